@@ -46,6 +46,7 @@ struct spdk_fio_options {
 	int mem_single_seg;
 	int initial_zone_reset;
 	int zone_append;
+	int shared_channels;
 	char *rpc_listen_addr;
 };
 
@@ -70,6 +71,12 @@ struct spdk_fio_thread {
 	TAILQ_HEAD(, spdk_fio_target)	targets;
 	bool				failed; /* true if the thread failed to initialize */
 
+	/* Channel thread that owns this job's descriptors and I/O channels when
+	 * spdk_shared_channels is set. NULL when each job owns its own channels.
+	 */
+	struct spdk_fio_thread		*ch_thread;
+	bool				bdev_open_done;
+
 	struct io_u		**iocq;		/* io completion queue */
 	unsigned int		iocq_count;	/* number of iocq entries filled by last getevents */
 	unsigned int		iocq_size;	/* number of iocq entries allocated */
@@ -124,6 +131,14 @@ static pthread_cond_t g_init_cond;
 static bool g_poll_loop = true;
 static TAILQ_HEAD(, spdk_fio_thread) g_threads = TAILQ_HEAD_INITIALIZER(g_threads);
 
+/* Threads owning the shared I/O channels when spdk_shared_channels is set.
+ * They are members of g_threads and are polled by the initialization thread.
+ */
+static pthread_mutex_t g_shared_ch_mtx = PTHREAD_MUTEX_INITIALIZER;
+static struct spdk_fio_thread **g_shared_ch_threads;
+static uint32_t g_shared_ch_count;
+static uint32_t g_shared_ch_next;
+
 /* Default polling timeout (ns) */
 #define SPDK_FIO_POLLING_TIMEOUT 1000000000ULL
 
@@ -228,7 +243,13 @@ spdk_fio_bdev_close_targets(void *arg)
 static void
 spdk_fio_cleanup_thread(struct spdk_fio_thread *fio_thread)
 {
-	spdk_thread_send_msg(fio_thread->thread, spdk_fio_bdev_close_targets, fio_thread);
+	/* Targets must be torn down on the thread that owns their I/O channels. */
+	if (fio_thread->ch_thread != NULL) {
+		spdk_thread_send_msg(fio_thread->ch_thread->thread, spdk_fio_bdev_close_targets,
+				     fio_thread);
+	} else {
+		spdk_thread_send_msg(fio_thread->thread, spdk_fio_bdev_close_targets, fio_thread);
+	}
 
 	pthread_mutex_lock(&g_init_mtx);
 	TAILQ_INSERT_TAIL(&g_threads, fio_thread, link);
@@ -720,6 +741,57 @@ spdk_fio_bdev_open(void *arg)
 	}
 }
 
+static void
+spdk_fio_bdev_open_shared(void *arg)
+{
+	struct thread_data *td = arg;
+	struct spdk_fio_thread *fio_thread = td->io_ops_data;
+
+	spdk_fio_bdev_open(td);
+	__atomic_store_n(&fio_thread->bdev_open_done, true, __ATOMIC_RELEASE);
+}
+
+/* Assign the caller one of the spdk_shared_channels channel threads, round robin,
+ * creating it on first use. Channel threads are created without g_internal_thread
+ * set, so spdk_fio_schedule_thread() adds them to g_threads and the initialization
+ * thread polls them continuously for the lifetime of the run.
+ */
+static struct spdk_fio_thread *
+spdk_fio_get_shared_ch_thread(uint32_t count)
+{
+	struct spdk_fio_thread *ch_thread;
+	struct spdk_thread *thread;
+	uint32_t idx;
+
+	pthread_mutex_lock(&g_shared_ch_mtx);
+	if (g_shared_ch_threads == NULL) {
+		g_shared_ch_threads = calloc(count, sizeof(*g_shared_ch_threads));
+		if (g_shared_ch_threads == NULL) {
+			pthread_mutex_unlock(&g_shared_ch_mtx);
+			return NULL;
+		}
+		g_shared_ch_count = count;
+	}
+
+	idx = g_shared_ch_next++ % g_shared_ch_count;
+	if (g_shared_ch_threads[idx] == NULL) {
+		thread = spdk_thread_create("fio_ch_thread", NULL);
+		if (!thread) {
+			pthread_mutex_unlock(&g_shared_ch_mtx);
+			return NULL;
+		}
+
+		ch_thread = spdk_thread_get_ctx(thread);
+		ch_thread->thread = thread;
+		TAILQ_INIT(&ch_thread->targets);
+		g_shared_ch_threads[idx] = ch_thread;
+	}
+	ch_thread = g_shared_ch_threads[idx];
+	pthread_mutex_unlock(&g_shared_ch_mtx);
+
+	return ch_thread;
+}
+
 /* Called for each thread, on that thread, shortly after the thread
  * starts.
  *
@@ -732,6 +804,7 @@ spdk_fio_bdev_open(void *arg)
 static int
 spdk_fio_init(struct thread_data *td)
 {
+	struct spdk_fio_options *fio_options = td->eo;
 	struct spdk_fio_thread *fio_thread;
 	int rc;
 
@@ -753,9 +826,32 @@ spdk_fio_init(struct thread_data *td)
 	assert(fio_thread);
 	fio_thread->failed = false;
 
-	spdk_thread_send_msg(fio_thread->thread, spdk_fio_bdev_open, td);
+	if (fio_options->shared_channels > 0) {
+		fio_thread->ch_thread = spdk_fio_get_shared_ch_thread(fio_options->shared_channels);
+		if (fio_thread->ch_thread == NULL) {
+			SPDK_ERRLOG("Unable to create shared channel thread\n");
+			return -1;
+		}
+
+		/* The descriptors and channels must be opened on the channel thread,
+		 * which is polled by the initialization thread, not by us.
+		 */
+		fio_thread->bdev_open_done = false;
+		spdk_thread_send_msg(fio_thread->ch_thread->thread, spdk_fio_bdev_open_shared, td);
+
+		/* Wake up the poll loop in spdk_init_thread_poll() */
+		pthread_mutex_lock(&g_init_mtx);
+		pthread_cond_signal(&g_init_cond);
+		pthread_mutex_unlock(&g_init_mtx);
+
+		while (!__atomic_load_n(&fio_thread->bdev_open_done, __ATOMIC_ACQUIRE)) {
+			spdk_fio_poll_thread(fio_thread);
+		}
+	} else {
+		spdk_thread_send_msg(fio_thread->thread, spdk_fio_bdev_open, td);
 
-	while (spdk_fio_poll_thread(fio_thread) > 0) {}
+		while (spdk_fio_poll_thread(fio_thread) > 0) {}
+	}
 
 	if (fio_thread->failed) {
 		return -1;
@@ -862,32 +958,24 @@ spdk_fio_zone_bytes_to_blocks(struct spdk_bdev *bdev, uint64_t offset_bytes, uin
 	return (offset_bytes % block_size) | (num_bytes % block_size);
 }
 
-static fio_q_status_t
-spdk_fio_queue(struct thread_data *td, struct io_u *io_u)
+static int
+spdk_fio_submit_io(struct spdk_fio_request *fio_req, struct spdk_fio_target *target,
+		   spdk_bdev_io_completion_cb cb)
 {
+	struct io_u *io_u = fio_req->io;
 	int rc = 1;
-	struct spdk_fio_request	*fio_req = io_u->engine_data;
-	struct spdk_fio_target *target = io_u->file->engine_data;
-
-	assert(fio_req->td == td);
-
-	if (!target) {
-		SPDK_ERRLOG("Unable to look up correct I/O target.\n");
-		fio_req->io->error = ENODEV;
-		return FIO_Q_COMPLETED;
-	}
 
 	switch (io_u->ddir) {
 	case DDIR_READ:
 		rc = spdk_bdev_read(target->desc, target->ch,
 				    io_u->buf, io_u->offset, io_u->xfer_buflen,
-				    spdk_fio_completion_cb, fio_req);
+				    cb, fio_req);
 		break;
 	case DDIR_WRITE:
 		if (!target->zone_append_enabled) {
 			rc = spdk_bdev_write(target->desc, target->ch,
 					     io_u->buf, io_u->offset, io_u->xfer_buflen,
-					     spdk_fio_completion_cb, fio_req);
+					     cb, fio_req);
 		} else {
 			uint64_t zone_start, num_blocks;
 			if (spdk_fio_zone_bytes_to_blocks(target->bdev, io_u->offset, &zone_start,
@@ -896,25 +984,105 @@ spdk_fio_queue(struct thread_data *td, struct io_u *io_u)
 				break;
 			}
 			rc = spdk_bdev_zone_append(target->desc, target->ch, io_u->buf,
-						   zone_start, num_blocks, spdk_fio_completion_cb,
+						   zone_start, num_blocks, cb,
 						   fio_req);
 		}
 		break;
 	case DDIR_TRIM:
 		rc = spdk_bdev_unmap(target->desc, target->ch,
 				     io_u->offset, io_u->xfer_buflen,
-				     spdk_fio_completion_cb, fio_req);
+				     cb, fio_req);
 		break;
 	case DDIR_SYNC:
 		rc = spdk_bdev_flush(target->desc, target->ch,
 				     io_u->offset, io_u->xfer_buflen,
-				     spdk_fio_completion_cb, fio_req);
+				     cb, fio_req);
 		break;
 	default:
 		assert(false);
 		break;
 	}
 
+	return rc;
+}
+
+/* Runs on the submitting job's thread, polled from spdk_fio_getevents(). */
+static void
+spdk_fio_deliver_completion(void *arg)
+{
+	struct spdk_fio_request *fio_req = arg;
+	struct spdk_fio_thread *fio_thread = fio_req->td->io_ops_data;
+
+	assert(fio_thread->iocq_count < fio_thread->iocq_size);
+	fio_thread->iocq[fio_thread->iocq_count++] = fio_req->io;
+}
+
+static void
+spdk_fio_shared_completion_cb(struct spdk_bdev_io *bdev_io,
+			      bool success,
+			      void *cb_arg)
+{
+	struct spdk_fio_request	*fio_req = cb_arg;
+	struct spdk_fio_thread	*fio_thread = fio_req->td->io_ops_data;
+
+	fio_req->io->error = success ? 0 : EIO;
+	spdk_bdev_free_io(bdev_io);
+
+	/* The iocq belongs to the submitting job - bounce the completion back
+	 * to its thread rather than touching the iocq from the channel thread.
+	 */
+	spdk_thread_send_msg(fio_thread->thread, spdk_fio_deliver_completion, fio_req);
+}
+
+/* Runs on the channel thread owning the target's I/O channel. */
+static void
+spdk_fio_bdev_submit(void *arg)
+{
+	struct spdk_fio_request *fio_req = arg;
+	struct spdk_fio_target *target = fio_req->io->file->engine_data;
+	struct spdk_fio_thread *fio_thread = fio_req->td->io_ops_data;
+	int rc;
+
+	rc = spdk_fio_submit_io(fio_req, target, spdk_fio_shared_completion_cb);
+	if (rc == -ENOMEM) {
+		/* Retry on the next poll of this channel thread. */
+		spdk_thread_send_msg(spdk_get_thread(), spdk_fio_bdev_submit, fio_req);
+		return;
+	}
+
+	if (rc != 0) {
+		fio_req->io->error = abs(rc);
+		spdk_thread_send_msg(fio_thread->thread, spdk_fio_deliver_completion, fio_req);
+	}
+}
+
+static fio_q_status_t
+spdk_fio_queue(struct thread_data *td, struct io_u *io_u)
+{
+	int rc;
+	struct spdk_fio_request	*fio_req = io_u->engine_data;
+	struct spdk_fio_target *target = io_u->file->engine_data;
+	struct spdk_fio_thread *fio_thread = td->io_ops_data;
+
+	assert(fio_req->td == td);
+
+	if (!target) {
+		SPDK_ERRLOG("Unable to look up correct I/O target.\n");
+		fio_req->io->error = ENODEV;
+		return FIO_Q_COMPLETED;
+	}
+
+	if (fio_thread->ch_thread != NULL) {
+		/* The channel belongs to a shared channel thread. Hand the request
+		 * off over the thread's lock-free message ring; errors (including
+		 * ENOMEM retries) are reported back through the completion path.
+		 */
+		spdk_thread_send_msg(fio_thread->ch_thread->thread, spdk_fio_bdev_submit, fio_req);
+		return FIO_Q_QUEUED;
+	}
+
+	rc = spdk_fio_submit_io(fio_req, target, spdk_fio_completion_cb);
+
 	if (rc == -ENOMEM) {
 		return FIO_Q_BUSY;
 	}
@@ -1172,7 +1340,9 @@ spdk_fio_report_zones(struct thread_data *td, struct fio_file *f, uint64_t offse
 		goto cleanup_thread;
 	}
 
-	spdk_thread_send_msg(fio_thread->thread, spdk_fio_bdev_get_zone_info, &cb_arg);
+	spdk_thread_send_msg(fio_thread->ch_thread != NULL ?
+			     fio_thread->ch_thread->thread : fio_thread->thread,
+			     spdk_fio_bdev_get_zone_info, &cb_arg);
 	do {
 		spdk_fio_poll_thread(fio_thread);
 	} while (!cb_arg.completed);
@@ -1245,7 +1415,9 @@ spdk_fio_reset_zones(struct spdk_fio_thread *fio_thread, struct spdk_fio_target
 			.offset_blocks = cur / block_size,
 		};
 
-		spdk_thread_send_msg(fio_thread->thread, spdk_fio_bdev_zone_reset, &cb_arg);
+		spdk_thread_send_msg(fio_thread->ch_thread != NULL ?
+				     fio_thread->ch_thread->thread : fio_thread->thread,
+				     spdk_fio_bdev_zone_reset, &cb_arg);
 		do {
 			spdk_fio_poll_thread(fio_thread);
 		} while (!cb_arg.completed);
@@ -1415,6 +1587,16 @@ static struct fio_option options[] = {
 		.category	= FIO_OPT_C_ENGINE,
 		.group		= FIO_OPT_G_INVALID,
 	},
+	{
+		.name		= "spdk_shared_channels",
+		.lname		= "Number of shared bdev I/O channel threads",
+		.type		= FIO_OPT_INT,
+		.off1		= offsetof(struct spdk_fio_options, shared_channels),
+		.def		= "0",
+		.help		= "Share this many I/O channel threads among all jobs (0=one channel per job)",
+		.category	= FIO_OPT_C_ENGINE,
+		.group		= FIO_OPT_G_INVALID,
+	},
 	{
 		.name           = "env_context",
 		.lname          = "Environment context options",
@@ -1490,6 +1672,11 @@ spdk_fio_finish_env(void)
 	pthread_mutex_unlock(&g_init_mtx);
 	pthread_join(g_init_thread_id, NULL);
 
+	/* The channel threads themselves were destroyed with the rest of g_threads. */
+	free(g_shared_ch_threads);
+	g_shared_ch_threads = NULL;
+	g_shared_ch_count = 0;
+
 	spdk_thread_lib_fini();
 	spdk_env_fini();
 }
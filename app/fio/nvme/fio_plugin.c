@@ -1240,6 +1240,30 @@ spdk_fio_queue(struct thread_data *td, struct io_u *io_u)
 	return FIO_Q_QUEUED;
 }
 
+/*
+ * The qpairs are created with delay_cmd_submit enabled, so commands queued by
+ * spdk_fio_queue() accumulate in the submission queue without ringing the
+ * doorbell. fio calls commit once per batch of queued io_us, which lets the
+ * whole batch be made visible to the controller with a single doorbell write
+ * per qpair instead of one per io_u.
+ */
+static int
+spdk_fio_commit(struct thread_data *td)
+{
+	struct spdk_fio_thread	*fio_thread = td->io_ops_data;
+	struct spdk_fio_qpair	*fio_qpair;
+
+	TAILQ_FOREACH(fio_qpair, &fio_thread->fio_qpair, link) {
+		if (fio_qpair->qpair == NULL) {
+			continue;
+		}
+
+		spdk_nvme_qpair_flush(fio_qpair->qpair);
+	}
+
+	return 0;
+}
+
 static struct io_u *
 spdk_fio_event(struct thread_data *td, int event)
 {
@@ -1898,6 +1922,7 @@ struct ioengine_ops ioengine = {
 	.name			= "spdk",
 	.version		= FIO_IOOPS_VERSION,
 	.queue			= spdk_fio_queue,
+	.commit			= spdk_fio_commit,
 	.getevents		= spdk_fio_getevents,
 	.event			= spdk_fio_event,
 	.cleanup		= spdk_fio_cleanup,
@@ -8,6 +8,7 @@
 
 #include "spdk/bdev.h"
 #include "spdk/event.h"
+#include "spdk/rpc.h"
 #include "spdk/fd.h"
 #include "spdk/string.h"
 #include "spdk/util.h"
@@ -34,6 +35,7 @@ struct spdk_dd_opts {
 	int64_t		io_unit_size;
 	int64_t		io_unit_count;
 	uint32_t	queue_depth;
+	uint32_t	streams;
 	bool		aio;
 	bool		sparse;
 };
@@ -41,6 +43,7 @@ struct spdk_dd_opts {
 static struct spdk_dd_opts g_opts = {
 	.io_unit_size = 4096,
 	.queue_depth = 2,
+	.streams = 1,
 };
 
 enum dd_submit_type {
@@ -151,6 +154,44 @@ static struct dd_job g_job = {};
 static int g_error = 0;
 static bool g_interrupt;
 
+/* Multi-stream copy engine (--streams).  The LBA range is sharded across
+ * several streams, each with its own spdk_thread, descriptors and I/O
+ * channels, so that a single reactor is no longer the bottleneck.  Only
+ * bdev-to-bdev copies are supported; files keep the single-stream path.
+ */
+struct dd_stream;
+
+struct dd_stream_io {
+	uint64_t		offset;
+	uint64_t		length;
+	enum dd_submit_type	type;
+	void			*buf;
+	struct dd_stream	*stream;
+};
+
+struct dd_stream {
+	uint32_t		id;
+	struct spdk_thread	*thread;
+	struct spdk_bdev_desc	*in_desc;
+	struct spdk_bdev_desc	*out_desc;
+	struct spdk_io_channel	*in_ch;
+	struct spdk_io_channel	*out_ch;
+
+	/* Byte range of the input this stream copies, [pos, end) */
+	uint64_t		pos;
+	uint64_t		end;
+
+	uint32_t		outstanding;
+	bool			use_copy;
+	bool			done;
+	struct dd_stream_io	*ios;
+};
+
+static struct dd_stream *g_streams;
+static struct spdk_thread *g_dd_main_thread;
+static uint32_t g_streams_started;
+static uint32_t g_streams_done;
+
 static void dd_target_seek(struct dd_io *io);
 static void _dd_bdev_seek_hole_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg);
 
@@ -227,9 +268,9 @@ dd_show_progress(bool finish)
 	uint64_t milliseconds;
 	uint64_t size, tmp_size;
 
-	size = g_job.incremental_bytes;
+	/* Streams account their progress from other threads. */
+	size = __atomic_exchange_n(&g_job.incremental_bytes, 0, __ATOMIC_RELAXED);
 
-	g_job.incremental_bytes = 0;
 	g_job.total_bytes += size;
 
 	if (finish) {
@@ -1067,6 +1108,327 @@ dd_register_buffers(void)
 }
 #endif
 
+static void dd_stream_submit(struct dd_stream_io *io);
+
+static void
+_dd_stream_done(void *ctx)
+{
+	assert(g_streams_done < g_streams_started);
+
+	if (++g_streams_done < g_streams_started) {
+		return;
+	}
+
+	if (g_error == 0 && g_interrupt == false) {
+		dd_show_progress(true);
+		printf("\n\n");
+	}
+	dd_exit(g_error);
+}
+
+static void
+dd_stream_finish(struct dd_stream *stream)
+{
+	if (stream->done) {
+		return;
+	}
+	stream->done = true;
+
+	if (stream->in_ch) {
+		spdk_put_io_channel(stream->in_ch);
+		stream->in_ch = NULL;
+	}
+	if (stream->out_ch) {
+		spdk_put_io_channel(stream->out_ch);
+		stream->out_ch = NULL;
+	}
+	if (stream->in_desc) {
+		spdk_bdev_close(stream->in_desc);
+		stream->in_desc = NULL;
+	}
+	if (stream->out_desc) {
+		spdk_bdev_close(stream->out_desc);
+		stream->out_desc = NULL;
+	}
+
+	spdk_thread_send_msg(g_dd_main_thread, _dd_stream_done, NULL);
+	spdk_thread_exit(spdk_get_thread());
+}
+
+static void
+dd_stream_fail(struct dd_stream *stream, int rc)
+{
+	int expected = 0;
+
+	SPDK_ERRLOG("stream %u: %s\n", stream->id, strerror(-rc));
+	__atomic_compare_exchange_n(&g_error, &expected, rc, false,
+				    __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+
+	if (stream->outstanding == 0) {
+		dd_stream_finish(stream);
+	}
+}
+
+static void
+dd_stream_bdev_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct dd_stream_io *io = cb_arg;
+	struct dd_stream *stream = io->stream;
+	uint64_t read_region_start = g_opts.input_offset * g_opts.io_unit_size;
+	uint64_t write_region_start = g_opts.output_offset * g_opts.io_unit_size;
+	uint64_t write_offset = write_region_start + (io->offset - read_region_start);
+	uint64_t length;
+	int rc = 0;
+
+	spdk_bdev_free_io(bdev_io);
+
+	assert(stream->outstanding > 0);
+	stream->outstanding--;
+
+	if (!success) {
+		dd_stream_fail(stream, -EIO);
+		return;
+	}
+
+	switch (io->type) {
+	case DD_POPULATE:
+		io->type = DD_READ;
+		stream->outstanding++;
+		rc = spdk_bdev_read(stream->in_desc, stream->in_ch, io->buf, io->offset,
+				    io->length, dd_stream_bdev_done, io);
+		break;
+	case DD_READ:
+		io->type = DD_WRITE;
+		length = SPDK_CEIL_DIV(io->length, g_job.output.block_size) * g_job.output.block_size;
+		stream->outstanding++;
+		rc = spdk_bdev_write(stream->out_desc, stream->out_ch, io->buf, write_offset,
+				     length, dd_stream_bdev_done, io);
+		break;
+	case DD_WRITE:
+		__atomic_fetch_add(&g_job.incremental_bytes, io->length, __ATOMIC_RELAXED);
+		dd_stream_submit(io);
+		return;
+	default:
+		assert(false);
+		break;
+	}
+
+	if (rc != 0) {
+		assert(stream->outstanding > 0);
+		stream->outstanding--;
+		dd_stream_fail(stream, rc);
+	}
+}
+
+static void
+dd_stream_submit(struct dd_stream_io *io)
+{
+	struct dd_stream *stream = io->stream;
+	uint64_t read_region_start = g_opts.input_offset * g_opts.io_unit_size;
+	uint64_t write_region_start = g_opts.output_offset * g_opts.io_unit_size;
+	uint64_t write_offset;
+	uint32_t block_size;
+	int rc;
+
+	if (stream->pos >= stream->end ||
+	    __atomic_load_n(&g_error, __ATOMIC_RELAXED) != 0 || g_interrupt == true) {
+		if (stream->outstanding == 0) {
+			dd_stream_finish(stream);
+		}
+		return;
+	}
+
+	io->offset = stream->pos;
+	io->length = spdk_min((uint64_t)g_opts.io_unit_size, stream->end - stream->pos);
+	stream->pos += io->length;
+	write_offset = write_region_start + (io->offset - read_region_start);
+
+	stream->outstanding++;
+
+	if (stream->use_copy) {
+		block_size = g_job.input.block_size;
+		io->type = DD_WRITE;
+		rc = spdk_bdev_copy_blocks(stream->out_desc, stream->out_ch,
+					   write_offset / block_size, io->offset / block_size,
+					   io->length / block_size, dd_stream_bdev_done, io);
+	} else if ((io->length % g_job.output.block_size) != 0) {
+		/* Read whole blocks from output to combine buffers later */
+		io->type = DD_POPULATE;
+		rc = spdk_bdev_read(stream->out_desc, stream->out_ch, io->buf, write_offset,
+				    SPDK_CEIL_DIV(io->length, g_job.output.block_size) * g_job.output.block_size,
+				    dd_stream_bdev_done, io);
+	} else {
+		io->type = DD_READ;
+		rc = spdk_bdev_read(stream->in_desc, stream->in_ch, io->buf, io->offset,
+				    io->length, dd_stream_bdev_done, io);
+	}
+
+	if (rc != 0) {
+		assert(stream->outstanding > 0);
+		stream->outstanding--;
+		dd_stream_fail(stream, rc);
+	}
+}
+
+static void
+dd_stream_start(void *ctx)
+{
+	struct dd_stream *stream = ctx;
+	uint32_t i;
+	int rc;
+
+	if (!stream->use_copy) {
+		rc = spdk_bdev_open_ext(g_opts.input_bdev, false, dd_bdev_event_cb, NULL,
+					&stream->in_desc);
+		if (rc != 0) {
+			dd_stream_fail(stream, rc);
+			return;
+		}
+
+		stream->in_ch = spdk_bdev_get_io_channel(stream->in_desc);
+		if (stream->in_ch == NULL) {
+			dd_stream_fail(stream, -ENOMEM);
+			return;
+		}
+	}
+
+	rc = spdk_bdev_open_ext(g_opts.output_bdev, true, dd_bdev_event_cb, NULL,
+				&stream->out_desc);
+	if (rc != 0) {
+		dd_stream_fail(stream, rc);
+		return;
+	}
+
+	stream->out_ch = spdk_bdev_get_io_channel(stream->out_desc);
+	if (stream->out_ch == NULL) {
+		dd_stream_fail(stream, -ENOMEM);
+		return;
+	}
+
+	for (i = 0; i < g_opts.queue_depth; i++) {
+		dd_stream_submit(&stream->ios[i]);
+		if (stream->done) {
+			break;
+		}
+	}
+}
+
+static uint32_t
+dd_stream_next_core(void)
+{
+	static uint32_t core = UINT32_MAX;
+
+	if (core == UINT32_MAX) {
+		core = spdk_env_get_first_core();
+		return core;
+	}
+
+	core = spdk_env_get_next_core(core);
+	if (core == UINT32_MAX) {
+		core = spdk_env_get_first_core();
+	}
+	return core;
+}
+
+static int
+dd_streams_start(void)
+{
+	struct dd_stream *stream;
+	struct spdk_cpuset cpumask;
+	char name[32];
+	uint64_t base = g_opts.input_offset * g_opts.io_unit_size;
+	uint64_t chunk;
+	bool use_copy;
+	uint32_t i, j;
+
+	/* The copy command works within a single bdev only. */
+	use_copy = g_job.input.u.bdev.bdev == g_job.output.u.bdev.bdev &&
+		   spdk_bdev_io_type_supported(g_job.output.u.bdev.bdev, SPDK_BDEV_IO_TYPE_COPY) &&
+		   (g_job.copy_size % g_job.input.block_size) == 0;
+	if (use_copy) {
+		printf("Offloading to bdev copy command\n");
+	}
+
+	chunk = SPDK_CEIL_DIV(g_job.copy_size / g_opts.streams, g_opts.io_unit_size) *
+		g_opts.io_unit_size;
+
+	g_streams = calloc(g_opts.streams, sizeof(struct dd_stream));
+	if (g_streams == NULL) {
+		return -ENOMEM;
+	}
+
+	g_dd_main_thread = spdk_get_thread();
+
+	for (i = 0; i < g_opts.streams; i++) {
+		stream = &g_streams[i];
+		stream->id = i;
+		stream->use_copy = use_copy;
+		stream->pos = base + (uint64_t)i * chunk;
+		stream->end = spdk_min(stream->pos + chunk, base + g_job.copy_size);
+		if (stream->pos >= stream->end) {
+			/* Copy too small for this many streams. */
+			break;
+		}
+
+		stream->ios = calloc(g_opts.queue_depth, sizeof(struct dd_stream_io));
+		if (stream->ios == NULL) {
+			return -ENOMEM;
+		}
+
+		for (j = 0; j < g_opts.queue_depth; j++) {
+			stream->ios[j].stream = stream;
+			if (!use_copy) {
+				stream->ios[j].buf = spdk_malloc(g_opts.io_unit_size, 0x1000, NULL,
+								 0, SPDK_MALLOC_DMA);
+				if (stream->ios[j].buf == NULL) {
+					SPDK_ERRLOG("%s - try smaller block size value\n",
+						    strerror(ENOMEM));
+					return -ENOMEM;
+				}
+			}
+		}
+
+		spdk_cpuset_zero(&cpumask);
+		spdk_cpuset_set_cpu(&cpumask, dd_stream_next_core(), true);
+		snprintf(name, sizeof(name), "dd_stream_%u", i);
+		stream->thread = spdk_thread_create(name, &cpumask);
+		if (stream->thread == NULL) {
+			return -ENOMEM;
+		}
+	}
+
+	g_streams_started = i;
+	for (i = 0; i < g_streams_started; i++) {
+		spdk_thread_send_msg(g_streams[i].thread, dd_stream_start, &g_streams[i]);
+	}
+
+	return 0;
+}
+
+static void
+rpc_dd_get_progress(struct spdk_jsonrpc_request *request, const struct spdk_json_val *params)
+{
+	struct spdk_json_write_ctx *w;
+	uint64_t copied;
+
+	if (params != NULL) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+						 "dd_get_progress requires no parameters");
+		return;
+	}
+
+	copied = g_job.total_bytes + __atomic_load_n(&g_job.incremental_bytes, __ATOMIC_RELAXED);
+
+	w = spdk_jsonrpc_begin_result(request);
+	spdk_json_write_object_begin(w);
+	spdk_json_write_named_uint64(w, "copied_bytes", copied);
+	spdk_json_write_named_uint64(w, "total_bytes", g_job.copy_size);
+	spdk_json_write_named_uint32(w, "streams", g_opts.streams);
+	spdk_json_write_object_end(w);
+	spdk_jsonrpc_end_result(request, w);
+}
+SPDK_RPC_REGISTER("dd_get_progress", rpc_dd_get_progress, SPDK_RPC_RUNTIME)
+
 static void
 dd_run(void *arg1)
 {
@@ -1171,6 +1533,19 @@ dd_run(void *arg1)
 		return;
 	}
 
+	if (g_opts.streams > 1) {
+		clock_gettime(CLOCK_REALTIME, &g_job.start_time);
+
+		g_job.status_poller = SPDK_POLLER_REGISTER(dd_status_poller, NULL,
+				      STATUS_POLLER_PERIOD_SEC * SPDK_SEC_TO_USEC);
+
+		rc = dd_streams_start();
+		if (rc != 0) {
+			dd_exit(rc);
+		}
+		return;
+	}
+
 	g_job.ios = calloc(g_opts.queue_depth, sizeof(struct dd_io));
 	if (g_job.ios == NULL) {
 		SPDK_ERRLOG("%s\n", strerror(ENOMEM));
@@ -1263,6 +1638,7 @@ enum dd_cmdline_opts {
 	DD_OPTION_COUNT,
 	DD_OPTION_AIO,
 	DD_OPTION_SPARSE,
+	DD_OPTION_STREAMS,
 };
 
 static struct option g_cmdline_opts[] = {
@@ -1344,6 +1720,12 @@ static struct option g_cmdline_opts[] = {
 		.flag = NULL,
 		.val = DD_OPTION_SPARSE,
 	},
+	{
+		.name = "streams",
+		.has_arg = 1,
+		.flag = NULL,
+		.val = DD_OPTION_STREAMS,
+	},
 	{
 		.name = NULL
 	}
@@ -1366,6 +1748,8 @@ usage(void)
 	printf(" --seek Skip this many I/O units at start of output. (default: 0)\n");
 	printf(" --aio Force usage of AIO. (by default io_uring is used if available)\n");
 	printf(" --sparse Enable hole skipping in input target\n");
+	printf(" --streams Number of parallel copy streams, each on its own core of the\n");
+	printf("           reactor mask. Requires --ib and --ob. (default: 1)\n");
 	printf(" Available iflag and oflag values:\n");
 	printf("  append - append mode\n");
 	printf("  direct - use direct I/O for data\n");
@@ -1421,6 +1805,9 @@ parse_args(int argc, char *argv)
 	case DD_OPTION_SPARSE:
 		g_opts.sparse = true;
 		break;
+	case DD_OPTION_STREAMS:
+		g_opts.streams = spdk_strtol(optarg, 10);
+		break;
 	default:
 		usage();
 		return 1;
@@ -1462,6 +1849,22 @@ dd_free(void)
 
 		free(g_job.ios);
 	}
+
+	if (g_streams) {
+		uint32_t j;
+
+		for (i = 0; i < g_opts.streams; i++) {
+			if (g_streams[i].ios == NULL) {
+				continue;
+			}
+			for (j = 0; j < g_opts.queue_depth; j++) {
+				spdk_free(g_streams[i].ios[j].buf);
+			}
+			free(g_streams[i].ios);
+		}
+
+		free(g_streams);
+	}
 }
 
 int
@@ -1531,6 +1934,25 @@ main(int argc, char **argv)
 		goto end;
 	}
 
+	if (g_opts.streams < 1 || g_opts.streams > 128) {
+		SPDK_ERRLOG("Invalid --streams value\n");
+		rc = EINVAL;
+		goto end;
+	}
+
+	if (g_opts.streams > 1) {
+		if (g_opts.input_bdev == NULL || g_opts.output_bdev == NULL) {
+			SPDK_ERRLOG("--streams > 1 requires both --ib and --ob\n");
+			rc = EINVAL;
+			goto end;
+		}
+		if (g_opts.sparse) {
+			SPDK_ERRLOG("--streams cannot be combined with --sparse\n");
+			rc = EINVAL;
+			goto end;
+		}
+	}
+
 	rc = spdk_app_start(&opts, dd_run, NULL);
 	if (rc) {
 		SPDK_ERRLOG("Error occurred while performing copy\n");
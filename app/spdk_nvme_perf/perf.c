@@ -16,6 +16,7 @@
 #include "spdk/queue.h"
 #include "spdk/string.h"
 #include "spdk/nvme_intel.h"
+#include "spdk/nvme_zns.h"
 #include "spdk/histogram_data.h"
 #include "spdk/endian.h"
 #include "spdk/dif.h"
@@ -88,6 +89,14 @@ struct ns_entry {
 	bool			pi_loc;
 	enum spdk_nvme_pi_type	pi_type;
 	uint32_t		io_flags;
+	/* Zoned namespace parameters, only valid for zone workloads
+	 * (-w zappend/zwrite).
+	 */
+	uint64_t		zone_size_blocks;
+	uint64_t		num_zones;
+	uint32_t		max_open_zones;
+	uint32_t		zone_qd;
+	uint32_t		zns_ctx_count;
 	char			name[1024];
 };
 
@@ -122,6 +131,40 @@ struct ns_worker_stats {
 	uint64_t		idle_tsc;
 	uint64_t		last_busy_tsc;
 	uint64_t		last_idle_tsc;
+	/* cycle breakdown accounting (--cycle-breakdown) */
+	uint64_t		submit_tsc;
+	uint64_t		complete_tsc;
+	uint64_t		poll_tsc;
+};
+
+enum perf_zone_state {
+	PERF_ZONE_EMPTY = 0,
+	PERF_ZONE_OPEN,
+	/* Remaining capacity is smaller than the IO size - finish the zone
+	 * once the outstanding IO drains.
+	 */
+	PERF_ZONE_NEED_FINISH,
+	PERF_ZONE_FINISHING,
+	PERF_ZONE_FULL,
+	PERF_ZONE_RESETTING,
+};
+
+struct perf_zone {
+	uint64_t		slba;
+	/* Write pointer including in-flight reservations. */
+	uint64_t		next_lba;
+	/* Writable capacity in blocks (ZCAP, may be less than the zone size). */
+	uint64_t		zcap;
+	uint32_t		outstanding;
+	enum perf_zone_state	state;
+	struct ns_worker_ctx	*ns_ctx;
+};
+
+struct perf_zns_lat {
+	uint64_t		count;
+	uint64_t		total_tsc;
+	uint64_t		min_tsc;
+	uint64_t		max_tsc;
 };
 
 struct ns_worker_ctx {
@@ -129,6 +172,8 @@ struct ns_worker_ctx {
 	struct ns_worker_stats	stats;
 	uint64_t		current_queue_depth;
 	uint64_t		offset_in_ios;
+	uint64_t		replay_index;
+	uint64_t		replay_start_tsc;
 	bool			is_draining;
 
 	union {
@@ -161,6 +206,32 @@ struct ns_worker_ctx {
 
 	TAILQ_HEAD(, perf_task)		queued_tasks;
 
+	/* tasks waiting for their next replay record to become due */
+	TAILQ_HEAD(, perf_task)		replay_tasks;
+
+	/* tasks waiting for a zone with room to write (-w zappend/zwrite) */
+	TAILQ_HEAD(, perf_task)		zone_tasks;
+
+	/* Zone state for zone workloads.  Workers sharing a namespace each
+	 * own a disjoint stripe of its zones, so no cross-thread coordination
+	 * is needed.
+	 */
+	struct {
+		struct perf_zone	*zones;
+		uint32_t		num_zones;
+		uint32_t		num_open;
+		uint32_t		next_zone;
+		uint32_t		ctx_id;
+		uint64_t		finishes;
+		uint64_t		resets;
+		/* Append/write latency split by the zone state seen at
+		 * submission: first IO to an empty zone pays the implicit
+		 * open, the rest go to an already open zone.
+		 */
+		struct perf_zns_lat	lat_empty;
+		struct perf_zns_lat	lat_open;
+	} zns;
+
 	struct spdk_histogram_data	*histogram;
 	int				status;
 };
@@ -172,8 +243,12 @@ struct perf_task {
 	int			iovpos; /* Current iovec position. */
 	uint32_t		iov_offset; /* Offset in current iovec. */
 	struct iovec		md_iov;
+	uint64_t		lba;
+	uint32_t		num_blocks;
 	uint64_t		submit_tsc;
 	bool			is_read;
+	struct perf_zone	*zone;		/* zone targeted by a zone workload IO */
+	bool			zone_was_empty;	/* zone was empty at submission */
 	struct spdk_dif_ctx	dif_ctx;
 #if HAVE_LIBAIO
 	struct iocb		iocb;
@@ -191,7 +266,7 @@ struct ns_fn_table {
 	void	(*setup_payload)(struct perf_task *task, uint8_t pattern);
 
 	int	(*submit_io)(struct perf_task *task, struct ns_worker_ctx *ns_ctx,
-			     struct ns_entry *entry, uint64_t offset_in_ios);
+			     struct ns_entry *entry);
 
 	int64_t	(*check_io)(struct ns_worker_ctx *ns_ctx);
 
@@ -234,6 +309,8 @@ static uint32_t g_metacfg_pract_flag;
 static uint32_t g_metacfg_prchk_flags;
 static int g_rw_percentage = -1;
 static int g_is_random;
+static bool g_is_zone_workload;
+static bool g_is_zone_append;
 static uint32_t g_queue_depth;
 static int g_nr_io_queues_per_ns = 1;
 static int g_nr_unused_io_queues;
@@ -256,6 +333,19 @@ static uint32_t g_keep_alive_timeout_in_ms = 10000;
 static bool g_continue_on_error = false;
 static uint32_t g_quiet_count = 1;
 static double g_zipf_theta;
+
+/* One I/O from a captured trace being replayed with --replay */
+struct replay_record {
+	uint64_t	timestamp_us;
+	uint64_t	offset_bytes;
+	uint32_t	length_bytes;
+	bool		is_read;
+};
+static const char *g_replay_file;
+static double g_replay_time_scale = 1.0;
+static struct replay_record *g_replay_records;
+static uint64_t g_replay_num_records;
+static uint32_t g_replay_max_io_bytes;
 /* Set default io_queue_size to UINT16_MAX, NVMe driver will then reduce this
  * to MQES to maximize the io_queue_size as much as possible.
  */
@@ -292,6 +382,7 @@ uint8_t *g_psk = NULL;
 	}
 
 static bool g_dump_transport_stats;
+static bool g_cycle_breakdown;
 static pthread_mutex_t g_stats_mutex;
 
 #define MAX_ALLOWED_PCI_DEVICE_NUM 128
@@ -468,7 +559,7 @@ uring_setup_payload(struct perf_task *task, uint8_t pattern)
 
 static int
 uring_submit_io(struct perf_task *task, struct ns_worker_ctx *ns_ctx,
-		struct ns_entry *entry, uint64_t offset_in_ios)
+		struct ns_entry *entry)
 {
 	struct io_uring_sqe *sqe;
 
@@ -479,9 +570,11 @@ uring_submit_io(struct perf_task *task, struct ns_worker_ctx *ns_ctx,
 	}
 
 	if (task->is_read) {
-		io_uring_prep_readv(sqe, entry->u.uring.fd, task->iovs, 1, offset_in_ios * task->iovs[0].iov_len);
+		io_uring_prep_readv(sqe, entry->u.uring.fd, task->iovs, 1,
+				    task->lba * entry->block_size);
 	} else {
-		io_uring_prep_writev(sqe, entry->u.uring.fd, task->iovs, 1, offset_in_ios * task->iovs[0].iov_len);
+		io_uring_prep_writev(sqe, entry->u.uring.fd, task->iovs, 1,
+				     task->lba * entry->block_size);
 	}
 
 	io_uring_sqe_set_data(sqe, task);
@@ -611,7 +704,7 @@ aio_submit(io_context_t aio_ctx, struct iocb *iocb, int fd, enum io_iocb_cmd cmd
 	iocb->aio_lio_opcode = cmd;
 	iocb->u.c.buf = iov->iov_base;
 	iocb->u.c.nbytes = iov->iov_len;
-	iocb->u.c.offset = offset * iov->iov_len;
+	iocb->u.c.offset = offset;
 	iocb->data = cb_ctx;
 
 	if (io_submit(aio_ctx, 1, &iocb) < 0) {
@@ -624,14 +717,14 @@ aio_submit(io_context_t aio_ctx, struct iocb *iocb, int fd, enum io_iocb_cmd cmd
 
 static int
 aio_submit_io(struct perf_task *task, struct ns_worker_ctx *ns_ctx,
-	      struct ns_entry *entry, uint64_t offset_in_ios)
+	      struct ns_entry *entry)
 {
 	if (task->is_read) {
 		return aio_submit(ns_ctx->u.aio.ctx, &task->iocb, entry->u.aio.fd, IO_CMD_PREAD,
-				  task->iovs, offset_in_ios, task);
+				  task->iovs, task->lba * entry->block_size, task);
 	} else {
 		return aio_submit(ns_ctx->u.aio.ctx, &task->iocb, entry->u.aio.fd, IO_CMD_PWRITE,
-				  task->iovs, offset_in_ios, task);
+				  task->iovs, task->lba * entry->block_size, task);
 	}
 }
 
@@ -788,6 +881,7 @@ register_file(const char *path)
 	}
 	entry->size_in_ios = size / g_io_size_bytes;
 	entry->io_size_blocks = g_io_size_bytes / blklen;
+	entry->block_size = blklen;
 
 	if (g_is_random) {
 		entry->seed = rand();
@@ -811,6 +905,10 @@ register_files(int argc, char **argv)
 
 	/* Treat everything after the options as files for AIO/URING */
 	for (i = g_file_optind; i < argc; i++) {
+		if (g_is_zone_workload) {
+			fprintf(stderr, "Zone workloads are not supported on kernel devices.\n");
+			return 1;
+		}
 		if (register_file(argv[i]) != 0) {
 			return 1;
 		}
@@ -862,7 +960,7 @@ nvme_setup_payload(struct perf_task *task, uint8_t pattern)
 
 static int
 nvme_submit_io(struct perf_task *task, struct ns_worker_ctx *ns_ctx,
-	       struct ns_entry *entry, uint64_t offset_in_ios)
+	       struct ns_entry *entry)
 {
 	uint64_t lba;
 	int rc;
@@ -875,7 +973,7 @@ nvme_submit_io(struct perf_task *task, struct ns_worker_ctx *ns_ctx,
 		DIF_MODE_DIX = 2,
 	}  mode = DIF_MODE_NONE;
 
-	lba = offset_in_ios * entry->io_size_blocks;
+	lba = task->lba;
 
 	if (entry->md_size != 0 && !(entry->io_flags & SPDK_NVME_IO_FLAGS_PRACT)) {
 		if (entry->md_interleave) {
@@ -897,7 +995,7 @@ nvme_submit_io(struct perf_task *task, struct ns_worker_ctx *ns_ctx,
 		rc = spdk_dif_ctx_init(&task->dif_ctx, entry->block_size, entry->md_size,
 				       entry->md_interleave, entry->pi_loc,
 				       (enum spdk_dif_type)entry->pi_type, entry->io_flags,
-				       lba, 0xFFFF, (uint16_t)entry->io_size_blocks, 0, 0, &dif_opts);
+				       lba, 0xFFFF, (uint16_t)task->num_blocks, 0, 0, &dif_opts);
 		if (rc != 0) {
 			fprintf(stderr, "Initialization of DIF context failed\n");
 			exit(1);
@@ -909,12 +1007,12 @@ nvme_submit_io(struct perf_task *task, struct ns_worker_ctx *ns_ctx,
 			return spdk_nvme_ns_cmd_read_with_md(entry->u.nvme.ns, ns_ctx->u.nvme.qpair[qp_num],
 							     task->iovs[0].iov_base, task->md_iov.iov_base,
 							     lba,
-							     entry->io_size_blocks, io_complete,
+							     task->num_blocks, io_complete,
 							     task, entry->io_flags,
 							     task->dif_ctx.apptag_mask, task->dif_ctx.app_tag);
 		} else {
 			return spdk_nvme_ns_cmd_readv_with_md(entry->u.nvme.ns, ns_ctx->u.nvme.qpair[qp_num],
-							      lba, entry->io_size_blocks,
+							      lba, task->num_blocks,
 							      io_complete, task, entry->io_flags,
 							      nvme_perf_reset_sgl, nvme_perf_next_sge,
 							      task->md_iov.iov_base,
@@ -923,14 +1021,14 @@ nvme_submit_io(struct perf_task *task, struct ns_worker_ctx *ns_ctx,
 	} else {
 		switch (mode) {
 		case DIF_MODE_DIF:
-			rc = spdk_dif_generate(task->iovs, task->iovcnt, entry->io_size_blocks, &task->dif_ctx);
+			rc = spdk_dif_generate(task->iovs, task->iovcnt, task->num_blocks, &task->dif_ctx);
 			if (rc != 0) {
 				fprintf(stderr, "Generation of DIF failed\n");
 				return rc;
 			}
 			break;
 		case DIF_MODE_DIX:
-			rc = spdk_dix_generate(task->iovs, task->iovcnt, &task->md_iov, entry->io_size_blocks,
+			rc = spdk_dix_generate(task->iovs, task->iovcnt, &task->md_iov, task->num_blocks,
 					       &task->dif_ctx);
 			if (rc != 0) {
 				fprintf(stderr, "Generation of DIX failed\n");
@@ -941,16 +1039,37 @@ nvme_submit_io(struct perf_task *task, struct ns_worker_ctx *ns_ctx,
 			break;
 		}
 
+		if (g_is_zone_append) {
+			/* lba holds the zone start LBA - the device assigns the
+			 * actual LBA and returns it in the completion.
+			 */
+			if (task->iovcnt == 1) {
+				return spdk_nvme_zns_zone_append_with_md(entry->u.nvme.ns,
+						ns_ctx->u.nvme.qpair[qp_num],
+						task->iovs[0].iov_base, task->md_iov.iov_base,
+						lba, task->num_blocks, io_complete, task,
+						entry->io_flags, task->dif_ctx.apptag_mask,
+						task->dif_ctx.app_tag);
+			} else {
+				return spdk_nvme_zns_zone_appendv_with_md(entry->u.nvme.ns,
+						ns_ctx->u.nvme.qpair[qp_num],
+						lba, task->num_blocks, io_complete, task,
+						entry->io_flags, nvme_perf_reset_sgl,
+						nvme_perf_next_sge, task->md_iov.iov_base,
+						task->dif_ctx.apptag_mask, task->dif_ctx.app_tag);
+			}
+		}
+
 		if (task->iovcnt == 1) {
 			return spdk_nvme_ns_cmd_write_with_md(entry->u.nvme.ns, ns_ctx->u.nvme.qpair[qp_num],
 							      task->iovs[0].iov_base, task->md_iov.iov_base,
 							      lba,
-							      entry->io_size_blocks, io_complete,
+							      task->num_blocks, io_complete,
 							      task, entry->io_flags,
 							      task->dif_ctx.apptag_mask, task->dif_ctx.app_tag);
 		} else {
 			return spdk_nvme_ns_cmd_writev_with_md(entry->u.nvme.ns, ns_ctx->u.nvme.qpair[qp_num],
-							       lba, entry->io_size_blocks,
+							       lba, task->num_blocks,
 							       io_complete, task, entry->io_flags,
 							       nvme_perf_reset_sgl, nvme_perf_next_sge,
 							       task->md_iov.iov_base,
@@ -994,14 +1113,14 @@ nvme_verify_io(struct perf_task *task, struct ns_entry *entry)
 	}
 
 	if (entry->md_interleave) {
-		rc = spdk_dif_verify(task->iovs, task->iovcnt, entry->io_size_blocks, &task->dif_ctx,
+		rc = spdk_dif_verify(task->iovs, task->iovcnt, task->num_blocks, &task->dif_ctx,
 				     &err_blk);
 		if (rc != 0) {
 			fprintf(stderr, "DIF error detected. type=%d, offset=%" PRIu32 "\n",
 				err_blk.err_type, err_blk.err_offset);
 		}
 	} else {
-		rc = spdk_dix_verify(task->iovs, task->iovcnt, &task->md_iov, entry->io_size_blocks,
+		rc = spdk_dix_verify(task->iovs, task->iovcnt, &task->md_iov, task->num_blocks,
 				     &task->dif_ctx, &err_blk);
 		if (rc != 0) {
 			fprintf(stderr, "DIX error detected. type=%d, offset=%" PRIu32 "\n",
@@ -1010,6 +1129,120 @@ nvme_verify_io(struct perf_task *task, struct ns_entry *entry)
 	}
 }
 
+struct zone_init_ctx {
+	bool	done;
+	int	status;
+};
+
+static void
+nvme_init_zone_cpl(void *arg, const struct spdk_nvme_cpl *cpl)
+{
+	struct zone_init_ctx *ctx = arg;
+
+	ctx->status = spdk_nvme_cpl_is_error(cpl) ? -EIO : 0;
+	ctx->done = true;
+}
+
+static int
+nvme_init_zone_wait(struct ns_worker_ctx *ns_ctx, struct zone_init_ctx *ctx)
+{
+	while (!ctx->done) {
+		spdk_nvme_qpair_process_completions(ns_ctx->u.nvme.qpair[0], 0);
+	}
+	return ctx->status;
+}
+
+/* Build the zone table for a zone workload: reset the namespace's zones and
+ * learn each zone's writable capacity (ZCAP) from a zone report.  Runs before
+ * the worker sync barrier, so resetting with select_all cannot race with
+ * another worker's IO.
+ */
+static int
+nvme_init_zone_ctx(struct ns_worker_ctx *ns_ctx)
+{
+	struct ns_entry *entry = ns_ctx->entry;
+	struct spdk_nvme_zns_zone_report *report;
+	struct zone_init_ctx ctx;
+	struct perf_zone *zone;
+	uint32_t ctx_count = entry->zns_ctx_count;
+	uint32_t report_size = 4096;
+	uint64_t zidx, i, nr_zones;
+	int rc;
+
+	assert(ctx_count > 0);
+	ns_ctx->zns.num_zones = entry->num_zones / ctx_count +
+				(ns_ctx->zns.ctx_id < entry->num_zones % ctx_count ? 1 : 0);
+	if (ns_ctx->zns.num_zones == 0) {
+		fprintf(stderr, "Not enough zones on %s for %u workers\n", entry->name, ctx_count);
+		return -1;
+	}
+
+	ns_ctx->zns.zones = calloc(ns_ctx->zns.num_zones, sizeof(struct perf_zone));
+	if (ns_ctx->zns.zones == NULL) {
+		return -1;
+	}
+
+	for (i = 0; i < ns_ctx->zns.num_zones; i++) {
+		zone = &ns_ctx->zns.zones[i];
+		zone->slba = (ns_ctx->zns.ctx_id + i * ctx_count) * entry->zone_size_blocks;
+		zone->next_lba = zone->slba;
+		zone->state = PERF_ZONE_EMPTY;
+		zone->ns_ctx = ns_ctx;
+	}
+
+	/* Reset all zones once per namespace so every worker starts from empty. */
+	if (ns_ctx->zns.ctx_id == 0) {
+		ctx.done = false;
+		rc = spdk_nvme_zns_reset_zone(entry->u.nvme.ns, ns_ctx->u.nvme.qpair[0], 0, true,
+					      nvme_init_zone_cpl, &ctx);
+		if (rc == 0) {
+			rc = nvme_init_zone_wait(ns_ctx, &ctx);
+		}
+		if (rc != 0) {
+			fprintf(stderr, "Initial zone reset failed on %s\n", entry->name);
+			goto failed;
+		}
+	}
+
+	report = spdk_dma_zmalloc(report_size, 4096, NULL);
+	if (report == NULL) {
+		goto failed;
+	}
+
+	zidx = 0;
+	while (zidx < entry->num_zones) {
+		ctx.done = false;
+		rc = spdk_nvme_zns_report_zones(entry->u.nvme.ns, ns_ctx->u.nvme.qpair[0],
+						report, report_size, zidx * entry->zone_size_blocks,
+						SPDK_NVME_ZRA_LIST_ALL, true,
+						nvme_init_zone_cpl, &ctx);
+		if (rc == 0) {
+			rc = nvme_init_zone_wait(ns_ctx, &ctx);
+		}
+		nr_zones = spdk_min(report->nr_zones,
+				    (report_size - sizeof(*report)) / sizeof(report->descs[0]));
+		if (rc != 0 || nr_zones == 0) {
+			fprintf(stderr, "Zone report failed on %s\n", entry->name);
+			spdk_dma_free(report);
+			goto failed;
+		}
+
+		for (i = 0; i < nr_zones && zidx < entry->num_zones; i++, zidx++) {
+			if (zidx % ctx_count == ns_ctx->zns.ctx_id) {
+				ns_ctx->zns.zones[zidx / ctx_count].zcap = report->descs[i].zcap;
+			}
+		}
+	}
+
+	spdk_dma_free(report);
+	return 0;
+
+failed:
+	free(ns_ctx->zns.zones);
+	ns_ctx->zns.zones = NULL;
+	return -1;
+}
+
 /*
  * TODO: If a controller has multiple namespaces, they could all use the same queue.
  *  For now, give each namespace/thread combination its own queue.
@@ -1082,6 +1315,9 @@ nvme_init_ns_worker_ctx(struct ns_worker_ctx *ns_ctx)
 		spdk_nvme_poll_group_process_completions(group, 0, perf_disconnect_cb);
 		rc = spdk_nvme_poll_group_all_connected(group);
 		if (rc == 0) {
+			if (g_is_zone_workload && nvme_init_zone_ctx(ns_ctx) != 0) {
+				goto qpair_failed;
+			}
 			return 0;
 		}
 	}
@@ -1111,6 +1347,8 @@ nvme_cleanup_ns_worker_ctx(struct ns_worker_ctx *ns_ctx)
 
 	spdk_nvme_poll_group_destroy(ns_ctx->u.nvme.group);
 	free(ns_ctx->u.nvme.qpair);
+	free(ns_ctx->zns.zones);
+	ns_ctx->zns.zones = NULL;
 }
 
 static void
@@ -1337,6 +1575,61 @@ register_ns(struct spdk_nvme_ctrlr *ctrlr, struct spdk_nvme_ns *ns)
 		}
 	}
 
+	if (g_is_zone_workload) {
+		uint32_t max_append_size;
+
+		if (spdk_nvme_ns_get_csi(ns) != SPDK_NVME_CSI_ZNS) {
+			printf("WARNING: controller %-20.20s (%-20.20s) ns %u is not zoned."
+			       " Removing this ns from test\n", cdata->mn, cdata->sn,
+			       spdk_nvme_ns_get_id(ns));
+			g_warn = true;
+			free(entry);
+			return;
+		}
+
+		entry->zone_size_blocks = spdk_nvme_zns_ns_get_zone_size_sectors(ns);
+		entry->num_zones = spdk_nvme_zns_ns_get_num_zones(ns);
+
+		if (entry->io_size_blocks > entry->zone_size_blocks) {
+			printf("WARNING: IO size %u (-o) is larger than nsid %u zone size."
+			       " Removing this ns from test\n", g_io_size_bytes,
+			       spdk_nvme_ns_get_id(ns));
+			g_warn = true;
+			free(entry);
+			return;
+		}
+
+		if (g_is_zone_append) {
+			max_append_size = spdk_nvme_zns_ctrlr_get_max_zone_append_size(ctrlr);
+			if (max_append_size != 0 && g_io_size_bytes > max_append_size) {
+				printf("WARNING: IO size %u (-o) is larger than nsid %u max zone"
+				       " append size %u. Removing this ns from test\n",
+				       g_io_size_bytes, spdk_nvme_ns_get_id(ns), max_append_size);
+				g_warn = true;
+				free(entry);
+				return;
+			}
+		}
+
+		/* Open zone budget from the zoned namespace data.  MOR/MAR of
+		 * 0xffffffff mean no limit, which the 0's based getters wrap
+		 * to 0.
+		 */
+		entry->max_open_zones = spdk_min(spdk_nvme_zns_ns_get_max_open_zones(ns),
+						 spdk_nvme_zns_ns_get_max_active_zones(ns));
+		if (entry->max_open_zones == 0 || entry->max_open_zones > entry->num_zones) {
+			entry->max_open_zones = spdk_min(entry->num_zones, 32);
+		}
+
+		/* The zoned namespace data has no per-zone queue depth limit,
+		 * but appends to one zone serialize on its write pointer - cap
+		 * them so that the queue depth spreads across open zones.
+		 * Writes to sequential-write-required zones must stay strictly
+		 * in order, so they get a per-zone depth of 1.
+		 */
+		entry->zone_qd = g_is_zone_append ? 4 : 1;
+	}
+
 	entry->block_size = spdk_nvme_ns_get_extended_sector_size(ns);
 	entry->md_size = spdk_nvme_ns_get_md_size(ns);
 	entry->md_interleave = spdk_nvme_ns_supports_extended_lba(ns);
@@ -1484,39 +1777,352 @@ register_ctrlr(struct spdk_nvme_ctrlr *ctrlr, struct trid_entry *trid_entry)
 	}
 }
 
+/* Check whether the next record of the trace is due for submission, taking
+ * the time scale into account.  Only valid while the trace is not exhausted.
+ */
+static inline bool
+replay_record_due(struct ns_worker_ctx *ns_ctx)
+{
+	const struct replay_record *rec = &g_replay_records[ns_ctx->replay_index];
+	uint64_t due_tsc;
+
+	if (g_replay_time_scale <= 0) {
+		return true;
+	}
+
+	due_tsc = ns_ctx->replay_start_tsc +
+		  (uint64_t)(rec->timestamp_us * g_replay_time_scale * g_tsc_rate / SPDK_SEC_TO_USEC);
+
+	return spdk_get_ticks() >= due_tsc;
+}
+
+/* Credit cycles spent since cycle_start to the submission path. */
+static inline void
+perf_account_submit(struct ns_worker_ctx *ns_ctx, uint64_t cycle_start)
+{
+	if (spdk_unlikely(g_cycle_breakdown)) {
+		ns_ctx->stats.submit_tsc += spdk_get_ticks() - cycle_start;
+	}
+}
+
+static void
+perf_zns_lat_record(struct perf_zns_lat *lat, uint64_t tsc_diff)
+{
+	lat->count++;
+	lat->total_tsc += tsc_diff;
+	if (lat->count == 1 || tsc_diff < lat->min_tsc) {
+		lat->min_tsc = tsc_diff;
+	}
+	if (tsc_diff > lat->max_tsc) {
+		lat->max_tsc = tsc_diff;
+	}
+}
+
+static void
+zone_finish_complete(void *ctx, const struct spdk_nvme_cpl *cpl)
+{
+	struct perf_zone *zone = ctx;
+	struct ns_worker_ctx *ns_ctx = zone->ns_ctx;
+
+	ns_ctx->current_queue_depth--;
+	if (spdk_unlikely(spdk_nvme_cpl_is_error(cpl))) {
+		RATELIMIT_LOG("Zone finish failed (sct=%d, sc=%d)\n",
+			      cpl->status.sct, cpl->status.sc);
+		if (!g_continue_on_error) {
+			ns_ctx->status = 1;
+		}
+	}
+
+	zone->state = PERF_ZONE_FULL;
+	assert(ns_ctx->zns.num_open > 0);
+	ns_ctx->zns.num_open--;
+}
+
+static void
+zone_reset_complete(void *ctx, const struct spdk_nvme_cpl *cpl)
+{
+	struct perf_zone *zone = ctx;
+	struct ns_worker_ctx *ns_ctx = zone->ns_ctx;
+
+	ns_ctx->current_queue_depth--;
+	if (spdk_unlikely(spdk_nvme_cpl_is_error(cpl))) {
+		RATELIMIT_LOG("Zone reset failed (sct=%d, sc=%d)\n",
+			      cpl->status.sct, cpl->status.sc);
+		if (!g_continue_on_error) {
+			ns_ctx->status = 1;
+		}
+		zone->state = PERF_ZONE_FULL;
+		return;
+	}
+
+	zone->state = PERF_ZONE_EMPTY;
+	zone->next_lba = zone->slba;
+}
+
+static void
+zone_submit_finish(struct ns_worker_ctx *ns_ctx, struct perf_zone *zone)
+{
+	struct ns_entry *entry = ns_ctx->entry;
+	int rc;
+
+	zone->state = PERF_ZONE_FINISHING;
+	rc = spdk_nvme_zns_finish_zone(entry->u.nvme.ns, ns_ctx->u.nvme.qpair[0],
+				       zone->slba, false, zone_finish_complete, zone);
+	if (rc != 0) {
+		/* Leave the zone marked for finish and retry on the next pass. */
+		zone->state = PERF_ZONE_NEED_FINISH;
+		return;
+	}
+
+	ns_ctx->current_queue_depth++;
+	ns_ctx->zns.finishes++;
+}
+
+static void
+zone_submit_reset(struct ns_worker_ctx *ns_ctx, struct perf_zone *zone)
+{
+	struct ns_entry *entry = ns_ctx->entry;
+	int rc;
+
+	zone->state = PERF_ZONE_RESETTING;
+	rc = spdk_nvme_zns_reset_zone(entry->u.nvme.ns, ns_ctx->u.nvme.qpair[0],
+				      zone->slba, false, zone_reset_complete, zone);
+	if (rc != 0) {
+		zone->state = PERF_ZONE_FULL;
+		return;
+	}
+
+	ns_ctx->current_queue_depth++;
+	ns_ctx->zns.resets++;
+}
+
+/* Pick a zone with room for one more IO and reserve the blocks in it.
+ * Returns NULL if all usable zones are busy, in which case a full zone may
+ * have been sent a reset to make progress.
+ */
+static struct perf_zone *
+zone_reserve_io(struct ns_worker_ctx *ns_ctx, struct perf_task *task)
+{
+	struct ns_entry *entry = ns_ctx->entry;
+	struct perf_zone *zone, *reset_candidate = NULL;
+	uint32_t i, idx;
+
+	for (i = 0; i < ns_ctx->zns.num_zones; i++) {
+		idx = ns_ctx->zns.next_zone + i;
+		if (idx >= ns_ctx->zns.num_zones) {
+			idx -= ns_ctx->zns.num_zones;
+		}
+		zone = &ns_ctx->zns.zones[idx];
+
+		if (zone->state == PERF_ZONE_FULL) {
+			if (reset_candidate == NULL) {
+				reset_candidate = zone;
+			}
+			continue;
+		}
+		if (zone->state == PERF_ZONE_EMPTY &&
+		    ns_ctx->zns.num_open >= entry->max_open_zones) {
+			continue;
+		}
+		if (zone->state != PERF_ZONE_EMPTY && zone->state != PERF_ZONE_OPEN) {
+			continue;
+		}
+		if (zone->outstanding >= entry->zone_qd) {
+			continue;
+		}
+		if (zone->next_lba + entry->io_size_blocks > zone->slba + zone->zcap) {
+			continue;
+		}
+
+		if (zone->state == PERF_ZONE_EMPTY) {
+			/* The first append/write opens the zone implicitly. */
+			zone->state = PERF_ZONE_OPEN;
+			ns_ctx->zns.num_open++;
+			task->zone_was_empty = true;
+		} else {
+			task->zone_was_empty = false;
+		}
+
+		task->lba = g_is_zone_append ? zone->slba : zone->next_lba;
+		task->num_blocks = entry->io_size_blocks;
+		task->is_read = false;
+		task->zone = zone;
+		zone->next_lba += entry->io_size_blocks;
+		zone->outstanding++;
+
+		if (zone->next_lba + entry->io_size_blocks > zone->slba + zone->zcap &&
+		    zone->next_lba < zone->slba + zone->zcap) {
+			/* The remainder is smaller than one IO - finish the
+			 * zone once the outstanding IO drains.
+			 */
+			zone->state = PERF_ZONE_NEED_FINISH;
+		}
+
+		ns_ctx->zns.next_zone = idx + 1 == ns_ctx->zns.num_zones ? 0 : idx + 1;
+		return zone;
+	}
+
+	/* Nothing writable - recycle a full zone so the run can continue. */
+	if (reset_candidate != NULL) {
+		zone_submit_reset(ns_ctx, reset_candidate);
+	}
+
+	return NULL;
+}
+
+/* Called from task_complete for zone workload IO. */
+static void
+zone_io_complete(struct ns_worker_ctx *ns_ctx, struct perf_task *task, uint64_t tsc_diff)
+{
+	struct perf_zone *zone = task->zone;
+
+	task->zone = NULL;
+	assert(zone->outstanding > 0);
+	zone->outstanding--;
+
+	perf_zns_lat_record(task->zone_was_empty ? &ns_ctx->zns.lat_empty : &ns_ctx->zns.lat_open,
+			    tsc_diff);
+
+	if (zone->outstanding > 0) {
+		return;
+	}
+
+	if (zone->state == PERF_ZONE_NEED_FINISH) {
+		zone_submit_finish(ns_ctx, zone);
+	} else if (zone->state == PERF_ZONE_OPEN &&
+		   zone->next_lba == zone->slba + zone->zcap) {
+		/* The device transitions exactly filled zones to full on its
+		 * own - no finish needed.
+		 */
+		zone->state = PERF_ZONE_FULL;
+		assert(ns_ctx->zns.num_open > 0);
+		ns_ctx->zns.num_open--;
+	}
+}
+
+static void submit_single_io(struct perf_task *task);
+
+/* Re-submit tasks that were parked waiting for a zone with room. */
+static void
+zone_resume_tasks(struct ns_worker_ctx *ns_ctx)
+{
+	TAILQ_HEAD(, perf_task)	swap;
+	struct perf_task *task;
+
+	TAILQ_INIT(&swap);
+	TAILQ_SWAP(&swap, &ns_ctx->zone_tasks, perf_task, link);
+	while (!TAILQ_EMPTY(&swap)) {
+		task = TAILQ_FIRST(&swap);
+		TAILQ_REMOVE(&swap, task, link);
+		if (ns_ctx->is_draining) {
+			TAILQ_INSERT_TAIL(&ns_ctx->zone_tasks, task, link);
+			continue;
+		}
+		submit_single_io(task);
+	}
+}
+
 static inline void
 submit_single_io(struct perf_task *task)
 {
 	uint64_t		offset_in_ios;
+	uint64_t		cycle_start = 0;
 	int			rc;
 	struct ns_worker_ctx	*ns_ctx = task->ns_ctx;
 	struct ns_entry		*entry = ns_ctx->entry;
 
 	assert(!ns_ctx->is_draining);
 
-	if (entry->zipf) {
-		offset_in_ios = spdk_zipf_generate(entry->zipf);
-	} else if (g_is_random) {
-		offset_in_ios = rand_r(&entry->seed) % entry->size_in_ios;
-	} else {
-		offset_in_ios = ns_ctx->offset_in_ios++;
-		if (ns_ctx->offset_in_ios == entry->size_in_ios) {
-			ns_ctx->offset_in_ios = 0;
-		}
+	if (spdk_unlikely(g_cycle_breakdown)) {
+		cycle_start = spdk_get_ticks();
 	}
 
-	task->submit_tsc = spdk_get_ticks();
+	if (g_replay_num_records > 0) {
+		const struct replay_record *rec;
+		uint64_t capacity_blocks = entry->size_in_ios * entry->io_size_blocks;
+
+		if (ns_ctx->replay_index >= g_replay_num_records) {
+			/* Trace exhausted - park the task and start draining. */
+			TAILQ_INSERT_TAIL(&ns_ctx->replay_tasks, task, link);
+			ns_ctx->is_draining = true;
+			perf_account_submit(ns_ctx, cycle_start);
+			return;
+		}
+
+		if (ns_ctx->replay_start_tsc == 0) {
+			ns_ctx->replay_start_tsc = spdk_get_ticks();
+		}
 
-	if ((g_rw_percentage == 100) ||
-	    (g_rw_percentage != 0 && ((rand_r(&entry->seed) % 100) < g_rw_percentage))) {
-		task->is_read = true;
+		if (!replay_record_due(ns_ctx)) {
+			/* Too early - park the task until the record is due. */
+			TAILQ_INSERT_TAIL(&ns_ctx->replay_tasks, task, link);
+			perf_account_submit(ns_ctx, cycle_start);
+			return;
+		}
+
+		rec = &g_replay_records[ns_ctx->replay_index++];
+		task->lba = (rec->offset_bytes / entry->block_size) % capacity_blocks;
+		task->num_blocks = spdk_max(1,
+					    (rec->length_bytes + entry->block_size - 1) / entry->block_size);
+		task->num_blocks = spdk_min(task->num_blocks, entry->io_size_blocks);
+		if (task->lba + task->num_blocks > capacity_blocks) {
+			task->lba = capacity_blocks - task->num_blocks;
+		}
+		task->is_read = rec->is_read;
+		if (entry->type != ENTRY_TYPE_NVME_NS) {
+			/* Kernel backends take the transfer size from the iovec. */
+			task->iovs[0].iov_len = task->num_blocks * entry->block_size;
+		}
+	} else if (g_is_zone_workload) {
+		if (zone_reserve_io(ns_ctx, task) == NULL) {
+			/* Park the task until a zone has room again. */
+			TAILQ_INSERT_TAIL(&ns_ctx->zone_tasks, task, link);
+			perf_account_submit(ns_ctx, cycle_start);
+			return;
+		}
 	} else {
-		task->is_read = false;
+		if (entry->zipf) {
+			offset_in_ios = spdk_zipf_generate(entry->zipf);
+		} else if (g_is_random) {
+			offset_in_ios = rand_r(&entry->seed) % entry->size_in_ios;
+		} else {
+			offset_in_ios = ns_ctx->offset_in_ios++;
+			if (ns_ctx->offset_in_ios == entry->size_in_ios) {
+				ns_ctx->offset_in_ios = 0;
+			}
+		}
+
+		task->lba = offset_in_ios * entry->io_size_blocks;
+		task->num_blocks = entry->io_size_blocks;
+
+		if ((g_rw_percentage == 100) ||
+		    (g_rw_percentage != 0 && ((rand_r(&entry->seed) % 100) < g_rw_percentage))) {
+			task->is_read = true;
+		} else {
+			task->is_read = false;
+		}
 	}
 
-	rc = entry->fn_table->submit_io(task, ns_ctx, entry, offset_in_ios);
+	task->submit_tsc = spdk_get_ticks();
+
+	rc = entry->fn_table->submit_io(task, ns_ctx, entry);
 
 	if (spdk_unlikely(rc != 0)) {
+		if (task->zone != NULL) {
+			/* Undo the zone reservation taken just above - no other
+			 * reservation can have happened in between on this thread.
+			 */
+			task->zone->outstanding--;
+			task->zone->next_lba -= task->num_blocks;
+			if (task->zone->state == PERF_ZONE_NEED_FINISH) {
+				task->zone->state = PERF_ZONE_OPEN;
+			}
+			if (task->zone_was_empty) {
+				task->zone->state = PERF_ZONE_EMPTY;
+				ns_ctx->zns.num_open--;
+			}
+			task->zone = NULL;
+		}
 		if (g_continue_on_error) {
 			/* We can't just resubmit here or we can get in a loop that
 			 * stack overflows. */
@@ -1537,6 +2143,8 @@ submit_single_io(struct perf_task *task)
 	if (spdk_unlikely(g_number_ios && ns_ctx->stats.io_submitted >= g_number_ios)) {
 		ns_ctx->is_draining = true;
 	}
+
+	perf_account_submit(ns_ctx, cycle_start);
 }
 
 static inline void
@@ -1544,6 +2152,7 @@ task_complete(struct perf_task *task)
 {
 	struct ns_worker_ctx	*ns_ctx;
 	uint64_t		tsc_diff;
+	uint64_t		cycle_start = 0, submit_tsc_before = 0;
 	struct ns_entry		*entry;
 
 	ns_ctx = task->ns_ctx;
@@ -1551,6 +2160,11 @@ task_complete(struct perf_task *task)
 	ns_ctx->current_queue_depth--;
 	ns_ctx->stats.io_completed++;
 	tsc_diff = spdk_get_ticks() - task->submit_tsc;
+	if (spdk_unlikely(g_cycle_breakdown)) {
+		/* Reuse the tick we just took rather than reading the TSC again. */
+		cycle_start = task->submit_tsc + tsc_diff;
+		submit_tsc_before = ns_ctx->stats.submit_tsc;
+	}
 	ns_ctx->stats.total_tsc += tsc_diff;
 	if (spdk_unlikely(ns_ctx->stats.min_tsc > tsc_diff)) {
 		ns_ctx->stats.min_tsc = tsc_diff;
@@ -1562,6 +2176,10 @@ task_complete(struct perf_task *task)
 		spdk_histogram_data_tally(ns_ctx->histogram, tsc_diff);
 	}
 
+	if (spdk_unlikely(task->zone != NULL)) {
+		zone_io_complete(ns_ctx, task, tsc_diff);
+	}
+
 	if (spdk_unlikely(entry->md_size > 0)) {
 		/* add application level verification for end-to-end data protection */
 		entry->fn_table->verify_io(task, entry);
@@ -1581,6 +2199,13 @@ task_complete(struct perf_task *task)
 	} else {
 		submit_single_io(task);
 	}
+
+	if (spdk_unlikely(g_cycle_breakdown)) {
+		/* Cycles spent resubmitting were already credited to the
+		 * submission path - do not count them twice. */
+		ns_ctx->stats.complete_tsc += spdk_get_ticks() - cycle_start -
+					      (ns_ctx->stats.submit_tsc - submit_tsc_before);
+	}
 }
 
 static void
@@ -1639,10 +2264,29 @@ submit_io(struct ns_worker_ctx *ns_ctx, int queue_depth)
 	}
 }
 
+/* Re-submit parked replay tasks whose records have become due. */
+static void
+replay_resume_tasks(struct ns_worker_ctx *ns_ctx)
+{
+	struct perf_task *task;
+
+	while (!TAILQ_EMPTY(&ns_ctx->replay_tasks) && !ns_ctx->is_draining &&
+	       ns_ctx->replay_index < g_replay_num_records) {
+		if (!replay_record_due(ns_ctx)) {
+			break;
+		}
+		task = TAILQ_FIRST(&ns_ctx->replay_tasks);
+		TAILQ_REMOVE(&ns_ctx->replay_tasks, task, link);
+		submit_single_io(task);
+	}
+}
+
 static int
 init_ns_worker_ctx(struct ns_worker_ctx *ns_ctx)
 {
 	TAILQ_INIT(&ns_ctx->queued_tasks);
+	TAILQ_INIT(&ns_ctx->replay_tasks);
+	TAILQ_INIT(&ns_ctx->zone_tasks);
 	return ns_ctx->entry->fn_table->init_ns_worker_ctx(ns_ctx);
 }
 
@@ -1655,6 +2299,22 @@ cleanup_ns_worker_ctx(struct ns_worker_ctx *ns_ctx)
 		TAILQ_REMOVE(&ns_ctx->queued_tasks, task, link);
 		task_complete(task);
 	}
+	TAILQ_FOREACH_SAFE(task, &ns_ctx->replay_tasks, link, ttask) {
+		/* These tasks were never submitted - just free them. */
+		TAILQ_REMOVE(&ns_ctx->replay_tasks, task, link);
+		spdk_dma_free(task->iovs[0].iov_base);
+		free(task->iovs);
+		spdk_dma_free(task->md_iov.iov_base);
+		free(task);
+	}
+	TAILQ_FOREACH_SAFE(task, &ns_ctx->zone_tasks, link, ttask) {
+		/* These tasks never got a zone reservation - just free them. */
+		TAILQ_REMOVE(&ns_ctx->zone_tasks, task, link);
+		spdk_dma_free(task->iovs[0].iov_base);
+		free(task->iovs);
+		spdk_dma_free(task->md_iov.iov_base);
+		free(task);
+	}
 	ns_ctx->entry->fn_table->cleanup_ns_worker_ctx(ns_ctx);
 }
 
@@ -1720,6 +2380,41 @@ perf_dump_transport_statistics(struct worker_thread *worker)
 	}
 }
 
+static void
+perf_dump_cycle_breakdown(struct worker_thread *worker, uint64_t total_tsc)
+{
+	struct ns_worker_ctx *ns_ctx;
+	uint64_t submit_tsc = 0, complete_tsc = 0, poll_tsc = 0, other_tsc;
+
+	TAILQ_FOREACH(ns_ctx, &worker->ns_ctx, link) {
+		submit_tsc += ns_ctx->stats.submit_tsc;
+		complete_tsc += ns_ctx->stats.complete_tsc;
+		poll_tsc += ns_ctx->stats.poll_tsc;
+	}
+
+	/* Guard against rounding in the individual samples pushing the sum
+	 * past the measured total.
+	 */
+	if (total_tsc < submit_tsc + complete_tsc + poll_tsc) {
+		total_tsc = submit_tsc + complete_tsc + poll_tsc;
+	}
+	if (total_tsc == 0) {
+		return;
+	}
+	other_tsc = total_tsc - submit_tsc - complete_tsc - poll_tsc;
+
+	printf("=====================================================\n");
+	printf("Cycle breakdown, lcore %u: %ju cycles total\n", worker->lcore, total_tsc);
+	printf("  submission path:      %14ju (%6.2f%%)\n",
+	       submit_tsc, (double)submit_tsc * 100 / total_tsc);
+	printf("  completion callbacks: %14ju (%6.2f%%)\n",
+	       complete_tsc, (double)complete_tsc * 100 / total_tsc);
+	printf("  completion polling:   %14ju (%6.2f%%)\n",
+	       poll_tsc, (double)poll_tsc * 100 / total_tsc);
+	printf("  harness/other:        %14ju (%6.2f%%)\n",
+	       other_tsc, (double)other_tsc * 100 / total_tsc);
+}
+
 static int
 work_fn(void *arg)
 {
@@ -1731,6 +2426,7 @@ work_fn(void *arg)
 	int rc;
 	int64_t check_rc;
 	uint64_t check_now;
+	uint64_t submit_tsc_before = 0, complete_tsc_before = 0;
 	TAILQ_HEAD(, perf_task)	swap;
 	struct perf_task *task;
 
@@ -1793,9 +2489,33 @@ work_fn(void *arg)
 				}
 			}
 
+			if (g_replay_num_records > 0 && !ns_ctx->is_draining) {
+				replay_resume_tasks(ns_ctx);
+			}
+
+			if (g_is_zone_workload && !ns_ctx->is_draining &&
+			    !TAILQ_EMPTY(&ns_ctx->zone_tasks)) {
+				zone_resume_tasks(ns_ctx);
+			}
+
+			if (spdk_unlikely(g_cycle_breakdown)) {
+				submit_tsc_before = ns_ctx->stats.submit_tsc;
+				complete_tsc_before = ns_ctx->stats.complete_tsc;
+			}
+
 			check_now = spdk_get_ticks();
 			check_rc = ns_ctx->entry->fn_table->check_io(ns_ctx);
 
+			if (spdk_unlikely(g_cycle_breakdown)) {
+				/* check_io() covers both CQ scanning and the completion
+				 * callbacks - subtract what was already credited to the
+				 * submission and completion buckets to isolate polling.
+				 */
+				ns_ctx->stats.poll_tsc += spdk_get_ticks() - check_now -
+							  (ns_ctx->stats.submit_tsc - submit_tsc_before) -
+							  (ns_ctx->stats.complete_tsc - complete_tsc_before);
+			}
+
 			if (check_rc > 0) {
 				ns_ctx->stats.busy_tsc += check_now - ns_ctx->stats.last_tsc;
 			} else {
@@ -1875,6 +2595,12 @@ work_fn(void *arg)
 		pthread_mutex_unlock(&g_stats_mutex);
 	}
 
+	if (g_cycle_breakdown) {
+		pthread_mutex_lock(&g_stats_mutex);
+		perf_dump_cycle_breakdown(worker, tsc_current - tsc_start);
+		pthread_mutex_unlock(&g_stats_mutex);
+	}
+
 	TAILQ_FOREACH(ns_ctx, &worker->ns_ctx, link) {
 		cleanup_ns_worker_ctx(ns_ctx);
 	}
@@ -1882,6 +2608,110 @@ work_fn(void *arg)
 	return 0;
 }
 
+static int
+replay_compare_records(const void *a, const void *b)
+{
+	const struct replay_record *rec_a = a;
+	const struct replay_record *rec_b = b;
+
+	if (rec_a->timestamp_us < rec_b->timestamp_us) {
+		return -1;
+	} else if (rec_a->timestamp_us > rec_b->timestamp_us) {
+		return 1;
+	}
+
+	return 0;
+}
+
+static int
+replay_load_trace(const char *path)
+{
+	FILE *file;
+	char line[256];
+	char rwbs[16];
+	double timestamp;
+	uint64_t offset_sectors, length_bytes;
+	uint64_t num_records = 0, capacity = 0, base_us, i;
+	struct replay_record *records = NULL, *tmp, *rec;
+	int lineno = 0;
+
+	file = fopen(path, "r");
+	if (file == NULL) {
+		fprintf(stderr, "Could not open replay trace %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		lineno++;
+		if (line[0] == '#' || line[0] == '\n') {
+			continue;
+		}
+
+		if (sscanf(line, "%lf %15s %" SCNu64 " %" SCNu64,
+			   &timestamp, rwbs, &offset_sectors, &length_bytes) != 4) {
+			fprintf(stderr, "Malformed line %d in replay trace %s\n", lineno, path);
+			free(records);
+			fclose(file);
+			return -1;
+		}
+
+		/* Skip records that do not transfer data (e.g. standalone flushes) */
+		if ((strchr(rwbs, 'R') == NULL && strchr(rwbs, 'W') == NULL) ||
+		    length_bytes == 0 || length_bytes > UINT32_MAX) {
+			continue;
+		}
+
+		if (num_records == capacity) {
+			capacity = capacity ? capacity * 2 : 4096;
+			tmp = realloc(records, capacity * sizeof(*records));
+			if (tmp == NULL) {
+				fprintf(stderr, "Out of memory loading replay trace\n");
+				free(records);
+				fclose(file);
+				return -1;
+			}
+			records = tmp;
+		}
+
+		rec = &records[num_records++];
+		rec->timestamp_us = (uint64_t)(timestamp * SPDK_SEC_TO_USEC);
+		rec->offset_bytes = offset_sectors * 512;
+		rec->length_bytes = (uint32_t)length_bytes;
+		rec->is_read = strchr(rwbs, 'R') != NULL;
+
+		if (rec->length_bytes > g_replay_max_io_bytes) {
+			g_replay_max_io_bytes = rec->length_bytes;
+		}
+	}
+
+	fclose(file);
+
+	if (num_records == 0) {
+		fprintf(stderr, "Replay trace %s contains no I/O records\n", path);
+		free(records);
+		return -1;
+	}
+
+	/* Traces captured on multiple CPUs are not necessarily in time order. */
+	qsort(records, num_records, sizeof(*records), replay_compare_records);
+
+	/* Make timestamps relative to the first I/O. */
+	base_us = records[0].timestamp_us;
+	for (i = 0; i < num_records; i++) {
+		records[i].timestamp_us -= base_us;
+	}
+
+	g_replay_records = records;
+	g_replay_num_records = num_records;
+
+	printf("Loaded %" PRIu64 " I/Os from replay trace %s (duration %.3f s, max I/O %u bytes)\n",
+	       num_records, path,
+	       (double)records[num_records - 1].timestamp_us / SPDK_SEC_TO_USEC,
+	       g_replay_max_io_bytes);
+
+	return 0;
+}
+
 static void
 usage(char *program_name)
 {
@@ -1895,6 +2725,9 @@ usage(char *program_name)
 	printf("\t-o, --io-size <val> io size in bytes\n");
 	printf("\t-w, --io-pattern <pattern> io pattern type, must be one of\n");
 	printf("\t\t(read, write, randread, randwrite, rw, randrw)\n");
+	printf("\t\tor, for zoned namespaces, one of\n");
+	printf("\t\t(zappend, zwrite) - zone append or sequential writes to\n");
+	printf("\t\tsequential-write-required zones.  Zones are reset at startup.\n");
 	printf("\t-M, --rwmixread <0-100> rwmixread (100 for reads, 0 for writes)\n");
 	printf("\t-t, --time <sec> time in seconds\n");
 	printf("\t-a, --warmup-time <sec> warmup time in seconds\n");
@@ -1937,6 +2770,14 @@ usage(char *program_name)
 	printf("\t\t Example: -e 'PRACT=0,PRCHK=GUARD|REFTAG|APPTAG'\n");
 	printf("\t\t          -e 'PRACT=1,PRCHK=GUARD'\n");
 	printf("\t-F, --zipf <theta> use zipf distribution for random I/O\n");
+	printf("\t--replay <path> replay I/Os from a captured trace instead of generating a synthetic pattern.\n");
+	printf("\t\t Each line describes one I/O: \"<time_sec> <rwbs> <offset_sectors> <length_bytes>\"\n");
+	printf("\t\t as produced e.g. by blkparse -a issue -f \"%%T.%%t %%d %%S %%N\\n\".\n");
+	printf("\t\t Lines starting with '#' are ignored. I/O sizes and offsets are preserved;\n");
+	printf("\t\t offsets wrap around at the end of the namespace.\n");
+	printf("\t--replay-time-scale <ratio> scale the replayed inter-I/O delays.\n");
+	printf("\t\t 1.0 replays the original timing, 2.0 replays at half speed,\n");
+	printf("\t\t 0 ignores timing and replays as fast as possible. default: 1.0\n");
 #ifdef SPDK_CONFIG_URING
 	printf("\t-R, --enable-uring enable using liburing to drive kernel devices (Default: libaio)\n");
 #endif
@@ -1987,6 +2828,9 @@ usage(char *program_name)
 	printf("\t-G, --enable-debug enable debug logging (flag disabled, must reconfigure with --enable-debug)\n");
 #endif
 	printf("\t--transport-stats dump transport statistics\n");
+	printf("\t--cycle-breakdown report per-core CPU cycle accounting at exit,\n");
+	printf("\t\t split into submission path, completion callbacks,\n");
+	printf("\t\t completion queue polling and harness overhead\n");
 	printf("\n\n");
 }
 
@@ -2025,6 +2869,20 @@ print_bucket(void *ctx, uint64_t start, uint64_t end, uint64_t count,
 	       so_far_pct, count);
 }
 
+static void
+print_zone_latency(const char *name, struct perf_zns_lat *lat)
+{
+	if (lat->count == 0) {
+		return;
+	}
+
+	printf("  %-28s: %10" PRIu64 " IOs, avg %10.2f us, min %10.2f us, max %10.2f us\n",
+	       name, lat->count,
+	       ((double)lat->total_tsc / lat->count) * 1000 * 1000 / g_tsc_rate,
+	       (double)lat->min_tsc * 1000 * 1000 / g_tsc_rate,
+	       (double)lat->max_tsc * 1000 * 1000 / g_tsc_rate);
+}
+
 static void
 print_performance(void)
 {
@@ -2096,6 +2954,23 @@ print_performance(void)
 		printf("\n");
 	}
 
+	if (g_is_zone_workload) {
+		printf("%s latency by zone state at submission:\n",
+		       g_is_zone_append ? "Zone append" : "Zone write");
+		printf("========================================================\n");
+		TAILQ_FOREACH(worker, &g_workers, link) {
+			TAILQ_FOREACH(ns_ctx, &worker->ns_ctx, link) {
+				printf("%-*.*s from core %2u (%" PRIu64 " zone finishes, %" PRIu64
+				       " zone resets):\n", max_strlen, max_strlen,
+				       ns_ctx->entry->name, worker->lcore,
+				       ns_ctx->zns.finishes, ns_ctx->zns.resets);
+				print_zone_latency("empty zone (implicit open)", &ns_ctx->zns.lat_empty);
+				print_zone_latency("open zone", &ns_ctx->zns.lat_open);
+			}
+		}
+		printf("\n");
+	}
+
 	if (g_latency_sw_tracking_level == 0 || total_io_completed == 0) {
 		return;
 	}
@@ -2506,6 +3381,12 @@ static const struct option g_perf_cmdline_opts[] = {
 	{"use-every-core", no_argument, NULL, PERF_USE_EVERY_CORE},
 #define PERF_NO_HUGE		270
 	{"no-huge", no_argument, NULL, PERF_NO_HUGE},
+#define PERF_REPLAY_FILE	271
+	{"replay", required_argument, NULL, PERF_REPLAY_FILE},
+#define PERF_REPLAY_TIME_SCALE	272
+	{"replay-time-scale", required_argument, NULL, PERF_REPLAY_TIME_SCALE},
+#define PERF_CYCLE_BREAKDOWN	273
+	{"cycle-breakdown", no_argument, NULL, PERF_CYCLE_BREAKDOWN},
 	/* Should be the last element */
 	{0, 0, 0, 0}
 };
@@ -2772,6 +3653,20 @@ parse_args(int argc, char **argv, struct spdk_env_opts *env_opts)
 		case PERF_NO_HUGE:
 			env_opts->no_huge = true;
 			break;
+		case PERF_REPLAY_FILE:
+			g_replay_file = optarg;
+			break;
+		case PERF_REPLAY_TIME_SCALE:
+			errno = 0;
+			g_replay_time_scale = strtod(optarg, &endptr);
+			if (errno || optarg == endptr || g_replay_time_scale < 0) {
+				fprintf(stderr, "Illegal replay time scale value %s\n", optarg);
+				return 1;
+			}
+			break;
+		case PERF_CYCLE_BREAKDOWN:
+			g_cycle_breakdown = true;
+			break;
 		case PERF_HELP:
 			usage(argv[0]);
 			return HELP_RETURN_CODE;
@@ -2791,6 +3686,29 @@ parse_args(int argc, char **argv, struct spdk_env_opts *env_opts)
 		usage(argv[0]);
 		return 1;
 	}
+	if (g_replay_file != NULL) {
+		if (replay_load_trace(g_replay_file) != 0) {
+			return 1;
+		}
+		if (g_io_size_bytes < g_replay_max_io_bytes) {
+			if (g_io_size_bytes) {
+				fprintf(stderr, "Raising -o (--io-size) to fit the largest replayed I/O\n");
+			}
+			/* Keep the buffers a multiple of any sane sector size. */
+			g_io_size_bytes = SPDK_ALIGN_CEIL(g_replay_max_io_bytes, 4096);
+		}
+		if (!g_workload_type) {
+			/* The pattern comes from the trace itself. */
+			g_workload_type = "rw";
+			if (g_rw_percentage < 0) {
+				g_rw_percentage = 50;
+			}
+		}
+		if (!g_time_in_sec) {
+			/* Run until the trace is exhausted. */
+			g_time_in_sec = INT_MAX;
+		}
+	}
 	if (!g_io_size_bytes) {
 		fprintf(stderr, "missing -o (--io-size) operand\n");
 		usage(argv[0]);
@@ -2841,10 +3759,27 @@ parse_args(int argc, char **argv, struct spdk_env_opts *env_opts)
 				"for rw or randrw.\n");
 			return 1;
 		}
+	} else if (strcmp(g_workload_type, "zappend") == 0 || strcmp(g_workload_type, "zwrite") == 0) {
+		g_is_zone_workload = true;
+		g_is_zone_append = strcmp(g_workload_type, "zappend") == 0;
+		g_rw_percentage = 0;
+		if (g_is_random) {
+			fprintf(stderr, "Zone workloads are sequential within each zone - "
+				"rand prefix is not supported with zappend/zwrite.\n");
+			return 1;
+		}
+		if (g_mix_specified) {
+			fprintf(stderr, "Ignoring -M (--rwmixread) option... Please use -M option"
+				" only when using rw or randrw.\n");
+		}
+		if (g_replay_file) {
+			fprintf(stderr, "--replay is not supported with zappend/zwrite.\n");
+			return 1;
+		}
 	} else {
 		fprintf(stderr,
 			"-w (--io-pattern) io pattern type must be one of\n"
-			"(read, write, randread, randwrite, rw, randrw)\n");
+			"(read, write, randread, randwrite, rw, randrw, zappend, zwrite)\n");
 		return 1;
 	}
 
@@ -3091,6 +4026,8 @@ allocate_ns_worker(struct ns_entry *entry, struct worker_thread *worker)
 	printf("Associating %s with lcore %d\n", entry->name, worker->lcore);
 	ns_ctx->stats.min_tsc = UINT64_MAX;
 	ns_ctx->entry = entry;
+	/* Workers sharing a namespace each own a disjoint stripe of its zones. */
+	ns_ctx->zns.ctx_id = entry->zns_ctx_count++;
 	ns_ctx->histogram = spdk_histogram_data_alloc();
 	TAILQ_INSERT_TAIL(&worker->ns_ctx, ns_ctx, link);
 
@@ -404,6 +404,10 @@ usage(void)
 	fprintf(stderr, "                      newest trace file in /dev/shm\n");
 #endif
 	fprintf(stderr, "                 '-j' to use JSON to format the output\n");
+	fprintf(stderr, "                 '-b' to only print traces recorded at or after\n");
+	fprintf(stderr, "                      the given tsc\n");
+	fprintf(stderr, "                 '-e' to only print traces recorded at or before\n");
+	fprintf(stderr, "                      the given tsc\n");
 }
 
 #if defined(__linux__)
@@ -428,6 +432,7 @@ main(int argc, char **argv)
 	struct spdk_trace_parser_opts	opts;
 	enum print_format_type	print_format = PRINT_FMT_DEFAULT;
 	int				lcore = SPDK_TRACE_MAX_LCORE;
+	uint64_t			tsc_start = 0, tsc_end = 0;
 	const char			*app_name = NULL;
 	const char			*file_name = NULL;
 	int				op;
@@ -436,8 +441,14 @@ main(int argc, char **argv)
 	int				shm_id = -1, shm_pid = -1;
 
 	g_exe_name = argv[0];
-	while ((op = getopt(argc, argv, "c:f:i:jp:s:t")) != -1) {
+	while ((op = getopt(argc, argv, "b:c:e:f:i:jp:s:t")) != -1) {
 		switch (op) {
+		case 'b':
+			tsc_start = strtoull(optarg, NULL, 10);
+			break;
+		case 'e':
+			tsc_end = strtoull(optarg, NULL, 10);
+			break;
 		case 'c':
 			lcore = atoi(optarg);
 			if (lcore > SPDK_TRACE_MAX_LCORE) {
@@ -506,6 +517,8 @@ main(int argc, char **argv)
 
 	opts.filename = file_name;
 	opts.lcore = lcore;
+	opts.tsc_start = tsc_start;
+	opts.tsc_end = tsc_end;
 	opts.mode = app_name == NULL ? SPDK_TRACE_PARSER_MODE_FILE : SPDK_TRACE_PARSER_MODE_SHM;
 	g_parser = spdk_trace_parser_init(&opts);
 	if (g_parser == NULL) {
@@ -0,0 +1,292 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2016 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#include "spdk/stdinc.h"
+#include "spdk/env.h"
+#include "spdk/likely.h"
+#include "spdk/string.h"
+#include "spdk/util.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+extern "C" {
+#include "spdk/trace_parser.h"
+#include "spdk/util.h"
+}
+
+static struct spdk_trace_parser *g_parser;
+static const struct spdk_trace_file *g_file;
+
+/* This is a bit ugly, but we don't want to include env_dpdk in the app, while spdk_util, which we
+ * do need, uses some of the functions implemented there.  We're not actually using the functions
+ * that depend on those, so just define them as no-ops to allow the app to link.
+ */
+extern "C" {
+	void *
+	spdk_realloc(void *buf, size_t size, size_t align)
+	{
+		assert(false);
+
+		return NULL;
+	}
+
+	void
+	spdk_free(void *buf)
+	{
+		assert(false);
+	}
+
+	uint64_t
+	spdk_get_ticks(void)
+	{
+		return 0;
+	}
+} /* extern "C" */
+
+static char *g_exe_name;
+
+/* (object_type, object_index) uniquely identifies one request/object instance */
+typedef std::pair<uint8_t, uint64_t> object_key;
+
+struct object_life {
+	uint64_t	start;
+	uint64_t	end;
+};
+
+/* Latency samples, one distribution per breakdown stage */
+typedef std::vector<uint64_t> sample_vector;
+
+/* Time from the owning object's creation to each of its tracepoints */
+static std::map<uint16_t, sample_vector> g_tpoint_latency;
+/* Lifetime of each object instance, aggregated per object type */
+static std::map<uint8_t, sample_vector> g_object_latency;
+/* Time from a parent object's creation to the creation of an object related to it,
+ * e.g. from an nvmf request to the bdev_io submitted on its behalf.  This is what
+ * ties the stages of one request together across tpoint groups.
+ */
+static std::map<std::pair<uint8_t, uint8_t>, sample_vector> g_handoff_latency;
+
+static std::map<object_key, object_life> g_objects;
+
+static float
+get_us_from_tsc(uint64_t tsc, uint64_t tsc_rate)
+{
+	return ((float)tsc) * 1000 * 1000 / tsc_rate;
+}
+
+static uint64_t
+percentile(const sample_vector &samples, float p)
+{
+	size_t idx = (size_t)((samples.size() - 1) * p / 100);
+
+	return samples[idx];
+}
+
+static void
+print_header(const char *title)
+{
+	printf("\n%s\n", title);
+	printf("%-32s %10s %10s %10s %10s %10s %10s\n",
+	       "", "count", "avg (us)", "p50 (us)", "p90 (us)", "p99 (us)", "max (us)");
+}
+
+static void
+print_row(const char *name, sample_vector &samples)
+{
+	uint64_t sum = 0;
+
+	if (samples.empty()) {
+		return;
+	}
+
+	std::sort(samples.begin(), samples.end());
+	for (uint64_t sample : samples) {
+		sum += sample;
+	}
+
+	printf("%-32s %10zu %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+	       name, samples.size(),
+	       get_us_from_tsc(sum / samples.size(), g_file->tsc_rate),
+	       get_us_from_tsc(percentile(samples, 50), g_file->tsc_rate),
+	       get_us_from_tsc(percentile(samples, 90), g_file->tsc_rate),
+	       get_us_from_tsc(percentile(samples, 99), g_file->tsc_rate),
+	       get_us_from_tsc(samples.back(), g_file->tsc_rate));
+}
+
+static void
+process_entry(struct spdk_trace_parser_entry *entry)
+{
+	const struct spdk_trace_tpoint *tpoint;
+	std::map<object_key, object_life>::iterator parent;
+	uint64_t tsc = entry->entry->tsc;
+
+	tpoint = &g_file->tpoint[entry->entry->tpoint_id];
+	if (tpoint->object_type == OBJECT_NONE || entry->object_index == UINT64_MAX ||
+	    entry->object_start == UINT64_MAX) {
+		return;
+	}
+
+	object_key key(tpoint->object_type, entry->object_index);
+	object_life &life = g_objects[key];
+
+	life.start = entry->object_start;
+	life.end = tsc;
+
+	/* Time from the object's creation to this tracepoint - the per-stage breakdown */
+	g_tpoint_latency[entry->entry->tpoint_id].push_back(tsc - entry->object_start);
+
+	/* A related object is the request one layer up that this object was created for.
+	 * The delta between their creation times is the handoff latency between layers.
+	 */
+	if (tpoint->new_object && entry->related_type != OBJECT_NONE) {
+		parent = g_objects.find(object_key(entry->related_type, entry->related_index));
+		if (parent != g_objects.end() && parent->second.start <= entry->object_start) {
+			g_handoff_latency[std::make_pair(entry->related_type, tpoint->object_type)]
+			.push_back(entry->object_start - parent->second.start);
+		}
+	}
+}
+
+static void
+print_report(void)
+{
+	char name[64];
+
+	print_header("Tracepoint latency (time since start of owning object):");
+	for (auto &kv : g_tpoint_latency) {
+		print_row(g_file->tpoint[kv.first].name, kv.second);
+	}
+
+	print_header("Object lifetime (first to last tracepoint):");
+	for (auto &kv : g_object_latency) {
+		snprintf(name, sizeof(name), "%c (object type %u)",
+			 g_file->object[kv.first].id_prefix, kv.first);
+		print_row(name, kv.second);
+	}
+
+	print_header("Cross-layer handoff (parent object start to child object start):");
+	for (auto &kv : g_handoff_latency) {
+		snprintf(name, sizeof(name), "%c -> %c",
+			 g_file->object[kv.first.first].id_prefix,
+			 g_file->object[kv.first.second].id_prefix);
+		print_row(name, kv.second);
+	}
+}
+
+static void
+usage(void)
+{
+	fprintf(stderr, "usage:\n");
+	fprintf(stderr, "   %s <option>\n", g_exe_name);
+	fprintf(stderr, "                 '-s' to specify spdk_trace shm name for a\n");
+	fprintf(stderr, "                      currently running process\n");
+	fprintf(stderr, "                 '-i' to specify the shared memory ID\n");
+	fprintf(stderr, "                 '-p' to specify the trace PID\n");
+	fprintf(stderr, "                      (If -s is specified, then one of\n");
+	fprintf(stderr, "                       -i or -p must be specified)\n");
+	fprintf(stderr, "                 '-f' to specify a tracepoint file name\n");
+	fprintf(stderr, "                      (-s and -f are mutually exclusive)\n");
+	fprintf(stderr, "                 '-b' to only include traces recorded at or after\n");
+	fprintf(stderr, "                      the given tsc\n");
+	fprintf(stderr, "                 '-e' to only include traces recorded at or before\n");
+	fprintf(stderr, "                      the given tsc\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	struct spdk_trace_parser_opts	opts;
+	struct spdk_trace_parser_entry	entry;
+	uint64_t			tsc_start = 0, tsc_end = 0;
+	const char			*app_name = NULL;
+	const char			*file_name = NULL;
+	int				op;
+	char				shm_name[64];
+	int				shm_id = -1, shm_pid = -1;
+	std::map<object_key, object_life>::iterator it;
+
+	g_exe_name = argv[0];
+	while ((op = getopt(argc, argv, "b:e:f:i:p:s:")) != -1) {
+		switch (op) {
+		case 'b':
+			tsc_start = strtoull(optarg, NULL, 10);
+			break;
+		case 'e':
+			tsc_end = strtoull(optarg, NULL, 10);
+			break;
+		case 'i':
+			shm_id = atoi(optarg);
+			break;
+		case 'p':
+			shm_pid = atoi(optarg);
+			break;
+		case 's':
+			app_name = optarg;
+			break;
+		case 'f':
+			file_name = optarg;
+			break;
+		default:
+			usage();
+			exit(1);
+		}
+	}
+
+	if (file_name != NULL && app_name != NULL) {
+		fprintf(stderr, "-f and -s are mutually exclusive\n");
+		usage();
+		exit(1);
+	}
+
+	if (file_name == NULL && app_name == NULL) {
+		fprintf(stderr, "One of -f and -s must be specified\n");
+		usage();
+		exit(1);
+	}
+
+	if (!file_name) {
+		if (shm_id >= 0) {
+			snprintf(shm_name, sizeof(shm_name), "/%s_trace.%d", app_name, shm_id);
+		} else {
+			snprintf(shm_name, sizeof(shm_name), "/%s_trace.pid%d", app_name, shm_pid);
+		}
+		file_name = shm_name;
+	}
+
+	opts.filename = file_name;
+	opts.lcore = SPDK_TRACE_MAX_LCORE;
+	opts.mode = app_name == NULL ? SPDK_TRACE_PARSER_MODE_FILE : SPDK_TRACE_PARSER_MODE_SHM;
+	opts.tsc_start = tsc_start;
+	opts.tsc_end = tsc_end;
+	g_parser = spdk_trace_parser_init(&opts);
+	if (g_parser == NULL) {
+		fprintf(stderr, "Failed to initialize trace parser\n");
+		exit(1);
+	}
+
+	g_file = spdk_trace_parser_get_file(g_parser);
+	while (spdk_trace_parser_next_entry(g_parser, &entry)) {
+		if (entry.entry->tsc < spdk_trace_parser_get_tsc_offset(g_parser)) {
+			continue;
+		}
+		process_entry(&entry);
+	}
+
+	/* Lifetimes can only be aggregated once all entries of each object were seen */
+	for (it = g_objects.begin(); it != g_objects.end(); it++) {
+		if (it->second.end > it->second.start) {
+			g_object_latency[it->first.first].push_back(it->second.end -
+					it->second.start);
+		}
+	}
+
+	print_report();
+
+	spdk_trace_parser_cleanup(g_parser);
+
+	return 0;
+}
@@ -16,6 +16,7 @@
 
 static char *g_exe_name;
 static int g_verbose = 1;
+static int g_stream_fd = -1;
 static uint64_t g_tsc_rate;
 static uint64_t g_utsc_rate;
 static bool g_shutdown = false;
@@ -39,6 +40,17 @@ struct lcore_trace_record_ctx {
 	uint64_t num_entries;
 };
 
+/* Framing used in streaming mode ('-t').  The stream starts with one chunk
+ * carrying the raw struct spdk_trace_file metadata (lcore == UINT32_MAX), so
+ * that the collector can decode tracepoint definitions and the tsc rate.
+ * Each subsequent chunk carries a contiguous run of spdk_trace_entry
+ * structures recorded on the given lcore.
+ */
+struct stream_chunk_hdr {
+	uint32_t lcore;
+	uint32_t len;
+};
+
 struct aggr_trace_record_ctx {
 	const char *out_file;
 	int out_fd;
@@ -255,6 +267,26 @@ cont_read(int fildes, void *buf, size_t nbyte)
 	return nbyte;
 }
 
+static int
+append_entries(int fd, struct spdk_trace_history *in_history, int start, uint64_t count)
+{
+	struct stream_chunk_hdr hdr;
+	int rc;
+
+	if (g_stream_fd >= 0) {
+		hdr.lcore = in_history->lcore;
+		hdr.len = count * sizeof(struct spdk_trace_entry);
+		rc = cont_write(g_stream_fd, &hdr, sizeof(hdr));
+		if (rc < 0) {
+			return rc;
+		}
+
+		fd = g_stream_fd;
+	}
+
+	return cont_write(fd, &in_history->entries[start], count * sizeof(struct spdk_trace_entry));
+}
+
 static int
 lcore_trace_last_entry_idx(struct spdk_trace_history *in_history, int cir_next_idx)
 {
@@ -280,8 +312,7 @@ circular_buffer_padding_backward(int fd, struct spdk_trace_history *in_history,
 		return -1;
 	}
 
-	rc = cont_write(fd, &in_history->entries[cir_start],
-			sizeof(struct spdk_trace_entry) * (cir_end - cir_start));
+	rc = append_entries(fd, in_history, cir_start, cir_end - cir_start);
 	if (rc < 0) {
 		fprintf(stderr, "Failed to append entries into lcore file\n");
 		return rc;
@@ -302,8 +333,7 @@ circular_buffer_padding_across(int fd, struct spdk_trace_history *in_history,
 		return -1;
 	}
 
-	rc = cont_write(fd, &in_history->entries[cir_start],
-			sizeof(struct spdk_trace_entry) * (num_entries - cir_start));
+	rc = append_entries(fd, in_history, cir_start, num_entries - cir_start);
 	if (rc < 0) {
 		fprintf(stderr, "Failed to append entries into lcore file backward\n");
 		return rc;
@@ -313,7 +343,7 @@ circular_buffer_padding_across(int fd, struct spdk_trace_history *in_history,
 		return 0;
 	}
 
-	rc = cont_write(fd, &in_history->entries[0], sizeof(struct spdk_trace_entry) * cir_end);
+	rc = append_entries(fd, in_history, 0, cir_end);
 	if (rc < 0) {
 		fprintf(stderr, "Failed to append entries into lcore file forward\n");
 		return rc;
@@ -422,7 +452,9 @@ out:
 	}
 
 	/* Update tpoint_count info */
-	memcpy(lcore_port->out_history, lcore_port->in_history, sizeof(struct spdk_trace_history));
+	if (lcore_port->out_history != NULL) {
+		memcpy(lcore_port->out_history, lcore_port->in_history, sizeof(struct spdk_trace_history));
+	}
 
 	/* Update last_entry_tsc to align with appended entries */
 	last_idx = lcore_trace_last_entry_idx(in_history, shm_cir_next);
@@ -432,6 +464,80 @@ out:
 	return rc;
 }
 
+/* Append the time index footer past file_size bytes, where readers that predate
+ * the index never look. Sample i of an lcore is the tsc of entry i * stride of
+ * its trace history, which lets tools seek to a time range without scanning the
+ * whole file.
+ */
+static int
+trace_file_index_append(struct aggr_trace_record_ctx *ctx)
+{
+	struct spdk_trace_index_footer *footer;
+	struct lcore_trace_record_ctx *lcore_port;
+	struct spdk_trace_entry entry;
+	uint64_t num_samples, offset;
+	uint64_t j;
+	int rc, i;
+
+	footer = calloc(1, sizeof(*footer));
+	if (footer == NULL) {
+		fprintf(stderr, "Failed to allocate memory for index footer.\n");
+		return -1;
+	}
+
+	footer->magic = SPDK_TRACE_INDEX_MAGIC;
+	footer->stride = SPDK_TRACE_INDEX_STRIDE;
+
+	offset = sizeof(*footer);
+	for (i = 0; i < SPDK_TRACE_MAX_LCORE; i++) {
+		lcore_port = &ctx->lcore_ports[i];
+		if (!lcore_port->valid || lcore_port->num_entries == 0) {
+			continue;
+		}
+
+		num_samples = (lcore_port->num_entries + SPDK_TRACE_INDEX_STRIDE - 1) /
+			      SPDK_TRACE_INDEX_STRIDE;
+		footer->lcores[i].num_samples = num_samples;
+		footer->lcores[i].sample_offset = offset;
+		offset += num_samples * sizeof(uint64_t);
+	}
+
+	rc = cont_write(ctx->out_fd, footer, sizeof(*footer));
+	if (rc < 0) {
+		fprintf(stderr, "Failed to write index footer into trace file\n");
+		goto out;
+	}
+
+	for (i = 0; i < SPDK_TRACE_MAX_LCORE; i++) {
+		lcore_port = &ctx->lcore_ports[i];
+		if (footer->lcores[i].num_samples == 0) {
+			continue;
+		}
+
+		for (j = 0; j < footer->lcores[i].num_samples; j++) {
+			rc = pread(lcore_port->fd, &entry, sizeof(entry),
+				   j * SPDK_TRACE_INDEX_STRIDE * sizeof(entry));
+			if (rc != sizeof(entry)) {
+				fprintf(stderr, "Failed to read entry for index footer\n");
+				rc = -1;
+				goto out;
+			}
+
+			rc = cont_write(ctx->out_fd, &entry.tsc, sizeof(entry.tsc));
+			if (rc < 0) {
+				fprintf(stderr, "Failed to write tsc sample into trace file\n");
+				goto out;
+			}
+		}
+	}
+
+	rc = 0;
+out:
+	free(footer);
+
+	return rc;
+}
+
 static int
 trace_files_aggregate(struct aggr_trace_record_ctx *ctx)
 {
@@ -547,6 +653,11 @@ trace_files_aggregate(struct aggr_trace_record_ctx *ctx)
 		goto out;
 	}
 
+	rc = trace_file_index_append(ctx);
+	if (rc < 0) {
+		goto out;
+	}
+
 	printf("All lcores trace entries are aggregated into trace file %s\n", ctx->out_file);
 	return 0;
 
@@ -556,6 +667,82 @@ out:
 	return rc;
 }
 
+static int
+stream_connect(struct aggr_trace_record_ctx *ctx, const char *collector_addr)
+{
+	struct addrinfo hints = {};
+	struct addrinfo *res, *ai;
+	struct stream_chunk_hdr hdr;
+	char *addr, *host, *port;
+	int fd = -1;
+	int rc;
+
+	addr = strdup(collector_addr);
+	if (addr == NULL) {
+		return -1;
+	}
+
+	host = addr;
+	port = strrchr(addr, ':');
+	if (port == NULL) {
+		fprintf(stderr, "Collector address (%s) must be in host:port format.\n", collector_addr);
+		free(addr);
+		return -1;
+	}
+	*port++ = '\0';
+
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	rc = getaddrinfo(host, port, &hints, &res);
+	if (rc != 0) {
+		fprintf(stderr, "Could not resolve collector address %s: %s.\n", collector_addr,
+			gai_strerror(rc));
+		free(addr);
+		return -1;
+	}
+
+	for (ai = res; ai != NULL; ai = ai->ai_next) {
+		fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+		if (fd < 0) {
+			continue;
+		}
+
+		if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+			break;
+		}
+
+		close(fd);
+		fd = -1;
+	}
+
+	freeaddrinfo(res);
+	free(addr);
+
+	if (fd < 0) {
+		fprintf(stderr, "Could not connect to collector %s.\n", collector_addr);
+		return -1;
+	}
+
+	g_stream_fd = fd;
+
+	/* Ship the trace metadata first, so the collector can decode the entries */
+	hdr.lcore = UINT32_MAX;
+	hdr.len = sizeof(struct spdk_trace_file);
+	rc = cont_write(g_stream_fd, &hdr, sizeof(hdr));
+	if (rc < 0) {
+		return rc;
+	}
+
+	rc = cont_write(g_stream_fd, ctx->trace_file, sizeof(struct spdk_trace_file));
+	if (rc < 0) {
+		return rc;
+	}
+
+	printf("Start to stream trace entries to collector %s\n", collector_addr);
+	return 0;
+}
+
 static void
 __shutdown_signal(int signo)
 {
@@ -602,6 +789,10 @@ usage(void)
 	printf("                 '-p' to specify the trace PID\n");
 	printf("                      (one of -i or -p must be specified)\n");
 	printf("                 '-f' to specify output trace file name\n");
+	printf("                 '-t' to continuously stream trace entries to a\n");
+	printf("                      collector at the given host:port instead of\n");
+	printf("                      writing them to a file\n");
+	printf("                      (one of -f or -t must be specified)\n");
 	printf("                 '-h' to print usage information\n");
 }
 
@@ -610,6 +801,7 @@ main(int argc, char **argv)
 {
 	const char			*app_name = NULL;
 	const char			*file_name = NULL;
+	const char			*collector_addr = NULL;
 	int				op;
 	char				shm_name[64];
 	int				shm_id = -1, shm_pid = -1;
@@ -619,7 +811,7 @@ main(int argc, char **argv)
 	struct lcore_trace_record_ctx	*lcore_port;
 
 	g_exe_name = argv[0];
-	while ((op = getopt(argc, argv, "f:i:p:qs:h")) != -1) {
+	while ((op = getopt(argc, argv, "f:i:p:qs:t:h")) != -1) {
 		switch (op) {
 		case 'i':
 			shm_id = spdk_strtol(optarg, 10);
@@ -636,6 +828,9 @@ main(int argc, char **argv)
 		case 'f':
 			file_name = optarg;
 			break;
+		case 't':
+			collector_addr = optarg;
+			break;
 		case 'h':
 			usage();
 			exit(EXIT_SUCCESS);
@@ -645,8 +840,14 @@ main(int argc, char **argv)
 		}
 	}
 
-	if (file_name == NULL) {
-		fprintf(stderr, "-f must be specified\n");
+	if (file_name == NULL && collector_addr == NULL) {
+		fprintf(stderr, "-f or -t must be specified\n");
+		usage();
+		exit(1);
+	}
+
+	if (file_name != NULL && collector_addr != NULL) {
+		fprintf(stderr, "-f and -t cannot both be specified\n");
 		usage();
 		exit(1);
 	}
@@ -679,7 +880,11 @@ main(int argc, char **argv)
 		exit(1);
 	}
 
-	rc = output_trace_files_prepare(&ctx, file_name);
+	if (collector_addr != NULL) {
+		rc = stream_connect(&ctx, collector_addr);
+	} else {
+		rc = output_trace_files_prepare(&ctx, file_name);
+	}
 	if (rc) {
 		exit(1);
 	}
@@ -703,10 +908,12 @@ main(int argc, char **argv)
 		exit(1);
 	}
 
-	printf("Start to aggregate lcore trace files\n");
-	rc = trace_files_aggregate(&ctx);
-	if (rc) {
-		exit(1);
+	if (collector_addr == NULL) {
+		printf("Start to aggregate lcore trace files\n");
+		rc = trace_files_aggregate(&ctx);
+		if (rc) {
+			exit(1);
+		}
 	}
 
 	/* Summary report */
@@ -727,7 +934,11 @@ main(int argc, char **argv)
 	munmap(ctx.trace_file, g_file_size);
 	close(ctx.shm_fd);
 
-	output_trace_files_finish(&ctx);
+	if (collector_addr != NULL) {
+		close(g_stream_fd);
+	} else {
+		output_trace_files_finish(&ctx);
+	}
 
 	return 0;
 }
@@ -18,6 +18,7 @@
 #define DATA_PATTERN 0x5a
 #define ALIGN_4K 0x1000
 #define COMP_BUF_PAD_PERCENTAGE 1.1L
+#define ACCEL_PERF_MAX_SEQ_OPS 8
 
 static uint64_t	g_tsc_rate;
 static uint64_t g_tsc_end;
@@ -40,6 +41,10 @@ static uint32_t g_xor_src_count = 2;
 static bool g_verify = false;
 static const char *g_workload_type = NULL;
 static enum spdk_accel_opcode g_workload_selection = SPDK_ACCEL_OPC_LAST;
+/* Operations chained into a sequence when the -w argument is a comma separated list */
+static enum spdk_accel_opcode g_seq_ops[ACCEL_PERF_MAX_SEQ_OPS];
+static uint32_t g_seq_op_count = 0;
+static bool g_seq_disable_optimizer = false;
 static const char *g_module_name = NULL;
 static struct worker_thread *g_workers = NULL;
 static int g_num_workers = 0;
@@ -89,6 +94,8 @@ struct ap_task {
 	uint32_t		num_blocks; /* used for the DIF related operations */
 	struct spdk_dif_ctx	dif_ctx;
 	struct spdk_dif_error	dif_err;
+	uint64_t		submit_tsc;
+	uint64_t		stage_tsc[ACCEL_PERF_MAX_SEQ_OPS];
 	TAILQ_ENTRY(ap_task)	link;
 };
 
@@ -98,6 +105,9 @@ struct worker_thread {
 	uint64_t			xfer_failed;
 	uint64_t			injected_miscompares;
 	uint64_t			current_queue_depth;
+	uint64_t			seq_completed;
+	uint64_t			seq_total_tsc;
+	uint64_t			seq_stage_tsc[ACCEL_PERF_MAX_SEQ_OPS];
 	TAILQ_HEAD(, ap_task)		tasks_pool;
 	struct worker_thread		*next;
 	unsigned			core;
@@ -114,8 +124,30 @@ static void
 dump_user_config(void)
 {
 	const char *module_name = NULL;
+	uint32_t i;
 	int rc;
 
+	if (g_seq_op_count != 0) {
+		printf("\nSPDK Configuration:\n");
+		printf("Core mask:      %s\n\n", g_opts.reactor_mask);
+		printf("Accel Perf Configuration:\n");
+		printf("Workload Type:  sequence (%s)\n", g_workload_type);
+		printf("Optimizer:      %s\n", g_seq_disable_optimizer ? "disabled" : "enabled");
+		for (i = 0; i < g_seq_op_count; i++) {
+			module_name = NULL;
+			spdk_accel_get_opc_module_name(g_seq_ops[i], &module_name);
+			printf("Stage %u:        %s (module: %s)\n", i,
+			       spdk_accel_get_opcode_name(g_seq_ops[i]),
+			       module_name ? module_name : "unknown");
+		}
+		printf("Transfer size:  %u bytes\n", g_xfer_size_bytes);
+		printf("Queue depth:    %u\n", g_queue_depth);
+		printf("Allocate depth: %u\n", g_allocate_depth);
+		printf("# threads/core: %u\n", g_threads_per_core);
+		printf("Run time:       %u seconds\n", g_time_in_sec);
+		return;
+	}
+
 	rc = spdk_accel_get_opc_module_name(g_workload_selection, &module_name);
 	if (rc) {
 		printf("error getting module name (%d)\n", rc);
@@ -162,6 +194,84 @@ dump_user_config(void)
 	printf("Verify:         %s\n\n", g_verify ? "Yes" : "No");
 }
 
+static enum spdk_accel_opcode
+accel_perf_parse_workload_op(const char *name)
+{
+	if (!strcmp(name, "copy")) {
+		return SPDK_ACCEL_OPC_COPY;
+	} else if (!strcmp(name, "fill")) {
+		return SPDK_ACCEL_OPC_FILL;
+	} else if (!strcmp(name, "crc32c")) {
+		return SPDK_ACCEL_OPC_CRC32C;
+	} else if (!strcmp(name, "copy_crc32c")) {
+		return SPDK_ACCEL_OPC_COPY_CRC32C;
+	} else if (!strcmp(name, "compare")) {
+		return SPDK_ACCEL_OPC_COMPARE;
+	} else if (!strcmp(name, "dualcast")) {
+		return SPDK_ACCEL_OPC_DUALCAST;
+	} else if (!strcmp(name, "compress")) {
+		return SPDK_ACCEL_OPC_COMPRESS;
+	} else if (!strcmp(name, "decompress")) {
+		return SPDK_ACCEL_OPC_DECOMPRESS;
+	} else if (!strcmp(name, "xor")) {
+		return SPDK_ACCEL_OPC_XOR;
+	} else if (!strcmp(name, "dif_verify")) {
+		return SPDK_ACCEL_OPC_DIF_VERIFY;
+	} else if (!strcmp(name, "dif_verify_copy")) {
+		return SPDK_ACCEL_OPC_DIF_VERIFY_COPY;
+	} else if (!strcmp(name, "dif_generate")) {
+		return SPDK_ACCEL_OPC_DIF_GENERATE;
+	} else if (!strcmp(name, "dif_generate_copy")) {
+		return SPDK_ACCEL_OPC_DIF_GENERATE_COPY;
+	}
+
+	return SPDK_ACCEL_OPC_LAST;
+}
+
+static int
+accel_perf_parse_sequence(const char *arg)
+{
+	char *ops, *op, *sp = NULL;
+	enum spdk_accel_opcode opcode;
+	int rc = 0;
+
+	ops = strdup(arg);
+	if (ops == NULL) {
+		return -ENOMEM;
+	}
+
+	for (op = strtok_r(ops, ",", &sp); op != NULL; op = strtok_r(NULL, ",", &sp)) {
+		if (g_seq_op_count == ACCEL_PERF_MAX_SEQ_OPS) {
+			fprintf(stderr, "A sequence may chain at most %u operations\n",
+				ACCEL_PERF_MAX_SEQ_OPS);
+			rc = -EINVAL;
+			break;
+		}
+		opcode = accel_perf_parse_workload_op(op);
+		switch (opcode) {
+		case SPDK_ACCEL_OPC_COPY:
+		case SPDK_ACCEL_OPC_FILL:
+		case SPDK_ACCEL_OPC_CRC32C:
+			g_seq_ops[g_seq_op_count++] = opcode;
+			break;
+		default:
+			fprintf(stderr, "Operation '%s' cannot be part of a sequence\n", op);
+			rc = -EINVAL;
+			break;
+		}
+		if (rc != 0) {
+			break;
+		}
+	}
+	free(ops);
+
+	if (rc == 0 && g_seq_op_count == 0) {
+		rc = -EINVAL;
+	}
+
+	return rc;
+}
+
 static void
 usage(void)
 {
@@ -174,6 +284,8 @@ usage(void)
 	printf("\t[-t time in seconds]\n");
 	printf("\t[-w workload type must be one of these: copy, fill, crc32c, copy_crc32c, compare, compress, decompress, dualcast, xor,\n");
 	printf("\t[                                       dif_verify, dif_verify_copy, dif_generate, dif_generate_copy\n");
+	printf("\t[   a comma separated list (e.g. copy,crc32c) chains the operations into a sequence]\n");
+	printf("\t[-d for sequence workloads, disable sequence optimizations (copy elision, operation fusion)]\n");
 	printf("\t[-M assign module to the operation, not compatible with accel_assign_opc RPC\n");
 	printf("\t[-l for compress/decompress workloads, name of uncompressed input file\n");
 	printf("\t[-S for crc32c workload, use this seed value (default 0)\n");
@@ -249,35 +361,20 @@ parse_args(int ch, char *arg)
 	case 'y':
 		g_verify = true;
 		break;
+	case 'd':
+		g_seq_disable_optimizer = true;
+		break;
 	case 'w':
 		g_workload_type = optarg;
-		if (!strcmp(g_workload_type, "copy")) {
-			g_workload_selection = SPDK_ACCEL_OPC_COPY;
-		} else if (!strcmp(g_workload_type, "fill")) {
-			g_workload_selection = SPDK_ACCEL_OPC_FILL;
-		} else if (!strcmp(g_workload_type, "crc32c")) {
-			g_workload_selection = SPDK_ACCEL_OPC_CRC32C;
-		} else if (!strcmp(g_workload_type, "copy_crc32c")) {
-			g_workload_selection = SPDK_ACCEL_OPC_COPY_CRC32C;
-		} else if (!strcmp(g_workload_type, "compare")) {
-			g_workload_selection = SPDK_ACCEL_OPC_COMPARE;
-		} else if (!strcmp(g_workload_type, "dualcast")) {
-			g_workload_selection = SPDK_ACCEL_OPC_DUALCAST;
-		} else if (!strcmp(g_workload_type, "compress")) {
-			g_workload_selection = SPDK_ACCEL_OPC_COMPRESS;
-		} else if (!strcmp(g_workload_type, "decompress")) {
-			g_workload_selection = SPDK_ACCEL_OPC_DECOMPRESS;
-		} else if (!strcmp(g_workload_type, "xor")) {
-			g_workload_selection = SPDK_ACCEL_OPC_XOR;
-		} else if (!strcmp(g_workload_type, "dif_verify")) {
-			g_workload_selection = SPDK_ACCEL_OPC_DIF_VERIFY;
-		} else if (!strcmp(g_workload_type, "dif_verify_copy")) {
-			g_workload_selection = SPDK_ACCEL_OPC_DIF_VERIFY_COPY;
-		} else if (!strcmp(g_workload_type, "dif_generate")) {
-			g_workload_selection = SPDK_ACCEL_OPC_DIF_GENERATE;
-		} else if (!strcmp(g_workload_type, "dif_generate_copy")) {
-			g_workload_selection = SPDK_ACCEL_OPC_DIF_GENERATE_COPY;
-		} else {
+		if (strchr(optarg, ',') != NULL) {
+			if (accel_perf_parse_sequence(optarg)) {
+				usage();
+				return 1;
+			}
+			break;
+		}
+		g_workload_selection = accel_perf_parse_workload_op(optarg);
+		if (g_workload_selection == SPDK_ACCEL_OPC_LAST) {
 			fprintf(stderr, "Unsupported workload type: %s\n", optarg);
 			usage();
 			return 1;
@@ -302,8 +399,13 @@ unregister_worker(void *arg1)
 	struct worker_thread *worker = arg1;
 
 	if (worker->ch) {
-		spdk_accel_get_opcode_stats(worker->ch, worker->workload,
-					    &worker->stats, sizeof(worker->stats));
+		if (g_seq_op_count != 0) {
+			worker->stats.executed = worker->seq_completed;
+			worker->stats.num_bytes = worker->seq_completed * g_xfer_size_bytes;
+		} else {
+			spdk_accel_get_opcode_stats(worker->ch, worker->workload,
+						    &worker->stats, sizeof(worker->stats));
+		}
 		spdk_put_io_channel(worker->ch);
 		worker->ch = NULL;
 	}
@@ -364,6 +466,29 @@ _get_task_data_bufs(struct ap_task *task)
 		align = ALIGN_4K;
 	}
 
+	if (g_seq_op_count != 0) {
+		task->src = spdk_dma_zmalloc(g_xfer_size_bytes, 0, NULL);
+		task->dst = spdk_dma_zmalloc(g_xfer_size_bytes, 0, NULL);
+		task->crc_dst = spdk_dma_zmalloc(sizeof(*task->crc_dst), 0, NULL);
+		task->src_iovs = calloc(1, sizeof(struct iovec));
+		task->dst_iovs = calloc(1, sizeof(struct iovec));
+		if (task->src == NULL || task->dst == NULL || task->crc_dst == NULL ||
+		    task->src_iovs == NULL || task->dst_iovs == NULL) {
+			fprintf(stderr, "Unable to alloc sequence buffers\n");
+			return -ENOMEM;
+		}
+		memset(task->src, DATA_PATTERN, g_xfer_size_bytes);
+		memset(task->dst, ~DATA_PATTERN, g_xfer_size_bytes);
+		task->src_iovs[0].iov_base = task->src;
+		task->src_iovs[0].iov_len = g_xfer_size_bytes;
+		task->src_iovcnt = 1;
+		task->dst_iovs[0].iov_base = task->dst;
+		task->dst_iovs[0].iov_len = g_xfer_size_bytes;
+		task->dst_iovcnt = 1;
+
+		return 0;
+	}
+
 	if (g_workload_selection == SPDK_ACCEL_OPC_COMPRESS ||
 	    g_workload_selection == SPDK_ACCEL_OPC_DECOMPRESS) {
 		task->cur_seg = STAILQ_FIRST(&g_compress_segs);
@@ -628,6 +753,123 @@ _get_task(struct worker_thread *worker)
 	return task;
 }
 
+static void _submit_sequence(struct worker_thread *worker, struct ap_task *task);
+
+static void
+_sequence_step_done(void *cb_arg)
+{
+	*(uint64_t *)cb_arg = spdk_get_ticks();
+}
+
+static void
+_sequence_done(void *arg1, int status)
+{
+	struct ap_task *task = arg1;
+	struct worker_thread *worker = task->worker;
+	uint64_t now = spdk_get_ticks();
+	uint64_t prev = task->submit_tsc;
+	uint64_t stage_tsc;
+	uint32_t i;
+
+	assert(worker);
+	assert(worker->current_queue_depth > 0);
+
+	if (status != 0) {
+		worker->xfer_failed++;
+	} else {
+		worker->seq_completed++;
+		worker->seq_total_tsc += now - task->submit_tsc;
+		for (i = 0; i < g_seq_op_count; i++) {
+			/* Stages elided or fused by the optimizer complete together with
+			 * their neighbor and show up with (close to) zero latency.
+			 */
+			stage_tsc = spdk_max(task->stage_tsc[i], prev);
+			worker->seq_stage_tsc[i] += stage_tsc - prev;
+			prev = stage_tsc;
+		}
+
+		if (g_verify && g_seq_ops[g_seq_op_count - 1] == SPDK_ACCEL_OPC_CRC32C) {
+			bool filled = false;
+
+			/* After a fill stage the data checksummed by the crc32c stage no
+			 * longer matches the source buffer, so only plain copy chains can
+			 * be verified against it.
+			 */
+			for (i = 0; i < g_seq_op_count - 1; i++) {
+				if (g_seq_ops[i] == SPDK_ACCEL_OPC_FILL) {
+					filled = true;
+				}
+			}
+
+			if (!filled &&
+			    *task->crc_dst != spdk_crc32c_iov_update(task->src_iovs, 1, ~g_crc32c_seed)) {
+				SPDK_NOTICELOG("CRC-32C miscompare\n");
+				worker->xfer_failed++;
+			}
+		}
+	}
+
+	worker->current_queue_depth--;
+	TAILQ_INSERT_TAIL(&worker->tasks_pool, task, link);
+
+	if (!worker->is_draining && status == 0) {
+		task = _get_task(worker);
+		_submit_sequence(worker, task);
+	}
+}
+
+/* Chain the configured operations into a sequence and submit it. */
+static void
+_submit_sequence(struct worker_thread *worker, struct ap_task *task)
+{
+	struct spdk_accel_sequence *seq = NULL;
+	struct iovec *cur_iovs = task->src_iovs;
+	uint32_t i;
+	int rc = 0;
+
+	assert(worker);
+
+	task->submit_tsc = spdk_get_ticks();
+	memset(task->stage_tsc, 0, sizeof(task->stage_tsc));
+
+	for (i = 0; i < g_seq_op_count; i++) {
+		switch (g_seq_ops[i]) {
+		case SPDK_ACCEL_OPC_COPY:
+			rc = spdk_accel_append_copy(&seq, worker->ch, task->dst_iovs, 1, NULL, NULL,
+						    cur_iovs, 1, NULL, NULL,
+						    _sequence_step_done, &task->stage_tsc[i]);
+			cur_iovs = task->dst_iovs;
+			break;
+		case SPDK_ACCEL_OPC_FILL:
+			rc = spdk_accel_append_fill(&seq, worker->ch, cur_iovs[0].iov_base,
+						    cur_iovs[0].iov_len, NULL, NULL, g_fill_pattern,
+						    _sequence_step_done, &task->stage_tsc[i]);
+			break;
+		case SPDK_ACCEL_OPC_CRC32C:
+			rc = spdk_accel_append_crc32c(&seq, worker->ch, task->crc_dst,
+						      cur_iovs, 1, NULL, NULL, g_crc32c_seed,
+						      _sequence_step_done, &task->stage_tsc[i]);
+			break;
+		default:
+			assert(false);
+			rc = -EINVAL;
+			break;
+		}
+		if (rc != 0) {
+			break;
+		}
+	}
+
+	worker->current_queue_depth++;
+	if (rc != 0) {
+		spdk_accel_sequence_abort(seq);
+		_sequence_done(task, rc);
+		return;
+	}
+
+	spdk_accel_sequence_finish(seq, _sequence_done, task);
+}
+
 /* Submit one operation using the same ap task that just completed. */
 static void
 _submit_single(struct worker_thread *worker, struct ap_task *task)
@@ -637,6 +879,11 @@ _submit_single(struct worker_thread *worker, struct ap_task *task)
 
 	assert(worker);
 
+	if (g_seq_op_count != 0) {
+		_submit_sequence(worker, task);
+		return;
+	}
+
 	switch (worker->workload) {
 	case SPDK_ACCEL_OPC_COPY:
 		rc = spdk_accel_submit_copy(worker->ch, task->dst, task->src,
@@ -724,6 +971,15 @@ _free_task_buffers(struct ap_task *task)
 {
 	uint32_t i;
 
+	if (g_seq_op_count != 0) {
+		spdk_dma_free(task->crc_dst);
+		spdk_dma_free(task->src);
+		spdk_dma_free(task->dst);
+		free(task->src_iovs);
+		free(task->dst_iovs);
+		return;
+	}
+
 	if (g_workload_selection == SPDK_ACCEL_OPC_DECOMPRESS ||
 	    g_workload_selection == SPDK_ACCEL_OPC_COMPRESS) {
 		free(task->dst_iovs);
@@ -965,6 +1221,34 @@ dump_result(void)
 	printf("%-12s %18" PRIu64 "/s %10" PRIu64 " MiB/s %16"PRIu64 " %16" PRIu64 "\n",
 	       "Total", total_xfer_per_sec, total_bw_in_MiBps, total_failed, total_miscompared);
 
+	if (g_seq_op_count != 0) {
+		uint64_t total_seq = 0, total_seq_tsc = 0;
+		uint64_t stage_tsc[ACCEL_PERF_MAX_SEQ_OPS] = {};
+		uint32_t i;
+
+		for (worker = g_workers; worker != NULL; worker = worker->next) {
+			total_seq += worker->seq_completed;
+			total_seq_tsc += worker->seq_total_tsc;
+			for (i = 0; i < g_seq_op_count; i++) {
+				stage_tsc[i] += worker->seq_stage_tsc[i];
+			}
+		}
+
+		if (total_seq != 0) {
+			printf("\nSequence latency:\n");
+			printf("%-24s %12.2f us\n", "End-to-end (avg)",
+			       (double)total_seq_tsc * SPDK_SEC_TO_USEC / (g_tsc_rate * total_seq));
+			for (i = 0; i < g_seq_op_count; i++) {
+				char stage_name[32];
+
+				snprintf(stage_name, sizeof(stage_name), "Stage %u: %s (avg)", i,
+					 spdk_accel_get_opcode_name(g_seq_ops[i]));
+				printf("%-24s %12.2f us\n", stage_name,
+				       (double)stage_tsc[i] * SPDK_SEC_TO_USEC / (g_tsc_rate * total_seq));
+			}
+		}
+	}
+
 	return total_failed ? 1 : 0;
 }
 
@@ -1308,7 +1592,7 @@ accel_perf_prep(void *arg1)
 	const char *module_name = NULL;
 	int rc = 0;
 
-	if (g_module_name) {
+	if (g_module_name && g_seq_op_count == 0) {
 		rc = spdk_accel_get_opc_module_name(g_workload_selection, &module_name);
 		if (rc != 0 || strcmp(g_module_name, module_name) != 0) {
 			fprintf(stderr, "Module '%s' was assigned via JSON config or RPC, instead of '%s'\n",
@@ -1319,8 +1603,9 @@ accel_perf_prep(void *arg1)
 		}
 	}
 
-	if (g_workload_selection != SPDK_ACCEL_OPC_COMPRESS &&
-	    g_workload_selection != SPDK_ACCEL_OPC_DECOMPRESS) {
+	if (g_seq_op_count != 0 ||
+	    (g_workload_selection != SPDK_ACCEL_OPC_COMPRESS &&
+	     g_workload_selection != SPDK_ACCEL_OPC_DECOMPRESS)) {
 		accel_perf_start(arg1);
 		return;
 	}
@@ -1417,18 +1702,29 @@ main(int argc, char **argv)
 	g_opts.shutdown_cb = shutdown_cb;
 	g_opts.rpc_addr = NULL;
 
-	rc = spdk_app_parse_args(argc, argv, &g_opts, "a:C:o:q:t:yw:M:P:f:T:l:S:x:", NULL,
+	rc = spdk_app_parse_args(argc, argv, &g_opts, "a:C:do:q:t:yw:M:P:f:T:l:S:x:", NULL,
 				 parse_args, usage);
 	if (rc != SPDK_APP_PARSE_ARGS_SUCCESS) {
 		return rc == SPDK_APP_PARSE_ARGS_HELP ? 0 : 1;
 	}
 
-	if (g_workload_selection == SPDK_ACCEL_OPC_LAST) {
+	if (g_workload_selection == SPDK_ACCEL_OPC_LAST && g_seq_op_count == 0) {
 		fprintf(stderr, "Must provide a workload type\n");
 		usage();
 		return -1;
 	}
 
+	if (g_seq_disable_optimizer) {
+		struct spdk_accel_opts accel_opts = {};
+
+		spdk_accel_get_opts(&accel_opts, sizeof(accel_opts));
+		accel_opts.disable_sequence_optimizations = 1;
+		if (spdk_accel_set_opts(&accel_opts)) {
+			fprintf(stderr, "Was not able to disable sequence optimizations\n");
+			return -1;
+		}
+	}
+
 	if (g_allocate_depth > 0 && g_queue_depth > g_allocate_depth) {
 		fprintf(stdout, "allocate depth must be at least as big as queue depth\n");
 		usage();
@@ -1453,10 +1749,23 @@ main(int argc, char **argv)
 		return -1;
 	}
 
-	if (g_module_name && spdk_accel_assign_opc(g_workload_selection, g_module_name)) {
-		fprintf(stderr, "Was not able to assign '%s' module to the workload\n", g_module_name);
-		usage();
-		return -1;
+	if (g_module_name) {
+		if (g_seq_op_count != 0) {
+			uint32_t i;
+
+			for (i = 0; i < g_seq_op_count; i++) {
+				if (spdk_accel_assign_opc(g_seq_ops[i], g_module_name)) {
+					fprintf(stderr, "Was not able to assign '%s' module to the workload\n",
+						g_module_name);
+					usage();
+					return -1;
+				}
+			}
+		} else if (spdk_accel_assign_opc(g_workload_selection, g_module_name)) {
+			fprintf(stderr, "Was not able to assign '%s' module to the workload\n", g_module_name);
+			usage();
+			return -1;
+		}
 	}
 
 	g_rc = spdk_app_start(&g_opts, accel_perf_prep, NULL);
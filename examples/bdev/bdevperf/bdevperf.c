@@ -78,6 +78,8 @@ static struct spdk_cpuset g_all_cpuset;
 static struct spdk_poller *g_perf_timer = NULL;
 
 static void bdevperf_submit_single(struct bdevperf_job *job, struct bdevperf_task *task);
+static uint32_t bdevperf_start_phase(uint32_t phase);
+static void bdevperf_release_unstarted_jobs(void);
 static void rpc_perform_tests_cb(void);
 static int bdevperf_parse_arg(int ch, char *arg);
 static int verify_test_params(void);
@@ -166,7 +168,13 @@ struct bdevperf_job {
 	uint64_t			buf_size;
 	uint32_t			dif_check_flags;
 	bool				is_draining;
+	bool				started;
+	uint32_t			phase;
+	uint64_t			time_in_usec;
+	uint64_t			ramp_time_in_usec;
+	uint64_t			start_tsc;
 	struct spdk_poller		*run_timer;
+	struct spdk_poller		*ramp_timer;
 	struct spdk_poller		*reset_timer;
 	struct spdk_bit_array		*outstanding;
 	struct spdk_zipf		*zipf;
@@ -175,6 +183,8 @@ struct bdevperf_job {
 
 	/* keep channel's histogram data before being destroyed */
 	struct spdk_histogram_data	*histogram;
+	/* latency accumulated during warmup, subtracted from the final histogram */
+	struct spdk_histogram_data	*ramp_histogram;
 	struct spdk_bit_array		*random_map;
 
 	/* counter used for generating unique write data (-U option) */
@@ -191,6 +201,11 @@ static struct spdk_bdevperf g_bdevperf = {
 	.running_jobs = 0,
 };
 
+/* Jobs are grouped into phases that run back to back.  Phase N+1 is not
+ * started until every job in phase N has finished. */
+static uint32_t g_num_phases = 1;
+static uint32_t g_current_phase = 0;
+
 /* Storing values from a section of job config file */
 struct job_config {
 	const char			*name;
@@ -203,6 +218,10 @@ struct job_config {
 	int64_t				offset;
 	uint64_t			length;
 	enum job_config_rw		rw;
+	double				zipf_theta;
+	int				ramp_time;
+	int				runtime;
+	int				phase;
 	TAILQ_ENTRY(job_config)	link;
 };
 
@@ -237,6 +256,273 @@ TAILQ_HEAD(, lcore_thread) g_lcore_thread_list
 	= TAILQ_HEAD_INITIALIZER(g_lcore_thread_list);
 
 
+/* Multi-process scale-out mode (--sync-instances).  Cooperating bdevperf
+ * processes rendezvous in a small POSIX shared memory segment: they wait for
+ * each other before opening the measurement window, split the available bdevs
+ * between them and report their results back so that the first process can
+ * print one merged report.
+ */
+#define BDEVPERF_SYNC_SHM_NAME_DEFAULT	"bdevperf_sync"
+#define BDEVPERF_SYNC_MAX_INSTANCES	64
+#define BDEVPERF_SYNC_MAGIC		0x42445053594e4331ULL
+
+enum bdevperf_cmdline_opts {
+	BDEVPERF_OPTION_SYNC_INSTANCES = 0x1000,
+	BDEVPERF_OPTION_SYNC_SHM,
+};
+
+struct bdevperf_sync_result {
+	uint64_t	io_time_in_usec;
+	uint64_t	total_io_completed;
+	uint64_t	total_tsc;
+	double		total_io_per_second;
+	double		total_mb_per_second;
+	double		total_failed_per_second;
+	double		total_timeout_per_second;
+	double		min_latency;
+	double		max_latency;
+	int		rc;
+};
+
+struct bdevperf_sync_shm {
+	uint64_t			magic;
+	uint32_t			num_instances;
+	uint32_t			attach_count;
+	uint32_t			ready_count;
+	uint32_t			done_count;
+	struct bdevperf_sync_result	results[BDEVPERF_SYNC_MAX_INSTANCES];
+};
+
+static uint32_t g_sync_instances = 0;
+static const char *g_sync_shm_name = BDEVPERF_SYNC_SHM_NAME_DEFAULT;
+static struct bdevperf_sync_shm *g_sync_shm = NULL;
+static uint32_t g_sync_instance_id = 0;
+static uint32_t g_sync_bdev_index = 0;
+static bool g_sync_coordinator = false;
+static struct spdk_poller *g_sync_poller = NULL;
+
+/* Decide whether this instance owns the next auto-enumerated bdev.  Every
+ * instance walks the bdev list in the same order, so striping by index gives
+ * a disjoint partition without any communication.
+ */
+static bool
+bdevperf_sync_claim_bdev(void)
+{
+	if (g_sync_instances == 0 || g_job_bdev_name != NULL) {
+		return true;
+	}
+
+	return (g_sync_bdev_index++ % g_sync_instances) == g_sync_instance_id;
+}
+
+static void
+bdevperf_sync_dump_aggregate(void)
+{
+	struct bdevperf_sync_result *result;
+	char name[32];
+	double total_io_per_second = 0.0, total_mb_per_second = 0.0;
+	double total_failed_per_second = 0.0, total_timeout_per_second = 0.0;
+	double min_latency = (double)UINT64_MAX, max_latency = 0.0;
+	double average_latency = 0.0, instance_average;
+	uint64_t total_io_completed = 0, total_tsc = 0, io_time_in_usec = 0;
+	uint32_t i;
+
+	printf("\n Aggregate results across %u bdevperf instances\n",
+	       g_sync_shm->num_instances);
+	printf("\r %-*s: %10s %10s %10s %10s %8s %10s %10s %10s\n",
+	       28, "Instance", "runtime(s)", "IOPS", "MiB/s", "Fail/s", "TO/s",
+	       "Average", "min", "max");
+
+	for (i = 0; i < g_sync_shm->num_instances; i++) {
+		result = &g_sync_shm->results[i];
+		snprintf(name, sizeof(name), "Instance %u", i);
+
+		if (result->rc != 0) {
+			printf("\r %-*s: failed with rc %d\n", 28, name, result->rc);
+			if (g_run_rc == 0) {
+				g_run_rc = result->rc;
+			}
+			continue;
+		}
+
+		instance_average = 0.0;
+		if (result->total_io_completed != 0) {
+			instance_average = ((double)result->total_tsc / result->total_io_completed) *
+					   SPDK_SEC_TO_USEC / spdk_get_ticks_hz();
+		}
+		printf("\r %-*s: %10.2f %10.2f %10.2f %10.2f %8.2f %10.2f %10.2f %10.2f\n",
+		       28, name, (double)result->io_time_in_usec / SPDK_SEC_TO_USEC,
+		       result->total_io_per_second, result->total_mb_per_second,
+		       result->total_failed_per_second, result->total_timeout_per_second,
+		       instance_average, result->min_latency, result->max_latency);
+
+		total_io_per_second += result->total_io_per_second;
+		total_mb_per_second += result->total_mb_per_second;
+		total_failed_per_second += result->total_failed_per_second;
+		total_timeout_per_second += result->total_timeout_per_second;
+		total_io_completed += result->total_io_completed;
+		total_tsc += result->total_tsc;
+		io_time_in_usec = spdk_max(io_time_in_usec, result->io_time_in_usec);
+		min_latency = spdk_min(min_latency, result->min_latency);
+		max_latency = spdk_max(max_latency, result->max_latency);
+	}
+
+	if (total_io_completed != 0) {
+		average_latency = ((double)total_tsc / total_io_completed) *
+				  SPDK_SEC_TO_USEC / spdk_get_ticks_hz();
+	}
+
+	printf("\r =================================================================================="
+	       "=================================\n");
+	printf("\r %-*s: %10.2f %10.2f %10.2f %10.2f %8.2f %10.2f %10.2f %10.2f\n",
+	       28, "Global total", (double)io_time_in_usec / SPDK_SEC_TO_USEC,
+	       total_io_per_second, total_mb_per_second,
+	       total_failed_per_second, total_timeout_per_second,
+	       average_latency, min_latency, max_latency);
+	fflush(stdout);
+}
+
+static int
+bdevperf_sync_done_poller(void *ctx)
+{
+	if (__atomic_load_n(&g_sync_shm->done_count, __ATOMIC_ACQUIRE) <
+	    g_sync_shm->num_instances) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	spdk_poller_unregister(&g_sync_poller);
+	bdevperf_sync_dump_aggregate();
+	spdk_app_stop(g_run_rc);
+	return SPDK_POLLER_BUSY;
+}
+
+static void
+bdevperf_sync_publish_result(int rc)
+{
+	struct bdevperf_sync_result *result = &g_sync_shm->results[g_sync_instance_id];
+
+	result->io_time_in_usec = g_stats.io_time_in_usec;
+	result->total_io_completed = g_stats.total_io_completed;
+	result->total_tsc = g_stats.total_tsc;
+	result->total_io_per_second = g_stats.total_io_per_second;
+	result->total_mb_per_second = g_stats.total_mb_per_second;
+	result->total_failed_per_second = g_stats.total_failed_per_second;
+	result->total_timeout_per_second = g_stats.total_timeout_per_second;
+	result->min_latency = g_stats.min_latency;
+	result->max_latency = g_stats.max_latency;
+	result->rc = rc;
+
+	__atomic_fetch_add(&g_sync_shm->done_count, 1, __ATOMIC_RELEASE);
+
+	if (g_sync_coordinator) {
+		/* Stay alive until every instance has reported so the merged
+		 * results can be printed.
+		 */
+		g_sync_poller = SPDK_POLLER_REGISTER(bdevperf_sync_done_poller, NULL, 1000);
+	} else {
+		spdk_app_stop(rc);
+	}
+}
+
+static void
+bdevperf_sync_detach(void)
+{
+	char name[256];
+
+	if (g_sync_shm == NULL) {
+		return;
+	}
+
+	munmap(g_sync_shm, sizeof(*g_sync_shm));
+	g_sync_shm = NULL;
+
+	if (g_sync_coordinator) {
+		snprintf(name, sizeof(name), "/%s", g_sync_shm_name);
+		shm_unlink(name);
+	}
+}
+
+static int
+bdevperf_sync_attach(void)
+{
+	char name[256];
+	struct stat st;
+	bool created = false;
+	int fd, rc;
+
+	snprintf(name, sizeof(name), "/%s", g_sync_shm_name);
+
+	fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd >= 0) {
+		created = true;
+		if (ftruncate(fd, sizeof(*g_sync_shm)) != 0) {
+			rc = -errno;
+			fprintf(stderr, "Unable to size shared memory segment %s: %s\n",
+				name, strerror(errno));
+			close(fd);
+			shm_unlink(name);
+			return rc;
+		}
+	} else if (errno == EEXIST) {
+		fd = shm_open(name, O_RDWR, 0600);
+	}
+	if (fd < 0) {
+		rc = -errno;
+		fprintf(stderr, "Unable to open shared memory segment %s: %s\n",
+			name, strerror(errno));
+		return rc;
+	}
+
+	if (!created) {
+		/* Wait until the creator has sized the segment. */
+		do {
+			if (fstat(fd, &st) != 0) {
+				rc = -errno;
+				close(fd);
+				return rc;
+			}
+		} while ((size_t)st.st_size < sizeof(*g_sync_shm) && usleep(1000) == 0);
+	}
+
+	g_sync_shm = mmap(NULL, sizeof(*g_sync_shm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (g_sync_shm == MAP_FAILED) {
+		g_sync_shm = NULL;
+		fprintf(stderr, "Unable to map shared memory segment %s\n", name);
+		return -ENOMEM;
+	}
+
+	if (created) {
+		memset(g_sync_shm, 0, sizeof(*g_sync_shm));
+		g_sync_shm->num_instances = g_sync_instances;
+		__atomic_store_n(&g_sync_shm->magic, BDEVPERF_SYNC_MAGIC, __ATOMIC_RELEASE);
+	} else {
+		/* Wait until the creator has initialized the segment. */
+		while (__atomic_load_n(&g_sync_shm->magic, __ATOMIC_ACQUIRE) != BDEVPERF_SYNC_MAGIC) {
+			usleep(1000);
+		}
+		if (g_sync_shm->num_instances != g_sync_instances) {
+			fprintf(stderr, "--sync-instances mismatch: segment %s expects %u instances\n",
+				name, g_sync_shm->num_instances);
+			bdevperf_sync_detach();
+			return -EINVAL;
+		}
+	}
+
+	g_sync_coordinator = created;
+	g_sync_instance_id = __atomic_fetch_add(&g_sync_shm->attach_count, 1, __ATOMIC_SEQ_CST);
+	if (g_sync_instance_id >= g_sync_shm->num_instances) {
+		fprintf(stderr, "Too many bdevperf instances attached to %s\n", name);
+		bdevperf_sync_detach();
+		return -EINVAL;
+	}
+
+	printf("Running as instance %u of %u in group %s%s\n", g_sync_instance_id,
+	       g_sync_shm->num_instances, name, g_sync_coordinator ? " (coordinator)" : "");
+	return 0;
+}
+
+
 static char *
 parse_workload_type(enum job_config_rw ret)
 {
@@ -329,6 +615,15 @@ performance_dump_job(struct bdevperf_aggregate_stats *stats, struct bdevperf_job
 	uint64_t total_io;
 	struct latency_info latency_info = {};
 
+	if (!job->started) {
+		printf("\r Job: %s (phase %u) was not started\n", job->name, job->phase);
+		return;
+	}
+
+	if (g_num_phases > 1) {
+		printf("\r Phase %u:\n", job->phase);
+	}
+
 	if (job->workload_type == JOB_CONFIG_RW_RW || job->workload_type == JOB_CONFIG_RW_RANDRW) {
 		printf("\r Job: %s (Core Mask 0x%s, workload: %s, percentage: %d, depth: %d, IO size: %d)\n",
 		       job->name, spdk_cpuset_fmt(spdk_thread_get_cpumask(job->thread)),
@@ -549,6 +844,7 @@ static void
 bdevperf_job_free(struct bdevperf_job *job)
 {
 	spdk_histogram_data_free(job->histogram);
+	spdk_histogram_data_free(job->ramp_histogram);
 	spdk_bit_array_free(&job->outstanding);
 	spdk_bit_array_free(&job->random_map);
 	spdk_zipf_free(&job->zipf);
@@ -659,9 +955,17 @@ bdevperf_test_done(void *ctx)
 
 	printf("\n Latency summary\n");
 	TAILQ_FOREACH_SAFE(job, &g_bdevperf.jobs, link, jtmp) {
+		if (!job->started) {
+			continue;
+		}
 		printf("\r =============================================\n");
-		printf("\r Job: %s (Core Mask 0x%s)\n", job->name,
-		       spdk_cpuset_fmt(spdk_thread_get_cpumask(job->thread)));
+		if (g_num_phases > 1) {
+			printf("\r Job: %s (Phase %u, Core Mask 0x%s)\n", job->name, job->phase,
+			       spdk_cpuset_fmt(spdk_thread_get_cpumask(job->thread)));
+		} else {
+			printf("\r Job: %s (Core Mask 0x%s)\n", job->name,
+			       spdk_cpuset_fmt(spdk_thread_get_cpumask(job->thread)));
+		}
 
 		const double *cutoff = g_latency_cutoffs;
 
@@ -676,9 +980,17 @@ bdevperf_test_done(void *ctx)
 
 	printf("\r Latency histogram\n");
 	TAILQ_FOREACH_SAFE(job, &g_bdevperf.jobs, link, jtmp) {
+		if (!job->started) {
+			continue;
+		}
 		printf("\r =============================================\n");
-		printf("\r Job: %s (Core Mask 0x%s)\n", job->name,
-		       spdk_cpuset_fmt(spdk_thread_get_cpumask(job->thread)));
+		if (g_num_phases > 1) {
+			printf("\r Job: %s (Phase %u, Core Mask 0x%s)\n", job->name, job->phase,
+			       spdk_cpuset_fmt(spdk_thread_get_cpumask(job->thread)));
+		} else {
+			printf("\r Job: %s (Core Mask 0x%s)\n", job->name,
+			       spdk_cpuset_fmt(spdk_thread_get_cpumask(job->thread)));
+		}
 
 		spdk_histogram_data_iterate(job->histogram, print_bucket, NULL);
 		printf("\n");
@@ -718,6 +1030,15 @@ clean:
 	}
 
 	rc = g_run_rc;
+
+	if (g_sync_shm != NULL && g_request == NULL) {
+		/* Report into the shared segment; the coordinator prints the
+		 * merged results once every instance has checked in.
+		 */
+		bdevperf_sync_publish_result(rc);
+		return;
+	}
+
 	if (g_request && !g_shutdown) {
 		rpc_perform_tests_cb();
 		if (rc != 0) {
@@ -734,10 +1055,54 @@ bdevperf_job_end(void *ctx)
 	assert(g_main_thread == spdk_get_thread());
 
 	if (--g_bdevperf.running_jobs == 0) {
+		/* Move on to the next phase that has jobs, unless the test
+		 * was interrupted or failed. */
+		while (!g_shutdown && g_run_rc == 0 && g_current_phase + 1 < g_num_phases) {
+			g_current_phase++;
+			if (bdevperf_start_phase(g_current_phase) > 0) {
+				return;
+			}
+		}
+
+		/* Jobs in phases that were never reached still hold a channel
+		 * and descriptor that must be released on their threads. */
+		bdevperf_release_unstarted_jobs();
+		if (g_bdevperf.running_jobs > 0) {
+			return;
+		}
+
 		bdevperf_test_done(NULL);
 	}
 }
 
+static void
+_bdevperf_job_release(void *ctx)
+{
+	struct bdevperf_job *job = ctx;
+
+	spdk_put_io_channel(job->ch);
+	spdk_bdev_close(job->bdev_desc);
+	job->ch = NULL;
+	job->bdev_desc = NULL;
+	spdk_thread_send_msg(g_main_thread, bdevperf_job_end, NULL);
+}
+
+static void
+bdevperf_release_unstarted_jobs(void)
+{
+	struct bdevperf_job *job;
+
+	assert(g_main_thread == spdk_get_thread());
+
+	TAILQ_FOREACH(job, &g_bdevperf.jobs, link) {
+		if (job->started || job->ch == NULL) {
+			continue;
+		}
+		g_bdevperf.running_jobs++;
+		spdk_thread_send_msg(job->thread, _bdevperf_job_release, job);
+	}
+}
+
 static void
 bdevperf_channel_get_histogram_cb(void *cb_arg, int status, struct spdk_histogram_data *histogram)
 {
@@ -748,18 +1113,41 @@ bdevperf_channel_get_histogram_cb(void *cb_arg, int status, struct spdk_histogra
 	}
 }
 
+static void
+bdevperf_histogram_subtract(struct spdk_histogram_data *histogram,
+			    const struct spdk_histogram_data *warmup)
+{
+	uint64_t *count;
+	uint32_t range, index;
+
+	assert(histogram->bucket_shift == warmup->bucket_shift);
+
+	for (range = 0; range < SPDK_HISTOGRAM_NUM_BUCKET_RANGES(histogram); range++) {
+		for (index = 0; index < SPDK_HISTOGRAM_NUM_BUCKETS_PER_RANGE(histogram); index++) {
+			count = __spdk_histogram_get_bucket(histogram, range, index);
+			*count -= spdk_min(*count, __spdk_histogram_get_count(warmup, range, index));
+		}
+	}
+}
+
 static void
 bdevperf_job_empty(struct bdevperf_job *job)
 {
 	uint64_t end_tsc = 0;
 
-	end_tsc = spdk_get_ticks() - g_start_tsc;
+	end_tsc = spdk_get_ticks() - job->start_tsc;
 	job->run_time_in_usec = end_tsc * SPDK_SEC_TO_USEC / spdk_get_ticks_hz();
 	/* keep histogram info before channel is destroyed */
 	spdk_bdev_channel_get_histogram(job->ch, bdevperf_channel_get_histogram_cb,
 					job->histogram);
+	if (job->ramp_histogram != NULL) {
+		/* Drop the latency datapoints collected during warmup. */
+		bdevperf_histogram_subtract(job->histogram, job->ramp_histogram);
+	}
 	spdk_put_io_channel(job->ch);
 	spdk_bdev_close(job->bdev_desc);
+	job->ch = NULL;
+	job->bdev_desc = NULL;
 	spdk_thread_send_msg(g_main_thread, bdevperf_job_end, NULL);
 }
 
@@ -793,6 +1181,7 @@ bdevperf_job_drain(void *ctx)
 	struct bdevperf_job *job = ctx;
 
 	spdk_poller_unregister(&job->run_timer);
+	spdk_poller_unregister(&job->ramp_timer);
 	if (job->reset) {
 		spdk_poller_unregister(&job->reset_timer);
 	}
@@ -1392,6 +1781,28 @@ bdevperf_timeout_cb(void *cb_arg, struct spdk_bdev_io *bdev_io)
 	bdevperf_submit_task(task);
 }
 
+static int
+bdevperf_job_ramp_timer(void *ctx)
+{
+	struct bdevperf_job *job = ctx;
+
+	spdk_poller_unregister(&job->ramp_timer);
+
+	/* Warmup is over.  Snapshot the latency collected so far so it can be
+	 * subtracted from the final histogram, and restart the counters so
+	 * only the measured interval contributes to the results. */
+	spdk_bdev_channel_get_histogram(job->ch, bdevperf_channel_get_histogram_cb,
+					job->ramp_histogram);
+	job->io_completed = 0;
+	job->io_failed = 0;
+	job->io_timeout = 0;
+	job->prev_io_completed = 0;
+	job->ema_io_per_second = 0;
+	job->start_tsc = spdk_get_ticks();
+
+	return SPDK_POLLER_BUSY;
+}
+
 static void
 bdevperf_job_run(void *ctx)
 {
@@ -1402,8 +1813,16 @@ bdevperf_job_run(void *ctx)
 	/* Submit initial I/O for this job. Each time one
 	 * completes, another will be submitted. */
 
+	job->started = true;
+	job->start_tsc = spdk_get_ticks();
+
 	/* Start a timer to stop this I/O chain when the run is over */
-	job->run_timer = SPDK_POLLER_REGISTER(bdevperf_job_drain_timer, job, g_time_in_usec);
+	job->run_timer = SPDK_POLLER_REGISTER(bdevperf_job_drain_timer, job,
+					      job->ramp_time_in_usec + job->time_in_usec);
+	if (job->ramp_time_in_usec > 0) {
+		job->ramp_timer = SPDK_POLLER_REGISTER(bdevperf_job_ramp_timer, job,
+						       job->ramp_time_in_usec);
+	}
 	if (job->reset) {
 		job->reset_timer = SPDK_POLLER_REGISTER(reset_job, job,
 							10 * SPDK_SEC_TO_USEC);
@@ -1496,12 +1915,48 @@ performance_statistics_thread(void *arg)
 	return -1;
 }
 
+static uint32_t
+bdevperf_start_phase(uint32_t phase)
+{
+	struct bdevperf_job *job;
+	uint32_t started = 0;
+
+	TAILQ_FOREACH(job, &g_bdevperf.jobs, link) {
+		if (job->phase != phase) {
+			continue;
+		}
+		g_bdevperf.running_jobs++;
+		started++;
+		spdk_thread_send_msg(job->thread, bdevperf_job_run, job);
+	}
+
+	if (phase > 0 && started > 0) {
+		printf("Starting phase %u (%u job(s))...\n", phase, started);
+		fflush(stdout);
+	}
+
+	return started;
+}
+
 static void
-bdevperf_test(void)
+bdevperf_test_start(void)
 {
 	struct bdevperf_job *job;
 
-	printf("Running I/O for %" PRIu64 " seconds...\n", g_time_in_usec / (uint64_t)SPDK_SEC_TO_USEC);
+	g_num_phases = 1;
+	g_current_phase = 0;
+	TAILQ_FOREACH(job, &g_bdevperf.jobs, link) {
+		if (job->phase + 1 > g_num_phases) {
+			g_num_phases = job->phase + 1;
+		}
+	}
+
+	if (g_num_phases > 1) {
+		printf("Running I/O in %u phases...\n", g_num_phases);
+	} else {
+		printf("Running I/O for %" PRIu64 " seconds...\n",
+		       g_time_in_usec / (uint64_t)SPDK_SEC_TO_USEC);
+	}
 	fflush(stdout);
 
 	/* Start a timer to dump performance numbers */
@@ -1515,11 +1970,43 @@ bdevperf_test(void)
 						    g_show_performance_period_in_usec);
 	}
 
-	/* Iterate jobs to start all I/O */
-	TAILQ_FOREACH(job, &g_bdevperf.jobs, link) {
+	/* Start I/O for all jobs in the first phase */
+	if (bdevperf_start_phase(0) == 0) {
+		/* No job is assigned to phase 0 - skip ahead. */
 		g_bdevperf.running_jobs++;
-		spdk_thread_send_msg(job->thread, bdevperf_job_run, job);
+		bdevperf_job_end(NULL);
+	}
+}
+
+static int
+bdevperf_sync_start_poller(void *ctx)
+{
+	if (__atomic_load_n(&g_sync_shm->ready_count, __ATOMIC_ACQUIRE) <
+	    g_sync_shm->num_instances) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	spdk_poller_unregister(&g_sync_poller);
+	bdevperf_test_start();
+	return SPDK_POLLER_BUSY;
+}
+
+static void
+bdevperf_test(void)
+{
+	if (g_sync_shm != NULL) {
+		/* Line up with the other instances of the group so that every
+		 * process opens its measurement window at the same time.
+		 */
+		printf("Instance %u ready, waiting for %u bdevperf instances...\n",
+		       g_sync_instance_id, g_sync_shm->num_instances);
+		fflush(stdout);
+		__atomic_fetch_add(&g_sync_shm->ready_count, 1, __ATOMIC_RELEASE);
+		g_sync_poller = SPDK_POLLER_REGISTER(bdevperf_sync_start_poller, NULL, 1000);
+		return;
 	}
+
+	bdevperf_test_start();
 }
 
 static void
@@ -1776,6 +2263,10 @@ bdevperf_construct_job(struct spdk_bdev *bdev, struct job_config *config,
 	job->io_size_blocks = job->io_size / data_block_size;
 	job->buf_size = job->io_size_blocks * block_size;
 	job->abort = g_abort;
+	job->phase = config->phase;
+	job->time_in_usec = (config->runtime > 0 ? (uint64_t)config->runtime : (uint64_t)g_time_in_sec) *
+			    SPDK_SEC_TO_USEC;
+	job->ramp_time_in_usec = (uint64_t)config->ramp_time * SPDK_SEC_TO_USEC;
 	job_init_rw(job, config->rw);
 
 	if ((job->io_size % data_block_size) != 0) {
@@ -1810,8 +2301,8 @@ bdevperf_construct_job(struct spdk_bdev *bdev, struct job_config *config,
 		job->ios_base = 0;
 	}
 
-	if (job->is_random && g_zipf_theta > 0) {
-		job->zipf = spdk_zipf_create(job->size_in_ios, g_zipf_theta, 0);
+	if (job->is_random && config->zipf_theta > 0) {
+		job->zipf = spdk_zipf_create(job->size_in_ios, config->zipf_theta, 0);
 	}
 
 	if (job->verify) {
@@ -1843,6 +2334,15 @@ bdevperf_construct_job(struct spdk_bdev *bdev, struct job_config *config,
 		return -ENOMEM;
 	}
 
+	if (job->ramp_time_in_usec > 0) {
+		job->ramp_histogram = spdk_histogram_data_alloc();
+		if (job->ramp_histogram == NULL) {
+			fprintf(stderr, "Failed to allocate warmup histogram\n");
+			bdevperf_job_free(job);
+			return -ENOMEM;
+		}
+	}
+
 	TAILQ_INIT(&job->task_list);
 
 	if (g_random_map) {
@@ -2101,6 +2601,7 @@ make_cli_job_config(const char *filename, int64_t offset, uint64_t range)
 	config->rwmixread = g_rw_percentage;
 	config->offset = offset;
 	config->length = range;
+	config->zipf_theta = g_zipf_theta;
 	config->rw = parse_rw(g_workload_type, BDEVPERF_CONFIG_ERROR);
 	if ((int)config->rw == BDEVPERF_CONFIG_ERROR) {
 		free(config);
@@ -2120,6 +2621,10 @@ bdevperf_construct_multithread_job_config(void *ctx, struct spdk_bdev *bdev)
 	int64_t offset;
 	int rc;
 
+	if (!bdevperf_sync_claim_bdev()) {
+		return 0;
+	}
+
 	blocks_per_job = spdk_bdev_get_num_blocks(bdev) / *num_cores;
 	offset = 0;
 
@@ -2168,6 +2673,11 @@ bdevperf_construct_multithread_job_configs(void)
 static int
 bdevperf_construct_job_config(void *ctx, struct spdk_bdev *bdev)
 {
+	if (!bdevperf_sync_claim_bdev()) {
+		/* Another instance of the group tests this bdev. */
+		return 0;
+	}
+
 	/* Construct the job */
 	return make_cli_job_config(spdk_bdev_get_name(bdev), 0, 0);
 }
@@ -2177,6 +2687,9 @@ bdevperf_construct_job_configs(void)
 {
 	struct spdk_bdev *bdev;
 
+	/* Restart bdev striping across sync instances on every run. */
+	g_sync_bdev_index = 0;
+
 	/* There are three different modes for allocating jobs. Standard mode
 	 * (the default) creates one spdk_thread per bdev and runs the I/O job there.
 	 *
@@ -2279,6 +2792,9 @@ config_set_cli_args(struct job_config *config)
 	if (g_workload_type) {
 		config->rw = parse_rw(g_workload_type, config->rw);
 	}
+	if (g_zipf_theta > 0) {
+		config->zipf_theta = g_zipf_theta;
+	}
 }
 
 static int
@@ -2290,6 +2806,7 @@ read_job_config(void)
 	struct job_config *config = NULL;
 	const char *cpumask;
 	const char *rw;
+	const char *zipf;
 	bool is_global;
 	int n = 0;
 	int val;
@@ -2324,6 +2841,12 @@ read_job_config(void)
 	/* length 0 means 100% */
 	global_default_config.length = 0;
 	global_default_config.rw = BDEVPERF_CONFIG_UNDEFINED;
+	global_default_config.zipf_theta = 0;
+	/* ramp_time 0 means all I/O counts towards the results */
+	global_default_config.ramp_time = 0;
+	/* runtime 0 means use the -t option */
+	global_default_config.runtime = 0;
+	global_default_config.phase = 0;
 	config_set_cli_args(&global_default_config);
 
 	if ((int)global_default_config.rw == BDEVPERF_CONFIG_ERROR) {
@@ -2424,6 +2947,35 @@ read_job_config(void)
 			goto error;
 		}
 
+		zipf = spdk_conf_section_get_val(s, "zipf");
+		if (zipf == NULL) {
+			config->zipf_theta = global_config.zipf_theta;
+		} else {
+			char *endptr;
+
+			errno = 0;
+			config->zipf_theta = strtod(zipf, &endptr);
+			if (errno || zipf == endptr || config->zipf_theta < 0) {
+				fprintf(stderr, "Job '%s' has bad 'zipf' value\n", config->name);
+				goto error;
+			}
+		}
+
+		config->ramp_time = parse_uint_option(s, "ramp_time", global_config.ramp_time);
+		if (config->ramp_time == BDEVPERF_CONFIG_ERROR) {
+			goto error;
+		}
+
+		config->runtime = parse_uint_option(s, "runtime", global_config.runtime);
+		if (config->runtime == BDEVPERF_CONFIG_ERROR) {
+			goto error;
+		}
+
+		config->phase = parse_uint_option(s, "phase", global_config.phase);
+		if (config->phase == BDEVPERF_CONFIG_ERROR) {
+			goto error;
+		}
+
 		if (is_global) {
 			config_set_cli_args(config);
 			global_config = *config;
@@ -2679,6 +3231,16 @@ bdevperf_parse_arg(int ch, char *arg)
 		g_io_size = (int)size;
 	} else if (ch == 'U') {
 		g_unique_writes = true;
+	} else if (ch == BDEVPERF_OPTION_SYNC_INSTANCES) {
+		tmp = spdk_strtoll(arg, 10);
+		if (tmp < 2 || tmp > BDEVPERF_SYNC_MAX_INSTANCES) {
+			fprintf(stderr, "Invalid number of sync instances %s, valid range is 2-%d\n",
+				arg, BDEVPERF_SYNC_MAX_INSTANCES);
+			return -EINVAL;
+		}
+		g_sync_instances = tmp;
+	} else if (ch == BDEVPERF_OPTION_SYNC_SHM) {
+		g_sync_shm_name = arg;
 	} else {
 		tmp = spdk_strtoll(arg, 10);
 		if (tmp < 0) {
@@ -2745,6 +3307,11 @@ bdevperf_usage(void)
 	printf(" -E                        share per lcore thread among jobs. Available only if -j is not used.\n");
 	printf(" -J                        File name to open with append mode and log JSON RPC calls.\n");
 	printf(" -U                        generate unique data for each write I/O, has no effect on non-write I/O\n");
+	printf(" --sync-instances <num>    coordinate <num> bdevperf processes: they start and stop together,\n");
+	printf("                           split the auto-enumerated bdevs between them and the first process\n");
+	printf("                           prints a merged report\n");
+	printf(" --sync-shm <name>         shared memory segment used for coordination (default: %s)\n",
+	       BDEVPERF_SYNC_SHM_NAME_DEFAULT);
 }
 
 static void
@@ -2752,6 +3319,7 @@ bdevperf_fini(void)
 {
 	free_job_config();
 	free(g_workload_type);
+	bdevperf_sync_detach();
 
 	if (g_rpc_log_file != NULL) {
 		fclose(g_rpc_log_file);
@@ -2855,6 +3423,24 @@ out:
 	return 1;
 }
 
+static struct option g_cmdline_opts[] = {
+	{
+		.name = "sync-instances",
+		.has_arg = 1,
+		.flag = NULL,
+		.val = BDEVPERF_OPTION_SYNC_INSTANCES,
+	},
+	{
+		.name = "sync-shm",
+		.has_arg = 1,
+		.flag = NULL,
+		.val = BDEVPERF_OPTION_SYNC_SHM,
+	},
+	{
+		.name = NULL,
+	}
+};
+
 int
 main(int argc, char **argv)
 {
@@ -2869,7 +3455,7 @@ main(int argc, char **argv)
 	opts.rpc_addr = NULL;
 	opts.shutdown_cb = spdk_bdevperf_shutdown_cb;
 
-	if ((rc = spdk_app_parse_args(argc, argv, &opts, "Zzfq:o:t:w:k:CEF:J:M:P:S:T:Xlj:DU", NULL,
+	if ((rc = spdk_app_parse_args(argc, argv, &opts, "Zzfq:o:t:w:k:CEF:J:M:P:S:T:Xlj:DU", g_cmdline_opts,
 				      bdevperf_parse_arg, bdevperf_usage)) !=
 	    SPDK_APP_PARSE_ARGS_SUCCESS) {
 		return rc;
@@ -2886,6 +3472,18 @@ main(int argc, char **argv)
 		return 1;
 	}
 
+	if (g_sync_instances > 0) {
+		if (g_wait_for_tests) {
+			fprintf(stderr, "--sync-instances cannot be combined with -z\n");
+			bdevperf_fini();
+			return 1;
+		}
+		if (bdevperf_sync_attach() != 0) {
+			bdevperf_fini();
+			return 1;
+		}
+	}
+
 	if (g_rpc_log_file != NULL) {
 		opts.rpc_log_file = g_rpc_log_file;
 	}
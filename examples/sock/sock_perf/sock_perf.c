@@ -0,0 +1,794 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#include "spdk/stdinc.h"
+#include "spdk/env.h"
+#include "spdk/event.h"
+#include "spdk/log.h"
+#include "spdk/sock.h"
+#include "spdk/string.h"
+#include "spdk/thread.h"
+#include "spdk/util.h"
+
+#define ACCEPT_TIMEOUT_US	1000
+#define DEFAULT_PORT		8000
+#define DEFAULT_MSG_SIZE	4096
+#define DEFAULT_QUEUE_DEPTH	4
+#define DEFAULT_CONNECTIONS	1
+#define DEFAULT_TIME_IN_SEC	10
+#define MIN_RECV_BUF_SIZE	(64 * 1024)
+
+static char *g_host = "127.0.0.1";
+static char *g_sock_impl_name;
+static int g_port = DEFAULT_PORT;
+static bool g_is_server;
+static int g_num_connections = DEFAULT_CONNECTIONS;
+static uint32_t g_msg_size = DEFAULT_MSG_SIZE;
+static int g_queue_depth = DEFAULT_QUEUE_DEPTH;
+static int g_time_in_sec = DEFAULT_TIME_IN_SEC;
+/* Impl opt toggles: -1 leaves the module default untouched. */
+static int g_zcopy = -1;
+static int g_recv_pipe = -1;
+static int g_quickack = -1;
+
+static bool g_is_running;
+static int g_rc;
+static void *g_send_buf;
+static struct spdk_sock *g_listen_sock;
+static struct spdk_poller *g_accept_poller;
+static uint64_t g_tsc_rate;
+
+struct sock_perf_worker;
+
+struct sock_perf_conn {
+	struct spdk_sock		*sock;
+	struct sock_perf_worker		*worker;
+	uint64_t			bytes_sent;
+	uint64_t			bytes_recv;
+	int				outstanding;
+	bool				closing;
+	struct sock_perf_send_req	*sends;
+	TAILQ_ENTRY(sock_perf_conn)	link;
+};
+
+/* The sock layer expects an iovec array to immediately follow the request
+ * in memory, so keep req and iov adjacent and last. */
+struct sock_perf_send_req {
+	struct sock_perf_conn		*conn;
+	struct spdk_sock_request	req;
+	struct iovec			iov;
+};
+
+struct sock_perf_worker {
+	struct spdk_thread		*thread;
+	uint32_t			core;
+	struct spdk_sock_group		*group;
+	struct spdk_poller		*group_poller;
+	struct spdk_poller		*stop_poller;
+	struct spdk_poller		*drain_poller;
+	void				*recv_buf;
+	uint64_t			poll_tsc;
+	uint64_t			poll_count;
+	uint64_t			start_tsc;
+	uint64_t			end_tsc;
+	int				num_conns;
+	bool				is_draining;
+	/* Accumulated at connection close so that the numbers survive the
+	 * connections themselves. */
+	int				conn_count;
+	uint64_t			conn_bytes_total;
+	uint64_t			conn_bytes_min;
+	uint64_t			conn_bytes_max;
+	TAILQ_HEAD(sock_perf_conns, sock_perf_conn)	conns;
+	struct sock_perf_worker		*next;
+};
+
+struct sock_perf_worker_ctx {
+	int num_conns;
+};
+
+struct sock_perf_accept_msg {
+	struct sock_perf_worker	*worker;
+	struct spdk_sock	*sock;
+};
+
+static pthread_mutex_t g_workers_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct sock_perf_worker *g_workers;
+static struct sock_perf_worker *g_next_worker;
+static int g_num_workers;
+static int g_running_workers;
+
+static void
+sock_perf_usage(void)
+{
+	printf(" -C connections  total number of connections to open (client only, default %d)\n",
+	       DEFAULT_CONNECTIONS);
+	printf(" -H host_addr    host address (default 127.0.0.1)\n");
+	printf(" -N sock_impl    socket implementation, e.g., -N posix or -N uring\n");
+	printf(" -P port         port number (default %d)\n", DEFAULT_PORT);
+	printf(" -S              start in server mode\n");
+	printf(" -o msg_size     message size in bytes (default %d)\n", DEFAULT_MSG_SIZE);
+	printf(" -q queue_depth  writes in flight per connection (client only, default %d)\n",
+	       DEFAULT_QUEUE_DEPTH);
+	printf(" -t time_in_sec  run time in seconds (client only, default %d)\n", DEFAULT_TIME_IN_SEC);
+	printf(" -k/-K           disable/enable quick ACK for the given sock implementation\n");
+	printf(" -x/-X           disable/enable the receive pipe for the given sock implementation\n");
+	printf(" -z/-Z           disable/enable zero copy send for the given sock implementation\n");
+}
+
+static int
+sock_perf_parse_arg(int ch, char *arg)
+{
+	switch (ch) {
+	case 'C':
+		g_num_connections = spdk_strtol(arg, 10);
+		if (g_num_connections <= 0) {
+			fprintf(stderr, "Invalid connection count\n");
+			return -EINVAL;
+		}
+		break;
+	case 'H':
+		g_host = arg;
+		break;
+	case 'N':
+		g_sock_impl_name = arg;
+		break;
+	case 'P':
+		g_port = spdk_strtol(arg, 10);
+		if (g_port < 0) {
+			fprintf(stderr, "Invalid port ID\n");
+			return g_port;
+		}
+		break;
+	case 'S':
+		g_is_server = true;
+		break;
+	case 'o':
+		g_msg_size = spdk_strtol(arg, 10);
+		if (g_msg_size == 0) {
+			fprintf(stderr, "Invalid message size\n");
+			return -EINVAL;
+		}
+		break;
+	case 'q':
+		g_queue_depth = spdk_strtol(arg, 10);
+		if (g_queue_depth <= 0) {
+			fprintf(stderr, "Invalid queue depth\n");
+			return -EINVAL;
+		}
+		break;
+	case 't':
+		g_time_in_sec = spdk_strtol(arg, 10);
+		if (g_time_in_sec <= 0) {
+			fprintf(stderr, "Invalid run time\n");
+			return -EINVAL;
+		}
+		break;
+	case 'k':
+		g_quickack = 0;
+		break;
+	case 'K':
+		g_quickack = 1;
+		break;
+	case 'x':
+		g_recv_pipe = 0;
+		break;
+	case 'X':
+		g_recv_pipe = 1;
+		break;
+	case 'z':
+		g_zcopy = 0;
+		break;
+	case 'Z':
+		g_zcopy = 1;
+		break;
+	default:
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static const char *
+sock_perf_toggle_str(int val)
+{
+	return val < 0 ? "module default" : (val ? "enabled" : "disabled");
+}
+
+static void
+dump_user_config(void)
+{
+	printf("SPDK sock_perf configuration:\n");
+	printf("Mode:                   %s\n", g_is_server ? "server" : "client");
+	printf("Target:                 %s:%d\n", g_host, g_port);
+	printf("Sock implementation:    %s\n",
+	       g_sock_impl_name ? g_sock_impl_name : "default");
+	printf("Poll groups:            %u (one per core)\n", spdk_env_get_core_count());
+	if (!g_is_server) {
+		printf("Connections:            %d\n", g_num_connections);
+		printf("Queue depth:            %d\n", g_queue_depth);
+		printf("Run time:               %d seconds\n", g_time_in_sec);
+	}
+	printf("Message size:           %u bytes\n", g_msg_size);
+	printf("Zero copy send:         %s\n", sock_perf_toggle_str(g_zcopy));
+	printf("Receive pipe:           %s\n", sock_perf_toggle_str(g_recv_pipe));
+	printf("Quick ACK:              %s\n", sock_perf_toggle_str(g_quickack));
+}
+
+static void
+sock_perf_close_conn(struct sock_perf_conn *conn)
+{
+	struct sock_perf_worker *worker = conn->worker;
+	uint64_t bytes = conn->bytes_sent + conn->bytes_recv;
+
+	if (worker->conn_count == 0 || bytes < worker->conn_bytes_min) {
+		worker->conn_bytes_min = bytes;
+	}
+	if (bytes > worker->conn_bytes_max) {
+		worker->conn_bytes_max = bytes;
+	}
+	worker->conn_bytes_total += bytes;
+	worker->conn_count++;
+
+	TAILQ_REMOVE(&worker->conns, conn, link);
+	worker->num_conns--;
+	spdk_sock_group_remove_sock(worker->group, conn->sock);
+	spdk_sock_close(&conn->sock);
+	free(conn->sends);
+	free(conn);
+}
+
+static void sock_perf_submit_send(struct sock_perf_send_req *sreq);
+
+static void
+sock_perf_send_done(void *cb_arg, int err)
+{
+	struct sock_perf_send_req *sreq = cb_arg;
+	struct sock_perf_conn *conn = sreq->conn;
+
+	conn->outstanding--;
+	if (err != 0) {
+		if (!conn->worker->is_draining && !conn->closing) {
+			SPDK_ERRLOG("Send failed (%d): %s\n", err, spdk_strerror(-err));
+			conn->closing = true;
+			g_rc = -1;
+		}
+		return;
+	}
+
+	conn->bytes_sent += g_msg_size;
+	if (!conn->worker->is_draining && !conn->closing) {
+		sock_perf_submit_send(sreq);
+	}
+}
+
+static void
+sock_perf_submit_send(struct sock_perf_send_req *sreq)
+{
+	struct sock_perf_conn *conn = sreq->conn;
+
+	sreq->req.cb_fn = sock_perf_send_done;
+	sreq->req.cb_arg = sreq;
+	sreq->req.iovcnt = 1;
+	sreq->iov.iov_base = g_send_buf;
+	sreq->iov.iov_len = g_msg_size;
+
+	conn->outstanding++;
+	spdk_sock_writev_async(conn->sock, &sreq->req);
+}
+
+static void
+sock_perf_recv_cb(void *arg, struct spdk_sock_group *group, struct spdk_sock *sock)
+{
+	struct sock_perf_conn *conn = arg;
+	struct sock_perf_worker *worker = conn->worker;
+	ssize_t n;
+
+	n = spdk_sock_recv(sock, worker->recv_buf, spdk_max(g_msg_size, MIN_RECV_BUF_SIZE));
+	if (n > 0) {
+		conn->bytes_recv += n;
+		return;
+	}
+
+	if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+		return;
+	}
+
+	if (n < 0 && errno != ENOTCONN && errno != ECONNRESET) {
+		SPDK_ERRLOG("spdk_sock_recv() failed, errno %d: %s\n",
+			    errno, spdk_strerror(errno));
+	}
+
+	/* Connection closed by the peer. */
+	sock_perf_close_conn(conn);
+}
+
+static struct sock_perf_conn *
+sock_perf_add_conn(struct sock_perf_worker *worker, struct spdk_sock *sock)
+{
+	struct sock_perf_conn *conn;
+	int rc;
+
+	conn = calloc(1, sizeof(*conn));
+	if (conn == NULL) {
+		SPDK_ERRLOG("Unable to allocate connection\n");
+		return NULL;
+	}
+
+	conn->sock = sock;
+	conn->worker = worker;
+
+	rc = spdk_sock_group_add_sock(worker->group, sock, sock_perf_recv_cb, conn);
+	if (rc < 0) {
+		SPDK_ERRLOG("Failed to add sock to group: %s\n", spdk_strerror(-rc));
+		free(conn);
+		return NULL;
+	}
+
+	TAILQ_INSERT_TAIL(&worker->conns, conn, link);
+	worker->num_conns++;
+	if (worker->start_tsc == 0) {
+		worker->start_tsc = spdk_get_ticks();
+	}
+
+	return conn;
+}
+
+static int
+sock_perf_group_poll(void *arg)
+{
+	struct sock_perf_worker *worker = arg;
+	uint64_t start = spdk_get_ticks();
+	int rc;
+
+	rc = spdk_sock_group_poll(worker->group);
+	worker->poll_tsc += spdk_get_ticks() - start;
+	worker->poll_count++;
+	if (rc < 0) {
+		SPDK_ERRLOG("Failed to poll sock_group=%p\n", worker->group);
+	}
+
+	return rc > 0 ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
+}
+
+static void
+sock_perf_worker_done(struct sock_perf_worker *worker)
+{
+	struct sock_perf_conn *conn, *tmp;
+	bool last;
+
+	worker->end_tsc = spdk_get_ticks();
+
+	TAILQ_FOREACH_SAFE(conn, &worker->conns, link, tmp) {
+		sock_perf_close_conn(conn);
+	}
+
+	spdk_poller_unregister(&worker->group_poller);
+	spdk_sock_group_close(&worker->group);
+
+	pthread_mutex_lock(&g_workers_lock);
+	last = (--g_running_workers == 0);
+	pthread_mutex_unlock(&g_workers_lock);
+
+	if (last) {
+		spdk_app_stop(g_rc);
+	}
+
+	spdk_thread_exit(spdk_get_thread());
+}
+
+static int
+sock_perf_check_drained(void *arg)
+{
+	struct sock_perf_worker *worker = arg;
+	struct sock_perf_conn *conn;
+
+	TAILQ_FOREACH(conn, &worker->conns, link) {
+		if (conn->outstanding > 0) {
+			return SPDK_POLLER_IDLE;
+		}
+	}
+
+	spdk_poller_unregister(&worker->drain_poller);
+	sock_perf_worker_done(worker);
+	return SPDK_POLLER_BUSY;
+}
+
+static void
+sock_perf_worker_drain(struct sock_perf_worker *worker)
+{
+	if (worker->is_draining) {
+		return;
+	}
+
+	worker->is_draining = true;
+	spdk_poller_unregister(&worker->stop_poller);
+	worker->drain_poller = SPDK_POLLER_REGISTER(sock_perf_check_drained, worker, 0);
+}
+
+static int
+sock_perf_worker_stop(void *arg)
+{
+	sock_perf_worker_drain(arg);
+	return SPDK_POLLER_BUSY;
+}
+
+static void
+sock_perf_worker_shutdown(void *arg)
+{
+	sock_perf_worker_drain(arg);
+}
+
+static void
+sock_perf_server_add_conn_msg(void *arg)
+{
+	struct sock_perf_accept_msg *msg = arg;
+
+	if (msg->worker->is_draining || sock_perf_add_conn(msg->worker, msg->sock) == NULL) {
+		spdk_sock_close(&msg->sock);
+	}
+	free(msg);
+}
+
+static int
+sock_perf_accept_poll(void *arg)
+{
+	struct sock_perf_accept_msg *msg;
+	struct spdk_sock *sock;
+	int count = 0;
+
+	if (!g_is_running) {
+		spdk_poller_unregister(&g_accept_poller);
+		spdk_sock_close(&g_listen_sock);
+		return SPDK_POLLER_IDLE;
+	}
+
+	while (1) {
+		sock = spdk_sock_accept(g_listen_sock);
+		if (sock == NULL) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				SPDK_ERRLOG("accept error(%d): %s\n", errno, spdk_strerror(errno));
+			}
+			break;
+		}
+
+		/* Spread accepted connections round-robin across the poll groups. */
+		pthread_mutex_lock(&g_workers_lock);
+		if (g_next_worker == NULL) {
+			g_next_worker = g_workers;
+		}
+		msg = calloc(1, sizeof(*msg));
+		if (msg == NULL || g_next_worker == NULL) {
+			pthread_mutex_unlock(&g_workers_lock);
+			free(msg);
+			spdk_sock_close(&sock);
+			break;
+		}
+		msg->worker = g_next_worker;
+		msg->sock = sock;
+		g_next_worker = g_next_worker->next;
+		pthread_mutex_unlock(&g_workers_lock);
+
+		spdk_thread_send_msg(msg->worker->thread, sock_perf_server_add_conn_msg, msg);
+		count++;
+	}
+
+	return count > 0 ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
+}
+
+static int
+sock_perf_open_conn(struct sock_perf_worker *worker)
+{
+	struct sock_perf_conn *conn;
+	struct spdk_sock *sock;
+	int i;
+
+	sock = spdk_sock_connect(g_host, g_port, g_sock_impl_name);
+	if (sock == NULL) {
+		SPDK_ERRLOG("connect error(%d): %s\n", errno, spdk_strerror(errno));
+		return -errno;
+	}
+
+	conn = sock_perf_add_conn(worker, sock);
+	if (conn == NULL) {
+		spdk_sock_close(&sock);
+		return -ENOMEM;
+	}
+
+	conn->sends = calloc(g_queue_depth, sizeof(struct sock_perf_send_req));
+	if (conn->sends == NULL) {
+		SPDK_ERRLOG("Unable to allocate send requests\n");
+		sock_perf_close_conn(conn);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < g_queue_depth; i++) {
+		conn->sends[i].conn = conn;
+		sock_perf_submit_send(&conn->sends[i]);
+	}
+
+	return 0;
+}
+
+static void
+sock_perf_init_thread(void *arg)
+{
+	struct sock_perf_worker_ctx *ctx = arg;
+	struct sock_perf_worker *worker;
+	int i, num_conns = ctx->num_conns;
+
+	free(ctx);
+
+	worker = calloc(1, sizeof(*worker));
+	if (worker == NULL) {
+		SPDK_ERRLOG("Unable to allocate worker\n");
+		goto error;
+	}
+
+	worker->core = spdk_env_get_current_core();
+	worker->thread = spdk_get_thread();
+	TAILQ_INIT(&worker->conns);
+
+	worker->recv_buf = calloc(1, spdk_max(g_msg_size, MIN_RECV_BUF_SIZE));
+	if (worker->recv_buf == NULL) {
+		SPDK_ERRLOG("Unable to allocate receive buffer\n");
+		goto error;
+	}
+
+	worker->group = spdk_sock_group_create(NULL);
+	if (worker->group == NULL) {
+		SPDK_ERRLOG("Cannot create sock group\n");
+		goto error;
+	}
+
+	worker->group_poller = SPDK_POLLER_REGISTER(sock_perf_group_poll, worker, 0);
+
+	pthread_mutex_lock(&g_workers_lock);
+	worker->next = g_workers;
+	g_workers = worker;
+	g_num_workers++;
+	g_running_workers++;
+	pthread_mutex_unlock(&g_workers_lock);
+
+	if (!g_is_server) {
+		for (i = 0; i < num_conns; i++) {
+			if (sock_perf_open_conn(worker) != 0) {
+				g_rc = -1;
+				sock_perf_worker_drain(worker);
+				return;
+			}
+		}
+
+		worker->stop_poller = SPDK_POLLER_REGISTER(sock_perf_worker_stop, worker,
+				      g_time_in_sec * 1000000ULL);
+	}
+
+	return;
+error:
+	if (worker != NULL) {
+		free(worker->recv_buf);
+		free(worker);
+	}
+	g_rc = -1;
+	spdk_app_stop(g_rc);
+	spdk_thread_exit(spdk_get_thread());
+}
+
+static void
+sock_perf_start(void *arg1)
+{
+	struct spdk_cpuset tmp_cpumask = {};
+	struct sock_perf_worker_ctx *ctx;
+	struct spdk_thread *thread;
+	char thread_name[32];
+	uint32_t i, num_cores, idx = 0;
+	int base, remainder;
+
+	g_tsc_rate = spdk_get_ticks_hz();
+	g_is_running = true;
+
+	dump_user_config();
+
+	g_send_buf = calloc(1, g_msg_size);
+	if (g_send_buf == NULL) {
+		SPDK_ERRLOG("Unable to allocate send buffer\n");
+		spdk_app_stop(-1);
+		return;
+	}
+
+	num_cores = spdk_env_get_core_count();
+	base = g_num_connections / num_cores;
+	remainder = g_num_connections % num_cores;
+
+	SPDK_ENV_FOREACH_CORE(i) {
+		ctx = calloc(1, sizeof(*ctx));
+		if (ctx == NULL) {
+			SPDK_ERRLOG("Unable to allocate memory\n");
+			spdk_app_stop(-1);
+			return;
+		}
+		ctx->num_conns = base + (idx < (uint32_t)remainder ? 1 : 0);
+		idx++;
+
+		snprintf(thread_name, sizeof(thread_name), "sock_perf_%u", i);
+		spdk_cpuset_zero(&tmp_cpumask);
+		spdk_cpuset_set_cpu(&tmp_cpumask, i, true);
+		thread = spdk_thread_create(thread_name, &tmp_cpumask);
+		spdk_thread_send_msg(thread, sock_perf_init_thread, ctx);
+	}
+
+	if (g_is_server) {
+		g_listen_sock = spdk_sock_listen(g_host, g_port, g_sock_impl_name);
+		if (g_listen_sock == NULL) {
+			SPDK_ERRLOG("Cannot create server socket\n");
+			spdk_app_stop(-1);
+			return;
+		}
+
+		SPDK_NOTICELOG("Listening on %s:%d\n", g_host, g_port);
+		g_accept_poller = SPDK_POLLER_REGISTER(sock_perf_accept_poll, NULL,
+						       ACCEPT_TIMEOUT_US);
+	} else {
+		printf("Running for %d seconds...\n", g_time_in_sec);
+		fflush(stdout);
+	}
+}
+
+static void
+sock_perf_shutdown_cb(void)
+{
+	struct sock_perf_worker *worker;
+
+	g_is_running = false;
+
+	pthread_mutex_lock(&g_workers_lock);
+	for (worker = g_workers; worker != NULL; worker = worker->next) {
+		spdk_thread_send_msg(worker->thread, sock_perf_worker_shutdown, worker);
+	}
+	pthread_mutex_unlock(&g_workers_lock);
+}
+
+static void
+dump_result(void)
+{
+	struct sock_perf_worker *worker;
+	uint64_t total_bytes = 0, total_polls = 0, total_poll_tsc = 0;
+	double rate, elapsed, poll_cost;
+	double conn_min = 0, conn_max = 0;
+	int total_conns = 0;
+	bool first = true;
+
+	printf("\n%6s %6s %17s %15s %16s\n",
+	       "Core", "Conns", "Bandwidth (MiB/s)", "Polls", "Poll cost (usec)");
+	printf("------ ------ ----------------- --------------- ----------------\n");
+
+	for (worker = g_workers; worker != NULL; worker = worker->next) {
+		elapsed = worker->end_tsc > worker->start_tsc ?
+			  (double)(worker->end_tsc - worker->start_tsc) / g_tsc_rate : 0;
+		rate = elapsed > 0 ? worker->conn_bytes_total / elapsed / (1024 * 1024) : 0;
+		poll_cost = worker->poll_count > 0 ?
+			    (double)worker->poll_tsc * SPDK_SEC_TO_USEC / worker->poll_count / g_tsc_rate : 0;
+
+		printf("%6u %6d %17.2f %15" PRIu64 " %16.3f\n",
+		       worker->core, worker->conn_count, rate, worker->poll_count, poll_cost);
+
+		total_bytes += worker->conn_bytes_total;
+		total_polls += worker->poll_count;
+		total_poll_tsc += worker->poll_tsc;
+		total_conns += worker->conn_count;
+
+		if (elapsed > 0 && worker->conn_count > 0) {
+			if (first || worker->conn_bytes_min / elapsed < conn_min) {
+				conn_min = worker->conn_bytes_min / elapsed;
+			}
+			if (first || worker->conn_bytes_max / elapsed > conn_max) {
+				conn_max = worker->conn_bytes_max / elapsed;
+			}
+			first = false;
+		}
+	}
+
+	printf("==================================================================\n");
+	printf("Total: %d connections, %.2f MiB/s aggregate\n",
+	       total_conns, g_time_in_sec > 0 ? (double)total_bytes / g_time_in_sec / (1024 * 1024) : 0);
+	if (total_conns > 0) {
+		printf("Per-connection bandwidth: min %.2f, avg %.2f, max %.2f MiB/s\n",
+		       conn_min / (1024 * 1024),
+		       (double)total_bytes / total_conns / g_time_in_sec / (1024 * 1024),
+		       conn_max / (1024 * 1024));
+	}
+	if (total_polls > 0) {
+		printf("Group poll cycle cost: %.3f usec average across %" PRIu64 " polls\n",
+		       (double)total_poll_tsc * SPDK_SEC_TO_USEC / total_polls / g_tsc_rate,
+		       total_polls);
+	}
+}
+
+static int
+sock_perf_apply_impl_opts(void)
+{
+	struct spdk_sock_impl_opts impl_opts = {};
+	size_t len = sizeof(impl_opts);
+	const char *impl = g_sock_impl_name;
+	int rc;
+
+	if (g_zcopy < 0 && g_recv_pipe < 0 && g_quickack < 0) {
+		return 0;
+	}
+
+	if (impl == NULL) {
+		impl = spdk_sock_get_default_impl();
+		if (impl == NULL) {
+			SPDK_ERRLOG("No sock implementations available!\n");
+			return -ENODEV;
+		}
+	}
+
+	rc = spdk_sock_impl_get_opts(impl, &impl_opts, &len);
+	if (rc < 0) {
+		return rc;
+	}
+
+	if (g_zcopy >= 0) {
+		if (g_is_server) {
+			impl_opts.enable_zerocopy_send_server = g_zcopy;
+		} else {
+			impl_opts.enable_zerocopy_send_client = g_zcopy;
+		}
+	}
+	if (g_recv_pipe >= 0) {
+		impl_opts.enable_recv_pipe = g_recv_pipe;
+	}
+	if (g_quickack >= 0) {
+		impl_opts.enable_quickack = g_quickack;
+	}
+
+	return spdk_sock_impl_set_opts(impl, &impl_opts, len);
+}
+
+int
+main(int argc, char **argv)
+{
+	struct spdk_app_opts opts = {};
+	struct sock_perf_worker *worker, *tmp;
+	int rc;
+
+	spdk_app_opts_init(&opts, sizeof(opts));
+	opts.name = "sock_perf";
+	opts.shutdown_cb = sock_perf_shutdown_cb;
+	opts.rpc_addr = NULL;
+
+	rc = spdk_app_parse_args(argc, argv, &opts, "C:H:kKN:o:P:q:St:xXzZ", NULL,
+				 sock_perf_parse_arg, sock_perf_usage);
+	if (rc != SPDK_APP_PARSE_ARGS_SUCCESS) {
+		exit(rc);
+	}
+
+	rc = sock_perf_apply_impl_opts();
+	if (rc < 0) {
+		SPDK_ERRLOG("Failed to apply sock implementation options\n");
+		exit(-rc);
+	}
+
+	rc = spdk_app_start(&opts, sock_perf_start, NULL);
+	if (rc) {
+		SPDK_ERRLOG("ERROR starting application\n");
+	} else {
+		rc = g_rc;
+	}
+
+	dump_result();
+
+	worker = g_workers;
+	while (worker != NULL) {
+		tmp = worker->next;
+		free(worker->recv_buf);
+		free(worker);
+		worker = tmp;
+	}
+	free(g_send_buf);
+
+	spdk_app_fini();
+	return rc;
+}
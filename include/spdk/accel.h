@@ -259,6 +259,65 @@ int spdk_accel_submit_copy_crc32cv(struct spdk_io_channel *ch, void *dst, struct
 				   uint32_t iovcnt, uint32_t *crc_dst, uint32_t seed,
 				   spdk_accel_completion_cb cb_fn, void *cb_arg);
 
+/**
+ * Describes a single operation within a batch submitted through
+ * spdk_accel_submit_batch().  Only the fields used by the given opcode need to
+ * be set.
+ */
+struct spdk_accel_submit_entry {
+	/** Operation to execute.  Only SPDK_ACCEL_OPC_COPY, SPDK_ACCEL_OPC_FILL,
+	 *  SPDK_ACCEL_OPC_DUALCAST, SPDK_ACCEL_OPC_COMPARE, SPDK_ACCEL_OPC_CRC32C and
+	 *  SPDK_ACCEL_OPC_COPY_CRC32C are accepted in a batch. */
+	enum spdk_accel_opcode opcode;
+	/** Destination buffer (copy, fill, dualcast, copy_crc32c). */
+	void *dst;
+	/** Second destination buffer (dualcast). */
+	void *dst2;
+	/** Source buffer (copy, dualcast, compare, crc32c, copy_crc32c). */
+	void *src;
+	/** Second source buffer (compare). */
+	void *src2;
+	/** Destination to write the CRC-32C to (crc32c, copy_crc32c). */
+	uint32_t *crc_dst;
+	/** Four byte CRC-32C seed value (crc32c, copy_crc32c). */
+	uint32_t seed;
+	/** Fill pattern byte (fill). */
+	uint8_t fill;
+	/** Length in bytes. */
+	uint64_t nbytes;
+	/** Called when this operation completes. */
+	spdk_accel_completion_cb cb_fn;
+	/** Argument passed to cb_fn. */
+	void *cb_arg;
+};
+
+/**
+ * Maximum number of entries accepted by a single spdk_accel_submit_batch() call.
+ */
+#define SPDK_ACCEL_MAX_SUBMIT_BATCH 64
+
+/**
+ * Submit a batch of operations in a single call.
+ *
+ * All tasks backing the batch are carved from the channel's task pool up front
+ * and entries assigned to the same module are handed to its submit_tasks
+ * callback as a single chain in one call, allowing hardware modules to submit
+ * them back to back.  Every entry gets its own completion callback.
+ *
+ * The batch is allocated atomically: on -ENOMEM no operation has been
+ * submitted and none of the callbacks will be called.
+ *
+ * \param ch I/O channel associated with this call.
+ * \param entries Array of operation descriptors.
+ * \param count Number of entries, at most SPDK_ACCEL_MAX_SUBMIT_BATCH.
+ *
+ * \return 0 on success, negative errno on failure.  -EINVAL if an entry uses
+ * an unsupported opcode or count is too large, -ENOMEM if there aren't enough
+ * tasks available to back the whole batch.
+ */
+int spdk_accel_submit_batch(struct spdk_io_channel *ch, struct spdk_accel_submit_entry *entries,
+			    uint32_t count);
+
 /**
  * Build and submit a memory compress request.
  *
@@ -663,6 +722,134 @@ int spdk_accel_append_crc32c(struct spdk_accel_sequence **seq, struct spdk_io_ch
 			     struct spdk_memory_domain *domain, void *domain_ctx,
 			     uint32_t seed, spdk_accel_step_cb cb_fn, void *cb_arg);
 
+/**
+ * Append a Data Integrity Field (DIF) verify operation to a sequence.
+ *
+ * \param seq Sequence object.  If NULL, a new sequence object will be created.
+ * \param ch I/O channel.
+ * \param iovs The io vector array. The total allocated memory size needs to be at least:
+ *             num_blocks * block_size (including metadata)
+ * \param iovcnt The size of the io vectors array.
+ * \param domain Memory domain to which the source buffers belong.
+ * \param domain_ctx Source buffer domain context.
+ * \param num_blocks Number of data blocks to check.
+ * \param ctx DIF context. Contains the DIF configuration values, including the reference
+ *            Application Tag value and initial value of the Reference Tag to check
+ *            Note: the user must ensure the validity of this pointer throughout the entire operation
+ *            because it is not validated along the processing path.
+ * \param err DIF error detailed information.
+ *            Note: the user must ensure the validity of this pointer throughout the entire operation
+ *            because it is not validated along the processing path.
+ * \param cb_fn Callback to be executed once this operation is completed.
+ * \param cb_arg Argument to be passed to `cb_fn`.
+ *
+ * \return 0 if operation was successfully added to the sequence, negative errno otherwise.
+ */
+int spdk_accel_append_dif_verify(struct spdk_accel_sequence **seq, struct spdk_io_channel *ch,
+				 struct iovec *iovs, size_t iovcnt,
+				 struct spdk_memory_domain *domain, void *domain_ctx,
+				 uint32_t num_blocks,
+				 const struct spdk_dif_ctx *ctx, struct spdk_dif_error *err,
+				 spdk_accel_step_cb cb_fn, void *cb_arg);
+
+/**
+ * Append a Data Integrity Field (DIF) copy and verify operation to a sequence.
+ *
+ * The DIF data is stripped from the source data while being verified according
+ * to the flags provided in the context.
+ *
+ * \param seq Sequence object.  If NULL, a new sequence object will be created.
+ * \param ch I/O channel.
+ * \param dst_iovs The destination I/O vector array. The total allocated memory size needs
+ *		  to be at least: num_blocks * block_size (provided to spdk_dif_ctx_init())
+ * \param dst_iovcnt The size of the destination I/O vectors array.
+ * \param dst_domain Memory domain to which the destination buffers belong.
+ * \param dst_domain_ctx Destination buffer domain context.
+ * \param src_iovs The source I/O vector array. The total allocated memory size needs
+ *		  to be at least: num_blocks * data_block_size.
+ * \param src_iovcnt The size of the source I/O vectors array.
+ * \param src_domain Memory domain to which the source buffers belong.
+ * \param src_domain_ctx Source buffer domain context.
+ * \param num_blocks Number of data blocks to process.
+ * \param ctx DIF context. Contains the DIF configuration values, including the reference
+ *            Application Tag value and initial value of the Reference Tag to insert.
+ * \param err DIF error detailed information.
+ *            Note: the user must ensure the validity of this pointer throughout the entire operation
+ *            because it is not validated along the processing path.
+ * \param cb_fn Callback to be executed once this operation is completed.
+ * \param cb_arg Argument to be passed to `cb_fn`.
+ *
+ * \return 0 if operation was successfully added to the sequence, negative errno otherwise.
+ */
+int spdk_accel_append_dif_verify_copy(struct spdk_accel_sequence **seq, struct spdk_io_channel *ch,
+				      struct iovec *dst_iovs, size_t dst_iovcnt,
+				      struct spdk_memory_domain *dst_domain, void *dst_domain_ctx,
+				      struct iovec *src_iovs, size_t src_iovcnt,
+				      struct spdk_memory_domain *src_domain, void *src_domain_ctx,
+				      uint32_t num_blocks,
+				      const struct spdk_dif_ctx *ctx, struct spdk_dif_error *err,
+				      spdk_accel_step_cb cb_fn, void *cb_arg);
+
+/**
+ * Append a Data Integrity Field (DIF) generate operation to a sequence.  The DIF
+ * is computed on the source data and inserted in place into the source data.
+ *
+ * \param seq Sequence object.  If NULL, a new sequence object will be created.
+ * \param ch I/O channel.
+ * \param iovs The io vector array. The total allocated memory size needs to be at least:
+ *             num_blocks * block_size (including metadata)
+ * \param iovcnt The size of the io vectors array.
+ * \param domain Memory domain to which the source buffers belong.
+ * \param domain_ctx Source buffer domain context.
+ * \param num_blocks Number of data blocks.
+ * \param ctx DIF context. Contains the DIF configuration values, including the reference
+ *            Application Tag value and initial value of the Reference Tag to insert
+ * \param cb_fn Callback to be executed once this operation is completed.
+ * \param cb_arg Argument to be passed to `cb_fn`.
+ *
+ * \return 0 if operation was successfully added to the sequence, negative errno otherwise.
+ */
+int spdk_accel_append_dif_generate(struct spdk_accel_sequence **seq, struct spdk_io_channel *ch,
+				   struct iovec *iovs, size_t iovcnt,
+				   struct spdk_memory_domain *domain, void *domain_ctx,
+				   uint32_t num_blocks, const struct spdk_dif_ctx *ctx,
+				   spdk_accel_step_cb cb_fn, void *cb_arg);
+
+/**
+ * Append a Data Integrity Field (DIF) copy and generate operation to a sequence.
+ *
+ * The source data is copied to the destination, with the DIF computed on the
+ * source data and inserted into the output data.
+ *
+ * \param seq Sequence object.  If NULL, a new sequence object will be created.
+ * \param ch I/O channel.
+ * \param dst_iovs The destination io vector array. The total allocated memory size needs
+ *		  to be at least: num_blocks * block_size (provided to spdk_dif_ctx_init())
+ * \param dst_iovcnt The size of the destination io vectors array.
+ * \param dst_domain Memory domain to which the destination buffers belong.
+ * \param dst_domain_ctx Destination buffer domain context.
+ * \param src_iovs The source io vector array. The total allocated memory size needs
+ *		  to be at least: num_blocks * data_block_size.
+ * \param src_iovcnt The size of the source io vectors array.
+ * \param src_domain Memory domain to which the source buffers belong.
+ * \param src_domain_ctx Source buffer domain context.
+ * \param num_blocks Number of data blocks to process.
+ * \param ctx DIF context. Contains the DIF configuration values, including the reference
+ *            Application Tag value and initial value of the Reference Tag to insert
+ * \param cb_fn Callback to be executed once this operation is completed.
+ * \param cb_arg Argument to be passed to `cb_fn`.
+ *
+ * \return 0 if operation was successfully added to the sequence, negative errno otherwise.
+ */
+int spdk_accel_append_dif_generate_copy(struct spdk_accel_sequence **seq,
+					struct spdk_io_channel *ch,
+					struct iovec *dst_iovs, size_t dst_iovcnt,
+					struct spdk_memory_domain *dst_domain, void *dst_domain_ctx,
+					struct iovec *src_iovs, size_t src_iovcnt,
+					struct spdk_memory_domain *src_domain, void *src_domain_ctx,
+					uint32_t num_blocks, const struct spdk_dif_ctx *ctx,
+					spdk_accel_step_cb cb_fn, void *cb_arg);
+
 /**
  * Finish a sequence and execute all its operations. After the completion callback is executed, the
  * sequence object is automatically freed.
@@ -789,6 +976,23 @@ struct spdk_accel_opts {
 	uint32_t	sequence_count;
 	/** Maximum number of accel buffers per IO channel */
 	uint32_t	buf_count;
+	/**
+	 * Operations at or below this many bytes are executed by the software module on
+	 * channels whose assigned hardware device is on a remote CPU socket (as reported
+	 * by the module's `get_channel_socket_id` callback).  0 disables the fallback.
+	 */
+	uint32_t	cross_socket_size_threshold;
+	/**
+	 * Enables per-size-class dispatch of compress and decompress operations between the
+	 * module assigned to the opcode and the software module, based on measured per-module
+	 * latency.  Has no effect when the software module is already assigned to both opcodes.
+	 */
+	uint8_t		adaptive_compress_dispatch;
+	/**
+	 * Disables sequence optimizations, e.g. eliding copies and fusing adjacent operations
+	 * into a single task.  Mainly useful for benchmarking the optimizations themselves.
+	 */
+	uint8_t		disable_sequence_optimizations;
 
 } __attribute__((packed));
 
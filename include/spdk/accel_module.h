@@ -95,7 +95,9 @@ struct spdk_accel_task {
 	uint8_t				op_code;
 	bool				has_aux;
 	int16_t				status;
-	uint8_t				reserved[4];
+	/* Engine index used by adaptive compress dispatch, UINT8_MAX when not dispatched */
+	uint8_t				dispatch_engine;
+	uint8_t				reserved[3];
 	struct accel_io_channel		*accel_ch;
 	struct spdk_accel_sequence	*seq;
 	union {
@@ -150,6 +152,8 @@ struct spdk_accel_task {
 		uint32_t		block_size; /* for crypto op */
 	};
 	uint64_t			iv; /* Initialization vector (tweak) for crypto op */
+	/* Submission timestamp used by adaptive compress dispatch */
+	uint64_t			submit_tsc;
 	struct spdk_accel_task_aux_data	*aux;
 };
 
@@ -202,6 +206,15 @@ struct spdk_accel_module_if {
 	/** Reports whether the module supports a given operation. */
 	bool (*supports_opcode)(enum spdk_accel_opcode);
 
+	/**
+	 * Reports whether the module supports executing a given fused operation, i.e. an
+	 * operation combining the work of two simpler ones (e.g. `SPDK_ACCEL_OPC_COPY_CRC32C`).
+	 * When implemented, the framework may merge adjacent compatible operations within a
+	 * sequence into a single task using such an opcode.  Modules that don't implement this
+	 * function never receive fused tasks that weren't explicitly submitted by the user.
+	 */
+	bool (*supports_fused_opcode)(enum spdk_accel_opcode fused_opcode);
+
 	/** Returns module's IO channel on the calling thread. */
 	struct spdk_io_channel *(*get_io_channel)(void);
 
@@ -251,6 +264,14 @@ struct spdk_accel_module_if {
 				  const struct spdk_accel_operation_exec_ctx *ctx,
 				  struct spdk_accel_opcode_info *info);
 
+	/**
+	 * Returns the CPU socket that the hardware device backing the given module channel is
+	 * attached to, or a negative value if it's unknown or not applicable.  The framework
+	 * uses it to detect channels whose device ended up on a remote socket and execute
+	 * small operations in software instead of paying the cross-socket round trip.
+	 */
+	int (*get_channel_socket_id)(struct spdk_io_channel *module_ch);
+
 	TAILQ_ENTRY(spdk_accel_module_if)	tailq;
 };
 
@@ -122,6 +122,7 @@ enum spdk_bdev_io_type {
 	SPDK_BDEV_IO_TYPE_SEEK_DATA,
 	SPDK_BDEV_IO_TYPE_COPY,
 	SPDK_BDEV_IO_TYPE_NVME_IOV_MD,
+	SPDK_BDEV_IO_TYPE_GET_ZONE_INFO_RLE,
 	SPDK_BDEV_NUM_IO_TYPES /* Keep last */
 };
 
@@ -152,6 +153,24 @@ typedef void (*spdk_bdev_io_completion_cb)(struct spdk_bdev_io *bdev_io,
 		bool success,
 		void *cb_arg);
 
+/**
+ * Block device batched completion callback.
+ *
+ * Delivers all I/O completed on a channel since the previous invocation in a
+ * single call.  The callback owns each bdev_io exactly as if it had been
+ * delivered through \ref spdk_bdev_io_completion_cb - it must eventually call
+ * spdk_bdev_free_io() on every entry.  Per-I/O status may be retrieved with
+ * spdk_bdev_io_get_success() and the original callback argument with
+ * spdk_bdev_io_get_cb_arg().
+ *
+ * \param bdev_ios Array of completed block device I/O.
+ * \param count Number of entries in bdev_ios.
+ * \param cb_arg Callback argument specified when batching was enabled.
+ */
+typedef void (*spdk_bdev_io_completion_cb_batch)(struct spdk_bdev_io **bdev_ios,
+		uint32_t count,
+		void *cb_arg);
+
 struct spdk_bdev_io_error_stat;
 
 struct spdk_bdev_io_stat {
@@ -204,8 +223,19 @@ struct spdk_bdev_opts {
 	/* Size of the per-thread iobuf caches */
 	uint32_t iobuf_small_cache_size;
 	uint32_t iobuf_large_cache_size;
+
+	/**
+	 * If set, newly registered bdevs get their latency histogram enabled
+	 * automatically, so percentile data (see the
+	 * bdev_get_latency_percentiles RPC) is available without a per-bdev
+	 * bdev_enable_histogram sweep.
+	 */
+	bool bdev_histogram_enable;
+
+	/* Hole at bytes 33-39. */
+	uint8_t reserved33[7];
 } __attribute__((packed));
-SPDK_STATIC_ASSERT(sizeof(struct spdk_bdev_opts) == 32, "Incorrect size");
+SPDK_STATIC_ASSERT(sizeof(struct spdk_bdev_opts) == 40, "Incorrect size");
 
 /**
  * Union for controller attributes field, to list whether bdev supports fdp etc.
@@ -235,7 +265,10 @@ union spdk_bdev_nvme_cdw12 {
 		uint32_t reserved	: 20;
 		/* Directive type */
 		uint32_t dtype		: 4;
-		uint32_t reserved2	: 8;
+		uint32_t reserved2	: 6;
+		/* Force unit access */
+		uint32_t fua		: 1;
+		uint32_t reserved3	: 1;
 	} write;
 };
 SPDK_STATIC_ASSERT(sizeof(union spdk_bdev_nvme_cdw12) == 4, "Incorrect size");
@@ -286,8 +319,14 @@ struct spdk_bdev_ext_io_opts {
 	union spdk_bdev_nvme_cdw12 nvme_cdw12;
 	/** defined by \ref spdk_bdev_nvme_cdw13 */
 	union spdk_bdev_nvme_cdw13 nvme_cdw13;
+	/**
+	 * Force unit access - the write must not complete until its data has been
+	 * committed to non-volatile media. Emulated with a flush of the device write
+	 * cache following the write on bdevs which don't support it natively.
+	 */
+	bool fua;
 } __attribute__((packed));
-SPDK_STATIC_ASSERT(sizeof(struct spdk_bdev_ext_io_opts) == 52, "Incorrect size");
+SPDK_STATIC_ASSERT(sizeof(struct spdk_bdev_ext_io_opts) == 53, "Incorrect size");
 
 /**
  * Get the options for the bdev module.
@@ -854,6 +893,22 @@ spdk_bdev_get_qd_sampling_period(const struct spdk_bdev *bdev);
  */
 void spdk_bdev_set_qd_sampling_period(struct spdk_bdev *bdev, uint64_t period);
 
+/**
+ * Enable or disable I/O statistics subscription for this bdev.
+ *
+ * When the period is greater than 0, every channel of the bdev periodically
+ * publishes a snapshot of its I/O statistics, and spdk_bdev_get_device_stat()
+ * aggregates the published snapshots without sending any cross-thread
+ * messages.  The aggregated statistics may be up to one period stale.  When
+ * the period is 0, spdk_bdev_get_device_stat() iterates the channels as
+ * usual.
+ *
+ * \param bdev Block device on which to enable stat subscription.
+ * \param period The period in microseconds at which each channel publishes
+ * its statistics.  If this is set to zero, publishing is disabled.
+ */
+void spdk_bdev_set_stat_subscription_period(struct spdk_bdev *bdev, uint64_t period);
+
 /**
  * Get the time spent processing IO for this device.
  *
@@ -1363,6 +1418,59 @@ int spdk_bdev_writev_blocks_ext(struct spdk_bdev_desc *desc, struct spdk_io_chan
 				uint64_t num_blocks, spdk_bdev_io_completion_cb cb, void *cb_arg,
 				struct spdk_bdev_ext_io_opts *opts);
 
+/**
+ * Describes a single read or write request within a batch submitted through
+ * spdk_bdev_submit_batch().
+ */
+struct spdk_bdev_io_submit_entry {
+	/** SPDK_BDEV_IO_TYPE_READ or SPDK_BDEV_IO_TYPE_WRITE */
+	enum spdk_bdev_io_type type;
+	/** A scatter gather list of buffers to be read into or written from. */
+	struct iovec *iovs;
+	/** The number of elements in iovs. */
+	int iovcnt;
+	/** The offset, in blocks, from the start of the block device. */
+	uint64_t offset_blocks;
+	/** The number of blocks to read or write. */
+	uint64_t num_blocks;
+	/** Called when the request is complete. */
+	spdk_bdev_io_completion_cb cb;
+	/** Argument passed to cb. */
+	void *cb_arg;
+};
+
+/**
+ * Maximum number of entries accepted by a single spdk_bdev_submit_batch() call.
+ */
+#define SPDK_BDEV_MAX_SUBMIT_BATCH 64
+
+/**
+ * Submit a batch of read/write requests to the bdev on the given channel in a
+ * single call.
+ *
+ * The channel state, QoS and split checks are evaluated once per batch where
+ * possible.  When the bdev module implements the optional submit_request_batch
+ * entry in its function table and no request in the batch requires QoS
+ * queueing or splitting, the whole batch is handed to the module in one call;
+ * otherwise each request falls back to the regular submit path.  Either way
+ * every request gets its own completion callback.
+ *
+ * The batch is validated up front: on a non-zero return no request has been
+ * submitted.
+ *
+ * \param desc Block device descriptor.
+ * \param ch I/O channel. Obtained by calling spdk_bdev_get_io_channel().
+ * \param entries Array of request descriptors.
+ * \param count Number of entries, at most SPDK_BDEV_MAX_SUBMIT_BATCH.
+ * \return 0 on success. On success, all requests were submitted and their
+ * callbacks will be called (possibly with failure status). Negated errno on
+ * failure: -EINVAL if an entry is invalid or count is too large, -EBADF if a
+ * write is present but the descriptor was not opened for writing, -ENOMEM if
+ * spdk_bdev_io memory could not be allocated for the whole batch.
+ */
+int spdk_bdev_submit_batch(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
+			   struct spdk_bdev_io_submit_entry *entries, uint32_t count);
+
 /**
  * Submit a compare request to the bdev on the given channel.
  *
@@ -2062,6 +2170,45 @@ void *spdk_bdev_io_get_md_buf(struct spdk_bdev_io *bdev_io);
  */
 void *spdk_bdev_io_get_cb_arg(struct spdk_bdev_io *bdev_io);
 
+/**
+ * Get the completion status of a bdev_io delivered through a batched
+ * completion callback.
+ *
+ * \param bdev_io I/O to get the status from.
+ * \return True if the I/O completed successfully, false otherwise; additional
+ * error information may be retrieved by calling spdk_bdev_io_get_nvme_status()
+ * or spdk_bdev_io_get_scsi_status().
+ */
+bool spdk_bdev_io_get_success(struct spdk_bdev_io *bdev_io);
+
+/**
+ * Enable batched completion delivery on an I/O channel.
+ *
+ * While enabled, I/O completed on this channel are not delivered through their
+ * per-I/O completion callbacks.  Instead they are accumulated and handed to
+ * \p cb, either once per poller iteration or whenever the internal batch
+ * fills up.  This covers every completion on the channel, including resets
+ * and aborts.  Must be called on the thread that owns the channel.
+ *
+ * \param ch I/O channel obtained from spdk_bdev_get_io_channel().
+ * \param cb Batched completion callback.
+ * \param cb_arg Argument passed to cb.
+ * \return 0 on success, -EINVAL if cb is NULL or batching is already enabled.
+ */
+int spdk_bdev_channel_enable_batched_completions(struct spdk_io_channel *ch,
+		spdk_bdev_io_completion_cb_batch cb, void *cb_arg);
+
+/**
+ * Disable batched completion delivery on an I/O channel.
+ *
+ * Any accumulated completions are flushed to the batch callback before the
+ * channel reverts to per-I/O delivery.  Must be called on the thread that
+ * owns the channel.
+ *
+ * \param ch I/O channel obtained from spdk_bdev_get_io_channel().
+ */
+void spdk_bdev_channel_disable_batched_completions(struct spdk_io_channel *ch);
+
 typedef void (*spdk_bdev_histogram_status_cb)(void *cb_arg, int status);
 typedef void (*spdk_bdev_histogram_data_cb)(void *cb_arg, int status,
 		struct spdk_histogram_data *histogram);
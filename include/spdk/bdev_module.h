@@ -30,6 +30,8 @@ extern "C" {
 
 #define SPDK_BDEV_CLAIM_NAME_LEN	32
 
+struct spdk_bdev_channel;
+
 /* This parameter is best defined for bdevs that share an underlying bdev,
  * such as multiple lvol bdevs sharing an nvme device, to avoid unnecessarily
  * resetting the underlying bdev and affecting other bdevs that are sharing it. */
@@ -141,6 +143,15 @@ struct spdk_bdev_module {
 	 */
 	bool async_fini_start;
 
+	/**
+	 * Denotes if the module reports examine completion with
+	 * spdk_bdev_module_examine_done_ext(), which identifies the examined bdev.
+	 * This lets the bdev layer track examine progress per bdev, so that
+	 * registration of one bdev does not have to wait for examinations of
+	 * unrelated bdevs to finish.
+	 */
+	bool examine_done_ext;
+
 	/**
 	 * Fields that are used by the internal bdev subsystem. Bdev modules
 	 *  must not read or write to these fields.
@@ -315,6 +326,16 @@ struct spdk_bdev_fn_table {
 	/** Process the IO. */
 	void (*submit_request)(struct spdk_io_channel *ch, struct spdk_bdev_io *);
 
+	/**
+	 * Process a batch of IO in a single call. Optional - may be NULL.
+	 *
+	 * Only invoked for batches submitted via spdk_bdev_submit_batch() in
+	 * which no request required QoS queueing or splitting.  Modules that
+	 * don't implement this receive each request through submit_request.
+	 */
+	void (*submit_request_batch)(struct spdk_io_channel *ch,
+				     struct spdk_bdev_io **bdev_ios, uint32_t count);
+
 	/** Check if the block device supports a specific I/O type. */
 	bool (*io_type_supported)(void *ctx, enum spdk_bdev_io_type);
 
@@ -437,6 +458,13 @@ struct spdk_bdev {
 	/** write cache enabled, not used at the moment */
 	int write_cache;
 
+	/**
+	 * Set to true by modules which honor the fua flag on write I/Os natively.
+	 * When false, the bdev layer emulates FUA writes by flushing the device
+	 * write cache after the write completes.
+	 */
+	bool fua_supported;
+
 	/** Size in bytes of a logical block for the backend */
 	uint32_t blocklen;
 
@@ -663,6 +691,12 @@ struct spdk_bdev {
 		 */
 		uint32_t examine_in_progress;
 
+		/**
+		 * Count of in-progress examine actions attributed to this bdev by modules
+		 * with examine_done_ext set. Must hold spinlock on all updates.
+		 */
+		uint32_t examine_actions;
+
 		/**
 		 * The claim type: used in conjunction with claim. Must hold spinlock on all
 		 * updates.
@@ -734,6 +768,15 @@ struct spdk_bdev {
 		/** accumulated I/O statistics for previously deleted channels of this bdev */
 		struct spdk_bdev_io_stat *stat;
 
+		/** Period in microseconds at which each channel publishes a snapshot of
+		 *  its I/O statistics for lock-free aggregation, 0 if stat subscription
+		 *  is disabled.
+		 */
+		uint64_t stat_sub_period;
+
+		/** Channels publishing stat snapshots.  Protected by spinlock. */
+		TAILQ_HEAD(, spdk_bdev_channel) stat_sub_channels;
+
 		/** true if tracking the queue_depth of a device is in progress */
 		bool	qd_poll_in_progress;
 
@@ -780,6 +823,15 @@ typedef void (*spdk_bdev_io_get_aux_buf_cb)(struct spdk_io_channel *ch,
 /* Maximum number of IOVs used for I/O splitting */
 #define SPDK_BDEV_IO_NUM_CHILD_IOV 32
 
+/*
+ * The layout of spdk_bdev_io is cache-line optimized: the fields read on the
+ * submit path (bdev, type and the leading part of u.bdev describing the
+ * transfer) are guaranteed to reside within the first cache line of the
+ * structure, while fields that are only touched on rarely taken paths
+ * (splitting scratch space, reset/zone/passthru unions) are placed at the
+ * tail.  This is enforced with compile-time asserts in lib/bdev/bdev.c; bdev
+ * modules may rely on it.
+ */
 struct spdk_bdev_io {
 	/** The block device that this I/O belongs to. */
 	struct spdk_bdev *bdev;
@@ -790,12 +842,6 @@ struct spdk_bdev_io {
 	/** Number of IO submission retries */
 	uint16_t num_retries;
 
-	/** A single iovec element for use by this bdev_io. */
-	struct iovec iov;
-
-	/** Array of iovecs used for I/O splitting. */
-	struct iovec child_iov[SPDK_BDEV_IO_NUM_CHILD_IOV];
-
 	union {
 		struct {
 			/** For SG buffer cases, array of iovecs to transfer. */
@@ -804,6 +850,15 @@ struct spdk_bdev_io {
 			/** For SG buffer cases, number of iovecs in iovec array. */
 			int iovcnt;
 
+			/** Total size of data to be transferred. */
+			uint64_t num_blocks;
+
+			/** Starting offset (in blocks) of the bdev for this I/O. */
+			uint64_t offset_blocks;
+
+			/* Metadata buffer */
+			void *md_buf;
+
 			/** For fused operations such as COMPARE_AND_WRITE, array of iovecs
 			 *  for the second operation.
 			 */
@@ -812,15 +867,6 @@ struct spdk_bdev_io {
 			/** Number of iovecs in fused_iovs. */
 			int fused_iovcnt;
 
-			/* Metadata buffer */
-			void *md_buf;
-
-			/** Total size of data to be transferred. */
-			uint64_t num_blocks;
-
-			/** Starting offset (in blocks) of the bdev for this I/O. */
-			uint64_t offset_blocks;
-
 			/** Memory domain and its context to be used by bdev modules */
 			struct spdk_memory_domain *memory_domain;
 			void *memory_domain_ctx;
@@ -849,6 +895,9 @@ struct spdk_bdev_io {
 			/** defined by \ref spdk_bdev_nvme_cdw13 */
 			union spdk_bdev_nvme_cdw13 nvme_cdw13;
 
+			/** Force unit access, only set for bdevs which support it natively */
+			bool fua;
+
 			struct {
 				/** Whether the buffer should be populated with the real data */
 				uint8_t populate : 1;
@@ -925,12 +974,32 @@ struct spdk_bdev_io {
 
 			/* The data buffer */
 			void *buf;
+
+			/* For SPDK_BDEV_IO_TYPE_GET_ZONE_INFO_RLE, the capacity of buf
+			 * in struct spdk_bdev_zone_run entries. */
+			uint32_t max_runs;
+
+			/* For SPDK_BDEV_IO_TYPE_GET_ZONE_INFO_RLE, the number of run
+			 * entries filled in, set by the module on completion. */
+			uint32_t num_runs;
 		} zone_mgmt;
 	} u;
 
 	/** It may be used by modules to put the bdev_io into its own list. */
 	TAILQ_ENTRY(spdk_bdev_io) module_link;
 
+	/** A single iovec element for use by this bdev_io.  Only used on paths
+	 *  that allocate a buffer for the I/O, so kept out of the hot part of
+	 *  the structure.
+	 */
+	struct iovec iov;
+
+	/** Array of iovecs used for I/O splitting.  This is by far the largest
+	 *  member of the structure and is only touched when an I/O is split,
+	 *  so it is placed at the cold tail.
+	 */
+	struct iovec child_iov[SPDK_BDEV_IO_NUM_CHILD_IOV];
+
 	/**
 	 *  Fields that are used internally by the bdev subsystem.  Bdev modules
 	 *  must not read or write to these fields.
@@ -939,8 +1008,6 @@ struct spdk_bdev_io {
 		/** The bdev I/O channel that this was handled on. */
 		struct spdk_bdev_channel *ch;
 
-		uint8_t	reserved[8];
-
 		/** The bdev descriptor that was used when submitting this I/O. */
 		struct spdk_bdev_desc *desc;
 
@@ -953,6 +1020,30 @@ struct spdk_bdev_io {
 		/** Current tsc at submit time. Used to calculate latency at completion. */
 		uint64_t submit_tsc;
 
+		/**
+		 * Set to true while the bdev module submit_request function is in progress.
+		 *
+		 * This is used to decide whether spdk_bdev_io_complete() can complete the I/O directly
+		 * or if completion must be deferred via an event.
+		 */
+		bool in_submit_request;
+
+		/** Status for the IO */
+		int8_t status;
+
+		/** Indicates whether the IO is split */
+		bool split;
+
+		/** Retry state (resubmit, re-pull, re-push, etc.) */
+		uint8_t retry_state;
+
+		/** Indicates that the IO is associated with an accel sequence */
+		bool has_accel_sequence;
+
+		/** Indicates the IO came from its channel's pre-allocated
+		 *  child-IO cache and must be returned there on free. */
+		bool from_child_cache;
+
 		/** Error information from a device */
 		union {
 			struct {
@@ -978,26 +1069,6 @@ struct spdk_bdev_io {
 			int aio_result;
 		} error;
 
-		/**
-		 * Set to true while the bdev module submit_request function is in progress.
-		 *
-		 * This is used to decide whether spdk_bdev_io_complete() can complete the I/O directly
-		 * or if completion must be deferred via an event.
-		 */
-		bool in_submit_request;
-
-		/** Status for the IO */
-		int8_t status;
-
-		/** Indicates whether the IO is split */
-		bool split;
-
-		/** Retry state (resubmit, re-pull, re-push, etc.) */
-		uint8_t retry_state;
-
-		/** Indicates that the IO is associated with an accel sequence */
-		bool has_accel_sequence;
-
 		/** bdev allocated memory associated with this request */
 		void *buf;
 
@@ -1131,6 +1202,19 @@ void spdk_bdev_destruct_done(struct spdk_bdev *bdev, int bdeverrno);
  */
 void spdk_bdev_module_examine_done(struct spdk_bdev_module *module);
 
+/**
+ * Indicate to the bdev layer that the module is done examining a bdev.
+ *
+ * Identical to spdk_bdev_module_examine_done(), but additionally identifies the
+ * examined bdev, allowing the bdev layer to track examine progress per bdev.
+ * Modules using this function must set examine_done_ext to true in their
+ * spdk_bdev_module structure and use it for all of their examine completions.
+ *
+ * \param module Pointer to the module completing the examination.
+ * \param bdev Block device that was examined.
+ */
+void spdk_bdev_module_examine_done_ext(struct spdk_bdev_module *module, struct spdk_bdev *bdev);
+
 /**
  * Indicate to the bdev layer that the module is done initializing.
  *
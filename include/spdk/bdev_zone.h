@@ -60,6 +60,19 @@ struct spdk_bdev_zone_info {
 	enum spdk_bdev_zone_type	type;
 };
 
+/**
+ * A run of consecutive zones in the same state, produced by
+ * spdk_bdev_get_zone_info_rle(). Per-zone details such as the write pointer
+ * differ within a run and must be fetched with spdk_bdev_get_zone_info().
+ */
+struct spdk_bdev_zone_run {
+	/* First logical block of the first zone in the run */
+	uint64_t			zone_id;
+	/* Number of consecutive zones in the run */
+	uint64_t			num_zones;
+	enum spdk_bdev_zone_state	state;
+};
+
 /**
  * Get device zone size in logical blocks.
  *
@@ -153,6 +166,49 @@ int spdk_bdev_get_zone_info(struct spdk_bdev_desc *desc, struct spdk_io_channel
 			    uint64_t zone_id, size_t num_zones, struct spdk_bdev_zone_info *info,
 			    spdk_bdev_io_completion_cb cb, void *cb_arg);
 
+/**
+ * Submit a run-length-encoded get_zone_info request to the bdev.
+ *
+ * Contiguous zones in identical state are collapsed into a single
+ * struct spdk_bdev_zone_run entry, so a state sweep over a large zoned device
+ * completes in a single request. The number of entries filled in can be
+ * obtained with spdk_bdev_io_get_num_zone_runs() in the completion callback.
+ * If the run array is too small to describe the requested range, the request
+ * fails with SPDK_BDEV_IO_STATUS_FAILED.
+ *
+ * The caller must check that the bdev supports
+ * SPDK_BDEV_IO_TYPE_GET_ZONE_INFO_RLE before using this function.
+ *
+ * \ingroup bdev_io_submit_functions
+ *
+ * \param desc Block device descriptor.
+ * \param ch I/O channel. Obtained by calling spdk_bdev_get_io_channel().
+ * \param zone_id First logical block of a zone.
+ * \param num_zones Number of consecutive zones to report.
+ * \param runs Pointer to array capable of storing max_runs elements.
+ * \param max_runs Capacity of the runs array.
+ * \param cb Called when the request is complete.
+ * \param cb_arg Argument passed to cb.
+ *
+ * \return 0 on success. On success, the callback will always
+ * be called (even if the request ultimately failed). Return
+ * negated errno on failure, in which case the callback will not be called.
+ *   * -ENOMEM - spdk_bdev_io buffer cannot be allocated
+ *   * -EINVAL - max_runs is zero
+ */
+int spdk_bdev_get_zone_info_rle(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
+				uint64_t zone_id, size_t num_zones, struct spdk_bdev_zone_run *runs,
+				size_t max_runs, spdk_bdev_io_completion_cb cb, void *cb_arg);
+
+/**
+ * Get the number of zone run entries filled in by a completed
+ * SPDK_BDEV_IO_TYPE_GET_ZONE_INFO_RLE request.
+ *
+ * \param bdev_io I/O to get the run count from.
+ *
+ * \return Number of valid entries in the runs array.
+ */
+uint32_t spdk_bdev_io_get_num_zone_runs(struct spdk_bdev_io *bdev_io);
 
 /**
  * Submit a zone_management request to the bdev.
@@ -105,6 +105,19 @@ int spdk_bit_array_set(struct spdk_bit_array *ba, uint32_t bit_index);
  */
 void spdk_bit_array_clear(struct spdk_bit_array *ba, uint32_t bit_index);
 
+/**
+ * Clear (to 0) a range of bits in the bit array.
+ *
+ * Clears whole words at a time, so this is much cheaper than clearing the
+ * bits one by one.  Any part of the range beyond the end of the bit array is
+ * ignored. Bits beyond the end of the bit array are implicitly 0.
+ *
+ * \param ba Bit array to clear bits in.
+ * \param begin The index of the first bit to clear.
+ * \param count The number of bits to clear.
+ */
+void spdk_bit_array_clear_range(struct spdk_bit_array *ba, uint32_t begin, uint32_t count);
+
 /**
  * Find the index of the first set bit in the array.
  *
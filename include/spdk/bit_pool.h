@@ -115,6 +115,20 @@ uint32_t spdk_bit_pool_allocate_bit(struct spdk_bit_pool *pool);
  */
 void spdk_bit_pool_free_bit(struct spdk_bit_pool *pool, uint32_t bit_index);
 
+/**
+ * Free a range of bits back to the bit pool.
+ *
+ * The bits are cleared whole words at a time, so freeing a large range is
+ * much cheaper than freeing the bits one by one.  All bits in the range must
+ * have been allocated; freeing a bit that has not been allocated will result
+ * in an assert in debug builds and may corrupt the pool otherwise.
+ *
+ * \param pool Bit pool to place the freed bits.
+ * \param begin The index of the first bit to free.
+ * \param count The number of bits to free.
+ */
+void spdk_bit_pool_free_range(struct spdk_bit_pool *pool, uint32_t begin, uint32_t count);
+
 /**
  * Count the number of bits allocated from the pool.
  *
@@ -314,8 +314,16 @@ struct spdk_bs_opts {
 	 * Context to pass with esnap_bs_dev_create.
 	 */
 	void *esnap_ctx;
+
+	/**
+	 * Number of clusters to reserve ahead of a detected sequential write
+	 * stream on a thin-provisioned blob.  The reservations are handed out
+	 * without taking the allocation lock and unused ones are returned when
+	 * the blob is closed.  0 disables sequential preallocation.
+	 */
+	uint32_t cluster_prealloc_count;
 } __attribute__((packed));
-SPDK_STATIC_ASSERT(sizeof(struct spdk_bs_opts) == 88, "Incorrect size");
+SPDK_STATIC_ASSERT(sizeof(struct spdk_bs_opts) == 92, "Incorrect size");
 
 /**
  * Initialize a spdk_bs_opts structure to the default blobstore option values.
@@ -666,6 +674,35 @@ void spdk_bs_create_clone(struct spdk_blob_store *bs, spdk_blob_id blobid,
 			  const struct spdk_blob_xattr_opts *clone_xattrs,
 			  spdk_blob_op_with_id_complete cb_fn, void *cb_arg);
 
+/**
+ * Create multiple clones of specified read-only blob.
+ *
+ * The snapshot is opened once for the whole batch and several clone creations
+ * are kept in flight at a time, which is considerably faster than calling
+ * spdk_bs_create_clone() in a loop when provisioning many clones.
+ *
+ * The blobids array must have room for count entries.  Each entry is set to
+ * the id of the corresponding clone as it is created.  If the operation fails,
+ * entries for clones that were not created are left as SPDK_BLOBID_INVALID and
+ * already created clones are kept.
+ *
+ * Structure clone_xattrs as well as anything it references (like e.g. names
+ * array) must be valid until the completion is called.
+ *
+ * This function must be called from the blobstore's metadata thread.
+ *
+ * \param bs blobstore.
+ * \param blobid Id of the read only blob used as a snapshot for the new clones.
+ * \param clone_xattrs Array of count xattr descriptors, one per clone, or NULL.
+ * \param count Number of clones to create.
+ * \param blobids Array filled with the ids of the created clones.
+ * \param cb_fn Called when the operation is complete.
+ * \param cb_arg Argument passed to function cb_fn.
+ */
+void spdk_bs_create_clones(struct spdk_blob_store *bs, spdk_blob_id blobid,
+			   const struct spdk_blob_xattr_opts *clone_xattrs, size_t count,
+			   spdk_blob_id *blobids, spdk_blob_op_complete cb_fn, void *cb_arg);
+
 /**
  * Provide table with blob id's of clones are dependent on specified snapshot.
  *
@@ -766,6 +803,27 @@ bool spdk_blob_is_esnap_clone(const struct spdk_blob *blob);
 void spdk_bs_delete_blob(struct spdk_blob_store *bs, spdk_blob_id blobid,
 			 spdk_blob_op_complete cb_fn, void *cb_arg);
 
+/**
+ * Delete a batch of blobs.
+ *
+ * Several deletions are kept in flight at a time, so the metadata updates of
+ * independent blobs are pipelined instead of being issued one blob after the
+ * other.  Blobs that cannot be deleted because another blob of the batch still
+ * references them are retried after the rest of the batch has completed, so
+ * snapshots may be listed in any order relative to their clones.  All blobs are
+ * attempted even if some fail; the callback receives the first error
+ * encountered, or -EBUSY if blobs remained referenced from outside the batch.
+ *
+ * \param bs blobstore.
+ * \param blobids Array of ids of the blobs to delete.  The array is copied and
+ * may be released as soon as this function returns.
+ * \param count Number of entries in blobids.
+ * \param cb_fn Called when the operation is complete.
+ * \param cb_arg Argument passed to function cb_fn.
+ */
+void spdk_bs_delete_blobs(struct spdk_blob_store *bs, spdk_blob_id *blobids, size_t count,
+			  spdk_blob_op_complete cb_fn, void *cb_arg);
+
 /**
  * Allocate all clusters in this blob. Data for allocated clusters is copied
  * from backing blob(s) if they exist.
@@ -781,6 +839,25 @@ void spdk_bs_delete_blob(struct spdk_blob_store *bs, spdk_blob_id blobid,
 void spdk_bs_inflate_blob(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
 			  spdk_blob_id blobid, spdk_blob_op_complete cb_fn, void *cb_arg);
 
+/**
+ * Allocate all clusters in this blob, keeping several cluster copies in flight.
+ *
+ * Same as spdk_bs_inflate_blob(), but the number of parallel cluster copies can
+ * be chosen by the caller, either to speed the inflation up or to limit its
+ * impact on foreground I/O.
+ *
+ * \param bs blobstore.
+ * \param channel IO channel used to inflate blob.
+ * \param blobid The id of the blob to inflate.
+ * \param max_in_flight Maximum number of cluster copies kept in flight.
+ * 0 selects the default.
+ * \param cb_fn Called when the operation is complete.
+ * \param cb_arg Argument passed to function cb_fn.
+ */
+void spdk_bs_inflate_blob_ext(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
+			      spdk_blob_id blobid, uint32_t max_in_flight,
+			      spdk_blob_op_complete cb_fn, void *cb_arg);
+
 /**
  * Remove dependency on parent blob.
  *
@@ -799,6 +876,24 @@ void spdk_bs_inflate_blob(struct spdk_blob_store *bs, struct spdk_io_channel *ch
 void spdk_bs_blob_decouple_parent(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
 				  spdk_blob_id blobid, spdk_blob_op_complete cb_fn, void *cb_arg);
 
+/**
+ * Remove dependency on parent blob, keeping several cluster copies in flight.
+ *
+ * Same as spdk_bs_blob_decouple_parent(), but the number of parallel cluster
+ * copies can be chosen by the caller.
+ *
+ * \param bs blobstore.
+ * \param channel IO channel used to inflate blob.
+ * \param blobid The id of the blob.
+ * \param max_in_flight Maximum number of cluster copies kept in flight.
+ * 0 selects the default.
+ * \param cb_fn Called when the operation is complete.
+ * \param cb_arg Argument passed to function cb_fn.
+ */
+void spdk_bs_blob_decouple_parent_ext(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
+				      spdk_blob_id blobid, uint32_t max_in_flight,
+				      spdk_blob_op_complete cb_fn, void *cb_arg);
+
 /**
  * Perform a shallow copy of a blob to a blobstore device.
  *
@@ -1073,6 +1168,28 @@ void spdk_blob_io_readv_ext(struct spdk_blob *blob, struct spdk_io_channel *chan
 			    spdk_blob_op_complete cb_fn, void *cb_arg,
 			    struct spdk_blob_ext_io_opts *io_opts);
 
+/**
+ * Copy 'length' io_units starting at 'src_offset' io_units within the blob to
+ * 'dst_offset' io_units within the same blob, using the base device's copy
+ * offload.
+ *
+ * The copy is only submitted if every involved cluster is already allocated
+ * and the base device supports copy offload; otherwise the callback is
+ * invoked with -ENOTSUP and the caller is expected to fall back to a
+ * buffered read/write pair.
+ *
+ * \param blob Blob to copy within.
+ * \param channel I/O channel used to submit requests.
+ * \param dst_offset Destination offset in io units from the beginning of the blob.
+ * \param src_offset Source offset in io units from the beginning of the blob.
+ * \param length Size of data in io units.
+ * \param cb_fn Called when the operation is complete.
+ * \param cb_arg Argument passed to function cb_fn.
+ */
+void spdk_blob_io_copy(struct spdk_blob *blob, struct spdk_io_channel *channel,
+		       uint64_t dst_offset, uint64_t src_offset, uint64_t length,
+		       spdk_blob_op_complete cb_fn, void *cb_arg);
+
 /**
  * Unmap 'length' io_units beginning at 'offset' io_units on the blob as unused. Unmapped
  * io_units may allow the underlying storage media to behave more efficiently.
@@ -348,6 +348,60 @@ int spdk_fs_set_cache_size(uint64_t size_in_mb);
  */
 uint64_t spdk_fs_get_cache_size(void);
 
+/**
+ * Set the maximum number of write-behind I/Os kept in flight per file.
+ *
+ * Cache buffers filled by sequential writes are flushed to the blobstore as a
+ * pipeline of up to this many I/Os per file.
+ *
+ * \param depth Maximum number of flush I/Os in flight per file. Must not be 0.
+ *
+ * \return 0 on success, negative errno on failure.
+ */
+int spdk_fs_set_flush_depth(uint32_t depth);
+
+/**
+ * Obtain the maximum number of write-behind I/Os kept in flight per file.
+ *
+ * \return flush pipeline depth.
+ */
+uint32_t spdk_fs_get_flush_depth(void);
+
+/**
+ * Set the number of cache buffers read ahead of a sequential read stream.
+ *
+ * \param num_buffers Read-ahead window in cache buffers. Must not be 0.
+ *
+ * \return 0 on success, negative errno on failure.
+ */
+int spdk_fs_set_readahead_window(uint32_t num_buffers);
+
+/**
+ * Obtain the number of cache buffers read ahead of a sequential read stream.
+ *
+ * \return read-ahead window in cache buffers.
+ */
+uint32_t spdk_fs_get_readahead_window(void);
+
+struct spdk_file_stats {
+	/* Write-behind I/Os currently in flight. */
+	uint32_t	flush_depth;
+	/* Highest number of write-behind I/Os that were in flight at once. */
+	uint32_t	flush_depth_max;
+	/* Read-ahead I/Os currently in flight. */
+	uint32_t	readahead_depth;
+	/* Highest number of read-ahead I/Os that were in flight at once. */
+	uint32_t	readahead_depth_max;
+};
+
+/**
+ * Obtain the I/O pipeline statistics of a file.
+ *
+ * \param file File to query.
+ * \param stats Filled with the file's statistics.
+ */
+void spdk_file_get_stats(struct spdk_file *file, struct spdk_file_stats *stats);
+
 #define SPDK_FILE_PRIORITY_LOW	0 /* default */
 #define SPDK_FILE_PRIORITY_HIGH	1
 
@@ -336,6 +336,41 @@ int spdk_memory_domain_translate_data(struct spdk_memory_domain *src_domain, voi
 				      struct spdk_memory_domain *dst_domain, struct spdk_memory_domain_translation_ctx *dst_domain_ctx,
 				      void *addr, size_t len, struct spdk_memory_domain_translation_result *result);
 
+/**
+ * Enable or disable caching of translation results for the given memory domain.
+ *
+ * When enabled, \ref spdk_memory_domain_translate_data serves repeated translations of the same
+ * (address, length, destination domain) triple from the cache instead of invoking the domain's
+ * translation callback.  Only the owner of the domain may enable the cache, and only if its
+ * translations are stable for the lifetime of the mapping and depend solely on that triple - i.e.
+ * the translation callback ignores the per-request contexts.  Results describing more than one
+ * iov element are never cached.
+ *
+ * Cached entries are dropped by \ref spdk_memory_domain_invalidate_translation_cache and
+ * automatically for any range passed to \ref spdk_memory_domain_invalidate_data.  The cache must
+ * not be resized while translations are in flight.
+ *
+ * \param domain Memory domain owned by the caller
+ * \param num_entries Number of cache entries, rounded up to a power of two.  0 disables and frees
+ * the cache.
+ * \return 0 on success, negated errno on failure
+ */
+int spdk_memory_domain_set_translation_cache(struct spdk_memory_domain *domain,
+		uint32_t num_entries);
+
+/**
+ * Drop cached translation results overlapping the given range.
+ *
+ * The owner of the domain must call this function (or \ref spdk_memory_domain_invalidate_data)
+ * whenever a mapping changes, e.g. on a vfio-user DMA unmap or vhost memory table update.
+ *
+ * \param domain Memory domain in which address space of the buffer is located
+ * \param addr Start of the range in \b domain memory space, NULL to drop all cached entries
+ * \param len Length of the range, ignored if \b addr is NULL
+ */
+void spdk_memory_domain_invalidate_translation_cache(struct spdk_memory_domain *domain,
+		void *addr, size_t len);
+
 /**
  * Invalidate memory in the given domain.
  *
@@ -124,6 +124,61 @@ void *spdk_realloc(void *buf, size_t size, size_t align);
  */
 void spdk_free(void *buf);
 
+/**
+ * An arena allocator for small, short-lived allocations that are not
+ * DMA-capable (e.g. protocol control structures or parser state).  Allocations
+ * are carved out of thread-private slabs without any locking and cannot be
+ * freed individually - spdk_arena_reset() releases the whole epoch at once.
+ * An arena may only be used from the thread that created it.
+ */
+struct spdk_arena;
+
+/**
+ * Create an arena allocator.
+ *
+ * \param slab_size Size in bytes of the slabs backing the arena, or 0 to use
+ * a default size.  Allocations larger than the slab size get a dedicated slab.
+ *
+ * \return a pointer to the arena, or NULL on failure.
+ */
+struct spdk_arena *spdk_arena_create(size_t slab_size);
+
+/**
+ * Allocate a buffer from an arena.  The buffer is aligned suitably for any
+ * built-in type and remains valid until the arena is reset or destroyed.
+ *
+ * \param arena Arena to allocate from.
+ * \param size Size in bytes.
+ *
+ * \return a pointer to the allocated buffer, or NULL on failure.
+ */
+void *spdk_arena_alloc(struct spdk_arena *arena, size_t size);
+
+/**
+ * Allocate a zeroed buffer from an arena.
+ *
+ * \param arena Arena to allocate from.
+ * \param size Size in bytes.
+ *
+ * \return a pointer to the allocated buffer, or NULL on failure.
+ */
+void *spdk_arena_zalloc(struct spdk_arena *arena, size_t size);
+
+/**
+ * Free all buffers allocated from an arena in a single operation.  Standard
+ * sized slabs are retained for reuse by subsequent allocations.
+ *
+ * \param arena Arena to reset.
+ */
+void spdk_arena_reset(struct spdk_arena *arena);
+
+/**
+ * Destroy an arena, releasing all of its slabs.
+ *
+ * \param arena Arena to destroy.
+ */
+void spdk_arena_destroy(struct spdk_arena *arena);
+
 /**
  * Initialize the default value of opts.
  *
@@ -1358,6 +1413,25 @@ uint64_t spdk_mem_map_translate(const struct spdk_mem_map *map, uint64_t vaddr,
  */
 int spdk_mem_register(void *vaddr, size_t len);
 
+/**
+ * Register multiple memory regions for address translation in one operation.
+ *
+ * Virtually contiguous entries are coalesced and every registered map is
+ * notified once per coalesced region, while the internal locks are taken only
+ * once for the whole batch.  This is significantly faster than calling
+ * spdk_mem_register() per region when registering many regions at once, e.g.
+ * the memory table of a vhost guest.
+ *
+ * The memory regions must map to pinned huge pages (2MB or greater).
+ *
+ * \param iov I/O vector describing the memory regions to register.
+ * \param iovcnt Number of entries in iov.
+ *
+ * \return 0 on success, negative errno on failure.  On failure, regions
+ * registered before the failing one remain registered.
+ */
+int spdk_mem_register_batch(struct iovec *iov, uint32_t iovcnt);
+
 /**
  * Unregister the specified memory region from vtophys address translation.
  *
@@ -1371,6 +1445,22 @@ int spdk_mem_register(void *vaddr, size_t len);
  */
 int spdk_mem_unregister(void *vaddr, size_t len);
 
+/**
+ * Unregister multiple memory regions from vtophys address translation in one
+ * operation.  The counterpart of spdk_mem_register_batch(), with the same
+ * coalescing and locking behavior.
+ *
+ * The caller must ensure all in-flight DMA operations to these memory regions
+ * are completed or cancelled before calling this function.
+ *
+ * \param iov I/O vector describing the memory regions to unregister.
+ * \param iovcnt Number of entries in iov.
+ *
+ * \return 0 on success, negative errno on failure.  On failure, regions
+ * unregistered before the failing one remain unregistered.
+ */
+int spdk_mem_unregister_batch(struct iovec *iov, uint32_t iovcnt);
+
 /**
  * Reserve the address space specified in all memory maps.
  *
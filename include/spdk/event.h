@@ -191,8 +191,15 @@ struct spdk_app_opts {
 	 */
 	void *json_data;
 	size_t json_data_size;
+
+	/**
+	 * If non-NULL, a validated configuration snapshot is written to this path on
+	 * clean shutdown and, when present and valid, restored from it at startup in
+	 * preference to json_config_file.
+	 */
+	const char *json_config_snapshot_path;
 } __attribute__((packed));
-SPDK_STATIC_ASSERT(sizeof(struct spdk_app_opts) == 252, "Incorrect size");
+SPDK_STATIC_ASSERT(sizeof(struct spdk_app_opts) == 260, "Incorrect size");
 
 /**
  * Initialize the default value of opts
@@ -356,6 +363,46 @@ void spdk_framework_enable_context_switch_monitor(bool enabled);
  */
 bool spdk_framework_context_switch_monitor_enabled(void);
 
+/**
+ * Enable or disable automatic interrupt/poll hybrid switching of reactors.
+ *
+ * When enabled, each reactor periodically evaluates its own idle/busy tsc
+ * ratio and transitions itself between busy-polling and fd_group based
+ * interrupt mode with hysteresis, so that reactors sleep through quiet
+ * periods without requiring an application restart.  The application must be
+ * running with interrupt mode support enabled.
+ *
+ * \param enabled True to enable, false to disable.
+ *
+ * \return 0 on success or -ENOTSUP if interrupt mode is not available.
+ */
+int spdk_framework_enable_hybrid_interrupt(bool enabled);
+
+/**
+ * Return whether hybrid interrupt switching is enabled.
+ *
+ * \return true if enabled or false otherwise.
+ */
+bool spdk_framework_hybrid_interrupt_enabled(void);
+
+/**
+ * Configure adaptive event batching for reactors running in interrupt mode.
+ *
+ * When enabled, a reactor that was just woken up keeps polling its fd_group
+ * with a zero timeout for spin_us microseconds before blocking again, and each
+ * poll that finds events extends the window by another spin_us.  This lets
+ * bursts of events be handled in a single sleep/wake cycle at the cost of a
+ * short busy spin after each wakeup.
+ *
+ * \param spin_us Duration in microseconds of the harvest window after a wakeup
+ * that found events. 0 disables batching (the default).
+ * \param max_spin_us Upper bound in microseconds on the total harvest time per
+ * wakeup, no matter how long the burst lasts. Must be >= spin_us.
+ *
+ * \return 0 on success or -EINVAL if max_spin_us is smaller than spin_us.
+ */
+int spdk_framework_set_interrupt_batching(uint32_t spin_us, uint32_t max_spin_us);
+
 #ifdef __cplusplus
 }
 #endif
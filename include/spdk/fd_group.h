@@ -12,6 +12,7 @@
 #define SPDK_FD_GROUP_H
 
 #include "spdk/stdinc.h"
+#include "spdk/assert.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -99,6 +100,39 @@ int spdk_fd_group_nest(struct spdk_fd_group *parent, struct spdk_fd_group *child
  */
 int spdk_fd_group_unnest(struct spdk_fd_group *parent, struct spdk_fd_group *child);
 
+/**
+ * Priority class of an event source. Within each wait iteration, events of a
+ * higher priority class are always dispatched before events of a lower one.
+ */
+enum spdk_fd_group_prio {
+	SPDK_FD_GROUP_PRIO_LOW = 0,
+	SPDK_FD_GROUP_PRIO_DEFAULT = 1,
+	SPDK_FD_GROUP_PRIO_HIGH = 2,
+	SPDK_FD_GROUP_PRIO_NUM_CLASSES,
+};
+
+/**
+ * Structure with optional parameters for registering an event source.
+ */
+struct spdk_fd_group_add_opts {
+	/* Size of this structure in bytes. */
+	size_t size;
+	/*
+	 * Priority class of the event source. The default value is
+	 * SPDK_FD_GROUP_PRIO_DEFAULT and used when options are omitted.
+	 */
+	enum spdk_fd_group_prio prio;
+	/*
+	 * If non-zero, at most this many events of lower priority classes are
+	 * dispatched before the group is re-polled for new events of this source's
+	 * class, bounding the dispatch latency of the source during event storms
+	 * on lower priority fds. Only meaningful for sources with a priority above
+	 * SPDK_FD_GROUP_PRIO_LOW. The default value is 0 (no deadline).
+	 */
+	uint32_t deadline;
+};
+SPDK_STATIC_ASSERT(sizeof(struct spdk_fd_group_add_opts) == 16, "Incorrect size");
+
 /**
  * Register one event source to specified fgrp.
  *
@@ -113,6 +147,22 @@ int spdk_fd_group_unnest(struct spdk_fd_group *parent, struct spdk_fd_group *chi
 int spdk_fd_group_add(struct spdk_fd_group *fgrp, int efd,
 		      spdk_fd_fn fn, void *arg, const char *name);
 
+/**
+ * Register one event source to specified fgrp with extended options.
+ *
+ * \param fgrp The fgrp registered to.
+ * \param efd File descriptor of the event source.
+ * \param fn Called each time there are events in event source.
+ * \param arg Function argument for fn.
+ * \param name Name of the event source.
+ * \param opts Extended event source options. If NULL, default values are used.
+ *
+ * \return 0 if success or -errno if failed
+ */
+int spdk_fd_group_add_ext(struct spdk_fd_group *fgrp, int efd, spdk_fd_fn fn,
+			  void *arg, const char *name,
+			  const struct spdk_fd_group_add_opts *opts);
+
 /*
  * \brief Register an event source with the name set to the string of the
  * callback function.
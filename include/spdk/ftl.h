@@ -138,8 +138,18 @@ struct spdk_ftl_conf {
 	/* Enable fast shutdown path */
 	bool					fast_shutdown;
 
-	/* Hole at bytes 0x79 - 0x7f. */
-	uint8_t					reserved2[7];
+	/* Hole at bytes 0x79 - 0x7b. */
+	uint8_t					reserved2[3];
+
+	/* Number of parallel compaction processes draining the nv cache, 8 by default.
+	 * Kept outside of the nv_cache struct above to preserve the structure layout. */
+	uint32_t				nv_cache_compaction_concurrency;
+
+	/* Path to a DAX device or file providing a direct-access mapping of the cache
+	 * device's storage (e.g. CXL-attached persistent memory). When set, the dax NV
+	 * cache device type serves cache fills and reads through the mapping, bypassing
+	 * the bdev stack. */
+	char					*cache_dax_path;
 
 	/*
 	 * The size of spdk_ftl_conf according to the caller of this library is used for ABI
@@ -148,7 +158,7 @@ struct spdk_ftl_conf {
 	 */
 	size_t					conf_size;
 } __attribute__((packed));
-SPDK_STATIC_ASSERT(sizeof(struct spdk_ftl_conf) == 136, "Incorrect size");
+SPDK_STATIC_ASSERT(sizeof(struct spdk_ftl_conf) == 144, "Incorrect size");
 
 enum spdk_ftl_mode {
 	/* Create new device */
@@ -408,6 +408,20 @@ int spdk_idxd_submit_raw_desc(struct spdk_idxd_io_channel *chan,
 			      struct idxd_hw_desc *desc,
 			      spdk_idxd_req_cb cb_fn, void *cb_arg);
 
+/**
+ * Submit the batch being built on an IDXD channel to the hardware.
+ *
+ * Descriptors prepared by the submit functions are accumulated into a hardware
+ * batch descriptor which is normally written to the device portal once enough
+ * entries have been gathered or on the next \b spdk_idxd_process_events call.
+ * Call this function after submitting a group of operations to flush the batch
+ * immediately instead of waiting for either of those triggers.
+ *
+ * \param chan IDXD channel to flush.
+ * \return 0 on success (including no batch being built), negative errno on failure.
+ */
+int spdk_idxd_flush_batch(struct spdk_idxd_io_channel *chan);
+
 /**
  * Check for completed requests on an IDXD channel.
  *
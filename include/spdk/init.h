@@ -112,6 +112,33 @@ void spdk_subsystem_init_from_json_config(const char *json_config_file, const ch
 void spdk_subsystem_load_config(void *json, ssize_t json_size, spdk_subsystem_init_fn cb_fn,
 				void *cb_arg, bool stop_on_error);
 
+/**
+ * Save the current runtime configuration of all subsystems as a validated snapshot file.
+ * The snapshot carries a header with a version and a CRC over the configuration payload,
+ * so a stale or corrupted snapshot is rejected at restore time. This is intended to be
+ * called on clean shutdown, while all subsystems are still initialized.
+ *
+ * \param path Path of the snapshot file. The file is written atomically (temporary file
+ * plus rename).
+ *
+ * \return 0 on success, negated errno on failure.
+ */
+int spdk_subsystem_save_config_snapshot(const char *path);
+
+/**
+ * Read and validate a configuration snapshot previously written by
+ * \ref spdk_subsystem_save_config_snapshot. On success the returned buffer contains the
+ * JSON configuration payload and can be passed to \ref spdk_subsystem_load_config.
+ * The caller is responsible for freeing the buffer.
+ *
+ * \param path Path of the snapshot file.
+ * \param size Output parameter for the size of the JSON payload.
+ *
+ * \return Buffer with the JSON payload, or NULL if the snapshot is missing or fails
+ * validation.
+ */
+void *spdk_subsystem_read_config_snapshot(const char *path, size_t *size);
+
 typedef void (*spdk_subsystem_fini_fn)(void *ctx);
 
 /**
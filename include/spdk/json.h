@@ -195,6 +195,8 @@ typedef int (*spdk_json_write_cb)(void *cb_ctx, const void *data, size_t size);
 struct spdk_json_write_ctx *spdk_json_write_begin(spdk_json_write_cb write_cb, void *cb_ctx,
 		uint32_t flags);
 int spdk_json_write_end(struct spdk_json_write_ctx *w);
+/* Push any internally buffered data out through the write callback. */
+int spdk_json_write_flush(struct spdk_json_write_ctx *w);
 int spdk_json_write_null(struct spdk_json_write_ctx *w);
 int spdk_json_write_bool(struct spdk_json_write_ctx *w, bool val);
 int spdk_json_write_uint8(struct spdk_json_write_ctx *w, uint8_t val);
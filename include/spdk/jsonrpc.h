@@ -171,6 +171,32 @@ struct spdk_json_write_ctx *spdk_jsonrpc_begin_result(struct spdk_jsonrpc_reques
  */
 void spdk_jsonrpc_end_result(struct spdk_jsonrpc_request *request, struct spdk_json_write_ctx *w);
 
+/**
+ * Flush the part of the response serialized so far to the connection.
+ *
+ * This may be called between spdk_jsonrpc_begin_result() and
+ * spdk_jsonrpc_end_result() while building a large response.  The data written
+ * to the JSON write context so far is handed off to the connection and starts
+ * being sent to the client while the rest of the response is still being
+ * generated, so the full response never has to be buffered in memory at once.
+ * After the first flush no other response is sent on the connection until this
+ * one is completed with spdk_jsonrpc_end_result().
+ *
+ * The return value reports how many flushed bytes have not been sent to the
+ * client yet and can be used as a backpressure signal - a handler generating
+ * its response incrementally (e.g. from a poller) can stop producing when the
+ * backlog grows too large and resume once the client catches up.
+ *
+ * \param request JSON-RPC request the response is built for.
+ * \param w JSON write context returned from spdk_jsonrpc_begin_result().
+ *
+ * \return Number of flushed bytes still queued for the connection, or negated
+ * errno: -ENOTCONN if the connection was closed (the response will never be
+ * sent), -ENOMEM on memory allocation failure.
+ */
+ssize_t spdk_jsonrpc_flush_result(struct spdk_jsonrpc_request *request,
+				  struct spdk_json_write_ctx *w);
+
 /**
  * Complete a JSON-RPC response and write bool result.
  *
@@ -216,6 +216,29 @@ void spdk_lvol_create_snapshot(struct spdk_lvol *lvol, const char *snapshot_name
 void spdk_lvol_create_clone(struct spdk_lvol *lvol, const char *clone_name,
 			    spdk_lvol_op_with_handle_complete cb_fn, void *cb_arg);
 
+/**
+ * Create many clones of given snapshot in one batch.
+ *
+ * The underlying blob creations are pipelined through the blobstore metadata
+ * thread, which is considerably faster than cloning one lvol at a time when
+ * provisioning a large number of clones.
+ *
+ * The lvols array must have room for count entries and is filled with the
+ * created lvols. If opening one of the created clones fails, its entry is set
+ * to NULL, the remaining clones are still created and the callback receives
+ * the first error.
+ *
+ * \param lvol Handle to lvol snapshot.
+ * \param clone_names Array of count names, one for each created clone.
+ * \param count Number of clones to create.
+ * \param lvols Array filled with the created lvols.
+ * \param cb_fn Completion callback.
+ * \param cb_arg Completion callback custom arguments.
+ */
+void spdk_lvol_create_clone_bulk(struct spdk_lvol *lvol, const char **clone_names,
+				 size_t count, struct spdk_lvol **lvols,
+				 spdk_lvol_op_complete cb_fn, void *cb_arg);
+
 /**
  * Create clone of given non-lvol device.
  *
@@ -265,6 +288,24 @@ bool spdk_lvol_deletable(struct spdk_lvol *lvol);
  */
 void spdk_lvol_destroy(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_arg);
 
+/**
+ * Destroy a batch of lvols from the same lvolstore.
+ *
+ * The underlying blob deletions are kept in flight together, so destroying many
+ * lvols at once is considerably faster than destroying them one after another.
+ * Snapshots may be listed in any order relative to their clones.  All lvols are
+ * attempted even if some fail; the callback receives the first error
+ * encountered.
+ *
+ * \param lvols Array of handles to the lvols to destroy.  The array is copied
+ * and may be released as soon as this function returns.
+ * \param count Number of entries in lvols.
+ * \param cb_fn Completion callback.
+ * \param cb_arg Completion callback custom arguments.
+ */
+void spdk_lvol_destroy_bulk(struct spdk_lvol **lvols, size_t count,
+			    spdk_lvol_op_complete cb_fn, void *cb_arg);
+
 /**
  * Close lvol, but information is kept on lvolstore.
  *
@@ -374,6 +415,18 @@ void spdk_lvol_open(struct spdk_lvol *lvol, spdk_lvol_op_with_handle_complete cb
  */
 void spdk_lvol_inflate(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_arg);
 
+/**
+ * Inflate lvol with a caller-chosen number of parallel cluster copies
+ *
+ * \param lvol Handle to lvol
+ * \param max_in_flight Maximum number of cluster copies kept in flight,
+ * 0 selects the default
+ * \param cb_fn Completion callback
+ * \param cb_arg Completion callback custom arguments
+ */
+void spdk_lvol_inflate_ext(struct spdk_lvol *lvol, uint32_t max_in_flight,
+			   spdk_lvol_op_complete cb_fn, void *cb_arg);
+
 /**
  * Decouple parent of lvol
  *
@@ -383,6 +436,18 @@ void spdk_lvol_inflate(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void
  */
 void spdk_lvol_decouple_parent(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_arg);
 
+/**
+ * Decouple parent of lvol with a caller-chosen number of parallel cluster copies
+ *
+ * \param lvol Handle to lvol
+ * \param max_in_flight Maximum number of cluster copies kept in flight,
+ * 0 selects the default
+ * \param cb_fn Completion callback
+ * \param cb_arg Completion callback custom arguments
+ */
+void spdk_lvol_decouple_parent_ext(struct spdk_lvol *lvol, uint32_t max_in_flight,
+				   spdk_lvol_op_complete cb_fn, void *cb_arg);
+
 /**
  * Determine if an lvol is degraded. A degraded lvol cannot perform IO.
  *
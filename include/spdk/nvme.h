@@ -312,8 +312,17 @@ struct spdk_nvme_ctrlr_opts {
 	 * the spdk_nvmf_dhchap_dhgroup values.
 	 */
 	uint32_t dhchap_dhgroups;
+
+	/**
+	 * Maximum number of per-namespace IDENTIFY commands kept outstanding on the admin
+	 * queue while enumerating namespaces during controller initialization.
+	 *
+	 * Larger windows speed up attaching controllers with many namespaces.  A value of
+	 * 0 or 1 enumerates namespaces serially.  Default is 16.
+	 */
+	uint32_t ns_identify_window;
 };
-SPDK_STATIC_ASSERT(sizeof(struct spdk_nvme_ctrlr_opts) == 856, "Incorrect size");
+SPDK_STATIC_ASSERT(sizeof(struct spdk_nvme_ctrlr_opts) == 864, "Incorrect size");
 
 /**
  * NVMe acceleration operation callback.
@@ -652,8 +661,13 @@ struct spdk_nvme_ns_cmd_ext_io_opts {
 	 *  qpair is part of a poll group).
 	 */
 	void *accel_sequence;
+	/** Token of a payload layout pre-registered on the qpair with
+	 * spdk_nvme_qpair_register_payload(), or 0.  On a match, the transport reuses the
+	 * cached data pointer representation instead of rebuilding it for each submission.
+	 */
+	uint64_t payload_token;
 };
-SPDK_STATIC_ASSERT(sizeof(struct spdk_nvme_ns_cmd_ext_io_opts) == 56, "Incorrect size");
+SPDK_STATIC_ASSERT(sizeof(struct spdk_nvme_ns_cmd_ext_io_opts) == 64, "Incorrect size");
 
 /**
  * Parse the string representation of a transport ID.
@@ -1618,8 +1632,19 @@ struct spdk_nvme_io_qpair_opts {
 		bool delay_pcie_doorbell;
 	};
 
-	/* Hole at bytes 13-15. */
-	uint8_t reserved13[3];
+	/**
+	 * If set and the controller exposes a controller memory buffer with write
+	 * data support, write payloads up to one memory page are copied into a
+	 * per-command staging area in the CMB and the command points at the CMB
+	 * copy, saving the controller a DMA round trip to host memory.
+	 *
+	 * This is only used by PCIe attached NVMe devices.  It is ignored if no
+	 * CMB staging space could be reserved when the qpair is created.
+	 */
+	bool use_cmb_wds;
+
+	/* Hole at bytes 14-15. */
+	uint8_t reserved14[2];
 
 	/**
 	 * These fields allow specifying the memory buffers for the submission and/or
@@ -1976,6 +2001,68 @@ int spdk_nvme_ctrlr_cmd_iov_raw_with_md(struct spdk_nvme_ctrlr *ctrlr,
 int32_t spdk_nvme_qpair_process_completions(struct spdk_nvme_qpair *qpair,
 		uint32_t max_completions);
 
+/**
+ * Flush any deferred command submissions on a queue pair.
+ *
+ * When a queue pair was created with delay_cmd_submit enabled, submissions are
+ * normally made visible to the controller (e.g. by ringing the PCIe submission
+ * queue doorbell) from spdk_nvme_qpair_process_completions().  Latency-sensitive
+ * callers can use this function to notify the controller immediately without
+ * processing completions.
+ *
+ * This is a no-op on queue pairs that have no deferred submissions, either
+ * because delay_cmd_submit is disabled or because the transport always submits
+ * commands immediately.
+ *
+ * The caller must ensure that each queue pair is only used from one thread at a
+ * time.
+ *
+ * \param qpair Queue pair to flush.
+ *
+ * \return 0 on success, negated errno on failure.
+ */
+int spdk_nvme_qpair_flush(struct spdk_nvme_qpair *qpair);
+
+/**
+ * Pre-register a contiguous payload buffer layout with a queue pair.
+ *
+ * The transport translates the buffer once and caches the resulting data
+ * pointer representation (e.g. the PRP entries on the PCIe transport).  I/O
+ * submitted through the _ext variants of the command APIs with the returned
+ * token set in spdk_nvme_ns_cmd_ext_io_opts reuses the cached representation
+ * when the payload matches the registered buffer, skipping the per-submission
+ * translation.  The buffer must stay pinned at the same virtual address for as
+ * long as it is registered.
+ *
+ * The caller must ensure that each queue pair is only used from one thread at
+ * a time.
+ *
+ * \param qpair Queue pair to register the payload with.
+ * \param buffer Virtual address pointer to the payload buffer.
+ * \param payload_size Size of the payload buffer in bytes.
+ * \param[out] token Opaque non-zero token identifying the registration.
+ *
+ * \return 0 on success, -ENOTSUP if the transport does not support payload
+ * registration, -ENOSPC if the qpair's registration table is full, or negated
+ * errno on other failures.
+ */
+int spdk_nvme_qpair_register_payload(struct spdk_nvme_qpair *qpair, void *buffer,
+				     uint32_t payload_size, uint64_t *token);
+
+/**
+ * Unregister a payload layout previously registered with
+ * spdk_nvme_qpair_register_payload().
+ *
+ * The caller must ensure no I/O using the token is outstanding on the qpair.
+ *
+ * \param qpair Queue pair the payload was registered with.
+ * \param token Token returned by the registration.
+ *
+ * \return 0 on success, -ENOTSUP if the transport does not support payload
+ * registration, or -EINVAL if the token does not name a registration.
+ */
+int spdk_nvme_qpair_unregister_payload(struct spdk_nvme_qpair *qpair, uint64_t token);
+
 /**
  * Returns the reason the qpair is disconnected.
  *
@@ -2815,6 +2902,55 @@ int spdk_nvme_poll_group_destroy(struct spdk_nvme_poll_group *group);
 int64_t spdk_nvme_poll_group_process_completions(struct spdk_nvme_poll_group *group,
 		uint32_t completions_per_qpair, spdk_nvme_disconnected_qpair_cb disconnected_qpair_cb);
 
+/**
+ * Enable hybrid interrupt/poll mode on a poll group.
+ *
+ * While enabled, a qpair that completes no I/O and has no outstanding or queued
+ * requests for \b idle_poll_threshold consecutive polls is parked and skipped by
+ * subsequent spdk_nvme_poll_group_process_completions() calls.  A parked qpair
+ * cannot have completions pending, so no events are lost; it resumes polling
+ * automatically on its next request submission or qpair state change.  This
+ * bounds the polling cost of poll groups with many mostly-idle qpairs.
+ *
+ * When all qpairs in the group are parked, the caller may sleep on the file
+ * descriptor returned by spdk_nvme_poll_group_get_fd(), which becomes readable
+ * whenever a qpair is unparked.
+ *
+ * \param group The poll group to enable hybrid polling on.
+ * \param idle_poll_threshold Number of consecutive idle polls after which a
+ * qpair is parked.  Must be greater than zero.
+ *
+ * \return 0 on success, -EINVAL if idle_poll_threshold is zero, -ENOTSUP on
+ * platforms without eventfd support, or negated errno on failure to allocate
+ * the notification resources.
+ */
+int spdk_nvme_poll_group_enable_hybrid_polling(struct spdk_nvme_poll_group *group,
+		uint32_t idle_poll_threshold);
+
+/**
+ * Disable hybrid interrupt/poll mode on a poll group.
+ *
+ * All parked qpairs are returned to busy polling and the notification file
+ * descriptor is closed.
+ *
+ * \param group The poll group to disable hybrid polling on.
+ */
+void spdk_nvme_poll_group_disable_hybrid_polling(struct spdk_nvme_poll_group *group);
+
+/**
+ * Return a file descriptor to wait on when all qpairs in the group are parked.
+ *
+ * The returned descriptor may be polled directly or nested into an epoll set.
+ * It becomes readable whenever a parked qpair resumes polling and remains owned
+ * by the poll group.
+ *
+ * \param group The poll group to retrieve the file descriptor from.
+ *
+ * \return A pollable file descriptor, or -ENOTSUP if hybrid polling is not
+ * enabled on the group.
+ */
+int spdk_nvme_poll_group_get_fd(struct spdk_nvme_poll_group *group);
+
 /**
  * Check if all qpairs in the poll group are connected.
  *
@@ -4333,6 +4469,16 @@ struct spdk_nvme_transport_ops {
 
 	int32_t (*qpair_process_completions)(struct spdk_nvme_qpair *qpair, uint32_t max_completions);
 
+	/* Optional.  Makes any deferred submissions visible to the controller. */
+	int (*qpair_flush)(struct spdk_nvme_qpair *qpair);
+
+	/* Optional.  Caches the data pointer representation of a payload buffer. */
+	int (*qpair_register_payload)(struct spdk_nvme_qpair *qpair, void *buffer,
+				      uint32_t payload_size, uint64_t *token);
+
+	/* Optional.  Required if qpair_register_payload is provided. */
+	int (*qpair_unregister_payload)(struct spdk_nvme_qpair *qpair, uint64_t token);
+
 	int (*qpair_iterate_requests)(struct spdk_nvme_qpair *qpair,
 				      int (*iter_fn)(struct nvme_request *req, void *arg),
 				      void *arg);
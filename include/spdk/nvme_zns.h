@@ -392,6 +392,113 @@ int spdk_nvme_zns_ext_report_zones(struct spdk_nvme_ns *ns, struct spdk_nvme_qpa
 				   enum spdk_nvme_zns_zra_report_opts report_opts, bool partial_report,
 				   spdk_nvme_cmd_cb cb_fn, void *cb_arg);
 
+/**
+ * Opaque handle to a zone append scheduler.
+ *
+ * The scheduler submits Zone Append commands on behalf of the caller while
+ * honoring the namespace's open and active zone budgets, limiting the number
+ * of appends outstanding per zone, and tracking per-zone write pointers from
+ * the append completions so that the caller does not need a Report Zones
+ * round trip to learn where its data landed.
+ */
+struct spdk_nvme_zns_scheduler;
+
+/**
+ * Create a zone append scheduler for the given zoned namespace and qpair.
+ *
+ * The scheduler keeps at most min(MOR, MAR) + 1 zones implicitly open at once.
+ * Appends to zones beyond that budget are queued and dispatched as zones
+ * become full or are finished with spdk_nvme_zns_scheduler_finish_zone().
+ *
+ * The scheduler is not thread safe.  It must only be used from the thread
+ * that submits to and polls the qpair.
+ *
+ * \param ns Namespace with the Zoned Namespace Command Set enabled.
+ * \param qpair I/O queue pair used to submit the commands.
+ * \param max_zone_qd Maximum number of appends outstanding per zone, or 0 for
+ * the default (4).
+ * \param num_requests Number of append contexts to preallocate, or 0 for the
+ * default (128).  This bounds the number of appends that may be outstanding
+ * or queued in the scheduler at once.
+ *
+ * \return a scheduler on success, or NULL if the namespace is not zoned or
+ * memory could not be allocated.
+ */
+struct spdk_nvme_zns_scheduler *spdk_nvme_zns_scheduler_create(struct spdk_nvme_ns *ns,
+		struct spdk_nvme_qpair *qpair,
+		uint32_t max_zone_qd,
+		uint32_t num_requests);
+
+/**
+ * Append a data buffer to the given zone through the scheduler.
+ *
+ * The append is submitted immediately if the zone is within the open zone
+ * budget and has fewer than max_zone_qd appends outstanding, and is queued
+ * inside the scheduler otherwise.  The callback is invoked with the Zone
+ * Append completion once the command completes; the assigned LBA is in cdw0
+ * and cdw1 of the completion as defined by the specification.
+ *
+ * \param sched Zone append scheduler.
+ * \param buffer Virtual address pointer to the data payload.
+ * \param zslba Zone start LBA of the zone to append to.
+ * \param lba_count Length of the payload in logical blocks.
+ * \param cb_fn Callback function invoked when the I/O command completes.
+ * \param cb_arg Argument passed to callback function.
+ * \param io_flags Set flags, defined in nvme_spec.h, for this I/O.
+ *
+ * \return 0 on success.  Negated errno on failure: -EINVAL if zslba is not a
+ * valid zone start LBA, -ENOSPC if the scheduler has seen the zone become
+ * full, -ENOMEM if all preallocated append contexts are in use.
+ */
+int spdk_nvme_zns_scheduler_append(struct spdk_nvme_zns_scheduler *sched, void *buffer,
+				   uint64_t zslba, uint32_t lba_count,
+				   spdk_nvme_cmd_cb cb_fn, void *cb_arg, uint32_t io_flags);
+
+/**
+ * Get the tracked write pointer of the given zone.
+ *
+ * The write pointer is maintained from append completions, so it reflects
+ * only data written through this scheduler and trails the device's write
+ * pointer by the appends still in flight.
+ *
+ * \param sched Zone append scheduler.
+ * \param zslba Zone start LBA of the zone to query.
+ *
+ * \return the next LBA that will be assigned in the zone, or UINT64_MAX if
+ * zslba is invalid or no append to the zone has completed yet.
+ */
+uint64_t spdk_nvme_zns_scheduler_get_write_pointer(struct spdk_nvme_zns_scheduler *sched,
+		uint64_t zslba);
+
+/**
+ * Finish the given zone and release its open zone budget slot.
+ *
+ * The zone must have no appends outstanding or queued in the scheduler.
+ * Once the Zone Management Send completes, the budget slot is handed to the
+ * oldest zone waiting for one, if any.
+ *
+ * \param sched Zone append scheduler.
+ * \param zslba Zone start LBA of the zone to finish.
+ * \param cb_fn Callback function invoked when the command completes.
+ * \param cb_arg Argument passed to callback function.
+ *
+ * \return 0 on success.  Negated errno on failure: -EINVAL if zslba is not a
+ * valid zone start LBA, -EBUSY if the zone still has appends outstanding or
+ * queued, -ENOMEM if no context or request could be allocated.
+ */
+int spdk_nvme_zns_scheduler_finish_zone(struct spdk_nvme_zns_scheduler *sched, uint64_t zslba,
+					spdk_nvme_cmd_cb cb_fn, void *cb_arg);
+
+/**
+ * Free a zone append scheduler.
+ *
+ * All appends submitted through the scheduler must have completed before
+ * calling this function.
+ *
+ * \param sched Zone append scheduler to free.
+ */
+void spdk_nvme_zns_scheduler_free(struct spdk_nvme_zns_scheduler *sched);
+
 #ifdef __cplusplus
 }
 #endif
@@ -356,6 +356,36 @@ void spdk_nvmf_poll_group_destroy(struct spdk_nvmf_poll_group *group,
 int spdk_nvmf_poll_group_add(struct spdk_nvmf_poll_group *group,
 			     struct spdk_nvmf_qpair *qpair);
 
+/**
+ * Migrate the given qpair to another poll group.
+ *
+ * The qpair stops accepting new commands, its outstanding requests are drained,
+ * and then the qpair is detached from its current poll group and attached to
+ * \b group on that group's thread. The migration is asynchronous; commands
+ * received while it is in progress are processed once the qpair is attached to
+ * the new group. If the qpair is disconnected before the migration completes,
+ * the migration is abandoned and the qpair is destroyed as usual.
+ *
+ * This function must be called on the thread of the qpair's current poll group.
+ * The caller must ensure \b group is not destroyed while the migration is in
+ * progress.
+ *
+ * \param qpair The qpair to migrate. Must be an I/O qpair - the admin qpair
+ * cannot be migrated away from its controller's thread.
+ * \param group The poll group to migrate the qpair to.
+ *
+ * \return 0 on success (including when \b group is already the qpair's group).
+ * \return -EINVAL if called on the wrong thread or \b group does not service
+ * the qpair's transport.
+ * \return -ENOTSUP if the qpair is an admin qpair or its transport does not
+ * support migration.
+ * \return -ENXIO if the qpair is not enabled or is being disconnected.
+ * \return -EINPROGRESS if the qpair is already being migrated.
+ * \return -ENOMEM if the migration context could not be allocated.
+ */
+int spdk_nvmf_qpair_migrate(struct spdk_nvmf_qpair *qpair,
+			    struct spdk_nvmf_poll_group *group);
+
 typedef void (*nvmf_qpair_disconnect_cb)(void *ctx);
 
 /**
@@ -622,6 +652,10 @@ struct spdk_nvmf_host_opts {
 	struct spdk_key			*dhchap_key;
 	/** DH-HMAC-CHAP controller key */
 	struct spdk_key			*dhchap_ctrlr_key;
+	/** Max I/O per second from this host, 0 for unlimited */
+	uint64_t			max_ios_per_sec;
+	/** Max read/write throughput from this host in MiB/s, 0 for unlimited */
+	uint64_t			max_mbytes_per_sec;
 };
 
 /**
@@ -650,6 +684,25 @@ int spdk_nvmf_subsystem_add_host_ext(struct spdk_nvmf_subsystem *subsystem,
  */
 int spdk_nvmf_subsystem_remove_host(struct spdk_nvmf_subsystem *subsystem, const char *hostnqn);
 
+/**
+ * Set QoS rate limits for I/O submitted by the given host.
+ *
+ * The limits are enforced per controller created by the host within this
+ * subsystem, across all of the controller's queue pairs.  I/O exceeding the
+ * limits is queued and submitted once the token buckets refill.  Existing
+ * controllers pick up the new limits; setting a limit to 0 disables it.
+ *
+ * \param subsystem Subsystem the host connects to.
+ * \param hostnqn The NQN for the host.  Must have been added via
+ *	  spdk_nvmf_subsystem_add_host() first.
+ * \param max_ios_per_sec Max I/O per second, 0 for unlimited.
+ * \param max_mbytes_per_sec Max read/write throughput in MiB/s, 0 for unlimited.
+ *
+ * \return 0 on success, or negated errno value on failure.
+ */
+int spdk_nvmf_subsystem_set_host_qos(struct spdk_nvmf_subsystem *subsystem, const char *hostnqn,
+				     uint64_t max_ios_per_sec, uint64_t max_mbytes_per_sec);
+
 /**
  * Disconnect all connections originating from the provided hostnqn
  *
@@ -1019,9 +1072,12 @@ SPDK_STATIC_ASSERT(sizeof(struct spdk_nvmf_ns_opts) == 72, "Incorrect size");
 void spdk_nvmf_ns_opts_get_defaults(struct spdk_nvmf_ns_opts *opts, size_t opts_size);
 
 /**
- * Add a namespace to a subsystems in the PAUSED or INACTIVE states.
+ * Add a namespace to a subsystem.
  *
- * May only be performed on subsystems in the PAUSED or INACTIVE states.
+ * May be performed on subsystems in the ACTIVE, PAUSED or INACTIVE states.
+ * When the subsystem is ACTIVE, the namespace is published to the poll groups
+ * asynchronously and hosts are notified once every poll group can see it;
+ * I/O to the existing namespaces is not interrupted.
  *
  * \param subsystem Subsystem to add namespace to.
  * \param bdev_name Block device name to add as a namespace.
@@ -121,8 +121,11 @@ struct spdk_nvmf_request {
 
 	/* Timeout tracked for connect and abort flows. */
 	uint64_t timeout_tsc;
+
+	/* Submission timestamp, used for per-namespace I/O statistics. */
+	uint64_t submit_tsc;
 };
-SPDK_STATIC_ASSERT(sizeof(struct spdk_nvmf_request) == 776, "Incorrect size");
+SPDK_STATIC_ASSERT(sizeof(struct spdk_nvmf_request) == 784, "Incorrect size");
 
 enum spdk_nvmf_qpair_state {
 	SPDK_NVMF_QPAIR_UNINITIALIZED = 0,
@@ -136,6 +139,7 @@ enum spdk_nvmf_qpair_state {
 typedef void (*spdk_nvmf_state_change_done)(void *cb_arg, int status);
 
 struct spdk_nvmf_qpair_auth;
+struct nvmf_qpair_migrate_ctx;
 
 struct spdk_nvmf_qpair {
 	uint8_t					state; /* ref spdk_nvmf_qpair_state */
@@ -167,7 +171,17 @@ struct spdk_nvmf_qpair {
 	/* Number of IO outstanding at transport level */
 	uint16_t				queue_depth;
 
+	/* Local per-host QoS credit caches, refilled in batches from the
+	 * owning controller's shared token pools.  May go negative when a
+	 * single command costs more than the remaining credits. */
+	int64_t					qos_io_credits;
+	int64_t					qos_byte_credits;
+
 	struct spdk_nvmf_qpair_auth		*auth;
+
+	/* Set while the qpair is being migrated to another poll group.  Transports
+	 * must not start new requests on the qpair while this is non-NULL. */
+	struct nvmf_qpair_migrate_ctx		*migrate_ctx;
 };
 
 struct spdk_nvmf_transport_poll_group {
@@ -175,6 +189,13 @@ struct spdk_nvmf_transport_poll_group {
 	/* Requests that are waiting to obtain a data buffer */
 	STAILQ_HEAD(, spdk_nvmf_request)				pending_buf_queue;
 	struct spdk_iobuf_channel					*buf_cache;
+	/* LIFO arena of io_unit_size data buffers owned by this poll group.
+	 * Fronts buf_cache, so steady-state request buffers are recycled
+	 * without going through the iobuf channel.  Sized by the transport's
+	 * buf_cache_size. */
+	void								**buf_arena;
+	uint32_t							buf_arena_count;
+	uint32_t							buf_arena_size;
 	struct spdk_nvmf_poll_group					*group;
 	TAILQ_ENTRY(spdk_nvmf_transport_poll_group)			link;
 };
@@ -198,6 +219,9 @@ struct spdk_nvmf_poll_group {
 	/* All of the queue pairs that belong to this poll group */
 	TAILQ_HEAD(, spdk_nvmf_qpair)			qpairs;
 
+	/* Requests held back by per-host QoS, waiting for token refill */
+	TAILQ_HEAD(, spdk_nvmf_request)			qos_queued;
+
 	/* Statistics */
 	struct spdk_nvmf_poll_group_stat		stat;
 
@@ -377,6 +401,24 @@ struct spdk_nvmf_transport_ops {
 	int (*poll_group_remove)(struct spdk_nvmf_transport_poll_group *group,
 				 struct spdk_nvmf_qpair *qpair);
 
+	/**
+	 * Detach a qpair from its poll group as part of a live migration to
+	 * another poll group.  Called on the current poll group's thread once
+	 * the qpair has no outstanding requests.  Return -EAGAIN if transport
+	 * level resources are still in flight and the detach should be retried.
+	 * Optional.  Required to support spdk_nvmf_qpair_migrate().
+	 */
+	int (*qpair_migrate_detach)(struct spdk_nvmf_transport_poll_group *group,
+				    struct spdk_nvmf_qpair *qpair);
+
+	/**
+	 * Attach a previously detached qpair to its new poll group, completing
+	 * a live migration.  Called on the new poll group's thread.
+	 * Optional.  Required to support spdk_nvmf_qpair_migrate().
+	 */
+	int (*qpair_migrate_attach)(struct spdk_nvmf_transport_poll_group *group,
+				    struct spdk_nvmf_qpair *qpair);
+
 	/**
 	 * Poll the group to process I/O
 	 */
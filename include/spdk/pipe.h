@@ -162,6 +162,93 @@ int spdk_pipe_group_add(struct spdk_pipe_group *group, struct spdk_pipe *pipe);
  */
 int spdk_pipe_group_remove(struct spdk_pipe_group *group, struct spdk_pipe *pipe);
 
+struct spdk_spsc_pipe;
+
+/**
+ * Construct a lock-free single-producer/single-consumer pipe around the given
+ * memory buffer.
+ *
+ * Unlike spdk_pipe, exactly one thread may act as the writer and one (possibly
+ * different) thread as the reader, without any external locking. The API
+ * mirrors spdk_pipe's claim/commit model. To distinguish a full pipe from an
+ * empty one without shared state, the pipe holds at most sz - 1 bytes.
+ *
+ * \param buf The data buffer that backs this pipe.
+ * \param sz The size of the data buffer. Must be at least 2.
+ *
+ * \return spdk_spsc_pipe. The new pipe, or NULL on failure.
+ */
+struct spdk_spsc_pipe *spdk_spsc_pipe_create(void *buf, uint32_t sz);
+
+/**
+ * Destroys the pipe. Neither thread may be using the pipe when it is
+ * destroyed.
+ *
+ * \param pipe The pipe to operate on.
+ * \return Pipe buffer associated with the pipe when destroyed. The caller
+ *         should free this buffer.
+ */
+void *spdk_spsc_pipe_destroy(struct spdk_spsc_pipe *pipe);
+
+/**
+ * Acquire memory from the pipe for writing. Only the writer thread may call
+ * this. See spdk_pipe_writer_get_buffer() for the claim/commit semantics.
+ *
+ * \param pipe The pipe to operate on.
+ * \param sz The size requested.
+ * \param iovs A two element iovec array that will be populated with the requested memory.
+ *
+ * \return The total bytes obtained. May be 0.
+ */
+int spdk_spsc_pipe_writer_get_buffer(struct spdk_spsc_pipe *pipe, uint32_t sz,
+				     struct iovec *iovs);
+
+/**
+ * Advance the write pointer by the given number of bytes, publishing them to
+ * the reader thread. Only the writer thread may call this.
+ *
+ * \param pipe The pipe to operate on.
+ * \param count The number of bytes to advance.
+ *
+ * \return On error, a negated errno. On success, 0.
+ */
+int spdk_spsc_pipe_writer_advance(struct spdk_spsc_pipe *pipe, uint32_t count);
+
+/**
+ * Get the number of bytes available to read from the pipe. Only the reader
+ * thread may call this.
+ *
+ * \param pipe The pipe to operate on.
+ *
+ * \return The number of bytes available for reading.
+ */
+uint32_t spdk_spsc_pipe_reader_bytes_available(struct spdk_spsc_pipe *pipe);
+
+/**
+ * Obtain previously written memory from the pipe for reading. Only the reader
+ * thread may call this. See spdk_pipe_reader_get_buffer() for the
+ * claim/commit semantics.
+ *
+ * \param pipe The pipe to operate on.
+ * \param sz The size requested.
+ * \param iovs A two element iovec array that will be populated with the requested memory.
+ *
+ * \return On error, a negated errno. On success, the total number of bytes available.
+ */
+int spdk_spsc_pipe_reader_get_buffer(struct spdk_spsc_pipe *pipe, uint32_t sz,
+				     struct iovec *iovs);
+
+/**
+ * Mark memory as read, making it available to the writer thread. Only the
+ * reader thread may call this.
+ *
+ * \param pipe The pipe to operate on.
+ * \param count The number of bytes to advance.
+ *
+ * \return On error, a negated errno. On success, 0.
+ */
+int spdk_spsc_pipe_reader_advance(struct spdk_spsc_pipe *pipe, uint32_t count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -97,6 +97,36 @@ typedef void (*spdk_rpc_method_handler)(struct spdk_jsonrpc_request *request,
 void spdk_rpc_register_method(const char *method, spdk_rpc_method_handler func,
 			      uint32_t state_mask);
 
+/**
+ * The method does not modify any state and its handler may be run on an RPC
+ * worker thread, concurrently with other methods, instead of queueing behind
+ * them on the thread polling the RPC server.  Methods registered without this
+ * flag keep their ordering on the polling thread.
+ */
+#define SPDK_RPC_METHOD_FLAG_CONCURRENT	0x1
+
+/**
+ * Register an RPC method with additional flags.
+ *
+ * \param method Name for the registered method.
+ * \param func Function registered for this method to handle the RPC request.
+ * \param state_mask State mask of the registered method. If the bit of the state of
+ * the RPC server is set in the state_mask, the method is allowed. Otherwise, it is rejected.
+ * \param flags Bitwise combination of SPDK_RPC_METHOD_FLAG_* flags.
+ */
+void spdk_rpc_register_method_ext(const char *method, spdk_rpc_method_handler func,
+				  uint32_t state_mask, uint32_t flags);
+
+/**
+ * Install the executor used to run handlers of methods registered with
+ * SPDK_RPC_METHOD_FLAG_CONCURRENT.  The executor is expected to call \b fn
+ * with \b ctx exactly once, on a thread of its choosing.  If no executor is
+ * installed, flagged methods run inline like any other method.
+ *
+ * \param executor Executor function, or NULL to uninstall.
+ */
+void spdk_rpc_set_executor(void (*executor)(void (*fn)(void *ctx), void *ctx));
+
 /**
  * Register a deprecated alias for an RPC method.
  *
@@ -141,6 +171,12 @@ static void __attribute__((constructor(1000))) rpc_register_##func(void) \
 	spdk_rpc_register_method(method, func, state_mask); \
 }
 
+#define SPDK_RPC_REGISTER_EXT(method, func, state_mask, flags) \
+static void __attribute__((constructor(1000))) rpc_register_##func(void) \
+{ \
+	spdk_rpc_register_method_ext(method, func, state_mask, flags); \
+}
+
 #define SPDK_RPC_REGISTER_ALIAS_DEPRECATED(method, alias) \
 static void __attribute__((constructor(1001))) rpc_register_##alias(void) \
 { \
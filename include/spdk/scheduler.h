@@ -149,6 +149,8 @@ struct spdk_scheduler_thread_info {
 	struct spdk_thread_stats total_stats;
 	/* stats during the last scheduling period */
 	struct spdk_thread_stats current_stats;
+	/* hint set with spdk_thread_set_latency_sensitive() */
+	bool latency_sensitive;
 };
 
 /**
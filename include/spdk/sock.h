@@ -188,6 +188,42 @@ struct spdk_sock_impl_opts {
 	 * example: "TLS_AES_256_GCM_SHA384:TLS_AES_128_GCM_SHA256"
 	 */
 	const char *tls_cipher_suites;
+
+	/**
+	 * Enable or disable per-connection adaptation of the zerocopy threshold. When enabled,
+	 * each connection measures its zerocopy completion notification latency against the
+	 * cost of copied sends and adjusts its own threshold online, using zerocopy_threshold
+	 * only as the initial value and lower bound. Used by posix socket module.
+	 */
+	bool enable_dynamic_zerocopy;
+
+	/**
+	 * Maximum pacing rate of the socket in bytes per second, set via
+	 * SO_MAX_PACING_RATE. Limits how fast the kernel drains the socket
+	 * buffer onto the wire, which avoids bufferbloat on shared links.
+	 * A value of 0 disables pacing. Used by posix socket module.
+	 */
+	uint32_t max_pacing_rate;
+
+	/**
+	 * Limit on not-yet-sent bytes queued in the kernel socket buffer, set
+	 * via TCP_NOTSENT_LOWAT. Once the limit is exceeded, sends return
+	 * EAGAIN and queued requests remain in the sock layer, where they can
+	 * still be reordered or aborted. A value of 0 keeps the kernel
+	 * default. Used by posix socket module.
+	 */
+	uint32_t notsent_lowat;
+
+	/**
+	 * Limit on the number of sockets flushed (sendmsg calls) per poll
+	 * group iteration. When more sockets have queued data than the budget
+	 * allows, the ones with the most pending bytes are flushed first and
+	 * the rest are deferred; a socket deferred for several consecutive
+	 * polls is flushed regardless of size so that small connections are
+	 * not starved. A value of 0 flushes every socket on every poll. Used
+	 * by posix socket module.
+	 */
+	uint32_t max_flushes_per_poll;
 };
 
 /**
@@ -214,8 +250,15 @@ struct spdk_sock_opts {
 	 */
 	bool zcopy;
 
-	/* Hole at bytes 13-15. */
-	uint8_t reserved13[3];
+	/**
+	 * Allow multiple listen sockets to bind to the same address and port
+	 * (SO_REUSEPORT), letting the kernel spread incoming connections across
+	 * them. Only used by spdk_sock_listen_ext().
+	 */
+	bool reuse_port;
+
+	/* Hole at bytes 14-15. */
+	uint8_t reserved14[2];
 
 	/**
 	 * Time in msec to wait ack until connection is closed forcefully.
@@ -557,6 +600,63 @@ int spdk_sock_group_remove_sock(struct spdk_sock_group *group, struct spdk_sock
  */
 int spdk_sock_group_provide_buf(struct spdk_sock_group *group, void *buf, size_t len, void *ctx);
 
+/**
+ * Cork the group. Asynchronous writes submitted on member sockets accumulate instead
+ * of being sent eagerly, so that a single send per socket goes out when the group is
+ * uncorked. A socket that accumulates max_bytes is flushed immediately, and the group
+ * is uncorked automatically if it is still corked after max_latency_us, so data is
+ * never held indefinitely.
+ *
+ * \param group Group to cork.
+ * \param max_bytes Per-socket byte cap. 0 uses a default cap.
+ * \param max_latency_us Maximum time the group may stay corked. 0 uses a default cap.
+ */
+void spdk_sock_group_cork(struct spdk_sock_group *group, uint32_t max_bytes,
+			  uint32_t max_latency_us);
+
+/**
+ * Uncork the group, flushing the writes accumulated on each member socket since
+ * spdk_sock_group_cork() in a single send per socket.
+ *
+ * \param group Group to uncork.
+ */
+void spdk_sock_group_uncork(struct spdk_sock_group *group);
+
+/**
+ * Callback invoked when a socket's placement has drifted away from its group.
+ *
+ * The sock layer does not move the socket itself - the owner of the socket
+ * (e.g. the nvmf transport that created the qpair) decides whether and how to
+ * migrate it, typically by removing it from its current group and adding it
+ * to optimal_group from the thread that polls that group.
+ *
+ * \param ctx Context passed to spdk_sock_group_set_rebalance_cb().
+ * \param sock Socket whose placement no longer matches its group.
+ * \param optimal_group Group that currently matches the socket's placement.
+ */
+typedef void (*spdk_sock_group_rebalance_cb)(void *ctx, struct spdk_sock *sock,
+		struct spdk_sock_group *optimal_group);
+
+/**
+ * Periodically re-evaluate the placement of each socket in the group.
+ *
+ * Placement ids derived from the NIC (e.g. SO_INCOMING_NAPI_ID) can change
+ * after the connection is accepted, for example when RSS is rehashed after a
+ * link flap. Every period_us the group re-reads each socket's placement id
+ * and invokes cb_fn for sockets whose optimal group is no longer the group
+ * they are polled by. Only sock implementations that support placement
+ * re-evaluation participate; others are silently skipped.
+ *
+ * \param group Group to monitor.
+ * \param cb_fn Callback to invoke for misplaced sockets. NULL disables
+ * re-evaluation.
+ * \param cb_arg Argument passed to cb_fn.
+ * \param period_us Interval between re-evaluations. 0 uses a default interval.
+ */
+void spdk_sock_group_set_rebalance_cb(struct spdk_sock_group *group,
+				      spdk_sock_group_rebalance_cb cb_fn, void *cb_arg,
+				      uint32_t period_us);
+
 /**
  * Poll incoming events for each registered socket.
  *
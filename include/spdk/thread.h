@@ -276,6 +276,28 @@ void spdk_thread_bind(struct spdk_thread *thread, bool bind);
  */
 bool spdk_thread_is_bound(struct spdk_thread *thread);
 
+/**
+ * Mark a thread as servicing latency-critical work.
+ *
+ * This is a scheduling hint.  Schedulers that support it will avoid placing
+ * latency-sensitive threads on cores that also run busy threads without the
+ * hint (e.g. background garbage collection).  It has no effect on thread
+ * execution itself.
+ *
+ * \param thread The thread to mark.
+ * \param latency_sensitive true to set the hint, false to clear it.
+ */
+void spdk_thread_set_latency_sensitive(struct spdk_thread *thread, bool latency_sensitive);
+
+/**
+ * Returns whether the thread is marked as latency-sensitive.
+ *
+ * \param thread The thread to query.
+ *
+ * \return true if latency-sensitive, false otherwise
+ */
+bool spdk_thread_is_latency_sensitive(struct spdk_thread *thread);
+
 /**
  * Mark the thread as exited, failing all future spdk_thread_send_msg(),
  * spdk_poller_register(), and spdk_get_io_channel() calls. May only be called
@@ -475,6 +497,18 @@ struct spdk_thread *spdk_thread_get_by_id(uint64_t id);
 struct spdk_thread_stats {
 	uint64_t busy_tsc;
 	uint64_t idle_tsc;
+	/* Messages sent to other threads as part of a multi-message ring enqueue. */
+	uint64_t batched_msg_sends;
+	/* Messages sent to other threads with a single-message ring enqueue. */
+	uint64_t single_msg_sends;
+	/* Poller runs that reported work done (returned a positive value). */
+	uint64_t busy_poller_runs;
+	/* Times a poller was skipped for one iteration after exhausting its
+	 * work budget (see spdk_poller_set_budget()). */
+	uint64_t poller_deferrals;
+	/* Times a timed poller became runnable more than a full period past
+	 * its deadline. */
+	uint64_t poller_overruns;
 };
 
 /**
@@ -486,6 +520,84 @@ struct spdk_thread_stats {
  */
 int spdk_thread_get_stats(struct spdk_thread_stats *stats);
 
+/* Layout version of the shared-memory stats segment */
+#define SPDK_THREAD_STATS_SHM_VERSION		1
+/* Thread and poller names longer than this are truncated in the segment */
+#define SPDK_THREAD_STATS_SHM_NAME_LEN		64
+/* Number of poller slots published per thread */
+#define SPDK_THREAD_STATS_SHM_MAX_POLLERS	64
+
+struct spdk_thread_shm_poller_stats {
+	char		name[SPDK_THREAD_STATS_SHM_NAME_LEN];
+	uint64_t	id;
+	uint64_t	period_ticks;
+	uint64_t	run_count;
+	uint64_t	busy_count;
+	uint64_t	busy_tsc;
+};
+
+struct spdk_thread_shm_thread_stats {
+	/* ID of the thread owning the slot, or 0 if the slot is unused */
+	uint64_t	id;
+	char		name[SPDK_THREAD_STATS_SHM_NAME_LEN];
+	uint64_t	busy_tsc;
+	uint64_t	idle_tsc;
+	/* Sequence counter protecting the poller table below.  It is odd while
+	 * the owning thread is rewriting the table - readers should check it
+	 * before and after copying the table and retry if it changed or is odd.
+	 */
+	uint64_t	poller_seq;
+	uint64_t	num_pollers;
+	struct spdk_thread_shm_poller_stats	pollers[SPDK_THREAD_STATS_SHM_MAX_POLLERS];
+};
+
+/**
+ * Header of the shared-memory stats segment published by
+ * spdk_thread_stats_shm_init().  Monitoring tools mmap() the segment read-only
+ * and consume the counters without issuing any RPCs to the target.  Readers
+ * must verify the version before interpreting the rest of the segment.
+ */
+struct spdk_thread_stats_shm {
+	uint64_t	version;
+	uint64_t	tsc_rate;
+	uint64_t	max_threads;
+	struct spdk_thread_shm_thread_stats	threads[];
+};
+
+/**
+ * Start publishing per-thread and per-poller statistics into a shared-memory
+ * segment.
+ *
+ * Each thread updates its slot at the end of every spdk_thread_poll()
+ * iteration (busy/idle counters) and republishes its poller table at most once
+ * per second, so monitoring tools can read the statistics without perturbing
+ * the threads they measure.
+ *
+ * \param shm_name Name of the shared-memory segment to create.  If NULL,
+ * "/spdk_thread_stats.pid<pid>" is used.
+ * \param max_threads Number of thread slots to allocate in the segment, or 0
+ * for the default.
+ *
+ * \return 0 on success, negated errno on failure.
+ */
+int spdk_thread_stats_shm_init(const char *shm_name, uint32_t max_threads);
+
+/**
+ * Stop publishing statistics, unmap and unlink the shared-memory segment.
+ *
+ * Must not be called while threads are still being polled - it is intended to
+ * be called during application shutdown (spdk_thread_lib_fini() calls it
+ * automatically).
+ */
+void spdk_thread_stats_shm_fini(void);
+
+/**
+ * Get the name of the shared-memory stats segment.
+ *
+ * \return Segment name, or NULL if spdk_thread_stats_shm_init() was not called.
+ */
+const char *spdk_thread_stats_shm_get_name(void);
+
 /**
  * Return the TSC value from the end of the last time this thread was polled.
  *
@@ -646,10 +758,51 @@ void spdk_poller_pause(struct spdk_poller *poller);
  * Resumes a poller paused with spdk_poller_pause().  It is perfectly fine to
  * resume an unpaused poller.
  *
+ * Resuming also promotes a poller that was demoted to its idle backoff period
+ * (see spdk_poller_set_idle_backoff()) back to running every iteration, so an
+ * event source may use it to signal that a consistently-idle poller has work
+ * again.
+ *
  * \param poller The poller to resume.
  */
 void spdk_poller_resume(struct spdk_poller *poller);
 
+/**
+ * Set an idle-backoff policy on a poller registered without a period.
+ *
+ * After idle_threshold consecutive idle returns, the poller stops running on
+ * every thread iteration and is instead run every backoff_period_microseconds.
+ * It returns to running on every iteration as soon as it reports busy, or when
+ * spdk_poller_resume() is called on it.  This keeps the hot per-iteration loop
+ * down to the pollers that are actually doing work.
+ *
+ * Passing 0 for idle_threshold or backoff_period_microseconds disables the
+ * policy and restores the poller to every iteration.
+ *
+ * \param poller A poller registered with period_microseconds set to 0.
+ * \param idle_threshold Number of consecutive idle returns before backing off.
+ * \param backoff_period_microseconds Polling period while backed off.
+ */
+void spdk_poller_set_idle_backoff(struct spdk_poller *poller, uint32_t idle_threshold,
+				  uint64_t backoff_period_microseconds);
+
+/**
+ * Set a per-iteration work budget on a poller.
+ *
+ * The positive values a poller returns accumulate as its work done.  Once they
+ * reach the budget, the poller is skipped for exactly one thread iteration and
+ * its accumulator resets, giving the other pollers on the thread a turn before
+ * a single deep queue monopolizes the reactor.  The poller's callback should
+ * return its amount of work in the unit the budget is expressed in, e.g. the
+ * number of completions drained.
+ *
+ * Passing 0 for budget disables the policy.
+ *
+ * \param poller The poller to set the budget on.
+ * \param budget Work units allowed per iteration, or 0 to disable.
+ */
+void spdk_poller_set_budget(struct spdk_poller *poller, uint64_t budget);
+
 /**
  * Register the opaque io_device context as an I/O device.
  *
@@ -765,6 +918,26 @@ struct spdk_thread *spdk_io_channel_get_thread(struct spdk_io_channel *ch);
 void spdk_for_each_channel(void *io_device, spdk_channel_msg fn, void *ctx,
 			   spdk_channel_for_each_cpl cpl);
 
+/**
+ * Call 'fn' on each channel associated with io_device, in parallel.
+ *
+ * Unlike spdk_for_each_channel(), 'fn' is sent to every channel's thread at
+ * once, so calls to 'fn' may overlap in time and a non-zero status passed to
+ * spdk_for_each_channel_continue() does not stop the iteration - the remaining
+ * channels are still visited and 'cpl' receives one of the failing statuses.
+ * Use this for operations that do not depend on visiting channels one at a
+ * time, e.g. gathering per-channel statistics.
+ *
+ * \param io_device 'fn' will be called on each channel associated with this io_device.
+ * \param fn Called on the appropriate thread for each channel associated with io_device.
+ * \param ctx Context buffer registered to spdk_io_channel_iter that can be obtained
+ * form the function spdk_io_channel_iter_get_ctx().
+ * \param cpl Called on the thread that spdk_for_each_channel_parallel was initially
+ * called from when 'fn' has been called on each channel.
+ */
+void spdk_for_each_channel_parallel(void *io_device, spdk_channel_msg fn, void *ctx,
+				    spdk_channel_for_each_cpl cpl);
+
 /**
  * Get io_device from the I/O channel iterator.
  *
@@ -1000,6 +1173,35 @@ struct spdk_iobuf_opts {
 	 */
 	size_t opts_size;
 
+	/**
+	 * Allocate the backing pools per NUMA node and select them based on the
+	 * locality of the thread initializing an iobuf channel.
+	 */
+	bool enable_numa;
+
+	/**
+	 * Period, in microseconds, of the per-thread poller that migrates cache
+	 * credits from idle iobuf channels to channels that had to fall through
+	 * to the shared pool.  0 disables rebalancing.
+	 */
+	uint32_t cache_rebalance_period_us;
+
+	/**
+	 * Maximum number of small buffers the pool can be grown to at runtime
+	 * with spdk_iobuf_pool_grow().  The shared pool rings are sized for
+	 * this count up front.  0 disables runtime growth of the small pool.
+	 */
+	uint64_t small_pool_max_count;
+	/** Same as small_pool_max_count, for the large pool. */
+	uint64_t large_pool_max_count;
+
+	/**
+	 * Idle period, in microseconds, after which a channel's cached buffers
+	 * are returned to the shared pool.  The cache credits are kept, so the
+	 * cache refills from the pool once the channel becomes active again.
+	 * 0 disables idle reclaim.
+	 */
+	uint32_t cache_idle_reclaim_us;
 };
 
 struct spdk_iobuf_pool_stats {
@@ -1009,6 +1211,10 @@ struct spdk_iobuf_pool_stats {
 	uint64_t	main;
 	/** Buffer missed and request to get buffer was queued */
 	uint64_t	retry;
+	/** Buffers currently held in per-thread caches */
+	uint64_t	cache_count;
+	/** Configured per-thread cache capacity */
+	uint64_t	cache_size;
 };
 
 struct spdk_iobuf_module_stats {
@@ -1098,6 +1304,45 @@ int spdk_iobuf_set_opts(const struct spdk_iobuf_opts *opts);
  */
 void spdk_iobuf_get_opts(struct spdk_iobuf_opts *opts, size_t opts_size);
 
+/**
+ * Grow the shared iobuf pools at runtime by allocating additional buffers and
+ * adding them to the backing pools.  The new buffers come from hugepage memory
+ * mapped on demand, so the pools can be expanded without restarting the
+ * application, as long as small_pool_max_count/large_pool_max_count left
+ * enough headroom in the pool rings.
+ *
+ * \param small_pool_count Number of small buffers to add.  0 leaves the small
+ * pool unchanged.
+ * \param large_pool_count Number of large buffers to add.  0 leaves the large
+ * pool unchanged.
+ * \param numa_node NUMA node to allocate the new buffers on, or
+ * SPDK_ENV_SOCKET_ID_ANY to spread them across all nodes the pools were
+ * created on.
+ *
+ * \return 0 on success, -ENOSPC if the pool rings have no headroom left,
+ * negative errno otherwise.
+ */
+int spdk_iobuf_pool_grow(uint64_t small_pool_count, uint64_t large_pool_count, int32_t numa_node);
+
+/**
+ * Shrink the shared iobuf pools at runtime by freeing buffers previously added
+ * with spdk_iobuf_pool_grow().  Memory is released at the granularity of the
+ * chunks the pools were grown by, and only chunks whose buffers are all sitting
+ * idle in the shared pool can be freed; buffers that are in use or held in
+ * per-thread caches stay put.  The initial pools are never freed.
+ *
+ * \param small_pool_count Maximum number of small buffers to remove.  0 leaves
+ * the small pool unchanged.
+ * \param large_pool_count Maximum number of large buffers to remove.  0 leaves
+ * the large pool unchanged.
+ * \param numa_node NUMA node to free buffers on, or SPDK_ENV_SOCKET_ID_ANY to
+ * consider all nodes.
+ *
+ * \return 0 if any buffers were freed, -EBUSY if a nonzero shrink was requested
+ * but no chunk could be freed, negative errno otherwise.
+ */
+int spdk_iobuf_pool_shrink(uint64_t small_pool_count, uint64_t large_pool_count, int32_t numa_node);
+
 /**
  * Register a module as an iobuf pool user.  Only registered users can request buffers from the
  * iobuf pool.
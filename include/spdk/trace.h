@@ -108,6 +108,14 @@ struct spdk_trace_history {
 	 */
 	uint64_t			tpoint_count[SPDK_TRACE_MAX_TPOINT_ID];
 
+	/**
+	 * Running count of tracepoint occurrences per tpoint group on this
+	 *  lcore, used to select which occurrences to record when a sampling
+	 *  rate is set for the group.  Unlike the recorded entries,
+	 *  tpoint_count above always counts every occurrence.
+	 */
+	uint64_t			sample_count[SPDK_TRACE_MAX_GROUP_ID];
+
 	/** Index to next spdk_trace_entry to fill. */
 	uint64_t			next_entry;
 
@@ -126,6 +134,13 @@ struct spdk_trace_file {
 	uint64_t			file_size;
 	uint64_t			tsc_rate;
 	uint64_t			tpoint_mask[SPDK_TRACE_MAX_GROUP_ID];
+
+	/**
+	 * Sampling rate of each tpoint group.  When set to N > 1, only every
+	 *  Nth occurrence of an enabled tracepoint from the group is recorded.
+	 *  0 and 1 both mean that every occurrence is recorded.
+	 */
+	uint64_t			sample_rate[SPDK_TRACE_MAX_GROUP_ID];
 	char				tname[SPDK_TRACE_MAX_LCORE][SPDK_TRACE_THREAD_NAME_LEN];
 	struct spdk_trace_owner_type	owner_type[SPDK_TRACE_MAX_OWNER_TYPE];
 	struct spdk_trace_object	object[UCHAR_MAX + 1];
@@ -148,6 +163,33 @@ struct spdk_trace_file {
 };
 extern struct spdk_trace_file *g_trace_file;
 
+#define SPDK_TRACE_INDEX_MAGIC 0x5844494543415254ULL /* "TRACEIDX" */
+
+/** Interval, in trace entries, between consecutive index footer tsc samples. */
+#define SPDK_TRACE_INDEX_STRIDE 4096
+
+struct spdk_trace_index_lcore {
+	/** Number of tsc samples for this lcore, 0 if the lcore has no history. */
+	uint64_t			num_samples;
+	/** Offset of this lcore's samples from the beginning of the footer. */
+	uint64_t			sample_offset;
+};
+
+/**
+ * Optional time index appended past file_size bytes by tools recording trace
+ *  files.  Sample i of an lcore is the tsc of entry i * stride of its trace
+ *  history, which allows readers to seek to a time range without scanning the
+ *  whole file.  Readers that predate the index ignore everything past
+ *  file_size.
+ */
+struct spdk_trace_index_footer {
+	/** Must be SPDK_TRACE_INDEX_MAGIC. */
+	uint64_t			magic;
+	/** Interval, in trace entries, between consecutive tsc samples. */
+	uint64_t			stride;
+	struct spdk_trace_index_lcore	lcores[SPDK_TRACE_MAX_LCORE];
+};
+
 static inline uint64_t
 spdk_get_trace_history_size(uint64_t num_entries)
 {
@@ -294,6 +336,26 @@ void spdk_trace_set_tpoint_group_mask(uint64_t tpoint_group_mask);
  */
 void spdk_trace_clear_tpoint_group_mask(uint64_t tpoint_group_mask);
 
+/**
+ * Get the current sampling rate of the given tpoint group.
+ *
+ * \param group_id Tpoint group id associated with the sampling rate.
+ *
+ * \return current sampling rate, 0 if sampling is disabled.
+ */
+uint64_t spdk_trace_get_sample_rate(uint32_t group_id);
+
+/**
+ * Set the sampling rate for the given tpoint group. When set to N > 1, only
+ * every Nth occurrence of an enabled tracepoint from the group is recorded.
+ * Pass 0 or 1 to record every occurrence again. The rate may be adjusted at
+ * runtime while tracing is active.
+ *
+ * \param group_id Tpoint group id associated with the sampling rate.
+ * \param rate Record one in every \b rate occurrences.
+ */
+void spdk_trace_set_sample_rate(uint32_t group_id, uint64_t rate);
+
 /**
  * Initialize the trace environment. Debug tool can read the information from
  * the given shared memory to post-process the tpoint entries and display in a
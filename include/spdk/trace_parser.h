@@ -35,12 +35,18 @@ struct spdk_trace_parser_opts {
 	int		mode;
 	/** Logical core number to parse the traces from (or SPDK_TRACE_MAX_LCORE) for all cores */
 	uint16_t	lcore;
+	/** Only include entries recorded at or after this tsc, 0 for no lower bound.  When the
+	 *  trace file carries an index footer, it is used to seek close to this timestamp without
+	 *  scanning the preceding entries. */
+	uint64_t	tsc_start;
+	/** Only include entries recorded at or before this tsc, 0 for no upper bound */
+	uint64_t	tsc_end;
 };
 
 /**
- * Initialize the parser using a specified trace file.  This results in parsing the traces, merging
- * entries from multiple cores together and sorting them by their tsc, so it can take a significant
- * amount of time to complete.
+ * Initialize the parser using a specified trace file.  This results in parsing the traces of each
+ * core in parallel and merging them together by their tsc, so it can take a significant amount of
+ * time to complete.
  *
  * \param opts Describes the trace file to parse.
  *
@@ -50,6 +50,15 @@ struct spdk_lw_thread {
  */
 typedef void (*spdk_reactor_set_interrupt_mode_cb)(void *cb_arg);
 
+enum spdk_reactor_hybrid_mode {
+	/* Follow the framework-wide hybrid interrupt setting. */
+	SPDK_REACTOR_HYBRID_MODE_DEFAULT = 0,
+	/* Auto-switch this reactor regardless of the framework setting. */
+	SPDK_REACTOR_HYBRID_MODE_ENABLED,
+	/* Never auto-switch this reactor. */
+	SPDK_REACTOR_HYBRID_MODE_DISABLED,
+};
+
 struct spdk_reactor {
 	/* Lightweight threads running on this reactor */
 	TAILQ_HEAD(, spdk_lw_thread)			threads;
@@ -86,6 +95,16 @@ struct spdk_reactor {
 
 	struct spdk_fd_group				*fgrp;
 	int						resched_fd;
+
+	/* Automatic interrupt/poll hybrid switching */
+	enum spdk_reactor_hybrid_mode			hybrid_mode;
+	bool						hybrid_switch_pending;
+	bool						hybrid_target_in_interrupt;
+	uint32_t					hybrid_idle_periods;
+	uint64_t					hybrid_eval_tsc;
+	uint64_t					hybrid_prev_busy_tsc;
+	uint64_t					hybrid_prev_idle_tsc;
+	uint64_t					hybrid_wakeups;
 } __attribute__((aligned(SPDK_CACHE_LINE_SIZE)));
 
 int spdk_reactors_init(size_t msg_mempool_size);
@@ -128,6 +147,17 @@ void spdk_for_each_reactor(spdk_event_fn fn, void *arg1, void *arg2, spdk_event_
 int spdk_reactor_set_interrupt_mode(uint32_t lcore, bool new_in_interrupt,
 				    spdk_reactor_set_interrupt_mode_cb cb_fn, void *cb_arg);
 
+/**
+ * Override the framework-wide hybrid interrupt setting for one reactor.
+ *
+ * \param lcore Logical core of the reactor.
+ * \param mode Per-reactor hybrid switching mode.
+ *
+ * \return 0 on success, -EINVAL if the reactor does not exist or -ENOTSUP if
+ * the reactor cannot run in interrupt mode.
+ */
+int spdk_reactor_set_hybrid_interrupt_mode(uint32_t lcore, enum spdk_reactor_hybrid_mode mode);
+
 #ifdef __cplusplus
 }
 #endif
@@ -10,10 +10,23 @@
 
 struct spdk_json_write_ctx;
 
+enum spdk_subsystem_state {
+	SPDK_SUBSYSTEM_UNINITIALIZED = 0,
+	SPDK_SUBSYSTEM_INITIALIZING,
+	SPDK_SUBSYSTEM_INITIALIZED,
+};
+
 struct spdk_subsystem {
 	const char *name;
-	/* User must call spdk_subsystem_init_next() when they are done with their initialization. */
+	/* User must call spdk_subsystem_init_next() when they are done with their initialization.
+	 * Only one init() is outstanding at a time, so subsystems using this handler initialize
+	 * serially with respect to each other. */
 	void (*init)(void);
+	/* Alternative to init.  Subsystems using this handler may initialize concurrently with
+	 * any other subsystem they have no (transitive) dependency relation with - only their
+	 * SPDK_SUBSYSTEM_DEPEND() edges order them.  User must call spdk_subsystem_init_done()
+	 * with the provided subsystem pointer when they are done with their initialization. */
+	void (*init_async)(struct spdk_subsystem *subsystem);
 	void (*fini)(void);
 
 	/**
@@ -23,6 +36,8 @@ struct spdk_subsystem {
 	 */
 	void (*write_config_json)(struct spdk_json_write_ctx *w);
 	TAILQ_ENTRY(spdk_subsystem) tailq;
+	/* Initialization progress, managed by lib/init. */
+	enum spdk_subsystem_state state;
 };
 
 struct spdk_subsystem_depend {
@@ -35,6 +50,7 @@ void spdk_add_subsystem(struct spdk_subsystem *subsystem);
 void spdk_add_subsystem_depend(struct spdk_subsystem_depend *depend);
 
 void spdk_subsystem_init_next(int rc);
+void spdk_subsystem_init_done(struct spdk_subsystem *subsystem, int rc);
 void spdk_subsystem_fini_next(void);
 
 /**
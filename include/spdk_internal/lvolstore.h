@@ -46,6 +46,30 @@ struct spdk_lvol_req {
 	char			name[SPDK_LVOL_NAME_MAX];
 };
 
+struct spdk_lvol_bulk_destroy_req {
+	spdk_lvol_op_complete	cb_fn;
+	void			*cb_arg;
+	size_t			count;
+	struct spdk_lvol	**lvols;
+	/* Per lvol, only set when the lvol is a snapshot with a single clone. */
+	struct spdk_lvol	**clone_lvols;
+	spdk_blob_id		*blob_ids;
+};
+
+struct spdk_lvol_bulk_clone_req {
+	spdk_lvol_op_complete	cb_fn;
+	void			*cb_arg;
+	struct spdk_lvol_store	*lvs;
+	size_t			count;
+	/* Number of created blobs that have been opened and bound to their lvols. */
+	size_t			opened;
+	struct spdk_lvol	**lvols;
+	spdk_blob_id		*blob_ids;
+	struct spdk_blob_xattr_opts *xattrs;
+	char			*xattr_names[2];
+	int			lvolerrno;
+};
+
 struct spdk_lvol_copy_req {
 	spdk_lvol_op_complete	cb_fn;
 	void			*cb_arg;
@@ -92,6 +92,18 @@ enum spdk_rdma_memory_map_role {
 	SPDK_RDMA_MEMORY_MAP_ROLE_INITIATOR
 };
 
+/* Provider specific, may poll completions directly from the CQE buffer */
+struct spdk_rdma_cq;
+
+struct spdk_rdma_cq_init_attr {
+	struct ibv_context	*context;
+	/* Minimal number of entries, the actual CQ size may be bigger */
+	int			cqe;
+	void			*cq_context;
+	struct ibv_comp_channel	*comp_channel;
+	int			comp_vector;
+};
+
 /**
  * Create RDMA SRQ
  *
@@ -127,6 +139,51 @@ bool spdk_rdma_srq_queue_recv_wrs(struct spdk_rdma_srq *rdma_srq, struct ibv_rec
  */
 int spdk_rdma_srq_flush_recv_wrs(struct spdk_rdma_srq *rdma_srq, struct ibv_recv_wr **bad_wr);
 
+/**
+ * Create RDMA provider specific completion queue
+ *
+ * \param cq_attr Pointer to CQ init attributes
+ * \return Pointer to a newly created CQ on success or NULL on failure. errno is updated in failure case
+ */
+struct spdk_rdma_cq *spdk_rdma_cq_create(struct spdk_rdma_cq_init_attr *cq_attr);
+
+/**
+ * Destroy RDMA provider specific completion queue
+ *
+ * \param rdma_cq Pointer to CQ
+ */
+void spdk_rdma_cq_destroy(struct spdk_rdma_cq *rdma_cq);
+
+/**
+ * Resize RDMA provider specific completion queue
+ *
+ * \param rdma_cq Pointer to CQ
+ * \param cqe New minimal number of entries
+ * \return 0 on success, errno on failure
+ */
+int spdk_rdma_cq_resize(struct spdk_rdma_cq *rdma_cq, int cqe);
+
+/**
+ * Poll a batch of Work Completions
+ *
+ * A provider may implement this function on top of direct access to the CQE buffer
+ * instead of ibv_poll_cq
+ *
+ * \param rdma_cq Pointer to CQ
+ * \param num_entries Size of the \b wc array
+ * \param wc Array of Work Completions to be filled by this function
+ * \return Number of polled completions (may be 0) on success, negative errno on failure
+ */
+int spdk_rdma_cq_poll(struct spdk_rdma_cq *rdma_cq, int num_entries, struct ibv_wc *wc);
+
+/**
+ * Get the ibv_cq used by the provider, e.g. to fill qpair init attributes
+ *
+ * \param rdma_cq Pointer to CQ
+ * \return Pointer to ibv_cq
+ */
+struct ibv_cq *spdk_rdma_cq_get_ibv_cq(struct spdk_rdma_cq *rdma_cq);
+
 /**
  * Create RDMA provider specific qpair
  *
@@ -242,6 +299,37 @@ void spdk_rdma_free_mem_map(struct spdk_rdma_mem_map **map);
 int spdk_rdma_get_translation(struct spdk_rdma_mem_map *map, void *address,
 			      size_t length, struct spdk_rdma_memory_translation *translation);
 
+/* Default pin budget for Memory Regions registered on demand for memory that is
+ * not part of the SPDK memory map, e.g. application-owned buffers
+ */
+#define SPDK_RDMA_DEF_MR_CACHE_SIZE (64 * 1024 * 1024)
+
+/**
+ * Set the maximum number of bytes that may stay pinned by Memory Regions registered
+ * on demand for memory outside of the SPDK memory map. Such registrations are cached
+ * per memory map and deregistered lazily, in least recently used order, once the
+ * budget is exceeded. The budget must be large enough that registrations for
+ * in-flight IO are never evicted. Setting the size to 0 disables on demand
+ * registration, translation of unregistered memory then fails with -EINVAL.
+ *
+ * \param size_bytes Pin budget in bytes, SPDK_RDMA_DEF_MR_CACHE_SIZE by default
+ */
+void spdk_rdma_set_mr_cache_size(uint64_t size_bytes);
+
+/**
+ * Register all unregistered elements of an IO vector in one pass and cache the
+ * Memory Regions, so that subsequent per-element calls to \b spdk_rdma_get_translation
+ * do not pay the registration cost.
+ *
+ * \param map Pointer to translation map
+ * \param iovs IO vector to register
+ * \param iovcnt Number of elements in \b iovs
+ * \retval -EINVAL if a registration failed
+ * \retval 0 all elements are registered
+ */
+int spdk_rdma_mem_map_register_iovs(struct spdk_rdma_mem_map *map, struct iovec *iovs,
+				    int iovcnt);
+
 /**
  * Helper function for retrieving Local Memory Key. Should be applied to a translation
  * returned by \b spdk_rdma_get_translation
@@ -41,6 +41,7 @@ struct spdk_sock {
 	TAILQ_HEAD(, spdk_sock_request)	pending_reqs;
 	struct spdk_sock_request	*read_req;
 	int				queued_iovcnt;
+	uint64_t			queued_bytes;
 	int				cb_cnt;
 	spdk_sock_cb			cb_fn;
 	void				*cb_arg;
@@ -61,6 +62,15 @@ struct spdk_sock_group {
 	STAILQ_HEAD(, spdk_sock_group_impl)	group_impls;
 	STAILQ_HEAD(, spdk_sock_group_provided_buf) pool;
 	void					*ctx;
+	/* While corked, writes on member sockets are held until spdk_sock_group_uncork(),
+	 * the per-socket byte cap is reached, or the latency cap expires. */
+	bool					corked;
+	uint32_t				cork_max_bytes;
+	uint64_t				cork_deadline_tsc;
+	spdk_sock_group_rebalance_cb		rebalance_cb;
+	void					*rebalance_ctx;
+	uint64_t				rebalance_period_tsc;
+	uint64_t				rebalance_next_tsc;
 };
 
 struct spdk_sock_group_impl {
@@ -103,6 +113,10 @@ struct spdk_net_impl {
 
 	struct spdk_sock_group_impl *(*group_impl_get_optimal)(struct spdk_sock *sock,
 			struct spdk_sock_group_impl *hint);
+	/* Optional. Re-read the socket's placement id from the kernel and update the
+	 * placement map. Returns 1 if the placement id changed, 0 if unchanged, negated
+	 * errno on failure. */
+	int (*refresh_placement_id)(struct spdk_sock *sock);
 	struct spdk_sock_group_impl *(*group_impl_create)(void);
 	int (*group_impl_add_sock)(struct spdk_sock_group_impl *group, struct spdk_sock *sock);
 	int (*group_impl_remove_sock)(struct spdk_sock_group_impl *group, struct spdk_sock *sock);
@@ -133,17 +147,37 @@ static void __attribute__((constructor)) net_impl_register_default_##name(void)
 
 size_t spdk_sock_group_get_buf(struct spdk_sock_group *group, void **buf, void **ctx);
 
+/* Returns true if the sock belongs to a group that is currently corked. Sock modules
+ * should then hold queued writes until the group is uncorked, unless the socket has
+ * already accumulated cork_max_bytes. */
+static inline bool
+spdk_sock_group_is_corked(struct spdk_sock *sock)
+{
+	struct spdk_sock_group_impl *group_impl = sock->group_impl;
+
+	return group_impl != NULL && group_impl->group != NULL && group_impl->group->corked;
+}
+
+static inline uint64_t
+spdk_sock_request_len(struct spdk_sock_request *req)
+{
+	uint64_t len = 0;
+	int i;
+
+	for (i = 0; i < req->iovcnt; i++) {
+		len += SPDK_SOCK_REQUEST_IOV(req, i)->iov_len;
+	}
+
+	return len;
+}
+
 static inline void
 spdk_sock_request_queue(struct spdk_sock *sock, struct spdk_sock_request *req)
 {
+	uint64_t len = spdk_sock_request_len(req);
+
 	assert(req->internal.curr_list == NULL);
 	if (spdk_trace_tpoint_enabled(TRACE_SOCK_REQ_QUEUE)) {
-		uint64_t len = 0;
-		int i;
-
-		for (i = 0; i < req->iovcnt; i++) {
-			len += SPDK_SOCK_REQUEST_IOV(req, i)->iov_len;
-		}
 		spdk_trace_record(TRACE_SOCK_REQ_QUEUE, 0, len, (uintptr_t)req, (uintptr_t)req->cb_arg);
 	}
 	TAILQ_INSERT_TAIL(&sock->queued_reqs, req, internal.link);
@@ -151,16 +185,21 @@ spdk_sock_request_queue(struct spdk_sock *sock, struct spdk_sock_request *req)
 	req->internal.curr_list = &sock->queued_reqs;
 #endif
 	sock->queued_iovcnt += req->iovcnt;
+	sock->queued_bytes += len;
 }
 
 static inline void
 spdk_sock_request_pend(struct spdk_sock *sock, struct spdk_sock_request *req)
 {
+	uint64_t len = spdk_sock_request_len(req);
+
 	assert(req->internal.curr_list == &sock->queued_reqs);
 	spdk_trace_record(TRACE_SOCK_REQ_PEND, 0, 0, (uintptr_t)req, (uintptr_t)req->cb_arg);
 	TAILQ_REMOVE(&sock->queued_reqs, req, internal.link);
 	assert(sock->queued_iovcnt >= req->iovcnt);
 	sock->queued_iovcnt -= req->iovcnt;
+	assert(sock->queued_bytes >= len);
+	sock->queued_bytes -= len;
 	TAILQ_INSERT_TAIL(&sock->pending_reqs, req, internal.link);
 #ifdef DEBUG
 	req->internal.curr_list = &sock->pending_reqs;
@@ -236,6 +275,7 @@ spdk_sock_abort_requests(struct spdk_sock *sock)
 
 		assert(sock->queued_iovcnt >= req->iovcnt);
 		sock->queued_iovcnt -= req->iovcnt;
+		sock->queued_bytes -= spdk_sock_request_len(req);
 
 		req->cb_fn(req->cb_arg, -ECANCELED);
 
@@ -14,6 +14,14 @@ struct spdk_poller;
 struct spdk_poller_stats {
 	uint64_t	run_count;
 	uint64_t	busy_count;
+	/* Cycles spent in busy runs of this poller.  Only accumulated while
+	 * poller cycle tracking is enabled.
+	 */
+	uint64_t	busy_tsc;
+	/* One-iteration skips taken after the work budget was exhausted. */
+	uint64_t	defer_count;
+	/* Times this timed poller became runnable more than a period late. */
+	uint64_t	overrun_count;
 };
 
 struct io_device;
@@ -25,6 +33,19 @@ const char *spdk_poller_get_state_str(struct spdk_poller *poller);
 uint64_t spdk_poller_get_period_ticks(struct spdk_poller *poller);
 void spdk_poller_get_stats(struct spdk_poller *poller, struct spdk_poller_stats *stats);
 
+/**
+ * Enable or disable per-poller cycle accounting on all threads.
+ *
+ * When enabled, every busy poller run costs two additional tick reads, so this
+ * is meant for schedulers that need to attribute core load to individual
+ * pollers rather than for always-on use.
+ *
+ * \param enabled True to enable, false to disable.
+ */
+void spdk_thread_enable_poller_cycle_tracking(bool enabled);
+
+bool spdk_thread_poller_cycle_tracking_enabled(void);
+
 const char *spdk_io_channel_get_io_device_name(struct spdk_io_channel *ch);
 int spdk_io_channel_get_ref_count(struct spdk_io_channel *ch);
 
@@ -19,6 +19,7 @@
 #include "spdk/thread.h"
 #include "spdk/pci_ids.h"
 #include "spdk/env.h"
+#include "spdk/util.h"
 
 /**
  * The maximum virtqueue size is 2^15. Use that value as the end of
@@ -101,11 +102,39 @@ struct virtio_dev_ops {
 struct vq_desc_extra {
 	void *cookie;
 	uint16_t ndescs;
+	/** Next free buffer id. Only used by packed rings, where buffer ids
+	 *  are allocated separately from the descriptor ring slots.
+	 */
+	uint16_t next;
 };
 
 struct virtqueue {
 	struct virtio_dev *vdev; /**< owner of this virtqueue */
 	struct vring vq_ring;  /**< vring keeping desc, used and avail */
+
+	/** Packed (VIRTIO_F_RING_PACKED) ring state. Unused for split rings. */
+	struct {
+		/** Descriptor ring, serves both the driver and the device. */
+		struct vring_packed_desc *desc;
+		/** Driver event suppression structure. */
+		struct vring_packed_desc_event *driver_event;
+		/** Device event suppression structure. */
+		struct vring_packed_desc_event *device_event;
+
+		/** Ring slot of the first descriptor of the current request. */
+		uint16_t head_idx;
+		/** Deferred flags of the first descriptor of the current request,
+		 *  written only once the whole request is ready.
+		 */
+		uint16_t head_flags;
+		/** Driver ring wrap counter, equals avail_wrap_counter in the spec. */
+		bool avail_phase;
+		/** Device ring wrap counter, equals used_wrap_counter in the spec. */
+		bool used_phase;
+		/** True if VIRTIO_F_RING_PACKED has been negotiated for this queue. */
+		bool packed_ring;
+	} vq_packed;
+
 	/**
 	 * Last consumed descriptor in the used table,
 	 * trails vq_ring.used->idx.
@@ -395,6 +424,58 @@ virtio_dev_has_feature(struct virtio_dev *vdev, uint64_t bit)
 	return !!(vdev->negotiated_features & (1ULL << bit));
 }
 
+/**
+ * Calculate the memory size occupied by the vring of given virtqueue,
+ * including the alignment padding between the ring parts. For split rings
+ * this matches vring_size(); for packed rings it covers the descriptor
+ * ring followed by the driver and device event suppression structures.
+ *
+ * \param vq virtqueue with vq_nentries and the ring layout already set
+ * \param align vring alignment
+ */
+static inline size_t
+virtio_vring_size(struct virtqueue *vq, unsigned long align)
+{
+	if (vq->vq_packed.packed_ring) {
+		return SPDK_ALIGN_CEIL(vq->vq_nentries * sizeof(struct vring_packed_desc), align) +
+		       2 * sizeof(struct vring_packed_desc_event);
+	}
+
+	return vring_size(vq->vq_nentries, align);
+}
+
+/**
+ * Calculate the addresses of the three vring parts laid out at given base
+ * address. For split rings these are the descriptor table, the available
+ * ring and the used ring. For packed rings these are the descriptor ring
+ * and the driver and device event suppression structures, which transports
+ * pass through the same desc/avail/used registers or message fields.
+ *
+ * \param vq virtqueue with vq_nentries and the ring layout already set
+ * \param base virtual or physical base address of the ring memory
+ * \param align vring alignment
+ * \param desc_addr output address of the descriptor table/ring
+ * \param avail_addr output address of the available ring (split) or the
+ * driver event suppression structure (packed)
+ * \param used_addr output address of the used ring (split) or the device
+ * event suppression structure (packed)
+ */
+static inline void
+virtio_vring_addrs(struct virtqueue *vq, uint64_t base, unsigned long align,
+		   uint64_t *desc_addr, uint64_t *avail_addr, uint64_t *used_addr)
+{
+	*desc_addr = base;
+	if (vq->vq_packed.packed_ring) {
+		*avail_addr = SPDK_ALIGN_CEIL(base + vq->vq_nentries * sizeof(struct vring_packed_desc),
+					      align);
+		*used_addr = *avail_addr + sizeof(struct vring_packed_desc_event);
+	} else {
+		*avail_addr = base + vq->vq_nentries * sizeof(struct vring_desc);
+		*used_addr = SPDK_ALIGN_CEIL(*avail_addr + offsetof(struct vring_avail,
+					     ring[vq->vq_nentries]), align);
+	}
+}
+
 /**
  * Dump all device specific information into given json stream.
  *
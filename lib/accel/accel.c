@@ -32,6 +32,16 @@
 #define MAX_TASKS_PER_CHANNEL		0x800
 #define ACCEL_SMALL_CACHE_SIZE		128
 #define ACCEL_LARGE_CACHE_SIZE		16
+/* Operations at or below this size are executed in software on cross-socket channels */
+#define ACCEL_CROSS_SOCKET_SIZE_THRESHOLD	2048
+/* Adaptive compress dispatch: number of log2 size classes, starting at the base size */
+#define ACCEL_DISPATCH_NUM_CLASSES	8
+#define ACCEL_DISPATCH_BASE_SIZE	4096
+/* Re-measure the non-preferred engine after this many tasks in a size class */
+#define ACCEL_DISPATCH_PROBE_INTERVAL	64
+/* EWMA weight: new sample contributes 1/8th */
+#define ACCEL_DISPATCH_EWMA_SHIFT	3
+#define ACCEL_DISPATCH_NUM_ENGINES	2
 /* Set MSB, so we don't return NULL pointers as buffers */
 #define ACCEL_BUFFER_BASE		((void *)(1ull << 63))
 #define ACCEL_BUFFER_OFFSET_MASK	((uintptr_t)ACCEL_BUFFER_BASE - 1)
@@ -71,6 +81,8 @@ static struct spdk_accel_opts g_opts = {
 	.task_count = MAX_TASKS_PER_CHANNEL,
 	.sequence_count = MAX_TASKS_PER_CHANNEL,
 	.buf_count = MAX_TASKS_PER_CHANNEL,
+	.cross_socket_size_threshold = ACCEL_CROSS_SOCKET_SIZE_THRESHOLD,
+	.adaptive_compress_dispatch = 1,
 };
 static struct accel_stats g_stats;
 static struct spdk_spinlock g_stats_lock;
@@ -139,8 +151,19 @@ struct accel_buffer {
 	struct accel_io_channel		*ch;
 };
 
+/* Per-channel, per-size-class state for adaptive compress dispatch.  Engine 0 is the module
+ * assigned to the opcode, engine 1 the software module.  ewma_ticks of 0 means unmeasured. */
+struct accel_dispatch_class {
+	uint64_t	ewma_ticks[ACCEL_DISPATCH_NUM_ENGINES];
+	uint32_t	since_probe;
+	uint8_t		preferred;
+};
+
 struct accel_io_channel {
 	struct spdk_io_channel			*module_ch[SPDK_ACCEL_OPC_LAST];
+	struct spdk_io_channel			*numa_fallback_ch[SPDK_ACCEL_OPC_LAST];
+	struct spdk_io_channel			*compress_sw_ch;
+	struct accel_dispatch_class		compress_classes[2][ACCEL_DISPATCH_NUM_CLASSES];
 	struct spdk_io_channel			*driver_channel;
 	void					*task_pool_base;
 	struct spdk_accel_sequence		*seq_pool_base;
@@ -272,6 +295,9 @@ spdk_accel_assign_opc(enum spdk_accel_opcode opcode, const char *name)
 	return 0;
 }
 
+static inline void accel_dispatch_update(struct accel_io_channel *accel_ch,
+		struct spdk_accel_task *task);
+
 void
 spdk_accel_task_complete(struct spdk_accel_task *accel_task, int status)
 {
@@ -285,6 +311,13 @@ spdk_accel_task_complete(struct spdk_accel_task *accel_task, int status)
 		accel_update_task_stats(accel_ch, accel_task, failed, 1);
 	}
 
+	if (spdk_unlikely(accel_task->dispatch_engine != UINT8_MAX)) {
+		if (status == 0) {
+			accel_dispatch_update(accel_ch, accel_task);
+		}
+		accel_task->dispatch_engine = UINT8_MAX;
+	}
+
 	if (accel_task->seq) {
 		accel_sequence_task_cb(accel_task->seq, status);
 		return;
@@ -327,10 +360,71 @@ _get_task(struct accel_io_channel *accel_ch, spdk_accel_completion_cb cb_fn, voi
 	accel_task->accel_ch = accel_ch;
 	accel_task->s.iovs = NULL;
 	accel_task->d.iovs = NULL;
+	accel_task->dispatch_engine = UINT8_MAX;
 
 	return accel_task;
 }
 
+/* Software module used for small operations on channels whose device is on a remote socket */
+static struct spdk_accel_module_if *g_numa_fallback_module;
+/* Software module used as the alternate engine for adaptive compress dispatch */
+static struct spdk_accel_module_if *g_compress_sw_module;
+
+static inline struct accel_dispatch_class *
+accel_dispatch_get_class(struct accel_io_channel *accel_ch, struct spdk_accel_task *task)
+{
+	uint32_t class;
+
+	if (task->nbytes < ACCEL_DISPATCH_BASE_SIZE) {
+		class = 0;
+	} else {
+		class = spdk_min(spdk_u64log2(task->nbytes / ACCEL_DISPATCH_BASE_SIZE) + 1,
+				 ACCEL_DISPATCH_NUM_CLASSES - 1);
+	}
+
+	return &accel_ch->compress_classes[task->op_code == SPDK_ACCEL_OPC_DECOMPRESS][class];
+}
+
+/* Pick the engine for a compress/decompress task based on the per-size-class latency measured
+ * on this channel.  The non-preferred engine is probed periodically so the decision tracks
+ * workload and device behavior over time. */
+static inline uint8_t
+accel_dispatch_select_engine(struct accel_io_channel *accel_ch, struct spdk_accel_task *task)
+{
+	struct accel_dispatch_class *class = accel_dispatch_get_class(accel_ch, task);
+	uint8_t other = !class->preferred;
+
+	if (class->ewma_ticks[other] == 0 || ++class->since_probe >= ACCEL_DISPATCH_PROBE_INTERVAL) {
+		class->since_probe = 0;
+		return other;
+	}
+
+	return class->preferred;
+}
+
+static inline void
+accel_dispatch_update(struct accel_io_channel *accel_ch, struct spdk_accel_task *task)
+{
+	struct accel_dispatch_class *class = accel_dispatch_get_class(accel_ch, task);
+	uint64_t ticks = spdk_get_ticks() - task->submit_tsc;
+	uint64_t *ewma = &class->ewma_ticks[task->dispatch_engine];
+	uint8_t other;
+
+	if (*ewma == 0) {
+		*ewma = spdk_max(ticks, 1);
+	} else {
+		*ewma -= *ewma >> ACCEL_DISPATCH_EWMA_SHIFT;
+		*ewma += spdk_max(ticks >> ACCEL_DISPATCH_EWMA_SHIFT, 1);
+	}
+
+	other = !task->dispatch_engine;
+	if (class->ewma_ticks[other] != 0 && class->ewma_ticks[other] < *ewma) {
+		class->preferred = other;
+	} else {
+		class->preferred = task->dispatch_engine;
+	}
+}
+
 static inline int
 accel_submit_task(struct accel_io_channel *accel_ch, struct spdk_accel_task *task)
 {
@@ -338,6 +432,25 @@ accel_submit_task(struct accel_io_channel *accel_ch, struct spdk_accel_task *tas
 	struct spdk_accel_module_if *module = g_modules_opc[task->op_code].module;
 	int rc;
 
+	if (spdk_unlikely(accel_ch->compress_sw_ch != NULL &&
+			  (task->op_code == SPDK_ACCEL_OPC_COMPRESS ||
+			   task->op_code == SPDK_ACCEL_OPC_DECOMPRESS))) {
+		/* The channel has both a hardware and the software engine available for this
+		 * opcode - choose per task based on measured latency for its size class. */
+		task->dispatch_engine = accel_dispatch_select_engine(accel_ch, task);
+		task->submit_tsc = spdk_get_ticks();
+		if (task->dispatch_engine == 1) {
+			module_ch = accel_ch->compress_sw_ch;
+			module = g_compress_sw_module;
+		}
+	} else if (spdk_unlikely(accel_ch->numa_fallback_ch[task->op_code] != NULL &&
+				 task->nbytes <= g_opts.cross_socket_size_threshold)) {
+		/* The assigned device sits on a remote socket and the operation is small enough
+		 * that executing it locally in software beats the cross-socket round trip. */
+		module_ch = accel_ch->numa_fallback_ch[task->op_code];
+		module = g_numa_fallback_module;
+	}
+
 	rc = module->submit_tasks(module_ch, task);
 	if (spdk_unlikely(rc != 0)) {
 		accel_update_task_stats(accel_ch, task, failed, 1);
@@ -655,6 +768,176 @@ spdk_accel_submit_copy_crc32cv(struct spdk_io_channel *ch, void *dst,
 	return accel_submit_task(accel_ch, accel_task);
 }
 
+static void
+accel_batch_fill_task(struct spdk_accel_task *accel_task,
+		      const struct spdk_accel_submit_entry *entry)
+{
+	struct iovec *iovs = accel_task->aux->iovs;
+
+	accel_task->op_code = entry->opcode;
+	accel_task->nbytes = entry->nbytes;
+	accel_task->src_domain = NULL;
+	accel_task->dst_domain = NULL;
+
+	switch (entry->opcode) {
+	case SPDK_ACCEL_OPC_COPY:
+	case SPDK_ACCEL_OPC_DUALCAST:
+	case SPDK_ACCEL_OPC_COPY_CRC32C:
+		accel_task->d.iovs = &iovs[SPDK_ACCEL_AUX_IOV_DST];
+		accel_task->d.iovs[0].iov_base = entry->dst;
+		accel_task->d.iovs[0].iov_len = entry->nbytes;
+		accel_task->d.iovcnt = 1;
+		break;
+	case SPDK_ACCEL_OPC_FILL:
+		accel_task->d.iovs = &iovs[SPDK_ACCEL_AUX_IOV_DST];
+		accel_task->d.iovs[0].iov_base = entry->dst;
+		accel_task->d.iovs[0].iov_len = entry->nbytes;
+		accel_task->d.iovcnt = 1;
+		memset(&accel_task->fill_pattern, entry->fill, sizeof(uint64_t));
+		return;
+	default:
+		break;
+	}
+
+	accel_task->s.iovs = &iovs[SPDK_ACCEL_AUX_IOV_SRC];
+	accel_task->s.iovs[0].iov_base = entry->src;
+	accel_task->s.iovs[0].iov_len = entry->nbytes;
+	accel_task->s.iovcnt = 1;
+
+	switch (entry->opcode) {
+	case SPDK_ACCEL_OPC_DUALCAST:
+		accel_task->d2.iovs = &iovs[SPDK_ACCEL_AUX_IOV_DST2];
+		accel_task->d2.iovs[0].iov_base = entry->dst2;
+		accel_task->d2.iovs[0].iov_len = entry->nbytes;
+		accel_task->d2.iovcnt = 1;
+		break;
+	case SPDK_ACCEL_OPC_COMPARE:
+		accel_task->s2.iovs = &iovs[SPDK_ACCEL_AUX_IOV_SRC2];
+		accel_task->s2.iovs[0].iov_base = entry->src2;
+		accel_task->s2.iovs[0].iov_len = entry->nbytes;
+		accel_task->s2.iovcnt = 1;
+		break;
+	case SPDK_ACCEL_OPC_CRC32C:
+	case SPDK_ACCEL_OPC_COPY_CRC32C:
+		accel_task->crc_dst = entry->crc_dst;
+		accel_task->seed = entry->seed;
+		break;
+	default:
+		break;
+	}
+}
+
+/* Accel framework public API for batched submission */
+int
+spdk_accel_submit_batch(struct spdk_io_channel *ch, struct spdk_accel_submit_entry *entries,
+			uint32_t count)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *first = NULL, *prev = NULL, *task, *last, *next;
+	struct spdk_io_channel *module_ch;
+	struct spdk_accel_module_if *module;
+	uint32_t i;
+	int rc;
+
+	if (count == 0 || count > SPDK_ACCEL_MAX_SUBMIT_BATCH) {
+		return -EINVAL;
+	}
+
+	/* Validate the whole batch up front, so that it's never partially allocated */
+	for (i = 0; i < count; i++) {
+		switch (entries[i].opcode) {
+		case SPDK_ACCEL_OPC_DUALCAST:
+			if ((uintptr_t)entries[i].dst & (ALIGN_4K - 1) ||
+			    (uintptr_t)entries[i].dst2 & (ALIGN_4K - 1)) {
+				SPDK_ERRLOG("Dualcast requires 4K alignment on dst addresses\n");
+				return -EINVAL;
+			}
+			break;
+		case SPDK_ACCEL_OPC_COPY:
+		case SPDK_ACCEL_OPC_FILL:
+		case SPDK_ACCEL_OPC_COMPARE:
+		case SPDK_ACCEL_OPC_CRC32C:
+		case SPDK_ACCEL_OPC_COPY_CRC32C:
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	/* Carve all tasks from the pool before submitting anything, chaining them together
+	 * through their link pointers */
+	for (i = 0; i < count; i++) {
+		task = _get_task(accel_ch, entries[i].cb_fn, entries[i].cb_arg);
+		if (spdk_likely(task != NULL)) {
+			task->aux = SLIST_FIRST(&accel_ch->task_aux_data_pool);
+			if (spdk_likely(task->aux != NULL)) {
+				SLIST_REMOVE_HEAD(&accel_ch->task_aux_data_pool, link);
+				task->has_aux = true;
+			} else {
+				STAILQ_INSERT_HEAD(&accel_ch->task_pool, task, link);
+				task = NULL;
+			}
+		}
+		if (spdk_unlikely(task == NULL)) {
+			for (task = first; task != NULL; task = next) {
+				next = STAILQ_NEXT(task, link);
+				SLIST_INSERT_HEAD(&accel_ch->task_aux_data_pool, task->aux, link);
+				task->aux = NULL;
+				task->has_aux = false;
+				STAILQ_INSERT_TAIL(&accel_ch->task_pool, task, link);
+			}
+			return -ENOMEM;
+		}
+
+		accel_batch_fill_task(task, &entries[i]);
+		if (prev != NULL) {
+			prev->link.stqe_next = task;
+		} else {
+			first = task;
+		}
+		prev = task;
+	}
+
+	/* Hand consecutive tasks assigned to the same module channel to its submit_tasks
+	 * callback as a single chain */
+	task = first;
+	while (task != NULL) {
+		module_ch = accel_ch->module_ch[task->op_code];
+		module = g_modules_opc[task->op_code].module;
+
+		last = task;
+		while ((next = STAILQ_NEXT(last, link)) != NULL &&
+		       accel_ch->module_ch[next->op_code] == module_ch) {
+			last = next;
+		}
+		next = STAILQ_NEXT(last, link);
+		last->link.stqe_next = NULL;
+
+		rc = module->submit_tasks(module_ch, task);
+		if (spdk_unlikely(rc != 0)) {
+			/* The module rejected the chain, so it's still owned by the framework.
+			 * Return it and any tasks that haven't been handed over yet to the pool.
+			 * Entries submitted earlier will still complete through their callbacks.
+			 */
+			last->link.stqe_next = next;
+			while (task != NULL) {
+				next = STAILQ_NEXT(task, link);
+				accel_update_task_stats(accel_ch, task, failed, 1);
+				SLIST_INSERT_HEAD(&accel_ch->task_aux_data_pool, task->aux, link);
+				task->aux = NULL;
+				task->has_aux = false;
+				STAILQ_INSERT_HEAD(&accel_ch->task_pool, task, link);
+				task = next;
+			}
+			return rc;
+		}
+
+		task = next;
+	}
+
+	return 0;
+}
+
 int
 spdk_accel_submit_compress(struct spdk_io_channel *ch, void *dst, uint64_t nbytes,
 			   struct iovec *src_iovs, size_t src_iovcnt, uint32_t *output_size,
@@ -1313,6 +1596,196 @@ spdk_accel_append_crc32c(struct spdk_accel_sequence **pseq, struct spdk_io_chann
 	return 0;
 }
 
+int
+spdk_accel_append_dif_verify(struct spdk_accel_sequence **pseq, struct spdk_io_channel *ch,
+			     struct iovec *iovs, size_t iovcnt,
+			     struct spdk_memory_domain *domain, void *domain_ctx,
+			     uint32_t num_blocks,
+			     const struct spdk_dif_ctx *ctx, struct spdk_dif_error *err,
+			     spdk_accel_step_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *task;
+	struct spdk_accel_sequence *seq = *pseq;
+
+	if (seq == NULL) {
+		seq = accel_sequence_get(accel_ch);
+		if (spdk_unlikely(seq == NULL)) {
+			return -ENOMEM;
+		}
+	}
+
+	assert(seq->ch == accel_ch);
+	task = accel_sequence_get_task(accel_ch, seq, cb_fn, cb_arg);
+	if (spdk_unlikely(task == NULL)) {
+		if (*pseq == NULL) {
+			accel_sequence_put(seq);
+		}
+
+		return -ENOMEM;
+	}
+
+	task->s.iovs = iovs;
+	task->s.iovcnt = iovcnt;
+	task->src_domain = domain;
+	task->src_domain_ctx = domain_ctx;
+	task->dif.ctx = ctx;
+	task->dif.err = err;
+	task->dif.num_blocks = num_blocks;
+	task->nbytes = num_blocks * ctx->block_size;
+	task->op_code = SPDK_ACCEL_OPC_DIF_VERIFY;
+	task->dst_domain = NULL;
+
+	TAILQ_INSERT_TAIL(&seq->tasks, task, seq_link);
+	*pseq = seq;
+
+	return 0;
+}
+
+int
+spdk_accel_append_dif_verify_copy(struct spdk_accel_sequence **pseq, struct spdk_io_channel *ch,
+				  struct iovec *dst_iovs, size_t dst_iovcnt,
+				  struct spdk_memory_domain *dst_domain, void *dst_domain_ctx,
+				  struct iovec *src_iovs, size_t src_iovcnt,
+				  struct spdk_memory_domain *src_domain, void *src_domain_ctx,
+				  uint32_t num_blocks,
+				  const struct spdk_dif_ctx *ctx, struct spdk_dif_error *err,
+				  spdk_accel_step_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *task;
+	struct spdk_accel_sequence *seq = *pseq;
+
+	if (seq == NULL) {
+		seq = accel_sequence_get(accel_ch);
+		if (spdk_unlikely(seq == NULL)) {
+			return -ENOMEM;
+		}
+	}
+
+	assert(seq->ch == accel_ch);
+	task = accel_sequence_get_task(accel_ch, seq, cb_fn, cb_arg);
+	if (spdk_unlikely(task == NULL)) {
+		if (*pseq == NULL) {
+			accel_sequence_put(seq);
+		}
+
+		return -ENOMEM;
+	}
+
+	task->d.iovs = dst_iovs;
+	task->d.iovcnt = dst_iovcnt;
+	task->dst_domain = dst_domain;
+	task->dst_domain_ctx = dst_domain_ctx;
+	task->s.iovs = src_iovs;
+	task->s.iovcnt = src_iovcnt;
+	task->src_domain = src_domain;
+	task->src_domain_ctx = src_domain_ctx;
+	task->dif.ctx = ctx;
+	task->dif.err = err;
+	task->dif.num_blocks = num_blocks;
+	task->nbytes = num_blocks * ctx->block_size;
+	task->op_code = SPDK_ACCEL_OPC_DIF_VERIFY_COPY;
+
+	TAILQ_INSERT_TAIL(&seq->tasks, task, seq_link);
+	*pseq = seq;
+
+	return 0;
+}
+
+int
+spdk_accel_append_dif_generate(struct spdk_accel_sequence **pseq, struct spdk_io_channel *ch,
+			       struct iovec *iovs, size_t iovcnt,
+			       struct spdk_memory_domain *domain, void *domain_ctx,
+			       uint32_t num_blocks, const struct spdk_dif_ctx *ctx,
+			       spdk_accel_step_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *task;
+	struct spdk_accel_sequence *seq = *pseq;
+
+	if (seq == NULL) {
+		seq = accel_sequence_get(accel_ch);
+		if (spdk_unlikely(seq == NULL)) {
+			return -ENOMEM;
+		}
+	}
+
+	assert(seq->ch == accel_ch);
+	task = accel_sequence_get_task(accel_ch, seq, cb_fn, cb_arg);
+	if (spdk_unlikely(task == NULL)) {
+		if (*pseq == NULL) {
+			accel_sequence_put(seq);
+		}
+
+		return -ENOMEM;
+	}
+
+	task->s.iovs = iovs;
+	task->s.iovcnt = iovcnt;
+	task->src_domain = domain;
+	task->src_domain_ctx = domain_ctx;
+	task->dif.ctx = ctx;
+	task->dif.num_blocks = num_blocks;
+	task->nbytes = num_blocks * ctx->block_size;
+	task->op_code = SPDK_ACCEL_OPC_DIF_GENERATE;
+	task->dst_domain = NULL;
+
+	TAILQ_INSERT_TAIL(&seq->tasks, task, seq_link);
+	*pseq = seq;
+
+	return 0;
+}
+
+int
+spdk_accel_append_dif_generate_copy(struct spdk_accel_sequence **pseq, struct spdk_io_channel *ch,
+				    struct iovec *dst_iovs, size_t dst_iovcnt,
+				    struct spdk_memory_domain *dst_domain, void *dst_domain_ctx,
+				    struct iovec *src_iovs, size_t src_iovcnt,
+				    struct spdk_memory_domain *src_domain, void *src_domain_ctx,
+				    uint32_t num_blocks, const struct spdk_dif_ctx *ctx,
+				    spdk_accel_step_cb cb_fn, void *cb_arg)
+{
+	struct accel_io_channel *accel_ch = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *task;
+	struct spdk_accel_sequence *seq = *pseq;
+
+	if (seq == NULL) {
+		seq = accel_sequence_get(accel_ch);
+		if (spdk_unlikely(seq == NULL)) {
+			return -ENOMEM;
+		}
+	}
+
+	assert(seq->ch == accel_ch);
+	task = accel_sequence_get_task(accel_ch, seq, cb_fn, cb_arg);
+	if (spdk_unlikely(task == NULL)) {
+		if (*pseq == NULL) {
+			accel_sequence_put(seq);
+		}
+
+		return -ENOMEM;
+	}
+
+	task->d.iovs = dst_iovs;
+	task->d.iovcnt = dst_iovcnt;
+	task->dst_domain = dst_domain;
+	task->dst_domain_ctx = dst_domain_ctx;
+	task->s.iovs = src_iovs;
+	task->s.iovcnt = src_iovcnt;
+	task->src_domain = src_domain;
+	task->src_domain_ctx = src_domain_ctx;
+	task->dif.ctx = ctx;
+	task->dif.num_blocks = num_blocks;
+	task->nbytes = num_blocks * ctx->block_size;
+	task->op_code = SPDK_ACCEL_OPC_DIF_GENERATE_COPY;
+
+	TAILQ_INSERT_TAIL(&seq->tasks, task, seq_link);
+	*pseq = seq;
+
+	return 0;
+}
+
 int
 spdk_accel_get_buf(struct spdk_io_channel *ch, uint64_t len, void **buf,
 		   struct spdk_memory_domain **domain, void **domain_ctx)
@@ -2032,6 +2505,18 @@ accel_task_set_dstbuf(struct spdk_accel_task *task, struct spdk_accel_task *next
 	return true;
 }
 
+static bool
+accel_module_supports_fused_opcode(enum spdk_accel_opcode opcode)
+{
+	struct spdk_accel_module_if *module = g_modules_opc[opcode].module;
+
+	if (module == NULL || module->supports_fused_opcode == NULL) {
+		return false;
+	}
+
+	return module->supports_fused_opcode(opcode);
+}
+
 static void
 accel_sequence_merge_tasks(struct spdk_accel_sequence *seq, struct spdk_accel_task *task,
 			   struct spdk_accel_task **next_task)
@@ -2040,6 +2525,28 @@ accel_sequence_merge_tasks(struct spdk_accel_sequence *seq, struct spdk_accel_ta
 
 	switch (task->op_code) {
 	case SPDK_ACCEL_OPC_COPY:
+		/* A copy followed by a crc32c of the copy's destination can be fused into a single
+		 * copy+crc32c task if the module assigned to that opcode can execute it.
+		 */
+		if (next->op_code == SPDK_ACCEL_OPC_CRC32C &&
+		    accel_module_supports_fused_opcode(SPDK_ACCEL_OPC_COPY_CRC32C) &&
+		    task->dst_domain == next->src_domain &&
+		    accel_compare_iovs(task->d.iovs, task->d.iovcnt,
+				       next->s.iovs, next->s.iovcnt)) {
+			/* seed and crc_dst are already in place in next's unions */
+			next->op_code = SPDK_ACCEL_OPC_COPY_CRC32C;
+			next->d.iovs = task->d.iovs;
+			next->d.iovcnt = task->d.iovcnt;
+			next->dst_domain = task->dst_domain;
+			next->dst_domain_ctx = task->dst_domain_ctx;
+			next->s.iovs = task->s.iovs;
+			next->s.iovcnt = task->s.iovcnt;
+			next->src_domain = task->src_domain;
+			next->src_domain_ctx = task->src_domain_ctx;
+			next->nbytes = task->nbytes;
+			accel_sequence_complete_task(seq, task);
+			break;
+		}
 		/* We only allow changing src of operations that actually have a src, e.g. we never
 		 * do it for fill.  Theoretically, it is possible, but we'd have to be careful to
 		 * change the src of the operation after fill (which in turn could also be a fill).
@@ -2065,11 +2572,40 @@ accel_sequence_merge_tasks(struct spdk_accel_sequence *seq, struct spdk_accel_ta
 		next->src_domain_ctx = task->src_domain_ctx;
 		accel_sequence_complete_task(seq, task);
 		break;
+	case SPDK_ACCEL_OPC_CRC32C:
+		/* We can only merge tasks when one of them is a copy */
+		if (next->op_code != SPDK_ACCEL_OPC_COPY) {
+			break;
+		}
+		if (!accel_task_set_dstbuf(task, next)) {
+			/* The copy couldn't be elided (e.g. crc32c is the first operation in the
+			 * sequence), but a crc32c of a buffer followed by a copy of that same
+			 * buffer is equivalent to a single copy+crc32c task, so fuse them if the
+			 * module assigned to that opcode can execute it.
+			 */
+			if (!accel_module_supports_fused_opcode(SPDK_ACCEL_OPC_COPY_CRC32C) ||
+			    task->src_domain != next->src_domain ||
+			    !accel_compare_iovs(task->s.iovs, task->s.iovcnt,
+						next->s.iovs, next->s.iovcnt)) {
+				break;
+			}
+			/* seed and crc_dst are already in place in task's unions */
+			task->op_code = SPDK_ACCEL_OPC_COPY_CRC32C;
+			task->d.iovs = next->d.iovs;
+			task->d.iovcnt = next->d.iovcnt;
+			task->dst_domain = next->dst_domain;
+			task->dst_domain_ctx = next->dst_domain_ctx;
+			task->nbytes = next->nbytes;
+		}
+		/* We're removing next_task from the tasks queue, so we need to update its pointer,
+		 * so that the TAILQ_FOREACH_SAFE() loop below works correctly */
+		*next_task = TAILQ_NEXT(next, seq_link);
+		accel_sequence_complete_task(seq, next);
+		break;
 	case SPDK_ACCEL_OPC_DECOMPRESS:
 	case SPDK_ACCEL_OPC_FILL:
 	case SPDK_ACCEL_OPC_ENCRYPT:
 	case SPDK_ACCEL_OPC_DECRYPT:
-	case SPDK_ACCEL_OPC_CRC32C:
 		/* We can only merge tasks when one of them is a copy */
 		if (next->op_code != SPDK_ACCEL_OPC_COPY) {
 			break;
@@ -2094,12 +2630,14 @@ spdk_accel_sequence_finish(struct spdk_accel_sequence *seq,
 {
 	struct spdk_accel_task *task, *next;
 
-	/* Try to remove any copy operations if possible */
-	TAILQ_FOREACH_SAFE(task, &seq->tasks, seq_link, next) {
-		if (next == NULL) {
-			break;
+	if (!g_opts.disable_sequence_optimizations) {
+		/* Try to remove any copy operations if possible */
+		TAILQ_FOREACH_SAFE(task, &seq->tasks, seq_link, next) {
+			if (next == NULL) {
+				break;
+			}
+			accel_sequence_merge_tasks(seq, task, &next);
 		}
-		accel_sequence_merge_tasks(seq, task, &next);
 	}
 
 	seq->cb_fn = cb_fn;
@@ -2510,6 +3048,83 @@ spdk_accel_module_list_add(struct spdk_accel_module_if *accel_module)
 	}
 }
 
+/* Detect module channels whose backing device is on a remote CPU socket and set up software
+ * channels to execute small operations on them locally.  Best effort - on any failure the
+ * channel simply keeps using the assigned module for all sizes, as before. */
+static void
+accel_assign_numa_fallback_channels(struct accel_io_channel *accel_ch)
+{
+	struct spdk_accel_module_if *sw_module, *module;
+	struct spdk_io_channel *sw_ch;
+	uint32_t socket_id, i;
+	int module_socket;
+
+	if (g_opts.cross_socket_size_threshold == 0) {
+		return;
+	}
+
+	sw_module = _module_find_by_name("software");
+	if (sw_module == NULL) {
+		return;
+	}
+
+	socket_id = spdk_env_get_socket_id(spdk_env_get_current_core());
+	if (socket_id == (uint32_t)SPDK_ENV_SOCKET_ID_ANY) {
+		return;
+	}
+
+	for (i = 0; i < SPDK_ACCEL_OPC_LAST; i++) {
+		module = g_modules_opc[i].module;
+		if (module == sw_module || module->get_channel_socket_id == NULL) {
+			continue;
+		}
+
+		module_socket = module->get_channel_socket_id(accel_ch->module_ch[i]);
+		if (module_socket < 0 || (uint32_t)module_socket == socket_id) {
+			continue;
+		}
+
+		sw_ch = sw_module->get_io_channel();
+		if (sw_ch == NULL) {
+			return;
+		}
+
+		accel_ch->numa_fallback_ch[i] = sw_ch;
+		g_numa_fallback_module = sw_module;
+	}
+}
+
+/* Set up a software channel to compete with the module assigned to compress/decompress, so that
+ * each task can be dispatched to whichever engine measures faster for its size class.  Best
+ * effort - on any failure the channel keeps using the assigned module for everything. */
+static void
+accel_assign_compress_dispatch_channel(struct accel_io_channel *accel_ch)
+{
+	struct spdk_accel_module_if *sw_module;
+
+	if (!g_opts.adaptive_compress_dispatch) {
+		return;
+	}
+
+	sw_module = _module_find_by_name("software");
+	if (sw_module == NULL) {
+		return;
+	}
+
+	/* Pointless when software is already the assigned module for both opcodes */
+	if (g_modules_opc[SPDK_ACCEL_OPC_COMPRESS].module == sw_module &&
+	    g_modules_opc[SPDK_ACCEL_OPC_DECOMPRESS].module == sw_module) {
+		return;
+	}
+
+	accel_ch->compress_sw_ch = sw_module->get_io_channel();
+	if (accel_ch->compress_sw_ch == NULL) {
+		return;
+	}
+
+	g_compress_sw_module = sw_module;
+}
+
 /* Framework level channel create callback. */
 static int
 accel_create_channel(void *io_device, void *ctx_buf)
@@ -2597,6 +3212,9 @@ accel_create_channel(void *io_device, void *ctx_buf)
 		goto err;
 	}
 
+	accel_assign_numa_fallback_channels(accel_ch);
+	accel_assign_compress_dispatch_channel(accel_ch);
+
 	return 0;
 err:
 	if (accel_ch->driver_channel != NULL) {
@@ -2648,6 +3266,15 @@ accel_destroy_channel(void *io_device, void *ctx_buf)
 		assert(accel_ch->module_ch[i] != NULL);
 		spdk_put_io_channel(accel_ch->module_ch[i]);
 		accel_ch->module_ch[i] = NULL;
+		if (accel_ch->numa_fallback_ch[i] != NULL) {
+			spdk_put_io_channel(accel_ch->numa_fallback_ch[i]);
+			accel_ch->numa_fallback_ch[i] = NULL;
+		}
+	}
+
+	if (accel_ch->compress_sw_ch != NULL) {
+		spdk_put_io_channel(accel_ch->compress_sw_ch);
+		accel_ch->compress_sw_ch = NULL;
 	}
 
 	/* Update global stats to make sure channel's stats aren't lost after a channel is gone */
@@ -2709,23 +3336,29 @@ accel_memory_domain_translate(struct spdk_memory_domain *src_domain, void *src_d
 			      void *addr, size_t len, struct spdk_memory_domain_translation_result *result)
 {
 	struct accel_buffer *buf = src_domain_ctx;
+	uintptr_t offset;
 
 	SPDK_DEBUGLOG(accel, "translate addr %p, len %zu\n", addr, len);
 
 	assert(g_accel_domain == src_domain);
 	assert(spdk_memory_domain_get_system_domain() == dst_domain);
-	assert(buf->buf == NULL);
-	assert(addr == ACCEL_BUFFER_BASE);
-	assert(len == buf->len);
 
-	buf->buf = spdk_iobuf_get(&buf->ch->iobuf, buf->len, NULL, NULL);
-	if (spdk_unlikely(buf->buf == NULL)) {
-		return -ENOMEM;
+	offset = (uintptr_t)addr & ACCEL_BUFFER_OFFSET_MASK;
+	assert(offset + len <= buf->len);
+
+	/* The data buffer is allocated lazily, so it might already be in place if the buffer was
+	 * used by an executed sequence.  In that case the translation simply points at the data
+	 * the sequence produced. */
+	if (buf->buf == NULL) {
+		buf->buf = spdk_iobuf_get(&buf->ch->iobuf, buf->len, NULL, NULL);
+		if (spdk_unlikely(buf->buf == NULL)) {
+			return -ENOMEM;
+		}
 	}
 
 	result->iov_count = 1;
-	result->iov.iov_base = buf->buf;
-	result->iov.iov_len = buf->len;
+	result->iov.iov_base = (char *)buf->buf + offset;
+	result->iov.iov_len = len;
 	SPDK_DEBUGLOG(accel, "translated addr %p\n", result->iov.iov_base);
 	return 0;
 }
@@ -2914,6 +3547,10 @@ accel_write_options(struct spdk_json_write_ctx *w)
 	spdk_json_write_named_uint32(w, "task_count", g_opts.task_count);
 	spdk_json_write_named_uint32(w, "sequence_count", g_opts.sequence_count);
 	spdk_json_write_named_uint32(w, "buf_count", g_opts.buf_count);
+	spdk_json_write_named_uint32(w, "cross_socket_size_threshold", g_opts.cross_socket_size_threshold);
+	spdk_json_write_named_bool(w, "adaptive_compress_dispatch", g_opts.adaptive_compress_dispatch);
+	spdk_json_write_named_bool(w, "disable_sequence_optimizations",
+				   g_opts.disable_sequence_optimizations);
 	spdk_json_write_object_end(w);
 	spdk_json_write_object_end(w);
 }
@@ -3095,6 +3732,9 @@ spdk_accel_set_opts(const struct spdk_accel_opts *opts)
 	SET_FIELD(task_count);
 	SET_FIELD(sequence_count);
 	SET_FIELD(buf_count);
+	SET_FIELD(cross_socket_size_threshold);
+	SET_FIELD(adaptive_compress_dispatch);
+	SET_FIELD(disable_sequence_optimizations);
 
 	g_opts.opts_size = opts->opts_size;
 
@@ -3128,12 +3768,15 @@ spdk_accel_get_opts(struct spdk_accel_opts *opts, size_t opts_size)
 	SET_FIELD(task_count);
 	SET_FIELD(sequence_count);
 	SET_FIELD(buf_count);
+	SET_FIELD(cross_socket_size_threshold);
+	SET_FIELD(adaptive_compress_dispatch);
+	SET_FIELD(disable_sequence_optimizations);
 
 #undef SET_FIELD
 
 	/* Do not remove this statement, you should always update this statement when you adding a new field,
 	 * and do not forget to add the SET_FIELD statement for your added field. */
-	SPDK_STATIC_ASSERT(sizeof(struct spdk_accel_opts) == 28, "Incorrect size");
+	SPDK_STATIC_ASSERT(sizeof(struct spdk_accel_opts) == 34, "Incorrect size");
 }
 
 struct accel_get_stats_ctx {
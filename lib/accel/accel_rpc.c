@@ -361,6 +361,9 @@ struct rpc_accel_opts {
 	uint32_t	task_count;
 	uint32_t	sequence_count;
 	uint32_t	buf_count;
+	uint32_t	cross_socket_size_threshold;
+	bool		adaptive_compress_dispatch;
+	bool		disable_sequence_optimizations;
 };
 
 static const struct spdk_json_object_decoder rpc_accel_set_options_decoders[] = {
@@ -369,6 +372,9 @@ static const struct spdk_json_object_decoder rpc_accel_set_options_decoders[] =
 	{"task_count", offsetof(struct rpc_accel_opts, task_count), spdk_json_decode_uint32, true},
 	{"sequence_count", offsetof(struct rpc_accel_opts, sequence_count), spdk_json_decode_uint32, true},
 	{"buf_count", offsetof(struct rpc_accel_opts, buf_count), spdk_json_decode_uint32, true},
+	{"cross_socket_size_threshold", offsetof(struct rpc_accel_opts, cross_socket_size_threshold), spdk_json_decode_uint32, true},
+	{"adaptive_compress_dispatch", offsetof(struct rpc_accel_opts, adaptive_compress_dispatch), spdk_json_decode_bool, true},
+	{"disable_sequence_optimizations", offsetof(struct rpc_accel_opts, disable_sequence_optimizations), spdk_json_decode_bool, true},
 };
 
 static void
@@ -386,6 +392,9 @@ rpc_accel_set_options(struct spdk_jsonrpc_request *request, const struct spdk_js
 	rpc_opts.task_count = opts.task_count;
 	rpc_opts.sequence_count = opts.sequence_count;
 	rpc_opts.buf_count = opts.buf_count;
+	rpc_opts.cross_socket_size_threshold = opts.cross_socket_size_threshold;
+	rpc_opts.adaptive_compress_dispatch = opts.adaptive_compress_dispatch != 0;
+	rpc_opts.disable_sequence_optimizations = opts.disable_sequence_optimizations != 0;
 
 	if (spdk_json_decode_object(params, rpc_accel_set_options_decoders,
 				    SPDK_COUNTOF(rpc_accel_set_options_decoders), &rpc_opts)) {
@@ -399,6 +408,9 @@ rpc_accel_set_options(struct spdk_jsonrpc_request *request, const struct spdk_js
 	opts.task_count = rpc_opts.task_count;
 	opts.sequence_count = rpc_opts.sequence_count;
 	opts.buf_count = rpc_opts.buf_count;
+	opts.cross_socket_size_threshold = rpc_opts.cross_socket_size_threshold;
+	opts.adaptive_compress_dispatch = rpc_opts.adaptive_compress_dispatch;
+	opts.disable_sequence_optimizations = rpc_opts.disable_sequence_optimizations;
 
 	rc = spdk_accel_set_opts(&opts);
 	if (rc != 0) {
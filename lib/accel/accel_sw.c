@@ -87,6 +87,17 @@ sw_accel_supports_opcode(enum spdk_accel_opcode opc)
 	}
 }
 
+static bool
+sw_accel_supports_fused_opcode(enum spdk_accel_opcode fused_opc)
+{
+	switch (fused_opc) {
+	case SPDK_ACCEL_OPC_COPY_CRC32C:
+		return true;
+	default:
+		return false;
+	}
+}
+
 static int
 _sw_accel_dualcast_iovs(struct iovec *dst_iovs, uint32_t dst_iovcnt,
 			struct iovec *dst2_iovs, uint32_t dst2_iovcnt,
@@ -162,6 +173,28 @@ _sw_accel_crc32cv(uint32_t *crc_dst, struct iovec *iov, uint32_t iovcnt, uint32_
 	*crc_dst = spdk_crc32c_iov_update(iov, iovcnt, ~seed);
 }
 
+static void
+_sw_accel_copy_crc32cv(uint32_t *crc_dst, struct iovec *dst_iovs, uint32_t dst_iovcnt,
+		       struct iovec *src_iovs, uint32_t src_iovcnt, uint32_t seed)
+{
+	struct spdk_ioviter iter;
+	void *src, *dst;
+	size_t len;
+	uint32_t crc = ~seed;
+
+	/* Copy and checksum each span in a single pass, while the data is still hot in cache,
+	 * instead of copying all iovecs first and reading them back for the checksum */
+	for (len = spdk_ioviter_first(&iter, src_iovs, src_iovcnt,
+				      dst_iovs, dst_iovcnt, &src, &dst);
+	     len != 0;
+	     len = spdk_ioviter_next(&iter, &src, &dst)) {
+		memcpy(dst, src, len);
+		crc = spdk_crc32c_update(src, len, crc);
+	}
+
+	*crc_dst = crc;
+}
+
 static int
 _sw_accel_compress(struct sw_accel_io_channel *sw_ch, struct spdk_accel_task *accel_task)
 {
@@ -547,10 +580,10 @@ sw_accel_submit_tasks(struct spdk_io_channel *ch, struct spdk_accel_task *accel_
 			_sw_accel_crc32cv(accel_task->crc_dst, accel_task->s.iovs, accel_task->s.iovcnt, accel_task->seed);
 			break;
 		case SPDK_ACCEL_OPC_COPY_CRC32C:
-			_sw_accel_copy_iovs(accel_task->d.iovs, accel_task->d.iovcnt,
-					    accel_task->s.iovs, accel_task->s.iovcnt);
-			_sw_accel_crc32cv(accel_task->crc_dst, accel_task->s.iovs,
-					  accel_task->s.iovcnt, accel_task->seed);
+			_sw_accel_copy_crc32cv(accel_task->crc_dst,
+					       accel_task->d.iovs, accel_task->d.iovcnt,
+					       accel_task->s.iovs, accel_task->s.iovcnt,
+					       accel_task->seed);
 			break;
 		case SPDK_ACCEL_OPC_COMPRESS:
 			rc = _sw_accel_compress(sw_ch, accel_task);
@@ -743,6 +776,7 @@ static struct spdk_accel_module_if g_sw_module = {
 	.name				= "software",
 	.priority			= SPDK_ACCEL_SW_PRIORITY,
 	.supports_opcode		= sw_accel_supports_opcode,
+	.supports_fused_opcode		= sw_accel_supports_fused_opcode,
 	.get_io_channel			= sw_accel_get_io_channel,
 	.submit_tasks			= sw_accel_submit_tasks,
 	.crypto_key_init		= sw_accel_crypto_key_init,
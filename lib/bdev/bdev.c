@@ -48,6 +48,16 @@ int __itt_init_ittlib(const char *, __itt_group_id);
 #define SPDK_BDEV_QOS_MIN_IOS_PER_SEC		1000
 #define SPDK_BDEV_QOS_MIN_BYTES_PER_SEC		(1024 * 1024)
 #define SPDK_BDEV_QOS_MAX_MBYTES_PER_SEC	(UINT64_MAX / (1024 * 1024))
+/* Fraction (as a right shift) of the per-timeslice quota that a channel grabs
+ * from the shared pool when refilling its local QoS token bucket.
+ */
+#define SPDK_BDEV_QOS_LOCAL_REFILL_SHIFT	4
+
+/* Number of bdev_ios pre-allocated per channel exclusively for split children,
+ * so splitting a large I/O doesn't contend with regular submissions for the
+ * shared bdev_io pool or hit the io_wait path.
+ */
+#define SPDK_BDEV_CHILD_IO_CACHE_SIZE		(8)
 #define SPDK_BDEV_QOS_LIMIT_NOT_DEFINED		UINT64_MAX
 #define SPDK_BDEV_IO_POLL_INTERVAL_IN_MSEC	1000
 
@@ -62,6 +72,33 @@ int __itt_init_ittlib(const char *, __itt_group_id);
  */
 #define SPDK_BDEV_MAX_CHILDREN_COPY_REQS (8)
 
+/* Maximum number of completions accumulated on a channel before the batched
+ * completion callback is forced to run (see
+ * spdk_bdev_channel_enable_batched_completions()).
+ */
+#define SPDK_BDEV_IO_COMPLETION_BATCH_SIZE (64)
+
+/* Maximum nesting depth of inline completion dispatch on a channel.  An I/O
+ * completed synchronously from within its own submit_request has its callback
+ * run as soon as the submit path unwinds; past this depth the completion falls
+ * back to a thread message to bound stack growth when callbacks keep issuing
+ * new I/O that also completes synchronously.
+ */
+#define BDEV_IO_INLINE_COMPLETE_MAX_DEPTH (8)
+
+/* The layout of spdk_bdev_io is documented as cache-line optimized (see the
+ * comment on the structure in bdev_module.h).  Enforce the two guarantees bdev
+ * modules may rely on: the submit-path fields (bdev, type and the transfer
+ * description at the head of u.bdev) fit within the first 64 bytes, and the
+ * completion-path fields of the internal area (ch through the status byte) are
+ * packed within 64 bytes of each other.
+ */
+SPDK_STATIC_ASSERT(offsetof(struct spdk_bdev_io, u.bdev.md_buf) + sizeof(void *) <= 64,
+		   "hot submit fields of spdk_bdev_io exceed the first cache line");
+SPDK_STATIC_ASSERT(offsetof(struct spdk_bdev_io, internal.status) -
+		   offsetof(struct spdk_bdev_io, internal.ch) < 64,
+		   "hot completion fields of spdk_bdev_io are not packed together");
+
 #define LOG_ALREADY_CLAIMED_ERROR(detail, bdev) \
 	log_already_claimed(SPDK_LOG_ERROR, __LINE__, __func__, detail, bdev)
 #ifdef DEBUG
@@ -150,6 +187,7 @@ static struct spdk_bdev_opts	g_bdev_opts = {
 	.bdev_auto_examine = SPDK_BDEV_AUTO_EXAMINE,
 	.iobuf_small_cache_size = BUF_SMALL_CACHE_SIZE,
 	.iobuf_large_cache_size = BUF_LARGE_CACHE_SIZE,
+	.bdev_histogram_enable = false,
 };
 
 static spdk_bdev_init_cb	g_init_cb_fn = NULL;
@@ -203,6 +241,12 @@ struct spdk_bdev_qos {
 	/** Timestamp of start of last timeslice. */
 	uint64_t last_timeslice;
 
+	/** Incremented whenever the per-timeslice quota is reset.  Channels
+	 *  compare this against their cached generation to know when their
+	 *  local token buckets have expired.
+	 */
+	uint64_t timeslice_gen;
+
 	/** Poller that processes queued I/O commands each time slice. */
 	struct spdk_poller *poller;
 };
@@ -264,6 +308,7 @@ struct spdk_bdev_shared_resource {
 
 #define BDEV_CH_RESET_IN_PROGRESS	(1 << 0)
 #define BDEV_CH_QOS_ENABLED		(1 << 1)
+#define BDEV_CH_BATCHED_COMPLETIONS	(1 << 2)
 
 struct spdk_bdev_channel {
 	struct spdk_bdev	*bdev;
@@ -320,10 +365,62 @@ struct spdk_bdev_channel {
 
 	bdev_io_tailq_t		queued_resets;
 
+	/** I/O completed by the module from within its submit_request, held
+	 * until the submit path unwinds so their callbacks run without a
+	 * thread message round-trip. */
+	bdev_io_tailq_t		queued_inline_completions;
+
+	/** Nesting depth of inline completion dispatch on this channel. */
+	uint32_t		inline_complete_depth;
+
+	/** Nesting depth of bdev_io_submit() on this channel.  Inline
+	 * completions are only dispatched from the outermost frame, after all
+	 * bookkeeping of nested submissions (e.g. split children) is done.
+	 */
+	uint32_t		submit_depth;
+
 	lba_range_tailq_t	locked_ranges;
 
 	/** List of I/Os queued by QoS. */
 	bdev_io_tailq_t		qos_queued_io;
+
+	/** Channel-local QoS token buckets, refilled in chunks from the shared
+	 *  pool in bdev->internal.qos so most rate-limited I/O don't touch the
+	 *  shared cache line.  Tokens become invalid when qos_timeslice_gen
+	 *  falls behind the generation in the shared QoS object.
+	 */
+	int64_t			qos_local_tokens[SPDK_BDEV_QOS_NUM_RATE_LIMIT_TYPES];
+	uint64_t		qos_timeslice_gen;
+
+	/** Pre-allocated bdev_ios reserved for split children (see
+	 *  bdev_io_split_submit()).  These never enter the shared pool.
+	 */
+	bdev_io_stailq_t	child_io_cache;
+	uint16_t		child_io_cache_count;
+	uint16_t		child_io_cache_size;
+
+	/** Set while allocating a bdev_io for a split child, so
+	 *  bdev_channel_get_io() serves it from child_io_cache.
+	 */
+	bool			split_child_alloc;
+
+	/** Stat snapshot published on a cadence for lock-free device-stat
+	 *  aggregation when bdev->internal.stat_sub_period != 0.  The seqlock
+	 *  lets spdk_bdev_get_device_stat() read a consistent copy from any
+	 *  thread without messaging this channel.
+	 */
+	uint64_t		stat_slot_seq;
+	struct spdk_bdev_io_stat stat_slot;
+	TAILQ_ENTRY(spdk_bdev_channel) stat_sub_link;
+	struct spdk_poller	*stat_sub_poller;
+
+	/** Batched completion delivery state, only used when
+	 * BDEV_CH_BATCHED_COMPLETIONS is set in flags. */
+	spdk_bdev_io_completion_cb_batch completion_batch_cb;
+	void			*completion_batch_ctx;
+	uint32_t		completion_batch_count;
+	struct spdk_poller	*completion_batch_poller;
+	struct spdk_bdev_io	*completion_batch[SPDK_BDEV_IO_COMPLETION_BATCH_SIZE];
 };
 
 struct media_event_entry {
@@ -397,12 +494,16 @@ enum bdev_io_retry_state {
 
 static inline void bdev_io_complete(void *ctx);
 static inline void bdev_io_complete_unsubmitted(struct spdk_bdev_io *bdev_io);
+static void bdev_ch_complete_inline_ios(struct spdk_bdev_channel *bdev_ch);
 static void bdev_io_push_bounce_md_buf(struct spdk_bdev_io *bdev_io);
 static void bdev_io_push_bounce_data(struct spdk_bdev_io *bdev_io);
 
 static void bdev_write_zero_buffer_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg);
 static int bdev_write_zero_buffer(struct spdk_bdev_io *bdev_io);
 
+static void bdev_copy_do_read_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg);
+static void bdev_copy_do_write_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg);
+
 static void bdev_enable_qos_msg(struct spdk_bdev_channel_iter *i, struct spdk_bdev *bdev,
 				struct spdk_io_channel *ch, void *_ctx);
 static void bdev_enable_qos_done(struct spdk_bdev *bdev, void *_ctx, int status);
@@ -418,7 +519,7 @@ static int bdev_writev_blocks_with_md(struct spdk_bdev_desc *desc, struct spdk_i
 				      uint64_t offset_blocks, uint64_t num_blocks,
 				      struct spdk_memory_domain *domain, void *domain_ctx,
 				      struct spdk_accel_sequence *seq, uint32_t dif_check_flags,
-				      uint32_t nvme_cdw12_raw, uint32_t nvme_cdw13_raw,
+				      uint32_t nvme_cdw12_raw, uint32_t nvme_cdw13_raw, bool fua,
 				      spdk_bdev_io_completion_cb cb, void *cb_arg);
 
 static int bdev_lock_lba_range(struct spdk_bdev_desc *desc, struct spdk_io_channel *_ch,
@@ -480,10 +581,11 @@ spdk_bdev_get_opts(struct spdk_bdev_opts *opts, size_t opts_size)
 	SET_FIELD(bdev_auto_examine);
 	SET_FIELD(iobuf_small_cache_size);
 	SET_FIELD(iobuf_large_cache_size);
+	SET_FIELD(bdev_histogram_enable);
 
 	/* Do not remove this statement, you should always update this statement when you adding a new field,
 	 * and do not forget to add the SET_FIELD statement for your added field. */
-	SPDK_STATIC_ASSERT(sizeof(struct spdk_bdev_opts) == 32, "Incorrect size");
+	SPDK_STATIC_ASSERT(sizeof(struct spdk_bdev_opts) == 40, "Incorrect size");
 
 #undef SET_FIELD
 }
@@ -527,6 +629,7 @@ spdk_bdev_set_opts(struct spdk_bdev_opts *opts)
 	SET_FIELD(bdev_auto_examine);
 	SET_FIELD(iobuf_small_cache_size);
 	SET_FIELD(iobuf_large_cache_size);
+	SET_FIELD(bdev_histogram_enable);
 
 	g_bdev_opts.opts_size = opts->opts_size;
 
@@ -634,6 +737,74 @@ spdk_bdev_wait_for_examine(spdk_bdev_wait_for_examine_cb cb_fn, void *cb_arg)
 	return 0;
 }
 
+struct bdev_wait_for_examine_bdev_ctx {
+	struct spdk_bdev		*bdev;
+	struct spdk_poller		*poller;
+	spdk_bdev_wait_for_examine_cb	cb_fn;
+	void				*cb_arg;
+};
+
+static bool
+bdev_examine_completed(struct spdk_bdev *bdev)
+{
+	struct spdk_bdev_module *m;
+	uint32_t actions;
+
+	spdk_spin_lock(&bdev->internal.spinlock);
+	actions = bdev->internal.examine_actions;
+	spdk_spin_unlock(&bdev->internal.spinlock);
+
+	if (actions > 0) {
+		return false;
+	}
+
+	/*
+	 * Modules that do not identify the examined bdev are only tracked by their
+	 * global action counter, so fall back to waiting for them globally.
+	 */
+	TAILQ_FOREACH(m, &g_bdev_mgr.bdev_modules, internal.tailq) {
+		if (!m->examine_done_ext && m->internal.action_in_progress > 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static int
+bdev_wait_for_examine_bdev_cb(void *arg)
+{
+	struct bdev_wait_for_examine_bdev_ctx *ctx = arg;
+
+	if (!bdev_examine_completed(ctx->bdev)) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	spdk_poller_unregister(&ctx->poller);
+	ctx->cb_fn(ctx->cb_arg);
+	free(ctx);
+
+	return SPDK_POLLER_BUSY;
+}
+
+static int
+bdev_wait_for_examine_bdev(struct spdk_bdev *bdev, spdk_bdev_wait_for_examine_cb cb_fn,
+			   void *cb_arg)
+{
+	struct bdev_wait_for_examine_bdev_ctx *ctx;
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		return -ENOMEM;
+	}
+	ctx->bdev = bdev;
+	ctx->cb_fn = cb_fn;
+	ctx->cb_arg = cb_arg;
+	ctx->poller = SPDK_POLLER_REGISTER(bdev_wait_for_examine_bdev_cb, ctx, 0);
+
+	return 0;
+}
+
 struct spdk_bdev_examine_item {
 	char *name;
 	TAILQ_ENTRY(spdk_bdev_examine_item) link;
@@ -706,6 +877,11 @@ bdev_examine(struct spdk_bdev *bdev)
 
 	TAILQ_FOREACH(module, &g_bdev_mgr.bdev_modules, internal.tailq) {
 		if (module->examine_config) {
+			if (module->examine_done_ext) {
+				spdk_spin_lock(&bdev->internal.spinlock);
+				bdev->internal.examine_actions++;
+				spdk_spin_unlock(&bdev->internal.spinlock);
+			}
 			spdk_spin_lock(&module->internal.spinlock);
 			action = module->internal.action_in_progress;
 			module->internal.action_in_progress++;
@@ -725,6 +901,9 @@ bdev_examine(struct spdk_bdev *bdev)
 		/* Examine by all bdev modules */
 		TAILQ_FOREACH(module, &g_bdev_mgr.bdev_modules, internal.tailq) {
 			if (module->examine_disk) {
+				if (module->examine_done_ext) {
+					bdev->internal.examine_actions++;
+				}
 				spdk_spin_lock(&module->internal.spinlock);
 				module->internal.action_in_progress++;
 				spdk_spin_unlock(&module->internal.spinlock);
@@ -738,6 +917,9 @@ bdev_examine(struct spdk_bdev *bdev)
 		/* Examine by the one bdev module with a v1 claim */
 		module = bdev->internal.claim.v1.module;
 		if (module->examine_disk) {
+			if (module->examine_done_ext) {
+				bdev->internal.examine_actions++;
+			}
 			spdk_spin_lock(&module->internal.spinlock);
 			module->internal.action_in_progress++;
 			spdk_spin_unlock(&module->internal.spinlock);
@@ -768,6 +950,9 @@ bdev_examine(struct spdk_bdev *bdev)
 				continue;
 			}
 
+			if (module->examine_done_ext) {
+				bdev->internal.examine_actions++;
+			}
 			spdk_spin_lock(&module->internal.spinlock);
 			module->internal.action_in_progress++;
 			spdk_spin_unlock(&module->internal.spinlock);
@@ -2117,6 +2302,19 @@ spdk_bdev_module_examine_done(struct spdk_bdev_module *module)
 	bdev_module_action_done(module);
 }
 
+void
+spdk_bdev_module_examine_done_ext(struct spdk_bdev_module *module, struct spdk_bdev *bdev)
+{
+	assert(module->examine_done_ext);
+
+	spdk_spin_lock(&bdev->internal.spinlock);
+	assert(bdev->internal.examine_actions > 0);
+	bdev->internal.examine_actions--;
+	spdk_spin_unlock(&bdev->internal.spinlock);
+
+	bdev_module_action_done(module);
+}
+
 /** The last initialized bdev module */
 static struct spdk_bdev_module *g_resume_bdev_module = NULL;
 
@@ -2456,6 +2654,14 @@ bdev_channel_get_io(struct spdk_bdev_channel *channel)
 	struct spdk_bdev_mgmt_channel *ch = channel->shared_resource->mgmt_ch;
 	struct spdk_bdev_io *bdev_io;
 
+	if (spdk_unlikely(channel->split_child_alloc) && channel->child_io_cache_count > 0) {
+		bdev_io = STAILQ_FIRST(&channel->child_io_cache);
+		STAILQ_REMOVE_HEAD(&channel->child_io_cache, internal.buf_link);
+		channel->child_io_cache_count--;
+		bdev_io->internal.from_child_cache = true;
+		return bdev_io;
+	}
+
 	if (ch->per_thread_cache_count > 0) {
 		bdev_io = STAILQ_FIRST(&ch->per_thread_cache);
 		STAILQ_REMOVE_HEAD(&ch->per_thread_cache, internal.buf_link);
@@ -2470,6 +2676,10 @@ bdev_channel_get_io(struct spdk_bdev_channel *channel)
 		bdev_io = spdk_mempool_get(g_bdev_mgr.bdev_io_pool);
 	}
 
+	if (spdk_likely(bdev_io != NULL)) {
+		bdev_io->internal.from_child_cache = false;
+	}
+
 	return bdev_io;
 }
 
@@ -2487,6 +2697,17 @@ spdk_bdev_free_io(struct spdk_bdev_io *bdev_io)
 		bdev_io_put_buf(bdev_io);
 	}
 
+	if (spdk_unlikely(bdev_io->internal.from_child_cache)) {
+		struct spdk_bdev_channel *bdev_ch = bdev_io->internal.ch;
+
+		/* This bdev_io is owned by the channel's child-IO cache and must
+		 * never enter the shared pool.
+		 */
+		STAILQ_INSERT_HEAD(&bdev_ch->child_io_cache, bdev_io, internal.buf_link);
+		bdev_ch->child_io_cache_count++;
+		return;
+	}
+
 	if (ch->per_thread_cache_count < ch->bdev_io_cache_size) {
 		ch->per_thread_cache_count++;
 		STAILQ_INSERT_HEAD(&ch->per_thread_cache, bdev_io, internal.buf_link);
@@ -2595,22 +2816,62 @@ bdev_get_io_size_in_byte(struct spdk_bdev_io *bdev_io)
 static inline bool
 bdev_qos_rw_queue_io(struct spdk_bdev_qos_limit *limit, struct spdk_bdev_io *io, uint64_t delta)
 {
+	struct spdk_bdev_qos *qos = io->bdev->internal.qos;
+	struct spdk_bdev_channel *ch = io->internal.ch;
+	uint32_t idx = limit - qos->rate_limits;
 	int64_t remaining_this_timeslice;
+	int64_t needed, grab, give_back;
+	uint64_t gen;
 
 	if (!limit->max_per_timeslice) {
 		/* The QoS is disabled */
 		return false;
 	}
 
-	remaining_this_timeslice = __atomic_sub_fetch(&limit->remaining_this_timeslice, delta,
+	/* Local tokens left over from an expired timeslice were already
+	 * deducted from the shared pool, so they are simply dropped.
+	 */
+	gen = __atomic_load_n(&qos->timeslice_gen, __ATOMIC_RELAXED);
+	if (spdk_unlikely(ch->qos_timeslice_gen != gen)) {
+		memset(ch->qos_local_tokens, 0, sizeof(ch->qos_local_tokens));
+		ch->qos_timeslice_gen = gen;
+	}
+
+	/* Fast path - the channel-local token bucket covers this delta and no
+	 * shared state needs to be touched.
+	 */
+	if (ch->qos_local_tokens[idx] >= (int64_t)delta) {
+		ch->qos_local_tokens[idx] -= delta;
+		return false;
+	}
+
+	/* Refill the local bucket from the shared pool.  Grab at least a chunk
+	 * of the per-timeslice quota so the atomic is amortized over many I/O.
+	 */
+	needed = delta - ch->qos_local_tokens[idx];
+	grab = spdk_max(needed,
+			(int64_t)(limit->max_per_timeslice >> SPDK_BDEV_QOS_LOCAL_REFILL_SHIFT));
+
+	remaining_this_timeslice = __atomic_sub_fetch(&limit->remaining_this_timeslice, grab,
 				   __ATOMIC_RELAXED);
-	if (remaining_this_timeslice + (int64_t)delta > 0) {
+	if (remaining_this_timeslice + grab > 0) {
 		/* There was still a quota for this delta -> the IO shouldn't be queued
 		 *
 		 * We allow a slight quota overrun here so an IO bigger than the per-timeslice
 		 * quota can be allowed once a while. Such overrun then taken into account in
 		 * the QoS poller, where the next timeslice quota is calculated.
 		 */
+		if (remaining_this_timeslice < 0 && grab > needed) {
+			/* Don't hoard tokens the shared pool didn't actually have -
+			 * return the part of the chunk that overdrew it.
+			 */
+			give_back = spdk_min(grab - needed, -remaining_this_timeslice);
+			__atomic_add_fetch(&limit->remaining_this_timeslice, give_back,
+					   __ATOMIC_RELAXED);
+			grab -= give_back;
+		}
+
+		ch->qos_local_tokens[idx] += grab - delta;
 		return false;
 	}
 
@@ -2619,14 +2880,21 @@ bdev_qos_rw_queue_io(struct spdk_bdev_qos_limit *limit, struct spdk_bdev_io *io,
 	 * amount of IOs or bytes allowed.
 	 */
 	__atomic_add_fetch(
-		&limit->remaining_this_timeslice, delta, __ATOMIC_RELAXED);
+		&limit->remaining_this_timeslice, grab, __ATOMIC_RELAXED);
 	return true;
 }
 
 static inline void
 bdev_qos_rw_rewind_io(struct spdk_bdev_qos_limit *limit, struct spdk_bdev_io *io, uint64_t delta)
 {
-	__atomic_add_fetch(&limit->remaining_this_timeslice, delta, __ATOMIC_RELAXED);
+	struct spdk_bdev_qos *qos = io->bdev->internal.qos;
+	struct spdk_bdev_channel *ch = io->internal.ch;
+	uint32_t idx = limit - qos->rate_limits;
+
+	/* The tokens were taken on this channel within the current timeslice,
+	 * so they can be returned to the local bucket without an atomic.
+	 */
+	ch->qos_local_tokens[idx] += delta;
 }
 
 static bool
@@ -2732,6 +3000,10 @@ _bdev_io_complete_in_submit(struct spdk_bdev_channel *bdev_ch,
 	bdev_io_increment_outstanding(bdev_ch, bdev_ch->shared_resource);
 	spdk_bdev_io_complete(bdev_io, status);
 	bdev_io->internal.in_submit_request = false;
+	if (spdk_unlikely(!TAILQ_EMPTY(&bdev_ch->queued_inline_completions)) &&
+	    bdev_ch->submit_depth == 0) {
+		bdev_ch_complete_inline_ios(bdev_ch);
+	}
 }
 
 static inline void
@@ -2767,6 +3039,10 @@ bdev_io_do_submit(struct spdk_bdev_channel *bdev_ch, struct spdk_bdev_io *bdev_i
 		bdev_io->internal.in_submit_request = true;
 		bdev_submit_request(bdev, ch, bdev_io);
 		bdev_io->internal.in_submit_request = false;
+		if (spdk_unlikely(!TAILQ_EMPTY(&bdev_ch->queued_inline_completions)) &&
+		    bdev_ch->submit_depth == 0) {
+			bdev_ch_complete_inline_ios(bdev_ch);
+		}
 	} else {
 		bdev_queue_nomem_io_tail(shared_resource, bdev_io, BDEV_IO_RETRY_STATE_SUBMIT);
 		if (shared_resource->nomem_threshold == 0 && shared_resource->io_outstanding == 0) {
@@ -2970,14 +3246,41 @@ _to_next_boundary(uint64_t offset, uint32_t boundary)
 
 static void bdev_io_split_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg);
 
-static void _bdev_rw_split(void *_bdev_io);
+static void bdev_rw_split(struct spdk_bdev_io *bdev_io);
+
+/* The split workers submit children and then advance the parent's split
+ * bookkeeping, so inline completions queued by those submissions must not be
+ * dispatched until the worker returns (see bdev_io_submit()).  This guard
+ * covers the resume paths that run outside of bdev_io_submit():
+ * queued-for-resource waits, buffer allocation callbacks and
+ * bdev_io_split_done().
+ */
+static void
+bdev_io_split_guarded(struct spdk_bdev_io *bdev_io,
+		      void (*split_fn)(struct spdk_bdev_io *))
+{
+	struct spdk_bdev_channel *ch = bdev_io->internal.ch;
+
+	ch->submit_depth++;
+	split_fn(bdev_io);
+	if (--ch->submit_depth == 0 &&
+	    spdk_unlikely(!TAILQ_EMPTY(&ch->queued_inline_completions))) {
+		bdev_ch_complete_inline_ios(ch);
+	}
+}
+
+static void
+_bdev_rw_split(void *_bdev_io)
+{
+	bdev_io_split_guarded(_bdev_io, bdev_rw_split);
+}
 
 static void bdev_unmap_split(struct spdk_bdev_io *bdev_io);
 
 static void
 _bdev_unmap_split(void *_bdev_io)
 {
-	return bdev_unmap_split((struct spdk_bdev_io *)_bdev_io);
+	bdev_io_split_guarded(_bdev_io, bdev_unmap_split);
 }
 
 static void bdev_write_zeroes_split(struct spdk_bdev_io *bdev_io);
@@ -2985,7 +3288,7 @@ static void bdev_write_zeroes_split(struct spdk_bdev_io *bdev_io);
 static void
 _bdev_write_zeroes_split(void *_bdev_io)
 {
-	return bdev_write_zeroes_split((struct spdk_bdev_io *)_bdev_io);
+	bdev_io_split_guarded(_bdev_io, bdev_write_zeroes_split);
 }
 
 static void bdev_copy_split(struct spdk_bdev_io *bdev_io);
@@ -2993,7 +3296,7 @@ static void bdev_copy_split(struct spdk_bdev_io *bdev_io);
 static void
 _bdev_copy_split(void *_bdev_io)
 {
-	return bdev_copy_split((struct spdk_bdev_io *)_bdev_io);
+	bdev_io_split_guarded(_bdev_io, bdev_copy_split);
 }
 
 static int
@@ -3009,6 +3312,9 @@ bdev_io_split_submit(struct spdk_bdev_io *bdev_io, struct iovec *iov, int iovcnt
 
 	bdev_io->u.bdev.split_outstanding++;
 
+	/* Serve the child's bdev_io from the channel's pre-allocated cache. */
+	bdev_io->internal.ch->split_child_alloc = true;
+
 	io_wait_fn = _bdev_rw_split;
 	switch (bdev_io->type) {
 	case SPDK_BDEV_IO_TYPE_READ:
@@ -3031,6 +3337,7 @@ bdev_io_split_submit(struct spdk_bdev_io *bdev_io, struct iovec *iov, int iovcnt
 						bdev_io->u.bdev.dif_check_flags,
 						bdev_io->u.bdev.nvme_cdw12.raw,
 						bdev_io->u.bdev.nvme_cdw13.raw,
+						bdev_io->u.bdev.fua,
 						bdev_io_split_done, bdev_io);
 		break;
 	case SPDK_BDEV_IO_TYPE_UNMAP:
@@ -3062,6 +3369,8 @@ bdev_io_split_submit(struct spdk_bdev_io *bdev_io, struct iovec *iov, int iovcnt
 		break;
 	}
 
+	bdev_io->internal.ch->split_child_alloc = false;
+
 	if (rc == 0) {
 		current_offset += num_blocks;
 		current_remaining -= num_blocks;
@@ -3092,10 +3401,9 @@ bdev_io_split_submit(struct spdk_bdev_io *bdev_io, struct iovec *iov, int iovcnt
 }
 
 static void
-_bdev_rw_split(void *_bdev_io)
+bdev_rw_split(struct spdk_bdev_io *bdev_io)
 {
 	struct iovec *parent_iov, *iov;
-	struct spdk_bdev_io *bdev_io = _bdev_io;
 	struct spdk_bdev *bdev = bdev_io->bdev;
 	uint64_t parent_offset, current_offset, remaining;
 	uint32_t parent_iov_offset, parent_iovcnt, parent_iovpos, child_iovcnt;
@@ -3395,13 +3703,13 @@ bdev_io_split_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 		_bdev_rw_split(parent_io);
 		break;
 	case SPDK_BDEV_IO_TYPE_UNMAP:
-		bdev_unmap_split(parent_io);
+		_bdev_unmap_split(parent_io);
 		break;
 	case SPDK_BDEV_IO_TYPE_WRITE_ZEROES:
-		bdev_write_zeroes_split(parent_io);
+		_bdev_write_zeroes_split(parent_io);
 		break;
 	case SPDK_BDEV_IO_TYPE_COPY:
-		bdev_copy_split(parent_io);
+		_bdev_copy_split(parent_io);
 		break;
 	default:
 		assert(false);
@@ -3578,12 +3886,24 @@ bdev_io_submit(struct spdk_bdev_io *bdev_io)
 			      (uintptr_t)bdev_io, (uint64_t)bdev_io->type, bdev_io->internal.caller_ctx,
 			      bdev_io->u.bdev.offset_blocks, ch->queue_depth);
 
+	/* Hold back inline completions queued by anything below - in particular
+	 * split children completed synchronously by the module - until this
+	 * frame unwinds.  Draining them from a nested frame would run
+	 * bdev_io_split_done() before the split bookkeeping of the submission
+	 * still on the stack has been advanced.
+	 */
+	ch->submit_depth++;
+
 	if (bdev_io->internal.split) {
 		bdev_io_split(bdev_io);
-		return;
+	} else {
+		_bdev_io_submit(bdev_io);
 	}
 
-	_bdev_io_submit(bdev_io);
+	if (--ch->submit_depth == 0 &&
+	    spdk_unlikely(!TAILQ_EMPTY(&ch->queued_inline_completions))) {
+		bdev_ch_complete_inline_ios(ch);
+	}
 }
 
 static inline void
@@ -3615,10 +3935,18 @@ _bdev_io_submit_ext(struct spdk_bdev_desc *desc, struct spdk_bdev_io *bdev_io)
 
 	/* We need to allocate bounce buffer if bdev doesn't support memory domains, or if it does
 	 * support them, but we need to execute an accel sequence and the data buffer is from accel
-	 * memory domain (to avoid doing a push/pull from that domain).
+	 * memory domain (to avoid doing a push/pull from that domain).  The exception is a buffer
+	 * from the accel memory domain whose sequence is executed by the bdev module itself: only
+	 * the accel framework ever touches such buffers, so they can be passed down as-is even
+	 * when the module doesn't support memory domains in general.
 	 */
-	if ((bdev_io->internal.memory_domain && !desc->memory_domains_supported) ||
-	    (needs_exec && bdev_io->internal.memory_domain == spdk_accel_get_memory_domain())) {
+	if (bdev_io->internal.memory_domain == spdk_accel_get_memory_domain() &&
+	    bdev_io->internal.accel_sequence != NULL) {
+		if (needs_exec) {
+			_bdev_io_ext_use_bounce_buffer(bdev_io);
+			return;
+		}
+	} else if (bdev_io->internal.memory_domain && !desc->memory_domains_supported) {
 		_bdev_io_ext_use_bounce_buffer(bdev_io);
 		return;
 	}
@@ -3649,6 +3977,10 @@ bdev_io_submit_reset(struct spdk_bdev_io *bdev_io)
 	bdev_io->internal.in_submit_request = true;
 	bdev_submit_request(bdev, ch, bdev_io);
 	bdev_io->internal.in_submit_request = false;
+	if (spdk_unlikely(!TAILQ_EMPTY(&bdev_ch->queued_inline_completions)) &&
+	    bdev_ch->submit_depth == 0) {
+		bdev_ch_complete_inline_ios(bdev_ch);
+	}
 }
 
 void
@@ -3742,6 +4074,9 @@ bdev_qos_update_max_quota_per_timeslice(struct spdk_bdev_qos *qos)
 				 qos->rate_limits[i].max_per_timeslice, __ATOMIC_RELEASE);
 	}
 
+	/* Invalidate all channel-local token buckets. */
+	__atomic_add_fetch(&qos->timeslice_gen, 1, __ATOMIC_RELAXED);
+
 	bdev_qos_set_ops(qos);
 }
 
@@ -3818,6 +4153,12 @@ bdev_channel_poll_qos(void *arg)
 		}
 	}
 
+	/* A new timeslice has started - leftover channel-local tokens belong to
+	 * the previous one and must not be spent, so bump the generation to
+	 * invalidate them.
+	 */
+	__atomic_add_fetch(&qos->timeslice_gen, 1, __ATOMIC_RELAXED);
+
 	spdk_bdev_for_each_channel(bdev, bdev_channel_submit_qos_io, qos,
 				   bdev_channel_submit_qos_io_done);
 
@@ -3829,6 +4170,17 @@ bdev_channel_destroy_resource(struct spdk_bdev_channel *ch)
 {
 	struct spdk_bdev_shared_resource *shared_resource;
 	struct lba_range *range;
+	struct spdk_bdev_io *child_io;
+
+	/* All split children must have completed by now. */
+	assert(ch->child_io_cache_count == ch->child_io_cache_size);
+	while (!STAILQ_EMPTY(&ch->child_io_cache)) {
+		child_io = STAILQ_FIRST(&ch->child_io_cache);
+		STAILQ_REMOVE_HEAD(&ch->child_io_cache, internal.buf_link);
+		free(child_io);
+	}
+	ch->child_io_cache_count = 0;
+	ch->child_io_cache_size = 0;
 
 	bdev_free_io_stat(ch->stat);
 #ifdef SPDK_CONFIG_VTUNE
@@ -3909,6 +4261,8 @@ bdev_enable_qos(struct spdk_bdev *bdev, struct spdk_bdev_channel *ch)
 							   SPDK_BDEV_QOS_TIMESLICE_IN_USEC);
 		}
 
+		memset(ch->qos_local_tokens, 0, sizeof(ch->qos_local_tokens));
+		ch->qos_timeslice_gen = __atomic_load_n(&qos->timeslice_gen, __ATOMIC_RELAXED);
 		ch->flags |= BDEV_CH_QOS_ENABLED;
 	}
 }
@@ -3954,7 +4308,7 @@ bdev_channel_poll_timeout_io(struct spdk_bdev_channel_iter *i, struct spdk_bdev
 	struct spdk_bdev_channel *bdev_ch = __io_ch_to_bdev_ch(io_ch);
 	struct spdk_bdev_desc *desc = ctx->desc;
 	struct spdk_bdev_io *bdev_io;
-	uint64_t now;
+	uint64_t now, timeout_in_ticks;
 
 	spdk_spin_lock(&desc->spinlock);
 	if (desc->closed == true) {
@@ -3965,20 +4319,22 @@ bdev_channel_poll_timeout_io(struct spdk_bdev_channel_iter *i, struct spdk_bdev
 	spdk_spin_unlock(&desc->spinlock);
 
 	now = spdk_get_ticks();
+	timeout_in_ticks = ctx->timeout_in_sec * spdk_get_ticks_hz();
+
 	TAILQ_FOREACH(bdev_io, &bdev_ch->io_submitted, internal.ch_link) {
+		/* The list is ordered by submit_tsc, so once we find an I/O that
+		 * has not timed out, neither has anything submitted after it and
+		 * we can immediately exit the loop.
+		 */
+		if (now < (bdev_io->internal.submit_tsc + timeout_in_ticks)) {
+			goto end;
+		}
+
 		/* Exclude any I/O that are generated via splitting. */
 		if (bdev_io->internal.cb == bdev_io_split_done) {
 			continue;
 		}
 
-		/* Once we find an I/O that has not timed out, we can immediately
-		 * exit the loop.
-		 */
-		if (now < (bdev_io->internal.submit_tsc +
-			   ctx->timeout_in_sec * spdk_get_ticks_hz())) {
-			goto end;
-		}
-
 		if (bdev_io->internal.desc == desc) {
 			ctx->cb_fn(ctx->cb_arg, bdev_io);
 		}
@@ -4045,6 +4401,31 @@ spdk_bdev_set_timeout(struct spdk_bdev_desc *desc, uint64_t timeout_in_sec,
 	return 0;
 }
 
+/* Seqlock-publish a snapshot of the channel's stats.  Writer side: bump to an
+ * odd sequence, copy, then bump to the next even sequence, so readers can
+ * detect and retry a torn copy without ever blocking this thread.
+ */
+static int
+bdev_channel_publish_stat(void *ctx)
+{
+	struct spdk_bdev_channel *ch = ctx;
+	uint64_t seq = ch->stat_slot_seq;
+
+	__atomic_store_n(&ch->stat_slot_seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(&ch->stat_slot, ch->stat, offsetof(struct spdk_bdev_io_stat, io_error));
+	__atomic_store_n(&ch->stat_slot_seq, seq + 2, __ATOMIC_RELEASE);
+
+	return SPDK_POLLER_BUSY;
+}
+
+static void
+bdev_channel_start_stat_subscription(struct spdk_bdev_channel *ch, uint64_t period)
+{
+	bdev_channel_publish_stat(ch);
+	ch->stat_sub_poller = SPDK_POLLER_REGISTER(bdev_channel_publish_stat, ch, period);
+}
+
 static int
 bdev_channel_create(void *io_device, void *ctx_buf)
 {
@@ -4114,6 +4495,9 @@ bdev_channel_create(void *io_device, void *ctx_buf)
 
 	ch->io_outstanding = 0;
 	TAILQ_INIT(&ch->queued_resets);
+	TAILQ_INIT(&ch->queued_inline_completions);
+	ch->inline_complete_depth = 0;
+	ch->submit_depth = 0;
 	TAILQ_INIT(&ch->locked_ranges);
 	TAILQ_INIT(&ch->qos_queued_io);
 	ch->flags = 0;
@@ -4125,6 +4509,26 @@ bdev_channel_create(void *io_device, void *ctx_buf)
 	TAILQ_INIT(&ch->io_accel_exec);
 	TAILQ_INIT(&ch->io_memory_domain);
 
+	/* The child-IO cache is best effort - a partially (or not at all)
+	 * populated cache only means splits fall back to the shared pool.
+	 */
+	STAILQ_INIT(&ch->child_io_cache);
+	ch->child_io_cache_count = 0;
+	ch->child_io_cache_size = 0;
+	ch->split_child_alloc = false;
+	while (ch->child_io_cache_size < SPDK_BDEV_CHILD_IO_CACHE_SIZE) {
+		struct spdk_bdev_io *child_io;
+
+		child_io = calloc(1, sizeof(*child_io) + bdev_module_get_max_ctx_size());
+		if (child_io == NULL) {
+			break;
+		}
+
+		STAILQ_INSERT_HEAD(&ch->child_io_cache, child_io, internal.buf_link);
+		ch->child_io_cache_count++;
+		ch->child_io_cache_size++;
+	}
+
 	ch->stat = bdev_alloc_io_stat(false);
 	if (ch->stat == NULL) {
 		bdev_channel_destroy_resource(ch);
@@ -4133,6 +4537,11 @@ bdev_channel_create(void *io_device, void *ctx_buf)
 
 	ch->stat->ticks_rate = spdk_get_ticks_hz();
 
+	ch->stat_slot.io_error = NULL;
+	ch->stat_slot_seq = 0;
+	ch->stat_sub_poller = NULL;
+	bdev_channel_publish_stat(ch);
+
 #ifdef SPDK_CONFIG_VTUNE
 	{
 		char *name;
@@ -4157,6 +4566,11 @@ bdev_channel_create(void *io_device, void *ctx_buf)
 	spdk_spin_lock(&bdev->internal.spinlock);
 	bdev_enable_qos(bdev, ch);
 
+	TAILQ_INSERT_TAIL(&bdev->internal.stat_sub_channels, ch, stat_sub_link);
+	if (bdev->internal.stat_sub_period != 0) {
+		bdev_channel_start_stat_subscription(ch, bdev->internal.stat_sub_period);
+	}
+
 	TAILQ_FOREACH(range, &bdev->internal.locked_ranges, tailq) {
 		struct lba_range *new_range;
 
@@ -4542,12 +4956,19 @@ bdev_channel_destroy(void *io_device, void *ctx_buf)
 	/* This channel is going away, so add its statistics into the bdev so that they don't get lost. */
 	spdk_spin_lock(&ch->bdev->internal.spinlock);
 	spdk_bdev_add_io_stat(ch->bdev->internal.stat, ch->stat);
+	TAILQ_REMOVE(&ch->bdev->internal.stat_sub_channels, ch, stat_sub_link);
 	spdk_spin_unlock(&ch->bdev->internal.spinlock);
 
+	spdk_poller_unregister(&ch->stat_sub_poller);
+
 	bdev_abort_all_queued_io(&ch->queued_resets, ch);
 
 	bdev_channel_abort_queued_ios(ch);
 
+	if (ch->flags & BDEV_CH_BATCHED_COMPLETIONS) {
+		spdk_bdev_channel_disable_batched_completions(spdk_io_channel_from_ctx(ch));
+	}
+
 	if (ch->histogram) {
 		spdk_histogram_data_free(ch->histogram);
 	}
@@ -5000,6 +5421,39 @@ _tmp_bdev_event_cb(enum spdk_bdev_event_type type, struct spdk_bdev *bdev, void
 	SPDK_NOTICELOG("Unexpected event type: %d\n", type);
 }
 
+static void
+bdev_stat_subscription_update(struct spdk_bdev_channel_iter *i, struct spdk_bdev *bdev,
+			      struct spdk_io_channel *io_ch, void *ctx)
+{
+	struct spdk_bdev_channel *ch = __io_ch_to_bdev_ch(io_ch);
+
+	spdk_poller_unregister(&ch->stat_sub_poller);
+	if (bdev->internal.stat_sub_period != 0) {
+		bdev_channel_start_stat_subscription(ch, bdev->internal.stat_sub_period);
+	}
+	spdk_bdev_for_each_channel_continue(i, 0);
+}
+
+static void
+bdev_stat_subscription_update_done(struct spdk_bdev *bdev, void *ctx, int status)
+{
+}
+
+void
+spdk_bdev_set_stat_subscription_period(struct spdk_bdev *bdev, uint64_t period)
+{
+	spdk_spin_lock(&bdev->internal.spinlock);
+	if (bdev->internal.stat_sub_period == period) {
+		spdk_spin_unlock(&bdev->internal.spinlock);
+		return;
+	}
+	bdev->internal.stat_sub_period = period;
+	spdk_spin_unlock(&bdev->internal.spinlock);
+
+	spdk_bdev_for_each_channel(bdev, bdev_stat_subscription_update, NULL,
+				   bdev_stat_subscription_update_done);
+}
+
 void
 spdk_bdev_set_qd_sampling_period(struct spdk_bdev *bdev, uint64_t period)
 {
@@ -5540,6 +5994,7 @@ bdev_write_blocks_with_md(struct spdk_bdev_desc *desc, struct spdk_io_channel *c
 	bdev_io->u.bdev.memory_domain_ctx = NULL;
 	bdev_io->u.bdev.accel_sequence = NULL;
 	bdev_io->u.bdev.dif_check_flags = bdev->dif_check_flags;
+	bdev_io->u.bdev.fua = false;
 	bdev_io_init(bdev_io, bdev, cb_arg, cb);
 
 	bdev_io_submit(bdev_io);
@@ -5591,13 +6046,60 @@ spdk_bdev_write_blocks_with_md(struct spdk_bdev_desc *desc, struct spdk_io_chann
 					 cb, cb_arg);
 }
 
+static void bdev_write_fua_do_flush(void *_bdev_io);
+
+static void
+bdev_write_fua_flush_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct spdk_bdev_io *parent_io = cb_arg;
+
+	spdk_bdev_free_io(bdev_io);
+
+	if (!success) {
+		parent_io->internal.status = SPDK_BDEV_IO_STATUS_FAILED;
+	}
+	parent_io->u.bdev.stored_user_cb(parent_io,
+					 parent_io->internal.status == SPDK_BDEV_IO_STATUS_SUCCESS,
+					 parent_io->internal.caller_ctx);
+}
+
+static void
+bdev_write_fua_do_flush(void *_bdev_io)
+{
+	struct spdk_bdev_io *bdev_io = _bdev_io;
+	int rc;
+
+	rc = spdk_bdev_flush_blocks(bdev_io->internal.desc,
+				    spdk_io_channel_from_ctx(bdev_io->internal.ch),
+				    0, bdev_io->bdev->blockcnt,
+				    bdev_write_fua_flush_done, bdev_io);
+	if (rc == -ENOMEM) {
+		bdev_queue_io_wait_with_cb(bdev_io, bdev_write_fua_do_flush);
+	} else if (rc != 0) {
+		bdev_io->internal.status = SPDK_BDEV_IO_STATUS_FAILED;
+		bdev_io->u.bdev.stored_user_cb(bdev_io, false, bdev_io->internal.caller_ctx);
+	}
+}
+
+static void
+bdev_write_fua_write_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	if (!success) {
+		/* The write itself failed - there is nothing worth flushing */
+		bdev_io->u.bdev.stored_user_cb(bdev_io, false, cb_arg);
+		return;
+	}
+
+	bdev_write_fua_do_flush(bdev_io);
+}
+
 static int
 bdev_writev_blocks_with_md(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
 			   struct iovec *iov, int iovcnt, void *md_buf,
 			   uint64_t offset_blocks, uint64_t num_blocks,
 			   struct spdk_memory_domain *domain, void *domain_ctx,
 			   struct spdk_accel_sequence *seq, uint32_t dif_check_flags,
-			   uint32_t nvme_cdw12_raw, uint32_t nvme_cdw13_raw,
+			   uint32_t nvme_cdw12_raw, uint32_t nvme_cdw13_raw, bool fua,
 			   spdk_bdev_io_completion_cb cb, void *cb_arg)
 {
 	struct spdk_bdev *bdev = spdk_bdev_desc_get_bdev(desc);
@@ -5636,6 +6138,22 @@ bdev_writev_blocks_with_md(struct spdk_bdev_desc *desc, struct spdk_io_channel *
 	bdev_io->u.bdev.dif_check_flags = dif_check_flags;
 	bdev_io->u.bdev.nvme_cdw12.raw = nvme_cdw12_raw;
 	bdev_io->u.bdev.nvme_cdw13.raw = nvme_cdw13_raw;
+	bdev_io->u.bdev.fua = false;
+	bdev_io->u.bdev.nvme_cdw12.write.fua = 0;
+
+	if (spdk_unlikely(fua)) {
+		if (bdev->fua_supported) {
+			bdev_io->u.bdev.fua = true;
+			bdev_io->u.bdev.nvme_cdw12.write.fua = 1;
+		} else if (bdev->write_cache && bdev_io_type_supported(bdev, SPDK_BDEV_IO_TYPE_FLUSH)) {
+			/* Emulate FUA - the write completes through a flush of the
+			 * device write cache. If the bdev has no write cache (or no
+			 * way to flush it), FUA is a no-op.
+			 */
+			bdev_io->u.bdev.stored_user_cb = cb;
+			bdev_io->internal.cb = bdev_write_fua_write_done;
+		}
+	}
 
 	_bdev_io_submit_ext(desc, bdev_io);
 
@@ -5668,7 +6186,7 @@ spdk_bdev_writev_blocks(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
 
 	return bdev_writev_blocks_with_md(desc, ch, iov, iovcnt, NULL, offset_blocks,
 					  num_blocks, NULL, NULL, NULL, bdev->dif_check_flags, 0, 0,
-					  cb, cb_arg);
+					  false, cb, cb_arg);
 }
 
 int
@@ -5689,7 +6207,7 @@ spdk_bdev_writev_blocks_with_md(struct spdk_bdev_desc *desc, struct spdk_io_chan
 
 	return bdev_writev_blocks_with_md(desc, ch, iov, iovcnt, md_buf, offset_blocks,
 					  num_blocks, NULL, NULL, NULL, bdev->dif_check_flags, 0, 0,
-					  cb, cb_arg);
+					  false, cb, cb_arg);
 }
 
 int
@@ -5706,6 +6224,7 @@ spdk_bdev_writev_blocks_ext(struct spdk_bdev_desc *desc, struct spdk_io_channel
 	struct spdk_bdev *bdev = spdk_bdev_desc_get_bdev(desc);
 	uint32_t nvme_cdw12_raw = 0;
 	uint32_t nvme_cdw13_raw = 0;
+	bool fua = false;
 
 	if (opts) {
 		if (spdk_unlikely(!_bdev_io_check_opts(opts, iov))) {
@@ -5717,6 +6236,7 @@ spdk_bdev_writev_blocks_ext(struct spdk_bdev_desc *desc, struct spdk_io_channel
 		seq = bdev_get_ext_io_opt(opts, accel_sequence, NULL);
 		nvme_cdw12_raw = bdev_get_ext_io_opt(opts, nvme_cdw12.raw, 0);
 		nvme_cdw13_raw = bdev_get_ext_io_opt(opts, nvme_cdw13.raw, 0);
+		fua = bdev_get_ext_io_opt(opts, fua, false);
 		if (md) {
 			if (spdk_unlikely(!spdk_bdev_is_md_separate(bdev))) {
 				return -EINVAL;
@@ -5737,7 +6257,122 @@ spdk_bdev_writev_blocks_ext(struct spdk_bdev_desc *desc, struct spdk_io_channel
 
 	return bdev_writev_blocks_with_md(desc, ch, iov, iovcnt, md, offset_blocks, num_blocks,
 					  domain, domain_ctx, seq, dif_check_flags,
-					  nvme_cdw12_raw, nvme_cdw13_raw, cb, cb_arg);
+					  nvme_cdw12_raw, nvme_cdw13_raw, fua, cb, cb_arg);
+}
+
+int
+spdk_bdev_submit_batch(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
+		       struct spdk_bdev_io_submit_entry *entries, uint32_t count)
+{
+	struct spdk_bdev *bdev = spdk_bdev_desc_get_bdev(desc);
+	struct spdk_bdev_channel *channel = __io_ch_to_bdev_ch(ch);
+	struct spdk_bdev_shared_resource *shared_resource = channel->shared_resource;
+	struct spdk_bdev_io *batch[SPDK_BDEV_MAX_SUBMIT_BATCH];
+	struct spdk_bdev_io_submit_entry *entry;
+	struct spdk_bdev_io *bdev_io;
+	uint64_t submit_tsc;
+	uint32_t i, fast_count;
+	bool fast_path;
+
+	if (spdk_unlikely(count == 0 || count > SPDK_BDEV_MAX_SUBMIT_BATCH)) {
+		return -EINVAL;
+	}
+
+	/* Validate the whole batch up front so that a bad entry doesn't leave
+	 * part of the batch submitted.
+	 */
+	for (i = 0; i < count; i++) {
+		entry = &entries[i];
+
+		if (spdk_unlikely(entry->type != SPDK_BDEV_IO_TYPE_READ &&
+				  entry->type != SPDK_BDEV_IO_TYPE_WRITE)) {
+			return -EINVAL;
+		}
+
+		if (spdk_unlikely(entry->type == SPDK_BDEV_IO_TYPE_WRITE && !desc->write)) {
+			return -EBADF;
+		}
+
+		if (spdk_unlikely(!bdev_io_valid_blocks(bdev, entry->offset_blocks,
+							entry->num_blocks))) {
+			return -EINVAL;
+		}
+	}
+
+	for (i = 0; i < count; i++) {
+		entry = &entries[i];
+
+		bdev_io = bdev_channel_get_io(channel);
+		if (spdk_unlikely(bdev_io == NULL)) {
+			while (i-- > 0) {
+				batch[i]->internal.status = SPDK_BDEV_IO_STATUS_FAILED;
+				spdk_bdev_free_io(batch[i]);
+			}
+			return -ENOMEM;
+		}
+
+		bdev_io->internal.ch = channel;
+		bdev_io->internal.desc = desc;
+		bdev_io->type = entry->type;
+		bdev_io->u.bdev.iovs = entry->iovs;
+		bdev_io->u.bdev.iovcnt = entry->iovcnt;
+		bdev_io->u.bdev.md_buf = NULL;
+		bdev_io->u.bdev.num_blocks = entry->num_blocks;
+		bdev_io->u.bdev.offset_blocks = entry->offset_blocks;
+		bdev_io->u.bdev.nvme_cdw12.raw = 0;
+		bdev_io->u.bdev.nvme_cdw13.raw = 0;
+		bdev_io->u.bdev.fua = false;
+		bdev_io_init(bdev_io, bdev, entry->cb_arg, entry->cb);
+		bdev_io->u.bdev.memory_domain = NULL;
+		bdev_io->u.bdev.memory_domain_ctx = NULL;
+		bdev_io->u.bdev.accel_sequence = NULL;
+		bdev_io->u.bdev.dif_check_flags = bdev->dif_check_flags;
+		batch[i] = bdev_io;
+	}
+
+	/* The channel state is checked once for the whole batch.  The batched
+	 * module path is only usable when nothing on the channel can queue,
+	 * reorder or split the I/O.
+	 */
+	fast_path = bdev->fn_table->submit_request_batch != NULL &&
+		    channel->flags == 0 &&
+		    TAILQ_EMPTY(&channel->locked_ranges) &&
+		    TAILQ_EMPTY(&shared_resource->nomem_io);
+
+	submit_tsc = spdk_get_ticks();
+	fast_count = 0;
+
+	for (i = 0; i < count; i++) {
+		bdev_io = batch[i];
+
+		if (!fast_path || bdev_io->internal.split) {
+			bdev_io_submit(bdev_io);
+			continue;
+		}
+
+		bdev_ch_add_to_io_submitted(bdev_io);
+		bdev_io->internal.submit_tsc = submit_tsc;
+		spdk_trace_record_tsc(submit_tsc, TRACE_BDEV_IO_START, channel->trace_id,
+				      bdev_io->u.bdev.num_blocks, (uintptr_t)bdev_io,
+				      (uint64_t)bdev_io->type, bdev_io->internal.caller_ctx,
+				      bdev_io->u.bdev.offset_blocks, channel->queue_depth);
+		bdev_io_increment_outstanding(channel, shared_resource);
+		bdev_io->internal.in_submit_request = true;
+		batch[fast_count++] = bdev_io;
+	}
+
+	if (fast_count > 0) {
+		bdev->fn_table->submit_request_batch(channel->channel, batch, fast_count);
+		for (i = 0; i < fast_count; i++) {
+			batch[i]->internal.in_submit_request = false;
+		}
+		if (spdk_unlikely(!TAILQ_EMPTY(&channel->queued_inline_completions)) &&
+		    channel->submit_depth == 0) {
+			bdev_ch_complete_inline_ios(channel);
+		}
+	}
+
+	return 0;
 }
 
 static void
@@ -6590,6 +7225,35 @@ spdk_bdev_get_device_stat(struct spdk_bdev *bdev, struct spdk_bdev_io_stat *stat
 	assert(stat != NULL);
 	assert(cb != NULL);
 
+	/* With stat subscription enabled, aggregate the snapshots the channels
+	 * publish on their own cadence instead of messaging every channel.  The
+	 * result may be up to one publish period stale.
+	 */
+	spdk_spin_lock(&bdev->internal.spinlock);
+	if (bdev->internal.stat_sub_period != 0) {
+		struct spdk_bdev_channel *channel;
+		struct spdk_bdev_io_stat slot_stat;
+		uint64_t seq1, seq2;
+
+		bdev_get_io_stat(stat, bdev->internal.stat);
+		slot_stat.io_error = NULL;
+		TAILQ_FOREACH(channel, &bdev->internal.stat_sub_channels, stat_sub_link) {
+			do {
+				seq1 = __atomic_load_n(&channel->stat_slot_seq, __ATOMIC_ACQUIRE);
+				memcpy(&slot_stat, &channel->stat_slot,
+				       offsetof(struct spdk_bdev_io_stat, io_error));
+				__atomic_thread_fence(__ATOMIC_ACQUIRE);
+				seq2 = __atomic_load_n(&channel->stat_slot_seq, __ATOMIC_RELAXED);
+			} while (seq1 != seq2 || (seq1 & 1) != 0);
+			spdk_bdev_add_io_stat(stat, &slot_stat);
+		}
+		spdk_spin_unlock(&bdev->internal.spinlock);
+
+		cb(bdev, stat, cb_arg, 0);
+		return;
+	}
+	spdk_spin_unlock(&bdev->internal.spinlock);
+
 	bdev_iostat_ctx = calloc(1, sizeof(struct spdk_bdev_iostat_ctx));
 	if (bdev_iostat_ctx == NULL) {
 		SPDK_ERRLOG("Unable to allocate memory for spdk_bdev_iostat_ctx\n");
@@ -7215,10 +7879,62 @@ bdev_io_update_io_stat(struct spdk_bdev_io *bdev_io, uint64_t tsc_diff)
 #endif
 }
 
+static void
+bdev_ch_flush_completion_batch(struct spdk_bdev_channel *bdev_ch)
+{
+	uint32_t count = bdev_ch->completion_batch_count;
+
+	if (count == 0) {
+		return;
+	}
+
+	bdev_ch->completion_batch_count = 0;
+	bdev_ch->completion_batch_cb(bdev_ch->completion_batch, count,
+				     bdev_ch->completion_batch_ctx);
+}
+
+static int
+bdev_ch_completion_batch_poll(void *ctx)
+{
+	struct spdk_bdev_channel *bdev_ch = ctx;
+
+	if (bdev_ch->completion_batch_count == 0) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	bdev_ch_flush_completion_batch(bdev_ch);
+	return SPDK_POLLER_BUSY;
+}
+
+/* True if the bdev layer itself installed the completion callback of this I/O:
+ * split and abort children, and the helper I/O (or repurposed parent) of the
+ * FUA, compare, compare-and-write, write-zeroes and copy emulation paths.
+ * Their callbacks advance the state of another I/O and must always run
+ * directly - handing such an I/O to a user's completion batch would leak it to
+ * an application that never submitted it and leave its parent incomplete.
+ */
+static bool
+bdev_io_cb_is_internal(struct spdk_bdev_io *bdev_io)
+{
+	spdk_bdev_io_completion_cb cb = bdev_io->internal.cb;
+
+	return cb == bdev_io_split_done ||
+	       cb == bdev_abort_io_done ||
+	       cb == bdev_write_fua_write_done ||
+	       cb == bdev_write_fua_flush_done ||
+	       cb == bdev_compare_do_read_done ||
+	       cb == bdev_compare_and_write_do_compare_done ||
+	       cb == bdev_compare_and_write_do_write_done ||
+	       cb == bdev_write_zero_buffer_done ||
+	       cb == bdev_copy_do_read_done ||
+	       cb == bdev_copy_do_write_done;
+}
+
 static inline void
 _bdev_io_complete(void *ctx)
 {
 	struct spdk_bdev_io *bdev_io = ctx;
+	struct spdk_bdev_channel *bdev_ch = bdev_io->internal.ch;
 
 	if (spdk_unlikely(bdev_io->internal.accel_sequence != NULL)) {
 		assert(bdev_io->internal.status != SPDK_BDEV_IO_STATUS_SUCCESS);
@@ -7228,25 +7944,58 @@ _bdev_io_complete(void *ctx)
 	assert(bdev_io->internal.cb != NULL);
 	assert(spdk_get_thread() == spdk_bdev_io_get_thread(bdev_io));
 
+	if (spdk_unlikely(bdev_ch->flags & BDEV_CH_BATCHED_COMPLETIONS) &&
+	    !bdev_io_cb_is_internal(bdev_io)) {
+		bdev_ch->completion_batch[bdev_ch->completion_batch_count++] = bdev_io;
+		if (bdev_ch->completion_batch_count == SPDK_BDEV_IO_COMPLETION_BATCH_SIZE) {
+			bdev_ch_flush_completion_batch(bdev_ch);
+		}
+		return;
+	}
+
 	bdev_io->internal.cb(bdev_io, bdev_io->internal.status == SPDK_BDEV_IO_STATUS_SUCCESS,
 			     bdev_io->internal.caller_ctx);
 }
 
+/* Run the callbacks of I/O completed synchronously from within their own
+ * submit_request, once the submit path has unwound.  Callbacks may issue new
+ * I/O that also completes synchronously; those drain in their own nested
+ * submit frame, so the depth only grows by one per level of callback-issued
+ * I/O and is bounded by BDEV_IO_INLINE_COMPLETE_MAX_DEPTH.
+ */
+static void
+bdev_ch_complete_inline_ios(struct spdk_bdev_channel *bdev_ch)
+{
+	struct spdk_bdev_io *bdev_io;
+
+	bdev_ch->inline_complete_depth++;
+	while (!TAILQ_EMPTY(&bdev_ch->queued_inline_completions)) {
+		bdev_io = TAILQ_FIRST(&bdev_ch->queued_inline_completions);
+		TAILQ_REMOVE(&bdev_ch->queued_inline_completions, bdev_io, internal.link);
+		_bdev_io_complete(bdev_io);
+	}
+	bdev_ch->inline_complete_depth--;
+}
+
 static inline void
 bdev_io_complete(void *ctx)
 {
 	struct spdk_bdev_io *bdev_io = ctx;
 	struct spdk_bdev_channel *bdev_ch = bdev_io->internal.ch;
 	uint64_t tsc, tsc_diff;
+	bool in_submit_request = false;
 
 	if (spdk_unlikely(bdev_io->internal.in_submit_request)) {
-		/*
-		 * Defer completion to avoid potential infinite recursion if the
-		 * user's completion callback issues a new I/O.
-		 */
-		spdk_thread_send_msg(spdk_bdev_io_get_thread(bdev_io),
-				     bdev_io_complete, bdev_io);
-		return;
+		if (bdev_ch->inline_complete_depth >= BDEV_IO_INLINE_COMPLETE_MAX_DEPTH) {
+			/*
+			 * Defer completion to avoid potential infinite recursion if the
+			 * user's completion callback issues a new I/O.
+			 */
+			spdk_thread_send_msg(spdk_bdev_io_get_thread(bdev_io),
+					     bdev_io_complete, bdev_io);
+			return;
+		}
+		in_submit_request = true;
 	}
 
 	tsc = spdk_get_ticks();
@@ -7261,6 +8010,16 @@ bdev_io_complete(void *ctx)
 	}
 
 	bdev_io_update_io_stat(bdev_io, tsc_diff);
+
+	if (spdk_unlikely(in_submit_request)) {
+		/* Hold the callback until the submit path unwinds; it runs from
+		 * bdev_ch_complete_inline_ios() as soon as the module's
+		 * submit_request returns.
+		 */
+		TAILQ_INSERT_TAIL(&bdev_ch->queued_inline_completions, bdev_io, internal.link);
+		return;
+	}
+
 	_bdev_io_complete(bdev_io);
 }
 
@@ -7669,6 +8428,9 @@ bdev_register(struct spdk_bdev *bdev)
 	memset(&bdev->internal.claim, 0, sizeof(bdev->internal.claim));
 	bdev->internal.qd_poller = NULL;
 	bdev->internal.qos = NULL;
+	bdev->internal.histogram_enabled = g_bdev_opts.bdev_histogram_enable;
+	bdev->internal.stat_sub_period = 0;
+	TAILQ_INIT(&bdev->internal.stat_sub_channels);
 
 	TAILQ_INIT(&bdev->internal.open_descs);
 	TAILQ_INIT(&bdev->internal.locked_ranges);
@@ -8483,7 +9245,7 @@ spdk_bdev_register(struct spdk_bdev *bdev)
 	/* Examine configuration before initializing I/O */
 	bdev_examine(bdev);
 
-	rc = spdk_bdev_wait_for_examine(bdev_register_finished, desc);
+	rc = bdev_wait_for_examine_bdev(bdev, bdev_register_finished, desc);
 	if (rc != 0) {
 		bdev_close(bdev, desc);
 		spdk_bdev_unregister(bdev, NULL, NULL);
@@ -9058,6 +9820,60 @@ spdk_bdev_io_get_cb_arg(struct spdk_bdev_io *bdev_io)
 	return bdev_io->internal.caller_ctx;
 }
 
+bool
+spdk_bdev_io_get_success(struct spdk_bdev_io *bdev_io)
+{
+	if (bdev_io == NULL) {
+		assert(false);
+		return false;
+	}
+
+	return bdev_io->internal.status == SPDK_BDEV_IO_STATUS_SUCCESS;
+}
+
+int
+spdk_bdev_channel_enable_batched_completions(struct spdk_io_channel *ch,
+		spdk_bdev_io_completion_cb_batch cb, void *cb_arg)
+{
+	struct spdk_bdev_channel *bdev_ch = __io_ch_to_bdev_ch(ch);
+
+	if (cb == NULL || (bdev_ch->flags & BDEV_CH_BATCHED_COMPLETIONS)) {
+		return -EINVAL;
+	}
+
+	assert(spdk_io_channel_get_thread(ch) == spdk_get_thread());
+
+	bdev_ch->completion_batch_cb = cb;
+	bdev_ch->completion_batch_ctx = cb_arg;
+	bdev_ch->completion_batch_count = 0;
+	bdev_ch->completion_batch_poller = SPDK_POLLER_REGISTER(bdev_ch_completion_batch_poll,
+					   bdev_ch, 0);
+	if (bdev_ch->completion_batch_poller == NULL) {
+		return -ENOMEM;
+	}
+
+	bdev_ch->flags |= BDEV_CH_BATCHED_COMPLETIONS;
+	return 0;
+}
+
+void
+spdk_bdev_channel_disable_batched_completions(struct spdk_io_channel *ch)
+{
+	struct spdk_bdev_channel *bdev_ch = __io_ch_to_bdev_ch(ch);
+
+	if (!(bdev_ch->flags & BDEV_CH_BATCHED_COMPLETIONS)) {
+		return;
+	}
+
+	assert(spdk_io_channel_get_thread(ch) == spdk_get_thread());
+
+	bdev_ch->flags &= ~BDEV_CH_BATCHED_COMPLETIONS;
+	bdev_ch_flush_completion_batch(bdev_ch);
+	spdk_poller_unregister(&bdev_ch->completion_batch_poller);
+	bdev_ch->completion_batch_cb = NULL;
+	bdev_ch->completion_batch_ctx = NULL;
+}
+
 void
 spdk_bdev_module_list_add(struct spdk_bdev_module *bdev_module)
 {
@@ -29,6 +29,7 @@ static const struct spdk_json_object_decoder rpc_set_bdev_opts_decoders[] = {
 	{"bdev_auto_examine", offsetof(struct spdk_bdev_opts, bdev_auto_examine), spdk_json_decode_bool, true},
 	{"iobuf_small_cache_size", offsetof(struct spdk_bdev_opts, iobuf_small_cache_size), spdk_json_decode_uint32, true},
 	{"iobuf_large_cache_size", offsetof(struct spdk_bdev_opts, iobuf_large_cache_size), spdk_json_decode_uint32, true},
+	{"bdev_histogram_enable", offsetof(struct spdk_bdev_opts, bdev_histogram_enable), spdk_json_decode_bool, true},
 };
 
 static void
@@ -435,7 +436,10 @@ rpc_bdev_get_iostat(struct spdk_jsonrpc_request *request,
 
 	rpc_get_iostat_done(rpc_ctx);
 }
-SPDK_RPC_REGISTER("bdev_get_iostat", rpc_bdev_get_iostat, SPDK_RPC_RUNTIME)
+/* Read-only stat aggregation - may run on an RPC worker thread so that it does
+ * not delay mutating RPCs queued on the polling thread. */
+SPDK_RPC_REGISTER_EXT("bdev_get_iostat", rpc_bdev_get_iostat, SPDK_RPC_RUNTIME,
+		      SPDK_RPC_METHOD_FLAG_CONCURRENT)
 
 struct rpc_reset_iostat_ctx {
 	int bdev_count;
@@ -749,6 +753,25 @@ rpc_dump_bdev_info(void *ctx, struct spdk_bdev *bdev)
 	return 0;
 }
 
+struct rpc_dump_all_bdevs_ctx {
+	struct spdk_jsonrpc_request	*request;
+	struct spdk_json_write_ctx	*w;
+};
+
+static int
+rpc_dump_bdev_info_flush(void *ctx, struct spdk_bdev *bdev)
+{
+	struct rpc_dump_all_bdevs_ctx *dump_ctx = ctx;
+
+	rpc_dump_bdev_info(dump_ctx->w, bdev);
+	/* Flush each bdev to the connection as it is serialized, so that a large
+	 * response starts reaching the client immediately and is never buffered
+	 * in its entirety. */
+	spdk_jsonrpc_flush_result(dump_ctx->request, dump_ctx->w);
+
+	return 0;
+}
+
 struct rpc_bdev_get_bdevs {
 	char		*name;
 	uint64_t	timeout;
@@ -798,6 +821,7 @@ rpc_bdev_get_bdevs(struct spdk_jsonrpc_request *request,
 {
 	struct rpc_bdev_get_bdevs req = {};
 	struct spdk_bdev_open_async_opts opts = {};
+	struct rpc_dump_all_bdevs_ctx dump_ctx;
 	struct spdk_json_write_ctx *w;
 	int rc;
 
@@ -831,7 +855,9 @@ rpc_bdev_get_bdevs(struct spdk_jsonrpc_request *request,
 	w = spdk_jsonrpc_begin_result(request);
 	spdk_json_write_array_begin(w);
 
-	spdk_for_each_bdev(w, rpc_dump_bdev_info);
+	dump_ctx.request = request;
+	dump_ctx.w = w;
+	spdk_for_each_bdev(&dump_ctx, rpc_dump_bdev_info_flush);
 
 	spdk_json_write_array_end(w);
 
@@ -892,6 +918,59 @@ SPDK_RPC_REGISTER("bdev_set_qd_sampling_period",
 		  rpc_bdev_set_qd_sampling_period,
 		  SPDK_RPC_RUNTIME)
 
+struct rpc_bdev_set_stat_subscription_period {
+	char *name;
+	uint64_t period;
+};
+
+static void
+free_rpc_bdev_set_stat_subscription_period(struct rpc_bdev_set_stat_subscription_period *r)
+{
+	free(r->name);
+}
+
+static const struct spdk_json_object_decoder
+	rpc_bdev_set_stat_subscription_period_decoders[] = {
+	{"name", offsetof(struct rpc_bdev_set_stat_subscription_period, name), spdk_json_decode_string},
+	{"period", offsetof(struct rpc_bdev_set_stat_subscription_period, period), spdk_json_decode_uint64},
+};
+
+static void
+rpc_bdev_set_stat_subscription_period(struct spdk_jsonrpc_request *request,
+				      const struct spdk_json_val *params)
+{
+	struct rpc_bdev_set_stat_subscription_period req = {0};
+	struct spdk_bdev_desc *desc;
+	int rc;
+
+	if (spdk_json_decode_object(params, rpc_bdev_set_stat_subscription_period_decoders,
+				    SPDK_COUNTOF(rpc_bdev_set_stat_subscription_period_decoders),
+				    &req)) {
+		SPDK_ERRLOG("spdk_json_decode_object failed\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "spdk_json_decode_object failed");
+		goto cleanup;
+	}
+
+	rc = spdk_bdev_open_ext(req.name, false, dummy_bdev_event_cb, NULL, &desc);
+	if (rc != 0) {
+		SPDK_ERRLOG("Failed to open bdev '%s': %d\n", req.name, rc);
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+		goto cleanup;
+	}
+
+	spdk_bdev_set_stat_subscription_period(spdk_bdev_desc_get_bdev(desc), req.period);
+	spdk_jsonrpc_send_bool_response(request, true);
+
+	spdk_bdev_close(desc);
+
+cleanup:
+	free_rpc_bdev_set_stat_subscription_period(&req);
+}
+SPDK_RPC_REGISTER("bdev_set_stat_subscription_period",
+		  rpc_bdev_set_stat_subscription_period,
+		  SPDK_RPC_RUNTIME)
+
 struct rpc_bdev_set_qos_limit {
 	char		*name;
 	uint64_t	limits[SPDK_BDEV_QOS_NUM_RATE_LIMIT_TYPES];
@@ -1157,3 +1236,136 @@ cleanup:
 }
 
 SPDK_RPC_REGISTER("bdev_get_histogram", rpc_bdev_get_histogram, SPDK_RPC_RUNTIME)
+
+/* SPDK_RPC_BDEV_GET_LATENCY_PERCENTILES */
+
+struct rpc_bdev_get_latency_percentiles_request {
+	char *name;
+};
+
+static const struct spdk_json_object_decoder rpc_bdev_get_latency_percentiles_request_decoders[] = {
+	{"name", offsetof(struct rpc_bdev_get_latency_percentiles_request, name), spdk_json_decode_string}
+};
+
+static void
+free_rpc_bdev_get_latency_percentiles_request(struct rpc_bdev_get_latency_percentiles_request *r)
+{
+	free(r->name);
+}
+
+static const double g_latency_percentiles[] = {50.0, 99.0, 99.9};
+
+struct rpc_latency_percentiles_ctx {
+	struct spdk_jsonrpc_request *request;
+	/* Upper bound, in ticks, of the bucket that crossed each percentile. */
+	uint64_t values[SPDK_COUNTOF(g_latency_percentiles)];
+	size_t cur;
+};
+
+static void
+_rpc_bdev_latency_percentile_cutoff(void *cb_arg, uint64_t start, uint64_t end, uint64_t count,
+				    uint64_t total, uint64_t so_far)
+{
+	struct rpc_latency_percentiles_ctx *ctx = cb_arg;
+	double so_far_pct;
+
+	if (count == 0) {
+		return;
+	}
+
+	so_far_pct = (double)so_far * 100 / total;
+	while (ctx->cur < SPDK_COUNTOF(g_latency_percentiles) &&
+	       so_far_pct >= g_latency_percentiles[ctx->cur]) {
+		ctx->values[ctx->cur++] = end;
+	}
+}
+
+static void
+_rpc_bdev_latency_percentiles_cb(void *cb_arg, int status, struct spdk_histogram_data *histogram)
+{
+	struct rpc_latency_percentiles_ctx *ctx = cb_arg;
+	struct spdk_json_write_ctx *w;
+	uint64_t tsc_rate = spdk_get_ticks_hz();
+	size_t i;
+
+	if (status != 0) {
+		spdk_jsonrpc_send_error_response(ctx->request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 spdk_strerror(-status));
+		goto out;
+	}
+
+	spdk_histogram_data_iterate(histogram, _rpc_bdev_latency_percentile_cutoff, ctx);
+
+	w = spdk_jsonrpc_begin_result(ctx->request);
+	spdk_json_write_object_begin(w);
+	spdk_json_write_named_uint64(w, "tsc_rate", tsc_rate);
+	spdk_json_write_named_array_begin(w, "percentiles");
+	for (i = 0; i < SPDK_COUNTOF(g_latency_percentiles); i++) {
+		spdk_json_write_object_begin(w);
+		spdk_json_write_named_double(w, "percentile", g_latency_percentiles[i]);
+		spdk_json_write_named_uint64(w, "value_ticks", ctx->values[i]);
+		spdk_json_write_named_double(w, "value_us",
+					     (double)ctx->values[i] * SPDK_SEC_TO_USEC / tsc_rate);
+		spdk_json_write_object_end(w);
+	}
+	spdk_json_write_array_end(w);
+	spdk_json_write_object_end(w);
+	spdk_jsonrpc_end_result(ctx->request, w);
+
+out:
+	spdk_histogram_data_free(histogram);
+	free(ctx);
+}
+
+static void
+rpc_bdev_get_latency_percentiles(struct spdk_jsonrpc_request *request,
+				 const struct spdk_json_val *params)
+{
+	struct rpc_bdev_get_latency_percentiles_request req = {NULL};
+	struct rpc_latency_percentiles_ctx *ctx;
+	struct spdk_histogram_data *histogram;
+	struct spdk_bdev_desc *desc;
+	int rc;
+
+	if (spdk_json_decode_object(params, rpc_bdev_get_latency_percentiles_request_decoders,
+				    SPDK_COUNTOF(rpc_bdev_get_latency_percentiles_request_decoders),
+				    &req)) {
+		SPDK_ERRLOG("spdk_json_decode_object failed\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "spdk_json_decode_object failed");
+		goto cleanup;
+	}
+
+	rc = spdk_bdev_open_ext(req.name, false, dummy_bdev_event_cb, NULL, &desc);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+		goto cleanup;
+	}
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		spdk_bdev_close(desc);
+		spdk_jsonrpc_send_error_response(request, -ENOMEM, spdk_strerror(ENOMEM));
+		goto cleanup;
+	}
+	ctx->request = request;
+
+	histogram = spdk_histogram_data_alloc();
+	if (histogram == NULL) {
+		free(ctx);
+		spdk_bdev_close(desc);
+		spdk_jsonrpc_send_error_response(request, -ENOMEM, spdk_strerror(ENOMEM));
+		goto cleanup;
+	}
+
+	spdk_bdev_histogram_get(spdk_bdev_desc_get_bdev(desc), histogram,
+				_rpc_bdev_latency_percentiles_cb, ctx);
+
+	spdk_bdev_close(desc);
+
+cleanup:
+	free_rpc_bdev_get_latency_percentiles_request(&req);
+}
+
+SPDK_RPC_REGISTER("bdev_get_latency_percentiles", rpc_bdev_get_latency_percentiles,
+		  SPDK_RPC_RUNTIME)
@@ -89,6 +89,38 @@ spdk_bdev_get_zone_info(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
 	return 0;
 }
 
+int
+spdk_bdev_get_zone_info_rle(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
+			    uint64_t zone_id, size_t num_zones, struct spdk_bdev_zone_run *runs,
+			    size_t max_runs, spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	struct spdk_bdev *bdev = spdk_bdev_desc_get_bdev(desc);
+	struct spdk_bdev_io *bdev_io;
+	struct spdk_bdev_channel *channel = spdk_io_channel_get_ctx(ch);
+
+	if (max_runs == 0) {
+		return -EINVAL;
+	}
+
+	bdev_io = bdev_channel_get_io(channel);
+	if (!bdev_io) {
+		return -ENOMEM;
+	}
+
+	bdev_io->internal.ch = channel;
+	bdev_io->internal.desc = desc;
+	bdev_io->type = SPDK_BDEV_IO_TYPE_GET_ZONE_INFO_RLE;
+	bdev_io->u.zone_mgmt.zone_id = zone_id;
+	bdev_io->u.zone_mgmt.num_zones = num_zones;
+	bdev_io->u.zone_mgmt.buf = runs;
+	bdev_io->u.zone_mgmt.max_runs = max_runs;
+	bdev_io->u.zone_mgmt.num_runs = 0;
+	bdev_io_init(bdev_io, bdev, cb_arg, cb);
+
+	bdev_io_submit(bdev_io);
+	return 0;
+}
+
 int
 spdk_bdev_zone_management(struct spdk_bdev_desc *desc, struct spdk_io_channel *ch,
 			  uint64_t zone_id, enum spdk_bdev_zone_action action,
@@ -206,3 +238,9 @@ spdk_bdev_io_get_append_location(struct spdk_bdev_io *bdev_io)
 {
 	return bdev_io->u.bdev.offset_blocks;
 }
+
+uint32_t
+spdk_bdev_io_get_num_zone_runs(struct spdk_bdev_io *bdev_io)
+{
+	return bdev_io->u.zone_mgmt.num_runs;
+}
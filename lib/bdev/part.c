@@ -16,6 +16,8 @@
 
 #include "spdk/bdev_module.h"
 
+#include "bdev_internal.h"
+
 /* This namespace UUID was generated using uuid_generate() method. */
 #define BDEV_PART_NAMESPACE_UUID "976b899e-3e1e-4d71-ab69-c2b08e9df8b8"
 
@@ -24,6 +24,9 @@
 
 #define BLOB_CRC32C_INITIAL    0xffffffffUL
 
+/* Number of md pages fetched per read while replaying metadata at load. */
+#define BS_LOAD_MD_SCAN_BATCH	64
+
 static int bs_register_md_thread(struct spdk_blob_store *bs);
 static int bs_unregister_md_thread(struct spdk_blob_store *bs);
 static void blob_close_cpl(spdk_bs_sequence_t *seq, void *cb_arg, int bserrno);
@@ -135,7 +138,9 @@ bs_claim_cluster(struct spdk_blob_store *bs)
 	}
 
 	SPDK_DEBUGLOG(blob, "Claiming cluster %u\n", cluster_num);
-	bs->num_free_clusters--;
+	/* Channels hand out reserved clusters without the lock, so all updates
+	 * of the free cluster count must be atomic. */
+	__atomic_fetch_sub(&bs->num_free_clusters, 1, __ATOMIC_SEQ_CST);
 
 	return cluster_num;
 }
@@ -151,7 +156,172 @@ bs_release_cluster(struct spdk_blob_store *bs, uint32_t cluster_num)
 	SPDK_DEBUGLOG(blob, "Releasing cluster %u\n", cluster_num);
 
 	spdk_bit_pool_free_bit(bs->used_clusters, cluster_num);
-	bs->num_free_clusters++;
+	__atomic_fetch_add(&bs->num_free_clusters, 1, __ATOMIC_SEQ_CST);
+}
+
+static void
+bs_release_cluster_range(struct spdk_blob_store *bs, uint32_t cluster_num, uint32_t count)
+{
+	assert(spdk_spin_held(&bs->used_lock));
+	assert(cluster_num + count <= spdk_bit_pool_capacity(bs->used_clusters));
+	assert(count <= bs->total_clusters - bs->num_free_clusters);
+
+	SPDK_DEBUGLOG(blob, "Releasing clusters %u-%u\n", cluster_num, cluster_num + count - 1);
+
+	spdk_bit_pool_free_range(bs->used_clusters, cluster_num, count);
+	__atomic_fetch_add(&bs->num_free_clusters, count, __ATOMIC_SEQ_CST);
+}
+
+static uint32_t
+bs_channel_claim_cluster(struct spdk_bs_channel *ch)
+{
+	struct spdk_blob_store *bs = ch->bs;
+	uint32_t batch, cluster_num;
+
+	if (ch->cluster_cache_count == 0) {
+		spdk_spin_lock(&bs->used_lock);
+		/* Shrink the batch as the pool drains so the reservations cannot
+		 * keep the last free clusters away from the other channels. */
+		batch = spdk_min(SPDK_BLOB_CLUSTER_CACHE_SIZE, bs->num_free_clusters / 4 + 1);
+		while (ch->cluster_cache_count < batch) {
+			cluster_num = spdk_bit_pool_allocate_bit(bs->used_clusters);
+			if (cluster_num == UINT32_MAX) {
+				break;
+			}
+			ch->cluster_cache[ch->cluster_cache_count++] = cluster_num;
+		}
+		spdk_spin_unlock(&bs->used_lock);
+		if (ch->cluster_cache_count == 0) {
+			return UINT32_MAX;
+		}
+	}
+
+	cluster_num = ch->cluster_cache[--ch->cluster_cache_count];
+	SPDK_DEBUGLOG(blob, "Claiming reserved cluster %u\n", cluster_num);
+	/* Reserved clusters stay counted as free until they are handed out,
+	 * so spdk_bs_free_cluster_count() does not see the reservations. */
+	__atomic_fetch_sub(&bs->num_free_clusters, 1, __ATOMIC_SEQ_CST);
+
+	return cluster_num;
+}
+
+static void
+bs_channel_release_cluster(struct spdk_bs_channel *ch, uint32_t cluster_num)
+{
+	struct spdk_blob_store *bs = ch->bs;
+
+	if (ch->cluster_cache_count < SPDK_BLOB_CLUSTER_CACHE_SIZE) {
+		SPDK_DEBUGLOG(blob, "Releasing cluster %u to the channel cache\n", cluster_num);
+		ch->cluster_cache[ch->cluster_cache_count++] = cluster_num;
+		__atomic_fetch_add(&bs->num_free_clusters, 1, __ATOMIC_SEQ_CST);
+		return;
+	}
+
+	spdk_spin_lock(&bs->used_lock);
+	bs_release_cluster(bs, cluster_num);
+	spdk_spin_unlock(&bs->used_lock);
+}
+
+/* Track the blob's sequential write streak and hand out a cluster reserved
+ * ahead of the stream.  Returns UINT32_MAX when preallocation is disabled, the
+ * streak is too short or the pool is exhausted. */
+static uint32_t
+blob_seq_prealloc_claim(struct spdk_blob *blob, uint32_t cluster_num)
+{
+	struct spdk_blob_store *bs = blob->bs;
+	uint32_t cluster = UINT32_MAX;
+	uint32_t count, n;
+
+	if (bs->cluster_prealloc_count == 0) {
+		return UINT32_MAX;
+	}
+
+	spdk_spin_lock(&bs->used_lock);
+	if (cluster_num == blob->seq_write_next_cluster) {
+		blob->seq_write_streak++;
+	} else {
+		blob->seq_write_streak = 1;
+	}
+	blob->seq_write_next_cluster = (uint64_t)cluster_num + 1;
+
+	if (blob->prealloc_next == blob->prealloc_count &&
+	    blob->seq_write_streak >= SPDK_BLOB_SEQ_PREALLOC_THRESHOLD) {
+		if (blob->prealloc_clusters == NULL) {
+			blob->prealloc_clusters = calloc(bs->cluster_prealloc_count,
+							 sizeof(*blob->prealloc_clusters));
+		}
+		if (blob->prealloc_clusters != NULL) {
+			/* Shrink the run as the pool drains so a stream cannot hold
+			 * the last free clusters away from other blobs. */
+			count = spdk_min(bs->cluster_prealloc_count,
+					 bs->num_free_clusters / 4 + 1);
+			blob->prealloc_count = 0;
+			blob->prealloc_next = 0;
+			for (n = 0; n < count; n++) {
+				cluster = spdk_bit_pool_allocate_bit(bs->used_clusters);
+				if (cluster == UINT32_MAX) {
+					break;
+				}
+				blob->prealloc_clusters[blob->prealloc_count++] = cluster;
+			}
+			cluster = UINT32_MAX;
+		}
+	}
+
+	/* Consume in allocation order to keep a stream's clusters contiguous. */
+	if (blob->prealloc_next < blob->prealloc_count) {
+		cluster = blob->prealloc_clusters[blob->prealloc_next++];
+	}
+	spdk_spin_unlock(&bs->used_lock);
+
+	if (cluster != UINT32_MAX) {
+		SPDK_DEBUGLOG(blob, "Claiming preallocated cluster %u for blob 0x%" PRIx64 "\n",
+			      cluster, blob->id);
+		/* Like the channel reservations, preallocated clusters stay counted
+		 * as free until they are handed out. */
+		__atomic_fetch_sub(&bs->num_free_clusters, 1, __ATOMIC_SEQ_CST);
+	}
+
+	return cluster;
+}
+
+static void
+blob_release_prealloc_clusters(struct spdk_blob *blob)
+{
+	struct spdk_blob_store *bs = blob->bs;
+
+	if (blob->prealloc_clusters == NULL) {
+		return;
+	}
+
+	spdk_spin_lock(&bs->used_lock);
+	while (blob->prealloc_next < blob->prealloc_count) {
+		/* The reservations are still counted as free, so only the bit
+		 * pool needs to be unwound here. */
+		spdk_bit_pool_free_bit(bs->used_clusters,
+				       blob->prealloc_clusters[blob->prealloc_next++]);
+	}
+	spdk_spin_unlock(&bs->used_lock);
+
+	free(blob->prealloc_clusters);
+	blob->prealloc_clusters = NULL;
+	blob->prealloc_count = 0;
+	blob->prealloc_next = 0;
+}
+
+static void
+bs_channel_release_reserved_clusters(struct spdk_bs_channel *ch)
+{
+	struct spdk_blob_store *bs = ch->bs;
+
+	spdk_spin_lock(&bs->used_lock);
+	while (ch->cluster_cache_count > 0) {
+		/* Reserved clusters are still counted as free, so only the bit
+		 * pool needs to be unwound here. */
+		spdk_bit_pool_free_bit(bs->used_clusters,
+				       ch->cluster_cache[--ch->cluster_cache_count]);
+	}
+	spdk_spin_unlock(&bs->used_lock);
 }
 
 static int
@@ -217,6 +387,53 @@ bs_allocate_cluster(struct spdk_blob *blob, uint32_t cluster_num,
 	return 0;
 }
 
+/* Like bs_allocate_cluster() with update_map false, but draws the cluster from the
+ * channel's reservation cache so bs->used_lock is only taken for a cache refill or
+ * a new extent page. */
+static int
+bs_channel_allocate_cluster(struct spdk_blob *blob, struct spdk_bs_channel *ch,
+			    uint32_t cluster_num, uint64_t *cluster, uint32_t *lowest_free_md_page)
+{
+	struct spdk_blob_store *bs = blob->bs;
+	uint32_t *extent_page;
+
+	*cluster = blob_seq_prealloc_claim(blob, cluster_num);
+	if (*cluster == UINT32_MAX) {
+		*cluster = bs_channel_claim_cluster(ch);
+	}
+	if (*cluster == UINT32_MAX) {
+		/* No more free clusters. Cannot satisfy the request */
+		return -ENOSPC;
+	}
+
+	if (blob->use_extent_table) {
+		extent_page = bs_cluster_to_extent_page(blob, cluster_num);
+		if (*extent_page == 0) {
+			/* Extent page shall never occupy md_page so start the search from 1 */
+			if (*lowest_free_md_page == 0) {
+				*lowest_free_md_page = 1;
+			}
+			spdk_spin_lock(&bs->used_lock);
+			/* No extent_page is allocated for the cluster */
+			*lowest_free_md_page = spdk_bit_array_find_first_clear(bs->used_md_pages,
+					       *lowest_free_md_page);
+			if (*lowest_free_md_page == UINT32_MAX) {
+				/* No more free md pages. Cannot satisfy the request */
+				spdk_spin_unlock(&bs->used_lock);
+				bs_channel_release_cluster(ch, *cluster);
+				return -ENOSPC;
+			}
+			bs_claim_md_page(bs, *lowest_free_md_page);
+			spdk_spin_unlock(&bs->used_lock);
+		}
+	}
+
+	SPDK_DEBUGLOG(blob, "Claiming cluster %" PRIu64 " for blob 0x%" PRIx64 "\n", *cluster,
+		      blob->id);
+
+	return 0;
+}
+
 static void
 blob_xattrs_init(struct spdk_blob_xattr_opts *xattrs)
 {
@@ -353,6 +570,8 @@ blob_free(struct spdk_blob *blob)
 	free(blob->clean.extent_pages);
 	free(blob->active.clusters);
 	free(blob->clean.clusters);
+	spdk_free(blob->last_md);
+	free(blob->prealloc_clusters);
 	free(blob->active.pages);
 	free(blob->clean.pages);
 
@@ -360,6 +579,7 @@ blob_free(struct spdk_blob *blob)
 	xattrs_free(&blob->xattrs_internal);
 
 	if (blob->back_bs_dev) {
+		blob->bs->back_bs_dev_gen++;
 		blob->back_bs_dev->destroy(blob->back_bs_dev);
 	}
 
@@ -405,6 +625,8 @@ blob_back_bs_destroy(struct spdk_blob *blob)
 	SPDK_DEBUGLOG(blob_esnap, "blob 0x%" PRIx64 ": preparing to destroy back_bs_dev\n",
 		      blob->id);
 
+	/* Cached chain lookups in the channels may point at the destroyed dev */
+	blob->bs->back_bs_dev_gen++;
 	blob_esnap_destroy_bs_dev_channels(blob, false, blob_back_bs_destroy_esnap_done,
 					   blob->back_bs_dev);
 	blob->back_bs_dev = NULL;
@@ -564,38 +786,14 @@ blob_unfreeze_io(struct spdk_blob *blob, spdk_blob_op_complete cb_fn, void *cb_a
 static int
 blob_mark_clean(struct spdk_blob *blob)
 {
-	uint32_t *extent_pages = NULL;
-	uint64_t *clusters = NULL;
 	uint32_t *pages = NULL;
 
 	assert(blob != NULL);
 
-	if (blob->active.num_extent_pages) {
-		assert(blob->active.extent_pages);
-		extent_pages = calloc(blob->active.num_extent_pages, sizeof(*blob->active.extent_pages));
-		if (!extent_pages) {
-			return -ENOMEM;
-		}
-		memcpy(extent_pages, blob->active.extent_pages,
-		       blob->active.num_extent_pages * sizeof(*extent_pages));
-	}
-
-	if (blob->active.num_clusters) {
-		assert(blob->active.clusters);
-		clusters = calloc(blob->active.num_clusters, sizeof(*blob->active.clusters));
-		if (!clusters) {
-			free(extent_pages);
-			return -ENOMEM;
-		}
-		memcpy(clusters, blob->active.clusters, blob->active.num_clusters * sizeof(*blob->active.clusters));
-	}
-
 	if (blob->active.num_pages) {
 		assert(blob->active.pages);
 		pages = calloc(blob->active.num_pages, sizeof(*blob->active.pages));
 		if (!pages) {
-			free(extent_pages);
-			free(clusters);
 			return -ENOMEM;
 		}
 		memcpy(pages, blob->active.pages, blob->active.num_pages * sizeof(*blob->active.pages));
@@ -605,16 +803,20 @@ blob_mark_clean(struct spdk_blob *blob)
 	free(blob->clean.clusters);
 	free(blob->clean.pages);
 
+	/* Only the md page list of the clean state is consulted after a persist,
+	 * so the cluster map and extent page arrays are tracked by size alone and
+	 * are not duplicated.  The cluster map dominates the memory footprint of
+	 * a large open blob (8 bytes per cluster) and keeping one copy instead of
+	 * two halves it.
+	 */
 	blob->clean.num_extent_pages = blob->active.num_extent_pages;
-	blob->clean.extent_pages = blob->active.extent_pages;
+	blob->clean.extent_pages = NULL;
 	blob->clean.num_clusters = blob->active.num_clusters;
-	blob->clean.clusters = blob->active.clusters;
+	blob->clean.clusters = NULL;
 	blob->clean.num_allocated_clusters = blob->active.num_allocated_clusters;
 	blob->clean.num_pages = blob->active.num_pages;
 	blob->clean.pages = blob->active.pages;
 
-	blob->active.extent_pages = extent_pages;
-	blob->active.clusters = clusters;
 	blob->active.pages = pages;
 
 	/* If the metadata was dirtied again while the metadata was being written to disk,
@@ -1434,6 +1636,15 @@ blob_md_page_calc_crc(void *page)
 
 }
 
+static bool
+blob_md_page_equal(const struct spdk_blob_md_page *a, const struct spdk_blob_md_page *b)
+{
+	/* The next and crc fields are skipped - they depend on where the
+	 * following pages land, not on the serialized metadata itself. */
+	return a->id == b->id && a->sequence_num == b->sequence_num &&
+	       memcmp(a->descriptors, b->descriptors, sizeof(a->descriptors)) == 0;
+}
+
 static void
 blob_load_final(struct spdk_blob_load_ctx *ctx, int bserrno)
 {
@@ -1782,6 +1993,10 @@ struct spdk_blob_persist_ctx {
 	struct spdk_blob		*blob;
 
 	struct spdk_blob_md_page	*pages;
+	uint32_t			num_pages;
+	/* Number of leading chain pages that match the last persisted
+	 * serialization and stay at their on-disk location. */
+	uint32_t			md_prefix;
 	uint32_t			next_extent_page;
 	struct spdk_blob_md_page	*extent_page;
 
@@ -1876,6 +2091,17 @@ blob_persist_complete(spdk_bs_sequence_t *seq, struct spdk_blob_persist_ctx *ctx
 
 	if (bserrno == 0) {
 		blob_mark_clean(blob);
+		/* Keep the serialization that is now on disk, so the next persist
+		 * can skip rewriting the pages that did not change. */
+		spdk_free(blob->last_md);
+		blob->last_md = ctx->pages;
+		blob->last_md_count = ctx->num_pages;
+		ctx->pages = NULL;
+	} else {
+		/* The on-disk state is unknown - do not reuse any pages. */
+		spdk_free(blob->last_md);
+		blob->last_md = NULL;
+		blob->last_md_count = 0;
 	}
 
 	assert(ctx == TAILQ_FIRST(&blob->persists_to_complete));
@@ -1973,6 +2199,7 @@ blob_persist_clear_clusters_cpl(spdk_bs_sequence_t *seq, void *cb_arg, int bserr
 	struct spdk_blob_persist_ctx	*ctx = cb_arg;
 	struct spdk_blob		*blob = ctx->blob;
 	struct spdk_blob_store		*bs = blob->bs;
+	uint32_t			run_start, run_count;
 	size_t				i;
 
 	if (bserrno != 0) {
@@ -1981,14 +2208,36 @@ blob_persist_clear_clusters_cpl(spdk_bs_sequence_t *seq, void *cb_arg, int bserr
 	}
 
 	spdk_spin_lock(&bs->used_lock);
-	/* Release all clusters that were truncated */
+	/* Release all clusters that were truncated.  Consecutive cluster runs
+	 * are freed with a single word-at-a-time bit operation, so deleting a
+	 * large blob does not hold up allocators on the used_lock for a bit
+	 * flip per cluster.
+	 */
+	run_start = 0;
+	run_count = 0;
 	for (i = blob->active.num_clusters; i < blob->active.cluster_array_size; i++) {
-		uint32_t cluster_num = bs_lba_to_cluster(bs, blob->active.clusters[i]);
+		uint32_t cluster_num;
 
 		/* Nothing to release if it was not allocated */
-		if (blob->active.clusters[i] != 0) {
-			bs_release_cluster(bs, cluster_num);
+		if (blob->active.clusters[i] == 0) {
+			continue;
 		}
+
+		cluster_num = bs_lba_to_cluster(bs, blob->active.clusters[i]);
+		if (run_count > 0 && cluster_num == run_start + run_count) {
+			/* This cluster is contiguous with the previous run. */
+			run_count++;
+			continue;
+		}
+
+		if (run_count > 0) {
+			bs_release_cluster_range(bs, run_start, run_count);
+		}
+		run_start = cluster_num;
+		run_count = 1;
+	}
+	if (run_count > 0) {
+		bs_release_cluster_range(bs, run_start, run_count);
 	}
 	spdk_spin_unlock(&bs->used_lock);
 
@@ -2083,11 +2332,11 @@ blob_persist_zero_pages_cpl(spdk_bs_sequence_t *seq, void *cb_arg, int bserrno)
 
 	spdk_spin_lock(&bs->used_lock);
 
-	/* This loop starts at 1 because the first page is special and handled
-	 * below. The pages (except the first) are never written in place,
-	 * so any pages in the clean list must be zeroed.
+	/* Pages in the reused prefix kept their location, so only release the
+	 * pages of the old chain that were replaced.  The first page is special
+	 * and handled below.
 	 */
-	for (i = 1; i < blob->clean.num_pages; i++) {
+	for (i = spdk_max(ctx->md_prefix, 1); i < blob->clean.num_pages; i++) {
 		bs_release_md_page(bs, blob->clean.pages[i]);
 	}
 
@@ -2124,11 +2373,11 @@ blob_persist_zero_pages(spdk_bs_sequence_t *seq, void *cb_arg, int bserrno)
 
 	lba_count = bs_byte_to_lba(bs, SPDK_BS_PAGE_SIZE);
 
-	/* This loop starts at 1 because the first page is special and handled
-	 * below. The pages (except the first) are never written in place,
-	 * so any pages in the clean list must be zeroed.
+	/* Pages in the reused prefix kept their location and are still part of
+	 * the chain, so only zero the pages of the old chain that were replaced.
+	 * The first page is special and handled below.
 	 */
-	for (i = 1; i < blob->clean.num_pages; i++) {
+	for (i = spdk_max(ctx->md_prefix, 1); i < blob->clean.num_pages; i++) {
 		lba = bs_md_page_to_lba(bs, blob->clean.pages[i]);
 
 		bs_batch_write_zeroes_dev(batch, lba, lba_count);
@@ -2149,7 +2398,7 @@ blob_persist_zero_pages(spdk_bs_sequence_t *seq, void *cb_arg, int bserrno)
 }
 
 static void
-blob_persist_write_page_root(spdk_bs_sequence_t *seq, void *cb_arg, int bserrno)
+blob_persist_write_page_boundary(spdk_bs_sequence_t *seq, void *cb_arg, int bserrno)
 {
 	struct spdk_blob_persist_ctx	*ctx = cb_arg;
 	struct spdk_blob		*blob = ctx->blob;
@@ -2169,11 +2418,27 @@ blob_persist_write_page_root(spdk_bs_sequence_t *seq, void *cb_arg, int bserrno)
 		return;
 	}
 
+	if (ctx->md_prefix == blob->active.num_pages &&
+	    ctx->md_prefix == blob->clean.num_pages) {
+		/* The serialized metadata is identical to what is already on
+		 * disk - there is nothing to write. */
+		blob_persist_zero_pages(seq, ctx, 0);
+		return;
+	}
+
 	lba_count = bs_byte_to_lba(bs, sizeof(*page));
 
-	page = &ctx->pages[0];
-	/* The first page in the metadata goes where the blobid indicates */
-	lba = bs_md_page_to_lba(bs, bs_blobid_to_page(blob->id));
+	/* The boundary page is the last page of the reused prefix, or the root
+	 * page when nothing could be reused.  It is written in place as the
+	 * final step, atomically linking the freshly written tail pages into
+	 * the chain.  The root page location is fixed by the blobid. */
+	if (ctx->md_prefix > 0) {
+		page = &ctx->pages[ctx->md_prefix - 1];
+		lba = bs_md_page_to_lba(bs, blob->active.pages[ctx->md_prefix - 1]);
+	} else {
+		page = &ctx->pages[0];
+		lba = bs_md_page_to_lba(bs, bs_blobid_to_page(blob->id));
+	}
 
 	bs_sequence_write_dev(seq, page, lba, lba_count,
 			      blob_persist_zero_pages, ctx);
@@ -2196,12 +2461,13 @@ blob_persist_write_page_chain(spdk_bs_sequence_t *seq, struct spdk_blob_persist_
 
 	lba_count = bs_byte_to_lba(bs, sizeof(*page));
 
-	batch = bs_sequence_to_batch(seq, blob_persist_write_page_root, ctx);
+	batch = bs_sequence_to_batch(seq, blob_persist_write_page_boundary, ctx);
 
-	/* This starts at 1. The root page is not written until
-	 * all of the others are finished
+	/* Only the pages after the reused prefix are written, and never in
+	 * place.  The boundary page linking them into the chain is not written
+	 * until all of the others are finished.
 	 */
-	for (i = 1; i < blob->active.num_pages; i++) {
+	for (i = spdk_max(ctx->md_prefix, 1); i < blob->active.num_pages; i++) {
 		page = &ctx->pages[i];
 		assert(page->sequence_num == i);
 
@@ -2355,9 +2621,26 @@ blob_persist_generate_new_md(struct spdk_blob_persist_ctx *ctx)
 		blob_persist_complete(seq, ctx, rc);
 		return;
 	}
+	ctx->num_pages = blob->active.num_pages;
 
 	assert(blob->active.num_pages >= 1);
 
+	/* Find how many leading pages match the last persisted serialization.
+	 * Those pages are already on disk with the same content, so they can
+	 * keep their location instead of being rewritten. */
+	ctx->md_prefix = 0;
+	if (blob->last_md != NULL) {
+		uint32_t max_prefix;
+
+		max_prefix = spdk_min(blob->active.num_pages, blob->clean.num_pages);
+		max_prefix = spdk_min(max_prefix, blob->last_md_count);
+		while (ctx->md_prefix < max_prefix &&
+		       blob_md_page_equal(&ctx->pages[ctx->md_prefix],
+					  &blob->last_md[ctx->md_prefix])) {
+			ctx->md_prefix++;
+		}
+	}
+
 	/* Resize the cache of page indices */
 	tmp = realloc(blob->active.pages, blob->active.num_pages * sizeof(*blob->active.pages));
 	if (!tmp) {
@@ -2372,8 +2655,9 @@ blob_persist_generate_new_md(struct spdk_blob_persist_ctx *ctx)
 	 */
 	spdk_spin_lock(&bs->used_lock);
 	page_num = 0;
-	/* Note that this loop starts at one. The first page location is fixed by the blobid. */
-	for (i = 1; i < blob->active.num_pages; i++) {
+	/* Note that this loop starts past the reused prefix (or at one - the
+	 * first page location is fixed by the blobid). */
+	for (i = spdk_max(ctx->md_prefix, 1); i < blob->active.num_pages; i++) {
 		page_num = spdk_bit_array_find_first_clear(bs->used_md_pages, page_num);
 		if (page_num == UINT32_MAX) {
 			spdk_spin_unlock(&bs->used_lock);
@@ -2386,10 +2670,12 @@ blob_persist_generate_new_md(struct spdk_blob_persist_ctx *ctx)
 	page_num = 0;
 	blob->active.pages[0] = bs_blobid_to_page(blob->id);
 	for (i = 1; i < blob->active.num_pages; i++) {
+		if (i < ctx->md_prefix) {
+			/* The page content did not change, keep its location. */
+			blob->active.pages[i] = blob->clean.pages[i];
+			continue;
+		}
 		page_num = spdk_bit_array_find_first_clear(bs->used_md_pages, page_num);
-		ctx->pages[i - 1].next = page_num;
-		/* Now that previous metadata page is complete, calculate the crc for it. */
-		ctx->pages[i - 1].crc = blob_md_page_calc_crc(&ctx->pages[i - 1]);
 		blob->active.pages[i] = page_num;
 		bs_claim_md_page(bs, page_num);
 		SPDK_DEBUGLOG(blob, "Claiming page %u for blob 0x%" PRIx64 "\n", page_num,
@@ -2397,7 +2683,15 @@ blob_persist_generate_new_md(struct spdk_blob_persist_ctx *ctx)
 		page_num++;
 	}
 	spdk_spin_unlock(&bs->used_lock);
-	ctx->pages[i - 1].crc = blob_md_page_calc_crc(&ctx->pages[i - 1]);
+
+	/* With all page locations assigned, link the chain and calculate the crcs. */
+	for (i = 1; i < blob->active.num_pages; i++) {
+		ctx->pages[i - 1].next = blob->active.pages[i];
+	}
+	for (i = 0; i < blob->active.num_pages; i++) {
+		ctx->pages[i].crc = blob_md_page_calc_crc(&ctx->pages[i]);
+	}
+
 	/* Start writing the metadata from last page to first */
 	blob->state = SPDK_BLOB_STATE_CLEAN;
 	blob_persist_write_page_chain(seq, ctx);
@@ -2869,10 +3163,8 @@ bs_allocate_and_copy_cluster(struct spdk_blob *blob,
 		}
 	}
 
-	spdk_spin_lock(&blob->bs->used_lock);
-	rc = bs_allocate_cluster(blob, cluster_number, &ctx->new_cluster, &ctx->new_extent_page,
-				 false);
-	spdk_spin_unlock(&blob->bs->used_lock);
+	rc = bs_channel_allocate_cluster(blob, ch, cluster_number, &ctx->new_cluster,
+					 &ctx->new_extent_page);
 	if (rc != 0) {
 		spdk_free(ctx->buf);
 		free(ctx);
@@ -2886,9 +3178,7 @@ bs_allocate_and_copy_cluster(struct spdk_blob *blob,
 
 	ctx->seq = bs_sequence_start_blob(_ch, &cpl, blob);
 	if (!ctx->seq) {
-		spdk_spin_lock(&blob->bs->used_lock);
-		bs_release_cluster(blob->bs, ctx->new_cluster);
-		spdk_spin_unlock(&blob->bs->used_lock);
+		bs_channel_release_cluster(ch, ctx->new_cluster);
 		spdk_free(ctx->buf);
 		free(ctx);
 		bs_user_op_abort(op, -ENOMEM);
@@ -2932,6 +3222,72 @@ blob_calculate_lba_and_lba_count(struct spdk_blob *blob, uint64_t io_unit, uint6
 	}
 }
 
+/* A read that is not covered by the blob's own clusters descends through the
+ * chain of back_bs_devs one blob at a time, paying a full request round trip
+ * at every level.  The chain can be walked synchronously instead, so find the
+ * device that actually owns the data and issue the read straight to it.  The
+ * result is memoized in the channel; snapshots never allocate clusters, so an
+ * entry stays valid until a back_bs_dev somewhere in the blobstore goes away
+ * and bumps the generation counter.  The lba and lba_count, given in units of
+ * blob->back_bs_dev, are translated to units of the returned device. */
+static struct spdk_bs_dev *
+blob_back_dev_for_read(struct spdk_blob *blob, struct spdk_io_channel *_ch,
+		       uint64_t offset, uint64_t *lba, uint64_t *lba_count)
+{
+	struct spdk_bs_channel *ch = spdk_io_channel_get_ctx(_ch);
+	struct spdk_bs_back_dev_cache_entry *entry;
+	struct spdk_bs_dev *dev = blob->back_bs_dev;
+	struct spdk_blob *cur = blob;
+	struct spdk_blob *parent;
+	uint64_t cluster = bs_io_unit_to_cluster_number(blob, offset);
+	uint64_t dev_lba = *lba;
+	uint32_t scale = 1;
+
+	if (blob->parent_id == SPDK_BLOBID_INVALID ||
+	    blob->parent_id == SPDK_BLOBID_EXTERNAL_SNAPSHOT) {
+		/* A single level - there is nothing to short-circuit. */
+		return dev;
+	}
+
+	if (ch->back_dev_cache_gen != blob->bs->back_bs_dev_gen) {
+		memset(ch->back_dev_cache, 0, sizeof(ch->back_dev_cache));
+		ch->back_dev_cache_gen = blob->bs->back_bs_dev_gen;
+	}
+
+	entry = &ch->back_dev_cache[cluster % SPDK_BLOB_BACK_DEV_CACHE_SIZE];
+	if (entry->dev != NULL && entry->blob_id == blob->id && entry->cluster == cluster) {
+		*lba *= entry->lba_scale;
+		*lba_count *= entry->lba_scale;
+		return entry->dev;
+	}
+
+	while (cur->parent_id != SPDK_BLOBID_INVALID &&
+	       cur->parent_id != SPDK_BLOBID_EXTERNAL_SNAPSHOT) {
+		/* dev is the blob_bs_dev wrapping cur's parent here, so the walk
+		 * stops at the first blob that holds the cluster, at a device that
+		 * must zero the whole range, or at the terminal zeroes or external
+		 * snapshot device. */
+		parent = ((struct spdk_blob_bs_dev *)dev)->blob;
+		if (dev_lba >= dev->blockcnt || bs_io_unit_is_allocated(parent, dev_lba) ||
+		    parent->back_bs_dev == NULL) {
+			break;
+		}
+		cur = parent;
+		dev_lba = bs_io_unit_to_back_dev_lba(parent, dev_lba);
+		scale *= parent->bs->io_unit_size / parent->back_bs_dev->blocklen;
+		dev = parent->back_bs_dev;
+	}
+
+	entry->blob_id = blob->id;
+	entry->cluster = cluster;
+	entry->dev = dev;
+	entry->lba_scale = scale;
+
+	*lba = dev_lba;
+	*lba_count *= scale;
+	return dev;
+}
+
 struct op_split_ctx {
 	struct spdk_blob *blob;
 	struct spdk_io_channel *channel;
@@ -3152,8 +3508,11 @@ blob_request_submit_op_single(struct spdk_io_channel *_ch, struct spdk_blob *blo
 			/* Read from the blob */
 			bs_batch_read_dev(batch, payload, lba, lba_count);
 		} else {
-			/* Read from the backing block device */
-			bs_batch_read_bs_dev(batch, blob->back_bs_dev, payload, lba, lba_count);
+			struct spdk_bs_dev *back_dev;
+
+			/* Read from the device in the backing chain that owns the data */
+			back_dev = blob_back_dev_for_read(blob, _ch, offset, &lba, &lba_count);
+			bs_batch_read_bs_dev(batch, back_dev, payload, lba, lba_count);
 		}
 
 		bs_batch_close(batch);
@@ -3453,6 +3812,8 @@ blob_request_submit_rw_iov(struct spdk_blob *blob, struct spdk_io_channel *_chan
 				return;
 			}
 
+			op->ext_io_opts = ext_io_opts;
+
 			TAILQ_INSERT_TAIL(&bs_channel->queued_io, op, link);
 
 			return;
@@ -3474,7 +3835,10 @@ blob_request_submit_rw_iov(struct spdk_blob *blob, struct spdk_io_channel *_chan
 			if (is_allocated) {
 				bs_sequence_readv_dev(seq, iov, iovcnt, lba, lba_count, rw_iov_done, NULL);
 			} else {
-				bs_sequence_readv_bs_dev(seq, blob->back_bs_dev, iov, iovcnt, lba, lba_count,
+				struct spdk_bs_dev *back_dev;
+
+				back_dev = blob_back_dev_for_read(blob, _channel, offset, &lba, &lba_count);
+				bs_sequence_readv_bs_dev(seq, back_dev, iov, iovcnt, lba, lba_count,
 							 rw_iov_done, NULL);
 			}
 		} else {
@@ -3614,6 +3978,16 @@ bs_channel_create(void *io_device, void *ctx_buf)
 		return -1;
 	}
 
+	channel->cluster_cache = calloc(SPDK_BLOB_CLUSTER_CACHE_SIZE,
+					sizeof(*channel->cluster_cache));
+	if (!channel->cluster_cache) {
+		SPDK_ERRLOG("Failed to allocate cluster reservation cache\n");
+		free(channel->req_mem);
+		spdk_free(channel->new_cluster_page);
+		channel->dev->destroy_channel(channel->dev, channel->dev_channel);
+		return -1;
+	}
+
 	TAILQ_INIT(&channel->need_cluster_alloc);
 	TAILQ_INIT(&channel->queued_io);
 	RB_INIT(&channel->esnap_channels);
@@ -3641,7 +4015,10 @@ bs_channel_destroy(void *io_device, void *ctx_buf)
 
 	blob_esnap_destroy_bs_channel(channel);
 
+	bs_channel_release_reserved_clusters(channel);
+
 	free(channel->req_mem);
+	free(channel->cluster_cache);
 	spdk_free(channel->new_cluster_page);
 	channel->dev->destroy_channel(channel->dev, channel->dev_channel);
 }
@@ -3676,21 +4053,13 @@ bs_dev_destroy(void *io_device)
 }
 
 static int
-bs_blob_list_add(struct spdk_blob *blob)
+bs_blob_list_add_by_ids(struct spdk_blob_store *bs, spdk_blob_id snapshot_id,
+			spdk_blob_id clone_id)
 {
-	spdk_blob_id snapshot_id;
 	struct spdk_blob_list *snapshot_entry = NULL;
 	struct spdk_blob_list *clone_entry = NULL;
 
-	assert(blob != NULL);
-
-	snapshot_id = blob->parent_id;
-	if (snapshot_id == SPDK_BLOBID_INVALID ||
-	    snapshot_id == SPDK_BLOBID_EXTERNAL_SNAPSHOT) {
-		return 0;
-	}
-
-	snapshot_entry = bs_get_snapshot_entry(blob->bs, snapshot_id);
+	snapshot_entry = bs_get_snapshot_entry(bs, snapshot_id);
 	if (snapshot_entry == NULL) {
 		/* Snapshot not found */
 		snapshot_entry = calloc(1, sizeof(struct spdk_blob_list));
@@ -3699,10 +4068,10 @@ bs_blob_list_add(struct spdk_blob *blob)
 		}
 		snapshot_entry->id = snapshot_id;
 		TAILQ_INIT(&snapshot_entry->clones);
-		TAILQ_INSERT_TAIL(&blob->bs->snapshots, snapshot_entry, link);
+		TAILQ_INSERT_TAIL(&bs->snapshots, snapshot_entry, link);
 	} else {
 		TAILQ_FOREACH(clone_entry, &snapshot_entry->clones, link) {
-			if (clone_entry->id == blob->id) {
+			if (clone_entry->id == clone_id) {
 				break;
 			}
 		}
@@ -3714,7 +4083,7 @@ bs_blob_list_add(struct spdk_blob *blob)
 		if (clone_entry == NULL) {
 			return -ENOMEM;
 		}
-		clone_entry->id = blob->id;
+		clone_entry->id = clone_id;
 		TAILQ_INIT(&clone_entry->clones);
 		TAILQ_INSERT_TAIL(&snapshot_entry->clones, clone_entry, link);
 		snapshot_entry->clone_count++;
@@ -3723,6 +4092,22 @@ bs_blob_list_add(struct spdk_blob *blob)
 	return 0;
 }
 
+static int
+bs_blob_list_add(struct spdk_blob *blob)
+{
+	spdk_blob_id snapshot_id;
+
+	assert(blob != NULL);
+
+	snapshot_id = blob->parent_id;
+	if (snapshot_id == SPDK_BLOBID_INVALID ||
+	    snapshot_id == SPDK_BLOBID_EXTERNAL_SNAPSHOT) {
+		return 0;
+	}
+
+	return bs_blob_list_add_by_ids(blob->bs, snapshot_id, blob->id);
+}
+
 static void
 bs_blob_list_remove(struct spdk_blob *blob)
 {
@@ -3811,6 +4196,7 @@ spdk_bs_opts_init(struct spdk_bs_opts *opts, size_t opts_size)
 	SET_FIELD(force_recover, false);
 	SET_FIELD(esnap_bs_dev_create, NULL);
 	SET_FIELD(esnap_ctx, NULL);
+	SET_FIELD(cluster_prealloc_count, 0);
 
 #undef FIELD_OK
 #undef SET_FIELD
@@ -3842,6 +4228,11 @@ struct spdk_bs_load_ctx {
 	uint32_t			cur_page;
 	struct spdk_blob_md_page	*page;
 
+	/* Read-ahead buffer for the md page scan during recovery. */
+	struct spdk_blob_md_page	*page_buf;
+	uint32_t			page_buf_start;
+	uint32_t			page_buf_count;
+
 	uint64_t			num_extent_pages;
 	uint32_t			*extent_page_num;
 	struct spdk_blob_md_page	*extent_pages;
@@ -3936,6 +4327,7 @@ bs_alloc(struct spdk_bs_dev *dev, struct spdk_bs_opts *opts, struct spdk_blob_st
 	bs->io_unit_size = dev->blocklen;
 
 	bs->max_channel_ops = opts->max_channel_ops;
+	bs->cluster_prealloc_count = opts->cluster_prealloc_count;
 	bs->super_blob = SPDK_BLOBID_INVALID;
 	memcpy(&bs->bstype, &opts->bstype, sizeof(opts->bstype));
 	bs->esnap_bs_dev_create = opts->esnap_bs_dev_create;
@@ -4694,8 +5086,11 @@ bs_load_write_used_md(struct spdk_bs_load_ctx *ctx)
 	bs_write_used_md(ctx->seq, ctx, bs_load_write_used_pages_cpl);
 }
 
-static void
-bs_load_replay_md_chain_cpl(struct spdk_bs_load_ctx *ctx)
+/* Advance the scan past the current page chain.  Returns 0 when the caller
+ * should continue with the page now in ctx->cur_page, or 1 when the scan is
+ * complete and the used md write has been issued. */
+static int
+bs_load_replay_md_chain_advance(struct spdk_bs_load_ctx *ctx)
 {
 	uint64_t num_md_clusters;
 	uint64_t i;
@@ -4708,18 +5103,20 @@ bs_load_replay_md_chain_cpl(struct spdk_bs_load_ctx *ctx)
 
 	if (ctx->page_index < ctx->super->md_len) {
 		ctx->cur_page = ctx->page_index;
-		bs_load_replay_cur_md_page(ctx);
-	} else {
-		/* Claim all of the clusters used by the metadata */
-		num_md_clusters = spdk_divide_round_up(
-					  ctx->super->md_start + ctx->super->md_len, ctx->bs->pages_per_cluster);
-		for (i = 0; i < num_md_clusters; i++) {
-			spdk_bit_array_set(ctx->used_clusters, i);
-		}
-		ctx->bs->num_free_clusters -= num_md_clusters;
-		spdk_free(ctx->page);
-		bs_load_write_used_md(ctx);
+		return 0;
+	}
+
+	/* Claim all of the clusters used by the metadata */
+	num_md_clusters = spdk_divide_round_up(
+				  ctx->super->md_start + ctx->super->md_len, ctx->bs->pages_per_cluster);
+	for (i = 0; i < num_md_clusters; i++) {
+		spdk_bit_array_set(ctx->used_clusters, i);
 	}
+	ctx->bs->num_free_clusters -= num_md_clusters;
+	spdk_free(ctx->page);
+	spdk_free(ctx->page_buf);
+	bs_load_write_used_md(ctx);
+	return 1;
 }
 
 static void
@@ -4758,7 +5155,9 @@ bs_load_replay_extent_page_cpl(spdk_bs_sequence_t *seq, void *cb_arg, int bserrn
 	ctx->extent_page_num = NULL;
 	ctx->num_extent_pages = 0;
 
-	bs_load_replay_md_chain_cpl(ctx);
+	if (bs_load_replay_md_chain_advance(ctx) == 0) {
+		bs_load_replay_cur_md_page(ctx);
+	}
 }
 
 static void
@@ -4789,18 +5188,15 @@ bs_load_replay_extent_pages(struct spdk_bs_load_ctx *ctx)
 	bs_batch_close(batch);
 }
 
-static void
-bs_load_replay_md_cpl(spdk_bs_sequence_t *seq, void *cb_arg, int bserrno)
+/* Process the md page in ctx->page.  Returns 0 when the caller should continue
+ * with the page now in ctx->cur_page, or 1 when an async operation (extent page
+ * reads, the final used md write or a load failure) took over the scan. */
+static int
+bs_load_replay_md_process_page(struct spdk_bs_load_ctx *ctx)
 {
-	struct spdk_bs_load_ctx *ctx = cb_arg;
 	uint32_t page_num;
 	struct spdk_blob_md_page *page;
 
-	if (bserrno != 0) {
-		bs_load_ctx_fail(ctx, bserrno);
-		return;
-	}
-
 	page_num = ctx->cur_page;
 	page = ctx->page;
 	if (bs_load_cur_md_page_valid(ctx) == true) {
@@ -4814,33 +5210,67 @@ bs_load_replay_md_cpl(spdk_bs_sequence_t *seq, void *cb_arg, int bserrno)
 			}
 			if (bs_load_replay_md_parse_page(ctx, page)) {
 				bs_load_ctx_fail(ctx, -EILSEQ);
-				return;
+				return 1;
 			}
 			if (page->next != SPDK_INVALID_MD_PAGE) {
 				ctx->in_page_chain = true;
 				ctx->cur_page = page->next;
-				bs_load_replay_cur_md_page(ctx);
-				return;
+				return 0;
 			}
 			if (ctx->num_extent_pages != 0) {
 				bs_load_replay_extent_pages(ctx);
-				return;
+				return 1;
 			}
 		}
 	}
-	bs_load_replay_md_chain_cpl(ctx);
+	return bs_load_replay_md_chain_advance(ctx);
+}
+
+static void
+bs_load_replay_md_batch_cpl(spdk_bs_sequence_t *seq, void *cb_arg, int bserrno)
+{
+	struct spdk_bs_load_ctx *ctx = cb_arg;
+
+	if (bserrno != 0) {
+		bs_load_ctx_fail(ctx, bserrno);
+		return;
+	}
+
+	bs_load_replay_cur_md_page(ctx);
 }
 
 static void
 bs_load_replay_cur_md_page(struct spdk_bs_load_ctx *ctx)
 {
 	uint64_t lba;
+	uint32_t count;
 
-	assert(ctx->cur_page < ctx->super->md_len);
-	lba = bs_md_page_to_lba(ctx->bs, ctx->cur_page);
-	bs_sequence_read_dev(ctx->seq, ctx->page, lba,
-			     bs_byte_to_lba(ctx->bs, SPDK_BS_PAGE_SIZE),
-			     bs_load_replay_md_cpl, ctx);
+	while (true) {
+		assert(ctx->cur_page < ctx->super->md_len);
+
+		if (ctx->cur_page >= ctx->page_buf_start &&
+		    ctx->cur_page < ctx->page_buf_start + ctx->page_buf_count) {
+			/* Serve the page from the read-ahead buffer. */
+			memcpy(ctx->page, &ctx->page_buf[ctx->cur_page - ctx->page_buf_start],
+			       sizeof(*ctx->page));
+			if (bs_load_replay_md_process_page(ctx) != 0) {
+				return;
+			}
+			continue;
+		}
+
+		/* Refill the read-ahead buffer starting at the current page.  The md
+		 * pages are contiguous on disk, so one large read replaces up to
+		 * BS_LOAD_MD_SCAN_BATCH single page round trips. */
+		count = spdk_min(BS_LOAD_MD_SCAN_BATCH, ctx->super->md_len - ctx->cur_page);
+		ctx->page_buf_start = ctx->cur_page;
+		ctx->page_buf_count = count;
+		lba = bs_md_page_to_lba(ctx->bs, ctx->cur_page);
+		bs_sequence_read_dev(ctx->seq, ctx->page_buf, lba,
+				     bs_byte_to_lba(ctx->bs, count * SPDK_BS_PAGE_SIZE),
+				     bs_load_replay_md_batch_cpl, ctx);
+		return;
+	}
 }
 
 static void
@@ -4854,6 +5284,13 @@ bs_load_replay_md(struct spdk_bs_load_ctx *ctx)
 		bs_load_ctx_fail(ctx, -ENOMEM);
 		return;
 	}
+	ctx->page_buf = spdk_zmalloc(BS_LOAD_MD_SCAN_BATCH * SPDK_BS_PAGE_SIZE, 0,
+				     NULL, SPDK_ENV_SOCKET_ID_ANY, SPDK_MALLOC_DMA);
+	if (!ctx->page_buf) {
+		spdk_free(ctx->page);
+		bs_load_ctx_fail(ctx, -ENOMEM);
+		return;
+	}
 	bs_load_replay_cur_md_page(ctx);
 }
 
@@ -4987,12 +5424,13 @@ bs_opts_copy(struct spdk_bs_opts *src, struct spdk_bs_opts *dst)
 	SET_FIELD(force_recover);
 	SET_FIELD(esnap_bs_dev_create);
 	SET_FIELD(esnap_ctx);
+	SET_FIELD(cluster_prealloc_count);
 
 	dst->opts_size = src->opts_size;
 
 	/* You should not remove this statement, but need to update the assert statement
 	 * if you add a new field, and also add a corresponding SET_FIELD statement */
-	SPDK_STATIC_ASSERT(sizeof(struct spdk_bs_opts) == 88, "Incorrect size");
+	SPDK_STATIC_ASSERT(sizeof(struct spdk_bs_opts) == 92, "Incorrect size");
 
 #undef FIELD_OK
 #undef SET_FIELD
@@ -6364,6 +6802,11 @@ struct spdk_clone_snapshot_ctx {
 	/* Current cluster for inflate operation */
 	uint64_t cluster;
 
+	/* Number of cluster copies kept in flight by an inflate operation */
+	uint32_t inflate_inflight;
+	uint32_t inflate_max_inflight;
+	bool inflate_in_submit;
+
 	/* For inflation force allocation of all unallocated clusters and remove
 	 * thin-provisioning. Otherwise only decouple parent and keep clone thin. */
 	bool allocate_all;
@@ -6930,9 +7373,207 @@ spdk_bs_create_clone(struct spdk_blob_store *bs, spdk_blob_id blobid,
 
 /* END spdk_bs_create_clone */
 
-/* START spdk_bs_inflate_blob */
+/* START spdk_bs_create_clones */
 
-static void
+#define BS_CREATE_CLONES_IN_FLIGHT 8
+
+struct spdk_bs_bulk_clone_ctx;
+
+struct spdk_bs_bulk_clone_op {
+	struct spdk_bs_bulk_clone_ctx	*ctx;
+	size_t				index;
+	bool				in_use;
+};
+
+struct spdk_bs_bulk_clone_ctx {
+	struct spdk_blob_store		*bs;
+	struct spdk_blob		*snapshot;
+	const struct spdk_blob_xattr_opts *clone_xattrs;
+	spdk_blob_id			*blobids;
+	size_t				count;
+	size_t				next;
+	uint32_t			outstanding;
+	bool				in_submit;
+	int				bserrno;
+	struct spdk_blob_opts		opts;
+	struct spdk_blob_xattr_opts	internal_xattrs;
+	char				*internal_xattr_names[1];
+	struct spdk_bs_bulk_clone_op	ops[BS_CREATE_CLONES_IN_FLIGHT];
+	spdk_blob_op_complete		cb_fn;
+	void				*cb_arg;
+};
+
+static void bs_bulk_clone_submit(struct spdk_bs_bulk_clone_ctx *ctx);
+
+static void
+bs_bulk_clone_finish(void *cb_arg, int bserrno)
+{
+	struct spdk_bs_bulk_clone_ctx *ctx = cb_arg;
+
+	if (ctx->bserrno == 0) {
+		ctx->bserrno = bserrno;
+	}
+
+	ctx->cb_fn(ctx->cb_arg, ctx->bserrno);
+	free(ctx);
+}
+
+static void
+bs_bulk_clone_create_cpl(void *cb_arg, spdk_blob_id blobid, int bserrno)
+{
+	struct spdk_bs_bulk_clone_op *op = cb_arg;
+	struct spdk_bs_bulk_clone_ctx *ctx = op->ctx;
+
+	assert(ctx->outstanding > 0);
+	ctx->outstanding--;
+	op->in_use = false;
+
+	if (bserrno == 0) {
+		ctx->blobids[op->index] = blobid;
+		bserrno = bs_blob_list_add_by_ids(ctx->bs, ctx->snapshot->id, blobid);
+	}
+
+	if (bserrno != 0 && ctx->bserrno == 0) {
+		ctx->bserrno = bserrno;
+	}
+
+	if (!ctx->in_submit) {
+		bs_bulk_clone_submit(ctx);
+	}
+}
+
+static void
+bs_bulk_clone_submit(struct spdk_bs_bulk_clone_ctx *ctx)
+{
+	struct spdk_bs_bulk_clone_op *op;
+	struct spdk_blob_opts opts;
+	uint32_t slot;
+
+	ctx->in_submit = true;
+
+	while (ctx->bserrno == 0 && ctx->next < ctx->count &&
+	       ctx->outstanding < BS_CREATE_CLONES_IN_FLIGHT) {
+		op = NULL;
+		for (slot = 0; slot < BS_CREATE_CLONES_IN_FLIGHT; slot++) {
+			if (!ctx->ops[slot].in_use) {
+				op = &ctx->ops[slot];
+				break;
+			}
+		}
+		assert(op != NULL);
+
+		memcpy(&opts, &ctx->opts, sizeof(opts));
+		if (ctx->clone_xattrs != NULL) {
+			memcpy(&opts.xattrs, &ctx->clone_xattrs[ctx->next],
+			       sizeof(opts.xattrs));
+		}
+
+		op->index = ctx->next++;
+		op->in_use = true;
+		ctx->outstanding++;
+		bs_create_blob(ctx->bs, &opts, &ctx->internal_xattrs,
+			       bs_bulk_clone_create_cpl, op);
+	}
+
+	ctx->in_submit = false;
+
+	if (ctx->outstanding > 0) {
+		return;
+	}
+
+	ctx->snapshot->locked_operation_in_progress = false;
+	spdk_blob_close(ctx->snapshot, bs_bulk_clone_finish, ctx);
+}
+
+static void
+bs_bulk_clone_snapshot_open_cpl(void *cb_arg, struct spdk_blob *_blob, int bserrno)
+{
+	struct spdk_bs_bulk_clone_ctx *ctx = cb_arg;
+
+	if (bserrno != 0) {
+		ctx->cb_fn(ctx->cb_arg, bserrno);
+		free(ctx);
+		return;
+	}
+
+	ctx->snapshot = _blob;
+
+	if (!_blob->data_ro || !_blob->md_ro) {
+		SPDK_DEBUGLOG(blob, "Clone not from read-only blob\n");
+		ctx->bserrno = -EINVAL;
+		spdk_blob_close(_blob, bs_bulk_clone_finish, ctx);
+		return;
+	}
+
+	if (_blob->locked_operation_in_progress) {
+		SPDK_DEBUGLOG(blob, "Cannot create clones - another operation in progress\n");
+		ctx->bserrno = -EBUSY;
+		spdk_blob_close(_blob, bs_bulk_clone_finish, ctx);
+		return;
+	}
+
+	_blob->locked_operation_in_progress = true;
+
+	/* The snapshot stays open and locked for the duration of the batch, so
+	 * the template opts and the BLOB_SNAPSHOT xattr can refer to it directly. */
+	spdk_blob_opts_init(&ctx->opts, sizeof(ctx->opts));
+	ctx->opts.thin_provision = true;
+	ctx->opts.num_clusters = spdk_blob_get_num_clusters(_blob);
+	ctx->opts.use_extent_table = _blob->use_extent_table;
+
+	blob_xattrs_init(&ctx->internal_xattrs);
+	ctx->internal_xattr_names[0] = BLOB_SNAPSHOT;
+	ctx->internal_xattrs.count = 1;
+	ctx->internal_xattrs.ctx = _blob;
+	ctx->internal_xattrs.names = ctx->internal_xattr_names;
+	ctx->internal_xattrs.get_value = bs_xattr_clone;
+
+	bs_bulk_clone_submit(ctx);
+}
+
+void
+spdk_bs_create_clones(struct spdk_blob_store *bs, spdk_blob_id blobid,
+		      const struct spdk_blob_xattr_opts *clone_xattrs, size_t count,
+		      spdk_blob_id *blobids, spdk_blob_op_complete cb_fn, void *cb_arg)
+{
+	struct spdk_bs_bulk_clone_ctx *ctx;
+	uint32_t slot;
+	size_t i;
+
+	assert(spdk_get_thread() == bs->md_thread);
+
+	if (count == 0) {
+		cb_fn(cb_arg, 0);
+		return;
+	}
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		cb_fn(cb_arg, -ENOMEM);
+		return;
+	}
+
+	ctx->bs = bs;
+	ctx->clone_xattrs = clone_xattrs;
+	ctx->blobids = blobids;
+	ctx->count = count;
+	ctx->cb_fn = cb_fn;
+	ctx->cb_arg = cb_arg;
+	for (slot = 0; slot < BS_CREATE_CLONES_IN_FLIGHT; slot++) {
+		ctx->ops[slot].ctx = ctx;
+	}
+	for (i = 0; i < count; i++) {
+		blobids[i] = SPDK_BLOBID_INVALID;
+	}
+
+	spdk_bs_open_blob(bs, blobid, bs_bulk_clone_snapshot_open_cpl, ctx);
+}
+
+/* END spdk_bs_create_clones */
+
+/* START spdk_bs_inflate_blob */
+
+static void
 bs_inflate_blob_set_parent_cpl(void *cb_arg, struct spdk_blob *_parent, int bserrno)
 {
 	struct spdk_clone_snapshot_ctx *ctx = (struct spdk_clone_snapshot_ctx *)cb_arg;
@@ -7034,27 +7675,48 @@ bs_cluster_needs_allocation(struct spdk_blob *blob, uint64_t cluster, bool alloc
 	return (allocate_all || b->blob->active.clusters[cluster] != 0);
 }
 
+/* Default number of cluster copies an inflate keeps in flight */
+#define BS_INFLATE_CLUSTERS_IN_FLIGHT 8
+
+static void bs_inflate_blob_submit(struct spdk_clone_snapshot_ctx *ctx);
+
 static void
-bs_inflate_blob_touch_next(void *cb_arg, int bserrno)
+bs_inflate_blob_touch_done(void *cb_arg, int bserrno)
 {
 	struct spdk_clone_snapshot_ctx *ctx = (struct spdk_clone_snapshot_ctx *)cb_arg;
+
+	assert(ctx->inflate_inflight > 0);
+	ctx->inflate_inflight--;
+	if (bserrno != 0 && ctx->bserrno == 0) {
+		ctx->bserrno = bserrno;
+	}
+
+	if (!ctx->inflate_in_submit) {
+		bs_inflate_blob_submit(ctx);
+	}
+}
+
+static void
+bs_inflate_blob_submit(struct spdk_clone_snapshot_ctx *ctx)
+{
 	struct spdk_blob *_blob = ctx->original.blob;
 	struct spdk_bs_cpl cpl;
 	spdk_bs_user_op_t *op;
 	uint64_t offset;
 
-	if (bserrno != 0) {
-		bs_clone_snapshot_origblob_cleanup(ctx, bserrno);
-		return;
-	}
-
-	for (; ctx->cluster < _blob->active.num_clusters; ctx->cluster++) {
-		if (bs_cluster_needs_allocation(_blob, ctx->cluster, ctx->allocate_all)) {
+	/* Copies may complete synchronously; their completions must not re-enter
+	 * this loop. */
+	ctx->inflate_in_submit = true;
+	while (ctx->bserrno == 0 && ctx->inflate_inflight < ctx->inflate_max_inflight) {
+		for (; ctx->cluster < _blob->active.num_clusters; ctx->cluster++) {
+			if (bs_cluster_needs_allocation(_blob, ctx->cluster, ctx->allocate_all)) {
+				break;
+			}
+		}
+		if (ctx->cluster >= _blob->active.num_clusters) {
 			break;
 		}
-	}
 
-	if (ctx->cluster < _blob->active.num_clusters) {
 		offset = bs_cluster_to_lba(_blob->bs, ctx->cluster);
 
 		/* We may safely increment a cluster before copying */
@@ -7062,17 +7724,30 @@ bs_inflate_blob_touch_next(void *cb_arg, int bserrno)
 
 		/* Use a dummy 0B read as a context for cluster copy */
 		cpl.type = SPDK_BS_CPL_TYPE_BLOB_BASIC;
-		cpl.u.blob_basic.cb_fn = bs_inflate_blob_touch_next;
+		cpl.u.blob_basic.cb_fn = bs_inflate_blob_touch_done;
 		cpl.u.blob_basic.cb_arg = ctx;
 
 		op = bs_user_op_alloc(ctx->channel, &cpl, SPDK_BLOB_READ, _blob,
 				      NULL, 0, offset, 0);
 		if (!op) {
-			bs_clone_snapshot_origblob_cleanup(ctx, -ENOMEM);
-			return;
+			if (ctx->bserrno == 0) {
+				ctx->bserrno = -ENOMEM;
+			}
+			break;
 		}
 
+		ctx->inflate_inflight++;
 		bs_allocate_and_copy_cluster(_blob, ctx->channel, offset, op);
+	}
+	ctx->inflate_in_submit = false;
+
+	if (ctx->inflate_inflight > 0) {
+		/* The in-flight copies drive the remaining clusters */
+		return;
+	}
+
+	if (ctx->bserrno != 0) {
+		bs_clone_snapshot_origblob_cleanup(ctx, ctx->bserrno);
 	} else {
 		bs_inflate_blob_done(ctx);
 	}
@@ -7147,12 +7822,13 @@ bs_inflate_blob_open_cpl(void *cb_arg, struct spdk_blob *_blob, int bserrno)
 	}
 
 	ctx->cluster = 0;
-	bs_inflate_blob_touch_next(ctx, 0);
+	bs_inflate_blob_submit(ctx);
 }
 
 static void
 bs_inflate_blob(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
-		spdk_blob_id blobid, bool allocate_all, spdk_blob_op_complete cb_fn, void *cb_arg)
+		spdk_blob_id blobid, bool allocate_all, uint32_t max_in_flight,
+		spdk_blob_op_complete cb_fn, void *cb_arg)
 {
 	struct spdk_clone_snapshot_ctx *ctx = calloc(1, sizeof(*ctx));
 
@@ -7167,6 +7843,8 @@ bs_inflate_blob(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
 	ctx->original.id = blobid;
 	ctx->channel = channel;
 	ctx->allocate_all = allocate_all;
+	ctx->inflate_max_inflight = max_in_flight != 0 ? max_in_flight :
+				    BS_INFLATE_CLUSTERS_IN_FLIGHT;
 
 	spdk_bs_open_blob(bs, ctx->original.id, bs_inflate_blob_open_cpl, ctx);
 }
@@ -7175,14 +7853,30 @@ void
 spdk_bs_inflate_blob(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
 		     spdk_blob_id blobid, spdk_blob_op_complete cb_fn, void *cb_arg)
 {
-	bs_inflate_blob(bs, channel, blobid, true, cb_fn, cb_arg);
+	bs_inflate_blob(bs, channel, blobid, true, 0, cb_fn, cb_arg);
+}
+
+void
+spdk_bs_inflate_blob_ext(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
+			 spdk_blob_id blobid, uint32_t max_in_flight,
+			 spdk_blob_op_complete cb_fn, void *cb_arg)
+{
+	bs_inflate_blob(bs, channel, blobid, true, max_in_flight, cb_fn, cb_arg);
 }
 
 void
 spdk_bs_blob_decouple_parent(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
 			     spdk_blob_id blobid, spdk_blob_op_complete cb_fn, void *cb_arg)
 {
-	bs_inflate_blob(bs, channel, blobid, false, cb_fn, cb_arg);
+	bs_inflate_blob(bs, channel, blobid, false, 0, cb_fn, cb_arg);
+}
+
+void
+spdk_bs_blob_decouple_parent_ext(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
+				 spdk_blob_id blobid, uint32_t max_in_flight,
+				 spdk_blob_op_complete cb_fn, void *cb_arg)
+{
+	bs_inflate_blob(bs, channel, blobid, false, max_in_flight, cb_fn, cb_arg);
 }
 /* END spdk_bs_inflate_blob */
 
@@ -8517,6 +9211,168 @@ spdk_bs_delete_blob(struct spdk_blob_store *bs, spdk_blob_id blobid,
 
 /* END spdk_bs_delete_blob */
 
+/* START spdk_bs_delete_blobs */
+
+/* Number of deletions kept in flight while working through a batch. */
+#define BS_DELETE_BLOBS_IN_FLIGHT 8
+
+struct spdk_bs_bulk_delete_ctx;
+
+struct spdk_bs_bulk_delete_op {
+	struct spdk_bs_bulk_delete_ctx	*ctx;
+	spdk_blob_id			blobid;
+	bool				in_use;
+};
+
+struct spdk_bs_bulk_delete_ctx {
+	struct spdk_blob_store		*bs;
+	/* The blobs still to be deleted in the current pass */
+	spdk_blob_id			*ids;
+	size_t				count;
+	size_t				next;
+	size_t				outstanding;
+	/* Blobs that were still referenced in this pass, retried in the next one */
+	spdk_blob_id			*busy;
+	size_t				busy_count;
+	/* True once any blob of the current pass was actually deleted */
+	bool				progress;
+	bool				in_submit;
+	int				bserrno;
+	struct spdk_bs_bulk_delete_op	ops[BS_DELETE_BLOBS_IN_FLIGHT];
+	spdk_blob_op_complete		cb_fn;
+	void				*cb_arg;
+};
+
+static void bs_bulk_delete_submit(struct spdk_bs_bulk_delete_ctx *ctx);
+
+static void
+bs_bulk_delete_done(void *cb_arg, int bserrno)
+{
+	struct spdk_bs_bulk_delete_op *op = cb_arg;
+	struct spdk_bs_bulk_delete_ctx *ctx = op->ctx;
+
+	assert(ctx->outstanding > 0);
+	ctx->outstanding--;
+	op->in_use = false;
+
+	if (bserrno == -EBUSY) {
+		/* Another blob of the batch may still be holding this one as its
+		 * parent - retry it once the rest of the batch has completed. */
+		ctx->busy[ctx->busy_count++] = op->blobid;
+	} else if (bserrno != 0) {
+		if (ctx->bserrno == 0) {
+			ctx->bserrno = bserrno;
+		}
+	} else {
+		ctx->progress = true;
+	}
+
+	if (!ctx->in_submit) {
+		bs_bulk_delete_submit(ctx);
+	}
+}
+
+static void
+bs_bulk_delete_submit(struct spdk_bs_bulk_delete_ctx *ctx)
+{
+	struct spdk_bs_bulk_delete_op *op;
+	spdk_blob_id *tmp;
+	size_t i;
+
+	/* Deletions may complete synchronously; their completions must not
+	 * re-enter this loop. */
+	ctx->in_submit = true;
+	while (true) {
+		if (ctx->next < ctx->count && ctx->outstanding < BS_DELETE_BLOBS_IN_FLIGHT) {
+			for (i = 0; i < BS_DELETE_BLOBS_IN_FLIGHT; i++) {
+				if (!ctx->ops[i].in_use) {
+					break;
+				}
+			}
+			assert(i < BS_DELETE_BLOBS_IN_FLIGHT);
+			op = &ctx->ops[i];
+			op->in_use = true;
+			op->blobid = ctx->ids[ctx->next++];
+			ctx->outstanding++;
+			spdk_bs_delete_blob(ctx->bs, op->blobid, bs_bulk_delete_done, op);
+			continue;
+		}
+		if (ctx->outstanding > 0) {
+			/* The in-flight completions drive the rest of the batch */
+			ctx->in_submit = false;
+			return;
+		}
+		if (ctx->busy_count > 0 && ctx->progress) {
+			/* Deleting the rest of the batch released some of the busy
+			 * blobs - run another pass over them. */
+			tmp = ctx->ids;
+			ctx->ids = ctx->busy;
+			ctx->busy = tmp;
+			ctx->count = ctx->busy_count;
+			ctx->next = 0;
+			ctx->busy_count = 0;
+			ctx->progress = false;
+			continue;
+		}
+		break;
+	}
+
+	if (ctx->bserrno == 0 && ctx->busy_count > 0) {
+		/* The remaining blobs are referenced from outside the batch */
+		ctx->bserrno = -EBUSY;
+	}
+	ctx->cb_fn(ctx->cb_arg, ctx->bserrno);
+	free(ctx->ids);
+	free(ctx->busy);
+	free(ctx);
+}
+
+void
+spdk_bs_delete_blobs(struct spdk_blob_store *bs, spdk_blob_id *blobids, size_t count,
+		     spdk_blob_op_complete cb_fn, void *cb_arg)
+{
+	struct spdk_bs_bulk_delete_ctx *ctx;
+	size_t i;
+
+	SPDK_DEBUGLOG(blob, "Deleting %zu blobs\n", count);
+
+	assert(spdk_get_thread() == bs->md_thread);
+
+	if (count == 0) {
+		cb_fn(cb_arg, 0);
+		return;
+	}
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		cb_fn(cb_arg, -ENOMEM);
+		return;
+	}
+
+	ctx->ids = malloc(count * sizeof(*ctx->ids));
+	ctx->busy = malloc(count * sizeof(*ctx->busy));
+	if (ctx->ids == NULL || ctx->busy == NULL) {
+		free(ctx->ids);
+		free(ctx->busy);
+		free(ctx);
+		cb_fn(cb_arg, -ENOMEM);
+		return;
+	}
+
+	memcpy(ctx->ids, blobids, count * sizeof(*ctx->ids));
+	ctx->bs = bs;
+	ctx->count = count;
+	ctx->cb_fn = cb_fn;
+	ctx->cb_arg = cb_arg;
+	for (i = 0; i < BS_DELETE_BLOBS_IN_FLIGHT; i++) {
+		ctx->ops[i].ctx = ctx;
+	}
+
+	bs_bulk_delete_submit(ctx);
+}
+
+/* END spdk_bs_delete_blobs */
+
 /* START spdk_bs_open_blob */
 
 static void
@@ -9079,6 +9935,12 @@ spdk_blob_close(struct spdk_blob *blob, spdk_blob_op_complete cb_fn, void *cb_ar
 		return;
 	}
 
+	if (blob->open_ref == 1) {
+		/* No more writes can arrive - return the unused sequential
+		 * preallocations to the shared pool. */
+		blob_release_prealloc_clusters(blob);
+	}
+
 	cpl.type = SPDK_BS_CPL_TYPE_BLOB_BASIC;
 	cpl.u.blob_basic.cb_fn = cb_fn;
 	cpl.u.blob_basic.cb_arg = cb_arg;
@@ -9180,6 +10042,142 @@ spdk_blob_io_readv_ext(struct spdk_blob *blob, struct spdk_io_channel *channel,
 				   io_opts);
 }
 
+struct blob_io_copy_ctx {
+	struct spdk_blob *blob;
+	spdk_bs_sequence_t *seq;
+	uint64_t dst_offset;
+	uint64_t src_offset;
+	uint64_t remaining;
+};
+
+static bool
+blob_io_copy_range_allocated(struct spdk_blob *blob, uint64_t offset, uint64_t length)
+{
+	uint64_t boundary;
+
+	while (length > 0) {
+		if (!bs_io_unit_is_allocated(blob, offset)) {
+			return false;
+		}
+
+		boundary = bs_num_io_units_to_cluster_boundary(blob, offset);
+		if (boundary >= length) {
+			break;
+		}
+		offset += boundary;
+		length -= boundary;
+	}
+
+	return true;
+}
+
+static void blob_io_copy_next(struct blob_io_copy_ctx *ctx);
+
+static void
+blob_io_copy_done(spdk_bs_sequence_t *seq, void *cb_arg, int bserrno)
+{
+	struct blob_io_copy_ctx *ctx = cb_arg;
+
+	if (bserrno != 0) {
+		bs_sequence_finish(seq, bserrno);
+		free(ctx);
+		return;
+	}
+
+	blob_io_copy_next(ctx);
+}
+
+static void
+blob_io_copy_next(struct blob_io_copy_ctx *ctx)
+{
+	struct spdk_blob *blob = ctx->blob;
+	uint64_t op_length;
+
+	if (ctx->remaining == 0) {
+		bs_sequence_finish(ctx->seq, 0);
+		free(ctx);
+		return;
+	}
+
+	/* Neither the source nor the destination range of a single device copy
+	 * may span a cluster boundary, since adjacent clusters are not
+	 * necessarily contiguous on the device. */
+	op_length = spdk_min(ctx->remaining,
+			     spdk_min(bs_num_io_units_to_cluster_boundary(blob, ctx->src_offset),
+				      bs_num_io_units_to_cluster_boundary(blob, ctx->dst_offset)));
+
+	bs_sequence_copy_dev(ctx->seq,
+			     bs_blob_io_unit_to_lba(blob, ctx->dst_offset),
+			     bs_blob_io_unit_to_lba(blob, ctx->src_offset),
+			     op_length, blob_io_copy_done, ctx);
+
+	ctx->src_offset += op_length;
+	ctx->dst_offset += op_length;
+	ctx->remaining -= op_length;
+}
+
+void
+spdk_blob_io_copy(struct spdk_blob *blob, struct spdk_io_channel *channel,
+		  uint64_t dst_offset, uint64_t src_offset, uint64_t length,
+		  spdk_blob_op_complete cb_fn, void *cb_arg)
+{
+	struct blob_io_copy_ctx *ctx;
+	struct spdk_bs_cpl cpl;
+
+	assert(blob != NULL);
+
+	if (blob->data_ro) {
+		cb_fn(cb_arg, -EPERM);
+		return;
+	}
+
+	if (length == 0) {
+		cb_fn(cb_arg, 0);
+		return;
+	}
+
+	if (src_offset + length > bs_cluster_to_lba(blob->bs, blob->active.num_clusters) ||
+	    dst_offset + length > bs_cluster_to_lba(blob->bs, blob->active.num_clusters)) {
+		cb_fn(cb_arg, -EINVAL);
+		return;
+	}
+
+	/* Device copies bypass the frozen I/O queue and cannot allocate
+	 * clusters, so punt back to the caller whenever the copy cannot be
+	 * expressed as cluster-to-cluster operations on the base device.
+	 * The caller is expected to fall back to a buffered read/write pair. */
+	if (blob->bs->dev->copy == NULL || blob->frozen_refcnt > 0 ||
+	    !blob_io_copy_range_allocated(blob, src_offset, length) ||
+	    !blob_io_copy_range_allocated(blob, dst_offset, length)) {
+		cb_fn(cb_arg, -ENOTSUP);
+		return;
+	}
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		cb_fn(cb_arg, -ENOMEM);
+		return;
+	}
+
+	ctx->blob = blob;
+	ctx->dst_offset = dst_offset;
+	ctx->src_offset = src_offset;
+	ctx->remaining = length;
+
+	cpl.type = SPDK_BS_CPL_TYPE_BLOB_BASIC;
+	cpl.u.blob_basic.cb_fn = cb_fn;
+	cpl.u.blob_basic.cb_arg = cb_arg;
+
+	ctx->seq = bs_sequence_start_blob(channel, &cpl, blob);
+	if (ctx->seq == NULL) {
+		free(ctx);
+		cb_fn(cb_arg, -ENOMEM);
+		return;
+	}
+
+	blob_io_copy_next(ctx);
+}
+
 struct spdk_bs_iter_ctx {
 	int64_t page_num;
 	struct spdk_blob_store *bs;
@@ -10217,6 +11215,7 @@ blob_frozen_set_back_bs_dev(void *_ctx, struct spdk_blob *blob, int bserrno)
 	}
 
 	if (blob->back_bs_dev != NULL) {
+		blob->bs->back_bs_dev_gen++;
 		blob->back_bs_dev->destroy(blob->back_bs_dev);
 		blob->back_bs_dev = NULL;
 	}
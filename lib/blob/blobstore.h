@@ -25,6 +25,12 @@
 #define SPDK_BLOB_OPTS_NUM_MD_PAGES UINT32_MAX
 #define SPDK_BLOB_OPTS_MAX_MD_OPS 32
 #define SPDK_BLOB_OPTS_DEFAULT_CHANNEL_OPS 512
+#define SPDK_BLOB_CLUSTER_CACHE_SIZE 16
+/* Number of consecutive cluster allocations before a blob is treated as a
+ * sequential write stream and clusters are preallocated ahead of it. */
+#define SPDK_BLOB_SEQ_PREALLOC_THRESHOLD 4
+/* Number of entries in a channel's back_bs_dev chain read cache. */
+#define SPDK_BLOB_BACK_DEV_CACHE_SIZE 32
 #define SPDK_BLOB_BLOBID_HIGH_BIT (1ULL << 32)
 
 struct spdk_xattr {
@@ -151,6 +157,21 @@ struct spdk_blob {
 	/* Number of data clusters retrieved from extent table,
 	 * that many have to be read from extent pages. */
 	uint64_t	remaining_clusters_in_et;
+
+	/* The metadata pages written by the last successful persist.  Used to
+	 * detect the unchanged leading pages of the chain, which can keep their
+	 * on-disk location on the next sync instead of being rewritten. */
+	struct spdk_blob_md_page	*last_md;
+	uint32_t			last_md_count;
+
+	/* Sequential write detection and cluster preallocation, guarded by
+	 * bs->used_lock.  The reserved clusters are not part of the cluster map
+	 * and still count as free; leftovers are returned on the last close. */
+	uint64_t	seq_write_next_cluster;
+	uint32_t	seq_write_streak;
+	uint32_t	*prealloc_clusters;
+	uint32_t	prealloc_count;
+	uint32_t	prealloc_next;
 };
 
 struct spdk_blob_store {
@@ -159,6 +180,7 @@ struct spdk_blob_store {
 
 	struct spdk_io_channel		*md_channel;
 	uint32_t			max_channel_ops;
+	uint32_t			cluster_prealloc_count;
 
 	struct spdk_thread		*md_thread;
 
@@ -190,6 +212,11 @@ struct spdk_blob_store {
 
 	bool				clean;
 
+	/* Incremented whenever a back_bs_dev anywhere in the blobstore is
+	 * destroyed or replaced.  Channels compare it against their cached
+	 * chain lookups and drop the stale ones. */
+	uint64_t			back_bs_dev_gen;
+
 	spdk_bs_esnap_dev_create	esnap_bs_dev_create;
 	void				*esnap_ctx;
 
@@ -202,6 +229,16 @@ struct spdk_blob_store {
 	void				*esnap_unload_cb_arg;
 };
 
+/* One memoized result of walking a clone's chain of back_bs_devs: reads of
+ * the given unallocated cluster can go straight to this device.  Only valid
+ * while the channel's cache generation matches the blobstore's. */
+struct spdk_bs_back_dev_cache_entry {
+	spdk_blob_id		blob_id;
+	uint64_t		cluster;
+	struct spdk_bs_dev	*dev;
+	uint32_t		lba_scale;
+};
+
 struct spdk_bs_channel {
 	struct spdk_bs_request_set	*req_mem;
 	TAILQ_HEAD(, spdk_bs_request_set) reqs;
@@ -214,6 +251,18 @@ struct spdk_bs_channel {
 	/* This page is only used during insert of a new cluster. */
 	struct spdk_blob_md_page	*new_cluster_page;
 
+	/* Clusters reserved from the shared pool for this channel.  They are
+	 * handed out without taking bs->used_lock and still count as free in
+	 * bs->num_free_clusters until they are actually used.  Unused
+	 * reservations go back to the pool when the channel is destroyed. */
+	uint32_t			*cluster_cache;
+	uint32_t			cluster_cache_count;
+
+	/* Memoizes which device in a back_bs_dev chain owns recently read
+	 * clusters, so repeat reads of deep clone chains skip the traversal. */
+	struct spdk_bs_back_dev_cache_entry back_dev_cache[SPDK_BLOB_BACK_DEV_CACHE_SIZE];
+	uint64_t			back_dev_cache_gen;
+
 	TAILQ_HEAD(, spdk_bs_request_set) need_cluster_alloc;
 	TAILQ_HEAD(, spdk_bs_request_set) queued_io;
 
@@ -27,9 +27,14 @@
 #define BLOBFS_DEFAULT_CACHE_SIZE (4ULL * 1024 * 1024 * 1024)
 #define SPDK_BLOBFS_DEFAULT_OPTS_CLUSTER_SZ (1024 * 1024)
 
+#define BLOBFS_DEFAULT_FLUSH_DEPTH 4
+#define BLOBFS_DEFAULT_READAHEAD_WINDOW 4
+
 #define SPDK_BLOBFS_SIGNATURE	"BLOBFS"
 
 static uint64_t g_fs_cache_size = BLOBFS_DEFAULT_CACHE_SIZE;
+static uint32_t g_fs_flush_depth = BLOBFS_DEFAULT_FLUSH_DEPTH;
+static uint32_t g_fs_readahead_window = BLOBFS_DEFAULT_READAHEAD_WINDOW;
 static struct spdk_mempool *g_cache_pool;
 static TAILQ_HEAD(, spdk_file) g_caches = TAILQ_HEAD_INITIALIZER(g_caches);
 static struct spdk_poller *g_cache_pool_mgmt_poller;
@@ -93,11 +98,19 @@ struct spdk_file {
 	bool                    is_deleted;
 	bool			open_for_writing;
 	uint64_t		length_flushed;
+	/* Offset up to which write-behind I/O has been submitted.  Always
+	 * >= length_flushed; the two are equal when no flush is in flight.
+	 */
+	uint64_t		length_flush_submitted;
 	uint64_t		length_xattr;
 	uint64_t		append_pos;
 	uint64_t		seq_byte_count;
 	uint64_t		next_seq_offset;
 	uint32_t		priority;
+	uint32_t		flushes_in_progress;
+	uint32_t		flush_depth_max;
+	uint32_t		readaheads_in_progress;
+	uint32_t		readahead_depth_max;
 	TAILQ_ENTRY(spdk_file)	tailq;
 	spdk_blob_id		blobid;
 	uint32_t		ref_count;
@@ -743,6 +756,7 @@ iter_cb(void *ctx, struct spdk_blob *blob, int rc)
 		f->blobid = spdk_blob_get_id(blob);
 		f->length = *length;
 		f->length_flushed = *length;
+		f->length_flush_submitted = *length;
 		f->length_xattr = *length;
 		f->append_pos = *length;
 		SPDK_DEBUGLOG(blobfs, "added file %s length=%ju\n", f->name, f->length);
@@ -1994,6 +2008,53 @@ spdk_fs_get_cache_size(void)
 	return g_fs_cache_size / (1024 * 1024);
 }
 
+int
+spdk_fs_set_flush_depth(uint32_t depth)
+{
+	if (depth == 0) {
+		return -EINVAL;
+	}
+
+	g_fs_flush_depth = depth;
+
+	return 0;
+}
+
+uint32_t
+spdk_fs_get_flush_depth(void)
+{
+	return g_fs_flush_depth;
+}
+
+int
+spdk_fs_set_readahead_window(uint32_t num_buffers)
+{
+	if (num_buffers == 0) {
+		return -EINVAL;
+	}
+
+	g_fs_readahead_window = num_buffers;
+
+	return 0;
+}
+
+uint32_t
+spdk_fs_get_readahead_window(void)
+{
+	return g_fs_readahead_window;
+}
+
+void
+spdk_file_get_stats(struct spdk_file *file, struct spdk_file_stats *stats)
+{
+	pthread_spin_lock(&file->lock);
+	stats->flush_depth = file->flushes_in_progress;
+	stats->flush_depth_max = file->flush_depth_max;
+	stats->readahead_depth = file->readaheads_in_progress;
+	stats->readahead_depth_max = file->readahead_depth_max;
+	pthread_spin_unlock(&file->lock);
+}
+
 static void __file_flush(void *ctx);
 
 /* Try to free some cache buffers from this file.
@@ -2226,27 +2287,44 @@ __file_flush_done(void *ctx, int bserrno)
 	struct spdk_fs_cb_args *args = &req->args;
 	struct spdk_file *file = args->file;
 	struct cache_buffer *next = args->op.flush.cache_buffer;
+	struct cache_buffer *buf;
+	uint64_t flushed_end;
 
 	BLOBFS_TRACE(file, "length=%jx\n", args->op.flush.length);
 
 	pthread_spin_lock(&file->lock);
+	assert(file->flushes_in_progress > 0);
+	file->flushes_in_progress--;
 	next->in_progress = false;
 	next->bytes_flushed += args->op.flush.length;
-	file->length_flushed += args->op.flush.length;
+
+	/*
+	 * Several flush I/Os may be in flight and they can complete out of
+	 *  order.  length_flushed is the contiguous flushed frontier, so only
+	 *  advance it as far as fully flushed buffers allow.
+	 */
+	while ((buf = tree_find_buffer(file->tree, file->length_flushed)) != NULL) {
+		flushed_end = buf->offset + buf->bytes_flushed;
+		if (flushed_end == file->length_flushed) {
+			break;
+		}
+		file->length_flushed = flushed_end;
+		if (buf->bytes_flushed < buf->buf_size) {
+			break;
+		}
+		BLOBFS_TRACE(file, "write buffer fully flushed 0x%jx\n", file->length_flushed);
+	}
 	if (file->length_flushed > file->length) {
 		file->length = file->length_flushed;
 	}
-	if (next->bytes_flushed == next->buf_size) {
-		BLOBFS_TRACE(file, "write buffer fully flushed 0x%jx\n", file->length_flushed);
-		next = tree_find_buffer(file->tree, file->length_flushed);
-	}
 
 	/*
 	 * Assert that there is no cached data that extends past the end of the underlying
 	 *  blob.
 	 */
-	assert(next == NULL || next->offset < __file_get_blob_size(file) ||
-	       next->bytes_filled == 0);
+	buf = tree_find_buffer(file->tree, file->length_flushed);
+	assert(buf == NULL || buf->offset < __file_get_blob_size(file) ||
+	       buf->bytes_filled == 0);
 
 	pthread_spin_unlock(&file->lock);
 
@@ -2261,24 +2339,27 @@ __file_flush(void *ctx)
 	struct spdk_fs_request *req = ctx;
 	struct spdk_fs_cb_args *args = &req->args;
 	struct spdk_file *file = args->file;
+	struct spdk_fs_request *next_req;
 	struct cache_buffer *next;
 	uint64_t offset, length, start_lba, num_lba;
 	uint32_t lba_size;
 
 	pthread_spin_lock(&file->lock);
-	next = tree_find_buffer(file->tree, file->length_flushed);
+	next = tree_find_buffer(file->tree, file->length_flush_submitted);
 	if (next == NULL || next->in_progress ||
+	    file->flushes_in_progress >= g_fs_flush_depth ||
 	    ((next->bytes_filled < next->buf_size) && TAILQ_EMPTY(&file->sync_requests))) {
 		/*
 		 * There is either no data to flush, a flush I/O is already in
-		 *  progress, or the next buffer is partially filled but there's no
+		 *  progress on the next buffer, the write-behind pipeline is full,
+		 *  or the next buffer is partially filled but there's no
 		 *  outstanding request to sync it.
 		 * So return immediately - if a flush I/O is in progress we will flush
 		 *  more data after that is completed, or a partial buffer will get flushed
 		 *  when it is either filled or the file is synced.
 		 */
 		free_fs_request(req);
-		if (next == NULL) {
+		if (next == NULL && file->flushes_in_progress == 0) {
 			/*
 			 * For cases where a file's cache was evicted, and then the
 			 *  file was later appended, we will write the data directly
@@ -2286,6 +2367,7 @@ __file_flush(void *ctx)
 			 *  here to reflect that all data was already written to disk.
 			 */
 			file->length_flushed = file->append_pos;
+			file->length_flush_submitted = file->append_pos;
 		}
 		pthread_spin_unlock(&file->lock);
 		if (next == NULL) {
@@ -2298,8 +2380,8 @@ __file_flush(void *ctx)
 		return;
 	}
 
-	offset = next->offset + next->bytes_flushed;
-	length = next->bytes_filled - next->bytes_flushed;
+	offset = file->length_flush_submitted;
+	length = next->bytes_filled - (offset - next->offset);
 	if (length == 0) {
 		free_fs_request(req);
 		pthread_spin_unlock(&file->lock);
@@ -2316,9 +2398,27 @@ __file_flush(void *ctx)
 	__get_page_parameters(file, offset, length, &start_lba, &lba_size, &num_lba);
 
 	next->in_progress = true;
+	file->length_flush_submitted += length;
+	file->flushes_in_progress++;
+	if (file->flushes_in_progress > file->flush_depth_max) {
+		file->flush_depth_max = file->flushes_in_progress;
+	}
 	BLOBFS_TRACE(file, "offset=0x%jx length=0x%jx page start=0x%jx num=0x%jx\n",
 		     offset, length, start_lba, num_lba);
 	pthread_spin_unlock(&file->lock);
+
+	/*
+	 * If the pipeline has room, try to start a flush of the next buffer as
+	 *  well before this one completes.
+	 */
+	if (file->flushes_in_progress < g_fs_flush_depth) {
+		next_req = alloc_fs_request(req->channel);
+		if (next_req != NULL) {
+			next_req->args.file = file;
+			__file_flush(next_req);
+		}
+	}
+
 	spdk_blob_io_write(file->blob, file->fs->sync_target.sync_fs_channel->bs_channel,
 			   next->buf + (start_lba * lba_size) - next->offset,
 			   start_lba, num_lba, __file_flush_done, req);
@@ -2540,6 +2640,8 @@ __readahead_done(void *ctx, int bserrno)
 	cache_buffer->bytes_filled = args->op.readahead.length;
 	cache_buffer->bytes_flushed = args->op.readahead.length;
 	cache_buffer->in_progress = false;
+	assert(file->readaheads_in_progress > 0);
+	file->readaheads_in_progress--;
 	pthread_spin_unlock(&file->lock);
 
 	free_fs_request(req);
@@ -2608,6 +2710,10 @@ check_readahead(struct spdk_file *file, uint64_t offset,
 	} else {
 		args->op.readahead.length = CACHE_BUFFER_SIZE;
 	}
+	file->readaheads_in_progress++;
+	if (file->readaheads_in_progress > file->readahead_depth_max) {
+		file->readahead_depth_max = file->readaheads_in_progress;
+	}
 	file->fs->send_request(__readahead, req);
 }
 
@@ -2643,8 +2749,11 @@ spdk_file_read(struct spdk_file *file, struct spdk_fs_thread_ctx *ctx,
 	file->seq_byte_count += length;
 	file->next_seq_offset = offset + length;
 	if (file->seq_byte_count >= CACHE_READAHEAD_THRESHOLD) {
-		check_readahead(file, offset, channel);
-		check_readahead(file, offset + CACHE_BUFFER_SIZE, channel);
+		uint32_t i;
+
+		for (i = 0; i < g_fs_readahead_window; i++) {
+			check_readahead(file, offset + i * CACHE_BUFFER_SIZE, channel);
+		}
 	}
 
 	arg.channel = channel;
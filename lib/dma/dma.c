@@ -11,6 +11,24 @@ pthread_mutex_t g_dma_mutex = PTHREAD_MUTEX_INITIALIZER;
 TAILQ_HEAD(, spdk_memory_domain) g_dma_memory_domains = TAILQ_HEAD_INITIALIZER(
 			g_dma_memory_domains);
 
+/* Single entry of the translation cache.  Entries are direct-mapped by a hash
+ * of the translated address, each under its own lock so that lookups from
+ * different channels don't serialize on one cache line.
+ */
+struct dma_translation_entry {
+	pthread_spinlock_t lock;
+	bool valid;
+	void *addr;
+	size_t len;
+	struct spdk_memory_domain *dst_domain;
+	struct spdk_memory_domain_translation_result result;
+};
+
+struct dma_translation_cache {
+	uint32_t num_entries;
+	struct dma_translation_entry entries[];
+};
+
 struct spdk_memory_domain {
 	enum spdk_dma_device_type type;
 	spdk_memory_domain_pull_data_cb pull_cb;
@@ -18,6 +36,7 @@ struct spdk_memory_domain {
 	spdk_memory_domain_translate_memory_cb translate_cb;
 	spdk_memory_domain_invalidate_data_cb invalidate_cb;
 	spdk_memory_domain_memzero_cb memzero_cb;
+	struct dma_translation_cache *tcache;
 	TAILQ_ENTRY(spdk_memory_domain) link;
 	struct spdk_memory_domain_ctx *ctx;
 	char *id;
@@ -169,6 +188,83 @@ spdk_memory_domain_get_dma_device_id(struct spdk_memory_domain *domain)
 	return domain->id;
 }
 
+static void
+dma_translation_cache_free(struct spdk_memory_domain *domain)
+{
+	uint32_t i;
+
+	if (!domain->tcache) {
+		return;
+	}
+
+	for (i = 0; i < domain->tcache->num_entries; i++) {
+		pthread_spin_destroy(&domain->tcache->entries[i].lock);
+	}
+
+	free(domain->tcache);
+	domain->tcache = NULL;
+}
+
+int
+spdk_memory_domain_set_translation_cache(struct spdk_memory_domain *domain, uint32_t num_entries)
+{
+	struct dma_translation_cache *cache;
+	uint32_t i;
+
+	assert(domain);
+
+	if (domain == &g_system_domain) {
+		return -EINVAL;
+	}
+
+	dma_translation_cache_free(domain);
+
+	if (num_entries == 0) {
+		return 0;
+	}
+
+	num_entries = spdk_align32pow2(num_entries);
+	cache = calloc(1, sizeof(*cache) + num_entries * sizeof(cache->entries[0]));
+	if (!cache) {
+		SPDK_ERRLOG("Failed to allocate memory");
+		return -ENOMEM;
+	}
+
+	cache->num_entries = num_entries;
+	for (i = 0; i < num_entries; i++) {
+		pthread_spin_init(&cache->entries[i].lock, 0);
+	}
+
+	domain->tcache = cache;
+
+	return 0;
+}
+
+void
+spdk_memory_domain_invalidate_translation_cache(struct spdk_memory_domain *domain, void *addr,
+		size_t len)
+{
+	struct dma_translation_entry *entry;
+	uint32_t i;
+
+	assert(domain);
+
+	if (!domain->tcache) {
+		return;
+	}
+
+	for (i = 0; i < domain->tcache->num_entries; i++) {
+		entry = &domain->tcache->entries[i];
+		pthread_spin_lock(&entry->lock);
+		if (entry->valid &&
+		    (addr == NULL || ((uint8_t *)entry->addr < (uint8_t *)addr + len &&
+				      (uint8_t *)addr < (uint8_t *)entry->addr + entry->len))) {
+			entry->valid = false;
+		}
+		pthread_spin_unlock(&entry->lock);
+	}
+}
+
 void
 spdk_memory_domain_destroy(struct spdk_memory_domain *domain)
 {
@@ -182,6 +278,7 @@ spdk_memory_domain_destroy(struct spdk_memory_domain *domain)
 	TAILQ_REMOVE(&g_dma_memory_domains, domain, link);
 	pthread_mutex_unlock(&g_dma_mutex);
 
+	dma_translation_cache_free(domain);
 	free(domain->ctx);
 	free(domain->id);
 	free(domain);
@@ -221,11 +318,22 @@ spdk_memory_domain_push_data(struct spdk_memory_domain *dst_domain, void *dst_do
 				   cpl_cb, cpl_cb_arg);
 }
 
+static struct dma_translation_entry *
+dma_translation_cache_get_entry(struct dma_translation_cache *cache, void *addr)
+{
+	/* Buffers handed out by the same mapping tend to be page granular, so
+	 * hash on the page frame number to spread them over the entries. */
+	return &cache->entries[((uintptr_t)addr >> 12) & (cache->num_entries - 1)];
+}
+
 int
 spdk_memory_domain_translate_data(struct spdk_memory_domain *src_domain, void *src_domain_ctx,
 				  struct spdk_memory_domain *dst_domain, struct spdk_memory_domain_translation_ctx *dst_domain_ctx,
 				  void *addr, size_t len, struct spdk_memory_domain_translation_result *result)
 {
+	struct dma_translation_entry *entry;
+	int rc;
+
 	assert(src_domain);
 	assert(dst_domain);
 	assert(result);
@@ -234,16 +342,53 @@ spdk_memory_domain_translate_data(struct spdk_memory_domain *src_domain, void *s
 		return -ENOTSUP;
 	}
 
-	return src_domain->translate_cb(src_domain, src_domain_ctx, dst_domain, dst_domain_ctx, addr, len,
-					result);
+	if (src_domain->tcache == NULL) {
+		return src_domain->translate_cb(src_domain, src_domain_ctx, dst_domain, dst_domain_ctx,
+						addr, len, result);
+	}
+
+	entry = dma_translation_cache_get_entry(src_domain->tcache, addr);
+	pthread_spin_lock(&entry->lock);
+	if (entry->valid && entry->addr == addr && entry->len == len &&
+	    entry->dst_domain == dst_domain) {
+		*result = entry->result;
+		pthread_spin_unlock(&entry->lock);
+		return 0;
+	}
+	pthread_spin_unlock(&entry->lock);
+
+	rc = src_domain->translate_cb(src_domain, src_domain_ctx, dst_domain, dst_domain_ctx, addr, len,
+				      result);
+	if (rc == 0 && result->iov_count == 1) {
+		/* Multi-element results reference an iov array that is only valid
+		 * for the duration of the request, so don't cache those. */
+		pthread_spin_lock(&entry->lock);
+		entry->valid = true;
+		entry->addr = addr;
+		entry->len = len;
+		entry->dst_domain = dst_domain;
+		entry->result = *result;
+		pthread_spin_unlock(&entry->lock);
+	}
+
+	return rc;
 }
 
 void
 spdk_memory_domain_invalidate_data(struct spdk_memory_domain *domain, void *domain_ctx,
 				   struct iovec *iov, uint32_t iovcnt)
 {
+	uint32_t i;
+
 	assert(domain);
 
+	if (spdk_unlikely(domain->tcache != NULL)) {
+		for (i = 0; i < iovcnt; i++) {
+			spdk_memory_domain_invalidate_translation_cache(domain, iov[i].iov_base,
+					iov[i].iov_len);
+		}
+	}
+
 	if (spdk_unlikely(!domain->invalidate_cb)) {
 		return;
 	}
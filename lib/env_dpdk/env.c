@@ -95,6 +95,131 @@ spdk_dma_free(void *buf)
 	spdk_free(buf);
 }
 
+#define ARENA_DEFAULT_SLAB_SIZE	(64 * 1024)
+#define ARENA_ALIGNMENT		16
+
+struct arena_slab {
+	SLIST_ENTRY(arena_slab)	link;
+	size_t			size;
+	size_t			used;
+	uint8_t			data[];
+};
+
+struct spdk_arena {
+	SLIST_HEAD(, arena_slab)	slabs;
+	SLIST_HEAD(, arena_slab)	free_slabs;
+	size_t				slab_size;
+};
+
+struct spdk_arena *
+spdk_arena_create(size_t slab_size)
+{
+	struct spdk_arena *arena;
+
+	arena = calloc(1, sizeof(*arena));
+	if (arena == NULL) {
+		return NULL;
+	}
+
+	arena->slab_size = slab_size != 0 ? slab_size : ARENA_DEFAULT_SLAB_SIZE;
+	SLIST_INIT(&arena->slabs);
+	SLIST_INIT(&arena->free_slabs);
+
+	return arena;
+}
+
+static struct arena_slab *
+arena_get_slab(struct spdk_arena *arena, size_t size)
+{
+	struct arena_slab *slab;
+
+	slab = SLIST_FIRST(&arena->free_slabs);
+	if (slab != NULL && slab->size >= size) {
+		SLIST_REMOVE_HEAD(&arena->free_slabs, link);
+	} else {
+		size = spdk_max(size, arena->slab_size);
+		slab = malloc(sizeof(*slab) + size);
+		if (slab == NULL) {
+			return NULL;
+		}
+		slab->size = size;
+	}
+
+	slab->used = 0;
+	SLIST_INSERT_HEAD(&arena->slabs, slab, link);
+
+	return slab;
+}
+
+void *
+spdk_arena_alloc(struct spdk_arena *arena, size_t size)
+{
+	struct arena_slab *slab;
+	void *buf;
+
+	size = SPDK_ALIGN_CEIL(size, ARENA_ALIGNMENT);
+
+	slab = SLIST_FIRST(&arena->slabs);
+	if (slab == NULL || slab->size - slab->used < size) {
+		slab = arena_get_slab(arena, size);
+		if (slab == NULL) {
+			return NULL;
+		}
+	}
+
+	buf = slab->data + slab->used;
+	slab->used += size;
+
+	return buf;
+}
+
+void *
+spdk_arena_zalloc(struct spdk_arena *arena, size_t size)
+{
+	void *buf;
+
+	buf = spdk_arena_alloc(arena, size);
+	if (buf != NULL) {
+		memset(buf, 0, size);
+	}
+
+	return buf;
+}
+
+void
+spdk_arena_reset(struct spdk_arena *arena)
+{
+	struct arena_slab *slab;
+
+	while ((slab = SLIST_FIRST(&arena->slabs)) != NULL) {
+		SLIST_REMOVE_HEAD(&arena->slabs, link);
+		if (slab->size > arena->slab_size) {
+			/* Oversized slabs back a single large allocation, don't cache them. */
+			free(slab);
+		} else {
+			SLIST_INSERT_HEAD(&arena->free_slabs, slab, link);
+		}
+	}
+}
+
+void
+spdk_arena_destroy(struct spdk_arena *arena)
+{
+	struct arena_slab *slab;
+
+	if (arena == NULL) {
+		return;
+	}
+
+	spdk_arena_reset(arena);
+	while ((slab = SLIST_FIRST(&arena->free_slabs)) != NULL) {
+		SLIST_REMOVE_HEAD(&arena->free_slabs, link);
+		free(slab);
+	}
+
+	free(arena);
+}
+
 void *
 spdk_memzone_reserve_aligned(const char *name, size_t len, int socket_id,
 			     unsigned flags, unsigned align)
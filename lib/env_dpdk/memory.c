@@ -328,8 +328,9 @@ spdk_mem_map_free(struct spdk_mem_map **pmap)
 	*pmap = NULL;
 }
 
-int
-spdk_mem_register(void *vaddr, size_t len)
+/* Must be called with g_spdk_mem_map_mutex held */
+static int
+mem_register(void *vaddr, size_t len)
 {
 	struct spdk_mem_map *map;
 	int rc;
@@ -352,14 +353,11 @@ spdk_mem_register(void *vaddr, size_t len)
 		return 0;
 	}
 
-	pthread_mutex_lock(&g_spdk_mem_map_mutex);
-
 	seg_vaddr = vaddr;
 	seg_len = len;
 	while (seg_len > 0) {
 		reg = spdk_mem_map_translate(g_mem_reg_map, (uint64_t)seg_vaddr, NULL);
 		if (reg & REG_MAP_REGISTERED) {
-			pthread_mutex_unlock(&g_spdk_mem_map_mutex);
 			return -EBUSY;
 		}
 		seg_vaddr += VALUE_2MB;
@@ -379,17 +377,62 @@ spdk_mem_register(void *vaddr, size_t len)
 	TAILQ_FOREACH(map, &g_spdk_mem_maps, tailq) {
 		rc = map->ops.notify_cb(map->cb_ctx, map, SPDK_MEM_MAP_NOTIFY_REGISTER, seg_vaddr, seg_len);
 		if (rc != 0) {
-			pthread_mutex_unlock(&g_spdk_mem_map_mutex);
 			return rc;
 		}
 	}
 
-	pthread_mutex_unlock(&g_spdk_mem_map_mutex);
 	return 0;
 }
 
 int
-spdk_mem_unregister(void *vaddr, size_t len)
+spdk_mem_register(void *vaddr, size_t len)
+{
+	int rc;
+
+	pthread_mutex_lock(&g_spdk_mem_map_mutex);
+	rc = mem_register(vaddr, len);
+	pthread_mutex_unlock(&g_spdk_mem_map_mutex);
+
+	return rc;
+}
+
+int
+spdk_mem_register_batch(struct iovec *iov, uint32_t iovcnt)
+{
+	void *vaddr;
+	size_t len;
+	uint32_t i;
+	int rc = 0;
+
+	pthread_mutex_lock(&g_spdk_mem_map_mutex);
+
+	i = 0;
+	while (i < iovcnt) {
+		vaddr = iov[i].iov_base;
+		len = iov[i].iov_len;
+		/* Coalesce virtually contiguous entries, so that the registered maps
+		 * are notified about one large region rather than many small ones.
+		 */
+		while (i + 1 < iovcnt && iov[i + 1].iov_base == vaddr + len) {
+			len += iov[i + 1].iov_len;
+			i++;
+		}
+
+		rc = mem_register(vaddr, len);
+		if (rc != 0) {
+			break;
+		}
+		i++;
+	}
+
+	pthread_mutex_unlock(&g_spdk_mem_map_mutex);
+
+	return rc;
+}
+
+/* Must be called with g_spdk_mem_map_mutex held */
+static int
+mem_unregister(void *vaddr, size_t len)
 {
 	struct spdk_mem_map *map;
 	int rc;
@@ -408,15 +451,12 @@ spdk_mem_unregister(void *vaddr, size_t len)
 		return -EINVAL;
 	}
 
-	pthread_mutex_lock(&g_spdk_mem_map_mutex);
-
 	/* The first page must be a start of a region. Also check if it's
 	 * registered to make sure we don't return -ERANGE for non-registered
 	 * regions.
 	 */
 	reg = spdk_mem_map_translate(g_mem_reg_map, (uint64_t)vaddr, NULL);
 	if ((reg & REG_MAP_REGISTERED) && (reg & REG_MAP_NOTIFY_START) == 0) {
-		pthread_mutex_unlock(&g_spdk_mem_map_mutex);
 		return -ERANGE;
 	}
 
@@ -425,7 +465,6 @@ spdk_mem_unregister(void *vaddr, size_t len)
 	while (seg_len > 0) {
 		reg = spdk_mem_map_translate(g_mem_reg_map, (uint64_t)seg_vaddr, NULL);
 		if ((reg & REG_MAP_REGISTERED) == 0) {
-			pthread_mutex_unlock(&g_spdk_mem_map_mutex);
 			return -EINVAL;
 		}
 		seg_vaddr += VALUE_2MB;
@@ -437,7 +476,6 @@ spdk_mem_unregister(void *vaddr, size_t len)
 	 * otherwise we'd be unregistering only a part of a region.
 	 */
 	if ((newreg & REG_MAP_NOTIFY_START) == 0 && (newreg & REG_MAP_REGISTERED)) {
-		pthread_mutex_unlock(&g_spdk_mem_map_mutex);
 		return -ERANGE;
 	}
 	seg_vaddr = vaddr;
@@ -451,7 +489,6 @@ spdk_mem_unregister(void *vaddr, size_t len)
 			TAILQ_FOREACH_REVERSE(map, &g_spdk_mem_maps, spdk_mem_map_head, tailq) {
 				rc = map->ops.notify_cb(map->cb_ctx, map, SPDK_MEM_MAP_NOTIFY_UNREGISTER, seg_vaddr, seg_len);
 				if (rc != 0) {
-					pthread_mutex_unlock(&g_spdk_mem_map_mutex);
 					return rc;
 				}
 			}
@@ -470,16 +507,57 @@ spdk_mem_unregister(void *vaddr, size_t len)
 		TAILQ_FOREACH_REVERSE(map, &g_spdk_mem_maps, spdk_mem_map_head, tailq) {
 			rc = map->ops.notify_cb(map->cb_ctx, map, SPDK_MEM_MAP_NOTIFY_UNREGISTER, seg_vaddr, seg_len);
 			if (rc != 0) {
-				pthread_mutex_unlock(&g_spdk_mem_map_mutex);
 				return rc;
 			}
 		}
 	}
 
-	pthread_mutex_unlock(&g_spdk_mem_map_mutex);
 	return 0;
 }
 
+int
+spdk_mem_unregister(void *vaddr, size_t len)
+{
+	int rc;
+
+	pthread_mutex_lock(&g_spdk_mem_map_mutex);
+	rc = mem_unregister(vaddr, len);
+	pthread_mutex_unlock(&g_spdk_mem_map_mutex);
+
+	return rc;
+}
+
+int
+spdk_mem_unregister_batch(struct iovec *iov, uint32_t iovcnt)
+{
+	void *vaddr;
+	size_t len;
+	uint32_t i;
+	int rc = 0;
+
+	pthread_mutex_lock(&g_spdk_mem_map_mutex);
+
+	i = 0;
+	while (i < iovcnt) {
+		vaddr = iov[i].iov_base;
+		len = iov[i].iov_len;
+		while (i + 1 < iovcnt && iov[i + 1].iov_base == vaddr + len) {
+			len += iov[i + 1].iov_len;
+			i++;
+		}
+
+		rc = mem_unregister(vaddr, len);
+		if (rc != 0) {
+			break;
+		}
+		i++;
+	}
+
+	pthread_mutex_unlock(&g_spdk_mem_map_mutex);
+
+	return rc;
+}
+
 int
 spdk_mem_reserve(void *vaddr, size_t len)
 {
@@ -47,6 +47,7 @@ struct spdk_app {
 	void				*json_data;
 	size_t				json_data_size;
 	bool				json_config_ignore_errors;
+	const char			*json_config_snapshot_path;
 	bool				stopped;
 	const char			*rpc_addr;
 	const char			**rpc_allowlist;
@@ -150,6 +151,8 @@ static const struct option g_cmdline_options[] = {
 	{"no-huge",			no_argument,		NULL, NO_HUGE_OPT_IDX},
 #define NO_RPC_SERVER_OPT_IDX	273
 	{"no-rpc-server",		no_argument,		NULL, NO_RPC_SERVER_OPT_IDX},
+#define JSON_CONFIG_SNAPSHOT_OPT_IDX	274
+	{"json-snapshot",		required_argument,	NULL, JSON_CONFIG_SNAPSHOT_OPT_IDX},
 };
 
 static int
@@ -681,10 +684,11 @@ app_copy_opts(struct spdk_app_opts *opts, struct spdk_app_opts *opts_user, size_
 	SET_FIELD(rpc_log_level);
 	SET_FIELD(json_data);
 	SET_FIELD(json_data_size);
+	SET_FIELD(json_config_snapshot_path);
 
 	/* You should not remove this statement, but need to update the assert statement
 	 * if you add a new field, and also add a corresponding SET_FIELD statement */
-	SPDK_STATIC_ASSERT(sizeof(struct spdk_app_opts) == 252, "Incorrect size");
+	SPDK_STATIC_ASSERT(sizeof(struct spdk_app_opts) == 260, "Incorrect size");
 
 #undef SET_FIELD
 }
@@ -868,6 +872,7 @@ spdk_app_start(struct spdk_app_opts *opts_user, spdk_msg_fn start_fn,
 	memset(&g_spdk_app, 0, sizeof(g_spdk_app));
 
 	g_spdk_app.json_config_ignore_errors = opts->json_config_ignore_errors;
+	g_spdk_app.json_config_snapshot_path = opts->json_config_snapshot_path;
 	g_spdk_app.rpc_addr = opts->rpc_addr;
 	g_spdk_app.rpc_allowlist = opts->rpc_allowlist;
 	g_spdk_app.rpc_log_file = opts->rpc_log_file;
@@ -950,7 +955,19 @@ spdk_app_start(struct spdk_app_opts *opts_user, spdk_msg_fn start_fn,
 	g_start_fn = start_fn;
 	g_start_arg = arg1;
 
-	if (opts->json_config_file != NULL) {
+	if (opts->json_config_snapshot_path != NULL) {
+		g_spdk_app.json_data = spdk_subsystem_read_config_snapshot(
+					       opts->json_config_snapshot_path,
+					       &g_spdk_app.json_data_size);
+		if (g_spdk_app.json_data) {
+			SPDK_NOTICELOG("Restoring configuration from snapshot %s\n",
+				       opts->json_config_snapshot_path);
+		}
+	}
+
+	if (g_spdk_app.json_data != NULL) {
+		/* Configuration restored from a snapshot - skip the cold config below */
+	} else if (opts->json_config_file != NULL) {
 		if (opts->json_data) {
 			SPDK_ERRLOG("App opts json_config_file and json_data are mutually exclusive\n");
 			return 1;
@@ -1043,6 +1060,16 @@ app_stop(void *arg1)
 
 	g_spdk_app.stopped = true;
 	spdk_log_for_each_deprecation(NULL, log_deprecation_hits);
+
+	if (g_spdk_app.rc == 0 && g_spdk_app.json_config_snapshot_path != NULL) {
+		/* Subsystems are still fully initialized here, so the snapshot captures
+		 * the complete runtime configuration. */
+		if (spdk_subsystem_save_config_snapshot(g_spdk_app.json_config_snapshot_path)) {
+			SPDK_WARNLOG("Failed to save config snapshot to %s\n",
+				     g_spdk_app.json_config_snapshot_path);
+		}
+	}
+
 	_start_subsystem_fini(NULL);
 }
 
@@ -1100,6 +1127,8 @@ usage(void (*app_usage)(void))
 	printf("     --wait-for-rpc        wait for RPCs to initialize subsystems\n");
 	printf("     --rpcs-allowed	   comma-separated list of permitted RPCS\n");
 	printf("     --json-ignore-init-errors    don't exit on invalid config entry\n");
+	printf("     --json-snapshot <path>    save a config snapshot to <path> on clean shutdown and\n");
+	printf("                           restore from it at startup when present and valid\n");
 
 	printf("\nMemory options:\n");
 	printf("     --iova-mode <pa/va>   set IOVA mode ('pa' for IOVA_PA and 'va' for IOVA_VA)\n");
@@ -1217,6 +1246,9 @@ spdk_app_parse_args(int argc, char **argv, struct spdk_app_opts *opts,
 		case JSON_CONFIG_IGNORE_INIT_ERRORS_IDX:
 			opts->json_config_ignore_errors = true;
 			break;
+		case JSON_CONFIG_SNAPSHOT_OPT_IDX:
+			opts->json_config_snapshot_path = optarg;
+			break;
 		case LIMIT_COREDUMP_OPT_IDX:
 			opts->enable_coredump = false;
 			break;
@@ -125,6 +125,60 @@ rpc_framework_monitor_context_switch(struct spdk_jsonrpc_request *request,
 SPDK_RPC_REGISTER("framework_monitor_context_switch", rpc_framework_monitor_context_switch,
 		  SPDK_RPC_RUNTIME)
 
+struct rpc_framework_set_hybrid_interrupt {
+	bool enabled;
+	uint32_t lcore;
+	bool lcore_set;
+};
+
+static const struct spdk_json_object_decoder rpc_framework_set_hybrid_interrupt_decoders[] = {
+	{"enabled", offsetof(struct rpc_framework_set_hybrid_interrupt, enabled), spdk_json_decode_bool},
+	{"lcore", offsetof(struct rpc_framework_set_hybrid_interrupt, lcore), spdk_json_decode_uint32, true},
+};
+
+static void
+rpc_framework_set_hybrid_interrupt(struct spdk_jsonrpc_request *request,
+				   const struct spdk_json_val *params)
+{
+	struct rpc_framework_set_hybrid_interrupt req = {};
+	struct spdk_json_write_ctx *w;
+	int rc;
+
+	req.lcore = SPDK_ENV_LCORE_ID_ANY;
+	if (spdk_json_decode_object(params, rpc_framework_set_hybrid_interrupt_decoders,
+				    SPDK_COUNTOF(rpc_framework_set_hybrid_interrupt_decoders),
+				    &req)) {
+		SPDK_DEBUGLOG(app_rpc, "spdk_json_decode_object failed\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+						 "Invalid parameters");
+		return;
+	}
+
+	if (req.lcore != SPDK_ENV_LCORE_ID_ANY) {
+		rc = spdk_reactor_set_hybrid_interrupt_mode(req.lcore,
+				req.enabled ? SPDK_REACTOR_HYBRID_MODE_ENABLED :
+				SPDK_REACTOR_HYBRID_MODE_DISABLED);
+	} else {
+		rc = spdk_framework_enable_hybrid_interrupt(req.enabled);
+	}
+
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+		return;
+	}
+
+	w = spdk_jsonrpc_begin_result(request);
+	spdk_json_write_object_begin(w);
+
+	spdk_json_write_named_bool(w, "enabled", spdk_framework_hybrid_interrupt_enabled());
+
+	spdk_json_write_object_end(w);
+	spdk_jsonrpc_end_result(request, w);
+}
+
+SPDK_RPC_REGISTER("framework_set_hybrid_interrupt", rpc_framework_set_hybrid_interrupt,
+		  SPDK_RPC_RUNTIME)
+
 struct rpc_get_stats_ctx {
 	struct spdk_jsonrpc_request *request;
 	struct spdk_json_write_ctx *w;
@@ -200,6 +254,11 @@ _rpc_thread_get_stats(void *arg)
 		spdk_json_write_named_string(ctx->w, "cpumask", spdk_cpuset_fmt(&tmp_mask));
 		spdk_json_write_named_uint64(ctx->w, "busy", stats.busy_tsc);
 		spdk_json_write_named_uint64(ctx->w, "idle", stats.idle_tsc);
+		spdk_json_write_named_uint64(ctx->w, "batched_msg_sends", stats.batched_msg_sends);
+		spdk_json_write_named_uint64(ctx->w, "single_msg_sends", stats.single_msg_sends);
+		spdk_json_write_named_uint64(ctx->w, "busy_poller_runs", stats.busy_poller_runs);
+		spdk_json_write_named_uint64(ctx->w, "poller_deferrals", stats.poller_deferrals);
+		spdk_json_write_named_uint64(ctx->w, "poller_overruns", stats.poller_overruns);
 		spdk_json_write_named_uint64(ctx->w, "active_pollers_count", active_pollers_count);
 		spdk_json_write_named_uint64(ctx->w, "timed_pollers_count", timed_pollers_count);
 		spdk_json_write_named_uint64(ctx->w, "paused_pollers_count", paused_pollers_count);
@@ -222,6 +281,48 @@ rpc_thread_get_stats(struct spdk_jsonrpc_request *request,
 
 SPDK_RPC_REGISTER("thread_get_stats", rpc_thread_get_stats, SPDK_RPC_RUNTIME)
 
+struct rpc_thread_stats_shm_enable {
+	char		*shm_name;
+	uint32_t	max_threads;
+};
+
+static const struct spdk_json_object_decoder rpc_thread_stats_shm_enable_decoders[] = {
+	{"shm_name", offsetof(struct rpc_thread_stats_shm_enable, shm_name), spdk_json_decode_string, true},
+	{"max_threads", offsetof(struct rpc_thread_stats_shm_enable, max_threads), spdk_json_decode_uint32, true},
+};
+
+static void
+rpc_thread_stats_shm_enable(struct spdk_jsonrpc_request *request,
+			    const struct spdk_json_val *params)
+{
+	struct rpc_thread_stats_shm_enable req = {};
+	struct spdk_json_write_ctx *w;
+	int rc;
+
+	if (params != NULL &&
+	    spdk_json_decode_object(params, rpc_thread_stats_shm_enable_decoders,
+				    SPDK_COUNTOF(rpc_thread_stats_shm_enable_decoders), &req)) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+						 "spdk_json_decode_object failed");
+		return;
+	}
+
+	rc = spdk_thread_stats_shm_init(req.shm_name, req.max_threads);
+	free(req.shm_name);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+		return;
+	}
+
+	w = spdk_jsonrpc_begin_result(request);
+	spdk_json_write_object_begin(w);
+	spdk_json_write_named_string(w, "shm_name", spdk_thread_stats_shm_get_name());
+	spdk_json_write_object_end(w);
+	spdk_jsonrpc_end_result(request, w);
+}
+SPDK_RPC_REGISTER("thread_stats_shm_enable", rpc_thread_stats_shm_enable,
+		  SPDK_RPC_STARTUP | SPDK_RPC_RUNTIME)
+
 static void
 rpc_get_poller(struct spdk_poller *poller, struct spdk_json_write_ctx *w)
 {
@@ -237,8 +338,15 @@ rpc_get_poller(struct spdk_poller *poller, struct spdk_json_write_ctx *w)
 	spdk_json_write_named_string(w, "state", spdk_poller_get_state_str(poller));
 	spdk_json_write_named_uint64(w, "run_count", stats.run_count);
 	spdk_json_write_named_uint64(w, "busy_count", stats.busy_count);
+	if (spdk_thread_poller_cycle_tracking_enabled()) {
+		spdk_json_write_named_uint64(w, "busy_tsc", stats.busy_tsc);
+	}
+	if (stats.defer_count) {
+		spdk_json_write_named_uint64(w, "defer_count", stats.defer_count);
+	}
 	if (period_ticks) {
 		spdk_json_write_named_uint64(w, "period_ticks", period_ticks);
+		spdk_json_write_named_uint64(w, "overrun_count", stats.overrun_count);
 	}
 	spdk_json_write_object_end(w);
 }
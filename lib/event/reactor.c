@@ -35,6 +35,28 @@ static enum spdk_reactor_state	g_reactor_state = SPDK_REACTOR_STATE_UNINITIALIZE
 
 static bool g_framework_context_switch_monitor_enabled = true;
 
+/* Automatic interrupt/poll hybrid switching.  Reactors are evaluated once per
+ * period; a busy-poll reactor that stays below the busy threshold for several
+ * consecutive periods drops to interrupt mode, and an interrupt mode reactor
+ * whose fd_group wait wakes up too often goes back to busy-poll right away.
+ */
+#define SPDK_REACTOR_HYBRID_PERIOD_US		(1000 * 1000)
+#define SPDK_REACTOR_HYBRID_IDLE_BUSY_PCT	1
+#define SPDK_REACTOR_HYBRID_IDLE_PERIODS	5
+#define SPDK_REACTOR_HYBRID_WAKEUPS_PER_SEC	1000
+
+static bool g_framework_hybrid_interrupt_enabled = false;
+static uint64_t g_hybrid_period_tsc;
+
+/* Adaptive interrupt-mode event batching.  After a wakeup that found events,
+ * the reactor keeps harvesting follow-on events with zero-timeout polls for a
+ * short window instead of going back to sleep right away.  Each non-empty poll
+ * extends the window, so the effective wait timeout stretches for as long as a
+ * burst lasts, bounded by the configured cap per wakeup.  Disabled by default.
+ */
+static uint32_t g_reactor_intr_batch_spin_us;
+static uint32_t g_reactor_intr_batch_max_spin_us;
+
 static struct spdk_mempool *g_spdk_event_mempool = NULL;
 
 TAILQ_HEAD(, spdk_scheduler) g_scheduler_list
@@ -640,6 +662,64 @@ spdk_framework_context_switch_monitor_enabled(void)
 	return g_framework_context_switch_monitor_enabled;
 }
 
+int
+spdk_framework_enable_hybrid_interrupt(bool enabled)
+{
+	if (enabled && !spdk_interrupt_mode_is_enabled()) {
+		SPDK_ERRLOG("Hybrid interrupt switching requires running with interrupt mode enabled\n");
+		return -ENOTSUP;
+	}
+
+	/* Like the context switch monitor flag, this global is read by the
+	 * reactors without synchronization and may be observed late.
+	 */
+	g_framework_hybrid_interrupt_enabled = enabled;
+
+	return 0;
+}
+
+bool
+spdk_framework_hybrid_interrupt_enabled(void)
+{
+	return g_framework_hybrid_interrupt_enabled;
+}
+
+int
+spdk_framework_set_interrupt_batching(uint32_t spin_us, uint32_t max_spin_us)
+{
+	if (spin_us > 0 && max_spin_us < spin_us) {
+		return -EINVAL;
+	}
+
+	/* Read by the reactors without synchronization, like the hybrid
+	 * interrupt flag; updated values may be observed late.
+	 */
+	g_reactor_intr_batch_spin_us = spin_us;
+	g_reactor_intr_batch_max_spin_us = max_spin_us;
+
+	return 0;
+}
+
+int
+spdk_reactor_set_hybrid_interrupt_mode(uint32_t lcore, enum spdk_reactor_hybrid_mode mode)
+{
+	struct spdk_reactor *reactor;
+
+	reactor = spdk_reactor_get(lcore);
+	if (reactor == NULL) {
+		return -EINVAL;
+	}
+
+	if (mode == SPDK_REACTOR_HYBRID_MODE_ENABLED &&
+	    (reactor->fgrp == NULL || !spdk_interrupt_mode_is_enabled())) {
+		return -ENOTSUP;
+	}
+
+	reactor->hybrid_mode = mode;
+
+	return 0;
+}
+
 static void
 _set_thread_name(const char *thread_name)
 {
@@ -667,6 +747,8 @@ _init_thread_stats(struct spdk_reactor *reactor, struct spdk_lw_thread *lw_threa
 
 	lw_thread->current_stats.busy_tsc = lw_thread->total_stats.busy_tsc - prev_total_stats.busy_tsc;
 	lw_thread->current_stats.idle_tsc = lw_thread->total_stats.idle_tsc - prev_total_stats.idle_tsc;
+	lw_thread->current_stats.busy_poller_runs = lw_thread->total_stats.busy_poller_runs -
+			prev_total_stats.busy_poller_runs;
 }
 
 static void
@@ -816,6 +898,7 @@ _reactors_scheduler_gather_metrics(void *arg1, void *arg2)
 			core_info->thread_infos[i].thread_id = spdk_thread_get_id(thread);
 			core_info->thread_infos[i].total_stats = lw_thread->total_stats;
 			core_info->thread_infos[i].current_stats = lw_thread->current_stats;
+			core_info->thread_infos[i].latency_sensitive = spdk_thread_is_latency_sensitive(thread);
 			core_info->threads_count++;
 			assert(core_info->threads_count <= reactor->thread_count);
 			i++;
@@ -885,8 +968,145 @@ static void
 reactor_interrupt_run(struct spdk_reactor *reactor)
 {
 	int block_timeout = -1; /* _EPOLL_WAIT_FOREVER */
+	uint64_t now, spin_tsc, spin_end, batch_end;
+	int rc;
 
-	spdk_fd_group_wait(reactor->fgrp, block_timeout);
+	rc = spdk_fd_group_wait(reactor->fgrp, block_timeout);
+	if (rc <= 0 || g_reactor_intr_batch_spin_us == 0) {
+		return;
+	}
+
+	/* Bursty event sources often fire several wakeups back to back.  Spin
+	 * briefly harvesting follow-on events so the burst is handled in one
+	 * sleep/wake cycle, extending the window while events keep arriving.
+	 */
+	spin_tsc = spdk_get_ticks_hz() * g_reactor_intr_batch_spin_us / SPDK_SEC_TO_USEC;
+	now = spdk_get_ticks();
+	batch_end = now + spdk_get_ticks_hz() * g_reactor_intr_batch_max_spin_us / SPDK_SEC_TO_USEC;
+	spin_end = spdk_min(now + spin_tsc, batch_end);
+
+	while (now < spin_end) {
+		rc = spdk_fd_group_wait(reactor->fgrp, 0);
+		now = spdk_get_ticks();
+		if (rc > 0) {
+			spin_end = spdk_min(now + spin_tsc, batch_end);
+		}
+	}
+}
+
+static void
+_reactor_hybrid_switch_done(void *arg)
+{
+	struct spdk_reactor *reactor = arg;
+
+	reactor->hybrid_switch_pending = false;
+}
+
+/* Runs on the app thread - spdk_reactor_set_interrupt_mode() is only
+ * permitted there.
+ */
+static void
+_reactor_hybrid_request_switch(void *arg)
+{
+	struct spdk_reactor *reactor = arg;
+	int rc;
+
+	rc = spdk_reactor_set_interrupt_mode(reactor->lcore, reactor->hybrid_target_in_interrupt,
+					     _reactor_hybrid_switch_done, reactor);
+	if (rc != 0) {
+		reactor->hybrid_switch_pending = false;
+	}
+}
+
+static void
+reactor_hybrid_request_switch(struct spdk_reactor *reactor, bool new_in_interrupt)
+{
+	reactor->hybrid_switch_pending = true;
+	reactor->hybrid_target_in_interrupt = new_in_interrupt;
+	/* Start measuring from scratch once the switch has happened. */
+	reactor->hybrid_eval_tsc = 0;
+	reactor->hybrid_idle_periods = 0;
+
+	spdk_thread_send_msg(spdk_thread_get_app_thread(), _reactor_hybrid_request_switch, reactor);
+}
+
+static void
+reactor_hybrid_check(struct spdk_reactor *reactor)
+{
+	uint64_t now, delta_tsc, busy_delta, idle_delta;
+	uint64_t busy_pct, wakeup_rate;
+	bool enabled;
+
+	if (reactor->hybrid_mode == SPDK_REACTOR_HYBRID_MODE_DEFAULT) {
+		enabled = g_framework_hybrid_interrupt_enabled;
+	} else {
+		enabled = reactor->hybrid_mode == SPDK_REACTOR_HYBRID_MODE_ENABLED;
+	}
+
+	if (spdk_likely(!enabled)) {
+		return;
+	}
+
+	if (reactor->hybrid_switch_pending || reactor->set_interrupt_mode_in_progress) {
+		return;
+	}
+
+	if (spdk_unlikely(g_hybrid_period_tsc == 0)) {
+		g_hybrid_period_tsc = spdk_get_ticks_hz() * SPDK_REACTOR_HYBRID_PERIOD_US /
+				      SPDK_SEC_TO_USEC;
+	}
+
+	now = spdk_get_ticks();
+	if (reactor->in_interrupt) {
+		reactor->hybrid_wakeups++;
+	}
+
+	if (reactor->hybrid_eval_tsc == 0) {
+		goto reset;
+	}
+
+	delta_tsc = now - reactor->hybrid_eval_tsc;
+	if (delta_tsc < g_hybrid_period_tsc) {
+		return;
+	}
+
+	if (reactor->in_interrupt) {
+		/* No tsc stats are accumulated in interrupt mode, so use the
+		 * fd_group wake-up rate as the load signal.  Once waking up
+		 * costs more than polling would, go back to busy-poll at once.
+		 */
+		wakeup_rate = reactor->hybrid_wakeups * spdk_get_ticks_hz() / delta_tsc;
+		if (wakeup_rate > SPDK_REACTOR_HYBRID_WAKEUPS_PER_SEC) {
+			reactor_hybrid_request_switch(reactor, false);
+			return;
+		}
+	} else {
+		busy_delta = reactor->busy_tsc - reactor->hybrid_prev_busy_tsc;
+		idle_delta = reactor->idle_tsc - reactor->hybrid_prev_idle_tsc;
+		if (busy_delta + idle_delta == 0) {
+			busy_pct = 0;
+		} else {
+			busy_pct = busy_delta * 100 / (busy_delta + idle_delta);
+		}
+
+		/* Require several consecutive near-idle periods before dropping
+		 * to interrupt mode, so that short dips do not cause flapping.
+		 */
+		if (busy_pct <= SPDK_REACTOR_HYBRID_IDLE_BUSY_PCT) {
+			if (++reactor->hybrid_idle_periods >= SPDK_REACTOR_HYBRID_IDLE_PERIODS) {
+				reactor_hybrid_request_switch(reactor, true);
+				return;
+			}
+		} else {
+			reactor->hybrid_idle_periods = 0;
+		}
+	}
+
+reset:
+	reactor->hybrid_eval_tsc = now;
+	reactor->hybrid_prev_busy_tsc = reactor->busy_tsc;
+	reactor->hybrid_prev_idle_tsc = reactor->idle_tsc;
+	reactor->hybrid_wakeups = 0;
 }
 
 static void
@@ -952,6 +1172,8 @@ reactor_run(void *arg)
 			_reactor_run(reactor);
 		}
 
+		reactor_hybrid_check(reactor);
+
 		if (g_framework_context_switch_monitor_enabled) {
 			if ((reactor->last_rusage + g_rusage_period) < reactor->tsc_last) {
 				get_rusage(reactor);
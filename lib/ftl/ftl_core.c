@@ -32,7 +32,9 @@ ftl_io_cmpl_cb(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 	struct ftl_io *io = cb_arg;
 	struct spdk_ftl_dev *dev = io->dev;
 
-	ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_USER, bdev_io);
+	if (bdev_io != NULL) {
+		ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_USER, bdev_io);
+	}
 
 	if (spdk_unlikely(!success)) {
 		io->status = -EIO;
@@ -45,7 +47,9 @@ ftl_io_cmpl_cb(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 		ftl_io_complete(io);
 	}
 
-	spdk_bdev_free_io(bdev_io);
+	if (bdev_io != NULL) {
+		spdk_bdev_free_io(bdev_io);
+	}
 }
 
 static void
@@ -162,6 +166,7 @@ ftl_invalidate_addr(struct spdk_ftl_dev *dev, ftl_addr addr)
 	if (FTL_BAND_STATE_OPEN == band->md->state || FTL_BAND_STATE_FULL == band->md->state) {
 		p2l_map->band_map[ftl_band_block_offset_from_addr(band, addr)].lba = FTL_LBA_INVALID;
 		p2l_map->band_map[ftl_band_block_offset_from_addr(band, addr)].seq_id = 0;
+		ftl_p2l_ckpt_invalidate(band, addr);
 	}
 }
 
@@ -512,7 +517,6 @@ spdk_ftl_unmap(struct spdk_ftl_dev *dev, struct ftl_io *io, struct spdk_io_chann
 	return rc;
 }
 
-#define FTL_IO_QUEUE_BATCH 16
 int
 ftl_io_channel_poll(void *arg)
 {
@@ -744,8 +748,16 @@ int
 ftl_core_poller(void *ctx)
 {
 	struct spdk_ftl_dev *dev = ctx;
+	struct ftl_io_channel *ioch;
 	uint64_t io_activity_total_old = dev->stats.io_activity_total;
 
+	/* Push out completions batched up since the previous poll, including ones
+	 * produced by bdev callbacks between polls
+	 */
+	TAILQ_FOREACH(ioch, &dev->ioch_queue, entry) {
+		ftl_io_channel_flush_completions(ioch);
+	}
+
 	if (dev->halt && ftl_shutdown_complete(dev)) {
 		spdk_poller_unregister(&dev->core_poller);
 		return SPDK_POLLER_IDLE;
@@ -757,6 +769,7 @@ ftl_core_poller(void *ctx)
 	ftl_reloc(dev->reloc);
 	ftl_nv_cache_process(dev);
 	ftl_l2p_process(dev);
+	ftl_hotness_sketch_decay(dev->hotness);
 
 	if (io_activity_total_old != dev->stats.io_activity_total) {
 		return SPDK_POLLER_BUSY;
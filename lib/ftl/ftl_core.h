@@ -25,6 +25,7 @@
 #include "ftl_l2p.h"
 #include "base/ftl_base_dev.h"
 #include "utils/ftl_bitmap.h"
+#include "utils/ftl_hotness.h"
 #include "utils/ftl_log.h"
 #include "utils/ftl_property.h"
 
@@ -181,6 +182,9 @@ struct spdk_ftl_dev {
 	/* Writer for GC IOs */
 	struct ftl_writer		writer_gc;
 
+	/* LBA update-recency sketch used to separate hot and cold user data */
+	struct ftl_hotness_sketch	*hotness;
+
 	uint32_t			num_logical_bands_in_physical;
 
 	/* Retry init sequence */
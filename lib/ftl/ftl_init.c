@@ -85,6 +85,7 @@ free_dev(struct spdk_ftl_dev *dev)
 	}
 
 	deinit_core_thread(dev);
+	ftl_hotness_sketch_destroy(dev->hotness);
 	spdk_ftl_conf_deinit(&dev->conf);
 	ftl_properties_deinit(dev);
 	free(dev);
@@ -128,6 +129,12 @@ allocate_dev(const struct spdk_ftl_conf *conf, int *error)
 	ftl_writer_init(dev, &dev->writer_user, SPDK_FTL_LIMIT_HIGH, FTL_BAND_TYPE_COMPACTION);
 	ftl_writer_init(dev, &dev->writer_gc, SPDK_FTL_LIMIT_CRIT, FTL_BAND_TYPE_GC);
 
+	dev->hotness = ftl_hotness_sketch_create(FTL_HOTNESS_NUM_COUNTERS);
+	if (!dev->hotness) {
+		*error = -ENOMEM;
+		goto error;
+	}
+
 	return dev;
 error:
 	free_dev(dev);
@@ -146,6 +146,8 @@ void ftl_p2l_ckpt_deinit(struct spdk_ftl_dev *dev);
 
 void ftl_p2l_ckpt_issue(struct ftl_rq *rq);
 
+void ftl_p2l_ckpt_invalidate(struct ftl_band *band, ftl_addr addr);
+
 struct ftl_p2l_ckpt *ftl_p2l_ckpt_acquire(struct spdk_ftl_dev *dev);
 
 struct ftl_p2l_ckpt *ftl_p2l_ckpt_acquire_region_type(struct spdk_ftl_dev *dev,
@@ -114,11 +114,24 @@ ftl_io_iovec_len_left(struct ftl_io *io)
 	}
 }
 
+void
+ftl_io_channel_flush_completions(struct ftl_io_channel *ioch)
+{
+	size_t result  __attribute__((unused));
+
+	if (!ioch->comp_batch_count) {
+		return;
+	}
+
+	result = spdk_ring_enqueue(ioch->cq, ioch->comp_batch, ioch->comp_batch_count, NULL);
+	assert(result == ioch->comp_batch_count);
+	ioch->comp_batch_count = 0;
+}
+
 static void
 ftl_io_cb(struct ftl_io *io, void *arg, int status)
 {
 	struct ftl_io_channel *ioch = ftl_io_channel_get_ctx(io->ioch);
-	size_t result  __attribute__((unused));
 
 	if (spdk_unlikely(status)) {
 		io->status = status;
@@ -156,8 +169,13 @@ ftl_io_cb(struct ftl_io *io, void *arg, int status)
 		ftl_mempool_put(ioch->map_pool, io->map);
 	}
 
-	result = spdk_ring_enqueue(ioch->cq, (void **)&io, 1, NULL);
-	assert(result != 0);
+	/* Completions are gathered and pushed to the completion queue in one ring
+	 * operation per batch, ftl_core_poller() flushes any leftovers
+	 */
+	ioch->comp_batch[ioch->comp_batch_count++] = io;
+	if (ioch->comp_batch_count == FTL_IO_QUEUE_BATCH) {
+		ftl_io_channel_flush_completions(ioch);
+	}
 }
 
 int
@@ -39,6 +39,8 @@ enum ftl_io_type {
 
 #define FTL_IO_MAX_IOVEC 4
 
+#define FTL_IO_QUEUE_BATCH 16
+
 struct ftl_io_channel {
 	/*  Device */
 	struct spdk_ftl_dev		*dev;
@@ -52,6 +54,9 @@ struct ftl_io_channel {
 	struct spdk_ring		*sq;
 	/*  Completion queue */
 	struct spdk_ring		*cq;
+	/*  Completed IOs waiting to be pushed to the completion queue in one batch */
+	void				*comp_batch[FTL_IO_QUEUE_BATCH];
+	uint64_t			comp_batch_count;
 };
 
 /* General IO descriptor for user requests */
@@ -199,6 +204,10 @@ struct ftl_rq {
 	/* Request result status */
 	bool success;
 
+	/* Data temperature hint, the user writer directs hot and cold requests
+	 * to separate open bands */
+	bool hot;
+
 	/* Fields for owner of this request */
 	struct {
 		/* End request callback */
@@ -317,6 +326,7 @@ int ftl_io_init(struct spdk_io_channel *ioch, struct ftl_io *io, uint64_t lba,
 		size_t num_blocks, struct iovec *iov, size_t iov_cnt, spdk_ftl_fn cb_fn,
 		void *cb_arg, int type);
 void ftl_io_complete(struct ftl_io *io);
+void ftl_io_channel_flush_completions(struct ftl_io_channel *ioch);
 void ftl_rq_del(struct ftl_rq *rq);
 struct ftl_rq *ftl_rq_new(struct spdk_ftl_dev *dev, uint32_t io_md_size);
 void ftl_rq_unpin(struct ftl_rq *rq);
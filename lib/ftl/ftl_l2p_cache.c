@@ -84,6 +84,26 @@ struct ftl_l2p_l1_map_entry {
 	ftl_df_obj_id page_obj_id;
 };
 
+/* A run of delta-encoded L2P entries: <count> consecutive LBAs mapped either to
+ * consecutive physical addresses starting at <start>, or - when <start> is
+ * FTL_ADDR_INVALID - to <count> unmapped entries. */
+struct ftl_l2p_comp_run {
+	ftl_addr start;
+	uint32_t count;
+};
+
+/* Compressed copy of a clean L2P page kept resident after eviction. Decoding it
+ * on a page fault saves a read from the cache device. */
+struct ftl_l2p_comp_page {
+	uint64_t page_no;
+	uint32_t num_runs;
+	TAILQ_ENTRY(ftl_l2p_comp_page) list_entry;
+	struct ftl_l2p_comp_run runs[];
+};
+
+/* Portion of the L2P DRAM limit reserved for compressed copies of evicted pages */
+#define FTL_L2P_CACHE_COMP_BUDGET_RATIO 25UL
+
 enum ftl_l2p_cache_state {
 	L2P_CACHE_INIT,
 	L2P_CACHE_RUNNING,
@@ -118,6 +138,22 @@ struct ftl_l2p_cache {
 	uint32_t l2_pgs_evicting;
 	uint32_t l2_pgs_resident_max;
 	uint32_t evict_keep;
+
+	/* Clean pages evicted from the cache are kept resident in a delta-encoded
+	 * form as long as they compress well, so the same DRAM budget covers more
+	 * of the L2P and a page fault can be served without touching the cache device. */
+	struct {
+		struct ftl_l2p_comp_page **mapping;	/* page_no to compressed copy */
+		TAILQ_HEAD(l2p_comp_lru_list, ftl_l2p_comp_page) lru_list;
+		uint64_t budget;	/* DRAM budget for compressed copies, in bytes */
+		uint64_t used;		/* Bytes currently occupied by compressed copies */
+		uint64_t raw_size;	/* Uncompressed size of the pages currently held */
+		uint64_t pages;		/* Number of compressed copies currently held */
+		uint64_t hits;		/* Page faults served by decoding a compressed copy */
+		uint64_t misses;	/* Page faults that had to read the cache device */
+		uint64_t incompressible;	/* Evicted pages dropped due to a poor compression ratio */
+	} comp;
+
 	struct ftl_mempool *page_sets_pool;
 	TAILQ_HEAD(, ftl_l2p_page_set) deferred_page_set_list; /* for deferred page sets */
 
@@ -377,6 +413,183 @@ ftl_l2p_cache_evict_continue(struct ftl_l2p_cache *cache)
 	return cache->l2_pgs_avail + cache->l2_pgs_evicting < cache->evict_keep;
 }
 
+static inline size_t
+ftl_l2p_cache_comp_page_size(uint32_t num_runs)
+{
+	return sizeof(struct ftl_l2p_comp_page) + num_runs * sizeof(struct ftl_l2p_comp_run);
+}
+
+/* Delta-encode the page contents into <runs> (or just count the runs when <runs>
+ * is NULL). Returns the number of runs needed to describe the page. */
+static uint32_t
+ftl_l2p_cache_comp_encode(struct spdk_ftl_dev *dev, struct ftl_l2p_page *page,
+			  uint64_t naddr, struct ftl_l2p_comp_run *runs)
+{
+	uint32_t num_runs = 0, count = 0;
+	ftl_addr addr, start = FTL_ADDR_INVALID;
+	uint64_t i;
+
+	for (i = 0; i < naddr; i++) {
+		addr = ftl_addr_load(dev, page->page_buffer, i);
+		if (count &&
+		    ((start == FTL_ADDR_INVALID && addr == FTL_ADDR_INVALID) ||
+		     (start != FTL_ADDR_INVALID && addr == start + count))) {
+			count++;
+			continue;
+		}
+
+		if (count) {
+			if (runs) {
+				runs[num_runs].start = start;
+				runs[num_runs].count = count;
+			}
+			num_runs++;
+		}
+
+		start = addr;
+		count = 1;
+	}
+
+	if (count) {
+		if (runs) {
+			runs[num_runs].start = start;
+			runs[num_runs].count = count;
+		}
+		num_runs++;
+	}
+
+	return num_runs;
+}
+
+static void
+ftl_l2p_cache_comp_drop(struct ftl_l2p_cache *cache, struct ftl_l2p_comp_page *comp_page)
+{
+	assert(cache->comp.mapping[comp_page->page_no] == comp_page);
+
+	TAILQ_REMOVE(&cache->comp.lru_list, comp_page, list_entry);
+	cache->comp.mapping[comp_page->page_no] = NULL;
+	cache->comp.used -= ftl_l2p_cache_comp_page_size(comp_page->num_runs);
+	cache->comp.raw_size -= ftl_l2p_cache_get_l1_page_size();
+	cache->comp.pages--;
+	free(comp_page);
+}
+
+static inline void
+ftl_l2p_cache_comp_invalidate(struct ftl_l2p_cache *cache, uint64_t page_no)
+{
+	struct ftl_l2p_comp_page *comp_page = cache->comp.mapping[page_no];
+
+	if (spdk_unlikely(comp_page != NULL)) {
+		ftl_l2p_cache_comp_drop(cache, comp_page);
+	}
+}
+
+/* Stash a compressed copy of a clean page which is about to be removed from
+ * the cache. Pages which do not compress are dropped - the DRAM is better
+ * spent on uncompressed resident pages then. */
+static void
+ftl_l2p_cache_comp_stash(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache,
+			 struct ftl_l2p_page *page)
+{
+	uint64_t naddr = ftl_l2p_cache_get_lbas_in_page(cache);
+	struct ftl_l2p_comp_page *comp_page, *coldest;
+	uint32_t num_runs;
+	size_t size;
+
+	/* The copy must match the on-disk page contents - see the invalidate
+	 * calls on the page out paths. */
+	assert(!page->updates);
+	assert(cache->comp.mapping[page->page_no] == NULL);
+
+	num_runs = ftl_l2p_cache_comp_encode(dev, page, naddr, NULL);
+	size = ftl_l2p_cache_comp_page_size(num_runs);
+
+	/* Keep only pages which compress at least 2x */
+	if (size * 2 > ftl_l2p_cache_get_l1_page_size()) {
+		cache->comp.incompressible++;
+		return;
+	}
+
+	while (cache->comp.used + size > cache->comp.budget) {
+		coldest = TAILQ_LAST(&cache->comp.lru_list, l2p_comp_lru_list);
+		if (!coldest) {
+			return;
+		}
+
+		ftl_l2p_cache_comp_drop(cache, coldest);
+	}
+
+	comp_page = malloc(size);
+	if (spdk_unlikely(!comp_page)) {
+		return;
+	}
+
+	comp_page->page_no = page->page_no;
+	comp_page->num_runs = num_runs;
+	ftl_l2p_cache_comp_encode(dev, page, naddr, comp_page->runs);
+
+	cache->comp.mapping[page->page_no] = comp_page;
+	TAILQ_INSERT_HEAD(&cache->comp.lru_list, comp_page, list_entry);
+	cache->comp.used += size;
+	cache->comp.raw_size += ftl_l2p_cache_get_l1_page_size();
+	cache->comp.pages++;
+}
+
+/* Try to serve a page fault by decoding a compressed resident copy of the page.
+ * Returns true if the page buffer was filled and no read is needed. */
+static bool
+ftl_l2p_cache_comp_page_in(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache,
+			   struct ftl_l2p_page *page)
+{
+	struct ftl_l2p_comp_page *comp_page = cache->comp.mapping[page->page_no];
+	struct ftl_l2p_comp_run *run;
+	uint64_t entry = 0;
+	uint32_t i, j;
+
+	if (!comp_page) {
+		cache->comp.misses++;
+		return false;
+	}
+
+	for (i = 0; i < comp_page->num_runs; i++) {
+		run = &comp_page->runs[i];
+		for (j = 0; j < run->count; j++, entry++) {
+			ftl_addr_store(dev, page->page_buffer, entry,
+				       run->start == FTL_ADDR_INVALID ?
+				       FTL_ADDR_INVALID : run->start + j);
+		}
+	}
+	assert(entry == ftl_l2p_cache_get_lbas_in_page(cache));
+
+	cache->comp.hits++;
+	/* The page is resident in uncompressed form now - drop the copy, it will
+	 * be stashed again when the page gets evicted. */
+	ftl_l2p_cache_comp_drop(cache, comp_page);
+
+	return true;
+}
+
+static void
+ftl_property_dump_l2p_cache(struct spdk_ftl_dev *dev, const struct ftl_property *property,
+			    struct spdk_json_write_ctx *w)
+{
+	struct ftl_l2p_cache *cache = (struct ftl_l2p_cache *)dev->l2p;
+	double ratio = 0;
+
+	if (cache->comp.used) {
+		ratio = (double)cache->comp.raw_size / (double)cache->comp.used;
+	}
+
+	spdk_json_write_named_uint64(w, "resident_pages",
+				     cache->l2_pgs_resident_max - cache->l2_pgs_avail);
+	spdk_json_write_named_uint64(w, "compressed_pages", cache->comp.pages);
+	spdk_json_write_named_uint64(w, "compressed_size", cache->comp.used);
+	spdk_json_write_named_double(w, "compression_ratio", ratio);
+	spdk_json_write_named_uint64(w, "compressed_hits", cache->comp.hits);
+	spdk_json_write_named_uint64(w, "compressed_misses", cache->comp.misses);
+	spdk_json_write_named_uint64(w, "incompressible_pages", cache->comp.incompressible);
+}
+
 static void *
 _ftl_l2p_cache_init(struct spdk_ftl_dev *dev, size_t addr_size, uint64_t l2p_size)
 {
@@ -451,16 +664,33 @@ ftl_l2p_cache_init(struct spdk_ftl_dev *dev)
 	if (max_resident_pgs > cache->num_pages) {
 		SPDK_NOTICELOG("l2p memory limit higher than entire L2P size\n");
 		max_resident_pgs = cache->num_pages;
+	} else {
+		/* Carve out a part of the DRAM budget for compressed copies of
+		 * evicted pages - only useful when the L2P doesn't fit in DRAM
+		 * uncompressed in the first place. */
+		cache->comp.budget = max_resident_size * FTL_L2P_CACHE_COMP_BUDGET_RATIO / 100;
+		max_resident_pgs = (max_resident_size - cache->comp.budget) /
+				   ftl_l2p_cache_get_page_all_size();
 	}
 
 	/* Round down max res pgs to the nearest # of l2/l1 pgs */
 	max_resident_size = max_resident_pgs * ftl_l2p_cache_get_page_all_size();
 	SPDK_NOTICELOG("l2p maximum resident size is: %"PRIu64" (of %"PRIu64") MiB\n",
 		       max_resident_size >> 20, dev->conf.l2p_dram_limit);
+	if (cache->comp.budget) {
+		SPDK_NOTICELOG("l2p compressed page budget is: %"PRIu64" MiB\n",
+			       cache->comp.budget >> 20);
+	}
 
 	TAILQ_INIT(&cache->deferred_page_set_list);
 	TAILQ_INIT(&cache->lru_list);
 
+	cache->comp.mapping = calloc(cache->num_pages, sizeof(*cache->comp.mapping));
+	if (!cache->comp.mapping) {
+		return -1;
+	}
+	TAILQ_INIT(&cache->comp.lru_list);
+
 	cache->l2_ctx_md = ftl_md_create(dev,
 					 spdk_divide_round_up(max_resident_pgs * SPDK_ALIGN_CEIL(sizeof(struct ftl_l2p_page), 64),
 							 FTL_BLOCK_SIZE), 0, FTL_L2P_CACHE_MD_NAME_L2_CTX, ftl_md_create_shm_flags(dev), NULL);
@@ -504,12 +734,23 @@ ftl_l2p_cache_init(struct spdk_ftl_dev *dev)
 	cache->cache_layout_bdev_desc = reg->bdev_desc;
 	cache->cache_layout_ioch = reg->ioch;
 
+	ftl_property_register(dev, "l2p_cache", NULL, 0, NULL, NULL, ftl_property_dump_l2p_cache,
+			      NULL, NULL, true);
+
 	return 0;
 }
 
 static void
 ftl_l2p_cache_deinit_l2(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache)
 {
+	struct ftl_l2p_comp_page *comp_page;
+
+	while ((comp_page = TAILQ_FIRST(&cache->comp.lru_list))) {
+		ftl_l2p_cache_comp_drop(cache, comp_page);
+	}
+	free(cache->comp.mapping);
+	cache->comp.mapping = NULL;
+
 	ftl_md_destroy(cache->l2_ctx_md, ftl_md_destroy_shm_flags(dev));
 	cache->l2_ctx_md = NULL;
 
@@ -603,9 +844,10 @@ process_persist_page_out_cb(struct spdk_bdev_io *bdev_io, bool success, void *ar
 	struct spdk_ftl_dev *dev = cache->dev;
 	struct ftl_l2p_cache_process_ctx *ctx = &cache->mctx;
 
-	assert(bdev_io);
-	ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_L2P, bdev_io);
-	spdk_bdev_free_io(bdev_io);
+	if (bdev_io) {
+		ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_L2P, bdev_io);
+		spdk_bdev_free_io(bdev_io);
+	}
 
 	if (!success) {
 		ctx->status = -EIO;
@@ -635,6 +877,9 @@ process_page_out(struct ftl_l2p_page *page, spdk_bdev_io_completion_cb cb)
 
 	assert(page->page_buffer);
 
+	/* The write below makes any compressed copy of the page stale */
+	ftl_l2p_cache_comp_invalidate(cache, page->page_no);
+
 	rc = ftl_nv_cache_bdev_write_blocks_with_md(dev, ftl_l2p_cache_get_bdev_desc(cache),
 			ftl_l2p_cache_get_bdev_iochannel(cache),
 			page->page_buffer, NULL, ftl_l2p_cache_page_get_bdev_offset(cache, page),
@@ -677,9 +922,10 @@ process_trim_page_out_cb(struct spdk_bdev_io *bdev_io, bool success, void *ctx_p
 	struct spdk_ftl_dev *dev = cache->dev;
 	struct ftl_l2p_cache_process_ctx *ctx = &cache->mctx;
 
-	assert(bdev_io);
-	ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_L2P, bdev_io);
-	spdk_bdev_free_io(bdev_io);
+	if (bdev_io) {
+		ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_L2P, bdev_io);
+		spdk_bdev_free_io(bdev_io);
+	}
 
 	if (!success) {
 		ctx->status = -EIO;
@@ -1239,8 +1485,10 @@ page_in_io_cb(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 	struct ftl_l2p_cache *cache = page->ctx.cache;
 	struct spdk_ftl_dev *dev = cache->dev;
 
-	ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_L2P, bdev_io);
-	spdk_bdev_free_io(bdev_io);
+	if (bdev_io) {
+		ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_L2P, bdev_io);
+		spdk_bdev_free_io(bdev_io);
+	}
 	page_in_io_complete(dev, cache, page, success);
 }
 
@@ -1253,6 +1501,13 @@ page_in_io(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache, struct ftl_l2p
 	int rc;
 	page->ctx.cache = cache;
 
+	if (ftl_l2p_cache_comp_page_in(dev, cache, page)) {
+		/* Served from a compressed resident copy, no read needed */
+		cache->ios_in_flight++;
+		page_in_io_complete(dev, cache, page, true);
+		return;
+	}
+
 	rc = ftl_nv_cache_bdev_read_blocks_with_md(cache->dev, ftl_l2p_cache_get_bdev_desc(cache),
 			ftl_l2p_cache_get_bdev_iochannel(cache),
 			page->page_buffer, NULL, ftl_l2p_cache_page_get_bdev_offset(cache, page),
@@ -1406,6 +1661,7 @@ page_out_io_complete(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache,
 	}
 
 	if (success && ftl_l2p_cache_page_can_remove(page)) {
+		ftl_l2p_cache_comp_stash(dev, cache, page);
 		ftl_l2p_cache_page_remove(cache, page);
 	} else {
 		if (!page->pin_ref_cnt) {
@@ -1422,8 +1678,10 @@ page_out_io_cb(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 	struct ftl_l2p_cache *cache = page->ctx.cache;
 	struct spdk_ftl_dev *dev = cache->dev;
 
-	ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_L2P, bdev_io);
-	spdk_bdev_free_io(bdev_io);
+	if (bdev_io) {
+		ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_L2P, bdev_io);
+		spdk_bdev_free_io(bdev_io);
+	}
 	page_out_io_complete(dev, cache, page, success);
 }
 
@@ -1438,6 +1696,9 @@ page_out_io(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *cache,
 
 	page->ctx.cache = cache;
 
+	/* The write below makes any compressed copy of the page stale */
+	ftl_l2p_cache_comp_invalidate(cache, page->page_no);
+
 	rc = ftl_nv_cache_bdev_write_blocks_with_md(dev, ftl_l2p_cache_get_bdev_desc(cache),
 			ftl_l2p_cache_get_bdev_iochannel(cache),
 			page->page_buffer, NULL, ftl_l2p_cache_page_get_bdev_offset(cache, page),
@@ -1500,6 +1761,7 @@ ftl_l2p_cache_process_eviction(struct spdk_ftl_dev *dev, struct ftl_l2p_cache *c
 		page_out_io(dev, cache, page);
 	} else {
 		/* Page clean and we can remove it */
+		ftl_l2p_cache_comp_stash(dev, cache, page);
 		ftl_l2p_cache_page_remove(cache, page);
 	}
 }
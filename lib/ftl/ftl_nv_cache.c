@@ -289,7 +289,7 @@ ftl_nv_cache_init(struct spdk_ftl_dev *dev)
 	assert(offset <= nvc_data_offset(nv_cache) + nvc_data_blocks(nv_cache));
 
 	TAILQ_INIT(&nv_cache->compactor_list);
-	for (i = 0; i < FTL_NV_CACHE_NUM_COMPACTORS; i++) {
+	for (i = 0; i < dev->conf.nv_cache_compaction_concurrency; i++) {
 		compactor = compactor_alloc(dev);
 
 		if (!compactor) {
@@ -322,7 +322,7 @@ ftl_nv_cache_init(struct spdk_ftl_dev *dev)
 	 * plus one backup each for high invalidity chunks processing (if there's a backlog of chunks with extremely
 	 * small, even 0, validity then they can be processed by the compactors quickly and trigger a lot of updates
 	 * to free state at once) */
-	nv_cache->free_chunk_md_pool = ftl_mempool_create(2 * FTL_NV_CACHE_NUM_COMPACTORS,
+	nv_cache->free_chunk_md_pool = ftl_mempool_create(2 * dev->conf.nv_cache_compaction_concurrency,
 				       sizeof(struct ftl_nv_cache_chunk_md),
 				       FTL_BLOCK_SIZE,
 				       SPDK_ENV_SOCKET_ID_ANY);
@@ -754,9 +754,10 @@ compaction_process_read_entry_cb(struct spdk_bdev_io *bdev_io, bool success, voi
 	struct spdk_ftl_dev *dev = rq->dev;
 	struct ftl_nv_cache_compactor *compactor = rq->owner.priv;
 
-	ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_CMP, bdev_io);
-
-	spdk_bdev_free_io(bdev_io);
+	if (bdev_io != NULL) {
+		ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_CMP, bdev_io);
+		spdk_bdev_free_io(bdev_io);
+	}
 
 	if (!success) {
 		/* retry */
@@ -1008,19 +1009,25 @@ compaction_process(struct ftl_nv_cache *nv_cache)
 	struct spdk_ftl_dev *dev = SPDK_CONTAINEROF(nv_cache, struct spdk_ftl_dev, nv_cache);
 	struct ftl_nv_cache_compactor *compactor;
 
-	if (!is_compaction_required(nv_cache)) {
-		return;
-	}
+	/* Ramp all idle compactors up in one go, so the achieved compaction
+	 * concurrency reaches the configured level instead of growing by at
+	 * most one pipeline per poll. */
+	while (is_compaction_required(nv_cache)) {
+		compactor = TAILQ_FIRST(&nv_cache->compactor_list);
+		if (!compactor) {
+			break;
+		}
 
-	compactor = TAILQ_FIRST(&nv_cache->compactor_list);
-	if (!compactor) {
-		return;
-	}
+		TAILQ_REMOVE(&nv_cache->compactor_list, compactor, entry);
+		compactor->nv_cache->compaction_active_count++;
+		compaction_process_start(compactor);
+		ftl_add_io_activity(dev);
 
-	TAILQ_REMOVE(&nv_cache->compactor_list, compactor, entry);
-	compactor->nv_cache->compaction_active_count++;
-	compaction_process_start(compactor);
-	ftl_add_io_activity(dev);
+		if (0 == compactor->rq->iter.count) {
+			/* Nothing to read, the compactor went back idle */
+			break;
+		}
+	}
 }
 
 static void
@@ -1072,6 +1079,7 @@ compaction_process_finish_read(struct ftl_nv_cache_compactor *compactor)
 	struct ftl_rq_entry *entry;
 	ftl_addr current_addr;
 	uint64_t skip = 0;
+	uint64_t valid = 0, hot = 0;
 
 	FTL_RQ_ENTRY_LOOP(rq, entry, rq->iter.count) {
 		struct ftl_nv_cache_chunk *chunk = entry->owner.priv;
@@ -1088,6 +1096,12 @@ compaction_process_finish_read(struct ftl_nv_cache_compactor *compactor)
 		if (current_addr == entry->addr) {
 			entry->lba = md->nv_cache.lba;
 			entry->seq_id = chunk->md->seq_id;
+
+			valid++;
+			if (ftl_hotness_sketch_query(dev->hotness, entry->lba) >=
+			    FTL_HOTNESS_HOT_THRESHOLD) {
+				hot++;
+			}
 		} else {
 			/* This address already invalidated, just omit this block */
 			chunk_compaction_advance(chunk, 1);
@@ -1099,8 +1113,11 @@ compaction_process_finish_read(struct ftl_nv_cache_compactor *compactor)
 
 	if (skip < rq->iter.count) {
 		/*
-		 * Request contains data to be placed on FTL, compact it
+		 * Request contains data to be placed on FTL, compact it.
+		 * Route it to the hot or the cold open band based on how many of
+		 * the surviving blocks have been updated recently.
 		 */
+		rq->hot = 2 * hot >= valid;
 		ftl_writer_queue_rq(&dev->writer_user, rq);
 	} else {
 		compactor_deactivate(compactor);
@@ -1183,9 +1200,10 @@ ftl_nv_cache_submit_cb(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 {
 	struct ftl_io *io = cb_arg;
 
-	ftl_stats_bdev_io_completed(io->dev, FTL_STATS_TYPE_USER, bdev_io);
-
-	spdk_bdev_free_io(bdev_io);
+	if (bdev_io != NULL) {
+		ftl_stats_bdev_io_completed(io->dev, FTL_STATS_TYPE_USER, bdev_io);
+		spdk_bdev_free_io(bdev_io);
+	}
 
 	if (spdk_unlikely(!success)) {
 		FTL_ERRLOG(io->dev, "Non-volatile cache write failed at %"PRIx64"\n",
@@ -1205,10 +1223,10 @@ nv_cache_write(void *_io)
 	struct ftl_nv_cache *nv_cache = &dev->nv_cache;
 	int rc;
 
-	rc = spdk_bdev_writev_blocks_with_md(nv_cache->bdev_desc, nv_cache->cache_ioch,
-					     io->iov, io->iov_cnt, io->md,
-					     ftl_addr_to_nvc_offset(dev, io->addr), io->num_blocks,
-					     ftl_nv_cache_submit_cb, io);
+	rc = ftl_nv_cache_bdev_writev_blocks_with_md(dev, nv_cache->bdev_desc, nv_cache->cache_ioch,
+			io->iov, io->iov_cnt, io->md,
+			ftl_addr_to_nvc_offset(dev, io->addr), io->num_blocks,
+			ftl_nv_cache_submit_cb, io);
 	if (spdk_unlikely(rc)) {
 		if (rc == -ENOMEM) {
 			struct spdk_bdev *bdev = spdk_bdev_desc_get_bdev(nv_cache->bdev_desc);
@@ -1276,6 +1294,7 @@ ftl_nv_cache_write(struct ftl_io *io)
 		    &io->l2p_pin_ctx);
 
 	dev->nv_cache.throttle.blocks_submitted += io->num_blocks;
+	ftl_hotness_sketch_update(dev->hotness, io->lba, io->num_blocks);
 
 	return true;
 }
@@ -1765,14 +1784,16 @@ write_brq_end(struct spdk_bdev_io *bdev_io, bool success, void *arg)
 	struct ftl_basic_rq *brq = arg;
 	struct ftl_nv_cache_chunk *chunk = brq->io.chunk;
 
-	ftl_stats_bdev_io_completed(brq->dev, FTL_STATS_TYPE_MD_NV_CACHE, bdev_io);
+	if (bdev_io != NULL) {
+		ftl_stats_bdev_io_completed(brq->dev, FTL_STATS_TYPE_MD_NV_CACHE, bdev_io);
+		spdk_bdev_free_io(bdev_io);
+	}
 
 	brq->success = success;
 	if (spdk_likely(success)) {
 		chunk_advance_blocks(chunk->nv_cache, chunk, brq->num_blocks);
 	}
 
-	spdk_bdev_free_io(bdev_io);
 	brq->owner.cb(brq);
 }
 
@@ -1820,12 +1841,14 @@ read_brq_end(struct spdk_bdev_io *bdev_io, bool success, void *arg)
 {
 	struct ftl_basic_rq *brq = arg;
 
-	ftl_stats_bdev_io_completed(brq->dev, FTL_STATS_TYPE_MD_NV_CACHE, bdev_io);
+	if (bdev_io != NULL) {
+		ftl_stats_bdev_io_completed(brq->dev, FTL_STATS_TYPE_MD_NV_CACHE, bdev_io);
+		spdk_bdev_free_io(bdev_io);
+	}
 
 	brq->success = success;
 
 	brq->owner.cb(brq);
-	spdk_bdev_free_io(bdev_io);
 }
 
 static int
@@ -2053,14 +2076,15 @@ read_open_chunk_cb(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 	struct ftl_nv_cache *nv_cache = chunk->nv_cache;
 	struct spdk_ftl_dev *dev = SPDK_CONTAINEROF(chunk->nv_cache, struct spdk_ftl_dev, nv_cache);
 	union ftl_md_vss *md;
-	uint64_t cache_offset = bdev_io->u.bdev.offset_blocks;
-	uint64_t len = bdev_io->u.bdev.num_blocks;
+	uint64_t cache_offset = rq->io.addr;
+	uint64_t len = rq->iter.count;
 	ftl_addr addr = ftl_addr_from_nvc_offset(dev, cache_offset);
 	int rc;
 
-	ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_USER, bdev_io);
-
-	spdk_bdev_free_io(bdev_io);
+	if (bdev_io != NULL) {
+		ftl_stats_bdev_io_completed(dev, FTL_STATS_TYPE_USER, bdev_io);
+		spdk_bdev_free_io(bdev_io);
+	}
 
 	if (!success) {
 		parent->success = false;
@@ -2088,6 +2112,7 @@ read_open_chunk_cb(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 		len = spdk_min(dev->xfer_size, chunk->offset + chunk_tail_md_offset(nv_cache) - cache_offset);
 		rq->iter.idx = 0;
 		rq->iter.count = len;
+		rq->io.addr = cache_offset;
 
 		rc = ftl_nv_cache_bdev_read_blocks_with_md(dev, nv_cache->bdev_desc,
 				nv_cache->cache_ioch,
@@ -2135,11 +2160,12 @@ restore_open_chunk(struct ftl_nv_cache_chunk *chunk, struct ftl_basic_rq *parent
 
 	rq->owner.priv = parent;
 	rq->iter.idx = 0;
-	rq->iter.count = len;
 
 	addr = chunk->offset;
 
 	len = spdk_min(dev->xfer_size, chunk->offset + chunk_tail_md_offset(nv_cache) - addr);
+	rq->iter.count = len;
+	rq->io.addr = addr;
 
 	rc = ftl_nv_cache_bdev_read_blocks_with_md(dev, nv_cache->bdev_desc,
 			nv_cache->cache_ioch,
@@ -31,6 +31,9 @@
 
 #define FTL_NV_CACHE_NUM_COMPACTORS 8
 
+/* Upper bound for the configurable compaction concurrency */
+#define FTL_NV_CACHE_MAX_COMPACTORS 64
+
 /*
  * Parameters controlling nv cache write throttling.
  *
@@ -147,6 +150,9 @@ struct ftl_nv_cache {
 	/* Persistent cache IO channel */
 	struct spdk_io_channel *cache_ioch;
 
+	/* State of the dax NV cache device type, NULL otherwise */
+	struct ftl_nvc_dax *dax;
+
 	/* Metadata pool */
 	struct ftl_mempool *md_pool;
 
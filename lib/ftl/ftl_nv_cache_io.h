@@ -9,6 +9,7 @@
 
 #include "spdk/bdev.h"
 #include "ftl_core.h"
+#include "nvc/ftl_nvc_dev.h"
 
 static inline int
 ftl_nv_cache_bdev_read_blocks_with_md(struct spdk_ftl_dev *dev,
@@ -18,6 +19,14 @@ ftl_nv_cache_bdev_read_blocks_with_md(struct spdk_ftl_dev *dev,
 				      uint64_t offset_blocks, uint64_t num_blocks,
 				      spdk_bdev_io_completion_cb cb, void *cb_arg)
 {
+	const struct ftl_nv_cache_device_type *type = dev->nv_cache.nvc_type;
+
+	if (type && type->ops.read) {
+		return type->ops.read(dev, buf, md ? : g_ftl_read_buf,
+				      offset_blocks, num_blocks,
+				      cb, cb_arg);
+	}
+
 	return spdk_bdev_read_blocks_with_md(desc, ch, buf, md ? : g_ftl_read_buf,
 					     offset_blocks, num_blocks,
 					     cb, cb_arg);
@@ -31,9 +40,38 @@ ftl_nv_cache_bdev_write_blocks_with_md(struct spdk_ftl_dev *dev,
 				       uint64_t offset_blocks, uint64_t num_blocks,
 				       spdk_bdev_io_completion_cb cb, void *cb_arg)
 {
+	const struct ftl_nv_cache_device_type *type = dev->nv_cache.nvc_type;
+
+	if (type && type->ops.write) {
+		return type->ops.write(dev, buf, md ? : g_ftl_write_buf,
+				       offset_blocks, num_blocks,
+				       cb, cb_arg);
+	}
+
 	return spdk_bdev_write_blocks_with_md(desc, ch, buf, md ? : g_ftl_write_buf,
 					      offset_blocks, num_blocks,
 					      cb, cb_arg);
 }
 
+static inline int
+ftl_nv_cache_bdev_writev_blocks_with_md(struct spdk_ftl_dev *dev,
+					struct spdk_bdev_desc *desc,
+					struct spdk_io_channel *ch,
+					struct iovec *iov, int iovcnt, void *md,
+					uint64_t offset_blocks, uint64_t num_blocks,
+					spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	const struct ftl_nv_cache_device_type *type = dev->nv_cache.nvc_type;
+
+	if (type && type->ops.writev) {
+		return type->ops.writev(dev, iov, iovcnt, md ? : g_ftl_write_buf,
+					offset_blocks, num_blocks,
+					cb, cb_arg);
+	}
+
+	return spdk_bdev_writev_blocks_with_md(desc, ch, iov, iovcnt, md ? : g_ftl_write_buf,
+					       offset_blocks, num_blocks,
+					       cb, cb_arg);
+}
+
 #endif /* FTL_NV_CACHE_IO_H */
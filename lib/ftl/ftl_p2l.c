@@ -22,6 +22,15 @@ struct ftl_p2l_ckpt {
 	struct ftl_layout_region	*layout_region;
 	uint64_t			num_pages;
 	uint64_t			pages_per_xfer;
+	uint64_t			num_xfers;
+
+	/* Tracks xfers whose in-memory band P2L map diverged from the checkpoint
+	 * persisted at write time (i.e. entries invalidated by newer writes).
+	 * Clean shutdown needs to re-sync only these.
+	 */
+	uint64_t			dirty_bmp_sz;
+	void				*dirty_bmp_buf;
+	struct ftl_bitmap		*dirty_bmp;
 
 #if defined(DEBUG)
 	uint64_t			dbg_bmp_sz;
@@ -45,6 +54,7 @@ ftl_p2l_ckpt_new(struct spdk_ftl_dev *dev, int region_type)
 	ckpt->md = dev->layout.md[region_type];
 	ckpt->pages_per_xfer = dev->layout.p2l.pages_per_xfer;
 	ckpt->num_pages = dev->layout.p2l.ckpt_pages;
+	ckpt->num_xfers = ckpt->num_pages / ckpt->pages_per_xfer;
 	if (dev->nv_cache.md_size) {
 		ckpt->vss_md_page = ftl_md_vss_buf_alloc(region, region->num_entries);
 		if (!ckpt->vss_md_page) {
@@ -53,6 +63,21 @@ ftl_p2l_ckpt_new(struct spdk_ftl_dev *dev, int region_type)
 		}
 	}
 
+	ckpt->dirty_bmp_sz = ftl_bitmap_bits_to_size(ckpt->num_xfers);
+	ckpt->dirty_bmp_buf = calloc(1, ckpt->dirty_bmp_sz);
+	if (!ckpt->dirty_bmp_buf) {
+		spdk_dma_free(ckpt->vss_md_page);
+		free(ckpt);
+		return NULL;
+	}
+	ckpt->dirty_bmp = ftl_bitmap_create(ckpt->dirty_bmp_buf, ckpt->dirty_bmp_sz);
+	if (!ckpt->dirty_bmp) {
+		free(ckpt->dirty_bmp_buf);
+		spdk_dma_free(ckpt->vss_md_page);
+		free(ckpt);
+		return NULL;
+	}
+
 #if defined(DEBUG)
 	/* The bitmap size must be a multiple of word size (8b) - round up */
 	ckpt->dbg_bmp_sz = spdk_divide_round_up(ckpt->num_pages, 8);
@@ -73,6 +98,8 @@ ftl_p2l_ckpt_destroy(struct ftl_p2l_ckpt *ckpt)
 	ftl_bitmap_destroy(ckpt->bmp);
 	free(ckpt->dbg_bmp);
 #endif
+	ftl_bitmap_destroy(ckpt->dirty_bmp);
+	free(ckpt->dirty_bmp_buf);
 	spdk_dma_free(ckpt->vss_md_page);
 	free(ckpt);
 }
@@ -132,10 +159,26 @@ ftl_p2l_ckpt_release(struct spdk_ftl_dev *dev, struct ftl_p2l_ckpt *ckpt)
 #if defined(DEBUG)
 	memset(ckpt->dbg_bmp, 0, ckpt->dbg_bmp_sz);
 #endif
+	memset(ckpt->dirty_bmp_buf, 0, ckpt->dirty_bmp_sz);
 	TAILQ_REMOVE(&dev->p2l_ckpt.inuse, ckpt, link);
 	TAILQ_INSERT_TAIL(&dev->p2l_ckpt.free, ckpt, link);
 }
 
+void
+ftl_p2l_ckpt_invalidate(struct ftl_band *band, ftl_addr addr)
+{
+	struct ftl_p2l_ckpt *ckpt = band->p2l_map.p2l_ckpt;
+	uint64_t xfer;
+
+	if (!ckpt) {
+		return;
+	}
+
+	xfer = ftl_band_block_offset_from_addr(band, addr) / band->dev->xfer_size;
+	assert(xfer < ckpt->num_xfers);
+	ftl_bitmap_set(ckpt->dirty_bmp, xfer);
+}
+
 static void
 ftl_p2l_ckpt_issue_end(int status, void *arg)
 {
@@ -276,6 +319,21 @@ ftl_get_band_from_region(struct spdk_ftl_dev *dev, enum ftl_layout_region_type t
 
 static void ftl_mngt_persist_band_p2l(struct ftl_mngt_process *mngt, struct ftl_p2l_sync_ctx *ctx);
 
+static uint64_t
+ftl_p2l_ckpt_next_dirty_xfer(struct ftl_p2l_ckpt *ckpt, uint64_t xfer_start, uint64_t xfer_end)
+{
+	uint64_t xfer;
+
+	assert(xfer_start < xfer_end);
+
+	xfer = ftl_bitmap_find_first_set(ckpt->dirty_bmp, xfer_start, xfer_end - 1);
+	if (xfer == UINT64_MAX) {
+		return xfer_end;
+	}
+
+	return xfer;
+}
+
 static void
 ftl_p2l_ckpt_persist_end(int status, void *arg)
 {
@@ -313,6 +371,18 @@ ftl_mngt_persist_band_p2l(struct ftl_mngt_process *mngt, struct ftl_p2l_sync_ctx
 
 	ckpt = band->p2l_map.p2l_ckpt;
 
+	/* Checkpoint pages were already persisted when the corresponding xfers were
+	 * written - only xfers whose entries have been invalidated since then need
+	 * to be re-synced
+	 */
+	ctx->xfer_start = ftl_p2l_ckpt_next_dirty_xfer(ckpt, ctx->xfer_start, ctx->xfer_end);
+	if (ctx->xfer_start == ctx->xfer_end) {
+		ctx->md_region++;
+		ftl_mngt_continue_step(mngt);
+		return;
+	}
+	ftl_bitmap_clear(ckpt->dirty_bmp, ctx->xfer_start);
+
 	map_page = ftl_md_get_buffer(ckpt->md);
 	assert(map_page);
 
@@ -48,8 +48,9 @@ struct ftl_reloc {
 	/* Indicates relocate is about to halt */
 	bool halt;
 
-	/* Band which are read to relocate */
-	struct ftl_band *band;
+	/* Bands currently being read to relocate */
+	TAILQ_HEAD(, ftl_band) band_read;
+	size_t band_read_count;
 
 	/* Bands already read, but waiting for finishing GC */
 	TAILQ_HEAD(, ftl_band) band_done;
@@ -67,6 +68,8 @@ struct ftl_reloc {
 	/* Array of movers queue for each state */
 	TAILQ_HEAD(, ftl_reloc_move) move_queue[FTL_RELOC_STATE_MAX];
 
+	/* Number of movers in each state's queue */
+	size_t move_count[FTL_RELOC_STATE_MAX];
 };
 
 static void move_read_cb(struct ftl_rq *rq);
@@ -88,6 +91,7 @@ move_init(struct ftl_reloc *reloc, struct ftl_reloc_move *mv)
 {
 	mv->state = FTL_RELOC_STATE_HALT;
 	TAILQ_INSERT_TAIL(&reloc->move_queue[FTL_RELOC_STATE_HALT], mv, qentry);
+	reloc->move_count[FTL_RELOC_STATE_HALT]++;
 
 	mv->reloc = reloc;
 	mv->dev = reloc->dev;
@@ -137,6 +141,7 @@ ftl_reloc_init(struct spdk_ftl_dev *dev)
 		}
 	}
 
+	TAILQ_INIT(&reloc->band_read);
 	TAILQ_INIT(&reloc->band_done);
 
 	return reloc;
@@ -231,20 +236,67 @@ move_set_state(struct ftl_reloc_move *mv, enum ftl_reloc_move_state state)
 	if (mv->state != state) {
 		/* Remove the mover from previous queue */
 		TAILQ_REMOVE(&reloc->move_queue[mv->state], mv, qentry);
+		assert(reloc->move_count[mv->state] > 0);
+		reloc->move_count[mv->state]--;
 		/* Insert the mover to the new queue */
 		TAILQ_INSERT_TAIL(&reloc->move_queue[state], mv, qentry);
+		reloc->move_count[state]++;
 		/* Update state */
 		mv->state = state;
 	}
 }
 
+/*
+ * Reclaim bandwidth follows the free-band watermark: as the device drops
+ * towards the critical limit more movers are allowed to run in parallel,
+ * while under no pressure a single mover trickles along to keep relocation
+ * out of the way of user reads.
+ */
+static size_t
+reloc_mover_budget(struct ftl_reloc *reloc)
+{
+	switch (reloc->dev->limit) {
+	case SPDK_FTL_LIMIT_CRIT:
+		return reloc->max_qdepth;
+	case SPDK_FTL_LIMIT_HIGH:
+		return spdk_max(3 * reloc->max_qdepth / 4, 1UL);
+	case SPDK_FTL_LIMIT_LOW:
+		return spdk_max(reloc->max_qdepth / 2, 1UL);
+	default:
+		return 1;
+	}
+}
+
+static size_t
+reloc_band_budget(struct ftl_reloc *reloc)
+{
+	switch (reloc->dev->limit) {
+	case SPDK_FTL_LIMIT_CRIT:
+	case SPDK_FTL_LIMIT_HIGH:
+		return 3;
+	case SPDK_FTL_LIMIT_LOW:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
+static size_t
+reloc_busy_moves(struct ftl_reloc *reloc)
+{
+	return reloc->move_count[FTL_RELOC_STATE_PIN] +
+	       reloc->move_count[FTL_RELOC_STATE_WRITE] +
+	       reloc->move_count[FTL_RELOC_STATE_WAIT];
+}
+
 static void
 move_get_band_cb(struct ftl_band *band, void *cntx, bool status)
 {
 	struct ftl_reloc *reloc = cntx;
 
 	if (spdk_likely(status)) {
-		reloc->band = band;
+		TAILQ_INSERT_TAIL(&reloc->band_read, band, queue_entry);
+		reloc->band_read_count++;
 		ftl_band_iter_init(band);
 	}
 	reloc->band_waiting = false;
@@ -259,6 +311,10 @@ move_grab_new_band(struct ftl_reloc *reloc)
 		}
 
 		/* Limit number of simultaneously relocated bands */
+		if (reloc->band_read_count >= reloc_band_budget(reloc)) {
+			return;
+		}
+
 		if (reloc->band_done_count > 2) {
 			return;
 		}
@@ -271,21 +327,22 @@ move_grab_new_band(struct ftl_reloc *reloc)
 static struct ftl_band *
 move_get_band(struct ftl_reloc *reloc)
 {
-	struct ftl_band *band = reloc->band;
+	struct ftl_band *band, *next;
 
-	if (!band) {
-		move_grab_new_band(reloc);
-		return NULL;
-	}
+	/* Grab ahead so movers don't go idle waiting for the next band */
+	move_grab_new_band(reloc);
 
-	if (!ftl_band_filled(band, band->md->iter.offset)) {
-		/* Band still not read, we can continue reading */
-		return band;
-	}
+	TAILQ_FOREACH_SAFE(band, &reloc->band_read, queue_entry, next) {
+		if (!ftl_band_filled(band, band->md->iter.offset)) {
+			/* Band still not read, we can continue reading */
+			return band;
+		}
 
-	TAILQ_INSERT_TAIL(&reloc->band_done, band, queue_entry);
-	reloc->band_done_count++;
-	reloc->band = NULL;
+		TAILQ_REMOVE(&reloc->band_read, band, queue_entry);
+		reloc->band_read_count--;
+		TAILQ_INSERT_TAIL(&reloc->band_done, band, queue_entry);
+		reloc->band_done_count++;
+	}
 
 	return NULL;
 }
@@ -568,6 +625,14 @@ move_run(struct ftl_reloc *reloc, struct ftl_reloc_move *mv)
 			break;
 		}
 
+		/* Start a new move cycle only while reclaim concurrency is below
+		 * the level warranted by the current free-band pressure
+		 */
+		if (0 == mv->rq->iter.idx && 0 == mv->rq->iter.qd &&
+		    reloc_busy_moves(reloc) >= reloc_mover_budget(reloc)) {
+			break;
+		}
+
 		band = move_get_band(reloc);
 		if (!band) {
 			break;
@@ -667,15 +732,27 @@ ftl_reloc_is_halted(const struct ftl_reloc *reloc)
 void
 ftl_reloc(struct ftl_reloc *reloc)
 {
-	size_t i, count;
+	struct ftl_reloc_move *mv;
+	size_t i, n, count, budget;
 
+	budget = reloc_mover_budget(reloc);
 	count = SPDK_COUNTOF(reloc->move_queue);
 	for (i = 0; i < count; ++i) {
-		if (TAILQ_EMPTY(&reloc->move_queue[i])) {
-			continue;
+		for (n = 0; n < budget; ++n) {
+			mv = TAILQ_FIRST(&reloc->move_queue[i]);
+			if (!mv) {
+				break;
+			}
+
+			move_run(reloc, mv);
+
+			if (TAILQ_FIRST(&reloc->move_queue[i]) == mv) {
+				/* The mover stayed put, no more progress to be
+				 * made on this queue in this poll
+				 */
+				break;
+			}
 		}
-
-		move_run(reloc, TAILQ_FIRST(&reloc->move_queue[i]));
 	}
 
 	move_release_bands(reloc);
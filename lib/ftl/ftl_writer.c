@@ -22,13 +22,13 @@ ftl_writer_init(struct spdk_ftl_dev *dev, struct ftl_writer *writer,
 }
 
 static bool
-can_write(struct ftl_writer *writer)
+can_write(struct ftl_writer *writer, struct ftl_band *band)
 {
 	if (spdk_unlikely(writer->halt)) {
 		return false;
 	}
 
-	return writer->band->md->state == FTL_BAND_STATE_OPEN;
+	return band->md->state == FTL_BAND_STATE_OPEN;
 }
 
 void
@@ -38,9 +38,13 @@ ftl_writer_band_state_change(struct ftl_band *band)
 
 	switch (band->md->state) {
 	case FTL_BAND_STATE_FULL:
-		assert(writer->band == band);
+		assert(writer->band == band || writer->hot_band == band);
 		TAILQ_INSERT_TAIL(&writer->full_bands, band, queue_entry);
-		writer->band = NULL;
+		if (writer->band == band) {
+			writer->band = NULL;
+		} else {
+			writer->hot_band = NULL;
+		}
 		break;
 
 	case FTL_BAND_STATE_CLOSED:
@@ -81,19 +85,21 @@ is_active(struct ftl_writer *writer)
 }
 
 static struct ftl_band *
-get_band(struct ftl_writer *writer)
+get_band(struct ftl_writer *writer, bool hot)
 {
-	if (spdk_unlikely(!writer->band)) {
+	struct ftl_band **slot = hot ? &writer->hot_band : &writer->band;
+
+	if (spdk_unlikely(!*slot)) {
 		if (!is_active(writer)) {
 			return NULL;
 		}
 
 		if (spdk_unlikely(NULL != writer->next_band)) {
 			if (FTL_BAND_STATE_OPEN == writer->next_band->md->state) {
-				writer->band = writer->next_band;
+				*slot = writer->next_band;
 				writer->next_band = NULL;
 
-				return writer->band;
+				return *slot;
 			} else {
 				assert(FTL_BAND_STATE_OPEN == writer->next_band->md->state);
 				ftl_abort();
@@ -107,13 +113,13 @@ get_band(struct ftl_writer *writer)
 			return NULL;
 		}
 
-		writer->band = ftl_band_get_next_free(writer->dev);
-		if (writer->band) {
+		*slot = ftl_band_get_next_free(writer->dev);
+		if (*slot) {
 			writer->num_bands++;
-			ftl_band_set_owner(writer->band,
+			ftl_band_set_owner(*slot,
 					   ftl_writer_band_state_change, writer);
 
-			if (ftl_band_write_prep(writer->band)) {
+			if (ftl_band_write_prep(*slot)) {
 				/*
 				 * This error might happen due to allocation failure. However number
 				 * of open bands is controlled and it should have enough resources
@@ -127,11 +133,11 @@ get_band(struct ftl_writer *writer)
 		}
 	}
 
-	if (spdk_likely(writer->band->md->state == FTL_BAND_STATE_OPEN)) {
-		return writer->band;
+	if (spdk_likely((*slot)->md->state == FTL_BAND_STATE_OPEN)) {
+		return *slot;
 	} else {
-		if (spdk_unlikely(writer->band->md->state == FTL_BAND_STATE_PREP)) {
-			ftl_band_open(writer->band, writer->writer_type);
+		if (spdk_unlikely((*slot)->md->state == FTL_BAND_STATE_PREP)) {
+			ftl_band_open(*slot, writer->writer_type);
 		}
 		return NULL;
 	}
@@ -146,19 +152,20 @@ ftl_writer_run(struct ftl_writer *writer)
 	close_full_bands(writer);
 
 	if (!TAILQ_EMPTY(&writer->rq_queue)) {
-		band = get_band(writer);
+		rq = TAILQ_FIRST(&writer->rq_queue);
+
+		band = get_band(writer, rq->hot);
 		if (spdk_unlikely(!band)) {
 			return;
 		}
 
-		if (!can_write(writer)) {
+		if (!can_write(writer, band)) {
 			return;
 		}
 
 		/* Finally we can write to band */
-		rq = TAILQ_FIRST(&writer->rq_queue);
 		TAILQ_REMOVE(&writer->rq_queue, rq, qentry);
-		ftl_band_rq_write(writer->band, rq);
+		ftl_band_rq_write(band, rq);
 	}
 }
 
@@ -170,13 +177,13 @@ ftl_writer_pad_band_cb(struct ftl_rq *rq)
 }
 
 static void
-ftl_writer_pad_band(struct ftl_writer *writer)
+ftl_writer_pad_band(struct ftl_writer *writer, struct ftl_band *band)
 {
 	struct spdk_ftl_dev *dev = writer->dev;
 
 	assert(dev->conf.prep_upgrade_on_shutdown);
-	assert(writer->band);
-	assert(0 == writer->band->queue_depth);
+	assert(band);
+	assert(0 == band->queue_depth);
 
 	/* First allocate the padding FTL request */
 	if (!writer->pad) {
@@ -189,12 +196,12 @@ ftl_writer_pad_band(struct ftl_writer *writer)
 	}
 
 	if (writer->pad->iter.qd) {
-		/* The band is handling the pad request already */
+		/* A band is handling the pad request already */
 		return;
 	}
 
-	if (writer->band->md->state == FTL_BAND_STATE_OPEN) {
-		ftl_band_rq_write(writer->band, writer->pad);
+	if (band->md->state == FTL_BAND_STATE_OPEN) {
+		ftl_band_rq_write(band, writer->pad);
 		writer->pad->iter.qd++;
 	}
 }
@@ -216,9 +223,21 @@ ftl_writer_is_halted(struct ftl_writer *writer)
 		}
 	}
 
+	if (writer->hot_band) {
+		if (writer->hot_band->md->state != FTL_BAND_STATE_OPEN) {
+			return false;
+		}
+
+		if (writer->hot_band->queue_depth) {
+			return false;
+		}
+	}
+
 	if (writer->dev->conf.prep_upgrade_on_shutdown) {
 		if (writer->band) {
-			ftl_writer_pad_band(writer);
+			ftl_writer_pad_band(writer, writer->band);
+		} else if (writer->hot_band) {
+			ftl_writer_pad_band(writer, writer->hot_band);
 		} else if (writer->num_bands) {
 			return false;
 		} else {
@@ -241,6 +260,11 @@ ftl_writer_get_free_blocks(struct ftl_writer *writer)
 				writer->band->md->iter.offset);
 	}
 
+	if (writer->hot_band) {
+		free_blocks += ftl_band_user_blocks_left(writer->hot_band,
+				writer->hot_band->md->iter.offset);
+	}
+
 	if (writer->next_band) {
 		free_blocks += ftl_band_user_blocks_left(writer->next_band,
 				writer->next_band->md->iter.offset);
@@ -19,6 +19,12 @@ struct ftl_writer {
 	/* Band currently being written to */
 	struct ftl_band	*band;
 
+	/* Band currently being written to with hot data. Keeping recently
+	 * updated data away from cold data leaves bands uniformly short- or
+	 * long-lived, which lowers GC write amplification. Used only by the
+	 * user writer - GC requests always go to the regular band. */
+	struct ftl_band *hot_band;
+
 	/* Number of bands associated with writer */
 	uint64_t num_bands;
 
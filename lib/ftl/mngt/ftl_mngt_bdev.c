@@ -221,6 +221,11 @@ ftl_mngt_open_cache_bdev(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt
 	}
 	nv_cache->md_size = sizeof(union ftl_md_vss);
 
+	if (nv_cache->nvc_type->ops.init && nv_cache->nvc_type->ops.init(dev)) {
+		FTL_ERRLOG(dev, "Failed to initialize NV Cache device type\n");
+		goto error;
+	}
+
 	md_ops = &nv_cache->nvc_type->ops.md_layout_ops;
 	if (!md_ops->region_create) {
 		FTL_ERRLOG(dev, "NV Cache device doesn't implement md_layout_ops\n");
@@ -243,6 +248,10 @@ error:
 void
 ftl_mngt_close_cache_bdev(struct spdk_ftl_dev *dev, struct ftl_mngt_process *mngt)
 {
+	if (dev->nv_cache.nvc_type && dev->nv_cache.nvc_type->ops.deinit) {
+		dev->nv_cache.nvc_type->ops.deinit(dev);
+	}
+
 	if (dev->nv_cache.cache_ioch) {
 		spdk_put_io_channel(dev->nv_cache.cache_ioch);
 		dev->nv_cache.cache_ioch = NULL;
@@ -0,0 +1,391 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#include <libpmem.h>
+
+#include "ftl_nvc_dev.h"
+#include "ftl_core.h"
+#include "ftl_layout.h"
+#include "ftl_nv_cache.h"
+#include "utils/ftl_layout_tracker_bdev.h"
+
+/* Number of preallocated completion contexts. The pool covers the expected
+ * IO depth on the cache device; the heap is used in the unlikely case it
+ * runs dry, so that submission never fails with ENOMEM (the caller would
+ * wait for a bdev which never gets any IO).
+ */
+#define FTL_NVC_DAX_IO_POOL_SIZE 1024
+
+struct ftl_nvc_dax_io {
+	spdk_bdev_io_completion_cb cb;
+	void *cb_arg;
+	bool from_heap;
+	TAILQ_ENTRY(ftl_nvc_dax_io) entry;
+};
+
+/* State of the dax NV cache device type.
+ *
+ * The cache bdev is opened and claimed as usual and defines the size and
+ * layout of the cache, but all cache IO is served by memcpy to/from a
+ * direct-access mapping of the cache device's storage, bypassing the bdev
+ * stack. The mapping emulates the variable sector size of NVMe cache
+ * devices - block data occupies the beginning of the mapping, per-block
+ * metadata is placed in a separate area behind it.
+ *
+ * Completions are collected on a list and fired from a poller on the core
+ * thread, preserving the asynchronous completion contract of the bdev
+ * based IO paths.
+ */
+struct ftl_nvc_dax {
+	struct spdk_ftl_dev *dev;
+
+	/* Direct-access mapping of the cache device's storage */
+	void *map;
+
+	/* Size of the mapping in bytes */
+	size_t map_size;
+
+	/* Start of the per-block metadata area within the mapping */
+	char *md_base;
+
+	/* Number of cache blocks backed by the mapping */
+	uint64_t num_blocks;
+
+	/* True if the mapping resides on persistent memory and can be
+	 * flushed with pmem_persist rather than msync */
+	int is_pmem;
+
+	/* Pool of completion contexts */
+	struct ftl_mempool *io_pool;
+
+	/* Completed IOs waiting for the completion poller */
+	TAILQ_HEAD(, ftl_nvc_dax_io) pending_ios;
+
+	struct spdk_poller *completion_poller;
+};
+
+static int
+dax_completion_poller_cb(void *ctx)
+{
+	struct ftl_nvc_dax *dax = ctx;
+	struct ftl_nvc_dax_io *io;
+	int count = 0;
+
+	while ((io = TAILQ_FIRST(&dax->pending_ios))) {
+		TAILQ_REMOVE(&dax->pending_ios, io, entry);
+
+		/* There is no bdev_io on this path, the callbacks accept NULL */
+		io->cb(NULL, true, io->cb_arg);
+
+		if (spdk_unlikely(io->from_heap)) {
+			free(io);
+		} else {
+			ftl_mempool_put(dax->io_pool, io);
+		}
+		count++;
+	}
+
+	return count > 0 ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
+}
+
+static int
+dax_io_complete(struct ftl_nvc_dax *dax, spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	struct ftl_nvc_dax_io *io;
+
+	io = ftl_mempool_get(dax->io_pool);
+	if (spdk_unlikely(!io)) {
+		io = calloc(1, sizeof(*io));
+		if (!io) {
+			return -ENOMEM;
+		}
+		io->from_heap = true;
+	} else {
+		io->from_heap = false;
+	}
+
+	io->cb = cb;
+	io->cb_arg = cb_arg;
+	TAILQ_INSERT_TAIL(&dax->pending_ios, io, entry);
+
+	return 0;
+}
+
+static inline void *
+dax_data_addr(struct ftl_nvc_dax *dax, uint64_t offset_blocks)
+{
+	return (char *)dax->map + offset_blocks * FTL_BLOCK_SIZE;
+}
+
+static inline void *
+dax_md_addr(struct ftl_nvc_dax *dax, uint64_t offset_blocks)
+{
+	return dax->md_base + offset_blocks * dax->dev->nv_cache.md_size;
+}
+
+static void
+dax_memcpy_persist(struct ftl_nvc_dax *dax, void *dst, const void *src, size_t len)
+{
+	if (dax->is_pmem) {
+		pmem_memcpy_persist(dst, src, len);
+	} else {
+		memcpy(dst, src, len);
+		pmem_msync(dst, len);
+	}
+}
+
+static int
+dax_read(struct spdk_ftl_dev *dev, void *buf, void *md_buf,
+	 uint64_t offset_blocks, uint64_t num_blocks,
+	 spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	struct ftl_nvc_dax *dax = dev->nv_cache.dax;
+
+	assert(offset_blocks + num_blocks <= dax->num_blocks);
+
+	memcpy(buf, dax_data_addr(dax, offset_blocks), num_blocks * FTL_BLOCK_SIZE);
+	memcpy(md_buf, dax_md_addr(dax, offset_blocks), num_blocks * dev->nv_cache.md_size);
+
+	return dax_io_complete(dax, cb, cb_arg);
+}
+
+static int
+dax_write(struct spdk_ftl_dev *dev, void *buf, void *md_buf,
+	  uint64_t offset_blocks, uint64_t num_blocks,
+	  spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	struct ftl_nvc_dax *dax = dev->nv_cache.dax;
+
+	assert(offset_blocks + num_blocks <= dax->num_blocks);
+
+	dax_memcpy_persist(dax, dax_data_addr(dax, offset_blocks), buf,
+			   num_blocks * FTL_BLOCK_SIZE);
+	dax_memcpy_persist(dax, dax_md_addr(dax, offset_blocks), md_buf,
+			   num_blocks * dev->nv_cache.md_size);
+
+	return dax_io_complete(dax, cb, cb_arg);
+}
+
+static int
+dax_writev(struct spdk_ftl_dev *dev, struct iovec *iov, int iovcnt, void *md_buf,
+	   uint64_t offset_blocks, uint64_t num_blocks,
+	   spdk_bdev_io_completion_cb cb, void *cb_arg)
+{
+	struct ftl_nvc_dax *dax = dev->nv_cache.dax;
+	char *dst = dax_data_addr(dax, offset_blocks);
+	int i;
+
+	assert(offset_blocks + num_blocks <= dax->num_blocks);
+
+	for (i = 0; i < iovcnt; i++) {
+		dax_memcpy_persist(dax, dst, iov[i].iov_base, iov[i].iov_len);
+		dst += iov[i].iov_len;
+	}
+	assert(dst == (char *)dax_data_addr(dax, offset_blocks + num_blocks));
+
+	dax_memcpy_persist(dax, dax_md_addr(dax, offset_blocks), md_buf,
+			   num_blocks * dev->nv_cache.md_size);
+
+	return dax_io_complete(dax, cb, cb_arg);
+}
+
+static void
+dax_deinit(struct spdk_ftl_dev *dev)
+{
+	struct ftl_nvc_dax *dax = dev->nv_cache.dax;
+
+	if (!dax) {
+		return;
+	}
+
+	assert(TAILQ_EMPTY(&dax->pending_ios));
+	spdk_poller_unregister(&dax->completion_poller);
+	ftl_mempool_destroy(dax->io_pool);
+	if (dax->map) {
+		pmem_unmap(dax->map, dax->map_size);
+	}
+	free(dax);
+	dev->nv_cache.dax = NULL;
+}
+
+static int
+dax_init(struct spdk_ftl_dev *dev)
+{
+	struct spdk_bdev *bdev = spdk_bdev_desc_get_bdev(dev->nv_cache.bdev_desc);
+	struct ftl_nvc_dax *dax;
+	size_t required_size;
+
+	dax = calloc(1, sizeof(*dax));
+	if (!dax) {
+		FTL_ERRLOG(dev, "Failed to allocate dax NV cache state\n");
+		return -ENOMEM;
+	}
+	dax->dev = dev;
+	TAILQ_INIT(&dax->pending_ios);
+	dev->nv_cache.dax = dax;
+
+	dax->num_blocks = spdk_bdev_get_num_blocks(bdev);
+
+	dax->map = pmem_map_file(dev->conf.cache_dax_path, 0, 0, 0,
+				 &dax->map_size, &dax->is_pmem);
+	if (!dax->map) {
+		FTL_ERRLOG(dev, "Could not map %s: %s\n", dev->conf.cache_dax_path,
+			   strerror(errno));
+		goto error;
+	}
+
+	required_size = dax->num_blocks * (FTL_BLOCK_SIZE + dev->nv_cache.md_size);
+	if (dax->map_size < required_size) {
+		FTL_ERRLOG(dev, "Mapping of %s too small, %zu bytes, requires %zu bytes\n",
+			   dev->conf.cache_dax_path, dax->map_size, required_size);
+		goto error;
+	}
+	dax->md_base = (char *)dax->map + dax->num_blocks * FTL_BLOCK_SIZE;
+
+	dax->io_pool = ftl_mempool_create(FTL_NVC_DAX_IO_POOL_SIZE,
+					  sizeof(struct ftl_nvc_dax_io),
+					  64, SPDK_ENV_SOCKET_ID_ANY);
+	if (!dax->io_pool) {
+		FTL_ERRLOG(dev, "Failed to create dax NV cache IO pool\n");
+		goto error;
+	}
+
+	dax->completion_poller = SPDK_POLLER_REGISTER(dax_completion_poller_cb, dax, 0);
+	if (!dax->completion_poller) {
+		FTL_ERRLOG(dev, "Failed to register dax NV cache completion poller\n");
+		goto error;
+	}
+
+	FTL_NOTICELOG(dev, "Using %s mapping of %s as NV Cache storage\n",
+		      dax->is_pmem ? "pmem" : "page cache", dev->conf.cache_dax_path);
+	return 0;
+error:
+	dax_deinit(dev);
+	return -1;
+}
+
+static bool
+is_bdev_compatible(struct spdk_ftl_dev *dev, struct spdk_bdev *bdev)
+{
+	if (!dev->conf.cache_dax_path) {
+		return false;
+	}
+
+	if (spdk_bdev_is_md_separate(bdev)) {
+		/* Bdevs with their own metadata are handled by the bdev device type */
+		return false;
+	}
+
+	if (ftl_md_xfer_blocks(dev) * sizeof(union ftl_md_vss) > FTL_ZERO_BUFFER_SIZE) {
+		FTL_ERRLOG(dev, "Zero buffer too small for bdev %s metadata transfer\n",
+			   spdk_bdev_get_name(bdev));
+		return false;
+	}
+
+	return true;
+}
+
+static bool
+is_chunk_active(struct spdk_ftl_dev *dev, uint64_t chunk_offset)
+{
+	const struct ftl_layout_tracker_bdev_region_props *reg_free = ftl_layout_tracker_bdev_insert_region(
+				dev->nvc_layout_tracker, FTL_LAYOUT_REGION_TYPE_INVALID, 0, chunk_offset,
+				dev->layout.nvc.chunk_data_blocks);
+
+	assert(!reg_free || reg_free->type == FTL_LAYOUT_REGION_TYPE_FREE);
+	return reg_free != NULL;
+}
+
+static void
+md_region_setup(struct spdk_ftl_dev *dev, enum ftl_layout_region_type reg_type,
+		struct ftl_layout_region *region)
+{
+	assert(region);
+	region->type = reg_type;
+	region->mirror_type = FTL_LAYOUT_REGION_TYPE_INVALID;
+	region->name = ftl_md_region_name(reg_type);
+
+	region->bdev_desc = dev->nv_cache.bdev_desc;
+	region->ioch = dev->nv_cache.cache_ioch;
+	region->vss_blksz = dev->nv_cache.md_size;
+}
+
+static int
+md_region_create(struct spdk_ftl_dev *dev, enum ftl_layout_region_type reg_type,
+		 uint32_t reg_version, size_t reg_blks)
+{
+	const struct ftl_layout_tracker_bdev_region_props *reg_props;
+
+	assert(reg_type < FTL_LAYOUT_REGION_TYPE_MAX);
+	reg_blks = ftl_md_region_align_blocks(dev, reg_blks);
+
+	reg_props = ftl_layout_tracker_bdev_add_region(dev->nvc_layout_tracker, reg_type, reg_version,
+			reg_blks, 0);
+	if (!reg_props) {
+		return -1;
+	}
+	assert(reg_props->type == reg_type);
+	assert(reg_props->ver == reg_version);
+	assert(reg_props->blk_sz == reg_blks);
+	assert(reg_props->blk_offs + reg_blks <= dev->layout.nvc.total_blocks);
+	return 0;
+}
+
+static int
+md_region_open(struct spdk_ftl_dev *dev, enum ftl_layout_region_type reg_type, uint32_t reg_version,
+	       size_t entry_size, size_t entry_count, struct ftl_layout_region *region)
+{
+	const struct ftl_layout_tracker_bdev_region_props *reg_search_ctx = NULL;
+	uint64_t reg_blks = ftl_md_region_blocks(dev, entry_size * entry_count);
+
+	assert(reg_type < FTL_LAYOUT_REGION_TYPE_MAX);
+
+	while (true) {
+		ftl_layout_tracker_bdev_find_next_region(dev->nvc_layout_tracker, reg_type, &reg_search_ctx);
+		if (!reg_search_ctx || reg_search_ctx->ver == reg_version) {
+			break;
+		}
+	}
+
+	if (!reg_search_ctx || reg_search_ctx->blk_sz < reg_blks) {
+		/* Region not found or insufficient space */
+		return -1;
+	}
+
+	if (!region) {
+		return 0;
+	}
+
+	md_region_setup(dev, reg_type, region);
+
+	region->entry_size = entry_size / FTL_BLOCK_SIZE;
+	region->num_entries = entry_count;
+
+	region->current.version = reg_version;
+	region->current.offset = reg_search_ctx->blk_offs;
+	region->current.blocks = reg_search_ctx->blk_sz;
+
+	return 0;
+}
+
+struct ftl_nv_cache_device_type nvc_dax = {
+	.name = "dax",
+	.features = {
+	},
+	.ops = {
+		.is_bdev_compatible = is_bdev_compatible,
+		.is_chunk_active = is_chunk_active,
+		.init = dax_init,
+		.deinit = dax_deinit,
+		.read = dax_read,
+		.write = dax_write,
+		.writev = dax_writev,
+		.md_layout_ops = {
+			.region_create = md_region_create,
+			.region_open = md_region_open,
+		},
+	}
+};
+FTL_NV_CACHE_DEVICE_TYPE_REGISTER(nvc_dax)
@@ -48,6 +48,87 @@ struct ftl_nv_cache_device_ops {
 	 */
 	bool (*is_chunk_active)(struct spdk_ftl_dev *dev, uint64_t chunk_offset);
 
+	/**
+	 * @brief Initialize NV Cache device type state for the FTL device
+	 *
+	 * Called after the device type has been selected for the cache bdev.
+	 * Optional.
+	 *
+	 * @param dev FTL device
+	 *
+	 * @return Operation result
+	 */
+	int (*init)(struct spdk_ftl_dev *dev);
+
+	/**
+	 * @brief Release NV Cache device type state of the FTL device
+	 *
+	 * Optional.
+	 *
+	 * @param dev FTL device
+	 */
+	void (*deinit)(struct spdk_ftl_dev *dev);
+
+	/**
+	 * @brief Read blocks from the NV Cache device
+	 *
+	 * Optional. When implemented, all cache reads are directed here instead
+	 * of the cache bdev. The operation may complete inline, in which case
+	 * the completion callback is invoked with a NULL bdev_io.
+	 *
+	 * @param dev FTL device
+	 * @param buf data buffer
+	 * @param md_buf metadata buffer
+	 * @param offset_blocks offset on the cache device
+	 * @param num_blocks number of blocks to read
+	 * @param cb completion callback, bdev_io may be NULL
+	 * @param cb_arg completion callback argument
+	 *
+	 * @return Operation result
+	 */
+	int (*read)(struct spdk_ftl_dev *dev, void *buf, void *md_buf,
+		    uint64_t offset_blocks, uint64_t num_blocks,
+		    spdk_bdev_io_completion_cb cb, void *cb_arg);
+
+	/**
+	 * @brief Write blocks to the NV Cache device
+	 *
+	 * Optional, see read above.
+	 *
+	 * @param dev FTL device
+	 * @param buf data buffer
+	 * @param md_buf metadata buffer
+	 * @param offset_blocks offset on the cache device
+	 * @param num_blocks number of blocks to write
+	 * @param cb completion callback, bdev_io may be NULL
+	 * @param cb_arg completion callback argument
+	 *
+	 * @return Operation result
+	 */
+	int (*write)(struct spdk_ftl_dev *dev, void *buf, void *md_buf,
+		     uint64_t offset_blocks, uint64_t num_blocks,
+		     spdk_bdev_io_completion_cb cb, void *cb_arg);
+
+	/**
+	 * @brief Write a vectored buffer to the NV Cache device
+	 *
+	 * Optional, see read above.
+	 *
+	 * @param dev FTL device
+	 * @param iov data buffer vector
+	 * @param iovcnt number of buffers in iov
+	 * @param md_buf metadata buffer
+	 * @param offset_blocks offset on the cache device
+	 * @param num_blocks number of blocks to write
+	 * @param cb completion callback, bdev_io may be NULL
+	 * @param cb_arg completion callback argument
+	 *
+	 * @return Operation result
+	 */
+	int (*writev)(struct spdk_ftl_dev *dev, struct iovec *iov, int iovcnt, void *md_buf,
+		      uint64_t offset_blocks, uint64_t num_blocks,
+		      spdk_bdev_io_completion_cb cb, void *cb_arg);
+
 	struct ftl_md_layout_ops md_layout_ops;
 };
 
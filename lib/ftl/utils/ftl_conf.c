@@ -28,6 +28,7 @@ static const struct spdk_ftl_conf g_default_conf = {
 		.chunk_compaction_threshold = 80,
 		.chunk_free_target = 5,
 	},
+	.nv_cache_compaction_concurrency = FTL_NV_CACHE_NUM_COMPACTORS,
 	.fast_shutdown = true,
 };
 
@@ -58,6 +59,7 @@ spdk_ftl_conf_copy(struct spdk_ftl_conf *dst, const struct spdk_ftl_conf *src)
 	char *core_mask = NULL;
 	char *base_bdev = NULL;
 	char *cache_bdev = NULL;
+	char *cache_dax_path = NULL;
 
 	if (!src->conf_size || src->conf_size > sizeof(struct spdk_ftl_conf)) {
 		return -EINVAL;
@@ -87,6 +89,13 @@ spdk_ftl_conf_copy(struct spdk_ftl_conf *dst, const struct spdk_ftl_conf *src)
 			goto error;
 		}
 	}
+	if (src->conf_size >= offsetof(struct spdk_ftl_conf, cache_dax_path) +
+	    sizeof(src->cache_dax_path) && src->cache_dax_path) {
+		cache_dax_path = strdup(src->cache_dax_path);
+		if (!cache_dax_path) {
+			goto error;
+		}
+	}
 
 	memcpy(dst, src, src->conf_size);
 
@@ -94,12 +103,14 @@ spdk_ftl_conf_copy(struct spdk_ftl_conf *dst, const struct spdk_ftl_conf *src)
 	dst->core_mask = core_mask;
 	dst->base_bdev = base_bdev;
 	dst->cache_bdev = cache_bdev;
+	dst->cache_dax_path = cache_dax_path;
 	return 0;
 error:
 	free(name);
 	free(core_mask);
 	free(base_bdev);
 	free(cache_bdev);
+	free(cache_dax_path);
 	return -ENOMEM;
 }
 
@@ -110,6 +121,7 @@ spdk_ftl_conf_deinit(struct spdk_ftl_conf *conf)
 	free(conf->core_mask);
 	free(conf->base_bdev);
 	free(conf->cache_bdev);
+	free(conf->cache_dax_path);
 }
 
 int
@@ -172,6 +184,11 @@ ftl_conf_is_valid(const struct spdk_ftl_conf *conf)
 		return false;
 	}
 
+	if (conf->nv_cache_compaction_concurrency == 0 ||
+	    conf->nv_cache_compaction_concurrency > FTL_NV_CACHE_MAX_COMPACTORS) {
+		return false;
+	}
+
 	if (conf->l2p_dram_limit == 0) {
 		return false;
 	}
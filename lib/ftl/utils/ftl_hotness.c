@@ -0,0 +1,96 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#include "spdk/env.h"
+#include "spdk/util.h"
+#include "spdk/thread.h"
+
+#include "ftl_hotness.h"
+
+#define FTL_HOTNESS_DECAY_INTERVAL_MS 1000
+
+/* Group adjacent LBAs into one counter to aggregate spatial locality */
+#define FTL_HOTNESS_LBA_SHIFT 6
+
+static inline uint64_t
+hotness_bucket(struct ftl_hotness_sketch *sketch, uint64_t lba)
+{
+	/* Fibonacci hashing of the LBA group */
+	return ((lba >> FTL_HOTNESS_LBA_SHIFT) * 0x9e3779b97f4a7c15UL) >> sketch->shift;
+}
+
+struct ftl_hotness_sketch *
+ftl_hotness_sketch_create(uint64_t num_counters)
+{
+	struct ftl_hotness_sketch *sketch;
+
+	sketch = calloc(1, sizeof(*sketch));
+	if (!sketch) {
+		return NULL;
+	}
+
+	sketch->num_counters = spdk_align64pow2(num_counters);
+	sketch->shift = 64 - spdk_u64log2(sketch->num_counters);
+	sketch->counters = calloc(sketch->num_counters, sizeof(*sketch->counters));
+	if (!sketch->counters) {
+		free(sketch);
+		return NULL;
+	}
+
+	sketch->interval_tsc = FTL_HOTNESS_DECAY_INTERVAL_MS * (spdk_get_ticks_hz() / 1000);
+	sketch->next_tsc = spdk_get_ticks() + sketch->interval_tsc;
+
+	return sketch;
+}
+
+void
+ftl_hotness_sketch_destroy(struct ftl_hotness_sketch *sketch)
+{
+	if (!sketch) {
+		return;
+	}
+
+	free(sketch->counters);
+	free(sketch);
+}
+
+void
+ftl_hotness_sketch_update(struct ftl_hotness_sketch *sketch, uint64_t lba, uint64_t count)
+{
+	uint64_t group = lba >> FTL_HOTNESS_LBA_SHIFT;
+	uint64_t last_group = (lba + count - 1) >> FTL_HOTNESS_LBA_SHIFT;
+	uint64_t bucket;
+
+	assert(count);
+
+	for (; group <= last_group; group++) {
+		bucket = hotness_bucket(sketch, group << FTL_HOTNESS_LBA_SHIFT);
+		if (sketch->counters[bucket] < UINT8_MAX) {
+			sketch->counters[bucket]++;
+		}
+	}
+}
+
+uint8_t
+ftl_hotness_sketch_query(struct ftl_hotness_sketch *sketch, uint64_t lba)
+{
+	return sketch->counters[hotness_bucket(sketch, lba)];
+}
+
+void
+ftl_hotness_sketch_decay(struct ftl_hotness_sketch *sketch)
+{
+	uint64_t tsc = spdk_thread_get_last_tsc(spdk_get_thread());
+	uint64_t i;
+
+	if (spdk_likely(tsc < sketch->next_tsc)) {
+		return;
+	}
+	sketch->next_tsc = tsc + sketch->interval_tsc;
+
+	for (i = 0; i < sketch->num_counters; i++) {
+		sketch->counters[i] >>= 1;
+	}
+}
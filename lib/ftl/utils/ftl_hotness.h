@@ -0,0 +1,43 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#ifndef FTL_HOTNESS_H
+#define FTL_HOTNESS_H
+
+#include "spdk/stdinc.h"
+
+/* Default number of counters in the sketch (64KiB of DRAM) */
+#define FTL_HOTNESS_NUM_COUNTERS (64UL * 1024)
+
+/* Counter value from which an LBA is considered hot */
+#define FTL_HOTNESS_HOT_THRESHOLD 2
+
+/* Compact sketch of per-LBA update recency. LBA groups hash into a fixed array
+ * of saturating counters which are periodically halved, so a high counter means
+ * the group has been written repeatedly in the recent past. */
+struct ftl_hotness_sketch {
+	uint8_t *counters;
+	uint64_t num_counters;
+	/* Bits to shift the hashed key right by to get a counter index */
+	uint64_t shift;
+	/* Periodic counter decay */
+	uint64_t interval_tsc;
+	uint64_t next_tsc;
+};
+
+struct ftl_hotness_sketch *ftl_hotness_sketch_create(uint64_t num_counters);
+
+void ftl_hotness_sketch_destroy(struct ftl_hotness_sketch *sketch);
+
+/* Record an update of <count> blocks starting at <lba> */
+void ftl_hotness_sketch_update(struct ftl_hotness_sketch *sketch, uint64_t lba, uint64_t count);
+
+/* Get the update-recency counter of <lba> */
+uint8_t ftl_hotness_sketch_query(struct ftl_hotness_sketch *sketch, uint64_t lba);
+
+/* Halve all counters once the decay interval elapsed, call from the core poller */
+void ftl_hotness_sketch_decay(struct ftl_hotness_sketch *sketch);
+
+#endif /* FTL_HOTNESS_H */
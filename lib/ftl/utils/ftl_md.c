@@ -455,7 +455,10 @@ read_write_blocks_cb(struct spdk_bdev_io *bdev_io, bool success, void *arg)
 {
 	struct ftl_md *md = arg;
 
-	ftl_stats_bdev_io_completed(md->dev, get_bdev_io_ftl_stats_type(md->dev, bdev_io), bdev_io);
+	if (bdev_io != NULL) {
+		ftl_stats_bdev_io_completed(md->dev, get_bdev_io_ftl_stats_type(md->dev, bdev_io),
+					    bdev_io);
+	}
 
 	if (spdk_unlikely(!success)) {
 		if (md->io.op == FTL_MD_OP_RESTORE && has_mirror(md)) {
@@ -464,7 +467,9 @@ read_write_blocks_cb(struct spdk_bdev_io *bdev_io, bool success, void *arg)
 			md->io.status = -EIO;
 		}
 	} else {
-		uint64_t blocks = bdev_io->u.bdev.num_blocks;
+		/* Recompute the transfer size - the completion may not carry a bdev_io
+		 * when the NV cache device type completed it directly. */
+		uint64_t blocks = spdk_min(md->io.remaining, ftl_md_xfer_blocks(md->dev));
 		uint64_t size = blocks * FTL_BLOCK_SIZE;
 
 		if (md->io.op == FTL_MD_OP_RESTORE) {
@@ -482,7 +487,9 @@ read_write_blocks_cb(struct spdk_bdev_io *bdev_io, bool success, void *arg)
 		md->io.data_offset += size;
 	}
 
-	spdk_bdev_free_io(bdev_io);
+	if (bdev_io != NULL) {
+		spdk_bdev_free_io(bdev_io);
+	}
 
 	io_submit(md);
 }
@@ -677,9 +684,11 @@ persist_entry_cb(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 	struct ftl_md_io_entry_ctx *ctx = cb_arg;
 	struct ftl_md *md = ctx->md;
 
-	ftl_stats_bdev_io_completed(md->dev, get_bdev_io_ftl_stats_type(md->dev, bdev_io), bdev_io);
-
-	spdk_bdev_free_io(bdev_io);
+	if (bdev_io != NULL) {
+		ftl_stats_bdev_io_completed(md->dev, get_bdev_io_ftl_stats_type(md->dev, bdev_io),
+					    bdev_io);
+		spdk_bdev_free_io(bdev_io);
+	}
 
 	assert(ctx->remaining > 0);
 	ctx->remaining--;
@@ -787,9 +796,11 @@ read_entry_cb(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 	struct ftl_md_io_entry_ctx *ctx = cb_arg;
 	struct ftl_md *md = ctx->md;
 
-	ftl_stats_bdev_io_completed(md->dev, get_bdev_io_ftl_stats_type(md->dev, bdev_io), bdev_io);
-
-	spdk_bdev_free_io(bdev_io);
+	if (bdev_io != NULL) {
+		ftl_stats_bdev_io_completed(md->dev, get_bdev_io_ftl_stats_type(md->dev, bdev_io),
+					    bdev_io);
+		spdk_bdev_free_io(bdev_io);
+	}
 
 	if (!success) {
 		if (has_mirror(md)) {
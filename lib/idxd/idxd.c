@@ -25,6 +25,9 @@
 /* The minimum number of entries in batch per flush */
 #define IDXD_MIN_BATCH_FLUSH      32
 
+/* The number of completion records prefetched ahead of polling */
+#define IDXD_COMPLETIONS_PREFETCH 8
+
 #define DATA_BLOCK_SIZE_512 512
 #define DATA_BLOCK_SIZE_520 520
 #define DATA_BLOCK_SIZE_4096 4096
@@ -636,6 +639,18 @@ _idxd_flush_batch(struct spdk_idxd_io_channel *chan)
 	return 0;
 }
 
+int
+spdk_idxd_flush_batch(struct spdk_idxd_io_channel *chan)
+{
+	assert(chan != NULL);
+
+	if (chan->batch == NULL) {
+		return 0;
+	}
+
+	return idxd_batch_submit(chan, NULL, NULL);
+}
+
 static inline void
 _update_write_flags(struct spdk_idxd_io_channel *chan, struct idxd_hw_desc *desc)
 {
@@ -1908,9 +1923,18 @@ spdk_idxd_process_events(struct spdk_idxd_io_channel *chan)
 	int rc2, rc = 0;
 	void *cb_arg;
 	spdk_idxd_req_cb cb_fn;
+	int i;
 
 	assert(chan != NULL);
 
+	/* Completion records are written by the device, pull the first few into cache
+	 * before the processing loop polls their status bytes. */
+	op = STAILQ_FIRST(&chan->ops_outstanding);
+	for (i = 0; op != NULL && i < IDXD_COMPLETIONS_PREFETCH; i++) {
+		__builtin_prefetch(&op->hw);
+		op = STAILQ_NEXT(op, link);
+	}
+
 	STAILQ_FOREACH_SAFE(op, &chan->ops_outstanding, link, tmp) {
 		if (!IDXD_COMPLETION(op->hw.status)) {
 			/*
@@ -8,6 +8,7 @@
 
 #include "spdk/init.h"
 #include "spdk/util.h"
+#include "spdk/crc32.h"
 #include "spdk/file.h"
 #include "spdk/log.h"
 #include "spdk/env.h"
@@ -17,6 +18,9 @@
 #include "spdk/string.h"
 
 #include "spdk_internal/event.h"
+#include "spdk_internal/init.h"
+
+#include "subsystem.h"
 
 #define SPDK_DEBUG_APP_CFG(...) SPDK_DEBUGLOG(app_config, __VA_ARGS__)
 
@@ -42,10 +46,6 @@
  *
  */
 
-struct load_json_config_ctx;
-typedef void (*client_resp_handler)(struct load_json_config_ctx *,
-				    struct spdk_jsonrpc_client_response *);
-
 #define RPC_SOCKET_PATH_MAX SPDK_SIZEOF_MEMBER(struct sockaddr_un, sun_path)
 
 /* 1s connections timeout */
@@ -57,6 +57,13 @@ typedef void (*client_resp_handler)(struct load_json_config_ctx *,
  * So just print WARNLOG every 10s. */
 #define RPC_CLIENT_REQUEST_TIMEOUT_US (10U * 1000 * 1000)
 
+/* Config entries that invoke the same RPC method are assumed independent of each other
+ * and are applied concurrently, each request on its own client connection.  This is the
+ * default number of connections; it can be overridden with the
+ * SPDK_JSON_CONFIG_MAX_PARALLEL_RPCS environment variable. */
+#define RPC_CLIENT_DEFAULT_PARALLEL_RPCS 16
+#define RPC_CLIENT_MAX_PARALLEL_RPCS 32
+
 struct load_json_config_ctx {
 	/* Thread used during configuration. */
 	struct spdk_thread *thread;
@@ -87,10 +94,17 @@ struct load_json_config_ctx {
 
 	char rpc_socket_path_temp[RPC_SOCKET_PATH_MAX + 1];
 
-	struct spdk_jsonrpc_client *client_conn;
+	struct spdk_jsonrpc_client *client_conns[RPC_CLIENT_MAX_PARALLEL_RPCS];
+	bool client_conn_busy[RPC_CLIENT_MAX_PARALLEL_RPCS];
+	uint32_t num_conns;
 	struct spdk_poller *client_conn_poller;
 
-	client_resp_handler client_resp_cb;
+	/* Number of config entry RPCs currently in flight. */
+	uint32_t outstanding;
+	/* Method name of the RPCs currently in flight. */
+	char batch_method[128];
+	/* First error seen in the current batch. */
+	int batch_rc;
 
 	/* Timeout for current RPC client action. */
 	uint64_t timeout;
@@ -104,9 +118,13 @@ static void app_json_config_load_subsystem(void *_ctx);
 static void
 app_json_config_load_done(struct load_json_config_ctx *ctx, int rc)
 {
+	uint32_t i;
+
 	spdk_poller_unregister(&ctx->client_conn_poller);
-	if (ctx->client_conn != NULL) {
-		spdk_jsonrpc_client_close(ctx->client_conn);
+	for (i = 0; i < ctx->num_conns; i++) {
+		if (ctx->client_conns[i] != NULL) {
+			spdk_jsonrpc_client_close(ctx->client_conns[i]);
+		}
 	}
 
 	spdk_rpc_server_finish(ctx->rpc_socket_path_temp);
@@ -155,63 +173,72 @@ json_write_stdout(void *cb_ctx, const void *data, size_t size)
 	return rc == size ? 0 : -1;
 }
 
+static void app_json_config_load_subsystem_config_entry(void *_ctx);
+
 static int
 rpc_client_poller(void *arg)
 {
 	struct load_json_config_ctx *ctx = arg;
 	struct spdk_jsonrpc_client_response *resp;
-	client_resp_handler cb;
+	bool received = false;
+	uint32_t i;
 	int rc;
 
 	assert(spdk_get_thread() == ctx->thread);
 
-	rc = spdk_jsonrpc_client_poll(ctx->client_conn, 0);
-	if (rc == 0) {
-		rc = rpc_client_check_timeout(ctx);
-		if (rc == -ETIMEDOUT) {
-			rpc_client_set_timeout(ctx, RPC_CLIENT_REQUEST_TIMEOUT_US);
-			rc = 0;
+	for (i = 0; i < ctx->num_conns; i++) {
+		if (!ctx->client_conn_busy[i]) {
+			continue;
 		}
-	}
 
-	if (rc == 0) {
-		/* No response yet */
-		return SPDK_POLLER_BUSY;
-	} else if (rc < 0) {
-		app_json_config_load_done(ctx, rc);
-		return SPDK_POLLER_BUSY;
-	}
+		rc = spdk_jsonrpc_client_poll(ctx->client_conns[i], 0);
+		if (rc == 0) {
+			continue;
+		} else if (rc < 0) {
+			app_json_config_load_done(ctx, rc);
+			return SPDK_POLLER_BUSY;
+		}
 
-	resp = spdk_jsonrpc_client_get_response(ctx->client_conn);
-	assert(resp);
+		resp = spdk_jsonrpc_client_get_response(ctx->client_conns[i]);
+		assert(resp);
+
+		if (resp->error) {
+			struct json_write_buf buf = {};
+			struct spdk_json_write_ctx *w = spdk_json_write_begin(json_write_stdout,
+							&buf, SPDK_JSON_PARSE_FLAG_DECODE_IN_PLACE);
+
+			if (w == NULL) {
+				SPDK_ERRLOG("error response: (?)\n");
+			} else {
+				spdk_json_write_val(w, resp->error);
+				spdk_json_write_end(w);
+				SPDK_ERRLOG("error response: \n%s\n", buf.data);
+			}
+
+			if (ctx->stop_on_error && ctx->batch_rc == 0) {
+				ctx->batch_rc = -EINVAL;
+			}
+		}
 
-	if (resp->error) {
-		struct json_write_buf buf = {};
-		struct spdk_json_write_ctx *w = spdk_json_write_begin(json_write_stdout,
-						&buf, SPDK_JSON_PARSE_FLAG_DECODE_IN_PLACE);
+		/* Don't care about the rest of the response */
+		spdk_jsonrpc_client_free_response(resp);
 
-		if (w == NULL) {
-			SPDK_ERRLOG("error response: (?)\n");
-		} else {
-			spdk_json_write_val(w, resp->error);
-			spdk_json_write_end(w);
-			SPDK_ERRLOG("error response: \n%s\n", buf.data);
-		}
+		ctx->client_conn_busy[i] = false;
+		assert(ctx->outstanding > 0);
+		ctx->outstanding--;
+		received = true;
 	}
 
-	if (resp->error && ctx->stop_on_error) {
-		spdk_jsonrpc_client_free_response(resp);
-		app_json_config_load_done(ctx, -EINVAL);
-	} else {
-		/* We have response so we must have callback for it. */
-		cb = ctx->client_resp_cb;
-		assert(cb != NULL);
+	if (!received) {
+		if (ctx->outstanding > 0 && rpc_client_check_timeout(ctx) == -ETIMEDOUT) {
+			rpc_client_set_timeout(ctx, RPC_CLIENT_REQUEST_TIMEOUT_US);
+		}
 
-		/* Mark we are done with this handler. */
-		ctx->client_resp_cb = NULL;
-		cb(ctx, resp);
+		return SPDK_POLLER_BUSY;
 	}
 
+	rpc_client_set_timeout(ctx, RPC_CLIENT_REQUEST_TIMEOUT_US);
+	app_json_config_load_subsystem_config_entry(ctx);
 
 	return SPDK_POLLER_BUSY;
 }
@@ -220,43 +247,50 @@ static int
 rpc_client_connect_poller(void *_ctx)
 {
 	struct load_json_config_ctx *ctx = _ctx;
+	uint32_t i;
 	int rc;
 
-	rc = spdk_jsonrpc_client_poll(ctx->client_conn, 0);
-	if (rc != -ENOTCONN) {
-		/* We are connected. Start regular poller and issue first request */
-		spdk_poller_unregister(&ctx->client_conn_poller);
-		ctx->client_conn_poller = SPDK_POLLER_REGISTER(rpc_client_poller, ctx, 100);
-		app_json_config_load_subsystem(ctx);
-	} else {
-		rc = rpc_client_check_timeout(ctx);
-		if (rc) {
-			app_json_config_load_done(ctx, rc);
-		}
+	for (i = 0; i < ctx->num_conns; i++) {
+		rc = spdk_jsonrpc_client_poll(ctx->client_conns[i], 0);
+		if (rc == -ENOTCONN) {
+			rc = rpc_client_check_timeout(ctx);
+			if (rc) {
+				app_json_config_load_done(ctx, rc);
+			}
 
-		return SPDK_POLLER_IDLE;
+			return SPDK_POLLER_IDLE;
+		}
 	}
 
+	/* All connections are established. Start regular poller and issue first request */
+	spdk_poller_unregister(&ctx->client_conn_poller);
+	ctx->client_conn_poller = SPDK_POLLER_REGISTER(rpc_client_poller, ctx, 100);
+	app_json_config_load_subsystem(ctx);
+
 	return SPDK_POLLER_BUSY;
 }
 
 static int
-client_send_request(struct load_json_config_ctx *ctx, struct spdk_jsonrpc_client_request *request,
-		    client_resp_handler client_resp_cb)
+client_send_request(struct load_json_config_ctx *ctx, uint32_t conn_idx,
+		    struct spdk_jsonrpc_client_request *request)
 {
 	int rc;
 
 	assert(spdk_get_thread() == ctx->thread);
+	assert(conn_idx < ctx->num_conns && !ctx->client_conn_busy[conn_idx]);
 
-	ctx->client_resp_cb = client_resp_cb;
 	rpc_client_set_timeout(ctx, RPC_CLIENT_REQUEST_TIMEOUT_US);
-	rc = spdk_jsonrpc_client_send_request(ctx->client_conn, request);
+	rc = spdk_jsonrpc_client_send_request(ctx->client_conns[conn_idx], request);
 
 	if (rc) {
 		SPDK_DEBUG_APP_CFG("Sending request to client failed (%d)\n", rc);
+		return rc;
 	}
 
-	return rc;
+	ctx->client_conn_busy[conn_idx] = true;
+	ctx->outstanding++;
+
+	return 0;
 }
 
 static int
@@ -309,19 +343,6 @@ static struct spdk_json_object_decoder jsonrpc_cmd_decoders[] = {
 	{"params", offsetof(struct config_entry, params), cap_object, true}
 };
 
-static void app_json_config_load_subsystem_config_entry(void *_ctx);
-
-static void
-app_json_config_load_subsystem_config_entry_next(struct load_json_config_ctx *ctx,
-		struct spdk_jsonrpc_client_response *resp)
-{
-	/* Don't care about the response */
-	spdk_jsonrpc_client_free_response(resp);
-
-	ctx->config_it = spdk_json_next(ctx->config_it);
-	app_json_config_load_subsystem_config_entry(ctx);
-}
-
 /* Load "config" entry */
 static void
 app_json_config_load_subsystem_config_entry(void *_ctx)
@@ -333,9 +354,23 @@ app_json_config_load_subsystem_config_entry(void *_ctx)
 	struct spdk_json_val *params_end;
 	size_t params_len = 0;
 	uint32_t state_mask = 0, cur_state_mask, startup_runtime = SPDK_RPC_STARTUP | SPDK_RPC_RUNTIME;
+	uint32_t conn_idx;
 	int rc;
 
+	if (ctx->batch_rc != 0) {
+		/* An entry in the current batch failed. Wait for the rest of the batch
+		 * to drain before failing the load. */
+		if (ctx->outstanding == 0) {
+			app_json_config_load_done(ctx, ctx->batch_rc);
+		}
+		return;
+	}
+
 	if (ctx->config_it == NULL) {
+		if (ctx->outstanding > 0) {
+			/* Re-invoked from the client poller when the remaining responses arrive. */
+			return;
+		}
 		SPDK_DEBUG_APP_CFG("Subsystem '%.*s': configuration done.\n", ctx->subsystem_name->len,
 				   (char *)ctx->subsystem_name->start);
 		ctx->subsystems_it = spdk_json_next(ctx->subsystems_it);
@@ -398,6 +433,16 @@ app_json_config_load_subsystem_config_entry(void *_ctx)
 		goto out;
 	}
 
+	/* Entries that invoke the same RPC method are assumed independent of each other
+	 * and are issued concurrently, up to the parallelism window.  A method change acts
+	 * as a barrier, which preserves the ordering config generators rely on: e.g. lvol
+	 * stores are only opened once all controllers have finished attaching. */
+	if (ctx->outstanding > 0 &&
+	    (ctx->outstanding >= ctx->num_conns || strcmp(cfg.method, ctx->batch_method) != 0)) {
+		/* Retried from the client poller when a response completes. */
+		goto out;
+	}
+
 	SPDK_DEBUG_APP_CFG("\tmethod: %s\n", cfg.method);
 
 	if (cfg.params) {
@@ -416,7 +461,7 @@ app_json_config_load_subsystem_config_entry(void *_ctx)
 		goto out;
 	}
 
-	w = spdk_jsonrpc_begin_request(rpc_request, ctx->rpc_request_id, NULL);
+	w = spdk_jsonrpc_begin_request(rpc_request, ctx->rpc_request_id++, NULL);
 	if (!w) {
 		spdk_jsonrpc_client_free_request(rpc_request);
 		app_json_config_load_done(ctx, -ENOMEM);
@@ -434,11 +479,23 @@ app_json_config_load_subsystem_config_entry(void *_ctx)
 
 	spdk_jsonrpc_end_request(rpc_request, w);
 
-	rc = client_send_request(ctx, rpc_request, app_json_config_load_subsystem_config_entry_next);
+	for (conn_idx = 0; conn_idx < ctx->num_conns; conn_idx++) {
+		if (!ctx->client_conn_busy[conn_idx]) {
+			break;
+		}
+	}
+	assert(conn_idx < ctx->num_conns);
+
+	rc = client_send_request(ctx, conn_idx, rpc_request);
 	if (rc != 0) {
 		app_json_config_load_done(ctx, -rc);
 		goto out;
 	}
+
+	snprintf(ctx->batch_method, sizeof(ctx->batch_method), "%s", cfg.method);
+	ctx->config_it = spdk_json_next(ctx->config_it);
+	/* Try to issue the next entry concurrently. Invoke later to avoid recursion */
+	spdk_thread_send_msg(ctx->thread, app_json_config_load_subsystem_config_entry, ctx);
 out:
 	free(cfg.method);
 }
@@ -576,6 +633,9 @@ json_config_prepare_ctx(spdk_subsystem_init_fn cb_fn, void *cb_arg, bool stop_on
 			ssize_t json_size, bool initalize_subsystems)
 {
 	struct load_json_config_ctx *ctx = calloc(1, sizeof(*ctx));
+	const char *max_parallel;
+	long int parallel;
+	uint32_t i;
 	int rc;
 
 	if (!ctx) {
@@ -631,10 +691,24 @@ json_config_prepare_ctx(spdk_subsystem_init_fn cb_fn, void *cb_arg, bool stop_on
 		goto fail;
 	}
 
-	ctx->client_conn = spdk_jsonrpc_client_connect(ctx->rpc_socket_path_temp, AF_UNIX);
-	if (ctx->client_conn == NULL) {
-		SPDK_ERRLOG("Failed to connect to '%s'\n", ctx->rpc_socket_path_temp);
-		goto fail;
+	ctx->num_conns = RPC_CLIENT_DEFAULT_PARALLEL_RPCS;
+	max_parallel = getenv("SPDK_JSON_CONFIG_MAX_PARALLEL_RPCS");
+	if (max_parallel != NULL) {
+		parallel = spdk_strtol(max_parallel, 10);
+		if (parallel < 1 || parallel > RPC_CLIENT_MAX_PARALLEL_RPCS) {
+			SPDK_WARNLOG("Invalid SPDK_JSON_CONFIG_MAX_PARALLEL_RPCS value '%s', "
+				     "using %u\n", max_parallel, ctx->num_conns);
+		} else {
+			ctx->num_conns = parallel;
+		}
+	}
+
+	for (i = 0; i < ctx->num_conns; i++) {
+		ctx->client_conns[i] = spdk_jsonrpc_client_connect(ctx->rpc_socket_path_temp, AF_UNIX);
+		if (ctx->client_conns[i] == NULL) {
+			SPDK_ERRLOG("Failed to connect to '%s'\n", ctx->rpc_socket_path_temp);
+			goto fail;
+		}
 	}
 
 	rpc_client_set_timeout(ctx, RPC_CLIENT_CONNECT_TIMEOUT_US);
@@ -679,4 +753,167 @@ spdk_subsystem_load_config(void *json, ssize_t json_size, spdk_subsystem_init_fn
 	json_config_prepare_ctx(cb_fn, cb_arg, stop_on_error, json, json_size, false);
 }
 
+#define CONFIG_SNAPSHOT_MAGIC		"SPDKCFGS"
+#define CONFIG_SNAPSHOT_VERSION		1
+#define CONFIG_SNAPSHOT_CRC32C_INITIAL	0xffffffffUL
+
+struct config_snapshot_hdr {
+	uint8_t		magic[8];
+	uint32_t	version;
+	/* crc32c of the JSON payload following the header */
+	uint32_t	crc;
+	uint64_t	json_size;
+};
+SPDK_STATIC_ASSERT(sizeof(struct config_snapshot_hdr) == 24, "Incorrect size");
+
+struct config_snapshot_write_buf {
+	char *data;
+	size_t size;
+	size_t off;
+};
+
+static int
+config_snapshot_write_cb(void *cb_ctx, const void *data, size_t size)
+{
+	struct config_snapshot_write_buf *buf = cb_ctx;
+	size_t new_size;
+	char *tmp;
+
+	if (buf->off + size > buf->size) {
+		new_size = spdk_max(buf->size * 2, buf->off + size);
+		tmp = realloc(buf->data, new_size);
+		if (tmp == NULL) {
+			return -ENOMEM;
+		}
+		buf->data = tmp;
+		buf->size = new_size;
+	}
+
+	memcpy(buf->data + buf->off, data, size);
+	buf->off += size;
+
+	return 0;
+}
+
+static uint32_t
+config_snapshot_calc_crc(const void *json, size_t json_size)
+{
+	uint32_t crc;
+
+	crc = CONFIG_SNAPSHOT_CRC32C_INITIAL;
+	crc = spdk_crc32c_update(json, json_size, crc);
+	crc ^= CONFIG_SNAPSHOT_CRC32C_INITIAL;
+
+	return crc;
+}
+
+int
+spdk_subsystem_save_config_snapshot(const char *path)
+{
+	struct spdk_subsystem *subsystem;
+	struct spdk_json_write_ctx *w;
+	struct config_snapshot_hdr hdr = {};
+	struct config_snapshot_write_buf buf = {};
+	char *tmp_path = NULL;
+	FILE *f = NULL;
+	int rc;
+
+	w = spdk_json_write_begin(config_snapshot_write_cb, &buf, 0);
+	if (w == NULL) {
+		return -ENOMEM;
+	}
+
+	spdk_json_write_object_begin(w);
+	spdk_json_write_named_array_begin(w, "subsystems");
+	for (subsystem = subsystem_get_first(); subsystem != NULL;
+	     subsystem = subsystem_get_next(subsystem)) {
+		spdk_json_write_object_begin(w);
+		spdk_json_write_named_string(w, "subsystem", subsystem->name);
+		spdk_json_write_name(w, "config");
+		subsystem_config_json(w, subsystem);
+		spdk_json_write_object_end(w);
+	}
+	spdk_json_write_array_end(w);
+	spdk_json_write_object_end(w);
+
+	rc = spdk_json_write_end(w);
+	if (rc != 0) {
+		rc = -ENOMEM;
+		goto out;
+	}
+
+	memcpy(hdr.magic, CONFIG_SNAPSHOT_MAGIC, sizeof(hdr.magic));
+	hdr.version = CONFIG_SNAPSHOT_VERSION;
+	hdr.json_size = buf.off;
+	hdr.crc = config_snapshot_calc_crc(buf.data, buf.off);
+
+	tmp_path = spdk_sprintf_alloc("%s.tmp", path);
+	if (tmp_path == NULL) {
+		rc = -ENOMEM;
+		goto out;
+	}
+
+	f = fopen(tmp_path, "w");
+	if (f == NULL) {
+		rc = -errno;
+		goto out;
+	}
+
+	if (fwrite(&hdr, sizeof(hdr), 1, f) != 1 ||
+	    fwrite(buf.data, 1, buf.off, f) != buf.off) {
+		rc = -EIO;
+		fclose(f);
+		unlink(tmp_path);
+		goto out;
+	}
+
+	rc = fclose(f) == 0 ? 0 : -errno;
+	if (rc == 0 && rename(tmp_path, path) != 0) {
+		rc = -errno;
+	}
+	if (rc != 0) {
+		unlink(tmp_path);
+	}
+out:
+	free(tmp_path);
+	free(buf.data);
+	return rc;
+}
+
+void *
+spdk_subsystem_read_config_snapshot(const char *path, size_t *size)
+{
+	struct config_snapshot_hdr *hdr;
+	size_t file_size = 0;
+	void *data, *json;
+
+	data = spdk_posix_file_load_from_name(path, &file_size);
+	if (data == NULL) {
+		return NULL;
+	}
+
+	hdr = data;
+	if (file_size < sizeof(*hdr) ||
+	    memcmp(hdr->magic, CONFIG_SNAPSHOT_MAGIC, sizeof(hdr->magic)) != 0 ||
+	    hdr->version != CONFIG_SNAPSHOT_VERSION ||
+	    hdr->json_size != file_size - sizeof(*hdr) ||
+	    hdr->crc != config_snapshot_calc_crc(hdr + 1, hdr->json_size)) {
+		SPDK_WARNLOG("Config snapshot '%s' failed validation\n", path);
+		free(data);
+		return NULL;
+	}
+
+	*size = hdr->json_size;
+	json = malloc(hdr->json_size);
+	if (json == NULL) {
+		free(data);
+		return NULL;
+	}
+
+	memcpy(json, hdr + 1, hdr->json_size);
+	free(data);
+
+	return json;
+}
+
 SPDK_LOG_REGISTER_COMPONENT(app_config)
@@ -12,9 +12,17 @@
 #include "spdk/rpc.h"
 
 #define RPC_SELECT_INTERVAL	4000 /* 4ms */
+#define RPC_NUM_WORKERS		2
 
 static struct spdk_poller *g_rpc_poller = NULL;
 
+/* Threads running handlers of RPC methods registered with
+ * SPDK_RPC_METHOD_FLAG_CONCURRENT.  Mutating methods are not flagged and keep
+ * their ordering on the thread polling the servers. */
+static struct spdk_thread *g_rpc_workers[RPC_NUM_WORKERS];
+static uint32_t g_rpc_num_workers = 0;
+static uint32_t g_rpc_next_worker = 0;
+
 struct init_rpc_server {
 	struct spdk_rpc_server *server;
 	char listen_addr[sizeof(((struct sockaddr_un *)0)->sun_path)];
@@ -25,6 +33,59 @@ struct init_rpc_server {
 static STAILQ_HEAD(, init_rpc_server) g_init_rpc_servers = STAILQ_HEAD_INITIALIZER(
 			g_init_rpc_servers);
 
+static void
+rpc_worker_executor(void (*fn)(void *ctx), void *ctx)
+{
+	spdk_thread_send_msg(g_rpc_workers[g_rpc_next_worker], fn, ctx);
+	g_rpc_next_worker = (g_rpc_next_worker + 1) % g_rpc_num_workers;
+}
+
+static void
+rpc_start_workers(void)
+{
+	char name[32];
+
+	if (g_rpc_num_workers != 0) {
+		return;
+	}
+
+	while (g_rpc_num_workers < RPC_NUM_WORKERS) {
+		snprintf(name, sizeof(name), "rpc_worker_%" PRIu32, g_rpc_num_workers);
+		g_rpc_workers[g_rpc_num_workers] = spdk_thread_create(name, NULL);
+		if (g_rpc_workers[g_rpc_num_workers] == NULL) {
+			SPDK_ERRLOG("Unable to create RPC worker thread %s\n", name);
+			break;
+		}
+		g_rpc_num_workers++;
+	}
+
+	if (g_rpc_num_workers > 0) {
+		spdk_rpc_set_executor(rpc_worker_executor);
+	}
+}
+
+static void
+rpc_worker_exit(void *ctx)
+{
+	spdk_thread_exit(spdk_get_thread());
+}
+
+static void
+rpc_stop_workers(void)
+{
+	uint32_t i;
+
+	spdk_rpc_set_executor(NULL);
+
+	for (i = 0; i < g_rpc_num_workers; i++) {
+		/* Delivered after any handlers already sent to the worker */
+		spdk_thread_send_msg(g_rpc_workers[i], rpc_worker_exit, NULL);
+		g_rpc_workers[i] = NULL;
+	}
+	g_rpc_num_workers = 0;
+	g_rpc_next_worker = 0;
+}
+
 static int
 rpc_subsystem_poll_servers(void *arg)
 {
@@ -175,6 +236,7 @@ spdk_rpc_initialize(const char *listen_addr, const struct spdk_rpc_opts *opts)
 	if (g_rpc_poller == NULL) {
 		/* Register a poller to periodically check for RPCs */
 		g_rpc_poller = SPDK_POLLER_REGISTER(rpc_subsystem_poll_servers, NULL, RPC_SELECT_INTERVAL);
+		rpc_start_workers();
 	}
 
 	return 0;
@@ -197,6 +259,7 @@ spdk_rpc_server_finish(const char *listen_addr)
 
 	if (STAILQ_EMPTY(&g_init_rpc_servers)) {
 		spdk_poller_unregister(&g_rpc_poller);
+		rpc_stop_workers();
 	}
 }
 
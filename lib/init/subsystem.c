@@ -23,8 +23,11 @@ struct spdk_subsystem_list g_subsystems = TAILQ_HEAD_INITIALIZER(g_subsystems);
 TAILQ_HEAD(spdk_subsystem_depend_list, spdk_subsystem_depend);
 struct spdk_subsystem_depend_list g_subsystems_deps = TAILQ_HEAD_INITIALIZER(g_subsystems_deps);
 static struct spdk_subsystem *g_next_subsystem;
+static uint32_t g_subsystems_remaining = 0;
 static bool g_subsystems_initialized = false;
+static bool g_subsystems_init_failed = false;
 static bool g_subsystems_init_interrupted = false;
+static bool g_subsystems_fini_started = false;
 static spdk_subsystem_init_fn g_subsystem_start_fn = NULL;
 static void *g_subsystem_start_arg = NULL;
 static spdk_msg_fn g_subsystem_stop_fn = NULL;
@@ -140,45 +143,135 @@ subsystem_sort(void)
 	TAILQ_SWAP(&sorted_list, &g_subsystems, spdk_subsystem, tailq);
 }
 
-void
-spdk_subsystem_init_next(int rc)
+static bool
+subsystem_deps_initialized(struct spdk_subsystem *subsystem)
 {
-	assert(spdk_thread_is_app_thread(NULL));
+	struct spdk_subsystem_depend *dep;
+	struct spdk_subsystem *depends_on;
 
-	/* The initialization is interrupted by the spdk_subsystem_fini, so just return */
-	if (g_subsystems_init_interrupted) {
-		return;
+	TAILQ_FOREACH(dep, &g_subsystems_deps, tailq) {
+		if (strcmp(subsystem->name, dep->name) != 0) {
+			continue;
+		}
+		depends_on = subsystem_find(dep->depends_on);
+		assert(depends_on != NULL);
+		if (depends_on->state != SPDK_SUBSYSTEM_INITIALIZED) {
+			return false;
+		}
 	}
 
-	if (rc) {
-		SPDK_ERRLOG("Init subsystem %s failed\n", g_next_subsystem->name);
-		g_subsystem_start_fn(rc, g_subsystem_start_arg);
+	return true;
+}
+
+static void subsystem_init_complete(struct spdk_subsystem *subsystem, int rc);
+
+static void
+subsystem_init_kick(void)
+{
+	struct spdk_subsystem *subsystem;
+
+	if (g_subsystems_initialized || g_subsystems_init_failed || g_subsystems_init_interrupted) {
 		return;
 	}
 
-	if (!g_next_subsystem) {
-		g_next_subsystem = TAILQ_FIRST(&g_subsystems);
-	} else {
-		g_next_subsystem = TAILQ_NEXT(g_next_subsystem, tailq);
+	/* g_subsystems is dependency-sorted, so one forward pass visits each subsystem only
+	 * after all of its dependencies.  Start every subsystem whose dependencies have all
+	 * finished initializing.  Subsystems with an init_async handler may overlap with
+	 * anything their dependency edges allow, while only one legacy init() is kept
+	 * outstanding at a time - spdk_subsystem_init_next() identifies the completing
+	 * subsystem solely via g_next_subsystem.
+	 */
+	TAILQ_FOREACH(subsystem, &g_subsystems, tailq) {
+		if (subsystem->state != SPDK_SUBSYSTEM_UNINITIALIZED ||
+		    !subsystem_deps_initialized(subsystem)) {
+			continue;
+		}
+
+		if (subsystem->init_async) {
+			subsystem->state = SPDK_SUBSYSTEM_INITIALIZING;
+			subsystem->init_async(subsystem);
+		} else if (subsystem->init) {
+			if (g_next_subsystem != NULL) {
+				/* Wait for the outstanding init() to complete. */
+				continue;
+			}
+			subsystem->state = SPDK_SUBSYSTEM_INITIALIZING;
+			g_next_subsystem = subsystem;
+			subsystem->init();
+		} else {
+			subsystem->state = SPDK_SUBSYSTEM_INITIALIZED;
+			assert(g_subsystems_remaining > 0);
+			g_subsystems_remaining--;
+			continue;
+		}
+
+		/* The handler may have completed synchronously and finished (or failed) the
+		 * whole initialization through a nested pass - don't do it again. */
+		if (g_subsystems_initialized || g_subsystems_init_failed ||
+		    g_subsystems_init_interrupted) {
+			return;
+		}
 	}
 
-	if (!g_next_subsystem) {
+	if (g_subsystems_remaining == 0) {
 		g_subsystems_initialized = true;
 		g_subsystem_start_fn(0, g_subsystem_start_arg);
+	}
+}
+
+static void
+subsystem_init_complete(struct spdk_subsystem *subsystem, int rc)
+{
+	/* The initialization is interrupted by the spdk_subsystem_fini, so just return */
+	if (g_subsystems_init_interrupted) {
 		return;
 	}
 
-	if (g_next_subsystem->init) {
-		g_next_subsystem->init();
-	} else {
-		spdk_subsystem_init_next(0);
+	if (rc) {
+		SPDK_ERRLOG("Init subsystem %s failed\n", subsystem->name);
+		/* Report only the first failure - the failed subsystem keeps its INITIALIZING
+		 * state, so it is still de-initialized on the way down. */
+		if (!g_subsystems_init_failed) {
+			g_subsystems_init_failed = true;
+			g_subsystem_start_fn(rc, g_subsystem_start_arg);
+		}
+		return;
 	}
+
+	assert(subsystem->state == SPDK_SUBSYSTEM_INITIALIZING);
+	subsystem->state = SPDK_SUBSYSTEM_INITIALIZED;
+	assert(g_subsystems_remaining > 0);
+	g_subsystems_remaining--;
+
+	subsystem_init_kick();
+}
+
+void
+spdk_subsystem_init_next(int rc)
+{
+	struct spdk_subsystem *subsystem = g_next_subsystem;
+
+	assert(spdk_thread_is_app_thread(NULL));
+	assert(subsystem != NULL);
+
+	g_next_subsystem = NULL;
+	subsystem_init_complete(subsystem, rc);
+}
+
+void
+spdk_subsystem_init_done(struct spdk_subsystem *subsystem, int rc)
+{
+	assert(spdk_thread_is_app_thread(NULL));
+	assert(subsystem != NULL);
+
+	subsystem_init_complete(subsystem, rc);
 }
 
 void
 spdk_subsystem_init(spdk_subsystem_init_fn cb_fn, void *cb_arg)
 {
 	struct spdk_subsystem_depend *dep;
+	struct spdk_subsystem *subsystem;
 
 	assert(spdk_thread_is_app_thread(NULL));
 
@@ -202,7 +295,15 @@ spdk_subsystem_init(spdk_subsystem_init_fn cb_fn, void *cb_arg)
 
 	subsystem_sort();
 
-	spdk_subsystem_init_next(0);
+	g_subsystems_initialized = false;
+	g_subsystems_init_failed = false;
+	g_subsystems_remaining = 0;
+	TAILQ_FOREACH(subsystem, &g_subsystems, tailq) {
+		subsystem->state = SPDK_SUBSYSTEM_UNINITIALIZED;
+		g_subsystems_remaining++;
+	}
+
+	subsystem_init_kick();
 }
 
 static void
@@ -210,23 +311,22 @@ subsystem_fini_next(void *arg1)
 {
 	assert(g_fini_thread == spdk_get_thread());
 
-	if (!g_next_subsystem) {
-		/* If the initialized flag is false, then we've failed to initialize
-		 * the very first subsystem and no de-init is needed
-		 */
-		if (g_subsystems_initialized) {
-			g_next_subsystem = TAILQ_LAST(&g_subsystems, spdk_subsystem_list);
-		}
-	} else {
-		if (g_subsystems_initialized || g_subsystems_init_interrupted) {
-			g_next_subsystem = TAILQ_PREV(g_next_subsystem, spdk_subsystem_list, tailq);
-		} else {
+	if (!g_subsystems_fini_started) {
+		g_subsystems_fini_started = true;
+		if (!g_subsystems_initialized) {
+			/* Initialization didn't finish.  Ignore any init completions that are
+			 * still in flight and only de-initialize subsystems that already
+			 * started initializing.
+			 */
 			g_subsystems_init_interrupted = true;
 		}
+		g_next_subsystem = TAILQ_LAST(&g_subsystems, spdk_subsystem_list);
+	} else {
+		g_next_subsystem = TAILQ_PREV(g_next_subsystem, spdk_subsystem_list, tailq);
 	}
 
 	while (g_next_subsystem) {
-		if (g_next_subsystem->fini) {
+		if (g_next_subsystem->state != SPDK_SUBSYSTEM_UNINITIALIZED && g_next_subsystem->fini) {
 			g_next_subsystem->fini();
 			return;
 		}
@@ -6,6 +6,7 @@
 
 #include "spdk/stdinc.h"
 
+#include "spdk/accel.h"
 #include "spdk/endian.h"
 #include "spdk/env.h"
 #include "spdk/likely.h"
@@ -28,6 +29,12 @@
             ((*((uint8_t *)(BUF)+2)) = (uint8_t)((uint32_t)(CRC32C) >> 16)), \
             ((*((uint8_t *)(BUF)+3)) = (uint8_t)((uint32_t)(CRC32C) >> 24)))
 
+/* Data digests of payloads at least this large are offloaded to the accel
+ * framework; smaller ones cost less to compute inline than to round-trip
+ * through an accel channel.
+ */
+#define ISCSI_ACCEL_DATA_DIGEST_MIN_LEN 2048
+
 #define SPDK_ISCSI_CONNECTION_MEMSET(conn)		\
 	memset(&(conn)->portal, 0, sizeof(*(conn)) -	\
 		offsetof(struct spdk_iscsi_conn, portal));
@@ -43,6 +50,11 @@ static pthread_mutex_t g_conns_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 static struct spdk_poller *g_shutdown_timer = NULL;
 
+/* Next poll group to host login processing for a new connection, advanced
+ * round-robin under g_iscsi.mutex.
+ */
+static struct spdk_iscsi_poll_group *g_next_login_pg = NULL;
+
 static void iscsi_conn_sock_cb(void *arg, struct spdk_sock_group *group,
 			       struct spdk_sock *sock);
 
@@ -156,15 +168,57 @@ login_timeout(void *arg)
 }
 
 static void
-iscsi_conn_start(void *ctx)
+iscsi_conn_login_start(struct spdk_iscsi_conn *conn)
 {
-	struct spdk_iscsi_conn *conn = ctx;
+	struct spdk_iscsi_poll_group *pg = conn->pg;
 
-	iscsi_poll_group_add_conn(conn->pg, conn);
+	pg->num_login_conns++;
+	conn->in_login = true;
+
+	iscsi_poll_group_add_conn(pg, conn);
 
 	conn->login_timer = SPDK_POLLER_REGISTER(login_timeout, conn, ISCSI_LOGIN_TIMEOUT * 1000000);
 }
 
+static void
+iscsi_conn_login_done(struct spdk_iscsi_conn *conn)
+{
+	struct spdk_iscsi_poll_group *pg = conn->pg;
+	struct spdk_iscsi_conn *next;
+
+	assert(conn->in_login);
+	conn->in_login = false;
+
+	assert(pg->num_login_conns > 0);
+	pg->num_login_conns--;
+
+	next = STAILQ_FIRST(&pg->pending_login_conns);
+	if (next != NULL) {
+		STAILQ_REMOVE_HEAD(&pg->pending_login_conns, pg_link);
+		iscsi_conn_login_start(next);
+	}
+}
+
+static void
+iscsi_conn_start(void *ctx)
+{
+	struct spdk_iscsi_conn *conn = ctx;
+	struct spdk_iscsi_poll_group *pg = conn->pg;
+
+	if (pg->num_login_conns >= g_iscsi.MaxLoginsPerPollGroup) {
+		/* The login concurrency budget of this poll group is used up.
+		 * Queue the connection until an earlier login finishes, so that
+		 * a login storm cannot crowd out PDU processing for established
+		 * connections.  The login timer starts only when the login
+		 * itself does.
+		 */
+		STAILQ_INSERT_TAIL(&pg->pending_login_conns, conn, pg_link);
+		return;
+	}
+
+	iscsi_conn_login_start(conn);
+}
+
 int
 iscsi_conn_construct(struct spdk_iscsi_portal *portal,
 		     struct spdk_sock *sock)
@@ -217,7 +271,11 @@ iscsi_conn_construct(struct spdk_iscsi_portal *portal,
 	conn->pdu_recv_state = ISCSI_PDU_RECV_STATE_AWAIT_PDU_READY;
 
 	TAILQ_INIT(&conn->write_pdu_list);
+	TAILQ_INIT(&conn->write_digest_pdu_list);
+	conn->pending_digest_ops = 0;
 	TAILQ_INIT(&conn->snack_pdu_list);
+	TAILQ_INIT(&conn->free_pdu_list);
+	conn->free_pdu_cnt = 0;
 	TAILQ_INIT(&conn->queued_r2t_tasks);
 	TAILQ_INIT(&conn->active_r2t_tasks);
 	TAILQ_INIT(&conn->queued_datain_tasks);
@@ -249,8 +307,19 @@ iscsi_conn_construct(struct spdk_iscsi_portal *portal,
 	SPDK_DEBUGLOG(iscsi, "Launching connection on acceptor thread\n");
 	conn->pending_task_cnt = 0;
 
-	/* Get the first poll group. */
-	pg = TAILQ_FIRST(&g_iscsi.poll_group_head);
+	/* Pick a poll group for login processing in a round-robin manner,
+	 * so that a burst of logins spreads across all poll groups instead
+	 * of landing on the first one.
+	 */
+	pthread_mutex_lock(&g_iscsi.mutex);
+	if (g_next_login_pg == NULL) {
+		g_next_login_pg = TAILQ_FIRST(&g_iscsi.poll_group_head);
+	}
+	pg = g_next_login_pg;
+	if (pg != NULL) {
+		g_next_login_pg = TAILQ_NEXT(g_next_login_pg, link);
+	}
+	pthread_mutex_unlock(&g_iscsi.mutex);
 	if (pg == NULL) {
 		SPDK_ERRLOG("There is no poll group.\n");
 		assert(false);
@@ -398,6 +467,7 @@ iscsi_conn_free(struct spdk_iscsi_conn *conn)
 
 end:
 	SPDK_DEBUGLOG(iscsi, "cleanup free conn\n");
+	iscsi_drain_pdu_cache(conn);
 	iscsi_param_free(conn->params);
 	_free_conn(conn);
 
@@ -616,6 +686,13 @@ _iscsi_conn_destruct(struct spdk_iscsi_conn *conn)
 {
 	int rc;
 
+	if (conn->in_login) {
+		/* The connection is exiting before login completed.  Release its
+		 * login slot and kick a queued login if any.
+		 */
+		iscsi_conn_login_done(conn);
+	}
+
 	iscsi_poll_group_remove_conn(conn->pg, conn);
 	spdk_sock_close(&conn->sock);
 	iscsi_clear_all_transfer_task(conn, NULL, NULL);
@@ -1426,12 +1503,69 @@ iscsi_conn_pdu_generic_complete(void *cb_arg)
 {
 }
 
+static void
+iscsi_conn_pdu_start_write(struct spdk_iscsi_conn *conn, struct spdk_iscsi_pdu *pdu)
+{
+	pdu->sock_req.iovcnt = iscsi_build_iovs(conn, pdu->iov, SPDK_COUNTOF(pdu->iov), pdu,
+						&pdu->mapped_length);
+	pdu->sock_req.cb_fn = _iscsi_conn_pdu_write_done;
+	pdu->sock_req.cb_arg = pdu;
+
+	spdk_sock_writev_async(conn->sock, &pdu->sock_req);
+}
+
+/* Write out PDUs whose digests are ready, stopping at the first PDU whose data
+ * digest is still being computed, to preserve PDU ordering on the socket. */
+static void
+iscsi_conn_flush_digest_pdus(struct spdk_iscsi_conn *conn)
+{
+	struct spdk_iscsi_pdu *pdu;
+
+	while (!TAILQ_EMPTY(&conn->write_digest_pdu_list)) {
+		pdu = TAILQ_FIRST(&conn->write_digest_pdu_list);
+		if (pdu->data_digest_in_flight) {
+			break;
+		}
+		TAILQ_REMOVE(&conn->write_digest_pdu_list, pdu, tailq_digest);
+		iscsi_conn_pdu_start_write(conn, pdu);
+	}
+}
+
+static void
+iscsi_pdu_data_digest_done(void *cb_arg, int status)
+{
+	struct spdk_iscsi_pdu *pdu = cb_arg;
+	struct spdk_iscsi_conn *conn = pdu->conn;
+	uint32_t crc32c;
+
+	assert(conn->pending_digest_ops > 0);
+	conn->pending_digest_ops--;
+
+	if (spdk_likely(status == 0)) {
+		crc32c = iscsi_pdu_finalize_data_digest(pdu);
+	} else {
+		/* Fall back to computing the digest on the connection's thread */
+		crc32c = iscsi_pdu_calc_data_digest(pdu);
+	}
+	MAKE_DIGEST_WORD(pdu->data_digest, crc32c);
+	pdu->data_digest_in_flight = false;
+
+	if (spdk_unlikely(conn->state >= ISCSI_CONN_STATE_EXITING)) {
+		/* The PDUs are freed together with the write_pdu_list */
+		return;
+	}
+
+	iscsi_conn_flush_digest_pdus(conn);
+}
+
 void
 iscsi_conn_write_pdu(struct spdk_iscsi_conn *conn, struct spdk_iscsi_pdu *pdu,
 		     iscsi_conn_xfer_complete_cb cb_fn,
 		     void *cb_arg)
 {
 	uint32_t crc32c;
+	uint32_t data_len;
+	bool accel_digest = false;
 	ssize_t rc;
 
 	if (spdk_unlikely(pdu->dif_insert_or_strip)) {
@@ -1451,9 +1585,16 @@ iscsi_conn_write_pdu(struct spdk_iscsi_conn *conn, struct spdk_iscsi_pdu *pdu,
 		}
 
 		/* Data Digest */
-		if (conn->data_digest && DGET24(pdu->bhs.data_segment_len) != 0) {
-			crc32c = iscsi_pdu_calc_data_digest(pdu);
-			MAKE_DIGEST_WORD(pdu->data_digest, crc32c);
+		data_len = DGET24(pdu->bhs.data_segment_len);
+		if (conn->data_digest && data_len != 0) {
+			if (!pdu->dif_insert_or_strip &&
+			    data_len >= ISCSI_ACCEL_DATA_DIGEST_MIN_LEN &&
+			    conn->state < ISCSI_CONN_STATE_EXITING) {
+				accel_digest = true;
+			} else {
+				crc32c = iscsi_pdu_calc_data_digest(pdu);
+				MAKE_DIGEST_WORD(pdu->data_digest, crc32c);
+			}
 		}
 	}
 
@@ -1464,12 +1605,33 @@ iscsi_conn_write_pdu(struct spdk_iscsi_conn *conn, struct spdk_iscsi_pdu *pdu,
 	if (spdk_unlikely(conn->state >= ISCSI_CONN_STATE_EXITING)) {
 		return;
 	}
-	pdu->sock_req.iovcnt = iscsi_build_iovs(conn, pdu->iov, SPDK_COUNTOF(pdu->iov), pdu,
-						&pdu->mapped_length);
-	pdu->sock_req.cb_fn = _iscsi_conn_pdu_write_done;
-	pdu->sock_req.cb_arg = pdu;
 
-	spdk_sock_writev_async(conn->sock, &pdu->sock_req);
+	if (accel_digest) {
+		pdu->data_digest_in_flight = true;
+		TAILQ_INSERT_TAIL(&conn->write_digest_pdu_list, pdu, tailq_digest);
+		rc = spdk_accel_submit_crc32c(conn->pg->accel_channel, &pdu->crc32c,
+					      pdu->data, 0, data_len,
+					      iscsi_pdu_data_digest_done, pdu);
+		if (rc == 0) {
+			conn->pending_digest_ops++;
+			return;
+		}
+
+		/* Fall back to computing the digest inline */
+		pdu->data_digest_in_flight = false;
+		crc32c = iscsi_pdu_calc_data_digest(pdu);
+		MAKE_DIGEST_WORD(pdu->data_digest, crc32c);
+	} else if (!TAILQ_EMPTY(&conn->write_digest_pdu_list)) {
+		/* An earlier PDU is still waiting for its digest - queue up behind it */
+		TAILQ_INSERT_TAIL(&conn->write_digest_pdu_list, pdu, tailq_digest);
+	}
+
+	if (!TAILQ_EMPTY(&conn->write_digest_pdu_list)) {
+		iscsi_conn_flush_digest_pdus(conn);
+		return;
+	}
+
+	iscsi_conn_pdu_start_write(conn, pdu);
 }
 
 static void
@@ -1528,9 +1690,14 @@ iscsi_conn_schedule(struct spdk_iscsi_conn *conn)
 	struct spdk_iscsi_poll_group	*pg;
 	struct spdk_iscsi_tgt_node	*target;
 
+	/* Login is complete.  Release the connection's login slot and kick a
+	 * queued login if any.
+	 */
+	iscsi_conn_login_done(conn);
+
 	if (conn->sess->session_type != SESSION_TYPE_NORMAL) {
-		/* Leave all non-normal sessions on the acceptor
-		 * thread. */
+		/* Leave all non-normal sessions on the poll group that
+		 * handled their login. */
 		return;
 	}
 	pthread_mutex_lock(&g_iscsi.mutex);
@@ -98,12 +98,29 @@ struct spdk_iscsi_conn {
 	 */
 	struct spdk_poller *login_timer;
 
+	/* Set while the connection is counted against its poll group's login
+	 *  concurrency budget.
+	 */
+	bool in_login;
+
 	struct spdk_iscsi_pdu *pdu_in_progress;
 	enum iscsi_pdu_recv_state pdu_recv_state;
 
 	TAILQ_HEAD(, spdk_iscsi_pdu) write_pdu_list;
+	/* PDUs whose socket write is held back until an accel-offloaded data
+	 *  digest completes; writes must preserve PDU ordering.
+	 */
+	TAILQ_HEAD(, spdk_iscsi_pdu) write_digest_pdu_list;
+	/* Number of accel data digest operations in flight */
+	uint32_t pending_digest_ops;
 	TAILQ_HEAD(, spdk_iscsi_pdu) snack_pdu_list;
 
+	/* Per-connection cache of free PDUs, refilled from and drained back
+	 *  to the global PDU pool.
+	 */
+	TAILQ_HEAD(, spdk_iscsi_pdu) free_pdu_list;
+	uint32_t free_pdu_cnt;
+
 	uint32_t pending_r2t;
 
 	uint16_t cid;
@@ -316,6 +316,30 @@ iscsi_pdu_calc_partial_data_digest_done(struct spdk_iscsi_pdu *pdu)
 	return crc32c ^ SPDK_CRC32C_XOR;
 }
 
+/* Finalize a data digest whose CRC over the data segment was already computed
+ * elsewhere (e.g. by the accel framework) and stored in pdu->crc32c. */
+uint32_t
+iscsi_pdu_finalize_data_digest(struct spdk_iscsi_pdu *pdu)
+{
+	uint32_t data_len = DGET24(pdu->bhs.data_segment_len);
+	uint32_t crc32c = pdu->crc32c;
+	uint32_t mod;
+
+	/* Include padding bytes into CRC if any. */
+	mod = data_len % ISCSI_ALIGNMENT;
+	if (mod != 0) {
+		uint32_t pad_length = ISCSI_ALIGNMENT - mod;
+		uint8_t pad[3] = {0, 0, 0};
+
+		assert(pad_length > 0);
+		assert(pad_length <= sizeof(pad));
+		crc32c = spdk_crc32c_update(pad, pad_length, crc32c);
+	}
+
+	/* Finalize CRC by inverting all bits. */
+	return crc32c ^ SPDK_CRC32C_XOR;
+}
+
 uint32_t
 iscsi_pdu_calc_data_digest(struct spdk_iscsi_pdu *pdu)
 {
@@ -107,6 +107,14 @@
 /** Defines how long we should wait until login process completes. */
 #define ISCSI_LOGIN_TIMEOUT 30 /* in seconds */
 
+/* Defines default maximum number of connections in login phase each poll
+ *  group processes concurrently. Further logins are queued until an earlier
+ *  login completes, so that a login storm (e.g. thousands of initiators
+ *  relogging in after a network outage) cannot crowd out PDU processing for
+ *  established connections.
+ */
+#define DEFAULT_MAX_LOGINS_PER_POLL_GROUP 64
+
 /* For spdk_iscsi_login_in related function use, we need to avoid the conflict
  * with other errors
  * */
@@ -116,6 +124,11 @@
 
 #define ISCSI_AHS_LEN 60
 
+/* Max number of free PDUs cached on each connection to avoid
+ * going through the global PDU pool on the hot path.
+ */
+#define ISCSI_CONN_PDU_CACHE_SIZE 32
+
 struct spdk_mobj {
 	struct spdk_mempool *mp;
 	void *buf;
@@ -163,6 +176,8 @@ struct spdk_iscsi_pdu {
 	uint32_t data_buf_len;
 	uint32_t data_offset;
 	uint32_t crc32c;
+	/* The data digest is being computed by the accel framework */
+	bool data_digest_in_flight;
 	bool dif_insert_or_strip;
 	struct spdk_dif_ctx dif_ctx;
 	struct spdk_iscsi_conn *conn;
@@ -177,6 +192,7 @@ struct spdk_iscsi_pdu {
 	struct spdk_sock_request			sock_req;
 	struct iovec					iov[SPDK_ISCSI_MAX_SGL_DESCRIPTORS];
 	TAILQ_ENTRY(spdk_iscsi_pdu)	tailq;
+	TAILQ_ENTRY(spdk_iscsi_pdu)	tailq_digest;
 
 
 	/*
@@ -286,7 +302,12 @@ struct spdk_iscsi_poll_group {
 	struct spdk_poller				*poller;
 	struct spdk_poller				*nop_poller;
 	STAILQ_HEAD(connections, spdk_iscsi_conn)	connections;
+	/* Connections waiting for a login slot on this poll group. */
+	STAILQ_HEAD(pending_logins, spdk_iscsi_conn)	pending_login_conns;
+	/* Number of connections currently in login phase on this poll group. */
+	uint32_t					num_login_conns;
 	struct spdk_sock_group				*sock_group;
+	struct spdk_io_channel				*accel_channel;
 	TAILQ_ENTRY(spdk_iscsi_poll_group)		link;
 };
 
@@ -311,6 +332,7 @@ struct spdk_iscsi_opts {
 	bool AllowDuplicateIsid;
 	uint32_t MaxLargeDataInPerConnection;
 	uint32_t MaxR2TPerConnection;
+	uint32_t MaxLoginsPerPollGroup;
 	uint32_t pdu_pool_size;
 	uint32_t immediate_data_pool_size;
 	uint32_t data_out_pool_size;
@@ -347,6 +369,7 @@ struct spdk_iscsi_globals {
 	bool AllowDuplicateIsid;
 	uint32_t MaxLargeDataInPerConnection;
 	uint32_t MaxR2TPerConnection;
+	uint32_t MaxLoginsPerPollGroup;
 	uint32_t pdu_pool_size;
 	uint32_t immediate_data_pool_size;
 	uint32_t data_out_pool_size;
@@ -435,10 +458,12 @@ bool iscsi_del_transfer_task(struct spdk_iscsi_conn *conn, uint32_t CmdSN);
 
 uint32_t iscsi_pdu_calc_header_digest(struct spdk_iscsi_pdu *pdu);
 uint32_t iscsi_pdu_calc_data_digest(struct spdk_iscsi_pdu *pdu);
+uint32_t iscsi_pdu_finalize_data_digest(struct spdk_iscsi_pdu *pdu);
 
 /* Memory management */
 void iscsi_put_pdu(struct spdk_iscsi_pdu *pdu);
 struct spdk_iscsi_pdu *iscsi_get_pdu(struct spdk_iscsi_conn *conn);
+void iscsi_drain_pdu_cache(struct spdk_iscsi_conn *conn);
 void iscsi_op_abort_task_set(struct spdk_iscsi_task *task,
 			     uint8_t function);
 void iscsi_queue_task(struct spdk_iscsi_conn *conn, struct spdk_iscsi_task *task);
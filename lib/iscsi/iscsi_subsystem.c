@@ -4,6 +4,7 @@
  *   All rights reserved.
  */
 
+#include "spdk/accel.h"
 #include "spdk/string.h"
 #include "spdk/likely.h"
 
@@ -213,8 +214,27 @@ iscsi_put_pdu(struct spdk_iscsi_pdu *pdu)
 			free(pdu->data);
 		}
 
+		if (pdu->conn != NULL &&
+		    pdu->conn->free_pdu_cnt < ISCSI_CONN_PDU_CACHE_SIZE) {
+			TAILQ_INSERT_HEAD(&pdu->conn->free_pdu_list, pdu, tailq);
+			pdu->conn->free_pdu_cnt++;
+		} else {
+			spdk_mempool_put(g_iscsi.pdu_pool, (void *)pdu);
+		}
+	}
+}
+
+void
+iscsi_drain_pdu_cache(struct spdk_iscsi_conn *conn)
+{
+	struct spdk_iscsi_pdu *pdu;
+
+	while ((pdu = TAILQ_FIRST(&conn->free_pdu_list)) != NULL) {
+		TAILQ_REMOVE(&conn->free_pdu_list, pdu, tailq);
 		spdk_mempool_put(g_iscsi.pdu_pool, (void *)pdu);
 	}
+
+	conn->free_pdu_cnt = 0;
 }
 
 struct spdk_iscsi_pdu *iscsi_get_pdu(struct spdk_iscsi_conn *conn)
@@ -222,10 +242,17 @@ struct spdk_iscsi_pdu *iscsi_get_pdu(struct spdk_iscsi_conn *conn)
 	struct spdk_iscsi_pdu *pdu;
 
 	assert(conn != NULL);
-	pdu = spdk_mempool_get(g_iscsi.pdu_pool);
-	if (!pdu) {
-		SPDK_ERRLOG("Unable to get PDU\n");
-		abort();
+	pdu = TAILQ_FIRST(&conn->free_pdu_list);
+	if (pdu != NULL) {
+		TAILQ_REMOVE(&conn->free_pdu_list, pdu, tailq);
+		assert(conn->free_pdu_cnt > 0);
+		conn->free_pdu_cnt--;
+	} else {
+		pdu = spdk_mempool_get(g_iscsi.pdu_pool);
+		if (!pdu) {
+			SPDK_ERRLOG("Unable to get PDU\n");
+			abort();
+		}
 	}
 
 	/* we do not want to zero out the last part of the structure reserved for AHS and sense data */
@@ -290,6 +317,9 @@ iscsi_log_globals(void)
 
 	SPDK_DEBUGLOG(iscsi, "MaxR2TPerConnection %d\n",
 		      g_iscsi.MaxR2TPerConnection);
+
+	SPDK_DEBUGLOG(iscsi, "MaxLoginsPerPollGroup %d\n",
+		      g_iscsi.MaxLoginsPerPollGroup);
 }
 
 #define NUM_PDU_PER_CONNECTION(opts)	(2 * (opts->MaxQueueDepth +	\
@@ -321,6 +351,7 @@ iscsi_opts_init(struct spdk_iscsi_opts *opts)
 	opts->nodebase = NULL;
 	opts->MaxLargeDataInPerConnection = DEFAULT_MAX_LARGE_DATAIN_PER_CONNECTION;
 	opts->MaxR2TPerConnection = DEFAULT_MAXR2T;
+	opts->MaxLoginsPerPollGroup = DEFAULT_MAX_LOGINS_PER_POLL_GROUP;
 	opts->pdu_pool_size = PDU_POOL_SIZE(opts);
 	opts->immediate_data_pool_size = IMMEDIATE_DATA_POOL_SIZE(opts);
 	opts->data_out_pool_size = DATA_OUT_POOL_SIZE(opts);
@@ -398,6 +429,7 @@ iscsi_opts_copy(struct spdk_iscsi_opts *src)
 	dst->chap_group = src->chap_group;
 	dst->MaxLargeDataInPerConnection = src->MaxLargeDataInPerConnection;
 	dst->MaxR2TPerConnection = src->MaxR2TPerConnection;
+	dst->MaxLoginsPerPollGroup = src->MaxLoginsPerPollGroup;
 	dst->pdu_pool_size = src->pdu_pool_size;
 	dst->immediate_data_pool_size = src->immediate_data_pool_size;
 	dst->data_out_pool_size = src->data_out_pool_size;
@@ -490,6 +522,11 @@ iscsi_opts_verify(struct spdk_iscsi_opts *opts)
 		return -EINVAL;
 	}
 
+	if (opts->MaxLoginsPerPollGroup == 0) {
+		SPDK_ERRLOG("0 is invalid. MaxLoginsPerPollGroup must be more than 0\n");
+		return -EINVAL;
+	}
+
 	if (opts->pdu_pool_size == 0) {
 		SPDK_ERRLOG("0 is invalid. pdu_pool_size must be more than 0\n");
 		return -EINVAL;
@@ -550,6 +587,7 @@ iscsi_set_global_params(struct spdk_iscsi_opts *opts)
 	g_iscsi.chap_group = opts->chap_group;
 	g_iscsi.MaxLargeDataInPerConnection = opts->MaxLargeDataInPerConnection;
 	g_iscsi.MaxR2TPerConnection = opts->MaxR2TPerConnection;
+	g_iscsi.MaxLoginsPerPollGroup = opts->MaxLoginsPerPollGroup;
 	g_iscsi.pdu_pool_size = opts->pdu_pool_size;
 	g_iscsi.immediate_data_pool_size = opts->immediate_data_pool_size;
 	g_iscsi.data_out_pool_size = opts->data_out_pool_size;
@@ -966,7 +1004,8 @@ iscsi_poll_group_poll(void *ctx)
 	}
 
 	STAILQ_FOREACH_SAFE(conn, &group->connections, pg_link, tmp) {
-		if (conn->state == ISCSI_CONN_STATE_EXITING) {
+		if (conn->state == ISCSI_CONN_STATE_EXITING &&
+		    conn->pending_digest_ops == 0) {
 			iscsi_conn_destruct(conn);
 		}
 	}
@@ -993,9 +1032,14 @@ iscsi_poll_group_create(void *io_device, void *ctx_buf)
 	struct spdk_iscsi_poll_group *pg = ctx_buf;
 
 	STAILQ_INIT(&pg->connections);
+	STAILQ_INIT(&pg->pending_login_conns);
+	pg->num_login_conns = 0;
 	pg->sock_group = spdk_sock_group_create(NULL);
 	assert(pg->sock_group != NULL);
 
+	pg->accel_channel = spdk_accel_get_io_channel();
+	assert(pg->accel_channel != NULL);
+
 	pg->poller = SPDK_POLLER_REGISTER(iscsi_poll_group_poll, pg, 0);
 	/* set the period to 1 sec */
 	pg->nop_poller = SPDK_POLLER_REGISTER(iscsi_poll_group_handle_nop, pg, 1000000);
@@ -1013,6 +1057,7 @@ iscsi_poll_group_destroy(void *io_device, void *ctx_buf)
 	assert(pg->poller != NULL);
 	assert(pg->sock_group != NULL);
 
+	spdk_put_io_channel(pg->accel_channel);
 	spdk_sock_group_close(&pg->sock_group);
 	spdk_poller_unregister(&pg->poller);
 	spdk_poller_unregister(&pg->nop_poller);
@@ -1255,6 +1300,8 @@ iscsi_opts_info_json(struct spdk_json_write_ctx *w)
 				     g_iscsi.MaxLargeDataInPerConnection);
 	spdk_json_write_named_uint32(w, "max_r2t_per_connection",
 				     g_iscsi.MaxR2TPerConnection);
+	spdk_json_write_named_uint32(w, "max_logins_per_poll_group",
+				     g_iscsi.MaxLoginsPerPollGroup);
 
 	spdk_json_write_named_uint32(w, "pdu_pool_size", g_iscsi.pdu_pool_size);
 	spdk_json_write_named_uint32(w, "immediate_data_pool_size",
@@ -7,8 +7,82 @@
 
 #include "spdk_internal/utf.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define SPDK_JSON_MAX_NESTING_DEPTH	64
 
+/* Count the leading bytes that are plain string content: printable ASCII except the
+ * closing quote and backslash.  Such bytes need no unescaping or UTF-8 validation and
+ * make up almost all string data, so scan for them 16 at a time when SSE2 is available.
+ */
+static size_t
+json_count_plain_string_chars(const uint8_t *p, const uint8_t *end)
+{
+	const uint8_t *start = p;
+#if defined(__SSE2__)
+	const __m128i ctrl = _mm_set1_epi8(0x1F);
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+
+	while (end - p >= 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i *)p);
+		/* The comparison is signed, so bytes >= 0x80 are excluded here as well */
+		__m128i plain = _mm_cmpgt_epi8(chunk, ctrl);
+		__m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+					       _mm_cmpeq_epi8(chunk, backslash));
+		int mask = _mm_movemask_epi8(_mm_andnot_si128(special, plain));
+
+		if (mask != 0xFFFF) {
+			return p - start + __builtin_ctz(~mask);
+		}
+
+		p += 16;
+	}
+#endif
+
+	while (p != end && *p > 0x1F && *p < 0x80 && *p != '"' && *p != '\\') {
+		p++;
+	}
+
+	return p - start;
+}
+
+/* Skip a run of JSON whitespace, 16 bytes at a time when SSE2 is available.
+ * Pretty-printed configs are dominated by indentation and newlines. */
+static uint8_t *
+json_skip_whitespace(uint8_t *p, uint8_t *end)
+{
+#if defined(__SSE2__)
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i tab = _mm_set1_epi8('\t');
+	const __m128i cr = _mm_set1_epi8('\r');
+	const __m128i lf = _mm_set1_epi8('\n');
+
+	while (end - p >= 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i *)p);
+		__m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+						       _mm_cmpeq_epi8(chunk, tab)),
+					  _mm_or_si128(_mm_cmpeq_epi8(chunk, cr),
+							  _mm_cmpeq_epi8(chunk, lf)));
+		int mask = _mm_movemask_epi8(ws);
+
+		if (mask != 0xFFFF) {
+			return p + __builtin_ctz(~mask);
+		}
+
+		p += 16;
+	}
+#endif
+
+	while (p != end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+		p++;
+	}
+
+	return p;
+}
+
 static int
 hex_value(uint8_t c)
 {
@@ -188,6 +262,18 @@ json_decode_string(uint8_t *str_start, uint8_t *buf_end, uint8_t **str_end, uint
 	}
 
 	while (str < buf_end) {
+		size_t plain = json_count_plain_string_chars(str, buf_end);
+
+		if (plain > 0) {
+			/* Copy the whole run of plain characters in one piece */
+			if (out != str && (flags & SPDK_JSON_PARSE_FLAG_DECODE_IN_PLACE)) {
+				memmove(out, str, plain);
+			}
+			out += plain;
+			str += plain;
+			continue;
+		}
+
 		if (str[0] == '"') {
 			/*
 			 * End of string.
@@ -452,7 +538,7 @@ spdk_json_parse(void *json, size_t size, struct spdk_json_val *values, size_t nu
 		case '\r':
 		case '\n':
 			/* Whitespace is allowed between any tokens. */
-			data++;
+			data = json_skip_whitespace(data, json_end);
 			break;
 
 		case 't':
@@ -601,15 +687,7 @@ spdk_json_parse(void *json, size_t size, struct spdk_json_val *values, size_t nu
 
 	if (state == STATE_END) {
 		/* Skip trailing whitespace */
-		while (data < json_end) {
-			uint8_t c = *data;
-
-			if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
-				data++;
-			} else {
-				break;
-			}
-		}
+		data = json_skip_whitespace(data, json_end);
 
 		/*
 		 * These asserts are just for sanity checking - they are guaranteed by the allowed
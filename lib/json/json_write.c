@@ -7,6 +7,10 @@
 
 #include "spdk_internal/utf.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 struct spdk_json_write_ctx {
 	spdk_json_write_cb write_cb;
 	void *cb_ctx;
@@ -65,6 +69,16 @@ spdk_json_write_begin(spdk_json_write_cb write_cb, void *cb_ctx, uint32_t flags)
 	return w;
 }
 
+int
+spdk_json_write_flush(struct spdk_json_write_ctx *w)
+{
+	if (w->failed) {
+		return -1;
+	}
+
+	return flush_buf(w);
+}
+
 int
 spdk_json_write_end(struct spdk_json_write_ctx *w)
 {
@@ -189,6 +203,52 @@ spdk_json_write_bool(struct spdk_json_write_ctx *w, bool val)
 	}
 }
 
+static const char g_two_digits[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+/* Format val as decimal into buf (no NULL terminator), returning the number of characters
+ * written.  Stats RPCs emit enough numbers that snprintf overhead is measurable, so the
+ * digits are produced two at a time from a lookup table instead.
+ */
+static int
+format_uint64(char *buf, uint64_t val)
+{
+	char tmp[20];
+	int pos = sizeof(tmp);
+
+	while (val >= 100) {
+		pos -= 2;
+		memcpy(&tmp[pos], &g_two_digits[(val % 100) * 2], 2);
+		val /= 100;
+	}
+
+	if (val >= 10) {
+		pos -= 2;
+		memcpy(&tmp[pos], &g_two_digits[val * 2], 2);
+	} else {
+		tmp[--pos] = '0' + val;
+	}
+
+	memcpy(buf, &tmp[pos], sizeof(tmp) - pos);
+	return sizeof(tmp) - pos;
+}
+
+static int
+format_int64(char *buf, int64_t val)
+{
+	if (val < 0) {
+		buf[0] = '-';
+		/* Avoid negating INT64_MIN, which has no int64_t representation */
+		return 1 + format_uint64(buf + 1, (uint64_t)(-(val + 1)) + 1);
+	}
+
+	return format_uint64(buf, val);
+}
+
 int
 spdk_json_write_uint8(struct spdk_json_write_ctx *w, uint8_t val)
 {
@@ -196,8 +256,7 @@ spdk_json_write_uint8(struct spdk_json_write_ctx *w, uint8_t val)
 	int count;
 
 	if (begin_value(w)) { return fail(w); }
-	count = snprintf(buf, sizeof(buf), "%" PRIu8, val);
-	if (count <= 0 || (size_t)count >= sizeof(buf)) { return fail(w); }
+	count = format_uint64(buf, val);
 	return emit(w, buf, count);
 }
 
@@ -208,8 +267,7 @@ spdk_json_write_uint16(struct spdk_json_write_ctx *w, uint16_t val)
 	int count;
 
 	if (begin_value(w)) { return fail(w); }
-	count = snprintf(buf, sizeof(buf), "%" PRIu16, val);
-	if (count <= 0 || (size_t)count >= sizeof(buf)) { return fail(w); }
+	count = format_uint64(buf, val);
 	return emit(w, buf, count);
 }
 
@@ -220,8 +278,7 @@ spdk_json_write_int32(struct spdk_json_write_ctx *w, int32_t val)
 	int count;
 
 	if (begin_value(w)) { return fail(w); }
-	count = snprintf(buf, sizeof(buf), "%" PRId32, val);
-	if (count <= 0 || (size_t)count >= sizeof(buf)) { return fail(w); }
+	count = format_int64(buf, val);
 	return emit(w, buf, count);
 }
 
@@ -232,8 +289,7 @@ spdk_json_write_uint32(struct spdk_json_write_ctx *w, uint32_t val)
 	int count;
 
 	if (begin_value(w)) { return fail(w); }
-	count = snprintf(buf, sizeof(buf), "%" PRIu32, val);
-	if (count <= 0 || (size_t)count >= sizeof(buf)) { return fail(w); }
+	count = format_uint64(buf, val);
 	return emit(w, buf, count);
 }
 
@@ -244,8 +300,7 @@ spdk_json_write_int64(struct spdk_json_write_ctx *w, int64_t val)
 	int count;
 
 	if (begin_value(w)) { return fail(w); }
-	count = snprintf(buf, sizeof(buf), "%" PRId64, val);
-	if (count <= 0 || (size_t)count >= sizeof(buf)) { return fail(w); }
+	count = format_int64(buf, val);
 	return emit(w, buf, count);
 }
 
@@ -256,8 +311,7 @@ spdk_json_write_uint64(struct spdk_json_write_ctx *w, uint64_t val)
 	int count;
 
 	if (begin_value(w)) { return fail(w); }
-	count = snprintf(buf, sizeof(buf), "%" PRIu64, val);
-	if (count <= 0 || (size_t)count >= sizeof(buf)) { return fail(w); }
+	count = format_uint64(buf, val);
 	return emit(w, buf, count);
 }
 
@@ -388,11 +442,50 @@ write_codepoint(struct spdk_json_write_ctx *w, uint32_t codepoint)
 	return emit(w, out, out_len);
 }
 
+/* Count the leading bytes that can be copied to the output verbatim: printable ASCII
+ * except '"' and '\'.  Strings emitted over RPC consist almost entirely of such bytes,
+ * so scan for them 16 at a time when SSE2 is available.
+ */
+static size_t
+count_plain_chars(const uint8_t *p, const uint8_t *end)
+{
+	const uint8_t *start = p;
+#if defined(__SSE2__)
+	const __m128i ctrl = _mm_set1_epi8(0x1F);
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i del = _mm_set1_epi8(0x7F);
+
+	while (end - p >= 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i *)p);
+		/* The comparison is signed, so bytes >= 0x80 are excluded here as well */
+		__m128i plain = _mm_cmpgt_epi8(chunk, ctrl);
+		__m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+					       _mm_or_si128(_mm_cmpeq_epi8(chunk, backslash),
+							       _mm_cmpeq_epi8(chunk, del)));
+		int mask = _mm_movemask_epi8(_mm_andnot_si128(special, plain));
+
+		if (mask != 0xFFFF) {
+			return p - start + __builtin_ctz(~mask);
+		}
+
+		p += 16;
+	}
+#endif
+
+	while (p != end && *p >= 0x20 && *p < 0x7F && *p != '"' && *p != '\\') {
+		p++;
+	}
+
+	return p - start;
+}
+
 static int
 write_string_or_name(struct spdk_json_write_ctx *w, const char *val, size_t len)
 {
 	const uint8_t *p = val;
 	const uint8_t *end = val + len;
+	size_t plain;
 
 	if (emit(w, "\"", 1)) { return fail(w); }
 
@@ -400,6 +493,14 @@ write_string_or_name(struct spdk_json_write_ctx *w, const char *val, size_t len)
 		int codepoint_len;
 		uint32_t codepoint;
 
+		/* Emit the run of characters that don't need to be escaped in one piece */
+		plain = count_plain_chars(p, end);
+		if (plain > 0) {
+			if (emit(w, p, plain)) { return fail(w); }
+			p += plain;
+			continue;
+		}
+
 		codepoint_len = utf8_valid(p, end);
 		switch (codepoint_len) {
 		case 1:
@@ -20,6 +20,19 @@
 #define SPDK_JSONRPC_MAX_VALUES		1024
 #define SPDK_JSONRPC_CLIENT_MAX_VALUES		8192
 
+/* Part of a response that was flushed to the connection before the whole
+ * response was serialized. */
+struct jsonrpc_send_chunk {
+	/* Number of bytes used in buf */
+	size_t len;
+
+	size_t offset;
+
+	STAILQ_ENTRY(jsonrpc_send_chunk) link;
+
+	uint8_t buf[];
+};
+
 struct spdk_jsonrpc_request {
 	struct spdk_jsonrpc_server_conn *conn;
 
@@ -37,9 +50,27 @@ struct spdk_jsonrpc_request {
 	uint8_t *recv_buffer;
 	struct spdk_json_val *values;
 	size_t values_cnt;
+	/* Allocated capacity of values[] (>= values_cnt) */
+	size_t values_alloc_cnt;
 
 	uint8_t *send_buf;
 
+	/* Flushed portions of the response waiting to be sent.  All fields below
+	 * (up to and including complete) are protected by conn->queue_lock, as
+	 * the response may be flushed and completed from a thread other than the
+	 * one polling the connection. */
+	STAILQ_HEAD(, jsonrpc_send_chunk) send_chunks;
+
+	/* Number of bytes sitting in send_chunks */
+	size_t chunks_len;
+
+	/* At least one chunk was flushed before the response was complete */
+	bool streaming;
+
+	/* Response fully serialized - send_buf holds the (remaining) tail and
+	 * the request can be freed once everything is sent. */
+	bool complete;
+
 	struct spdk_json_write_ctx *response;
 
 	STAILQ_ENTRY(spdk_jsonrpc_request) link;
@@ -62,6 +93,11 @@ struct spdk_jsonrpc_server_conn {
 
 	struct spdk_jsonrpc_request *send_request;
 
+	/* Values array recycled across requests on this connection to avoid
+	 * reallocating it for every parsed request. */
+	struct spdk_json_val *values_cache;
+	size_t values_cache_cnt;
+
 	spdk_jsonrpc_conn_closed_fn close_cb;
 	void *close_cb_ctx;
 
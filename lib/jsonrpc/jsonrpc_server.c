@@ -210,17 +210,27 @@ jsonrpc_parse_request(struct spdk_jsonrpc_server_conn *conn, const void *json, s
 
 	if (rc > 0 && rc <= SPDK_JSONRPC_MAX_VALUES) {
 		request->values_cnt = rc;
-		request->values = malloc(request->values_cnt * sizeof(request->values[0]));
-		if (request->values == NULL) {
-			SPDK_ERRLOG("Failed to allocate buffer for JSON values (%zu bytes)\n",
-				    request->values_cnt * sizeof(request->values[0]));
-			jsonrpc_free_request(request);
-			return -1;
+		if (conn->values_cache != NULL && conn->values_cache_cnt >= request->values_cnt) {
+			/* Reuse the array from a previous request on this connection */
+			request->values = conn->values_cache;
+			request->values_alloc_cnt = conn->values_cache_cnt;
+			conn->values_cache = NULL;
+			conn->values_cache_cnt = 0;
+		} else {
+			request->values_alloc_cnt = request->values_cnt;
+			request->values = malloc(request->values_alloc_cnt * sizeof(request->values[0]));
+			if (request->values == NULL) {
+				SPDK_ERRLOG("Failed to allocate buffer for JSON values (%zu bytes)\n",
+					    request->values_alloc_cnt * sizeof(request->values[0]));
+				jsonrpc_free_request(request);
+				return -1;
+			}
 		}
 	}
 
 	request->send_offset = 0;
 	request->send_len = 0;
+	STAILQ_INIT(&request->send_chunks);
 	request->send_buf_size = SPDK_JSONRPC_SEND_BUF_SIZE_INIT;
 	/* Add extra byte for the null terminator. */
 	request->send_buf = malloc(request->send_buf_size + 1);
@@ -322,6 +332,7 @@ jsonrpc_free_request(struct spdk_jsonrpc_request *request)
 {
 	struct spdk_jsonrpc_request *req;
 	struct spdk_jsonrpc_server_conn *conn;
+	struct jsonrpc_send_chunk *chunk;
 
 	if (!request) {
 		return;
@@ -341,8 +352,23 @@ jsonrpc_free_request(struct spdk_jsonrpc_request *request)
 				break;
 			}
 		}
+		/* Hand the values array back to the connection for the next request,
+		 * keeping the larger of the two.  Whatever is left in request->values
+		 * is freed below. */
+		if (request->values != NULL &&
+		    request->values_alloc_cnt > conn->values_cache_cnt) {
+			struct spdk_json_val *tmp = conn->values_cache;
+
+			conn->values_cache = request->values;
+			conn->values_cache_cnt = request->values_alloc_cnt;
+			request->values = tmp;
+		}
 		pthread_spin_unlock(&conn->queue_lock);
 	}
+	while ((chunk = STAILQ_FIRST(&request->send_chunks)) != NULL) {
+		STAILQ_REMOVE_HEAD(&request->send_chunks, link);
+		free(chunk);
+	}
 	free(request->recv_buffer);
 	free(request->values);
 	free(request->send_buf);
@@ -380,6 +406,61 @@ spdk_jsonrpc_end_result(struct spdk_jsonrpc_request *request, struct spdk_json_w
 	}
 }
 
+ssize_t
+spdk_jsonrpc_flush_result(struct spdk_jsonrpc_request *request, struct spdk_json_write_ctx *w)
+{
+	struct spdk_jsonrpc_server_conn *conn = request->conn;
+	struct jsonrpc_send_chunk *chunk;
+	ssize_t queued;
+
+	assert(w != NULL);
+	assert(w == request->response);
+
+	/* Push data buffered inside the write context into send_buf first. */
+	if (spdk_json_write_flush(w) != 0) {
+		return -EINVAL;
+	}
+
+	if (conn == NULL) {
+		/* The connection is closed - the response will never be sent. */
+		return -ENOTCONN;
+	}
+
+	/* Responses to requests without an ID are skipped, so there is nothing
+	 * to flush - discard the data to keep memory usage flat. */
+	if (request->id == NULL || request->id->type == SPDK_JSON_VAL_NULL) {
+		request->send_len = 0;
+		return 0;
+	}
+
+	if (request->send_len > 0) {
+		chunk = malloc(sizeof(*chunk) + request->send_len);
+		if (chunk == NULL) {
+			SPDK_ERRLOG("Failed to allocate response chunk (%zu bytes)\n",
+				    sizeof(*chunk) + request->send_len);
+			return -ENOMEM;
+		}
+
+		chunk->len = request->send_len;
+		chunk->offset = 0;
+		memcpy(chunk->buf, request->send_buf, chunk->len);
+		request->send_len = 0;
+	} else {
+		chunk = NULL;
+	}
+
+	pthread_spin_lock(&conn->queue_lock);
+	if (chunk != NULL) {
+		request->streaming = true;
+		STAILQ_INSERT_TAIL(&request->send_chunks, chunk, link);
+		request->chunks_len += chunk->len;
+	}
+	queued = request->chunks_len;
+	pthread_spin_unlock(&conn->queue_lock);
+
+	return queued;
+}
+
 void
 spdk_jsonrpc_send_bool_response(struct spdk_jsonrpc_request *request, bool value)
 {
@@ -82,6 +82,20 @@ static void
 jsonrpc_server_free_conn_request(struct spdk_jsonrpc_server_conn *conn)
 {
 	struct spdk_jsonrpc_request *request;
+	bool complete = true;
+
+	if (conn->send_request != NULL) {
+		pthread_spin_lock(&conn->queue_lock);
+		complete = conn->send_request->complete;
+		pthread_spin_unlock(&conn->queue_lock);
+	}
+
+	if (!complete) {
+		/* A streamed response that is still being generated is owned by its
+		 * handler and will be freed once the handler completes it and sees
+		 * that the connection is gone. */
+		conn->send_request = NULL;
+	}
 
 	jsonrpc_free_request(conn->send_request);
 	conn->send_request = NULL ;
@@ -124,6 +138,8 @@ spdk_jsonrpc_server_shutdown(struct spdk_jsonrpc_server *server)
 
 	TAILQ_FOREACH(conn, &server->conns, link) {
 		jsonrpc_server_conn_close(conn);
+		free(conn->values_cache);
+		conn->values_cache = NULL;
 	}
 
 	free(server);
@@ -139,6 +155,10 @@ jsonrpc_server_conn_remove(struct spdk_jsonrpc_server_conn *conn)
 	pthread_spin_destroy(&conn->queue_lock);
 	assert(STAILQ_EMPTY(&conn->send_queue));
 
+	free(conn->values_cache);
+	conn->values_cache = NULL;
+	conn->values_cache_cnt = 0;
+
 	TAILQ_REMOVE(&server->conns, conn, link);
 	TAILQ_INSERT_HEAD(&server->free_conns, conn, link);
 }
@@ -197,6 +217,8 @@ jsonrpc_server_accept(struct spdk_jsonrpc_server *server)
 		STAILQ_INIT(&conn->send_queue);
 		STAILQ_INIT(&conn->outstanding_queue);
 		conn->send_request = NULL;
+		conn->values_cache = NULL;
+		conn->values_cache_cnt = 0;
 
 		if (pthread_spin_init(&conn->queue_lock, PTHREAD_PROCESS_PRIVATE)) {
 			SPDK_ERRLOG("Unable to create queue lock for socket: %d", conn->sockfd);
@@ -327,16 +349,47 @@ jsonrpc_server_send_response(struct spdk_jsonrpc_request *request)
 
 	/* Queue the response to be sent */
 	pthread_spin_lock(&conn->queue_lock);
+	request->complete = true;
 	STAILQ_REMOVE(&conn->outstanding_queue, request, spdk_jsonrpc_request, link);
-	STAILQ_INSERT_TAIL(&conn->send_queue, request, link);
+	if (conn->send_request != request) {
+		STAILQ_INSERT_TAIL(&conn->send_queue, request, link);
+	}
+	/* else: a streamed response that already owns the socket - the poll
+	 * thread finishes it once the remaining data is sent. */
 	pthread_spin_unlock(&conn->queue_lock);
 }
 
 
+static void
+jsonrpc_server_pick_send_request(struct spdk_jsonrpc_server_conn *conn)
+{
+	struct spdk_jsonrpc_request *request;
+
+	pthread_spin_lock(&conn->queue_lock);
+	request = STAILQ_FIRST(&conn->send_queue);
+	if (request != NULL) {
+		STAILQ_REMOVE_HEAD(&conn->send_queue, link);
+	} else {
+		/* No complete responses are waiting - check for a streamed response
+		 * that has flushed some chunks before being finished.  It takes over
+		 * the socket until it is completed, so that its data can flow to the
+		 * client while the rest of it is still being generated. */
+		STAILQ_FOREACH(request, &conn->outstanding_queue, link) {
+			if (request->streaming) {
+				break;
+			}
+		}
+	}
+	conn->send_request = request;
+	pthread_spin_unlock(&conn->queue_lock);
+}
+
 static int
 jsonrpc_server_conn_send(struct spdk_jsonrpc_server_conn *conn)
 {
 	struct spdk_jsonrpc_request *request;
+	struct jsonrpc_send_chunk *chunk, *next;
+	bool complete;
 	ssize_t rc;
 
 more:
@@ -345,7 +398,7 @@ more:
 	}
 
 	if (conn->send_request == NULL) {
-		conn->send_request = jsonrpc_server_dequeue_request(conn);
+		jsonrpc_server_pick_send_request(conn);
 	}
 
 	request = conn->send_request;
@@ -354,6 +407,49 @@ more:
 		return 0;
 	}
 
+	/* Send any chunks flushed while the response was being generated.  A chunk
+	 * is never touched by the generating thread once it has been queued. */
+	pthread_spin_lock(&conn->queue_lock);
+	chunk = STAILQ_FIRST(&request->send_chunks);
+	complete = request->complete;
+	pthread_spin_unlock(&conn->queue_lock);
+
+	while (chunk != NULL) {
+		rc = send(conn->sockfd, chunk->buf + chunk->offset,
+			  chunk->len - chunk->offset, 0);
+		if (rc < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+				return 0;
+			}
+
+			SPDK_DEBUGLOG(rpc, "send() failed: %s\n", spdk_strerror(errno));
+			return -1;
+		}
+
+		chunk->offset += rc;
+		if (chunk->offset < chunk->len) {
+			return 0;
+		}
+
+		pthread_spin_lock(&conn->queue_lock);
+		STAILQ_REMOVE_HEAD(&request->send_chunks, link);
+		request->chunks_len -= chunk->len;
+		next = STAILQ_FIRST(&request->send_chunks);
+		complete = request->complete;
+		pthread_spin_unlock(&conn->queue_lock);
+
+		free(chunk);
+		chunk = next;
+	}
+
+	if (!complete) {
+		/* The rest of a streamed response is still being generated.  Keep
+		 * ownership of the socket so that no other response can interleave
+		 * with it, but do not touch send_buf - the generating thread still
+		 * owns it. */
+		return 0;
+	}
+
 	if (request->send_offset == 0) {
 		/* A byte for the null terminator is included in the send buffer. */
 		request->send_buf[request->send_len] = '\0';
@@ -380,7 +476,9 @@ more:
 		 * Full response has been sent.
 		 * Free it and set send_request to NULL to move on to the next queued response.
 		 */
+		pthread_spin_lock(&conn->queue_lock);
 		conn->send_request = NULL;
+		pthread_spin_unlock(&conn->queue_lock);
 		jsonrpc_complete_request(request);
 		goto more;
 	}
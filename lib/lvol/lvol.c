@@ -197,43 +197,39 @@ bs_unload_with_error_cb(void *cb_arg, int lvolerrno)
 }
 
 static void
-load_next_lvol(void *cb_arg, struct spdk_blob *blob, int lvolerrno)
+lvs_free_lvols(struct spdk_lvol_store *lvs)
+{
+	struct spdk_lvol *lvol, *tmp;
+
+	TAILQ_FOREACH_SAFE(lvol, &lvs->lvols, link, tmp) {
+		TAILQ_REMOVE(&lvs->lvols, lvol, link);
+		lvol_free(lvol);
+	}
+}
+
+/*
+ * Called by the blobstore for every blob it opens during its own load-time
+ * iteration. Harvesting the lvol metadata here avoids a second serialized
+ * open/close pass over all blobs after the blobstore load completes.
+ */
+static void
+lvs_load_iter_cb(void *cb_arg, struct spdk_blob *blob, int lvolerrno)
 {
 	struct spdk_lvs_with_handle_req *req = cb_arg;
 	struct spdk_lvol_store *lvs = req->lvol_store;
-	struct spdk_blob_store *bs = lvs->blobstore;
-	struct spdk_lvol *lvol, *tmp;
-	spdk_blob_id blob_id;
+	struct spdk_lvol *lvol;
 	const char *attr;
 	size_t value_len;
 	int rc;
 
-	if (lvolerrno == -ENOENT) {
-		/* Finished iterating */
-		if (req->lvserrno == 0) {
-			lvs->load_esnaps = true;
-			req->cb_fn(req->cb_arg, lvs, req->lvserrno);
-			free(req);
-		} else {
-			TAILQ_FOREACH_SAFE(lvol, &lvs->lvols, link, tmp) {
-				TAILQ_REMOVE(&lvs->lvols, lvol, link);
-				lvol_free(lvol);
-			}
-			lvs_free(lvs);
-			spdk_bs_unload(bs, bs_unload_with_error_cb, req);
-		}
+	if (req->lvserrno != 0) {
+		/* An earlier blob already failed to load, just drain the iteration. */
 		return;
-	} else if (lvolerrno < 0) {
-		SPDK_ERRLOG("Failed to fetch blobs list\n");
-		req->lvserrno = lvolerrno;
-		goto invalid;
 	}
 
-	blob_id = spdk_blob_get_id(blob);
-
-	if (blob_id == lvs->super_blob_id) {
-		SPDK_INFOLOG(lvol, "found superblob %"PRIu64"\n", (uint64_t)blob_id);
-		spdk_bs_iter_next(bs, blob, load_next_lvol, req);
+	if (lvolerrno < 0) {
+		SPDK_ERRLOG("Failed to fetch blobs list\n");
+		req->lvserrno = lvolerrno;
 		return;
 	}
 
@@ -241,14 +237,14 @@ load_next_lvol(void *cb_arg, struct spdk_blob *blob, int lvolerrno)
 	if (!lvol) {
 		SPDK_ERRLOG("Cannot alloc memory for lvol base pointer\n");
 		req->lvserrno = -ENOMEM;
-		goto invalid;
+		return;
 	}
 
 	/*
-	 * Do not store a reference to blob now because spdk_bs_iter_next() will close it.
-	 * Storing blob_id for future lookups is fine.
+	 * Do not store a reference to blob now because the blobstore will close it
+	 * when it advances to the next blob. Storing blob_id for future lookups is fine.
 	 */
-	lvol->blob_id = blob_id;
+	lvol->blob_id = spdk_blob_get_id(blob);
 	lvol->lvol_store = lvs;
 
 	rc = spdk_blob_get_xattr_value(blob, "uuid", (const void **)&attr, &value_len);
@@ -259,13 +255,12 @@ load_next_lvol(void *cb_arg, struct spdk_blob *blob, int lvolerrno)
 	}
 	spdk_uuid_fmt_lower(lvol->uuid_str, sizeof(lvol->uuid_str), &lvol->uuid);
 
+	/*
+	 * unique_id for lvols without a uuid is derived from the lvolstore uuid, which
+	 * is not known until the super blob is read - it is filled in close_super_cb().
+	 */
 	if (!spdk_uuid_is_null(&lvol->uuid)) {
 		snprintf(lvol->unique_id, sizeof(lvol->unique_id), "%s", lvol->uuid_str);
-	} else {
-		spdk_uuid_fmt_lower(lvol->unique_id, sizeof(lvol->unique_id), &lvol->lvol_store->uuid);
-		value_len = strlen(lvol->unique_id);
-		snprintf(lvol->unique_id + value_len, sizeof(lvol->unique_id) - value_len, "_%"PRIu64,
-			 (uint64_t)blob_id);
 	}
 
 	rc = spdk_blob_get_xattr_value(blob, "name", (const void **)&attr, &value_len);
@@ -273,7 +268,7 @@ load_next_lvol(void *cb_arg, struct spdk_blob *blob, int lvolerrno)
 		SPDK_ERRLOG("Cannot assign lvol name\n");
 		lvol_free(lvol);
 		req->lvserrno = -EINVAL;
-		goto invalid;
+		return;
 	}
 
 	snprintf(lvol->name, sizeof(lvol->name), "%s", attr);
@@ -283,9 +278,6 @@ load_next_lvol(void *cb_arg, struct spdk_blob *blob, int lvolerrno)
 	lvs->lvol_count++;
 
 	SPDK_INFOLOG(lvol, "added lvol %s (%s)\n", lvol->unique_id, lvol->uuid_str);
-
-invalid:
-	spdk_bs_iter_next(bs, blob, load_next_lvol, req);
 }
 
 static void
@@ -294,17 +286,50 @@ close_super_cb(void *cb_arg, int lvolerrno)
 	struct spdk_lvs_with_handle_req *req = (struct spdk_lvs_with_handle_req *)cb_arg;
 	struct spdk_lvol_store *lvs = req->lvol_store;
 	struct spdk_blob_store *bs = lvs->blobstore;
+	struct spdk_lvol *lvol, *tmp;
+	size_t len;
 
 	if (lvolerrno != 0) {
 		SPDK_INFOLOG(lvol, "Could not close super blob\n");
+		lvs_free_lvols(lvs);
 		lvs_free(lvs);
 		req->lvserrno = -ENODEV;
 		spdk_bs_unload(bs, bs_unload_with_error_cb, req);
 		return;
 	}
 
-	/* Start loading lvols */
-	spdk_bs_iter_first(lvs->blobstore, load_next_lvol, req);
+	if (req->lvserrno != 0) {
+		lvs_free_lvols(lvs);
+		lvs_free(lvs);
+		spdk_bs_unload(bs, bs_unload_with_error_cb, req);
+		return;
+	}
+
+	/*
+	 * The lvols were collected by lvs_load_iter_cb() before the super blob id
+	 * was known, so the super blob shows up in the list - drop it and fill in
+	 * the deferred unique_ids now that the lvolstore uuid has been read.
+	 */
+	TAILQ_FOREACH_SAFE(lvol, &lvs->lvols, link, tmp) {
+		if (lvol->blob_id == lvs->super_blob_id) {
+			SPDK_INFOLOG(lvol, "found superblob %"PRIu64"\n", (uint64_t)lvol->blob_id);
+			TAILQ_REMOVE(&lvs->lvols, lvol, link);
+			lvs->lvol_count--;
+			lvol_free(lvol);
+			continue;
+		}
+
+		if (spdk_uuid_is_null(&lvol->uuid)) {
+			spdk_uuid_fmt_lower(lvol->unique_id, sizeof(lvol->unique_id), &lvs->uuid);
+			len = strlen(lvol->unique_id);
+			snprintf(lvol->unique_id + len, sizeof(lvol->unique_id) - len, "_%"PRIu64,
+				 (uint64_t)lvol->blob_id);
+		}
+	}
+
+	lvs->load_esnaps = true;
+	req->cb_fn(req->cb_arg, lvs, 0);
+	free(req);
 }
 
 static void
@@ -314,6 +339,7 @@ close_super_blob_with_error_cb(void *cb_arg, int lvolerrno)
 	struct spdk_lvol_store *lvs = req->lvol_store;
 	struct spdk_blob_store *bs = lvs->blobstore;
 
+	lvs_free_lvols(lvs);
 	lvs_free(lvs);
 
 	spdk_bs_unload(bs, bs_unload_with_error_cb, req);
@@ -384,6 +410,7 @@ lvs_open_super(void *cb_arg, spdk_blob_id blobid, int lvolerrno)
 
 	if (lvolerrno != 0) {
 		SPDK_INFOLOG(lvol, "Super blob not found\n");
+		lvs_free_lvols(lvs);
 		lvs_free(lvs);
 		req->lvserrno = -ENODEV;
 		spdk_bs_unload(bs, bs_unload_with_error_cb, req);
@@ -401,6 +428,7 @@ lvs_load_cb(void *cb_arg, struct spdk_blob_store *bs, int lvolerrno)
 
 	if (lvolerrno != 0) {
 		req->cb_fn(req->cb_arg, NULL, lvolerrno);
+		lvs_free_lvols(lvs);
 		lvs_free(lvs);
 		free(req);
 		return;
@@ -464,6 +492,8 @@ lvs_load(struct spdk_bs_dev *bs_dev, const struct spdk_lvs_opts *_lvs_opts,
 
 	lvs_bs_opts_init(&bs_opts);
 	snprintf(bs_opts.bstype.bstype, sizeof(bs_opts.bstype.bstype), "LVOLSTORE");
+	bs_opts.iter_cb_fn = lvs_load_iter_cb;
+	bs_opts.iter_cb_arg = req;
 
 	if (lvs_opts.esnap_bs_dev_create != NULL) {
 		req->lvol_store->esnap_bs_dev_create = lvs_opts.esnap_bs_dev_create;
@@ -1414,6 +1444,193 @@ spdk_lvol_create_clone(struct spdk_lvol *origlvol, const char *clone_name,
 			     req);
 }
 
+static void
+lvol_bulk_clone_free_req(struct spdk_lvol_bulk_clone_req *req)
+{
+	free(req->blob_ids);
+	free(req->xattrs);
+	free(req);
+}
+
+static void
+lvol_bulk_clone_delete_cb(void *cb_arg, int lvolerrno)
+{
+	struct spdk_lvol_bulk_clone_req *req = cb_arg;
+
+	req->cb_fn(req->cb_arg, req->lvolerrno);
+	lvol_bulk_clone_free_req(req);
+}
+
+static void lvol_bulk_clone_open_next(struct spdk_lvol_bulk_clone_req *req);
+
+static void
+lvol_bulk_clone_open_cb(void *cb_arg, struct spdk_blob *blob, int lvolerrno)
+{
+	struct spdk_lvol_bulk_clone_req *req = cb_arg;
+	struct spdk_lvol *lvol = req->lvols[req->opened];
+
+	TAILQ_REMOVE(&req->lvs->pending_lvols, lvol, link);
+
+	if (lvolerrno < 0) {
+		lvol_free(lvol);
+		req->lvols[req->opened] = NULL;
+		if (req->lvolerrno == 0) {
+			req->lvolerrno = lvolerrno;
+		}
+	} else {
+		lvol->blob = blob;
+		lvol->blob_id = spdk_blob_get_id(blob);
+		TAILQ_INSERT_TAIL(&req->lvs->lvols, lvol, link);
+		lvol->ref_count++;
+	}
+
+	req->opened++;
+	lvol_bulk_clone_open_next(req);
+}
+
+static void
+lvol_bulk_clone_open_next(struct spdk_lvol_bulk_clone_req *req)
+{
+	struct spdk_blob_open_opts opts;
+	struct spdk_lvol *lvol;
+
+	if (req->opened == req->count) {
+		req->cb_fn(req->cb_arg, req->lvolerrno);
+		lvol_bulk_clone_free_req(req);
+		return;
+	}
+
+	lvol = req->lvols[req->opened];
+	spdk_blob_open_opts_init(&opts, sizeof(opts));
+	opts.clear_method = lvol->clear_method;
+	opts.esnap_ctx = lvol;
+
+	spdk_bs_open_blob_ext(req->lvs->blobstore, req->blob_ids[req->opened], &opts,
+			      lvol_bulk_clone_open_cb, req);
+}
+
+static void
+lvol_bulk_clone_blobs_cb(void *cb_arg, int lvolerrno)
+{
+	struct spdk_lvol_bulk_clone_req *req = cb_arg;
+	struct spdk_lvol *lvol;
+	size_t i, created = 0;
+
+	if (lvolerrno < 0) {
+		req->lvolerrno = lvolerrno;
+
+		for (i = 0; i < req->count; i++) {
+			lvol = req->lvols[i];
+			TAILQ_REMOVE(&req->lvs->pending_lvols, lvol, link);
+			lvol_free(lvol);
+			req->lvols[i] = NULL;
+		}
+
+		/* No lvols were bound to the created blobs yet, so compact their
+		 * ids and delete them instead of leaving stray clones behind. */
+		for (i = 0; i < req->count; i++) {
+			if (req->blob_ids[i] != SPDK_BLOBID_INVALID) {
+				req->blob_ids[created++] = req->blob_ids[i];
+			}
+		}
+		if (created > 0) {
+			spdk_bs_delete_blobs(req->lvs->blobstore, req->blob_ids, created,
+					     lvol_bulk_clone_delete_cb, req);
+			return;
+		}
+
+		lvol_bulk_clone_delete_cb(req, 0);
+		return;
+	}
+
+	lvol_bulk_clone_open_next(req);
+}
+
+void
+spdk_lvol_create_clone_bulk(struct spdk_lvol *origlvol, const char **clone_names,
+			    size_t count, struct spdk_lvol **lvols,
+			    spdk_lvol_op_complete cb_fn, void *cb_arg)
+{
+	struct spdk_lvol_bulk_clone_req *req;
+	struct spdk_lvol_store *lvs;
+	struct spdk_lvol *newlvol;
+	size_t i;
+	int rc;
+
+	if (origlvol == NULL) {
+		SPDK_INFOLOG(lvol, "Lvol not provided.\n");
+		cb_fn(cb_arg, -EINVAL);
+		return;
+	}
+
+	lvs = origlvol->lvol_store;
+	if (lvs == NULL) {
+		SPDK_ERRLOG("lvol store does not exist\n");
+		cb_fn(cb_arg, -EINVAL);
+		return;
+	}
+
+	if (count == 0) {
+		cb_fn(cb_arg, 0);
+		return;
+	}
+
+	req = calloc(1, sizeof(*req));
+	if (req == NULL) {
+		SPDK_ERRLOG("Cannot alloc memory for lvol request pointer\n");
+		cb_fn(cb_arg, -ENOMEM);
+		return;
+	}
+
+	req->blob_ids = calloc(count, sizeof(*req->blob_ids));
+	req->xattrs = calloc(count, sizeof(*req->xattrs));
+	if (req->blob_ids == NULL || req->xattrs == NULL) {
+		SPDK_ERRLOG("Cannot alloc memory for bulk clone request\n");
+		lvol_bulk_clone_free_req(req);
+		cb_fn(cb_arg, -ENOMEM);
+		return;
+	}
+
+	req->cb_fn = cb_fn;
+	req->cb_arg = cb_arg;
+	req->lvs = lvs;
+	req->count = count;
+	req->lvols = lvols;
+	req->xattr_names[0] = LVOL_NAME;
+	req->xattr_names[1] = "uuid";
+
+	for (i = 0; i < count; i++) {
+		rc = lvs_verify_lvol_name(lvs, clone_names[i]);
+		if (rc == 0) {
+			newlvol = lvol_alloc(lvs, clone_names[i], true,
+					     (enum lvol_clear_method)origlvol->clear_method);
+			if (newlvol == NULL) {
+				SPDK_ERRLOG("Cannot alloc memory for lvol base pointer\n");
+				rc = -ENOMEM;
+			}
+		}
+		if (rc != 0) {
+			while (i-- > 0) {
+				TAILQ_REMOVE(&lvs->pending_lvols, lvols[i], link);
+				lvol_free(lvols[i]);
+				lvols[i] = NULL;
+			}
+			lvol_bulk_clone_free_req(req);
+			cb_fn(cb_arg, rc);
+			return;
+		}
+		lvols[i] = newlvol;
+		req->xattrs[i].count = SPDK_COUNTOF(req->xattr_names);
+		req->xattrs[i].names = req->xattr_names;
+		req->xattrs[i].ctx = newlvol;
+		req->xattrs[i].get_value = lvol_get_xattr_value;
+	}
+
+	spdk_bs_create_clones(lvs->blobstore, spdk_blob_get_id(origlvol->blob),
+			      req->xattrs, count, req->blob_ids,
+			      lvol_bulk_clone_blobs_cb, req);
+}
+
 static void
 lvol_resize_done(void *cb_arg, int lvolerrno)
 {
@@ -1603,6 +1820,127 @@ spdk_lvol_destroy(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_
 	spdk_bs_delete_blob(bs, lvol->blob_id, lvol_delete_blob_cb, req);
 }
 
+static void
+lvol_bulk_delete_blobs_cb(void *cb_arg, int lvolerrno)
+{
+	struct spdk_lvol_bulk_destroy_req *req = cb_arg;
+	struct spdk_lvol *lvol, *clone_lvol;
+	size_t i;
+
+	if (lvolerrno < 0) {
+		SPDK_ERRLOG("Could not remove all blobs on bulk lvol destroy - forced removal\n");
+	}
+
+	for (i = 0; i < req->count; i++) {
+		lvol = req->lvols[i];
+		clone_lvol = req->clone_lvols[i];
+
+		if (lvol->degraded_set != NULL) {
+			if (clone_lvol != NULL && !clone_lvol->action_in_progress) {
+				/*
+				 * A degraded esnap clone that has a blob clone has been deleted.
+				 * clone_lvol becomes an esnap clone and needs to be associated
+				 * with the spdk_lvs_degraded_lvol_set.  A clone that is part of
+				 * the same batch is about to go away and is left alone.
+				 */
+				struct spdk_lvs_degraded_lvol_set *degraded_set = lvol->degraded_set;
+
+				lvs_degraded_lvol_set_remove(degraded_set, lvol);
+				lvs_degraded_lvol_set_add(degraded_set, clone_lvol);
+			} else {
+				spdk_lvs_esnap_missing_remove(lvol);
+			}
+		}
+
+		SPDK_INFOLOG(lvol, "Lvol %s deleted\n", lvol->unique_id);
+		TAILQ_REMOVE(&lvol->lvol_store->lvols, lvol, link);
+		lvol_free(lvol);
+	}
+
+	req->cb_fn(req->cb_arg, lvolerrno);
+	free(req->lvols);
+	free(req->clone_lvols);
+	free(req->blob_ids);
+	free(req);
+}
+
+void
+spdk_lvol_destroy_bulk(struct spdk_lvol **lvols, size_t count,
+		       spdk_lvol_op_complete cb_fn, void *cb_arg)
+{
+	struct spdk_lvol_bulk_destroy_req *req;
+	struct spdk_lvol_store *lvs;
+	spdk_blob_id clone_id;
+	size_t i, clone_count;
+	int rc;
+
+	assert(cb_fn != NULL);
+
+	if (count == 0) {
+		cb_fn(cb_arg, 0);
+		return;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (lvols[i] == NULL) {
+			SPDK_ERRLOG("lvol does not exist\n");
+			cb_fn(cb_arg, -ENODEV);
+			return;
+		}
+		if (lvols[i]->ref_count != 0) {
+			SPDK_ERRLOG("Cannot destroy lvol %s because it is still open\n",
+				    lvols[i]->unique_id);
+			cb_fn(cb_arg, -EBUSY);
+			return;
+		}
+		if (lvols[i]->lvol_store != lvols[0]->lvol_store) {
+			SPDK_ERRLOG("Cannot destroy lvols of different lvol stores in one batch\n");
+			cb_fn(cb_arg, -EINVAL);
+			return;
+		}
+	}
+
+	req = calloc(1, sizeof(*req));
+	if (req == NULL) {
+		SPDK_ERRLOG("Cannot alloc memory for lvol request pointer\n");
+		cb_fn(cb_arg, -ENOMEM);
+		return;
+	}
+
+	req->lvols = calloc(count, sizeof(*req->lvols));
+	req->clone_lvols = calloc(count, sizeof(*req->clone_lvols));
+	req->blob_ids = calloc(count, sizeof(*req->blob_ids));
+	if (req->lvols == NULL || req->clone_lvols == NULL || req->blob_ids == NULL) {
+		SPDK_ERRLOG("Cannot alloc memory for lvol request pointer\n");
+		free(req->lvols);
+		free(req->clone_lvols);
+		free(req->blob_ids);
+		free(req);
+		cb_fn(cb_arg, -ENOMEM);
+		return;
+	}
+
+	lvs = lvols[0]->lvol_store;
+	for (i = 0; i < count; i++) {
+		req->lvols[i] = lvols[i];
+		req->blob_ids[i] = lvols[i]->blob_id;
+
+		clone_count = 1;
+		rc = spdk_blob_get_clones(lvs->blobstore, lvols[i]->blob_id, &clone_id, &clone_count);
+		if (rc == 0 && clone_count == 1) {
+			req->clone_lvols[i] = lvs_get_lvol_by_blob_id(lvs, clone_id);
+		}
+
+		lvols[i]->action_in_progress = true;
+	}
+
+	req->count = count;
+	req->cb_fn = cb_fn;
+	req->cb_arg = cb_arg;
+
+	spdk_bs_delete_blobs(lvs->blobstore, req->blob_ids, count, lvol_bulk_delete_blobs_cb, req);
+}
+
 void
 spdk_lvol_close(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_arg)
 {
@@ -1662,8 +2000,9 @@ lvol_inflate_cb(void *cb_arg, int lvolerrno)
 	free(req);
 }
 
-void
-spdk_lvol_inflate(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_arg)
+static void
+lvol_inflate_common(struct spdk_lvol *lvol, bool allocate_all, uint32_t max_in_flight,
+		    spdk_lvol_op_complete cb_fn, void *cb_arg)
 {
 	struct spdk_lvol_req *req;
 	spdk_blob_id blob_id;
@@ -1694,44 +2033,39 @@ spdk_lvol_inflate(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_
 	}
 
 	blob_id = spdk_blob_get_id(lvol->blob);
-	spdk_bs_inflate_blob(lvol->lvol_store->blobstore, req->channel, blob_id, lvol_inflate_cb,
-			     req);
+	if (allocate_all) {
+		spdk_bs_inflate_blob_ext(lvol->lvol_store->blobstore, req->channel, blob_id,
+					 max_in_flight, lvol_inflate_cb, req);
+	} else {
+		spdk_bs_blob_decouple_parent_ext(lvol->lvol_store->blobstore, req->channel, blob_id,
+						 max_in_flight, lvol_inflate_cb, req);
+	}
 }
 
 void
-spdk_lvol_decouple_parent(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_arg)
+spdk_lvol_inflate(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_arg)
 {
-	struct spdk_lvol_req *req;
-	spdk_blob_id blob_id;
-
-	assert(cb_fn != NULL);
-
-	if (lvol == NULL) {
-		SPDK_ERRLOG("Lvol does not exist\n");
-		cb_fn(cb_arg, -ENODEV);
-		return;
-	}
+	lvol_inflate_common(lvol, true, 0, cb_fn, cb_arg);
+}
 
-	req = calloc(1, sizeof(*req));
-	if (!req) {
-		SPDK_ERRLOG("Cannot alloc memory for lvol request pointer\n");
-		cb_fn(cb_arg, -ENOMEM);
-		return;
-	}
+void
+spdk_lvol_inflate_ext(struct spdk_lvol *lvol, uint32_t max_in_flight,
+		      spdk_lvol_op_complete cb_fn, void *cb_arg)
+{
+	lvol_inflate_common(lvol, true, max_in_flight, cb_fn, cb_arg);
+}
 
-	req->cb_fn = cb_fn;
-	req->cb_arg = cb_arg;
-	req->channel = spdk_bs_alloc_io_channel(lvol->lvol_store->blobstore);
-	if (req->channel == NULL) {
-		SPDK_ERRLOG("Cannot alloc io channel for lvol inflate request\n");
-		free(req);
-		cb_fn(cb_arg, -ENOMEM);
-		return;
-	}
+void
+spdk_lvol_decouple_parent(struct spdk_lvol *lvol, spdk_lvol_op_complete cb_fn, void *cb_arg)
+{
+	lvol_inflate_common(lvol, false, 0, cb_fn, cb_arg);
+}
 
-	blob_id = spdk_blob_get_id(lvol->blob);
-	spdk_bs_blob_decouple_parent(lvol->lvol_store->blobstore, req->channel, blob_id,
-				     lvol_inflate_cb, req);
+void
+spdk_lvol_decouple_parent_ext(struct spdk_lvol *lvol, uint32_t max_in_flight,
+			      spdk_lvol_op_complete cb_fn, void *cb_arg)
+{
+	lvol_inflate_common(lvol, false, max_in_flight, cb_fn, cb_arg);
 }
 
 static void
@@ -1801,6 +2135,8 @@ spdk_lvs_grow(struct spdk_bs_dev *bs_dev, spdk_lvs_op_with_handle_complete cb_fn
 
 	lvs_bs_opts_init(&opts);
 	snprintf(opts.bstype.bstype, sizeof(opts.bstype.bstype), "LVOLSTORE");
+	opts.iter_cb_fn = lvs_load_iter_cb;
+	opts.iter_cb_arg = req;
 
 	spdk_bs_grow(bs_dev, &opts, lvs_load_cb, req);
 }
@@ -209,6 +209,38 @@ nvme_auth_get_seqnum(struct spdk_nvme_qpair *qpair)
 	return seqnum;
 }
 
+/*
+ * Generating the ephemeral DH key pair is by far the most expensive part of a
+ * DH-HMAC-CHAP transaction, so a single key pair is shared by all of the
+ * controller's qpairs and regenerated only once it expires or the controller
+ * switches to a different DH group.  This amortizes the DH math over a
+ * reconnect storm, where thousands of qpairs authenticate back-to-back.  Each
+ * exchange still mixes in fresh challenges from both sides, so responses and
+ * session keys remain unique across qpairs.  The caller must hold ctrlr_lock
+ * for the whole time it uses the returned key.
+ */
+#define NVME_AUTH_DHKEY_TTL_S 30
+
+static struct spdk_nvme_dhchap_dhkey *
+nvme_auth_get_dhkey(struct spdk_nvme_ctrlr *ctrlr, uint8_t dhgroup)
+{
+	uint64_t now = spdk_get_ticks();
+
+	if (ctrlr->auth_dhkey != NULL &&
+	    (ctrlr->auth_dhkey_dhgroup != dhgroup || now > ctrlr->auth_dhkey_expires)) {
+		spdk_nvme_dhchap_dhkey_free(&ctrlr->auth_dhkey);
+	}
+
+	if (ctrlr->auth_dhkey == NULL) {
+		ctrlr->auth_dhkey = spdk_nvme_dhchap_generate_dhkey(
+					    (enum spdk_nvmf_dhchap_dhgroup)dhgroup);
+		ctrlr->auth_dhkey_dhgroup = dhgroup;
+		ctrlr->auth_dhkey_expires = now + NVME_AUTH_DHKEY_TTL_S * spdk_get_ticks_hz();
+	}
+
+	return ctrlr->auth_dhkey;
+}
+
 static int
 nvme_auth_transform_key(struct spdk_key *key, int hash, const char *nqn,
 			const void *keyin, size_t keylen, void *out, size_t outlen)
@@ -913,23 +945,25 @@ nvme_auth_send_reply(struct spdk_nvme_qpair *qpair)
 		dhseclen = sizeof(dhsec);
 		publen = sizeof(pubkey);
 		AUTH_LOGDUMP("ctrlr pubkey:", &challenge->cval[hl], challenge->dhvlen);
-		dhkey = spdk_nvme_dhchap_generate_dhkey(
-				(enum spdk_nvmf_dhchap_dhgroup)challenge->dhg_id);
+		nvme_robust_mutex_lock(&ctrlr->ctrlr_lock);
+		dhkey = nvme_auth_get_dhkey(ctrlr, challenge->dhg_id);
 		if (dhkey == NULL) {
+			nvme_robust_mutex_unlock(&ctrlr->ctrlr_lock);
 			return -EINVAL;
 		}
 		rc = spdk_nvme_dhchap_dhkey_get_pubkey(dhkey, pubkey, &publen);
-		if (rc != 0) {
-			spdk_nvme_dhchap_dhkey_free(&dhkey);
-			return rc;
+		if (rc == 0) {
+			AUTH_LOGDUMP("host pubkey:", pubkey, publen);
+			rc = spdk_nvme_dhchap_dhkey_derive_secret(dhkey,
+					&challenge->cval[hl], challenge->dhvlen, dhsec, &dhseclen);
 		}
-		AUTH_LOGDUMP("host pubkey:", pubkey, publen);
-		rc = spdk_nvme_dhchap_dhkey_derive_secret(dhkey,
-				&challenge->cval[hl], challenge->dhvlen, dhsec, &dhseclen);
-		spdk_nvme_dhchap_dhkey_free(&dhkey);
 		if (rc != 0) {
+			/* Don't keep a key pair that failed to produce a secret */
+			spdk_nvme_dhchap_dhkey_free(&ctrlr->auth_dhkey);
+			nvme_robust_mutex_unlock(&ctrlr->ctrlr_lock);
 			return rc;
 		}
+		nvme_robust_mutex_unlock(&ctrlr->ctrlr_lock);
 
 		AUTH_LOGDUMP("dh secret:", dhsec, dhseclen);
 	}
@@ -9,6 +9,8 @@
 #include "nvme_internal.h"
 #include "nvme_io_msg.h"
 
+#include "spdk_internal/nvme.h"
+
 #include "spdk/env.h"
 #include "spdk/string.h"
 #include "spdk/endian.h"
@@ -252,6 +254,8 @@ spdk_nvme_ctrlr_get_default_ctrlr_opts(struct spdk_nvme_ctrlr_opts *opts, size_t
 		memset(opts->psk, 0, sizeof(opts->psk));
 	}
 
+	SET_FIELD(ns_identify_window, DEFAULT_NS_IDENTIFY_WINDOW);
+
 #undef FIELD_OK
 #undef SET_FIELD
 }
@@ -336,6 +340,10 @@ spdk_nvme_ctrlr_get_default_io_qpair_opts(struct spdk_nvme_ctrlr *ctrlr,
 		opts->delay_cmd_submit = false;
 	}
 
+	if (FIELD_OK(use_cmb_wds)) {
+		opts->use_cmb_wds = false;
+	}
+
 	if (FIELD_OK(sq.vaddr)) {
 		opts->sq.vaddr = NULL;
 	}
@@ -2513,34 +2521,99 @@ nvme_ctrlr_identify_active_ns(struct spdk_nvme_ctrlr *ctrlr)
 }
 
 static void
-nvme_ctrlr_identify_ns_async_done(void *arg, const struct spdk_nvme_cpl *cpl)
+nvme_ctrlr_identify_walk_start(struct spdk_nvme_ctrlr *ctrlr, uint32_t nsid)
 {
-	struct spdk_nvme_ns *ns = (struct spdk_nvme_ns *)arg;
-	struct spdk_nvme_ctrlr *ctrlr = ns->ctrlr;
-	uint32_t nsid;
-	int rc;
+	ctrlr->identify_walk_next_nsid = nsid;
+	ctrlr->identify_walk_outstanding = 0;
+	ctrlr->identify_walk_error = false;
+	ctrlr->identify_walk_stop = false;
+}
 
-	if (spdk_nvme_cpl_is_error(cpl)) {
-		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_ERROR, NVME_TIMEOUT_INFINITE);
-		return;
+/* Returns true if the failure of a single submission should abort the whole walk.
+ * Running out of requests while commands are already outstanding just shrinks the
+ * window; the walk continues as those commands complete.
+ */
+static bool
+nvme_ctrlr_identify_walk_submit_failed(struct spdk_nvme_ctrlr *ctrlr, int rc)
+{
+	if ((rc == -ENOMEM || rc == -EAGAIN) && ctrlr->identify_walk_outstanding > 0) {
+		return false;
 	}
 
-	nvme_ns_set_identify_data(ns);
+	return true;
+}
+
+/* Submit IDENTIFY_NS for the next active namespace.  Returns 1 if a command was
+ * submitted, 0 if there are no namespaces left, or a negated errno on failure.
+ */
+static int
+nvme_ctrlr_identify_ns_submit_next(struct spdk_nvme_ctrlr *ctrlr)
+{
+	struct spdk_nvme_ns *ns;
+	uint32_t nsid = ctrlr->identify_walk_next_nsid;
+	int rc;
 
-	/* move on to the next active NS */
-	nsid = spdk_nvme_ctrlr_get_next_active_ns(ctrlr, ns->id);
 	ns = spdk_nvme_ctrlr_get_ns(ctrlr, nsid);
 	if (ns == NULL) {
-		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_IDENTIFY_ID_DESCS,
-				     ctrlr->opts.admin_timeout_ms);
-		return;
+		return 0;
 	}
+
 	ns->ctrlr = ctrlr;
 	ns->id = nsid;
 
+	/* Update the walk state before submitting, the completion may arrive from
+	 * within the call.
+	 */
+	ctrlr->identify_walk_next_nsid = spdk_nvme_ctrlr_get_next_active_ns(ctrlr, nsid);
+	ctrlr->identify_walk_outstanding++;
+
 	rc = nvme_ctrlr_identify_ns_async(ns);
 	if (rc) {
+		ctrlr->identify_walk_next_nsid = nsid;
+		ctrlr->identify_walk_outstanding--;
+		return rc < 0 ? rc : -EIO;
+	}
+
+	return 1;
+}
+
+static void
+nvme_ctrlr_identify_ns_async_done(void *arg, const struct spdk_nvme_cpl *cpl)
+{
+	struct spdk_nvme_ns *ns = (struct spdk_nvme_ns *)arg;
+	struct spdk_nvme_ctrlr *ctrlr = ns->ctrlr;
+	int rc;
+
+	assert(ctrlr->identify_walk_outstanding > 0);
+	ctrlr->identify_walk_outstanding--;
+
+	if (spdk_nvme_cpl_is_error(cpl)) {
+		ctrlr->identify_walk_error = true;
+	} else {
+		nvme_ns_set_identify_data(ns);
+	}
+
+	if (!ctrlr->identify_walk_error) {
+		/* move on to the next active NS */
+		rc = nvme_ctrlr_identify_ns_submit_next(ctrlr);
+		if (rc > 0) {
+			return;
+		}
+		if (rc < 0 && nvme_ctrlr_identify_walk_submit_failed(ctrlr, rc)) {
+			ctrlr->identify_walk_error = true;
+		}
+	}
+
+	if (ctrlr->identify_walk_outstanding > 0) {
+		/* Wait for the rest of the window to drain */
+		return;
+	}
+
+	if (ctrlr->identify_walk_error) {
 		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_ERROR, NVME_TIMEOUT_INFINITE);
+	} else {
+		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_IDENTIFY_ID_DESCS,
+				     ctrlr->opts.admin_timeout_ms);
 	}
 }
 
@@ -2562,9 +2635,9 @@ nvme_ctrlr_identify_ns_async(struct spdk_nvme_ns *ns)
 static int
 nvme_ctrlr_identify_namespaces(struct spdk_nvme_ctrlr *ctrlr)
 {
-	uint32_t nsid;
+	uint32_t nsid, window, i;
 	struct spdk_nvme_ns *ns;
-	int rc;
+	int rc = 0;
 
 	nsid = spdk_nvme_ctrlr_get_first_active_ns(ctrlr);
 	ns = spdk_nvme_ctrlr_get_ns(ctrlr, nsid);
@@ -2575,15 +2648,37 @@ nvme_ctrlr_identify_namespaces(struct spdk_nvme_ctrlr *ctrlr)
 		return 0;
 	}
 
-	ns->ctrlr = ctrlr;
-	ns->id = nsid;
+	nvme_ctrlr_identify_walk_start(ctrlr, nsid);
 
-	rc = nvme_ctrlr_identify_ns_async(ns);
-	if (rc) {
+	/* Pipeline a window of IDENTIFY_NS commands on the admin queue.  Completions
+	 * keep the window full until all active namespaces have been identified.
+	 */
+	window = spdk_max(ctrlr->opts.ns_identify_window, 1);
+	for (i = 0; i < window; i++) {
+		if (ctrlr->identify_walk_error || ctrlr->identify_walk_stop) {
+			/* The walk was aborted by an early completion */
+			return 0;
+		}
+		rc = nvme_ctrlr_identify_ns_submit_next(ctrlr);
+		if (rc <= 0) {
+			break;
+		}
+	}
+
+	if (rc < 0) {
+		if (!nvme_ctrlr_identify_walk_submit_failed(ctrlr, rc)) {
+			return 0;
+		}
+		if (ctrlr->identify_walk_outstanding > 0) {
+			/* Let the outstanding completions drain before failing */
+			ctrlr->identify_walk_error = true;
+			return 0;
+		}
 		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_ERROR, NVME_TIMEOUT_INFINITE);
+		return rc;
 	}
 
-	return rc;
+	return 0;
 }
 
 static int
@@ -2693,14 +2788,48 @@ nvme_ctrlr_identify_namespaces_iocs_specific(struct spdk_nvme_ctrlr *ctrlr)
 	return nvme_ctrlr_identify_namespaces_iocs_specific_next(ctrlr, 0);
 }
 
+/* Submit IDENTIFY_NS_ID_DESCRIPTOR_LIST for the next active namespace.  Returns 1
+ * if a command was submitted, 0 if there are no namespaces left, or a negated errno
+ * on failure.
+ */
+static int
+nvme_ctrlr_identify_id_desc_submit_next(struct spdk_nvme_ctrlr *ctrlr)
+{
+	struct spdk_nvme_ns *ns;
+	uint32_t nsid = ctrlr->identify_walk_next_nsid;
+	int rc;
+
+	ns = spdk_nvme_ctrlr_get_ns(ctrlr, nsid);
+	if (ns == NULL) {
+		return 0;
+	}
+
+	/* Update the walk state before submitting, the completion may arrive from
+	 * within the call.
+	 */
+	ctrlr->identify_walk_next_nsid = spdk_nvme_ctrlr_get_next_active_ns(ctrlr, nsid);
+	ctrlr->identify_walk_outstanding++;
+
+	rc = nvme_ctrlr_identify_id_desc_async(ns);
+	if (rc) {
+		ctrlr->identify_walk_next_nsid = nsid;
+		ctrlr->identify_walk_outstanding--;
+		return rc < 0 ? rc : -EIO;
+	}
+
+	return 1;
+}
+
 static void
 nvme_ctrlr_identify_id_desc_async_done(void *arg, const struct spdk_nvme_cpl *cpl)
 {
 	struct spdk_nvme_ns *ns = (struct spdk_nvme_ns *)arg;
 	struct spdk_nvme_ctrlr *ctrlr = ns->ctrlr;
-	uint32_t nsid;
 	int rc;
 
+	assert(ctrlr->identify_walk_outstanding > 0);
+	ctrlr->identify_walk_outstanding--;
+
 	if (spdk_nvme_cpl_is_error(cpl)) {
 		/*
 		 * Many controllers claim to be compatible with NVMe 1.3, however,
@@ -2714,25 +2843,32 @@ nvme_ctrlr_identify_id_desc_async_done(void *arg, const struct spdk_nvme_cpl *cp
 		 * it is too generic and was added in order to handle controllers that
 		 * violate the NVMe 1.1 spec by not supporting ACTIVE LIST).
 		 */
-		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_IDENTIFY_NS_IOCS_SPECIFIC,
-				     ctrlr->opts.admin_timeout_ms);
-		return;
+		ctrlr->identify_walk_stop = true;
+	} else {
+		nvme_ns_set_id_desc_list_data(ns);
 	}
 
-	nvme_ns_set_id_desc_list_data(ns);
+	if (!ctrlr->identify_walk_stop && !ctrlr->identify_walk_error) {
+		/* move on to the next active NS */
+		rc = nvme_ctrlr_identify_id_desc_submit_next(ctrlr);
+		if (rc > 0) {
+			return;
+		}
+		if (rc < 0 && nvme_ctrlr_identify_walk_submit_failed(ctrlr, rc)) {
+			ctrlr->identify_walk_error = true;
+		}
+	}
 
-	/* move on to the next active NS */
-	nsid = spdk_nvme_ctrlr_get_next_active_ns(ctrlr, ns->id);
-	ns = spdk_nvme_ctrlr_get_ns(ctrlr, nsid);
-	if (ns == NULL) {
-		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_IDENTIFY_NS_IOCS_SPECIFIC,
-				     ctrlr->opts.admin_timeout_ms);
+	if (ctrlr->identify_walk_outstanding > 0) {
+		/* Wait for the rest of the window to drain */
 		return;
 	}
 
-	rc = nvme_ctrlr_identify_id_desc_async(ns);
-	if (rc) {
+	if (ctrlr->identify_walk_error) {
 		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_ERROR, NVME_TIMEOUT_INFINITE);
+	} else {
+		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_IDENTIFY_NS_IOCS_SPECIFIC,
+				     ctrlr->opts.admin_timeout_ms);
 	}
 }
 
@@ -2753,9 +2889,9 @@ nvme_ctrlr_identify_id_desc_async(struct spdk_nvme_ns *ns)
 static int
 nvme_ctrlr_identify_id_desc_namespaces(struct spdk_nvme_ctrlr *ctrlr)
 {
-	uint32_t nsid;
+	uint32_t nsid, window, i;
 	struct spdk_nvme_ns *ns;
-	int rc;
+	int rc = 0;
 
 	if ((ctrlr->vs.raw < SPDK_NVME_VERSION(1, 3, 0) &&
 	     !(ctrlr->cap.bits.css & SPDK_NVME_CAP_CSS_IOCS)) ||
@@ -2776,12 +2912,34 @@ nvme_ctrlr_identify_id_desc_namespaces(struct spdk_nvme_ctrlr *ctrlr)
 		return 0;
 	}
 
-	rc = nvme_ctrlr_identify_id_desc_async(ns);
-	if (rc) {
+	nvme_ctrlr_identify_walk_start(ctrlr, nsid);
+
+	window = spdk_max(ctrlr->opts.ns_identify_window, 1);
+	for (i = 0; i < window; i++) {
+		if (ctrlr->identify_walk_error || ctrlr->identify_walk_stop) {
+			/* The walk was aborted by an early completion */
+			return 0;
+		}
+		rc = nvme_ctrlr_identify_id_desc_submit_next(ctrlr);
+		if (rc <= 0) {
+			break;
+		}
+	}
+
+	if (rc < 0) {
+		if (!nvme_ctrlr_identify_walk_submit_failed(ctrlr, rc)) {
+			return 0;
+		}
+		if (ctrlr->identify_walk_outstanding > 0) {
+			/* Let the outstanding completions drain before failing */
+			ctrlr->identify_walk_error = true;
+			return 0;
+		}
 		nvme_ctrlr_set_state(ctrlr, NVME_CTRLR_STATE_ERROR, NVME_TIMEOUT_INFINITE);
+		return rc;
 	}
 
-	return rc;
+	return 0;
 }
 
 static void
@@ -4208,6 +4366,9 @@ nvme_ctrlr_init_cap(struct spdk_nvme_ctrlr *ctrlr)
 void
 nvme_ctrlr_destruct_finish(struct spdk_nvme_ctrlr *ctrlr)
 {
+#ifdef SPDK_CONFIG_HAVE_EVP_MAC
+	spdk_nvme_dhchap_dhkey_free(&ctrlr->auth_dhkey);
+#endif
 	pthread_mutex_destroy(&ctrlr->ctrlr_lock);
 
 	nvme_ctrlr_free_processes(ctrlr);
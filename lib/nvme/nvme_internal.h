@@ -20,6 +20,7 @@
 #include "spdk/queue.h"
 #include "spdk/barrier.h"
 #include "spdk/bit_array.h"
+#include "spdk/fd_group.h"
 #include "spdk/mmio.h"
 #include "spdk/pci_ids.h"
 #include "spdk/util.h"
@@ -34,6 +35,8 @@
 
 extern pid_t g_spdk_nvme_pid;
 
+struct spdk_nvme_dhchap_dhkey;
+
 extern struct spdk_nvme_transport_opts g_spdk_nvme_transport_opts;
 
 /*
@@ -163,6 +166,7 @@ extern struct spdk_nvme_transport_opts g_spdk_nvme_transport_opts;
  */
 #define DEFAULT_MAX_IO_QUEUES		(1024)
 #define DEFAULT_ADMIN_QUEUE_SIZE	(32)
+#define DEFAULT_NS_IDENTIFY_WINDOW	(16)
 #define DEFAULT_IO_QUEUE_SIZE		(256)
 #define DEFAULT_IO_QUEUE_SIZE_FOR_QUIRK	(1024) /* Matches Linux kernel driver */
 
@@ -487,9 +491,15 @@ struct spdk_nvme_qpair {
 	/* The user is destroying qpair */
 	uint8_t					destroy_in_progress: 1;
 
+	/* The qpair is parked by its poll group's hybrid polling mode */
+	uint8_t					is_parked: 1;
+
 	/* Number of IO outstanding at transport level */
 	uint16_t				queue_depth;
 
+	/* Number of consecutive polls that reaped no completions */
+	uint16_t				idle_polls;
+
 	enum spdk_nvme_transport_type		trtype;
 
 	uint32_t				num_outstanding_reqs;
@@ -540,6 +550,11 @@ struct spdk_nvme_poll_group {
 	struct spdk_nvme_accel_fn_table			accel_fn_table;
 	STAILQ_HEAD(, spdk_nvme_transport_poll_group)	tgroups;
 	bool						in_process_completions;
+	/* Hybrid interrupt/poll mode.  A park_threshold of 0 means disabled. */
+	struct spdk_fd_group				*fgrp;
+	int						park_efd;
+	uint32_t					park_threshold;
+	uint32_t					num_parked;
 };
 
 struct spdk_nvme_transport_poll_group {
@@ -974,6 +989,14 @@ struct spdk_nvme_ctrlr {
 	int				state;
 	uint64_t			state_timeout_tsc;
 
+	/* Windowed pipeline state for the per-namespace IDENTIFY walks during init */
+	uint32_t			identify_walk_next_nsid;
+	uint32_t			identify_walk_outstanding;
+	/* Abort the walk and enter the ERROR state once outstanding commands drain */
+	bool				identify_walk_error;
+	/* Stop the walk and move to the next init state once outstanding commands drain */
+	bool				identify_walk_stop;
+
 	uint64_t			next_keep_alive_tick;
 	uint64_t			keep_alive_interval_ticks;
 
@@ -1078,6 +1101,12 @@ struct spdk_nvme_ctrlr {
 	uint16_t				auth_tid;
 	/* Authentication sequence number */
 	uint32_t				auth_seqnum;
+	/* Cached DH key pair reused across qpair authentications */
+	struct spdk_nvme_dhchap_dhkey		*auth_dhkey;
+	/* DH group of the cached key pair */
+	uint8_t					auth_dhkey_dhgroup;
+	/* Tick at which the cached key pair expires */
+	uint64_t				auth_dhkey_expires;
 };
 
 struct spdk_nvme_probe_ctx {
@@ -1274,6 +1303,7 @@ void	nvme_qpair_abort_all_queued_reqs(struct spdk_nvme_qpair *qpair);
 uint32_t nvme_qpair_abort_queued_reqs_with_cbarg(struct spdk_nvme_qpair *qpair, void *cmd_cb_arg);
 void	nvme_qpair_abort_queued_reqs(struct spdk_nvme_qpair *qpair);
 void	nvme_qpair_resubmit_requests(struct spdk_nvme_qpair *qpair, uint32_t num_requests);
+void	nvme_qpair_unpark(struct spdk_nvme_qpair *qpair);
 int	nvme_ctrlr_identify_active_ns(struct spdk_nvme_ctrlr *ctrlr);
 void	nvme_ns_set_identify_data(struct spdk_nvme_ns *ns);
 void	nvme_ns_set_id_desc_list_data(struct spdk_nvme_ns *ns);
@@ -1630,6 +1660,10 @@ int nvme_transport_qpair_reset(struct spdk_nvme_qpair *qpair);
 int nvme_transport_qpair_submit_request(struct spdk_nvme_qpair *qpair, struct nvme_request *req);
 int32_t nvme_transport_qpair_process_completions(struct spdk_nvme_qpair *qpair,
 		uint32_t max_completions);
+int nvme_transport_qpair_flush(struct spdk_nvme_qpair *qpair);
+int nvme_transport_qpair_register_payload(struct spdk_nvme_qpair *qpair, void *buffer,
+		uint32_t payload_size, uint64_t *token);
+int nvme_transport_qpair_unregister_payload(struct spdk_nvme_qpair *qpair, uint64_t token);
 void nvme_transport_admin_qpair_abort_aers(struct spdk_nvme_qpair *qpair);
 int nvme_transport_qpair_iterate_requests(struct spdk_nvme_qpair *qpair,
 		int (*iter_fn)(struct nvme_request *req, void *arg),
@@ -367,6 +367,7 @@ nvme_pcie_ctrlr_map_cmb(struct nvme_pcie_ctrlr *pctrlr)
 	pctrlr->cmb.bar_pa = bar_phys_addr;
 	pctrlr->cmb.size = size;
 	pctrlr->cmb.current_offset = offset;
+	pctrlr->cmb.supports_wds = cmbsz.bits.wds != 0;
 
 	if (!cmbsz.bits.sqs) {
 		pctrlr->ctrlr.opts.use_cmb_sqs = false;
@@ -1107,6 +1108,9 @@ const struct spdk_nvme_transport_ops pcie_ops = {
 	.qpair_reset = nvme_pcie_qpair_reset,
 	.qpair_submit_request = nvme_pcie_qpair_submit_request,
 	.qpair_process_completions = nvme_pcie_qpair_process_completions,
+	.qpair_flush = nvme_pcie_qpair_flush,
+	.qpair_register_payload = nvme_pcie_qpair_register_payload,
+	.qpair_unregister_payload = nvme_pcie_qpair_unregister_payload,
 	.qpair_iterate_requests = nvme_pcie_qpair_iterate_requests,
 	.admin_qpair_abort_aers = nvme_pcie_admin_qpair_abort_aers,
 
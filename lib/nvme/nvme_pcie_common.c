@@ -17,6 +17,10 @@
 
 #include "spdk_internal/trace_defs.h"
 
+/* Number of valid CQ entries scanned (and trackers prefetched) ahead of the
+ * completion pass in nvme_pcie_qpair_process_completions(). */
+#define NVME_PCIE_COMPLETION_BATCH_SIZE	32
+
 __thread struct nvme_pcie_ctrlr *g_thread_mmio_ctrlr = NULL;
 
 static struct spdk_nvme_pcie_stat g_dummy_stat = {};
@@ -149,6 +153,21 @@ nvme_pcie_qpair_construct(struct spdk_nvme_qpair *qpair,
 		}
 	}
 
+	if (opts && opts->use_cmb_wds && pctrlr->cmb.supports_wds) {
+		/* One page-sized, page-aligned staging slot per tracker, so a staged
+		 * payload never crosses a page boundary.
+		 */
+		pqpair->cmb_wds.vaddr = nvme_pcie_ctrlr_alloc_cmb(ctrlr,
+					(uint64_t)num_trackers * ctrlr->page_size,
+					page_align, &pqpair->cmb_wds.bus_addr);
+		if (pqpair->cmb_wds.vaddr != NULL) {
+			pqpair->flags.has_cmb_wds = 1;
+		} else {
+			SPDK_NOTICELOG("Could not reserve CMB write data staging space, "
+				       "continuing without it\n");
+		}
+	}
+
 	if (pqpair->sq_in_cmb == false) {
 		if (pqpair->sq_vaddr) {
 			pqpair->cmd = pqpair->sq_vaddr;
@@ -824,17 +843,129 @@ nvme_pcie_qpair_check_timeout(struct spdk_nvme_qpair *qpair)
 	}
 }
 
+int
+nvme_pcie_qpair_flush(struct spdk_nvme_qpair *qpair)
+{
+	struct nvme_pcie_qpair	*pqpair = nvme_pcie_qpair(qpair);
+
+	if (pqpair->flags.delay_cmd_submit && pqpair->last_sq_tail != pqpair->sq_tail) {
+		nvme_pcie_qpair_ring_sq_doorbell(qpair);
+		pqpair->last_sq_tail = pqpair->sq_tail;
+	}
+
+	return 0;
+}
+
+int
+nvme_pcie_qpair_register_payload(struct spdk_nvme_qpair *qpair, void *buffer,
+				 uint32_t payload_size, uint64_t *token)
+{
+	struct nvme_pcie_qpair *pqpair = nvme_pcie_qpair(qpair);
+	struct spdk_nvme_ctrlr *ctrlr = qpair->ctrlr;
+	struct nvme_pcie_registered_payload *rp = NULL;
+	uint32_t page_size = ctrlr->page_size;
+	uintptr_t page_mask = page_size - 1;
+	uint8_t *virt_addr = buffer;
+	uint64_t phys_addr;
+	uint32_t len = payload_size;
+	uint32_t i;
+
+	if (((uintptr_t)buffer & 3) != 0) {
+		SPDK_ERRLOG("virt_addr %p not dword aligned\n", buffer);
+		return -EINVAL;
+	}
+
+	if (pqpair->registered_payloads == NULL) {
+		pqpair->registered_payloads = calloc(NVME_PCIE_MAX_REGISTERED_PAYLOADS,
+						     sizeof(*pqpair->registered_payloads));
+		if (pqpair->registered_payloads == NULL) {
+			return -ENOMEM;
+		}
+	}
+
+	for (i = 0; i < NVME_PCIE_MAX_REGISTERED_PAYLOADS; i++) {
+		if (pqpair->registered_payloads[i].num_prps == 0) {
+			rp = &pqpair->registered_payloads[i];
+			break;
+		}
+	}
+	if (rp == NULL) {
+		return -ENOSPC;
+	}
+
+	/* Translate the buffer once, with the same constraints that
+	 * nvme_pcie_prp_list_append() imposes per submission.
+	 */
+	i = 0;
+	while (len) {
+		uint32_t seg_len;
+
+		if (i > NVME_MAX_PRP_LIST_ENTRIES) {
+			SPDK_ERRLOG("out of PRP entries\n");
+			return -EFAULT;
+		}
+
+		phys_addr = nvme_pcie_vtophys(ctrlr, virt_addr, NULL);
+		if (phys_addr == SPDK_VTOPHYS_ERROR) {
+			SPDK_ERRLOG("vtophys(%p) failed\n", virt_addr);
+			return -EFAULT;
+		}
+
+		if (i == 0) {
+			rp->prp1 = phys_addr;
+			seg_len = page_size - ((uintptr_t)virt_addr & page_mask);
+		} else {
+			if ((phys_addr & page_mask) != 0) {
+				SPDK_ERRLOG("PRP %u not page aligned (%p)\n", i, virt_addr);
+				return -EFAULT;
+			}
+			rp->prp[i - 1] = phys_addr;
+			seg_len = page_size;
+		}
+
+		seg_len = spdk_min(seg_len, len);
+		virt_addr += seg_len;
+		len -= seg_len;
+		i++;
+	}
+
+	rp->vaddr = buffer;
+	rp->size = payload_size;
+	rp->num_prps = i;
+
+	*token = (uint64_t)(rp - pqpair->registered_payloads) + 1;
+
+	return 0;
+}
+
+int
+nvme_pcie_qpair_unregister_payload(struct spdk_nvme_qpair *qpair, uint64_t token)
+{
+	struct nvme_pcie_qpair *pqpair = nvme_pcie_qpair(qpair);
+
+	if (pqpair->registered_payloads == NULL ||
+	    token == 0 || token > NVME_PCIE_MAX_REGISTERED_PAYLOADS ||
+	    pqpair->registered_payloads[token - 1].num_prps == 0) {
+		return -EINVAL;
+	}
+
+	memset(&pqpair->registered_payloads[token - 1], 0,
+	       sizeof(pqpair->registered_payloads[token - 1]));
+
+	return 0;
+}
+
 int32_t
 nvme_pcie_qpair_process_completions(struct spdk_nvme_qpair *qpair, uint32_t max_completions)
 {
 	struct nvme_pcie_qpair	*pqpair = nvme_pcie_qpair(qpair);
 	struct nvme_tracker	*tr;
-	struct spdk_nvme_cpl	*cpl, *next_cpl;
+	struct spdk_nvme_cpl	*cpl;
 	uint32_t		 num_completions = 0;
 	struct spdk_nvme_ctrlr	*ctrlr = qpair->ctrlr;
-	uint16_t		 next_cq_head;
-	uint8_t			 next_phase;
-	bool			 next_is_valid = false;
+	uint32_t		 batch, i;
+	uint16_t		 scan_head;
+	uint8_t			 scan_phase;
 	int			 rc;
 
 	if (spdk_unlikely(pqpair->pcie_state == NVME_PCIE_QPAIR_FAILED)) {
@@ -881,24 +1012,33 @@ nvme_pcie_qpair_process_completions(struct spdk_nvme_qpair *qpair, uint32_t max_
 
 	pqpair->stat->polls++;
 
-	while (1) {
-		cpl = &pqpair->cpl[pqpair->cq_head];
+	while (num_completions < max_completions) {
+		/* Scan ahead for a batch of valid phase entries, prefetching each
+		 * entry's tracker before any of them are completed.  By the time the
+		 * completion pass below touches a tracker, its cacheline is already
+		 * on its way.
+		 */
+		scan_head = pqpair->cq_head;
+		scan_phase = pqpair->flags.phase;
+		batch = spdk_min(NVME_PCIE_COMPLETION_BATCH_SIZE,
+				 max_completions - num_completions);
+		for (i = 0; i < batch; i++) {
+			cpl = &pqpair->cpl[scan_head];
+
+			if (cpl->status.p != scan_phase) {
+				break;
+			}
 
-		if (!next_is_valid && cpl->status.p != pqpair->flags.phase) {
-			break;
+			__builtin_prefetch(&pqpair->tr[cpl->cid]);
+			if (spdk_unlikely(++scan_head == pqpair->num_entries)) {
+				scan_head = 0;
+				scan_phase = !scan_phase;
+			}
 		}
+		batch = i;
 
-		if (spdk_likely(pqpair->cq_head + 1 != pqpair->num_entries)) {
-			next_cq_head = pqpair->cq_head + 1;
-			next_phase = pqpair->flags.phase;
-		} else {
-			next_cq_head = 0;
-			next_phase = !pqpair->flags.phase;
-		}
-		next_cpl = &pqpair->cpl[next_cq_head];
-		next_is_valid = (next_cpl->status.p == next_phase);
-		if (next_is_valid) {
-			__builtin_prefetch(&pqpair->tr[next_cpl->cid]);
+		if (batch == 0) {
+			break;
 		}
 
 #if defined(__PPC64__) || defined(__riscv) || defined(__loongarch__)
@@ -912,29 +1052,31 @@ nvme_pcie_qpair_process_completions(struct spdk_nvme_qpair *qpair, uint32_t max_
 		__asm volatile("dmb oshld" ::: "memory");
 #endif
 
-		if (spdk_unlikely(++pqpair->cq_head == pqpair->num_entries)) {
-			pqpair->cq_head = 0;
-			pqpair->flags.phase = !pqpair->flags.phase;
-		}
+		for (i = 0; i < batch; i++) {
+			cpl = &pqpair->cpl[pqpair->cq_head];
 
-		tr = &pqpair->tr[cpl->cid];
-		pqpair->sq_head = cpl->sqhd;
+			if (spdk_unlikely(++pqpair->cq_head == pqpair->num_entries)) {
+				pqpair->cq_head = 0;
+				pqpair->flags.phase = !pqpair->flags.phase;
+			}
 
-		if (tr->req) {
-			/* Prefetch the req's STAILQ_ENTRY since we'll need to access it
-			 * as part of putting the req back on the qpair's free list.
-			 */
-			__builtin_prefetch(&tr->req->stailq);
-			nvme_pcie_qpair_complete_tracker(qpair, tr, cpl, true);
-		} else {
-			SPDK_ERRLOG("cpl does not map to outstanding cmd\n");
-			spdk_nvme_qpair_print_completion(qpair, cpl);
-			assert(0);
+			tr = &pqpair->tr[cpl->cid];
+			pqpair->sq_head = cpl->sqhd;
+
+			if (tr->req) {
+				/* Prefetch the req's STAILQ_ENTRY since we'll need to access it
+				 * as part of putting the req back on the qpair's free list.
+				 */
+				__builtin_prefetch(&tr->req->stailq);
+				nvme_pcie_qpair_complete_tracker(qpair, tr, cpl, true);
+			} else {
+				SPDK_ERRLOG("cpl does not map to outstanding cmd\n");
+				spdk_nvme_qpair_print_completion(qpair, cpl);
+				assert(0);
+			}
 		}
 
-		if (++num_completions == max_completions) {
-			break;
-		}
+		num_completions += batch;
 	}
 
 	if (num_completions > 0) {
@@ -1013,6 +1155,8 @@ nvme_pcie_qpair_destroy(struct spdk_nvme_qpair *qpair)
 		spdk_free(pqpair->tr);
 	}
 
+	free(pqpair->registered_payloads);
+
 	nvme_qpair_deinit(qpair);
 
 	if (!pqpair->shared_stats && (!qpair->active_proc ||
@@ -1270,6 +1414,44 @@ nvme_pcie_qpair_build_request_invalid(struct spdk_nvme_qpair *qpair,
 	return -EINVAL;
 }
 
+/**
+ * Fill the command's PRPs from the cached representation of a pre-registered
+ * payload.  Returns false if the token does not match the request's payload,
+ * in which case the caller builds the PRP list as usual.
+ */
+static bool
+nvme_pcie_qpair_apply_registered_payload(struct spdk_nvme_qpair *qpair, struct nvme_request *req,
+		struct nvme_tracker *tr, uint64_t token, void *virt_addr)
+{
+	struct nvme_pcie_qpair *pqpair = nvme_pcie_qpair(qpair);
+	struct nvme_pcie_registered_payload *rp;
+
+	if (pqpair->registered_payloads == NULL || token > NVME_PCIE_MAX_REGISTERED_PAYLOADS) {
+		return false;
+	}
+
+	rp = &pqpair->registered_payloads[token - 1];
+	if (rp->num_prps == 0 || rp->vaddr != virt_addr || rp->size != req->payload_size) {
+		/* The request does not cover the registered buffer exactly,
+		 * e.g. because it was split by the generic layer.
+		 */
+		return false;
+	}
+
+	req->cmd.psdt = SPDK_NVME_PSDT_PRP;
+	req->cmd.dptr.prp.prp1 = rp->prp1;
+	if (rp->num_prps == 1) {
+		req->cmd.dptr.prp.prp2 = 0;
+	} else if (rp->num_prps == 2) {
+		req->cmd.dptr.prp.prp2 = rp->prp[0];
+	} else {
+		memcpy(tr->u.prp, rp->prp, (rp->num_prps - 1) * sizeof(rp->prp[0]));
+		req->cmd.dptr.prp.prp2 = tr->prp_sgl_bus_addr;
+	}
+
+	return true;
+}
+
 /**
  * Build PRP list describing physically contiguous payload buffer.
  */
@@ -1278,10 +1460,17 @@ nvme_pcie_qpair_build_contig_request(struct spdk_nvme_qpair *qpair, struct nvme_
 				     struct nvme_tracker *tr, bool dword_aligned)
 {
 	uint32_t prp_index = 0;
+	uint8_t *virt_addr = (uint8_t *)req->payload.contig_or_cb_arg + req->payload_offset;
+	uint64_t token;
 	int rc;
 
-	rc = nvme_pcie_prp_list_append(qpair->ctrlr, tr, &prp_index,
-				       (uint8_t *)req->payload.contig_or_cb_arg + req->payload_offset,
+	token = nvme_ns_cmd_get_ext_io_opt(req->payload.opts, payload_token, 0);
+	if (spdk_unlikely(token != 0) &&
+	    nvme_pcie_qpair_apply_registered_payload(qpair, req, tr, token, virt_addr)) {
+		return 0;
+	}
+
+	rc = nvme_pcie_prp_list_append(qpair->ctrlr, tr, &prp_index, virt_addr,
 				       req->payload_size, qpair->ctrlr->page_size);
 	if (rc) {
 		nvme_pcie_fail_request_bad_vtophys(qpair, tr);
@@ -1620,6 +1809,39 @@ exit:
 	return -EINVAL;
 }
 
+/**
+ * Stage a small contiguous write payload into the tracker's CMB slot and point
+ * the command's PRP at the CMB copy, so the controller does not have to fetch
+ * the data from host memory.  Returns false if the request is not eligible.
+ */
+static bool
+nvme_pcie_qpair_stage_cmb_wds(struct spdk_nvme_qpair *qpair, struct nvme_request *req,
+			      struct nvme_tracker *tr)
+{
+	struct nvme_pcie_qpair *pqpair = nvme_pcie_qpair(qpair);
+	uint32_t page_size = qpair->ctrlr->page_size;
+	uint8_t *slot;
+
+	if (nvme_payload_type(&req->payload) != NVME_PAYLOAD_TYPE_CONTIG ||
+	    req->payload_size > page_size ||
+	    req->payload.md != NULL ||
+	    spdk_nvme_opc_get_data_transfer(req->cmd.opc) != SPDK_NVME_DATA_HOST_TO_CONTROLLER) {
+		return false;
+	}
+
+	slot = pqpair->cmb_wds.vaddr + (uint64_t)tr->cid * page_size;
+	memcpy(slot, (uint8_t *)req->payload.contig_or_cb_arg + req->payload_offset,
+	       req->payload_size);
+	/* Ensure the staged data is visible to the device before the doorbell write. */
+	spdk_wmb();
+
+	/* The slot is page aligned, so a single PRP entry describes the payload. */
+	req->cmd.dptr.prp.prp1 = pqpair->cmb_wds.bus_addr + (uint64_t)tr->cid * page_size;
+	req->cmd.dptr.prp.prp2 = 0;
+
+	return true;
+}
+
 int
 nvme_pcie_qpair_submit_request(struct spdk_nvme_qpair *qpair, struct nvme_request *req)
 {
@@ -1657,6 +1879,15 @@ nvme_pcie_qpair_submit_request(struct spdk_nvme_qpair *qpair, struct nvme_reques
 	req->cmd.psdt = SPDK_NVME_PSDT_PRP;
 
 	if (req->payload_size != 0) {
+		if (spdk_unlikely(pqpair->flags.has_cmb_wds) &&
+		    nvme_pcie_qpair_stage_cmb_wds(qpair, req, tr)) {
+			/* The payload was copied into the CMB and the PRP already
+			 * points at it, so there is nothing left to build.
+			 */
+			nvme_pcie_qpair_submit_tracker(qpair, tr);
+			goto exit;
+		}
+
 		payload_type = nvme_payload_type(&req->payload);
 		/* According to the specification, PRPs shall be used for all
 		 *  Admin commands for NVMe over PCIe implementations.
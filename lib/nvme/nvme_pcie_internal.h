@@ -49,6 +49,9 @@ struct nvme_pcie_ctrlr {
 
 		void *mem_register_addr;
 		size_t mem_register_size;
+
+		/* Controller supports write data and metadata in CMB */
+		bool supports_wds;
 	} cmb;
 
 	struct {
@@ -109,6 +112,21 @@ SPDK_STATIC_ASSERT(sizeof(struct nvme_tracker) == 4096, "nvme_tracker is not 4K"
 SPDK_STATIC_ASSERT((offsetof(struct nvme_tracker, u.sgl) & 7) == 0, "SGL must be Qword aligned");
 SPDK_STATIC_ASSERT((offsetof(struct nvme_tracker, meta_sgl) & 7) == 0, "SGL must be Qword aligned");
 
+/* Maximum number of payload layouts that can be pre-registered per qpair. */
+#define NVME_PCIE_MAX_REGISTERED_PAYLOADS	16
+
+/* Cached data pointer representation of a pre-registered payload buffer. */
+struct nvme_pcie_registered_payload {
+	void		*vaddr;
+	uint32_t	size;
+
+	/* Number of PRP entries including PRP1, 0 if the slot is free. */
+	uint32_t	num_prps;
+
+	uint64_t	prp1;
+	uint64_t	prp[NVME_MAX_PRP_LIST_ENTRIES];
+};
+
 struct nvme_pcie_poll_group {
 	struct spdk_nvme_transport_poll_group group;
 	struct spdk_nvme_pcie_stat stats;
@@ -143,6 +161,12 @@ struct nvme_pcie_qpair {
 
 	struct spdk_nvme_pcie_stat *stat;
 
+	/* Per-tracker write data staging slots in the CMB, one page per tracker. */
+	struct {
+		uint8_t *vaddr;
+		uint64_t bus_addr;
+	} cmb_wds;
+
 	uint16_t num_entries;
 
 	uint8_t pcie_state;
@@ -162,6 +186,7 @@ struct nvme_pcie_qpair {
 		uint8_t has_shadow_doorbell	: 1;
 		uint8_t has_pending_vtophys_failures : 1;
 		uint8_t defer_destruction	: 1;
+		uint8_t has_cmb_wds		: 1;
 	} flags;
 
 	/*
@@ -192,6 +217,9 @@ struct nvme_pcie_qpair {
 	bool sq_in_cmb;
 	bool shared_stats;
 
+	/* Allocated on first spdk_nvme_qpair_register_payload() call. */
+	struct nvme_pcie_registered_payload *registered_payloads;
+
 	uint64_t cmd_bus_addr;
 	uint64_t cpl_bus_addr;
 
@@ -322,6 +350,10 @@ void nvme_pcie_qpair_submit_tracker(struct spdk_nvme_qpair *qpair, struct nvme_t
 void nvme_pcie_admin_qpair_abort_aers(struct spdk_nvme_qpair *qpair);
 void nvme_pcie_admin_qpair_destroy(struct spdk_nvme_qpair *qpair);
 void nvme_pcie_qpair_abort_reqs(struct spdk_nvme_qpair *qpair, uint32_t dnr);
+int nvme_pcie_qpair_flush(struct spdk_nvme_qpair *qpair);
+int nvme_pcie_qpair_register_payload(struct spdk_nvme_qpair *qpair, void *buffer,
+				     uint32_t payload_size, uint64_t *token);
+int nvme_pcie_qpair_unregister_payload(struct spdk_nvme_qpair *qpair, uint64_t token);
 int32_t nvme_pcie_qpair_process_completions(struct spdk_nvme_qpair *qpair,
 		uint32_t max_completions);
 int nvme_pcie_qpair_destroy(struct spdk_nvme_qpair *qpair);
@@ -6,6 +6,10 @@
 
 #include "nvme_internal.h"
 
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
 struct spdk_nvme_poll_group *
 spdk_nvme_poll_group_create(void *ctx, struct spdk_nvme_accel_fn_table *table)
 {
@@ -56,6 +60,7 @@ spdk_nvme_poll_group_create(void *ctx, struct spdk_nvme_accel_fn_table *table)
 	}
 
 	group->ctx = ctx;
+	group->park_efd = -1;
 	STAILQ_INIT(&group->tgroups);
 
 	return group;
@@ -116,6 +121,10 @@ spdk_nvme_poll_group_remove(struct spdk_nvme_poll_group *group, struct spdk_nvme
 {
 	struct spdk_nvme_transport_poll_group *tgroup;
 
+	if (qpair->is_parked) {
+		nvme_qpair_unpark(qpair);
+	}
+
 	STAILQ_FOREACH(tgroup, &group->tgroups, link) {
 		if (tgroup->transport == qpair->transport) {
 			return nvme_transport_poll_group_remove(tgroup, qpair);
@@ -125,6 +134,106 @@ spdk_nvme_poll_group_remove(struct spdk_nvme_poll_group *group, struct spdk_nvme
 	return -ENODEV;
 }
 
+static int
+nvme_poll_group_park_event(void *arg)
+{
+	struct spdk_nvme_poll_group *group = arg;
+	uint64_t notify;
+	int rc __attribute__((unused));
+
+	/* Clear the level triggering; the caller resumes polling the group. */
+	rc = read(group->park_efd, &notify, sizeof(notify));
+
+	return 0;
+}
+
+int
+spdk_nvme_poll_group_enable_hybrid_polling(struct spdk_nvme_poll_group *group,
+		uint32_t idle_poll_threshold)
+{
+#ifdef __linux__
+	int rc;
+
+	if (idle_poll_threshold == 0) {
+		return -EINVAL;
+	}
+
+	if (group->fgrp != NULL) {
+		group->park_threshold = spdk_min(idle_poll_threshold, UINT16_MAX);
+		return 0;
+	}
+
+	rc = spdk_fd_group_create(&group->fgrp);
+	if (rc != 0) {
+		return rc;
+	}
+
+	group->park_efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (group->park_efd < 0) {
+		SPDK_ERRLOG("Failed to create eventfd for poll group\n");
+		rc = -errno;
+		spdk_fd_group_destroy(group->fgrp);
+		group->fgrp = NULL;
+		return rc;
+	}
+
+	rc = SPDK_FD_GROUP_ADD(group->fgrp, group->park_efd, nvme_poll_group_park_event, group);
+	if (rc != 0) {
+		close(group->park_efd);
+		group->park_efd = -1;
+		spdk_fd_group_destroy(group->fgrp);
+		group->fgrp = NULL;
+		return rc;
+	}
+
+	/* idle_polls is 16 bits wide, larger thresholds are clamped */
+	group->park_threshold = spdk_min(idle_poll_threshold, UINT16_MAX);
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+void
+spdk_nvme_poll_group_disable_hybrid_polling(struct spdk_nvme_poll_group *group)
+{
+	struct spdk_nvme_transport_poll_group *tgroup;
+	struct spdk_nvme_qpair *qpair;
+
+	if (group->fgrp == NULL) {
+		return;
+	}
+
+	group->park_threshold = 0;
+
+	STAILQ_FOREACH(tgroup, &group->tgroups, link) {
+		STAILQ_FOREACH(qpair, &tgroup->connected_qpairs, poll_group_stailq) {
+			if (qpair->is_parked) {
+				nvme_qpair_unpark(qpair);
+			}
+			qpair->idle_polls = 0;
+		}
+	}
+	assert(group->num_parked == 0);
+
+	spdk_fd_group_remove(group->fgrp, group->park_efd);
+	close(group->park_efd);
+	group->park_efd = -1;
+	spdk_fd_group_destroy(group->fgrp);
+	group->fgrp = NULL;
+}
+
+int
+spdk_nvme_poll_group_get_fd(struct spdk_nvme_poll_group *group)
+{
+	if (group->fgrp == NULL) {
+		return -ENOTSUP;
+	}
+
+	return spdk_fd_group_get_fd(group->fgrp);
+}
+
 int
 nvme_poll_group_connect_qpair(struct spdk_nvme_qpair *qpair)
 {
@@ -219,6 +328,8 @@ spdk_nvme_poll_group_destroy(struct spdk_nvme_poll_group *group)
 
 	}
 
+	spdk_nvme_poll_group_disable_hybrid_polling(group);
+
 	free(group);
 
 	return 0;
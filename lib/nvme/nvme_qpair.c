@@ -721,6 +721,28 @@ nvme_qpair_resubmit_requests(struct spdk_nvme_qpair *qpair, uint32_t num_request
 	_nvme_qpair_complete_abort_queued_reqs(qpair);
 }
 
+void
+nvme_qpair_unpark(struct spdk_nvme_qpair *qpair)
+{
+	struct spdk_nvme_poll_group *group;
+	uint64_t notify = 1;
+
+	assert(qpair->is_parked);
+	assert(qpair->poll_group != NULL);
+
+	qpair->is_parked = 0;
+	qpair->idle_polls = 0;
+
+	group = qpair->poll_group->group;
+	assert(group->num_parked > 0);
+	group->num_parked--;
+
+	/* Wake up anybody waiting on the poll group's notification fd */
+	if (group->park_efd >= 0 && write(group->park_efd, &notify, sizeof(notify)) < 0) {
+		SPDK_ERRLOG("Failed to notify unpark of qpair %u\n", qpair->id);
+	}
+}
+
 static void
 nvme_complete_register_operations(struct spdk_nvme_qpair *qpair)
 {
@@ -783,6 +805,18 @@ spdk_nvme_qpair_process_completions(struct spdk_nvme_qpair *qpair, uint32_t max_
 		return -ENXIO;
 	}
 
+	if (spdk_unlikely(qpair->is_parked)) {
+		if (spdk_likely(nvme_qpair_get_state(qpair) == NVME_QPAIR_ENABLED)) {
+			/*
+			 * Parked qpairs have no outstanding requests, so there is
+			 *  nothing to reap until the next submission unparks them.
+			 */
+			return 0;
+		}
+		/* Any other state needs to make progress, stop parking the qpair */
+		nvme_qpair_unpark(qpair);
+	}
+
 	/* error injection for those queued error requests */
 	if (spdk_unlikely(!STAILQ_EMPTY(&qpair->err_req_head))) {
 		STAILQ_FOREACH_SAFE(req, &qpair->err_req_head, stailq, tmp) {
@@ -828,9 +862,50 @@ spdk_nvme_qpair_process_completions(struct spdk_nvme_qpair *qpair, uint32_t max_
 		_nvme_qpair_complete_abort_queued_reqs(qpair);
 	}
 
+	if (spdk_unlikely(qpair->poll_group != NULL &&
+			  qpair->poll_group->group->park_threshold != 0 &&
+			  nvme_qpair_get_state(qpair) == NVME_QPAIR_ENABLED)) {
+		if (ret != 0 || qpair->num_outstanding_reqs > 0 || !STAILQ_EMPTY(&qpair->queued_req)) {
+			qpair->idle_polls = 0;
+		} else if (++qpair->idle_polls >= qpair->poll_group->group->park_threshold) {
+			qpair->is_parked = 1;
+			qpair->idle_polls = 0;
+			qpair->poll_group->group->num_parked++;
+		}
+	}
+
 	return ret;
 }
 
+int
+spdk_nvme_qpair_flush(struct spdk_nvme_qpair *qpair)
+{
+	if (spdk_unlikely(!nvme_qpair_check_enabled(qpair) &&
+			  !(nvme_qpair_get_state(qpair) == NVME_QPAIR_CONNECTING ||
+			    nvme_qpair_get_state(qpair) == NVME_QPAIR_DISCONNECTING))) {
+		return -ENXIO;
+	}
+
+	return nvme_transport_qpair_flush(qpair);
+}
+
+int
+spdk_nvme_qpair_register_payload(struct spdk_nvme_qpair *qpair, void *buffer,
+				 uint32_t payload_size, uint64_t *token)
+{
+	if (buffer == NULL || payload_size == 0 || token == NULL) {
+		return -EINVAL;
+	}
+
+	return nvme_transport_qpair_register_payload(qpair, buffer, payload_size, token);
+}
+
+int
+spdk_nvme_qpair_unregister_payload(struct spdk_nvme_qpair *qpair, uint64_t token)
+{
+	return nvme_transport_qpair_unregister_payload(qpair, token);
+}
+
 spdk_nvme_qp_failure_reason
 spdk_nvme_qpair_get_failure_reason(struct spdk_nvme_qpair *qpair)
 {
@@ -1089,6 +1164,10 @@ nvme_qpair_submit_request(struct spdk_nvme_qpair *qpair, struct nvme_request *re
 {
 	int rc;
 
+	if (spdk_unlikely(qpair->is_parked)) {
+		nvme_qpair_unpark(qpair);
+	}
+
 	if (spdk_unlikely(!STAILQ_EMPTY(&qpair->queued_req) && req->num_children == 0)) {
 		/*
 		 * Requests that have no children should be sent to the transport after all
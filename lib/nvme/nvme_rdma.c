@@ -15,6 +15,7 @@
 #include "spdk/log.h"
 #include "spdk/trace.h"
 #include "spdk/queue.h"
+#include "spdk/tree.h"
 #include "spdk/nvme.h"
 #include "spdk/nvmf_spec.h"
 #include "spdk/string.h"
@@ -72,9 +73,6 @@
 
 #define WC_PER_QPAIR(queue_depth)	(queue_depth * 2)
 
-#define NVME_RDMA_POLL_GROUP_CHECK_QPN(_rqpair, qpn)				\
-	((_rqpair)->rdma_qp && (_rqpair)->rdma_qp->qp->qp_num == (qpn))	\
-
 struct nvme_rdma_memory_domain {
 	TAILQ_ENTRY(nvme_rdma_memory_domain) link;
 	uint32_t ref;
@@ -155,6 +153,8 @@ struct nvme_rdma_poll_group {
 	uint32_t					num_pollers;
 	TAILQ_HEAD(, nvme_rdma_qpair)			connecting_qpairs;
 	TAILQ_HEAD(, nvme_rdma_qpair)			active_qpairs;
+	/* qpairs with a created QP, indexed by qp_num for WC demux */
+	RB_HEAD(nvme_rdma_qpairs_tree, nvme_rdma_qpair)	qpairs;
 };
 
 enum nvme_rdma_qpair_state {
@@ -231,6 +231,12 @@ struct nvme_rdma_qpair {
 	/* Count of outstanding send objects */
 	uint16_t				current_num_sends;
 
+	/* Cached copy of rdma_qp->qp->qp_num, the key to find this qpair
+	 * from a work completion on a shared CQ. */
+	uint32_t				qp_num;
+
+	RB_ENTRY(nvme_rdma_qpair)		node;
+
 	TAILQ_ENTRY(nvme_rdma_qpair)		link_active;
 
 	/* Placed at the end of the struct since it is not used frequently */
@@ -251,6 +257,14 @@ struct nvme_rdma_qpair {
 	TAILQ_ENTRY(nvme_rdma_qpair)		link_connecting;
 };
 
+static int
+nvme_rdma_qpair_compare(struct nvme_rdma_qpair *rqpair1, struct nvme_rdma_qpair *rqpair2)
+{
+	return rqpair1->qp_num < rqpair2->qp_num ? -1 : rqpair1->qp_num > rqpair2->qp_num;
+}
+
+RB_GENERATE_STATIC(nvme_rdma_qpairs_tree, nvme_rdma_qpair, node, nvme_rdma_qpair_compare);
+
 enum NVME_RDMA_COMPLETION_FLAGS {
 	NVME_RDMA_SEND_COMPLETED = 1u << 0,
 	NVME_RDMA_RECV_COMPLETED = 1u << 1,
@@ -805,6 +819,12 @@ nvme_rdma_qpair_init(struct nvme_rdma_qpair *rqpair)
 		return -1;
 	}
 
+	if (rqpair->qpair.poll_group) {
+		rqpair->qp_num = rqpair->rdma_qp->qp->qp_num;
+		RB_INSERT(nvme_rdma_qpairs_tree, &nvme_rdma_poll_group(rqpair->qpair.poll_group)->qpairs,
+			  rqpair);
+	}
+
 	rqpair->memory_domain = nvme_rdma_get_memory_domain(rqpair->rdma_qp->qp->pd);
 	if (!rqpair->memory_domain) {
 		SPDK_ERRLOG("Failed to get memory domain\n");
@@ -1883,6 +1903,10 @@ nvme_rdma_qpair_destroy(struct nvme_rdma_qpair *rqpair)
 
 	if (rqpair->cm_id) {
 		if (rqpair->rdma_qp) {
+			if (qpair->poll_group) {
+				RB_REMOVE(nvme_rdma_qpairs_tree,
+					  &nvme_rdma_poll_group(qpair->poll_group)->qpairs, rqpair);
+			}
 			spdk_rdma_put_pd(rqpair->rdma_qp->qp->pd);
 			spdk_rdma_qp_destroy(rqpair->rdma_qp);
 			rqpair->rdma_qp = NULL;
@@ -2459,24 +2483,11 @@ nvme_rdma_fail_qpair(struct spdk_nvme_qpair *qpair, int failure_reason)
 static struct nvme_rdma_qpair *
 get_rdma_qpair_from_wc(struct nvme_rdma_poll_group *group, struct ibv_wc *wc)
 {
-	struct spdk_nvme_qpair *qpair;
-	struct nvme_rdma_qpair *rqpair;
+	struct nvme_rdma_qpair find;
 
-	STAILQ_FOREACH(qpair, &group->group.connected_qpairs, poll_group_stailq) {
-		rqpair = nvme_rdma_qpair(qpair);
-		if (NVME_RDMA_POLL_GROUP_CHECK_QPN(rqpair, wc->qp_num)) {
-			return rqpair;
-		}
-	}
+	find.qp_num = wc->qp_num;
 
-	STAILQ_FOREACH(qpair, &group->group.disconnected_qpairs, poll_group_stailq) {
-		rqpair = nvme_rdma_qpair(qpair);
-		if (NVME_RDMA_POLL_GROUP_CHECK_QPN(rqpair, wc->qp_num)) {
-			return rqpair;
-		}
-	}
-
-	return NULL;
+	return RB_FIND(nvme_rdma_qpairs_tree, &group->qpairs, &find);
 }
 
 static inline void
@@ -3062,6 +3073,7 @@ nvme_rdma_poll_group_create(void)
 	STAILQ_INIT(&group->pollers);
 	TAILQ_INIT(&group->connecting_qpairs);
 	TAILQ_INIT(&group->active_qpairs);
+	RB_INIT(&group->qpairs);
 	return &group->group;
 }
 
@@ -2163,6 +2163,28 @@ nvme_tcp_qpair_check_timeout(struct spdk_nvme_qpair *qpair)
 static int nvme_tcp_ctrlr_connect_qpair_poll(struct spdk_nvme_ctrlr *ctrlr,
 		struct spdk_nvme_qpair *qpair);
 
+static int
+nvme_tcp_qpair_flush(struct spdk_nvme_qpair *qpair)
+{
+	struct nvme_tcp_qpair *tqpair = nvme_tcp_qpair(qpair);
+	int rc;
+
+	/* Qpairs in a poll group have their sockets flushed by the sock group poll. */
+	if (qpair->poll_group != NULL) {
+		return 0;
+	}
+
+	/* Besides sending any queued PDUs, this reaps pending MSG_ZEROCOPY
+	 * completions on zero-copy enabled sockets, releasing their requests.
+	 */
+	rc = spdk_sock_flush(tqpair->sock);
+	if (rc < 0 && errno != EAGAIN) {
+		return -errno;
+	}
+
+	return 0;
+}
+
 static int
 nvme_tcp_qpair_process_completions(struct spdk_nvme_qpair *qpair, uint32_t max_completions)
 {
@@ -2206,6 +2228,15 @@ nvme_tcp_qpair_process_completions(struct spdk_nvme_qpair *qpair, uint32_t max_c
 		goto fail;
 	}
 
+	if (reaped > 0 && qpair->poll_group == NULL) {
+		/* Completion callbacks may have queued new request PDUs.  Flush them
+		 * now, so that they all go out in a single sendmsg during this poll
+		 * instead of waiting for the next one.  Errors are handled by the
+		 * flush at the top of the next poll.
+		 */
+		spdk_sock_flush(tqpair->sock);
+	}
+
 	if (spdk_unlikely(tqpair->qpair.ctrlr->timeout_enabled)) {
 		nvme_tcp_qpair_check_timeout(qpair);
 	}
@@ -3020,6 +3051,7 @@ const struct spdk_nvme_transport_ops tcp_ops = {
 	.qpair_reset = nvme_tcp_qpair_reset,
 	.qpair_submit_request = nvme_tcp_qpair_submit_request,
 	.qpair_process_completions = nvme_tcp_qpair_process_completions,
+	.qpair_flush = nvme_tcp_qpair_flush,
 	.qpair_iterate_requests = nvme_tcp_qpair_iterate_requests,
 	.admin_qpair_abort_aers = nvme_tcp_admin_qpair_abort_aers,
 
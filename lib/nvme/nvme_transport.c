@@ -616,6 +616,51 @@ nvme_transport_qpair_process_completions(struct spdk_nvme_qpair *qpair, uint32_t
 	return transport->ops.qpair_process_completions(qpair, max_completions);
 }
 
+int
+nvme_transport_qpair_flush(struct spdk_nvme_qpair *qpair)
+{
+	const struct spdk_nvme_transport *transport;
+
+	if (spdk_likely(!nvme_qpair_is_admin_queue(qpair))) {
+		transport = qpair->transport;
+	} else {
+		transport = nvme_get_transport(qpair->ctrlr->trid.trstring);
+		assert(transport != NULL);
+	}
+
+	if (transport->ops.qpair_flush == NULL) {
+		/* Nothing to flush - the transport submits commands immediately */
+		return 0;
+	}
+
+	return transport->ops.qpair_flush(qpair);
+}
+
+int
+nvme_transport_qpair_register_payload(struct spdk_nvme_qpair *qpair, void *buffer,
+				      uint32_t payload_size, uint64_t *token)
+{
+	const struct spdk_nvme_transport *transport = qpair->transport;
+
+	if (transport->ops.qpair_register_payload == NULL) {
+		return -ENOTSUP;
+	}
+
+	return transport->ops.qpair_register_payload(qpair, buffer, payload_size, token);
+}
+
+int
+nvme_transport_qpair_unregister_payload(struct spdk_nvme_qpair *qpair, uint64_t token)
+{
+	const struct spdk_nvme_transport *transport = qpair->transport;
+
+	if (transport->ops.qpair_unregister_payload == NULL) {
+		return -ENOTSUP;
+	}
+
+	return transport->ops.qpair_unregister_payload(qpair, token);
+}
+
 int
 nvme_transport_qpair_iterate_requests(struct spdk_nvme_qpair *qpair,
 				      int (*iter_fn)(struct nvme_request *req, void *arg),
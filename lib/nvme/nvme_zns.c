@@ -253,3 +253,378 @@ spdk_nvme_zns_set_zone_desc_ext(struct spdk_nvme_ns *ns, struct spdk_nvme_qpair
 
 	return nvme_qpair_submit_request(qpair, req);
 }
+
+#define NVME_ZNS_SCHED_DEFAULT_ZONE_QD		4
+#define NVME_ZNS_SCHED_DEFAULT_NUM_REQUESTS	128
+
+struct nvme_zns_sched_zone {
+	/* Tracked write pointer, UINT64_MAX until the first append completes. */
+	uint64_t				wp;
+
+	/* Appends outstanding on the qpair for this zone. */
+	uint32_t				inflight;
+
+	/* The zone holds one of the scheduler's open zone budget slots. */
+	bool					open;
+
+	/* The scheduler has seen the zone become full. */
+	bool					full;
+
+	/* The zone is on the pending_zones list waiting for a budget slot. */
+	bool					pending;
+
+	STAILQ_HEAD(, nvme_zns_sched_req)	queued;
+
+	TAILQ_ENTRY(nvme_zns_sched_zone)	link;
+};
+
+struct nvme_zns_sched_req {
+	struct spdk_nvme_zns_scheduler		*sched;
+	struct nvme_zns_sched_zone		*zone;
+	void					*buffer;
+	uint32_t				lba_count;
+	uint32_t				io_flags;
+	spdk_nvme_cmd_cb			cb_fn;
+	void					*cb_arg;
+	STAILQ_ENTRY(nvme_zns_sched_req)	link;
+};
+
+struct spdk_nvme_zns_scheduler {
+	struct spdk_nvme_ns			*ns;
+	struct spdk_nvme_qpair			*qpair;
+	uint64_t				zone_size_sectors;
+	uint64_t				num_zones;
+	uint32_t				max_zone_qd;
+
+	/* Budget slots left for implicitly opening more zones. */
+	uint32_t				open_slots;
+
+	struct nvme_zns_sched_zone		*zones;
+
+	struct nvme_zns_sched_req		*req_mem;
+	STAILQ_HEAD(, nvme_zns_sched_req)	free_reqs;
+
+	/* Zones with queued appends waiting for a budget slot, in arrival order. */
+	TAILQ_HEAD(, nvme_zns_sched_zone)	pending_zones;
+};
+
+static void nvme_zns_sched_append_done(void *arg, const struct spdk_nvme_cpl *cpl);
+
+static struct nvme_zns_sched_zone *
+nvme_zns_sched_get_zone(struct spdk_nvme_zns_scheduler *sched, uint64_t zslba)
+{
+	uint64_t idx;
+
+	if (zslba % sched->zone_size_sectors != 0) {
+		return NULL;
+	}
+
+	idx = zslba / sched->zone_size_sectors;
+	if (idx >= sched->num_zones) {
+		return NULL;
+	}
+
+	return &sched->zones[idx];
+}
+
+static uint64_t
+nvme_zns_sched_zone_slba(struct spdk_nvme_zns_scheduler *sched, struct nvme_zns_sched_zone *zone)
+{
+	return (uint64_t)(zone - sched->zones) * sched->zone_size_sectors;
+}
+
+static void
+nvme_zns_sched_complete_req(struct spdk_nvme_zns_scheduler *sched, struct nvme_zns_sched_req *req,
+			    const struct spdk_nvme_cpl *cpl)
+{
+	spdk_nvme_cmd_cb cb_fn = req->cb_fn;
+	void *cb_arg = req->cb_arg;
+
+	STAILQ_INSERT_HEAD(&sched->free_reqs, req, link);
+
+	if (cb_fn != NULL) {
+		cb_fn(cb_arg, cpl);
+	}
+}
+
+static void
+nvme_zns_sched_zone_kick(struct spdk_nvme_zns_scheduler *sched, struct nvme_zns_sched_zone *zone)
+{
+	struct nvme_zns_sched_req *req;
+	struct spdk_nvme_cpl cpl;
+	uint64_t zslba = nvme_zns_sched_zone_slba(sched, zone);
+	int rc;
+
+	while (zone->inflight < sched->max_zone_qd && !STAILQ_EMPTY(&zone->queued)) {
+		req = STAILQ_FIRST(&zone->queued);
+
+		rc = spdk_nvme_zns_zone_append(sched->ns, sched->qpair, req->buffer, zslba,
+					       req->lba_count, nvme_zns_sched_append_done, req,
+					       req->io_flags);
+		if (rc == 0) {
+			STAILQ_REMOVE_HEAD(&zone->queued, link);
+			zone->inflight++;
+		} else if (rc == -ENOMEM || rc == -EAGAIN) {
+			/* Retried when an append to this zone completes. */
+			break;
+		} else {
+			STAILQ_REMOVE_HEAD(&zone->queued, link);
+			memset(&cpl, 0, sizeof(cpl));
+			cpl.status.sct = SPDK_NVME_SCT_GENERIC;
+			cpl.status.sc = SPDK_NVME_SC_INTERNAL_DEVICE_ERROR;
+			cpl.status.dnr = 1;
+			nvme_zns_sched_complete_req(sched, req, &cpl);
+		}
+	}
+}
+
+static void
+nvme_zns_sched_release_slot(struct spdk_nvme_zns_scheduler *sched, struct nvme_zns_sched_zone *zone)
+{
+	struct nvme_zns_sched_zone *next;
+
+	assert(zone->open);
+	zone->open = false;
+	sched->open_slots++;
+
+	while (sched->open_slots > 0 && !TAILQ_EMPTY(&sched->pending_zones)) {
+		next = TAILQ_FIRST(&sched->pending_zones);
+		TAILQ_REMOVE(&sched->pending_zones, next, link);
+		next->pending = false;
+		next->open = true;
+		sched->open_slots--;
+		nvme_zns_sched_zone_kick(sched, next);
+	}
+}
+
+static void
+nvme_zns_sched_append_done(void *arg, const struct spdk_nvme_cpl *cpl)
+{
+	struct nvme_zns_sched_req *req = arg;
+	struct spdk_nvme_zns_scheduler *sched = req->sched;
+	struct nvme_zns_sched_zone *zone = req->zone;
+	struct nvme_zns_sched_req *queued;
+	uint64_t alba, wp;
+
+	assert(zone->inflight > 0);
+	zone->inflight--;
+
+	if (spdk_nvme_cpl_is_success(cpl)) {
+		/* The assigned LBA of the append is returned in dwords 0 and 1
+		 * of the completion.  Appends may complete out of order, so only
+		 * advance the tracked write pointer.
+		 */
+		alba = ((uint64_t)cpl->cdw1 << 32) | cpl->cdw0;
+		wp = alba + req->lba_count;
+		if (zone->wp == UINT64_MAX || wp > zone->wp) {
+			zone->wp = wp;
+		}
+	} else if (cpl->status.sct == SPDK_NVME_SCT_COMMAND_SPECIFIC &&
+		   cpl->status.sc == SPDK_NVME_SC_ZONE_IS_FULL) {
+		zone->full = true;
+	}
+
+	nvme_zns_sched_complete_req(sched, req, cpl);
+
+	if (zone->full) {
+		/* Fail anything still queued for the zone and hand the budget
+		 * slot to the next waiting zone.
+		 */
+		while (!STAILQ_EMPTY(&zone->queued)) {
+			queued = STAILQ_FIRST(&zone->queued);
+			STAILQ_REMOVE_HEAD(&zone->queued, link);
+			nvme_zns_sched_complete_req(sched, queued, cpl);
+		}
+		if (zone->open && zone->inflight == 0) {
+			nvme_zns_sched_release_slot(sched, zone);
+		}
+	} else {
+		nvme_zns_sched_zone_kick(sched, zone);
+	}
+}
+
+struct spdk_nvme_zns_scheduler *
+spdk_nvme_zns_scheduler_create(struct spdk_nvme_ns *ns, struct spdk_nvme_qpair *qpair,
+			       uint32_t max_zone_qd, uint32_t num_requests)
+{
+	struct spdk_nvme_zns_scheduler *sched;
+	uint64_t i;
+
+	if (ns->csi != SPDK_NVME_CSI_ZNS) {
+		return NULL;
+	}
+
+	sched = calloc(1, sizeof(*sched));
+	if (sched == NULL) {
+		return NULL;
+	}
+
+	sched->ns = ns;
+	sched->qpair = qpair;
+	sched->zone_size_sectors = spdk_nvme_zns_ns_get_zone_size_sectors(ns);
+	sched->num_zones = spdk_nvme_zns_ns_get_num_zones(ns);
+	sched->max_zone_qd = max_zone_qd ? max_zone_qd : NVME_ZNS_SCHED_DEFAULT_ZONE_QD;
+	sched->open_slots = spdk_min(spdk_nvme_zns_ns_get_max_open_zones(ns),
+				     spdk_nvme_zns_ns_get_max_active_zones(ns));
+
+	sched->zones = calloc(sched->num_zones, sizeof(*sched->zones));
+	if (sched->zones == NULL) {
+		free(sched);
+		return NULL;
+	}
+
+	for (i = 0; i < sched->num_zones; i++) {
+		sched->zones[i].wp = UINT64_MAX;
+		STAILQ_INIT(&sched->zones[i].queued);
+	}
+
+	if (num_requests == 0) {
+		num_requests = NVME_ZNS_SCHED_DEFAULT_NUM_REQUESTS;
+	}
+
+	sched->req_mem = calloc(num_requests, sizeof(*sched->req_mem));
+	if (sched->req_mem == NULL) {
+		free(sched->zones);
+		free(sched);
+		return NULL;
+	}
+
+	STAILQ_INIT(&sched->free_reqs);
+	for (i = 0; i < num_requests; i++) {
+		sched->req_mem[i].sched = sched;
+		STAILQ_INSERT_TAIL(&sched->free_reqs, &sched->req_mem[i], link);
+	}
+
+	TAILQ_INIT(&sched->pending_zones);
+
+	return sched;
+}
+
+int
+spdk_nvme_zns_scheduler_append(struct spdk_nvme_zns_scheduler *sched, void *buffer,
+			       uint64_t zslba, uint32_t lba_count,
+			       spdk_nvme_cmd_cb cb_fn, void *cb_arg, uint32_t io_flags)
+{
+	struct nvme_zns_sched_zone *zone;
+	struct nvme_zns_sched_req *req;
+
+	zone = nvme_zns_sched_get_zone(sched, zslba);
+	if (zone == NULL) {
+		return -EINVAL;
+	}
+
+	if (zone->full) {
+		return -ENOSPC;
+	}
+
+	req = STAILQ_FIRST(&sched->free_reqs);
+	if (req == NULL) {
+		return -ENOMEM;
+	}
+	STAILQ_REMOVE_HEAD(&sched->free_reqs, link);
+
+	req->zone = zone;
+	req->buffer = buffer;
+	req->lba_count = lba_count;
+	req->io_flags = io_flags;
+	req->cb_fn = cb_fn;
+	req->cb_arg = cb_arg;
+
+	STAILQ_INSERT_TAIL(&zone->queued, req, link);
+
+	if (!zone->open && !zone->pending) {
+		if (sched->open_slots > 0) {
+			sched->open_slots--;
+			zone->open = true;
+		} else {
+			zone->pending = true;
+			TAILQ_INSERT_TAIL(&sched->pending_zones, zone, link);
+		}
+	}
+
+	if (zone->open) {
+		nvme_zns_sched_zone_kick(sched, zone);
+	}
+
+	return 0;
+}
+
+uint64_t
+spdk_nvme_zns_scheduler_get_write_pointer(struct spdk_nvme_zns_scheduler *sched, uint64_t zslba)
+{
+	struct nvme_zns_sched_zone *zone;
+
+	zone = nvme_zns_sched_get_zone(sched, zslba);
+	if (zone == NULL) {
+		return UINT64_MAX;
+	}
+
+	return zone->wp;
+}
+
+static void
+nvme_zns_sched_finish_done(void *arg, const struct spdk_nvme_cpl *cpl)
+{
+	struct nvme_zns_sched_req *req = arg;
+	struct spdk_nvme_zns_scheduler *sched = req->sched;
+	struct nvme_zns_sched_zone *zone = req->zone;
+
+	if (spdk_nvme_cpl_is_success(cpl)) {
+		zone->full = true;
+	}
+
+	if (zone->open) {
+		nvme_zns_sched_release_slot(sched, zone);
+	}
+
+	nvme_zns_sched_complete_req(sched, req, cpl);
+}
+
+int
+spdk_nvme_zns_scheduler_finish_zone(struct spdk_nvme_zns_scheduler *sched, uint64_t zslba,
+				    spdk_nvme_cmd_cb cb_fn, void *cb_arg)
+{
+	struct nvme_zns_sched_zone *zone;
+	struct nvme_zns_sched_req *req;
+	int rc;
+
+	zone = nvme_zns_sched_get_zone(sched, zslba);
+	if (zone == NULL) {
+		return -EINVAL;
+	}
+
+	if (zone->inflight > 0 || !STAILQ_EMPTY(&zone->queued) || zone->pending) {
+		return -EBUSY;
+	}
+
+	req = STAILQ_FIRST(&sched->free_reqs);
+	if (req == NULL) {
+		return -ENOMEM;
+	}
+	STAILQ_REMOVE_HEAD(&sched->free_reqs, link);
+
+	req->zone = zone;
+	req->cb_fn = cb_fn;
+	req->cb_arg = cb_arg;
+
+	rc = spdk_nvme_zns_finish_zone(sched->ns, sched->qpair, zslba, false,
+				       nvme_zns_sched_finish_done, req);
+	if (rc != 0) {
+		STAILQ_INSERT_HEAD(&sched->free_reqs, req, link);
+		return rc;
+	}
+
+	return 0;
+}
+
+void
+spdk_nvme_zns_scheduler_free(struct spdk_nvme_zns_scheduler *sched)
+{
+	if (sched == NULL) {
+		return;
+	}
+
+	free(sched->req_mem);
+	free(sched->zones);
+	free(sched);
+}
@@ -43,6 +43,14 @@
 
 #define NVMF_ABORT_COMMAND_LIMIT 3
 
+/* Per-host QoS token accounting */
+#define NVMF_QOS_TIMESLICE_IN_USEC	1000
+/* Batch sizes for moving tokens from the shared pools into qpair-local caches */
+#define NVMF_QOS_IO_BATCH		8
+#define NVMF_QOS_BYTE_BATCH		(64 * 1024)
+/* Unused tokens accumulate in the shared pools for up to this much burst */
+#define NVMF_QOS_BURST_IN_USEC		10000
+
 /*
  * Support for custom admin command handlers
  */
@@ -216,6 +224,80 @@ nvmf_ctrlr_start_keep_alive_timer(struct spdk_nvmf_ctrlr *ctrlr)
 	}
 }
 
+static void
+nvmf_qos_pool_refill(int64_t *pool, uint64_t rate, uint64_t elapsed, uint64_t ticks_hz,
+		     uint64_t *residual, int64_t batch)
+{
+	uint64_t acc;
+	int64_t tokens, cap, cur;
+
+	if (rate == 0) {
+		return;
+	}
+
+	acc = elapsed * rate + *residual;
+	tokens = acc / ticks_hz;
+	*residual = acc % ticks_hz;
+	if (tokens == 0) {
+		return;
+	}
+
+	cap = spdk_max((int64_t)(rate / (SPDK_SEC_TO_USEC / NVMF_QOS_BURST_IN_USEC)), batch);
+	cur = __atomic_add_fetch(pool, tokens, __ATOMIC_RELAXED);
+	if (cur > cap) {
+		/* Consumers only ever take tokens, so trimming the overshoot
+		 * cannot push the pool below the cap.
+		 */
+		__atomic_fetch_sub(pool, cur - cap, __ATOMIC_RELAXED);
+	}
+}
+
+static int
+nvmf_ctrlr_qos_poll(void *ctx)
+{
+	struct spdk_nvmf_ctrlr *ctrlr = ctx;
+	uint64_t ticks_hz = spdk_get_ticks_hz();
+	uint64_t now = spdk_get_ticks();
+	uint64_t elapsed;
+
+	/* Cap the elapsed time at one second so that a stalled reactor does
+	 * not turn into an unbounded burst allowance.
+	 */
+	elapsed = spdk_min(now - ctrlr->qos_last_tick, ticks_hz);
+	ctrlr->qos_last_tick = now;
+
+	nvmf_qos_pool_refill(&ctrlr->qos_io_pool,
+			     __atomic_load_n(&ctrlr->qos_ios_per_sec, __ATOMIC_RELAXED),
+			     elapsed, ticks_hz, &ctrlr->qos_io_residual, NVMF_QOS_IO_BATCH);
+	nvmf_qos_pool_refill(&ctrlr->qos_byte_pool,
+			     __atomic_load_n(&ctrlr->qos_bytes_per_sec, __ATOMIC_RELAXED),
+			     elapsed, ticks_hz, &ctrlr->qos_byte_residual, NVMF_QOS_BYTE_BATCH);
+
+	return SPDK_POLLER_BUSY;
+}
+
+void
+nvmf_ctrlr_start_qos_poller(struct spdk_nvmf_ctrlr *ctrlr)
+{
+	bool enabled;
+
+	enabled = __atomic_load_n(&ctrlr->qos_ios_per_sec, __ATOMIC_RELAXED) != 0 ||
+		  __atomic_load_n(&ctrlr->qos_bytes_per_sec, __ATOMIC_RELAXED) != 0;
+
+	if (enabled == (ctrlr->qos_poller != NULL)) {
+		return;
+	}
+
+	if (enabled) {
+		SPDK_DEBUGLOG(nvmf, "Ctrlr add QoS refill poller\n");
+		ctrlr->qos_last_tick = spdk_get_ticks();
+		ctrlr->qos_poller = SPDK_POLLER_REGISTER(nvmf_ctrlr_qos_poll, ctrlr,
+				    NVMF_QOS_TIMESLICE_IN_USEC);
+	} else {
+		spdk_poller_unregister(&ctrlr->qos_poller);
+	}
+}
+
 static void
 nvmf_qpair_set_ctrlr(struct spdk_nvmf_qpair *qpair, struct spdk_nvmf_ctrlr *ctrlr)
 {
@@ -521,6 +603,10 @@ nvmf_ctrlr_create(struct spdk_nvmf_subsystem *subsystem,
 	spdk_uuid_copy(&ctrlr->hostid, (struct spdk_uuid *)connect_data->hostid);
 	memcpy(ctrlr->hostnqn, connect_data->hostnqn, SPDK_NVMF_NQN_MAX_LEN);
 
+	nvmf_subsystem_get_host_qos(subsystem, ctrlr->hostnqn, &ctrlr->qos_ios_per_sec,
+				    &ctrlr->qos_bytes_per_sec);
+	nvmf_ctrlr_start_qos_poller(ctrlr);
+
 	ctrlr->visible_ns = spdk_bit_array_create(subsystem->max_nsid);
 	if (!ctrlr->visible_ns) {
 		SPDK_ERRLOG("Failed to allocate visible namespace array\n");
@@ -617,6 +703,7 @@ _nvmf_ctrlr_destruct(void *ctx)
 
 	nvmf_ctrlr_stop_keep_alive_timer(ctrlr);
 	nvmf_ctrlr_stop_association_timer(ctrlr);
+	spdk_poller_unregister(&ctrlr->qos_poller);
 	spdk_bit_array_free(&ctrlr->qpair_mask);
 
 	TAILQ_FOREACH_SAFE(log, &ctrlr->log_head, link, log_tmp) {
@@ -628,6 +715,8 @@ _nvmf_ctrlr_destruct(void *ctx)
 		free(event);
 	}
 	spdk_bit_array_free(&ctrlr->visible_ns);
+	free(ctrlr->ana_log_page);
+	free(ctrlr->disc_log_page);
 	free(ctrlr);
 }
 
@@ -2062,7 +2151,11 @@ nvmf_ctrlr_set_features_number_of_queues(struct spdk_nvmf_request *req)
 	return SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE;
 }
 
-SPDK_STATIC_ASSERT(sizeof(struct spdk_nvmf_ctrlr) == 4928,
+/* The per-host QoS fields are transient token bucket state and are not part
+ * of the migration data - limits are re-read from the subsystem's host entry
+ * when the controller is created on the destination.
+ */
+SPDK_STATIC_ASSERT(sizeof(struct spdk_nvmf_ctrlr) == 5608,
 		   "Please check migration fields that need to be added or not");
 
 static void
@@ -2324,103 +2417,109 @@ nvmf_get_error_log_page(struct spdk_nvmf_ctrlr *ctrlr, struct iovec *iovs, int i
 	/* TODO: actually fill out log page data */
 }
 
-static void
-nvmf_get_ana_log_page(struct spdk_nvmf_ctrlr *ctrlr, struct iovec *iovs, int iovcnt,
-		      uint64_t offset, uint32_t length, uint32_t rae)
+static int
+nvmf_ctrlr_update_ana_log_page(struct spdk_nvmf_ctrlr *ctrlr)
 {
+	struct spdk_nvmf_subsystem *subsystem = ctrlr->subsys;
 	struct spdk_nvme_ana_page ana_hdr;
 	struct spdk_nvme_ana_group_descriptor ana_desc;
-	size_t copy_len, copied_len;
-	uint32_t num_anagrp = 0, anagrpid;
+	uint32_t num_anagrp = 0, num_ns = 0, anagrpid;
 	struct spdk_nvmf_ns *ns;
-	struct spdk_iov_xfer ix;
+	size_t size, offset;
+	size_t *grp_offset;
+	char *buf;
+
+	for (anagrpid = 1; anagrpid <= subsystem->max_nsid; anagrpid++) {
+		if (subsystem->ana_group[anagrpid - 1] > 0) {
+			num_anagrp++;
+			num_ns += subsystem->ana_group[anagrpid - 1];
+		}
+	}
 
-	spdk_iov_xfer_init(&ix, iovs, iovcnt);
+	size = sizeof(ana_hdr) + num_anagrp * sizeof(ana_desc) + num_ns * sizeof(uint32_t);
 
-	if (length == 0) {
-		goto done;
+	if (ctrlr->ana_log_page == NULL || ctrlr->ana_log_page_size != size) {
+		buf = realloc(ctrlr->ana_log_page, size);
+		if (buf == NULL) {
+			return -ENOMEM;
+		}
+		ctrlr->ana_log_page = buf;
+		ctrlr->ana_log_page_size = size;
 	}
 
-	if (offset >= sizeof(ana_hdr)) {
-		offset -= sizeof(ana_hdr);
-	} else {
-		for (anagrpid = 1; anagrpid <= ctrlr->subsys->max_nsid; anagrpid++) {
-			if (ctrlr->subsys->ana_group[anagrpid - 1] > 0) {
-				num_anagrp++;
-			}
+	/* Offset of each group's next NSID slot, so that the namespace list can be
+	 * filled in a single pass over the namespaces below.
+	 */
+	grp_offset = calloc(subsystem->max_nsid, sizeof(*grp_offset));
+	if (grp_offset == NULL) {
+		return -ENOMEM;
+	}
+
+	buf = ctrlr->ana_log_page;
+
+	memset(&ana_hdr, 0, sizeof(ana_hdr));
+	ana_hdr.num_ana_group_desc = num_anagrp;
+	/* TODO: Support Change Count. */
+	ana_hdr.change_count = 0;
+	memcpy(buf, &ana_hdr, sizeof(ana_hdr));
+	offset = sizeof(ana_hdr);
+
+	for (anagrpid = 1; anagrpid <= subsystem->max_nsid; anagrpid++) {
+		if (subsystem->ana_group[anagrpid - 1] == 0) {
+			continue;
 		}
 
-		memset(&ana_hdr, 0, sizeof(ana_hdr));
+		memset(&ana_desc, 0, sizeof(ana_desc));
+
+		ana_desc.ana_group_id = anagrpid;
+		ana_desc.num_of_nsid = subsystem->ana_group[anagrpid - 1];
+		ana_desc.ana_state = nvmf_ctrlr_get_ana_state(ctrlr, anagrpid);
 
-		ana_hdr.num_ana_group_desc = num_anagrp;
-		/* TODO: Support Change Count. */
-		ana_hdr.change_count = 0;
+		memcpy(buf + offset, &ana_desc, sizeof(ana_desc));
+		offset += sizeof(ana_desc);
 
-		copy_len = spdk_min(sizeof(ana_hdr) - offset, length);
-		copied_len = spdk_iov_xfer_from_buf(&ix, (const char *)&ana_hdr + offset, copy_len);
-		assert(copied_len == copy_len);
-		length -= copied_len;
-		offset = 0;
+		grp_offset[anagrpid - 1] = offset;
+		offset += ana_desc.num_of_nsid * sizeof(uint32_t);
 	}
 
-	if (length == 0) {
-		goto done;
+	for (ns = spdk_nvmf_subsystem_get_first_ns(subsystem); ns != NULL;
+	     ns = spdk_nvmf_subsystem_get_next_ns(subsystem, ns)) {
+		memcpy(buf + grp_offset[ns->anagrpid - 1], &ns->nsid, sizeof(uint32_t));
+		grp_offset[ns->anagrpid - 1] += sizeof(uint32_t);
 	}
 
-	for (anagrpid = 1; anagrpid <= ctrlr->subsys->max_nsid; anagrpid++) {
-		if (ctrlr->subsys->ana_group[anagrpid - 1] == 0) {
-			continue;
-		}
+	free(grp_offset);
 
-		if (offset >= sizeof(ana_desc)) {
-			offset -= sizeof(ana_desc);
-		} else {
-			memset(&ana_desc, 0, sizeof(ana_desc));
+	ctrlr->ana_log_page_dirty = false;
 
-			ana_desc.ana_group_id = anagrpid;
-			ana_desc.num_of_nsid = ctrlr->subsys->ana_group[anagrpid - 1];
-			ana_desc.ana_state = nvmf_ctrlr_get_ana_state(ctrlr, anagrpid);
+	return 0;
+}
 
-			copy_len = spdk_min(sizeof(ana_desc) - offset, length);
-			copied_len = spdk_iov_xfer_from_buf(&ix, (const char *)&ana_desc + offset,
-							    copy_len);
-			assert(copied_len == copy_len);
-			length -= copied_len;
-			offset = 0;
+static void
+nvmf_get_ana_log_page(struct spdk_nvmf_ctrlr *ctrlr, struct iovec *iovs, int iovcnt,
+		      uint64_t offset, uint32_t length, uint32_t rae)
+{
+	struct spdk_iov_xfer ix;
+	size_t copy_len;
+	int rc;
 
-			if (length == 0) {
-				goto done;
-			}
+	if (ctrlr->ana_log_page == NULL || ctrlr->ana_log_page_dirty) {
+		rc = nvmf_ctrlr_update_ana_log_page(ctrlr);
+		if (rc != 0) {
+			/* Serve the previous contents, if any - the host will fetch
+			 * the log page again after the next ANA change notice.
+			 */
+			SPDK_ERRLOG("ANA log page update failed, rc %d\n", rc);
 		}
+	}
 
-		/* TODO: Revisit here about O(n^2) cost if we have subsystem with
-		 * many namespaces in the future.
-		 */
-		for (ns = spdk_nvmf_subsystem_get_first_ns(ctrlr->subsys); ns != NULL;
-		     ns = spdk_nvmf_subsystem_get_next_ns(ctrlr->subsys, ns)) {
-			if (ns->anagrpid != anagrpid) {
-				continue;
-			}
-
-			if (offset >= sizeof(uint32_t)) {
-				offset -= sizeof(uint32_t);
-				continue;
-			}
-
-			copy_len = spdk_min(sizeof(uint32_t) - offset, length);
-			copied_len = spdk_iov_xfer_from_buf(&ix, (const char *)&ns->nsid + offset,
-							    copy_len);
-			assert(copied_len == copy_len);
-			length -= copied_len;
-			offset = 0;
+	if (ctrlr->ana_log_page != NULL && offset < ctrlr->ana_log_page_size && length > 0) {
+		spdk_iov_xfer_init(&ix, iovs, iovcnt);
 
-			if (length == 0) {
-				goto done;
-			}
-		}
+		copy_len = spdk_min(length, ctrlr->ana_log_page_size - offset);
+		spdk_iov_xfer_from_buf(&ix, (char *)ctrlr->ana_log_page + offset, copy_len);
 	}
 
-done:
 	if (!rae) {
 		nvmf_ctrlr_unmask_aen(ctrlr, SPDK_NVME_ASYNC_EVENT_ANA_CHANGE_MASK_BIT);
 	}
@@ -2433,6 +2532,8 @@ nvmf_ctrlr_ns_changed(struct spdk_nvmf_ctrlr *ctrlr, uint32_t nsid)
 	uint16_t i;
 	bool found = false;
 
+	ctrlr->ana_log_page_dirty = true;
+
 	for (i = 0; i < ctrlr->changed_ns_list_count; i++) {
 		if (ctrlr->changed_ns_list.ns_list[i] == nsid) {
 			/* nsid is already in the list */
@@ -2640,7 +2741,7 @@ nvmf_ctrlr_get_log_page(struct spdk_nvmf_request *req)
 				response->status.sc = SPDK_NVME_SC_INTERNAL_DEVICE_ERROR;
 				return SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE;
 			}
-			nvmf_get_discovery_log_page(subsystem->tgt, ctrlr->hostnqn, req->iov, req->iovcnt,
+			nvmf_get_discovery_log_page(ctrlr, req->iov, req->iovcnt,
 						    offset, len, &cmd_source_trid);
 			if (!rae) {
 				nvmf_ctrlr_unmask_aen(ctrlr, SPDK_NVME_ASYNC_EVENT_DISCOVERY_LOG_CHANGE_MASK_BIT);
@@ -4178,54 +4279,63 @@ exit:
 }
 
 static int
-nvmf_ctrlr_process_io_fused_cmd(struct spdk_nvmf_request *req, struct spdk_bdev *bdev,
-				struct spdk_bdev_desc *desc, struct spdk_io_channel *ch)
+nvmf_ctrlr_process_io_fused_first(struct spdk_nvmf_request *req)
 {
 	struct spdk_nvme_cmd *cmd = &req->cmd->nvme_cmd;
 	struct spdk_nvme_cpl *rsp = &req->rsp->nvme_cpl;
 	struct spdk_nvmf_request *first_fused_req = req->qpair->first_fused_req;
-	int rc;
 
-	if (cmd->fuse == SPDK_NVME_CMD_FUSE_FIRST) {
-		/* first fused operation (should be compare) */
-		if (first_fused_req != NULL) {
-			struct spdk_nvme_cpl *fused_response = &first_fused_req->rsp->nvme_cpl;
+	/* first fused operation (should be compare) */
+	if (spdk_unlikely(first_fused_req != NULL)) {
+		struct spdk_nvme_cpl *fused_response = &first_fused_req->rsp->nvme_cpl;
 
-			SPDK_ERRLOG("Wrong sequence of fused operations\n");
+		SPDK_ERRLOG("Wrong sequence of fused operations\n");
 
-			/* abort req->qpair->first_fused_request and continue with new fused command */
-			fused_response->status.sc = SPDK_NVME_SC_ABORTED_MISSING_FUSED;
-			fused_response->status.sct = SPDK_NVME_SCT_GENERIC;
-			_nvmf_request_complete(first_fused_req);
-		} else if (cmd->opc != SPDK_NVME_OPC_COMPARE) {
-			SPDK_ERRLOG("Wrong op code of fused operations\n");
-			rsp->status.sct = SPDK_NVME_SCT_GENERIC;
-			rsp->status.sc = SPDK_NVME_SC_INVALID_OPCODE;
-			return SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE;
-		}
+		/* abort req->qpair->first_fused_request and continue with new fused command */
+		req->qpair->first_fused_req = NULL;
+		fused_response->status.sc = SPDK_NVME_SC_ABORTED_MISSING_FUSED;
+		fused_response->status.sct = SPDK_NVME_SCT_GENERIC;
+		_nvmf_request_complete(first_fused_req);
+	} else if (spdk_unlikely(cmd->opc != SPDK_NVME_OPC_COMPARE)) {
+		SPDK_ERRLOG("Wrong op code of fused operations\n");
+		rsp->status.sct = SPDK_NVME_SCT_GENERIC;
+		rsp->status.sc = SPDK_NVME_SC_INVALID_OPCODE;
+		return SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE;
+	}
 
-		req->qpair->first_fused_req = req;
-		return SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS;
-	} else if (cmd->fuse == SPDK_NVME_CMD_FUSE_SECOND) {
+	req->qpair->first_fused_req = req;
+	return SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS;
+}
+
+static int
+nvmf_ctrlr_process_io_fused_cmd(struct spdk_nvmf_request *req, struct spdk_bdev *bdev,
+				struct spdk_bdev_desc *desc, struct spdk_io_channel *ch)
+{
+	struct spdk_nvme_cmd *cmd = &req->cmd->nvme_cmd;
+	struct spdk_nvme_cpl *rsp = &req->rsp->nvme_cpl;
+	struct spdk_nvmf_request *first_fused_req = req->qpair->first_fused_req;
+	int rc;
+
+	if (spdk_likely(cmd->fuse == SPDK_NVME_CMD_FUSE_SECOND)) {
 		/* second fused operation (should be write) */
-		if (first_fused_req == NULL) {
+		if (spdk_unlikely(first_fused_req == NULL)) {
 			SPDK_ERRLOG("Wrong sequence of fused operations\n");
 			rsp->status.sct = SPDK_NVME_SCT_GENERIC;
 			rsp->status.sc = SPDK_NVME_SC_ABORTED_MISSING_FUSED;
 			return SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE;
-		} else if (cmd->opc != SPDK_NVME_OPC_WRITE) {
+		} else if (spdk_unlikely(cmd->opc != SPDK_NVME_OPC_WRITE)) {
 			struct spdk_nvme_cpl *fused_response = &first_fused_req->rsp->nvme_cpl;
 
 			SPDK_ERRLOG("Wrong op code of fused operations\n");
 
 			/* abort req->qpair->first_fused_request and fail current command */
+			req->qpair->first_fused_req = NULL;
 			fused_response->status.sc = SPDK_NVME_SC_ABORTED_MISSING_FUSED;
 			fused_response->status.sct = SPDK_NVME_SCT_GENERIC;
 			_nvmf_request_complete(first_fused_req);
 
 			rsp->status.sct = SPDK_NVME_SCT_GENERIC;
 			rsp->status.sc = SPDK_NVME_SC_INVALID_OPCODE;
-			req->qpair->first_fused_req = NULL;
 			return SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE;
 		}
 
@@ -4234,6 +4344,8 @@ nvmf_ctrlr_process_io_fused_cmd(struct spdk_nvmf_request *req, struct spdk_bdev
 		req->first_fused = true;
 		req->qpair->first_fused_req = NULL;
 	} else {
+		/* FUSE_FIRST commands are parked by nvmf_ctrlr_process_io_cmd before
+		 * the per-namespace checks, so only a reserved fuse value gets here. */
 		SPDK_ERRLOG("Invalid fused command fuse field.\n");
 		rsp->status.sct = SPDK_NVME_SCT_GENERIC;
 		rsp->status.sc = SPDK_NVME_SC_INVALID_FIELD;
@@ -4343,6 +4455,13 @@ nvmf_ctrlr_process_io_cmd(struct spdk_nvmf_request *req)
 		return SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE;
 	}
 
+	if (spdk_unlikely(cmd->fuse == SPDK_NVME_CMD_FUSE_FIRST)) {
+		/* The first of a fused pair is only held until its companion arrives,
+		 * so park it right away.  The per-namespace checks are deferred to the
+		 * second command, which validates and submits the pair as one unit. */
+		return nvmf_ctrlr_process_io_fused_first(req);
+	}
+
 	ns = nvmf_ctrlr_get_ns(ctrlr, nsid);
 	if (spdk_unlikely(ns == NULL || ns->bdev == NULL)) {
 		SPDK_DEBUGLOG(nvmf, "Unsuccessful query for nsid %u\n", cmd->nsid);
@@ -4379,6 +4498,7 @@ nvmf_ctrlr_process_io_cmd(struct spdk_nvmf_request *req)
 	bdev = ns->bdev;
 	desc = ns->desc;
 	ch = ns_info->channel;
+	req->submit_tsc = spdk_get_ticks();
 
 	if (spdk_unlikely(cmd->fuse & SPDK_NVME_CMD_FUSE_MASK)) {
 		return nvmf_ctrlr_process_io_fused_cmd(req, bdev, desc, ch);
@@ -4494,6 +4614,23 @@ _nvmf_request_complete(void *ctx)
 		sgroup = nvmf_subsystem_pg_from_connect_cmd(req);
 	}
 
+	if (spdk_unlikely(qpair->first_fused_req != NULL &&
+			  req->cmd->nvme_cmd.fuse == SPDK_NVME_CMD_FUSE_SECOND &&
+			  qpair->first_fused_req != req)) {
+		/* The second of a fused pair failed before the pair was matched, e.g.
+		 * on a namespace check.  Abort the parked first command now instead of
+		 * leaving it to dangle until the next command on the queue. */
+		struct spdk_nvmf_request *first_req = qpair->first_fused_req;
+		struct spdk_nvme_cpl *fused_response = &first_req->rsp->nvme_cpl;
+
+		SPDK_ERRLOG("Second of fused commands failed before the pair was matched\n");
+
+		qpair->first_fused_req = NULL;
+		fused_response->status.sc = SPDK_NVME_SC_ABORTED_MISSING_FUSED;
+		fused_response->status.sct = SPDK_NVME_SCT_GENERIC;
+		_nvmf_request_complete(first_req);
+	}
+
 	if (SPDK_DEBUGLOG_FLAG_ENABLED("nvmf")) {
 		spdk_nvme_print_completion(qpair->qid, rsp);
 	}
@@ -4713,8 +4850,74 @@ nvmf_check_qpair_active(struct spdk_nvmf_request *req)
 	return false;
 }
 
-void
-spdk_nvmf_request_exec(struct spdk_nvmf_request *req)
+static bool
+nvmf_qos_credits_get(int64_t *credits, int64_t *pool, int64_t batch)
+{
+	int64_t cur, take;
+
+	if (spdk_likely(*credits > 0)) {
+		return true;
+	}
+
+	/* Cover the accumulated debt plus one batch so that the shared pool
+	 * is not hit on every command.
+	 */
+	cur = __atomic_load_n(pool, __ATOMIC_RELAXED);
+	do {
+		if (cur <= 0) {
+			return false;
+		}
+		take = spdk_min(cur, batch - *credits);
+	} while (!__atomic_compare_exchange_n(pool, &cur, cur - take, false,
+					      __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	*credits += take;
+
+	return *credits > 0;
+}
+
+static bool
+nvmf_qpair_qos_try_charge(struct spdk_nvmf_request *req)
+{
+	struct spdk_nvmf_qpair *qpair = req->qpair;
+	struct spdk_nvmf_ctrlr *ctrlr = qpair->ctrlr;
+	uint64_t ios_per_sec, bytes_per_sec;
+
+	if (ctrlr == NULL || spdk_unlikely(req->cmd->nvmf_cmd.opcode == SPDK_NVME_OPC_FABRIC ||
+					   nvmf_qpair_is_admin_queue(qpair))) {
+		/* Fabrics and admin commands are never throttled. */
+		return true;
+	}
+
+	ios_per_sec = __atomic_load_n(&ctrlr->qos_ios_per_sec, __ATOMIC_RELAXED);
+	bytes_per_sec = __atomic_load_n(&ctrlr->qos_bytes_per_sec, __ATOMIC_RELAXED);
+	if (spdk_likely(ios_per_sec == 0 && bytes_per_sec == 0)) {
+		return true;
+	}
+
+	if (ios_per_sec != 0 &&
+	    !nvmf_qos_credits_get(&qpair->qos_io_credits, &ctrlr->qos_io_pool,
+				  NVMF_QOS_IO_BATCH)) {
+		return false;
+	}
+	if (bytes_per_sec != 0 &&
+	    !nvmf_qos_credits_get(&qpair->qos_byte_credits, &ctrlr->qos_byte_pool,
+				  NVMF_QOS_BYTE_BATCH)) {
+		return false;
+	}
+
+	if (ios_per_sec != 0) {
+		qpair->qos_io_credits--;
+	}
+	if (bytes_per_sec != 0) {
+		qpair->qos_byte_credits -= req->length;
+	}
+
+	return true;
+}
+
+static void
+nvmf_request_exec_dispatch(struct spdk_nvmf_request *req)
 {
 	struct spdk_nvmf_qpair *qpair = req->qpair;
 	enum spdk_nvmf_request_exec_status status;
@@ -4746,6 +4949,38 @@ spdk_nvmf_request_exec(struct spdk_nvmf_request *req)
 	}
 }
 
+void
+spdk_nvmf_request_exec(struct spdk_nvmf_request *req)
+{
+	if (spdk_unlikely(!nvmf_qpair_qos_try_charge(req))) {
+		/* Over the host's QoS rate limits.  Park the request until the
+		 * token buckets refill.
+		 */
+		TAILQ_INSERT_TAIL(&req->qpair->group->qos_queued, req, link);
+		return;
+	}
+
+	nvmf_request_exec_dispatch(req);
+}
+
+void
+nvmf_poll_group_qos_drain(struct spdk_nvmf_poll_group *group)
+{
+	struct spdk_nvmf_request *req;
+
+	/* Resubmit in submission order, stopping at the first request that
+	 * still lacks credits so that large commands are not starved by
+	 * later small ones.
+	 */
+	while ((req = TAILQ_FIRST(&group->qos_queued)) != NULL) {
+		if (!nvmf_qpair_qos_try_charge(req)) {
+			break;
+		}
+		TAILQ_REMOVE(&group->qos_queued, req, link);
+		nvmf_request_exec_dispatch(req);
+	}
+}
+
 static bool
 nvmf_ctrlr_get_dif_ctx(struct spdk_nvmf_ctrlr *ctrlr, struct spdk_nvme_cmd *cmd,
 		       struct spdk_dif_ctx *dif_ctx)
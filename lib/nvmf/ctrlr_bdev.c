@@ -66,6 +66,48 @@ nvmf_ctrlr_copy_supported(struct spdk_nvmf_ctrlr *ctrlr)
 	return nvmf_subsystem_bdev_io_type_supported(ctrlr->subsys, SPDK_BDEV_IO_TYPE_COPY);
 }
 
+static void
+nvmf_bdev_ctrlr_update_ns_stat(struct spdk_nvmf_request *req)
+{
+	struct spdk_nvmf_poll_group *group = req->qpair->group;
+	struct spdk_nvmf_ctrlr *ctrlr = req->qpair->ctrlr;
+	struct spdk_nvmf_subsystem_poll_group *sgroup;
+	struct spdk_nvmf_ns_stat *stat;
+	uint32_t nsid = req->cmd->nvme_cmd.nsid;
+	uint64_t tsc_diff;
+
+	if (spdk_unlikely(group == NULL || ctrlr == NULL)) {
+		return;
+	}
+
+	sgroup = &group->sgroups[ctrlr->subsys->id];
+	if (spdk_unlikely(nsid == 0 || nsid > sgroup->num_ns)) {
+		return;
+	}
+
+	/* The slot belongs to this poll group, so plain additions are safe. */
+	stat = &sgroup->ns_info[nsid - 1].stat;
+	tsc_diff = spdk_get_ticks() - req->submit_tsc;
+
+	switch (req->cmd->nvme_cmd.opc) {
+	case SPDK_NVME_OPC_READ:
+	case SPDK_NVME_OPC_COMPARE:
+		stat->num_read_ops++;
+		stat->read_bytes += req->length;
+		stat->read_latency_ticks += tsc_diff;
+		break;
+	case SPDK_NVME_OPC_WRITE:
+	case SPDK_NVME_OPC_WRITE_ZEROES:
+		stat->num_write_ops++;
+		stat->written_bytes += req->length;
+		stat->write_latency_ticks += tsc_diff;
+		break;
+	default:
+		stat->num_other_ops++;
+		break;
+	}
+}
+
 static void
 nvmf_bdev_ctrlr_complete_cmd(struct spdk_bdev_io *bdev_io, bool success,
 			     void *cb_arg)
@@ -98,6 +140,7 @@ nvmf_bdev_ctrlr_complete_cmd(struct spdk_bdev_io *bdev_io, bool success,
 	response->status.sc = sc;
 	response->status.sct = sct;
 
+	nvmf_bdev_ctrlr_update_ns_stat(req);
 	spdk_nvmf_request_complete(req);
 	spdk_bdev_free_io(bdev_io);
 }
@@ -217,6 +260,9 @@ nvmf_bdev_ctrlr_get_rw_ext_params(const struct spdk_nvme_cmd *cmd,
 
 	/* Get CDW13 values */
 	opts->nvme_cdw13.raw = from_le32(&cmd->cdw13);
+
+	/* Bdev layer emulates FUA when the backing device lacks native support */
+	opts->fua = opts->nvme_cdw12.write.fua;
 }
 
 static bool
@@ -335,7 +381,7 @@ nvmf_bdev_ctrlr_write_cmd(struct spdk_bdev *bdev, struct spdk_bdev_desc *desc,
 			  struct spdk_io_channel *ch, struct spdk_nvmf_request *req)
 {
 	struct spdk_bdev_ext_io_opts opts = {
-		.size = SPDK_SIZEOF(&opts, nvme_cdw13),
+		.size = SPDK_SIZEOF(&opts, fua),
 		.memory_domain = req->memory_domain,
 		.memory_domain_ctx = req->memory_domain_ctx,
 		.accel_sequence = req->accel_sequence,
@@ -443,6 +489,13 @@ nvmf_bdev_ctrlr_compare_and_write_cmd(struct spdk_bdev *bdev, struct spdk_bdev_d
 	nvmf_bdev_ctrlr_get_rw_params(cmp_cmd, &cmp_start_lba, &cmp_num_blocks);
 	nvmf_bdev_ctrlr_get_rw_params(write_cmd, &write_start_lba, &write_num_blocks);
 
+	if (spdk_unlikely(write_cmd->nsid != cmp_cmd->nsid)) {
+		SPDK_ERRLOG("Fused command namespace mismatch\n");
+		rsp->status.sct = SPDK_NVME_SCT_GENERIC;
+		rsp->status.sc = SPDK_NVME_SC_INVALID_FIELD;
+		return SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE;
+	}
+
 	if (spdk_unlikely(write_start_lba != cmp_start_lba || write_num_blocks != cmp_num_blocks)) {
 		SPDK_ERRLOG("Fused command start lba / num blocks mismatch\n");
 		rsp->status.sct = SPDK_NVME_SCT_GENERIC;
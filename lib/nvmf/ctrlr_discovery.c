@@ -203,42 +203,62 @@ nvmf_generate_discovery_log(struct spdk_nvmf_tgt *tgt, const char *hostnqn, size
 }
 
 void
-nvmf_get_discovery_log_page(struct spdk_nvmf_tgt *tgt, const char *hostnqn, struct iovec *iov,
+nvmf_get_discovery_log_page(struct spdk_nvmf_ctrlr *ctrlr, struct iovec *iov,
 			    uint32_t iovcnt, uint64_t offset, uint32_t length,
 			    struct spdk_nvme_transport_id *cmd_source_trid)
 {
+	struct spdk_nvmf_tgt *tgt = ctrlr->subsys->tgt;
 	size_t copy_len = 0;
 	size_t zero_len = 0;
 	struct iovec *tmp;
-	size_t log_page_size = 0;
+	size_t log_page_size;
 	struct spdk_nvmf_discovery_log_page *discovery_log_page;
 
-	discovery_log_page = nvmf_generate_discovery_log(tgt, hostnqn, &log_page_size, cmd_source_trid);
+	/* Regenerate the serialized log only when the discovery state actually
+	 * changed or the log was generated for a different source listener.
+	 * Unchanged polls are served straight from the cached buffer. */
+	if (ctrlr->disc_log_page == NULL ||
+	    ctrlr->disc_log_genctr != tgt->discovery_genctr ||
+	    ctrlr->disc_log_filter != tgt->discovery_filter ||
+	    spdk_nvme_transport_id_compare(&ctrlr->disc_log_trid, cmd_source_trid) != 0) {
+		log_page_size = 0;
+		discovery_log_page = nvmf_generate_discovery_log(tgt, ctrlr->hostnqn, &log_page_size,
+				     cmd_source_trid);
+		if (discovery_log_page == NULL) {
+			return;
+		}
 
-	/* Copy the valid part of the discovery log page, if any */
-	if (discovery_log_page) {
-		for (tmp = iov; tmp < iov + iovcnt; tmp++) {
-			copy_len = spdk_min(tmp->iov_len, length);
-			copy_len = spdk_min(log_page_size - offset, copy_len);
+		free(ctrlr->disc_log_page);
+		ctrlr->disc_log_page = discovery_log_page;
+		ctrlr->disc_log_page_size = log_page_size;
+		ctrlr->disc_log_genctr = discovery_log_page->genctr;
+		ctrlr->disc_log_filter = tgt->discovery_filter;
+		ctrlr->disc_log_trid = *cmd_source_trid;
+	}
 
-			memcpy(tmp->iov_base, (char *)discovery_log_page + offset, copy_len);
+	discovery_log_page = ctrlr->disc_log_page;
+	log_page_size = ctrlr->disc_log_page_size;
 
-			offset += copy_len;
-			length -= copy_len;
-			zero_len = tmp->iov_len - copy_len;
-			if (log_page_size <= offset || length == 0) {
-				break;
-			}
-		}
-		/* Zero out the rest of the payload */
-		if (zero_len) {
-			memset((char *)tmp->iov_base + copy_len, 0, zero_len);
-		}
+	/* Copy the valid part of the discovery log page */
+	for (tmp = iov; tmp < iov + iovcnt; tmp++) {
+		copy_len = spdk_min(tmp->iov_len, length);
+		copy_len = spdk_min(log_page_size - offset, copy_len);
+
+		memcpy(tmp->iov_base, (char *)discovery_log_page + offset, copy_len);
 
-		for (++tmp; tmp < iov + iovcnt; tmp++) {
-			memset((char *)tmp->iov_base, 0, tmp->iov_len);
+		offset += copy_len;
+		length -= copy_len;
+		zero_len = tmp->iov_len - copy_len;
+		if (log_page_size <= offset || length == 0) {
+			break;
 		}
+	}
+	/* Zero out the rest of the payload */
+	if (zero_len) {
+		memset((char *)tmp->iov_base + copy_len, 0, zero_len);
+	}
 
-		free(discovery_log_page);
+	for (++tmp; tmp < iov + iovcnt; tmp++) {
+		memset((char *)tmp->iov_base, 0, tmp->iov_len);
 	}
 }
@@ -153,6 +153,10 @@ nvmf_poll_group_poll(void *ctx)
 	int count = 0;
 	struct spdk_nvmf_transport_poll_group *tgroup;
 
+	if (spdk_unlikely(!TAILQ_EMPTY(&group->qos_queued))) {
+		nvmf_poll_group_qos_drain(group);
+	}
+
 	TAILQ_FOREACH(tgroup, &group->tgroups, link) {
 		rc = nvmf_transport_poll_group_poll(tgroup);
 		if (rc < 0) {
@@ -265,6 +269,7 @@ nvmf_tgt_create_poll_group(void *io_device, void *ctx_buf)
 	group->tgt = tgt;
 	TAILQ_INIT(&group->tgroups);
 	TAILQ_INIT(&group->qpairs);
+	TAILQ_INIT(&group->qos_queued);
 	group->thread = thread;
 	pthread_mutex_init(&group->mutex, NULL);
 
@@ -602,6 +607,13 @@ nvmf_write_nvme_subsystem_config(struct spdk_json_write_ctx *w,
 			spdk_json_write_named_string(w, "dhchap_ctrlr_key",
 						     spdk_key_get_name(host->dhchap_ctrlr_key));
 		}
+		if (host->max_ios_per_sec != 0) {
+			spdk_json_write_named_uint64(w, "max_ios_per_sec", host->max_ios_per_sec);
+		}
+		if (host->max_bytes_per_sec != 0) {
+			spdk_json_write_named_uint64(w, "max_mbytes_per_sec",
+						     host->max_bytes_per_sec / (1024 * 1024));
+		}
 		TAILQ_FOREACH(transport, &subsystem->tgt->transports, link) {
 			if (transport->ops->subsystem_dump_host != NULL) {
 				transport->ops->subsystem_dump_host(transport, subsystem, host->nqn, w);
@@ -1328,6 +1340,7 @@ _nvmf_qpair_destroy(void *ctx, int status)
 	struct spdk_nvmf_qpair *qpair = qpair_ctx->qpair;
 	struct spdk_nvmf_ctrlr *ctrlr = qpair->ctrlr;
 	struct spdk_nvmf_subsystem_poll_group *sgroup;
+	struct spdk_nvmf_request *req, *tmp;
 	uint32_t sid;
 
 	assert(qpair->state == SPDK_NVMF_QPAIR_DEACTIVATING);
@@ -1347,6 +1360,15 @@ _nvmf_qpair_destroy(void *ctx, int status)
 		pthread_mutex_unlock(&qpair->group->mutex);
 	}
 
+	TAILQ_FOREACH_SAFE(req, &qpair->group->qos_queued, link, tmp) {
+		if (req->qpair == qpair) {
+			TAILQ_REMOVE(&qpair->group->qos_queued, req, link);
+			if (nvmf_transport_req_free(req)) {
+				SPDK_ERRLOG("Transport request free error!\n");
+			}
+		}
+	}
+
 	if (ctrlr) {
 		sgroup = &qpair->group->sgroups[ctrlr->subsys->id];
 		_nvmf_qpair_sgroup_req_clean(sgroup, qpair);
@@ -1373,6 +1395,22 @@ _nvmf_qpair_disconnect_msg(void *ctx)
 	free(ctx);
 }
 
+struct nvmf_qpair_migrate_ctx {
+	struct spdk_nvmf_qpair		*qpair;
+	struct spdk_nvmf_poll_group	*group;
+	struct spdk_poller		*drain_poller;
+};
+
+static void
+nvmf_qpair_migrate_cancel(struct spdk_nvmf_qpair *qpair)
+{
+	struct nvmf_qpair_migrate_ctx *migrate_ctx = qpair->migrate_ctx;
+
+	spdk_poller_unregister(&migrate_ctx->drain_poller);
+	qpair->migrate_ctx = NULL;
+	free(migrate_ctx);
+}
+
 int
 spdk_nvmf_qpair_disconnect(struct spdk_nvmf_qpair *qpair)
 {
@@ -1403,6 +1441,26 @@ spdk_nvmf_qpair_disconnect(struct spdk_nvmf_qpair *qpair)
 		return 0;
 	}
 
+	if (spdk_unlikely(qpair->migrate_ctx != NULL)) {
+		if (qpair->migrate_ctx->drain_poller != NULL) {
+			/* The qpair is still draining on this thread - abandon the
+			 * migration and proceed with the disconnect. */
+			nvmf_qpair_migrate_cancel(qpair);
+		} else {
+			/* The attach to the new poll group is already queued on this
+			 * thread.  Retry the disconnect once it has run. */
+			__atomic_clear(&qpair->disconnect_started, __ATOMIC_RELAXED);
+			qpair_ctx = calloc(1, sizeof(struct nvmf_qpair_disconnect_ctx));
+			if (!qpair_ctx) {
+				SPDK_ERRLOG("Unable to allocate context for nvmf_qpair_disconnect\n");
+				return -ENOMEM;
+			}
+			qpair_ctx->qpair = qpair;
+			spdk_thread_send_msg(spdk_get_thread(), _nvmf_qpair_disconnect_msg, qpair_ctx);
+			return 0;
+		}
+	}
+
 	SPDK_DTRACE_PROBE2_TICKS(nvmf_qpair_disconnect, qpair, spdk_thread_get_id(group->thread));
 	assert(spdk_nvmf_qpair_is_active(qpair));
 	nvmf_qpair_set_state(qpair, SPDK_NVMF_QPAIR_DEACTIVATING);
@@ -1430,6 +1488,147 @@ spdk_nvmf_qpair_disconnect(struct spdk_nvmf_qpair *qpair)
 	return 0;
 }
 
+static void
+_nvmf_qpair_migrate_attach(void *ctx)
+{
+	struct nvmf_qpair_migrate_ctx *migrate_ctx = ctx;
+	struct spdk_nvmf_qpair *qpair = migrate_ctx->qpair;
+	struct spdk_nvmf_poll_group *group = migrate_ctx->group;
+	struct spdk_nvmf_transport_poll_group *tgroup;
+	int rc = -ENOTSUP;
+
+	assert(spdk_get_thread() == group->thread);
+
+	TAILQ_INSERT_TAIL(&group->qpairs, qpair, link);
+
+	TAILQ_FOREACH(tgroup, &group->tgroups, link) {
+		if (tgroup->transport == qpair->transport) {
+			rc = nvmf_transport_qpair_migrate_attach(tgroup, qpair);
+			break;
+		}
+	}
+
+	qpair->migrate_ctx = NULL;
+	free(migrate_ctx);
+
+	if (rc != 0) {
+		SPDK_ERRLOG("Cannot attach qpair=%p to poll group=%p\n", qpair, group);
+		spdk_nvmf_qpair_disconnect(qpair);
+	}
+}
+
+static int
+nvmf_qpair_migrate_poll(void *ctx)
+{
+	struct nvmf_qpair_migrate_ctx *migrate_ctx = ctx;
+	struct spdk_nvmf_qpair *qpair = migrate_ctx->qpair;
+	struct spdk_nvmf_poll_group *group = qpair->group;
+	struct spdk_nvmf_transport_poll_group *tgroup;
+	int rc = -ENOTSUP;
+
+	if (spdk_unlikely(qpair->disconnect_started)) {
+		/* The qpair is being torn down - abandon the migration. */
+		nvmf_qpair_migrate_cancel(qpair);
+		return SPDK_POLLER_BUSY;
+	}
+
+	if (!TAILQ_EMPTY(&qpair->outstanding)) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	TAILQ_FOREACH(tgroup, &group->tgroups, link) {
+		if (tgroup->transport == qpair->transport) {
+			rc = nvmf_transport_qpair_migrate_detach(tgroup, qpair);
+			break;
+		}
+	}
+
+	if (rc == -EAGAIN) {
+		return SPDK_POLLER_IDLE;
+	}
+	if (rc != 0) {
+		SPDK_ERRLOG("Cannot detach qpair=%p from poll group=%p, canceling migration\n",
+			    qpair, group);
+		nvmf_qpair_migrate_cancel(qpair);
+		return SPDK_POLLER_BUSY;
+	}
+
+	SPDK_DTRACE_PROBE2_TICKS(nvmf_poll_group_migrate_qpair, qpair,
+				 spdk_thread_get_id(migrate_ctx->group->thread));
+	TAILQ_REMOVE(&group->qpairs, qpair, link);
+	spdk_poller_unregister(&migrate_ctx->drain_poller);
+	qpair->group = migrate_ctx->group;
+	spdk_thread_send_msg(migrate_ctx->group->thread, _nvmf_qpair_migrate_attach, migrate_ctx);
+
+	return SPDK_POLLER_BUSY;
+}
+
+int
+spdk_nvmf_qpair_migrate(struct spdk_nvmf_qpair *qpair, struct spdk_nvmf_poll_group *group)
+{
+	struct nvmf_qpair_migrate_ctx *migrate_ctx;
+	struct spdk_nvmf_transport_poll_group *tgroup;
+	bool found = false;
+
+	assert(qpair->group != NULL);
+	if (spdk_get_thread() != qpair->group->thread) {
+		return -EINVAL;
+	}
+
+	if (group == qpair->group) {
+		return 0;
+	}
+
+	if (qpair->qid == 0) {
+		/* The admin qpair must stay on the thread its controller was created on. */
+		return -ENOTSUP;
+	}
+
+	if (qpair->transport->ops->qpair_migrate_detach == NULL ||
+	    qpair->transport->ops->qpair_migrate_attach == NULL) {
+		return -ENOTSUP;
+	}
+
+	TAILQ_FOREACH(tgroup, &group->tgroups, link) {
+		if (tgroup->transport == qpair->transport) {
+			found = true;
+			break;
+		}
+	}
+	if (!found) {
+		return -EINVAL;
+	}
+
+	if (qpair->state != SPDK_NVMF_QPAIR_ENABLED || qpair->disconnect_started) {
+		return -ENXIO;
+	}
+
+	if (qpair->migrate_ctx != NULL) {
+		return -EINPROGRESS;
+	}
+
+	migrate_ctx = calloc(1, sizeof(*migrate_ctx));
+	if (!migrate_ctx) {
+		SPDK_ERRLOG("Unable to allocate context for nvmf_qpair_migrate\n");
+		return -ENOMEM;
+	}
+
+	migrate_ctx->qpair = qpair;
+	migrate_ctx->group = group;
+	qpair->migrate_ctx = migrate_ctx;
+
+	/* Setting migrate_ctx stops the transport from starting new requests on the
+	 * qpair.  Poll until the outstanding ones complete, then hop threads. */
+	migrate_ctx->drain_poller = SPDK_POLLER_REGISTER(nvmf_qpair_migrate_poll, migrate_ctx, 0);
+	if (!migrate_ctx->drain_poller) {
+		qpair->migrate_ctx = NULL;
+		free(migrate_ctx);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
 int
 spdk_nvmf_qpair_get_peer_trid(struct spdk_nvmf_qpair *qpair,
 			      struct spdk_nvme_transport_id *trid)
@@ -1629,6 +1828,33 @@ nvmf_poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
 	return poll_group_update_subsystem(group, subsystem);
 }
 
+int
+nvmf_poll_group_add_ns(struct spdk_nvmf_poll_group *group,
+		       struct spdk_nvmf_subsystem *subsystem, uint32_t nsid)
+{
+	struct spdk_nvmf_subsystem_poll_group *sgroup;
+	int rc;
+
+	rc = poll_group_update_subsystem(group, subsystem);
+	if (rc != 0) {
+		return rc;
+	}
+
+	sgroup = &group->sgroups[subsystem->id];
+
+	/* The namespace's I/O channel is installed now, so mark just that
+	 * namespace active.  Until this happens, requests for the new NSID fail
+	 * with Invalid Namespace or Format without DNR set and the host retries.
+	 * If the subsystem is being paused concurrently, leave the new slot
+	 * alone - the eventual resume will activate every namespace.
+	 */
+	if (sgroup->state == SPDK_NVMF_SUBSYSTEM_ACTIVE && nsid - 1 < sgroup->num_ns) {
+		sgroup->ns_info[nsid - 1].state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+	}
+
+	return 0;
+}
+
 int
 nvmf_poll_group_add_subsystem(struct spdk_nvmf_poll_group *group,
 			      struct spdk_nvmf_subsystem *subsystem,
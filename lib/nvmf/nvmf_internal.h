@@ -89,6 +89,9 @@ struct spdk_nvmf_host {
 	char				nqn[SPDK_NVMF_NQN_MAX_LEN + 1];
 	struct spdk_key			*dhchap_key;
 	struct spdk_key			*dhchap_ctrlr_key;
+	/* QoS rate limits for I/O from this host, 0 means unlimited */
+	uint64_t			max_ios_per_sec;
+	uint64_t			max_bytes_per_sec;
 	TAILQ_ENTRY(spdk_nvmf_host)	link;
 };
 
@@ -113,6 +116,20 @@ struct spdk_nvmf_referral {
 	TAILQ_ENTRY(spdk_nvmf_referral) link;
 };
 
+/* Per-namespace I/O statistics.  Each poll group accumulates into its own
+ * copy without locking; the nvmf_subsystem_get_ns_stats RPC merges the
+ * per-group copies on demand.
+ */
+struct spdk_nvmf_ns_stat {
+	uint64_t			num_read_ops;
+	uint64_t			num_write_ops;
+	uint64_t			num_other_ops;
+	uint64_t			read_bytes;
+	uint64_t			written_bytes;
+	uint64_t			read_latency_ticks;
+	uint64_t			write_latency_ticks;
+};
+
 struct spdk_nvmf_subsystem_pg_ns_info {
 	struct spdk_io_channel		*channel;
 	struct spdk_uuid		uuid;
@@ -129,6 +146,9 @@ struct spdk_nvmf_subsystem_pg_ns_info {
 	/* I/O outstanding to this namespace */
 	uint64_t			io_outstanding;
 	enum spdk_nvmf_subsystem_state	state;
+
+	/* I/O statistics for this namespace, local to the owning poll group */
+	struct spdk_nvmf_ns_stat	stat;
 };
 
 typedef void(*spdk_nvmf_poll_group_mod_done)(void *cb_arg, int status);
@@ -235,6 +255,22 @@ struct spdk_nvmf_ctrlr {
 	uint32_t association_timeout; /* in milliseconds */
 	uint16_t changed_ns_list_count;
 	struct spdk_nvme_ns_list changed_ns_list;
+	/* Serialized ANA log page.  Rebuilt lazily on the next fetch after a
+	 * namespace or ANA state change marks it dirty.
+	 */
+	void *ana_log_page;
+	size_t ana_log_page_size;
+	bool ana_log_page_dirty;
+	/* Serialized discovery log page.  Valid while the genctr matches the
+	 * target's discovery_genctr and the log was generated for the same
+	 * source listener, so unchanged discovery polls are served with a
+	 * straight copy.
+	 */
+	void *disc_log_page;
+	size_t disc_log_page_size;
+	uint64_t disc_log_genctr;
+	uint32_t disc_log_filter;
+	struct spdk_nvme_transport_id disc_log_trid;
 	uint64_t log_page_count;
 	uint8_t num_avail_log_pages;
 	TAILQ_HEAD(log_page_head, spdk_nvmf_reservation_log) log_head;
@@ -243,6 +279,23 @@ struct spdk_nvmf_ctrlr {
 	uint64_t			last_keep_alive_tick;
 	struct spdk_poller		*keep_alive_poller;
 
+	/* Per-host QoS rate limits copied from the subsystem's host entry,
+	 * 0 means unlimited.  Updated with atomic stores when changed at
+	 * runtime, read with atomic loads from the poll group threads.
+	 */
+	uint64_t			qos_ios_per_sec;
+	uint64_t			qos_bytes_per_sec;
+	/* Shared token pools, drained in batches into per-qpair credit
+	 * caches by all poll groups polling this controller's queue pairs.
+	 */
+	int64_t				qos_io_pool;
+	int64_t				qos_byte_pool;
+	/* Fractional tokens carried between refills, in units of 1/hz */
+	uint64_t			qos_io_residual;
+	uint64_t			qos_byte_residual;
+	uint64_t			qos_last_tick;
+	struct spdk_poller		*qos_poller;
+
 	struct spdk_poller		*association_timer;
 
 	struct spdk_poller		*cc_timer;
@@ -359,6 +412,8 @@ RB_GENERATE_STATIC(subsystem_tree, spdk_nvmf_subsystem, link, subsystem_cmp);
 
 int nvmf_poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
 				     struct spdk_nvmf_subsystem *subsystem);
+int nvmf_poll_group_add_ns(struct spdk_nvmf_poll_group *group,
+			   struct spdk_nvmf_subsystem *subsystem, uint32_t nsid);
 int nvmf_poll_group_add_subsystem(struct spdk_nvmf_poll_group *group,
 				  struct spdk_nvmf_subsystem *subsystem,
 				  spdk_nvmf_poll_group_mod_done cb_fn, void *cb_arg);
@@ -372,7 +427,7 @@ void nvmf_poll_group_resume_subsystem(struct spdk_nvmf_poll_group *group,
 				      struct spdk_nvmf_subsystem *subsystem, spdk_nvmf_poll_group_mod_done cb_fn, void *cb_arg);
 
 void nvmf_update_discovery_log(struct spdk_nvmf_tgt *tgt, const char *hostnqn);
-void nvmf_get_discovery_log_page(struct spdk_nvmf_tgt *tgt, const char *hostnqn, struct iovec *iov,
+void nvmf_get_discovery_log_page(struct spdk_nvmf_ctrlr *ctrlr, struct iovec *iov,
 				 uint32_t iovcnt, uint64_t offset, uint32_t length,
 				 struct spdk_nvme_transport_id *cmd_source_trid);
 
@@ -424,6 +479,10 @@ enum nvmf_auth_key_type {
 };
 struct spdk_key *nvmf_subsystem_get_dhchap_key(struct spdk_nvmf_subsystem *subsys, const char *nqn,
 		enum nvmf_auth_key_type type);
+void nvmf_subsystem_get_host_qos(struct spdk_nvmf_subsystem *subsystem, const char *hostnqn,
+				 uint64_t *ios_per_sec, uint64_t *bytes_per_sec);
+void nvmf_ctrlr_start_qos_poller(struct spdk_nvmf_ctrlr *ctrlr);
+void nvmf_poll_group_qos_drain(struct spdk_nvmf_poll_group *group);
 struct spdk_nvmf_subsystem_listener *nvmf_subsystem_find_listener(
 	struct spdk_nvmf_subsystem *subsystem,
 	const struct spdk_nvme_transport_id *trid);
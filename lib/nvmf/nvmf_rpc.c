@@ -204,6 +204,13 @@ dump_nvmf_subsystem(struct spdk_json_write_ctx *w, struct spdk_nvmf_subsystem *s
 			spdk_json_write_named_string(w, "dhchap_ctrlr_key",
 						     spdk_key_get_name(host->dhchap_ctrlr_key));
 		}
+		if (host->max_ios_per_sec != 0) {
+			spdk_json_write_named_uint64(w, "max_ios_per_sec", host->max_ios_per_sec);
+		}
+		if (host->max_bytes_per_sec != 0) {
+			spdk_json_write_named_uint64(w, "max_mbytes_per_sec",
+						     host->max_bytes_per_sec / (1024 * 1024));
+		}
 		spdk_json_write_object_end(w);
 	}
 	spdk_json_write_array_end(w);
@@ -1505,11 +1512,9 @@ nvmf_rpc_ns_resumed(struct spdk_nvmf_subsystem *subsystem,
 	spdk_jsonrpc_end_result(request, w);
 }
 
-static void
-nvmf_rpc_ns_paused(struct spdk_nvmf_subsystem *subsystem,
-		   void *cb_arg, int status)
+static uint32_t
+nvmf_rpc_ns_add(struct spdk_nvmf_subsystem *subsystem, struct nvmf_rpc_ns_ctx *ctx)
 {
-	struct nvmf_rpc_ns_ctx *ctx = cb_arg;
 	struct spdk_nvmf_ns_opts ns_opts;
 
 	spdk_nvmf_ns_opts_get_defaults(&ns_opts, sizeof(ns_opts));
@@ -1529,18 +1534,25 @@ nvmf_rpc_ns_paused(struct spdk_nvmf_subsystem *subsystem,
 	ns_opts.anagrpid = ctx->ns_params.anagrpid;
 	ns_opts.no_auto_visible = ctx->ns_params.no_auto_visible;
 
-	ctx->ns_params.nsid = spdk_nvmf_subsystem_add_ns_ext(subsystem, ctx->ns_params.bdev_name,
-			      &ns_opts, sizeof(ns_opts),
-			      ctx->ns_params.ptpl_file);
+	return spdk_nvmf_subsystem_add_ns_ext(subsystem, ctx->ns_params.bdev_name,
+					      &ns_opts, sizeof(ns_opts),
+					      ctx->ns_params.ptpl_file);
+}
+
+static void
+nvmf_rpc_ns_paused(struct spdk_nvmf_subsystem *subsystem,
+		   void *cb_arg, int status)
+{
+	struct nvmf_rpc_ns_ctx *ctx = cb_arg;
+
+	ctx->ns_params.nsid = nvmf_rpc_ns_add(subsystem, ctx);
 	if (ctx->ns_params.nsid == 0) {
 		SPDK_ERRLOG("Unable to add namespace\n");
 		spdk_jsonrpc_send_error_response(ctx->request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
 						 "Invalid parameters");
 		ctx->response_sent = true;
-		goto resume;
 	}
 
-resume:
 	if (spdk_nvmf_subsystem_resume(subsystem, nvmf_rpc_ns_resumed, ctx)) {
 		spdk_jsonrpc_send_error_response(ctx->request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR, "Internal error");
 		nvmf_rpc_ns_ctx_free(ctx);
@@ -1554,6 +1566,7 @@ rpc_nvmf_subsystem_add_ns(struct spdk_jsonrpc_request *request,
 	struct nvmf_rpc_ns_ctx *ctx;
 	struct spdk_nvmf_subsystem *subsystem;
 	struct spdk_nvmf_tgt *tgt;
+	struct spdk_json_write_ctx *w;
 	int rc;
 
 	ctx = calloc(1, sizeof(*ctx));
@@ -1591,6 +1604,27 @@ rpc_nvmf_subsystem_add_ns(struct spdk_jsonrpc_request *request,
 		return;
 	}
 
+	if (subsystem->state == SPDK_NVMF_SUBSYSTEM_ACTIVE) {
+		/* An active subsystem can accept a new namespace without being
+		 * paused - the library publishes it to the poll groups while I/O
+		 * to the existing namespaces continues untouched.
+		 */
+		ctx->ns_params.nsid = nvmf_rpc_ns_add(subsystem, ctx);
+		if (ctx->ns_params.nsid == 0) {
+			SPDK_ERRLOG("Unable to add namespace\n");
+			spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+							 "Invalid parameters");
+			nvmf_rpc_ns_ctx_free(ctx);
+			return;
+		}
+
+		w = spdk_jsonrpc_begin_result(request);
+		spdk_json_write_uint32(w, ctx->ns_params.nsid);
+		spdk_jsonrpc_end_result(request, w);
+		nvmf_rpc_ns_ctx_free(ctx);
+		return;
+	}
+
 	rc = spdk_nvmf_subsystem_pause(subsystem, ctx->ns_params.nsid, nvmf_rpc_ns_paused, ctx);
 	if (rc != 0) {
 		if (rc == -EBUSY) {
@@ -1871,6 +1905,8 @@ struct nvmf_rpc_host_ctx {
 	char *tgt_name;
 	char *dhchap_key;
 	char *dhchap_ctrlr_key;
+	uint64_t max_ios_per_sec;
+	uint64_t max_mbytes_per_sec;
 	bool allow_any_host;
 };
 
@@ -1880,6 +1916,8 @@ static const struct spdk_json_object_decoder nvmf_rpc_subsystem_host_decoder[] =
 	{"tgt_name", offsetof(struct nvmf_rpc_host_ctx, tgt_name), spdk_json_decode_string, true},
 	{"dhchap_key", offsetof(struct nvmf_rpc_host_ctx, dhchap_key), spdk_json_decode_string, true},
 	{"dhchap_ctrlr_key", offsetof(struct nvmf_rpc_host_ctx, dhchap_ctrlr_key), spdk_json_decode_string, true},
+	{"max_ios_per_sec", offsetof(struct nvmf_rpc_host_ctx, max_ios_per_sec), spdk_json_decode_uint64, true},
+	{"max_mbytes_per_sec", offsetof(struct nvmf_rpc_host_ctx, max_mbytes_per_sec), spdk_json_decode_uint64, true},
 };
 
 static void
@@ -1947,10 +1985,12 @@ rpc_nvmf_subsystem_add_host(struct spdk_jsonrpc_request *request,
 		}
 	}
 
-	opts.size = SPDK_SIZEOF(&opts, dhchap_ctrlr_key);
+	opts.size = SPDK_SIZEOF(&opts, max_mbytes_per_sec);
 	opts.params = params;
 	opts.dhchap_key = key;
 	opts.dhchap_ctrlr_key = ckey;
+	opts.max_ios_per_sec = ctx.max_ios_per_sec;
+	opts.max_mbytes_per_sec = ctx.max_mbytes_per_sec;
 	rc = spdk_nvmf_subsystem_add_host_ext(subsystem, ctx.host, &opts);
 	if (rc != 0) {
 		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR, "Internal error");
@@ -1965,6 +2005,61 @@ out:
 }
 SPDK_RPC_REGISTER("nvmf_subsystem_add_host", rpc_nvmf_subsystem_add_host, SPDK_RPC_RUNTIME)
 
+static const struct spdk_json_object_decoder nvmf_rpc_subsystem_host_qos_decoder[] = {
+	{"nqn", offsetof(struct nvmf_rpc_host_ctx, nqn), spdk_json_decode_string},
+	{"host", offsetof(struct nvmf_rpc_host_ctx, host), spdk_json_decode_string},
+	{"tgt_name", offsetof(struct nvmf_rpc_host_ctx, tgt_name), spdk_json_decode_string, true},
+	{"max_ios_per_sec", offsetof(struct nvmf_rpc_host_ctx, max_ios_per_sec), spdk_json_decode_uint64, true},
+	{"max_mbytes_per_sec", offsetof(struct nvmf_rpc_host_ctx, max_mbytes_per_sec), spdk_json_decode_uint64, true},
+};
+
+static void
+rpc_nvmf_subsystem_set_host_qos(struct spdk_jsonrpc_request *request,
+				const struct spdk_json_val *params)
+{
+	struct nvmf_rpc_host_ctx ctx = {};
+	struct spdk_nvmf_subsystem *subsystem;
+	struct spdk_nvmf_tgt *tgt;
+	int rc;
+
+	if (spdk_json_decode_object(params, nvmf_rpc_subsystem_host_qos_decoder,
+				    SPDK_COUNTOF(nvmf_rpc_subsystem_host_qos_decoder),
+				    &ctx)) {
+		SPDK_ERRLOG("spdk_json_decode_object failed\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS, "Invalid parameters");
+		goto out;
+	}
+
+	tgt = spdk_nvmf_get_tgt(ctx.tgt_name);
+	if (!tgt) {
+		SPDK_ERRLOG("Unable to find a target object.\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "Unable to find a target.");
+		goto out;
+	}
+
+	subsystem = spdk_nvmf_tgt_find_subsystem(tgt, ctx.nqn);
+	if (!subsystem) {
+		SPDK_ERRLOG("Unable to find subsystem with NQN %s\n", ctx.nqn);
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS, "Invalid parameters");
+		goto out;
+	}
+
+	rc = spdk_nvmf_subsystem_set_host_qos(subsystem, ctx.host, ctx.max_ios_per_sec,
+					      ctx.max_mbytes_per_sec);
+	if (rc != 0) {
+		SPDK_ERRLOG("Unable to set QoS limits for host %s\n", ctx.host);
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+						 "Invalid parameters");
+		goto out;
+	}
+
+	spdk_jsonrpc_send_bool_response(request, true);
+out:
+	nvmf_rpc_host_ctx_free(&ctx);
+}
+SPDK_RPC_REGISTER("nvmf_subsystem_set_host_qos", rpc_nvmf_subsystem_set_host_qos, SPDK_RPC_RUNTIME)
+
 static void
 rpc_nvmf_subsystem_remove_host_done(void *_ctx, int status)
 {
@@ -2664,6 +2759,160 @@ rpc_nvmf_get_stats(struct spdk_jsonrpc_request *request,
 
 SPDK_RPC_REGISTER("nvmf_get_stats", rpc_nvmf_get_stats, SPDK_RPC_RUNTIME)
 
+struct rpc_nvmf_get_ns_stats_ctx {
+	char *nqn;
+	char *tgt_name;
+	struct spdk_nvmf_tgt *tgt;
+	struct spdk_nvmf_subsystem *subsystem;
+	/* Merged statistics indexed by nsid - 1 */
+	struct spdk_nvmf_ns_stat *stats;
+	uint32_t num_ns;
+	struct spdk_jsonrpc_request *request;
+};
+
+static const struct spdk_json_object_decoder rpc_get_ns_stats_decoders[] = {
+	{"nqn", offsetof(struct rpc_nvmf_get_ns_stats_ctx, nqn), spdk_json_decode_string},
+	{"tgt_name", offsetof(struct rpc_nvmf_get_ns_stats_ctx, tgt_name), spdk_json_decode_string, true},
+};
+
+static void
+free_get_ns_stats_ctx(struct rpc_nvmf_get_ns_stats_ctx *ctx)
+{
+	free(ctx->nqn);
+	free(ctx->tgt_name);
+	free(ctx->stats);
+	free(ctx);
+}
+
+static void
+rpc_nvmf_get_ns_stats_done(struct spdk_io_channel_iter *i, int status)
+{
+	struct rpc_nvmf_get_ns_stats_ctx *ctx = spdk_io_channel_iter_get_ctx(i);
+	struct spdk_json_write_ctx *w;
+	struct spdk_nvmf_ns *ns;
+	struct spdk_nvmf_ns_stat *stat;
+
+	w = spdk_jsonrpc_begin_result(ctx->request);
+	spdk_json_write_object_begin(w);
+	spdk_json_write_named_uint64(w, "tick_rate", spdk_get_ticks_hz());
+	spdk_json_write_named_array_begin(w, "namespaces");
+
+	for (ns = spdk_nvmf_subsystem_get_first_ns(ctx->subsystem); ns != NULL;
+	     ns = spdk_nvmf_subsystem_get_next_ns(ctx->subsystem, ns)) {
+		if (ns->nsid == 0 || ns->nsid > ctx->num_ns) {
+			continue;
+		}
+		stat = &ctx->stats[ns->nsid - 1];
+
+		spdk_json_write_object_begin(w);
+		spdk_json_write_named_uint32(w, "nsid", ns->nsid);
+		spdk_json_write_named_string(w, "bdev_name", spdk_bdev_get_name(ns->bdev));
+		spdk_json_write_named_uint64(w, "num_read_ops", stat->num_read_ops);
+		spdk_json_write_named_uint64(w, "num_write_ops", stat->num_write_ops);
+		spdk_json_write_named_uint64(w, "num_other_ops", stat->num_other_ops);
+		spdk_json_write_named_uint64(w, "bytes_read", stat->read_bytes);
+		spdk_json_write_named_uint64(w, "bytes_written", stat->written_bytes);
+		spdk_json_write_named_uint64(w, "read_latency_ticks", stat->read_latency_ticks);
+		spdk_json_write_named_uint64(w, "write_latency_ticks", stat->write_latency_ticks);
+		spdk_json_write_object_end(w);
+	}
+
+	spdk_json_write_array_end(w);
+	spdk_json_write_object_end(w);
+	spdk_jsonrpc_end_result(ctx->request, w);
+	free_get_ns_stats_ctx(ctx);
+}
+
+static void
+_rpc_nvmf_get_ns_stats(struct spdk_io_channel_iter *i)
+{
+	struct rpc_nvmf_get_ns_stats_ctx *ctx = spdk_io_channel_iter_get_ctx(i);
+	struct spdk_nvmf_subsystem_poll_group *sgroup;
+	struct spdk_io_channel *ch;
+	struct spdk_nvmf_poll_group *group;
+	struct spdk_nvmf_ns_stat *stat;
+	uint32_t nsid, count;
+
+	ch = spdk_get_io_channel(ctx->tgt);
+	group = spdk_io_channel_get_ctx(ch);
+
+	/* Runs on the group's thread, so the group-local counters are stable. */
+	sgroup = &group->sgroups[ctx->subsystem->id];
+	count = spdk_min(sgroup->num_ns, ctx->num_ns);
+	for (nsid = 1; nsid <= count; nsid++) {
+		stat = &sgroup->ns_info[nsid - 1].stat;
+
+		ctx->stats[nsid - 1].num_read_ops += stat->num_read_ops;
+		ctx->stats[nsid - 1].num_write_ops += stat->num_write_ops;
+		ctx->stats[nsid - 1].num_other_ops += stat->num_other_ops;
+		ctx->stats[nsid - 1].read_bytes += stat->read_bytes;
+		ctx->stats[nsid - 1].written_bytes += stat->written_bytes;
+		ctx->stats[nsid - 1].read_latency_ticks += stat->read_latency_ticks;
+		ctx->stats[nsid - 1].write_latency_ticks += stat->write_latency_ticks;
+	}
+
+	spdk_put_io_channel(ch);
+	spdk_for_each_channel_continue(i, 0);
+}
+
+static void
+rpc_nvmf_subsystem_get_ns_stats(struct spdk_jsonrpc_request *request,
+				const struct spdk_json_val *params)
+{
+	struct rpc_nvmf_get_ns_stats_ctx *ctx;
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (!ctx) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "Memory allocation error");
+		return;
+	}
+	ctx->request = request;
+
+	if (spdk_json_decode_object(params, rpc_get_ns_stats_decoders,
+				    SPDK_COUNTOF(rpc_get_ns_stats_decoders),
+				    ctx)) {
+		SPDK_ERRLOG("spdk_json_decode_object failed\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+						 "Invalid parameters");
+		free_get_ns_stats_ctx(ctx);
+		return;
+	}
+
+	ctx->tgt = spdk_nvmf_get_tgt(ctx->tgt_name);
+	if (!ctx->tgt) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "Unable to find a target.");
+		free_get_ns_stats_ctx(ctx);
+		return;
+	}
+
+	ctx->subsystem = spdk_nvmf_tgt_find_subsystem(ctx->tgt, ctx->nqn);
+	if (!ctx->subsystem) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+						 "Unable to find subsystem.");
+		free_get_ns_stats_ctx(ctx);
+		return;
+	}
+
+	ctx->num_ns = ctx->subsystem->max_nsid;
+	if (ctx->num_ns > 0) {
+		ctx->stats = calloc(ctx->num_ns, sizeof(*ctx->stats));
+		if (!ctx->stats) {
+			spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+							 "Memory allocation error");
+			free_get_ns_stats_ctx(ctx);
+			return;
+		}
+	}
+
+	spdk_for_each_channel(ctx->tgt,
+			      _rpc_nvmf_get_ns_stats,
+			      ctx,
+			      rpc_nvmf_get_ns_stats_done);
+}
+SPDK_RPC_REGISTER("nvmf_subsystem_get_ns_stats", rpc_nvmf_subsystem_get_ns_stats, SPDK_RPC_RUNTIME)
+
 static void
 dump_nvmf_ctrlr(struct spdk_json_write_ctx *w, struct spdk_nvmf_ctrlr *ctrlr)
 {
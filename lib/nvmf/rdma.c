@@ -211,6 +211,9 @@ struct spdk_nvmf_rdma_recv {
 	/* In-capsule data buffer */
 	uint8_t					*buf;
 
+	/* The resource chunk this recv was allocated from */
+	struct spdk_nvmf_rdma_resources		*resources;
+
 	struct spdk_nvmf_rdma_wr		rdma_wr;
 	uint64_t				receive_tsc;
 
@@ -243,6 +246,9 @@ struct spdk_nvmf_rdma_request {
 		struct	ibv_sge			sgl[NVMF_DEFAULT_RSP_SGE];
 	} rsp;
 
+	/* The resource chunk this request was allocated from */
+	struct spdk_nvmf_rdma_resources		*resources;
+
 	uint16_t				iovpos;
 	uint16_t				num_outstanding_data_wr;
 	/* Used to split Write IO with multi SGL payload */
@@ -292,6 +298,26 @@ struct spdk_nvmf_rdma_resources {
 
 	/* Queue to track free requests */
 	STAILQ_HEAD(, spdk_nvmf_rdma_request)	free_queue;
+
+	/* Number of entries in the arrays above */
+	uint32_t				num_entries;
+
+	/* The fields below are only used when this object is one chunk of an
+	 * autoscaled SRQ's resources.  A draining chunk is being removed: its
+	 * receives are parked on the incoming_queue above instead of being
+	 * re-posted to the SRQ and its requests accumulate on the free_queue
+	 * above instead of the poller's shared one.  Once both counts reach
+	 * num_entries the chunk is destroyed.
+	 */
+	bool					draining;
+
+	/* Requests of this chunk parked on its own free_queue */
+	uint32_t				num_free_reqs;
+
+	/* Receives of this chunk parked on its own incoming_queue */
+	uint32_t				num_parked_recvs;
+
+	TAILQ_ENTRY(spdk_nvmf_rdma_resources)	link;
 };
 
 typedef void (*spdk_nvmf_rdma_qpair_ibv_event)(struct spdk_nvmf_rdma_qpair *rqpair);
@@ -406,7 +432,7 @@ struct spdk_nvmf_rdma_poller {
 
 	int					num_cqe;
 	int					required_num_wr;
-	struct ibv_cq				*cq;
+	struct spdk_rdma_cq			*cq;
 
 	/* The maximum number of I/O outstanding on the shared receive queue at one time */
 	uint16_t				max_srq_depth;
@@ -415,7 +441,36 @@ struct spdk_nvmf_rdma_poller {
 	/* Shared receive queue */
 	struct spdk_rdma_srq			*srq;
 
+	/* The first chunk of receive resources; never removed by the autoscaler */
 	struct spdk_nvmf_rdma_resources		*resources;
+
+	/* SRQ autoscaling state.  When enabled, receive resources are allocated
+	 * in chunks of srq_chunk_size entries and chunks are added or removed
+	 * based on the observed number of posted receive WRs.
+	 */
+	bool					srq_autoscale;
+
+	/* Receive entries across all chunks, excluding a draining chunk */
+	uint32_t				srq_depth;
+
+	uint32_t				srq_chunk_size;
+
+	/* Receive WRs currently posted (or queued for posting) to the SRQ */
+	uint32_t				srq_posted;
+
+	/* Lowest srq_posted observed since the last shrink evaluation */
+	uint32_t				srq_min_posted;
+
+	uint64_t				srq_shrink_tsc;
+	uint64_t				srq_shrink_period;
+
+	/* Resource chunks beyond "resources"; a draining chunk stays here
+	 * until all of its entries have been parked.
+	 */
+	TAILQ_HEAD(srq_chunks_head, spdk_nvmf_rdma_resources)	srq_chunks;
+
+	struct spdk_nvmf_rdma_resources		*srq_draining_chunk;
+
 	struct spdk_nvmf_rdma_poller_stat	stat;
 
 	spdk_poller_destroy_cb			destroy_cb;
@@ -473,6 +528,7 @@ struct rdma_transport_opts {
 	int		num_cqe;
 	uint32_t	max_srq_depth;
 	bool		no_srq;
+	bool		srq_autoscale;
 	bool		no_wr_batching;
 	int		acceptor_backlog;
 };
@@ -524,6 +580,10 @@ static const struct spdk_json_object_decoder rdma_transport_opts_decoder[] = {
 		"no_srq", offsetof(struct rdma_transport_opts, no_srq),
 		spdk_json_decode_bool, true
 	},
+	{
+		"srq_autoscale", offsetof(struct rdma_transport_opts, srq_autoscale),
+		spdk_json_decode_bool, true
+	},
 	{
 		"no_wr_batching", offsetof(struct rdma_transport_opts, no_wr_batching),
 		spdk_json_decode_bool, true
@@ -716,6 +776,7 @@ nvmf_rdma_resources_create(struct spdk_nvmf_rdma_resource_opts *opts)
 	/* Initialize queues */
 	STAILQ_INIT(&resources->incoming_queue);
 	STAILQ_INIT(&resources->free_queue);
+	resources->num_entries = opts->max_queue_depth;
 
 	if (opts->shared) {
 		srq = (struct spdk_rdma_srq *)opts->qp;
@@ -726,6 +787,7 @@ nvmf_rdma_resources_create(struct spdk_nvmf_rdma_resource_opts *opts)
 	for (i = 0; i < opts->max_queue_depth; i++) {
 		rdma_recv = &resources->recvs[i];
 		rdma_recv->qpair = opts->qpair;
+		rdma_recv->resources = resources;
 
 		/* Set up memory to receive commands */
 		if (resources->bufs) {
@@ -767,6 +829,7 @@ nvmf_rdma_resources_create(struct spdk_nvmf_rdma_resource_opts *opts)
 
 	for (i = 0; i < opts->max_queue_depth; i++) {
 		rdma_req = &resources->reqs[i];
+		rdma_req->resources = resources;
 
 		if (opts->qpair != NULL) {
 			rdma_req->req.qpair = &opts->qpair->qpair;
@@ -827,6 +890,171 @@ cleanup:
 	return NULL;
 }
 
+/* Queue a completed receive for re-posting to the SRQ, or park it if the chunk
+ * it belongs to is being removed by the autoscaler.  The caller is responsible
+ * for flushing the queued WRs. */
+static void
+nvmf_rdma_srq_repost_recv(struct spdk_nvmf_rdma_poller *rpoller,
+			  struct spdk_nvmf_rdma_recv *rdma_recv)
+{
+	struct spdk_nvmf_rdma_resources *chunk = rdma_recv->resources;
+
+	if (spdk_unlikely(chunk->draining)) {
+		STAILQ_INSERT_TAIL(&chunk->incoming_queue, rdma_recv, link);
+		chunk->num_parked_recvs++;
+		return;
+	}
+
+	spdk_rdma_srq_queue_recv_wrs(rpoller->srq, &rdma_recv->wr);
+	rpoller->srq_posted++;
+}
+
+/* Iterate over all of the poller's SRQ resource chunks, including a draining
+ * one.  Pass NULL to get the first chunk; returns NULL after the last one. */
+static struct spdk_nvmf_rdma_resources *
+nvmf_rdma_poller_next_resources(struct spdk_nvmf_rdma_poller *rpoller,
+				struct spdk_nvmf_rdma_resources *prev)
+{
+	if (prev == NULL) {
+		return rpoller->resources;
+	}
+	if (prev == rpoller->resources) {
+		return TAILQ_FIRST(&rpoller->srq_chunks);
+	}
+	return TAILQ_NEXT(prev, link);
+}
+
+static void
+nvmf_rdma_srq_add_chunk(struct spdk_nvmf_rdma_transport *rtransport,
+			struct spdk_nvmf_rdma_poller *rpoller)
+{
+	struct spdk_nvmf_rdma_resource_opts	opts;
+	struct spdk_nvmf_rdma_resources		*chunk;
+	struct spdk_nvmf_rdma_recv		*rdma_recv;
+	struct ibv_recv_wr			*bad_wr;
+	int					rc;
+
+	chunk = rpoller->srq_draining_chunk;
+	if (chunk != NULL) {
+		/* A chunk is still being drained - revive it instead of allocating
+		 * a new one.  Parked receives go back to the SRQ and parked requests
+		 * back to the shared free queue. */
+		chunk->draining = false;
+		rpoller->srq_draining_chunk = NULL;
+		while ((rdma_recv = STAILQ_FIRST(&chunk->incoming_queue)) != NULL) {
+			STAILQ_REMOVE_HEAD(&chunk->incoming_queue, link);
+			nvmf_rdma_srq_repost_recv(rpoller, rdma_recv);
+		}
+		chunk->num_parked_recvs = 0;
+		rc = spdk_rdma_srq_flush_recv_wrs(rpoller->srq, &bad_wr);
+		if (rc) {
+			SPDK_ERRLOG("Unable to re-post rx descriptors\n");
+		}
+		STAILQ_CONCAT(&rpoller->resources->free_queue, &chunk->free_queue);
+		chunk->num_free_reqs = 0;
+		rpoller->srq_depth += chunk->num_entries;
+		SPDK_DEBUGLOG(rdma, "Revived draining SRQ chunk, poller %p depth %u\n",
+			      rpoller, rpoller->srq_depth);
+		return;
+	}
+
+	if (rpoller->srq_depth + rpoller->srq_chunk_size > rpoller->max_srq_depth) {
+		return;
+	}
+
+	memset(&opts, 0, sizeof(opts));
+	opts.qp = rpoller->srq;
+	opts.map = rpoller->device->map;
+	opts.qpair = NULL;
+	opts.shared = true;
+	opts.max_queue_depth = rpoller->srq_chunk_size;
+	opts.in_capsule_data_size = rtransport->transport.opts.in_capsule_data_size;
+
+	chunk = nvmf_rdma_resources_create(&opts);
+	if (chunk == NULL) {
+		SPDK_WARNLOG("Unable to grow SRQ resources for poller %p\n", rpoller);
+		return;
+	}
+
+	TAILQ_INSERT_TAIL(&rpoller->srq_chunks, chunk, link);
+	STAILQ_CONCAT(&rpoller->resources->free_queue, &chunk->free_queue);
+	rpoller->srq_depth += chunk->num_entries;
+	rpoller->srq_posted += chunk->num_entries;
+	SPDK_DEBUGLOG(rdma, "Grew SRQ resources of poller %p to %u entries\n",
+		      rpoller, rpoller->srq_depth);
+}
+
+static void
+nvmf_rdma_srq_remove_chunk(struct spdk_nvmf_rdma_poller *rpoller)
+{
+	struct spdk_nvmf_rdma_resources	*chunk;
+	struct spdk_nvmf_rdma_request	*rdma_req, *req_tmp;
+
+	chunk = TAILQ_LAST(&rpoller->srq_chunks, srq_chunks_head);
+	if (chunk == NULL) {
+		/* Only the base chunk is left */
+		return;
+	}
+
+	chunk->draining = true;
+	rpoller->srq_draining_chunk = chunk;
+	rpoller->srq_depth -= chunk->num_entries;
+
+	/* Pull this chunk's free requests off the shared free queue; busy ones
+	 * are parked as they complete, and posted receives as the SRQ consumes
+	 * them.  The chunk is destroyed once everything is parked. */
+	STAILQ_FOREACH_SAFE(rdma_req, &rpoller->resources->free_queue, state_link, req_tmp) {
+		if (rdma_req->resources == chunk) {
+			STAILQ_REMOVE(&rpoller->resources->free_queue, rdma_req,
+				      spdk_nvmf_rdma_request, state_link);
+			STAILQ_INSERT_TAIL(&chunk->free_queue, rdma_req, state_link);
+			chunk->num_free_reqs++;
+		}
+	}
+	SPDK_DEBUGLOG(rdma, "Draining SRQ chunk of poller %p, depth now %u\n",
+		      rpoller, rpoller->srq_depth);
+}
+
+static void
+nvmf_rdma_srq_autoscale_poll(struct spdk_nvmf_rdma_transport *rtransport,
+			     struct spdk_nvmf_rdma_poller *rpoller, uint64_t poll_tsc)
+{
+	struct spdk_nvmf_rdma_resources *chunk = rpoller->srq_draining_chunk;
+
+	if (chunk != NULL &&
+	    chunk->num_parked_recvs == chunk->num_entries &&
+	    chunk->num_free_reqs == chunk->num_entries) {
+		TAILQ_REMOVE(&rpoller->srq_chunks, chunk, link);
+		rpoller->srq_draining_chunk = NULL;
+		nvmf_rdma_resources_destroy(chunk);
+		SPDK_DEBUGLOG(rdma, "Shrank SRQ resources of poller %p to %u entries\n",
+			      rpoller, rpoller->srq_depth);
+	}
+
+	rpoller->srq_min_posted = spdk_min(rpoller->srq_min_posted, rpoller->srq_posted);
+
+	/* Grow immediately when the SRQ is close to running out of posted
+	 * receives, before bursts turn into RNR retries. */
+	if (rpoller->srq_posted < rpoller->srq_chunk_size / 2 &&
+	    rpoller->srq_depth < rpoller->max_srq_depth) {
+		nvmf_rdma_srq_add_chunk(rtransport, rpoller);
+		rpoller->srq_min_posted = rpoller->srq_posted;
+		rpoller->srq_shrink_tsc = poll_tsc;
+		return;
+	}
+
+	/* Shrink slowly: only when well over a chunk's worth of receives stayed
+	 * posted (i.e. unused) throughout the whole evaluation window. */
+	if (poll_tsc - rpoller->srq_shrink_tsc >= rpoller->srq_shrink_period) {
+		if (rpoller->srq_draining_chunk == NULL &&
+		    rpoller->srq_min_posted > rpoller->srq_chunk_size + rpoller->srq_chunk_size / 2) {
+			nvmf_rdma_srq_remove_chunk(rpoller);
+		}
+		rpoller->srq_min_posted = rpoller->srq_posted;
+		rpoller->srq_shrink_tsc = poll_tsc;
+	}
+}
+
 static void
 nvmf_rdma_qpair_clean_ibv_events(struct spdk_nvmf_rdma_qpair *rqpair)
 {
@@ -854,24 +1082,32 @@ nvmf_rdma_qpair_destroy(struct spdk_nvmf_rdma_qpair *rqpair)
 		struct spdk_nvmf_rdma_transport	*rtransport = SPDK_CONTAINEROF(qpair->transport,
 				struct spdk_nvmf_rdma_transport, transport);
 		struct spdk_nvmf_rdma_request *req;
-		uint32_t i, max_req_count = 0;
+		uint32_t i;
 
 		SPDK_WARNLOG("Destroying qpair when queue depth is %d\n", rqpair->qd);
 
+		SPDK_DEBUGLOG(rdma, "Release incomplete requests\n");
 		if (rqpair->srq == NULL) {
 			nvmf_rdma_dump_qpair_contents(rqpair);
-			max_req_count = rqpair->max_queue_depth;
+			for (i = 0; i < rqpair->max_queue_depth; i++) {
+				req = &rqpair->resources->reqs[i];
+				if (req->req.qpair == qpair && req->state != RDMA_REQUEST_STATE_FREE) {
+					/* nvmf_rdma_request_process checks qpair ibv and internal state
+					 * and completes a request */
+					nvmf_rdma_request_process(rtransport, req);
+				}
+			}
 		} else if (rqpair->poller && rqpair->resources) {
-			max_req_count = rqpair->poller->max_srq_depth;
-		}
-
-		SPDK_DEBUGLOG(rdma, "Release incomplete requests\n");
-		for (i = 0; i < max_req_count; i++) {
-			req = &rqpair->resources->reqs[i];
-			if (req->req.qpair == qpair && req->state != RDMA_REQUEST_STATE_FREE) {
-				/* nvmf_rdma_request_process checks qpair ibv and internal state
-				 * and completes a request */
-				nvmf_rdma_request_process(rtransport, req);
+			struct spdk_nvmf_rdma_resources *resources = NULL;
+
+			while ((resources = nvmf_rdma_poller_next_resources(rqpair->poller,
+					    resources)) != NULL) {
+				for (i = 0; i < resources->num_entries; i++) {
+					req = &resources->reqs[i];
+					if (req->req.qpair == qpair && req->state != RDMA_REQUEST_STATE_FREE) {
+						nvmf_rdma_request_process(rtransport, req);
+					}
+				}
 			}
 		}
 		assert(rqpair->qd == 0);
@@ -885,7 +1121,7 @@ nvmf_rdma_qpair_destroy(struct spdk_nvmf_rdma_qpair *rqpair)
 			STAILQ_FOREACH_SAFE(rdma_recv, &rqpair->resources->incoming_queue, link, recv_tmp) {
 				if (rqpair == rdma_recv->qpair) {
 					STAILQ_REMOVE(&rqpair->resources->incoming_queue, rdma_recv, spdk_nvmf_rdma_recv, link);
-					spdk_rdma_srq_queue_recv_wrs(rqpair->srq, &rdma_recv->wr);
+					nvmf_rdma_srq_repost_recv(rqpair->poller, rdma_recv);
 					rc = spdk_rdma_srq_flush_recv_wrs(rqpair->srq, &bad_recv_wr);
 					if (rc) {
 						SPDK_ERRLOG("Unable to re-post rx descriptor\n");
@@ -957,7 +1193,7 @@ nvmf_rdma_resize_cq(struct spdk_nvmf_rdma_qpair *rqpair, struct spdk_nvmf_rdma_d
 		}
 
 		SPDK_DEBUGLOG(rdma, "Resize RDMA CQ from %d to %d\n", rpoller->num_cqe, num_cqe);
-		rc = ibv_resize_cq(rpoller->cq, num_cqe);
+		rc = spdk_rdma_cq_resize(rpoller->cq, num_cqe);
 		if (rc) {
 			SPDK_ERRLOG("RDMA CQ resize failed: errno %d: %s\n", errno, spdk_strerror(errno));
 			return -1;
@@ -985,8 +1221,8 @@ nvmf_rdma_qpair_initialize(struct spdk_nvmf_qpair *qpair)
 
 	qp_init_attr.qp_context	= rqpair;
 	qp_init_attr.pd		= device->pd;
-	qp_init_attr.send_cq	= rqpair->poller->cq;
-	qp_init_attr.recv_cq	= rqpair->poller->cq;
+	qp_init_attr.send_cq	= spdk_rdma_cq_get_ibv_cq(rqpair->poller->cq);
+	qp_init_attr.recv_cq	= spdk_rdma_cq_get_ibv_cq(rqpair->poller->cq);
 
 	if (rqpair->srq) {
 		qp_init_attr.srq		= rqpair->srq->srq;
@@ -1064,7 +1300,17 @@ nvmf_rdma_qpair_queue_recv_wrs(struct spdk_nvmf_rdma_qpair *rqpair, struct ibv_r
 			struct spdk_nvmf_rdma_transport, transport);
 
 	if (rqpair->srq != NULL) {
-		spdk_rdma_srq_queue_recv_wrs(rqpair->srq, first);
+		struct ibv_recv_wr *cur, *next;
+
+		/* Route each wr through the repost helper so that receives of a
+		 * draining resource chunk are parked instead of re-posted. */
+		for (cur = first; cur != NULL; cur = next) {
+			next = cur->next;
+			cur->next = NULL;
+			nvmf_rdma_srq_repost_recv(rqpair->poller,
+						  SPDK_CONTAINEROF((struct spdk_nvmf_rdma_wr *)cur->wr_id,
+								  struct spdk_nvmf_rdma_recv, rdma_wr));
+		}
 	} else {
 		if (spdk_rdma_qp_queue_recv_wrs(rqpair->rdma_qp, first)) {
 			STAILQ_INSERT_TAIL(&rqpair->poller->qpairs_pending_recv, rqpair, recv_link);
@@ -1987,7 +2233,14 @@ _nvmf_rdma_request_free(struct spdk_nvmf_rdma_request *rdma_req,
 	memset(&rdma_req->req.dif, 0, sizeof(rdma_req->req.dif));
 	rqpair->qd--;
 
-	STAILQ_INSERT_HEAD(&rqpair->resources->free_queue, rdma_req, state_link);
+	if (spdk_unlikely(rdma_req->resources->draining)) {
+		/* This request's resource chunk is being removed by the SRQ
+		 * autoscaler - park the request on the chunk's own free queue. */
+		STAILQ_INSERT_TAIL(&rdma_req->resources->free_queue, rdma_req, state_link);
+		rdma_req->resources->num_free_reqs++;
+	} else {
+		STAILQ_INSERT_HEAD(&rqpair->resources->free_queue, rdma_req, state_link);
+	}
 	rqpair->qpair.queue_depth--;
 	rdma_req->state = RDMA_REQUEST_STATE_FREE;
 }
@@ -2455,6 +2708,14 @@ nvmf_rdma_request_process(struct spdk_nvmf_rdma_transport *rtransport,
 #define SPDK_NVMF_RDMA_DEFAULT_NUM_SHARED_BUFFERS 4095
 #define SPDK_NVMF_RDMA_DEFAULT_BUFFER_CACHE_SIZE UINT32_MAX
 #define SPDK_NVMF_RDMA_DEFAULT_NO_SRQ false
+#define SPDK_NVMF_RDMA_DEFAULT_SRQ_AUTOSCALE false
+/* With SRQ autoscaling, receive resources are allocated in chunks of
+ * max_srq_depth / SPDK_NVMF_RDMA_SRQ_NUM_CHUNKS entries.  A chunk is added as
+ * soon as the number of posted receives dips below half a chunk and removed
+ * when more than one and a half chunks stayed posted (i.e. unused) throughout
+ * a whole shrink interval, so the two thresholds never chase each other. */
+#define SPDK_NVMF_RDMA_SRQ_NUM_CHUNKS 8
+#define SPDK_NVMF_RDMA_SRQ_SHRINK_INTERVAL_SEC 10
 #define SPDK_NVMF_RDMA_DIF_INSERT_OR_STRIP false
 #define SPDK_NVMF_RDMA_ACCEPTOR_BACKLOG 100
 #define SPDK_NVMF_RDMA_DEFAULT_ABORT_TIMEOUT_SEC 1
@@ -2651,6 +2912,7 @@ nvmf_rdma_create(struct spdk_nvmf_transport_opts *opts)
 	rtransport->rdma_opts.num_cqe = DEFAULT_NVMF_RDMA_CQ_SIZE;
 	rtransport->rdma_opts.max_srq_depth = SPDK_NVMF_RDMA_DEFAULT_SRQ_DEPTH;
 	rtransport->rdma_opts.no_srq = SPDK_NVMF_RDMA_DEFAULT_NO_SRQ;
+	rtransport->rdma_opts.srq_autoscale = SPDK_NVMF_RDMA_DEFAULT_SRQ_AUTOSCALE;
 	rtransport->rdma_opts.acceptor_backlog = SPDK_NVMF_RDMA_ACCEPTOR_BACKLOG;
 	rtransport->rdma_opts.no_wr_batching = SPDK_NVMF_RDMA_DEFAULT_NO_WR_BATCHING;
 	if (opts->transport_specific != NULL &&
@@ -2666,8 +2928,8 @@ nvmf_rdma_create(struct spdk_nvmf_transport_opts *opts)
 		     "  Transport opts:  max_ioq_depth=%d, max_io_size=%d,\n"
 		     "  max_io_qpairs_per_ctrlr=%d, io_unit_size=%d,\n"
 		     "  in_capsule_data_size=%d, max_aq_depth=%d,\n"
-		     "  num_shared_buffers=%d, num_cqe=%d, max_srq_depth=%d, no_srq=%d,"
-		     "  acceptor_backlog=%d, no_wr_batching=%d abort_timeout_sec=%d\n",
+		     "  num_shared_buffers=%d, num_cqe=%d, max_srq_depth=%d, no_srq=%d,\n"
+		     "  srq_autoscale=%d, acceptor_backlog=%d, no_wr_batching=%d abort_timeout_sec=%d\n",
 		     opts->max_queue_depth,
 		     opts->max_io_size,
 		     opts->max_qpairs_per_ctrlr - 1,
@@ -2678,6 +2940,7 @@ nvmf_rdma_create(struct spdk_nvmf_transport_opts *opts)
 		     rtransport->rdma_opts.num_cqe,
 		     rtransport->rdma_opts.max_srq_depth,
 		     rtransport->rdma_opts.no_srq,
+		     rtransport->rdma_opts.srq_autoscale,
 		     rtransport->rdma_opts.acceptor_backlog,
 		     rtransport->rdma_opts.no_wr_batching,
 		     opts->abort_timeout_sec);
@@ -2841,6 +3104,7 @@ nvmf_rdma_dump_opts(struct spdk_nvmf_transport *transport, struct spdk_json_writ
 	rtransport = SPDK_CONTAINEROF(transport, struct spdk_nvmf_rdma_transport, transport);
 	spdk_json_write_named_uint32(w, "max_srq_depth", rtransport->rdma_opts.max_srq_depth);
 	spdk_json_write_named_bool(w, "no_srq", rtransport->rdma_opts.no_srq);
+	spdk_json_write_named_bool(w, "srq_autoscale", rtransport->rdma_opts.srq_autoscale);
 	if (rtransport->rdma_opts.no_srq == true) {
 		spdk_json_write_named_int32(w, "num_cqe", rtransport->rdma_opts.num_cqe);
 	}
@@ -3975,6 +4239,7 @@ nvmf_rdma_poller_create(struct spdk_nvmf_rdma_transport *rtransport,
 {
 	struct spdk_nvmf_rdma_poller		*poller;
 	struct spdk_rdma_srq_init_attr		srq_init_attr;
+	struct spdk_rdma_cq_init_attr		cq_attr = {};
 	struct spdk_nvmf_rdma_resource_opts	opts;
 	int					num_cqe;
 
@@ -3991,6 +4256,7 @@ nvmf_rdma_poller_create(struct spdk_nvmf_rdma_transport *rtransport,
 	RB_INIT(&poller->qpairs);
 	STAILQ_INIT(&poller->qpairs_pending_send);
 	STAILQ_INIT(&poller->qpairs_pending_recv);
+	TAILQ_INIT(&poller->srq_chunks);
 
 	TAILQ_INSERT_TAIL(&rgroup->pollers, poller, link);
 	SPDK_DEBUGLOG(rdma, "Create poller %p on device %p in poll group %p.\n", poller, device, rgroup);
@@ -4013,11 +4279,23 @@ nvmf_rdma_poller_create(struct spdk_nvmf_rdma_transport *rtransport,
 			return -1;
 		}
 
+		if (rtransport->rdma_opts.srq_autoscale) {
+			poller->srq_chunk_size = spdk_max(poller->max_srq_depth / SPDK_NVMF_RDMA_SRQ_NUM_CHUNKS,
+							  rtransport->transport.opts.max_queue_depth);
+			if (poller->srq_chunk_size < poller->max_srq_depth) {
+				poller->srq_autoscale = true;
+			} else {
+				/* Autoscaling degenerates to a single full-size chunk */
+				SPDK_WARNLOG("max_srq_depth %u too small to autoscale, using a fixed SRQ depth\n",
+					     poller->max_srq_depth);
+			}
+		}
+
 		opts.qp = poller->srq;
 		opts.map = device->map;
 		opts.qpair = NULL;
 		opts.shared = true;
-		opts.max_queue_depth = poller->max_srq_depth;
+		opts.max_queue_depth = poller->srq_autoscale ? poller->srq_chunk_size : poller->max_srq_depth;
 		opts.in_capsule_data_size = rtransport->transport.opts.in_capsule_data_size;
 
 		poller->resources = nvmf_rdma_resources_create(&opts);
@@ -4025,6 +4303,12 @@ nvmf_rdma_poller_create(struct spdk_nvmf_rdma_transport *rtransport,
 			SPDK_ERRLOG("Unable to allocate resources for shared receive queue.\n");
 			return -1;
 		}
+
+		poller->srq_depth = opts.max_queue_depth;
+		poller->srq_posted = opts.max_queue_depth;
+		poller->srq_min_posted = opts.max_queue_depth;
+		poller->srq_shrink_tsc = spdk_get_ticks();
+		poller->srq_shrink_period = SPDK_NVMF_RDMA_SRQ_SHRINK_INTERVAL_SEC * spdk_get_ticks_hz();
 	}
 
 	/*
@@ -4039,7 +4323,10 @@ nvmf_rdma_poller_create(struct spdk_nvmf_rdma_transport *rtransport,
 		num_cqe = rtransport->rdma_opts.num_cqe;
 	}
 
-	poller->cq = ibv_create_cq(device->context, num_cqe, poller, NULL, 0);
+	cq_attr.context = device->context;
+	cq_attr.cqe = num_cqe;
+	cq_attr.cq_context = poller;
+	poller->cq = spdk_rdma_cq_create(&cq_attr);
 	if (!poller->cq) {
 		SPDK_ERRLOG("Unable to create completion queue\n");
 		return -1;
@@ -4183,7 +4470,6 @@ static void
 nvmf_rdma_poller_destroy(struct spdk_nvmf_rdma_poller *poller)
 {
 	struct spdk_nvmf_rdma_qpair	*qpair, *tmp_qpair;
-	int				rc;
 
 	TAILQ_REMOVE(&poller->group->pollers, poller, link);
 	RB_FOREACH_SAFE(qpair, qpairs_tree, &poller->qpairs, tmp_qpair) {
@@ -4191,6 +4477,12 @@ nvmf_rdma_poller_destroy(struct spdk_nvmf_rdma_poller *poller)
 	}
 
 	if (poller->srq) {
+		struct spdk_nvmf_rdma_resources *chunk, *tmp_chunk;
+
+		TAILQ_FOREACH_SAFE(chunk, &poller->srq_chunks, link, tmp_chunk) {
+			TAILQ_REMOVE(&poller->srq_chunks, chunk, link);
+			nvmf_rdma_resources_destroy(chunk);
+		}
 		if (poller->resources) {
 			nvmf_rdma_resources_destroy(poller->resources);
 		}
@@ -4199,10 +4491,7 @@ nvmf_rdma_poller_destroy(struct spdk_nvmf_rdma_poller *poller)
 	}
 
 	if (poller->cq) {
-		rc = ibv_destroy_cq(poller->cq);
-		if (rc != 0) {
-			SPDK_ERRLOG("Destroy cq return %d, error: %s\n", rc, strerror(errno));
-		}
+		spdk_rdma_cq_destroy(poller->cq);
 	}
 
 	if (poller->destroy_cb) {
@@ -4357,7 +4646,7 @@ nvmf_rdma_request_free(struct spdk_nvmf_request *req)
 		int rc;
 		struct ibv_recv_wr *bad_recv_wr;
 
-		spdk_rdma_srq_queue_recv_wrs(rqpair->srq, &rdma_req->recv->wr);
+		nvmf_rdma_srq_repost_recv(rqpair->poller, rdma_req->recv);
 		rc = spdk_rdma_srq_flush_recv_wrs(rqpair->srq, &bad_recv_wr);
 		if (rc) {
 			SPDK_ERRLOG("Unable to re-post rx descriptor\n");
@@ -4452,6 +4741,8 @@ _poller_reset_failed_recvs(struct spdk_nvmf_rdma_poller *rpoller, struct ibv_rec
 		bad_rdma_wr = (struct spdk_nvmf_rdma_wr *)bad_recv_wr->wr_id;
 		rdma_recv = SPDK_CONTAINEROF(bad_rdma_wr, struct spdk_nvmf_rdma_recv, rdma_wr);
 
+		assert(rpoller->srq_posted > 0);
+		rpoller->srq_posted--;
 		rdma_recv->qpair->current_recv_depth++;
 		bad_recv_wr = bad_recv_wr->next;
 		SPDK_ERRLOG("Failed to post a recv for the qpair %p with errno %d\n", rdma_recv->qpair, -rc);
@@ -4639,10 +4930,10 @@ nvmf_rdma_poller_poll(struct spdk_nvmf_rdma_transport *rtransport,
 	}
 
 	/* Poll for completing operations. */
-	reaped = ibv_poll_cq(rpoller->cq, 32, wc);
+	reaped = spdk_rdma_cq_poll(rpoller->cq, 32, wc);
 	if (spdk_unlikely(reaped < 0)) {
 		SPDK_ERRLOG("Error polling CQ! (%d): %s\n",
-			    errno, spdk_strerror(errno));
+			    -reaped, spdk_strerror(-reaped));
 		return -1;
 	} else if (reaped == 0) {
 		rpoller->stat.idle_polls++;
@@ -4678,6 +4969,8 @@ nvmf_rdma_poller_poll(struct spdk_nvmf_rdma_transport *rtransport,
 			/* rdma_recv->qpair will be invalid if using an SRQ.  In that case we have to get the qpair from the wc. */
 			rdma_recv = SPDK_CONTAINEROF(rdma_wr, struct spdk_nvmf_rdma_recv, rdma_wr);
 			if (rpoller->srq != NULL) {
+				assert(rpoller->srq_posted > 0);
+				rpoller->srq_posted--;
 				rdma_recv->qpair = get_rdma_qpair_from_wc(rpoller, &wc[i]);
 				/* It is possible that there are still some completions for destroyed QP
 				 * associated with SRQ. We just ignore these late completions and re-post
@@ -4687,7 +4980,7 @@ nvmf_rdma_poller_poll(struct spdk_nvmf_rdma_transport *rtransport,
 					struct ibv_recv_wr *bad_wr;
 
 					rdma_recv->wr.next = NULL;
-					spdk_rdma_srq_queue_recv_wrs(rpoller->srq, &rdma_recv->wr);
+					nvmf_rdma_srq_repost_recv(rpoller, rdma_recv);
 					rc = spdk_rdma_srq_flush_recv_wrs(rpoller->srq, &bad_wr);
 					if (rc) {
 						SPDK_ERRLOG("Failed to re-post recv WR to SRQ, err %d\n", rc);
@@ -4799,6 +5092,10 @@ nvmf_rdma_poller_poll(struct spdk_nvmf_rdma_transport *rtransport,
 	_poller_submit_recvs(rtransport, rpoller);
 	_poller_submit_sends(rtransport, rpoller);
 
+	if (spdk_unlikely(rpoller->srq_autoscale)) {
+		nvmf_rdma_srq_autoscale_poll(rtransport, rpoller, poll_tsc);
+	}
+
 	return count;
 }
 
@@ -5054,7 +5351,7 @@ nvmf_rdma_qpair_abort_request(struct spdk_nvmf_qpair *qpair,
 	struct spdk_nvmf_rdma_transport *rtransport;
 	struct spdk_nvmf_transport *transport;
 	uint16_t cid;
-	uint32_t i, max_req_count;
+	uint32_t i;
 	struct spdk_nvmf_rdma_request *rdma_req_to_abort = NULL, *rdma_req;
 
 	rqpair = SPDK_CONTAINEROF(qpair, struct spdk_nvmf_rdma_qpair, qpair);
@@ -5062,17 +5359,32 @@ nvmf_rdma_qpair_abort_request(struct spdk_nvmf_qpair *qpair,
 	transport = &rtransport->transport;
 
 	cid = req->cmd->nvme_cmd.cdw10_bits.abort.cid;
-	max_req_count = rqpair->srq == NULL ? rqpair->max_queue_depth : rqpair->poller->max_srq_depth;
-
-	for (i = 0; i < max_req_count; i++) {
-		rdma_req = &rqpair->resources->reqs[i];
-		/* When SRQ == NULL, rqpair has its own requests and req.qpair pointer always points to the qpair
-		 * When SRQ != NULL all rqpairs share common requests and qpair pointer is assigned when we start to
-		 * process a request. So in both cases all requests which are not in FREE state have valid qpair ptr */
-		if (rdma_req->state != RDMA_REQUEST_STATE_FREE && rdma_req->req.cmd->nvme_cmd.cid == cid &&
-		    rdma_req->req.qpair == qpair) {
-			rdma_req_to_abort = rdma_req;
-			break;
+
+	/* When SRQ == NULL, rqpair has its own requests and req.qpair pointer always points to the qpair
+	 * When SRQ != NULL all rqpairs share common requests and qpair pointer is assigned when we start to
+	 * process a request. So in both cases all requests which are not in FREE state have valid qpair ptr */
+	if (rqpair->srq == NULL) {
+		for (i = 0; i < rqpair->max_queue_depth; i++) {
+			rdma_req = &rqpair->resources->reqs[i];
+			if (rdma_req->state != RDMA_REQUEST_STATE_FREE && rdma_req->req.cmd->nvme_cmd.cid == cid &&
+			    rdma_req->req.qpair == qpair) {
+				rdma_req_to_abort = rdma_req;
+				break;
+			}
+		}
+	} else {
+		struct spdk_nvmf_rdma_resources *resources = NULL;
+
+		while (rdma_req_to_abort == NULL &&
+		       (resources = nvmf_rdma_poller_next_resources(rqpair->poller, resources)) != NULL) {
+			for (i = 0; i < resources->num_entries; i++) {
+				rdma_req = &resources->reqs[i];
+				if (rdma_req->state != RDMA_REQUEST_STATE_FREE && rdma_req->req.cmd->nvme_cmd.cid == cid &&
+				    rdma_req->req.qpair == qpair) {
+					rdma_req_to_abort = rdma_req;
+					break;
+				}
+			}
 		}
 	}
 
@@ -1034,6 +1034,9 @@ spdk_nvmf_subsystem_add_host_ext(struct spdk_nvmf_subsystem *subsystem,
 
 	snprintf(host->nqn, sizeof(host->nqn), "%s", hostnqn);
 
+	host->max_ios_per_sec = SPDK_GET_FIELD(opts, max_ios_per_sec, 0);
+	host->max_bytes_per_sec = SPDK_GET_FIELD(opts, max_mbytes_per_sec, 0) * 1024 * 1024;
+
 	SPDK_DTRACE_PROBE2(nvmf_subsystem_add_host, subsystem->subnqn, host->nqn);
 
 	TAILQ_INSERT_HEAD(&subsystem->hosts, host, link);
@@ -1280,6 +1283,70 @@ nvmf_subsystem_get_dhchap_key(struct spdk_nvmf_subsystem *subsystem, const char
 	return key;
 }
 
+void
+nvmf_subsystem_get_host_qos(struct spdk_nvmf_subsystem *subsystem, const char *hostnqn,
+			    uint64_t *ios_per_sec, uint64_t *bytes_per_sec)
+{
+	struct spdk_nvmf_host *host;
+
+	*ios_per_sec = 0;
+	*bytes_per_sec = 0;
+
+	pthread_mutex_lock(&subsystem->mutex);
+	host = nvmf_subsystem_find_host(subsystem, hostnqn);
+	if (host != NULL) {
+		*ios_per_sec = host->max_ios_per_sec;
+		*bytes_per_sec = host->max_bytes_per_sec;
+	}
+	pthread_mutex_unlock(&subsystem->mutex);
+}
+
+static void
+nvmf_ctrlr_qos_changed_msg(void *ctx)
+{
+	struct spdk_nvmf_ctrlr *ctrlr = ctx;
+
+	if (!ctrlr->in_destruct) {
+		nvmf_ctrlr_start_qos_poller(ctrlr);
+	}
+}
+
+int
+spdk_nvmf_subsystem_set_host_qos(struct spdk_nvmf_subsystem *subsystem, const char *hostnqn,
+				 uint64_t max_ios_per_sec, uint64_t max_mbytes_per_sec)
+{
+	struct spdk_nvmf_host *host;
+	struct spdk_nvmf_ctrlr *ctrlr;
+
+	pthread_mutex_lock(&subsystem->mutex);
+
+	host = nvmf_subsystem_find_host(subsystem, hostnqn);
+	if (host == NULL) {
+		pthread_mutex_unlock(&subsystem->mutex);
+		return -ENOENT;
+	}
+
+	host->max_ios_per_sec = max_ios_per_sec;
+	host->max_bytes_per_sec = max_mbytes_per_sec * 1024 * 1024;
+
+	/* Propagate the new limits to this host's existing controllers.  The
+	 * limits themselves may be updated from any thread, but the QoS
+	 * poller must be started or stopped on the controller's thread.
+	 */
+	TAILQ_FOREACH(ctrlr, &subsystem->ctrlrs, link) {
+		if (strcmp(ctrlr->hostnqn, host->nqn) != 0) {
+			continue;
+		}
+		__atomic_store_n(&ctrlr->qos_ios_per_sec, host->max_ios_per_sec, __ATOMIC_RELAXED);
+		__atomic_store_n(&ctrlr->qos_bytes_per_sec, host->max_bytes_per_sec, __ATOMIC_RELAXED);
+		spdk_thread_send_msg(ctrlr->thread, nvmf_ctrlr_qos_changed_msg, ctrlr);
+	}
+
+	pthread_mutex_unlock(&subsystem->mutex);
+
+	return 0;
+}
+
 struct spdk_nvmf_host *
 spdk_nvmf_subsystem_get_first_host(struct spdk_nvmf_subsystem *subsystem)
 {
@@ -1676,6 +1743,42 @@ nvmf_subsystem_ns_changed(struct spdk_nvmf_subsystem *subsystem, uint32_t nsid)
 	}
 }
 
+struct subsystem_add_ns_ctx {
+	struct spdk_nvmf_subsystem *subsystem;
+	uint32_t nsid;
+};
+
+static void
+subsystem_add_ns_done(struct spdk_io_channel_iter *i, int status)
+{
+	struct subsystem_add_ns_ctx *ctx = spdk_io_channel_iter_get_ctx(i);
+
+	if (status != 0) {
+		/* The namespace stays in the subsystem, but poll groups that were
+		 * not updated will keep failing I/O to it with a retryable status
+		 * until the next update (e.g. a pause/resume cycle).
+		 */
+		SPDK_ERRLOG("Subsystem %s: failed to add nsid %" PRIu32 " to all poll groups, status %d\n",
+			    ctx->subsystem->subnqn, ctx->nsid, status);
+	}
+
+	nvmf_subsystem_ns_changed(ctx->subsystem, ctx->nsid);
+	free(ctx);
+}
+
+static void
+subsystem_add_ns_on_pg(struct spdk_io_channel_iter *i)
+{
+	struct subsystem_add_ns_ctx *ctx = spdk_io_channel_iter_get_ctx(i);
+	struct spdk_nvmf_poll_group *group;
+	int rc;
+
+	group = spdk_io_channel_get_ctx(spdk_io_channel_iter_get_channel(i));
+
+	rc = nvmf_poll_group_add_ns(group, ctx->subsystem, ctx->nsid);
+	spdk_for_each_channel_continue(i, rc);
+}
+
 static uint32_t nvmf_ns_reservation_clear_all_registrants(struct spdk_nvmf_ns *ns);
 
 int
@@ -1992,12 +2095,14 @@ spdk_nvmf_subsystem_add_ns_ext(struct spdk_nvmf_subsystem *subsystem, const char
 	struct spdk_nvmf_ns *ns, *first_ns;
 	struct spdk_nvmf_ctrlr *ctrlr;
 	struct spdk_nvmf_reservation_info info = {0};
+	struct subsystem_add_ns_ctx *update_ctx;
 	int rc;
 	bool zone_append_supported;
 	uint64_t max_zone_append_size_kib;
 
 	if (!(subsystem->state == SPDK_NVMF_SUBSYSTEM_INACTIVE ||
-	      subsystem->state == SPDK_NVMF_SUBSYSTEM_PAUSED)) {
+	      subsystem->state == SPDK_NVMF_SUBSYSTEM_PAUSED ||
+	      subsystem->state == SPDK_NVMF_SUBSYSTEM_ACTIVE)) {
 		return 0;
 	}
 
@@ -2190,7 +2295,25 @@ spdk_nvmf_subsystem_add_ns_ext(struct spdk_nvmf_subsystem *subsystem, const char
 		      bdev_name,
 		      opts.nsid);
 
-	nvmf_subsystem_ns_changed(subsystem, opts.nsid);
+	if (subsystem->state == SPDK_NVMF_SUBSYSTEM_ACTIVE) {
+		/* The subsystem was not paused, so the poll groups have not picked up
+		 * the new namespace yet.  Publish it to each poll group on its own
+		 * thread, then notify the hosts.  I/O to the existing namespaces
+		 * continues untouched the whole time.
+		 */
+		update_ctx = calloc(1, sizeof(*update_ctx));
+		if (update_ctx == NULL) {
+			SPDK_ERRLOG("Unable to allocate namespace publish context\n");
+			nvmf_ns_reservation_clear_all_registrants(ns);
+			goto err;
+		}
+		update_ctx->subsystem = subsystem;
+		update_ctx->nsid = opts.nsid;
+		spdk_for_each_channel(subsystem->tgt, subsystem_add_ns_on_pg, update_ctx,
+				      subsystem_add_ns_done);
+	} else {
+		nvmf_subsystem_ns_changed(subsystem, opts.nsid);
+	}
 
 	SPDK_DTRACE_PROBE2(nvmf_subsystem_add_ns, subsystem->subnqn, ns->nsid);
 
@@ -3646,6 +3769,10 @@ subsystem_listener_update_on_pg(struct spdk_io_channel_iter *i)
 			continue;
 		}
 
+		if (ctrlr->listener == listener) {
+			ctrlr->ana_log_page_dirty = true;
+		}
+
 		if (ctrlr->admin_qpair && ctrlr->admin_qpair->group == group && ctrlr->listener == listener) {
 			nvmf_ctrlr_async_event_ana_change_notice(ctrlr);
 		}
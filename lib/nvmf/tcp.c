@@ -26,10 +26,18 @@
 #include "spdk_internal/trace_defs.h"
 
 #define NVMF_TCP_MAX_ACCEPT_SOCK_ONE_TIME 16
+#define NVMF_TCP_MAX_LISTENER_SHARDS 16
+#define SPDK_NVMF_TCP_DEFAULT_LISTENER_SHARDS 1
 #define SPDK_NVMF_TCP_DEFAULT_MAX_SOCK_PRIORITY 16
 #define SPDK_NVMF_TCP_DEFAULT_SOCK_PRIORITY 0
 #define SPDK_NVMF_TCP_DEFAULT_CONTROL_MSG_NUM 32
 #define SPDK_NVMF_TCP_DEFAULT_SUCCESS_OPTIMIZATION true
+#define SPDK_NVMF_TCP_DEFAULT_ENABLE_RECV_PIPE true
+
+/* Data digests of PDUs smaller than this are computed in software.  For small
+ * payloads the crc32c costs less on the CPU than the descriptor setup and
+ * completion latency of an accel offload. */
+#define SPDK_NVMF_TCP_DDGST_ACCEL_MIN_DATA_LEN 8192
 
 #define SPDK_NVMF_TCP_MIN_IO_QUEUE_DEPTH 2
 #define SPDK_NVMF_TCP_MAX_IO_QUEUE_DEPTH 65535
@@ -334,14 +342,19 @@ struct spdk_nvmf_tcp_poll_group {
 
 struct spdk_nvmf_tcp_port {
 	const struct spdk_nvme_transport_id	*trid;
-	struct spdk_sock			*listen_sock;
+	/* One listen socket per shard, all bound to the same address and port
+	 * with SO_REUSEPORT when more than one shard is configured. */
+	struct spdk_sock			*listen_socks[NVMF_TCP_MAX_LISTENER_SHARDS];
+	uint32_t				num_listen_socks;
 	TAILQ_ENTRY(spdk_nvmf_tcp_port)		link;
 };
 
 struct tcp_transport_opts {
 	bool		c2h_success;
+	bool		enable_recv_pipe;
 	uint16_t	control_msg_num;
 	uint32_t	sock_priority;
+	uint32_t	listener_shards;
 };
 
 struct tcp_psk_entry {
@@ -382,10 +395,18 @@ static const struct spdk_json_object_decoder tcp_transport_opts_decoder[] = {
 		"control_msg_num", offsetof(struct tcp_transport_opts, control_msg_num),
 		spdk_json_decode_uint16, true
 	},
+	{
+		"enable_recv_pipe", offsetof(struct tcp_transport_opts, enable_recv_pipe),
+		spdk_json_decode_bool, true
+	},
 	{
 		"sock_priority", offsetof(struct tcp_transport_opts, sock_priority),
 		spdk_json_decode_uint32, true
 	},
+	{
+		"listener_shards", offsetof(struct tcp_transport_opts, listener_shards),
+		spdk_json_decode_uint32, true
+	},
 };
 
 static bool nvmf_tcp_req_process(struct spdk_nvmf_tcp_transport *ttransport,
@@ -428,6 +449,13 @@ nvmf_tcp_req_get(struct spdk_nvmf_tcp_qpair *tqpair)
 {
 	struct spdk_nvmf_tcp_req *tcp_req;
 
+	if (spdk_unlikely(tqpair->qpair.migrate_ctx != NULL)) {
+		/* Don't start new requests while the qpair is migrating to another
+		 * poll group.  The capsule waits in the AWAIT_REQ state until the
+		 * migration completes, just as if the free queue were empty. */
+		return NULL;
+	}
+
 	tcp_req = TAILQ_FIRST(&tqpair->tcp_req_free_queue);
 	if (spdk_unlikely(!tcp_req)) {
 		return NULL;
@@ -598,7 +626,9 @@ nvmf_tcp_dump_opts(struct spdk_nvmf_transport *transport, struct spdk_json_write
 
 	ttransport = SPDK_CONTAINEROF(transport, struct spdk_nvmf_tcp_transport, transport);
 	spdk_json_write_named_bool(w, "c2h_success", ttransport->tcp_opts.c2h_success);
+	spdk_json_write_named_bool(w, "enable_recv_pipe", ttransport->tcp_opts.enable_recv_pipe);
 	spdk_json_write_named_uint32(w, "sock_priority", ttransport->tcp_opts.sock_priority);
+	spdk_json_write_named_uint32(w, "listener_shards", ttransport->tcp_opts.listener_shards);
 }
 
 static void
@@ -658,8 +688,10 @@ nvmf_tcp_create(struct spdk_nvmf_transport_opts *opts)
 	ttransport->transport.ops = &spdk_nvmf_transport_tcp;
 
 	ttransport->tcp_opts.c2h_success = SPDK_NVMF_TCP_DEFAULT_SUCCESS_OPTIMIZATION;
+	ttransport->tcp_opts.enable_recv_pipe = SPDK_NVMF_TCP_DEFAULT_ENABLE_RECV_PIPE;
 	ttransport->tcp_opts.sock_priority = SPDK_NVMF_TCP_DEFAULT_SOCK_PRIORITY;
 	ttransport->tcp_opts.control_msg_num = SPDK_NVMF_TCP_DEFAULT_CONTROL_MSG_NUM;
+	ttransport->tcp_opts.listener_shards = SPDK_NVMF_TCP_DEFAULT_LISTENER_SHARDS;
 	if (opts->transport_specific != NULL &&
 	    spdk_json_decode_object_relaxed(opts->transport_specific, tcp_transport_opts_decoder,
 					    SPDK_COUNTOF(tcp_transport_opts_decoder),
@@ -701,6 +733,14 @@ nvmf_tcp_create(struct spdk_nvmf_transport_opts *opts)
 		return NULL;
 	}
 
+	if (ttransport->tcp_opts.listener_shards == 0 ||
+	    ttransport->tcp_opts.listener_shards > NVMF_TCP_MAX_LISTENER_SHARDS) {
+		SPDK_WARNLOG("TCP param listener_shards %u is out of range 1 to %u. Using default value %u\n",
+			     ttransport->tcp_opts.listener_shards, NVMF_TCP_MAX_LISTENER_SHARDS,
+			     SPDK_NVMF_TCP_DEFAULT_LISTENER_SHARDS);
+		ttransport->tcp_opts.listener_shards = SPDK_NVMF_TCP_DEFAULT_LISTENER_SHARDS;
+	}
+
 	if (ttransport->tcp_opts.control_msg_num == 0 &&
 	    opts->in_capsule_data_size < SPDK_NVME_TCP_IN_CAPSULE_DATA_MAX_SIZE) {
 		SPDK_WARNLOG("TCP param control_msg_num can't be 0 if ICD is less than %u bytes. Using default value %u\n",
@@ -835,6 +875,17 @@ nvmf_tcp_find_port(struct spdk_nvmf_tcp_transport *ttransport,
 	return NULL;
 }
 
+static void
+nvmf_tcp_port_close_socks(struct spdk_nvmf_tcp_port *port)
+{
+	uint32_t i;
+
+	for (i = 0; i < port->num_listen_socks; i++) {
+		spdk_sock_close(&port->listen_socks[i]);
+	}
+	port->num_listen_socks = 0;
+}
+
 static int
 tcp_sock_get_key(uint8_t *out, int out_len, const char **cipher, const char *pskid,
 		 void *get_key_ctx)
@@ -889,8 +940,10 @@ nvmf_tcp_listen(struct spdk_nvmf_transport *transport, const struct spdk_nvme_tr
 {
 	struct spdk_nvmf_tcp_transport *ttransport;
 	struct spdk_nvmf_tcp_port *port;
+	struct spdk_sock *sock;
 	int trsvcid_int;
 	uint8_t adrfam;
+	uint32_t i, num_shards;
 	const char *sock_impl_name;
 	struct spdk_sock_impl_opts impl_opts;
 	size_t impl_opts_size = sizeof(impl_opts);
@@ -938,19 +991,47 @@ nvmf_tcp_listen(struct spdk_nvmf_transport *transport, const struct spdk_nvme_tr
 		opts.impl_opts_size = sizeof(impl_opts);
 	}
 
-	port->listen_sock = spdk_sock_listen_ext(trid->traddr, trsvcid_int,
-			    sock_impl_name, &opts);
-	if (port->listen_sock == NULL) {
-		SPDK_ERRLOG("spdk_sock_listen(%s, %d) failed: %s (%d)\n",
-			    trid->traddr, trsvcid_int,
-			    spdk_strerror(errno), errno);
-		free(port);
-		return -errno;
+	if (!ttransport->tcp_opts.enable_recv_pipe) {
+		if (opts.impl_opts == NULL) {
+			if (sock_impl_name == NULL) {
+				sock_impl_name = spdk_sock_get_default_impl();
+			}
+			spdk_sock_impl_get_opts(sock_impl_name, &impl_opts, &impl_opts_size);
+			opts.impl_opts = &impl_opts;
+			opts.impl_opts_size = sizeof(impl_opts);
+		}
+		/* Receive data PDU payloads directly into request buffers rather than
+		 * staging them in the sock layer's receive pipe first. Accepted sockets
+		 * inherit this setting from the listen socket. */
+		impl_opts.enable_recv_pipe = false;
 	}
 
-	if (spdk_sock_is_ipv4(port->listen_sock)) {
+	num_shards = ttransport->tcp_opts.listener_shards;
+	opts.reuse_port = num_shards > 1;
+
+	for (i = 0; i < num_shards; i++) {
+		sock = spdk_sock_listen_ext(trid->traddr, trsvcid_int,
+					    sock_impl_name, &opts);
+		if (sock == NULL) {
+			if (i > 0) {
+				/* The sock impl may not support SO_REUSEPORT. Run with
+				 * the shards created so far. */
+				SPDK_WARNLOG("Created %u of %u listener shards for %s port %s\n",
+					     i, num_shards, trid->traddr, trid->trsvcid);
+				break;
+			}
+			SPDK_ERRLOG("spdk_sock_listen(%s, %d) failed: %s (%d)\n",
+				    trid->traddr, trsvcid_int,
+				    spdk_strerror(errno), errno);
+			free(port);
+			return -errno;
+		}
+		port->listen_socks[port->num_listen_socks++] = sock;
+	}
+
+	if (spdk_sock_is_ipv4(port->listen_socks[0])) {
 		adrfam = SPDK_NVMF_ADRFAM_IPV4;
-	} else if (spdk_sock_is_ipv6(port->listen_sock)) {
+	} else if (spdk_sock_is_ipv6(port->listen_socks[0])) {
 		adrfam = SPDK_NVMF_ADRFAM_IPV6;
 	} else {
 		SPDK_ERRLOG("Unhandled socket type\n");
@@ -959,7 +1040,7 @@ nvmf_tcp_listen(struct spdk_nvmf_transport *transport, const struct spdk_nvme_tr
 
 	if (adrfam != trid->adrfam) {
 		SPDK_ERRLOG("Socket address family mismatch\n");
-		spdk_sock_close(&port->listen_sock);
+		nvmf_tcp_port_close_socks(port);
 		free(port);
 		return -EINVAL;
 	}
@@ -986,7 +1067,7 @@ nvmf_tcp_stop_listen(struct spdk_nvmf_transport *transport,
 	port = nvmf_tcp_find_port(ttransport, trid);
 	if (port) {
 		TAILQ_REMOVE(&ttransport->ports, port, link);
-		spdk_sock_close(&port->listen_sock);
+		nvmf_tcp_port_close_socks(port);
 		free(port);
 	}
 }
@@ -1118,6 +1199,7 @@ pdu_data_crc32_compute(struct nvme_tcp_pdu *pdu)
 	if (pdu->data_len > 0 && g_nvme_tcp_ddgst[pdu->hdr.common.pdu_type] && tqpair->host_ddgst_enable) {
 		/* Only support this limitated case for the first step */
 		if (spdk_likely(!pdu->dif_ctx && (pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT == 0)
+				&& pdu->data_len >= SPDK_NVMF_TCP_DDGST_ACCEL_MIN_DATA_LEN
 				&& tqpair->group)) {
 			rc = spdk_accel_submit_crc32cv(tqpair->group->accel_channel, &pdu->data_digest_crc32, pdu->data_iov,
 						       pdu->data_iovcnt, 0, data_crc32_accel_done, pdu);
@@ -1364,15 +1446,21 @@ nvmf_tcp_port_accept(struct spdk_nvmf_transport *transport, struct spdk_nvmf_tcp
 {
 	struct spdk_sock *sock;
 	uint32_t count = 0;
+	uint32_t shard;
 	int i;
 
-	for (i = 0; i < NVMF_TCP_MAX_ACCEPT_SOCK_ONE_TIME; i++) {
-		sock = spdk_sock_accept(port->listen_sock);
-		if (sock == NULL) {
-			break;
+	/* Drain each shard's backlog in batches. The kernel spreads incoming
+	 * connections across the SO_REUSEPORT shards, so no single accept queue
+	 * grows deep enough to overflow during a reconnect storm. */
+	for (shard = 0; shard < port->num_listen_socks; shard++) {
+		for (i = 0; i < NVMF_TCP_MAX_ACCEPT_SOCK_ONE_TIME; i++) {
+			sock = spdk_sock_accept(port->listen_socks[shard]);
+			if (sock == NULL) {
+				break;
+			}
+			count++;
+			nvmf_tcp_handle_connect(transport, port, sock);
 		}
-		count++;
-		nvmf_tcp_handle_connect(transport, port, sock);
 	}
 
 	return count;
@@ -1414,7 +1502,7 @@ nvmf_tcp_discover(struct spdk_nvmf_transport *transport,
 
 	assert(port != NULL);
 
-	if (strcmp(spdk_sock_get_impl_name(port->listen_sock), "ssl") == 0) {
+	if (strcmp(spdk_sock_get_impl_name(port->listen_socks[0]), "ssl") == 0) {
 		entry->treq.secure_channel = SPDK_NVMF_TREQ_SECURE_CHANNEL_REQUIRED;
 		entry->tsas.tcp.sectype = SPDK_NVME_TCP_SECURITY_TLS_1_3;
 	} else {
@@ -2074,6 +2162,7 @@ nvmf_tcp_pdu_payload_handle(struct spdk_nvmf_tcp_qpair *tqpair, struct nvme_tcp_
 	/* check data digest if need */
 	if (pdu->ddgst_enable) {
 		if (tqpair->qpair.qid != 0 && !pdu->dif_ctx && tqpair->group &&
+		    pdu->data_len >= SPDK_NVMF_TCP_DDGST_ACCEL_MIN_DATA_LEN &&
 		    (pdu->data_len % SPDK_NVME_TCP_DIGEST_ALIGNMENT == 0)) {
 			rc = spdk_accel_submit_crc32cv(tqpair->group->accel_channel, &pdu->data_digest_crc32, pdu->data_iov,
 						       pdu->data_iovcnt, 0, data_crc32_calc_done, pdu);
@@ -3307,6 +3396,85 @@ nvmf_tcp_poll_group_remove(struct spdk_nvmf_transport_poll_group *group,
 	return rc;
 }
 
+static int
+nvmf_tcp_qpair_migrate_detach(struct spdk_nvmf_transport_poll_group *group,
+			      struct spdk_nvmf_qpair *qpair)
+{
+	struct spdk_nvmf_tcp_poll_group	*tgroup;
+	struct spdk_nvmf_tcp_qpair	*tqpair;
+	int				rc;
+
+	tgroup = SPDK_CONTAINEROF(group, struct spdk_nvmf_tcp_poll_group, group);
+	tqpair = SPDK_CONTAINEROF(qpair, struct spdk_nvmf_tcp_qpair, qpair);
+
+	assert(tqpair->group == tgroup);
+
+	if (tqpair->state != NVME_TCP_QPAIR_STATE_RUNNING) {
+		return -ENOTSUP;
+	}
+
+	/* All requests must be back on the free queue before the qpair can leave
+	 * this group.  A capsule received during the migration waits in the
+	 * AWAIT_REQ state and is picked up once the qpair joins the new group. */
+	if (tqpair->state_cntr[TCP_REQUEST_STATE_FREE] != tqpair->resource_count) {
+		return -EAGAIN;
+	}
+
+	/* Try to force out any pending writes */
+	spdk_sock_flush(tqpair->sock);
+
+	rc = spdk_sock_group_remove_sock(tgroup->sock_group, tqpair->sock);
+	if (rc != 0) {
+		SPDK_ERRLOG("Could not remove sock from sock_group: %s (%d)\n",
+			    spdk_strerror(errno), errno);
+		return rc;
+	}
+
+	SPDK_DEBUGLOG(nvmf_tcp, "detach tqpair=%p from the tgroup=%p\n", tqpair, tgroup);
+	if (tqpair->recv_state == NVME_TCP_PDU_RECV_STATE_AWAIT_REQ) {
+		TAILQ_REMOVE(&tgroup->await_req, tqpair, link);
+	} else {
+		TAILQ_REMOVE(&tgroup->qpairs, tqpair, link);
+	}
+	tqpair->group = NULL;
+
+	return 0;
+}
+
+static int
+nvmf_tcp_qpair_migrate_attach(struct spdk_nvmf_transport_poll_group *group,
+			      struct spdk_nvmf_qpair *qpair)
+{
+	struct spdk_nvmf_tcp_poll_group	*tgroup;
+	struct spdk_nvmf_tcp_qpair	*tqpair;
+	int				rc;
+
+	tgroup = SPDK_CONTAINEROF(group, struct spdk_nvmf_tcp_poll_group, group);
+	tqpair = SPDK_CONTAINEROF(qpair, struct spdk_nvmf_tcp_qpair, qpair);
+
+	assert(tqpair->group == NULL);
+
+	SPDK_DEBUGLOG(nvmf_tcp, "attach tqpair=%p to the tgroup=%p\n", tqpair, tgroup);
+	tqpair->group = tgroup;
+	if (tqpair->recv_state == NVME_TCP_PDU_RECV_STATE_AWAIT_REQ) {
+		TAILQ_INSERT_TAIL(&tgroup->await_req, tqpair, link);
+	} else {
+		TAILQ_INSERT_TAIL(&tgroup->qpairs, tqpair, link);
+	}
+
+	rc = spdk_sock_group_add_sock(tgroup->sock_group, tqpair->sock,
+				      nvmf_tcp_sock_cb, tqpair);
+	if (rc != 0) {
+		SPDK_ERRLOG("Could not add sock to sock_group: %s (%d)\n",
+			    spdk_strerror(errno), errno);
+		/* Leave the qpair on this group's lists so that the disconnect
+		 * issued by the caller tears it down through the usual path. */
+		return rc;
+	}
+
+	return 0;
+}
+
 static int
 nvmf_tcp_req_complete(struct spdk_nvmf_request *req)
 {
@@ -3836,6 +4004,8 @@ const struct spdk_nvmf_transport_ops spdk_nvmf_transport_tcp = {
 	.poll_group_destroy = nvmf_tcp_poll_group_destroy,
 	.poll_group_add = nvmf_tcp_poll_group_add,
 	.poll_group_remove = nvmf_tcp_poll_group_remove,
+	.qpair_migrate_detach = nvmf_tcp_qpair_migrate_detach,
+	.qpair_migrate_attach = nvmf_tcp_qpair_migrate_attach,
 	.poll_group_poll = nvmf_tcp_poll_group_poll,
 
 	.req_free = nvmf_tcp_req_free,
@@ -634,6 +634,16 @@ nvmf_transport_poll_group_create(struct spdk_nvmf_transport *transport,
 		}
 	}
 
+	if (buf_cache_size > 0) {
+		tgroup->buf_arena = calloc(buf_cache_size, sizeof(void *));
+		if (tgroup->buf_arena == NULL) {
+			SPDK_WARNLOG("Unable to allocate the poll group buffer arena. "
+				     "Falling back to the iobuf channel.\n");
+		} else {
+			tgroup->buf_arena_size = buf_cache_size;
+		}
+	}
+
 	return tgroup;
 err:
 	transport->ops->poll_group_destroy(tgroup);
@@ -674,6 +684,14 @@ nvmf_transport_poll_group_destroy(struct spdk_nvmf_transport_poll_group *group)
 		 * releases any remaining buffers. Cache channel pointer so we can still
 		 * release the resources after the group has been freed. */
 		ch = group->buf_cache;
+
+		/* Return the arena's buffers to the iobuf channel before the group
+		 * memory is freed. */
+		while (group->buf_arena_count > 0) {
+			spdk_iobuf_put(ch, group->buf_arena[--group->buf_arena_count],
+				       transport->opts.io_unit_size);
+		}
+		free(group->buf_arena);
 	}
 
 	pthread_mutex_lock(&transport->mutex);
@@ -722,6 +740,26 @@ nvmf_transport_poll_group_remove(struct spdk_nvmf_transport_poll_group *group,
 	return rc;
 }
 
+int
+nvmf_transport_qpair_migrate_detach(struct spdk_nvmf_transport_poll_group *group,
+				    struct spdk_nvmf_qpair *qpair)
+{
+	assert(qpair->transport == group->transport);
+	assert(group->transport->ops->qpair_migrate_detach != NULL);
+
+	return group->transport->ops->qpair_migrate_detach(group, qpair);
+}
+
+int
+nvmf_transport_qpair_migrate_attach(struct spdk_nvmf_transport_poll_group *group,
+				    struct spdk_nvmf_qpair *qpair)
+{
+	assert(qpair->transport == group->transport);
+	assert(group->transport->ops->qpair_migrate_attach != NULL);
+
+	return group->transport->ops->qpair_migrate_attach(group, qpair);
+}
+
 int
 nvmf_transport_poll_group_poll(struct spdk_nvmf_transport_poll_group *group)
 {
@@ -812,6 +850,32 @@ spdk_nvmf_transport_opts_init(const char *transport_name,
 	return true;
 }
 
+/* Only full io_unit_size buffers go through the arena.  They were obtained from
+ * the iobuf channel at exactly that size, so buffers of any other size must
+ * keep using the iobuf get/put pair to preserve the channel's accounting.
+ */
+static void *
+nvmf_transport_pg_buf_get(struct spdk_nvmf_transport_poll_group *group, uint64_t length)
+{
+	if (group->buf_arena_count > 0 && length == group->transport->opts.io_unit_size) {
+		return group->buf_arena[--group->buf_arena_count];
+	}
+
+	return spdk_iobuf_get(group->buf_cache, length, NULL, NULL);
+}
+
+static void
+nvmf_transport_pg_buf_put(struct spdk_nvmf_transport_poll_group *group, void *buf, uint64_t length)
+{
+	if (group->buf_arena_count < group->buf_arena_size &&
+	    length == group->transport->opts.io_unit_size) {
+		group->buf_arena[group->buf_arena_count++] = buf;
+		return;
+	}
+
+	spdk_iobuf_put(group->buf_cache, buf, length);
+}
+
 void
 spdk_nvmf_request_free_buffers(struct spdk_nvmf_request *req,
 			       struct spdk_nvmf_transport_poll_group *group,
@@ -820,7 +884,7 @@ spdk_nvmf_request_free_buffers(struct spdk_nvmf_request *req,
 	uint32_t i;
 
 	for (i = 0; i < req->iovcnt; i++) {
-		spdk_iobuf_put(group->buf_cache, req->iov[i].iov_base, req->iov[i].iov_len);
+		nvmf_transport_pg_buf_put(group, req->iov[i].iov_base, req->iov[i].iov_len);
 		req->iov[i].iov_base = NULL;
 		req->iov[i].iov_len = 0;
 	}
@@ -862,7 +926,7 @@ nvmf_request_get_buffers(struct spdk_nvmf_request *req,
 	}
 
 	while (i < num_buffers) {
-		buffer = spdk_iobuf_get(group->buf_cache, spdk_min(io_unit_size, length), NULL, NULL);
+		buffer = nvmf_transport_pg_buf_get(group, spdk_min(io_unit_size, length));
 		if (spdk_unlikely(buffer == NULL)) {
 			return -ENOMEM;
 		}
@@ -921,7 +985,7 @@ nvmf_request_free_stripped_buffers(struct spdk_nvmf_request *req,
 	uint32_t i;
 
 	for (i = 0; i < data->iovcnt; i++) {
-		spdk_iobuf_put(group->buf_cache, data->iov[i].iov_base, data->iov[i].iov_len);
+		nvmf_transport_pg_buf_put(group, data->iov[i].iov_base, data->iov[i].iov_len);
 	}
 	free(data);
 	req->stripped_data = NULL;
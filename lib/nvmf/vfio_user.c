@@ -309,6 +309,9 @@ struct nvmf_vfio_user_sq {
 	uint32_t				head;
 	volatile uint32_t			*dbl_tailp;
 
+	/* Tail doorbell value captured by the poll group's sweep phase. */
+	uint32_t				swept_tail;
+
 	/* Whether a shadow doorbell eventidx needs setting. */
 	bool					need_rearm;
 
@@ -1436,6 +1439,7 @@ asq_setup(struct nvmf_vfio_user_ctrlr *ctrlr)
 	sq->dbl_tailp = ctrlr->bar0_doorbells + queue_index(0, false);
 
 	*sq_dbl_tailp(sq) = 0;
+	sq->swept_tail = 0;
 
 	return 0;
 }
@@ -2097,6 +2101,7 @@ handle_create_io_sq(struct nvmf_vfio_user_ctrlr *ctrlr,
 	 * doorbell values.
 	 */
 	*sq_dbl_tailp(sq) = 0;
+	sq->swept_tail = 0;
 
 	if (ctrlr->sdbl != NULL) {
 		sq->need_rearm = true;
@@ -5661,30 +5666,15 @@ handle_suppressed_irq(struct nvmf_vfio_user_ctrlr *ctrlr,
 	cq->last_head = cq_head;
 }
 
-/* Returns the number of commands processed, or a negative value on error. */
-static int
-nvmf_vfio_user_sq_poll(struct nvmf_vfio_user_sq *sq)
+/*
+ * Fetch the current SQ tail doorbell value.  Split out from
+ * nvmf_vfio_user_sq_poll() so that the poll group can sweep every tail
+ * location in one pass before processing any commands, overlapping the
+ * doorbell reads instead of fetching and draining one queue at a time.
+ */
+static inline uint32_t
+nvmf_vfio_user_sq_fetch_tail(struct nvmf_vfio_user_sq *sq)
 {
-	struct nvmf_vfio_user_ctrlr *ctrlr;
-	uint32_t new_tail;
-	int count = 0;
-
-	assert(sq != NULL);
-
-	ctrlr = sq->ctrlr;
-
-	/*
-	 * A quiesced, or migrating, controller should never process new
-	 * commands.
-	 */
-	if (ctrlr->state != VFIO_USER_CTRLR_RUNNING) {
-		return SPDK_POLLER_IDLE;
-	}
-
-	if (ctrlr->adaptive_irqs_enabled) {
-		handle_suppressed_irq(ctrlr, sq);
-	}
-
 	/* On aarch64 platforms, doorbells update from guest VM may not be seen
 	 * on SPDK target side. This is because there is memory type mismatch
 	 * situation here. That is on guest VM side, the doorbells are treated as
@@ -5698,9 +5688,20 @@ nvmf_vfio_user_sq_poll(struct nvmf_vfio_user_sq *sq)
 	spdk_ivdt_dcache(sq_dbl_tailp(sq));
 
 	/* Load-Acquire. */
-	new_tail = *sq_dbl_tailp(sq);
+	return *sq_dbl_tailp(sq) & 0xffffu;
+}
+
+/* Returns the number of commands processed, or a negative value on error. */
+static int
+nvmf_vfio_user_sq_process_tail(struct nvmf_vfio_user_sq *sq, uint32_t new_tail)
+{
+	struct nvmf_vfio_user_ctrlr *ctrlr;
+	int count = 0;
+
+	assert(sq != NULL);
+
+	ctrlr = sq->ctrlr;
 
-	new_tail = new_tail & 0xffffu;
 	if (spdk_unlikely(new_tail >= sq->size)) {
 		SPDK_DEBUGLOG(nvmf_vfio, "%s: invalid sqid:%u doorbell value %u\n", ctrlr_id(ctrlr), sq->qid,
 			      new_tail);
@@ -5739,6 +5740,31 @@ nvmf_vfio_user_sq_poll(struct nvmf_vfio_user_sq *sq)
 	return count;
 }
 
+/* Returns the number of commands processed, or a negative value on error. */
+static int
+nvmf_vfio_user_sq_poll(struct nvmf_vfio_user_sq *sq)
+{
+	struct nvmf_vfio_user_ctrlr *ctrlr;
+
+	assert(sq != NULL);
+
+	ctrlr = sq->ctrlr;
+
+	/*
+	 * A quiesced, or migrating, controller should never process new
+	 * commands.
+	 */
+	if (ctrlr->state != VFIO_USER_CTRLR_RUNNING) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	if (ctrlr->adaptive_irqs_enabled) {
+		handle_suppressed_irq(ctrlr, sq);
+	}
+
+	return nvmf_vfio_user_sq_process_tail(sq, nvmf_vfio_user_sq_fetch_tail(sq));
+}
+
 /*
  * vfio-user transport poll handler. Note that the library context is polled in
  * a separate poller (->vfu_ctx_poller), so this poller only needs to poll the
@@ -5759,14 +5785,49 @@ nvmf_vfio_user_poll_group_poll(struct spdk_nvmf_transport_poll_group *group)
 
 	SPDK_DEBUGLOG(vfio_user_db, "polling all SQs\n");
 
+	/* Sweep phase: read every SQ tail doorbell before processing any
+	 * commands.  The tail locations of a controller's queues live in the
+	 * same doorbell (or shadow doorbell) page, so issuing the reads
+	 * back-to-back lets them overlap instead of stalling once per queue.
+	 */
+	TAILQ_FOREACH(sq, &vu_group->sqs, link) {
+		struct nvmf_vfio_user_ctrlr *ctrlr;
+
+		if (spdk_unlikely(sq->sq_state != VFIO_USER_SQ_ACTIVE || !sq->size)) {
+			continue;
+		}
+
+		ctrlr = sq->ctrlr;
+
+		/*
+		 * A quiesced, or migrating, controller should never process new
+		 * commands.
+		 */
+		if (spdk_unlikely(ctrlr->state != VFIO_USER_CTRLR_RUNNING)) {
+			continue;
+		}
+
+		if (ctrlr->adaptive_irqs_enabled) {
+			handle_suppressed_irq(ctrlr, sq);
+		}
+
+		sq->swept_tail = nvmf_vfio_user_sq_fetch_tail(sq);
+	}
+
+	/* Process phase: drain the queues whose tail moved. */
 	TAILQ_FOREACH_SAFE(sq, &vu_group->sqs, link, tmp) {
 		int ret;
 
-		if (spdk_unlikely(sq->sq_state != VFIO_USER_SQ_ACTIVE || !sq->size)) {
+		if (spdk_unlikely(sq->sq_state != VFIO_USER_SQ_ACTIVE || !sq->size ||
+				  sq->ctrlr->state != VFIO_USER_CTRLR_RUNNING)) {
 			continue;
 		}
 
-		ret = nvmf_vfio_user_sq_poll(sq);
+		if (sq->swept_tail == *sq_headp(sq)) {
+			continue;
+		}
+
+		ret = nvmf_vfio_user_sq_process_tail(sq, sq->swept_tail);
 
 		if (spdk_unlikely(ret < 0)) {
 			return ret;
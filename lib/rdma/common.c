@@ -9,6 +9,7 @@
 #include "spdk/env.h"
 #include "spdk/string.h"
 #include "spdk/likely.h"
+#include "spdk/util.h"
 
 #include "spdk_internal/rdma.h"
 #include "spdk_internal/assert.h"
@@ -21,15 +22,37 @@ struct spdk_rdma_device {
 	TAILQ_ENTRY(spdk_rdma_device)		tailq;
 };
 
+/* Registration cached for memory that is not part of the SPDK memory map,
+ * e.g. application-owned buffers. Entries are deregistered lazily - they stay
+ * pinned until evicted in LRU order to satisfy the pin budget or until the
+ * memory map is freed.
+ */
+struct rdma_mr_cache_entry {
+	uint64_t			addr;
+	uint64_t			length;
+	struct ibv_mr			*mr;
+	TAILQ_ENTRY(rdma_mr_cache_entry) link;
+};
+
 struct spdk_rdma_mem_map {
 	struct spdk_mem_map		*map;
 	struct ibv_pd			*pd;
 	struct spdk_nvme_rdma_hooks	*hooks;
 	uint32_t ref_count;
 	enum spdk_rdma_memory_map_role role;
+	/* MRs for memory outside of the SPDK memory map, most recently used first */
+	TAILQ_HEAD(rdma_mr_cache_entries, rdma_mr_cache_entry) mr_cache;
+	uint64_t			mr_cache_bytes;
+	pthread_mutex_t			mr_cache_mutex;
 	LIST_ENTRY(spdk_rdma_mem_map) link;
 };
 
+/* Cached registrations cover whole pages so that nearby buffers share an MR */
+#define RDMA_MR_CACHE_PAGE_SIZE 4096
+
+/* Maximum number of bytes pinned by cached registrations per memory map */
+static uint64_t g_rdma_mr_cache_size = SPDK_RDMA_DEF_MR_CACHE_SIZE;
+
 static pthread_mutex_t g_dev_mutex = PTHREAD_MUTEX_INITIALIZER;
 static struct ibv_context **g_ctx_list = NULL;
 static TAILQ_HEAD(, spdk_rdma_device) g_dev_list = TAILQ_HEAD_INITIALIZER(g_dev_list);
@@ -37,6 +60,32 @@ static TAILQ_HEAD(, spdk_rdma_device) g_dev_list = TAILQ_HEAD_INITIALIZER(g_dev_
 static LIST_HEAD(, spdk_rdma_mem_map) g_rdma_mr_maps = LIST_HEAD_INITIALIZER(&g_rdma_mr_maps);
 static pthread_mutex_t g_rdma_mr_maps_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+static uint32_t
+rdma_mem_map_access_flags(struct spdk_rdma_mem_map *rmap)
+{
+	uint32_t access_flags = 0;
+
+	switch (rmap->role) {
+	case SPDK_RDMA_MEMORY_MAP_ROLE_TARGET:
+		access_flags = IBV_ACCESS_LOCAL_WRITE;
+		if (rmap->pd->context->device->transport_type == IBV_TRANSPORT_IWARP) {
+			/* IWARP requires REMOTE_WRITE permission for RDMA_READ operation */
+			access_flags |= IBV_ACCESS_REMOTE_WRITE;
+		}
+		break;
+	case SPDK_RDMA_MEMORY_MAP_ROLE_INITIATOR:
+		access_flags = IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_READ | IBV_ACCESS_REMOTE_WRITE;
+		break;
+	default:
+		SPDK_UNREACHABLE();
+	}
+#ifdef IBV_ACCESS_OPTIONAL_FIRST
+	access_flags |= IBV_ACCESS_RELAXED_ORDERING;
+#endif
+
+	return access_flags;
+}
+
 static int
 rdma_mem_notify(void *cb_ctx, struct spdk_mem_map *map,
 		enum spdk_mem_map_notify_action action,
@@ -45,7 +94,6 @@ rdma_mem_notify(void *cb_ctx, struct spdk_mem_map *map,
 	struct spdk_rdma_mem_map *rmap = cb_ctx;
 	struct ibv_pd *pd = rmap->pd;
 	struct ibv_mr *mr;
-	uint32_t access_flags = 0;
 	int rc;
 
 	switch (action) {
@@ -54,24 +102,7 @@ rdma_mem_notify(void *cb_ctx, struct spdk_mem_map *map,
 			rc = spdk_mem_map_set_translation(map, (uint64_t)vaddr, size, rmap->hooks->get_rkey(pd, vaddr,
 							  size));
 		} else {
-			switch (rmap->role) {
-			case SPDK_RDMA_MEMORY_MAP_ROLE_TARGET:
-				access_flags = IBV_ACCESS_LOCAL_WRITE;
-				if (pd->context->device->transport_type == IBV_TRANSPORT_IWARP) {
-					/* IWARP requires REMOTE_WRITE permission for RDMA_READ operation */
-					access_flags |= IBV_ACCESS_REMOTE_WRITE;
-				}
-				break;
-			case SPDK_RDMA_MEMORY_MAP_ROLE_INITIATOR:
-				access_flags = IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_REMOTE_READ | IBV_ACCESS_REMOTE_WRITE;
-				break;
-			default:
-				SPDK_UNREACHABLE();
-			}
-#ifdef IBV_ACCESS_OPTIONAL_FIRST
-			access_flags |= IBV_ACCESS_RELAXED_ORDERING;
-#endif
-			mr = ibv_reg_mr(pd, vaddr, size, access_flags);
+			mr = ibv_reg_mr(pd, vaddr, size, rdma_mem_map_access_flags(rmap));
 			if (mr == NULL) {
 				SPDK_ERRLOG("ibv_reg_mr() failed\n");
 				return -1;
@@ -108,6 +139,93 @@ const struct spdk_mem_map_ops g_rdma_map_ops = {
 	.are_contiguous = rdma_check_contiguous_entries
 };
 
+static void
+rdma_mr_cache_evict(struct spdk_rdma_mem_map *map, struct rdma_mr_cache_entry *entry)
+{
+	TAILQ_REMOVE(&map->mr_cache, entry, link);
+	assert(map->mr_cache_bytes >= entry->length);
+	map->mr_cache_bytes -= entry->length;
+	ibv_dereg_mr(entry->mr);
+	free(entry);
+}
+
+/* Find or create a cached registration covering [addr, addr + length).
+ * Must be called with mr_cache_mutex held.
+ */
+static struct ibv_mr *
+rdma_mr_cache_get(struct spdk_rdma_mem_map *map, uint64_t addr, uint64_t length)
+{
+	struct rdma_mr_cache_entry *entry, *tmp;
+	uint64_t start, end;
+
+	TAILQ_FOREACH(entry, &map->mr_cache, link) {
+		if (addr >= entry->addr && addr + length <= entry->addr + entry->length) {
+			/* Keep the cache in LRU order for eviction */
+			if (entry != TAILQ_FIRST(&map->mr_cache)) {
+				TAILQ_REMOVE(&map->mr_cache, entry, link);
+				TAILQ_INSERT_HEAD(&map->mr_cache, entry, link);
+			}
+			return entry->mr;
+		}
+	}
+
+	if (g_rdma_mr_cache_size == 0) {
+		return NULL;
+	}
+
+	entry = calloc(1, sizeof(*entry));
+	if (!entry) {
+		SPDK_ERRLOG("Failed to allocate MR cache entry\n");
+		return NULL;
+	}
+
+	start = SPDK_ALIGN_FLOOR(addr, RDMA_MR_CACHE_PAGE_SIZE);
+	end = SPDK_ALIGN_CEIL(addr + length, RDMA_MR_CACHE_PAGE_SIZE);
+
+	entry->mr = ibv_reg_mr(map->pd, (void *)start, end - start, rdma_mem_map_access_flags(map));
+	if (entry->mr == NULL) {
+		SPDK_ERRLOG("ibv_reg_mr() failed for ptr %p, size %" PRIu64 "\n",
+			    (void *)start, end - start);
+		free(entry);
+		return NULL;
+	}
+
+	entry->addr = start;
+	entry->length = end - start;
+	TAILQ_INSERT_HEAD(&map->mr_cache, entry, link);
+	map->mr_cache_bytes += entry->length;
+
+	/* Deregistration is lazy - trim least recently used entries only when
+	 * the pin budget is exceeded. The budget must be large enough that
+	 * registrations for in-flight IO are never the eviction victims.
+	 */
+	while (map->mr_cache_bytes > g_rdma_mr_cache_size) {
+		tmp = TAILQ_LAST(&map->mr_cache, rdma_mr_cache_entries);
+		if (tmp == entry) {
+			break;
+		}
+		rdma_mr_cache_evict(map, tmp);
+	}
+
+	return entry->mr;
+}
+
+static void
+rdma_mr_cache_free(struct spdk_rdma_mem_map *map)
+{
+	struct rdma_mr_cache_entry *entry, *tmp;
+
+	TAILQ_FOREACH_SAFE(entry, &map->mr_cache, link, tmp) {
+		rdma_mr_cache_evict(map, entry);
+	}
+}
+
+void
+spdk_rdma_set_mr_cache_size(uint64_t size_bytes)
+{
+	g_rdma_mr_cache_size = size_bytes;
+}
+
 static void
 _rdma_free_mem_map(struct spdk_rdma_mem_map *map)
 {
@@ -150,6 +268,8 @@ spdk_rdma_create_mem_map(struct ibv_pd *pd, struct spdk_nvme_rdma_hooks *hooks,
 	map->ref_count = 1;
 	map->hooks = hooks;
 	map->role = role;
+	TAILQ_INIT(&map->mr_cache);
+	pthread_mutex_init(&map->mr_cache_mutex, NULL);
 	map->map = spdk_mem_map_alloc(0, &g_rdma_map_ops, map);
 	if (!map->map) {
 		SPDK_ERRLOG("Unable to create memory map\n");
@@ -189,6 +309,8 @@ spdk_rdma_free_mem_map(struct spdk_rdma_mem_map **_map)
 
 	LIST_REMOVE(map, link);
 	pthread_mutex_unlock(&g_rdma_mr_maps_mutex);
+	rdma_mr_cache_free(map);
+	pthread_mutex_destroy(&map->mr_cache_mutex);
 	if (map->map) {
 		spdk_mem_map_free(&map->map);
 	}
@@ -213,8 +335,17 @@ spdk_rdma_get_translation(struct spdk_rdma_mem_map *map, void *address,
 		translation->mr_or_key.mr = (struct ibv_mr *)spdk_mem_map_translate(map->map, (uint64_t)address,
 					    &real_length);
 		if (spdk_unlikely(!translation->mr_or_key.mr)) {
-			SPDK_ERRLOG("No translation for ptr %p, size %zu\n", address, length);
-			return -EINVAL;
+			/* The buffer is not part of the SPDK memory map, e.g. it is owned
+			 * by the application. Register it on demand and cache the MR.
+			 */
+			pthread_mutex_lock(&map->mr_cache_mutex);
+			translation->mr_or_key.mr = rdma_mr_cache_get(map, (uint64_t)address, length);
+			pthread_mutex_unlock(&map->mr_cache_mutex);
+			if (!translation->mr_or_key.mr) {
+				SPDK_ERRLOG("No translation for ptr %p, size %zu\n", address, length);
+				return -EINVAL;
+			}
+			return 0;
 		}
 	}
 
@@ -223,6 +354,37 @@ spdk_rdma_get_translation(struct spdk_rdma_mem_map *map, void *address,
 	return 0;
 }
 
+int
+spdk_rdma_mem_map_register_iovs(struct spdk_rdma_mem_map *map, struct iovec *iovs, int iovcnt)
+{
+	uint64_t real_length;
+	int i, rc = 0;
+
+	assert(map);
+	assert(iovs);
+
+	if (map->hooks && map->hooks->get_rkey) {
+		/* Translations are provided by the hooks, nothing to register */
+		return 0;
+	}
+
+	pthread_mutex_lock(&map->mr_cache_mutex);
+	for (i = 0; i < iovcnt; i++) {
+		real_length = iovs[i].iov_len;
+		if (spdk_mem_map_translate(map->map, (uint64_t)iovs[i].iov_base, &real_length) != 0) {
+			/* Already covered by the SPDK memory map */
+			continue;
+		}
+		if (!rdma_mr_cache_get(map, (uint64_t)iovs[i].iov_base, iovs[i].iov_len)) {
+			rc = -EINVAL;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&map->mr_cache_mutex);
+
+	return rc;
+}
+
 struct spdk_rdma_srq *
 spdk_rdma_srq_create(struct spdk_rdma_srq_init_attr *init_attr)
 {
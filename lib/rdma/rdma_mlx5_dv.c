@@ -19,6 +19,125 @@ struct spdk_rdma_mlx5_dv_qp {
 	struct ibv_qp_ex *qpex;
 };
 
+struct spdk_rdma_cq {
+	struct ibv_cq_ex *cqex;
+};
+
+struct spdk_rdma_cq *
+spdk_rdma_cq_create(struct spdk_rdma_cq_init_attr *cq_attr)
+{
+	struct spdk_rdma_cq *rdma_cq;
+	struct ibv_cq_init_attr_ex cq_attr_ex = {
+		.cqe = cq_attr->cqe,
+		.cq_context = cq_attr->cq_context,
+		.channel = cq_attr->comp_channel,
+		.comp_vector = cq_attr->comp_vector,
+		.wc_flags = IBV_WC_EX_WITH_BYTE_LEN | IBV_WC_EX_WITH_IMM | IBV_WC_EX_WITH_QP_NUM
+	};
+	struct mlx5dv_cq_init_attr mlx5_cq_attr = {};
+
+	assert(cq_attr != NULL);
+
+	rdma_cq = calloc(1, sizeof(*rdma_cq));
+	if (!rdma_cq) {
+		SPDK_ERRLOG("cq memory allocation failed\n");
+		return NULL;
+	}
+
+	rdma_cq->cqex = mlx5dv_create_cq(cq_attr->context, &cq_attr_ex, &mlx5_cq_attr);
+	if (!rdma_cq->cqex) {
+		SPDK_ERRLOG("Failed to create cq, errno %s (%d)\n", spdk_strerror(errno), errno);
+		free(rdma_cq);
+		return NULL;
+	}
+
+	return rdma_cq;
+}
+
+void
+spdk_rdma_cq_destroy(struct spdk_rdma_cq *rdma_cq)
+{
+	int rc;
+
+	assert(rdma_cq != NULL);
+
+	rc = ibv_destroy_cq(ibv_cq_ex_to_cq(rdma_cq->cqex));
+	if (rc) {
+		SPDK_ERRLOG("Failed to destroy ibv cq %p, rc %d\n", rdma_cq->cqex, rc);
+	}
+
+	free(rdma_cq);
+}
+
+int
+spdk_rdma_cq_resize(struct spdk_rdma_cq *rdma_cq, int cqe)
+{
+	assert(rdma_cq != NULL);
+
+	return ibv_resize_cq(ibv_cq_ex_to_cq(rdma_cq->cqex), cqe);
+}
+
+int
+spdk_rdma_cq_poll(struct spdk_rdma_cq *rdma_cq, int num_entries, struct ibv_wc *wc)
+{
+	struct ibv_poll_cq_attr poll_attr = {};
+	struct ibv_cq_ex *cqex;
+	int reaped = 0;
+	int rc;
+
+	assert(rdma_cq != NULL);
+
+	cqex = rdma_cq->cqex;
+
+	/* The extended poll API iterates over the CQE buffer in place checking the
+	 * ownership bit, the CQEs are not copied to a staging array inside the driver.
+	 * Completion fields are read lazily, only the ones our consumers use. */
+	rc = ibv_start_poll(cqex, &poll_attr);
+	if (rc != 0) {
+		return rc == ENOENT ? 0 : -rc;
+	}
+
+	do {
+		wc[reaped].wr_id = cqex->wr_id;
+		wc[reaped].status = cqex->status;
+		wc[reaped].qp_num = ibv_wc_read_qp_num(cqex);
+		if (spdk_likely(cqex->status == IBV_WC_SUCCESS)) {
+			wc[reaped].opcode = ibv_wc_read_opcode(cqex);
+			wc[reaped].byte_len = ibv_wc_read_byte_len(cqex);
+			wc[reaped].wc_flags = ibv_wc_read_wc_flags(cqex);
+			if (wc[reaped].wc_flags & IBV_WC_WITH_IMM) {
+				wc[reaped].imm_data = ibv_wc_read_imm_data(cqex);
+			}
+		} else {
+			/* Most fields are undefined for error completions, consumers
+			 * identify the failed Work Request by wr_id */
+			wc[reaped].vendor_err = ibv_wc_read_vendor_err(cqex);
+		}
+
+		if (++reaped == num_entries) {
+			break;
+		}
+
+		rc = ibv_next_poll(cqex);
+	} while (rc == 0);
+
+	ibv_end_poll(cqex);
+
+	if (spdk_unlikely(rc != 0 && rc != ENOENT)) {
+		return -rc;
+	}
+
+	return reaped;
+}
+
+struct ibv_cq *
+spdk_rdma_cq_get_ibv_cq(struct spdk_rdma_cq *rdma_cq)
+{
+	assert(rdma_cq != NULL);
+
+	return ibv_cq_ex_to_cq(rdma_cq->cqex);
+}
+
 static int
 rdma_mlx5_dv_init_qpair(struct spdk_rdma_mlx5_dv_qp *mlx5_qp)
 {
@@ -12,6 +12,80 @@
 #include "spdk_internal/rdma.h"
 #include "spdk/log.h"
 
+struct spdk_rdma_cq {
+	struct ibv_cq *cq;
+};
+
+struct spdk_rdma_cq *
+spdk_rdma_cq_create(struct spdk_rdma_cq_init_attr *cq_attr)
+{
+	struct spdk_rdma_cq *rdma_cq;
+
+	assert(cq_attr != NULL);
+
+	rdma_cq = calloc(1, sizeof(*rdma_cq));
+	if (!rdma_cq) {
+		SPDK_ERRLOG("cq memory allocation failed\n");
+		return NULL;
+	}
+
+	rdma_cq->cq = ibv_create_cq(cq_attr->context, cq_attr->cqe, cq_attr->cq_context,
+				    cq_attr->comp_channel, cq_attr->comp_vector);
+	if (!rdma_cq->cq) {
+		SPDK_ERRLOG("Failed to create cq, errno %s (%d)\n", spdk_strerror(errno), errno);
+		free(rdma_cq);
+		return NULL;
+	}
+
+	return rdma_cq;
+}
+
+void
+spdk_rdma_cq_destroy(struct spdk_rdma_cq *rdma_cq)
+{
+	int rc;
+
+	assert(rdma_cq != NULL);
+
+	rc = ibv_destroy_cq(rdma_cq->cq);
+	if (rc) {
+		SPDK_ERRLOG("Failed to destroy ibv cq %p, rc %d\n", rdma_cq->cq, rc);
+	}
+
+	free(rdma_cq);
+}
+
+int
+spdk_rdma_cq_resize(struct spdk_rdma_cq *rdma_cq, int cqe)
+{
+	assert(rdma_cq != NULL);
+
+	return ibv_resize_cq(rdma_cq->cq, cqe);
+}
+
+int
+spdk_rdma_cq_poll(struct spdk_rdma_cq *rdma_cq, int num_entries, struct ibv_wc *wc)
+{
+	int rc;
+
+	assert(rdma_cq != NULL);
+
+	rc = ibv_poll_cq(rdma_cq->cq, num_entries, wc);
+	if (spdk_unlikely(rc < 0)) {
+		return -errno;
+	}
+
+	return rc;
+}
+
+struct ibv_cq *
+spdk_rdma_cq_get_ibv_cq(struct spdk_rdma_cq *rdma_cq)
+{
+	assert(rdma_cq != NULL);
+
+	return rdma_cq->cq;
+}
+
 struct spdk_rdma_qp *
 spdk_rdma_qp_create(struct rdma_cm_id *cm_id, struct spdk_rdma_qp_init_attr *qp_attr)
 {
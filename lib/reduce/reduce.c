@@ -24,8 +24,34 @@
 
 #define REDUCE_EMPTY_MAP_ENTRY	-1ULL
 
+/* Logical map entry for a chunk whose data is all zeroes.  Such chunks have no
+ *  chunk map and no backing io units - they read back as zeroes the same way
+ *  unallocated chunks do.
+ */
+#define REDUCE_ZERO_MAP_ENTRY	-2ULL
+
 #define REDUCE_NUM_VOL_REQUESTS	256
 
+/*
+ * Maximum number of completed writes whose metadata persists may be staged
+ *  before a flush of the persist batch is forced.  Each staged write pins its
+ *  old chunk map (if any) until the flush, so this must stay well below
+ *  REDUCE_NUM_EXTRA_CHUNKS.
+ */
+#define REDUCE_PM_PERSIST_BATCH_MAX	32
+
+/*
+ * Chunks whose compressed size is at most this fraction of the backing io unit
+ *  size are packed together with other small chunks into a shared backing io
+ *  unit, rather than each consuming a full io unit.
+ */
+#define REDUCE_PACK_MAX_SIZE_DIVISOR	2
+
+/* Offsets of packed chunks within their shared backing io unit are aligned to
+ *  this boundary.
+ */
+#define REDUCE_PACK_ALIGNMENT		64
+
 /* Structure written to offset 0 of both the pm file and the backing device. */
 struct spdk_reduce_vol_superblock {
 	uint8_t				signature[8];
@@ -59,7 +85,13 @@ struct spdk_reduce_pm_file {
 
 struct spdk_reduce_chunk_map {
 	uint32_t		compressed_size;
-	uint32_t		reserved;
+	/* Byte offset of the compressed chunk within io_unit_index[0], for small
+	 *  chunks packed into a shared backing io unit.  0 for chunks occupying
+	 *  their io units exclusively.  Volumes created before packing support
+	 *  left this field as 0xFF fill - it is zeroed when such a volume is
+	 *  loaded.
+	 */
+	uint32_t		packed_offset;
 	uint64_t		io_unit_index[0];
 };
 
@@ -109,7 +141,27 @@ struct spdk_reduce_vol_request {
 	spdk_reduce_vol_op_complete		cb_fn;
 	void					*cb_arg;
 	TAILQ_ENTRY(spdk_reduce_vol_request)	tailq;
+	/* Used to stage this request on an open pack and later on the pending
+	 *  persists list - requests on those lists are still on the executing
+	 *  list via the tailq field.  A request is never on both at once.
+	 */
+	TAILQ_ENTRY(spdk_reduce_vol_request)	pending_tailq;
+	struct spdk_reduce_vol_cb_args		backing_cb_args;
+};
+
+/*
+ * Staging area for small compressed chunks packed into a shared backing io
+ *  unit.  The pack is filled by writes reaching the write chunk stage and is
+ *  written out as a single backing io once it is closed.
+ */
+struct reduce_pack {
+	struct spdk_reduce_vol			*vol;
+	uint64_t				io_unit_index;
+	uint32_t				fill;
+	TAILQ_HEAD(, spdk_reduce_vol_request)	reqs;
+	struct iovec				iov;
 	struct spdk_reduce_vol_cb_args		backing_cb_args;
+	uint8_t					buf[];
 };
 
 struct spdk_reduce_vol {
@@ -132,6 +184,27 @@ struct spdk_reduce_vol {
 	TAILQ_HEAD(, spdk_reduce_vol_request)	executing_requests;
 	TAILQ_HEAD(, spdk_reduce_vol_request)	queued_requests;
 
+	/* Completed writes whose chunk map and logical map updates have been
+	 *  staged but not yet persisted.  The batch is flushed when the last
+	 *  in-flight write completes, so the persist barriers amortize across
+	 *  all of the writes completing in that window.
+	 */
+	TAILQ_HEAD(, spdk_reduce_vol_request)	pending_persists;
+	uint32_t				num_pending_persists;
+	uint32_t				num_inflight_writes;
+
+	/* Pack of small compressed chunks currently being filled.  It is written
+	 *  to its backing io unit once no write still in the compression stage
+	 *  could join it, or when the next small chunk does not fit.
+	 */
+	struct reduce_pack			*open_pack;
+	/* Writes that have started but not yet reached _reduce_vol_write_chunk. */
+	uint32_t				num_compressing_writes;
+	/* Number of chunks referencing each backing io unit.  Packed chunks share
+	 *  their io unit, which may only be freed once no chunk references it.
+	 */
+	uint16_t				*io_unit_refs;
+
 	/* Single contiguous buffer used for all request buffers for this volume. */
 	uint8_t					*buf_mem;
 	struct iovec				*buf_iov_mem;
@@ -160,6 +233,31 @@ _reduce_persist(struct spdk_reduce_vol *vol, const void *addr, size_t len)
 	}
 }
 
+/*
+ * Flush a range to persistence without waiting for it to become durable.  A
+ *  batch of flushes must be followed by _reduce_persist_drain() before anything
+ *  ordered after the flushed stores may be written.  This lets the drain
+ *  barrier amortize across all of the ranges flushed in the batch, instead of
+ *  paying a full persist barrier per range.
+ */
+static void
+_reduce_persist_flush(struct spdk_reduce_vol *vol, const void *addr, size_t len)
+{
+	if (vol->pm_file.pm_is_pmem) {
+		pmem_flush(addr, len);
+	} else {
+		pmem_msync(addr, len);
+	}
+}
+
+static void
+_reduce_persist_drain(struct spdk_reduce_vol *vol)
+{
+	if (vol->pm_file.pm_is_pmem) {
+		pmem_drain();
+	}
+}
+
 static uint64_t
 _get_pm_logical_map_size(uint64_t vol_size, uint64_t chunk_size)
 {
@@ -443,6 +541,7 @@ _init_load_cleanup(struct spdk_reduce_vol *vol, struct reduce_init_load_ctx *ctx
 		spdk_free(vol->backing_super);
 		spdk_bit_array_free(&vol->allocated_chunk_maps);
 		spdk_bit_array_free(&vol->allocated_backing_io_units);
+		free(vol->io_unit_refs);
 		free(vol->request_mem);
 		free(vol->buf_iov_mem);
 		spdk_free(vol->buf_mem);
@@ -522,8 +621,10 @@ _allocate_bit_arrays(struct spdk_reduce_vol *vol)
 	vol->allocated_chunk_maps = spdk_bit_array_create(total_chunks);
 	total_backing_io_units = total_chunks * (vol->params.chunk_size / vol->params.backing_io_unit_size);
 	vol->allocated_backing_io_units = spdk_bit_array_create(total_backing_io_units);
+	vol->io_unit_refs = calloc(total_backing_io_units, sizeof(*vol->io_unit_refs));
 
-	if (vol->allocated_chunk_maps == NULL || vol->allocated_backing_io_units == NULL) {
+	if (vol->allocated_chunk_maps == NULL || vol->allocated_backing_io_units == NULL ||
+	    vol->io_unit_refs == NULL) {
 		return -ENOMEM;
 	}
 
@@ -597,6 +698,7 @@ spdk_reduce_vol_init(struct spdk_reduce_vol_params *params,
 	TAILQ_INIT(&vol->free_requests);
 	TAILQ_INIT(&vol->executing_requests);
 	TAILQ_INIT(&vol->queued_requests);
+	TAILQ_INIT(&vol->pending_persists);
 
 	vol->backing_super = spdk_zmalloc(sizeof(*vol->backing_super), 0, NULL,
 					  SPDK_ENV_LCORE_ID_ANY, SPDK_MALLOC_DMA);
@@ -779,14 +881,24 @@ _load_read_super_and_path_cpl(void *cb_arg, int reduce_errno)
 	num_chunks = vol->params.vol_size / vol->params.chunk_size;
 	for (i = 0; i < num_chunks; i++) {
 		logical_map_index = vol->pm_logical_map[i];
-		if (logical_map_index == REDUCE_EMPTY_MAP_ENTRY) {
+		if (logical_map_index == REDUCE_EMPTY_MAP_ENTRY ||
+		    logical_map_index == REDUCE_ZERO_MAP_ENTRY) {
 			continue;
 		}
 		spdk_bit_array_set(vol->allocated_chunk_maps, logical_map_index);
 		chunk = _reduce_vol_get_chunk_map(vol, logical_map_index);
+		if (chunk->packed_offset == UINT32_MAX) {
+			/* Chunk written before packing support - the field was never
+			 *  initialized from the 0xFF fill.  Such chunks always start at
+			 *  offset 0 of their io units.
+			 */
+			chunk->packed_offset = 0;
+			_reduce_persist(vol, &chunk->packed_offset, sizeof(chunk->packed_offset));
+		}
 		for (j = 0; j < vol->backing_io_units_per_chunk; j++) {
 			if (chunk->io_unit_index[j] != REDUCE_EMPTY_MAP_ENTRY) {
 				spdk_bit_array_set(vol->allocated_backing_io_units, chunk->io_unit_index[j]);
+				vol->io_unit_refs[chunk->io_unit_index[j]]++;
 			}
 		}
 	}
@@ -826,6 +938,7 @@ spdk_reduce_vol_load(struct spdk_reduce_backing_dev *backing_dev,
 	TAILQ_INIT(&vol->free_requests);
 	TAILQ_INIT(&vol->executing_requests);
 	TAILQ_INIT(&vol->queued_requests);
+	TAILQ_INIT(&vol->pending_persists);
 
 	vol->backing_super = spdk_zmalloc(sizeof(*vol->backing_super), 64, NULL,
 					  SPDK_ENV_LCORE_ID_ANY, SPDK_MALLOC_DMA);
@@ -1015,14 +1128,83 @@ _reduce_vol_complete_req(struct spdk_reduce_vol_request *req, int reduce_errno)
 }
 
 static void
-_write_write_done(void *_req, int reduce_errno)
+_reduce_vol_flush_pending_persists(struct spdk_reduce_vol *vol)
 {
-	struct spdk_reduce_vol_request *req = _req;
-	struct spdk_reduce_vol *vol = req->vol;
+	TAILQ_HEAD(, spdk_reduce_vol_request) batch;
+	struct spdk_reduce_vol_request *req;
 	uint64_t old_chunk_map_index;
 	struct spdk_reduce_chunk_map *old_chunk;
 	uint32_t i;
 
+	/* Move the staged requests to a local list first.  Completing a request
+	 *  may start a queued overlapping write, which could stage itself and
+	 *  trigger another flush before this batch is done.
+	 */
+	TAILQ_INIT(&batch);
+	TAILQ_CONCAT(&batch, &vol->pending_persists, pending_tailq);
+	vol->num_pending_persists = 0;
+
+	/* Persist the new chunk maps for the whole batch.  These must be durable
+	 *  before any of the logical map entries referencing them are updated.
+	 *  All-zero chunks have no chunk map to persist.
+	 */
+	TAILQ_FOREACH(req, &batch, pending_tailq) {
+		if (req->chunk == NULL) {
+			continue;
+		}
+		_reduce_persist_flush(vol, req->chunk,
+				      _reduce_vol_get_chunk_struct_size(vol->backing_io_units_per_chunk));
+	}
+	_reduce_persist_drain(vol);
+
+	TAILQ_FOREACH(req, &batch, pending_tailq) {
+		old_chunk_map_index = vol->pm_logical_map[req->logical_map_index];
+		if (old_chunk_map_index != REDUCE_EMPTY_MAP_ENTRY &&
+		    old_chunk_map_index != REDUCE_ZERO_MAP_ENTRY) {
+			old_chunk = _reduce_vol_get_chunk_map(vol, old_chunk_map_index);
+			for (i = 0; i < vol->backing_io_units_per_chunk; i++) {
+				if (old_chunk->io_unit_index[i] == REDUCE_EMPTY_MAP_ENTRY) {
+					break;
+				}
+				assert(spdk_bit_array_get(vol->allocated_backing_io_units,
+							  old_chunk->io_unit_index[i]) == true);
+				assert(vol->io_unit_refs[old_chunk->io_unit_index[i]] > 0);
+				/* Packed chunks share their io unit - it may only be freed
+				 *  once the last chunk referencing it is released.
+				 */
+				if (--vol->io_unit_refs[old_chunk->io_unit_index[i]] == 0) {
+					spdk_bit_array_clear(vol->allocated_backing_io_units,
+							     old_chunk->io_unit_index[i]);
+				}
+				old_chunk->io_unit_index[i] = REDUCE_EMPTY_MAP_ENTRY;
+			}
+			spdk_bit_array_clear(vol->allocated_chunk_maps, old_chunk_map_index);
+		}
+
+		/*
+		 * We don't need to persist the clearing of the old chunk map here.  The old chunk map
+		 * becomes invalid after we update the logical map, since the old chunk map will no
+		 * longer have a reference to it in the logical map.
+		 */
+
+		vol->pm_logical_map[req->logical_map_index] = req->chunk_map_index;
+
+		_reduce_persist_flush(vol, &vol->pm_logical_map[req->logical_map_index], sizeof(uint64_t));
+	}
+	_reduce_persist_drain(vol);
+
+	while ((req = TAILQ_FIRST(&batch)) != NULL) {
+		TAILQ_REMOVE(&batch, req, pending_tailq);
+		_reduce_vol_complete_req(req, 0);
+	}
+}
+
+static void
+_write_write_done(void *_req, int reduce_errno)
+{
+	struct spdk_reduce_vol_request *req = _req;
+	struct spdk_reduce_vol *vol = req->vol;
+
 	if (reduce_errno != 0) {
 		req->reduce_errno = reduce_errno;
 	}
@@ -1032,40 +1214,115 @@ _write_write_done(void *_req, int reduce_errno)
 		return;
 	}
 
+	assert(vol->num_inflight_writes > 0);
+	vol->num_inflight_writes--;
+
 	if (req->reduce_errno != 0) {
 		_reduce_vol_complete_req(req, req->reduce_errno);
-		return;
+	} else {
+		/* Stage the chunk map and logical map updates instead of persisting
+		 *  them right away.  The batch is flushed below once no other write
+		 *  could still join it, so the persist barriers amortize across all
+		 *  of the writes completing in this window.
+		 */
+		TAILQ_INSERT_TAIL(&vol->pending_persists, req, pending_tailq);
+		vol->num_pending_persists++;
 	}
 
-	old_chunk_map_index = vol->pm_logical_map[req->logical_map_index];
-	if (old_chunk_map_index != REDUCE_EMPTY_MAP_ENTRY) {
-		old_chunk = _reduce_vol_get_chunk_map(vol, old_chunk_map_index);
-		for (i = 0; i < vol->backing_io_units_per_chunk; i++) {
-			if (old_chunk->io_unit_index[i] == REDUCE_EMPTY_MAP_ENTRY) {
-				break;
-			}
-			assert(spdk_bit_array_get(vol->allocated_backing_io_units, old_chunk->io_unit_index[i]) == true);
-			spdk_bit_array_clear(vol->allocated_backing_io_units, old_chunk->io_unit_index[i]);
-			old_chunk->io_unit_index[i] = REDUCE_EMPTY_MAP_ENTRY;
-		}
-		spdk_bit_array_clear(vol->allocated_chunk_maps, old_chunk_map_index);
+	if (vol->num_pending_persists > 0 &&
+	    (vol->num_inflight_writes == 0 ||
+	     vol->num_pending_persists >= REDUCE_PM_PERSIST_BATCH_MAX)) {
+		_reduce_vol_flush_pending_persists(vol);
+	}
+}
+
+static void
+_reduce_vol_pack_write_done(void *cb_arg, int reduce_errno)
+{
+	struct reduce_pack *pack = cb_arg;
+	struct spdk_reduce_vol_request *req;
+
+	while ((req = TAILQ_FIRST(&pack->reqs)) != NULL) {
+		TAILQ_REMOVE(&pack->reqs, req, pending_tailq);
+		_write_write_done(req, reduce_errno);
 	}
+	spdk_free(pack);
+}
 
-	/*
-	 * We don't need to persist the clearing of the old chunk map here.  The old chunk map
-	 * becomes invalid after we update the logical map, since the old chunk map will no
-	 * longer have a reference to it in the logical map.
+static void
+_reduce_vol_pack_flush(struct spdk_reduce_vol *vol)
+{
+	struct reduce_pack *pack = vol->open_pack;
+
+	assert(pack != NULL);
+	vol->open_pack = NULL;
+
+	pack->iov.iov_base = pack->buf;
+	pack->iov.iov_len = vol->params.backing_io_unit_size;
+	pack->backing_cb_args.cb_fn = _reduce_vol_pack_write_done;
+	pack->backing_cb_args.cb_arg = pack;
+	vol->backing_dev->writev(vol->backing_dev, &pack->iov, 1,
+				 pack->io_unit_index * vol->backing_lba_per_io_unit,
+				 vol->backing_lba_per_io_unit, &pack->backing_cb_args);
+}
+
+static void
+_reduce_vol_pack_flush_if_idle(struct spdk_reduce_vol *vol)
+{
+	/* As long as some write is still in the compression stage, keep the pack
+	 *  open so that write can join it.
 	 */
+	if (vol->num_compressing_writes == 0 && vol->open_pack != NULL) {
+		_reduce_vol_pack_flush(vol);
+	}
+}
 
-	/* Persist the new chunk map.  This must be persisted before we update the logical map. */
-	_reduce_persist(vol, req->chunk,
-			_reduce_vol_get_chunk_struct_size(vol->backing_io_units_per_chunk));
+static int
+_reduce_vol_pack_chunk(struct spdk_reduce_vol_request *req, uint32_t compressed_size)
+{
+	struct spdk_reduce_vol *vol = req->vol;
+	struct reduce_pack *pack = vol->open_pack;
+	uint64_t io_unit_index;
 
-	vol->pm_logical_map[req->logical_map_index] = req->chunk_map_index;
+	/* If this chunk does not fit in the open pack, write the pack out and start
+	 *  a new one.  The pack write may complete synchronously, and a queued write
+	 *  started from its completion may have opened a new pack - so re-check
+	 *  vol->open_pack after each flush.
+	 */
+	while (pack != NULL &&
+	       pack->fill + compressed_size > vol->params.backing_io_unit_size) {
+		_reduce_vol_pack_flush(vol);
+		pack = vol->open_pack;
+	}
+
+	if (pack == NULL) {
+		pack = spdk_zmalloc(sizeof(*pack) + vol->params.backing_io_unit_size, 64, NULL,
+				    SPDK_ENV_LCORE_ID_ANY, SPDK_MALLOC_DMA);
+		if (pack == NULL) {
+			/* Caller falls back to writing this chunk to its own io unit. */
+			return -ENOMEM;
+		}
 
-	_reduce_persist(vol, &vol->pm_logical_map[req->logical_map_index], sizeof(uint64_t));
+		io_unit_index = spdk_bit_array_find_first_clear(vol->allocated_backing_io_units, 0);
+		assert(io_unit_index != UINT32_MAX);
+		spdk_bit_array_set(vol->allocated_backing_io_units, io_unit_index);
 
-	_reduce_vol_complete_req(req, 0);
+		TAILQ_INIT(&pack->reqs);
+		pack->vol = vol;
+		pack->io_unit_index = io_unit_index;
+		vol->open_pack = pack;
+	}
+
+	req->chunk->packed_offset = pack->fill;
+	req->chunk->io_unit_index[0] = pack->io_unit_index;
+	vol->io_unit_refs[pack->io_unit_index]++;
+	memcpy(pack->buf + pack->fill, req->comp_buf, compressed_size);
+	pack->fill = SPDK_ALIGN_CEIL(pack->fill + compressed_size, REDUCE_PACK_ALIGNMENT);
+
+	req->num_backing_ops = 1;
+	TAILQ_INSERT_TAIL(&pack->reqs, req, pending_tailq);
+
+	return 0;
 }
 
 static void
@@ -1112,6 +1369,9 @@ _reduce_vol_write_chunk(struct spdk_reduce_vol_request *req, reduce_request_fn n
 	uint8_t *buf;
 	int j;
 
+	assert(vol->num_compressing_writes > 0);
+	vol->num_compressing_writes--;
+
 	req->chunk_map_index = spdk_bit_array_find_first_clear(vol->allocated_chunk_maps, 0);
 
 	/* TODO: fail if no chunk map found - but really this should not happen if we
@@ -1126,6 +1386,7 @@ _reduce_vol_write_chunk(struct spdk_reduce_vol_request *req, reduce_request_fn n
 	req->chunk_is_compressed = (req->num_io_units != vol->backing_io_units_per_chunk);
 	req->chunk->compressed_size =
 		req->chunk_is_compressed ? compressed_size : vol->params.chunk_size;
+	req->chunk->packed_offset = 0;
 
 	/* if the chunk is uncompressed we need to copy the data from the host buffers. */
 	if (req->chunk_is_compressed == false) {
@@ -1155,6 +1416,18 @@ _reduce_vol_write_chunk(struct spdk_reduce_vol_request *req, reduce_request_fn n
 		assert(total_len == vol->params.chunk_size);
 	}
 
+	vol->num_inflight_writes++;
+
+	if (req->chunk_is_compressed &&
+	    compressed_size <= vol->params.backing_io_unit_size / REDUCE_PACK_MAX_SIZE_DIVISOR &&
+	    _reduce_vol_pack_chunk(req, compressed_size) == 0) {
+		/* The chunk was staged on the open pack - its backing io is issued
+		 *  when the pack is written out.
+		 */
+		_reduce_vol_pack_flush_if_idle(vol);
+		return;
+	}
+
 	for (i = 0; i < req->num_io_units; i++) {
 		req->chunk->io_unit_index[i] = spdk_bit_array_find_first_clear(vol->allocated_backing_io_units, 0);
 		/* TODO: fail if no backing block found - but really this should also not
@@ -1162,9 +1435,11 @@ _reduce_vol_write_chunk(struct spdk_reduce_vol_request *req, reduce_request_fn n
 		 */
 		assert(req->chunk->io_unit_index[i] != UINT32_MAX);
 		spdk_bit_array_set(vol->allocated_backing_io_units, req->chunk->io_unit_index[i]);
+		vol->io_unit_refs[req->chunk->io_unit_index[i]]++;
 	}
 
 	_issue_backing_ops(req, vol, next_fn, true /* write */);
+	_reduce_vol_pack_flush_if_idle(vol);
 }
 
 static void
@@ -1185,6 +1460,56 @@ _write_compress_done(void *_req, int reduce_errno)
 	_reduce_vol_write_chunk(req, _write_write_done, req->backing_cb_args.output_size);
 }
 
+static bool
+_reduce_vol_chunk_is_zero(struct spdk_reduce_vol_request *req)
+{
+	uint8_t *buf;
+	uint64_t len, cmp_len;
+	int i;
+
+	for (i = 0; i < req->decomp_iovcnt; i++) {
+		buf = req->decomp_iov[i].iov_base;
+		if (buf >= g_zero_buf && buf < g_zero_buf + REDUCE_ZERO_BUF_SIZE) {
+			/* Zero padding segment pointing into the zero buffer itself. */
+			continue;
+		}
+		len = req->decomp_iov[i].iov_len;
+		while (len > 0) {
+			cmp_len = spdk_min(len, (uint64_t)REDUCE_ZERO_BUF_SIZE);
+			if (memcmp(buf, g_zero_buf, cmp_len) != 0) {
+				return false;
+			}
+			buf += cmp_len;
+			len -= cmp_len;
+		}
+	}
+
+	return true;
+}
+
+static void
+_reduce_vol_write_zero_chunk(struct spdk_reduce_vol_request *req)
+{
+	struct spdk_reduce_vol *vol = req->vol;
+
+	assert(vol->num_compressing_writes > 0);
+	vol->num_compressing_writes--;
+
+	/* No chunk map or backing io units are allocated for an all-zero chunk -
+	 *  the logical map entry alone records its contents.  Skip compression
+	 *  and go straight to the metadata update, riding the persist batching
+	 *  as a write whose single "backing op" completed synchronously.
+	 */
+	req->chunk_map_index = REDUCE_ZERO_MAP_ENTRY;
+	req->chunk = NULL;
+	req->num_io_units = 0;
+	req->num_backing_ops = 1;
+	vol->num_inflight_writes++;
+
+	_reduce_vol_pack_flush_if_idle(vol);
+	_write_write_done(req, 0);
+}
+
 static void
 _reduce_vol_compress_chunk(struct spdk_reduce_vol_request *req, reduce_request_fn next_fn)
 {
@@ -1206,7 +1531,7 @@ _reduce_vol_decompress_chunk_scratch(struct spdk_reduce_vol_request *req, reduce
 
 	req->backing_cb_args.cb_fn = next_fn;
 	req->backing_cb_args.cb_arg = req;
-	req->comp_buf_iov[0].iov_base = req->comp_buf;
+	req->comp_buf_iov[0].iov_base = req->comp_buf + req->chunk->packed_offset;
 	req->comp_buf_iov[0].iov_len = req->chunk->compressed_size;
 	req->decomp_buf_iov[0].iov_base = req->decomp_buf;
 	req->decomp_buf_iov[0].iov_len = vol->params.chunk_size;
@@ -1273,7 +1598,7 @@ decompress:
 	assert(!req->copy_after_decompress || (req->copy_after_decompress && req->decomp_iovcnt == 1));
 	req->backing_cb_args.cb_fn = next_fn;
 	req->backing_cb_args.cb_arg = req;
-	req->comp_buf_iov[0].iov_base = req->comp_buf;
+	req->comp_buf_iov[0].iov_base = req->comp_buf + req->chunk->packed_offset;
 	req->comp_buf_iov[0].iov_len = req->chunk->compressed_size;
 	vol->backing_dev->decompress(vol->backing_dev,
 				     req->comp_buf_iov, 1, req->decomp_iov, req->decomp_iovcnt,
@@ -1384,10 +1709,14 @@ static void
 _write_decompress_done(void *_req, int reduce_errno)
 {
 	struct spdk_reduce_vol_request *req = _req;
+	struct spdk_reduce_vol *vol = req->vol;
 
 	/* Negative reduce_errno indicates failure for compression operations. */
 	if (reduce_errno < 0) {
+		assert(vol->num_compressing_writes > 0);
+		vol->num_compressing_writes--;
 		_reduce_vol_complete_req(req, reduce_errno);
+		_reduce_vol_pack_flush_if_idle(vol);
 		return;
 	}
 
@@ -1395,11 +1724,18 @@ _write_decompress_done(void *_req, int reduce_errno)
 	 * represents the output_size.
 	 */
 	if (req->backing_cb_args.output_size != req->vol->params.chunk_size) {
+		assert(vol->num_compressing_writes > 0);
+		vol->num_compressing_writes--;
 		_reduce_vol_complete_req(req, -EIO);
+		_reduce_vol_pack_flush_if_idle(vol);
 		return;
 	}
 
 	_prepare_compress_chunk(req, false);
+	if (_reduce_vol_chunk_is_zero(req)) {
+		_reduce_vol_write_zero_chunk(req);
+		return;
+	}
 	_reduce_vol_compress_chunk(req, _write_compress_done);
 }
 
@@ -1407,6 +1743,7 @@ static void
 _write_read_done(void *_req, int reduce_errno)
 {
 	struct spdk_reduce_vol_request *req = _req;
+	struct spdk_reduce_vol *vol = req->vol;
 
 	if (reduce_errno != 0) {
 		req->reduce_errno = reduce_errno;
@@ -1418,7 +1755,10 @@ _write_read_done(void *_req, int reduce_errno)
 	}
 
 	if (req->reduce_errno != 0) {
+		assert(vol->num_compressing_writes > 0);
+		vol->num_compressing_writes--;
 		_reduce_vol_complete_req(req, req->reduce_errno);
+		_reduce_vol_pack_flush_if_idle(vol);
 		return;
 	}
 
@@ -1555,7 +1895,23 @@ _check_overlap(struct spdk_reduce_vol *vol, uint64_t logical_map_index)
 static void
 _start_readv_request(struct spdk_reduce_vol_request *req)
 {
-	TAILQ_INSERT_TAIL(&req->vol->executing_requests, req, tailq);
+	struct spdk_reduce_vol *vol = req->vol;
+	int i;
+
+	TAILQ_INSERT_TAIL(&vol->executing_requests, req, tailq);
+
+	if (vol->pm_logical_map[req->logical_map_index] == REDUCE_ZERO_MAP_ENTRY) {
+		/* A queued read starts only after an overlapping write completes, and
+		 *  that write may have mapped the chunk to the zero entry.  There is
+		 *  nothing to read from the backing device in that case.
+		 */
+		for (i = 0; i < req->iovcnt; i++) {
+			memset(req->iov[i].iov_base, 0, req->iov[i].iov_len);
+		}
+		_reduce_vol_complete_req(req, 0);
+		return;
+	}
+
 	_reduce_vol_read_chunk(req, _read_read_done);
 }
 
@@ -1587,11 +1943,12 @@ spdk_reduce_vol_readv(struct spdk_reduce_vol *vol,
 	logical_map_index = offset / vol->logical_blocks_per_chunk;
 	overlapped = _check_overlap(vol, logical_map_index);
 
-	if (!overlapped && vol->pm_logical_map[logical_map_index] == REDUCE_EMPTY_MAP_ENTRY) {
+	if (!overlapped && (vol->pm_logical_map[logical_map_index] == REDUCE_EMPTY_MAP_ENTRY ||
+			    vol->pm_logical_map[logical_map_index] == REDUCE_ZERO_MAP_ENTRY)) {
 		/*
-		 * This chunk hasn't been allocated.  So treat the data as all
-		 * zeroes for this chunk - do the memset and immediately complete
-		 * the operation.
+		 * This chunk either hasn't been allocated or holds all zeroes.  So
+		 * treat the data as all zeroes for this chunk - do the memset and
+		 * immediately complete the operation.
 		 */
 		for (i = 0; i < iovcnt; i++) {
 			memset(iov[i].iov_base, 0, iov[i].iov_len);
@@ -1630,8 +1987,10 @@ _start_writev_request(struct spdk_reduce_vol_request *req)
 {
 	struct spdk_reduce_vol *vol = req->vol;
 
+	vol->num_compressing_writes++;
 	TAILQ_INSERT_TAIL(&req->vol->executing_requests, req, tailq);
-	if (vol->pm_logical_map[req->logical_map_index] != REDUCE_EMPTY_MAP_ENTRY) {
+	if (vol->pm_logical_map[req->logical_map_index] != REDUCE_EMPTY_MAP_ENTRY &&
+	    vol->pm_logical_map[req->logical_map_index] != REDUCE_ZERO_MAP_ENTRY) {
 		if ((req->length * vol->params.logical_block_size) < vol->params.chunk_size) {
 			/* Read old chunk, then overwrite with data from this write
 			 *  operation.
@@ -1645,6 +2004,10 @@ _start_writev_request(struct spdk_reduce_vol_request *req)
 	req->rmw = false;
 
 	_prepare_compress_chunk(req, true);
+	if (_reduce_vol_chunk_is_zero(req)) {
+		_reduce_vol_write_zero_chunk(req);
+		return;
+	}
 	_reduce_vol_compress_chunk(req, _write_compress_done);
 }
 
@@ -204,18 +204,41 @@ SpdkRandomAccessFile::InvalidateCache(__attribute__((unused)) size_t offset,
 	return Status::OK();
 }
 
+/* Matches CACHE_BUFFER_SIZE in lib/blobfs, so a full append buffer maps onto
+ * exactly one blobfs cache buffer.
+ */
+#define SPDK_APPEND_BUFFER_SIZE (256 * 1024)
+
 class SpdkWritableFile : public WritableFile
 {
 	struct spdk_file *mFile;
 	uint64_t mSize;
+	char *mBuf;
+	uint64_t mBufUsed;
+	pthread_mutex_t mSyncMutex;
+	pthread_cond_t mSyncCond;
+	bool mSyncInProgress;
+	uint64_t mSyncedSize;
+
+	Status FlushBuffered();
+	Status DoSync();
 
 public:
-	SpdkWritableFile(struct spdk_file *file) : mFile(file), mSize(0) {}
+	SpdkWritableFile(struct spdk_file *file) : mFile(file), mSize(0),
+		mBuf(new char[SPDK_APPEND_BUFFER_SIZE]), mBufUsed(0),
+		mSyncInProgress(false), mSyncedSize(0)
+	{
+		pthread_mutex_init(&mSyncMutex, NULL);
+		pthread_cond_init(&mSyncCond, NULL);
+	}
 	~SpdkWritableFile()
 	{
 		if (mFile != NULL) {
 			Close();
 		}
+		delete[] mBuf;
+		pthread_cond_destroy(&mSyncCond);
+		pthread_mutex_destroy(&mSyncMutex);
 	}
 
 	virtual void SetIOPriority(Env::IOPriority pri)
@@ -228,11 +251,24 @@ public:
 	virtual Status Truncate(uint64_t size) override
 	{
 		int rc;
+		Status status;
 
 		set_channel();
+		pthread_mutex_lock(&mSyncMutex);
+		status = FlushBuffered();
+		if (!status.ok()) {
+			pthread_mutex_unlock(&mSyncMutex);
+			return status;
+		}
 		rc = spdk_file_truncate(mFile, g_sync_args.channel, size);
 		if (!rc) {
 			mSize = size;
+			if (mSyncedSize > size) {
+				mSyncedSize = size;
+			}
+		}
+		pthread_mutex_unlock(&mSyncMutex);
+		if (!rc) {
 			return Status::OK();
 		} else {
 			errno = -rc;
@@ -241,7 +277,15 @@ public:
 	}
 	virtual Status Close() override
 	{
+		Status status;
+
 		set_channel();
+		pthread_mutex_lock(&mSyncMutex);
+		status = FlushBuffered();
+		pthread_mutex_unlock(&mSyncMutex);
+		if (!status.ok()) {
+			return status;
+		}
 		spdk_file_close(mFile, g_sync_args.channel);
 		mFile = NULL;
 		return Status::OK();
@@ -250,33 +294,21 @@ public:
 	virtual Status Append(const Slice &data) override;
 	virtual Status Flush() override
 	{
-		return Status::OK();
+		Status status;
+
+		set_channel();
+		pthread_mutex_lock(&mSyncMutex);
+		status = FlushBuffered();
+		pthread_mutex_unlock(&mSyncMutex);
+		return status;
 	}
 	virtual Status Sync() override
 	{
-		int rc;
-
-		set_channel();
-		rc = spdk_file_sync(mFile, g_sync_args.channel);
-		if (!rc) {
-			return Status::OK();
-		} else {
-			errno = -rc;
-			return Status::IOError(spdk_file_get_name(mFile), strerror(errno));
-		}
+		return DoSync();
 	}
 	virtual Status Fsync() override
 	{
-		int rc;
-
-		set_channel();
-		rc = spdk_file_sync(mFile, g_sync_args.channel);
-		if (!rc) {
-			return Status::OK();
-		} else {
-			errno = -rc;
-			return Status::IOError(spdk_file_get_name(mFile), strerror(errno));
-		}
+		return DoSync();
 	}
 	virtual bool IsSyncThreadSafe() const override
 	{
@@ -307,20 +339,11 @@ public:
 	virtual Status RangeSync(__attribute__((unused)) uint64_t offset,
 				 __attribute__((unused)) uint64_t nbytes) override
 	{
-		int rc;
-
 		/*
 		 * SPDK BlobFS does not have a range sync operation yet, so just sync
 		 *  the whole file.
 		 */
-		set_channel();
-		rc = spdk_file_sync(mFile, g_sync_args.channel);
-		if (!rc) {
-			return Status::OK();
-		} else {
-			errno = -rc;
-			return Status::IOError(spdk_file_get_name(mFile), strerror(errno));
-		}
+		return DoSync();
 	}
 	virtual size_t GetUniqueId(char *id, size_t max_size) const override
 	{
@@ -335,15 +358,19 @@ public:
 	}
 };
 
+/* Write any buffered appends down to blobfs.  Caller must hold mSyncMutex. */
 Status
-SpdkWritableFile::Append(const Slice &data)
+SpdkWritableFile::FlushBuffered(void)
 {
 	int64_t rc;
 
-	set_channel();
-	rc = spdk_file_write(mFile, g_sync_args.channel, (void *)data.data(), mSize, data.size());
+	if (mBufUsed == 0) {
+		return Status::OK();
+	}
+
+	rc = spdk_file_write(mFile, g_sync_args.channel, mBuf, mSize - mBufUsed, mBufUsed);
 	if (rc >= 0) {
-		mSize += data.size();
+		mBufUsed = 0;
 		return Status::OK();
 	} else {
 		errno = -rc;
@@ -351,6 +378,109 @@ SpdkWritableFile::Append(const Slice &data)
 	}
 }
 
+Status
+SpdkWritableFile::DoSync(void)
+{
+	uint64_t target;
+	Status status;
+	int rc;
+
+	set_channel();
+	pthread_mutex_lock(&mSyncMutex);
+
+	status = FlushBuffered();
+	if (!status.ok()) {
+		pthread_mutex_unlock(&mSyncMutex);
+		return status;
+	}
+	target = mSize;
+
+	/* Group commit - one thread flushes on behalf of every writer whose data
+	 * reached blobfs before the flush started, the rest just wait for a
+	 * covering flush to finish instead of issuing their own.
+	 */
+	while (mSyncedSize < target) {
+		uint64_t sync_to;
+
+		if (mSyncInProgress) {
+			pthread_cond_wait(&mSyncCond, &mSyncMutex);
+			continue;
+		}
+
+		mSyncInProgress = true;
+		sync_to = mSize - mBufUsed;
+		pthread_mutex_unlock(&mSyncMutex);
+
+		rc = spdk_file_sync(mFile, g_sync_args.channel);
+
+		pthread_mutex_lock(&mSyncMutex);
+		mSyncInProgress = false;
+		if (rc == 0 && mSyncedSize < sync_to) {
+			mSyncedSize = sync_to;
+		}
+		pthread_cond_broadcast(&mSyncCond);
+		if (rc != 0) {
+			pthread_mutex_unlock(&mSyncMutex);
+			errno = -rc;
+			return Status::IOError(spdk_file_get_name(mFile), strerror(errno));
+		}
+	}
+
+	pthread_mutex_unlock(&mSyncMutex);
+	return Status::OK();
+}
+
+Status
+SpdkWritableFile::Append(const Slice &data)
+{
+	const char *src = data.data();
+	size_t nbytes = data.size();
+	Status status = Status::OK();
+	int64_t rc;
+
+	set_channel();
+	pthread_mutex_lock(&mSyncMutex);
+
+	/* Large appends bypass the buffer once it has been drained. */
+	if (nbytes >= SPDK_APPEND_BUFFER_SIZE) {
+		status = FlushBuffered();
+		if (status.ok()) {
+			rc = spdk_file_write(mFile, g_sync_args.channel, (void *)src, mSize, nbytes);
+			if (rc >= 0) {
+				mSize += nbytes;
+			} else {
+				errno = -rc;
+				status = Status::IOError(spdk_file_get_name(mFile), strerror(errno));
+			}
+		}
+		pthread_mutex_unlock(&mSyncMutex);
+		return status;
+	}
+
+	while (nbytes > 0) {
+		uint64_t copy;
+
+		if (mBufUsed == SPDK_APPEND_BUFFER_SIZE) {
+			status = FlushBuffered();
+			if (!status.ok()) {
+				break;
+			}
+		}
+		copy = SPDK_APPEND_BUFFER_SIZE - mBufUsed;
+		if (copy > nbytes) {
+			copy = nbytes;
+		}
+		memcpy(mBuf + mBufUsed, src, copy);
+		mBufUsed += copy;
+		mSize += copy;
+		src += copy;
+		nbytes -= copy;
+	}
+
+	pthread_mutex_unlock(&mSyncMutex);
+	return status;
+}
+
 class SpdkDirectory : public Directory
 {
 public:
@@ -34,6 +34,7 @@ struct spdk_rpc_method {
 	spdk_rpc_method_handler func;
 	SLIST_ENTRY(spdk_rpc_method) slist;
 	uint32_t state_mask;
+	uint32_t flags;
 	bool is_deprecated;
 	struct spdk_rpc_method *is_alias_of;
 	bool deprecation_warning_printed;
@@ -41,6 +42,16 @@ struct spdk_rpc_method {
 
 static SLIST_HEAD(, spdk_rpc_method) g_rpc_methods = SLIST_HEAD_INITIALIZER(g_rpc_methods);
 
+/* Executor used to run handlers of methods registered with
+ * SPDK_RPC_METHOD_FLAG_CONCURRENT on other threads. */
+static void (*g_rpc_executor)(void (*fn)(void *ctx), void *ctx);
+
+void
+spdk_rpc_set_executor(void (*executor)(void (*fn)(void *ctx), void *ctx))
+{
+	g_rpc_executor = executor;
+}
+
 void
 spdk_rpc_set_state(uint32_t state)
 {
@@ -101,6 +112,21 @@ _get_rpc_method_raw(const char *method)
 	return _get_rpc_method(&method_val);
 }
 
+struct rpc_handler_ctx {
+	spdk_rpc_method_handler func;
+	struct spdk_jsonrpc_request *request;
+	const struct spdk_json_val *params;
+};
+
+static void
+rpc_handler_run(void *arg)
+{
+	struct rpc_handler_ctx *ctx = arg;
+
+	ctx->func(ctx->request, ctx->params);
+	free(ctx);
+}
+
 static void
 jsonrpc_handler(struct spdk_jsonrpc_request *request,
 		const struct spdk_json_val *method,
@@ -125,6 +151,19 @@ jsonrpc_handler(struct spdk_jsonrpc_request *request,
 	}
 
 	if ((m->state_mask & g_rpc_state) == g_rpc_state) {
+		if ((m->flags & SPDK_RPC_METHOD_FLAG_CONCURRENT) && g_rpc_executor != NULL) {
+			struct rpc_handler_ctx *ctx;
+
+			ctx = malloc(sizeof(*ctx));
+			if (ctx != NULL) {
+				ctx->func = m->func;
+				ctx->request = request;
+				ctx->params = params;
+				g_rpc_executor(rpc_handler_run, ctx);
+				return;
+			}
+			/* Fall back to running the handler inline */
+		}
 		m->func(request, params);
 	} else {
 		if (g_rpc_state == SPDK_RPC_STARTUP) {
@@ -259,7 +298,8 @@ spdk_rpc_server_accept(struct spdk_rpc_server *server)
 }
 
 void
-spdk_rpc_register_method(const char *method, spdk_rpc_method_handler func, uint32_t state_mask)
+spdk_rpc_register_method_ext(const char *method, spdk_rpc_method_handler func,
+			     uint32_t state_mask, uint32_t flags)
 {
 	struct spdk_rpc_method *m;
 
@@ -278,11 +318,18 @@ spdk_rpc_register_method(const char *method, spdk_rpc_method_handler func, uint3
 
 	m->func = func;
 	m->state_mask = state_mask;
+	m->flags = flags;
 
 	/* TODO: use a hash table or sorted list */
 	SLIST_INSERT_HEAD(&g_rpc_methods, m, slist);
 }
 
+void
+spdk_rpc_register_method(const char *method, spdk_rpc_method_handler func, uint32_t state_mask)
+{
+	spdk_rpc_register_method_ext(method, func, state_mask, 0);
+}
+
 void
 spdk_rpc_register_alias_deprecated(const char *method, const char *alias)
 {
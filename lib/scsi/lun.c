@@ -203,6 +203,9 @@ _scsi_lun_execute_task(struct spdk_scsi_lun *lun, struct spdk_scsi_task *task)
 		/* Check the command is allowed or not when reservation is exist */
 		if (spdk_unlikely(lun->reservation.flags & SCSI_SPC2_RESERVE)) {
 			rc = scsi2_reserve_check(task);
+		} else if (spdk_likely(!scsi_pr_has_reservation(lun))) {
+			/* No persistent reservation, nothing to check. */
+			rc = 0;
 		} else {
 			rc = scsi_pr_check(task);
 		}
@@ -189,6 +189,16 @@ int scsi_pr_out(struct spdk_scsi_task *task, uint8_t *cdb, uint8_t *data, uint16
 int scsi_pr_in(struct spdk_scsi_task *task, uint8_t *cdb, uint8_t *data, uint16_t data_len);
 int scsi_pr_check(struct spdk_scsi_task *task);
 
+/* LUN holds a reservation or not.  Inlined so that the per-I/O submit path
+ * can skip the scsi_pr_check() call entirely in the common case where no
+ * persistent reservation exists.
+ */
+static inline bool
+scsi_pr_has_reservation(const struct spdk_scsi_lun *lun)
+{
+	return !(lun->reservation.holder == NULL);
+}
+
 int scsi2_reserve(struct spdk_scsi_task *task, uint8_t *cdb);
 int scsi2_release(struct spdk_scsi_task *task);
 int scsi2_reserve_check(struct spdk_scsi_task *task);
@@ -62,13 +62,6 @@ scsi_pr_registrant_is_holder(struct spdk_scsi_lun *lun,
 	return (lun->reservation.holder == reg);
 }
 
-/* LUN holds a reservation or not */
-static inline bool
-scsi_pr_has_reservation(struct spdk_scsi_lun *lun)
-{
-	return !(lun->reservation.holder == NULL);
-}
-
 static int
 scsi_pr_register_registrant(struct spdk_scsi_lun *lun,
 			    struct spdk_scsi_port *initiator_port,
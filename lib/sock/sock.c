@@ -17,6 +17,9 @@
 #define SPDK_SOCK_DEFAULT_PRIORITY 0
 #define SPDK_SOCK_DEFAULT_ZCOPY true
 #define SPDK_SOCK_DEFAULT_ACK_TIMEOUT 0
+#define SPDK_SOCK_CORK_DEFAULT_MAX_BYTES (64 * 1024)
+#define SPDK_SOCK_CORK_DEFAULT_MAX_LATENCY_US 100
+#define SPDK_SOCK_REBALANCE_DEFAULT_PERIOD_US (1000 * 1000)
 
 #define SPDK_SOCK_OPTS_FIELD_OK(opts, field) (offsetof(struct spdk_sock_opts, field) + sizeof(opts->field) <= (opts->opts_size))
 
@@ -250,6 +253,10 @@ spdk_sock_get_default_opts(struct spdk_sock_opts *opts)
 		opts->zcopy = SPDK_SOCK_DEFAULT_ZCOPY;
 	}
 
+	if (SPDK_SOCK_OPTS_FIELD_OK(opts, reuse_port)) {
+		opts->reuse_port = false;
+	}
+
 	if (SPDK_SOCK_OPTS_FIELD_OK(opts, ack_timeout)) {
 		opts->ack_timeout = SPDK_SOCK_DEFAULT_ACK_TIMEOUT;
 	}
@@ -286,6 +293,10 @@ sock_init_opts(struct spdk_sock_opts *opts, struct spdk_sock_opts *opts_user)
 		opts->zcopy = opts_user->zcopy;
 	}
 
+	if (SPDK_SOCK_OPTS_FIELD_OK(opts, reuse_port)) {
+		opts->reuse_port = opts_user->reuse_port;
+	}
+
 	if (SPDK_SOCK_OPTS_FIELD_OK(opts, ack_timeout)) {
 		opts->ack_timeout = opts_user->ack_timeout;
 	}
@@ -699,6 +710,97 @@ spdk_sock_group_get_buf(struct spdk_sock_group *group, void **buf, void **ctx)
 	return provided->len;
 }
 
+void
+spdk_sock_group_cork(struct spdk_sock_group *group, uint32_t max_bytes, uint32_t max_latency_us)
+{
+	if (max_bytes == 0) {
+		max_bytes = SPDK_SOCK_CORK_DEFAULT_MAX_BYTES;
+	}
+	if (max_latency_us == 0) {
+		max_latency_us = SPDK_SOCK_CORK_DEFAULT_MAX_LATENCY_US;
+	}
+
+	group->corked = true;
+	group->cork_max_bytes = max_bytes;
+	group->cork_deadline_tsc = spdk_get_ticks() +
+				   max_latency_us * spdk_get_ticks_hz() / SPDK_SEC_TO_USEC;
+}
+
+void
+spdk_sock_group_uncork(struct spdk_sock_group *group)
+{
+	struct spdk_sock_group_impl *group_impl;
+	struct spdk_sock *sock, *tmp;
+	int rc;
+
+	if (!group->corked) {
+		return;
+	}
+
+	group->corked = false;
+
+	STAILQ_FOREACH(group_impl, &group->group_impls, link) {
+		/* This must be a TAILQ_FOREACH_SAFE because a completion callback
+		 * could remove the sock from the group while flushing. */
+		TAILQ_FOREACH_SAFE(sock, &group_impl->socks, link, tmp) {
+			if (TAILQ_EMPTY(&sock->queued_reqs)) {
+				continue;
+			}
+
+			rc = sock->net_impl->flush(sock);
+			if (rc < 0 && errno != EAGAIN) {
+				spdk_sock_abort_requests(sock);
+			}
+		}
+	}
+}
+
+void
+spdk_sock_group_set_rebalance_cb(struct spdk_sock_group *group,
+				 spdk_sock_group_rebalance_cb cb_fn, void *cb_arg,
+				 uint32_t period_us)
+{
+	if (period_us == 0) {
+		period_us = SPDK_SOCK_REBALANCE_DEFAULT_PERIOD_US;
+	}
+
+	group->rebalance_cb = cb_fn;
+	group->rebalance_ctx = cb_arg;
+	group->rebalance_period_tsc = period_us * spdk_get_ticks_hz() / SPDK_SEC_TO_USEC;
+	group->rebalance_next_tsc = spdk_get_ticks() + group->rebalance_period_tsc;
+}
+
+static void
+sock_group_rebalance(struct spdk_sock_group *group)
+{
+	struct spdk_sock_group_impl *group_impl;
+	struct spdk_sock *sock, *tmp;
+	struct spdk_sock_group *optimal;
+	int rc;
+
+	STAILQ_FOREACH(group_impl, &group->group_impls, link) {
+		if (group_impl->net_impl->refresh_placement_id == NULL) {
+			continue;
+		}
+
+		/* The callback may migrate the sock out of this group. */
+		TAILQ_FOREACH_SAFE(sock, &group_impl->socks, link, tmp) {
+			rc = sock->net_impl->refresh_placement_id(sock);
+			if (rc <= 0) {
+				continue;
+			}
+
+			optimal = NULL;
+			rc = spdk_sock_get_optimal_sock_group(sock, &optimal, group);
+			if (rc != 0 || optimal == NULL || optimal == group) {
+				continue;
+			}
+
+			group->rebalance_cb(group->rebalance_ctx, sock, optimal);
+		}
+	}
+}
+
 int
 spdk_sock_group_poll(struct spdk_sock_group *group)
 {
@@ -750,6 +852,18 @@ spdk_sock_group_poll_count(struct spdk_sock_group *group, int max_events)
 		max_events = MAX_EVENTS_PER_POLL;
 	}
 
+	/* Enforce the cork latency cap - don't let data sit across poll iterations
+	 * if the user forgot to (or chose not to) uncork. */
+	if (spdk_unlikely(group->corked) && spdk_get_ticks() >= group->cork_deadline_tsc) {
+		spdk_sock_group_uncork(group);
+	}
+
+	if (spdk_unlikely(group->rebalance_cb != NULL) &&
+	    spdk_get_ticks() >= group->rebalance_next_tsc) {
+		group->rebalance_next_tsc = spdk_get_ticks() + group->rebalance_period_tsc;
+		sock_group_rebalance(group);
+	}
+
 	STAILQ_FOREACH_FROM(group_impl, &group->group_impls, link) {
 		rc = sock_group_impl_poll_count(group_impl, group, max_events);
 		if (rc < 0) {
@@ -899,6 +1013,7 @@ spdk_sock_write_config_json(struct spdk_json_write_ctx *w)
 			spdk_json_write_named_uint32(w, "zerocopy_threshold", opts.zerocopy_threshold);
 			spdk_json_write_named_uint32(w, "tls_version", opts.tls_version);
 			spdk_json_write_named_bool(w, "enable_ktls", opts.enable_ktls);
+			spdk_json_write_named_bool(w, "enable_dynamic_zerocopy", opts.enable_dynamic_zerocopy);
 			spdk_json_write_object_end(w);
 			spdk_json_write_object_end(w);
 		} else {
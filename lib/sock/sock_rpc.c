@@ -55,6 +55,10 @@ rpc_sock_impl_get_options(struct spdk_jsonrpc_request *request,
 	spdk_json_write_named_uint32(w, "zerocopy_threshold", sock_opts.zerocopy_threshold);
 	spdk_json_write_named_uint32(w, "tls_version", sock_opts.tls_version);
 	spdk_json_write_named_bool(w, "enable_ktls", sock_opts.enable_ktls);
+	spdk_json_write_named_bool(w, "enable_dynamic_zerocopy", sock_opts.enable_dynamic_zerocopy);
+	spdk_json_write_named_uint32(w, "max_pacing_rate", sock_opts.max_pacing_rate);
+	spdk_json_write_named_uint32(w, "notsent_lowat", sock_opts.notsent_lowat);
+	spdk_json_write_named_uint32(w, "max_flushes_per_poll", sock_opts.max_flushes_per_poll);
 	spdk_json_write_object_end(w);
 	spdk_jsonrpc_end_result(request, w);
 	free(impl_name);
@@ -111,6 +115,22 @@ static const struct spdk_json_object_decoder rpc_sock_impl_set_opts_decoders[] =
 	{
 		"enable_ktls", offsetof(struct spdk_rpc_sock_impl_set_opts, sock_opts.enable_ktls),
 		spdk_json_decode_bool, true
+	},
+	{
+		"enable_dynamic_zerocopy", offsetof(struct spdk_rpc_sock_impl_set_opts, sock_opts.enable_dynamic_zerocopy),
+		spdk_json_decode_bool, true
+	},
+	{
+		"max_pacing_rate", offsetof(struct spdk_rpc_sock_impl_set_opts, sock_opts.max_pacing_rate),
+		spdk_json_decode_uint32, true
+	},
+	{
+		"notsent_lowat", offsetof(struct spdk_rpc_sock_impl_set_opts, sock_opts.notsent_lowat),
+		spdk_json_decode_uint32, true
+	},
+	{
+		"max_flushes_per_poll", offsetof(struct spdk_rpc_sock_impl_set_opts, sock_opts.max_flushes_per_poll),
+		spdk_json_decode_uint32, true
 	}
 };
 
@@ -23,16 +23,30 @@
  * for the default. */
 #define IOBUF_DEFAULT_LARGE_BUFSIZE	(132 * 1024)
 #define IOBUF_MAX_CHANNELS		64
+#define IOBUF_MAX_NUMA_NODES		8
+#define IOBUF_BATCH_SIZE		32
 
 SPDK_STATIC_ASSERT(sizeof(struct spdk_iobuf_buffer) <= IOBUF_MIN_SMALL_BUFSIZE,
 		   "Invalid data offset");
 
 static bool g_iobuf_is_initialized = false;
 
+/* Per-channel buffer usage observed at the last rebalance tick, used to tell
+ * starved channels (going to the shared pool) apart from idle ones. */
+struct iobuf_cache_usage {
+	uint64_t			total;
+	uint64_t			miss;
+	/* Tick of the last observed activity, for idle reclaim. */
+	uint64_t			last_active_tsc;
+};
+
 struct iobuf_channel {
 	spdk_iobuf_entry_stailq_t	small_queue;
 	spdk_iobuf_entry_stailq_t	large_queue;
 	struct spdk_iobuf_channel	*channels[IOBUF_MAX_CHANNELS];
+	struct spdk_poller		*rebalance_poller;
+	struct iobuf_cache_usage	small_usage[IOBUF_MAX_CHANNELS];
+	struct iobuf_cache_usage	large_usage[IOBUF_MAX_CHANNELS];
 };
 
 struct iobuf_module {
@@ -40,11 +54,35 @@ struct iobuf_module {
 	TAILQ_ENTRY(iobuf_module)	tailq;
 };
 
-struct iobuf {
+/* Buffers added by spdk_iobuf_pool_grow() after initialization.  Each chunk
+ * is a separate allocation that needs to be freed on its own. */
+struct iobuf_pool_chunk {
+	void				*base;
+	uint64_t			count;
+	TAILQ_ENTRY(iobuf_pool_chunk)	tailq;
+};
+
+TAILQ_HEAD(iobuf_chunk_list, iobuf_pool_chunk);
+
+/* Backing pools for one NUMA node.  Unless enable_numa is set, there is a
+ * single node holding the entire pool. */
+struct iobuf_node {
 	struct spdk_ring		*small_pool;
 	struct spdk_ring		*large_pool;
 	void				*small_pool_base;
 	void				*large_pool_base;
+	uint64_t			small_pool_count;
+	uint64_t			large_pool_count;
+	/* Ring capacities, limiting how far the pools can be grown. */
+	uint64_t			small_pool_max;
+	uint64_t			large_pool_max;
+	struct iobuf_chunk_list		small_chunks;
+	struct iobuf_chunk_list		large_chunks;
+};
+
+struct iobuf {
+	struct iobuf_node		nodes[IOBUF_MAX_NUMA_NODES];
+	uint32_t			num_nodes;
 	struct spdk_iobuf_opts		opts;
 	TAILQ_HEAD(, iobuf_module)	modules;
 	spdk_iobuf_finish_cb		finish_cb;
@@ -53,10 +91,7 @@ struct iobuf {
 
 static struct iobuf g_iobuf = {
 	.modules = TAILQ_HEAD_INITIALIZER(g_iobuf.modules),
-	.small_pool = NULL,
-	.large_pool = NULL,
-	.small_pool_base = NULL,
-	.large_pool_base = NULL,
+	.num_nodes = 0,
 	.opts = {
 		.small_pool_count = IOBUF_DEFAULT_SMALL_POOL_SIZE,
 		.large_pool_count = IOBUF_DEFAULT_LARGE_POOL_SIZE,
@@ -72,78 +107,295 @@ struct iobuf_get_stats_ctx {
 	void				*cb_arg;
 };
 
+static void
+iobuf_channel_rebalance_pool(struct iobuf_channel *iobuf_ch, bool small, uint64_t now,
+			     uint64_t reclaim_ticks, bool *moved)
+{
+	struct spdk_iobuf_channel *ch;
+	struct spdk_iobuf_pool *pool, *starved = NULL, *idle = NULL;
+	struct iobuf_cache_usage *usage;
+	struct spdk_iobuf_buffer *buf;
+	uint64_t total, miss, starved_miss = 0;
+	uint32_t i, credits;
+
+	for (i = 0; i < IOBUF_MAX_CHANNELS; ++i) {
+		ch = iobuf_ch->channels[i];
+		if (ch == NULL) {
+			continue;
+		}
+
+		pool = small ? &ch->small : &ch->large;
+		usage = small ? &iobuf_ch->small_usage[i] : &iobuf_ch->large_usage[i];
+		total = pool->stats.cache + pool->stats.main + pool->stats.retry;
+		miss = pool->stats.main + pool->stats.retry;
+
+		if (total != usage->total || usage->last_active_tsc == 0) {
+			usage->last_active_tsc = now;
+		} else if (reclaim_ticks > 0 && pool->cache_count > 0 &&
+			   now - usage->last_active_tsc >= reclaim_ticks) {
+			/* The channel has been idle past the reclaim period;
+			 * return its cached buffers to the shared pool.  The
+			 * cache credits are kept, so the cache refills from the
+			 * pool once the channel becomes active again.
+			 */
+			while (pool->cache_count > 0) {
+				buf = STAILQ_FIRST(&pool->cache);
+				STAILQ_REMOVE_HEAD(&pool->cache, stailq);
+				pool->cache_count--;
+				spdk_ring_enqueue(pool->pool, (void **)&buf, 1, NULL);
+			}
+			*moved = true;
+		}
+
+		if (miss - usage->miss > starved_miss) {
+			starved_miss = miss - usage->miss;
+			starved = pool;
+		} else if (total == usage->total && pool->cache_size > 0 &&
+			   (idle == NULL || pool->cache_size > idle->cache_size)) {
+			idle = pool;
+		}
+
+		usage->total = total;
+		usage->miss = miss;
+	}
+
+	if (g_iobuf.opts.cache_rebalance_period_us == 0) {
+		/* Only idle reclaim is enabled; don't move any cache credits. */
+		return;
+	}
+
+	if (starved == NULL || idle == NULL) {
+		return;
+	}
+
+	/* Move up to one batch of cache credits from the most idle channel to the most
+	 * starved one.  Any buffers the donor holds above its new cache size go back to
+	 * the shared pool, where the starved channel picks them up on its next refill. */
+	credits = spdk_min(IOBUF_BATCH_SIZE, idle->cache_size);
+	idle->cache_size -= credits;
+	starved->cache_size += credits;
+
+	while (idle->cache_count > idle->cache_size) {
+		buf = STAILQ_FIRST(&idle->cache);
+		STAILQ_REMOVE_HEAD(&idle->cache, stailq);
+		idle->cache_count--;
+		spdk_ring_enqueue(idle->pool, (void **)&buf, 1, NULL);
+	}
+
+	*moved = true;
+}
+
+static int
+iobuf_channel_rebalance(void *ctx)
+{
+	struct iobuf_channel *iobuf_ch = ctx;
+	uint64_t now = spdk_get_ticks();
+	uint64_t reclaim_ticks = 0;
+	bool moved = false;
+
+	if (g_iobuf.opts.cache_idle_reclaim_us > 0) {
+		reclaim_ticks = g_iobuf.opts.cache_idle_reclaim_us * spdk_get_ticks_hz() /
+				SPDK_SEC_TO_USEC;
+	}
+
+	iobuf_channel_rebalance_pool(iobuf_ch, true, now, reclaim_ticks, &moved);
+	iobuf_channel_rebalance_pool(iobuf_ch, false, now, reclaim_ticks, &moved);
+
+	return moved ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
+}
+
 static int
 iobuf_channel_create_cb(void *io_device, void *ctx)
 {
 	struct iobuf_channel *ch = ctx;
+	uint32_t period_us;
 
 	STAILQ_INIT(&ch->small_queue);
 	STAILQ_INIT(&ch->large_queue);
 
+	/* Idle reclaim runs from the same poller; when rebalancing is disabled
+	 * the poller runs at the reclaim period instead. */
+	period_us = g_iobuf.opts.cache_rebalance_period_us > 0 ?
+		    g_iobuf.opts.cache_rebalance_period_us : g_iobuf.opts.cache_idle_reclaim_us;
+	if (period_us > 0) {
+		ch->rebalance_poller = SPDK_POLLER_REGISTER(iobuf_channel_rebalance, ch, period_us);
+		if (ch->rebalance_poller == NULL) {
+			return -ENOMEM;
+		}
+	}
+
 	return 0;
 }
 
 static void
 iobuf_channel_destroy_cb(void *io_device, void *ctx)
 {
-	struct iobuf_channel *ch __attribute__((unused)) = ctx;
+	struct iobuf_channel *ch = ctx;
+
+	spdk_poller_unregister(&ch->rebalance_poller);
 
 	assert(STAILQ_EMPTY(&ch->small_queue));
 	assert(STAILQ_EMPTY(&ch->large_queue));
 }
 
-int
-spdk_iobuf_initialize(void)
+static void
+iobuf_node_free_chunks(struct iobuf_node *node)
+{
+	struct iobuf_pool_chunk *chunk;
+
+	while (!TAILQ_EMPTY(&node->small_chunks)) {
+		chunk = TAILQ_FIRST(&node->small_chunks);
+		TAILQ_REMOVE(&node->small_chunks, chunk, tailq);
+		spdk_free(chunk->base);
+		free(chunk);
+	}
+
+	while (!TAILQ_EMPTY(&node->large_chunks)) {
+		chunk = TAILQ_FIRST(&node->large_chunks);
+		TAILQ_REMOVE(&node->large_chunks, chunk, tailq);
+		spdk_free(chunk->base);
+		free(chunk);
+	}
+}
+
+static void
+iobuf_node_free(struct iobuf_node *node)
+{
+	iobuf_node_free_chunks(node);
+
+	spdk_free(node->small_pool_base);
+	node->small_pool_base = NULL;
+	spdk_ring_free(node->small_pool);
+	node->small_pool = NULL;
+
+	spdk_free(node->large_pool_base);
+	node->large_pool_base = NULL;
+	spdk_ring_free(node->large_pool);
+	node->large_pool = NULL;
+}
+
+static int
+iobuf_node_initialize(struct iobuf_node *node, uint64_t small_pool_count,
+		      uint64_t large_pool_count, uint64_t small_pool_max,
+		      uint64_t large_pool_max, int socket_id)
 {
 	struct spdk_iobuf_opts *opts = &g_iobuf.opts;
-	int rc = 0;
-	uint64_t i;
 	struct spdk_iobuf_buffer *buf;
+	uint64_t i;
+	int rc;
 
-	g_iobuf.small_pool = spdk_ring_create(SPDK_RING_TYPE_MP_MC, opts->small_pool_count,
-					      SPDK_ENV_SOCKET_ID_ANY);
-	if (!g_iobuf.small_pool) {
+	node->small_pool_count = small_pool_count;
+	node->large_pool_count = large_pool_count;
+	node->small_pool_max = spdk_max(small_pool_count, small_pool_max);
+	node->large_pool_max = spdk_max(large_pool_count, large_pool_max);
+	TAILQ_INIT(&node->small_chunks);
+	TAILQ_INIT(&node->large_chunks);
+
+	/* Size the rings for the maximum count, so that buffers added by
+	 * spdk_iobuf_pool_grow() always fit. */
+	node->small_pool = spdk_ring_create(SPDK_RING_TYPE_MP_MC, node->small_pool_max, socket_id);
+	if (!node->small_pool) {
 		SPDK_ERRLOG("Failed to create small iobuf pool\n");
 		rc = -ENOMEM;
 		goto error;
 	}
 
-	/* Round up to the nearest alignment so that each element remains aligned */
-	opts->small_bufsize = SPDK_ALIGN_CEIL(opts->small_bufsize, IOBUF_ALIGNMENT);
-	g_iobuf.small_pool_base = spdk_malloc(opts->small_bufsize * opts->small_pool_count, IOBUF_ALIGNMENT,
-					      NULL, SPDK_ENV_SOCKET_ID_ANY, SPDK_MALLOC_DMA);
-	if (g_iobuf.small_pool_base == NULL) {
+	node->small_pool_base = spdk_malloc(opts->small_bufsize * small_pool_count, IOBUF_ALIGNMENT,
+					    NULL, socket_id, SPDK_MALLOC_DMA);
+	if (node->small_pool_base == NULL) {
 		SPDK_ERRLOG("Unable to allocate requested small iobuf pool size\n");
 		rc = -ENOMEM;
 		goto error;
 	}
 
-	g_iobuf.large_pool = spdk_ring_create(SPDK_RING_TYPE_MP_MC, opts->large_pool_count,
-					      SPDK_ENV_SOCKET_ID_ANY);
-	if (!g_iobuf.large_pool) {
+	node->large_pool = spdk_ring_create(SPDK_RING_TYPE_MP_MC, node->large_pool_max, socket_id);
+	if (!node->large_pool) {
 		SPDK_ERRLOG("Failed to create large iobuf pool\n");
 		rc = -ENOMEM;
 		goto error;
 	}
 
-	/* Round up to the nearest alignment so that each element remains aligned */
-	opts->large_bufsize = SPDK_ALIGN_CEIL(opts->large_bufsize, IOBUF_ALIGNMENT);
-	g_iobuf.large_pool_base = spdk_malloc(opts->large_bufsize * opts->large_pool_count, IOBUF_ALIGNMENT,
-					      NULL, SPDK_ENV_SOCKET_ID_ANY, SPDK_MALLOC_DMA);
-	if (g_iobuf.large_pool_base == NULL) {
+	node->large_pool_base = spdk_malloc(opts->large_bufsize * large_pool_count, IOBUF_ALIGNMENT,
+					    NULL, socket_id, SPDK_MALLOC_DMA);
+	if (node->large_pool_base == NULL) {
 		SPDK_ERRLOG("Unable to allocate requested large iobuf pool size\n");
 		rc = -ENOMEM;
 		goto error;
 	}
 
-	for (i = 0; i < opts->small_pool_count; i++) {
-		buf = g_iobuf.small_pool_base + i * opts->small_bufsize;
-		spdk_ring_enqueue(g_iobuf.small_pool, (void **)&buf, 1, NULL);
+	for (i = 0; i < small_pool_count; i++) {
+		buf = node->small_pool_base + i * opts->small_bufsize;
+		spdk_ring_enqueue(node->small_pool, (void **)&buf, 1, NULL);
+	}
+
+	for (i = 0; i < large_pool_count; i++) {
+		buf = node->large_pool_base + i * opts->large_bufsize;
+		spdk_ring_enqueue(node->large_pool, (void **)&buf, 1, NULL);
+	}
+
+	return 0;
+error:
+	iobuf_node_free(node);
+
+	return rc;
+}
+
+static uint32_t
+iobuf_get_num_numa_nodes(void)
+{
+	uint32_t core, socket_id, num_nodes = 0;
+
+	SPDK_ENV_FOREACH_CORE(core) {
+		socket_id = spdk_env_get_socket_id(core);
+		if (socket_id != UINT32_MAX && socket_id >= num_nodes) {
+			num_nodes = socket_id + 1;
+		}
 	}
 
-	for (i = 0; i < opts->large_pool_count; i++) {
-		buf = g_iobuf.large_pool_base + i * opts->large_bufsize;
-		spdk_ring_enqueue(g_iobuf.large_pool, (void **)&buf, 1, NULL);
+	if (num_nodes > IOBUF_MAX_NUMA_NODES) {
+		SPDK_WARNLOG("Detected %" PRIu32 " NUMA nodes, limiting iobuf pools to %d nodes\n",
+			     num_nodes, IOBUF_MAX_NUMA_NODES);
+		num_nodes = IOBUF_MAX_NUMA_NODES;
+	}
+
+	return spdk_max(num_nodes, 1);
+}
+
+int
+spdk_iobuf_initialize(void)
+{
+	struct spdk_iobuf_opts *opts = &g_iobuf.opts;
+	uint64_t small_pool_count, large_pool_count;
+	uint64_t small_pool_max, large_pool_max;
+	uint32_t i;
+	int rc = 0, socket_id;
+
+	/* Round up to the nearest alignment so that each element remains aligned */
+	opts->small_bufsize = SPDK_ALIGN_CEIL(opts->small_bufsize, IOBUF_ALIGNMENT);
+	opts->large_bufsize = SPDK_ALIGN_CEIL(opts->large_bufsize, IOBUF_ALIGNMENT);
+
+	g_iobuf.num_nodes = opts->enable_numa ? iobuf_get_num_numa_nodes() : 1;
+
+	for (i = 0; i < g_iobuf.num_nodes; i++) {
+		small_pool_count = opts->small_pool_count / g_iobuf.num_nodes;
+		large_pool_count = opts->large_pool_count / g_iobuf.num_nodes;
+		small_pool_max = opts->small_pool_max_count / g_iobuf.num_nodes;
+		large_pool_max = opts->large_pool_max_count / g_iobuf.num_nodes;
+		if (i == 0) {
+			/* The first node gets the remainder */
+			small_pool_count += opts->small_pool_count % g_iobuf.num_nodes;
+			large_pool_count += opts->large_pool_count % g_iobuf.num_nodes;
+			small_pool_max += opts->small_pool_max_count % g_iobuf.num_nodes;
+			large_pool_max += opts->large_pool_max_count % g_iobuf.num_nodes;
+		}
+
+		socket_id = g_iobuf.num_nodes > 1 ? (int)i : SPDK_ENV_SOCKET_ID_ANY;
+		rc = iobuf_node_initialize(&g_iobuf.nodes[i], small_pool_count,
+					   large_pool_count, small_pool_max,
+					   large_pool_max, socket_id);
+		if (rc != 0) {
+			goto error;
+		}
 	}
 
 	spdk_io_device_register(&g_iobuf, iobuf_channel_create_cb, iobuf_channel_destroy_cb,
@@ -152,10 +404,9 @@ spdk_iobuf_initialize(void)
 
 	return 0;
 error:
-	spdk_free(g_iobuf.small_pool_base);
-	spdk_ring_free(g_iobuf.small_pool);
-	spdk_free(g_iobuf.large_pool_base);
-	spdk_ring_free(g_iobuf.large_pool);
+	for (i = 0; i < g_iobuf.num_nodes; i++) {
+		iobuf_node_free(&g_iobuf.nodes[i]);
+	}
 
 	return rc;
 }
@@ -164,6 +415,8 @@ static void
 iobuf_unregister_cb(void *io_device)
 {
 	struct iobuf_module *module;
+	struct iobuf_node *node;
+	uint32_t i;
 
 	while (!TAILQ_EMPTY(&g_iobuf.modules)) {
 		module = TAILQ_FIRST(&g_iobuf.modules);
@@ -172,25 +425,21 @@ iobuf_unregister_cb(void *io_device)
 		free(module);
 	}
 
-	if (spdk_ring_count(g_iobuf.small_pool) != g_iobuf.opts.small_pool_count) {
-		SPDK_ERRLOG("small iobuf pool count is %zu, expected %"PRIu64"\n",
-			    spdk_ring_count(g_iobuf.small_pool), g_iobuf.opts.small_pool_count);
-	}
+	for (i = 0; i < g_iobuf.num_nodes; i++) {
+		node = &g_iobuf.nodes[i];
 
-	if (spdk_ring_count(g_iobuf.large_pool) != g_iobuf.opts.large_pool_count) {
-		SPDK_ERRLOG("large iobuf pool count is %zu, expected %"PRIu64"\n",
-			    spdk_ring_count(g_iobuf.large_pool), g_iobuf.opts.large_pool_count);
-	}
+		if (spdk_ring_count(node->small_pool) != node->small_pool_count) {
+			SPDK_ERRLOG("small iobuf pool count is %zu, expected %"PRIu64"\n",
+				    spdk_ring_count(node->small_pool), node->small_pool_count);
+		}
 
-	spdk_free(g_iobuf.small_pool_base);
-	g_iobuf.small_pool_base = NULL;
-	spdk_ring_free(g_iobuf.small_pool);
-	g_iobuf.small_pool = NULL;
+		if (spdk_ring_count(node->large_pool) != node->large_pool_count) {
+			SPDK_ERRLOG("large iobuf pool count is %zu, expected %"PRIu64"\n",
+				    spdk_ring_count(node->large_pool), node->large_pool_count);
+		}
 
-	spdk_free(g_iobuf.large_pool_base);
-	g_iobuf.large_pool_base = NULL;
-	spdk_ring_free(g_iobuf.large_pool);
-	g_iobuf.large_pool = NULL;
+		iobuf_node_free(node);
+	}
 
 	if (g_iobuf.finish_cb != NULL) {
 		g_iobuf.finish_cb(g_iobuf.finish_arg);
@@ -212,6 +461,245 @@ spdk_iobuf_finish(spdk_iobuf_finish_cb cb_fn, void *cb_arg)
 	spdk_io_device_unregister(&g_iobuf, iobuf_unregister_cb);
 }
 
+static int
+iobuf_node_add_chunk(struct iobuf_node *node, bool small, uint64_t count, int socket_id)
+{
+	struct spdk_iobuf_opts *opts = &g_iobuf.opts;
+	struct spdk_ring *pool = small ? node->small_pool : node->large_pool;
+	uint32_t bufsize = small ? opts->small_bufsize : opts->large_bufsize;
+	struct iobuf_pool_chunk *chunk;
+	struct spdk_iobuf_buffer *buf;
+	uint64_t i;
+
+	chunk = calloc(1, sizeof(*chunk));
+	if (chunk == NULL) {
+		return -ENOMEM;
+	}
+
+	/* This is what actually maps additional hugepages at runtime - the
+	 * allocation comes from the DPDK heap, which grabs and registers more
+	 * hugepage memory on demand (including the vtophys map) through the
+	 * memory event callbacks in env_dpdk.
+	 */
+	chunk->base = spdk_malloc(bufsize * count, IOBUF_ALIGNMENT, NULL, socket_id,
+				  SPDK_MALLOC_DMA);
+	if (chunk->base == NULL) {
+		SPDK_ERRLOG("Unable to allocate %s iobuf pool chunk\n", small ? "small" : "large");
+		free(chunk);
+		return -ENOMEM;
+	}
+
+	chunk->count = count;
+	for (i = 0; i < count; i++) {
+		buf = chunk->base + i * bufsize;
+		spdk_ring_enqueue(pool, (void **)&buf, 1, NULL);
+	}
+
+	if (small) {
+		TAILQ_INSERT_TAIL(&node->small_chunks, chunk, tailq);
+		node->small_pool_count += count;
+	} else {
+		TAILQ_INSERT_TAIL(&node->large_chunks, chunk, tailq);
+		node->large_pool_count += count;
+	}
+
+	return 0;
+}
+
+static int
+iobuf_node_grow(struct iobuf_node *node, uint64_t small_count, uint64_t large_count,
+		int socket_id)
+{
+	int rc;
+
+	if (node->small_pool_count + small_count > node->small_pool_max ||
+	    node->large_pool_count + large_count > node->large_pool_max) {
+		SPDK_ERRLOG("iobuf pool growth exceeds the configured maximum counts\n");
+		return -ENOSPC;
+	}
+
+	if (small_count > 0) {
+		rc = iobuf_node_add_chunk(node, true, small_count, socket_id);
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	if (large_count > 0) {
+		rc = iobuf_node_add_chunk(node, false, large_count, socket_id);
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+int
+spdk_iobuf_pool_grow(uint64_t small_pool_count, uint64_t large_pool_count, int32_t numa_node)
+{
+	uint64_t small_count, large_count;
+	uint32_t i;
+	int rc, socket_id;
+
+	if (!g_iobuf_is_initialized) {
+		return -ENODEV;
+	}
+
+	if (numa_node >= 0) {
+		if ((uint32_t)numa_node >= g_iobuf.num_nodes) {
+			SPDK_ERRLOG("NUMA node %" PRIi32 " has no iobuf pools\n", numa_node);
+			return -EINVAL;
+		}
+
+		socket_id = g_iobuf.num_nodes > 1 ? numa_node : SPDK_ENV_SOCKET_ID_ANY;
+		rc = iobuf_node_grow(&g_iobuf.nodes[numa_node], small_pool_count,
+				     large_pool_count, socket_id);
+		if (rc != 0) {
+			return rc;
+		}
+	} else {
+		for (i = 0; i < g_iobuf.num_nodes; i++) {
+			small_count = small_pool_count / g_iobuf.num_nodes;
+			large_count = large_pool_count / g_iobuf.num_nodes;
+			if (i == 0) {
+				/* The first node gets the remainder */
+				small_count += small_pool_count % g_iobuf.num_nodes;
+				large_count += large_pool_count % g_iobuf.num_nodes;
+			}
+
+			socket_id = g_iobuf.num_nodes > 1 ? (int)i : SPDK_ENV_SOCKET_ID_ANY;
+			rc = iobuf_node_grow(&g_iobuf.nodes[i], small_count, large_count,
+					     socket_id);
+			if (rc != 0) {
+				return rc;
+			}
+		}
+	}
+
+	g_iobuf.opts.small_pool_count += small_pool_count;
+	g_iobuf.opts.large_pool_count += large_pool_count;
+
+	return 0;
+}
+
+/* Try to pull all of a chunk's buffers out of the shared pool ring.  Buffers
+ * from other allocations that get dequeued along the way are put back.  If any
+ * of the chunk's buffers are in use (or cached by a channel), the claimed ones
+ * are returned as well and the chunk cannot be freed.
+ */
+static bool
+iobuf_chunk_claim_bufs(struct spdk_ring *pool, struct iobuf_pool_chunk *chunk, uint32_t bufsize)
+{
+	void **bufs;
+	void *buf;
+	size_t avail, i, kept = 0, claimed = 0;
+
+	avail = spdk_ring_count(pool);
+	if (avail < chunk->count) {
+		return false;
+	}
+
+	bufs = calloc(avail, sizeof(*bufs));
+	if (bufs == NULL) {
+		return false;
+	}
+
+	for (i = 0; i < avail; i++) {
+		if (spdk_ring_dequeue(pool, &buf, 1) == 0) {
+			break;
+		}
+
+		if (buf >= chunk->base &&
+		    (char *)buf < (char *)chunk->base + chunk->count * bufsize) {
+			bufs[avail - ++claimed] = buf;
+		} else {
+			bufs[kept++] = buf;
+		}
+	}
+
+	if (kept > 0) {
+		spdk_ring_enqueue(pool, bufs, kept, NULL);
+	}
+
+	if (claimed != chunk->count) {
+		spdk_ring_enqueue(pool, &bufs[avail - claimed], claimed, NULL);
+		free(bufs);
+		return false;
+	}
+
+	free(bufs);
+
+	return true;
+}
+
+static void
+iobuf_node_shrink_pool(struct iobuf_node *node, bool small, uint64_t *count)
+{
+	struct spdk_iobuf_opts *opts = &g_iobuf.opts;
+	struct spdk_ring *pool = small ? node->small_pool : node->large_pool;
+	struct iobuf_chunk_list *chunks = small ? &node->small_chunks : &node->large_chunks;
+	uint32_t bufsize = small ? opts->small_bufsize : opts->large_bufsize;
+	struct iobuf_pool_chunk *chunk, *tmp;
+
+	TAILQ_FOREACH_SAFE(chunk, chunks, tailq, tmp) {
+		if (chunk->count > *count) {
+			continue;
+		}
+
+		if (!iobuf_chunk_claim_bufs(pool, chunk, bufsize)) {
+			continue;
+		}
+
+		TAILQ_REMOVE(chunks, chunk, tailq);
+		if (small) {
+			node->small_pool_count -= chunk->count;
+			g_iobuf.opts.small_pool_count -= chunk->count;
+		} else {
+			node->large_pool_count -= chunk->count;
+			g_iobuf.opts.large_pool_count -= chunk->count;
+		}
+		*count -= chunk->count;
+		spdk_free(chunk->base);
+		free(chunk);
+	}
+}
+
+int
+spdk_iobuf_pool_shrink(uint64_t small_pool_count, uint64_t large_pool_count, int32_t numa_node)
+{
+	uint64_t small_count = small_pool_count, large_count = large_pool_count;
+	uint32_t i;
+
+	if (!g_iobuf_is_initialized) {
+		return -ENODEV;
+	}
+
+	if (numa_node >= 0) {
+		if ((uint32_t)numa_node >= g_iobuf.num_nodes) {
+			SPDK_ERRLOG("NUMA node %" PRIi32 " has no iobuf pools\n", numa_node);
+			return -EINVAL;
+		}
+
+		iobuf_node_shrink_pool(&g_iobuf.nodes[numa_node], true, &small_count);
+		iobuf_node_shrink_pool(&g_iobuf.nodes[numa_node], false, &large_count);
+	} else {
+		for (i = 0; i < g_iobuf.num_nodes; i++) {
+			iobuf_node_shrink_pool(&g_iobuf.nodes[i], true, &small_count);
+			iobuf_node_shrink_pool(&g_iobuf.nodes[i], false, &large_count);
+		}
+	}
+
+	if (small_count == small_pool_count && large_count == large_pool_count &&
+	    small_pool_count + large_pool_count > 0) {
+		/* Nothing could be freed: either the pools were never grown or
+		 * the grown buffers are in use or held in channel caches. */
+		return -EBUSY;
+	}
+
+	return 0;
+}
+
 int
 spdk_iobuf_set_opts(const struct spdk_iobuf_opts *opts)
 {
@@ -257,6 +745,11 @@ spdk_iobuf_set_opts(const struct spdk_iobuf_opts *opts)
 	SET_FIELD(large_pool_count);
 	SET_FIELD(small_bufsize);
 	SET_FIELD(large_bufsize);
+	SET_FIELD(enable_numa);
+	SET_FIELD(cache_rebalance_period_us);
+	SET_FIELD(small_pool_max_count);
+	SET_FIELD(large_pool_max_count);
+	SET_FIELD(cache_idle_reclaim_us);
 
 	g_iobuf.opts.opts_size = opts->opts_size;
 
@@ -289,15 +782,37 @@ spdk_iobuf_get_opts(struct spdk_iobuf_opts *opts, size_t opts_size)
 	SET_FIELD(large_pool_count);
 	SET_FIELD(small_bufsize);
 	SET_FIELD(large_bufsize);
+	SET_FIELD(enable_numa);
+	SET_FIELD(cache_rebalance_period_us);
+	SET_FIELD(small_pool_max_count);
+	SET_FIELD(large_pool_max_count);
+	SET_FIELD(cache_idle_reclaim_us);
 
 #undef SET_FIELD
 
 	/* Do not remove this statement, you should always update this statement when you adding a new field,
 	 * and do not forget to add the SET_FIELD statement for your added field. */
-	SPDK_STATIC_ASSERT(sizeof(struct spdk_iobuf_opts) == 32, "Incorrect size");
+	SPDK_STATIC_ASSERT(sizeof(struct spdk_iobuf_opts) == 64, "Incorrect size");
 }
 
 
+static struct iobuf_node *
+iobuf_get_local_node(void)
+{
+	uint32_t socket_id;
+
+	if (g_iobuf.num_nodes == 1) {
+		return &g_iobuf.nodes[0];
+	}
+
+	socket_id = spdk_env_get_socket_id(spdk_env_get_current_core());
+	if (socket_id == UINT32_MAX || socket_id >= g_iobuf.num_nodes) {
+		return &g_iobuf.nodes[0];
+	}
+
+	return &g_iobuf.nodes[socket_id];
+}
+
 int
 spdk_iobuf_channel_init(struct spdk_iobuf_channel *ch, const char *name,
 			uint32_t small_cache_size, uint32_t large_cache_size)
@@ -305,6 +820,7 @@ spdk_iobuf_channel_init(struct spdk_iobuf_channel *ch, const char *name,
 	struct spdk_io_channel *ioch;
 	struct iobuf_channel *iobuf_ch;
 	struct iobuf_module *module;
+	struct iobuf_node *node;
 	struct spdk_iobuf_buffer *buf;
 	uint32_t i;
 
@@ -339,10 +855,12 @@ spdk_iobuf_channel_init(struct spdk_iobuf_channel *ch, const char *name,
 		goto error;
 	}
 
+	node = iobuf_get_local_node();
+
 	ch->small.queue = &iobuf_ch->small_queue;
 	ch->large.queue = &iobuf_ch->large_queue;
-	ch->small.pool = g_iobuf.small_pool;
-	ch->large.pool = g_iobuf.large_pool;
+	ch->small.pool = node->small_pool;
+	ch->large.pool = node->large_pool;
 	ch->small.bufsize = g_iobuf.opts.small_bufsize;
 	ch->large.bufsize = g_iobuf.opts.large_bufsize;
 	ch->parent = ioch;
@@ -356,7 +874,7 @@ spdk_iobuf_channel_init(struct spdk_iobuf_channel *ch, const char *name,
 	STAILQ_INIT(&ch->large.cache);
 
 	for (i = 0; i < small_cache_size; ++i) {
-		if (spdk_ring_dequeue(g_iobuf.small_pool, (void **)&buf, 1) == 0) {
+		if (spdk_ring_dequeue(node->small_pool, (void **)&buf, 1) == 0) {
 			SPDK_ERRLOG("Failed to populate '%s' iobuf small buffer cache at %d/%d entries. "
 				    "You may need to increase spdk_iobuf_opts.small_pool_count (%"PRIu64")\n",
 				    name, i, small_cache_size, g_iobuf.opts.small_pool_count);
@@ -368,7 +886,7 @@ spdk_iobuf_channel_init(struct spdk_iobuf_channel *ch, const char *name,
 		ch->small.cache_count++;
 	}
 	for (i = 0; i < large_cache_size; ++i) {
-		if (spdk_ring_dequeue(g_iobuf.large_pool, (void **)&buf, 1) == 0) {
+		if (spdk_ring_dequeue(node->large_pool, (void **)&buf, 1) == 0) {
 			SPDK_ERRLOG("Failed to populate '%s' iobuf large buffer cache at %d/%d entries. "
 				    "You may need to increase spdk_iobuf_opts.large_pool_count (%"PRIu64")\n",
 				    name, i, large_cache_size, g_iobuf.opts.large_pool_count);
@@ -407,13 +925,13 @@ spdk_iobuf_channel_fini(struct spdk_iobuf_channel *ch)
 	while (!STAILQ_EMPTY(&ch->small.cache)) {
 		buf = STAILQ_FIRST(&ch->small.cache);
 		STAILQ_REMOVE_HEAD(&ch->small.cache, stailq);
-		spdk_ring_enqueue(g_iobuf.small_pool, (void **)&buf, 1, NULL);
+		spdk_ring_enqueue(ch->small.pool, (void **)&buf, 1, NULL);
 		ch->small.cache_count--;
 	}
 	while (!STAILQ_EMPTY(&ch->large.cache)) {
 		buf = STAILQ_FIRST(&ch->large.cache);
 		STAILQ_REMOVE_HEAD(&ch->large.cache, stailq);
-		spdk_ring_enqueue(g_iobuf.large_pool, (void **)&buf, 1, NULL);
+		spdk_ring_enqueue(ch->large.pool, (void **)&buf, 1, NULL);
 		ch->large.cache_count--;
 	}
 
@@ -514,8 +1032,6 @@ spdk_iobuf_entry_abort(struct spdk_iobuf_channel *ch, struct spdk_iobuf_entry *e
 	STAILQ_REMOVE(pool->queue, entry, spdk_iobuf_entry, stailq);
 }
 
-#define IOBUF_BATCH_SIZE 32
-
 void *
 spdk_iobuf_get(struct spdk_iobuf_channel *ch, uint64_t len,
 	       struct spdk_iobuf_entry *entry, spdk_iobuf_get_cb cb_fn)
@@ -652,9 +1168,13 @@ iobuf_get_channel_stats(struct spdk_io_channel_iter *iter)
 				it->small_pool.cache += channel->small.stats.cache;
 				it->small_pool.main += channel->small.stats.main;
 				it->small_pool.retry += channel->small.stats.retry;
+				it->small_pool.cache_count += channel->small.cache_count;
+				it->small_pool.cache_size += channel->small.cache_size;
 				it->large_pool.cache += channel->large.stats.cache;
 				it->large_pool.main += channel->large.stats.main;
 				it->large_pool.retry += channel->large.stats.retry;
+				it->large_pool.cache_count += channel->large.cache_count;
+				it->large_pool.cache_size += channel->large.cache_size;
 				break;
 			}
 		}
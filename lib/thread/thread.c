@@ -32,6 +32,9 @@
 #endif
 
 #define SPDK_MSG_BATCH_SIZE		8
+#define SPDK_MSG_MAX_BATCH_SIZE		32
+#define SPDK_MSG_SEND_BATCH_SIZE	8
+#define SPDK_MSG_SEND_BATCH_TARGETS	4
 #define SPDK_MAX_DEVICE_NAME_LEN	256
 #define SPDK_THREAD_EXIT_TIMEOUT_SEC	5
 #define SPDK_MAX_POLLER_NAME_LEN	256
@@ -39,6 +42,12 @@
 
 static struct spdk_thread *g_app_thread;
 
+/* When set, thread_execute_poller()/thread_execute_timed_poller() attribute
+ * the cycles of every busy poller run to the poller itself.  Off by default
+ * because it costs two tick reads per busy run.
+ */
+static bool g_poller_cycle_tracking = false;
+
 struct spdk_interrupt {
 	int			efd;
 	struct spdk_thread	*thread;
@@ -79,6 +88,9 @@ struct spdk_poller {
 	uint64_t			next_run_tick;
 	uint64_t			run_count;
 	uint64_t			busy_count;
+	/* Cycles spent in busy runs, accumulated only while
+	 * g_poller_cycle_tracking is enabled. */
+	uint64_t			busy_tsc;
 	uint64_t			id;
 	spdk_poller_fn			fn;
 	void				*arg;
@@ -87,6 +99,32 @@ struct spdk_poller {
 	spdk_poller_set_interrupt_mode_cb set_intr_cb_fn;
 	void				*set_intr_cb_arg;
 
+	/* Idle-backoff policy for busy-wait pollers (period_ticks == 0).  After
+	 * idle_threshold consecutive idle returns the poller is demoted to the
+	 * timed_pollers tree with backoff_period_ticks as its period, and is
+	 * promoted back to active_pollers by a busy return or spdk_poller_resume().
+	 */
+	uint64_t			backoff_period_ticks;
+	uint32_t			idle_threshold;
+	uint32_t			idle_streak;
+	bool				demoted;
+	bool				promote_pending;
+
+	/* Per-iteration work budget.  Busy return values accumulate into
+	 * budget_used; once they reach budget, the poller is skipped for one
+	 * thread_poll() iteration so its neighbors get a turn.  budget == 0
+	 * disables the policy.
+	 */
+	uint64_t			budget;
+	uint64_t			budget_used;
+	uint64_t			defer_count;
+	bool				deferred;
+
+	/* Number of times a timed poller became runnable more than a full
+	 * period late, i.e. it was starved past its deadline.
+	 */
+	uint64_t			overrun_count;
+
 	char				name[SPDK_MAX_POLLER_NAME_LEN + 1];
 };
 
@@ -103,9 +141,22 @@ enum spdk_thread_state {
 	SPDK_THREAD_STATE_EXITED,
 };
 
+/* Outgoing messages batched per target thread while the sender is inside
+ * thread_poll(), flushed with a single ring enqueue per target. */
+struct spdk_msg_send_batch {
+	struct spdk_thread	*target;
+	struct spdk_msg		*msgs[SPDK_MSG_SEND_BATCH_SIZE];
+	uint32_t		count;
+};
+
 struct spdk_thread {
 	uint64_t			tsc_last;
 	struct spdk_thread_stats	stats;
+	/* Slot index in the shared-memory stats segment, or UINT32_MAX if
+	 * no slot has been claimed yet. */
+	uint32_t			stats_slot;
+	/* Last time the poller table was republished to shared memory */
+	uint64_t			stats_publish_tsc;
 	/*
 	 * Contains pollers actively running on this thread.  Pollers
 	 *  are run round-robin. The thread takes one poller from the head
@@ -124,10 +175,20 @@ struct spdk_thread {
 	 * queues) or unregistered.
 	 */
 	TAILQ_HEAD(paused_pollers_head, spdk_poller)	paused_pollers;
+	/* Number of demoted pollers waiting to be promoted back to
+	 * active_pollers at the end of the current thread_poll() iteration.
+	 */
+	uint32_t			pending_promotions;
 	struct spdk_ring		*messages;
 	int				msg_fd;
 	SLIST_HEAD(, spdk_msg)		msg_cache;
 	size_t				msg_cache_count;
+	struct spdk_msg_send_batch	send_batch[SPDK_MSG_SEND_BATCH_TARGETS];
+	/* True while the thread is inside thread_poll(), where outgoing messages
+	 * may safely be deferred to the end of the iteration. */
+	bool				msg_batching;
+	/* Current message dequeue batch size, adapted to the observed backlog. */
+	uint32_t			msg_batch_size;
 	spdk_msg_fn			critical_msg;
 	uint64_t			id;
 	uint64_t			next_poller_id;
@@ -147,6 +208,9 @@ struct spdk_thread {
 	/* spdk_thread is bound to current CPU core. */
 	bool				is_bound;
 
+	/* Scheduling hint that this thread services latency-critical work. */
+	bool				latency_sensitive;
+
 	/* Indicates whether this spdk_thread currently runs in interrupt. */
 	bool				in_interrupt;
 	bool				poller_unregistered;
@@ -284,6 +348,15 @@ static struct spdk_mempool *g_spdk_msg_mempool = NULL;
 static TAILQ_HEAD(, spdk_thread) g_threads = TAILQ_HEAD_INITIALIZER(g_threads);
 static uint32_t g_thread_count = 0;
 
+#define THREAD_STATS_SHM_DEFAULT_MAX_THREADS	256
+/* Sentinel stats_slot value marking that the segment had no free slot left */
+#define THREAD_STATS_SLOT_NONE			(UINT32_MAX - 1)
+
+static struct spdk_thread_stats_shm *g_thread_stats_shm;
+static size_t g_thread_stats_shm_size;
+static int g_thread_stats_shm_fd = -1;
+static char g_thread_stats_shm_name[NAME_MAX];
+
 static __thread struct spdk_thread *tls_thread = NULL;
 
 SPDK_TRACE_REGISTER_FN(thread_trace, "thread", TRACE_GROUP_THREAD)
@@ -400,6 +473,10 @@ _free_thread(struct spdk_thread *thread)
 	assert(g_thread_count > 0);
 	g_thread_count--;
 	TAILQ_REMOVE(&g_threads, thread, tailq);
+	if (g_thread_stats_shm != NULL && thread->stats_slot < g_thread_stats_shm->max_threads) {
+		/* Release the shared-memory stats slot for reuse */
+		g_thread_stats_shm->threads[thread->stats_slot].id = 0;
+	}
 	pthread_mutex_unlock(&g_devlist_mutex);
 
 	msg = SLIST_FIRST(&thread->msg_cache);
@@ -462,6 +539,101 @@ spdk_thread_lib_init_ext(spdk_thread_op_fn thread_op_fn,
 	return _thread_lib_init(ctx_sz, msg_mempool_sz);
 }
 
+int
+spdk_thread_stats_shm_init(const char *shm_name, uint32_t max_threads)
+{
+	struct spdk_thread_stats_shm *shm;
+	struct spdk_thread *thread;
+	char default_name[64];
+	size_t size;
+	int rc;
+
+	if (g_thread_stats_shm != NULL) {
+		return -EEXIST;
+	}
+
+	if (max_threads == 0) {
+		max_threads = THREAD_STATS_SHM_DEFAULT_MAX_THREADS;
+	}
+
+	if (shm_name == NULL) {
+		snprintf(default_name, sizeof(default_name), "/spdk_thread_stats.pid%d",
+			 (int)getpid());
+		shm_name = default_name;
+	}
+
+	g_thread_stats_shm_fd = shm_open(shm_name, O_RDWR | O_CREAT, 0600);
+	if (g_thread_stats_shm_fd < 0) {
+		rc = -errno;
+		SPDK_ERRLOG("could not shm_open %s: %s\n", shm_name, spdk_strerror(errno));
+		return rc;
+	}
+
+	size = sizeof(*shm) + max_threads * sizeof(struct spdk_thread_shm_thread_stats);
+	if (ftruncate(g_thread_stats_shm_fd, size) != 0) {
+		rc = -errno;
+		SPDK_ERRLOG("could not truncate shm %s: %s\n", shm_name, spdk_strerror(errno));
+		goto err;
+	}
+
+	shm = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, g_thread_stats_shm_fd, 0);
+	if (shm == MAP_FAILED) {
+		rc = -errno;
+		SPDK_ERRLOG("could not mmap shm %s: %s\n", shm_name, spdk_strerror(errno));
+		goto err;
+	}
+
+	memset(shm, 0, size);
+	shm->tsc_rate = spdk_get_ticks_hz();
+	shm->max_threads = max_threads;
+	/* The version is written last, so that readers never interpret a
+	 * partially initialized segment. */
+	shm->version = SPDK_THREAD_STATS_SHM_VERSION;
+
+	snprintf(g_thread_stats_shm_name, sizeof(g_thread_stats_shm_name), "%s", shm_name);
+	g_thread_stats_shm_size = size;
+
+	/* Any threads created before the segment claim their slots on their
+	 * next poll.  Publish the segment pointer only after it is fully set
+	 * up, since polling threads check it without any locking. */
+	pthread_mutex_lock(&g_devlist_mutex);
+	TAILQ_FOREACH(thread, &g_threads, tailq) {
+		thread->stats_slot = UINT32_MAX;
+		thread->stats_publish_tsc = 0;
+	}
+	__atomic_store_n(&g_thread_stats_shm, shm, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&g_devlist_mutex);
+
+	return 0;
+
+err:
+	close(g_thread_stats_shm_fd);
+	g_thread_stats_shm_fd = -1;
+	shm_unlink(shm_name);
+	return rc;
+}
+
+void
+spdk_thread_stats_shm_fini(void)
+{
+	if (g_thread_stats_shm == NULL) {
+		return;
+	}
+
+	munmap(g_thread_stats_shm, g_thread_stats_shm_size);
+	g_thread_stats_shm = NULL;
+	close(g_thread_stats_shm_fd);
+	g_thread_stats_shm_fd = -1;
+	shm_unlink(g_thread_stats_shm_name);
+	g_thread_stats_shm_name[0] = '\0';
+}
+
+const char *
+spdk_thread_stats_shm_get_name(void)
+{
+	return g_thread_stats_shm != NULL ? g_thread_stats_shm_name : NULL;
+}
+
 void
 spdk_thread_lib_fini(void)
 {
@@ -484,6 +656,8 @@ spdk_thread_lib_fini(void)
 		spdk_mempool_free(g_spdk_msg_mempool);
 		g_spdk_msg_mempool = NULL;
 	}
+
+	spdk_thread_stats_shm_fini();
 }
 
 struct spdk_thread *
@@ -511,6 +685,8 @@ spdk_thread_create(const char *name, const struct spdk_cpuset *cpumask)
 	TAILQ_INIT(&thread->paused_pollers);
 	SLIST_INIT(&thread->msg_cache);
 	thread->msg_cache_count = 0;
+	thread->msg_batch_size = SPDK_MSG_BATCH_SIZE;
+	thread->stats_slot = UINT32_MAX;
 
 	thread->tsc_last = spdk_get_ticks();
 
@@ -619,6 +795,18 @@ spdk_thread_is_bound(struct spdk_thread *thread)
 	return thread->is_bound;
 }
 
+void
+spdk_thread_set_latency_sensitive(struct spdk_thread *thread, bool latency_sensitive)
+{
+	thread->latency_sensitive = latency_sensitive;
+}
+
+bool
+spdk_thread_is_latency_sensitive(struct spdk_thread *thread)
+{
+	return thread->latency_sensitive;
+}
+
 void
 spdk_set_thread(struct spdk_thread *thread)
 {
@@ -813,7 +1001,7 @@ static inline uint32_t
 msg_queue_run_batch(struct spdk_thread *thread, uint32_t max_msgs)
 {
 	unsigned count, i;
-	void *messages[SPDK_MSG_BATCH_SIZE];
+	void *messages[SPDK_MSG_MAX_BATCH_SIZE];
 	uint64_t notify = 1;
 	int rc;
 
@@ -827,12 +1015,23 @@ msg_queue_run_batch(struct spdk_thread *thread, uint32_t max_msgs)
 #endif
 
 	if (max_msgs > 0) {
-		max_msgs = spdk_min(max_msgs, SPDK_MSG_BATCH_SIZE);
+		max_msgs = spdk_min(max_msgs, thread->msg_batch_size);
 	} else {
-		max_msgs = SPDK_MSG_BATCH_SIZE;
+		max_msgs = thread->msg_batch_size;
 	}
 
 	count = spdk_ring_dequeue(thread->messages, messages, max_msgs);
+
+	/* Adapt the next batch size to the observed backlog: grow while full
+	 * batches keep arriving, decay back once the queue drains. */
+	if (count == max_msgs) {
+		thread->msg_batch_size = spdk_min(thread->msg_batch_size * 2,
+						  SPDK_MSG_MAX_BATCH_SIZE);
+	} else {
+		thread->msg_batch_size = spdk_max(thread->msg_batch_size / 2,
+						  SPDK_MSG_BATCH_SIZE);
+	}
+
 	if (spdk_unlikely(thread->in_interrupt) &&
 	    spdk_ring_count(thread->messages) != 0) {
 		rc = write(thread->msg_fd, &notify, sizeof(notify));
@@ -868,12 +1067,61 @@ msg_queue_run_batch(struct spdk_thread *thread, uint32_t max_msgs)
 	return count;
 }
 
+static int thread_send_msg_notification(const struct spdk_thread *target_thread);
+
+static void
+msg_send_batch_flush_slot(struct spdk_thread *thread, struct spdk_msg_send_batch *slot)
+{
+	struct spdk_thread *target = slot->target;
+	size_t rc;
+	uint32_t i;
+
+	if (slot->count == 0) {
+		return;
+	}
+
+	if (spdk_unlikely(target->state == SPDK_THREAD_STATE_EXITED)) {
+		SPDK_ERRLOG("Thread %s is marked as exited.\n", target->name);
+		for (i = 0; i < slot->count; i++) {
+			spdk_mempool_put(g_spdk_msg_mempool, slot->msgs[i]);
+		}
+	} else {
+		rc = spdk_ring_enqueue(target->messages, (void **)slot->msgs, slot->count, NULL);
+		if (spdk_unlikely(rc != slot->count)) {
+			SPDK_ERRLOG("msg could not be enqueued\n");
+			for (i = rc; i < slot->count; i++) {
+				spdk_mempool_put(g_spdk_msg_mempool, slot->msgs[i]);
+			}
+		}
+		if (slot->count > 1) {
+			thread->stats.batched_msg_sends += slot->count;
+		} else {
+			thread->stats.single_msg_sends++;
+		}
+		thread_send_msg_notification(target);
+	}
+
+	slot->target = NULL;
+	slot->count = 0;
+}
+
+static void
+msg_send_batch_flush(struct spdk_thread *thread)
+{
+	uint32_t i;
+
+	for (i = 0; i < SPDK_MSG_SEND_BATCH_TARGETS; i++) {
+		msg_send_batch_flush_slot(thread, &thread->send_batch[i]);
+	}
+}
+
 static void
 poller_insert_timer(struct spdk_thread *thread, struct spdk_poller *poller, uint64_t now)
 {
 	struct spdk_poller *tmp __attribute__((unused));
 
-	poller->next_run_tick = now + poller->period_ticks;
+	poller->next_run_tick = now + (poller->demoted ? poller->backoff_period_ticks :
+				       poller->period_ticks);
 
 	/*
 	 * Insert poller in the thread's timed_pollers tree by next scheduled run time
@@ -908,6 +1156,47 @@ poller_remove_timer(struct spdk_thread *thread, struct spdk_poller *poller)
 	}
 }
 
+static void
+poller_promote(struct spdk_thread *thread, struct spdk_poller *poller)
+{
+	assert(poller->demoted);
+
+	if (poller->promote_pending) {
+		assert(thread->pending_promotions > 0);
+		thread->pending_promotions--;
+		poller->promote_pending = false;
+	}
+
+	poller->demoted = false;
+	poller->idle_streak = 0;
+	TAILQ_INSERT_TAIL(&thread->active_pollers, poller, tailq);
+}
+
+/* Move demoted pollers with a pending spdk_poller_resume() back to the active
+ * list.  This is deferred to the end of thread_poll() because removing a tree
+ * node from within the timed poller iteration would break it.
+ */
+static void
+poller_process_promotions(struct spdk_thread *thread)
+{
+	struct spdk_poller *poller, *tmp;
+
+	RB_FOREACH_SAFE(poller, timed_pollers_tree, &thread->timed_pollers, tmp) {
+		if (poller->promote_pending) {
+			poller_remove_timer(thread, poller);
+			poller_promote(thread, poller);
+			if (thread->pending_promotions == 0) {
+				break;
+			}
+		}
+	}
+
+	/* Any remaining count belongs to pollers that were paused or freed
+	 * after their promotion was requested and hence left the tree.
+	 */
+	thread->pending_promotions = 0;
+}
+
 static void
 thread_insert_poller(struct spdk_thread *thread, struct spdk_poller *poller)
 {
@@ -918,6 +1207,96 @@ thread_insert_poller(struct spdk_thread *thread, struct spdk_poller *poller)
 	}
 }
 
+static void
+thread_stats_shm_claim_slot(struct spdk_thread *thread)
+{
+	struct spdk_thread_stats_shm *shm = g_thread_stats_shm;
+	struct spdk_thread_shm_thread_stats *slot;
+	uint64_t i;
+
+	pthread_mutex_lock(&g_devlist_mutex);
+	for (i = 0; i < shm->max_threads; i++) {
+		slot = &shm->threads[i];
+		if (slot->id == 0) {
+			memset(slot, 0, sizeof(*slot));
+			snprintf(slot->name, sizeof(slot->name), "%s", thread->name);
+			slot->id = thread->id;
+			thread->stats_slot = i;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&g_devlist_mutex);
+
+	if (i == shm->max_threads) {
+		SPDK_WARNLOG("No free slot in the stats shm segment for thread %s\n",
+			     thread->name);
+		thread->stats_slot = THREAD_STATS_SLOT_NONE;
+	}
+}
+
+static void
+thread_stats_shm_publish_poller(struct spdk_thread_shm_thread_stats *slot,
+				struct spdk_poller *poller, uint64_t *num)
+{
+	struct spdk_thread_shm_poller_stats *pslot;
+
+	if (*num < SPDK_THREAD_STATS_SHM_MAX_POLLERS) {
+		pslot = &slot->pollers[*num];
+		snprintf(pslot->name, sizeof(pslot->name), "%s", poller->name);
+		pslot->id = poller->id;
+		pslot->period_ticks = poller->period_ticks;
+		pslot->run_count = poller->run_count;
+		pslot->busy_count = poller->busy_count;
+		pslot->busy_tsc = poller->busy_tsc;
+		(*num)++;
+	}
+}
+
+static void
+thread_stats_shm_publish(struct spdk_thread *thread, uint64_t now)
+{
+	struct spdk_thread_stats_shm *shm = g_thread_stats_shm;
+	struct spdk_thread_shm_thread_stats *slot;
+	struct spdk_poller *poller;
+	uint64_t num = 0, seq;
+
+	if (spdk_unlikely(thread->stats_slot == UINT32_MAX)) {
+		thread_stats_shm_claim_slot(thread);
+	}
+
+	if (thread->stats_slot >= shm->max_threads) {
+		return;
+	}
+
+	slot = &shm->threads[thread->stats_slot];
+	slot->busy_tsc = thread->stats.busy_tsc;
+	slot->idle_tsc = thread->stats.idle_tsc;
+
+	/* The poller table changes rarely and is comparatively large, so it is
+	 * republished at most once per second. */
+	if (now - thread->stats_publish_tsc < shm->tsc_rate) {
+		return;
+	}
+	thread->stats_publish_tsc = now;
+
+	/* Mark the table as inconsistent while it is rewritten */
+	seq = slot->poller_seq + 1;
+	__atomic_store_n(&slot->poller_seq, seq, __ATOMIC_RELEASE);
+
+	TAILQ_FOREACH(poller, &thread->active_pollers, tailq) {
+		thread_stats_shm_publish_poller(slot, poller, &num);
+	}
+	RB_FOREACH(poller, timed_pollers_tree, &thread->timed_pollers) {
+		thread_stats_shm_publish_poller(slot, poller, &num);
+	}
+	TAILQ_FOREACH(poller, &thread->paused_pollers, tailq) {
+		thread_stats_shm_publish_poller(slot, poller, &num);
+	}
+	slot->num_pollers = num;
+
+	__atomic_store_n(&slot->poller_seq, seq + 1, __ATOMIC_RELEASE);
+}
+
 static inline void
 thread_update_stats(struct spdk_thread *thread, uint64_t end,
 		    uint64_t start, int rc)
@@ -931,11 +1310,16 @@ thread_update_stats(struct spdk_thread *thread, uint64_t end,
 	}
 	/* Store end time to use it as start time of the next spdk_thread_poll(). */
 	thread->tsc_last = end;
+
+	if (spdk_unlikely(g_thread_stats_shm != NULL)) {
+		thread_stats_shm_publish(thread, end);
+	}
 }
 
 static inline int
 thread_execute_poller(struct spdk_thread *thread, struct spdk_poller *poller)
 {
+	uint64_t start_tsc = 0;
 	int rc;
 
 	switch (poller->state) {
@@ -955,6 +1339,18 @@ thread_execute_poller(struct spdk_thread *thread, struct spdk_poller *poller)
 		break;
 	}
 
+	if (spdk_unlikely(poller->deferred)) {
+		/* The poller exhausted its budget last iteration; skip it once
+		 * so the rest of the active list gets a turn.
+		 */
+		poller->deferred = false;
+		return 0;
+	}
+
+	if (spdk_unlikely(g_poller_cycle_tracking)) {
+		start_tsc = spdk_get_ticks();
+	}
+
 	poller->state = SPDK_POLLER_STATE_RUNNING;
 	rc = poller->fn(poller->arg);
 
@@ -963,6 +1359,19 @@ thread_execute_poller(struct spdk_thread *thread, struct spdk_poller *poller)
 	poller->run_count++;
 	if (rc > 0) {
 		poller->busy_count++;
+		thread->stats.busy_poller_runs++;
+		if (spdk_unlikely(g_poller_cycle_tracking)) {
+			poller->busy_tsc += spdk_get_ticks() - start_tsc;
+		}
+		if (spdk_unlikely(poller->budget > 0)) {
+			poller->budget_used += (uint64_t)rc;
+			if (poller->budget_used >= poller->budget) {
+				poller->budget_used = 0;
+				poller->deferred = true;
+				poller->defer_count++;
+				thread->stats.poller_deferrals++;
+			}
+		}
 	}
 
 #ifdef DEBUG
@@ -986,6 +1395,15 @@ thread_execute_poller(struct spdk_thread *thread, struct spdk_poller *poller)
 		break;
 	case SPDK_POLLER_STATE_RUNNING:
 		poller->state = SPDK_POLLER_STATE_WAITING;
+		if (spdk_unlikely(poller->backoff_period_ticks > 0)) {
+			if (rc > 0) {
+				poller->idle_streak = 0;
+			} else if (++poller->idle_streak >= poller->idle_threshold) {
+				TAILQ_REMOVE(&thread->active_pollers, poller, tailq);
+				poller->demoted = true;
+				poller_insert_timer(thread, poller, spdk_get_ticks());
+			}
+		}
 		break;
 	default:
 		assert(false);
@@ -999,6 +1417,7 @@ static inline int
 thread_execute_timed_poller(struct spdk_thread *thread, struct spdk_poller *poller,
 			    uint64_t now)
 {
+	uint64_t start_tsc = 0;
 	int rc;
 
 	switch (poller->state) {
@@ -1008,6 +1427,7 @@ thread_execute_timed_poller(struct spdk_thread *thread, struct spdk_poller *poll
 	case SPDK_POLLER_STATE_PAUSING:
 		TAILQ_INSERT_TAIL(&thread->paused_pollers, poller, tailq);
 		poller->state = SPDK_POLLER_STATE_PAUSED;
+		poller->promote_pending = false;
 		return 0;
 	case SPDK_POLLER_STATE_WAITING:
 		break;
@@ -1016,6 +1436,10 @@ thread_execute_timed_poller(struct spdk_thread *thread, struct spdk_poller *poll
 		break;
 	}
 
+	if (spdk_unlikely(g_poller_cycle_tracking)) {
+		start_tsc = spdk_get_ticks();
+	}
+
 	poller->state = SPDK_POLLER_STATE_RUNNING;
 	rc = poller->fn(poller->arg);
 
@@ -1024,6 +1448,10 @@ thread_execute_timed_poller(struct spdk_thread *thread, struct spdk_poller *poll
 	poller->run_count++;
 	if (rc > 0) {
 		poller->busy_count++;
+		thread->stats.busy_poller_runs++;
+		if (spdk_unlikely(g_poller_cycle_tracking)) {
+			poller->busy_tsc += spdk_get_ticks() - start_tsc;
+		}
 	}
 
 #ifdef DEBUG
@@ -1039,6 +1467,7 @@ thread_execute_timed_poller(struct spdk_thread *thread, struct spdk_poller *poll
 	case SPDK_POLLER_STATE_PAUSING:
 		TAILQ_INSERT_TAIL(&thread->paused_pollers, poller, tailq);
 		poller->state = SPDK_POLLER_STATE_PAUSED;
+		poller->promote_pending = false;
 		break;
 	case SPDK_POLLER_STATE_PAUSED:
 		break;
@@ -1046,7 +1475,11 @@ thread_execute_timed_poller(struct spdk_thread *thread, struct spdk_poller *poll
 		poller->state = SPDK_POLLER_STATE_WAITING;
 	/* fallthrough */
 	case SPDK_POLLER_STATE_WAITING:
-		poller_insert_timer(thread, poller, now);
+		if (spdk_unlikely(poller->demoted && (rc > 0 || poller->promote_pending))) {
+			poller_promote(thread, poller);
+		} else {
+			poller_insert_timer(thread, poller, now);
+		}
 		break;
 	default:
 		assert(false);
@@ -1065,6 +1498,7 @@ thread_poll(struct spdk_thread *thread, uint32_t max_msgs, uint64_t now)
 	int rc = 0;
 
 	thread->tsc_last = now;
+	thread->msg_batching = true;
 
 	critical_msg = thread->critical_msg;
 	if (spdk_unlikely(critical_msg != NULL)) {
@@ -1107,6 +1541,17 @@ thread_poll(struct spdk_thread *thread, uint32_t max_msgs, uint64_t now)
 			thread->first_timed_poller = tmp;
 		}
 
+		/* Detect starvation: the poller was due more than a full period
+		 * ago, so at least one deadline was missed before we got here.
+		 * Demoted busy-wait pollers are excluded since their backoff
+		 * period is a heuristic, not a deadline.
+		 */
+		if (spdk_unlikely(poller->period_ticks > 0 && !poller->demoted &&
+				  now > poller->next_run_tick + poller->period_ticks)) {
+			poller->overrun_count++;
+			thread->stats.poller_overruns++;
+		}
+
 		timer_rc = thread_execute_timed_poller(thread, poller, now);
 		if (timer_rc > rc) {
 			rc = timer_rc;
@@ -1115,6 +1560,13 @@ thread_poll(struct spdk_thread *thread, uint32_t max_msgs, uint64_t now)
 		poller = tmp;
 	}
 
+	if (spdk_unlikely(thread->pending_promotions > 0)) {
+		poller_process_promotions(thread);
+	}
+
+	msg_send_batch_flush(thread);
+	thread->msg_batching = false;
+
 	return rc;
 }
 
@@ -1388,6 +1840,41 @@ spdk_thread_send_msg(const struct spdk_thread *thread, spdk_msg_fn fn, void *ctx
 	msg->fn = fn;
 	msg->arg = ctx;
 
+	if (local_thread != NULL && local_thread->msg_batching) {
+		struct spdk_msg_send_batch *slot = NULL;
+		uint32_t i;
+
+		for (i = 0; i < SPDK_MSG_SEND_BATCH_TARGETS; i++) {
+			if (local_thread->send_batch[i].target == thread) {
+				slot = &local_thread->send_batch[i];
+				break;
+			}
+		}
+		if (slot == NULL) {
+			for (i = 0; i < SPDK_MSG_SEND_BATCH_TARGETS; i++) {
+				if (local_thread->send_batch[i].target == NULL) {
+					slot = &local_thread->send_batch[i];
+					slot->target = (struct spdk_thread *)thread;
+					break;
+				}
+			}
+		}
+
+		if (slot != NULL) {
+			slot->msgs[slot->count++] = msg;
+			if (slot->count == SPDK_MSG_SEND_BATCH_SIZE) {
+				msg_send_batch_flush_slot(local_thread, slot);
+			}
+
+			/* The message is enqueued, and the target notified, no later
+			 * than the end of the current poll iteration. */
+			return 0;
+		}
+
+		/* All slots are tracking other targets - fall through and send
+		 * this message directly. */
+	}
+
 	rc = spdk_ring_enqueue(thread->messages, (void **)&msg, 1, NULL);
 	if (rc != 1) {
 		SPDK_ERRLOG("msg could not be enqueued\n");
@@ -1395,6 +1882,10 @@ spdk_thread_send_msg(const struct spdk_thread *thread, spdk_msg_fn fn, void *ctx
 		return -EIO;
 	}
 
+	if (local_thread != NULL) {
+		local_thread->stats.single_msg_sends++;
+	}
+
 	return thread_send_msg_notification(thread);
 }
 
@@ -1870,6 +2361,8 @@ spdk_poller_resume(struct spdk_poller *poller)
 	switch (poller->state) {
 	case SPDK_POLLER_STATE_PAUSED:
 		TAILQ_REMOVE(&thread->paused_pollers, poller, tailq);
+		poller->demoted = false;
+		poller->idle_streak = 0;
 		thread_insert_poller(thread, poller);
 	/* fallthrough */
 	case SPDK_POLLER_STATE_PAUSING:
@@ -1877,6 +2370,15 @@ spdk_poller_resume(struct spdk_poller *poller)
 		break;
 	case SPDK_POLLER_STATE_RUNNING:
 	case SPDK_POLLER_STATE_WAITING:
+		/* A demoted poller is sitting in the timed poller tree waiting
+		 * out its backoff period.  Resuming it is the signal that there
+		 * is work again, so promote it at the end of the current
+		 * thread_poll() iteration.
+		 */
+		if (poller->demoted && !poller->promote_pending) {
+			poller->promote_pending = true;
+			thread->pending_promotions++;
+		}
 		break;
 	default:
 		assert(false);
@@ -1884,6 +2386,71 @@ spdk_poller_resume(struct spdk_poller *poller)
 	}
 }
 
+void
+spdk_poller_set_idle_backoff(struct spdk_poller *poller, uint32_t idle_threshold,
+			     uint64_t backoff_period_microseconds)
+{
+	struct spdk_thread *thread;
+
+	thread = spdk_get_thread();
+	if (!thread) {
+		assert(false);
+		return;
+	}
+
+	if (poller->thread != thread) {
+		wrong_thread(__func__, poller->name, poller->thread, thread);
+		return;
+	}
+
+	if (poller->period_ticks != 0) {
+		SPDK_ERRLOG("Poller %s already has a period, cannot set idle backoff\n",
+			    poller->name);
+		return;
+	}
+
+	if (backoff_period_microseconds == 0 || idle_threshold == 0) {
+		/* Disable the policy.  If the poller is currently demoted, get
+		 * it back onto the active list.
+		 */
+		poller->backoff_period_ticks = 0;
+		poller->idle_threshold = 0;
+		poller->idle_streak = 0;
+		if (poller->demoted && !poller->promote_pending) {
+			poller->promote_pending = true;
+			thread->pending_promotions++;
+		}
+		return;
+	}
+
+	poller->backoff_period_ticks = convert_us_to_ticks(backoff_period_microseconds);
+	poller->idle_threshold = idle_threshold;
+	poller->idle_streak = 0;
+}
+
+void
+spdk_poller_set_budget(struct spdk_poller *poller, uint64_t budget)
+{
+	struct spdk_thread *thread;
+
+	thread = spdk_get_thread();
+	if (!thread) {
+		assert(false);
+		return;
+	}
+
+	if (poller->thread != thread) {
+		wrong_thread(__func__, poller->name, poller->thread, thread);
+		return;
+	}
+
+	poller->budget = budget;
+	poller->budget_used = 0;
+	if (budget == 0) {
+		poller->deferred = false;
+	}
+}
+
 const char *
 spdk_poller_get_name(struct spdk_poller *poller)
 {
@@ -1926,6 +2493,24 @@ spdk_poller_get_stats(struct spdk_poller *poller, struct spdk_poller_stats *stat
 {
 	stats->run_count = poller->run_count;
 	stats->busy_count = poller->busy_count;
+	stats->busy_tsc = poller->busy_tsc;
+	stats->defer_count = poller->defer_count;
+	stats->overrun_count = poller->overrun_count;
+}
+
+void
+spdk_thread_enable_poller_cycle_tracking(bool enabled)
+{
+	/* Read by all threads without synchronization; observing the update
+	 * late only delays when cycles start or stop being accumulated.
+	 */
+	g_poller_cycle_tracking = enabled;
+}
+
+bool
+spdk_thread_poller_cycle_tracking_enabled(void)
+{
+	return g_poller_cycle_tracking;
 }
 
 struct spdk_poller *
@@ -2509,6 +3094,14 @@ struct spdk_io_channel_iter {
 
 	struct spdk_thread *orig_thread;
 	spdk_channel_for_each_cpl cpl;
+
+	/* Parallel fan-out state.  The parent iterator counts outstanding child
+	 * iterators in remaining; each child points back at its parent and is
+	 * chained through next until it is dispatched to its thread.
+	 */
+	struct spdk_io_channel_iter *parent;
+	struct spdk_io_channel_iter *next;
+	uint32_t remaining;
 };
 
 void *
@@ -2627,6 +3220,109 @@ end:
 	assert(rc == 0);
 }
 
+void
+spdk_for_each_channel_parallel(void *io_device, spdk_channel_msg fn, void *ctx,
+			       spdk_channel_for_each_cpl cpl)
+{
+	struct spdk_thread *thread;
+	struct spdk_io_channel *ch;
+	struct spdk_io_channel_iter *i, *child, *children = NULL;
+	uint32_t count = 0;
+	int rc __attribute__((unused));
+
+	i = calloc(1, sizeof(*i));
+	if (!i) {
+		SPDK_ERRLOG("Unable to allocate iterator\n");
+		assert(false);
+		return;
+	}
+
+	i->io_device = io_device;
+	i->fn = fn;
+	i->ctx = ctx;
+	i->cpl = cpl;
+	i->orig_thread = _get_thread();
+
+	i->orig_thread->for_each_count++;
+
+	pthread_mutex_lock(&g_devlist_mutex);
+	i->dev = io_device_get(io_device);
+	if (i->dev == NULL) {
+		SPDK_ERRLOG("could not find io_device %p\n", io_device);
+		assert(false);
+		i->status = -ENODEV;
+		goto end;
+	}
+
+	/* Do not allow new for_each operations if we are already waiting to unregister
+	 * the device for other for_each operations to complete.
+	 */
+	if (i->dev->pending_unregister) {
+		SPDK_ERRLOG("io_device %p has a pending unregister\n", io_device);
+		i->status = -ENODEV;
+		goto end;
+	}
+
+	/* Build one child iterator per channel while holding g_devlist_mutex, so
+	 * that the set of visited channels is a consistent snapshot.  The children
+	 * are dispatched only after i->remaining is final.
+	 */
+	TAILQ_FOREACH(thread, &g_threads, tailq) {
+		ch = thread_get_io_channel(thread, i->dev);
+		if (ch == NULL) {
+			continue;
+		}
+
+		child = calloc(1, sizeof(*child));
+		if (!child) {
+			SPDK_ERRLOG("Unable to allocate child iterator\n");
+			assert(false);
+			while (children != NULL) {
+				child = children;
+				children = child->next;
+				free(child);
+			}
+			i->status = -ENOMEM;
+			goto end;
+		}
+
+		child->io_device = io_device;
+		child->dev = i->dev;
+		child->fn = fn;
+		child->ctx = ctx;
+		child->ch = ch;
+		child->cur_thread = thread;
+		child->parent = i;
+		child->next = children;
+		children = child;
+		count++;
+	}
+
+	if (count == 0) {
+		goto end;
+	}
+
+	i->remaining = count;
+	i->dev->for_each_count++;
+	pthread_mutex_unlock(&g_devlist_mutex);
+
+	while (children != NULL) {
+		child = children;
+		children = child->next;
+		child->next = NULL;
+		rc = spdk_thread_send_msg(child->cur_thread, _call_channel, child);
+		assert(rc == 0);
+	}
+
+	return;
+
+end:
+	pthread_mutex_unlock(&g_devlist_mutex);
+
+	rc = spdk_thread_send_msg(i->orig_thread, _call_completion, i);
+	assert(rc == 0);
+}
+
 static void
 __pending_unregister(void *arg)
 {
@@ -2637,6 +3333,42 @@ __pending_unregister(void *arg)
 	spdk_io_device_unregister(dev->io_device, dev->unregister_cb);
 }
 
+static void
+for_each_channel_parallel_done(struct spdk_io_channel_iter *child, int status)
+{
+	struct spdk_io_channel_iter *i = child->parent;
+	struct io_device *dev;
+	int rc __attribute__((unused));
+
+	free(child);
+
+	if (status != 0) {
+		/* Children complete concurrently, so if several of them fail the
+		 * completion callback sees one of the failing statuses.
+		 */
+		__atomic_store_n(&i->status, status, __ATOMIC_RELAXED);
+	}
+
+	if (__atomic_sub_fetch(&i->remaining, 1, __ATOMIC_ACQ_REL) > 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&g_devlist_mutex);
+	dev = i->dev;
+	dev->for_each_count--;
+	pthread_mutex_unlock(&g_devlist_mutex);
+
+	rc = spdk_thread_send_msg(i->orig_thread, _call_completion, i);
+	assert(rc == 0);
+
+	pthread_mutex_lock(&g_devlist_mutex);
+	if (dev->pending_unregister && dev->for_each_count == 0) {
+		rc = spdk_thread_send_msg(dev->unregister_thread, __pending_unregister, dev);
+		assert(rc == 0);
+	}
+	pthread_mutex_unlock(&g_devlist_mutex);
+}
+
 void
 spdk_for_each_channel_continue(struct spdk_io_channel_iter *i, int status)
 {
@@ -2647,6 +3379,11 @@ spdk_for_each_channel_continue(struct spdk_io_channel_iter *i, int status)
 
 	assert(i->cur_thread == spdk_get_thread());
 
+	if (i->parent != NULL) {
+		for_each_channel_parallel_done(i, status);
+		return;
+	}
+
 	i->status = status;
 
 	pthread_mutex_lock(&g_devlist_mutex);
@@ -49,7 +49,7 @@ _spdk_trace_record(uint64_t tsc, uint16_t tpoint_id, uint16_t owner_id, uint32_t
 	struct spdk_trace_tpoint *tpoint;
 	struct spdk_trace_argument *argument;
 	unsigned lcore, i, offset, num_entries, arglen, argoff, curlen;
-	uint64_t intval;
+	uint64_t intval, sample_rate;
 	void *argval;
 	va_list vl;
 
@@ -68,6 +68,15 @@ _spdk_trace_record(uint64_t tsc, uint16_t tpoint_id, uint16_t owner_id, uint32_t
 
 	lcore_history->tpoint_count[tpoint_id]++;
 
+	/* When a sampling rate is set for this tpoint group, only record every Nth
+	 * occurrence. tpoint_count above still counts every occurrence.
+	 */
+	sample_rate = g_trace_file->sample_rate[tpoint_id >> 6];
+	if (spdk_unlikely(sample_rate > 1) &&
+	    lcore_history->sample_count[tpoint_id >> 6]++ % sample_rate != 0) {
+		return;
+	}
+
 	tpoint = &g_trace_file->tpoint[tpoint_id];
 	/* Make sure that the number of arguments passed matches tracepoint definition */
 	if (spdk_unlikely(tpoint->num_args != num_args)) {
@@ -119,6 +119,37 @@ spdk_trace_clear_tpoint_group_mask(uint64_t tpoint_group_mask)
 	}
 }
 
+uint64_t
+spdk_trace_get_sample_rate(uint32_t group_id)
+{
+	if (group_id >= SPDK_TRACE_MAX_GROUP_ID) {
+		SPDK_ERRLOG("invalid group ID %d\n", group_id);
+		return 0ULL;
+	}
+
+	if (g_trace_file == NULL) {
+		return 0ULL;
+	}
+
+	return g_trace_file->sample_rate[group_id];
+}
+
+void
+spdk_trace_set_sample_rate(uint32_t group_id, uint64_t rate)
+{
+	if (g_trace_file == NULL) {
+		SPDK_ERRLOG("trace is not initialized\n");
+		return;
+	}
+
+	if (group_id >= SPDK_TRACE_MAX_GROUP_ID) {
+		SPDK_ERRLOG("invalid group ID %d\n", group_id);
+		return;
+	}
+
+	g_trace_file->sample_rate[group_id] = rate;
+}
+
 struct spdk_trace_register_fn *
 spdk_trace_get_first_register_fn(void)
 {
@@ -99,6 +99,59 @@ invalid:
 SPDK_RPC_REGISTER("trace_clear_tpoint_mask", rpc_trace_clear_tpoint_mask,
 		  SPDK_RPC_STARTUP | SPDK_RPC_RUNTIME)
 
+struct rpc_tpoint_sample_rate {
+	char *name;
+	uint64_t rate;
+};
+
+static void
+free_rpc_tpoint_sample_rate(struct rpc_tpoint_sample_rate *p)
+{
+	free(p->name);
+}
+
+static const struct spdk_json_object_decoder rpc_tpoint_sample_rate_decoders[] = {
+	{"name", offsetof(struct rpc_tpoint_sample_rate, name), spdk_json_decode_string},
+	{"rate", offsetof(struct rpc_tpoint_sample_rate, rate), spdk_json_decode_uint64},
+};
+
+static void
+rpc_trace_set_tpoint_sample_rate(struct spdk_jsonrpc_request *request,
+				 const struct spdk_json_val *params)
+{
+	struct rpc_tpoint_sample_rate req = {};
+	uint64_t tpoint_group_mask = 0;
+
+	if (spdk_json_decode_object(params, rpc_tpoint_sample_rate_decoders,
+				    SPDK_COUNTOF(rpc_tpoint_sample_rate_decoders), &req)) {
+		SPDK_DEBUGLOG(trace, "spdk_json_decode_object failed\n");
+		goto invalid;
+	}
+
+	if (req.name == NULL) {
+		SPDK_DEBUGLOG(trace, "flag was NULL\n");
+		goto invalid;
+	}
+
+	tpoint_group_mask = spdk_trace_create_tpoint_group_mask(req.name);
+	if (tpoint_group_mask == 0) {
+		goto invalid;
+	}
+
+	spdk_trace_set_sample_rate(spdk_u64log2(tpoint_group_mask), req.rate);
+
+	free_rpc_tpoint_sample_rate(&req);
+
+	spdk_jsonrpc_send_bool_response(request, true);
+	return;
+
+invalid:
+	spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS, "Invalid parameters");
+	free_rpc_tpoint_sample_rate(&req);
+}
+SPDK_RPC_REGISTER("trace_set_tpoint_sample_rate", rpc_trace_set_tpoint_sample_rate,
+		  SPDK_RPC_STARTUP | SPDK_RPC_RUNTIME)
+
 static const struct spdk_json_object_decoder rpc_tpoint_group_decoders[] = {
 	{"name", offsetof(struct rpc_tpoint_group, name), spdk_json_decode_string},
 };
@@ -251,6 +304,8 @@ rpc_trace_get_info(struct spdk_jsonrpc_request *request,
 		spdk_json_write_named_string(w, "mask", mask_str);
 		snprintf(tpoint_mask_str, sizeof(tpoint_mask_str), "0x%lx", tpoint_mask);
 		spdk_json_write_named_string(w, "tpoint_mask", tpoint_mask_str);
+		spdk_json_write_named_uint64(w, "sample_rate",
+					     spdk_trace_get_sample_rate(register_fn->tgroup_id));
 		spdk_json_write_object_end(w);
 
 		register_fn = spdk_trace_get_next_register_fn(register_fn);
@@ -12,27 +12,27 @@
 #include <exception>
 #include <map>
 #include <new>
-
-struct entry_key {
-	entry_key(uint16_t _lcore, uint64_t _tsc) : lcore(_lcore), tsc(_tsc) {}
-	uint16_t lcore;
-	uint64_t tsc;
-};
-
-class compare_entry_key
-{
-public:
-	bool operator()(const entry_key &first, const entry_key &second) const
-	{
-		if (first.tsc == second.tsc) {
-			return first.lcore < second.lcore;
-		} else {
-			return first.tsc < second.tsc;
-		}
-	}
+#include <queue>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+/* Entries recorded on a single lcore, in tsc order.  Entries within an lcore's history are
+ * already sorted, since they were appended to the ring in the order they were recorded, so
+ * each history can be turned into one of these streams independently (and in parallel) and
+ * the global tsc order is recovered with a k-way merge across the streams.
+ */
+struct lcore_entries {
+	std::vector<spdk_trace_entry *>	entries;
+	size_t				pos = 0;
+	uint16_t			lcore = 0;
+	uint64_t			first_tsc = 0;
 };
 
-typedef std::map<entry_key, spdk_trace_entry *, compare_entry_key> entry_map;
+/* Head of each stream, ordered by (tsc, lcore, stream index) */
+typedef std::tuple<uint64_t, uint16_t, size_t> entry_heap_key;
+typedef std::priority_queue<entry_heap_key, std::vector<entry_heap_key>,
+	std::greater<entry_heap_key>> entry_heap;
 
 struct argument_context {
 	spdk_trace_entry	*entry;
@@ -74,17 +74,21 @@ private:
 	spdk_trace_entry_buffer *get_next_buffer(spdk_trace_entry_buffer *buf, uint16_t lcore);
 	bool build_arg(argument_context *argctx, const spdk_trace_argument *arg, int argid,
 		       spdk_trace_parser_entry *pe);
-	void populate_events(spdk_trace_history *history, int num_entries);
+	void populate_events(spdk_trace_history *history, int num_entries, lcore_entries *stream);
+	const uint64_t *index_samples(uint16_t lcore, uint64_t *num_samples) const;
 	bool init(const spdk_trace_parser_opts *opts);
 	void cleanup();
 
-	spdk_trace_file		*_trace_file;
-	size_t			_map_size;
-	int			_fd;
-	uint64_t		_tsc_offset;
-	entry_map		_entries;
-	entry_map::iterator	_iter;
-	object_stats		_stats[SPDK_TRACE_MAX_OBJECT];
+	spdk_trace_file			*_trace_file;
+	const spdk_trace_index_footer	*_index;
+	size_t				_map_size;
+	int				_fd;
+	uint64_t			_tsc_offset;
+	uint64_t			_tsc_start;
+	uint64_t			_tsc_end;
+	std::vector<lcore_entries>	_streams;
+	entry_heap			_heap;
+	object_stats			_stats[SPDK_TRACE_MAX_OBJECT];
 };
 
 uint64_t
@@ -164,12 +168,19 @@ spdk_trace_parser::next_entry(spdk_trace_parser_entry *pe)
 	object_stats *stats;
 	std::map<uint64_t, uint64_t>::iterator related_kv;
 
-	if (_iter == _entries.end()) {
+	if (_heap.empty()) {
 		return false;
 	}
 
-	pe->entry = entry = _iter->second;
-	pe->lcore = _iter->first.lcore;
+	const entry_heap_key key = _heap.top();
+	lcore_entries &stream = _streams[std::get<2>(key)];
+
+	_heap.pop();
+	pe->entry = entry = stream.entries[stream.pos++];
+	pe->lcore = stream.lcore;
+	if (stream.pos < stream.entries.size()) {
+		_heap.emplace(stream.entries[stream.pos]->tsc, stream.lcore, std::get<2>(key));
+	}
 	/* Set related index to the max value to indicate "empty" state */
 	pe->related_index = UINT64_MAX;
 	pe->related_type = OBJECT_NONE;
@@ -218,19 +229,34 @@ spdk_trace_parser::next_entry(spdk_trace_parser_entry *pe)
 		}
 	}
 
-	_iter++;
 	return true;
 }
 
+const uint64_t *
+spdk_trace_parser::index_samples(uint16_t lcore, uint64_t *num_samples) const
+{
+	if (_index == NULL || _index->lcores[lcore].num_samples == 0) {
+		return NULL;
+	}
+
+	*num_samples = _index->lcores[lcore].num_samples;
+	return reinterpret_cast<const uint64_t *>(reinterpret_cast<const uint8_t *>(_index) +
+			_index->lcores[lcore].sample_offset);
+}
+
 void
-spdk_trace_parser::populate_events(spdk_trace_history *history, int num_entries)
+spdk_trace_parser::populate_events(spdk_trace_history *history, int num_entries,
+				   lcore_entries *stream)
 {
 	int i, num_entries_filled;
 	spdk_trace_entry *e;
 	int first, last, lcore;
+	const uint64_t *samples;
+	uint64_t num_samples, sample;
 
 	lcore = history->lcore;
 	e = history->entries;
+	stream->lcore = lcore;
 
 	num_entries_filled = num_entries;
 	while (e[num_entries_filled - 1].tsc == 0) {
@@ -258,14 +284,31 @@ spdk_trace_parser::populate_events(spdk_trace_history *history, int num_entries)
 	 *  other reactors.  This will ensure we only print data for the
 	 *  subset of time where we have data across all reactors.
 	 */
-	if (e[first].tsc > _tsc_offset) {
-		_tsc_offset = e[first].tsc;
-	}
+	stream->first_tsc = e[first].tsc;
 
 	i = first;
+	/* When seeking to a time range in a file with an index footer, jump to the last sample
+	 * preceding tsc_start instead of scanning up to it.  The samples are counted from entry
+	 * 0 onward, so this is only valid when the ring hasn't wrapped.
+	 */
+	if (_tsc_start != 0 && first == 0) {
+		samples = index_samples(lcore, &num_samples);
+		if (samples != NULL) {
+			for (sample = 0; sample + 1 < num_samples; sample++) {
+				if (samples[sample + 1] >= _tsc_start) {
+					break;
+				}
+			}
+			i = spdk_min(sample * _index->stride, (uint64_t)last);
+		}
+	}
+
 	while (1) {
-		if (e[i].tpoint_id != SPDK_TRACE_MAX_TPOINT_ID) {
-			_entries[entry_key(lcore, e[i].tsc)] = &e[i];
+		if (e[i].tsc > _tsc_end) {
+			break;
+		}
+		if (e[i].tpoint_id != SPDK_TRACE_MAX_TPOINT_ID && e[i].tsc >= _tsc_start) {
+			stream->entries.push_back(&e[i]);
 		}
 		if (i == last) {
 			break;
@@ -281,9 +324,16 @@ bool
 spdk_trace_parser::init(const spdk_trace_parser_opts *opts)
 {
 	spdk_trace_history *history;
+	const spdk_trace_index_footer *index;
+	std::vector<spdk_trace_history *> histories;
+	std::vector<std::thread> threads;
+	size_t file_size, stream;
 	struct stat st;
 	int rc, i;
 
+	_tsc_start = opts->tsc_start;
+	_tsc_end = opts->tsc_end != 0 ? opts->tsc_end : UINT64_MAX;
+
 	switch (opts->mode) {
 	case SPDK_TRACE_PARSER_MODE_FILE:
 		_fd = open(opts->filename, O_RDONLY);
@@ -322,14 +372,15 @@ spdk_trace_parser::init(const spdk_trace_parser_opts *opts)
 		return false;
 	}
 
-	/* Remap the entire trace file */
-	_map_size = spdk_get_trace_file_size(_trace_file);
+	/* Remap the entire trace file, together with any index footer appended past its end */
+	file_size = spdk_get_trace_file_size(_trace_file);
 	munmap(_trace_file, sizeof(*_trace_file));
-	if ((size_t)st.st_size < _map_size) {
+	if ((size_t)st.st_size < file_size) {
 		SPDK_ERRLOG("Trace file %s is not valid\n", opts->filename);
 		_trace_file = NULL;
 		return false;
 	}
+	_map_size = opts->mode == SPDK_TRACE_PARSER_MODE_FILE ? (size_t)st.st_size : file_size;
 	_trace_file = static_cast<spdk_trace_file *>(mmap(NULL, _map_size, PROT_READ,
 			MAP_SHARED, _fd, 0));
 	if (_trace_file == MAP_FAILED) {
@@ -338,6 +389,14 @@ spdk_trace_parser::init(const spdk_trace_parser_opts *opts)
 		return false;
 	}
 
+	if (_map_size >= file_size + sizeof(*index)) {
+		index = reinterpret_cast<const spdk_trace_index_footer *>(
+				reinterpret_cast<const uint8_t *>(_trace_file) + file_size);
+		if (index->magic == SPDK_TRACE_INDEX_MAGIC && index->stride != 0) {
+			_index = index;
+		}
+	}
+
 	if (opts->lcore == SPDK_TRACE_MAX_LCORE) {
 		for (i = 0; i < SPDK_TRACE_MAX_LCORE; i++) {
 			history = spdk_get_per_lcore_history(_trace_file, i);
@@ -345,7 +404,7 @@ spdk_trace_parser::init(const spdk_trace_parser_opts *opts)
 				continue;
 			}
 
-			populate_events(history, history->num_entries);
+			histories.push_back(history);
 		}
 	} else {
 		history = spdk_get_per_lcore_history(_trace_file, opts->lcore);
@@ -355,11 +414,32 @@ spdk_trace_parser::init(const spdk_trace_parser_opts *opts)
 			return false;
 		}
 		if (history->num_entries > 0 && history->entries[0].tsc != 0) {
-			populate_events(history, history->num_entries);
+			histories.push_back(history);
+		}
+	}
+
+	/* Each lcore's history can be parsed independently, so do them all in parallel */
+	_streams.resize(histories.size());
+	for (stream = 0; stream < histories.size(); stream++) {
+		threads.emplace_back(&spdk_trace_parser::populate_events, this,
+				     histories[stream], histories[stream]->num_entries,
+				     &_streams[stream]);
+	}
+
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+
+	for (stream = 0; stream < _streams.size(); stream++) {
+		if (_streams[stream].first_tsc > _tsc_offset) {
+			_tsc_offset = _streams[stream].first_tsc;
+		}
+		if (!_streams[stream].entries.empty()) {
+			_heap.emplace(_streams[stream].entries[0]->tsc, _streams[stream].lcore,
+				      stream);
 		}
 	}
 
-	_iter = _entries.begin();
 	return true;
 }
 
@@ -377,9 +457,12 @@ spdk_trace_parser::cleanup()
 
 spdk_trace_parser::spdk_trace_parser(const spdk_trace_parser_opts *opts) :
 	_trace_file(NULL),
+	_index(NULL),
 	_map_size(0),
 	_fd(-1),
-	_tsc_offset(0)
+	_tsc_offset(0),
+	_tsc_start(0),
+	_tsc_end(UINT64_MAX)
 {
 	if (!init(opts)) {
 		cleanup();
@@ -45,6 +45,7 @@ static uint32_t g_next_ublk_poll_group = 0;
 static uint32_t g_ublks_max = UBLK_DEFAULT_MAX_SUPPORTED_DEVS;
 static struct spdk_cpuset g_core_mask;
 static bool g_disable_user_copy = false;
+static bool g_enable_queue_sqpoll = false;
 
 struct ublk_queue;
 struct ublk_poll_group;
@@ -168,6 +169,8 @@ struct ublk_tgt {
 	bool			user_copy;
 	/* `ublk_drv` supports UBLK_F_USER_RECOVERY */
 	bool			user_recovery;
+	/* IO rings are created with IORING_SETUP_SQPOLL */
+	bool			queue_sqpoll;
 };
 
 static TAILQ_HEAD(, spdk_ublk_dev) g_ublk_devs = TAILQ_HEAD_INITIALIZER(g_ublk_devs);
@@ -535,6 +538,15 @@ ublk_ctrl_cmd_get_features(void)
 		g_ublk_tgt.user_copy &= !g_disable_user_copy;
 		g_ublk_tgt.user_recovery = !!(g_ublk_tgt.features & UBLK_F_USER_RECOVERY);
 		SPDK_NOTICELOG("User Copy %s\n", g_ublk_tgt.user_copy ? "enabled" : "disabled");
+		/* Without user copy the kernel copies READ data out of the IO
+		 * buffers in io_uring_submit() context and we free them right
+		 * after submission, so the submission must not be deferred to
+		 * an SQPOLL thread.  See ublk_io_xmit().
+		 */
+		g_ublk_tgt.queue_sqpoll = g_enable_queue_sqpoll && g_ublk_tgt.user_copy;
+		if (g_enable_queue_sqpoll && !g_ublk_tgt.queue_sqpoll) {
+			SPDK_WARNLOG("SQPOLL for IO rings requires user copy, not enabling\n");
+		}
 	}
 	io_uring_cqe_seen(&g_ublk_tgt.ctrl_ring, cqe);
 
@@ -671,10 +683,12 @@ ublk_poller_register(void *args)
 
 struct rpc_create_target {
 	bool disable_user_copy;
+	bool enable_sqpoll;
 };
 
 static const struct spdk_json_object_decoder rpc_ublk_create_target[] = {
 	{"disable_user_copy", offsetof(struct rpc_create_target, disable_user_copy), spdk_json_decode_bool, true},
+	{"enable_sqpoll", offsetof(struct rpc_create_target, enable_sqpoll), spdk_json_decode_bool, true},
 };
 
 int
@@ -704,6 +718,7 @@ ublk_create_target(const char *cpumask_str, const struct spdk_json_val *params)
 			return -EINVAL;
 		}
 		g_disable_user_copy = req.disable_user_copy;
+		g_enable_queue_sqpoll = req.enable_sqpoll;
 	}
 
 	assert(g_ublk_tgt.poll_groups == NULL);
@@ -757,6 +772,7 @@ _ublk_fini_done(void *args)
 	g_ublk_tgt.ioctl_encode = false;
 	g_ublk_tgt.user_copy = false;
 	g_ublk_tgt.user_recovery = false;
+	g_ublk_tgt.queue_sqpoll = false;
 
 	if (g_ublk_tgt.cb_fn) {
 		g_ublk_tgt.cb_fn(g_ublk_tgt.cb_arg);
@@ -1398,9 +1414,9 @@ ublk_io_xmit(struct ublk_queue *q)
 	}
 
 	/* Note: for READ io, ublk will always copy the data out of
-	 * the buffers in the io_uring_submit context.  Since we
-	 * are not using SQPOLL for IO rings, we can safely free
-	 * those IO buffers here.  This design doesn't seem ideal,
+	 * the buffers in the io_uring_submit context.  Since SQPOLL
+	 * is never enabled for IO rings without user copy, we can
+	 * safely free those IO buffers here.  This design doesn't seem ideal,
 	 * but it's what's possible since there is no discrete
 	 * COMMIT_REQ operation.  That will need to change in the
 	 * future should we ever want to support async copy
@@ -1563,6 +1579,7 @@ ublk_dev_queue_init(struct ublk_queue *q)
 {
 	int rc = 0, cmd_buf_size;
 	uint32_t j;
+	unsigned int ring_flags;
 	struct spdk_ublk_dev *ublk = q->dev;
 	unsigned long off;
 
@@ -1583,7 +1600,12 @@ ublk_dev_queue_init(struct ublk_queue *q)
 		q->ios[j].iod = &q->io_cmd_buf[j];
 	}
 
-	rc = ublk_setup_ring(q->q_depth, &q->ring, IORING_SETUP_SQE128);
+	ring_flags = IORING_SETUP_SQE128;
+	if (g_ublk_tgt.queue_sqpoll) {
+		ring_flags |= IORING_SETUP_SQPOLL;
+	}
+
+	rc = ublk_setup_ring(q->q_depth, &q->ring, ring_flags);
 	if (rc < 0) {
 		SPDK_ERRLOG("Failed at setup uring: %s\n", spdk_strerror(-rc));
 		munmap(q->io_cmd_buf, ublk_queue_cmd_buf_sz(q->q_depth));
@@ -21,6 +21,11 @@ typedef uint64_t spdk_bit_array_word;
 #define SPDK_BIT_ARRAY_WORD_INDEX_SHIFT	spdk_u32log2(SPDK_BIT_ARRAY_WORD_BITS)
 #define SPDK_BIT_ARRAY_WORD_INDEX_MASK	((1u << SPDK_BIT_ARRAY_WORD_INDEX_SHIFT) - 1)
 
+/* The words[] array is followed by a summary level with one bit per data word,
+ * set when that word is all ones.  Scans for a clear bit consult the summary
+ * first, so that runs of fully allocated words are skipped
+ * SPDK_BIT_ARRAY_WORD_BITS words (i.e. 4096 bits) at a time.
+ */
 struct spdk_bit_array {
 	uint32_t bit_count;
 	spdk_bit_array_word words[];
@@ -63,6 +68,43 @@ bit_array_word_mask(uint32_t num_bits)
 	return (SPDK_BIT_ARRAY_WORD_C(1) << num_bits) - 1;
 }
 
+static inline uint32_t
+bit_array_summary_word_count(uint32_t word_count)
+{
+	return (word_count + SPDK_BIT_ARRAY_WORD_BITS - 1) >> SPDK_BIT_ARRAY_WORD_INDEX_SHIFT;
+}
+
+static inline spdk_bit_array_word *
+bit_array_summary(struct spdk_bit_array *ba)
+{
+	/* The summary level sits right after the data words and the extra word. */
+	return &ba->words[bit_array_word_count(ba->bit_count) + 1];
+}
+
+static void
+bit_array_summary_rebuild(struct spdk_bit_array *ba)
+{
+	uint32_t word_count = bit_array_word_count(ba->bit_count);
+	spdk_bit_array_word *summary = bit_array_summary(ba);
+	uint32_t i;
+
+	memset(summary, 0, bit_array_summary_word_count(word_count) * SPDK_BIT_ARRAY_WORD_BYTES);
+	for (i = 0; i < word_count; i++) {
+		if (ba->words[i] == ~SPDK_BIT_ARRAY_WORD_C(0)) {
+			summary[i >> SPDK_BIT_ARRAY_WORD_INDEX_SHIFT] |=
+				SPDK_BIT_ARRAY_WORD_C(1) << (i & SPDK_BIT_ARRAY_WORD_INDEX_MASK);
+		}
+	}
+
+	/* Mark the nonexistent words covered by the last summary word as full,
+	 * so that clear-bit scans never step past the data words.
+	 */
+	if (word_count & SPDK_BIT_ARRAY_WORD_INDEX_MASK) {
+		summary[bit_array_summary_word_count(word_count) - 1] |=
+			~bit_array_word_mask(word_count & SPDK_BIT_ARRAY_WORD_INDEX_MASK);
+	}
+}
+
 int
 spdk_bit_array_resize(struct spdk_bit_array **bap, uint32_t num_bits)
 {
@@ -87,6 +129,9 @@ spdk_bit_array_resize(struct spdk_bit_array **bap, uint32_t num_bits)
 	 */
 	new_size += SPDK_BIT_ARRAY_WORD_BYTES;
 
+	/* Room for the summary level after the extra word */
+	new_size += bit_array_summary_word_count(new_word_count) * SPDK_BIT_ARRAY_WORD_BYTES;
+
 	new_ba = (struct spdk_bit_array *)spdk_realloc(*bap, new_size, 64);
 	if (!new_ba) {
 		return -ENOMEM;
@@ -123,6 +168,12 @@ spdk_bit_array_resize(struct spdk_bit_array **bap, uint32_t num_bits)
 	}
 
 	new_ba->bit_count = num_bits;
+
+	/* The summary level moved and its old contents got overwritten by the
+	 * extra word, so recompute it from the data words.
+	 */
+	bit_array_summary_rebuild(new_ba);
+
 	*bap = new_ba;
 	return 0;
 }
@@ -169,6 +220,10 @@ spdk_bit_array_set(struct spdk_bit_array *ba, uint32_t bit_index)
 	}
 
 	ba->words[word_index] |= (SPDK_BIT_ARRAY_WORD_C(1) << word_bit_index);
+	if (spdk_unlikely(ba->words[word_index] == ~SPDK_BIT_ARRAY_WORD_C(0))) {
+		bit_array_summary(ba)[word_index >> SPDK_BIT_ARRAY_WORD_INDEX_SHIFT] |=
+			SPDK_BIT_ARRAY_WORD_C(1) << (word_index & SPDK_BIT_ARRAY_WORD_INDEX_MASK);
+	}
 	return 0;
 }
 
@@ -186,6 +241,49 @@ spdk_bit_array_clear(struct spdk_bit_array *ba, uint32_t bit_index)
 	}
 
 	ba->words[word_index] &= ~(SPDK_BIT_ARRAY_WORD_C(1) << word_bit_index);
+	bit_array_summary(ba)[word_index >> SPDK_BIT_ARRAY_WORD_INDEX_SHIFT] &=
+		~(SPDK_BIT_ARRAY_WORD_C(1) << (word_index & SPDK_BIT_ARRAY_WORD_INDEX_MASK));
+}
+
+void
+spdk_bit_array_clear_range(struct spdk_bit_array *ba, uint32_t begin, uint32_t count)
+{
+	spdk_bit_array_word *summary = bit_array_summary(ba);
+	spdk_bit_array_word first_mask, last_mask;
+	uint32_t first_word, last_word, word_index;
+	uint32_t end;
+
+	if (count == 0 || begin >= ba->bit_count) {
+		/*
+		 * Clearing past the end of the bit array is a no-op, since bits past
+		 * the end are implicitly 0.
+		 */
+		return;
+	}
+
+	/* Trim any part of the range beyond the end of the bit array */
+	end = (uint32_t)spdk_min((uint64_t)begin + count, (uint64_t)ba->bit_count);
+
+	first_word = begin >> SPDK_BIT_ARRAY_WORD_INDEX_SHIFT;
+	last_word = (end - 1) >> SPDK_BIT_ARRAY_WORD_INDEX_SHIFT;
+	first_mask = ~SPDK_BIT_ARRAY_WORD_C(0) << (begin & SPDK_BIT_ARRAY_WORD_INDEX_MASK);
+	last_mask = ~SPDK_BIT_ARRAY_WORD_C(0) >>
+		    (SPDK_BIT_ARRAY_WORD_BITS - 1 - ((end - 1) & SPDK_BIT_ARRAY_WORD_INDEX_MASK));
+
+	if (first_word == last_word) {
+		ba->words[first_word] &= ~(first_mask & last_mask);
+	} else {
+		ba->words[first_word] &= ~first_mask;
+		for (word_index = first_word + 1; word_index < last_word; word_index++) {
+			ba->words[word_index] = 0;
+		}
+		ba->words[last_word] &= ~last_mask;
+	}
+
+	for (word_index = first_word; word_index <= last_word; word_index++) {
+		summary[word_index >> SPDK_BIT_ARRAY_WORD_INDEX_SHIFT] &=
+			~(SPDK_BIT_ARRAY_WORD_C(1) << (word_index & SPDK_BIT_ARRAY_WORD_INDEX_MASK));
+	}
 }
 
 static inline uint32_t
@@ -246,16 +344,55 @@ spdk_bit_array_find_first_set(const struct spdk_bit_array *ba, uint32_t start_bi
 uint32_t
 spdk_bit_array_find_first_clear(const struct spdk_bit_array *ba, uint32_t start_bit_index)
 {
-	uint32_t bit_index;
+	uint32_t word_index, word_count, summary_index, summary_count, bit_index;
+	spdk_bit_array_word word, summary_word;
+	const spdk_bit_array_word *summary;
 
-	bit_index = bit_array_find_first(ba, start_bit_index, SPDK_BIT_ARRAY_WORD_C(-1));
+	if (spdk_unlikely(start_bit_index >= ba->bit_count)) {
+		return UINT32_MAX;
+	}
+
+	word_index = start_bit_index >> SPDK_BIT_ARRAY_WORD_INDEX_SHIFT;
+	word = ~ba->words[word_index] &
+	       ~bit_array_word_mask(start_bit_index & SPDK_BIT_ARRAY_WORD_INDEX_MASK);
+
+	if (word == 0) {
+		/* The first word is full from start_bit_index on - scan the summary
+		 * level for the next word that is not full, skipping whole runs of
+		 * full words per summary word.
+		 */
+		word_count = bit_array_word_count(ba->bit_count);
+		summary_count = bit_array_summary_word_count(word_count);
+		summary = &ba->words[word_count + 1];
+
+		word_index++;
+		summary_index = word_index >> SPDK_BIT_ARRAY_WORD_INDEX_SHIFT;
+		if (summary_index >= summary_count) {
+			return UINT32_MAX;
+		}
+		summary_word = ~summary[summary_index] &
+			       ~bit_array_word_mask(word_index & SPDK_BIT_ARRAY_WORD_INDEX_MASK);
+		while (summary_word == 0) {
+			if (++summary_index >= summary_count) {
+				return UINT32_MAX;
+			}
+			summary_word = ~summary[summary_index];
+		}
+
+		word_index = (summary_index << SPDK_BIT_ARRAY_WORD_INDEX_SHIFT) +
+			     SPDK_BIT_ARRAY_WORD_TZCNT(summary_word);
+		word = ~ba->words[word_index];
+		assert(word != 0);
+	}
+
+	bit_index = (word_index << SPDK_BIT_ARRAY_WORD_INDEX_SHIFT) + SPDK_BIT_ARRAY_WORD_TZCNT(word);
 
 	/*
-	 * If we ran off the end of the array and found the 0 bit in the extra word,
+	 * If the only clear bits are in the (cleared) tail of a partial last word,
 	 * return UINT32_MAX to indicate no actual 0 bits were found.
 	 */
 	if (bit_index >= ba->bit_count) {
-		bit_index = UINT32_MAX;
+		return UINT32_MAX;
 	}
 
 	return bit_index;
@@ -319,6 +456,9 @@ spdk_bit_array_load_mask(struct spdk_bit_array *ba, const void *mask)
 			spdk_bit_array_clear(ba, i + size * CHAR_BIT);
 		}
 	}
+
+	/* The memcpy() above bypassed the summary maintenance in set/clear */
+	bit_array_summary_rebuild(ba);
 }
 
 void
@@ -333,6 +473,8 @@ spdk_bit_array_clear_mask(struct spdk_bit_array *ba)
 	for (i = 0; i < num_bits % CHAR_BIT; i++) {
 		spdk_bit_array_clear(ba, i + size * CHAR_BIT);
 	}
+
+	bit_array_summary_rebuild(ba);
 }
 
 struct spdk_bit_pool {
@@ -458,6 +600,28 @@ spdk_bit_pool_free_bit(struct spdk_bit_pool *pool, uint32_t bit_index)
 	pool->free_count++;
 }
 
+void
+spdk_bit_pool_free_range(struct spdk_bit_pool *pool, uint32_t begin, uint32_t count)
+{
+#ifndef NDEBUG
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		assert(spdk_bit_array_get(pool->array, begin + i) == true);
+	}
+#endif
+
+	if (count == 0) {
+		return;
+	}
+
+	spdk_bit_array_clear_range(pool->array, begin, count);
+	if (pool->lowest_free_bit > begin) {
+		pool->lowest_free_bit = begin;
+	}
+	pool->free_count += count;
+}
+
 uint32_t
 spdk_bit_pool_count_allocated(const struct spdk_bit_pool *pool)
 {
@@ -17,6 +17,62 @@ spdk_crc32c_update(const void *buf, size_t len, uint32_t crc)
 
 #elif defined(SPDK_HAVE_SSE4_2)
 
+#ifdef __PCLMUL__
+
+/* Number of 8-byte words processed by each of the three CRC streams. */
+#define CRC32C_STREAM_QWORDS 128
+
+/* x^(8 * 2048) and x^(8 * 1024) mod the CRC32C polynomial, in the form
+ * expected by the reflected-domain recombination below: carryless
+ * multiplying a stream CRC by the constant and folding the product with
+ * _mm_crc32_u64() shifts that CRC over the bytes processed by the
+ * following stream(s).  See "Fast CRC Computation for iSCSI Polynomial
+ * Using CRC32 Instruction" (Gopal et al.).
+ */
+#define CRC32C_FOLD_K1 0x1a0f717c4ULL
+#define CRC32C_FOLD_K2 0x170076faULL
+
+static inline uint64_t
+crc32c_clmul(uint64_t a, uint64_t b)
+{
+	__m128i product;
+
+	product = _mm_clmulepi64_si128(_mm_cvtsi64_si128(a), _mm_cvtsi64_si128(b), 0x00);
+
+	return _mm_cvtsi128_si64(product);
+}
+
+/* Compute the CRC of 3 * CRC32C_STREAM_QWORDS words through three
+ * independent CRC32 instruction streams.  The instruction has a 3 cycle
+ * latency but single cycle throughput, so interleaving three chains keeps
+ * the ALU busy where a single chain would stall.  The three partial CRCs
+ * are recombined with two carryless multiplies folded into the final
+ * _mm_crc32_u64() of the third stream.
+ */
+static uint64_t
+crc32c_3way(const uint64_t *dword_buf, uint64_t crc_a)
+{
+	const uint64_t *a = dword_buf;
+	const uint64_t *b = a + CRC32C_STREAM_QWORDS;
+	const uint64_t *c = b + CRC32C_STREAM_QWORDS;
+	uint64_t crc_b = 0, crc_c = 0;
+	size_t i;
+
+	for (i = 0; i < CRC32C_STREAM_QWORDS - 1; i++) {
+		crc_a = _mm_crc32_u64(crc_a, a[i]);
+		crc_b = _mm_crc32_u64(crc_b, b[i]);
+		crc_c = _mm_crc32_u64(crc_c, c[i]);
+	}
+
+	crc_a = _mm_crc32_u64(crc_a, a[i]);
+	crc_b = _mm_crc32_u64(crc_b, b[i]);
+
+	return _mm_crc32_u64(crc_c, c[i] ^
+			     crc32c_clmul(crc_a, CRC32C_FOLD_K1) ^
+			     crc32c_clmul(crc_b, CRC32C_FOLD_K2));
+}
+#endif /* __PCLMUL__ */
+
 uint32_t
 spdk_crc32c_update(const void *buf, size_t len, uint32_t crc)
 {
@@ -29,6 +85,19 @@ spdk_crc32c_update(const void *buf, size_t len, uint32_t crc)
 	 */
 	count_pre = ((uint64_t)buf & 7) == 0 ? 0 : 8 - ((uint64_t)buf & 7);
 	count_post = (uint64_t)((uintptr_t)buf + len) & 7;
+
+	/* Buffers too small to reach an aligned 8-byte word are processed
+	 * byte by byte.
+	 */
+	if (count_pre + count_post > len) {
+		while (len--) {
+			crc = _mm_crc32_u8(crc, *(const uint8_t *)buf);
+			buf = (uint8_t *)buf + 1;
+		}
+
+		return crc;
+	}
+
 	count_mid = (len - count_pre - count_post) / 8;
 
 	while (count_pre--) {
@@ -40,6 +109,14 @@ spdk_crc32c_update(const void *buf, size_t len, uint32_t crc)
 	crc_tmp64 = crc;
 	dword_buf = (const uint64_t *)buf;
 
+#ifdef __PCLMUL__
+	while (count_mid >= 3 * CRC32C_STREAM_QWORDS) {
+		crc_tmp64 = crc32c_3way(dword_buf, crc_tmp64);
+		dword_buf += 3 * CRC32C_STREAM_QWORDS;
+		count_mid -= 3 * CRC32C_STREAM_QWORDS;
+	}
+#endif
+
 	while (count_mid--) {
 		crc_tmp64 = _mm_crc32_u64(crc_tmp64, *dword_buf);
 		dword_buf++;
@@ -68,6 +145,19 @@ spdk_crc32c_update(const void *buf, size_t len, uint32_t crc)
 	 */
 	count_pre = ((uint64_t)buf & 7) == 0 ? 0 : 8 - ((uint64_t)buf & 7);
 	count_post = (uint64_t)(buf + len) & 7;
+
+	/* Buffers too small to reach an aligned 8-byte word are processed
+	 * byte by byte.
+	 */
+	if (count_pre + count_post > len) {
+		while (len--) {
+			crc = __crc32cb(crc, *(const uint8_t *)buf);
+			buf++;
+		}
+
+		return crc;
+	}
+
 	count_mid = (len - count_pre - count_post) / 8;
 
 	while (count_pre--) {
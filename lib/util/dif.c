@@ -318,6 +318,42 @@ _dif_generate_guard_copy(uint64_t guard_seed, void *dst, void *src, size_t buf_l
 	return guard;
 }
 
+typedef uint64_t (*dif_guard_update_fn)(uint64_t guard_seed, void *buf, size_t buf_len);
+
+static uint64_t
+dif_guard_update_crc16(uint64_t guard_seed, void *buf, size_t buf_len)
+{
+	return (uint64_t)spdk_crc16_t10dif((uint16_t)guard_seed, buf, buf_len);
+}
+
+static uint64_t
+dif_guard_update_crc32c(uint64_t guard_seed, void *buf, size_t buf_len)
+{
+	return (uint64_t)spdk_crc32c_nvme(buf, buf_len, guard_seed);
+}
+
+static uint64_t
+dif_guard_update_crc64(uint64_t guard_seed, void *buf, size_t buf_len)
+{
+	return spdk_crc64_nvme(buf, buf_len, guard_seed);
+}
+
+/* Resolve the guard update function once per call instead of re-dispatching
+ * on the PI format for every block, so that the multi-block loops feed the
+ * accelerated CRC implementations back to back.
+ */
+static inline dif_guard_update_fn
+dif_guard_update_fn_get(const struct spdk_dif_ctx *ctx)
+{
+	if (ctx->dif_pi_format == SPDK_DIF_PI_FORMAT_16) {
+		return dif_guard_update_crc16;
+	} else if (ctx->dif_pi_format == SPDK_DIF_PI_FORMAT_32) {
+		return dif_guard_update_crc32c;
+	} else {
+		return dif_guard_update_crc64;
+	}
+}
+
 static inline uint8_t
 _dif_apptag_offset(enum spdk_dif_pi_format dif_pi_format)
 {
@@ -622,12 +658,15 @@ dif_generate(struct _dif_sgl *sgl, uint32_t num_blocks, const struct spdk_dif_ct
 	uint32_t offset_blocks = 0;
 	uint8_t *buf;
 	uint64_t guard = 0;
+	dif_guard_update_fn guard_fn;
+
+	guard_fn = dif_guard_update_fn_get(ctx);
 
 	while (offset_blocks < num_blocks) {
 		_dif_sgl_get_buf(sgl, &buf, NULL);
 
 		if (ctx->dif_flags & SPDK_DIF_FLAGS_GUARD_CHECK) {
-			guard = _dif_generate_guard(ctx->guard_seed, buf, ctx->guard_interval, ctx->dif_pi_format);
+			guard = guard_fn(ctx->guard_seed, buf, ctx->guard_interval);
 		}
 
 		_dif_generate(buf + ctx->guard_interval, guard, offset_blocks, ctx);
@@ -860,12 +899,15 @@ dif_verify(struct _dif_sgl *sgl, uint32_t num_blocks,
 	int rc;
 	uint8_t *buf;
 	uint64_t guard = 0;
+	dif_guard_update_fn guard_fn;
+
+	guard_fn = dif_guard_update_fn_get(ctx);
 
 	while (offset_blocks < num_blocks) {
 		_dif_sgl_get_buf(sgl, &buf, NULL);
 
 		if (ctx->dif_flags & SPDK_DIF_FLAGS_GUARD_CHECK) {
-			guard = _dif_generate_guard(ctx->guard_seed, buf, ctx->guard_interval, ctx->dif_pi_format);
+			guard = guard_fn(ctx->guard_seed, buf, ctx->guard_interval);
 		}
 
 		rc = _dif_verify(buf + ctx->guard_interval, guard, offset_blocks, ctx, err_blk);
@@ -1491,6 +1533,9 @@ dix_generate(struct _dif_sgl *data_sgl, struct _dif_sgl *md_sgl,
 	uint32_t offset_blocks = 0;
 	uint8_t *data_buf, *md_buf;
 	uint64_t guard;
+	dif_guard_update_fn guard_fn;
+
+	guard_fn = dif_guard_update_fn_get(ctx);
 
 	while (offset_blocks < num_blocks) {
 		_dif_sgl_get_buf(data_sgl, &data_buf, NULL);
@@ -1498,10 +1543,8 @@ dix_generate(struct _dif_sgl *data_sgl, struct _dif_sgl *md_sgl,
 
 		guard = 0;
 		if (ctx->dif_flags & SPDK_DIF_FLAGS_GUARD_CHECK) {
-			guard = _dif_generate_guard(ctx->guard_seed, data_buf, ctx->block_size,
-						    ctx->dif_pi_format);
-			guard = _dif_generate_guard(guard, md_buf, ctx->guard_interval,
-						    ctx->dif_pi_format);
+			guard = guard_fn(ctx->guard_seed, data_buf, ctx->block_size);
+			guard = guard_fn(guard, md_buf, ctx->guard_interval);
 		}
 
 		_dif_generate(md_buf + ctx->guard_interval, guard, offset_blocks, ctx);
@@ -1598,6 +1641,9 @@ dix_verify(struct _dif_sgl *data_sgl, struct _dif_sgl *md_sgl,
 	uint8_t *data_buf, *md_buf;
 	uint64_t guard;
 	int rc;
+	dif_guard_update_fn guard_fn;
+
+	guard_fn = dif_guard_update_fn_get(ctx);
 
 	while (offset_blocks < num_blocks) {
 		_dif_sgl_get_buf(data_sgl, &data_buf, NULL);
@@ -1605,10 +1651,8 @@ dix_verify(struct _dif_sgl *data_sgl, struct _dif_sgl *md_sgl,
 
 		guard = 0;
 		if (ctx->dif_flags & SPDK_DIF_FLAGS_GUARD_CHECK) {
-			guard = _dif_generate_guard(ctx->guard_seed, data_buf, ctx->block_size,
-						    ctx->dif_pi_format);
-			guard = _dif_generate_guard(guard, md_buf, ctx->guard_interval,
-						    ctx->dif_pi_format);
+			guard = guard_fn(ctx->guard_seed, data_buf, ctx->block_size);
+			guard = guard_fn(guard, md_buf, ctx->guard_interval);
 		}
 
 		rc = _dif_verify(md_buf + ctx->guard_interval, guard, offset_blocks, ctx, err_blk);
@@ -42,6 +42,9 @@ struct event_handler {
 	/* file descriptor of the interrupt event */
 	int				fd;
 	uint32_t			events;
+	enum spdk_fd_group_prio		prio;
+	/* Max number of lower priority events dispatched before re-polling. */
+	uint32_t			deadline;
 	char				name[SPDK_MAX_EVENT_NAME_LEN + 1];
 };
 
@@ -50,6 +53,14 @@ struct spdk_fd_group {
 	int num_fds; /* Number of fds registered in this group. */
 
 	struct spdk_fd_group *parent;
+	/* Directly nested children of this group. */
+	TAILQ_HEAD(, spdk_fd_group) children;
+	TAILQ_ENTRY(spdk_fd_group) sibling;
+
+	/* Smallest non-zero deadline among the event sources dispatched by this
+	 * group, including the sources of nested children. Zero if none set one.
+	 */
+	uint32_t min_deadline;
 
 	/* interrupt sources list */
 	TAILQ_HEAD(, event_handler) event_handlers;
@@ -75,6 +86,41 @@ spdk_fd_group_get_epoll_event(struct epoll_event *event)
 	return 0;
 }
 
+static uint32_t
+fd_group_min_handler_deadline(struct spdk_fd_group *fgrp, uint32_t min)
+{
+	struct event_handler *ehdlr;
+
+	TAILQ_FOREACH(ehdlr, &fgrp->event_handlers, next) {
+		if (ehdlr->deadline != 0 && ehdlr->prio != SPDK_FD_GROUP_PRIO_LOW &&
+		    (min == 0 || ehdlr->deadline < min)) {
+			min = ehdlr->deadline;
+		}
+	}
+
+	return min;
+}
+
+static void
+fd_group_update_min_deadline(struct spdk_fd_group *fgrp)
+{
+	struct spdk_fd_group *child;
+	uint32_t min;
+
+	if (fgrp->parent != NULL) {
+		/* The parent dispatches this group's event sources. */
+		fd_group_update_min_deadline(fgrp->parent);
+		return;
+	}
+
+	min = fd_group_min_handler_deadline(fgrp, 0);
+	TAILQ_FOREACH(child, &fgrp->children, sibling) {
+		min = fd_group_min_handler_deadline(child, min);
+	}
+
+	fgrp->min_deadline = min;
+}
+
 static int
 _fd_group_del_all(int epfd, struct spdk_fd_group *grp)
 {
@@ -191,6 +237,9 @@ spdk_fd_group_unnest(struct spdk_fd_group *parent, struct spdk_fd_group *child)
 	}
 
 	child->parent = NULL;
+	TAILQ_REMOVE(&parent->children, child, sibling);
+	fd_group_update_min_deadline(parent);
+	fd_group_update_min_deadline(child);
 
 	return _fd_group_add_all(child->epfd, child);
 }
@@ -220,6 +269,8 @@ spdk_fd_group_nest(struct spdk_fd_group *parent, struct spdk_fd_group *child)
 	}
 
 	child->parent = parent;
+	TAILQ_INSERT_TAIL(&parent->children, child, sibling);
+	fd_group_update_min_deadline(parent);
 
 	return _fd_group_add_all(parent->epfd, child);
 }
@@ -227,6 +278,14 @@ spdk_fd_group_nest(struct spdk_fd_group *parent, struct spdk_fd_group *child)
 int
 spdk_fd_group_add(struct spdk_fd_group *fgrp, int efd, spdk_fd_fn fn,
 		  void *arg, const char *name)
+{
+	return spdk_fd_group_add_ext(fgrp, efd, fn, arg, name, NULL);
+}
+
+int
+spdk_fd_group_add_ext(struct spdk_fd_group *fgrp, int efd, spdk_fd_fn fn,
+		      void *arg, const char *name,
+		      const struct spdk_fd_group_add_opts *opts)
 {
 	struct event_handler *ehdlr = NULL;
 	struct epoll_event epevent = {0};
@@ -238,6 +297,11 @@ spdk_fd_group_add(struct spdk_fd_group *fgrp, int efd, spdk_fd_fn fn,
 		return -EINVAL;
 	}
 
+	if (opts != NULL &&
+	    (opts->size != sizeof(*opts) || opts->prio >= SPDK_FD_GROUP_PRIO_NUM_CLASSES)) {
+		return -EINVAL;
+	}
+
 	/* check if there is already one function registered for this fd */
 	TAILQ_FOREACH(ehdlr, &fgrp->event_handlers, next) {
 		if (ehdlr->fd == efd) {
@@ -256,6 +320,8 @@ spdk_fd_group_add(struct spdk_fd_group *fgrp, int efd, spdk_fd_fn fn,
 	ehdlr->fn_arg = arg;
 	ehdlr->state = EVENT_HANDLER_STATE_WAITING;
 	ehdlr->events = EPOLLIN;
+	ehdlr->prio = opts != NULL ? opts->prio : SPDK_FD_GROUP_PRIO_DEFAULT;
+	ehdlr->deadline = opts != NULL ? opts->deadline : 0;
 	snprintf(ehdlr->name, sizeof(ehdlr->name), "%s", name);
 
 	if (fgrp->parent) {
@@ -274,6 +340,7 @@ spdk_fd_group_add(struct spdk_fd_group *fgrp, int efd, spdk_fd_fn fn,
 
 	TAILQ_INSERT_TAIL(&fgrp->event_handlers, ehdlr, next);
 	fgrp->num_fds++;
+	fd_group_update_min_deadline(fgrp);
 
 	return 0;
 }
@@ -320,6 +387,7 @@ spdk_fd_group_remove(struct spdk_fd_group *fgrp, int efd)
 	assert(fgrp->num_fds > 0);
 	fgrp->num_fds--;
 	TAILQ_REMOVE(&fgrp->event_handlers, ehdlr, next);
+	fd_group_update_min_deadline(fgrp);
 
 	/* Delay ehdlr's free in case it is waiting for execution in fgrp wait loop */
 	if (ehdlr->state == EVENT_HANDLER_STATE_RUNNING) {
@@ -383,6 +451,7 @@ spdk_fd_group_create(struct spdk_fd_group **_egrp)
 
 	/* init the event source head */
 	TAILQ_INIT(&fgrp->event_handlers);
+	TAILQ_INIT(&fgrp->children);
 
 	fgrp->num_fds = 0;
 	fgrp->epfd = epoll_create1(EPOLL_CLOEXEC);
@@ -411,12 +480,65 @@ spdk_fd_group_destroy(struct spdk_fd_group *fgrp)
 	return;
 }
 
+static void
+fd_group_dispatch_event(struct epoll_event *event)
+{
+	struct event_handler *ehdlr = event->data.ptr;
+
+	g_event = event;
+	/* call the interrupt response function */
+	ehdlr->fn(ehdlr->fn_arg);
+	g_event = NULL;
+
+	/* It is possible that the ehdlr was removed
+	 * during this wait loop when it get executed.
+	 */
+	if (ehdlr->state == EVENT_HANDLER_STATE_REMOVED) {
+		free(ehdlr);
+	} else {
+		ehdlr->state = EVENT_HANDLER_STATE_WAITING;
+	}
+}
+
+/* Pick up event sources of a priority class above cur_prio that became ready while
+ * the current batch was being dispatched, and dispatch them right away. Sources that
+ * are part of the current batch are still in RUNNING state and are skipped - if they
+ * were ready at the original poll, they were already dispatched ahead of cur_prio.
+ */
+static void
+fd_group_dispatch_new_higher_prio(struct spdk_fd_group *fgrp, enum spdk_fd_group_prio cur_prio)
+{
+	int totalfds = fgrp->num_fds;
+	struct epoll_event events[totalfds];
+	struct event_handler *ehdlr;
+	int n, nfds;
+
+	if (totalfds == 0) {
+		return;
+	}
+
+	nfds = epoll_wait(fgrp->epfd, events, totalfds, 0);
+	for (n = 0; n < nfds; n++) {
+		ehdlr = events[n].data.ptr;
+
+		if (ehdlr == NULL || ehdlr->fn == NULL ||
+		    ehdlr->state != EVENT_HANDLER_STATE_WAITING || ehdlr->prio <= cur_prio) {
+			continue;
+		}
+
+		ehdlr->state = EVENT_HANDLER_STATE_RUNNING;
+		fd_group_dispatch_event(&events[n]);
+	}
+}
+
 int
 spdk_fd_group_wait(struct spdk_fd_group *fgrp, int timeout)
 {
 	int totalfds = fgrp->num_fds;
 	struct epoll_event events[totalfds];
 	struct event_handler *ehdlr;
+	enum spdk_fd_group_prio prio;
+	uint32_t dispatched = 0;
 	int n;
 	int nfds;
 
@@ -457,34 +579,44 @@ spdk_fd_group_wait(struct spdk_fd_group *fgrp, int timeout)
 		ehdlr->state = EVENT_HANDLER_STATE_RUNNING;
 	}
 
-	for (n = 0; n < nfds; n++) {
-		/* find the event_handler */
-		ehdlr = events[n].data.ptr;
+	/* Dispatch the batch one priority class at a time, highest class first, so
+	 * that e.g. IO qpair wakeups are not delayed behind a storm of admin events
+	 * that happened to arrive ahead of them.
+	 */
+	for (prio = SPDK_FD_GROUP_PRIO_NUM_CLASSES; prio-- > 0;) {
+		for (n = 0; n < nfds; n++) {
+			/* find the event_handler */
+			ehdlr = events[n].data.ptr;
 
-		if (ehdlr == NULL || ehdlr->fn == NULL) {
-			continue;
-		}
+			if (ehdlr == NULL || ehdlr->fn == NULL) {
+				continue;
+			}
 
-		/* It is possible that the ehdlr was removed
-		 * during this wait loop but before it get executed.
-		 */
-		if (ehdlr->state == EVENT_HANDLER_STATE_REMOVED) {
-			free(ehdlr);
-			continue;
-		}
+			/* It is possible that the ehdlr was removed
+			 * during this wait loop but before it get executed.
+			 */
+			if (ehdlr->state == EVENT_HANDLER_STATE_REMOVED) {
+				free(ehdlr);
+				events[n].data.ptr = NULL;
+				continue;
+			}
 
-		g_event = &events[n];
-		/* call the interrupt response function */
-		ehdlr->fn(ehdlr->fn_arg);
-		g_event = NULL;
+			if (ehdlr->prio != prio) {
+				continue;
+			}
 
-		/* It is possible that the ehdlr was removed
-		 * during this wait loop when it get executed.
-		 */
-		if (ehdlr->state == EVENT_HANDLER_STATE_REMOVED) {
-			free(ehdlr);
-		} else {
-			ehdlr->state = EVENT_HANDLER_STATE_WAITING;
+			fd_group_dispatch_event(&events[n]);
+			/* Don't visit this event again in the lower priority passes. */
+			events[n].data.ptr = NULL;
+
+			/* If an event source set a dispatch deadline, re-poll for new
+			 * higher priority events once that many events were dispatched.
+			 */
+			if (fgrp->min_deadline != 0 && prio < SPDK_FD_GROUP_PRIO_NUM_CLASSES - 1 &&
+			    ++dispatched >= fgrp->min_deadline) {
+				fd_group_dispatch_new_higher_prio(fgrp, prio);
+				dispatched = 0;
+			}
 		}
 	}
 
@@ -506,6 +638,14 @@ spdk_fd_group_add(struct spdk_fd_group *fgrp, int efd, spdk_fd_fn fn,
 	return -ENOTSUP;
 }
 
+int
+spdk_fd_group_add_ext(struct spdk_fd_group *fgrp, int efd, spdk_fd_fn fn,
+		      void *arg, const char *name,
+		      const struct spdk_fd_group_add_opts *opts)
+{
+	return -ENOTSUP;
+}
+
 void
 spdk_fd_group_remove(struct spdk_fd_group *fgrp, int efd)
 {
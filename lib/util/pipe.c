@@ -367,3 +367,169 @@ spdk_pipe_group_remove(struct spdk_pipe_group *group, struct spdk_pipe *pipe)
 	pipe->group = NULL;
 	return 0;
 }
+
+/* The writer thread owns `write` and the reader thread owns `read`. Each index
+ * is only ever advanced (mod sz) by its owner, so the opposite side may observe
+ * a stale value - that only under-estimates the space or data available, never
+ * over-estimates it. One byte of the buffer is sacrificed so that read == write
+ * unambiguously means empty, avoiding any shared full flag. The indices live on
+ * separate cache lines to avoid false sharing between the two threads. */
+struct spdk_spsc_pipe {
+	uint8_t		*buf;
+	uint32_t	sz;
+
+	uint32_t	write __attribute__((aligned(SPDK_CACHE_LINE_SIZE)));
+	uint32_t	read __attribute__((aligned(SPDK_CACHE_LINE_SIZE)));
+};
+
+struct spdk_spsc_pipe *
+spdk_spsc_pipe_create(void *buf, uint32_t sz)
+{
+	struct spdk_spsc_pipe *pipe;
+
+	if (buf == NULL || sz < 2) {
+		return NULL;
+	}
+
+	pipe = calloc(1, sizeof(*pipe));
+	if (pipe == NULL) {
+		return NULL;
+	}
+
+	pipe->buf = buf;
+	pipe->sz = sz;
+
+	return pipe;
+}
+
+void *
+spdk_spsc_pipe_destroy(struct spdk_spsc_pipe *pipe)
+{
+	void *buf;
+
+	if (pipe == NULL) {
+		return NULL;
+	}
+
+	buf = pipe->buf;
+	free(pipe);
+	return buf;
+}
+
+static inline uint32_t
+spsc_pipe_space(struct spdk_spsc_pipe *pipe, uint32_t read, uint32_t write)
+{
+	return (read + pipe->sz - write - 1) % pipe->sz;
+}
+
+int
+spdk_spsc_pipe_writer_get_buffer(struct spdk_spsc_pipe *pipe, uint32_t requested_sz,
+				 struct iovec *iovs)
+{
+	uint32_t sz;
+	uint32_t read;
+	uint32_t write;
+
+	read = __atomic_load_n(&pipe->read, __ATOMIC_ACQUIRE);
+	write = pipe->write;
+
+	requested_sz = spdk_min(requested_sz, spsc_pipe_space(pipe, read, write));
+
+	sz = spdk_min(requested_sz, pipe->sz - write);
+
+	iovs[0].iov_base = (sz == 0) ? NULL : pipe->buf + write;
+	iovs[0].iov_len = sz;
+
+	requested_sz -= sz;
+
+	iovs[1].iov_base = (requested_sz == 0) ? NULL : pipe->buf;
+	iovs[1].iov_len = requested_sz;
+
+	return iovs[0].iov_len + iovs[1].iov_len;
+}
+
+int
+spdk_spsc_pipe_writer_advance(struct spdk_spsc_pipe *pipe, uint32_t requested_sz)
+{
+	uint32_t read;
+	uint32_t write;
+
+	read = __atomic_load_n(&pipe->read, __ATOMIC_ACQUIRE);
+	write = pipe->write;
+
+	if (requested_sz > spsc_pipe_space(pipe, read, write)) {
+		return -EINVAL;
+	}
+
+	write = (write + requested_sz) % pipe->sz;
+
+	/* The release pairs with the acquire in the reader functions, making the
+	 * written data visible before the new write index. */
+	__atomic_store_n(&pipe->write, write, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+uint32_t
+spdk_spsc_pipe_reader_bytes_available(struct spdk_spsc_pipe *pipe)
+{
+	uint32_t write;
+	uint32_t read;
+
+	write = __atomic_load_n(&pipe->write, __ATOMIC_ACQUIRE);
+	read = pipe->read;
+
+	return (write + pipe->sz - read) % pipe->sz;
+}
+
+int
+spdk_spsc_pipe_reader_get_buffer(struct spdk_spsc_pipe *pipe, uint32_t requested_sz,
+				 struct iovec *iovs)
+{
+	uint32_t sz;
+	uint32_t read;
+	uint32_t write;
+	uint32_t avail;
+
+	write = __atomic_load_n(&pipe->write, __ATOMIC_ACQUIRE);
+	read = pipe->read;
+
+	avail = (write + pipe->sz - read) % pipe->sz;
+	requested_sz = spdk_min(requested_sz, avail);
+
+	sz = spdk_min(requested_sz, pipe->sz - read);
+
+	iovs[0].iov_base = (sz == 0) ? NULL : pipe->buf + read;
+	iovs[0].iov_len = sz;
+
+	requested_sz -= sz;
+
+	iovs[1].iov_base = (requested_sz == 0) ? NULL : pipe->buf;
+	iovs[1].iov_len = requested_sz;
+
+	return iovs[0].iov_len + iovs[1].iov_len;
+}
+
+int
+spdk_spsc_pipe_reader_advance(struct spdk_spsc_pipe *pipe, uint32_t requested_sz)
+{
+	uint32_t read;
+	uint32_t write;
+	uint32_t avail;
+
+	write = __atomic_load_n(&pipe->write, __ATOMIC_ACQUIRE);
+	read = pipe->read;
+
+	avail = (write + pipe->sz - read) % pipe->sz;
+	if (requested_sz > avail) {
+		return -EINVAL;
+	}
+
+	read = (read + requested_sz) % pipe->sz;
+
+	/* The release pairs with the acquire in the writer functions, preventing
+	 * the writer from reclaiming the space before the data was consumed. */
+	__atomic_store_n(&pipe->read, read, __ATOMIC_RELEASE);
+
+	return 0;
+}
@@ -46,20 +46,57 @@ struct vhost_session_fn_ctx {
 static int vhost_user_wait_for_session_stop(struct spdk_vhost_session *vsession,
 		unsigned timeout_sec, const char *errmsg);
 
+static struct spdk_vhost_gpa_cache_entry *
+vhost_gpa_cache_lookup(struct spdk_vhost_session *vsession, uint64_t addr)
+{
+	struct spdk_vhost_gpa_cache_entry *entry;
+	struct rte_vhost_mem_region *region;
+	uint32_t i;
+
+	for (i = 0; i < SPDK_VHOST_GPA_CACHE_SIZE; i++) {
+		entry = &vsession->gpa_cache[i];
+		if (spdk_likely(entry->size != 0 && addr >= entry->gpa_start &&
+				addr - entry->gpa_start < entry->size)) {
+			return entry;
+		}
+	}
+
+	/* Cache miss - scan the memory table and cache the whole containing region. */
+	for (i = 0; i < vsession->mem->nregions; i++) {
+		region = &vsession->mem->regions[i];
+		if (addr >= region->guest_phys_addr &&
+		    addr - region->guest_phys_addr < region->size) {
+			entry = &vsession->gpa_cache[vsession->gpa_cache_next];
+			vsession->gpa_cache_next = (vsession->gpa_cache_next + 1) %
+						   SPDK_VHOST_GPA_CACHE_SIZE;
+			entry->gpa_start = region->guest_phys_addr;
+			entry->size = region->size;
+			entry->vva_start = region->host_user_addr;
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static void
+vhost_gpa_cache_invalidate(struct spdk_vhost_session *vsession)
+{
+	memset(vsession->gpa_cache, 0, sizeof(vsession->gpa_cache));
+	vsession->gpa_cache_next = 0;
+}
+
 void *
 vhost_gpa_to_vva(struct spdk_vhost_session *vsession, uint64_t addr, uint64_t len)
 {
-	void *vva;
-	uint64_t newlen;
+	struct spdk_vhost_gpa_cache_entry *entry;
 
-	newlen = len;
-	vva = (void *)rte_vhost_va_from_guest_pa(vsession->mem, addr, &newlen);
-	if (newlen != len) {
+	entry = vhost_gpa_cache_lookup(vsession, addr);
+	if (spdk_unlikely(entry == NULL || len > entry->size - (addr - entry->gpa_start))) {
 		return NULL;
 	}
 
-	return vva;
-
+	return (void *)(uintptr_t)(entry->vva_start + (addr - entry->gpa_start));
 }
 
 static void
@@ -327,6 +364,9 @@ vhost_vq_used_signal(struct spdk_vhost_session *vsession,
 		return 0;
 	}
 
+	/* Make sure the completions we're about to signal are visible to the guest */
+	vhost_vq_used_ring_flush(vsession, virtqueue);
+
 	SPDK_DEBUGLOG(vhost_ring,
 		      "Queue %td - USED RING: sending IRQ: last used %"PRIu16"\n",
 		      virtqueue - vsession->virtqueue, virtqueue->last_used_idx);
@@ -403,11 +443,15 @@ vhost_session_vq_used_signal(struct spdk_vhost_virtqueue *virtqueue)
 	struct spdk_vhost_session *vsession = virtqueue->vsession;
 	uint64_t now;
 
-	if (vsession->coalescing_delay_time_base == 0) {
-		if (virtqueue->vring.desc == NULL) {
-			return;
-		}
+	if (virtqueue->vring.desc == NULL) {
+		return;
+	}
+
+	/* Publish pending completions even when the event itself ends up suppressed or
+	 * delayed - the guest may be polling the used index. */
+	vhost_vq_used_ring_flush(vsession, virtqueue);
 
+	if (vsession->coalescing_delay_time_base == 0) {
 		if (vhost_vq_event_is_suppressed(virtqueue)) {
 			return;
 		}
@@ -437,7 +481,8 @@ vhost_session_vq_used_signal(struct spdk_vhost_virtqueue *virtqueue)
 }
 
 /*
- * Enqueue id and len to used ring.
+ * Enqueue id and len to used ring.  The entry is not visible to the guest until the
+ * used index is published by vhost_vq_used_ring_flush().
  */
 void
 vhost_vq_used_ring_enqueue(struct spdk_vhost_session *vsession,
@@ -459,20 +504,16 @@ vhost_vq_used_ring_enqueue(struct spdk_vhost_session *vsession,
 	used->ring[last_idx].id = id;
 	used->ring[last_idx].len = len;
 
-	/* Ensure the used ring is updated before we log it or increment used->idx. */
-	spdk_smp_wmb();
-
 	rte_vhost_set_last_inflight_io_split(vsession->vid, vq_idx, id);
 
 	vhost_log_used_vring_elem(vsession, virtqueue, last_idx);
-	* (volatile uint16_t *) &used->idx = virtqueue->last_used_idx;
-	vhost_log_used_vring_idx(vsession, virtqueue);
-
-	rte_vhost_clr_inflight_desc_split(vsession->vid, vq_idx, virtqueue->last_used_idx, id);
 
 	virtqueue->used_req_cnt++;
 
 	if (spdk_unlikely(spdk_interrupt_mode_is_enabled())) {
+		/* There is no polled flush in interrupt mode, publish the entry right away */
+		vhost_vq_used_ring_flush(vsession, virtqueue);
+
 		if (virtqueue->vring.desc == NULL || vhost_vq_event_is_suppressed(virtqueue)) {
 			return;
 		}
@@ -481,6 +522,43 @@ vhost_vq_used_ring_enqueue(struct spdk_vhost_session *vsession,
 	}
 }
 
+void
+vhost_vq_used_ring_flush(struct spdk_vhost_session *vsession,
+			 struct spdk_vhost_virtqueue *virtqueue)
+{
+	struct rte_vhost_vring *vring = &virtqueue->vring;
+	struct vring_used *used = vring->used;
+	uint16_t vq_idx = virtqueue->vring_idx;
+	uint16_t idx;
+
+	if (spdk_unlikely(virtqueue->packed.packed_ring)) {
+		/* Packed ring entries are published through per-descriptor flags */
+		return;
+	}
+
+	if (virtqueue->used_flush_idx == virtqueue->last_used_idx) {
+		return;
+	}
+
+	SPDK_DEBUGLOG(vhost_ring,
+		      "Queue %td - USED RING: publishing used idx %"PRIu16"\n",
+		      virtqueue - vsession->virtqueue, virtqueue->last_used_idx);
+
+	/* Ensure all used ring entries are updated before we increment used->idx. */
+	spdk_smp_wmb();
+
+	* (volatile uint16_t *) &used->idx = virtqueue->last_used_idx;
+	vhost_log_used_vring_idx(vsession, virtqueue);
+
+	/* The descriptors are visible to the guest now, take them off the inflight list */
+	for (idx = virtqueue->used_flush_idx; idx != virtqueue->last_used_idx; idx++) {
+		rte_vhost_clr_inflight_desc_split(vsession->vid, vq_idx, (uint16_t)(idx + 1),
+						  used->ring[idx & (vring->size - 1)].id);
+	}
+
+	virtqueue->used_flush_idx = virtqueue->last_used_idx;
+}
+
 void
 vhost_vq_packed_ring_enqueue(struct spdk_vhost_session *vsession,
 			     struct spdk_vhost_virtqueue *virtqueue,
@@ -612,6 +690,7 @@ static int
 vhost_vring_desc_payload_to_iov(struct spdk_vhost_session *vsession, struct iovec *iov,
 				uint16_t *iov_index, uintptr_t payload, uint64_t remaining)
 {
+	struct spdk_vhost_gpa_cache_entry *entry;
 	uintptr_t vva;
 	uint64_t len;
 
@@ -620,12 +699,13 @@ vhost_vring_desc_payload_to_iov(struct spdk_vhost_session *vsession, struct iove
 			SPDK_ERRLOG("SPDK_VHOST_IOVS_MAX(%d) reached\n", SPDK_VHOST_IOVS_MAX);
 			return -1;
 		}
-		len = remaining;
-		vva = (uintptr_t)rte_vhost_va_from_guest_pa(vsession->mem, payload, &len);
-		if (vva == 0 || len == 0) {
+		entry = vhost_gpa_cache_lookup(vsession, payload);
+		if (entry == NULL) {
 			SPDK_ERRLOG("gpa_to_vva(%p) == NULL\n", (void *)payload);
 			return -1;
 		}
+		len = spdk_min(remaining, entry->size - (payload - entry->gpa_start));
+		vva = (uintptr_t)(entry->vva_start + (payload - entry->gpa_start));
 		iov[*iov_index].iov_base = (void *)vva;
 		iov[*iov_index].iov_len = len;
 		remaining -= len;
@@ -815,6 +895,7 @@ vhost_register_memtable_if_required(struct spdk_vhost_session *vsession, int vid
 
 	if (vsession->mem == NULL) {
 		SPDK_INFOLOG(vhost, "Start to set memtable\n");
+		vhost_gpa_cache_invalidate(vsession);
 		vsession->mem = new_mem;
 		vhost_session_mem_register(vsession->mem);
 		return 0;
@@ -825,6 +906,7 @@ vhost_register_memtable_if_required(struct spdk_vhost_session *vsession, int vid
 		vhost_session_mem_unregister(vsession->mem);
 		free(vsession->mem);
 
+		vhost_gpa_cache_invalidate(vsession);
 		vsession->mem = new_mem;
 		vhost_session_mem_register(vsession->mem);
 		return 0;
@@ -1112,6 +1194,9 @@ enable_device_vq(struct spdk_vhost_session *vsession, uint16_t qid)
 		}
 	}
 
+	/* All used ring entries up to this point have already been published */
+	q->used_flush_idx = q->last_used_idx;
+
 	if (backend->enable_vq) {
 		rc = backend->enable_vq(vsession, q);
 		if (rc) {
@@ -74,11 +74,29 @@ typedef struct rte_vhost_resubmit_desc spdk_vhost_resubmit_desc;
 typedef struct rte_vhost_resubmit_info spdk_vhost_resubmit_info;
 typedef struct rte_vhost_inflight_desc_packed	spdk_vhost_inflight_desc;
 
+/*
+ * Number of entries in the per-session guest address translation cache.
+ * Sized to cover the number of memory regions a guest typically exposes,
+ * so that per-descriptor translations hit the cache instead of scanning
+ * the full memory table.
+ */
+#define SPDK_VHOST_GPA_CACHE_SIZE 8
+
+struct spdk_vhost_gpa_cache_entry {
+	uint64_t gpa_start;
+	uint64_t size;
+	uint64_t vva_start;
+};
+
 struct spdk_vhost_virtqueue {
 	struct rte_vhost_vring vring;
 	struct rte_vhost_ring_inflight vring_inflight;
 	uint16_t last_avail_idx;
 	uint16_t last_used_idx;
+	/* Last value of last_used_idx published to the guest, entries in between are
+	 * written to the used ring but not visible yet (split ring only).
+	 */
+	uint16_t used_flush_idx;
 
 	struct {
 		/* To mark a descriptor as available in packed ring
@@ -132,6 +150,13 @@ struct spdk_vhost_session {
 
 	struct rte_vhost_memory *mem;
 
+	/* Software cache of guest physical address translations, filled lazily
+	 * from the memory table and invalidated wholesale whenever the table
+	 * changes.
+	 */
+	struct spdk_vhost_gpa_cache_entry gpa_cache[SPDK_VHOST_GPA_CACHE_SIZE];
+	uint32_t gpa_cache_next;
+
 	int task_cnt;
 
 	uint16_t max_queues;
@@ -345,6 +370,16 @@ void vhost_vq_used_ring_enqueue(struct spdk_vhost_session *vsession,
 				struct spdk_vhost_virtqueue *vq,
 				uint16_t id, uint32_t len);
 
+/**
+ * Publish all used ring entries enqueued since the last flush to the guest with a single
+ * used index update.  No-op for packed rings, which publish each entry through its
+ * descriptor flags.
+ * \param vsession vhost session
+ * \param vq virtqueue
+ */
+void vhost_vq_used_ring_flush(struct spdk_vhost_session *vsession,
+			      struct spdk_vhost_virtqueue *vq);
+
 /**
  * Enqueue the entry to the used ring when device complete the request.
  * \param vsession vhost session
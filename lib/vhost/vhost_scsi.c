@@ -144,7 +144,12 @@ static const struct spdk_vhost_dev_backend spdk_vhost_scsi_device_backend = {
 static inline void
 scsi_task_init(struct spdk_vhost_scsi_task *task)
 {
-	memset(&task->scsi, 0, sizeof(task->scsi));
+	/* The tail of the scsi task (queue linkage, abort id and the bdev io wait entry) is
+	 * always fully written before it is read, so only the head has to be cleared when a
+	 * task slot is reused.  bdev_io in particular must be cleared, spdk_scsi_task_put()
+	 * would free a stale pointer.
+	 */
+	memset(&task->scsi, 0, offsetof(struct spdk_scsi_task, scsi_link));
 	/* Tmf_resp pointer and resp pointer are in a union.
 	 * Here means task->tmf_resp = task->resp = NULL.
 	 */
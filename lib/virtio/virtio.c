@@ -31,6 +31,42 @@ vring_desc_init(struct vring_desc *dp, uint16_t n)
 	dp[i].next = VQ_RING_DESC_CHAIN_END;
 }
 
+/* Chain all the free buffer ids with an END. Packed rings have no next
+ * field in the descriptors themselves, so the free list lives in the
+ * extra descriptor state.
+ */
+static inline void
+vring_descx_init_packed(struct vq_desc_extra *dxp, uint16_t n)
+{
+	uint16_t i;
+
+	for (i = 0; i < n - 1; i++) {
+		dxp[i].next = (uint16_t)(i + 1);
+	}
+	dxp[i].next = VQ_RING_DESC_CHAIN_END;
+}
+
+static void
+virtio_init_vring_packed(struct virtqueue *vq)
+{
+	uint64_t desc_addr, driver_addr, device_addr;
+
+	virtio_vring_addrs(vq, (uintptr_t)vq->vq_ring_virt_mem, VIRTIO_PCI_VRING_ALIGN,
+			   &desc_addr, &driver_addr, &device_addr);
+	vq->vq_packed.desc = (struct vring_packed_desc *)(uintptr_t)desc_addr;
+	vq->vq_packed.driver_event = (struct vring_packed_desc_event *)(uintptr_t)driver_addr;
+	vq->vq_packed.device_event = (struct vring_packed_desc_event *)(uintptr_t)device_addr;
+	vq->vq_packed.avail_phase = true;
+	vq->vq_packed.used_phase = true;
+
+	vring_descx_init_packed(vq->vq_descx, vq->vq_nentries);
+	vq->vq_desc_head_idx = 0;
+	vq->vq_desc_tail_idx = (uint16_t)(vq->vq_nentries - 1);
+
+	/* Tell the backend not to interrupt us - we poll the used descriptors. */
+	vq->vq_packed.driver_event->flags = VRING_PACKED_EVENT_FLAG_DISABLE;
+}
+
 static void
 virtio_init_vring(struct virtqueue *vq)
 {
@@ -42,17 +78,23 @@ virtio_init_vring(struct virtqueue *vq)
 	 * Reinitialise since virtio port might have been stopped and restarted
 	 */
 	memset(ring_mem, 0, vq->vq_ring_size);
-	vring_init(vr, size, ring_mem, VIRTIO_PCI_VRING_ALIGN);
 	vq->vq_used_cons_idx = 0;
-	vq->vq_desc_head_idx = 0;
 	vq->vq_avail_idx = 0;
-	vq->vq_desc_tail_idx = (uint16_t)(vq->vq_nentries - 1);
 	vq->vq_free_cnt = vq->vq_nentries;
 	vq->req_start = VQ_RING_DESC_CHAIN_END;
 	vq->req_end = VQ_RING_DESC_CHAIN_END;
 	vq->reqs_finished = 0;
 	memset(vq->vq_descx, 0, sizeof(struct vq_desc_extra) * vq->vq_nentries);
 
+	if (vq->vq_packed.packed_ring) {
+		virtio_init_vring_packed(vq);
+		return;
+	}
+
+	vring_init(vr, size, ring_mem, VIRTIO_PCI_VRING_ALIGN);
+	vq->vq_desc_head_idx = 0;
+	vq->vq_desc_tail_idx = (uint16_t)(vq->vq_nentries - 1);
+
 	vring_desc_init(vr->desc, size);
 
 	/* Tell the backend not to interrupt us.
@@ -105,11 +147,12 @@ virtio_init_queue(struct virtio_dev *dev, uint16_t vtpci_queue_idx)
 	vq->vdev = dev;
 	vq->vq_queue_index = vtpci_queue_idx;
 	vq->vq_nentries = vq_size;
+	vq->vq_packed.packed_ring = virtio_dev_has_feature(dev, VIRTIO_F_RING_PACKED);
 
 	/*
 	 * Reserve a memzone for vring elements
 	 */
-	size = vring_size(vq_size, VIRTIO_PCI_VRING_ALIGN);
+	size = virtio_vring_size(vq, VIRTIO_PCI_VRING_ALIGN);
 	vq->vq_ring_size = SPDK_ALIGN_CEIL(size, VIRTIO_PCI_VRING_ALIGN);
 	SPDK_DEBUGLOG(virtio_dev, "vring_size: %u, rounded_vring_size: %u\n",
 		      size, vq->vq_ring_size);
@@ -252,6 +295,10 @@ int
 virtio_dev_reset(struct virtio_dev *dev, uint64_t req_features)
 {
 	req_features |= (1ULL << VIRTIO_F_VERSION_1);
+	/* Prefer the packed ring layout whenever the device offers it.
+	 * Negotiation simply drops the bit on devices that only do split rings.
+	 */
+	req_features |= (1ULL << VIRTIO_F_RING_PACKED);
 
 	virtio_dev_stop(dev);
 
@@ -331,6 +378,90 @@ vq_ring_free_chain(struct virtqueue *vq, uint16_t desc_idx)
 	dp->next = VQ_RING_DESC_CHAIN_END;
 }
 
+/* Return a buffer id to the free list and reclaim its ring slots */
+static void
+vq_ring_free_id_packed(struct virtqueue *vq, uint16_t id)
+{
+	struct vq_desc_extra *dxp;
+
+	dxp = &vq->vq_descx[id];
+	vq->vq_free_cnt = (uint16_t)(vq->vq_free_cnt + dxp->ndescs);
+	dxp->ndescs = 0;
+
+	if (vq->vq_desc_tail_idx == VQ_RING_DESC_CHAIN_END) {
+		vq->vq_desc_head_idx = id;
+	} else {
+		vq->vq_descx[vq->vq_desc_tail_idx].next = id;
+	}
+
+	vq->vq_desc_tail_idx = id;
+	dxp->next = VQ_RING_DESC_CHAIN_END;
+}
+
+static inline bool
+vring_packed_desc_is_used(struct vring_packed_desc *desc, bool used_phase)
+{
+	uint16_t flags = *(volatile uint16_t *)&desc->flags;
+	bool avail = !!(flags & (1 << VRING_PACKED_DESC_F_AVAIL));
+	bool used = !!(flags & (1 << VRING_PACKED_DESC_F_USED));
+
+	/* The descriptor has been written back by the device when both the
+	 * avail and the used bits match the current used wrap counter.
+	 */
+	return avail == used && used == used_phase;
+}
+
+static uint16_t
+virtqueue_dequeue_burst_rx_packed(struct virtqueue *vq, void **rx_pkts,
+				  uint32_t *len, uint16_t num)
+{
+	struct vring_packed_desc *desc;
+	struct vq_desc_extra *dxp;
+	void *cookie;
+	uint16_t id;
+	uint16_t i;
+
+	for (i = 0; i < num; i++) {
+		desc = &vq->vq_packed.desc[vq->vq_used_cons_idx];
+		if (!vring_packed_desc_is_used(desc, vq->vq_packed.used_phase)) {
+			break;
+		}
+
+		/* Do not read the rest of the descriptor before its flags */
+		virtio_rmb();
+
+		id = desc->id;
+		len[i] = desc->len;
+		dxp = &vq->vq_descx[id];
+		cookie = dxp->cookie;
+
+		if (spdk_unlikely(cookie == NULL)) {
+			SPDK_WARNLOG("vring descriptor with no mbuf cookie at %"PRIu16"\n",
+				     vq->vq_used_cons_idx);
+			break;
+		}
+
+		__builtin_prefetch(cookie);
+
+		rx_pkts[i] = cookie;
+		dxp->cookie = NULL;
+
+		/* The device writes a single used descriptor for the whole
+		 * chain, but advances its ring position by the full chain
+		 * length, so slot accounting stays in sync.
+		 */
+		vq->vq_used_cons_idx = (uint16_t)(vq->vq_used_cons_idx + dxp->ndescs);
+		if (vq->vq_used_cons_idx >= vq->vq_nentries) {
+			vq->vq_used_cons_idx = (uint16_t)(vq->vq_used_cons_idx - vq->vq_nentries);
+			vq->vq_packed.used_phase = !vq->vq_packed.used_phase;
+		}
+
+		vq_ring_free_id_packed(vq, id);
+	}
+
+	return i;
+}
+
 static uint16_t
 virtqueue_dequeue_burst_rx(struct virtqueue *vq, void **rx_pkts,
 			   uint32_t *len, uint16_t num)
@@ -365,12 +496,47 @@ virtqueue_dequeue_burst_rx(struct virtqueue *vq, void **rx_pkts,
 	return i;
 }
 
+static void
+finish_req_packed(struct virtqueue *vq)
+{
+	struct vring_packed_desc *desc;
+	uint16_t head_flags = vq->vq_packed.head_flags;
+
+	desc = &vq->vq_packed.desc[vq->req_end];
+	/* The buffer id is only read by the device from the last descriptor
+	 * of the chain, where it also writes back the used length.
+	 */
+	desc->id = vq->req_start;
+	if (vq->req_end == vq->vq_packed.head_idx) {
+		head_flags &= ~VRING_DESC_F_NEXT;
+	} else {
+		desc->flags &= ~VRING_DESC_F_NEXT;
+	}
+
+	/*
+	 * Write out the flags of the head descriptor last, which hands the
+	 * whole chain over to the device. The chain is made available now
+	 * rather than deferring to virtqueue_req_flush() in the hopes that
+	 * if the host is currently running on another CPU, we can keep it
+	 * processing the new descriptor.
+	 */
+	virtio_wmb();
+	vq->vq_packed.desc[vq->vq_packed.head_idx].flags = head_flags;
+	vq->req_end = VQ_RING_DESC_CHAIN_END;
+	vq->reqs_finished++;
+}
+
 static void
 finish_req(struct virtqueue *vq)
 {
 	struct vring_desc *desc;
 	uint16_t avail_idx;
 
+	if (vq->vq_packed.packed_ring) {
+		finish_req_packed(vq);
+		return;
+	}
+
 	desc = &vq->vq_ring.desc[vq->req_end];
 	desc->flags &= ~VRING_DESC_F_NEXT;
 
@@ -404,8 +570,19 @@ virtqueue_req_start(struct virtqueue *vq, void *cookie, int iovcnt)
 		finish_req(vq);
 	}
 
+	/* For packed rings this takes a free buffer id rather than the head of
+	 * a free descriptor chain. Buffer ids must stay unique until their
+	 * requests complete, which may happen out of order, while the ring
+	 * slots are always consumed and written back in ring order.
+	 */
 	vq->req_start = vq->vq_desc_head_idx;
 	dxp = &vq->vq_descx[vq->req_start];
+	if (vq->vq_packed.packed_ring) {
+		vq->vq_desc_head_idx = dxp->next;
+		if (vq->vq_desc_head_idx == VQ_RING_DESC_CHAIN_END) {
+			vq->vq_desc_tail_idx = VQ_RING_DESC_CHAIN_END;
+		}
+	}
 	dxp->cookie = cookie;
 	dxp->ndescs = 0;
 
@@ -428,7 +605,11 @@ virtqueue_req_flush(struct virtqueue *vq)
 	reqs_finished = vq->reqs_finished;
 	vq->reqs_finished = 0;
 
-	if (vq->vdev->negotiated_features & (1ULL << VIRTIO_RING_F_EVENT_IDX)) {
+	if (vq->vq_packed.packed_ring) {
+		if (vq->vq_packed.device_event->flags == VRING_PACKED_EVENT_FLAG_DISABLE) {
+			return;
+		}
+	} else if (vq->vdev->negotiated_features & (1ULL << VIRTIO_RING_F_EVENT_IDX)) {
 		/* Set used event idx to a value the device will never reach.
 		 * This effectively disables interrupts.
 		 */
@@ -451,12 +632,30 @@ void
 virtqueue_req_abort(struct virtqueue *vq)
 {
 	struct vring_desc *desc;
+	struct vq_desc_extra *dxp;
 
 	if (vq->req_start == VQ_RING_DESC_CHAIN_END) {
 		/* no requests have been started */
 		return;
 	}
 
+	if (vq->vq_packed.packed_ring) {
+		/* None of the descriptors were handed over to the device yet,
+		 * so simply roll back the ring slots the request has written.
+		 */
+		dxp = &vq->vq_descx[vq->req_start];
+		if (dxp->ndescs > vq->vq_avail_idx) {
+			vq->vq_avail_idx = (uint16_t)(vq->vq_avail_idx + vq->vq_nentries);
+			vq->vq_packed.avail_phase = !vq->vq_packed.avail_phase;
+		}
+		vq->vq_avail_idx = (uint16_t)(vq->vq_avail_idx - dxp->ndescs);
+		dxp->cookie = NULL;
+		vq_ring_free_id_packed(vq, vq->req_start);
+		vq->req_start = VQ_RING_DESC_CHAIN_END;
+		vq->req_end = VQ_RING_DESC_CHAIN_END;
+		return;
+	}
+
 	desc = &vq->vq_ring.desc[vq->req_end];
 	desc->flags &= ~VRING_DESC_F_NEXT;
 
@@ -464,6 +663,77 @@ virtqueue_req_abort(struct virtqueue *vq)
 	vq->req_start = VQ_RING_DESC_CHAIN_END;
 }
 
+static void
+virtqueue_req_add_iovs_packed(struct virtqueue *vq, struct iovec *iovs, uint16_t iovcnt,
+			      enum spdk_virtio_desc_type desc_type)
+{
+	struct vring_packed_desc *desc;
+	struct vq_desc_extra *dxp;
+	uint16_t i, flags, prev_idx;
+	uint64_t processed_length, iovec_length, current_length;
+	void *current_base;
+	uint16_t used_desc_count = 0;
+	bool is_head = (vq->req_end == VQ_RING_DESC_CHAIN_END);
+
+	prev_idx = vq->req_end;
+	for (i = 0; i < iovcnt; ++i) {
+		processed_length = 0;
+		iovec_length = iovs[i].iov_len;
+		current_base = iovs[i].iov_base;
+
+		while (processed_length < iovec_length) {
+			desc = &vq->vq_packed.desc[vq->vq_avail_idx];
+			current_length = iovec_length - processed_length;
+
+			if (!vq->vdev->is_hw) {
+				desc->addr  = (uintptr_t)current_base;
+			} else {
+				desc->addr = spdk_vtophys(current_base, &current_length);
+			}
+
+			desc->len = current_length;
+			desc->id = vq->req_start;
+			/* always set NEXT flag. unset it on the last descriptor
+			 * in the request-ending function.
+			 */
+			flags = desc_type | VRING_DESC_F_NEXT;
+			if (vq->vq_packed.avail_phase) {
+				flags |= 1 << VRING_PACKED_DESC_F_AVAIL;
+			} else {
+				flags |= 1 << VRING_PACKED_DESC_F_USED;
+			}
+
+			if (spdk_unlikely(is_head)) {
+				/* The head flags hand the chain over to the
+				 * device, so defer them until the request is
+				 * finished. See finish_req_packed().
+				 */
+				vq->vq_packed.head_idx = vq->vq_avail_idx;
+				vq->vq_packed.head_flags = flags;
+				is_head = false;
+			} else {
+				desc->flags = flags;
+			}
+
+			prev_idx = vq->vq_avail_idx;
+			if (++vq->vq_avail_idx >= vq->vq_nentries) {
+				vq->vq_avail_idx = 0;
+				vq->vq_packed.avail_phase = !vq->vq_packed.avail_phase;
+			}
+			used_desc_count++;
+
+			processed_length += current_length;
+			current_base += current_length;
+		}
+	}
+
+	dxp = &vq->vq_descx[vq->req_start];
+	dxp->ndescs += used_desc_count;
+
+	vq->req_end = prev_idx;
+	vq->vq_free_cnt = (uint16_t)(vq->vq_free_cnt - used_desc_count);
+}
+
 void
 virtqueue_req_add_iovs(struct virtqueue *vq, struct iovec *iovs, uint16_t iovcnt,
 		       enum spdk_virtio_desc_type desc_type)
@@ -478,6 +748,11 @@ virtqueue_req_add_iovs(struct virtqueue *vq, struct iovec *iovs, uint16_t iovcnt
 	assert(vq->req_start != VQ_RING_DESC_CHAIN_END);
 	assert(iovcnt <= vq->vq_free_cnt);
 
+	if (vq->vq_packed.packed_ring) {
+		virtqueue_req_add_iovs_packed(vq, iovs, iovcnt, desc_type);
+		return;
+	}
+
 	/* TODO use indirect descriptors if iovcnt is high enough
 	 * or the caller specifies SPDK_VIRTIO_DESC_F_INDIRECT
 	 */
@@ -532,6 +807,13 @@ virtio_recv_pkts(struct virtqueue *vq, void **io, uint32_t *len, uint16_t nb_pkt
 {
 	uint16_t nb_used, num;
 
+	if (vq->vq_packed.packed_ring) {
+		/* There is no used index to batch on - the used phase of each
+		 * descriptor is checked directly.
+		 */
+		return virtqueue_dequeue_burst_rx_packed(vq, io, len, nb_pkts);
+	}
+
 	nb_used = vq->vq_ring.used->idx - vq->vq_used_cons_idx;
 	virtio_rmb();
 
@@ -530,7 +530,15 @@ virtio_user_kick_queue(struct virtio_dev *vdev, uint32_t queue_sel)
 	}
 
 	state.index = queue_sel;
-	state.num = 0; /* no reservation */
+	if (virtio_dev_has_feature(vdev, VIRTIO_F_RING_PACKED)) {
+		/* Bits 0-14 are the avail index and bit 15 its wrap counter.
+		 * Bits 16-30 are the used index and bit 31 its wrap counter.
+		 * Start with both indexes at 0 and both counters set.
+		 */
+		state.num = (1U << 15) | (1U << 31);
+	} else {
+		state.num = 0; /* no reservation */
+	}
 	rc = vhost_user_sock(dev, VHOST_USER_SET_VRING_BASE, &state);
 	if (rc < 0) {
 		return rc;
@@ -919,11 +927,11 @@ virtio_user_setup_queue(struct virtio_dev *vdev, struct virtqueue *vq)
 	dev->callfds[queue_idx] = callfd;
 	dev->kickfds[queue_idx] = kickfd;
 
-	desc_addr = (uintptr_t)vq->vq_ring_virt_mem;
-	avail_addr = desc_addr + vq->vq_nentries * sizeof(struct vring_desc);
-	used_addr = SPDK_ALIGN_CEIL(avail_addr + offsetof(struct vring_avail,
-				    ring[vq->vq_nentries]),
-				    VIRTIO_PCI_VRING_ALIGN);
+	/* For packed rings the avail/used fields carry the driver and device
+	 * event suppression structure addresses instead.
+	 */
+	virtio_vring_addrs(vq, (uintptr_t)vq->vq_ring_virt_mem, VIRTIO_PCI_VRING_ALIGN,
+			   &desc_addr, &avail_addr, &used_addr);
 
 	dev->vrings[queue_idx].num = vq->vq_nentries;
 	dev->vrings[queue_idx].desc = (void *)(uintptr_t)desc_addr;
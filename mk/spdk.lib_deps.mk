@@ -81,7 +81,7 @@ DEPDIRS-mlx5 = log rdma util
 endif
 DEPDIRS-scsi := log util thread $(JSON_LIBS) trace bdev
 
-DEPDIRS-iscsi := log sock util conf thread $(JSON_LIBS) trace scsi
+DEPDIRS-iscsi := log sock util conf thread $(JSON_LIBS) trace scsi accel
 DEPDIRS-vhost = log util thread $(JSON_LIBS) bdev scsi
 
 # ------------------------------------------------------------------------
@@ -157,6 +157,7 @@ DEPDIRS-bdev_rbd := $(BDEV_DEPS_THREAD)
 DEPDIRS-bdev_uring := $(BDEV_DEPS_THREAD)
 DEPDIRS-bdev_virtio := $(BDEV_DEPS_THREAD) virtio
 DEPDIRS-bdev_zone_block := $(BDEV_DEPS_THREAD)
+DEPDIRS-bdev_zone_remap := $(BDEV_DEPS_THREAD)
 DEPDIRS-bdev_xnvme := $(BDEV_DEPS_THREAD)
 
 # module/event
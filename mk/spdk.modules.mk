@@ -5,8 +5,8 @@
 #
 
 BLOCKDEV_MODULES_LIST = bdev_malloc bdev_null bdev_nvme bdev_passthru bdev_lvol
-BLOCKDEV_MODULES_LIST += bdev_raid bdev_error bdev_gpt bdev_split bdev_delay
-BLOCKDEV_MODULES_LIST += bdev_zone_block
+BLOCKDEV_MODULES_LIST += bdev_raid bdev_error bdev_gpt bdev_split bdev_delay bdev_rcache
+BLOCKDEV_MODULES_LIST += bdev_zone_block bdev_zone_remap
 BLOCKDEV_MODULES_LIST += blobfs blobfs_bdev blob_bdev blob lvol vmd nvme
 
 # Some bdev modules don't have pollers, so they can directly run in interrupt mode
@@ -62,6 +62,7 @@ BLOCKDEV_MODULES_LIST += bdev_aio
 BLOCKDEV_MODULES_PRIVATE_LIBS += -laio
 INTR_BLOCKDEV_MODULES_LIST += bdev_aio
 BLOCKDEV_MODULES_LIST += bdev_ftl ftl
+BLOCKDEV_MODULES_PRIVATE_LIBS += -lpmem
 ifeq ($(CONFIG_VIRTIO),y)
 BLOCKDEV_MODULES_LIST += bdev_virtio virtio
 endif
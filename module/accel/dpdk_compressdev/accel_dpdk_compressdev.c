@@ -44,6 +44,10 @@ static bool g_compressdev_initialized = false;
 #define MLX5_PMD		"mlx5_pci"
 #define NUM_MBUFS		65536
 #define POOL_CACHE_SIZE		256
+/* Max number of ops aggregated before being submitted to the device in one burst */
+#define MAX_ENQUEUE_BURST	16
+/* Number of recycled mbufs kept on each channel to avoid mempool round trips */
+#define MBUF_CACHE_SIZE		128
 
 /* Global list of available compression devices. */
 struct compress_dev {
@@ -75,6 +79,10 @@ struct compress_io_channel {
 	struct rte_mbuf			**src_mbufs;
 	struct rte_mbuf			**dst_mbufs;
 	STAILQ_HEAD(, spdk_accel_task)	queued_tasks;
+	struct rte_comp_op		*enq_ops[MAX_ENQUEUE_BURST];
+	uint16_t			num_enq_ops;
+	struct rte_mbuf			*mbuf_cache[MBUF_CACHE_SIZE];
+	uint16_t			mbuf_cache_cnt;
 };
 
 /* Shared mempools between all devices on this system */
@@ -419,6 +427,116 @@ _setup_compress_mbuf(struct rte_mbuf **mbufs, int *mbuf_total, uint64_t *total_l
 	return 0;
 }
 
+/* Get mbufs for a new operation, preferring ones recycled on this channel over
+ * a round trip to the shared mempool.
+ */
+static int
+_compress_get_mbufs(struct compress_io_channel *chan, struct rte_mbuf **mbufs, uint16_t count)
+{
+	uint16_t from_cache = spdk_min(count, chan->mbuf_cache_cnt);
+	uint16_t i;
+	int rc;
+
+	for (i = 0; i < from_cache; i++) {
+		chan->mbuf_cache_cnt--;
+		mbufs[i] = chan->mbuf_cache[chan->mbuf_cache_cnt];
+	}
+
+	if (from_cache < count) {
+		rc = rte_pktmbuf_alloc_bulk(g_mbuf_mp, &mbufs[from_cache], count - from_cache);
+		if (rc) {
+			/* Put the cached ones back so the failed op doesn't leak them. */
+			while (i > 0) {
+				i--;
+				chan->mbuf_cache[chan->mbuf_cache_cnt] = mbufs[i];
+				chan->mbuf_cache_cnt++;
+			}
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+/* Return the segments of an mbuf chain to the per-channel cache, detaching the
+ * external buffers so the mbufs are ready for reuse. Overflow and mbufs we
+ * don't exclusively own go back to the mempool.
+ */
+static void
+_compress_put_mbuf_chain(struct compress_io_channel *chan, struct rte_mbuf *mbuf)
+{
+	struct rte_mbuf *m = mbuf;
+	struct rte_mbuf *next;
+
+	while (m != NULL) {
+		next = m->next;
+		if (chan->mbuf_cache_cnt < MBUF_CACHE_SIZE && rte_mbuf_refcnt_read(m) == 1) {
+			if (RTE_MBUF_HAS_EXTBUF(m)) {
+				rte_pktmbuf_detach(m);
+			}
+			m->next = NULL;
+			m->nb_segs = 1;
+			m->pkt_len = 0;
+			m->data_len = 0;
+			chan->mbuf_cache[chan->mbuf_cache_cnt] = m;
+			chan->mbuf_cache_cnt++;
+		} else {
+			rte_pktmbuf_free_seg(m);
+		}
+		m = next;
+	}
+}
+
+/* Submit all aggregated ops to the device in a single burst. Ops the device
+ * didn't accept get their tasks queued for resubmission from the poller.
+ */
+static void
+_compress_flush_batch(struct compress_io_channel *chan)
+{
+	struct spdk_accel_task *task;
+	struct rte_comp_op *comp_op;
+	uint16_t num_enq, i;
+	uint8_t cdev_id;
+
+	if (chan->num_enq_ops == 0) {
+		return;
+	}
+
+	assert(chan->device_qp->device != NULL);
+	cdev_id = chan->device_qp->device->cdev_id;
+
+	num_enq = rte_compressdev_enqueue_burst(cdev_id, chan->device_qp->qp, chan->enq_ops,
+						chan->num_enq_ops);
+	assert(num_enq <= chan->num_enq_ops);
+
+	/* Walk the rejected ops backwards so that re-queueing at the head keeps
+	 * the original submission order.
+	 */
+	for (i = chan->num_enq_ops; i > num_enq; i--) {
+		comp_op = chan->enq_ops[i - 1];
+		task = (struct spdk_accel_task *)*RTE_MBUF_DYNFIELD(comp_op->m_src, g_mbuf_offset,
+				uint64_t *);
+
+		_compress_put_mbuf_chain(chan, comp_op->m_src);
+		_compress_put_mbuf_chain(chan, comp_op->m_dst);
+
+		if (comp_op->status == RTE_COMP_OP_STATUS_NOT_PROCESSED) {
+			/* The device queue is full, retry when completions free up space. */
+			rte_comp_op_free(comp_op);
+			STAILQ_INSERT_HEAD(&chan->queued_tasks, task, link);
+		} else {
+			/* There was an error sending the op to the device, most
+			 * likely with the parameters.
+			 */
+			SPDK_ERRLOG("Compression API returned 0x%x\n", comp_op->status);
+			rte_comp_op_free(comp_op);
+			spdk_accel_task_complete(task, -EINVAL);
+		}
+	}
+
+	chan->num_enq_ops = 0;
+}
+
 static int
 _compress_operation(struct compress_io_channel *chan,  struct spdk_accel_task *task)
 {
@@ -427,16 +545,13 @@ _compress_operation(struct compress_io_channel *chan,  struct spdk_accel_task *t
 	int src_iovcnt = task->s.iovcnt;
 	struct iovec *src_iovs = task->s.iovs;
 	struct rte_comp_op *comp_op;
-	uint8_t cdev_id;
 	uint64_t total_length = 0;
 	int rc = 0, i;
 	int src_mbuf_total = 0;
 	int dst_mbuf_total = 0;
-	bool device_error = false;
 	bool compress = (task->op_code == SPDK_ACCEL_OPC_COMPRESS);
 
 	assert(chan->device_qp->device != NULL);
-	cdev_id = chan->device_qp->device->cdev_id;
 
 	/* calc our mbuf totals based on max MBUF size allowed so we can pre-alloc mbufs in bulk */
 	for (i = 0 ; i < src_iovcnt; i++) {
@@ -454,7 +569,7 @@ _compress_operation(struct compress_io_channel *chan,  struct spdk_accel_task *t
 	}
 
 	/* get an mbuf per iov, src and dst */
-	rc = rte_pktmbuf_alloc_bulk(g_mbuf_mp, chan->src_mbufs, src_mbuf_total);
+	rc = _compress_get_mbufs(chan, chan->src_mbufs, src_mbuf_total);
 	if (rc) {
 		SPDK_ERRLOG("ERROR trying to get src_mbufs!\n");
 		rc = -ENOMEM;
@@ -462,7 +577,7 @@ _compress_operation(struct compress_io_channel *chan,  struct spdk_accel_task *t
 	}
 	assert(chan->src_mbufs[0]);
 
-	rc = rte_pktmbuf_alloc_bulk(g_mbuf_mp, chan->dst_mbufs, dst_mbuf_total);
+	rc = _compress_get_mbufs(chan, chan->dst_mbufs, dst_mbuf_total);
 	if (rc) {
 		SPDK_ERRLOG("ERROR trying to get dst_mbufs!\n");
 		rc = -ENOMEM;
@@ -511,18 +626,18 @@ _compress_operation(struct compress_io_channel *chan,  struct spdk_accel_task *t
 	comp_op->op_type = RTE_COMP_OP_STATELESS;
 	comp_op->flush_flag = RTE_COMP_FLUSH_FINAL;
 
-	rc = rte_compressdev_enqueue_burst(cdev_id, chan->device_qp->qp, &comp_op, 1);
-	assert(rc <= 1);
-
-	/* We always expect 1 got queued, if 0 then we need to queue it up. */
-	if (rc == 1) {
-		return 0;
-	} else if (comp_op->status == RTE_COMP_OP_STATUS_NOT_PROCESSED) {
-		rc = -EAGAIN;
-	} else {
-		device_error = true;
+	/* Aggregate the op, it goes to the device in one multi-op burst when the
+	 * caller flushes or when the batch fills up.
+	 */
+	assert(chan->num_enq_ops < MAX_ENQUEUE_BURST);
+	chan->enq_ops[chan->num_enq_ops] = comp_op;
+	chan->num_enq_ops++;
+	if (chan->num_enq_ops == MAX_ENQUEUE_BURST) {
+		_compress_flush_batch(chan);
 	}
 
+	return 0;
+
 	/* Error cleanup paths. */
 error_src_dst:
 	rte_pktmbuf_free_bulk(chan->dst_mbufs, dst_iovcnt);
@@ -532,14 +647,7 @@ error_get_src:
 	rte_comp_op_free(comp_op);
 error_get_op:
 
-	if (device_error == true) {
-		/* There was an error sending the op to the device, most
-		 * likely with the parameters.
-		 */
-		SPDK_ERRLOG("Compression API returned 0x%x\n", comp_op->status);
-		return -EINVAL;
-	}
-	if (rc != -ENOMEM && rc != -EAGAIN) {
+	if (rc != -ENOMEM) {
 		return rc;
 	}
 
@@ -554,7 +662,7 @@ comp_dev_poller(void *args)
 	struct compress_io_channel *chan = args;
 	uint8_t cdev_id;
 	struct rte_comp_op *deq_ops[NUM_MAX_INFLIGHT_OPS];
-	uint16_t num_deq;
+	uint16_t num_deq, num_enq;
 	struct spdk_accel_task *task, *task_to_resubmit;
 	int rc, i, status;
 
@@ -582,32 +690,39 @@ comp_dev_poller(void *args)
 
 		spdk_accel_task_complete(task, status);
 
-		/* Now free both mbufs and the compress operation. The rte_pktmbuf_free()
-		 * call takes care of freeing all of the mbufs in the chain back to their
-		 * original pool.
+		/* Recycle both mbuf chains onto the channel for reuse by the next
+		 * operations, anything we can't cache goes back to its original pool.
 		 */
-		rte_pktmbuf_free(deq_ops[i]->m_src);
-		rte_pktmbuf_free(deq_ops[i]->m_dst);
+		_compress_put_mbuf_chain(chan, deq_ops[i]->m_src);
+		_compress_put_mbuf_chain(chan, deq_ops[i]->m_dst);
 
-		/* There is no bulk free for com ops so we have to free them one at a time
-		 * here however it would be rare that we'd ever have more than 1 at a time
-		 * anyways.
+		/* There is no bulk free for comp ops so we have to free them one at
+		 * a time here.
 		 */
 		rte_comp_op_free(deq_ops[i]);
+	}
 
-		/* Check if there are any pending comp ops to process, only pull one
-		 * at a time off as _compress_operation() may re-queue the op.
-		 */
-		if (!STAILQ_EMPTY(&chan->queued_tasks)) {
-			task_to_resubmit = STAILQ_FIRST(&chan->queued_tasks);
-			rc = _compress_operation(chan, task_to_resubmit);
-			if (rc == 0) {
-				STAILQ_REMOVE_HEAD(&chan->queued_tasks, link);
-			}
+	/* Refill a burst from any pending tasks now that completions have freed up
+	 * device queue space, then submit it in one go.
+	 */
+	while (!STAILQ_EMPTY(&chan->queued_tasks) && chan->num_enq_ops < MAX_ENQUEUE_BURST) {
+		uint16_t num_ops = chan->num_enq_ops;
+
+		task_to_resubmit = STAILQ_FIRST(&chan->queued_tasks);
+		STAILQ_REMOVE_HEAD(&chan->queued_tasks, link);
+
+		rc = _compress_operation(chan, task_to_resubmit);
+		if (rc != 0) {
+			spdk_accel_task_complete(task_to_resubmit, rc);
+		} else if (chan->num_enq_ops == num_ops) {
+			/* The task was re-queued waiting for resources, stop for now. */
+			break;
 		}
 	}
+	num_enq = chan->num_enq_ops;
+	_compress_flush_batch(chan);
 
-	return num_deq == 0 ? SPDK_POLLER_IDLE : SPDK_POLLER_BUSY;
+	return (num_deq == 0 && num_enq == 0) ? SPDK_POLLER_IDLE : SPDK_POLLER_BUSY;
 }
 
 static int
@@ -656,6 +771,9 @@ compress_submit_tasks(struct spdk_io_channel *ch, struct spdk_accel_task *first_
 		task = tmp;
 	}
 
+	/* Submit everything aggregated above as a single burst. */
+	_compress_flush_batch(chan);
+
 	return 0;
 
 queue_tasks:
@@ -795,6 +913,11 @@ compress_destroy_cb(void *io_device, void *ctx_buf)
 	struct compress_io_channel *chan = ctx_buf;
 	struct comp_device_qp *device_qp = chan->device_qp;
 
+	if (chan->mbuf_cache_cnt > 0) {
+		rte_pktmbuf_free_bulk(chan->mbuf_cache, chan->mbuf_cache_cnt);
+		chan->mbuf_cache_cnt = 0;
+	}
+
 	spdk_free(chan->src_mbufs);
 	spdk_free(chan->dst_mbufs);
 
@@ -136,6 +136,14 @@ struct accel_dpdk_cryptodev_key_priv {
 	TAILQ_HEAD(, accel_dpdk_cryptodev_key_handle) dev_keys;
 };
 
+/* Number of entries in the per-channel key handle cache, must be a power of two */
+#define ACCEL_DPDK_CRYPTODEV_KEY_CACHE_SIZE 8
+
+struct accel_dpdk_cryptodev_key_cache_entry {
+	struct accel_dpdk_cryptodev_key_priv *key;
+	struct accel_dpdk_cryptodev_key_handle *key_handle;
+};
+
 /* The crypto channel struct. It is allocated and freed on my behalf by the io channel code.
  * We store things in here that are needed on per thread basis like the base_channel for this thread,
  * and the poller for this thread.
@@ -145,6 +153,11 @@ struct accel_dpdk_cryptodev_io_channel {
 	struct spdk_poller *poller;
 	/* Array of qpairs for each available device. The specific device will be selected depending on the crypto key */
 	struct accel_dpdk_cryptodev_qp *device_qp[ACCEL_DPDK_CRYPTODEV_DRIVER_LAST];
+	/* Cache of key handles resolved on this channel, indexed by a hash of the key pointer.
+	 * Flushed lazily when any crypto key is destroyed */
+	struct accel_dpdk_cryptodev_key_cache_entry key_cache[ACCEL_DPDK_CRYPTODEV_KEY_CACHE_SIZE];
+	/* Value of g_key_cache_generation at the last cache flush */
+	uint32_t key_cache_generation;
 	/* Used to queue tasks when qpair is full or only part of crypto ops was submitted to the PMD */
 	TAILQ_HEAD(, accel_dpdk_cryptodev_task) queued_tasks;
 	/* Used to queue tasks that were completed in submission path - to avoid calling cpl_cb and possibly overflow
@@ -174,6 +187,9 @@ static struct rte_mbuf_ext_shared_info g_shinfo = {};   /* used by DPDK mbuf mac
 static uint8_t g_qat_total_qp = 0;
 static uint8_t g_next_qat_index;
 
+/* Incremented whenever a crypto key is destroyed, invalidates per-channel key handle caches */
+static uint32_t g_key_cache_generation;
+
 static const char *g_driver_names[] = {
 	[ACCEL_DPDK_CRYPTODEV_DRIVER_AESNI_MB]	= ACCEL_DPDK_CRYPTODEV_AESNI_MB,
 	[ACCEL_DPDK_CRYPTODEV_DRIVER_QAT]	= ACCEL_DPDK_CRYPTODEV_QAT,
@@ -435,7 +451,22 @@ static inline struct accel_dpdk_cryptodev_key_handle *
 accel_dpdk_find_key_handle_in_channel(struct accel_dpdk_cryptodev_io_channel *crypto_ch,
 				      struct accel_dpdk_cryptodev_key_priv *key)
 {
-	struct accel_dpdk_cryptodev_key_handle *key_handle;
+	struct accel_dpdk_cryptodev_key_cache_entry *entry;
+	struct accel_dpdk_cryptodev_key_handle *key_handle = NULL;
+	uint32_t generation;
+
+	/* Resolved key handles are cached per channel, so repeated submissions with the same key
+	 * don't walk the key's device list.  Destroying any key flushes the caches. */
+	generation = __atomic_load_n(&g_key_cache_generation, __ATOMIC_ACQUIRE);
+	if (spdk_unlikely(crypto_ch->key_cache_generation != generation)) {
+		memset(crypto_ch->key_cache, 0, sizeof(crypto_ch->key_cache));
+		crypto_ch->key_cache_generation = generation;
+	}
+
+	entry = &crypto_ch->key_cache[((uintptr_t)key >> 6) % ACCEL_DPDK_CRYPTODEV_KEY_CACHE_SIZE];
+	if (spdk_likely(entry->key == key)) {
+		return entry->key_handle;
+	}
 
 	if (key->driver == ACCEL_DPDK_CRYPTODEV_DRIVER_MLX5_PCI) {
 		/* Crypto key is registered on all available devices while io_channel opens CQ/QP on a single device.
@@ -443,13 +474,19 @@ accel_dpdk_find_key_handle_in_channel(struct accel_dpdk_cryptodev_io_channel *cr
 		TAILQ_FOREACH(key_handle, &key->dev_keys, link) {
 			if (key_handle->device->cdev_id ==
 			    crypto_ch->device_qp[ACCEL_DPDK_CRYPTODEV_DRIVER_MLX5_PCI]->device->cdev_id) {
-				return key_handle;
+				break;
 			}
 		}
-		return NULL;
 	} else {
-		return TAILQ_FIRST(&key->dev_keys);
+		key_handle = TAILQ_FIRST(&key->dev_keys);
+	}
+
+	if (key_handle != NULL) {
+		entry->key = key;
+		entry->key_handle = key_handle;
 	}
+
+	return key_handle;
 }
 
 static inline int
@@ -912,6 +949,9 @@ _accel_dpdk_cryptodev_create_cb(void *io_device, void *ctx_buf)
 	TAILQ_INIT(&crypto_ch->queued_tasks);
 	TAILQ_INIT(&crypto_ch->completed_tasks);
 
+	memset(crypto_ch->key_cache, 0, sizeof(crypto_ch->key_cache));
+	crypto_ch->key_cache_generation = __atomic_load_n(&g_key_cache_generation, __ATOMIC_ACQUIRE);
+
 	return 0;
 }
 
@@ -1410,6 +1450,9 @@ accel_dpdk_cryptodev_key_deinit(struct spdk_accel_crypto_key *key)
 	}
 	free(priv->xts_key);
 	free(priv);
+
+	/* Channels may still cache handles of this key, make them flush their caches */
+	__atomic_fetch_add(&g_key_cache_generation, 1, __ATOMIC_RELEASE);
 }
 
 static bool
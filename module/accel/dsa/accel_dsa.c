@@ -97,11 +97,30 @@ idxd_select_device(struct idxd_io_channel *chan)
 	} while (++count < g_num_devices);
 
 	/* We are out of available channels and/or devices for the local socket. We fix the number
-	 * of channels that we allocate per device and only allocate devices on the same socket
-	 * that the current thread is on. If on a 2 socket system it may be possible to avoid
-	 * this situation by spreading threads across the sockets.
+	 * of channels that we allocate per device, so take a second pass accepting devices on
+	 * remote sockets rather than failing channel creation outright. The accel framework
+	 * detects such channels through get_channel_socket_id() and executes small operations in
+	 * software, so only larger operations pay the cross-socket penalty.
 	 */
-	SPDK_ERRLOG("No more DSA devices available on the local socket.\n");
+	count = 0;
+	do {
+		pthread_mutex_lock(&g_dev_lock);
+		g_next_dev = TAILQ_NEXT(g_next_dev, tailq);
+		if (g_next_dev == NULL) {
+			g_next_dev = TAILQ_FIRST(&g_dsa_devices);
+		}
+		dev = g_next_dev;
+		pthread_mutex_unlock(&g_dev_lock);
+
+		chan->chan = spdk_idxd_get_channel(dev->dsa);
+		if (chan->chan != NULL) {
+			SPDK_NOTICELOG("No DSA device available on socket %d, using device on socket %d\n",
+				       socket_id, spdk_idxd_get_socket(dev->dsa));
+			return dev;
+		}
+	} while (++count < g_num_devices);
+
+	SPDK_ERRLOG("No more DSA devices available on any socket.\n");
 	return NULL;
 }
 
@@ -296,26 +315,33 @@ static int
 dsa_submit_task(struct spdk_io_channel *ch, struct spdk_accel_task *task)
 {
 	struct idxd_io_channel *chan = spdk_io_channel_get_ctx(ch);
+	struct spdk_accel_task *tmp;
 	int rc = 0;
 
-	assert(STAILQ_NEXT(task, link) == NULL);
+	/* The framework may hand over a chain of tasks linked through their link pointers,
+	 * e.g. when submitted through spdk_accel_submit_batch() */
+	while (task != NULL) {
+		tmp = STAILQ_NEXT(task, link);
 
-	if (spdk_unlikely(chan->state == IDXD_CHANNEL_ERROR)) {
-		spdk_accel_task_complete(task, -EINVAL);
-		return 0;
-	}
+		if (spdk_unlikely(chan->state == IDXD_CHANNEL_ERROR)) {
+			spdk_accel_task_complete(task, -EINVAL);
+		} else if (!STAILQ_EMPTY(&chan->queued_tasks)) {
+			STAILQ_INSERT_TAIL(&chan->queued_tasks, task, link);
+		} else {
+			rc = _process_single_task(ch, task);
+			if (rc == -EBUSY) {
+				STAILQ_INSERT_TAIL(&chan->queued_tasks, task, link);
+			} else if (rc) {
+				spdk_accel_task_complete(task, rc);
+			}
+		}
 
-	if (!STAILQ_EMPTY(&chan->queued_tasks)) {
-		STAILQ_INSERT_TAIL(&chan->queued_tasks, task, link);
-		return 0;
+		task = tmp;
 	}
 
-	rc = _process_single_task(ch, task);
-	if (rc == -EBUSY) {
-		STAILQ_INSERT_TAIL(&chan->queued_tasks, task, link);
-	} else if (rc) {
-		spdk_accel_task_complete(task, rc);
-	}
+	/* Close out the batch descriptor built from this group of tasks right away
+	 * instead of leaving it for the next poll */
+	spdk_idxd_flush_batch(chan->chan);
 
 	return 0;
 }
@@ -339,6 +365,7 @@ dsa_submit_queued_tasks(struct idxd_io_channel *chan)
 	STAILQ_FOREACH_SAFE(task, &chan->queued_tasks, link, tmp) {
 		rc = _process_single_task(ch, task);
 		if (rc == -EBUSY) {
+			spdk_idxd_flush_batch(chan->chan);
 			return rc;
 		}
 		STAILQ_REMOVE_HEAD(&chan->queued_tasks, link);
@@ -347,6 +374,8 @@ dsa_submit_queued_tasks(struct idxd_io_channel *chan)
 		}
 	}
 
+	spdk_idxd_flush_batch(chan->chan);
+
 	return 0;
 }
 
@@ -398,6 +427,26 @@ dsa_supports_opcode(enum spdk_accel_opcode opc)
 	}
 }
 
+static bool
+dsa_supports_fused_opcode(enum spdk_accel_opcode fused_opc)
+{
+	switch (fused_opc) {
+	case SPDK_ACCEL_OPC_COPY_CRC32C:
+		/* Executed as a single Copy with CRC Generation descriptor */
+		return true;
+	default:
+		return false;
+	}
+}
+
+static int
+dsa_get_channel_socket_id(struct spdk_io_channel *ch)
+{
+	struct idxd_io_channel *chan = spdk_io_channel_get_ctx(ch);
+
+	return spdk_idxd_get_socket(chan->dev->dsa);
+}
+
 static int accel_dsa_init(void);
 static void accel_dsa_exit(void *ctx);
 static void accel_dsa_write_config_json(struct spdk_json_write_ctx *w);
@@ -409,7 +458,9 @@ static struct spdk_accel_module_if g_dsa_module = {
 	.get_ctx_size = accel_dsa_get_ctx_size,
 	.name			= "dsa",
 	.supports_opcode	= dsa_supports_opcode,
+	.supports_fused_opcode	= dsa_supports_fused_opcode,
 	.get_io_channel		= dsa_get_io_channel,
+	.get_channel_socket_id	= dsa_get_channel_socket_id,
 	.submit_tasks		= dsa_submit_task
 };
 
@@ -75,6 +75,8 @@ struct accel_mlx5_task {
 	uint32_t num_reqs;
 	uint32_t num_completed_reqs;
 	uint32_t num_submitted_reqs;
+	uint32_t num_blocks;
+	uint32_t num_submitted_blocks;
 	int rc;
 	struct spdk_iov_sgl src;
 	struct spdk_iov_sgl dst;
@@ -302,17 +304,21 @@ accel_mlx5_flush_wrs(struct accel_mlx5_dev *dev)
 
 static inline int
 accel_mlx5_fill_block_sge(struct accel_mlx5_req *req, struct ibv_sge *sge,
-			  struct spdk_iov_sgl *iovs)
+			  struct spdk_iov_sgl *iovs, uint32_t num_blocks)
 {
 	struct spdk_rdma_memory_translation translation;
 	void *addr;
-	uint32_t remaining = req->task->base.block_size;
+	uint64_t remaining = (uint64_t)req->task->base.block_size * num_blocks;
 	uint32_t size;
 	int i = 0;
 	int rc;
 
 	while (remaining) {
-		size = spdk_min(remaining, iovs->iov->iov_len - iovs->iov_offset);
+		if (spdk_unlikely(i == ACCEL_MLX5_MAX_SGE)) {
+			SPDK_ERRLOG("Memory domain has too many segments for %u blocks\n", num_blocks);
+			return -ERANGE;
+		}
+		size = spdk_min(remaining, (uint64_t)iovs->iov->iov_len - iovs->iov_offset);
 		addr = (void *)iovs->iov->iov_base + iovs->iov_offset;
 		rc = spdk_rdma_get_translation(req->task->dev->mmap, addr, size, &translation);
 		if (spdk_unlikely(rc)) {
@@ -331,6 +337,27 @@ accel_mlx5_fill_block_sge(struct accel_mlx5_req *req, struct ibv_sge *sge,
 	return i;
 }
 
+/* Return the number of whole blocks which fit into ACCEL_MLX5_MAX_SGE memory segments starting
+ * at the current position of \b iovs. The sgl is passed by value, the caller's copy is not
+ * advanced. One UMR can cover several blocks since the crypto BSF increments the tweak per
+ * data unit, so the only limit is the size of the mkey SGE list. */
+static inline uint32_t
+accel_mlx5_blocks_in_sges(struct spdk_iov_sgl iovs, uint32_t block_size, uint32_t max_blocks)
+{
+	uint64_t max_bytes = (uint64_t)block_size * max_blocks;
+	uint64_t bytes = 0;
+	uint32_t size;
+	int i;
+
+	for (i = 0; i < ACCEL_MLX5_MAX_SGE && bytes < max_bytes; i++) {
+		size = spdk_min(max_bytes - bytes, (uint64_t)iovs.iov->iov_len - iovs.iov_offset);
+		bytes += size;
+		spdk_iov_sgl_advance(&iovs, size);
+	}
+
+	return bytes / block_size;
+}
+
 static inline bool
 accel_mlx5_compare_iovs(struct iovec *v1, struct iovec *v2, uint32_t iovcnt)
 {
@@ -388,12 +415,10 @@ accel_mlx5_task_process(struct accel_mlx5_task *mlx5_task)
 	struct mlx5dv_mkey_conf_attr mkey_attr = {};
 	struct mlx5dv_crypto_attr cattr;
 	struct accel_mlx5_req *req;
-	uint64_t iv;
 	uint32_t num_setters = 3; /* access flags, layout, crypto */
+	uint32_t num_blocks;
 	int rc;
 
-	iv = task->iv + mlx5_task->num_completed_reqs;
-
 	if (!qp->wr_started) {
 		ibv_wr_start(qpx);
 		qp->wr_started = true;
@@ -404,7 +429,22 @@ accel_mlx5_task_process(struct accel_mlx5_task *mlx5_task)
 
 	while (mlx5_task->cur_req && dev->reqs_submitted < dev->max_reqs) {
 		req = mlx5_task->cur_req;
-		rc = accel_mlx5_fill_block_sge(req, req->src_sg, &mlx5_task->src);
+		/* Pack as many whole blocks as the UMR SGE list allows, the crypto BSF
+		 * increments the tweak per data unit within a single mkey */
+		num_blocks = accel_mlx5_blocks_in_sges(mlx5_task->src, task->block_size,
+						       mlx5_task->num_blocks - mlx5_task->num_submitted_blocks);
+		if (!mlx5_task->inplace) {
+			num_blocks = spdk_min(num_blocks,
+					      accel_mlx5_blocks_in_sges(mlx5_task->dst, task->block_size,
+							      mlx5_task->num_blocks - mlx5_task->num_submitted_blocks));
+		}
+		if (spdk_unlikely(num_blocks == 0)) {
+			/* A single block spans more than ACCEL_MLX5_MAX_SGE segments */
+			rc = -EINVAL;
+			SPDK_ERRLOG("failed set src sge, rc %d\n", rc);
+			goto err_out;
+		}
+		rc = accel_mlx5_fill_block_sge(req, req->src_sg, &mlx5_task->src, num_blocks);
 		if (spdk_unlikely(rc <= 0)) {
 			if (rc == 0) {
 				rc = -EINVAL;
@@ -423,7 +463,7 @@ accel_mlx5_task_process(struct accel_mlx5_task *mlx5_task)
 		if (mlx5_task->inplace) {
 			mlx5dv_wr_set_mkey_layout_list(mqpx, req->src_sg_count, req->src_sg);
 		} else {
-			rc = accel_mlx5_fill_block_sge(req, req->dst_sg, &mlx5_task->dst);
+			rc = accel_mlx5_fill_block_sge(req, req->dst_sg, &mlx5_task->dst, num_blocks);
 			if (spdk_unlikely(rc <= 0)) {
 				if (rc == 0) {
 					rc = -EINVAL;
@@ -435,16 +475,18 @@ accel_mlx5_task_process(struct accel_mlx5_task *mlx5_task)
 			req->dst_sg_count = rc;
 			mlx5dv_wr_set_mkey_layout_list(mqpx, req->dst_sg_count, req->dst_sg);
 		}
-		SPDK_DEBUGLOG(accel_mlx5, "req %p, task %p crypto_attr: bs %u, iv %"PRIu64", enc_on_tx %d\n",
-			      req, req->task, task->block_size, iv, mlx5_task->encrypt_on_tx);
+		SPDK_DEBUGLOG(accel_mlx5, "req %p, task %p crypto_attr: bs %u, blocks %u, iv %"PRIu64", enc_on_tx %d\n",
+			      req, req->task, task->block_size, num_blocks,
+			      task->iv + mlx5_task->num_submitted_blocks, mlx5_task->encrypt_on_tx);
 		rc = spdk_mlx5_crypto_set_attr(&cattr, task->crypto_key->priv, dev->dev_ctx->pd, task->block_size,
-					       iv++, mlx5_task->encrypt_on_tx);
+					       task->iv + mlx5_task->num_submitted_blocks, mlx5_task->encrypt_on_tx);
 		if (spdk_unlikely(rc)) {
 			SPDK_ERRLOG("failed to set crypto attr, rc %d\n", rc);
 			mlx5_task->rc = rc;
 			goto err_out;
 		}
 		mlx5dv_wr_set_mkey_crypto(mqpx, &cattr);
+		mlx5_task->num_submitted_blocks += num_blocks;
 
 		/* Prepare WRITE, use rkey from mkey, remote addr is always 0 - start of the mkey */
 		qpx->wr_flags = IBV_SEND_SIGNALED;
@@ -543,8 +585,9 @@ accel_mlx5_task_init(struct accel_mlx5_task *mlx5_task, struct accel_mlx5_dev *d
 	mlx5_task->rc = 0;
 	mlx5_task->num_completed_reqs = 0;
 	mlx5_task->num_submitted_reqs = 0;
+	mlx5_task->num_submitted_blocks = 0;
 	mlx5_task->cur_req = NULL;
-	mlx5_task->num_reqs = src_nbytes / mlx5_task->base.block_size;
+	mlx5_task->num_blocks = src_nbytes / mlx5_task->base.block_size;
 	spdk_iov_sgl_init(&mlx5_task->src, task->s.iovs, task->s.iovcnt, 0);
 	if (task->d.iovcnt == 0 || (task->d.iovcnt == task->s.iovcnt &&
 				    accel_mlx5_compare_iovs(task->d.iovs, task->s.iovs, task->s.iovcnt))) {
@@ -554,6 +597,37 @@ accel_mlx5_task_init(struct accel_mlx5_task *mlx5_task, struct accel_mlx5_dev *d
 		spdk_iov_sgl_init(&mlx5_task->dst, task->d.iovs, task->d.iovcnt, 0);
 	}
 
+	/* Find out how many requests the payload takes when each UMR packs as many whole
+	 * blocks as its SGE list can hold. Simulate the packing done at submission time */
+	{
+		struct spdk_iov_sgl src = mlx5_task->src;
+		struct spdk_iov_sgl dst;
+		uint32_t remaining_blocks = mlx5_task->num_blocks;
+		uint32_t num_blocks;
+
+		if (!mlx5_task->inplace) {
+			dst = mlx5_task->dst;
+		}
+		mlx5_task->num_reqs = 0;
+		while (remaining_blocks) {
+			num_blocks = accel_mlx5_blocks_in_sges(src, task->block_size, remaining_blocks);
+			if (!mlx5_task->inplace) {
+				num_blocks = spdk_min(num_blocks,
+						      accel_mlx5_blocks_in_sges(dst, task->block_size, remaining_blocks));
+			}
+			if (spdk_unlikely(num_blocks == 0)) {
+				/* A single block spans more than ACCEL_MLX5_MAX_SGE segments */
+				return -EINVAL;
+			}
+			spdk_iov_sgl_advance(&src, num_blocks * task->block_size);
+			if (!mlx5_task->inplace) {
+				spdk_iov_sgl_advance(&dst, num_blocks * task->block_size);
+			}
+			remaining_blocks -= num_blocks;
+			mlx5_task->num_reqs++;
+		}
+	}
+
 	TAILQ_INIT(&mlx5_task->reqs);
 	if (spdk_unlikely(!accel_mlx5_task_alloc_reqs(mlx5_task))) {
 		/* Pool is empty, queue this task */
@@ -563,8 +637,8 @@ accel_mlx5_task_init(struct accel_mlx5_task *mlx5_task, struct accel_mlx5_dev *d
 	}
 	mlx5_task->cur_req = TAILQ_FIRST(&mlx5_task->reqs);
 
-	SPDK_DEBUGLOG(accel_mlx5, "task %p, inplace %d, num_reqs %d\n", mlx5_task, mlx5_task->inplace,
-		      mlx5_task->num_reqs);
+	SPDK_DEBUGLOG(accel_mlx5, "task %p, inplace %d, num_blocks %u, num_reqs %d\n", mlx5_task,
+		      mlx5_task->inplace, mlx5_task->num_blocks, mlx5_task->num_reqs);
 
 	return 0;
 }
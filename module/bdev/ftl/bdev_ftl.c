@@ -240,6 +240,10 @@ bdev_ftl_write_config_json(struct spdk_bdev *bdev, struct spdk_json_write_ctx *w
 		spdk_json_write_named_string(w, "cache", conf.cache_bdev);
 	}
 
+	if (conf.cache_dax_path) {
+		spdk_json_write_named_string(w, "cache_dax_path", conf.cache_dax_path);
+	}
+
 	spdk_json_write_object_end(w);
 	spdk_json_write_object_end(w);
 }
@@ -54,6 +54,15 @@ static const struct spdk_json_object_decoder rpc_bdev_ftl_create_decoders[] = {
 		"fast_shutdown", offsetof(struct spdk_ftl_conf, fast_shutdown),
 		spdk_json_decode_bool, true
 	},
+	{
+		"nv_cache_compaction_concurrency",
+		offsetof(struct spdk_ftl_conf, nv_cache_compaction_concurrency),
+		spdk_json_decode_uint32, true
+	},
+	{
+		"cache_dax_path", offsetof(struct spdk_ftl_conf, cache_dax_path),
+		spdk_json_decode_string, true
+	},
 };
 
 static void
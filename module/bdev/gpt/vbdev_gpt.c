@@ -30,6 +30,7 @@ static struct spdk_bdev_module gpt_if = {
 	.module_init = vbdev_gpt_init,
 	.get_ctx_size = vbdev_gpt_get_ctx_size,
 	.examine_disk = vbdev_gpt_examine,
+	.examine_done_ext = true,
 
 };
 SPDK_BDEV_MODULE_REGISTER(gpt, &gpt_if)
@@ -428,7 +429,7 @@ gpt_read_secondary_table_complete(struct spdk_bdev_io *bdev_io, bool status, voi
 	}
 
 end:
-	spdk_bdev_module_examine_done(&gpt_if);
+	spdk_bdev_module_examine_done_ext(&gpt_if, bdev);
 	if (num_partitions <= 0) {
 		/* If no gpt_disk instances were created, free the base context */
 		spdk_bdev_part_base_free(gpt_base->part_base);
@@ -500,7 +501,7 @@ end:
 	 * Notify the generic bdev layer that the actions related to the original examine
 	 *  callback are now completed.
 	 */
-	spdk_bdev_module_examine_done(&gpt_if);
+	spdk_bdev_module_examine_done_ext(&gpt_if, bdev);
 
 	/*
 	 * vbdev_gpt_create_bdevs returns the number of bdevs created upon success.
@@ -566,7 +567,7 @@ vbdev_gpt_examine(struct spdk_bdev *bdev)
 	 * the MBR and block 1 has the GPT header.
 	 */
 	if (spdk_bdev_get_num_blocks(bdev) < 2) {
-		spdk_bdev_module_examine_done(&gpt_if);
+		spdk_bdev_module_examine_done_ext(&gpt_if, bdev);
 		return;
 	}
 
@@ -574,13 +575,13 @@ vbdev_gpt_examine(struct spdk_bdev *bdev)
 		SPDK_DEBUGLOG(vbdev_gpt,
 			      "GPT module does not support block size %" PRIu32 " for bdev %s\n",
 			      spdk_bdev_get_block_size(bdev), spdk_bdev_get_name(bdev));
-		spdk_bdev_module_examine_done(&gpt_if);
+		spdk_bdev_module_examine_done_ext(&gpt_if, bdev);
 		return;
 	}
 
 	rc = vbdev_gpt_read_gpt(bdev);
 	if (rc) {
-		spdk_bdev_module_examine_done(&gpt_if);
+		spdk_bdev_module_examine_done_ext(&gpt_if, bdev);
 		SPDK_ERRLOG("Failed to read info from bdev %s\n", spdk_bdev_get_name(bdev));
 	}
 }
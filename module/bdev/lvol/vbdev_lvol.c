@@ -35,6 +35,7 @@ struct spdk_bdev_module g_lvol_if = {
 	.examine_config = vbdev_lvs_examine_config,
 	.examine_disk = vbdev_lvs_examine_disk,
 	.get_ctx_size = vbdev_lvs_get_ctx_size,
+	.examine_done_ext = true,
 
 };
 
@@ -823,6 +824,9 @@ vbdev_lvol_io_type_supported(void *ctx, enum spdk_bdev_io_type io_type)
 	case SPDK_BDEV_IO_TYPE_UNMAP:
 	case SPDK_BDEV_IO_TYPE_WRITE_ZEROES:
 		return !spdk_blob_is_read_only(lvol->blob);
+	case SPDK_BDEV_IO_TYPE_COPY:
+		return !spdk_blob_is_read_only(lvol->blob) &&
+		       lvol->lvol_store->bs_dev->copy != NULL;
 	case SPDK_BDEV_IO_TYPE_RESET:
 	case SPDK_BDEV_IO_TYPE_READ:
 	case SPDK_BDEV_IO_TYPE_SEEK_DATA:
@@ -929,6 +933,65 @@ lvol_write(struct spdk_lvol *lvol, struct spdk_io_channel *ch, struct spdk_bdev_
 				num_pages, lvol_op_comp, bdev_io, &lvol_io->ext_io_opts);
 }
 
+static void
+lvol_copy_read_comp(void *cb_arg, int bserrno)
+{
+	struct spdk_bdev_io *bdev_io = cb_arg;
+	struct spdk_lvol *lvol = bdev_io->bdev->ctxt;
+
+	if (bserrno != 0) {
+		lvol_op_comp(bdev_io, bserrno);
+		return;
+	}
+
+	spdk_blob_io_writev(lvol->blob, spdk_bdev_io_get_io_channel(bdev_io),
+			    bdev_io->u.bdev.iovs, bdev_io->u.bdev.iovcnt,
+			    bdev_io->u.bdev.offset_blocks, bdev_io->u.bdev.num_blocks,
+			    lvol_op_comp, bdev_io);
+}
+
+static void
+lvol_copy_get_buf_cb(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io, bool success)
+{
+	struct spdk_lvol *lvol = bdev_io->bdev->ctxt;
+
+	if (!success) {
+		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED);
+		return;
+	}
+
+	spdk_blob_io_readv(lvol->blob, ch, bdev_io->u.bdev.iovs, bdev_io->u.bdev.iovcnt,
+			   bdev_io->u.bdev.copy.src_offset_blocks, bdev_io->u.bdev.num_blocks,
+			   lvol_copy_read_comp, bdev_io);
+}
+
+static void
+lvol_copy_comp(void *cb_arg, int bserrno)
+{
+	struct spdk_bdev_io *bdev_io = cb_arg;
+
+	if (bserrno == -ENOTSUP) {
+		/* The blobstore could not express this copy as device copy
+		 * operations, e.g. because a covered cluster is not allocated
+		 * yet.  Fall back to a buffered read/write pair. */
+		spdk_bdev_io_get_buf(bdev_io, lvol_copy_get_buf_cb,
+				     bdev_io->u.bdev.num_blocks * bdev_io->bdev->blocklen);
+		return;
+	}
+
+	lvol_op_comp(bdev_io, bserrno);
+}
+
+static void
+lvol_copy(struct spdk_lvol *lvol, struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io)
+{
+	struct spdk_blob *blob = lvol->blob;
+
+	spdk_blob_io_copy(blob, ch, bdev_io->u.bdev.offset_blocks,
+			  bdev_io->u.bdev.copy.src_offset_blocks, bdev_io->u.bdev.num_blocks,
+			  lvol_copy_comp, bdev_io);
+}
+
 static int
 lvol_reset(struct spdk_bdev_io *bdev_io)
 {
@@ -976,6 +1039,9 @@ vbdev_lvol_submit_request(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_
 	case SPDK_BDEV_IO_TYPE_SEEK_HOLE:
 		lvol_seek_hole(lvol, bdev_io);
 		break;
+	case SPDK_BDEV_IO_TYPE_COPY:
+		lvol_copy(lvol, ch, bdev_io);
+		break;
 	default:
 		SPDK_INFOLOG(vbdev_lvol, "lvol: unsupported I/O type %d\n", bdev_io->type);
 		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED);
@@ -1605,7 +1671,7 @@ vbdev_lvs_examine_config(struct spdk_bdev *bdev)
 		SPDK_INFOLOG(vbdev_lvol, "bdev %s: claimed by one ore more esnap clones\n",
 			     uuid_str);
 	}
-	spdk_bdev_module_examine_done(&g_lvol_if);
+	spdk_bdev_module_examine_done_ext(&g_lvol_if, bdev);
 }
 
 static void
@@ -1702,12 +1768,20 @@ _vbdev_lvs_examine(struct spdk_bdev *bdev, struct spdk_lvs_req *ori_req,
 	action(bs_dev, _vbdev_lvs_examine_cb, req);
 }
 
+/* Examine request carrying the examined base bdev, so that the completion can
+ * be reported against it. The embedded spdk_lvs_req must be the first member.
+ */
+struct vbdev_lvs_examine_req {
+	struct spdk_lvs_req	req;
+	struct spdk_bdev	*bdev;
+};
+
 static void
 vbdev_lvs_examine_done(void *arg, int lvserrno)
 {
-	struct spdk_lvs_req *req = arg;
+	struct vbdev_lvs_examine_req *req = arg;
 
-	spdk_bdev_module_examine_done(&g_lvol_if);
+	spdk_bdev_module_examine_done_ext(&g_lvol_if, req->bdev);
 	free(req);
 }
 
@@ -1724,26 +1798,27 @@ vbdev_lvs_load(struct spdk_bs_dev *bs_dev, spdk_lvs_op_with_handle_complete cb_f
 static void
 vbdev_lvs_examine_disk(struct spdk_bdev *bdev)
 {
-	struct spdk_lvs_req *req;
+	struct vbdev_lvs_examine_req *req;
 
 	if (spdk_bdev_get_md_size(bdev) != 0) {
 		SPDK_INFOLOG(vbdev_lvol, "Cannot create bs dev on %s\n which is formatted with metadata",
 			     bdev->name);
-		spdk_bdev_module_examine_done(&g_lvol_if);
+		spdk_bdev_module_examine_done_ext(&g_lvol_if, bdev);
 		return;
 	}
 
 	req = calloc(1, sizeof(*req));
 	if (req == NULL) {
 		SPDK_ERRLOG("Cannot alloc memory for vbdev lvol store request pointer\n");
-		spdk_bdev_module_examine_done(&g_lvol_if);
+		spdk_bdev_module_examine_done_ext(&g_lvol_if, bdev);
 		return;
 	}
 
-	req->cb_fn = vbdev_lvs_examine_done;
-	req->cb_arg = req;
+	req->bdev = bdev;
+	req->req.cb_fn = vbdev_lvs_examine_done;
+	req->req.cb_arg = req;
 
-	_vbdev_lvs_examine(bdev, req, vbdev_lvs_load);
+	_vbdev_lvs_examine(bdev, &req->req, vbdev_lvs_load);
 }
 
 struct spdk_lvol *
@@ -695,6 +695,7 @@ SPDK_RPC_REGISTER("bdev_lvol_rename", rpc_bdev_lvol_rename, SPDK_RPC_RUNTIME)
 
 struct rpc_bdev_lvol_inflate {
 	char *name;
+	uint32_t max_in_flight;
 };
 
 static void
@@ -705,6 +706,7 @@ free_rpc_bdev_lvol_inflate(struct rpc_bdev_lvol_inflate *req)
 
 static const struct spdk_json_object_decoder rpc_bdev_lvol_inflate_decoders[] = {
 	{"name", offsetof(struct rpc_bdev_lvol_inflate, name), spdk_json_decode_string},
+	{"max_in_flight", offsetof(struct rpc_bdev_lvol_inflate, max_in_flight), spdk_json_decode_uint32, true},
 };
 
 static void
@@ -757,7 +759,7 @@ rpc_bdev_lvol_inflate(struct spdk_jsonrpc_request *request,
 		goto cleanup;
 	}
 
-	spdk_lvol_inflate(lvol, rpc_bdev_lvol_inflate_cb, request);
+	spdk_lvol_inflate_ext(lvol, req.max_in_flight, rpc_bdev_lvol_inflate_cb, request);
 
 cleanup:
 	free_rpc_bdev_lvol_inflate(&req);
@@ -798,7 +800,7 @@ rpc_bdev_lvol_decouple_parent(struct spdk_jsonrpc_request *request,
 		goto cleanup;
 	}
 
-	spdk_lvol_decouple_parent(lvol, rpc_bdev_lvol_inflate_cb, request);
+	spdk_lvol_decouple_parent_ext(lvol, req.max_in_flight, rpc_bdev_lvol_inflate_cb, request);
 
 cleanup:
 	free_rpc_bdev_lvol_inflate(&req);
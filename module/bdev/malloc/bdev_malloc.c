@@ -20,6 +20,7 @@ struct malloc_disk {
 	struct spdk_bdev		disk;
 	void				*malloc_buf;
 	void				*malloc_md_buf;
+	int32_t				socket_id;
 	TAILQ_ENTRY(malloc_disk)	link;
 };
 
@@ -584,6 +585,8 @@ bdev_malloc_get_io_channel(void *ctx)
 static void
 bdev_malloc_write_json_config(struct spdk_bdev *bdev, struct spdk_json_write_ctx *w)
 {
+	struct malloc_disk *malloc_disk = bdev->ctxt;
+
 	spdk_json_write_object_begin(w);
 
 	spdk_json_write_named_string(w, "method", "bdev_malloc_create");
@@ -595,6 +598,9 @@ bdev_malloc_write_json_config(struct spdk_bdev *bdev, struct spdk_json_write_ctx
 	spdk_json_write_named_uint32(w, "physical_block_size", bdev->phys_blocklen);
 	spdk_json_write_named_uuid(w, "uuid", &bdev->uuid);
 	spdk_json_write_named_uint32(w, "optimal_io_boundary", bdev->optimal_io_boundary);
+	if (malloc_disk->socket_id != SPDK_ENV_SOCKET_ID_ANY) {
+		spdk_json_write_named_int32(w, "socket_id", malloc_disk->socket_id);
+	}
 
 	spdk_json_write_object_end(w);
 
@@ -751,20 +757,26 @@ create_malloc_disk(struct spdk_bdev **bdev, const struct malloc_bdev_opts *opts)
 		return -EINVAL;
 	}
 
+	if (opts->socket_id < SPDK_ENV_SOCKET_ID_ANY) {
+		SPDK_ERRLOG("Invalid socket ID %" PRIi32 "\n", opts->socket_id);
+		return -EINVAL;
+	}
+
 	mdisk = calloc(1, sizeof(*mdisk));
 	if (!mdisk) {
 		SPDK_ERRLOG("mdisk calloc() failed\n");
 		return -ENOMEM;
 	}
 
+	mdisk->socket_id = opts->socket_id;
+
 	/*
-	 * Allocate the large backend memory buffer from pinned memory.
-	 *
-	 * TODO: need to pass a hint so we know which socket to allocate
-	 *  from on multi-socket systems.
+	 * Allocate the large backend memory buffer from pinned memory on the
+	 * requested socket, so that the disk can be placed NUMA-local to the
+	 * cores that will drive it on multi-socket systems.
 	 */
 	mdisk->malloc_buf = spdk_zmalloc(opts->num_blocks * block_size, 2 * 1024 * 1024, NULL,
-					 SPDK_ENV_LCORE_ID_ANY, SPDK_MALLOC_DMA);
+					 opts->socket_id, SPDK_MALLOC_DMA);
 	if (!mdisk->malloc_buf) {
 		SPDK_ERRLOG("malloc_buf spdk_zmalloc() failed\n");
 		malloc_disk_free(mdisk);
@@ -773,7 +785,7 @@ create_malloc_disk(struct spdk_bdev **bdev, const struct malloc_bdev_opts *opts)
 
 	if (!opts->md_interleave && opts->md_size != 0) {
 		mdisk->malloc_md_buf = spdk_zmalloc(opts->num_blocks * opts->md_size, 2 * 1024 * 1024, NULL,
-						    SPDK_ENV_LCORE_ID_ANY, SPDK_MALLOC_DMA);
+						    opts->socket_id, SPDK_MALLOC_DMA);
 		if (!mdisk->malloc_md_buf) {
 			SPDK_ERRLOG("malloc_md_buf spdk_zmalloc() failed\n");
 			malloc_disk_free(mdisk);
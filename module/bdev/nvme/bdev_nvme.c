@@ -11,6 +11,7 @@
 
 #include "spdk/accel.h"
 #include "spdk/config.h"
+#include "spdk/dma.h"
 #include "spdk/endian.h"
 #include "spdk/bdev.h"
 #include "spdk/json.h"
@@ -97,6 +98,11 @@ struct nvme_bdev_io {
 
 	/* Current tsc at submit time. */
 	uint64_t submit_tsc;
+
+	/** Translated data buffer of a write whose buffer is from the accel memory domain and
+	 *  whose accel sequence was executed before submission.
+	 */
+	struct iovec accel_iov;
 };
 
 struct nvme_probe_skip_entry {
@@ -157,6 +163,8 @@ struct spdk_thread *g_bdev_nvme_init_thread;
 static struct spdk_poller *g_hotplug_poller;
 static struct spdk_poller *g_hotplug_probe_poller;
 static struct spdk_nvme_probe_ctx *g_hotplug_probe_ctx;
+static uint64_t g_hotplug_probe_start_tsc;
+static bool g_hotplug_probe_stall_logged;
 
 static void nvme_ctrlr_populate_namespaces(struct nvme_ctrlr *nvme_ctrlr,
 		struct nvme_async_probe_ctx *ctx);
@@ -164,6 +172,8 @@ static void nvme_ctrlr_populate_namespaces_done(struct nvme_ctrlr *nvme_ctrlr,
 		struct nvme_async_probe_ctx *ctx);
 static int bdev_nvme_library_init(void);
 static void bdev_nvme_library_fini(void);
+static void bdev_nvme_flush_accel_batch(struct nvme_poll_group *group);
+static void bdev_nvme_unregister_adminq_poll(struct nvme_ctrlr *nvme_ctrlr);
 static void _bdev_nvme_submit_request(struct nvme_bdev_channel *nbdev_ch,
 				      struct spdk_bdev_io *bdev_io);
 static void bdev_nvme_submit_request(struct spdk_io_channel *ch,
@@ -191,6 +201,8 @@ static int bdev_nvme_comparev_and_writev(struct nvme_bdev_io *bio,
 		uint32_t flags);
 static int bdev_nvme_get_zone_info(struct nvme_bdev_io *bio, uint64_t zone_id,
 				   uint32_t num_zones, struct spdk_bdev_zone_info *info);
+static int bdev_nvme_get_zone_info_rle(struct nvme_bdev_io *bio, uint64_t zone_id,
+				       uint64_t num_zones);
 static int bdev_nvme_zone_management(struct nvme_bdev_io *bio, uint64_t zone_id,
 				     enum spdk_bdev_zone_action action);
 static void bdev_nvme_admin_passthru(struct nvme_bdev_channel *nbdev_ch,
@@ -512,8 +524,8 @@ nvme_ctrlr_delete(struct nvme_ctrlr *nvme_ctrlr)
 
 	spdk_poller_unregister(&nvme_ctrlr->reconnect_delay_timer);
 
-	/* First, unregister the adminq poller, as the driver will poll adminq if necessary */
-	spdk_poller_unregister(&nvme_ctrlr->adminq_timer_poller);
+	/* First, stop polling the adminq, as the driver will poll it if necessary */
+	bdev_nvme_unregister_adminq_poll(nvme_ctrlr);
 
 	/* If we got here, the reset/detach poller cannot be active */
 	assert(nvme_ctrlr->reset_detach_poller == NULL);
@@ -1046,6 +1058,64 @@ _bdev_nvme_find_io_path_min_qd(struct nvme_bdev_channel *nbdev_ch)
 	return non_optimized;
 }
 
+/* Probe one I/O out of BDEV_NVME_LATENCY_PROBE_RATIO on an alternate path to keep
+ * the latency estimates of the slower paths up to date.
+ */
+#define BDEV_NVME_LATENCY_PROBE_RATIO 128
+
+static struct nvme_io_path *
+_bdev_nvme_find_io_path_min_latency(struct nvme_bdev_channel *nbdev_ch)
+{
+	struct nvme_io_path *io_path;
+	struct nvme_io_path *optimized = NULL, *non_optimized = NULL;
+	uint64_t opt_min_latency = UINT64_MAX, non_opt_min_latency = UINT64_MAX;
+	uint64_t ewma_latency_ticks;
+
+	if (spdk_unlikely(++nbdev_ch->latency_probe_counter >= BDEV_NVME_LATENCY_PROBE_RATIO)) {
+		nbdev_ch->latency_probe_counter = 0;
+		return _bdev_nvme_find_io_path(nbdev_ch);
+	}
+
+	STAILQ_FOREACH(io_path, &nbdev_ch->io_path_list, stailq) {
+		if (spdk_unlikely(!nvme_qpair_is_connected(io_path->qpair))) {
+			/* The device is currently resetting. */
+			continue;
+		}
+
+		if (spdk_unlikely(!nvme_ns_is_active(io_path->nvme_ns))) {
+			continue;
+		}
+
+		/* A path without any sample yet compares as fastest so that it gets
+		 * primed quickly.
+		 */
+		ewma_latency_ticks = io_path->ewma_latency_ticks;
+		switch (io_path->nvme_ns->ana_state) {
+		case SPDK_NVME_ANA_OPTIMIZED_STATE:
+			if (ewma_latency_ticks < opt_min_latency) {
+				opt_min_latency = ewma_latency_ticks;
+				optimized = io_path;
+			}
+			break;
+		case SPDK_NVME_ANA_NON_OPTIMIZED_STATE:
+			if (ewma_latency_ticks < non_opt_min_latency) {
+				non_opt_min_latency = ewma_latency_ticks;
+				non_optimized = io_path;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	/* don't cache io path for BDEV_NVME_MP_SELECTOR_LATENCY selector */
+	if (optimized != NULL) {
+		return optimized;
+	}
+
+	return non_optimized;
+}
+
 static inline struct nvme_io_path *
 bdev_nvme_find_io_path(struct nvme_bdev_channel *nbdev_ch)
 {
@@ -1063,6 +1133,8 @@ bdev_nvme_find_io_path(struct nvme_bdev_channel *nbdev_ch)
 	if (nbdev_ch->mp_policy == BDEV_NVME_MP_POLICY_ACTIVE_PASSIVE ||
 	    nbdev_ch->mp_selector == BDEV_NVME_MP_SELECTOR_ROUND_ROBIN) {
 		return _bdev_nvme_find_io_path(nbdev_ch);
+	} else if (nbdev_ch->mp_selector == BDEV_NVME_MP_SELECTOR_LATENCY) {
+		return _bdev_nvme_find_io_path_min_latency(nbdev_ch);
 	} else {
 		return _bdev_nvme_find_io_path_min_qd(nbdev_ch);
 	}
@@ -1241,6 +1313,31 @@ bdev_nvme_update_nvme_error_stat(struct spdk_bdev_io *bdev_io, const struct spdk
 	pthread_mutex_unlock(&nbdev->mutex);
 }
 
+static inline void
+bdev_nvme_update_io_path_latency(struct nvme_bdev_io *bio)
+{
+	struct nvme_io_path *io_path = bio->io_path;
+	uint64_t tsc_diff, ewma;
+
+	if (io_path->nbdev_ch == NULL ||
+	    io_path->nbdev_ch->mp_selector != BDEV_NVME_MP_SELECTOR_LATENCY) {
+		return;
+	}
+
+	tsc_diff = spdk_get_ticks() - bio->submit_tsc;
+	ewma = io_path->ewma_latency_ticks;
+
+	if (spdk_unlikely(ewma == 0)) {
+		/* First sample primes the estimate. */
+		io_path->ewma_latency_ticks = tsc_diff;
+	} else if (tsc_diff > ewma) {
+		/* EWMA with alpha = 1/8. */
+		io_path->ewma_latency_ticks = ewma + (tsc_diff - ewma) / 8;
+	} else {
+		io_path->ewma_latency_ticks = ewma - (ewma - tsc_diff) / 8;
+	}
+}
+
 static inline void
 bdev_nvme_update_io_path_stat(struct nvme_bdev_io *bio)
 {
@@ -1385,6 +1482,7 @@ bdev_nvme_io_complete_nvme_status(struct nvme_bdev_io *bio,
 	assert(!bdev_nvme_io_type_is_admin(bdev_io->type));
 
 	if (spdk_likely(spdk_nvme_cpl_is_success(cpl))) {
+		bdev_nvme_update_io_path_latency(bio);
 		bdev_nvme_update_io_path_stat(bio);
 		goto complete;
 	}
@@ -1643,8 +1741,12 @@ bdev_nvme_poll(void *arg)
 		group->start_ticks = spdk_get_ticks();
 	}
 
+	group->accel_collect = true;
 	num_completions = spdk_nvme_poll_group_process_completions(group->group, 0,
 			  bdev_nvme_disconnected_qpair_cb);
+	group->accel_collect = false;
+	bdev_nvme_flush_accel_batch(group);
+
 	if (group->collect_spin_stat) {
 		if (num_completions > 0) {
 			if (group->end_ticks != 0) {
@@ -1666,42 +1768,157 @@ bdev_nvme_poll(void *arg)
 
 static int bdev_nvme_poll_adminq(void *arg);
 
+struct nvme_adminq_poller {
+	struct spdk_thread		*thread;
+	struct spdk_poller		*poller;
+	uint64_t			period_us;
+	TAILQ_HEAD(, nvme_ctrlr)	ctrlrs;
+	TAILQ_ENTRY(nvme_adminq_poller)	tailq;
+};
+
+static TAILQ_HEAD(, nvme_adminq_poller) g_adminq_pollers = TAILQ_HEAD_INITIALIZER(
+			g_adminq_pollers);
+
+static struct nvme_adminq_poller *
+bdev_nvme_get_adminq_poller(void)
+{
+	struct spdk_thread *thread = spdk_get_thread();
+	struct nvme_adminq_poller *poller;
+
+	pthread_mutex_lock(&g_bdev_nvme_mutex);
+	TAILQ_FOREACH(poller, &g_adminq_pollers, tailq) {
+		if (poller->thread == thread) {
+			pthread_mutex_unlock(&g_bdev_nvme_mutex);
+			return poller;
+		}
+	}
+	pthread_mutex_unlock(&g_bdev_nvme_mutex);
+
+	poller = calloc(1, sizeof(*poller));
+	if (poller == NULL) {
+		return NULL;
+	}
+
+	poller->thread = thread;
+	TAILQ_INIT(&poller->ctrlrs);
+
+	pthread_mutex_lock(&g_bdev_nvme_mutex);
+	TAILQ_INSERT_TAIL(&g_adminq_pollers, poller, tailq);
+	pthread_mutex_unlock(&g_bdev_nvme_mutex);
+
+	return poller;
+}
+
+/* Re-arm the shared poller after its set of controllers or their requested
+ * periods changed.  The poller runs at the minimum period over all of its
+ * controllers and is torn down once the last one detaches. */
+static void
+bdev_nvme_update_adminq_poller(struct nvme_adminq_poller *poller)
+{
+	struct nvme_ctrlr *nvme_ctrlr;
+	uint64_t period_us = UINT64_MAX;
+
+	if (TAILQ_EMPTY(&poller->ctrlrs)) {
+		pthread_mutex_lock(&g_bdev_nvme_mutex);
+		TAILQ_REMOVE(&g_adminq_pollers, poller, tailq);
+		pthread_mutex_unlock(&g_bdev_nvme_mutex);
+
+		spdk_poller_unregister(&poller->poller);
+		free(poller);
+		return;
+	}
+
+	TAILQ_FOREACH(nvme_ctrlr, &poller->ctrlrs, adminq_tailq) {
+		period_us = spdk_min(period_us, nvme_ctrlr->adminq_poll_period_us);
+	}
+
+	if (poller->poller != NULL && period_us == poller->period_us) {
+		return;
+	}
+
+	spdk_poller_unregister(&poller->poller);
+	poller->period_us = period_us;
+	poller->poller = SPDK_POLLER_REGISTER(bdev_nvme_poll_adminq, poller, period_us);
+}
+
 static void
 bdev_nvme_change_adminq_poll_period(struct nvme_ctrlr *nvme_ctrlr, uint64_t new_period_us)
 {
-	spdk_poller_unregister(&nvme_ctrlr->adminq_timer_poller);
+	nvme_ctrlr->adminq_poll_period_us = new_period_us;
 
-	nvme_ctrlr->adminq_timer_poller = SPDK_POLLER_REGISTER(bdev_nvme_poll_adminq,
-					  nvme_ctrlr, new_period_us);
+	if (nvme_ctrlr->adminq_poller != NULL) {
+		bdev_nvme_update_adminq_poller(nvme_ctrlr->adminq_poller);
+	}
+}
+
+static int
+bdev_nvme_register_adminq_poll(struct nvme_ctrlr *nvme_ctrlr, uint64_t period_us)
+{
+	struct nvme_adminq_poller *poller;
+
+	poller = bdev_nvme_get_adminq_poller();
+	if (poller == NULL) {
+		return -ENOMEM;
+	}
+
+	nvme_ctrlr->adminq_poller = poller;
+	nvme_ctrlr->adminq_poll_period_us = period_us;
+	nvme_ctrlr->adminq_paused = false;
+	TAILQ_INSERT_TAIL(&poller->ctrlrs, nvme_ctrlr, adminq_tailq);
+	bdev_nvme_update_adminq_poller(poller);
+
+	return 0;
+}
+
+static void
+bdev_nvme_unregister_adminq_poll(struct nvme_ctrlr *nvme_ctrlr)
+{
+	struct nvme_adminq_poller *poller = nvme_ctrlr->adminq_poller;
+
+	if (poller == NULL) {
+		return;
+	}
+
+	nvme_ctrlr->adminq_poller = NULL;
+	TAILQ_REMOVE(&poller->ctrlrs, nvme_ctrlr, adminq_tailq);
+	bdev_nvme_update_adminq_poller(poller);
 }
 
 static int
 bdev_nvme_poll_adminq(void *arg)
 {
-	int32_t rc;
-	struct nvme_ctrlr *nvme_ctrlr = arg;
+	struct nvme_adminq_poller *poller = arg;
+	struct nvme_ctrlr *nvme_ctrlr, *tmp;
 	nvme_ctrlr_disconnected_cb disconnected_cb;
+	bool busy = false;
+	int32_t rc;
 
-	assert(nvme_ctrlr != NULL);
+	TAILQ_FOREACH_SAFE(nvme_ctrlr, &poller->ctrlrs, adminq_tailq, tmp) {
+		if (nvme_ctrlr->adminq_paused) {
+			continue;
+		}
 
-	rc = spdk_nvme_ctrlr_process_admin_completions(nvme_ctrlr->ctrlr);
-	if (rc < 0) {
-		disconnected_cb = nvme_ctrlr->disconnected_cb;
-		nvme_ctrlr->disconnected_cb = NULL;
+		rc = spdk_nvme_ctrlr_process_admin_completions(nvme_ctrlr->ctrlr);
+		if (rc < 0) {
+			disconnected_cb = nvme_ctrlr->disconnected_cb;
+			nvme_ctrlr->disconnected_cb = NULL;
 
-		if (disconnected_cb != NULL) {
-			bdev_nvme_change_adminq_poll_period(nvme_ctrlr,
-							    g_opts.nvme_adminq_poll_period_us);
-			disconnected_cb(nvme_ctrlr);
-		} else {
-			bdev_nvme_failover_ctrlr(nvme_ctrlr);
+			if (disconnected_cb != NULL) {
+				bdev_nvme_change_adminq_poll_period(nvme_ctrlr,
+								    g_opts.nvme_adminq_poll_period_us);
+				disconnected_cb(nvme_ctrlr);
+			} else {
+				bdev_nvme_failover_ctrlr(nvme_ctrlr);
+			}
+		} else if (spdk_nvme_ctrlr_get_admin_qp_failure_reason(nvme_ctrlr->ctrlr) !=
+			   SPDK_NVME_QPAIR_FAILURE_NONE) {
+			bdev_nvme_clear_io_path_caches(nvme_ctrlr);
 		}
-	} else if (spdk_nvme_ctrlr_get_admin_qp_failure_reason(nvme_ctrlr->ctrlr) !=
-		   SPDK_NVME_QPAIR_FAILURE_NONE) {
-		bdev_nvme_clear_io_path_caches(nvme_ctrlr);
+
+		busy = busy || rc != 0;
 	}
 
-	return rc == 0 ? SPDK_POLLER_IDLE : SPDK_POLLER_BUSY;
+	return busy ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
 }
 
 static void
@@ -1763,6 +1980,7 @@ bdev_nvme_create_qpair(struct nvme_qpair *nvme_qpair)
 	opts.delay_cmd_submit = g_opts.delay_cmd_submit;
 	opts.create_only = true;
 	opts.async_mode = true;
+	opts.qprio = nvme_ctrlr->opts.qprio;
 	opts.io_queue_requests = spdk_max(g_opts.io_queue_requests, opts.io_queue_requests);
 	g_opts.io_queue_requests = opts.io_queue_requests;
 
@@ -2022,7 +2240,7 @@ bdev_nvme_reconnect_delay_timer_expired(void *ctx)
 
 	pthread_mutex_unlock(&nvme_ctrlr->mutex);
 
-	spdk_poller_resume(nvme_ctrlr->adminq_timer_poller);
+	nvme_ctrlr->adminq_paused = false;
 
 	bdev_nvme_reconnect_ctrlr(nvme_ctrlr);
 	return SPDK_POLLER_BUSY;
@@ -2031,7 +2249,7 @@ bdev_nvme_reconnect_delay_timer_expired(void *ctx)
 static void
 bdev_nvme_start_reconnect_delay_timer(struct nvme_ctrlr *nvme_ctrlr)
 {
-	spdk_poller_pause(nvme_ctrlr->adminq_timer_poller);
+	nvme_ctrlr->adminq_paused = true;
 
 	assert(nvme_ctrlr->reconnect_is_delayed == false);
 	nvme_ctrlr->reconnect_is_delayed = true;
@@ -2329,7 +2547,7 @@ bdev_nvme_reconnect_ctrlr_now(void *ctx)
 
 	spdk_poller_unregister(&nvme_ctrlr->reconnect_delay_timer);
 
-	spdk_poller_resume(nvme_ctrlr->adminq_timer_poller);
+	nvme_ctrlr->adminq_paused = false;
 
 	bdev_nvme_reconnect_ctrlr(nvme_ctrlr);
 }
@@ -2443,7 +2661,7 @@ _bdev_nvme_disable_ctrlr_complete(struct spdk_io_channel_iter *i, int status)
 	op_after_disable = bdev_nvme_check_op_after_reset(nvme_ctrlr, true);
 
 	nvme_ctrlr->disabled = true;
-	spdk_poller_pause(nvme_ctrlr->adminq_timer_poller);
+	nvme_ctrlr->adminq_paused = true;
 
 	pthread_mutex_unlock(&nvme_ctrlr->mutex);
 
@@ -2979,6 +3197,61 @@ exit:
 	}
 }
 
+static inline bool
+bdev_nvme_io_path_accel_sequence_supported(struct nvme_io_path *io_path)
+{
+	return spdk_nvme_ctrlr_get_flags(io_path->qpair->ctrlr->ctrlr) &
+	       SPDK_NVME_CTRLR_ACCEL_SEQUENCE_SUPPORTED;
+}
+
+/* Finish a write's accel sequence before submitting the command on a controller that cannot
+ * execute it as part of the command itself.  The sequence's destination is typically a buffer
+ * from the accel memory domain, so once the sequence completes, the data already sits in a
+ * DMA-able buffer that the command can transfer directly after translation - no bounce through
+ * an intermediate buffer is necessary.
+ */
+static void
+bdev_nvme_write_accel_sequence_done(void *ctx, int status)
+{
+	struct nvme_bdev_io *bio = ctx;
+	struct spdk_bdev_io *bdev_io = spdk_bdev_io_from_ctx(bio);
+	int ret;
+
+	bdev_io->u.bdev.accel_sequence = NULL;
+
+	if (spdk_unlikely(status != 0)) {
+		/* The sequence is gone at this point, so the IO cannot be retried by
+		 * resubmitting it - fail it outright.
+		 */
+		SPDK_ERRLOG("Failed to execute accel sequence, status=%d\n", status);
+		__bdev_nvme_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED, NULL);
+		return;
+	}
+
+	if (spdk_unlikely(!nvme_io_path_is_available(bio->io_path))) {
+		ret = -ENXIO;
+		goto exit;
+	}
+
+	ret = bdev_nvme_writev(bio,
+			       bdev_io->u.bdev.iovs,
+			       bdev_io->u.bdev.iovcnt,
+			       bdev_io->u.bdev.md_buf,
+			       bdev_io->u.bdev.num_blocks,
+			       bdev_io->u.bdev.offset_blocks,
+			       bdev_io->u.bdev.dif_check_flags,
+			       bdev_io->u.bdev.memory_domain,
+			       bdev_io->u.bdev.memory_domain_ctx,
+			       NULL,
+			       bdev_io->u.bdev.nvme_cdw12,
+			       bdev_io->u.bdev.nvme_cdw13);
+
+exit:
+	if (spdk_unlikely(ret != 0)) {
+		bdev_nvme_io_complete(bio, ret);
+	}
+}
+
 static inline void
 _bdev_nvme_submit_request(struct nvme_bdev_channel *nbdev_ch, struct spdk_bdev_io *bdev_io)
 {
@@ -3008,6 +3281,15 @@ _bdev_nvme_submit_request(struct nvme_bdev_channel *nbdev_ch, struct spdk_bdev_i
 		}
 		break;
 	case SPDK_BDEV_IO_TYPE_WRITE:
+		if (spdk_unlikely(bdev_io->u.bdev.accel_sequence != NULL &&
+				  !bdev_nvme_io_path_accel_sequence_supported(nbdev_io->io_path))) {
+			/* The controller cannot execute the sequence as part of the command, so
+			 * finish it here first and submit the command once the data is ready.
+			 */
+			spdk_accel_sequence_finish(bdev_io->u.bdev.accel_sequence,
+						   bdev_nvme_write_accel_sequence_done, nbdev_io);
+			return;
+		}
 		rc = bdev_nvme_writev(nbdev_io,
 				      bdev_io->u.bdev.iovs,
 				      bdev_io->u.bdev.iovcnt,
@@ -3075,6 +3357,11 @@ _bdev_nvme_submit_request(struct nvme_bdev_channel *nbdev_ch, struct spdk_bdev_i
 					     bdev_io->u.zone_mgmt.num_zones,
 					     bdev_io->u.zone_mgmt.buf);
 		break;
+	case SPDK_BDEV_IO_TYPE_GET_ZONE_INFO_RLE:
+		rc = bdev_nvme_get_zone_info_rle(nbdev_io,
+						 bdev_io->u.zone_mgmt.zone_id,
+						 bdev_io->u.zone_mgmt.num_zones);
+		break;
 	case SPDK_BDEV_IO_TYPE_ZONE_MANAGEMENT:
 		rc = bdev_nvme_zone_management(nbdev_io,
 					       bdev_io->u.zone_mgmt.zone_id,
@@ -3217,6 +3504,7 @@ bdev_nvme_io_type_supported(void *ctx, enum spdk_bdev_io_type io_type)
 		return false;
 
 	case SPDK_BDEV_IO_TYPE_GET_ZONE_INFO:
+	case SPDK_BDEV_IO_TYPE_GET_ZONE_INFO_RLE:
 	case SPDK_BDEV_IO_TYPE_ZONE_MANAGEMENT:
 		return spdk_nvme_ns_get_csi(ns) == SPDK_NVME_CSI_ZNS;
 
@@ -3379,12 +3667,42 @@ bdev_nvme_get_accel_channel(struct nvme_poll_group *group)
 	return group->accel_channel;
 }
 
+static void
+bdev_nvme_flush_accel_batch(struct nvme_poll_group *group)
+{
+	struct spdk_accel_submit_entry *entry;
+	uint32_t i;
+	int rc;
+
+	if (group->accel_batch_count == 0) {
+		return;
+	}
+
+	rc = spdk_accel_submit_batch(group->accel_channel, group->accel_batch,
+				     group->accel_batch_count);
+	if (spdk_unlikely(rc != 0)) {
+		/* Fall back to submitting the entries one by one */
+		for (i = 0; i < group->accel_batch_count; ++i) {
+			entry = &group->accel_batch[i];
+			rc = spdk_accel_submit_crc32c(group->accel_channel, entry->crc_dst,
+						      entry->src, entry->seed, entry->nbytes,
+						      entry->cb_fn, entry->cb_arg);
+			if (rc != 0) {
+				entry->cb_fn(entry->cb_arg, rc);
+			}
+		}
+	}
+
+	group->accel_batch_count = 0;
+}
+
 static void
 bdev_nvme_submit_accel_crc32c(void *ctx, uint32_t *dst, struct iovec *iov,
 			      uint32_t iov_cnt, uint32_t seed,
 			      spdk_nvme_accel_completion_cb cb_fn, void *cb_arg)
 {
 	struct spdk_io_channel *accel_ch;
+	struct spdk_accel_submit_entry *entry;
 	struct nvme_poll_group *group = ctx;
 	int rc;
 
@@ -3396,6 +3714,22 @@ bdev_nvme_submit_accel_crc32c(void *ctx, uint32_t *dst, struct iovec *iov,
 		return;
 	}
 
+	/* Digests requested while the poll group is processing completions are gathered and
+	 * submitted as a single batch at the end of the poll, saving a round trip through
+	 * the accel framework for each PDU. */
+	if (group->accel_collect && iov_cnt == 1 &&
+	    group->accel_batch_count < SPDK_ACCEL_MAX_SUBMIT_BATCH) {
+		entry = &group->accel_batch[group->accel_batch_count++];
+		entry->opcode = SPDK_ACCEL_OPC_CRC32C;
+		entry->src = iov[0].iov_base;
+		entry->crc_dst = dst;
+		entry->seed = seed;
+		entry->nbytes = iov[0].iov_len;
+		entry->cb_fn = cb_fn;
+		entry->cb_arg = cb_arg;
+		return;
+	}
+
 	rc = spdk_accel_submit_crc32cv(accel_ch, dst, iov, iov_cnt, seed, cb_fn, cb_arg);
 	if (rc) {
 		/* For the two cases, spdk_accel_submit_crc32cv does not call the user's cb_fn */
@@ -3778,6 +4112,8 @@ nvme_bdev_get_mp_selector_str(struct nvme_bdev *nbdev)
 		return "round_robin";
 	case BDEV_NVME_MP_SELECTOR_QUEUE_DEPTH:
 		return "queue_depth";
+	case BDEV_NVME_MP_SELECTOR_LATENCY:
+		return "latency";
 	default:
 		assert(false);
 		return "invalid";
@@ -3927,6 +4263,10 @@ bdev_nvme_accel_sequence_supported(void *ctx, enum spdk_bdev_io_type type)
 
 	switch (type) {
 	case SPDK_BDEV_IO_TYPE_WRITE:
+		/* Write sequences the controller cannot execute as part of the command are
+		 * finished right before submission, so they are always supported.
+		 */
+		return true;
 	case SPDK_BDEV_IO_TYPE_READ:
 		break;
 	default:
@@ -4150,6 +4490,8 @@ nvme_disk_create(struct spdk_bdev *disk, const char *base_name,
 		/* Enable if the Volatile Write Cache exists */
 		disk->write_cache = 1;
 	}
+	/* The NVMe write command always carries the FUA bit */
+	disk->fua_supported = true;
 	if (cdata->oncs.write_zeroes) {
 		disk->max_write_zeroes = UINT16_MAX + 1;
 	}
@@ -5153,6 +5495,7 @@ bdev_nvme_set_multipath_policy(const char *name, enum bdev_nvme_multipath_policy
 			}
 			break;
 		case BDEV_NVME_MP_SELECTOR_QUEUE_DEPTH:
+		case BDEV_NVME_MP_SELECTOR_LATENCY:
 			break;
 		default:
 			rc = -EINVAL;
@@ -5512,8 +5855,23 @@ nvme_ctrlr_create(struct spdk_nvme_ctrlr *ctrlr,
 		bdev_nvme_get_default_ctrlr_opts(&nvme_ctrlr->opts);
 	}
 
-	nvme_ctrlr->adminq_timer_poller = SPDK_POLLER_REGISTER(bdev_nvme_poll_adminq, nvme_ctrlr,
-					  g_opts.nvme_adminq_poll_period_us);
+	if (nvme_ctrlr->opts.qprio != SPDK_NVME_QPRIO_URGENT) {
+		union spdk_nvme_cap_register cap;
+
+		cap = spdk_nvme_ctrlr_get_regs_cap(ctrlr);
+		if (!(cap.bits.ams & SPDK_NVME_CAP_AMS_WRR)) {
+			SPDK_ERRLOG("Controller %s does not support weighted round robin "
+				    "arbitration required for I/O priority classes\n", name);
+			rc = -ENOTSUP;
+			goto err;
+		}
+	}
+
+	rc = bdev_nvme_register_adminq_poll(nvme_ctrlr, g_opts.nvme_adminq_poll_period_us);
+	if (rc != 0) {
+		SPDK_ERRLOG("Failed to register adminq poll\n");
+		goto err;
+	}
 
 	if (g_opts.timeout_us > 0) {
 		/* Register timeout callback. Timeout values for IO vs. admin reqs can be different. */
@@ -5561,6 +5919,7 @@ bdev_nvme_get_default_ctrlr_opts(struct nvme_ctrlr_opts *opts)
 	opts->ctrlr_loss_timeout_sec = g_opts.ctrlr_loss_timeout_sec;
 	opts->reconnect_delay_sec = g_opts.reconnect_delay_sec;
 	opts->fast_io_fail_timeout_sec = g_opts.fast_io_fail_timeout_sec;
+	opts->qprio = SPDK_NVME_QPRIO_URGENT;
 }
 
 static void
@@ -5643,6 +6002,13 @@ remove_cb(void *cb_ctx, struct spdk_nvme_ctrlr *ctrlr)
 	bdev_nvme_delete_ctrlr(nvme_ctrlr, true);
 }
 
+/* A single device stuck mid-initialization keeps the probe context alive,
+ * which blocks any new hotplug scan from starting.  The probe itself is
+ * pumped asynchronously so the app thread is not stalled, but warn so that
+ * the operator can tell why newly inserted devices stop showing up.
+ */
+#define NVME_HOTPLUG_PROBE_STALL_WARN_SEC 10
+
 static int
 bdev_nvme_hotplug_probe(void *arg)
 {
@@ -5653,7 +6019,15 @@ bdev_nvme_hotplug_probe(void *arg)
 
 	if (spdk_nvme_probe_poll_async(g_hotplug_probe_ctx) != -EAGAIN) {
 		g_hotplug_probe_ctx = NULL;
+		g_hotplug_probe_stall_logged = false;
 		spdk_poller_unregister(&g_hotplug_probe_poller);
+	} else if (!g_hotplug_probe_stall_logged &&
+		   spdk_get_ticks() - g_hotplug_probe_start_tsc >
+		   NVME_HOTPLUG_PROBE_STALL_WARN_SEC * spdk_get_ticks_hz()) {
+		g_hotplug_probe_stall_logged = true;
+		SPDK_WARNLOG("Hotplug probe is taking more than %d seconds, a device may be "
+			     "stuck initializing.  New hotplug scans are delayed until it "
+			     "completes.\n", NVME_HOTPLUG_PROBE_STALL_WARN_SEC);
 	}
 
 	return SPDK_POLLER_BUSY;
@@ -5665,7 +6039,7 @@ bdev_nvme_hotplug(void *arg)
 	struct spdk_nvme_transport_id trid_pcie;
 
 	if (g_hotplug_probe_ctx) {
-		return SPDK_POLLER_BUSY;
+		return SPDK_POLLER_IDLE;
 	}
 
 	memset(&trid_pcie, 0, sizeof(trid_pcie));
@@ -5676,6 +6050,7 @@ bdev_nvme_hotplug(void *arg)
 
 	if (g_hotplug_probe_ctx) {
 		assert(g_hotplug_probe_poller == NULL);
+		g_hotplug_probe_start_tsc = spdk_get_ticks();
 		g_hotplug_probe_poller = SPDK_POLLER_REGISTER(bdev_nvme_hotplug_probe, NULL, 1000);
 	}
 
@@ -6269,6 +6644,124 @@ bdev_nvme_create(struct spdk_nvme_transport_id *trid,
 	return 0;
 }
 
+struct nvme_attach_all_ctx {
+	struct spdk_nvme_probe_ctx	*probe_ctx;
+	struct spdk_poller		*poller;
+	char				*name_prefix;
+	uint32_t			next_index;
+	const char			**names;
+	size_t				count;
+	bdev_nvme_attach_all_fn		cb_fn;
+	void				*cb_ctx;
+};
+
+static void
+free_nvme_attach_all_ctx(struct nvme_attach_all_ctx *ctx)
+{
+	size_t i;
+
+	for (i = 0; i < ctx->count; i++) {
+		free((char *)ctx->names[i]);
+	}
+	free(ctx->names);
+	free(ctx->name_prefix);
+	free(ctx);
+}
+
+static void
+attach_all_attach_cb(void *cb_ctx, const struct spdk_nvme_transport_id *trid,
+		     struct spdk_nvme_ctrlr *ctrlr, const struct spdk_nvme_ctrlr_opts *drv_opts)
+{
+	struct nvme_attach_all_ctx *ctx = cb_ctx;
+	const char **names;
+	char *name;
+
+	for (;;) {
+		name = spdk_sprintf_alloc("%s%u", ctx->name_prefix, ctx->next_index++);
+		if (name == NULL) {
+			SPDK_ERRLOG("Failed to assign name to NVMe device\n");
+			return;
+		}
+		if (nvme_ctrlr_get_by_name(name) == NULL) {
+			break;
+		}
+		/* Name already taken, try the next index. */
+		free(name);
+	}
+
+	if (nvme_ctrlr_create(ctrlr, name, trid, NULL) != 0) {
+		SPDK_ERRLOG("Failed to attach to %s (%s)\n", trid->traddr, name);
+		free(name);
+		return;
+	}
+
+	SPDK_DEBUGLOG(bdev_nvme, "Attached to %s (%s)\n", trid->traddr, name);
+
+	names = realloc(ctx->names, (ctx->count + 1) * sizeof(*names));
+	if (names == NULL) {
+		/* The controller is attached, we just cannot report its name. */
+		free(name);
+		return;
+	}
+	names[ctx->count++] = name;
+	ctx->names = names;
+}
+
+static int
+bdev_nvme_attach_all_poll(void *arg)
+{
+	struct nvme_attach_all_ctx *ctx = arg;
+
+	if (spdk_nvme_probe_poll_async(ctx->probe_ctx) == -EAGAIN) {
+		return SPDK_POLLER_BUSY;
+	}
+
+	spdk_poller_unregister(&ctx->poller);
+	ctx->cb_fn(ctx->cb_ctx, ctx->names, ctx->count, 0);
+	free_nvme_attach_all_ctx(ctx);
+
+	return SPDK_POLLER_BUSY;
+}
+
+int
+bdev_nvme_attach_all_controllers(const char *name_prefix,
+				 bdev_nvme_attach_all_fn cb_fn, void *cb_ctx)
+{
+	struct nvme_attach_all_ctx *ctx;
+	struct spdk_nvme_transport_id trid_pcie;
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		return -ENOMEM;
+	}
+
+	ctx->name_prefix = strdup(name_prefix);
+	if (ctx->name_prefix == NULL) {
+		free(ctx);
+		return -ENOMEM;
+	}
+	ctx->cb_fn = cb_fn;
+	ctx->cb_ctx = cb_ctx;
+
+	memset(&trid_pcie, 0, sizeof(trid_pcie));
+	spdk_nvme_trid_populate_transport(&trid_pcie, SPDK_NVME_TRANSPORT_PCIE);
+
+	/* All controllers found by the scan initialize in parallel - every
+	 * spdk_nvme_probe_poll_async() call advances each controller's init
+	 * state machine, so the total attach time is bounded by the slowest
+	 * device rather than the sum over all of them.
+	 */
+	ctx->probe_ctx = spdk_nvme_probe_async(&trid_pcie, ctx, hotplug_probe_cb,
+					       attach_all_attach_cb, NULL);
+	if (ctx->probe_ctx == NULL) {
+		free_nvme_attach_all_ctx(ctx);
+		return -ENODEV;
+	}
+	ctx->poller = SPDK_POLLER_REGISTER(bdev_nvme_attach_all_poll, ctx, 1000);
+
+	return 0;
+}
+
 struct bdev_nvme_delete_ctx {
 	char                        *name;
 	struct nvme_path_id         path_id;
@@ -7462,44 +7955,57 @@ bdev_nvme_queued_done(void *ref, const struct spdk_nvme_cpl *cpl)
 }
 
 static int
-fill_zone_from_report(struct spdk_bdev_zone_info *info, struct spdk_nvme_zns_zone_desc *desc)
+zone_state_from_report(enum spdk_bdev_zone_state *state, uint8_t zs)
 {
-	switch (desc->zt) {
-	case SPDK_NVME_ZONE_TYPE_SEQWR:
-		info->type = SPDK_BDEV_ZONE_TYPE_SEQWR;
-		break;
-	default:
-		SPDK_ERRLOG("Invalid zone type: %#x in zone report\n", desc->zt);
-		return -EIO;
-	}
-
-	switch (desc->zs) {
+	switch (zs) {
 	case SPDK_NVME_ZONE_STATE_EMPTY:
-		info->state = SPDK_BDEV_ZONE_STATE_EMPTY;
+		*state = SPDK_BDEV_ZONE_STATE_EMPTY;
 		break;
 	case SPDK_NVME_ZONE_STATE_IOPEN:
-		info->state = SPDK_BDEV_ZONE_STATE_IMP_OPEN;
+		*state = SPDK_BDEV_ZONE_STATE_IMP_OPEN;
 		break;
 	case SPDK_NVME_ZONE_STATE_EOPEN:
-		info->state = SPDK_BDEV_ZONE_STATE_EXP_OPEN;
+		*state = SPDK_BDEV_ZONE_STATE_EXP_OPEN;
 		break;
 	case SPDK_NVME_ZONE_STATE_CLOSED:
-		info->state = SPDK_BDEV_ZONE_STATE_CLOSED;
+		*state = SPDK_BDEV_ZONE_STATE_CLOSED;
 		break;
 	case SPDK_NVME_ZONE_STATE_RONLY:
-		info->state = SPDK_BDEV_ZONE_STATE_READ_ONLY;
+		*state = SPDK_BDEV_ZONE_STATE_READ_ONLY;
 		break;
 	case SPDK_NVME_ZONE_STATE_FULL:
-		info->state = SPDK_BDEV_ZONE_STATE_FULL;
+		*state = SPDK_BDEV_ZONE_STATE_FULL;
 		break;
 	case SPDK_NVME_ZONE_STATE_OFFLINE:
-		info->state = SPDK_BDEV_ZONE_STATE_OFFLINE;
+		*state = SPDK_BDEV_ZONE_STATE_OFFLINE;
 		break;
 	default:
-		SPDK_ERRLOG("Invalid zone state: %#x in zone report\n", desc->zs);
+		SPDK_ERRLOG("Invalid zone state: %#x in zone report\n", zs);
 		return -EIO;
 	}
 
+	return 0;
+}
+
+static int
+fill_zone_from_report(struct spdk_bdev_zone_info *info, struct spdk_nvme_zns_zone_desc *desc)
+{
+	int ret;
+
+	switch (desc->zt) {
+	case SPDK_NVME_ZONE_TYPE_SEQWR:
+		info->type = SPDK_BDEV_ZONE_TYPE_SEQWR;
+		break;
+	default:
+		SPDK_ERRLOG("Invalid zone type: %#x in zone report\n", desc->zt);
+		return -EIO;
+	}
+
+	ret = zone_state_from_report(&info->state, desc->zs);
+	if (ret) {
+		return ret;
+	}
+
 	info->zone_id = desc->zslba;
 	info->write_pointer = desc->wp;
 	info->capacity = desc->zcap;
@@ -7584,6 +8090,102 @@ out_complete_io_ret:
 	bdev_nvme_io_complete(bio, ret);
 }
 
+static void
+bdev_nvme_get_zone_info_rle_done(void *ref, const struct spdk_nvme_cpl *cpl)
+{
+	struct nvme_bdev_io *bio = ref;
+	struct spdk_bdev_io *bdev_io = spdk_bdev_io_from_ctx(bio);
+	uint64_t zone_id = bdev_io->u.zone_mgmt.zone_id;
+	uint64_t num_zones = bdev_io->u.zone_mgmt.num_zones;
+	struct spdk_bdev_zone_run *runs = bdev_io->u.zone_mgmt.buf;
+	enum spdk_bdev_zone_state state;
+	uint64_t max_zones_per_buf, i;
+	uint32_t zone_report_bufsize;
+	struct spdk_nvme_ns *ns;
+	struct spdk_nvme_qpair *qpair;
+	int ret;
+
+	if (spdk_nvme_cpl_is_error(cpl)) {
+		goto out_complete_io_nvme_cpl;
+	}
+
+	if (spdk_unlikely(!nvme_io_path_is_available(bio->io_path))) {
+		ret = -ENXIO;
+		goto out_complete_io_ret;
+	}
+
+	ns = bio->io_path->nvme_ns->ns;
+	qpair = bio->io_path->qpair->qpair;
+
+	zone_report_bufsize = spdk_nvme_ns_get_max_io_xfer_size(ns);
+	max_zones_per_buf = (zone_report_bufsize - sizeof(*bio->zone_report_buf)) /
+			    sizeof(bio->zone_report_buf->descs[0]);
+
+	if (bio->zone_report_buf->nr_zones > max_zones_per_buf) {
+		ret = -EINVAL;
+		goto out_complete_io_ret;
+	}
+
+	if (!bio->zone_report_buf->nr_zones) {
+		ret = -EINVAL;
+		goto out_complete_io_ret;
+	}
+
+	for (i = 0; i < bio->zone_report_buf->nr_zones && bio->handled_zones < num_zones; i++) {
+		struct spdk_nvme_zns_zone_desc *desc = &bio->zone_report_buf->descs[i];
+
+		ret = zone_state_from_report(&state, desc->zs);
+		if (ret) {
+			goto out_complete_io_ret;
+		}
+
+		/* Descriptors arrive in ascending zslba order, so a zone in the same
+		 * state as the previous one always extends the current run.
+		 */
+		if (bdev_io->u.zone_mgmt.num_runs > 0 &&
+		    runs[bdev_io->u.zone_mgmt.num_runs - 1].state == state) {
+			runs[bdev_io->u.zone_mgmt.num_runs - 1].num_zones++;
+		} else {
+			if (bdev_io->u.zone_mgmt.num_runs == bdev_io->u.zone_mgmt.max_runs) {
+				ret = -EOVERFLOW;
+				goto out_complete_io_ret;
+			}
+			runs[bdev_io->u.zone_mgmt.num_runs].zone_id = desc->zslba;
+			runs[bdev_io->u.zone_mgmt.num_runs].num_zones = 1;
+			runs[bdev_io->u.zone_mgmt.num_runs].state = state;
+			bdev_io->u.zone_mgmt.num_runs++;
+		}
+		bio->handled_zones++;
+	}
+
+	if (bio->handled_zones < num_zones) {
+		uint64_t zone_size_lba = spdk_nvme_zns_ns_get_zone_size_sectors(ns);
+		uint64_t slba = zone_id + (zone_size_lba * bio->handled_zones);
+
+		memset(bio->zone_report_buf, 0, zone_report_bufsize);
+		ret = spdk_nvme_zns_report_zones(ns, qpair,
+						 bio->zone_report_buf, zone_report_bufsize,
+						 slba, SPDK_NVME_ZRA_LIST_ALL, true,
+						 bdev_nvme_get_zone_info_rle_done, bio);
+		if (!ret) {
+			return;
+		} else {
+			goto out_complete_io_ret;
+		}
+	}
+
+out_complete_io_nvme_cpl:
+	free(bio->zone_report_buf);
+	bio->zone_report_buf = NULL;
+	bdev_nvme_io_complete_nvme_status(bio, cpl);
+	return;
+
+out_complete_io_ret:
+	free(bio->zone_report_buf);
+	bio->zone_report_buf = NULL;
+	bdev_nvme_io_complete(bio, ret);
+}
+
 static void
 bdev_nvme_zone_management_done(void *ref, const struct spdk_nvme_cpl *cpl)
 {
@@ -7808,6 +8410,35 @@ bdev_nvme_readv(struct nvme_bdev_io *bio, struct iovec *iov, int iovcnt,
 	return rc;
 }
 
+/* Translate a buffer from the accel memory domain to the DMA-able buffer backing it.  Buffers
+ * from that domain always describe a single contiguous range, so a single iovec is enough to
+ * hold the result.
+ */
+static int
+bdev_nvme_translate_accel_buf(struct nvme_bdev_io *bio, struct iovec *iov, int iovcnt,
+			      void *domain_ctx)
+{
+	struct spdk_memory_domain_translation_result result;
+	int rc;
+
+	if (spdk_unlikely(iovcnt != 1)) {
+		return -ENOTSUP;
+	}
+
+	result.size = sizeof(result);
+	rc = spdk_memory_domain_translate_data(spdk_accel_get_memory_domain(), domain_ctx,
+					       spdk_memory_domain_get_system_domain(), NULL,
+					       iov[0].iov_base, iov[0].iov_len, &result);
+	if (spdk_unlikely(rc != 0)) {
+		return rc;
+	}
+
+	assert(result.iov_count == 1);
+	bio->accel_iov = result.iov;
+
+	return 0;
+}
+
 static int
 bdev_nvme_writev(struct nvme_bdev_io *bio, struct iovec *iov, int iovcnt,
 		 void *md, uint64_t lba_count, uint64_t lba, uint32_t flags,
@@ -7822,6 +8453,25 @@ bdev_nvme_writev(struct nvme_bdev_io *bio, struct iovec *iov, int iovcnt,
 	SPDK_DEBUGLOG(bdev_nvme, "write %" PRIu64 " blocks with offset %#" PRIx64 "\n",
 		      lba_count, lba);
 
+	if (cdw12.write.fua) {
+		flags |= SPDK_NVME_IO_FLAGS_FORCE_UNIT_ACCESS;
+	}
+
+	if (spdk_unlikely(domain == spdk_accel_get_memory_domain() && seq == NULL)) {
+		/* The accel sequence producing the data has already been executed, so the data
+		 * can be transferred straight out of the accel buffer backing this iovec.
+		 */
+		rc = bdev_nvme_translate_accel_buf(bio, iov, iovcnt, domain_ctx);
+		if (spdk_unlikely(rc != 0)) {
+			return rc;
+		}
+
+		iov = &bio->accel_iov;
+		iovcnt = 1;
+		domain = NULL;
+		domain_ctx = NULL;
+	}
+
 	bio->iovs = iov;
 	bio->iovcnt = iovcnt;
 	bio->iovpos = 0;
@@ -8078,6 +8728,36 @@ bdev_nvme_get_zone_info(struct nvme_bdev_io *bio, uint64_t zone_id, uint32_t num
 					  bdev_nvme_get_zone_info_done, bio);
 }
 
+static int
+bdev_nvme_get_zone_info_rle(struct nvme_bdev_io *bio, uint64_t zone_id, uint64_t num_zones)
+{
+	struct spdk_nvme_ns *ns = bio->io_path->nvme_ns->ns;
+	struct spdk_nvme_qpair *qpair = bio->io_path->qpair->qpair;
+	uint32_t zone_report_bufsize = spdk_nvme_ns_get_max_io_xfer_size(ns);
+	uint64_t zone_size = spdk_nvme_zns_ns_get_zone_size_sectors(ns);
+	uint64_t total_zones = spdk_nvme_zns_ns_get_num_zones(ns);
+
+	if (zone_id % zone_size != 0) {
+		return -EINVAL;
+	}
+
+	if (num_zones > total_zones || !num_zones) {
+		return -EINVAL;
+	}
+
+	assert(!bio->zone_report_buf);
+	bio->zone_report_buf = calloc(1, zone_report_bufsize);
+	if (!bio->zone_report_buf) {
+		return -ENOMEM;
+	}
+
+	bio->handled_zones = 0;
+
+	return spdk_nvme_zns_report_zones(ns, qpair, bio->zone_report_buf, zone_report_bufsize,
+					  zone_id, SPDK_NVME_ZRA_LIST_ALL, true,
+					  bdev_nvme_get_zone_info_rle_done, bio);
+}
+
 static int
 bdev_nvme_zone_management(struct nvme_bdev_io *bio, uint64_t zone_id,
 			  enum spdk_bdev_zone_action action)
@@ -8441,6 +9121,19 @@ nvme_ctrlr_config_json(struct spdk_json_write_ctx *w,
 	spdk_json_write_named_uint32(w, "reconnect_delay_sec", nvme_ctrlr->opts.reconnect_delay_sec);
 	spdk_json_write_named_uint32(w, "fast_io_fail_timeout_sec",
 				     nvme_ctrlr->opts.fast_io_fail_timeout_sec);
+	switch (nvme_ctrlr->opts.qprio) {
+	case SPDK_NVME_QPRIO_HIGH:
+		spdk_json_write_named_string(w, "priority_class", "high");
+		break;
+	case SPDK_NVME_QPRIO_MEDIUM:
+		spdk_json_write_named_string(w, "priority_class", "medium");
+		break;
+	case SPDK_NVME_QPRIO_LOW:
+		spdk_json_write_named_string(w, "priority_class", "low");
+		break;
+	default:
+		break;
+	}
 	if (nvme_ctrlr->psk != NULL) {
 		spdk_json_write_named_string(w, "psk", spdk_key_get_name(nvme_ctrlr->psk));
 	} else if (nvme_ctrlr->opts.psk[0] != '\0') {
@@ -10,6 +10,7 @@
 
 #include "spdk/stdinc.h"
 
+#include "spdk/accel.h"
 #include "spdk/queue.h"
 #include "spdk/nvme.h"
 #include "spdk/bdev_module.h"
@@ -31,6 +32,7 @@ enum bdev_nvme_multipath_policy {
 enum bdev_nvme_multipath_selector {
 	BDEV_NVME_MP_SELECTOR_ROUND_ROBIN = 1,
 	BDEV_NVME_MP_SELECTOR_QUEUE_DEPTH,
+	BDEV_NVME_MP_SELECTOR_LATENCY,
 };
 
 typedef void (*spdk_bdev_create_nvme_fn)(void *ctx, size_t bdev_count, int rc);
@@ -43,6 +45,10 @@ struct nvme_ctrlr_opts {
 	uint32_t reconnect_delay_sec;
 	uint32_t fast_io_fail_timeout_sec;
 	bool from_discovery_service;
+	/* Weighted round robin priority class for the controller's I/O qpairs.
+	 * Requires a controller supporting WRR arbitration.
+	 */
+	enum spdk_nvme_qprio qprio;
 	/* Name of the PSK or path to the file containing PSK. */
 	char psk[PATH_MAX];
 	const char *dhchap_key;
@@ -104,6 +110,10 @@ struct nvme_path_id {
 typedef void (*bdev_nvme_ctrlr_op_cb)(void *cb_arg, int rc);
 typedef void (*nvme_ctrlr_disconnected_cb)(struct nvme_ctrlr *nvme_ctrlr);
 
+/* Shared per-thread admin queue poller, sweeping all controllers attached on
+ * that thread in a single pass. */
+struct nvme_adminq_poller;
+
 struct nvme_ctrlr {
 	/**
 	 * points to pinned, physically contiguous memory region;
@@ -131,7 +141,13 @@ struct nvme_ctrlr {
 
 	struct spdk_opal_dev			*opal_dev;
 
-	struct spdk_poller			*adminq_timer_poller;
+	/* The thread's shared admin queue poller this controller is swept by */
+	struct nvme_adminq_poller		*adminq_poller;
+	TAILQ_ENTRY(nvme_ctrlr)			adminq_tailq;
+	/* Period this controller wants its admin queue polled at; the shared
+	 * poller runs at the minimum over all of its controllers. */
+	uint64_t				adminq_poll_period_us;
+	bool					adminq_paused;
 	struct spdk_thread			*thread;
 
 	bdev_nvme_ctrlr_op_cb			ctrlr_op_cb_fn;
@@ -221,6 +237,9 @@ struct nvme_io_path {
 
 	/* allocation of stat is decided by option io_path_stat of RPC bdev_nvme_set_options */
 	struct spdk_bdev_io_stat	*stat;
+
+	/* EWMA of completion latency in ticks, used by the latency multipath selector. */
+	uint64_t			ewma_latency_ticks;
 };
 
 struct nvme_bdev_channel {
@@ -229,6 +248,7 @@ struct nvme_bdev_channel {
 	enum bdev_nvme_multipath_selector	mp_selector;
 	uint32_t				rr_min_io;
 	uint32_t				rr_counter;
+	uint32_t				latency_probe_counter;
 	STAILQ_HEAD(, nvme_io_path)		io_path_list;
 	TAILQ_HEAD(retry_io_head, spdk_bdev_io)	retry_io_list;
 	struct spdk_poller			*retry_io_poller;
@@ -242,6 +262,12 @@ struct nvme_poll_group {
 	uint64_t				spin_ticks;
 	uint64_t				start_ticks;
 	uint64_t				end_ticks;
+	/* While true (i.e. inside bdev_nvme_poll()), crc32c operations requested by the
+	 * transports are gathered in accel_batch and submitted in a single
+	 * spdk_accel_submit_batch() call at the end of the poll. */
+	bool					accel_collect;
+	uint32_t				accel_batch_count;
+	struct spdk_accel_submit_entry		accel_batch[SPDK_ACCEL_MAX_SUBMIT_BATCH];
 	TAILQ_HEAD(, nvme_qpair)		qpair_list;
 };
 
@@ -325,6 +351,24 @@ int bdev_nvme_create(struct spdk_nvme_transport_id *trid,
 		     struct nvme_ctrlr_opts *bdev_opts,
 		     bool multipath);
 
+typedef void (*bdev_nvme_attach_all_fn)(void *cb_ctx, const char **ctrlr_names,
+					size_t ctrlr_count, int rc);
+
+/**
+ * Scan the PCIe bus and attach every NVMe controller that is not attached yet.
+ * All discovered controllers are initialized in parallel, so the total attach
+ * time is bounded by the slowest device. Controllers are named by appending an
+ * index to name_prefix. Namespaces are populated asynchronously after the
+ * callback fires, the same way hotplugged controllers are handled.
+ *
+ * \param name_prefix Prefix used to generate controller names.
+ * \param cb_fn Callback invoked with the attached controller names once the
+ * probe completes. The names are only valid for the duration of the callback.
+ * \param cb_ctx Context passed to cb_fn.
+ */
+int bdev_nvme_attach_all_controllers(const char *name_prefix,
+				     bdev_nvme_attach_all_fn cb_fn, void *cb_ctx);
+
 int bdev_nvme_start_discovery(struct spdk_nvme_transport_id *trid, const char *base_name,
 			      struct spdk_nvme_ctrlr_opts *drv_opts, struct nvme_ctrlr_opts *bdev_opts,
 			      uint64_t timeout, bool from_mdns,
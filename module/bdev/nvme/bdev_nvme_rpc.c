@@ -312,6 +312,28 @@ bdev_nvme_decode_multipath(const struct spdk_json_val *val, void *out)
 }
 
 
+static int
+bdev_nvme_decode_priority_class(const struct spdk_json_val *val, void *out)
+{
+	enum spdk_nvme_qprio *qprio = out;
+
+	if (spdk_json_strequal(val, "urgent") == true) {
+		*qprio = SPDK_NVME_QPRIO_URGENT;
+	} else if (spdk_json_strequal(val, "high") == true) {
+		*qprio = SPDK_NVME_QPRIO_HIGH;
+	} else if (spdk_json_strequal(val, "medium") == true) {
+		*qprio = SPDK_NVME_QPRIO_MEDIUM;
+	} else if (spdk_json_strequal(val, "low") == true) {
+		*qprio = SPDK_NVME_QPRIO_LOW;
+	} else {
+		SPDK_NOTICELOG("Invalid parameter value: priority_class\n");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+
 static const struct spdk_json_object_decoder rpc_bdev_nvme_attach_controller_decoders[] = {
 	{"name", offsetof(struct rpc_bdev_nvme_attach_controller, name), spdk_json_decode_string},
 	{"trtype", offsetof(struct rpc_bdev_nvme_attach_controller, trtype), spdk_json_decode_string},
@@ -339,6 +361,7 @@ static const struct spdk_json_object_decoder rpc_bdev_nvme_attach_controller_dec
 	{"max_bdevs", offsetof(struct rpc_bdev_nvme_attach_controller, max_bdevs), spdk_json_decode_uint32, true},
 	{"dhchap_key", offsetof(struct rpc_bdev_nvme_attach_controller, dhchap_key), spdk_json_decode_string, true},
 	{"dhchap_ctrlr_key", offsetof(struct rpc_bdev_nvme_attach_controller, dhchap_ctrlr_key), spdk_json_decode_string, true},
+	{"priority_class", offsetof(struct rpc_bdev_nvme_attach_controller, bdev_opts.qprio), bdev_nvme_decode_priority_class, true},
 };
 
 #define DEFAULT_MAX_BDEVS_PER_RPC 128
@@ -433,6 +456,13 @@ rpc_bdev_nvme_attach_controller(struct spdk_jsonrpc_request *request,
 		goto cleanup;
 	}
 
+	if (ctx->req.bdev_opts.qprio != SPDK_NVME_QPRIO_URGENT) {
+		/* Priority classes only take effect when the controller is enabled
+		 * with weighted round robin arbitration.
+		 */
+		ctx->req.drv_opts.arb_mechanism = SPDK_NVME_CC_AMS_WRR;
+	}
+
 	ctx->names = calloc(ctx->req.max_bdevs, sizeof(char *));
 	if (ctx->names == NULL) {
 		spdk_jsonrpc_send_error_response(request, -ENOMEM, spdk_strerror(ENOMEM));
@@ -639,6 +669,64 @@ cleanup:
 SPDK_RPC_REGISTER("bdev_nvme_attach_controller", rpc_bdev_nvme_attach_controller,
 		  SPDK_RPC_RUNTIME)
 
+struct rpc_bdev_nvme_attach_all_controllers {
+	char *name_prefix;
+};
+
+static const struct spdk_json_object_decoder rpc_bdev_nvme_attach_all_controllers_decoders[] = {
+	{"name_prefix", offsetof(struct rpc_bdev_nvme_attach_all_controllers, name_prefix), spdk_json_decode_string, true},
+};
+
+static void
+rpc_bdev_nvme_attach_all_controllers_done(void *cb_ctx, const char **ctrlr_names,
+		size_t ctrlr_count, int rc)
+{
+	struct spdk_jsonrpc_request *request = cb_ctx;
+	struct spdk_json_write_ctx *w;
+	size_t i;
+
+	if (rc < 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+		return;
+	}
+
+	w = spdk_jsonrpc_begin_result(request);
+	spdk_json_write_array_begin(w);
+	for (i = 0; i < ctrlr_count; i++) {
+		spdk_json_write_string(w, ctrlr_names[i]);
+	}
+	spdk_json_write_array_end(w);
+	spdk_jsonrpc_end_result(request, w);
+}
+
+static void
+rpc_bdev_nvme_attach_all_controllers(struct spdk_jsonrpc_request *request,
+				     const struct spdk_json_val *params)
+{
+	struct rpc_bdev_nvme_attach_all_controllers req = {};
+	int rc;
+
+	if (params != NULL &&
+	    spdk_json_decode_object(params, rpc_bdev_nvme_attach_all_controllers_decoders,
+				    SPDK_COUNTOF(rpc_bdev_nvme_attach_all_controllers_decoders),
+				    &req)) {
+		SPDK_ERRLOG("spdk_json_decode_object failed\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "spdk_json_decode_object failed");
+		return;
+	}
+
+	rc = bdev_nvme_attach_all_controllers(req.name_prefix ? req.name_prefix : "Nvme",
+					      rpc_bdev_nvme_attach_all_controllers_done, request);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+	}
+
+	free(req.name_prefix);
+}
+SPDK_RPC_REGISTER("bdev_nvme_attach_all_controllers", rpc_bdev_nvme_attach_all_controllers,
+		  SPDK_RPC_RUNTIME)
+
 static void
 rpc_dump_nvme_bdev_controller_info(struct nvme_bdev_ctrlr *nbdev_ctrlr, void *ctx)
 {
@@ -2329,6 +2417,8 @@ rpc_decode_mp_selector(const struct spdk_json_val *val, void *out)
 		*selector = BDEV_NVME_MP_SELECTOR_ROUND_ROBIN;
 	} else if (spdk_json_strequal(val, "queue_depth") == true) {
 		*selector = BDEV_NVME_MP_SELECTOR_QUEUE_DEPTH;
+	} else if (spdk_json_strequal(val, "latency") == true) {
+		*selector = BDEV_NVME_MP_SELECTOR_LATENCY;
 	} else {
 		SPDK_NOTICELOG("Invalid parameter value: selector\n");
 		return -EINVAL;
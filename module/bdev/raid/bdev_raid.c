@@ -13,10 +13,19 @@
 #include "spdk/json.h"
 #include "spdk/likely.h"
 
-#define RAID_OFFSET_BLOCKS_INVALID	UINT64_MAX
 #define RAID_BDEV_PROCESS_MAX_QD	16
 
 #define RAID_BDEV_PROCESS_WINDOW_SIZE_KB_DEFAULT 1024
+#define RAID_BDEV_PROCESS_MAX_BANDWIDTH_MB_SEC_DEFAULT 0
+
+/* Period of the background process bandwidth budget refill poller */
+#define RAID_BDEV_PROCESS_BUDGET_PERIOD_US	(100 * 1000)
+
+/* Factor by which the budget refill is reduced while foreground I/O is outstanding */
+#define RAID_BDEV_PROCESS_PRESSURE_DIVISOR	4
+
+/* Persist a background process checkpoint in the superblock after this much progress */
+#define RAID_BDEV_PROCESS_CHECKPOINT_STEP_BYTES	(1024ULL * 1024 * 1024)
 
 static bool g_shutdown_started = false;
 
@@ -33,6 +42,10 @@ struct raid_bdev_io_channel {
 	/* Array of IO channels of base bdevs */
 	struct spdk_io_channel	**base_channel;
 
+	/* Number of entries in base_channel. May temporarily differ from the raid bdev's
+	 * num_base_bdevs while the raid is being grown by a new base bdev. */
+	uint8_t			num_base_channels;
+
 	/* Private raid module IO channel */
 	struct spdk_io_channel	*module_channel;
 
@@ -64,6 +77,12 @@ struct raid_bdev_process {
 	int				window_status;
 	uint64_t			window_offset;
 	bool				window_range_locked;
+	uint64_t			max_bandwidth_blocks;
+	uint64_t			window_budget;
+	bool				waiting_for_budget;
+	struct spdk_poller		*budget_poller;
+	uint64_t			checkpoint_step;
+	uint64_t			checkpoint_offset;
 	struct raid_base_bdev_info	*target;
 	int				status;
 	TAILQ_HEAD(, raid_process_finish_action) finish_actions;
@@ -77,6 +96,7 @@ struct raid_process_finish_action {
 
 static struct spdk_raid_bdev_opts g_opts = {
 	.process_window_size_kb = RAID_BDEV_PROCESS_WINDOW_SIZE_KB_DEFAULT,
+	.process_max_bandwidth_mb_sec = RAID_BDEV_PROCESS_MAX_BANDWIDTH_MB_SEC_DEFAULT,
 };
 
 void
@@ -159,6 +179,7 @@ raid_bdev_channel_get_base_info(struct raid_bdev_io_channel *raid_ch, struct spd
 /* Function declarations */
 static void	raid_bdev_examine(struct spdk_bdev *bdev);
 static int	raid_bdev_init(void);
+static void	raid_bdev_process_checkpoint_invalidate(void *ctx);
 static void	raid_bdev_deconfigure(struct raid_bdev *raid_bdev,
 				      raid_bdev_destruct_cb cb_fn, void *cb_arg);
 
@@ -258,8 +279,9 @@ raid_bdev_create_cb(void *io_device, void *ctx_buf)
 		SPDK_ERRLOG("Unable to allocate base bdevs io channel\n");
 		return -ENOMEM;
 	}
+	raid_ch->num_base_channels = raid_bdev->num_base_bdevs;
 
-	for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
+	for (i = 0; i < raid_ch->num_base_channels; i++) {
 		/*
 		 * Get the spdk_io_channel for all the base bdevs. This is used during
 		 * split logic to send the respective child bdev ios to respective base
@@ -299,7 +321,7 @@ raid_bdev_create_cb(void *io_device, void *ctx_buf)
 
 	return 0;
 err:
-	for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
+	for (i = 0; i < raid_ch->num_base_channels; i++) {
 		if (raid_ch->base_channel[i] != NULL) {
 			spdk_put_io_channel(raid_ch->base_channel[i]);
 		}
@@ -324,7 +346,6 @@ err:
 static void
 raid_bdev_destroy_cb(void *io_device, void *ctx_buf)
 {
-	struct raid_bdev *raid_bdev = io_device;
 	struct raid_bdev_io_channel *raid_ch = ctx_buf;
 	uint8_t i;
 
@@ -337,7 +358,7 @@ raid_bdev_destroy_cb(void *io_device, void *ctx_buf)
 		spdk_put_io_channel(raid_ch->module_channel);
 	}
 
-	for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
+	for (i = 0; i < raid_ch->num_base_channels; i++) {
 		/* Free base bdev channels */
 		if (raid_ch->base_channel[i] != NULL) {
 			spdk_put_io_channel(raid_ch->base_channel[i]);
@@ -644,6 +665,7 @@ raid_bdev_io_complete(struct raid_bdev_io *raid_io, enum spdk_bdev_io_status sta
 				status = SPDK_BDEV_IO_STATUS_FAILED;
 			}
 		}
+		__atomic_fetch_sub(&raid_io->raid_bdev->num_outstanding_ios, 1, __ATOMIC_RELAXED);
 		spdk_bdev_io_complete(bdev_io, status);
 	}
 }
@@ -922,6 +944,15 @@ raid_bdev_submit_request(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_i
 			  bdev_io->u.bdev.iovs, bdev_io->u.bdev.iovcnt, bdev_io->u.bdev.md_buf,
 			  bdev_io->u.bdev.memory_domain, bdev_io->u.bdev.memory_domain_ctx);
 
+	__atomic_fetch_add(&raid_io->raid_bdev->num_outstanding_ios, 1, __ATOMIC_RELAXED);
+
+	if (spdk_unlikely(raid_io->raid_bdev->stale_process_checkpoint) &&
+	    bdev_io->type != SPDK_BDEV_IO_TYPE_READ) {
+		raid_io->raid_bdev->stale_process_checkpoint = false;
+		spdk_thread_send_msg(spdk_thread_get_app_thread(),
+				     raid_bdev_process_checkpoint_invalidate, raid_io->raid_bdev);
+	}
+
 	switch (bdev_io->type) {
 	case SPDK_BDEV_IO_TYPE_READ:
 		spdk_bdev_io_get_buf(bdev_io, raid_bdev_get_buf_cb,
@@ -1052,6 +1083,10 @@ raid_bdev_write_info_json(struct raid_bdev *raid_bdev, struct spdk_json_write_ct
 	spdk_json_write_named_string(w, "state", raid_bdev_state_to_str(raid_bdev->state));
 	spdk_json_write_named_string(w, "raid_level", raid_bdev_level_to_str(raid_bdev->level));
 	spdk_json_write_named_bool(w, "superblock", raid_bdev->superblock_enabled);
+	if (raid_bdev->module->read_policy_supported) {
+		spdk_json_write_named_string(w, "read_policy",
+					     raid_bdev_read_policy_to_str(raid_bdev->read_policy));
+	}
 	spdk_json_write_named_uint32(w, "num_base_bdevs", raid_bdev->num_base_bdevs);
 	spdk_json_write_named_uint32(w, "num_base_bdevs_discovered", raid_bdev->num_base_bdevs_discovered);
 	spdk_json_write_named_uint32(w, "num_base_bdevs_operational",
@@ -1163,6 +1198,20 @@ raid_bdev_write_config_json(struct spdk_bdev *bdev, struct spdk_json_write_ctx *
 	spdk_json_write_object_end(w);
 
 	spdk_json_write_object_end(w);
+
+	if (raid_bdev->read_policy != RAID_BDEV_READ_POLICY_OUTSTANDING) {
+		spdk_json_write_object_begin(w);
+
+		spdk_json_write_named_string(w, "method", "bdev_raid_set_read_policy");
+
+		spdk_json_write_named_object_begin(w, "params");
+		spdk_json_write_named_string(w, "name", bdev->name);
+		spdk_json_write_named_string(w, "policy",
+					     raid_bdev_read_policy_to_str(raid_bdev->read_policy));
+		spdk_json_write_object_end(w);
+
+		spdk_json_write_object_end(w);
+	}
 }
 
 static int
@@ -1256,10 +1305,19 @@ static struct {
 	{ "1", RAID1 },
 	{ "raid5f", RAID5F },
 	{ "5f", RAID5F },
+	{ "raid6", RAID6 },
+	{ "6", RAID6 },
 	{ "concat", CONCAT },
 	{ }
 };
 
+static const char *g_raid_read_policy_names[] = {
+	[RAID_BDEV_READ_POLICY_OUTSTANDING]	= "outstanding",
+	[RAID_BDEV_READ_POLICY_LATENCY]		= "latency",
+	[RAID_BDEV_READ_POLICY_AFFINITY]	= "affinity",
+	[RAID_BDEV_READ_POLICY_MAX]		= NULL
+};
+
 const char *g_raid_state_names[] = {
 	[RAID_BDEV_STATE_ONLINE]	= "online",
 	[RAID_BDEV_STATE_CONFIGURING]	= "configuring",
@@ -1276,6 +1334,7 @@ static const char *g_raid_process_type_names[] = {
 /* We have to use the typedef in the function declaration to appease astyle. */
 typedef enum raid_level raid_level_t;
 typedef enum raid_bdev_state raid_bdev_state_t;
+typedef enum raid_bdev_read_policy raid_bdev_read_policy_t;
 
 raid_level_t
 raid_bdev_str_to_level(const char *str)
@@ -1343,6 +1402,48 @@ raid_bdev_process_to_str(enum raid_process_type value)
 	return g_raid_process_type_names[value];
 }
 
+raid_bdev_read_policy_t
+raid_bdev_str_to_read_policy(const char *str)
+{
+	unsigned int i;
+
+	assert(str != NULL);
+
+	for (i = 0; i < RAID_BDEV_READ_POLICY_MAX; i++) {
+		if (strcasecmp(g_raid_read_policy_names[i], str) == 0) {
+			break;
+		}
+	}
+
+	return i;
+}
+
+const char *
+raid_bdev_read_policy_to_str(enum raid_bdev_read_policy policy)
+{
+	if (policy >= RAID_BDEV_READ_POLICY_MAX) {
+		return "";
+	}
+
+	return g_raid_read_policy_names[policy];
+}
+
+int
+raid_bdev_set_read_policy(struct raid_bdev *raid_bdev, enum raid_bdev_read_policy policy)
+{
+	if (policy >= RAID_BDEV_READ_POLICY_MAX) {
+		return -EINVAL;
+	}
+
+	if (!raid_bdev->module->read_policy_supported) {
+		return -ENOTSUP;
+	}
+
+	raid_bdev->read_policy = policy;
+
+	return 0;
+}
+
 /*
  * brief:
  * raid_bdev_fini_start is called when bdev layer is starting the
@@ -1388,6 +1489,8 @@ raid_bdev_opts_config_json(struct spdk_json_write_ctx *w)
 
 	spdk_json_write_named_object_begin(w, "params");
 	spdk_json_write_named_uint32(w, "process_window_size_kb", g_opts.process_window_size_kb);
+	spdk_json_write_named_uint32(w, "process_max_bandwidth_mb_sec",
+				     g_opts.process_max_bandwidth_mb_sec);
 	spdk_json_write_object_end(w);
 
 	spdk_json_write_object_end(w);
@@ -1918,7 +2021,7 @@ raid_bdev_channel_remove_base_bdev(struct spdk_io_channel_iter *i)
 
 	SPDK_DEBUGLOG(bdev_raid, "slot: %u raid_ch: %p\n", idx, raid_ch);
 
-	if (raid_ch->base_channel[idx] != NULL) {
+	if (idx < raid_ch->num_base_channels && raid_ch->base_channel[idx] != NULL) {
 		spdk_put_io_channel(raid_ch->base_channel[idx]);
 		raid_ch->base_channel[idx] = NULL;
 	}
@@ -2415,6 +2518,7 @@ raid_bdev_process_finish_write_sb(void *ctx)
 			base_info = &raid_bdev->base_bdev_info[sb_base_bdev->slot];
 			if (base_info->is_configured) {
 				sb_base_bdev->state = RAID_SB_BASE_BDEV_CONFIGURED;
+				sb_base_bdev->rebuild_offset = 0;
 				spdk_uuid_copy(&sb_base_bdev->uuid, &base_info->uuid);
 			}
 		}
@@ -2494,6 +2598,8 @@ raid_bdev_process_finish_done(void *ctx)
 	struct raid_bdev_process *process = ctx;
 	struct raid_bdev *raid_bdev = process->raid_bdev;
 
+	spdk_poller_unregister(&process->budget_poller);
+
 	if (process->raid_ch != NULL) {
 		spdk_put_io_channel(spdk_io_channel_from_ctx(process->raid_ch));
 	}
@@ -2514,6 +2620,11 @@ raid_bdev_process_finish_done(void *ctx)
 			     raid_bdev_process_to_str(process->type),
 			     raid_bdev->bdev.name,
 			     spdk_strerror(-process->status));
+		if (process->checkpoint_offset != 0) {
+			/* The persisted checkpoint remains valid only until the raid bdev is
+			 * written to - resuming the process will clear this flag again */
+			raid_bdev->stale_process_checkpoint = true;
+		}
 	}
 
 	spdk_thread_send_msg(spdk_thread_get_app_thread(), raid_bdev_process_finish_unquiesce,
@@ -2610,6 +2721,155 @@ raid_bdev_process_finish(struct raid_bdev_process *process, int status)
 	}
 }
 
+static void
+raid_bdev_process_checkpoint_write_sb_cb(int status, struct raid_bdev *raid_bdev, void *ctx)
+{
+	if (status != 0) {
+		SPDK_WARNLOG("Failed to write raid bdev '%s' superblock process checkpoint: %s\n",
+			     raid_bdev->bdev.name, spdk_strerror(-status));
+	}
+}
+
+struct raid_process_checkpoint_ctx {
+	struct raid_bdev *raid_bdev;
+	uint64_t offset;
+	uint8_t slot;
+};
+
+static void
+raid_bdev_process_checkpoint_write_sb(void *_ctx)
+{
+	struct raid_process_checkpoint_ctx *ctx = _ctx;
+	struct raid_bdev_process *process;
+	struct raid_bdev_sb_base_bdev *sb_base_bdev;
+	struct raid_bdev *raid_bdev;
+	uint8_t i;
+
+	assert(spdk_get_thread() == spdk_thread_get_app_thread());
+
+	TAILQ_FOREACH(raid_bdev, &g_raid_bdev_list, global_link) {
+		if (raid_bdev == ctx->raid_bdev) {
+			break;
+		}
+	}
+
+	/* The raid bdev may have been deleted or the process may have finished by now */
+	if (raid_bdev == NULL || raid_bdev->process == NULL) {
+		goto out;
+	}
+
+	process = raid_bdev->process;
+	if (raid_bdev_base_bdev_slot(process->target) != ctx->slot) {
+		goto out;
+	}
+
+	for (i = 0; i < raid_bdev->sb->base_bdevs_size; i++) {
+		sb_base_bdev = &raid_bdev->sb->base_bdevs[i];
+
+		if (sb_base_bdev->slot == ctx->slot &&
+		    sb_base_bdev->state != RAID_SB_BASE_BDEV_CONFIGURED) {
+			sb_base_bdev->rebuild_offset = ctx->offset;
+			spdk_uuid_copy(&sb_base_bdev->uuid, &process->target->uuid);
+			raid_bdev_write_superblock(raid_bdev, raid_bdev_process_checkpoint_write_sb_cb, NULL);
+			break;
+		}
+	}
+out:
+	free(ctx);
+}
+
+static void
+raid_bdev_process_checkpoint(struct raid_bdev_process *process)
+{
+	struct raid_process_checkpoint_ctx *ctx;
+
+	assert(spdk_get_thread() == process->thread);
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		/* Not fatal - the process continues without persisting this checkpoint */
+		return;
+	}
+
+	ctx->raid_bdev = process->raid_bdev;
+	ctx->offset = process->window_offset;
+	ctx->slot = raid_bdev_base_bdev_slot(process->target);
+
+	spdk_thread_send_msg(spdk_thread_get_app_thread(), raid_bdev_process_checkpoint_write_sb, ctx);
+}
+
+static void
+raid_bdev_process_checkpoint_invalidate(void *_ctx)
+{
+	struct raid_bdev *ctx = _ctx;
+	struct raid_bdev_sb_base_bdev *sb_base_bdev;
+	struct raid_bdev *raid_bdev;
+	bool modified = false;
+	uint8_t i;
+
+	assert(spdk_get_thread() == spdk_thread_get_app_thread());
+
+	TAILQ_FOREACH(raid_bdev, &g_raid_bdev_list, global_link) {
+		if (raid_bdev == ctx) {
+			break;
+		}
+	}
+
+	/* The raid bdev may have been deleted by now */
+	if (raid_bdev == NULL || raid_bdev->sb == NULL) {
+		return;
+	}
+
+	for (i = 0; i < raid_bdev->sb->base_bdevs_size; i++) {
+		sb_base_bdev = &raid_bdev->sb->base_bdevs[i];
+
+		if (sb_base_bdev->state == RAID_SB_BASE_BDEV_CONFIGURED ||
+		    sb_base_bdev->rebuild_offset == 0) {
+			continue;
+		}
+
+		/* A running process keeps the checkpoint of its own target slot up to
+		 * date, so only that one is still valid - checkpoints of any other
+		 * slot no longer reflect the data written since and must not be
+		 * resumed from. */
+		if (raid_bdev->process != NULL &&
+		    sb_base_bdev->slot == raid_bdev_base_bdev_slot(raid_bdev->process->target)) {
+			continue;
+		}
+
+		sb_base_bdev->rebuild_offset = 0;
+		modified = true;
+	}
+
+	if (modified) {
+		raid_bdev_write_superblock(raid_bdev, raid_bdev_process_checkpoint_write_sb_cb, NULL);
+	}
+}
+
+static int
+raid_bdev_process_budget_poller(void *ctx)
+{
+	struct raid_bdev_process *process = ctx;
+	uint64_t refill = process->max_bandwidth_blocks /
+			  (SPDK_SEC_TO_USEC / RAID_BDEV_PROCESS_BUDGET_PERIOD_US);
+
+	/* Back off while there is foreground I/O outstanding on the raid bdev */
+	if (__atomic_load_n(&process->raid_bdev->num_outstanding_ios, __ATOMIC_RELAXED) > 0) {
+		refill /= RAID_BDEV_PROCESS_PRESSURE_DIVISOR;
+	}
+
+	process->window_budget = spdk_min(process->window_budget + spdk_max(refill, 1),
+					  process->max_bandwidth_blocks);
+
+	if (process->waiting_for_budget && process->state == RAID_PROCESS_STATE_RUNNING &&
+	    process->window_budget >= process->max_window_size) {
+		process->waiting_for_budget = false;
+		raid_bdev_process_thread_run(process);
+	}
+
+	return SPDK_POLLER_BUSY;
+}
+
 static void
 raid_bdev_process_window_range_unlocked(void *ctx, int status)
 {
@@ -2624,6 +2884,12 @@ raid_bdev_process_window_range_unlocked(void *ctx, int status)
 	process->window_range_locked = false;
 	process->window_offset += process->window_size;
 
+	if (process->checkpoint_step != 0 &&
+	    process->window_offset >= process->checkpoint_offset + process->checkpoint_step) {
+		process->checkpoint_offset = process->window_offset;
+		raid_bdev_process_checkpoint(process);
+	}
+
 	raid_bdev_process_thread_run(process);
 }
 
@@ -2744,6 +3010,10 @@ _raid_bdev_process_thread_run(struct raid_bdev_process *process)
 
 	if (process->window_remaining > 0) {
 		process->window_size = process->window_remaining;
+		if (process->max_bandwidth_blocks != 0) {
+			assert(process->window_budget >= process->window_size);
+			process->window_budget -= process->window_size;
+		}
 	} else {
 		raid_bdev_process_finish(process, process->window_status);
 	}
@@ -2794,6 +3064,13 @@ raid_bdev_process_thread_run(struct raid_bdev_process *process)
 	process->max_window_size = spdk_min(raid_bdev->bdev.blockcnt - process->window_offset,
 					    process->max_window_size);
 
+	if (process->max_bandwidth_blocks != 0 &&
+	    process->window_budget < process->max_window_size) {
+		/* Wait for the budget poller to refill the token bucket */
+		process->waiting_for_budget = true;
+		return;
+	}
+
 	rc = spdk_bdev_quiesce_range(&raid_bdev->bdev, &g_raid_if,
 				     process->window_offset, process->max_window_size,
 				     raid_bdev_process_window_range_locked, process);
@@ -2821,6 +3098,12 @@ raid_bdev_process_thread_init(void *ctx)
 	process->raid_ch = spdk_io_channel_get_ctx(ch);
 	process->state = RAID_PROCESS_STATE_RUNNING;
 
+	if (process->max_bandwidth_blocks != 0) {
+		process->window_budget = process->max_bandwidth_blocks;
+		process->budget_poller = SPDK_POLLER_REGISTER(raid_bdev_process_budget_poller,
+					 process, RAID_BDEV_PROCESS_BUDGET_PERIOD_US);
+	}
+
 	SPDK_NOTICELOG("Started %s on raid bdev %s\n",
 		       raid_bdev_process_to_str(process->type), raid_bdev->bdev.name);
 
@@ -2984,6 +3267,16 @@ raid_bdev_process_alloc(struct raid_bdev *raid_bdev, enum raid_process_type type
 	process->max_window_size = spdk_max(spdk_divide_round_up(g_opts.process_window_size_kb * 1024UL,
 					    spdk_bdev_get_data_block_size(&raid_bdev->bdev)),
 					    raid_bdev->bdev.write_unit_size);
+	if (g_opts.process_max_bandwidth_mb_sec != 0) {
+		process->max_bandwidth_blocks = spdk_max(g_opts.process_max_bandwidth_mb_sec * 1024ULL * 1024 /
+						spdk_bdev_get_data_block_size(&raid_bdev->bdev),
+						process->max_window_size);
+	}
+	if (raid_bdev->superblock_enabled) {
+		process->checkpoint_step = spdk_max(RAID_BDEV_PROCESS_CHECKPOINT_STEP_BYTES /
+						    spdk_bdev_get_data_block_size(&raid_bdev->bdev),
+						    process->max_window_size);
+	}
 	TAILQ_INIT(&process->requests);
 	TAILQ_INIT(&process->finish_actions);
 
@@ -3000,6 +3293,44 @@ raid_bdev_process_alloc(struct raid_bdev *raid_bdev, enum raid_process_type type
 	return process;
 }
 
+static void
+raid_bdev_process_resume_checkpoint(struct raid_bdev_process *process)
+{
+	struct raid_bdev *raid_bdev = process->raid_bdev;
+	struct raid_bdev_sb_base_bdev *sb_base_bdev;
+	uint8_t i;
+
+	if (raid_bdev->sb == NULL) {
+		return;
+	}
+
+	for (i = 0; i < raid_bdev->sb->base_bdevs_size; i++) {
+		sb_base_bdev = &raid_bdev->sb->base_bdevs[i];
+
+		if (sb_base_bdev->state == RAID_SB_BASE_BDEV_CONFIGURED ||
+		    sb_base_bdev->rebuild_offset == 0 ||
+		    spdk_uuid_compare(&sb_base_bdev->uuid, &process->target->uuid) != 0) {
+			continue;
+		}
+
+		if (sb_base_bdev->rebuild_offset >= raid_bdev->bdev.blockcnt) {
+			SPDK_WARNLOG("Ignoring invalid %s checkpoint %" PRIu64 " on raid bdev %s\n",
+				     raid_bdev_process_to_str(process->type),
+				     sb_base_bdev->rebuild_offset, raid_bdev->bdev.name);
+			break;
+		}
+
+		process->window_offset = sb_base_bdev->rebuild_offset;
+		process->checkpoint_offset = sb_base_bdev->rebuild_offset;
+		raid_bdev->stale_process_checkpoint = false;
+
+		SPDK_NOTICELOG("Resuming %s of %s on raid bdev %s from checkpoint %" PRIu64 "\n",
+			       raid_bdev_process_to_str(process->type), process->target->name,
+			       raid_bdev->bdev.name, process->window_offset);
+		break;
+	}
+}
+
 static int
 raid_bdev_start_rebuild(struct raid_base_bdev_info *target)
 {
@@ -3012,6 +3343,8 @@ raid_bdev_start_rebuild(struct raid_base_bdev_info *target)
 		return -ENOMEM;
 	}
 
+	raid_bdev_process_resume_checkpoint(process);
+
 	raid_bdev_process_start(process);
 
 	return 0;
@@ -3064,9 +3397,16 @@ raid_bdev_configure_base_bdev_cont(struct raid_base_bdev_info *base_info)
 	 * degraded.
 	 */
 	if (raid_bdev->num_base_bdevs_discovered == raid_bdev->num_base_bdevs_operational) {
-		rc = raid_bdev_configure(raid_bdev);
-		if (rc != 0) {
-			SPDK_ERRLOG("Failed to configure raid bdev: %s\n", spdk_strerror(-rc));
+		if (raid_bdev->state == RAID_BDEV_STATE_CONFIGURING) {
+			rc = raid_bdev_configure(raid_bdev);
+			if (rc != 0) {
+				SPDK_ERRLOG("Failed to configure raid bdev: %s\n", spdk_strerror(-rc));
+			}
+		} else {
+			/* The raid is already online - this is a new base bdev added to grow
+			 * the raid. The grow operation continues in the configure callback. */
+			assert(raid_bdev->state == RAID_BDEV_STATE_ONLINE);
+			rc = 0;
 		}
 	} else if (base_info->is_process_target) {
 		raid_bdev->num_base_bdevs_operational++;
@@ -3374,6 +3714,322 @@ raid_bdev_add_base_bdev(struct raid_bdev *raid_bdev, const char *name,
 	return rc;
 }
 
+struct raid_bdev_grow_base_bdev_ctx {
+	struct raid_bdev *raid_bdev;
+	char *base_bdev_name;
+	raid_base_bdev_cb cb_fn;
+	void *cb_ctx;
+	int status;
+};
+
+static void
+raid_bdev_grow_base_bdev_done(struct raid_bdev_grow_base_bdev_ctx *ctx, int status)
+{
+	if (ctx->cb_fn != NULL) {
+		ctx->cb_fn(ctx->cb_ctx, status);
+	}
+	free(ctx->base_bdev_name);
+	free(ctx);
+}
+
+static void
+raid_bdev_grow_base_bdev_on_unquiesced(void *_ctx, int status)
+{
+	struct raid_bdev_grow_base_bdev_ctx *ctx = _ctx;
+	struct raid_bdev *raid_bdev = ctx->raid_bdev;
+
+	if (status != 0) {
+		SPDK_ERRLOG("Failed to unquiesce raid bdev %s: %s\n",
+			    raid_bdev->bdev.name, spdk_strerror(-status));
+		if (ctx->status == 0) {
+			ctx->status = status;
+		}
+	}
+
+	raid_bdev_grow_base_bdev_done(ctx, ctx->status);
+}
+
+static void
+raid_bdev_grow_base_bdev_unquiesce(struct raid_bdev_grow_base_bdev_ctx *ctx, int status)
+{
+	ctx->status = status;
+	spdk_bdev_unquiesce(&ctx->raid_bdev->bdev, &g_raid_if,
+			    raid_bdev_grow_base_bdev_on_unquiesced, ctx);
+}
+
+static void
+raid_bdev_grow_base_bdev_rollback(struct raid_bdev_grow_base_bdev_ctx *ctx, int status)
+{
+	struct raid_bdev *raid_bdev = ctx->raid_bdev;
+
+	assert(raid_bdev->num_base_bdevs > 1);
+	raid_bdev->num_base_bdevs--;
+	raid_bdev->num_base_bdevs_operational--;
+
+	raid_bdev_grow_base_bdev_unquiesce(ctx, status);
+}
+
+static void
+raid_bdev_grow_base_bdev_write_sb_cb(int status, struct raid_bdev *raid_bdev, void *_ctx)
+{
+	struct raid_bdev_grow_base_bdev_ctx *ctx = _ctx;
+
+	if (status != 0) {
+		SPDK_ERRLOG("Failed to write raid bdev '%s' superblock after growing the bdev: %s\n",
+			    raid_bdev->bdev.name, spdk_strerror(-status));
+	}
+
+	raid_bdev_grow_base_bdev_unquiesce(ctx, status);
+}
+
+static void
+raid_bdev_channel_grow_base_bdev(struct spdk_io_channel_iter *i)
+{
+	struct raid_bdev_grow_base_bdev_ctx *ctx = spdk_io_channel_iter_get_ctx(i);
+	struct raid_bdev *raid_bdev = ctx->raid_bdev;
+	struct spdk_io_channel *ch = spdk_io_channel_iter_get_channel(i);
+	struct raid_bdev_io_channel *raid_ch = spdk_io_channel_get_ctx(ch);
+	uint8_t idx = raid_bdev->num_base_bdevs - 1;
+	int status = 0;
+
+	if (raid_ch->num_base_channels < raid_bdev->num_base_bdevs) {
+		struct spdk_io_channel **base_channel;
+
+		base_channel = realloc(raid_ch->base_channel,
+				       raid_bdev->num_base_bdevs * sizeof(*base_channel));
+		if (base_channel == NULL) {
+			spdk_for_each_channel_continue(i, -ENOMEM);
+			return;
+		}
+		base_channel[idx] = NULL;
+		raid_ch->base_channel = base_channel;
+		raid_ch->num_base_channels = raid_bdev->num_base_bdevs;
+	}
+
+	/* The channel may have been created after the new base bdev was configured and
+	 * already have its io channel - open one only if it doesn't. */
+	if (raid_ch->base_channel[idx] == NULL) {
+		struct raid_base_bdev_info *base_info = &raid_bdev->base_bdev_info[idx];
+
+		raid_ch->base_channel[idx] = spdk_bdev_get_io_channel(base_info->desc);
+		if (raid_ch->base_channel[idx] == NULL) {
+			status = -ENOMEM;
+		}
+	}
+
+	spdk_for_each_channel_continue(i, status);
+}
+
+static void
+raid_bdev_channel_grow_base_bdev_cleanup(struct spdk_io_channel_iter *i)
+{
+	struct raid_bdev_grow_base_bdev_ctx *ctx = spdk_io_channel_iter_get_ctx(i);
+	struct raid_bdev *raid_bdev = ctx->raid_bdev;
+	struct spdk_io_channel *ch = spdk_io_channel_iter_get_channel(i);
+	struct raid_bdev_io_channel *raid_ch = spdk_io_channel_get_ctx(ch);
+	uint8_t idx = raid_bdev->num_base_bdevs - 1;
+
+	if (idx < raid_ch->num_base_channels && raid_ch->base_channel[idx] != NULL) {
+		spdk_put_io_channel(raid_ch->base_channel[idx]);
+		raid_ch->base_channel[idx] = NULL;
+	}
+
+	spdk_for_each_channel_continue(i, 0);
+}
+
+static void
+raid_bdev_channels_grow_base_bdev_cleanup_done(struct spdk_io_channel_iter *i, int status)
+{
+	struct raid_bdev_grow_base_bdev_ctx *ctx = spdk_io_channel_iter_get_ctx(i);
+	struct raid_bdev *raid_bdev = ctx->raid_bdev;
+	struct raid_base_bdev_info *base_info;
+
+	base_info = &raid_bdev->base_bdev_info[raid_bdev->num_base_bdevs - 1];
+	raid_bdev_free_base_bdev_resource(base_info);
+
+	raid_bdev_grow_base_bdev_rollback(ctx, ctx->status);
+}
+
+static void
+raid_bdev_channels_grow_base_bdev_done(struct spdk_io_channel_iter *i, int status)
+{
+	struct raid_bdev_grow_base_bdev_ctx *ctx = spdk_io_channel_iter_get_ctx(i);
+	struct raid_bdev *raid_bdev = ctx->raid_bdev;
+	struct raid_base_bdev_info *base_info;
+	uint64_t blockcnt_old = raid_bdev->bdev.blockcnt;
+
+	base_info = &raid_bdev->base_bdev_info[raid_bdev->num_base_bdevs - 1];
+
+	if (status != 0) {
+		SPDK_ERRLOG("Failed to set up io channels for new base bdev '%s': %s\n",
+			    base_info->name, spdk_strerror(-status));
+	} else {
+		status = raid_bdev->module->grow_base_bdev(raid_bdev, base_info);
+		if (status != 0) {
+			SPDK_ERRLOG("Failed to grow raid bdev '%s' with base bdev '%s': %s\n",
+				    raid_bdev->bdev.name, base_info->name, spdk_strerror(-status));
+		}
+	}
+
+	if (status != 0) {
+		/* Release the io channels opened for the new base bdev before
+		 * freeing its resources. */
+		ctx->status = status;
+		spdk_for_each_channel(raid_bdev, raid_bdev_channel_grow_base_bdev_cleanup, ctx,
+				      raid_bdev_channels_grow_base_bdev_cleanup_done);
+		return;
+	}
+
+	SPDK_NOTICELOG("raid bdev '%s': block count was changed from %" PRIu64 " to %" PRIu64 "\n",
+		       raid_bdev->bdev.name, blockcnt_old, raid_bdev->bdev.blockcnt);
+
+	if (raid_bdev->superblock_enabled) {
+		/* Regenerate the superblock to cover the new base bdev and raid size */
+		raid_bdev_init_superblock(raid_bdev);
+		raid_bdev_write_superblock(raid_bdev, raid_bdev_grow_base_bdev_write_sb_cb, ctx);
+		return;
+	}
+
+	raid_bdev_grow_base_bdev_unquiesce(ctx, 0);
+}
+
+static void
+raid_bdev_grow_base_bdev_configured(void *_ctx, int status)
+{
+	struct raid_bdev_grow_base_bdev_ctx *ctx = _ctx;
+	struct raid_bdev *raid_bdev = ctx->raid_bdev;
+
+	if (status != 0) {
+		struct raid_base_bdev_info *base_info;
+
+		base_info = &raid_bdev->base_bdev_info[raid_bdev->num_base_bdevs - 1];
+		SPDK_ERRLOG("Failed to configure new base bdev for raid bdev '%s': %s\n",
+			    raid_bdev->bdev.name, spdk_strerror(-status));
+		raid_bdev_free_base_bdev_resource(base_info);
+		raid_bdev_grow_base_bdev_rollback(ctx, status);
+		return;
+	}
+
+	spdk_for_each_channel(raid_bdev, raid_bdev_channel_grow_base_bdev, ctx,
+			      raid_bdev_channels_grow_base_bdev_done);
+}
+
+static void
+raid_bdev_grow_base_bdev_on_quiesced(void *_ctx, int status)
+{
+	struct raid_bdev_grow_base_bdev_ctx *ctx = _ctx;
+	struct raid_bdev *raid_bdev = ctx->raid_bdev;
+	struct raid_base_bdev_info *base_info;
+	int rc;
+
+	if (status != 0) {
+		SPDK_ERRLOG("Failed to quiesce raid bdev %s: %s\n",
+			    raid_bdev->bdev.name, spdk_strerror(-status));
+		raid_bdev_grow_base_bdev_done(ctx, status);
+		return;
+	}
+
+	base_info = realloc(raid_bdev->base_bdev_info,
+			    (raid_bdev->num_base_bdevs + 1) * sizeof(*base_info));
+	if (base_info == NULL) {
+		SPDK_ERRLOG("Failed to reallocate base bdev info array for raid bdev '%s'\n",
+			    raid_bdev->bdev.name);
+		raid_bdev_grow_base_bdev_unquiesce(ctx, -ENOMEM);
+		return;
+	}
+	raid_bdev->base_bdev_info = base_info;
+
+	base_info = &raid_bdev->base_bdev_info[raid_bdev->num_base_bdevs];
+	memset(base_info, 0, sizeof(*base_info));
+	base_info->raid_bdev = raid_bdev;
+	base_info->name = ctx->base_bdev_name;
+	ctx->base_bdev_name = NULL;
+
+	raid_bdev->num_base_bdevs++;
+	raid_bdev->num_base_bdevs_operational++;
+
+	rc = raid_bdev_configure_base_bdev(base_info, false, raid_bdev_grow_base_bdev_configured, ctx);
+	if (rc != 0) {
+		SPDK_ERRLOG("base bdev '%s' configure failed: %s\n",
+			    base_info->name, spdk_strerror(-rc));
+		free(base_info->name);
+		base_info->name = NULL;
+		raid_bdev_grow_base_bdev_rollback(ctx, rc);
+	}
+}
+
+int
+raid_bdev_grow_base_bdev(struct raid_bdev *raid_bdev, const char *name,
+			 raid_base_bdev_cb cb_fn, void *cb_ctx)
+{
+	struct raid_bdev_grow_base_bdev_ctx *ctx;
+	struct raid_base_bdev_info *base_info;
+	int rc;
+
+	assert(name != NULL);
+	assert(spdk_get_thread() == spdk_thread_get_app_thread());
+
+	if (raid_bdev->module->grow_base_bdev == NULL) {
+		SPDK_ERRLOG("raid bdev '%s': growing a %s bdev is not supported\n",
+			    raid_bdev->bdev.name, raid_bdev_level_to_str(raid_bdev->level));
+		return -ENOTSUP;
+	}
+
+	if (raid_bdev->state != RAID_BDEV_STATE_ONLINE) {
+		SPDK_ERRLOG("raid bdev '%s' is not online\n", raid_bdev->bdev.name);
+		return -EPERM;
+	}
+
+	if (raid_bdev->process != NULL) {
+		SPDK_ERRLOG("raid bdev '%s' is in process\n", raid_bdev->bdev.name);
+		return -EPERM;
+	}
+
+	if (raid_bdev->num_base_bdevs_operational != raid_bdev->num_base_bdevs) {
+		SPDK_ERRLOG("raid bdev '%s' is degraded\n", raid_bdev->bdev.name);
+		return -EPERM;
+	}
+
+	RAID_FOR_EACH_BASE_BDEV(raid_bdev, base_info) {
+		if (!base_info->is_configured || base_info->remove_scheduled) {
+			SPDK_ERRLOG("raid bdev '%s' has unconfigured base bdevs\n",
+				    raid_bdev->bdev.name);
+			return -EPERM;
+		}
+	}
+
+	if (raid_bdev->num_base_bdevs == UINT8_MAX) {
+		SPDK_ERRLOG("raid bdev '%s' already has the maximum number of base bdevs\n",
+			    raid_bdev->bdev.name);
+		return -EINVAL;
+	}
+
+	ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		return -ENOMEM;
+	}
+
+	ctx->raid_bdev = raid_bdev;
+	ctx->cb_fn = cb_fn;
+	ctx->cb_ctx = cb_ctx;
+	ctx->base_bdev_name = strdup(name);
+	if (ctx->base_bdev_name == NULL) {
+		free(ctx);
+		return -ENOMEM;
+	}
+
+	rc = spdk_bdev_quiesce(&raid_bdev->bdev, &g_raid_if, raid_bdev_grow_base_bdev_on_quiesced,
+			       ctx);
+	if (rc != 0) {
+		SPDK_ERRLOG("Failed to quiesce raid bdev '%s': %s\n",
+			    raid_bdev->bdev.name, spdk_strerror(-rc));
+		free(ctx->base_bdev_name);
+		free(ctx);
+	}
+
+	return rc;
+}
+
 static int
 raid_bdev_create_from_sb(const struct raid_bdev_superblock *sb, struct raid_bdev **raid_bdev_out)
 {
@@ -3403,6 +4059,10 @@ raid_bdev_create_from_sb(const struct raid_bdev_superblock *sb, struct raid_bdev
 		if (sb_base_bdev->state == RAID_SB_BASE_BDEV_CONFIGURED) {
 			spdk_uuid_copy(&base_info->uuid, &sb_base_bdev->uuid);
 			raid_bdev->num_base_bdevs_operational++;
+		} else if (sb_base_bdev->rebuild_offset != 0) {
+			/* A process checkpoint can only be resumed if the raid bdev is not
+			 * written to before the checkpointed base bdev is re-added */
+			raid_bdev->stale_process_checkpoint = true;
 		}
 
 		base_info->data_offset = sb_base_bdev->data_offset;
@@ -11,10 +11,14 @@
 
 #define RAID_BDEV_MIN_DATA_OFFSET_SIZE	(1024*1024) /* 1 MiB */
 
+/* Value of raid_bdev_io split.offset when the I/O is not split */
+#define RAID_OFFSET_BLOCKS_INVALID	UINT64_MAX
+
 enum raid_level {
 	INVALID_RAID_LEVEL	= -1,
 	RAID0			= 0,
 	RAID1			= 1,
+	RAID6			= 6,
 	RAID5F			= 95, /* 0x5f */
 	CONCAT			= 99,
 };
@@ -49,6 +53,27 @@ enum raid_process_type {
 	RAID_PROCESS_MAX
 };
 
+/*
+ * Policy for selecting the base bdev to read from on raid levels that mirror
+ * data (currently raid1 only)
+ */
+enum raid_bdev_read_policy {
+	/* Read from the base bdev with the least outstanding read blocks */
+	RAID_BDEV_READ_POLICY_OUTSTANDING,
+
+	/*
+	 * Weigh the base bdevs by the inverse of their measured read latency
+	 * and pick one at random according to the weights
+	 */
+	RAID_BDEV_READ_POLICY_LATENCY,
+
+	/* Pin reads on each io channel to a single base bdev */
+	RAID_BDEV_READ_POLICY_AFFINITY,
+
+	/* read policy max, new policies should be added before this */
+	RAID_BDEV_READ_POLICY_MAX
+};
+
 typedef void (*raid_base_bdev_cb)(void *ctx, int status);
 
 /*
@@ -223,6 +248,9 @@ struct raid_bdev {
 	/* Raid Level of this raid bdev */
 	enum raid_level			level;
 
+	/* Read selection policy, used by modules that mirror data */
+	enum raid_bdev_read_policy	read_policy;
+
 	/* Set to true if destroy of this raid bdev is started. */
 	bool				destroy_started;
 
@@ -242,6 +270,14 @@ struct raid_bdev {
 
 	/* Raid bdev background process, e.g. rebuild */
 	struct raid_bdev_process	*process;
+
+	/* Number of outstanding I/Os submitted through the raid bdev, used to detect
+	 * foreground load by the background process rate limiter */
+	uint64_t			num_outstanding_ios;
+
+	/* Set when the superblock contains a background process checkpoint that must be
+	 * invalidated if the raid bdev is written to before the process is resumed */
+	bool				stale_process_checkpoint;
 };
 
 #define RAID_FOR_EACH_BASE_BDEV(r, i) \
@@ -262,10 +298,15 @@ int raid_bdev_create(const char *name, uint32_t strip_size, uint8_t num_base_bde
 void raid_bdev_delete(struct raid_bdev *raid_bdev, raid_bdev_destruct_cb cb_fn, void *cb_ctx);
 int raid_bdev_add_base_bdev(struct raid_bdev *raid_bdev, const char *name,
 			    raid_base_bdev_cb cb_fn, void *cb_ctx);
+int raid_bdev_grow_base_bdev(struct raid_bdev *raid_bdev, const char *name,
+			     raid_base_bdev_cb cb_fn, void *cb_ctx);
 struct raid_bdev *raid_bdev_find_by_name(const char *name);
 enum raid_level raid_bdev_str_to_level(const char *str);
 const char *raid_bdev_level_to_str(enum raid_level level);
 enum raid_bdev_state raid_bdev_str_to_state(const char *str);
+enum raid_bdev_read_policy raid_bdev_str_to_read_policy(const char *str);
+const char *raid_bdev_read_policy_to_str(enum raid_bdev_read_policy policy);
+int raid_bdev_set_read_policy(struct raid_bdev *raid_bdev, enum raid_bdev_read_policy policy);
 const char *raid_bdev_state_to_str(enum raid_bdev_state state);
 const char *raid_bdev_process_to_str(enum raid_process_type value);
 void raid_bdev_write_info_json(struct raid_bdev *raid_bdev, struct spdk_json_write_ctx *w);
@@ -300,6 +341,9 @@ struct raid_bdev_module {
 	/* Set to true if this module supports DIF/DIX */
 	bool dif_supported;
 
+	/* Set to true if this module supports read selection policies. */
+	bool read_policy_supported;
+
 	/*
 	 * Called when the raid is starting, right before changing the state to
 	 * online and registering the bdev. Parameters of the bdev like blockcnt
@@ -339,6 +383,17 @@ struct raid_bdev_module {
 	 */
 	bool (*resize)(struct raid_bdev *raid_bdev);
 
+	/*
+	 * Called when a new base bdev is added to an online raid to grow its
+	 * capacity. The module should extend its internal mapping to cover the
+	 * new base bdev's data region and update the raid bdev's block count.
+	 * Optional - only modules that can grow by appending a member implement
+	 * this.
+	 *
+	 * Non-zero return value will abort the grow operation.
+	 */
+	int (*grow_base_bdev)(struct raid_bdev *raid_bdev, struct raid_base_bdev_info *base_info);
+
 	/* Handler for raid process requests. Required for raid modules with redundancy. */
 	int (*submit_process_request)(struct raid_bdev_process_request *process_req,
 				      struct raid_bdev_io_channel *raid_ch);
@@ -462,7 +517,7 @@ raid_bdev_flush_blocks(struct raid_base_bdev_info *base_info, struct spdk_io_cha
  */
 
 #define RAID_BDEV_SB_VERSION_MAJOR	1
-#define RAID_BDEV_SB_VERSION_MINOR	0
+#define RAID_BDEV_SB_VERSION_MINOR	1
 
 #define RAID_BDEV_SB_NAME_SIZE		64
 
@@ -487,7 +542,11 @@ struct raid_bdev_sb_base_bdev {
 	/* slot number of this base bdev in the raid */
 	uint8_t			slot;
 
-	uint8_t			reserved[23];
+	uint8_t			reserved0[7];
+	/* background process (e.g. rebuild) checkpoint offset in blocks, 0 if none (minor version 1) */
+	uint64_t		rebuild_offset;
+
+	uint8_t			reserved[8];
 };
 SPDK_STATIC_ASSERT(sizeof(struct raid_bdev_sb_base_bdev) == 64, "incorrect size");
 
@@ -553,6 +612,8 @@ int raid_bdev_load_base_bdev_superblock(struct spdk_bdev_desc *desc, struct spdk
 struct spdk_raid_bdev_opts {
 	/* Size of the background process window in KiB */
 	uint32_t process_window_size_kb;
+	/* Maximum bandwidth of the background process in MiB/s, 0 for unlimited */
+	uint32_t process_max_bandwidth_mb_sec;
 };
 
 void raid_bdev_get_opts(struct spdk_raid_bdev_opts *opts);
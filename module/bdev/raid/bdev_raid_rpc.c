@@ -540,6 +540,105 @@ cleanup:
 }
 SPDK_RPC_REGISTER("bdev_raid_add_base_bdev", rpc_bdev_raid_add_base_bdev, SPDK_RPC_RUNTIME)
 
+/*
+ * Base bdevs in RPC bdev_raid_grow_base_bdev
+ */
+struct rpc_bdev_raid_grow_base_bdev {
+	/* Base bdev name */
+	char			*base_bdev;
+
+	/* Raid bdev name */
+	char			*raid_bdev;
+};
+
+/*
+ * brief:
+ * free_rpc_bdev_raid_grow_base_bdev function is to free RPC
+ * bdev_raid_grow_base_bdev related parameters.
+ * params:
+ * req - pointer to RPC request
+ * returns:
+ * none
+ */
+static void
+free_rpc_bdev_raid_grow_base_bdev(struct rpc_bdev_raid_grow_base_bdev *req)
+{
+	free(req->base_bdev);
+	free(req->raid_bdev);
+}
+
+/*
+ * Decoder object for RPC bdev_raid_grow_base_bdev
+ */
+static const struct spdk_json_object_decoder rpc_bdev_raid_grow_base_bdev_decoders[] = {
+	{"base_bdev", offsetof(struct rpc_bdev_raid_grow_base_bdev, base_bdev), spdk_json_decode_string},
+	{"raid_bdev", offsetof(struct rpc_bdev_raid_grow_base_bdev, raid_bdev), spdk_json_decode_string},
+};
+
+static void
+rpc_bdev_raid_grow_base_bdev_done(void *ctx, int status)
+{
+	struct spdk_jsonrpc_request *request = ctx;
+
+	if (status != 0) {
+		spdk_jsonrpc_send_error_response_fmt(request, status,
+						     "Failed to grow RAID bdev with base bdev: %s",
+						     spdk_strerror(-status));
+		return;
+	}
+
+	spdk_jsonrpc_send_bool_response(request, true);
+}
+
+/*
+ * brief:
+ * bdev_raid_grow_base_bdev function is the RPC for adding a new base bdev to an
+ * online raid bdev to grow its capacity. It takes base bdev and raid bdev names
+ * as input.
+ * params:
+ * request - pointer to json rpc request
+ * params - pointer to request parameters
+ * returns:
+ * none
+ */
+static void
+rpc_bdev_raid_grow_base_bdev(struct spdk_jsonrpc_request *request,
+			     const struct spdk_json_val *params)
+{
+	struct rpc_bdev_raid_grow_base_bdev req = {};
+	struct raid_bdev *raid_bdev;
+	int rc;
+
+	if (spdk_json_decode_object(params, rpc_bdev_raid_grow_base_bdev_decoders,
+				    SPDK_COUNTOF(rpc_bdev_raid_grow_base_bdev_decoders),
+				    &req)) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "spdk_json_decode_object failed");
+		goto cleanup;
+	}
+
+	raid_bdev = raid_bdev_find_by_name(req.raid_bdev);
+	if (raid_bdev == NULL) {
+		spdk_jsonrpc_send_error_response_fmt(request, -ENODEV, "raid bdev %s is not found in config",
+						     req.raid_bdev);
+		goto cleanup;
+	}
+
+	rc = raid_bdev_grow_base_bdev(raid_bdev, req.base_bdev, rpc_bdev_raid_grow_base_bdev_done,
+				      request);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response_fmt(request, rc,
+						     "Failed to grow RAID bdev %s with base bdev %s: %s",
+						     req.raid_bdev, req.base_bdev,
+						     spdk_strerror(-rc));
+		goto cleanup;
+	}
+
+cleanup:
+	free_rpc_bdev_raid_grow_base_bdev(&req);
+}
+SPDK_RPC_REGISTER("bdev_raid_grow_base_bdev", rpc_bdev_raid_grow_base_bdev, SPDK_RPC_RUNTIME)
+
 /*
  * Decoder object for RPC bdev_raid_remove_base_bdev
  */
@@ -605,8 +704,116 @@ err:
 }
 SPDK_RPC_REGISTER("bdev_raid_remove_base_bdev", rpc_bdev_raid_remove_base_bdev, SPDK_RPC_RUNTIME)
 
+/*
+ * Input structure for RPC bdev_raid_set_read_policy
+ */
+struct rpc_bdev_raid_set_read_policy {
+	/* Raid bdev name */
+	char *name;
+
+	/* Read selection policy */
+	enum raid_bdev_read_policy policy;
+};
+
+/*
+ * brief:
+ * free_rpc_bdev_raid_set_read_policy function frees RPC bdev_raid_set_read_policy
+ * related parameters
+ * params:
+ * req - pointer to RPC request
+ * returns:
+ * none
+ */
+static void
+free_rpc_bdev_raid_set_read_policy(struct rpc_bdev_raid_set_read_policy *req)
+{
+	free(req->name);
+}
+
+/*
+ * Decoder function for RPC bdev_raid_set_read_policy to decode the policy name
+ */
+static int
+decode_read_policy(const struct spdk_json_val *val, void *out)
+{
+	int ret;
+	char *str = NULL;
+	enum raid_bdev_read_policy policy;
+
+	ret = spdk_json_decode_string(val, &str);
+	if (ret == 0 && str != NULL) {
+		policy = raid_bdev_str_to_read_policy(str);
+		if (policy == RAID_BDEV_READ_POLICY_MAX) {
+			ret = -EINVAL;
+		} else {
+			*(enum raid_bdev_read_policy *)out = policy;
+		}
+	}
+
+	free(str);
+	return ret;
+}
+
+/*
+ * Decoder object for RPC bdev_raid_set_read_policy
+ */
+static const struct spdk_json_object_decoder rpc_bdev_raid_set_read_policy_decoders[] = {
+	{"name", offsetof(struct rpc_bdev_raid_set_read_policy, name), spdk_json_decode_string},
+	{"policy", offsetof(struct rpc_bdev_raid_set_read_policy, policy), decode_read_policy},
+};
+
+/*
+ * brief:
+ * rpc_bdev_raid_set_read_policy function is the RPC for setting the read selection
+ * policy of a raid bdev. It takes the raid bdev name and policy name as input.
+ * params:
+ * request - pointer to json rpc request
+ * params - pointer to request parameters
+ * returns:
+ * none
+ */
+static void
+rpc_bdev_raid_set_read_policy(struct spdk_jsonrpc_request *request,
+			      const struct spdk_json_val *params)
+{
+	struct rpc_bdev_raid_set_read_policy req = {};
+	struct raid_bdev *raid_bdev;
+	int rc;
+
+	if (spdk_json_decode_object(params, rpc_bdev_raid_set_read_policy_decoders,
+				    SPDK_COUNTOF(rpc_bdev_raid_set_read_policy_decoders),
+				    &req)) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_PARSE_ERROR,
+						 "spdk_json_decode_object failed");
+		goto cleanup;
+	}
+
+	raid_bdev = raid_bdev_find_by_name(req.name);
+	if (raid_bdev == NULL) {
+		spdk_jsonrpc_send_error_response_fmt(request, -ENODEV,
+						     "raid bdev %s not found",
+						     req.name);
+		goto cleanup;
+	}
+
+	rc = raid_bdev_set_read_policy(raid_bdev, req.policy);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response_fmt(request, rc,
+						     "Failed to set read policy of raid bdev %s: %s",
+						     req.name, spdk_strerror(-rc));
+		goto cleanup;
+	}
+
+	spdk_jsonrpc_send_bool_response(request, true);
+
+cleanup:
+	free_rpc_bdev_raid_set_read_policy(&req);
+}
+SPDK_RPC_REGISTER("bdev_raid_set_read_policy", rpc_bdev_raid_set_read_policy, SPDK_RPC_RUNTIME)
+
 static const struct spdk_json_object_decoder rpc_bdev_raid_options_decoders[] = {
 	{"process_window_size_kb", offsetof(struct spdk_raid_bdev_opts, process_window_size_kb), spdk_json_decode_uint32, true},
+	{"process_max_bandwidth_mb_sec", offsetof(struct spdk_raid_bdev_opts, process_max_bandwidth_mb_sec), spdk_json_decode_uint32, true},
 };
 
 static void
@@ -96,19 +96,38 @@ static int
 raid_bdev_alloc_sb_io_buf(struct raid_bdev *raid_bdev)
 {
 	struct raid_bdev_superblock *sb = raid_bdev->sb;
+	uint32_t sb_io_buf_size;
 
 	if (spdk_bdev_is_md_interleaved(&raid_bdev->bdev)) {
-		raid_bdev->sb_io_buf_size = spdk_divide_round_up(sb->length,
-					    sb->block_size) * raid_bdev->bdev.blocklen;
-		raid_bdev->sb_io_buf = spdk_dma_zmalloc(raid_bdev->sb_io_buf_size, 0x1000, NULL);
+		sb_io_buf_size = spdk_divide_round_up(sb->length,
+						      sb->block_size) * raid_bdev->bdev.blocklen;
+	} else {
+		sb_io_buf_size = SPDK_ALIGN_CEIL(sb->length, raid_bdev->bdev.blocklen);
+	}
+
+	if (raid_bdev->sb_io_buf != NULL) {
+		if (raid_bdev->sb_io_buf_size >= sb_io_buf_size) {
+			return 0;
+		}
+
+		/* The superblock grew, e.g. after adding a base bdev - the io buffer
+		 * must be reallocated to fit it. */
+		if (raid_bdev->sb_io_buf != raid_bdev->sb) {
+			spdk_dma_free(raid_bdev->sb_io_buf);
+		}
+		raid_bdev->sb_io_buf = NULL;
+	}
+
+	if (spdk_bdev_is_md_interleaved(&raid_bdev->bdev)) {
+		raid_bdev->sb_io_buf = spdk_dma_zmalloc(sb_io_buf_size, 0x1000, NULL);
 		if (!raid_bdev->sb_io_buf) {
 			SPDK_ERRLOG("Failed to allocate raid bdev sb io buffer\n");
 			return -ENOMEM;
 		}
 	} else {
-		raid_bdev->sb_io_buf_size = SPDK_ALIGN_CEIL(sb->length, raid_bdev->bdev.blocklen);
 		raid_bdev->sb_io_buf = raid_bdev->sb;
 	}
+	raid_bdev->sb_io_buf_size = sb_io_buf_size;
 
 	return 0;
 }
@@ -390,11 +409,9 @@ raid_bdev_write_superblock(struct raid_bdev *raid_bdev, raid_bdev_write_sb_cb cb
 	assert(sb != NULL);
 	assert(cb != NULL);
 
-	if (raid_bdev->sb_io_buf == NULL) {
-		rc = raid_bdev_alloc_sb_io_buf(raid_bdev);
-		if (rc != 0) {
-			goto err;
-		}
+	rc = raid_bdev_alloc_sb_io_buf(raid_bdev);
+	if (rc != 0) {
+		goto err;
 	}
 
 	ctx = calloc(1, sizeof(*ctx));
@@ -316,6 +316,49 @@ concat_stop(struct raid_bdev *raid_bdev)
 	return true;
 }
 
+static int
+concat_grow_base_bdev(struct raid_bdev *raid_bdev, struct raid_base_bdev_info *base_info)
+{
+	struct concat_block_range *block_range;
+	uint8_t idx = raid_bdev_base_bdev_slot(base_info);
+	uint64_t strip_cnt, pd_block_cnt, total_blockcnt;
+	int rc;
+
+	assert(idx == raid_bdev->num_base_bdevs - 1);
+	assert(idx > 0);
+
+	block_range = realloc(raid_bdev->module_private,
+			      raid_bdev->num_base_bdevs * sizeof(struct concat_block_range));
+	if (!block_range) {
+		SPDK_ERRLOG("Can not reallocate block_range, num_base_bdevs: %u",
+			    raid_bdev->num_base_bdevs);
+		return -ENOMEM;
+	}
+	raid_bdev->module_private = block_range;
+
+	strip_cnt = base_info->data_size >> raid_bdev->strip_size_shift;
+	pd_block_cnt = strip_cnt << raid_bdev->strip_size_shift;
+
+	base_info->data_size = pd_block_cnt;
+
+	/* The new base bdev's block range starts right after the last member's */
+	total_blockcnt = block_range[idx - 1].start + block_range[idx - 1].length;
+	assert(total_blockcnt == raid_bdev->bdev.blockcnt);
+	block_range[idx].start = total_blockcnt;
+	block_range[idx].length = pd_block_cnt;
+
+	rc = spdk_bdev_notify_blockcnt_change(&raid_bdev->bdev, total_blockcnt + pd_block_cnt);
+	if (rc != 0) {
+		SPDK_ERRLOG("Failed to notify blockcount change\n");
+		return rc;
+	}
+
+	SPDK_DEBUGLOG(bdev_concat, "total blockcount %" PRIu64 ",  numbasedev %u, strip size shift %u\n",
+		      raid_bdev->bdev.blockcnt, raid_bdev->num_base_bdevs, raid_bdev->strip_size_shift);
+
+	return 0;
+}
+
 static struct raid_bdev_module g_concat_module = {
 	.level = CONCAT,
 	.base_bdevs_min = 1,
@@ -324,6 +367,7 @@ static struct raid_bdev_module g_concat_module = {
 	.stop = concat_stop,
 	.submit_rw_request = concat_submit_rw_request,
 	.submit_null_payload_request = concat_submit_null_payload_request,
+	.grow_base_bdev = concat_grow_base_bdev,
 };
 RAID_MODULE_REGISTER(&g_concat_module)
 
@@ -54,6 +54,7 @@ raid0_bdev_io_completion(struct spdk_bdev_io *bdev_io, bool success, void *cb_ar
 }
 
 static void raid0_submit_rw_request(struct raid_bdev_io *raid_io);
+static void raid0_submit_batched_rw_request(struct raid_bdev_io *raid_io);
 
 static void
 _raid0_submit_rw_request(void *_raid_io)
@@ -93,9 +94,10 @@ raid0_submit_rw_request(struct raid_bdev_io *raid_io)
 	end_strip = (raid_io->offset_blocks + raid_io->num_blocks - 1) >>
 		    raid_bdev->strip_size_shift;
 	if (start_strip != end_strip && raid_bdev->num_base_bdevs > 1) {
-		assert(false);
-		SPDK_ERRLOG("I/O spans strip boundary!\n");
-		raid_bdev_io_complete(raid_io, SPDK_BDEV_IO_STATUS_FAILED);
+		/* The I/O spans strip boundaries - scatter it to the base bdevs in a
+		 * single batch per base bdev instead of one I/O per strip.
+		 */
+		raid0_submit_batched_rw_request(raid_io);
 		return;
 	}
 
@@ -259,6 +261,236 @@ _raid0_split_io_range(struct raid_bdev_io_range *io_range, uint8_t disk_idx,
 	*_nblocks_in_disk = nblocks_in_disk;
 }
 
+/* Cursor for scattering the parent I/O buffer into per-base-bdev iov batches */
+struct raid0_iov_cursor {
+	const struct iovec	*iovs;
+	int			iovcnt;
+	int			idx;
+	size_t			offset;
+};
+
+static void
+raid0_iov_cursor_init(struct raid0_iov_cursor *cursor, const struct iovec *iovs, int iovcnt)
+{
+	cursor->iovs = iovs;
+	cursor->iovcnt = iovcnt;
+	cursor->idx = 0;
+	cursor->offset = 0;
+}
+
+static void
+raid0_iov_cursor_seek(struct raid0_iov_cursor *cursor, size_t nbytes)
+{
+	while (nbytes > 0) {
+		size_t iov_rem = cursor->iovs[cursor->idx].iov_len - cursor->offset;
+
+		if (nbytes < iov_rem) {
+			cursor->offset += nbytes;
+			return;
+		}
+		nbytes -= iov_rem;
+		cursor->idx++;
+		cursor->offset = 0;
+	}
+}
+
+static int
+raid0_iov_cursor_emit(struct raid0_iov_cursor *cursor, size_t nbytes, struct iovec *iovs)
+{
+	int iovcnt = 0;
+
+	while (nbytes > 0) {
+		const struct iovec *iov = &cursor->iovs[cursor->idx];
+		size_t len = spdk_min(nbytes, iov->iov_len - cursor->offset);
+
+		iovs[iovcnt].iov_base = iov->iov_base + cursor->offset;
+		iovs[iovcnt].iov_len = len;
+		iovcnt++;
+
+		raid0_iov_cursor_seek(cursor, len);
+		nbytes -= len;
+	}
+
+	return iovcnt;
+}
+
+struct raid0_batch_disk {
+	uint64_t	offset_in_disk;
+	uint64_t	nblocks_in_disk;
+	struct iovec	*iovs;
+	int		iovcnt;
+};
+
+struct raid0_batch_request {
+	uint8_t			start_disk;
+	uint8_t			n_disks;
+	struct raid0_batch_disk	disks[];
+	/* iovec pool for all disks follows the disks array */
+};
+
+static struct raid0_batch_request *
+raid0_batch_request_create(struct raid_bdev_io *raid_io)
+{
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	const uint32_t blocklen = raid_bdev->bdev.blocklen;
+	struct raid_bdev_io_range io_range;
+	struct raid0_batch_request *batch;
+	struct iovec *iov_pool;
+	uint64_t start_strip;
+	uint64_t end_strip;
+	size_t iov_pool_cnt;
+	uint8_t i;
+
+	_raid0_get_io_range(&io_range, raid_bdev->num_base_bdevs,
+			    raid_bdev->strip_size, raid_bdev->strip_size_shift,
+			    raid_io->offset_blocks, raid_io->num_blocks);
+
+	start_strip = raid_io->offset_blocks >> raid_bdev->strip_size_shift;
+	end_strip = (raid_io->offset_blocks + raid_io->num_blocks - 1) >> raid_bdev->strip_size_shift;
+
+	/* Each strip adds at most one iov on top of the parent iovs walked per disk */
+	iov_pool_cnt = (end_strip - start_strip + 1) +
+		       (size_t)io_range.n_disks_involved * raid_io->iovcnt;
+
+	batch = malloc(sizeof(*batch) + io_range.n_disks_involved * sizeof(batch->disks[0]) +
+		       iov_pool_cnt * sizeof(struct iovec));
+	if (batch == NULL) {
+		return NULL;
+	}
+
+	batch->start_disk = io_range.start_disk;
+	batch->n_disks = io_range.n_disks_involved;
+	iov_pool = (struct iovec *)&batch->disks[batch->n_disks];
+
+	for (i = 0; i < batch->n_disks; i++) {
+		uint8_t disk_idx = (io_range.start_disk + i) % raid_bdev->num_base_bdevs;
+		struct raid0_batch_disk *disk = &batch->disks[i];
+		struct raid0_iov_cursor cursor;
+		uint64_t first_strip_in_disk;
+		uint64_t last_strip_in_disk;
+		uint64_t strip_in_disk;
+		uint64_t pos = 0;
+
+		_raid0_split_io_range(&io_range, disk_idx, &disk->offset_in_disk,
+				      &disk->nblocks_in_disk);
+
+		disk->iovs = iov_pool;
+		disk->iovcnt = 0;
+
+		first_strip_in_disk = io_range.start_strip_in_disk + (disk_idx < io_range.start_disk);
+		last_strip_in_disk = io_range.end_strip_in_disk - (disk_idx > io_range.end_disk);
+
+		raid0_iov_cursor_init(&cursor, raid_io->iovs, raid_io->iovcnt);
+
+		for (strip_in_disk = first_strip_in_disk; strip_in_disk <= last_strip_in_disk;
+		     strip_in_disk++) {
+			uint64_t strip = strip_in_disk * raid_bdev->num_base_bdevs + disk_idx;
+			uint64_t strip_begin = spdk_max(strip << raid_bdev->strip_size_shift,
+							raid_io->offset_blocks);
+			uint64_t strip_end = spdk_min((strip + 1) << raid_bdev->strip_size_shift,
+						      raid_io->offset_blocks + raid_io->num_blocks);
+			uint64_t begin_bytes = (strip_begin - raid_io->offset_blocks) * blocklen;
+			uint64_t nbytes = (strip_end - strip_begin) * blocklen;
+
+			raid0_iov_cursor_seek(&cursor, begin_bytes - pos);
+			disk->iovcnt += raid0_iov_cursor_emit(&cursor, nbytes,
+							      &disk->iovs[disk->iovcnt]);
+			pos = begin_bytes + nbytes;
+		}
+
+		iov_pool += disk->iovcnt;
+	}
+
+	assert(iov_pool <= (struct iovec *)&batch->disks[batch->n_disks] + iov_pool_cnt);
+
+	return batch;
+}
+
+static void
+raid0_batch_io_complete(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct raid_bdev_io *raid_io = cb_arg;
+	struct raid0_batch_request *batch = raid_io->module_private;
+
+	spdk_bdev_free_io(bdev_io);
+
+	if (raid_bdev_io_complete_part(raid_io, 1, success ?
+				       SPDK_BDEV_IO_STATUS_SUCCESS :
+				       SPDK_BDEV_IO_STATUS_FAILED)) {
+		free(batch);
+	}
+}
+
+static void
+raid0_submit_batched_rw_request(struct raid_bdev_io *raid_io)
+{
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	struct spdk_bdev_ext_io_opts io_opts = {};
+	struct raid0_batch_request *batch;
+	uint8_t start_disk;
+	uint8_t n_disks;
+	int ret;
+
+	if (raid_io->base_bdev_io_remaining == 0) {
+		batch = raid0_batch_request_create(raid_io);
+		if (batch == NULL) {
+			raid_bdev_io_complete(raid_io, SPDK_BDEV_IO_STATUS_NOMEM);
+			return;
+		}
+		raid_io->module_private = batch;
+		raid_io->base_bdev_io_remaining = batch->n_disks;
+	} else {
+		batch = raid_io->module_private;
+	}
+
+	io_opts.size = sizeof(io_opts);
+	io_opts.memory_domain = raid_io->memory_domain;
+	io_opts.memory_domain_ctx = raid_io->memory_domain_ctx;
+
+	/* The batch may be freed by the completion of its last child I/O while still
+	 * inside the submission loop */
+	start_disk = batch->start_disk;
+	n_disks = batch->n_disks;
+
+	while (raid_io->base_bdev_io_submitted < n_disks) {
+		uint8_t i = raid_io->base_bdev_io_submitted;
+		uint8_t disk_idx = (start_disk + i) % raid_bdev->num_base_bdevs;
+		struct raid0_batch_disk *disk = &batch->disks[i];
+		struct raid_base_bdev_info *base_info = &raid_bdev->base_bdev_info[disk_idx];
+		struct spdk_io_channel *base_ch = raid_bdev_channel_get_base_channel(raid_io->raid_ch,
+						  disk_idx);
+
+		if (raid_io->type == SPDK_BDEV_IO_TYPE_READ) {
+			ret = raid_bdev_readv_blocks_ext(base_info, base_ch,
+							 disk->iovs, disk->iovcnt,
+							 disk->offset_in_disk, disk->nblocks_in_disk,
+							 raid0_batch_io_complete, raid_io, &io_opts);
+		} else {
+			ret = raid_bdev_writev_blocks_ext(base_info, base_ch,
+							  disk->iovs, disk->iovcnt,
+							  disk->offset_in_disk, disk->nblocks_in_disk,
+							  raid0_batch_io_complete, raid_io, &io_opts);
+		}
+
+		if (ret == 0) {
+			raid_io->base_bdev_io_submitted++;
+		} else if (ret == -ENOMEM) {
+			raid_bdev_queue_io_wait(raid_io, spdk_bdev_desc_get_bdev(base_info->desc),
+						base_ch, _raid0_submit_rw_request);
+			return;
+		} else {
+			SPDK_ERRLOG("bdev io submit error not due to ENOMEM, it should not happen\n");
+			assert(false);
+			if (raid_bdev_io_complete_part(raid_io,
+						       n_disks - raid_io->base_bdev_io_submitted,
+						       SPDK_BDEV_IO_STATUS_FAILED)) {
+				free(batch);
+			}
+			return;
+		}
+	}
+}
+
 static void raid0_submit_null_payload_request(struct raid_bdev_io *raid_io);
 
 static void
@@ -389,7 +621,13 @@ raid0_start(struct raid_bdev *raid_bdev)
 
 	if (raid_bdev->num_base_bdevs > 1) {
 		raid_bdev->bdev.optimal_io_boundary = raid_bdev->strip_size;
-		raid_bdev->bdev.split_on_optimal_io_boundary = true;
+		/* With DIF/DIX or separate metadata, rely on the bdev layer to split I/Os at
+		 * strip boundaries. Otherwise accept large I/Os whole and scatter them to the
+		 * base bdevs in a single batch per base bdev.
+		 */
+		raid_bdev->bdev.split_on_optimal_io_boundary =
+			spdk_bdev_get_dif_type(&raid_bdev->bdev) != SPDK_DIF_DISABLE ||
+			spdk_bdev_is_md_separate(&raid_bdev->bdev);
 	} else {
 		/* Do not need to split reads/writes on single bdev RAID modules. */
 		raid_bdev->bdev.optimal_io_boundary = 0;
@@ -5,17 +5,41 @@
 
 #include "bdev_raid.h"
 
+#include "spdk/env.h"
 #include "spdk/likely.h"
 #include "spdk/log.h"
 
+/* Shift for the read latency EWMA smoothing factor: alpha = 1/8 */
+#define RAID1_LATENCY_EWMA_SHIFT 3
+
+/* Weight of the base bdev with the lowest latency in the weighted random selection */
+#define RAID1_LATENCY_WEIGHT_MAX 256
+
 struct raid1_info {
 	/* The parent raid bdev */
 	struct raid_bdev *raid_bdev;
+
+	/* Counter distributing the affinity base bdevs across io channels */
+	uint8_t next_affinity_base_bdev;
+};
+
+struct raid1_base_channel_stats {
+	/* Counter of outstanding read blocks on the base bdev on this channel */
+	uint64_t read_blocks_outstanding;
+
+	/* EWMA of the base bdev's read latency in ticks on this channel */
+	uint64_t latency_ticks_ewma;
 };
 
 struct raid1_io_channel {
-	/* Array of per-base_bdev counters of outstanding read blocks on this channel */
-	uint64_t read_blocks_outstanding[0];
+	/* Base bdev to read from with the affinity read policy */
+	uint8_t affinity_base_bdev;
+
+	/* Seed for the latency read policy's weighted random selection */
+	unsigned int rand_seed;
+
+	/* Array of per-base_bdev read statistics on this channel */
+	struct raid1_base_channel_stats base_stats[0];
 };
 
 static void
@@ -24,8 +48,8 @@ raid1_channel_inc_read_counters(struct raid_bdev_io_channel *raid_ch, uint8_t id
 {
 	struct raid1_io_channel *raid1_ch = raid_bdev_channel_get_module_ctx(raid_ch);
 
-	assert(raid1_ch->read_blocks_outstanding[idx] <= UINT64_MAX - num_blocks);
-	raid1_ch->read_blocks_outstanding[idx] += num_blocks;
+	assert(raid1_ch->base_stats[idx].read_blocks_outstanding <= UINT64_MAX - num_blocks);
+	raid1_ch->base_stats[idx].read_blocks_outstanding += num_blocks;
 }
 
 static void
@@ -34,8 +58,22 @@ raid1_channel_dec_read_counters(struct raid_bdev_io_channel *raid_ch, uint8_t id
 {
 	struct raid1_io_channel *raid1_ch = raid_bdev_channel_get_module_ctx(raid_ch);
 
-	assert(raid1_ch->read_blocks_outstanding[idx] >= num_blocks);
-	raid1_ch->read_blocks_outstanding[idx] -= num_blocks;
+	assert(raid1_ch->base_stats[idx].read_blocks_outstanding >= num_blocks);
+	raid1_ch->base_stats[idx].read_blocks_outstanding -= num_blocks;
+}
+
+static void
+raid1_channel_update_read_latency(struct raid_bdev_io_channel *raid_ch, uint8_t idx,
+				  uint64_t latency_ticks)
+{
+	struct raid1_io_channel *raid1_ch = raid_bdev_channel_get_module_ctx(raid_ch);
+	uint64_t *ewma = &raid1_ch->base_stats[idx].latency_ticks_ewma;
+
+	if (*ewma == 0) {
+		*ewma = latency_ticks;
+	} else {
+		*ewma += ((int64_t)(latency_ticks - *ewma)) >> RAID1_LATENCY_EWMA_SHIFT;
+	}
 }
 
 static void
@@ -197,6 +235,11 @@ raid1_read_bdev_io_completion(struct spdk_bdev_io *bdev_io, bool success, void *
 	raid1_channel_dec_read_counters(raid_io->raid_ch, raid_io->base_bdev_io_submitted,
 					raid_io->num_blocks);
 
+	if (raid_io->raid_bdev->read_policy == RAID_BDEV_READ_POLICY_LATENCY) {
+		raid1_channel_update_read_latency(raid_io->raid_ch, raid_io->base_bdev_io_submitted,
+						  spdk_get_ticks() - (uintptr_t)raid_io->module_private);
+	}
+
 	if (!success) {
 		raid_io->base_bdev_io_remaining = raid_io->raid_bdev->num_base_bdevs;
 		raid1_read_other_base_bdev(raid_io);
@@ -217,7 +260,8 @@ _raid1_submit_rw_request(void *_raid_io)
 }
 
 static uint8_t
-raid1_channel_next_read_base_bdev(struct raid_bdev *raid_bdev, struct raid_bdev_io_channel *raid_ch)
+raid1_channel_next_read_base_bdev_outstanding(struct raid_bdev *raid_bdev,
+		struct raid_bdev_io_channel *raid_ch)
 {
 	struct raid1_io_channel *raid1_ch = raid_bdev_channel_get_module_ctx(raid_ch);
 	uint64_t read_blocks_min = UINT64_MAX;
@@ -226,8 +270,8 @@ raid1_channel_next_read_base_bdev(struct raid_bdev *raid_bdev, struct raid_bdev_
 
 	for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
 		if (raid_bdev_channel_get_base_channel(raid_ch, i) != NULL &&
-		    raid1_ch->read_blocks_outstanding[i] < read_blocks_min) {
-			read_blocks_min = raid1_ch->read_blocks_outstanding[i];
+		    raid1_ch->base_stats[i].read_blocks_outstanding < read_blocks_min) {
+			read_blocks_min = raid1_ch->base_stats[i].read_blocks_outstanding;
 			idx = i;
 		}
 	}
@@ -235,6 +279,105 @@ raid1_channel_next_read_base_bdev(struct raid_bdev *raid_bdev, struct raid_bdev_
 	return idx;
 }
 
+static uint64_t
+raid1_latency_weight(struct raid1_io_channel *raid1_ch, uint8_t idx, uint64_t ewma_min)
+{
+	uint64_t ewma = raid1_ch->base_stats[idx].latency_ticks_ewma;
+	uint64_t weight;
+
+	/* Give base bdevs without latency samples the maximum weight to get them probed */
+	if (ewma == 0) {
+		return RAID1_LATENCY_WEIGHT_MAX;
+	}
+
+	weight = ewma_min * RAID1_LATENCY_WEIGHT_MAX / ewma;
+
+	return spdk_max(weight, 1);
+}
+
+static uint8_t
+raid1_channel_next_read_base_bdev_latency(struct raid_bdev *raid_bdev,
+		struct raid_bdev_io_channel *raid_ch)
+{
+	struct raid1_io_channel *raid1_ch = raid_bdev_channel_get_module_ctx(raid_ch);
+	uint64_t ewma_min = UINT64_MAX;
+	uint64_t weights_sum = 0;
+	uint64_t r;
+	uint8_t idx = UINT8_MAX;
+	uint8_t i;
+
+	for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
+		if (raid_bdev_channel_get_base_channel(raid_ch, i) == NULL) {
+			continue;
+		}
+
+		idx = i;
+		if (raid1_ch->base_stats[i].latency_ticks_ewma != 0) {
+			ewma_min = spdk_min(ewma_min, raid1_ch->base_stats[i].latency_ticks_ewma);
+		}
+	}
+
+	if (idx == UINT8_MAX) {
+		return idx;
+	}
+
+	/* No latency samples yet - fall back to the outstanding block counters */
+	if (ewma_min == UINT64_MAX) {
+		return raid1_channel_next_read_base_bdev_outstanding(raid_bdev, raid_ch);
+	}
+
+	for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
+		if (raid_bdev_channel_get_base_channel(raid_ch, i) != NULL) {
+			weights_sum += raid1_latency_weight(raid1_ch, i, ewma_min);
+		}
+	}
+
+	r = rand_r(&raid1_ch->rand_seed) % weights_sum;
+
+	for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
+		uint64_t weight;
+
+		if (raid_bdev_channel_get_base_channel(raid_ch, i) == NULL) {
+			continue;
+		}
+
+		weight = raid1_latency_weight(raid1_ch, i, ewma_min);
+		if (r < weight) {
+			return i;
+		}
+		r -= weight;
+	}
+
+	return idx;
+}
+
+static uint8_t
+raid1_channel_next_read_base_bdev_affinity(struct raid_bdev *raid_bdev,
+		struct raid_bdev_io_channel *raid_ch)
+{
+	struct raid1_io_channel *raid1_ch = raid_bdev_channel_get_module_ctx(raid_ch);
+	uint8_t idx = raid1_ch->affinity_base_bdev;
+
+	if (spdk_likely(raid_bdev_channel_get_base_channel(raid_ch, idx) != NULL)) {
+		return idx;
+	}
+
+	return raid1_channel_next_read_base_bdev_outstanding(raid_bdev, raid_ch);
+}
+
+static uint8_t
+raid1_channel_next_read_base_bdev(struct raid_bdev *raid_bdev, struct raid_bdev_io_channel *raid_ch)
+{
+	switch (raid_bdev->read_policy) {
+	case RAID_BDEV_READ_POLICY_LATENCY:
+		return raid1_channel_next_read_base_bdev_latency(raid_bdev, raid_ch);
+	case RAID_BDEV_READ_POLICY_AFFINITY:
+		return raid1_channel_next_read_base_bdev_affinity(raid_bdev, raid_ch);
+	default:
+		return raid1_channel_next_read_base_bdev_outstanding(raid_bdev, raid_ch);
+	}
+}
+
 static int
 raid1_submit_read_request(struct raid_bdev_io *raid_io)
 {
@@ -263,6 +406,9 @@ raid1_submit_read_request(struct raid_bdev_io *raid_io)
 	if (spdk_likely(ret == 0)) {
 		raid1_channel_inc_read_counters(raid_ch, idx, raid_io->num_blocks);
 		raid_io->base_bdev_io_submitted = idx;
+		if (raid_bdev->read_policy == RAID_BDEV_READ_POLICY_LATENCY) {
+			raid_io->module_private = (void *)(uintptr_t)spdk_get_ticks();
+		}
 	} else if (spdk_unlikely(ret == -ENOMEM)) {
 		raid_bdev_queue_io_wait(raid_io, spdk_bdev_desc_get_bdev(base_info->desc),
 					base_ch, _raid1_submit_rw_request);
@@ -357,6 +503,13 @@ raid1_ioch_destroy(void *io_device, void *ctx_buf)
 static int
 raid1_ioch_create(void *io_device, void *ctx_buf)
 {
+	struct raid1_info *r1info = io_device;
+	struct raid1_io_channel *raid1_ch = ctx_buf;
+
+	raid1_ch->affinity_base_bdev = __atomic_fetch_add(&r1info->next_affinity_base_bdev, 1,
+				       __ATOMIC_RELAXED) % r1info->raid_bdev->num_base_bdevs;
+	raid1_ch->rand_seed = (unsigned int)spdk_get_ticks();
+
 	return 0;
 }
 
@@ -398,7 +551,8 @@ raid1_start(struct raid_bdev *raid_bdev)
 
 	snprintf(name, sizeof(name), "raid1_%s", raid_bdev->bdev.name);
 	spdk_io_device_register(r1info, raid1_ioch_create, raid1_ioch_destroy,
-				sizeof(struct raid1_io_channel) + raid_bdev->num_base_bdevs * sizeof(uint64_t),
+				sizeof(struct raid1_io_channel) +
+				raid_bdev->num_base_bdevs * sizeof(struct raid1_base_channel_stats),
 				name);
 
 	return 0;
@@ -505,6 +659,7 @@ static struct raid_bdev_module g_raid1_module = {
 	.base_bdevs_min = 2,
 	.base_bdevs_constraint = {CONSTRAINT_MIN_BASE_BDEVS_OPERATIONAL, 1},
 	.memory_domains_supported = true,
+	.read_policy_supported = true,
 	.start = raid1_start,
 	.stop = raid1_stop,
 	.submit_rw_request = raid1_submit_rw_request,
@@ -16,6 +16,12 @@
 /* Maximum concurrent full stripe writes per io channel */
 #define RAID5F_MAX_STRIPES 32
 
+/* Maximum stripes accumulating partial writes per io channel */
+#define RAID5F_MAX_RMW_STRIPES 8
+
+/* Interval of the poller flushing accumulated partial writes, in microseconds */
+#define RAID5F_RMW_FLUSH_PERIOD_US 100
+
 struct chunk {
 	/* Corresponds to base_bdev index */
 	uint8_t index;
@@ -33,6 +39,26 @@ struct chunk {
 	void *md_buf;
 };
 
+/* Partial write state of a single chunk of a cached stripe */
+struct raid5f_rmw_chunk {
+	/* Pending partial writes to the chunk in submission order, linked via module_private */
+	struct raid_bdev_io *writes_head;
+	struct raid_bdev_io *writes_tail;
+
+	/* Contiguous range of chunk blocks covered by the pending writes */
+	uint32_t covered_start;
+	uint32_t covered_end;
+
+	/* The pending writes do not form a contiguous range */
+	bool fragmented;
+
+	/* Chunk data must be read from the base bdev before the parity update */
+	bool read;
+
+	/* Chunk holds new data and must be written back */
+	bool write;
+};
+
 struct stripe_request;
 typedef void (*stripe_req_xor_cb)(struct stripe_request *stripe_req, int status);
 
@@ -40,6 +66,7 @@ struct stripe_request {
 	enum stripe_request_type {
 		STRIPE_REQ_WRITE,
 		STRIPE_REQ_RECONSTRUCT,
+		STRIPE_REQ_RMW,
 	} type;
 
 	struct raid5f_io_channel *r5ch;
@@ -75,6 +102,29 @@ struct stripe_request {
 			/* Offset from chunk start */
 			uint64_t chunk_offset;
 		} reconstruct;
+
+		struct {
+			/* Internal I/O driving reads and writes of the stripe chunks */
+			struct raid_bdev_io raid_io;
+
+			/* Array of buffers for reading and merging chunk data, indexed by chunk */
+			void **chunk_buffers;
+
+			/* Array of buffers for chunk io metadata, indexed by chunk */
+			void **chunk_md_buffers;
+
+			/* Array of per-chunk partial write state, indexed by chunk */
+			struct raid5f_rmw_chunk *chunks;
+
+			/* Current phase of the read-modify-write cycle */
+			enum raid5f_rmw_phase {
+				RAID5F_RMW_PHASE_READ,
+				RAID5F_RMW_PHASE_WRITE,
+			} phase;
+
+			/* Set once the stripe has waited a full flush period for more writes */
+			bool aged;
+		} rmw;
 	};
 
 	/* Array of iovec iterators for each chunk */
@@ -122,8 +172,18 @@ struct raid5f_io_channel {
 	struct {
 		TAILQ_HEAD(, stripe_request) write;
 		TAILQ_HEAD(, stripe_request) reconstruct;
+		TAILQ_HEAD(, stripe_request) rmw;
 	} free_stripe_requests;
 
+	/* Stripe requests accumulating partial writes, oldest first */
+	TAILQ_HEAD(, stripe_request) rmw_stripes;
+
+	/* Stripe requests with a read-modify-write cycle in progress */
+	TAILQ_HEAD(, stripe_request) rmw_flushing;
+
+	/* Periodically flushes accumulated partial writes */
+	struct spdk_poller *rmw_poller;
+
 	/* accel_fw channel */
 	struct spdk_io_channel *accel_ch;
 
@@ -183,6 +243,8 @@ raid5f_stripe_request_release(struct stripe_request *stripe_req)
 		TAILQ_INSERT_HEAD(&stripe_req->r5ch->free_stripe_requests.write, stripe_req, link);
 	} else if (stripe_req->type == STRIPE_REQ_RECONSTRUCT) {
 		TAILQ_INSERT_HEAD(&stripe_req->r5ch->free_stripe_requests.reconstruct, stripe_req, link);
+	} else if (stripe_req->type == STRIPE_REQ_RMW) {
+		TAILQ_INSERT_HEAD(&stripe_req->r5ch->free_stripe_requests.rmw, stripe_req, link);
 	} else {
 		assert(false);
 	}
@@ -290,7 +352,7 @@ raid5f_xor_stripe(struct stripe_request *stripe_req, stripe_req_xor_cb cb)
 
 	assert(cb != NULL);
 
-	if (spdk_likely(stripe_req->type == STRIPE_REQ_WRITE)) {
+	if (spdk_likely(stripe_req->type == STRIPE_REQ_WRITE || stripe_req->type == STRIPE_REQ_RMW)) {
 		num_blocks = raid_bdev->strip_size;
 		dest_chunk = stripe_req->parity_chunk;
 	} else if (stripe_req->type == STRIPE_REQ_RECONSTRUCT) {
@@ -331,11 +393,13 @@ raid5f_xor_stripe(struct stripe_request *stripe_req, stripe_req_xor_cb cb)
 		c = 0;
 		FOR_EACH_CHUNK(stripe_req, chunk) {
 			if (chunk != dest_chunk) {
+				assert(chunk->md_buf != NULL);
 				stripe_req->chunk_xor_md_buffers[c] = chunk->md_buf;
 				c++;
 			}
 		}
 
+		assert(dest_chunk->md_buf != NULL);
 		ret = spdk_accel_submit_xor(stripe_req->r5ch->accel_ch, dest_chunk->md_buf,
 					    stripe_req->chunk_xor_md_buffers, n_src, len,
 					    raid5f_xor_stripe_md_cb, stripe_req);
@@ -395,6 +459,9 @@ raid5f_chunk_complete_bdev_io(struct spdk_bdev_io *bdev_io, bool success, void *
 		raid5f_stripe_request_chunk_write_complete(stripe_req, status);
 	} else if (stripe_req->type == STRIPE_REQ_RECONSTRUCT) {
 		raid5f_stripe_request_chunk_read_complete(stripe_req, status);
+	} else if (stripe_req->type == STRIPE_REQ_RMW) {
+		/* Completion of the whole cycle is handled by the internal I/O's completion_cb */
+		raid_bdev_io_complete_part(stripe_req->raid_io, 1, status);
 	} else {
 		assert(false);
 	}
@@ -462,6 +529,36 @@ raid5f_chunk_submit(struct chunk *chunk)
 						 base_offset_blocks, raid_io->num_blocks,
 						 raid5f_chunk_complete_bdev_io, chunk, &io_opts);
 		break;
+	case STRIPE_REQ_RMW: {
+		struct raid5f_rmw_chunk *rmw_chunk = &stripe_req->rmw.chunks[chunk->index];
+
+		if (stripe_req->rmw.phase == RAID5F_RMW_PHASE_READ) {
+			if (!rmw_chunk->read) {
+				raid_bdev_io_complete_part(raid_io, 1, SPDK_BDEV_IO_STATUS_SUCCESS);
+				return 0;
+			}
+
+			if (base_ch == NULL) {
+				/* Old chunk data is unavailable - the parity cannot be updated */
+				raid_bdev_io_complete_part(raid_io, 1, SPDK_BDEV_IO_STATUS_FAILED);
+				return 0;
+			}
+
+			ret = raid_bdev_readv_blocks_ext(base_info, base_ch, chunk->iovs, chunk->iovcnt,
+							 base_offset_blocks, raid_bdev->strip_size,
+							 raid5f_chunk_complete_bdev_io, chunk, &io_opts);
+		} else {
+			if (!rmw_chunk->write || base_ch == NULL) {
+				raid_bdev_io_complete_part(raid_io, 1, SPDK_BDEV_IO_STATUS_SUCCESS);
+				return 0;
+			}
+
+			ret = raid_bdev_writev_blocks_ext(base_info, base_ch, chunk->iovs, chunk->iovcnt,
+							  base_offset_blocks, raid_bdev->strip_size,
+							  raid5f_chunk_complete_bdev_io, chunk, &io_opts);
+		}
+		break;
+	}
 	default:
 		assert(false);
 		ret = -EINVAL;
@@ -481,16 +578,18 @@ raid5f_chunk_submit(struct chunk *chunk)
 			 */
 			uint64_t base_bdev_io_not_submitted;
 
-			if (stripe_req->type == STRIPE_REQ_WRITE) {
-				base_bdev_io_not_submitted = raid_bdev->num_base_bdevs -
+			if (stripe_req->type == STRIPE_REQ_RECONSTRUCT) {
+				base_bdev_io_not_submitted = raid5f_stripe_data_chunks_num(raid_bdev) -
 							     raid_io->base_bdev_io_submitted;
 			} else {
-				base_bdev_io_not_submitted = raid5f_stripe_data_chunks_num(raid_bdev) -
+				base_bdev_io_not_submitted = raid_bdev->num_base_bdevs -
 							     raid_io->base_bdev_io_submitted;
 			}
 
 			if (raid_bdev_io_complete_part(raid_io, base_bdev_io_not_submitted,
-						       SPDK_BDEV_IO_STATUS_FAILED)) {
+						       SPDK_BDEV_IO_STATUS_FAILED) &&
+			    stripe_req->type != STRIPE_REQ_RMW) {
+				/* RMW requests are released by the internal I/O's completion_cb */
 				raid5f_stripe_request_release(stripe_req);
 			}
 		}
@@ -655,6 +754,367 @@ raid5f_submit_write_request(struct raid_bdev_io *raid_io, uint64_t stripe_index)
 	return 0;
 }
 
+static inline struct raid5f_rmw_chunk *
+raid5f_chunk_rmw_state(struct stripe_request *stripe_req, struct chunk *chunk)
+{
+	return &stripe_req->rmw.chunks[chunk->index];
+}
+
+static void
+raid5f_rmw_io_start(struct stripe_request *stripe_req, enum spdk_bdev_io_type type,
+		    enum raid5f_rmw_phase phase, raid_bdev_io_completion_cb completion_cb)
+{
+	struct raid_bdev_io *raid_io = &stripe_req->rmw.raid_io;
+	struct raid5f_info *r5f_info = raid5f_ch_to_r5f_info(stripe_req->r5ch);
+	struct raid_bdev *raid_bdev = r5f_info->raid_bdev;
+
+	/*
+	 * The internal I/O is not backed by a bdev_io, so it cannot be initialized with
+	 * raid_bdev_io_init() and is never completed through the generic bdev layer -
+	 * completion_cb is always set.
+	 */
+	raid_io->type = type;
+	raid_io->offset_blocks = stripe_req->stripe_index * r5f_info->stripe_blocks;
+	raid_io->num_blocks = r5f_info->stripe_blocks;
+	raid_io->iovs = NULL;
+	raid_io->iovcnt = 0;
+	raid_io->memory_domain = NULL;
+	raid_io->memory_domain_ctx = NULL;
+	raid_io->md_buf = stripe_req->rmw.chunk_md_buffers != NULL ?
+			  stripe_req->rmw.chunk_md_buffers[stripe_req->parity_chunk->index] : NULL;
+	raid_io->module_private = stripe_req;
+	raid_io->completion_cb = completion_cb;
+	raid_io->split.offset = RAID_OFFSET_BLOCKS_INVALID;
+	raid_io->base_bdev_io_remaining = raid_bdev->num_base_bdevs;
+	raid_io->base_bdev_io_submitted = 0;
+	raid_bdev_io_set_default_status(raid_io, SPDK_BDEV_IO_STATUS_SUCCESS);
+
+	stripe_req->rmw.phase = phase;
+
+	raid5f_stripe_request_submit_chunks(stripe_req);
+}
+
+static void
+raid5f_rmw_done(struct stripe_request *stripe_req, enum spdk_bdev_io_status status)
+{
+	struct raid5f_io_channel *r5ch = stripe_req->r5ch;
+	struct raid_bdev_io *writes_head = NULL;
+	struct raid_bdev_io *writes_tail = NULL;
+	struct raid_bdev_io *raid_io, *next;
+	struct chunk *chunk;
+
+	/*
+	 * Detach the pending writes and release the stripe request before completing them -
+	 * a completion may synchronously resubmit a write that was rejected with ENOMEM while
+	 * this stripe was being flushed.
+	 */
+	FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+		struct raid5f_rmw_chunk *rmw_chunk = raid5f_chunk_rmw_state(stripe_req, chunk);
+
+		if (rmw_chunk->writes_head == NULL) {
+			continue;
+		}
+
+		if (writes_tail == NULL) {
+			writes_head = rmw_chunk->writes_head;
+		} else {
+			writes_tail->module_private = rmw_chunk->writes_head;
+		}
+		writes_tail = rmw_chunk->writes_tail;
+
+		rmw_chunk->writes_head = NULL;
+		rmw_chunk->writes_tail = NULL;
+	}
+
+	TAILQ_REMOVE(&r5ch->rmw_flushing, stripe_req, link);
+	raid5f_stripe_request_release(stripe_req);
+
+	for (raid_io = writes_head; raid_io != NULL; raid_io = next) {
+		next = raid_io->module_private;
+		raid_bdev_io_complete(raid_io, status);
+	}
+}
+
+static void
+raid5f_rmw_writes_done(struct raid_bdev_io *raid_io, enum spdk_bdev_io_status status)
+{
+	struct stripe_request *stripe_req = raid_io->module_private;
+
+	raid_io->completion_cb = NULL;
+
+	raid5f_rmw_done(stripe_req, status);
+}
+
+static void
+raid5f_rmw_xor_done(struct stripe_request *stripe_req, int status)
+{
+	if (status != 0) {
+		raid5f_rmw_done(stripe_req, SPDK_BDEV_IO_STATUS_FAILED);
+		return;
+	}
+
+	raid5f_rmw_io_start(stripe_req, SPDK_BDEV_IO_TYPE_WRITE, RAID5F_RMW_PHASE_WRITE,
+			    raid5f_rmw_writes_done);
+}
+
+static void
+raid5f_rmw_overlay_chunk(struct stripe_request *stripe_req, struct chunk *chunk)
+{
+	struct raid5f_info *r5f_info = raid5f_ch_to_r5f_info(stripe_req->r5ch);
+	struct raid_bdev *raid_bdev = r5f_info->raid_bdev;
+	struct raid5f_rmw_chunk *rmw_chunk = raid5f_chunk_rmw_state(stripe_req, chunk);
+	uint8_t *buf = stripe_req->rmw.chunk_buffers[chunk->index];
+	struct raid_bdev_io *raid_io;
+
+	if (chunk->iovs[0].iov_base != buf) {
+		/* A single write covering the whole chunk is used in place - nothing to merge */
+		return;
+	}
+
+	for (raid_io = rmw_chunk->writes_head; raid_io != NULL; raid_io = raid_io->module_private) {
+		uint64_t stripe_offset = raid_io->offset_blocks % r5f_info->stripe_blocks;
+		uint64_t chunk_offset = stripe_offset % raid_bdev->strip_size;
+		uint8_t *dst = buf + chunk_offset * raid_bdev->bdev.blocklen;
+		size_t remaining = raid_io->num_blocks * raid_bdev->bdev.blocklen;
+		int i;
+
+		for (i = 0; i < raid_io->iovcnt && remaining > 0; i++) {
+			size_t len = spdk_min(remaining, raid_io->iovs[i].iov_len);
+
+			memcpy(dst, raid_io->iovs[i].iov_base, len);
+			dst += len;
+			remaining -= len;
+		}
+
+		if (raid_io->md_buf != NULL && stripe_req->rmw.chunk_md_buffers != NULL) {
+			memcpy(stripe_req->rmw.chunk_md_buffers[chunk->index] +
+			       chunk_offset * raid_bdev->bdev.md_len,
+			       raid_io->md_buf, raid_io->num_blocks * raid_bdev->bdev.md_len);
+		}
+	}
+}
+
+static void
+raid5f_rmw_reads_done(struct raid_bdev_io *raid_io, enum spdk_bdev_io_status status)
+{
+	struct stripe_request *stripe_req = raid_io->module_private;
+	struct chunk *chunk;
+
+	raid_io->completion_cb = NULL;
+
+	if (status != SPDK_BDEV_IO_STATUS_SUCCESS) {
+		raid5f_rmw_done(stripe_req, status);
+		return;
+	}
+
+	FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+		if (raid5f_chunk_rmw_state(stripe_req, chunk)->writes_head != NULL) {
+			raid5f_rmw_overlay_chunk(stripe_req, chunk);
+		}
+	}
+
+	if (raid_bdev_channel_get_base_channel(raid_io->raid_ch, stripe_req->parity_chunk->index) != NULL) {
+		raid5f_xor_stripe(stripe_req, raid5f_rmw_xor_done);
+	} else {
+		raid5f_rmw_xor_done(stripe_req, 0);
+	}
+}
+
+static void
+raid5f_rmw_flush(struct stripe_request *stripe_req)
+{
+	struct raid5f_io_channel *r5ch = stripe_req->r5ch;
+	struct raid5f_info *r5f_info = raid5f_ch_to_r5f_info(r5ch);
+	struct raid_bdev *raid_bdev = r5f_info->raid_bdev;
+	struct raid_bdev_io_channel *raid_ch = stripe_req->rmw.raid_io.raid_ch;
+	size_t chunk_len = raid_bdev->strip_size * raid_bdev->bdev.blocklen;
+	bool parity_online = raid_bdev_channel_get_base_channel(raid_ch,
+			     stripe_req->parity_chunk->index) != NULL;
+	struct raid5f_rmw_chunk *rmw_chunk;
+	struct chunk *chunk;
+
+	TAILQ_REMOVE(&r5ch->rmw_stripes, stripe_req, link);
+	TAILQ_INSERT_TAIL(&r5ch->rmw_flushing, stripe_req, link);
+
+	FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+		bool covered;
+
+		rmw_chunk = raid5f_chunk_rmw_state(stripe_req, chunk);
+		covered = !rmw_chunk->fragmented && rmw_chunk->covered_start == 0 &&
+			  rmw_chunk->covered_end == raid_bdev->strip_size;
+
+		if (covered && stripe_req->rmw.chunk_md_buffers != NULL) {
+			/* A write without a metadata buffer leaves the on-disk metadata
+			 * in place, so the chunk metadata must still be read to fill the
+			 * chunk metadata buffer and to compute the parity metadata. */
+			struct raid_bdev_io *write_io;
+
+			for (write_io = rmw_chunk->writes_head; write_io != NULL;
+			     write_io = write_io->module_private) {
+				if (write_io->md_buf == NULL) {
+					covered = false;
+					break;
+				}
+			}
+		}
+
+		rmw_chunk->write = rmw_chunk->writes_head != NULL;
+		/* Chunks not fully covered by pending writes must be read to update the parity
+		 * and to fill the gaps in the chunk buffer before it is written back. Chunks
+		 * without pending writes are only needed for the parity update. */
+		rmw_chunk->read = !covered && (parity_online || rmw_chunk->write);
+
+		if (covered && rmw_chunk->writes_head == rmw_chunk->writes_tail) {
+			/* A single write covers the whole chunk - use its buffers directly */
+			struct raid_bdev_io *write_io = rmw_chunk->writes_head;
+			int i;
+
+			if (raid5f_chunk_set_iovcnt(chunk, write_io->iovcnt) != 0) {
+				raid5f_rmw_done(stripe_req, SPDK_BDEV_IO_STATUS_FAILED);
+				return;
+			}
+
+			for (i = 0; i < write_io->iovcnt; i++) {
+				chunk->iovs[i] = write_io->iovs[i];
+			}
+			chunk->md_buf = write_io->md_buf;
+		} else {
+			chunk->iovs[0].iov_base = stripe_req->rmw.chunk_buffers[chunk->index];
+			chunk->iovs[0].iov_len = chunk_len;
+			chunk->iovcnt = 1;
+			chunk->md_buf = stripe_req->rmw.chunk_md_buffers != NULL ?
+					stripe_req->rmw.chunk_md_buffers[chunk->index] : NULL;
+		}
+	}
+
+	chunk = stripe_req->parity_chunk;
+	rmw_chunk = raid5f_chunk_rmw_state(stripe_req, chunk);
+	rmw_chunk->read = false;
+	rmw_chunk->write = parity_online;
+	chunk->iovs[0].iov_base = stripe_req->rmw.chunk_buffers[chunk->index];
+	chunk->iovs[0].iov_len = chunk_len;
+	chunk->iovcnt = 1;
+	chunk->md_buf = stripe_req->rmw.chunk_md_buffers != NULL ?
+			stripe_req->rmw.chunk_md_buffers[chunk->index] : NULL;
+
+	raid5f_rmw_io_start(stripe_req, SPDK_BDEV_IO_TYPE_READ, RAID5F_RMW_PHASE_READ,
+			    raid5f_rmw_reads_done);
+}
+
+static bool
+raid5f_rmw_stripe_full(struct stripe_request *stripe_req)
+{
+	struct raid_bdev *raid_bdev = raid5f_ch_to_r5f_info(stripe_req->r5ch)->raid_bdev;
+	struct chunk *chunk;
+
+	FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+		struct raid5f_rmw_chunk *rmw_chunk = raid5f_chunk_rmw_state(stripe_req, chunk);
+
+		if (rmw_chunk->fragmented || rmw_chunk->covered_start != 0 ||
+		    rmw_chunk->covered_end != raid_bdev->strip_size) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static int
+raid5f_submit_partial_write_request(struct raid_bdev_io *raid_io, uint64_t stripe_index,
+				    uint64_t stripe_offset)
+{
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	struct raid5f_io_channel *r5ch = raid_bdev_channel_get_module_ctx(raid_io->raid_ch);
+	uint8_t chunk_data_idx = stripe_offset >> raid_bdev->strip_size_shift;
+	uint8_t p_idx = raid5f_stripe_parity_chunk_index(raid_bdev, stripe_index);
+	uint8_t chunk_idx = chunk_data_idx < p_idx ? chunk_data_idx : chunk_data_idx + 1;
+	uint64_t chunk_offset = stripe_offset - (chunk_data_idx << raid_bdev->strip_size_shift);
+	uint32_t new_start = chunk_offset;
+	uint32_t new_end = chunk_offset + raid_io->num_blocks;
+	struct stripe_request *stripe_req;
+	struct raid5f_rmw_chunk *rmw_chunk;
+
+	assert(new_end <= raid_bdev->strip_size);
+
+	/* Wait for an in-progress read-modify-write of the same stripe to finish first */
+	TAILQ_FOREACH(stripe_req, &r5ch->rmw_flushing, link) {
+		if (stripe_req->stripe_index == stripe_index) {
+			return -ENOMEM;
+		}
+	}
+
+	TAILQ_FOREACH(stripe_req, &r5ch->rmw_stripes, link) {
+		if (stripe_req->stripe_index == stripe_index) {
+			break;
+		}
+	}
+
+	if (stripe_req == NULL) {
+		stripe_req = TAILQ_FIRST(&r5ch->free_stripe_requests.rmw);
+		if (stripe_req == NULL) {
+			/* Flush the oldest stripe to make room and retry this I/O later */
+			stripe_req = TAILQ_FIRST(&r5ch->rmw_stripes);
+			if (stripe_req != NULL) {
+				raid5f_rmw_flush(stripe_req);
+			}
+			return -ENOMEM;
+		}
+		TAILQ_REMOVE(&r5ch->free_stripe_requests.rmw, stripe_req, link);
+
+		stripe_req->rmw.raid_io.raid_bdev = raid_bdev;
+		stripe_req->rmw.raid_io.raid_ch = raid_io->raid_ch;
+		raid5f_stripe_request_init(stripe_req, &stripe_req->rmw.raid_io, stripe_index);
+		memset(stripe_req->rmw.chunks, 0,
+		       raid_bdev->num_base_bdevs * sizeof(*stripe_req->rmw.chunks));
+		stripe_req->rmw.aged = false;
+
+		TAILQ_INSERT_TAIL(&r5ch->rmw_stripes, stripe_req, link);
+	}
+
+	rmw_chunk = &stripe_req->rmw.chunks[chunk_idx];
+
+	if (rmw_chunk->writes_head == NULL) {
+		rmw_chunk->covered_start = new_start;
+		rmw_chunk->covered_end = new_end;
+		rmw_chunk->writes_head = raid_io;
+	} else {
+		if (new_start <= rmw_chunk->covered_end && new_end >= rmw_chunk->covered_start) {
+			rmw_chunk->covered_start = spdk_min(rmw_chunk->covered_start, new_start);
+			rmw_chunk->covered_end = spdk_max(rmw_chunk->covered_end, new_end);
+		} else {
+			rmw_chunk->fragmented = true;
+		}
+		rmw_chunk->writes_tail->module_private = raid_io;
+	}
+	rmw_chunk->writes_tail = raid_io;
+	raid_io->module_private = NULL;
+
+	if (raid5f_rmw_stripe_full(stripe_req)) {
+		raid5f_rmw_flush(stripe_req);
+	}
+
+	return 0;
+}
+
+static int
+raid5f_rmw_poller(void *ctx)
+{
+	struct raid5f_io_channel *r5ch = ctx;
+	struct stripe_request *stripe_req, *tmp;
+	int count = 0;
+
+	TAILQ_FOREACH_SAFE(stripe_req, &r5ch->rmw_stripes, link, tmp) {
+		if (stripe_req->rmw.aged) {
+			raid5f_rmw_flush(stripe_req);
+			count++;
+		} else {
+			stripe_req->rmw.aged = true;
+		}
+	}
+
+	return count > 0 ? SPDK_POLLER_BUSY : SPDK_POLLER_IDLE;
+}
+
 static void
 raid5f_chunk_read_complete(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
 {
@@ -816,9 +1276,13 @@ raid5f_submit_rw_request(struct raid_bdev_io *raid_io)
 		ret = raid5f_submit_read_request(raid_io, stripe_index, stripe_offset);
 		break;
 	case SPDK_BDEV_IO_TYPE_WRITE:
-		assert(stripe_offset == 0);
-		assert(raid_io->num_blocks == r5f_info->stripe_blocks);
-		ret = raid5f_submit_write_request(raid_io, stripe_index);
+		if (raid_io->num_blocks < r5f_info->stripe_blocks) {
+			ret = raid5f_submit_partial_write_request(raid_io, stripe_index, stripe_offset);
+		} else {
+			assert(stripe_offset == 0);
+			assert(raid_io->num_blocks == r5f_info->stripe_blocks);
+			ret = raid5f_submit_write_request(raid_io, stripe_index);
+		}
 		break;
 	default:
 		ret = -EINVAL;
@@ -861,6 +1325,26 @@ raid5f_stripe_request_free(struct stripe_request *stripe_req)
 			}
 			free(stripe_req->reconstruct.chunk_md_buffers);
 		}
+	} else if (stripe_req->type == STRIPE_REQ_RMW) {
+		struct raid5f_info *r5f_info = raid5f_ch_to_r5f_info(stripe_req->r5ch);
+		struct raid_bdev *raid_bdev = r5f_info->raid_bdev;
+		uint8_t i;
+
+		if (stripe_req->rmw.chunk_buffers) {
+			for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
+				spdk_dma_free(stripe_req->rmw.chunk_buffers[i]);
+			}
+			free(stripe_req->rmw.chunk_buffers);
+		}
+
+		if (stripe_req->rmw.chunk_md_buffers) {
+			for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
+				spdk_dma_free(stripe_req->rmw.chunk_md_buffers[i]);
+			}
+			free(stripe_req->rmw.chunk_md_buffers);
+		}
+
+		free(stripe_req->rmw.chunks);
 	} else {
 		assert(false);
 	}
@@ -946,6 +1430,43 @@ raid5f_stripe_request_alloc(struct raid5f_io_channel *r5ch, enum stripe_request_
 				stripe_req->reconstruct.chunk_md_buffers[i] = buf;
 			}
 		}
+	} else if (type == STRIPE_REQ_RMW) {
+		uint8_t n = raid_bdev->num_base_bdevs;
+		void *buf;
+		uint8_t i;
+
+		stripe_req->rmw.chunks = calloc(n, sizeof(*stripe_req->rmw.chunks));
+		if (!stripe_req->rmw.chunks) {
+			goto err;
+		}
+
+		stripe_req->rmw.chunk_buffers = calloc(n, sizeof(void *));
+		if (!stripe_req->rmw.chunk_buffers) {
+			goto err;
+		}
+
+		for (i = 0; i < n; i++) {
+			buf = spdk_dma_malloc(chunk_len, r5f_info->buf_alignment, NULL);
+			if (!buf) {
+				goto err;
+			}
+			stripe_req->rmw.chunk_buffers[i] = buf;
+		}
+
+		if (raid_io_md_size != 0) {
+			stripe_req->rmw.chunk_md_buffers = calloc(n, sizeof(void *));
+			if (!stripe_req->rmw.chunk_md_buffers) {
+				goto err;
+			}
+
+			for (i = 0; i < n; i++) {
+				buf = spdk_dma_malloc(raid_bdev->strip_size * raid_io_md_size, r5f_info->buf_alignment, NULL);
+				if (!buf) {
+					goto err;
+				}
+				stripe_req->rmw.chunk_md_buffers[i] = buf;
+			}
+		}
 	} else {
 		assert(false);
 		return NULL;
@@ -981,6 +1502,10 @@ raid5f_ioch_destroy(void *io_device, void *ctx_buf)
 	struct stripe_request *stripe_req;
 
 	assert(TAILQ_EMPTY(&r5ch->xor_retry_queue));
+	assert(TAILQ_EMPTY(&r5ch->rmw_stripes));
+	assert(TAILQ_EMPTY(&r5ch->rmw_flushing));
+
+	spdk_poller_unregister(&r5ch->rmw_poller);
 
 	while ((stripe_req = TAILQ_FIRST(&r5ch->free_stripe_requests.write))) {
 		TAILQ_REMOVE(&r5ch->free_stripe_requests.write, stripe_req, link);
@@ -992,6 +1517,11 @@ raid5f_ioch_destroy(void *io_device, void *ctx_buf)
 		raid5f_stripe_request_free(stripe_req);
 	}
 
+	while ((stripe_req = TAILQ_FIRST(&r5ch->free_stripe_requests.rmw))) {
+		TAILQ_REMOVE(&r5ch->free_stripe_requests.rmw, stripe_req, link);
+		raid5f_stripe_request_free(stripe_req);
+	}
+
 	if (r5ch->accel_ch) {
 		spdk_put_io_channel(r5ch->accel_ch);
 	}
@@ -1012,6 +1542,9 @@ raid5f_ioch_create(void *io_device, void *ctx_buf)
 
 	TAILQ_INIT(&r5ch->free_stripe_requests.write);
 	TAILQ_INIT(&r5ch->free_stripe_requests.reconstruct);
+	TAILQ_INIT(&r5ch->free_stripe_requests.rmw);
+	TAILQ_INIT(&r5ch->rmw_stripes);
+	TAILQ_INIT(&r5ch->rmw_flushing);
 	TAILQ_INIT(&r5ch->xor_retry_queue);
 
 	for (i = 0; i < RAID5F_MAX_STRIPES; i++) {
@@ -1032,6 +1565,20 @@ raid5f_ioch_create(void *io_device, void *ctx_buf)
 		TAILQ_INSERT_HEAD(&r5ch->free_stripe_requests.reconstruct, stripe_req, link);
 	}
 
+	for (i = 0; i < RAID5F_MAX_RMW_STRIPES; i++) {
+		stripe_req = raid5f_stripe_request_alloc(r5ch, STRIPE_REQ_RMW);
+		if (!stripe_req) {
+			goto err;
+		}
+
+		TAILQ_INSERT_HEAD(&r5ch->free_stripe_requests.rmw, stripe_req, link);
+	}
+
+	r5ch->rmw_poller = SPDK_POLLER_REGISTER(raid5f_rmw_poller, r5ch, RAID5F_RMW_FLUSH_PERIOD_US);
+	if (!r5ch->rmw_poller) {
+		goto err;
+	}
+
 	r5ch->accel_ch = spdk_accel_get_io_channel();
 	if (!r5ch->accel_ch) {
 		SPDK_ERRLOG("Failed to get accel framework's IO channel\n");
@@ -1101,8 +1648,14 @@ raid5f_start(struct raid_bdev *raid_bdev)
 	raid_bdev->bdev.blockcnt = r5f_info->stripe_blocks * r5f_info->total_stripes;
 	raid_bdev->bdev.optimal_io_boundary = raid_bdev->strip_size;
 	raid_bdev->bdev.split_on_optimal_io_boundary = true;
+	/*
+	 * A full stripe is still the preferred write granularity, but sub-stripe writes are
+	 * now accepted and accumulated in the stripe cache, so the generic bdev layer must
+	 * not reject them. Writes are split on the strip boundary instead, so that each one
+	 * maps to a single chunk.
+	 */
 	raid_bdev->bdev.write_unit_size = r5f_info->stripe_blocks;
-	raid_bdev->bdev.split_on_write_unit = true;
+	raid_bdev->bdev.split_on_write_unit = false;
 
 	raid_bdev->module_private = r5f_info;
 
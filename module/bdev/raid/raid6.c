@@ -0,0 +1,1731 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#include "bdev_raid.h"
+
+#include "spdk/env.h"
+#include "spdk/thread.h"
+#include "spdk/string.h"
+#include "spdk/util.h"
+#include "spdk/likely.h"
+#include "spdk/log.h"
+#include "spdk/accel.h"
+#include "spdk/xor.h"
+
+/* Maximum concurrent full stripe writes per io channel */
+#define RAID6_MAX_STRIPES 32
+
+/*
+ * GF(2^8) arithmetic for the Q syndrome, using the RAID-6 polynomial
+ * x^8 + x^4 + x^3 + x^2 + 1 (0x11d) and generator g = 2.
+ *
+ * Q = g^0*D_0 + g^1*D_1 + ... + g^(n-1)*D_(n-1)
+ */
+static uint8_t g_gf_log[256];
+static uint8_t g_gf_exp[510];
+static bool g_gf_tables_initialized;
+
+static void
+raid6_gf_tables_init(void)
+{
+	uint8_t v = 1;
+	int i;
+
+	for (i = 0; i < 255; i++) {
+		g_gf_exp[i] = v;
+		g_gf_exp[i + 255] = v;
+		g_gf_log[v] = i;
+		v = (v << 1) ^ ((v & 0x80) ? 0x1d : 0);
+	}
+
+	g_gf_tables_initialized = true;
+}
+
+static inline uint8_t
+raid6_gf_mul(uint8_t a, uint8_t b)
+{
+	if (a == 0 || b == 0) {
+		return 0;
+	}
+
+	return g_gf_exp[g_gf_log[a] + g_gf_log[b]];
+}
+
+static inline uint8_t
+raid6_gf_inv(uint8_t a)
+{
+	assert(a != 0);
+
+	return g_gf_exp[255 - g_gf_log[a]];
+}
+
+/* The Q syndrome coefficient of the data chunk at the given index */
+static inline uint8_t
+raid6_gf_coef(uint8_t data_chunk_idx)
+{
+	return g_gf_exp[data_chunk_idx];
+}
+
+/* Multiply each byte packed in a 64-bit word by the generator */
+static inline uint64_t
+raid6_gf_mul2_u64(uint64_t v)
+{
+	uint64_t mask = (v & 0x8080808080808080ULL) >> 7;
+
+	return ((v << 1) & 0xfefefefefefefefeULL) ^ (mask * 0x1d);
+}
+
+static inline uint8_t
+raid6_gf_mul2_u8(uint8_t v)
+{
+	return (v << 1) ^ ((v & 0x80) ? 0x1d : 0);
+}
+
+/*
+ * Generate the Q syndrome of the source buffers using Horner's scheme:
+ * Q = D_0 + g*(D_1 + g*(D_2 + ...)). The inner loop only needs xor and a
+ * multiplication by the generator, which is done on 8 bytes at a time.
+ */
+static void
+raid6_q_gen(void **srcs, uint8_t n_src, void *dest, size_t len)
+{
+	size_t off = 0;
+	int i;
+
+	assert(n_src >= 2);
+
+	while (off + sizeof(uint64_t) <= len) {
+		uint64_t v, s;
+
+		memcpy(&v, srcs[n_src - 1] + off, sizeof(v));
+		for (i = n_src - 2; i >= 0; i--) {
+			memcpy(&s, srcs[i] + off, sizeof(s));
+			v = raid6_gf_mul2_u64(v) ^ s;
+		}
+		memcpy(dest + off, &v, sizeof(v));
+		off += sizeof(uint64_t);
+	}
+
+	while (off < len) {
+		uint8_t v = *((uint8_t *)srcs[n_src - 1] + off);
+
+		for (i = n_src - 2; i >= 0; i--) {
+			v = raid6_gf_mul2_u8(v) ^ *((uint8_t *)srcs[i] + off);
+		}
+		*((uint8_t *)dest + off) = v;
+		off++;
+	}
+}
+
+/*
+ * Multiply src by a constant coefficient and xor it into dest, using nibble
+ * lookup tables in the style of isa-l's gf_vect_mul.
+ */
+static void
+raid6_gf_mul_xor_buf(void *dest, const void *src, uint8_t coef, size_t len)
+{
+	uint8_t tbl_lo[16], tbl_hi[16];
+	size_t i;
+
+	for (i = 0; i < 16; i++) {
+		tbl_lo[i] = raid6_gf_mul(coef, i);
+		tbl_hi[i] = raid6_gf_mul(coef, i << 4);
+	}
+
+	for (i = 0; i < len; i++) {
+		uint8_t s = ((const uint8_t *)src)[i];
+
+		((uint8_t *)dest)[i] ^= tbl_lo[s & 0xf] ^ tbl_hi[s >> 4];
+	}
+}
+
+/* Multiply buf by a constant coefficient in place */
+static void
+raid6_gf_scale_buf(void *buf, uint8_t coef, size_t len)
+{
+	uint8_t tbl_lo[16], tbl_hi[16];
+	size_t i;
+
+	for (i = 0; i < 16; i++) {
+		tbl_lo[i] = raid6_gf_mul(coef, i);
+		tbl_hi[i] = raid6_gf_mul(coef, i << 4);
+	}
+
+	for (i = 0; i < len; i++) {
+		uint8_t s = ((uint8_t *)buf)[i];
+
+		((uint8_t *)buf)[i] = tbl_lo[s & 0xf] ^ tbl_hi[s >> 4];
+	}
+}
+
+struct chunk {
+	/* Corresponds to base_bdev index */
+	uint8_t index;
+
+	/* Array of iovecs */
+	struct iovec *iovs;
+
+	/* Number of used iovecs */
+	int iovcnt;
+
+	/* Total number of available iovecs in the array */
+	int iovcnt_max;
+
+	/* Pointer to buffer with I/O metadata */
+	void *md_buf;
+};
+
+struct stripe_request;
+typedef void (*stripe_req_xor_cb)(struct stripe_request *stripe_req, int status);
+
+struct stripe_request {
+	enum stripe_request_type {
+		STRIPE_REQ_WRITE,
+		STRIPE_REQ_RECONSTRUCT,
+	} type;
+
+	struct raid6_io_channel *r6ch;
+
+	/* The associated raid_bdev_io */
+	struct raid_bdev_io *raid_io;
+
+	/* The stripe's index in the raid array. */
+	uint64_t stripe_index;
+
+	/* The stripe's P parity chunk */
+	struct chunk *p_chunk;
+
+	/* The stripe's Q syndrome chunk */
+	struct chunk *q_chunk;
+
+	union {
+		struct {
+			/* Buffer for stripe P parity */
+			void *parity_buf;
+
+			/* Buffer for stripe io metadata P parity */
+			void *parity_md_buf;
+
+			/* Buffer for stripe Q syndrome */
+			void *q_buf;
+
+			/* Buffer for stripe io metadata Q syndrome */
+			void *q_md_buf;
+		} write;
+
+		struct {
+			/* Array of buffers for reading chunk data, indexed by chunk */
+			void **chunk_buffers;
+
+			/* Array of buffers for reading chunk metadata, indexed by chunk */
+			void **chunk_md_buffers;
+
+			/* Flags of the chunks that need to be read, indexed by chunk */
+			bool *chunk_read;
+
+			/* Chunk to reconstruct */
+			struct chunk *chunk;
+
+			/* Offset from chunk start */
+			uint64_t chunk_offset;
+
+			/* How the missing data chunks are recovered */
+			enum raid6_reconstruct_mode {
+				/* From P and the other data chunks */
+				RAID6_RECONSTRUCT_P,
+				/* P is unavailable - from Q and the other data chunks */
+				RAID6_RECONSTRUCT_Q,
+				/* Two data chunks are missing - from P and Q */
+				RAID6_RECONSTRUCT_PQ,
+			} mode;
+
+			/* Indices of the missing data chunks, the first being the chunk to
+			 * reconstruct if it is a data chunk */
+			uint8_t missing_chunk_idx[2];
+			uint8_t num_missing_data;
+		} reconstruct;
+	};
+
+	/* Array of iovec iterators for each chunk */
+	struct spdk_ioviter *chunk_iov_iters;
+
+	/* Array of source buffer pointers for parity calculation */
+	void **chunk_xor_buffers;
+
+	/* Array of source buffer pointers for parity calculation of io metadata */
+	void **chunk_xor_md_buffers;
+
+	struct {
+		size_t len;
+		size_t remaining;
+		size_t remaining_md;
+		int status;
+		stripe_req_xor_cb cb;
+	} xor;
+
+	TAILQ_ENTRY(stripe_request) link;
+
+	/* Array of chunks corresponding to base_bdevs */
+	struct chunk chunks[0];
+};
+
+struct raid6_info {
+	/* The parent raid bdev */
+	struct raid_bdev *raid_bdev;
+
+	/* Number of data blocks in a stripe (without parity) */
+	uint64_t stripe_blocks;
+
+	/* Number of stripes on this array */
+	uint64_t total_stripes;
+
+	/* Alignment for buffer allocation */
+	size_t buf_alignment;
+
+	/* block length bit shift for optimized calculation, only valid when no interleaved md */
+	uint32_t blocklen_shift;
+};
+
+struct raid6_io_channel {
+	/* All available stripe requests on this channel */
+	struct {
+		TAILQ_HEAD(, stripe_request) write;
+		TAILQ_HEAD(, stripe_request) reconstruct;
+	} free_stripe_requests;
+
+	/* accel_fw channel */
+	struct spdk_io_channel *accel_ch;
+
+	/* For retrying xor if accel_ch runs out of resources */
+	TAILQ_HEAD(, stripe_request) xor_retry_queue;
+
+	/* For iterating over chunk iovecs during parity calculation */
+	void **chunk_xor_buffers;
+	struct iovec **chunk_xor_iovs;
+	size_t *chunk_xor_iovcnt;
+};
+
+#define __CHUNK_IN_RANGE(req, c) \
+	c < req->chunks + raid6_ch_to_r6_info(req->r6ch)->raid_bdev->num_base_bdevs
+
+#define FOR_EACH_CHUNK_FROM(req, c, from) \
+	for (c = from; __CHUNK_IN_RANGE(req, c); c++)
+
+#define FOR_EACH_CHUNK(req, c) \
+	FOR_EACH_CHUNK_FROM(req, c, req->chunks)
+
+static inline struct chunk *
+raid6_next_data_chunk(struct stripe_request *stripe_req, struct chunk *chunk)
+{
+	while (chunk == stripe_req->p_chunk || chunk == stripe_req->q_chunk) {
+		chunk++;
+	}
+
+	return chunk;
+}
+
+#define FOR_EACH_DATA_CHUNK(req, c) \
+	for (c = raid6_next_data_chunk(req, req->chunks); __CHUNK_IN_RANGE(req, c); \
+	     c = raid6_next_data_chunk(req, c + 1))
+
+static inline struct raid6_info *
+raid6_ch_to_r6_info(struct raid6_io_channel *r6ch)
+{
+	return spdk_io_channel_get_io_device(spdk_io_channel_from_ctx(r6ch));
+}
+
+static inline struct stripe_request *
+raid6_chunk_stripe_req(struct chunk *chunk)
+{
+	return SPDK_CONTAINEROF((chunk - chunk->index), struct stripe_request, chunks);
+}
+
+static inline uint8_t
+raid6_stripe_data_chunks_num(const struct raid_bdev *raid_bdev)
+{
+	return raid_bdev->min_base_bdevs_operational;
+}
+
+static inline uint8_t
+raid6_stripe_q_chunk_index(const struct raid_bdev *raid_bdev, uint64_t stripe_index)
+{
+	return raid_bdev->num_base_bdevs - 1 - stripe_index % raid_bdev->num_base_bdevs;
+}
+
+static inline uint8_t
+raid6_stripe_p_chunk_index(const struct raid_bdev *raid_bdev, uint64_t stripe_index)
+{
+	uint8_t q_idx = raid6_stripe_q_chunk_index(raid_bdev, stripe_index);
+
+	return q_idx == 0 ? raid_bdev->num_base_bdevs - 1 : q_idx - 1;
+}
+
+/* Map a data chunk index to the corresponding base bdev index */
+static inline uint8_t
+raid6_data_chunk_to_chunk_index(uint8_t p_idx, uint8_t q_idx, uint8_t data_chunk_idx)
+{
+	uint8_t idx = data_chunk_idx;
+
+	if (idx >= spdk_min(p_idx, q_idx)) {
+		idx++;
+	}
+	if (idx >= spdk_max(p_idx, q_idx)) {
+		idx++;
+	}
+
+	return idx;
+}
+
+/* Map a chunk to its data index within the stripe */
+static inline uint8_t
+raid6_chunk_data_index(struct stripe_request *stripe_req, const struct chunk *chunk)
+{
+	uint8_t idx = chunk->index;
+
+	assert(chunk != stripe_req->p_chunk && chunk != stripe_req->q_chunk);
+
+	if (chunk->index > stripe_req->p_chunk->index) {
+		idx--;
+	}
+	if (chunk->index > stripe_req->q_chunk->index) {
+		idx--;
+	}
+
+	return idx;
+}
+
+static inline void
+raid6_stripe_request_release(struct stripe_request *stripe_req)
+{
+	if (spdk_likely(stripe_req->type == STRIPE_REQ_WRITE)) {
+		TAILQ_INSERT_HEAD(&stripe_req->r6ch->free_stripe_requests.write, stripe_req, link);
+	} else if (stripe_req->type == STRIPE_REQ_RECONSTRUCT) {
+		TAILQ_INSERT_HEAD(&stripe_req->r6ch->free_stripe_requests.reconstruct, stripe_req, link);
+	} else {
+		assert(false);
+	}
+}
+
+static void raid6_xor_stripe_retry(struct stripe_request *stripe_req);
+
+static void
+raid6_xor_stripe_done(struct stripe_request *stripe_req)
+{
+	struct raid6_io_channel *r6ch = stripe_req->r6ch;
+
+	if (stripe_req->xor.status != 0) {
+		SPDK_ERRLOG("stripe xor failed: %s\n", spdk_strerror(-stripe_req->xor.status));
+	}
+
+	stripe_req->xor.cb(stripe_req, stripe_req->xor.status);
+
+	if (!TAILQ_EMPTY(&r6ch->xor_retry_queue)) {
+		stripe_req = TAILQ_FIRST(&r6ch->xor_retry_queue);
+		TAILQ_REMOVE(&r6ch->xor_retry_queue, stripe_req, link);
+		raid6_xor_stripe_retry(stripe_req);
+	}
+}
+
+static void raid6_xor_stripe_continue(struct stripe_request *stripe_req);
+
+static void
+_raid6_xor_stripe_cb(struct stripe_request *stripe_req, int status)
+{
+	if (status != 0) {
+		stripe_req->xor.status = status;
+	}
+
+	if (stripe_req->xor.remaining + stripe_req->xor.remaining_md == 0) {
+		raid6_xor_stripe_done(stripe_req);
+	}
+}
+
+static void
+raid6_xor_stripe_cb(void *_stripe_req, int status)
+{
+	struct stripe_request *stripe_req = _stripe_req;
+
+	stripe_req->xor.remaining -= stripe_req->xor.len;
+
+	if (stripe_req->xor.remaining > 0) {
+		stripe_req->xor.len = spdk_ioviter_nextv(stripe_req->chunk_iov_iters,
+				      stripe_req->r6ch->chunk_xor_buffers);
+		raid6_xor_stripe_continue(stripe_req);
+	}
+
+	_raid6_xor_stripe_cb(stripe_req, status);
+}
+
+static void
+raid6_xor_stripe_md_cb(void *_stripe_req, int status)
+{
+	struct stripe_request *stripe_req = _stripe_req;
+
+	stripe_req->xor.remaining_md = 0;
+
+	_raid6_xor_stripe_cb(stripe_req, status);
+}
+
+static void
+raid6_xor_stripe_continue(struct stripe_request *stripe_req)
+{
+	struct raid6_io_channel *r6ch = stripe_req->r6ch;
+	struct raid_bdev_io *raid_io = stripe_req->raid_io;
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	uint8_t n_src = raid6_stripe_data_chunks_num(raid_bdev);
+	uint8_t i;
+	int ret;
+
+	assert(stripe_req->xor.len > 0);
+
+	for (i = 0; i < n_src; i++) {
+		stripe_req->chunk_xor_buffers[i] = r6ch->chunk_xor_buffers[i];
+	}
+
+	ret = spdk_accel_submit_xor(r6ch->accel_ch, r6ch->chunk_xor_buffers[n_src],
+				    stripe_req->chunk_xor_buffers, n_src, stripe_req->xor.len,
+				    raid6_xor_stripe_cb, stripe_req);
+	if (spdk_unlikely(ret)) {
+		if (ret == -ENOMEM) {
+			TAILQ_INSERT_HEAD(&r6ch->xor_retry_queue, stripe_req, link);
+		} else {
+			stripe_req->xor.status = ret;
+			raid6_xor_stripe_done(stripe_req);
+		}
+	}
+}
+
+/* Compute the P parity of the stripe's data chunks via the accel framework */
+static void
+raid6_xor_stripe(struct stripe_request *stripe_req, stripe_req_xor_cb cb)
+{
+	struct raid6_io_channel *r6ch = stripe_req->r6ch;
+	struct raid_bdev_io *raid_io = stripe_req->raid_io;
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	uint8_t n_src = raid6_stripe_data_chunks_num(raid_bdev);
+	struct chunk *dest_chunk = stripe_req->p_chunk;
+	struct chunk *chunk;
+	uint8_t c;
+
+	assert(cb != NULL);
+	assert(stripe_req->type == STRIPE_REQ_WRITE);
+
+	c = 0;
+	FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+		r6ch->chunk_xor_iovs[c] = chunk->iovs;
+		r6ch->chunk_xor_iovcnt[c] = chunk->iovcnt;
+		c++;
+	}
+	r6ch->chunk_xor_iovs[c] = dest_chunk->iovs;
+	r6ch->chunk_xor_iovcnt[c] = dest_chunk->iovcnt;
+
+	stripe_req->xor.len = spdk_ioviter_firstv(stripe_req->chunk_iov_iters, n_src + 1,
+			      r6ch->chunk_xor_iovs,
+			      r6ch->chunk_xor_iovcnt,
+			      r6ch->chunk_xor_buffers);
+	stripe_req->xor.remaining = raid_bdev->strip_size * raid_bdev->bdev.blocklen;
+	stripe_req->xor.status = 0;
+	stripe_req->xor.cb = cb;
+
+	if (raid_io->md_buf != NULL) {
+		uint64_t len = raid_bdev->strip_size * raid_bdev->bdev.md_len;
+		int ret;
+
+		stripe_req->xor.remaining_md = len;
+
+		c = 0;
+		FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+			stripe_req->chunk_xor_md_buffers[c] = chunk->md_buf;
+			c++;
+		}
+
+		ret = spdk_accel_submit_xor(r6ch->accel_ch, dest_chunk->md_buf,
+					    stripe_req->chunk_xor_md_buffers, n_src, len,
+					    raid6_xor_stripe_md_cb, stripe_req);
+		if (spdk_unlikely(ret)) {
+			if (ret == -ENOMEM) {
+				TAILQ_INSERT_HEAD(&r6ch->xor_retry_queue, stripe_req, link);
+			} else {
+				stripe_req->xor.status = ret;
+				raid6_xor_stripe_done(stripe_req);
+			}
+			return;
+		}
+	}
+
+	raid6_xor_stripe_continue(stripe_req);
+}
+
+static void
+raid6_xor_stripe_retry(struct stripe_request *stripe_req)
+{
+	if (stripe_req->xor.remaining_md) {
+		raid6_xor_stripe(stripe_req, stripe_req->xor.cb);
+	} else {
+		raid6_xor_stripe_continue(stripe_req);
+	}
+}
+
+/* Compute the Q syndrome of the stripe's data chunks into the Q chunk buffer */
+static void
+raid6_gen_stripe_q(struct stripe_request *stripe_req)
+{
+	struct raid6_io_channel *r6ch = stripe_req->r6ch;
+	struct raid_bdev_io *raid_io = stripe_req->raid_io;
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	uint8_t n_src = raid6_stripe_data_chunks_num(raid_bdev);
+	struct chunk *chunk;
+	size_t len;
+	uint8_t c;
+
+	c = 0;
+	FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+		r6ch->chunk_xor_iovs[c] = chunk->iovs;
+		r6ch->chunk_xor_iovcnt[c] = chunk->iovcnt;
+		c++;
+	}
+	r6ch->chunk_xor_iovs[c] = stripe_req->q_chunk->iovs;
+	r6ch->chunk_xor_iovcnt[c] = stripe_req->q_chunk->iovcnt;
+
+	len = spdk_ioviter_firstv(stripe_req->chunk_iov_iters, n_src + 1,
+				  r6ch->chunk_xor_iovs,
+				  r6ch->chunk_xor_iovcnt,
+				  r6ch->chunk_xor_buffers);
+	while (len > 0) {
+		raid6_q_gen(r6ch->chunk_xor_buffers, n_src, r6ch->chunk_xor_buffers[n_src], len);
+		len = spdk_ioviter_nextv(stripe_req->chunk_iov_iters, r6ch->chunk_xor_buffers);
+	}
+
+	if (raid_io->md_buf != NULL) {
+		c = 0;
+		FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+			stripe_req->chunk_xor_md_buffers[c] = chunk->md_buf;
+			c++;
+		}
+
+		raid6_q_gen(stripe_req->chunk_xor_md_buffers, n_src, stripe_req->q_chunk->md_buf,
+			    raid_bdev->strip_size * raid_bdev->bdev.md_len);
+	}
+}
+
+static void
+raid6_stripe_request_chunk_write_complete(struct stripe_request *stripe_req,
+		enum spdk_bdev_io_status status)
+{
+	if (raid_bdev_io_complete_part(stripe_req->raid_io, 1, status)) {
+		raid6_stripe_request_release(stripe_req);
+	}
+}
+
+static void
+raid6_chunk_complete_bdev_io(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct chunk *chunk = cb_arg;
+	struct stripe_request *stripe_req = raid6_chunk_stripe_req(chunk);
+	enum spdk_bdev_io_status status = success ? SPDK_BDEV_IO_STATUS_SUCCESS :
+					  SPDK_BDEV_IO_STATUS_FAILED;
+
+	spdk_bdev_free_io(bdev_io);
+
+	if (spdk_likely(stripe_req->type == STRIPE_REQ_WRITE)) {
+		raid6_stripe_request_chunk_write_complete(stripe_req, status);
+	} else if (stripe_req->type == STRIPE_REQ_RECONSTRUCT) {
+		raid_bdev_io_complete_part(stripe_req->raid_io, 1, status);
+	} else {
+		assert(false);
+	}
+}
+
+static void raid6_stripe_request_submit_chunks(struct stripe_request *stripe_req);
+
+static void
+raid6_chunk_submit_retry(void *_raid_io)
+{
+	struct raid_bdev_io *raid_io = _raid_io;
+	struct stripe_request *stripe_req = raid_io->module_private;
+
+	raid6_stripe_request_submit_chunks(stripe_req);
+}
+
+static inline void
+raid6_init_ext_io_opts(struct spdk_bdev_ext_io_opts *opts, struct raid_bdev_io *raid_io)
+{
+	memset(opts, 0, sizeof(*opts));
+	opts->size = sizeof(*opts);
+	opts->memory_domain = raid_io->memory_domain;
+	opts->memory_domain_ctx = raid_io->memory_domain_ctx;
+	opts->metadata = raid_io->md_buf;
+}
+
+static int
+raid6_chunk_submit(struct chunk *chunk)
+{
+	struct stripe_request *stripe_req = raid6_chunk_stripe_req(chunk);
+	struct raid_bdev_io *raid_io = stripe_req->raid_io;
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	struct raid_base_bdev_info *base_info = &raid_bdev->base_bdev_info[chunk->index];
+	struct spdk_io_channel *base_ch = raid_bdev_channel_get_base_channel(raid_io->raid_ch,
+					  chunk->index);
+	uint64_t base_offset_blocks = (stripe_req->stripe_index << raid_bdev->strip_size_shift);
+	struct spdk_bdev_ext_io_opts io_opts;
+	int ret;
+
+	raid6_init_ext_io_opts(&io_opts, raid_io);
+	io_opts.metadata = chunk->md_buf;
+
+	raid_io->base_bdev_io_submitted++;
+
+	switch (stripe_req->type) {
+	case STRIPE_REQ_WRITE:
+		if (base_ch == NULL) {
+			raid_bdev_io_complete_part(raid_io, 1, SPDK_BDEV_IO_STATUS_SUCCESS);
+			return 0;
+		}
+
+		ret = raid_bdev_writev_blocks_ext(base_info, base_ch, chunk->iovs, chunk->iovcnt,
+						  base_offset_blocks, raid_bdev->strip_size,
+						  raid6_chunk_complete_bdev_io, chunk, &io_opts);
+		break;
+	case STRIPE_REQ_RECONSTRUCT:
+		if (!stripe_req->reconstruct.chunk_read[chunk->index]) {
+			raid_bdev_io_complete_part(raid_io, 1, SPDK_BDEV_IO_STATUS_SUCCESS);
+			return 0;
+		}
+
+		if (base_ch == NULL) {
+			raid_bdev_io_complete_part(raid_io, 1, SPDK_BDEV_IO_STATUS_FAILED);
+			return 0;
+		}
+
+		base_offset_blocks += stripe_req->reconstruct.chunk_offset;
+
+		ret = raid_bdev_readv_blocks_ext(base_info, base_ch, chunk->iovs, chunk->iovcnt,
+						 base_offset_blocks, raid_io->num_blocks,
+						 raid6_chunk_complete_bdev_io, chunk, &io_opts);
+		break;
+	default:
+		assert(false);
+		ret = -EINVAL;
+		break;
+	}
+
+	if (spdk_unlikely(ret)) {
+		raid_io->base_bdev_io_submitted--;
+		if (ret == -ENOMEM) {
+			raid_bdev_queue_io_wait(raid_io, spdk_bdev_desc_get_bdev(base_info->desc),
+						base_ch, raid6_chunk_submit_retry);
+		} else {
+			/*
+			 * Implicitly complete any I/Os not yet submitted as FAILED. If completing
+			 * these means there are no more to complete for the stripe request, we can
+			 * release the stripe request as well.
+			 */
+			uint64_t base_bdev_io_not_submitted = raid_bdev->num_base_bdevs -
+							      raid_io->base_bdev_io_submitted;
+
+			if (raid_bdev_io_complete_part(raid_io, base_bdev_io_not_submitted,
+						       SPDK_BDEV_IO_STATUS_FAILED)) {
+				raid6_stripe_request_release(stripe_req);
+			}
+		}
+	}
+
+	return ret;
+}
+
+static int
+raid6_chunk_set_iovcnt(struct chunk *chunk, int iovcnt)
+{
+	if (iovcnt > chunk->iovcnt_max) {
+		struct iovec *iovs = chunk->iovs;
+
+		iovs = realloc(iovs, iovcnt * sizeof(*iovs));
+		if (!iovs) {
+			return -ENOMEM;
+		}
+		chunk->iovs = iovs;
+		chunk->iovcnt_max = iovcnt;
+	}
+	chunk->iovcnt = iovcnt;
+
+	return 0;
+}
+
+static int
+raid6_stripe_request_map_iovecs(struct stripe_request *stripe_req)
+{
+	struct raid_bdev_io *raid_io = stripe_req->raid_io;
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	struct raid6_info *r6_info = raid_bdev->module_private;
+	struct chunk *chunk;
+	int raid_io_iov_idx = 0;
+	size_t raid_io_offset = 0;
+	size_t raid_io_iov_offset = 0;
+	int i;
+
+	FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+		int chunk_iovcnt = 0;
+		uint64_t len = raid_bdev->strip_size * raid_bdev->bdev.blocklen;
+		size_t off = raid_io_iov_offset;
+		int ret;
+
+		for (i = raid_io_iov_idx; i < raid_io->iovcnt; i++) {
+			chunk_iovcnt++;
+			off += raid_io->iovs[i].iov_len;
+			if (off >= raid_io_offset + len) {
+				break;
+			}
+		}
+
+		assert(raid_io_iov_idx + chunk_iovcnt <= raid_io->iovcnt);
+
+		ret = raid6_chunk_set_iovcnt(chunk, chunk_iovcnt);
+		if (ret) {
+			return ret;
+		}
+
+		if (raid_io->md_buf != NULL) {
+			chunk->md_buf = raid_io->md_buf +
+					(raid_io_offset >> r6_info->blocklen_shift) * raid_bdev->bdev.md_len;
+		}
+
+		for (i = 0; i < chunk_iovcnt; i++) {
+			struct iovec *chunk_iov = &chunk->iovs[i];
+			const struct iovec *raid_io_iov = &raid_io->iovs[raid_io_iov_idx];
+			size_t chunk_iov_offset = raid_io_offset - raid_io_iov_offset;
+
+			chunk_iov->iov_base = raid_io_iov->iov_base + chunk_iov_offset;
+			chunk_iov->iov_len = spdk_min(len, raid_io_iov->iov_len - chunk_iov_offset);
+			raid_io_offset += chunk_iov->iov_len;
+			len -= chunk_iov->iov_len;
+
+			if (raid_io_offset >= raid_io_iov_offset + raid_io_iov->iov_len) {
+				raid_io_iov_idx++;
+				raid_io_iov_offset += raid_io_iov->iov_len;
+			}
+		}
+
+		if (spdk_unlikely(len > 0)) {
+			return -EINVAL;
+		}
+	}
+
+	stripe_req->p_chunk->iovs[0].iov_base = stripe_req->write.parity_buf;
+	stripe_req->p_chunk->iovs[0].iov_len = raid_bdev->strip_size * raid_bdev->bdev.blocklen;
+	stripe_req->p_chunk->iovcnt = 1;
+	stripe_req->p_chunk->md_buf = stripe_req->write.parity_md_buf;
+
+	stripe_req->q_chunk->iovs[0].iov_base = stripe_req->write.q_buf;
+	stripe_req->q_chunk->iovs[0].iov_len = raid_bdev->strip_size * raid_bdev->bdev.blocklen;
+	stripe_req->q_chunk->iovcnt = 1;
+	stripe_req->q_chunk->md_buf = stripe_req->write.q_md_buf;
+
+	return 0;
+}
+
+static void
+raid6_stripe_request_submit_chunks(struct stripe_request *stripe_req)
+{
+	struct raid_bdev_io *raid_io = stripe_req->raid_io;
+	struct chunk *start = &stripe_req->chunks[raid_io->base_bdev_io_submitted];
+	struct chunk *chunk;
+
+	FOR_EACH_CHUNK_FROM(stripe_req, chunk, start) {
+		if (spdk_unlikely(raid6_chunk_submit(chunk) != 0)) {
+			break;
+		}
+	}
+}
+
+static inline void
+raid6_stripe_request_init(struct stripe_request *stripe_req, struct raid_bdev_io *raid_io,
+			  uint64_t stripe_index)
+{
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+
+	stripe_req->raid_io = raid_io;
+	stripe_req->stripe_index = stripe_index;
+	stripe_req->p_chunk = &stripe_req->chunks[raid6_stripe_p_chunk_index(raid_bdev, stripe_index)];
+	stripe_req->q_chunk = &stripe_req->chunks[raid6_stripe_q_chunk_index(raid_bdev, stripe_index)];
+}
+
+static void
+raid6_stripe_write_request_xor_done(struct stripe_request *stripe_req, int status)
+{
+	struct raid_bdev_io *raid_io = stripe_req->raid_io;
+
+	if (status != 0) {
+		raid6_stripe_request_release(stripe_req);
+		raid_bdev_io_complete(raid_io, SPDK_BDEV_IO_STATUS_FAILED);
+	} else {
+		raid6_stripe_request_submit_chunks(stripe_req);
+	}
+}
+
+static int
+raid6_submit_write_request(struct raid_bdev_io *raid_io, uint64_t stripe_index)
+{
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	struct raid6_io_channel *r6ch = raid_bdev_channel_get_module_ctx(raid_io->raid_ch);
+	struct stripe_request *stripe_req;
+	int ret;
+
+	stripe_req = TAILQ_FIRST(&r6ch->free_stripe_requests.write);
+	if (!stripe_req) {
+		return -ENOMEM;
+	}
+
+	raid6_stripe_request_init(stripe_req, raid_io, stripe_index);
+
+	ret = raid6_stripe_request_map_iovecs(stripe_req);
+	if (spdk_unlikely(ret)) {
+		return ret;
+	}
+
+	TAILQ_REMOVE(&r6ch->free_stripe_requests.write, stripe_req, link);
+
+	raid_io->module_private = stripe_req;
+	raid_io->base_bdev_io_remaining = raid_bdev->num_base_bdevs;
+
+	if (raid_bdev_channel_get_base_channel(raid_io->raid_ch, stripe_req->q_chunk->index) != NULL) {
+		raid6_gen_stripe_q(stripe_req);
+	}
+
+	if (raid_bdev_channel_get_base_channel(raid_io->raid_ch, stripe_req->p_chunk->index) != NULL) {
+		raid6_xor_stripe(stripe_req, raid6_stripe_write_request_xor_done);
+	} else {
+		raid6_stripe_write_request_xor_done(stripe_req, 0);
+	}
+
+	return 0;
+}
+
+static void
+raid6_chunk_read_complete(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct raid_bdev_io *raid_io = cb_arg;
+
+	spdk_bdev_free_io(bdev_io);
+
+	raid_bdev_io_complete(raid_io, success ? SPDK_BDEV_IO_STATUS_SUCCESS :
+			      SPDK_BDEV_IO_STATUS_FAILED);
+}
+
+static void raid6_submit_rw_request(struct raid_bdev_io *raid_io);
+
+static void
+_raid6_submit_rw_request(void *_raid_io)
+{
+	struct raid_bdev_io *raid_io = _raid_io;
+
+	raid6_submit_rw_request(raid_io);
+}
+
+/* Like spdk_xor_gen() but also accepts a single source buffer */
+static void
+raid6_xor_bufs(void *dest, void **srcs, uint8_t n_src, size_t len)
+{
+	if (n_src == 1) {
+		memcpy(dest, srcs[0], len);
+	} else {
+		int rc = spdk_xor_gen(dest, srcs, n_src, len);
+
+		assert(rc == 0);
+		(void)rc;
+	}
+}
+
+/*
+ * First recover the missing data chunks into their buffers, then derive the
+ * target chunk from the data chunks if it is the P or Q chunk. The tmp array
+ * is used for gathering source buffer pointers.
+ */
+static void
+raid6_reconstruct_bufs(struct stripe_request *stripe_req, void **bufs, void **tmp, size_t len)
+{
+	struct chunk *target = stripe_req->reconstruct.chunk;
+	uint8_t m0 = stripe_req->reconstruct.missing_chunk_idx[0];
+	struct chunk *chunk;
+	uint8_t n_src;
+
+	switch (stripe_req->reconstruct.mode) {
+	case RAID6_RECONSTRUCT_P:
+		if (stripe_req->reconstruct.num_missing_data > 0) {
+			n_src = 0;
+			FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+				if (chunk->index != m0) {
+					tmp[n_src++] = bufs[chunk->index];
+				}
+			}
+			tmp[n_src++] = bufs[stripe_req->p_chunk->index];
+
+			raid6_xor_bufs(bufs[m0], tmp, n_src, len);
+		}
+		break;
+	case RAID6_RECONSTRUCT_Q: {
+		/* D_x = g^-x * (Q + sum of g^i * D_i over the other data chunks) */
+		uint8_t x = raid6_chunk_data_index(stripe_req, &stripe_req->chunks[m0]);
+
+		memcpy(bufs[m0], bufs[stripe_req->q_chunk->index], len);
+		FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+			if (chunk->index != m0) {
+				raid6_gf_mul_xor_buf(bufs[m0], bufs[chunk->index],
+						     raid6_gf_coef(raid6_chunk_data_index(stripe_req, chunk)),
+						     len);
+			}
+		}
+		raid6_gf_scale_buf(bufs[m0], raid6_gf_inv(raid6_gf_coef(x)), len);
+		break;
+	}
+	case RAID6_RECONSTRUCT_PQ: {
+		/*
+		 * With data chunks x and y missing:
+		 *   A = P + sum of D_i = D_x + D_y
+		 *   B = Q + sum of g^i * D_i = g^x * D_x + g^y * D_y
+		 *   D_x = (g^x + g^y)^-1 * (g^y * A + B)
+		 * A is built in x's buffer, B in y's buffer.
+		 */
+		uint8_t m1 = stripe_req->reconstruct.missing_chunk_idx[1];
+		uint8_t x = raid6_chunk_data_index(stripe_req, &stripe_req->chunks[m0]);
+		uint8_t y = raid6_chunk_data_index(stripe_req, &stripe_req->chunks[m1]);
+		uint8_t inv_xy = raid6_gf_inv(raid6_gf_coef(x) ^ raid6_gf_coef(y));
+
+		n_src = 0;
+		FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+			if (chunk->index != m0 && chunk->index != m1) {
+				tmp[n_src++] = bufs[chunk->index];
+			}
+		}
+		tmp[n_src++] = bufs[stripe_req->p_chunk->index];
+
+		raid6_xor_bufs(bufs[m0], tmp, n_src, len);
+
+		memcpy(bufs[m1], bufs[stripe_req->q_chunk->index], len);
+		FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+			if (chunk->index != m0 && chunk->index != m1) {
+				raid6_gf_mul_xor_buf(bufs[m1], bufs[chunk->index],
+						     raid6_gf_coef(raid6_chunk_data_index(stripe_req, chunk)),
+						     len);
+			}
+		}
+
+		raid6_gf_scale_buf(bufs[m0], raid6_gf_mul(raid6_gf_coef(y), inv_xy), len);
+		raid6_gf_mul_xor_buf(bufs[m0], bufs[m1], inv_xy, len);
+		break;
+	}
+	default:
+		assert(false);
+		break;
+	}
+
+	if (target == stripe_req->p_chunk) {
+		n_src = 0;
+		FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+			tmp[n_src++] = bufs[chunk->index];
+		}
+		raid6_xor_bufs(bufs[target->index], tmp, n_src, len);
+	} else if (target == stripe_req->q_chunk) {
+		n_src = 0;
+		FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+			tmp[n_src++] = bufs[chunk->index];
+		}
+		raid6_q_gen(tmp, n_src, bufs[target->index], len);
+	}
+}
+
+/*
+ * Reconstruct the missing chunk from the chunks read into the stripe request's
+ * buffers, then copy the result to the request's iovecs.
+ */
+static void
+raid6_reconstruct_chunk(struct stripe_request *stripe_req)
+{
+	struct raid_bdev_io *raid_io = stripe_req->raid_io;
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	struct chunk *target = stripe_req->reconstruct.chunk;
+	void **bufs = stripe_req->reconstruct.chunk_buffers;
+	void **md_bufs = stripe_req->reconstruct.chunk_md_buffers;
+	size_t len = raid_io->num_blocks * raid_bdev->bdev.blocklen;
+	size_t md_len = raid_io->md_buf != NULL ? raid_io->num_blocks * raid_bdev->bdev.md_len : 0;
+	struct iovec src;
+
+	raid6_reconstruct_bufs(stripe_req, bufs, stripe_req->chunk_xor_buffers, len);
+
+	if (md_len != 0) {
+		raid6_reconstruct_bufs(stripe_req, md_bufs, stripe_req->chunk_xor_md_buffers, md_len);
+	}
+
+	src.iov_base = bufs[target->index];
+	src.iov_len = len;
+	spdk_iovcpy(&src, 1, target->iovs, target->iovcnt);
+
+	if (md_len != 0) {
+		memcpy(target->md_buf, md_bufs[target->index], md_len);
+	}
+}
+
+static void
+raid6_reconstruct_reads_completed_cb(struct raid_bdev_io *raid_io, enum spdk_bdev_io_status status)
+{
+	struct stripe_request *stripe_req = raid_io->module_private;
+
+	raid_io->completion_cb = NULL;
+
+	if (status != SPDK_BDEV_IO_STATUS_SUCCESS) {
+		stripe_req->xor.cb(stripe_req, -EIO);
+		return;
+	}
+
+	raid6_reconstruct_chunk(stripe_req);
+
+	stripe_req->xor.cb(stripe_req, 0);
+}
+
+static int
+raid6_submit_reconstruct_read(struct raid_bdev_io *raid_io, uint64_t stripe_index,
+			      uint8_t chunk_idx, uint64_t chunk_offset, stripe_req_xor_cb cb)
+{
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	struct raid6_io_channel *r6ch = raid_bdev_channel_get_module_ctx(raid_io->raid_ch);
+	void *raid_io_md = raid_io->md_buf;
+	struct stripe_request *stripe_req;
+	uint8_t missing[2] = {};
+	uint8_t num_missing_data = 0;
+	bool p_unavail, q_unavail;
+	struct chunk *chunk;
+	int ret;
+
+	assert(cb != NULL);
+
+	stripe_req = TAILQ_FIRST(&r6ch->free_stripe_requests.reconstruct);
+	if (!stripe_req) {
+		return -ENOMEM;
+	}
+
+	raid6_stripe_request_init(stripe_req, raid_io, stripe_index);
+
+	stripe_req->reconstruct.chunk = &stripe_req->chunks[chunk_idx];
+	stripe_req->reconstruct.chunk_offset = chunk_offset;
+	stripe_req->xor.cb = cb;
+
+	/*
+	 * Determine how the chunk can be reconstructed based on which of the other
+	 * chunks are unavailable. The chunk being reconstructed is treated as
+	 * missing, too - its base bdev may be online, e.g. during rebuild.
+	 */
+	p_unavail = stripe_req->p_chunk->index == chunk_idx ||
+		    raid_bdev_channel_get_base_channel(raid_io->raid_ch,
+				    stripe_req->p_chunk->index) == NULL;
+	q_unavail = stripe_req->q_chunk->index == chunk_idx ||
+		    raid_bdev_channel_get_base_channel(raid_io->raid_ch,
+				    stripe_req->q_chunk->index) == NULL;
+
+	FOR_EACH_DATA_CHUNK(stripe_req, chunk) {
+		if (chunk->index != chunk_idx &&
+		    raid_bdev_channel_get_base_channel(raid_io->raid_ch, chunk->index) != NULL) {
+			continue;
+		}
+		if (num_missing_data == 2) {
+			return -EIO;
+		}
+		missing[num_missing_data++] = chunk->index;
+	}
+
+	/* the chunk to reconstruct comes first */
+	if (num_missing_data == 2 && missing[1] == chunk_idx) {
+		missing[1] = missing[0];
+		missing[0] = chunk_idx;
+	}
+
+	if (num_missing_data == 2) {
+		if (p_unavail || q_unavail) {
+			return -EIO;
+		}
+		stripe_req->reconstruct.mode = RAID6_RECONSTRUCT_PQ;
+	} else if (num_missing_data == 1 && p_unavail) {
+		if (q_unavail) {
+			return -EIO;
+		}
+		stripe_req->reconstruct.mode = RAID6_RECONSTRUCT_Q;
+	} else {
+		stripe_req->reconstruct.mode = RAID6_RECONSTRUCT_P;
+	}
+
+	stripe_req->reconstruct.missing_chunk_idx[0] = missing[0];
+	stripe_req->reconstruct.missing_chunk_idx[1] = missing[1];
+	stripe_req->reconstruct.num_missing_data = num_missing_data;
+
+	FOR_EACH_CHUNK(stripe_req, chunk) {
+		bool read;
+
+		if (chunk == stripe_req->reconstruct.chunk) {
+			read = false;
+		} else if (chunk == stripe_req->p_chunk) {
+			read = !p_unavail && num_missing_data > 0 &&
+			       stripe_req->reconstruct.mode != RAID6_RECONSTRUCT_Q;
+		} else if (chunk == stripe_req->q_chunk) {
+			read = !q_unavail &&
+			       stripe_req->reconstruct.mode != RAID6_RECONSTRUCT_P;
+		} else {
+			read = raid_bdev_channel_get_base_channel(raid_io->raid_ch,
+					chunk->index) != NULL;
+		}
+
+		stripe_req->reconstruct.chunk_read[chunk->index] = read;
+
+		if (chunk == stripe_req->reconstruct.chunk) {
+			int i;
+
+			ret = raid6_chunk_set_iovcnt(chunk, raid_io->iovcnt);
+			if (ret) {
+				return ret;
+			}
+
+			for (i = 0; i < raid_io->iovcnt; i++) {
+				chunk->iovs[i] = raid_io->iovs[i];
+			}
+
+			chunk->md_buf = raid_io_md;
+		} else {
+			struct iovec *iov = &chunk->iovs[0];
+
+			iov->iov_base = stripe_req->reconstruct.chunk_buffers[chunk->index];
+			iov->iov_len = raid_io->num_blocks * raid_bdev->bdev.blocklen;
+			chunk->iovcnt = 1;
+
+			if (raid_io_md) {
+				chunk->md_buf = stripe_req->reconstruct.chunk_md_buffers[chunk->index];
+			}
+		}
+	}
+
+	raid_io->module_private = stripe_req;
+	raid_io->base_bdev_io_remaining = raid_bdev->num_base_bdevs;
+	raid_io->completion_cb = raid6_reconstruct_reads_completed_cb;
+
+	TAILQ_REMOVE(&r6ch->free_stripe_requests.reconstruct, stripe_req, link);
+
+	raid6_stripe_request_submit_chunks(stripe_req);
+
+	return 0;
+}
+
+static void
+raid6_stripe_request_reconstruct_done(struct stripe_request *stripe_req, int status)
+{
+	struct raid_bdev_io *raid_io = stripe_req->raid_io;
+
+	raid6_stripe_request_release(stripe_req);
+
+	raid_bdev_io_complete(raid_io,
+			      status == 0 ? SPDK_BDEV_IO_STATUS_SUCCESS : SPDK_BDEV_IO_STATUS_FAILED);
+}
+
+static int
+raid6_submit_read_request(struct raid_bdev_io *raid_io, uint64_t stripe_index,
+			  uint64_t stripe_offset)
+{
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	uint8_t chunk_data_idx = stripe_offset >> raid_bdev->strip_size_shift;
+	uint8_t p_idx = raid6_stripe_p_chunk_index(raid_bdev, stripe_index);
+	uint8_t q_idx = raid6_stripe_q_chunk_index(raid_bdev, stripe_index);
+	uint8_t chunk_idx = raid6_data_chunk_to_chunk_index(p_idx, q_idx, chunk_data_idx);
+	struct raid_base_bdev_info *base_info = &raid_bdev->base_bdev_info[chunk_idx];
+	struct spdk_io_channel *base_ch = raid_bdev_channel_get_base_channel(raid_io->raid_ch, chunk_idx);
+	uint64_t chunk_offset = stripe_offset - (chunk_data_idx << raid_bdev->strip_size_shift);
+	uint64_t base_offset_blocks = (stripe_index << raid_bdev->strip_size_shift) + chunk_offset;
+	struct spdk_bdev_ext_io_opts io_opts;
+	int ret;
+
+	raid6_init_ext_io_opts(&io_opts, raid_io);
+	if (base_ch == NULL) {
+		return raid6_submit_reconstruct_read(raid_io, stripe_index, chunk_idx, chunk_offset,
+						     raid6_stripe_request_reconstruct_done);
+	}
+
+	ret = raid_bdev_readv_blocks_ext(base_info, base_ch, raid_io->iovs, raid_io->iovcnt,
+					 base_offset_blocks, raid_io->num_blocks,
+					 raid6_chunk_read_complete, raid_io, &io_opts);
+	if (spdk_unlikely(ret == -ENOMEM)) {
+		raid_bdev_queue_io_wait(raid_io, spdk_bdev_desc_get_bdev(base_info->desc),
+					base_ch, _raid6_submit_rw_request);
+		return 0;
+	}
+
+	return ret;
+}
+
+static void
+raid6_submit_rw_request(struct raid_bdev_io *raid_io)
+{
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	struct raid6_info *r6_info = raid_bdev->module_private;
+	uint64_t stripe_index = raid_io->offset_blocks / r6_info->stripe_blocks;
+	uint64_t stripe_offset = raid_io->offset_blocks % r6_info->stripe_blocks;
+	int ret;
+
+	switch (raid_io->type) {
+	case SPDK_BDEV_IO_TYPE_READ:
+		assert(raid_io->num_blocks <= raid_bdev->strip_size);
+		ret = raid6_submit_read_request(raid_io, stripe_index, stripe_offset);
+		break;
+	case SPDK_BDEV_IO_TYPE_WRITE:
+		assert(stripe_offset == 0);
+		assert(raid_io->num_blocks == r6_info->stripe_blocks);
+		ret = raid6_submit_write_request(raid_io, stripe_index);
+		break;
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	if (spdk_unlikely(ret)) {
+		raid_bdev_io_complete(raid_io, ret == -ENOMEM ? SPDK_BDEV_IO_STATUS_NOMEM :
+				      SPDK_BDEV_IO_STATUS_FAILED);
+	}
+}
+
+static void
+raid6_stripe_request_free(struct stripe_request *stripe_req)
+{
+	struct chunk *chunk;
+
+	FOR_EACH_CHUNK(stripe_req, chunk) {
+		free(chunk->iovs);
+	}
+
+	if (stripe_req->type == STRIPE_REQ_WRITE) {
+		spdk_dma_free(stripe_req->write.parity_buf);
+		spdk_dma_free(stripe_req->write.parity_md_buf);
+		spdk_dma_free(stripe_req->write.q_buf);
+		spdk_dma_free(stripe_req->write.q_md_buf);
+	} else if (stripe_req->type == STRIPE_REQ_RECONSTRUCT) {
+		struct raid6_info *r6_info = raid6_ch_to_r6_info(stripe_req->r6ch);
+		struct raid_bdev *raid_bdev = r6_info->raid_bdev;
+		uint8_t i;
+
+		if (stripe_req->reconstruct.chunk_buffers) {
+			for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
+				spdk_dma_free(stripe_req->reconstruct.chunk_buffers[i]);
+			}
+			free(stripe_req->reconstruct.chunk_buffers);
+		}
+
+		if (stripe_req->reconstruct.chunk_md_buffers) {
+			for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
+				spdk_dma_free(stripe_req->reconstruct.chunk_md_buffers[i]);
+			}
+			free(stripe_req->reconstruct.chunk_md_buffers);
+		}
+
+		free(stripe_req->reconstruct.chunk_read);
+	} else {
+		assert(false);
+	}
+
+	free(stripe_req->chunk_xor_buffers);
+	free(stripe_req->chunk_xor_md_buffers);
+	free(stripe_req->chunk_iov_iters);
+
+	free(stripe_req);
+}
+
+static struct stripe_request *
+raid6_stripe_request_alloc(struct raid6_io_channel *r6ch, enum stripe_request_type type)
+{
+	struct raid6_info *r6_info = raid6_ch_to_r6_info(r6ch);
+	struct raid_bdev *raid_bdev = r6_info->raid_bdev;
+	uint32_t raid_io_md_size = raid_bdev->bdev.md_interleave ? 0 : raid_bdev->bdev.md_len;
+	struct stripe_request *stripe_req;
+	struct chunk *chunk;
+	size_t chunk_len;
+
+	stripe_req = calloc(1, sizeof(*stripe_req) + sizeof(*chunk) * raid_bdev->num_base_bdevs);
+	if (!stripe_req) {
+		return NULL;
+	}
+
+	stripe_req->r6ch = r6ch;
+	stripe_req->type = type;
+
+	FOR_EACH_CHUNK(stripe_req, chunk) {
+		chunk->index = chunk - stripe_req->chunks;
+		chunk->iovcnt_max = 4;
+		chunk->iovs = calloc(chunk->iovcnt_max, sizeof(chunk->iovs[0]));
+		if (!chunk->iovs) {
+			goto err;
+		}
+	}
+
+	chunk_len = raid_bdev->strip_size * raid_bdev->bdev.blocklen;
+
+	if (type == STRIPE_REQ_WRITE) {
+		stripe_req->write.parity_buf = spdk_dma_malloc(chunk_len, r6_info->buf_alignment, NULL);
+		if (!stripe_req->write.parity_buf) {
+			goto err;
+		}
+
+		stripe_req->write.q_buf = spdk_dma_malloc(chunk_len, r6_info->buf_alignment, NULL);
+		if (!stripe_req->write.q_buf) {
+			goto err;
+		}
+
+		if (raid_io_md_size != 0) {
+			stripe_req->write.parity_md_buf = spdk_dma_malloc(raid_bdev->strip_size * raid_io_md_size,
+							  r6_info->buf_alignment, NULL);
+			if (!stripe_req->write.parity_md_buf) {
+				goto err;
+			}
+
+			stripe_req->write.q_md_buf = spdk_dma_malloc(raid_bdev->strip_size * raid_io_md_size,
+						     r6_info->buf_alignment, NULL);
+			if (!stripe_req->write.q_md_buf) {
+				goto err;
+			}
+		}
+	} else if (type == STRIPE_REQ_RECONSTRUCT) {
+		uint8_t n = raid_bdev->num_base_bdevs;
+		void *buf;
+		uint8_t i;
+
+		stripe_req->reconstruct.chunk_read = calloc(n, sizeof(bool));
+		if (!stripe_req->reconstruct.chunk_read) {
+			goto err;
+		}
+
+		stripe_req->reconstruct.chunk_buffers = calloc(n, sizeof(void *));
+		if (!stripe_req->reconstruct.chunk_buffers) {
+			goto err;
+		}
+
+		for (i = 0; i < n; i++) {
+			buf = spdk_dma_malloc(chunk_len, r6_info->buf_alignment, NULL);
+			if (!buf) {
+				goto err;
+			}
+			stripe_req->reconstruct.chunk_buffers[i] = buf;
+		}
+
+		if (raid_io_md_size != 0) {
+			stripe_req->reconstruct.chunk_md_buffers = calloc(n, sizeof(void *));
+			if (!stripe_req->reconstruct.chunk_md_buffers) {
+				goto err;
+			}
+
+			for (i = 0; i < n; i++) {
+				buf = spdk_dma_malloc(raid_bdev->strip_size * raid_io_md_size,
+						      r6_info->buf_alignment, NULL);
+				if (!buf) {
+					goto err;
+				}
+				stripe_req->reconstruct.chunk_md_buffers[i] = buf;
+			}
+		}
+	} else {
+		assert(false);
+		return NULL;
+	}
+
+	stripe_req->chunk_iov_iters = malloc(SPDK_IOVITER_SIZE(raid_bdev->num_base_bdevs));
+	if (!stripe_req->chunk_iov_iters) {
+		goto err;
+	}
+
+	stripe_req->chunk_xor_buffers = calloc(raid_bdev->num_base_bdevs,
+					       sizeof(stripe_req->chunk_xor_buffers[0]));
+	if (!stripe_req->chunk_xor_buffers) {
+		goto err;
+	}
+
+	stripe_req->chunk_xor_md_buffers = calloc(raid_bdev->num_base_bdevs,
+					   sizeof(stripe_req->chunk_xor_md_buffers[0]));
+	if (!stripe_req->chunk_xor_md_buffers) {
+		goto err;
+	}
+
+	return stripe_req;
+err:
+	raid6_stripe_request_free(stripe_req);
+	return NULL;
+}
+
+static void
+raid6_ioch_destroy(void *io_device, void *ctx_buf)
+{
+	struct raid6_io_channel *r6ch = ctx_buf;
+	struct stripe_request *stripe_req;
+
+	assert(TAILQ_EMPTY(&r6ch->xor_retry_queue));
+
+	while ((stripe_req = TAILQ_FIRST(&r6ch->free_stripe_requests.write))) {
+		TAILQ_REMOVE(&r6ch->free_stripe_requests.write, stripe_req, link);
+		raid6_stripe_request_free(stripe_req);
+	}
+
+	while ((stripe_req = TAILQ_FIRST(&r6ch->free_stripe_requests.reconstruct))) {
+		TAILQ_REMOVE(&r6ch->free_stripe_requests.reconstruct, stripe_req, link);
+		raid6_stripe_request_free(stripe_req);
+	}
+
+	if (r6ch->accel_ch) {
+		spdk_put_io_channel(r6ch->accel_ch);
+	}
+
+	free(r6ch->chunk_xor_buffers);
+	free(r6ch->chunk_xor_iovs);
+	free(r6ch->chunk_xor_iovcnt);
+}
+
+static int
+raid6_ioch_create(void *io_device, void *ctx_buf)
+{
+	struct raid6_io_channel *r6ch = ctx_buf;
+	struct raid6_info *r6_info = io_device;
+	struct raid_bdev *raid_bdev = r6_info->raid_bdev;
+	struct stripe_request *stripe_req;
+	int i;
+
+	TAILQ_INIT(&r6ch->free_stripe_requests.write);
+	TAILQ_INIT(&r6ch->free_stripe_requests.reconstruct);
+	TAILQ_INIT(&r6ch->xor_retry_queue);
+
+	for (i = 0; i < RAID6_MAX_STRIPES; i++) {
+		stripe_req = raid6_stripe_request_alloc(r6ch, STRIPE_REQ_WRITE);
+		if (!stripe_req) {
+			goto err;
+		}
+
+		TAILQ_INSERT_HEAD(&r6ch->free_stripe_requests.write, stripe_req, link);
+	}
+
+	for (i = 0; i < RAID6_MAX_STRIPES; i++) {
+		stripe_req = raid6_stripe_request_alloc(r6ch, STRIPE_REQ_RECONSTRUCT);
+		if (!stripe_req) {
+			goto err;
+		}
+
+		TAILQ_INSERT_HEAD(&r6ch->free_stripe_requests.reconstruct, stripe_req, link);
+	}
+
+	r6ch->accel_ch = spdk_accel_get_io_channel();
+	if (!r6ch->accel_ch) {
+		SPDK_ERRLOG("Failed to get accel framework's IO channel\n");
+		goto err;
+	}
+
+	r6ch->chunk_xor_buffers = calloc(raid_bdev->num_base_bdevs, sizeof(*r6ch->chunk_xor_buffers));
+	if (!r6ch->chunk_xor_buffers) {
+		goto err;
+	}
+
+	r6ch->chunk_xor_iovs = calloc(raid_bdev->num_base_bdevs, sizeof(*r6ch->chunk_xor_iovs));
+	if (!r6ch->chunk_xor_iovs) {
+		goto err;
+	}
+
+	r6ch->chunk_xor_iovcnt = calloc(raid_bdev->num_base_bdevs, sizeof(*r6ch->chunk_xor_iovcnt));
+	if (!r6ch->chunk_xor_iovcnt) {
+		goto err;
+	}
+
+	return 0;
+err:
+	SPDK_ERRLOG("Failed to initialize io channel\n");
+	raid6_ioch_destroy(r6_info, r6ch);
+	return -ENOMEM;
+}
+
+static int
+raid6_start(struct raid_bdev *raid_bdev)
+{
+	uint64_t min_blockcnt = UINT64_MAX;
+	uint64_t base_bdev_data_size;
+	struct raid_base_bdev_info *base_info;
+	struct spdk_bdev *base_bdev;
+	struct raid6_info *r6_info;
+	size_t alignment = 0;
+
+	if (!g_gf_tables_initialized) {
+		raid6_gf_tables_init();
+	}
+
+	r6_info = calloc(1, sizeof(*r6_info));
+	if (!r6_info) {
+		SPDK_ERRLOG("Failed to allocate r6_info\n");
+		return -ENOMEM;
+	}
+	r6_info->raid_bdev = raid_bdev;
+
+	RAID_FOR_EACH_BASE_BDEV(raid_bdev, base_info) {
+		min_blockcnt = spdk_min(min_blockcnt, base_info->data_size);
+		if (base_info->desc) {
+			base_bdev = spdk_bdev_desc_get_bdev(base_info->desc);
+			alignment = spdk_max(alignment, spdk_bdev_get_buf_align(base_bdev));
+		}
+	}
+
+	base_bdev_data_size = (min_blockcnt / raid_bdev->strip_size) * raid_bdev->strip_size;
+
+	RAID_FOR_EACH_BASE_BDEV(raid_bdev, base_info) {
+		base_info->data_size = base_bdev_data_size;
+	}
+
+	r6_info->total_stripes = min_blockcnt / raid_bdev->strip_size;
+	r6_info->stripe_blocks = raid_bdev->strip_size * raid6_stripe_data_chunks_num(raid_bdev);
+	r6_info->buf_alignment = alignment;
+	if (!raid_bdev->bdev.md_interleave) {
+		r6_info->blocklen_shift = spdk_u32log2(raid_bdev->bdev.blocklen);
+	}
+
+	raid_bdev->bdev.blockcnt = r6_info->stripe_blocks * r6_info->total_stripes;
+	raid_bdev->bdev.optimal_io_boundary = raid_bdev->strip_size;
+	raid_bdev->bdev.split_on_optimal_io_boundary = true;
+	raid_bdev->bdev.write_unit_size = r6_info->stripe_blocks;
+	raid_bdev->bdev.split_on_write_unit = true;
+
+	raid_bdev->module_private = r6_info;
+
+	spdk_io_device_register(r6_info, raid6_ioch_create, raid6_ioch_destroy,
+				sizeof(struct raid6_io_channel), NULL);
+
+	return 0;
+}
+
+static void
+raid6_io_device_unregister_done(void *io_device)
+{
+	struct raid6_info *r6_info = io_device;
+
+	raid_bdev_module_stop_done(r6_info->raid_bdev);
+
+	free(r6_info);
+}
+
+static bool
+raid6_stop(struct raid_bdev *raid_bdev)
+{
+	struct raid6_info *r6_info = raid_bdev->module_private;
+
+	spdk_io_device_unregister(r6_info, raid6_io_device_unregister_done);
+
+	return false;
+}
+
+static struct spdk_io_channel *
+raid6_get_io_channel(struct raid_bdev *raid_bdev)
+{
+	struct raid6_info *r6_info = raid_bdev->module_private;
+
+	return spdk_get_io_channel(r6_info);
+}
+
+static void
+raid6_process_write_completed(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct raid_bdev_process_request *process_req = cb_arg;
+
+	spdk_bdev_free_io(bdev_io);
+
+	raid_bdev_process_request_complete(process_req, success ? 0 : -EIO);
+}
+
+static void raid6_process_submit_write(struct raid_bdev_process_request *process_req);
+
+static void
+_raid6_process_submit_write(void *ctx)
+{
+	struct raid_bdev_process_request *process_req = ctx;
+
+	raid6_process_submit_write(process_req);
+}
+
+static void
+raid6_process_submit_write(struct raid_bdev_process_request *process_req)
+{
+	struct raid_bdev_io *raid_io = &process_req->raid_io;
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	struct raid6_info *r6_info = raid_bdev->module_private;
+	uint64_t stripe_index = process_req->offset_blocks / r6_info->stripe_blocks;
+	struct spdk_bdev_ext_io_opts io_opts;
+	int ret;
+
+	raid6_init_ext_io_opts(&io_opts, raid_io);
+	ret = raid_bdev_writev_blocks_ext(process_req->target, process_req->target_ch,
+					  raid_io->iovs, raid_io->iovcnt,
+					  stripe_index << raid_bdev->strip_size_shift, raid_bdev->strip_size,
+					  raid6_process_write_completed, process_req, &io_opts);
+	if (spdk_unlikely(ret != 0)) {
+		if (ret == -ENOMEM) {
+			raid_bdev_queue_io_wait(raid_io, spdk_bdev_desc_get_bdev(process_req->target->desc),
+						process_req->target_ch, _raid6_process_submit_write);
+		} else {
+			raid_bdev_process_request_complete(process_req, ret);
+		}
+	}
+}
+
+static void
+raid6_process_stripe_request_reconstruct_done(struct stripe_request *stripe_req, int status)
+{
+	struct raid_bdev_io *raid_io = stripe_req->raid_io;
+	struct raid_bdev_process_request *process_req = SPDK_CONTAINEROF(raid_io,
+			struct raid_bdev_process_request, raid_io);
+
+	raid6_stripe_request_release(stripe_req);
+
+	if (status != 0) {
+		raid_bdev_process_request_complete(process_req, status);
+		return;
+	}
+
+	raid6_process_submit_write(process_req);
+}
+
+static int
+raid6_submit_process_request(struct raid_bdev_process_request *process_req,
+			     struct raid_bdev_io_channel *raid_ch)
+{
+	struct spdk_io_channel *ch = spdk_io_channel_from_ctx(raid_ch);
+	struct raid_bdev *raid_bdev = spdk_io_channel_get_io_device(ch);
+	struct raid6_info *r6_info = raid_bdev->module_private;
+	struct raid_bdev_io *raid_io = &process_req->raid_io;
+	uint8_t chunk_idx = raid_bdev_base_bdev_slot(process_req->target);
+	uint64_t stripe_index = process_req->offset_blocks / r6_info->stripe_blocks;
+	int ret;
+
+	assert((process_req->offset_blocks % r6_info->stripe_blocks) == 0);
+
+	if (process_req->num_blocks < r6_info->stripe_blocks) {
+		return 0;
+	}
+
+	raid_bdev_io_init(raid_io, raid_ch, SPDK_BDEV_IO_TYPE_READ,
+			  process_req->offset_blocks, raid_bdev->strip_size,
+			  &process_req->iov, 1, process_req->md_buf, NULL, NULL);
+
+	ret = raid6_submit_reconstruct_read(raid_io, stripe_index, chunk_idx, 0,
+					    raid6_process_stripe_request_reconstruct_done);
+	if (spdk_likely(ret == 0)) {
+		return r6_info->stripe_blocks;
+	} else if (ret < 0) {
+		return ret;
+	} else {
+		return -EINVAL;
+	}
+}
+
+static struct raid_bdev_module g_raid6_module = {
+	.level = RAID6,
+	.base_bdevs_min = 4,
+	.base_bdevs_constraint = {CONSTRAINT_MAX_BASE_BDEVS_REMOVED, 2},
+	.start = raid6_start,
+	.stop = raid6_stop,
+	.submit_rw_request = raid6_submit_rw_request,
+	.get_io_channel = raid6_get_io_channel,
+	.submit_process_request = raid6_submit_process_request,
+};
+RAID_MODULE_REGISTER(&g_raid6_module)
+
+SPDK_LOG_REGISTER_COMPONENT(bdev_raid6)
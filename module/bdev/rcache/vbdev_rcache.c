@@ -0,0 +1,920 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#include "spdk/stdinc.h"
+
+#include "vbdev_rcache.h"
+#include "spdk/rpc.h"
+#include "spdk/env.h"
+#include "spdk/string.h"
+#include "spdk/thread.h"
+#include "spdk/util.h"
+
+#include "spdk/bdev_module.h"
+#include "spdk/log.h"
+
+/* This namespace UUID was generated using uuid_generate() method. */
+#define BDEV_RCACHE_NAMESPACE_UUID "7f4983da-2c93-4c4c-8b9a-3f1b6e1de0a2"
+
+/* Number of cache slots per channel.  Each slot holds one read extent. */
+#define RCACHE_NUM_SLOTS (1024)
+
+/* Invalidation granularity.  The LBA space is hashed into this many regions,
+ * each with its own epoch counter that writes bump.  A cached extent is only
+ * served while the epoch of its region is unchanged since the extent was
+ * filled.
+ */
+#define RCACHE_NUM_REGIONS (256)
+
+/* log2 of the region size in blocks: 2048 blocks (1MiB at 512B blocks). */
+#define RCACHE_REGION_SHIFT (11)
+
+static int vbdev_rcache_init(void);
+static int vbdev_rcache_get_ctx_size(void);
+static void vbdev_rcache_examine(struct spdk_bdev *bdev);
+static void vbdev_rcache_finish(void);
+static int vbdev_rcache_config_json(struct spdk_json_write_ctx *w);
+
+static struct spdk_bdev_module rcache_if = {
+	.name = "rcache",
+	.module_init = vbdev_rcache_init,
+	.get_ctx_size = vbdev_rcache_get_ctx_size,
+	.examine_config = vbdev_rcache_examine,
+	.module_fini = vbdev_rcache_finish,
+	.config_json = vbdev_rcache_config_json
+};
+
+SPDK_BDEV_MODULE_REGISTER(rcache, &rcache_if)
+
+/* Associative list to be used in examine */
+struct bdev_association {
+	char			*vbdev_name;
+	char			*bdev_name;
+	struct spdk_uuid	uuid;
+	TAILQ_ENTRY(bdev_association)	link;
+};
+static TAILQ_HEAD(, bdev_association) g_bdev_associations = TAILQ_HEAD_INITIALIZER(
+			g_bdev_associations);
+
+/* List of virtual bdevs and associated info for each. */
+struct vbdev_rcache {
+	struct spdk_bdev		*base_bdev; /* the thing we're attaching to */
+	struct spdk_bdev_desc		*base_desc; /* its descriptor we get from open */
+	struct spdk_bdev		rcache_bdev; /* the read cache virtual bdev */
+	/* Per-region invalidation epochs, shared by all channels.  Writes bump
+	 * the epochs of the regions they overlap before descending to the base
+	 * bdev and again on completion; reads validate the epoch of a cached
+	 * extent before serving it.
+	 * This is the only cross-core state and it is only ever accessed with
+	 * relaxed/acquire/release atomics - no locks are taken anywhere on the
+	 * I/O path.
+	 */
+	uint64_t			region_epoch[RCACHE_NUM_REGIONS];
+	TAILQ_ENTRY(vbdev_rcache)	link;
+	struct spdk_thread		*thread;    /* thread where base device is opened */
+};
+static TAILQ_HEAD(, vbdev_rcache) g_rcache_nodes = TAILQ_HEAD_INITIALIZER(g_rcache_nodes);
+
+struct rcache_bdev_io {
+	struct spdk_io_channel *ch;
+
+	struct spdk_bdev_io_wait_entry bdev_io_wait;
+
+	/* Epoch of the read's region sampled before descending to the base
+	 * bdev.  Used to fill the cache on completion; if a write raced with
+	 * the read, the current epoch no longer matches and the filled extent
+	 * will simply never be served.
+	 */
+	uint64_t fill_epoch;
+
+	uint32_t region;
+
+	bool cacheable;
+};
+
+/* One cached read extent.  Slots are owned exclusively by their channel's
+ * thread, so no synchronization is needed to fill, serve or evict them.
+ */
+struct rcache_slot {
+	uint64_t	offset_blocks;
+	uint64_t	num_blocks;
+	uint64_t	epoch;
+	uint32_t	region;
+	void		*buf;
+	uint64_t	buf_len;
+};
+
+struct rcache_io_channel {
+	struct spdk_io_channel	*base_ch; /* IO channel of base device */
+	struct spdk_iobuf_channel iobuf;
+	struct rcache_slot	*slots;
+	uint32_t		max_cached_len; /* iobuf large_bufsize cap */
+	uint64_t		hits;
+	uint64_t		misses;
+};
+
+static void vbdev_rcache_submit_request(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io);
+
+static inline uint32_t
+rcache_region(uint64_t offset_blocks)
+{
+	return (offset_blocks >> RCACHE_REGION_SHIFT) % RCACHE_NUM_REGIONS;
+}
+
+static inline struct rcache_slot *
+rcache_get_slot(struct rcache_io_channel *rcache_ch, uint64_t offset_blocks,
+		uint64_t num_blocks)
+{
+	uint64_t h = (offset_blocks * 0x9e3779b97f4a7c15ULL) ^ num_blocks;
+
+	return &rcache_ch->slots[h % RCACHE_NUM_SLOTS];
+}
+
+static void
+rcache_evict_slot(struct rcache_io_channel *rcache_ch, struct rcache_slot *slot)
+{
+	if (slot->buf != NULL) {
+		spdk_iobuf_put(&rcache_ch->iobuf, slot->buf, slot->buf_len);
+		slot->buf = NULL;
+	}
+}
+
+/* Bump the epoch of every region the extent overlaps.  Release ordering pairs
+ * with the acquire load in the hit check, so a reader that observes the old
+ * epoch can only have been submitted concurrently with this write, where
+ * returning the prior data is an allowed outcome.
+ */
+static void
+rcache_invalidate(struct vbdev_rcache *rcache_node, uint64_t offset_blocks,
+		  uint64_t num_blocks)
+{
+	uint64_t first = offset_blocks >> RCACHE_REGION_SHIFT;
+	uint64_t last = (offset_blocks + num_blocks - 1) >> RCACHE_REGION_SHIFT;
+	uint64_t region;
+
+	if (last - first >= RCACHE_NUM_REGIONS) {
+		last = first + RCACHE_NUM_REGIONS - 1;
+	}
+
+	for (region = first; region <= last; region++) {
+		__atomic_add_fetch(&rcache_node->region_epoch[region % RCACHE_NUM_REGIONS],
+				   1, __ATOMIC_RELEASE);
+	}
+}
+
+/* A read is only cached if it fits in one iobuf large buffer and does not
+ * cross a region boundary, so a single epoch covers the whole extent.
+ */
+static bool
+rcache_io_cacheable(struct rcache_io_channel *rcache_ch, struct spdk_bdev_io *bdev_io)
+{
+	uint64_t offset_blocks = bdev_io->u.bdev.offset_blocks;
+	uint64_t num_blocks = bdev_io->u.bdev.num_blocks;
+
+	if (bdev_io->u.bdev.md_buf != NULL) {
+		return false;
+	}
+	if (num_blocks * bdev_io->bdev->blocklen > rcache_ch->max_cached_len) {
+		return false;
+	}
+	return (offset_blocks >> RCACHE_REGION_SHIFT) ==
+	       ((offset_blocks + num_blocks - 1) >> RCACHE_REGION_SHIFT);
+}
+
+static bool
+rcache_serve_from_cache(struct rcache_io_channel *rcache_ch, struct vbdev_rcache *rcache_node,
+			struct spdk_bdev_io *bdev_io)
+{
+	struct rcache_slot *slot;
+	uint64_t len = bdev_io->u.bdev.num_blocks * bdev_io->bdev->blocklen;
+
+	slot = rcache_get_slot(rcache_ch, bdev_io->u.bdev.offset_blocks,
+			       bdev_io->u.bdev.num_blocks);
+	if (slot->buf == NULL ||
+	    slot->offset_blocks != bdev_io->u.bdev.offset_blocks ||
+	    slot->num_blocks != bdev_io->u.bdev.num_blocks) {
+		return false;
+	}
+
+	if (__atomic_load_n(&rcache_node->region_epoch[slot->region],
+			    __ATOMIC_ACQUIRE) != slot->epoch) {
+		/* A write has touched this region since the slot was filled. */
+		rcache_evict_slot(rcache_ch, slot);
+		return false;
+	}
+
+	spdk_copy_buf_to_iovs(bdev_io->u.bdev.iovs, bdev_io->u.bdev.iovcnt, slot->buf, len);
+
+	return true;
+}
+
+static void
+rcache_fill_cache(struct rcache_io_channel *rcache_ch, struct spdk_bdev_io *bdev_io)
+{
+	struct rcache_bdev_io *io_ctx = (struct rcache_bdev_io *)bdev_io->driver_ctx;
+	struct rcache_slot *slot;
+	uint64_t len = bdev_io->u.bdev.num_blocks * bdev_io->bdev->blocklen;
+	void *buf;
+
+	slot = rcache_get_slot(rcache_ch, bdev_io->u.bdev.offset_blocks,
+			       bdev_io->u.bdev.num_blocks);
+	rcache_evict_slot(rcache_ch, slot);
+
+	/* Never wait for a buffer - filling the cache is best effort. */
+	buf = spdk_iobuf_get(&rcache_ch->iobuf, len, NULL, NULL);
+	if (buf == NULL) {
+		return;
+	}
+
+	spdk_copy_iovs_to_buf(buf, len, bdev_io->u.bdev.iovs, bdev_io->u.bdev.iovcnt);
+
+	slot->offset_blocks = bdev_io->u.bdev.offset_blocks;
+	slot->num_blocks = bdev_io->u.bdev.num_blocks;
+	slot->epoch = io_ctx->fill_epoch;
+	slot->region = io_ctx->region;
+	slot->buf = buf;
+	slot->buf_len = len;
+}
+
+/* Callback for unregistering the IO device. */
+static void
+_device_unregister_cb(void *io_device)
+{
+	struct vbdev_rcache *rcache_node = io_device;
+
+	/* Done with this rcache_node. */
+	free(rcache_node->rcache_bdev.name);
+	free(rcache_node);
+}
+
+static void
+_vbdev_rcache_destruct(void *ctx)
+{
+	struct spdk_bdev_desc *desc = ctx;
+
+	spdk_bdev_close(desc);
+}
+
+static int
+vbdev_rcache_destruct(void *ctx)
+{
+	struct vbdev_rcache *rcache_node = (struct vbdev_rcache *)ctx;
+
+	/* It is important to follow this exact sequence of steps for destroying
+	 * a vbdev...
+	 */
+
+	TAILQ_REMOVE(&g_rcache_nodes, rcache_node, link);
+
+	/* Unclaim the underlying bdev. */
+	spdk_bdev_module_release_bdev(rcache_node->base_bdev);
+
+	/* Close the underlying bdev on its same opened thread. */
+	if (rcache_node->thread && rcache_node->thread != spdk_get_thread()) {
+		spdk_thread_send_msg(rcache_node->thread, _vbdev_rcache_destruct, rcache_node->base_desc);
+	} else {
+		spdk_bdev_close(rcache_node->base_desc);
+	}
+
+	/* Unregister the io_device. */
+	spdk_io_device_unregister(rcache_node, _device_unregister_cb);
+
+	return 0;
+}
+
+/* Completion callback for IO that were issued from this bdev.  The original
+ * bdev_io is passed in as an arg so we'll complete that one with the
+ * appropriate status and then free the one that this module issued.
+ */
+static void
+_rcache_complete_io(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct spdk_bdev_io *orig_io = cb_arg;
+	struct rcache_bdev_io *io_ctx = (struct rcache_bdev_io *)orig_io->driver_ctx;
+	struct rcache_io_channel *rcache_ch = spdk_io_channel_get_ctx(io_ctx->ch);
+	struct vbdev_rcache *rcache_node = SPDK_CONTAINEROF(orig_io->bdev, struct vbdev_rcache,
+					   rcache_bdev);
+
+	switch (orig_io->type) {
+	case SPDK_BDEV_IO_TYPE_WRITE:
+	case SPDK_BDEV_IO_TYPE_WRITE_ZEROES:
+	case SPDK_BDEV_IO_TYPE_UNMAP:
+		/* Bump the overlapped epochs a second time now that the write has
+		 * finished.  A read that missed the cache sampled its fill epoch at
+		 * submission; if that happened after the submission-time bump but
+		 * while this write was still in flight, the read may carry pre-write
+		 * data.  This second bump makes such a fill unserveable, so a read
+		 * can only be served from an extent whose epoch was sampled after
+		 * the write completed.  On failure the base data is indeterminate,
+		 * so the bump applies regardless of status.
+		 */
+		rcache_invalidate(rcache_node, orig_io->u.bdev.offset_blocks,
+				  orig_io->u.bdev.num_blocks);
+		break;
+	default:
+		break;
+	}
+
+	if (success && io_ctx->cacheable) {
+		rcache_fill_cache(rcache_ch, orig_io);
+	}
+
+	spdk_bdev_io_complete(orig_io, success ? SPDK_BDEV_IO_STATUS_SUCCESS :
+			      SPDK_BDEV_IO_STATUS_FAILED);
+	spdk_bdev_free_io(bdev_io);
+}
+
+static void
+vbdev_rcache_resubmit_io(void *arg)
+{
+	struct spdk_bdev_io *bdev_io = (struct spdk_bdev_io *)arg;
+	struct rcache_bdev_io *io_ctx = (struct rcache_bdev_io *)bdev_io->driver_ctx;
+
+	vbdev_rcache_submit_request(io_ctx->ch, bdev_io);
+}
+
+static void
+vbdev_rcache_queue_io(struct spdk_bdev_io *bdev_io)
+{
+	struct rcache_bdev_io *io_ctx = (struct rcache_bdev_io *)bdev_io->driver_ctx;
+	struct rcache_io_channel *rcache_ch = spdk_io_channel_get_ctx(io_ctx->ch);
+	int rc;
+
+	io_ctx->bdev_io_wait.bdev = bdev_io->bdev;
+	io_ctx->bdev_io_wait.cb_fn = vbdev_rcache_resubmit_io;
+	io_ctx->bdev_io_wait.cb_arg = bdev_io;
+
+	rc = spdk_bdev_queue_io_wait(bdev_io->bdev, rcache_ch->base_ch, &io_ctx->bdev_io_wait);
+	if (rc != 0) {
+		SPDK_ERRLOG("Queue io failed in vbdev_rcache_queue_io, rc=%d.\n", rc);
+		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED);
+	}
+}
+
+static void
+rcache_init_ext_io_opts(struct spdk_bdev_io *bdev_io, struct spdk_bdev_ext_io_opts *opts)
+{
+	memset(opts, 0, sizeof(*opts));
+	opts->size = sizeof(*opts);
+	opts->memory_domain = bdev_io->u.bdev.memory_domain;
+	opts->memory_domain_ctx = bdev_io->u.bdev.memory_domain_ctx;
+	opts->metadata = bdev_io->u.bdev.md_buf;
+}
+
+static void
+rcache_read_get_buf_cb(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io, bool success)
+{
+	struct vbdev_rcache *rcache_node = SPDK_CONTAINEROF(bdev_io->bdev, struct vbdev_rcache,
+					   rcache_bdev);
+	struct rcache_io_channel *rcache_ch = spdk_io_channel_get_ctx(ch);
+	struct rcache_bdev_io *io_ctx = (struct rcache_bdev_io *)bdev_io->driver_ctx;
+	struct spdk_bdev_ext_io_opts io_opts;
+	int rc;
+
+	if (!success) {
+		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED);
+		return;
+	}
+
+	io_ctx->cacheable = rcache_io_cacheable(rcache_ch, bdev_io);
+	if (io_ctx->cacheable) {
+		if (rcache_serve_from_cache(rcache_ch, rcache_node, bdev_io)) {
+			/* Cache hit - complete without descending to the base bdev. */
+			rcache_ch->hits++;
+			spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_SUCCESS);
+			return;
+		}
+		rcache_ch->misses++;
+		io_ctx->region = rcache_region(bdev_io->u.bdev.offset_blocks);
+		io_ctx->fill_epoch = __atomic_load_n(&rcache_node->region_epoch[io_ctx->region],
+						     __ATOMIC_ACQUIRE);
+	}
+
+	rcache_init_ext_io_opts(bdev_io, &io_opts);
+	rc = spdk_bdev_readv_blocks_ext(rcache_node->base_desc, rcache_ch->base_ch,
+					bdev_io->u.bdev.iovs,
+					bdev_io->u.bdev.iovcnt, bdev_io->u.bdev.offset_blocks,
+					bdev_io->u.bdev.num_blocks, _rcache_complete_io,
+					bdev_io, &io_opts);
+
+	if (rc == -ENOMEM) {
+		vbdev_rcache_queue_io(bdev_io);
+	} else if (rc != 0) {
+		SPDK_ERRLOG("ERROR on bdev_io submission!\n");
+		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED);
+	}
+}
+
+static void
+vbdev_rcache_reset_dev(struct spdk_io_channel_iter *i, int status)
+{
+	struct spdk_bdev_io *bdev_io = spdk_io_channel_iter_get_ctx(i);
+	struct rcache_bdev_io *io_ctx = (struct rcache_bdev_io *)bdev_io->driver_ctx;
+	struct rcache_io_channel *rcache_ch = spdk_io_channel_get_ctx(io_ctx->ch);
+	struct vbdev_rcache *rcache_node = spdk_io_channel_iter_get_io_device(i);
+	int rc;
+
+	rc = spdk_bdev_reset(rcache_node->base_desc, rcache_ch->base_ch,
+			     _rcache_complete_io, bdev_io);
+
+	if (rc == -ENOMEM) {
+		vbdev_rcache_queue_io(bdev_io);
+	} else if (rc != 0) {
+		SPDK_ERRLOG("ERROR on bdev_io submission!\n");
+		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED);
+	}
+}
+
+/* Drop every cached extent on a channel.  Used on reset, where all prior
+ * state of the base device must be forgotten.
+ */
+static void
+vbdev_rcache_reset_channel(struct spdk_io_channel_iter *i)
+{
+	struct spdk_io_channel *ch = spdk_io_channel_iter_get_channel(i);
+	struct rcache_io_channel *rcache_ch = spdk_io_channel_get_ctx(ch);
+	uint32_t slot;
+
+	for (slot = 0; slot < RCACHE_NUM_SLOTS; slot++) {
+		rcache_evict_slot(rcache_ch, &rcache_ch->slots[slot]);
+	}
+
+	spdk_for_each_channel_continue(i, 0);
+}
+
+static void
+vbdev_rcache_submit_request(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io)
+{
+	struct vbdev_rcache *rcache_node = SPDK_CONTAINEROF(bdev_io->bdev, struct vbdev_rcache,
+					   rcache_bdev);
+	struct rcache_io_channel *rcache_ch = spdk_io_channel_get_ctx(ch);
+	struct rcache_bdev_io *io_ctx = (struct rcache_bdev_io *)bdev_io->driver_ctx;
+	struct spdk_bdev_ext_io_opts io_opts;
+	int rc = 0;
+
+	io_ctx->ch = ch;
+	io_ctx->cacheable = false;
+
+	switch (bdev_io->type) {
+	case SPDK_BDEV_IO_TYPE_READ:
+		spdk_bdev_io_get_buf(bdev_io, rcache_read_get_buf_cb,
+				     bdev_io->u.bdev.num_blocks * bdev_io->bdev->blocklen);
+		break;
+	case SPDK_BDEV_IO_TYPE_WRITE:
+		rcache_invalidate(rcache_node, bdev_io->u.bdev.offset_blocks,
+				  bdev_io->u.bdev.num_blocks);
+		rcache_init_ext_io_opts(bdev_io, &io_opts);
+		rc = spdk_bdev_writev_blocks_ext(rcache_node->base_desc, rcache_ch->base_ch,
+						 bdev_io->u.bdev.iovs,
+						 bdev_io->u.bdev.iovcnt, bdev_io->u.bdev.offset_blocks,
+						 bdev_io->u.bdev.num_blocks, _rcache_complete_io,
+						 bdev_io, &io_opts);
+		break;
+	case SPDK_BDEV_IO_TYPE_WRITE_ZEROES:
+		rcache_invalidate(rcache_node, bdev_io->u.bdev.offset_blocks,
+				  bdev_io->u.bdev.num_blocks);
+		rc = spdk_bdev_write_zeroes_blocks(rcache_node->base_desc, rcache_ch->base_ch,
+						   bdev_io->u.bdev.offset_blocks,
+						   bdev_io->u.bdev.num_blocks,
+						   _rcache_complete_io, bdev_io);
+		break;
+	case SPDK_BDEV_IO_TYPE_UNMAP:
+		rcache_invalidate(rcache_node, bdev_io->u.bdev.offset_blocks,
+				  bdev_io->u.bdev.num_blocks);
+		rc = spdk_bdev_unmap_blocks(rcache_node->base_desc, rcache_ch->base_ch,
+					    bdev_io->u.bdev.offset_blocks,
+					    bdev_io->u.bdev.num_blocks,
+					    _rcache_complete_io, bdev_io);
+		break;
+	case SPDK_BDEV_IO_TYPE_FLUSH:
+		rc = spdk_bdev_flush_blocks(rcache_node->base_desc, rcache_ch->base_ch,
+					    bdev_io->u.bdev.offset_blocks,
+					    bdev_io->u.bdev.num_blocks,
+					    _rcache_complete_io, bdev_io);
+		break;
+	case SPDK_BDEV_IO_TYPE_RESET:
+		spdk_for_each_channel(rcache_node, vbdev_rcache_reset_channel, bdev_io,
+				      vbdev_rcache_reset_dev);
+		break;
+	case SPDK_BDEV_IO_TYPE_ABORT:
+		rc = spdk_bdev_abort(rcache_node->base_desc, rcache_ch->base_ch,
+				     bdev_io->u.abort.bio_to_abort,
+				     _rcache_complete_io, bdev_io);
+		break;
+	default:
+		SPDK_ERRLOG("rcache: unknown I/O type %d\n", bdev_io->type);
+		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED);
+		return;
+	}
+
+	if (rc == -ENOMEM) {
+		vbdev_rcache_queue_io(bdev_io);
+	} else if (rc != 0) {
+		SPDK_ERRLOG("ERROR on bdev_io submission!\n");
+		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED);
+	}
+}
+
+static bool
+vbdev_rcache_io_type_supported(void *ctx, enum spdk_bdev_io_type io_type)
+{
+	struct vbdev_rcache *rcache_node = (struct vbdev_rcache *)ctx;
+
+	switch (io_type) {
+	case SPDK_BDEV_IO_TYPE_ZCOPY:
+		/* Zero copy would let readers bypass the cache coherency
+		 * protocol, so it is not passed through.
+		 */
+		return false;
+	default:
+		return spdk_bdev_io_type_supported(rcache_node->base_bdev, io_type);
+	}
+}
+
+static struct spdk_io_channel *
+vbdev_rcache_get_io_channel(void *ctx)
+{
+	struct vbdev_rcache *rcache_node = (struct vbdev_rcache *)ctx;
+
+	return spdk_get_io_channel(rcache_node);
+}
+
+static void
+_rcache_write_conf_values(struct vbdev_rcache *rcache_node, struct spdk_json_write_ctx *w)
+{
+	struct spdk_uuid *uuid = &rcache_node->rcache_bdev.uuid;
+
+	spdk_json_write_named_string(w, "name", spdk_bdev_get_name(&rcache_node->rcache_bdev));
+	spdk_json_write_named_string(w, "base_bdev_name", spdk_bdev_get_name(rcache_node->base_bdev));
+	if (!spdk_uuid_is_null(uuid)) {
+		spdk_json_write_named_uuid(w, "uuid", uuid);
+	}
+}
+
+static int
+vbdev_rcache_dump_info_json(void *ctx, struct spdk_json_write_ctx *w)
+{
+	struct vbdev_rcache *rcache_node = (struct vbdev_rcache *)ctx;
+
+	spdk_json_write_name(w, "rcache");
+	spdk_json_write_object_begin(w);
+	_rcache_write_conf_values(rcache_node, w);
+	spdk_json_write_object_end(w);
+
+	return 0;
+}
+
+/* This is used to generate JSON that can configure this module to its current state. */
+static int
+vbdev_rcache_config_json(struct spdk_json_write_ctx *w)
+{
+	struct vbdev_rcache *rcache_node;
+
+	TAILQ_FOREACH(rcache_node, &g_rcache_nodes, link) {
+		spdk_json_write_object_begin(w);
+		spdk_json_write_named_string(w, "method", "bdev_rcache_create");
+		spdk_json_write_named_object_begin(w, "params");
+		_rcache_write_conf_values(rcache_node, w);
+		spdk_json_write_object_end(w);
+		spdk_json_write_object_end(w);
+	}
+	return 0;
+}
+
+/* We provide this callback for the SPDK channel code to create a channel using
+ * the channel struct we provided in our module get_io_channel() entry point.
+ * The cache slots live here, so each channel has its own table that only its
+ * thread ever touches.
+ */
+static int
+rcache_bdev_ch_create_cb(void *io_device, void *ctx_buf)
+{
+	struct rcache_io_channel *rcache_ch = ctx_buf;
+	struct vbdev_rcache *rcache_node = io_device;
+	struct spdk_iobuf_opts iobuf_opts;
+	int rc;
+
+	rcache_ch->slots = calloc(RCACHE_NUM_SLOTS, sizeof(struct rcache_slot));
+	if (rcache_ch->slots == NULL) {
+		SPDK_ERRLOG("could not allocate rcache slots\n");
+		return -ENOMEM;
+	}
+
+	rc = spdk_iobuf_channel_init(&rcache_ch->iobuf, "rcache", 0, 0);
+	if (rc != 0) {
+		SPDK_ERRLOG("could not initialize iobuf channel: %s\n", spdk_strerror(-rc));
+		free(rcache_ch->slots);
+		return rc;
+	}
+
+	spdk_iobuf_get_opts(&iobuf_opts, sizeof(iobuf_opts));
+	rcache_ch->max_cached_len = iobuf_opts.large_bufsize;
+
+	rcache_ch->base_ch = spdk_bdev_get_io_channel(rcache_node->base_desc);
+	rcache_ch->hits = 0;
+	rcache_ch->misses = 0;
+
+	return 0;
+}
+
+/* We provide this callback for the SPDK channel code to destroy a channel
+ * created with our create callback.  All cached buffers go back to the iobuf
+ * pool before the iobuf channel is torn down.
+ */
+static void
+rcache_bdev_ch_destroy_cb(void *io_device, void *ctx_buf)
+{
+	struct rcache_io_channel *rcache_ch = ctx_buf;
+	uint32_t slot;
+
+	for (slot = 0; slot < RCACHE_NUM_SLOTS; slot++) {
+		rcache_evict_slot(rcache_ch, &rcache_ch->slots[slot]);
+	}
+	free(rcache_ch->slots);
+	spdk_iobuf_channel_fini(&rcache_ch->iobuf);
+	spdk_put_io_channel(rcache_ch->base_ch);
+}
+
+/* Create the rcache association from the bdev and vbdev name and insert
+ * on the global list. */
+static int
+vbdev_rcache_insert_association(const char *bdev_name, const char *vbdev_name,
+				struct spdk_uuid *uuid)
+{
+	struct bdev_association *assoc;
+
+	TAILQ_FOREACH(assoc, &g_bdev_associations, link) {
+		if (strcmp(vbdev_name, assoc->vbdev_name) == 0) {
+			SPDK_ERRLOG("rcache bdev %s already exists\n", vbdev_name);
+			return -EEXIST;
+		}
+	}
+
+	assoc = calloc(1, sizeof(struct bdev_association));
+	if (!assoc) {
+		SPDK_ERRLOG("could not allocate bdev_association\n");
+		return -ENOMEM;
+	}
+
+	assoc->bdev_name = strdup(bdev_name);
+	if (!assoc->bdev_name) {
+		SPDK_ERRLOG("could not allocate assoc->bdev_name\n");
+		free(assoc);
+		return -ENOMEM;
+	}
+
+	assoc->vbdev_name = strdup(vbdev_name);
+	if (!assoc->vbdev_name) {
+		SPDK_ERRLOG("could not allocate assoc->vbdev_name\n");
+		free(assoc->bdev_name);
+		free(assoc);
+		return -ENOMEM;
+	}
+
+	spdk_uuid_copy(&assoc->uuid, uuid);
+
+	TAILQ_INSERT_TAIL(&g_bdev_associations, assoc, link);
+
+	return 0;
+}
+
+static int
+vbdev_rcache_init(void)
+{
+	return spdk_iobuf_register_module("rcache");
+}
+
+static void
+vbdev_rcache_finish(void)
+{
+	struct bdev_association *assoc;
+
+	while ((assoc = TAILQ_FIRST(&g_bdev_associations))) {
+		TAILQ_REMOVE(&g_bdev_associations, assoc, link);
+		free(assoc->bdev_name);
+		free(assoc->vbdev_name);
+		free(assoc);
+	}
+
+	spdk_iobuf_unregister_module("rcache");
+}
+
+static int
+vbdev_rcache_get_ctx_size(void)
+{
+	return sizeof(struct rcache_bdev_io);
+}
+
+static void
+vbdev_rcache_write_config_json(struct spdk_bdev *bdev, struct spdk_json_write_ctx *w)
+{
+	/* No config per bdev needed */
+}
+
+/* When we register our bdev this is how we specify our entry points. */
+static const struct spdk_bdev_fn_table vbdev_rcache_fn_table = {
+	.destruct		= vbdev_rcache_destruct,
+	.submit_request		= vbdev_rcache_submit_request,
+	.io_type_supported	= vbdev_rcache_io_type_supported,
+	.get_io_channel		= vbdev_rcache_get_io_channel,
+	.dump_info_json		= vbdev_rcache_dump_info_json,
+	.write_config_json	= vbdev_rcache_write_config_json,
+};
+
+static void
+vbdev_rcache_base_bdev_hotremove_cb(struct spdk_bdev *bdev_find)
+{
+	struct vbdev_rcache *rcache_node, *tmp;
+
+	TAILQ_FOREACH_SAFE(rcache_node, &g_rcache_nodes, link, tmp) {
+		if (bdev_find == rcache_node->base_bdev) {
+			spdk_bdev_unregister(&rcache_node->rcache_bdev, NULL, NULL);
+		}
+	}
+}
+
+/* Called when the underlying base bdev triggers asynchronous event such as bdev removal. */
+static void
+vbdev_rcache_base_bdev_event_cb(enum spdk_bdev_event_type type, struct spdk_bdev *bdev,
+				void *event_ctx)
+{
+	switch (type) {
+	case SPDK_BDEV_EVENT_REMOVE:
+		vbdev_rcache_base_bdev_hotremove_cb(bdev);
+		break;
+	default:
+		SPDK_NOTICELOG("Unsupported bdev event: type %d\n", type);
+		break;
+	}
+}
+
+/* Create and register the rcache vbdev if we find it in our list of bdev names.
+ * This can be called either by the examine path or RPC method.
+ */
+static int
+vbdev_rcache_register(const char *bdev_name)
+{
+	struct bdev_association *assoc;
+	struct vbdev_rcache *rcache_node;
+	struct spdk_bdev *bdev;
+	struct spdk_uuid ns_uuid;
+	int rc = 0;
+
+	spdk_uuid_parse(&ns_uuid, BDEV_RCACHE_NAMESPACE_UUID);
+
+	/* Check our list of names from config versus this bdev and if
+	 * there's a match, create the rcache_node & bdev accordingly.
+	 */
+	TAILQ_FOREACH(assoc, &g_bdev_associations, link) {
+		if (strcmp(assoc->bdev_name, bdev_name) != 0) {
+			continue;
+		}
+
+		rcache_node = calloc(1, sizeof(struct vbdev_rcache));
+		if (!rcache_node) {
+			rc = -ENOMEM;
+			SPDK_ERRLOG("could not allocate rcache_node\n");
+			break;
+		}
+		rcache_node->rcache_bdev.name = strdup(assoc->vbdev_name);
+		if (!rcache_node->rcache_bdev.name) {
+			rc = -ENOMEM;
+			SPDK_ERRLOG("could not allocate rcache_bdev name\n");
+			free(rcache_node);
+			break;
+		}
+		rcache_node->rcache_bdev.product_name = "rcache";
+
+		/* The base bdev that we're attaching to. */
+		rc = spdk_bdev_open_ext(bdev_name, true, vbdev_rcache_base_bdev_event_cb,
+					NULL, &rcache_node->base_desc);
+		if (rc) {
+			if (rc != -ENODEV) {
+				SPDK_ERRLOG("could not open bdev %s\n", bdev_name);
+			}
+			free(rcache_node->rcache_bdev.name);
+			free(rcache_node);
+			break;
+		}
+
+		bdev = spdk_bdev_desc_get_bdev(rcache_node->base_desc);
+		rcache_node->base_bdev = bdev;
+
+		rcache_node->rcache_bdev.write_cache = bdev->write_cache;
+		rcache_node->rcache_bdev.required_alignment = bdev->required_alignment;
+		rcache_node->rcache_bdev.optimal_io_boundary = bdev->optimal_io_boundary;
+		rcache_node->rcache_bdev.blocklen = bdev->blocklen;
+		rcache_node->rcache_bdev.blockcnt = bdev->blockcnt;
+
+		rcache_node->rcache_bdev.md_interleave = bdev->md_interleave;
+		rcache_node->rcache_bdev.md_len = bdev->md_len;
+		rcache_node->rcache_bdev.dif_type = bdev->dif_type;
+		rcache_node->rcache_bdev.dif_is_head_of_md = bdev->dif_is_head_of_md;
+		rcache_node->rcache_bdev.dif_check_flags = bdev->dif_check_flags;
+
+		rcache_node->rcache_bdev.ctxt = rcache_node;
+		rcache_node->rcache_bdev.fn_table = &vbdev_rcache_fn_table;
+		rcache_node->rcache_bdev.module = &rcache_if;
+
+		if (spdk_uuid_is_null(&assoc->uuid)) {
+			/* Generate UUID based on namespace UUID + base bdev UUID */
+			rc = spdk_uuid_generate_sha1(&rcache_node->rcache_bdev.uuid, &ns_uuid,
+						     (const char *)&bdev->uuid, sizeof(struct spdk_uuid));
+			if (rc) {
+				spdk_bdev_close(rcache_node->base_desc);
+				free(rcache_node->rcache_bdev.name);
+				free(rcache_node);
+				break;
+			}
+		} else {
+			spdk_uuid_copy(&rcache_node->rcache_bdev.uuid, &assoc->uuid);
+		}
+
+		spdk_io_device_register(rcache_node, rcache_bdev_ch_create_cb, rcache_bdev_ch_destroy_cb,
+					sizeof(struct rcache_io_channel),
+					assoc->vbdev_name);
+
+		/* Save the thread where the base device is opened */
+		rcache_node->thread = spdk_get_thread();
+
+		rc = spdk_bdev_module_claim_bdev(bdev, rcache_node->base_desc, rcache_node->rcache_bdev.module);
+		if (rc) {
+			SPDK_ERRLOG("could not claim bdev %s\n", bdev_name);
+			goto error_close;
+		}
+
+		rc = spdk_bdev_register(&rcache_node->rcache_bdev);
+		if (rc) {
+			SPDK_ERRLOG("could not register rcache_bdev\n");
+			spdk_bdev_module_release_bdev(rcache_node->base_bdev);
+			goto error_close;
+		}
+
+		TAILQ_INSERT_TAIL(&g_rcache_nodes, rcache_node, link);
+	}
+
+	return rc;
+
+error_close:
+	spdk_bdev_close(rcache_node->base_desc);
+	spdk_io_device_unregister(rcache_node, NULL);
+	free(rcache_node->rcache_bdev.name);
+	free(rcache_node);
+	return rc;
+}
+
+int
+create_rcache_disk(const char *bdev_name, const char *vbdev_name, struct spdk_uuid *uuid)
+{
+	int rc = 0;
+
+	rc = vbdev_rcache_insert_association(bdev_name, vbdev_name, uuid);
+	if (rc) {
+		return rc;
+	}
+
+	rc = vbdev_rcache_register(bdev_name);
+	if (rc == -ENODEV) {
+		/* This is not an error, we tracked the name above and it still
+		 * may show up later.
+		 */
+		SPDK_NOTICELOG("vbdev creation deferred pending base bdev arrival\n");
+		rc = 0;
+	}
+
+	return rc;
+}
+
+void
+delete_rcache_disk(const char *vbdev_name, spdk_bdev_unregister_cb cb_fn, void *cb_arg)
+{
+	struct bdev_association *assoc;
+	int rc;
+
+	rc = spdk_bdev_unregister_by_name(vbdev_name, &rcache_if, cb_fn, cb_arg);
+	if (rc == 0) {
+		TAILQ_FOREACH(assoc, &g_bdev_associations, link) {
+			if (strcmp(assoc->vbdev_name, vbdev_name) == 0) {
+				TAILQ_REMOVE(&g_bdev_associations, assoc, link);
+				free(assoc->bdev_name);
+				free(assoc->vbdev_name);
+				free(assoc);
+				break;
+			}
+		}
+	} else {
+		cb_fn(cb_arg, rc);
+	}
+}
+
+static void
+vbdev_rcache_examine(struct spdk_bdev *bdev)
+{
+	vbdev_rcache_register(bdev->name);
+
+	spdk_bdev_module_examine_done(&rcache_if);
+}
+
+SPDK_LOG_REGISTER_COMPONENT(vbdev_rcache)
@@ -0,0 +1,35 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#ifndef SPDK_VBDEV_RCACHE_H
+#define SPDK_VBDEV_RCACHE_H
+
+#include "spdk/stdinc.h"
+
+#include "spdk/bdev.h"
+#include "spdk/bdev_module.h"
+
+/**
+ * Create new read cache bdev.
+ *
+ * \param bdev_name Bdev on which read cache vbdev will be created.
+ * \param vbdev_name Name of the read cache bdev.
+ * \param uuid UUID of the read cache bdev.
+ * \return 0 on success, other on failure.
+ */
+int create_rcache_disk(const char *bdev_name, const char *vbdev_name,
+		       struct spdk_uuid *uuid);
+
+/**
+ * Delete read cache bdev.
+ *
+ * \param vbdev_name Name of the read cache bdev.
+ * \param cb_fn Function to call after deletion.
+ * \param cb_arg Argument to pass to cb_fn.
+ */
+void delete_rcache_disk(const char *vbdev_name, spdk_bdev_unregister_cb cb_fn,
+			void *cb_arg);
+
+#endif /* SPDK_VBDEV_RCACHE_H */
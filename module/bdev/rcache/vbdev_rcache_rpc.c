@@ -0,0 +1,108 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#include "vbdev_rcache.h"
+#include "spdk/rpc.h"
+#include "spdk/util.h"
+#include "spdk/string.h"
+#include "spdk/log.h"
+
+struct rpc_construct_rcache {
+	char *base_bdev_name;
+	char *name;
+	struct spdk_uuid uuid;
+};
+
+static void
+free_rpc_construct_rcache(struct rpc_construct_rcache *r)
+{
+	free(r->base_bdev_name);
+	free(r->name);
+}
+
+static const struct spdk_json_object_decoder rpc_construct_rcache_decoders[] = {
+	{"base_bdev_name", offsetof(struct rpc_construct_rcache, base_bdev_name), spdk_json_decode_string},
+	{"name", offsetof(struct rpc_construct_rcache, name), spdk_json_decode_string},
+	{"uuid", offsetof(struct rpc_construct_rcache, uuid), spdk_json_decode_uuid, true},
+};
+
+static void
+rpc_bdev_rcache_create(struct spdk_jsonrpc_request *request,
+		       const struct spdk_json_val *params)
+{
+	struct rpc_construct_rcache req = {NULL};
+	struct spdk_json_write_ctx *w;
+	int rc;
+
+	if (spdk_json_decode_object(params, rpc_construct_rcache_decoders,
+				    SPDK_COUNTOF(rpc_construct_rcache_decoders),
+				    &req)) {
+		SPDK_DEBUGLOG(vbdev_rcache, "spdk_json_decode_object failed\n");
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "spdk_json_decode_object failed");
+		goto cleanup;
+	}
+
+	rc = create_rcache_disk(req.base_bdev_name, req.name, &req.uuid);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+		goto cleanup;
+	}
+
+	w = spdk_jsonrpc_begin_result(request);
+	spdk_json_write_string(w, req.name);
+	spdk_jsonrpc_end_result(request, w);
+
+cleanup:
+	free_rpc_construct_rcache(&req);
+}
+SPDK_RPC_REGISTER("bdev_rcache_create", rpc_bdev_rcache_create, SPDK_RPC_RUNTIME)
+
+struct rpc_delete_rcache {
+	char *name;
+};
+
+static void
+free_rpc_delete_rcache(struct rpc_delete_rcache *req)
+{
+	free(req->name);
+}
+
+static const struct spdk_json_object_decoder rpc_delete_rcache_decoders[] = {
+	{"name", offsetof(struct rpc_delete_rcache, name), spdk_json_decode_string},
+};
+
+static void
+rpc_bdev_rcache_delete_cb(void *cb_arg, int bdeverrno)
+{
+	struct spdk_jsonrpc_request *request = cb_arg;
+
+	if (bdeverrno == 0) {
+		spdk_jsonrpc_send_bool_response(request, true);
+	} else {
+		spdk_jsonrpc_send_error_response(request, bdeverrno, spdk_strerror(-bdeverrno));
+	}
+}
+
+static void
+rpc_bdev_rcache_delete(struct spdk_jsonrpc_request *request,
+		       const struct spdk_json_val *params)
+{
+	struct rpc_delete_rcache req = {NULL};
+
+	if (spdk_json_decode_object(params, rpc_delete_rcache_decoders,
+				    SPDK_COUNTOF(rpc_delete_rcache_decoders),
+				    &req)) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
+						 "spdk_json_decode_object failed");
+		goto cleanup;
+	}
+
+	delete_rcache_disk(req.name, rpc_bdev_rcache_delete_cb, request);
+
+cleanup:
+	free_rpc_delete_rcache(&req);
+}
+SPDK_RPC_REGISTER("bdev_rcache_delete", rpc_bdev_rcache_delete, SPDK_RPC_RUNTIME)
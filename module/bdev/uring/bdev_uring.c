@@ -31,8 +31,18 @@ struct bdev_uring_zoned_dev {
 	uint32_t		lba_shift;
 };
 
+/* Size of the registered file table of each group ring.  Slots are handed
+ * out to uring bdev channels as they are created and recycled when they are
+ * destroyed, so this only bounds the number of uring bdevs used from one
+ * thread at the same time. */
+#define SPDK_URING_MAX_REG_FILES 256
+
 struct bdev_uring_io_channel {
 	struct bdev_uring_group_channel		*group_ch;
+
+	/* Slot of this bdev's fd in the group ring's registered file table,
+	 * or -1 when fixed files are not available. */
+	int					reg_fd_idx;
 };
 
 struct bdev_uring_group_channel {
@@ -40,6 +50,8 @@ struct bdev_uring_group_channel {
 	uint64_t				io_pending;
 	struct spdk_poller			*poller;
 	struct io_uring				uring;
+	bool					reg_files;
+	bool					file_slot_used[SPDK_URING_MAX_REG_FILES];
 };
 
 struct bdev_uring_task {
@@ -186,7 +198,13 @@ bdev_uring_readv(struct bdev_uring *uring, struct spdk_io_channel *ch,
 		return -ENOMEM;
 	}
 
-	io_uring_prep_readv(sqe, uring->fd, iov, iovcnt, offset);
+	if (uring_ch->reg_fd_idx >= 0) {
+		/* Skip the per-I/O fd lookup and refcount in the kernel. */
+		io_uring_prep_readv(sqe, uring_ch->reg_fd_idx, iov, iovcnt, offset);
+		sqe->flags |= IOSQE_FIXED_FILE;
+	} else {
+		io_uring_prep_readv(sqe, uring->fd, iov, iovcnt, offset);
+	}
 	io_uring_sqe_set_data(sqe, uring_task);
 	uring_task->len = nbytes;
 	uring_task->ch = uring_ch;
@@ -213,7 +231,12 @@ bdev_uring_writev(struct bdev_uring *uring, struct spdk_io_channel *ch,
 		return -ENOMEM;
 	}
 
-	io_uring_prep_writev(sqe, uring->fd, iov, iovcnt, offset);
+	if (uring_ch->reg_fd_idx >= 0) {
+		io_uring_prep_writev(sqe, uring_ch->reg_fd_idx, iov, iovcnt, offset);
+		sqe->flags |= IOSQE_FIXED_FILE;
+	} else {
+		io_uring_prep_writev(sqe, uring->fd, iov, iovcnt, offset);
+	}
 	io_uring_sqe_set_data(sqe, uring_task);
 	uring_task->len = nbytes;
 	uring_task->ch = uring_ch;
@@ -697,9 +720,33 @@ bdev_uring_io_type_supported(void *ctx, enum spdk_bdev_io_type io_type)
 static int
 bdev_uring_create_cb(void *io_device, void *ctx_buf)
 {
+	struct bdev_uring *uring = io_device;
 	struct bdev_uring_io_channel *ch = ctx_buf;
+	struct bdev_uring_group_channel *group_ch;
+	uint32_t i;
 
 	ch->group_ch = spdk_io_channel_get_ctx(spdk_get_io_channel(&uring_if));
+	ch->reg_fd_idx = -1;
+
+	group_ch = ch->group_ch;
+	if (!group_ch->reg_files) {
+		return 0;
+	}
+
+	for (i = 0; i < SPDK_URING_MAX_REG_FILES; i++) {
+		if (!group_ch->file_slot_used[i]) {
+			break;
+		}
+	}
+	if (i == SPDK_URING_MAX_REG_FILES) {
+		/* Table full - fall back to plain fds for this channel. */
+		return 0;
+	}
+
+	if (io_uring_register_files_update(&group_ch->uring, i, &uring->fd, 1) == 1) {
+		group_ch->file_slot_used[i] = true;
+		ch->reg_fd_idx = i;
+	}
 
 	return 0;
 }
@@ -708,6 +755,13 @@ static void
 bdev_uring_destroy_cb(void *io_device, void *ctx_buf)
 {
 	struct bdev_uring_io_channel *ch = ctx_buf;
+	int fd = -1;
+
+	if (ch->reg_fd_idx >= 0) {
+		io_uring_register_files_update(&ch->group_ch->uring, ch->reg_fd_idx, &fd, 1);
+		ch->group_ch->file_slot_used[ch->reg_fd_idx] = false;
+		ch->reg_fd_idx = -1;
+	}
 
 	spdk_put_io_channel(spdk_io_channel_from_ctx(ch->group_ch));
 }
@@ -779,6 +833,7 @@ static int
 bdev_uring_group_create_cb(void *io_device, void *ctx_buf)
 {
 	struct bdev_uring_group_channel *ch = ctx_buf;
+	int fds[SPDK_URING_MAX_REG_FILES];
 
 	/* Do not use IORING_SETUP_IOPOLL until the Linux kernel can support not only
 	 * local devices but also devices attached from remote target */
@@ -787,6 +842,16 @@ bdev_uring_group_create_cb(void *io_device, void *ctx_buf)
 		return -1;
 	}
 
+	/* Register a table of empty file slots so that bdev fds can be added
+	 * and removed as channels come and go.  Not supported on older
+	 * kernels, in which case the module keeps using plain fds. */
+	memset(fds, 0xff, sizeof(fds));
+	if (io_uring_register_files(&ch->uring, fds, SPDK_URING_MAX_REG_FILES) == 0) {
+		ch->reg_files = true;
+	} else {
+		SPDK_DEBUGLOG(uring, "fixed file registration unavailable\n");
+	}
+
 	ch->poller = SPDK_POLLER_REGISTER(bdev_uring_group_poll, ch, 0);
 	return 0;
 }
@@ -796,6 +861,10 @@ bdev_uring_group_destroy_cb(void *io_device, void *ctx_buf)
 {
 	struct bdev_uring_group_channel *ch = ctx_buf;
 
+	if (ch->reg_files) {
+		io_uring_unregister_files(&ch->uring);
+	}
+
 	io_uring_queue_exit(&ch->uring);
 
 	spdk_poller_unregister(&ch->poller);
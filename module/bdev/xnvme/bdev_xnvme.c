@@ -39,6 +39,7 @@ struct bdev_xnvme {
 	struct xnvme_dev	*dev;
 	uint32_t		nsid;
 	bool			conserve_cpu;
+	bool			poll_sq;
 
 	TAILQ_ENTRY(bdev_xnvme) link;
 };
@@ -69,6 +70,7 @@ bdev_xnvme_config_json(struct spdk_json_write_ctx *w)
 		spdk_json_write_named_string(w, "filename", xnvme->filename);
 		spdk_json_write_named_string(w, "io_mechanism", xnvme->io_mechanism);
 		spdk_json_write_named_bool(w, "conserve_cpu", xnvme->conserve_cpu);
+		spdk_json_write_named_bool(w, "poll_sq", xnvme->poll_sq);
 		spdk_json_write_object_end(w);
 
 		spdk_json_write_object_end(w);
@@ -322,7 +324,7 @@ bdev_xnvme_queue_destroy_cb(void *io_device, void *ctx_buf)
 
 struct spdk_bdev *
 create_xnvme_bdev(const char *name, const char *filename, const char *io_mechanism,
-		  bool conserve_cpu)
+		  bool conserve_cpu, bool poll_sq)
 {
 	struct bdev_xnvme *xnvme;
 	uint32_t block_size;
@@ -345,6 +347,7 @@ create_xnvme_bdev(const char *name, const char *filename, const char *io_mechani
 	if (!xnvme->io_mechanism) {
 		goto error_return;
 	}
+	xnvme->conserve_cpu = conserve_cpu;
 
 	if (!conserve_cpu) {
 		if (!strcmp(xnvme->io_mechanism, "libaio")) {
@@ -356,6 +359,28 @@ create_xnvme_bdev(const char *name, const char *filename, const char *io_mechani
 		}
 	}
 
+	if (poll_sq) {
+		if (strcmp(xnvme->io_mechanism, "io_uring") != 0 &&
+		    strcmp(xnvme->io_mechanism, "io_uring_cmd") != 0) {
+			SPDK_ERRLOG("poll_sq is only supported with io_uring and io_uring_cmd\n");
+			goto error_return;
+		}
+		if (conserve_cpu) {
+			SPDK_ERRLOG("poll_sq cannot be combined with conserve_cpu\n");
+			goto error_return;
+		}
+
+		/* Hand submission-queue reaping to a kernel SQPOLL thread and
+		 * pin the files and buffers up front.  Together with the
+		 * io_uring_cmd passthrough this keeps the whole data path out
+		 * of the kernel block layer.
+		 */
+		opts.poll_sq = 1;
+		opts.register_files = 1;
+		opts.register_buffers = 1;
+	}
+	xnvme->poll_sq = poll_sq;
+
 	xnvme->filename = strdup(filename);
 	if (!xnvme->filename) {
 		goto error_return;
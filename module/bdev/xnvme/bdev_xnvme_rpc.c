@@ -16,6 +16,7 @@ struct rpc_create_xnvme {
 	char *filename;
 	char *io_mechanism;
 	bool conserve_cpu;
+	bool poll_sq;
 };
 
 /* Free the allocated memory resource after the RPC handling. */
@@ -33,6 +34,7 @@ static const struct spdk_json_object_decoder rpc_create_xnvme_decoders[] = {
 	{"filename", offsetof(struct rpc_create_xnvme, filename), spdk_json_decode_string},
 	{"io_mechanism", offsetof(struct rpc_create_xnvme, io_mechanism), spdk_json_decode_string},
 	{"conserve_cpu", offsetof(struct rpc_create_xnvme, conserve_cpu), spdk_json_decode_bool, true},
+	{"poll_sq", offsetof(struct rpc_create_xnvme, poll_sq), spdk_json_decode_bool, true},
 };
 
 /* Decode the parameters for this RPC method and properly create the xnvme
@@ -55,7 +57,8 @@ rpc_bdev_xnvme_create(struct spdk_jsonrpc_request *request,
 		goto cleanup;
 	}
 
-	bdev = create_xnvme_bdev(req.name, req.filename, req.io_mechanism, req.conserve_cpu);
+	bdev = create_xnvme_bdev(req.name, req.filename, req.io_mechanism, req.conserve_cpu,
+				 req.poll_sq);
 	if (!bdev) {
 		SPDK_ERRLOG("Unable to create xNVMe bdev from file %s\n", req.filename);
 		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INTERNAL_ERROR,
@@ -0,0 +1,1278 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+/* A light zone translation layer: exposes a conventional (random-write) bdev
+ * on top of a zoned base bdev. Writes are logged with zone appends into the
+ * currently open log zone and an in-memory block-granularity remap table
+ * translates logical to physical blocks on the read path. A background
+ * greedy garbage collector migrates the remaining live blocks out of the
+ * fullest-invalidated zones and resets them once empty, keeping a
+ * configurable reserve of empty zones available for new writes.
+ *
+ * This sits between the zone_block emulation (which goes the other way) and
+ * the full FTL in lib/ftl: no persistent L2P, no write buffer, no
+ * power-fail recovery - the mapping lives only as long as the vbdev does.
+ * That makes it suitable for scratch, cache and other rebuildable data on
+ * cheap ZNS drives, at a fraction of the FTL's footprint.
+ */
+
+#include "spdk/stdinc.h"
+
+#include "vbdev_zone_remap.h"
+
+#include "spdk/bdev_zone.h"
+#include "spdk/env.h"
+#include "spdk/string.h"
+#include "spdk/util.h"
+
+#include "spdk/log.h"
+
+/* This namespace UUID was generated using uuid_generate() method. */
+#define BDEV_ZONE_REMAP_NAMESPACE_UUID "a47d1f5c-20cb-4bde-9f0d-8b2c66e12f11"
+
+#define ZR_LBA_UNMAPPED		UINT64_MAX
+#define ZR_DEFAULT_RESERVED_ZONES 2
+/* Live blocks migrated per gc step and period of the gc poller. */
+#define ZR_GC_BATCH_BLOCKS	32
+#define ZR_GC_POLL_PERIOD_US	1000
+
+static int zone_remap_init(void);
+static int zone_remap_get_ctx_size(void);
+static void zone_remap_finish(void);
+static int zone_remap_config_json(struct spdk_json_write_ctx *w);
+static void zone_remap_examine(struct spdk_bdev *bdev);
+
+static struct spdk_bdev_module bdev_zone_remap_if = {
+	.name = "bdev_zone_remap",
+	.module_init = zone_remap_init,
+	.module_fini = zone_remap_finish,
+	.config_json = zone_remap_config_json,
+	.examine_config = zone_remap_examine,
+	.get_ctx_size = zone_remap_get_ctx_size,
+};
+
+SPDK_BDEV_MODULE_REGISTER(bdev_zone_remap, &bdev_zone_remap_if)
+
+/* List of remap vbdev names and their base bdevs via configuration file.
+ * Used so we can parse the conf once at init and use this list in examine().
+ */
+struct bdev_zone_remap_config {
+	char					*vbdev_name;
+	char					*bdev_name;
+	uint64_t				zone_capacity;
+	uint32_t				reserved_zones;
+	TAILQ_ENTRY(bdev_zone_remap_config)	link;
+};
+static TAILQ_HEAD(, bdev_zone_remap_config) g_zr_configs = TAILQ_HEAD_INITIALIZER(g_zr_configs);
+
+enum zr_zone_state {
+	ZR_ZONE_EMPTY = 0,
+	ZR_ZONE_OPEN,
+	ZR_ZONE_FULL,
+};
+
+struct zr_zone {
+	uint64_t		slba;	/* first physical block of the zone */
+	uint64_t		next;	/* next physical block to be reserved for an append */
+	uint64_t		valid;	/* number of live mapped blocks */
+	uint64_t		pending; /* appends reserved but not yet completed */
+	uint64_t		readers; /* read extents in flight against this zone */
+	enum zr_zone_state	state;
+};
+
+struct zr_gc {
+	bool			running; /* a migration step is in flight */
+	bool			failed;
+	struct zr_zone		*victim;
+	struct zr_zone		*append_zone;
+	uint32_t		count;
+	uint32_t		outstanding;
+	uint64_t		lbas[ZR_GC_BATCH_BLOCKS];
+	uint64_t		plbas[ZR_GC_BATCH_BLOCKS];
+	void			*buf;	/* bounce buffer for migrated blocks */
+	struct iovec		iov;
+};
+
+/* List of remap vbdevs and associated info for each. */
+struct vbdev_zone_remap {
+	struct spdk_bdev		bdev;	/* the conventional vbdev */
+	struct spdk_bdev_desc		*base_desc; /* its descriptor we get from open */
+	uint64_t			*l2p;	/* logical block -> physical block */
+	struct zr_zone			*zones;	/* array of physical zones */
+	uint64_t			num_zones;
+	uint64_t			zone_size; /* physical zone size of the base bdev */
+	uint64_t			zone_capacity; /* writable blocks per zone */
+	uint32_t			reserved_zones; /* zones held back for gc */
+	uint64_t			empty_zones;
+	struct zr_zone			*active; /* current log zone, NULL if none open */
+	pthread_spinlock_t		lock;	/* protects l2p, zones, active, empty_zones */
+	struct zr_gc			gc;
+	struct spdk_io_channel		*gc_ch;
+	struct spdk_poller		*gc_poller;
+	bool				shutdown;
+	bool				pending_destruct;
+	TAILQ_ENTRY(vbdev_zone_remap)	link;
+	struct spdk_thread		*thread; /* thread where base device is opened */
+};
+static TAILQ_HEAD(, vbdev_zone_remap) g_zr_nodes = TAILQ_HEAD_INITIALIZER(g_zr_nodes);
+
+struct zone_remap_io_channel {
+	struct spdk_io_channel	*base_ch; /* IO channel of base device */
+};
+
+struct zone_remap_bdev_io {
+	int			status;	/* aggregate status of child IOs */
+	uint32_t		outstanding; /* child IOs in flight */
+	struct zr_zone		*zone;	/* zone reserved for a write's append */
+};
+
+/* Physical extent of a read after translation. phys == ZR_LBA_UNMAPPED marks
+ * a hole, which reads back as zeroes.
+ */
+struct zr_extent {
+	uint64_t	phys;
+	uint64_t	start;	/* offset in blocks from the start of the request */
+	uint64_t	num;
+};
+
+struct zr_read_child {
+	struct spdk_bdev_io	*orig_io;
+	struct zr_zone		*zone;
+	struct iovec		*iovs;
+};
+
+static void zr_gc_finish_step(struct vbdev_zone_remap *node);
+
+static int
+zone_remap_init(void)
+{
+	return 0;
+}
+
+static void
+zone_remap_remove_config(struct bdev_zone_remap_config *name)
+{
+	TAILQ_REMOVE(&g_zr_configs, name, link);
+	free(name->bdev_name);
+	free(name->vbdev_name);
+	free(name);
+}
+
+static void
+zone_remap_finish(void)
+{
+	struct bdev_zone_remap_config *name;
+
+	while ((name = TAILQ_FIRST(&g_zr_configs))) {
+		zone_remap_remove_config(name);
+	}
+}
+
+static int
+zone_remap_get_ctx_size(void)
+{
+	return sizeof(struct zone_remap_bdev_io);
+}
+
+static int
+zone_remap_config_json(struct spdk_json_write_ctx *w)
+{
+	struct vbdev_zone_remap *node;
+	struct spdk_bdev *base_bdev;
+
+	TAILQ_FOREACH(node, &g_zr_nodes, link) {
+		base_bdev = spdk_bdev_desc_get_bdev(node->base_desc);
+		spdk_json_write_object_begin(w);
+		spdk_json_write_named_string(w, "method", "bdev_zone_remap_create");
+		spdk_json_write_named_object_begin(w, "params");
+		spdk_json_write_named_string(w, "base_bdev", spdk_bdev_get_name(base_bdev));
+		spdk_json_write_named_string(w, "name", spdk_bdev_get_name(&node->bdev));
+		spdk_json_write_named_uint64(w, "zone_capacity", node->zone_capacity);
+		spdk_json_write_named_uint32(w, "reserved_zones", node->reserved_zones);
+		spdk_json_write_object_end(w);
+		spdk_json_write_object_end(w);
+	}
+
+	return 0;
+}
+
+/* Callback for unregistering the IO device. */
+static void
+_device_unregister_cb(void *io_device)
+{
+	struct vbdev_zone_remap *node = io_device;
+
+	free(node->bdev.name);
+	pthread_spin_destroy(&node->lock);
+	spdk_free(node->gc.buf);
+	free(node->zones);
+	free(node->l2p);
+	free(node);
+}
+
+static void
+zr_destruct_finish(struct vbdev_zone_remap *node)
+{
+	spdk_poller_unregister(&node->gc_poller);
+	spdk_put_io_channel(node->gc_ch);
+	spdk_bdev_close(node->base_desc);
+	spdk_io_device_unregister(node, _device_unregister_cb);
+	spdk_bdev_destruct_done(&node->bdev, 0);
+}
+
+static void
+_zone_remap_destruct_msg(void *ctx)
+{
+	struct vbdev_zone_remap *node = ctx;
+
+	if (node->gc.running) {
+		/* The in-flight gc step finishes the destruct. */
+		node->pending_destruct = true;
+		return;
+	}
+
+	zr_destruct_finish(node);
+}
+
+static int
+zone_remap_destruct(void *ctx)
+{
+	struct vbdev_zone_remap *node = ctx;
+
+	TAILQ_REMOVE(&g_zr_nodes, node, link);
+
+	/* Unclaim the underlying bdev. */
+	spdk_bdev_module_release_bdev(spdk_bdev_desc_get_bdev(node->base_desc));
+
+	node->shutdown = true;
+
+	/* Tear down on the thread where the base device was opened, once any
+	 * in-flight gc step has drained.
+	 */
+	if (node->thread && node->thread != spdk_get_thread()) {
+		spdk_thread_send_msg(node->thread, _zone_remap_destruct_msg, node);
+	} else {
+		_zone_remap_destruct_msg(node);
+	}
+
+	return 1;
+}
+
+static struct zr_zone *
+zr_zone_of(struct vbdev_zone_remap *node, uint64_t phys)
+{
+	return &node->zones[phys / node->zone_size];
+}
+
+/* Reserve num_blocks of log space and return the zone to append to, or NULL
+ * if no empty zone may be opened. The last empty zone is held back for gc so
+ * the collector can always make forward progress. Caller holds node->lock.
+ */
+static struct zr_zone *
+zr_alloc_blocks(struct vbdev_zone_remap *node, uint64_t num_blocks, bool for_gc)
+{
+	struct zr_zone *zone = node->active;
+	uint64_t i;
+
+	assert(num_blocks <= node->zone_capacity);
+
+	if (zone != NULL && zone->next + num_blocks > zone->slba + node->zone_capacity) {
+		/* The blocks between next and the zone capacity were never
+		 * written; they stay invalid until the zone is reclaimed.
+		 */
+		zone->state = ZR_ZONE_FULL;
+		zone = node->active = NULL;
+	}
+
+	if (zone == NULL) {
+		if (node->empty_zones == 0 || (!for_gc && node->empty_zones == 1)) {
+			return NULL;
+		}
+		for (i = 0; i < node->num_zones; i++) {
+			if (node->zones[i].state == ZR_ZONE_EMPTY) {
+				zone = &node->zones[i];
+				break;
+			}
+		}
+		assert(zone != NULL);
+		zone->state = ZR_ZONE_OPEN;
+		zone->next = zone->slba;
+		node->empty_zones--;
+		node->active = zone;
+	}
+
+	zone->next += num_blocks;
+	zone->pending++;
+	if (zone->next == zone->slba + node->zone_capacity) {
+		zone->state = ZR_ZONE_FULL;
+		node->active = NULL;
+	}
+
+	return zone;
+}
+
+static void
+_zone_remap_complete_append(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct spdk_bdev_io *orig_io = cb_arg;
+	struct vbdev_zone_remap *node = SPDK_CONTAINEROF(orig_io->bdev, struct vbdev_zone_remap, bdev);
+	struct zone_remap_bdev_io *io_ctx = (struct zone_remap_bdev_io *)orig_io->driver_ctx;
+	uint64_t lba = orig_io->u.bdev.offset_blocks;
+	uint64_t num = orig_io->u.bdev.num_blocks;
+	uint64_t phys, old, i;
+
+	pthread_spin_lock(&node->lock);
+	io_ctx->zone->pending--;
+	if (success) {
+		phys = bdev_io->u.bdev.offset_blocks;
+		for (i = 0; i < num; i++) {
+			old = node->l2p[lba + i];
+			node->l2p[lba + i] = phys + i;
+			zr_zone_of(node, phys + i)->valid++;
+			if (old != ZR_LBA_UNMAPPED) {
+				zr_zone_of(node, old)->valid--;
+			}
+		}
+	}
+	pthread_spin_unlock(&node->lock);
+
+	spdk_bdev_io_complete(orig_io, success ? SPDK_BDEV_IO_STATUS_SUCCESS :
+			      SPDK_BDEV_IO_STATUS_FAILED);
+	spdk_bdev_free_io(bdev_io);
+}
+
+static int
+zone_remap_write(struct vbdev_zone_remap *node, struct zone_remap_io_channel *ch,
+		 struct spdk_bdev_io *bdev_io)
+{
+	struct zone_remap_bdev_io *io_ctx = (struct zone_remap_bdev_io *)bdev_io->driver_ctx;
+	uint64_t num = bdev_io->u.bdev.num_blocks;
+	struct zr_zone *zone;
+	int rc;
+
+	if (num > node->zone_capacity) {
+		/* split_on_optimal_io_boundary keeps writes within a zone */
+		return -EINVAL;
+	}
+
+	pthread_spin_lock(&node->lock);
+	zone = zr_alloc_blocks(node, num, false);
+	pthread_spin_unlock(&node->lock);
+	if (zone == NULL) {
+		/* Out of log space until gc reclaims a zone. */
+		return -ENOMEM;
+	}
+	io_ctx->zone = zone;
+
+	rc = spdk_bdev_zone_appendv(node->base_desc, ch->base_ch,
+				    bdev_io->u.bdev.iovs, bdev_io->u.bdev.iovcnt,
+				    zone->slba, num,
+				    _zone_remap_complete_append, bdev_io);
+	if (rc != 0) {
+		/* The reserved blocks are wasted; gc reclaims them with the zone. */
+		pthread_spin_lock(&node->lock);
+		zone->pending--;
+		pthread_spin_unlock(&node->lock);
+	}
+
+	return rc;
+}
+
+/* Build an iovec array covering len bytes of src starting at offset bytes.
+ * Returns the number of entries written to dst (at most src_cnt).
+ */
+static int
+zr_iov_slice(const struct iovec *src, int src_cnt, uint64_t offset, uint64_t len,
+	     struct iovec *dst)
+{
+	uint64_t take;
+	int i, cnt = 0;
+
+	for (i = 0; i < src_cnt && len > 0; i++) {
+		if (offset >= src[i].iov_len) {
+			offset -= src[i].iov_len;
+			continue;
+		}
+		take = spdk_min(len, src[i].iov_len - offset);
+		dst[cnt].iov_base = (char *)src[i].iov_base + offset;
+		dst[cnt].iov_len = take;
+		cnt++;
+		len -= take;
+		offset = 0;
+	}
+	assert(len == 0);
+
+	return cnt;
+}
+
+static void
+zr_iov_memset_zero(const struct iovec *iovs, int iovcnt, uint64_t offset, uint64_t len)
+{
+	uint64_t take;
+	int i;
+
+	for (i = 0; i < iovcnt && len > 0; i++) {
+		if (offset >= iovs[i].iov_len) {
+			offset -= iovs[i].iov_len;
+			continue;
+		}
+		take = spdk_min(len, iovs[i].iov_len - offset);
+		memset((char *)iovs[i].iov_base + offset, 0, take);
+		len -= take;
+		offset = 0;
+	}
+	assert(len == 0);
+}
+
+static void
+_zone_remap_complete_read(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct zr_read_child *child = cb_arg;
+	struct spdk_bdev_io *orig_io = child->orig_io;
+	struct vbdev_zone_remap *node = SPDK_CONTAINEROF(orig_io->bdev, struct vbdev_zone_remap, bdev);
+	struct zone_remap_bdev_io *io_ctx = (struct zone_remap_bdev_io *)orig_io->driver_ctx;
+
+	pthread_spin_lock(&node->lock);
+	child->zone->readers--;
+	pthread_spin_unlock(&node->lock);
+
+	if (!success) {
+		io_ctx->status = SPDK_BDEV_IO_STATUS_FAILED;
+	}
+	free(child->iovs);
+	free(child);
+	spdk_bdev_free_io(bdev_io);
+
+	if (--io_ctx->outstanding == 0) {
+		spdk_bdev_io_complete(orig_io, io_ctx->status);
+	}
+}
+
+/* Translate the logical range into physical extents. The extent list is built
+ * under the lock and each mapped extent takes a reader reference on its zone,
+ * which keeps gc from resetting the zone underneath an in-flight read.
+ * Extents never span a zone boundary. Caller holds node->lock.
+ */
+static uint32_t
+zr_build_extents(struct vbdev_zone_remap *node, uint64_t lba, uint64_t num,
+		 struct zr_extent *extents)
+{
+	uint32_t cnt = 0;
+	uint64_t i = 0, start, phys;
+
+	while (i < num) {
+		start = i;
+		phys = node->l2p[lba + i];
+		i++;
+		if (phys == ZR_LBA_UNMAPPED) {
+			while (i < num && node->l2p[lba + i] == ZR_LBA_UNMAPPED) {
+				i++;
+			}
+		} else {
+			while (i < num && node->l2p[lba + i] == phys + (i - start) &&
+			       (phys + (i - start)) / node->zone_size == phys / node->zone_size) {
+				i++;
+			}
+			zr_zone_of(node, phys)->readers++;
+		}
+		extents[cnt].phys = phys;
+		extents[cnt].start = start;
+		extents[cnt].num = i - start;
+		cnt++;
+	}
+
+	return cnt;
+}
+
+static int
+zone_remap_read(struct vbdev_zone_remap *node, struct zone_remap_io_channel *ch,
+		struct spdk_bdev_io *bdev_io)
+{
+	struct zone_remap_bdev_io *io_ctx = (struct zone_remap_bdev_io *)bdev_io->driver_ctx;
+	uint64_t lba = bdev_io->u.bdev.offset_blocks;
+	uint64_t num = bdev_io->u.bdev.num_blocks;
+	uint32_t blocklen = node->bdev.blocklen;
+	struct zr_extent *extents;
+	struct zr_read_child *child;
+	uint32_t cnt, i;
+	int iovcnt, rc = 0;
+
+	extents = malloc(num * sizeof(*extents));
+	if (extents == NULL) {
+		return -ENOMEM;
+	}
+
+	pthread_spin_lock(&node->lock);
+	cnt = zr_build_extents(node, lba, num, extents);
+	pthread_spin_unlock(&node->lock);
+
+	io_ctx->status = SPDK_BDEV_IO_STATUS_SUCCESS;
+	/* Hold a reference while submitting so a fast child completion cannot
+	 * complete the parent before all extents have been issued.
+	 */
+	io_ctx->outstanding = 1;
+
+	for (i = 0; i < cnt; i++) {
+		if (extents[i].phys == ZR_LBA_UNMAPPED) {
+			zr_iov_memset_zero(bdev_io->u.bdev.iovs, bdev_io->u.bdev.iovcnt,
+					   extents[i].start * blocklen, extents[i].num * blocklen);
+			continue;
+		}
+
+		child = calloc(1, sizeof(*child));
+		if (child != NULL) {
+			child->iovs = calloc(bdev_io->u.bdev.iovcnt, sizeof(struct iovec));
+		}
+		if (child == NULL || child->iovs == NULL) {
+			free(child);
+			rc = -ENOMEM;
+		} else {
+			child->orig_io = bdev_io;
+			child->zone = zr_zone_of(node, extents[i].phys);
+			iovcnt = zr_iov_slice(bdev_io->u.bdev.iovs, bdev_io->u.bdev.iovcnt,
+					      extents[i].start * blocklen, extents[i].num * blocklen,
+					      child->iovs);
+			io_ctx->outstanding++;
+			rc = spdk_bdev_readv_blocks(node->base_desc, ch->base_ch,
+						    child->iovs, iovcnt,
+						    extents[i].phys, extents[i].num,
+						    _zone_remap_complete_read, child);
+			if (rc != 0) {
+				io_ctx->outstanding--;
+				free(child->iovs);
+				free(child);
+			}
+		}
+
+		if (rc != 0) {
+			break;
+		}
+	}
+
+	if (rc != 0) {
+		/* Drop the reader references of the extents that were not issued. */
+		pthread_spin_lock(&node->lock);
+		for (; i < cnt; i++) {
+			if (extents[i].phys != ZR_LBA_UNMAPPED) {
+				zr_zone_of(node, extents[i].phys)->readers--;
+			}
+		}
+		pthread_spin_unlock(&node->lock);
+	}
+	free(extents);
+
+	if (rc != 0) {
+		if (io_ctx->outstanding == 1) {
+			/* Nothing was issued, let the caller retry or fail. */
+			io_ctx->outstanding = 0;
+			return rc;
+		}
+		io_ctx->status = SPDK_BDEV_IO_STATUS_FAILED;
+	}
+
+	if (--io_ctx->outstanding == 0) {
+		spdk_bdev_io_complete(bdev_io, io_ctx->status);
+	}
+
+	return 0;
+}
+
+static int
+zone_remap_unmap(struct vbdev_zone_remap *node, struct spdk_bdev_io *bdev_io)
+{
+	uint64_t lba = bdev_io->u.bdev.offset_blocks;
+	uint64_t num = bdev_io->u.bdev.num_blocks;
+	uint64_t old, i;
+
+	pthread_spin_lock(&node->lock);
+	for (i = 0; i < num; i++) {
+		old = node->l2p[lba + i];
+		if (old != ZR_LBA_UNMAPPED) {
+			zr_zone_of(node, old)->valid--;
+			node->l2p[lba + i] = ZR_LBA_UNMAPPED;
+		}
+	}
+	pthread_spin_unlock(&node->lock);
+
+	spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_SUCCESS);
+	return 0;
+}
+
+static void
+_zone_remap_complete_flush(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct spdk_bdev_io *orig_io = cb_arg;
+
+	spdk_bdev_io_complete(orig_io, success ? SPDK_BDEV_IO_STATUS_SUCCESS :
+			      SPDK_BDEV_IO_STATUS_FAILED);
+	spdk_bdev_free_io(bdev_io);
+}
+
+static int
+zone_remap_flush(struct vbdev_zone_remap *node, struct zone_remap_io_channel *ch,
+		 struct spdk_bdev_io *bdev_io)
+{
+	struct spdk_bdev *base_bdev = spdk_bdev_desc_get_bdev(node->base_desc);
+
+	/* The logical range has no meaning on the base device, flush it whole. */
+	return spdk_bdev_flush_blocks(node->base_desc, ch->base_ch, 0,
+				      spdk_bdev_get_num_blocks(base_bdev),
+				      _zone_remap_complete_flush, bdev_io);
+}
+
+static void
+zone_remap_read_get_buf_cb(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io,
+			   bool success)
+{
+	struct vbdev_zone_remap *node = SPDK_CONTAINEROF(bdev_io->bdev, struct vbdev_zone_remap, bdev);
+	struct zone_remap_io_channel *dev_ch = spdk_io_channel_get_ctx(ch);
+	int rc;
+
+	if (!success) {
+		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED);
+		return;
+	}
+
+	rc = zone_remap_read(node, dev_ch, bdev_io);
+	if (rc == -ENOMEM) {
+		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_NOMEM);
+	} else if (rc != 0) {
+		spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED);
+	}
+}
+
+static void
+zone_remap_submit_request(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io)
+{
+	struct vbdev_zone_remap *node = SPDK_CONTAINEROF(bdev_io->bdev, struct vbdev_zone_remap, bdev);
+	struct zone_remap_io_channel *dev_ch = spdk_io_channel_get_ctx(ch);
+	int rc = 0;
+
+	switch (bdev_io->type) {
+	case SPDK_BDEV_IO_TYPE_READ:
+		spdk_bdev_io_get_buf(bdev_io, zone_remap_read_get_buf_cb,
+				     bdev_io->u.bdev.num_blocks * node->bdev.blocklen);
+		return;
+	case SPDK_BDEV_IO_TYPE_WRITE:
+		rc = zone_remap_write(node, dev_ch, bdev_io);
+		break;
+	case SPDK_BDEV_IO_TYPE_UNMAP:
+		rc = zone_remap_unmap(node, bdev_io);
+		break;
+	case SPDK_BDEV_IO_TYPE_FLUSH:
+		rc = zone_remap_flush(node, dev_ch, bdev_io);
+		break;
+	default:
+		SPDK_ERRLOG("vbdev_zone_remap: unknown I/O type %u\n", bdev_io->type);
+		rc = -ENOTSUP;
+		break;
+	}
+
+	if (rc != 0) {
+		if (rc == -ENOMEM) {
+			spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_NOMEM);
+		} else {
+			spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_FAILED);
+		}
+	}
+}
+
+static bool
+zone_remap_io_type_supported(void *ctx, enum spdk_bdev_io_type io_type)
+{
+	struct vbdev_zone_remap *node = ctx;
+
+	switch (io_type) {
+	case SPDK_BDEV_IO_TYPE_READ:
+	case SPDK_BDEV_IO_TYPE_WRITE:
+	case SPDK_BDEV_IO_TYPE_UNMAP:
+		return true;
+	case SPDK_BDEV_IO_TYPE_FLUSH:
+		return spdk_bdev_io_type_supported(spdk_bdev_desc_get_bdev(node->base_desc),
+						   SPDK_BDEV_IO_TYPE_FLUSH);
+	default:
+		return false;
+	}
+}
+
+static struct spdk_io_channel *
+zone_remap_get_io_channel(void *ctx)
+{
+	struct vbdev_zone_remap *node = ctx;
+
+	return spdk_get_io_channel(node);
+}
+
+static int
+zone_remap_dump_info_json(void *ctx, struct spdk_json_write_ctx *w)
+{
+	struct vbdev_zone_remap *node = ctx;
+	struct spdk_bdev *base_bdev = spdk_bdev_desc_get_bdev(node->base_desc);
+
+	spdk_json_write_name(w, "zone_remap");
+	spdk_json_write_object_begin(w);
+	spdk_json_write_named_string(w, "name", spdk_bdev_get_name(&node->bdev));
+	spdk_json_write_named_string(w, "base_bdev", spdk_bdev_get_name(base_bdev));
+	spdk_json_write_named_uint64(w, "zone_capacity", node->zone_capacity);
+	spdk_json_write_named_uint32(w, "reserved_zones", node->reserved_zones);
+	spdk_json_write_named_uint64(w, "empty_zones", node->empty_zones);
+	spdk_json_write_object_end(w);
+
+	return 0;
+}
+
+/* When we register our vbdev this is how we specify our entry points. */
+static const struct spdk_bdev_fn_table zone_remap_fn_table = {
+	.destruct		= zone_remap_destruct,
+	.submit_request		= zone_remap_submit_request,
+	.io_type_supported	= zone_remap_io_type_supported,
+	.get_io_channel		= zone_remap_get_io_channel,
+	.dump_info_json		= zone_remap_dump_info_json,
+};
+
+/* Garbage collection. Runs on node->thread with its own channel. One step
+ * migrates up to ZR_GC_BATCH_BLOCKS live blocks from the fullest-invalidated
+ * FULL zone into the log, then resets the zone once nothing live remains.
+ */
+
+static void
+_zr_gc_reset_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct vbdev_zone_remap *node = cb_arg;
+	struct zr_zone *victim = node->gc.victim;
+
+	spdk_bdev_free_io(bdev_io);
+
+	if (success) {
+		pthread_spin_lock(&node->lock);
+		victim->state = ZR_ZONE_EMPTY;
+		victim->next = victim->slba;
+		node->empty_zones++;
+		pthread_spin_unlock(&node->lock);
+	}
+
+	zr_gc_finish_step(node);
+}
+
+static void
+zr_gc_reset_victim(struct vbdev_zone_remap *node)
+{
+	int rc;
+
+	rc = spdk_bdev_zone_management(node->base_desc, node->gc_ch,
+				       node->gc.victim->slba, SPDK_BDEV_ZONE_RESET,
+				       _zr_gc_reset_done, node);
+	if (rc != 0) {
+		zr_gc_finish_step(node);
+	}
+}
+
+static void
+_zr_gc_append_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct vbdev_zone_remap *node = cb_arg;
+	struct zr_zone *victim = node->gc.victim;
+	uint64_t phys, lba;
+	uint32_t i;
+	bool reset = false;
+
+	pthread_spin_lock(&node->lock);
+	node->gc.append_zone->pending--;
+	if (success) {
+		phys = bdev_io->u.bdev.offset_blocks;
+		for (i = 0; i < node->gc.count; i++) {
+			lba = node->gc.lbas[i];
+			if (node->l2p[lba] == node->gc.plbas[i]) {
+				node->l2p[lba] = phys + i;
+				zr_zone_of(node, phys + i)->valid++;
+				victim->valid--;
+			}
+			/* else the block was overwritten or unmapped while it
+			 * was being migrated and the copy is already dead.
+			 */
+		}
+		reset = victim->valid == 0 && victim->pending == 0 && victim->readers == 0;
+	}
+	pthread_spin_unlock(&node->lock);
+
+	spdk_bdev_free_io(bdev_io);
+
+	if (reset) {
+		zr_gc_reset_victim(node);
+	} else {
+		zr_gc_finish_step(node);
+	}
+}
+
+static void
+zr_gc_step_done(struct vbdev_zone_remap *node)
+{
+	struct zr_zone *zone;
+	int rc;
+
+	if (node->gc.failed || node->shutdown) {
+		zr_gc_finish_step(node);
+		return;
+	}
+
+	pthread_spin_lock(&node->lock);
+	zone = zr_alloc_blocks(node, node->gc.count, true);
+	pthread_spin_unlock(&node->lock);
+	if (zone == NULL) {
+		zr_gc_finish_step(node);
+		return;
+	}
+	node->gc.append_zone = zone;
+
+	node->gc.iov.iov_base = node->gc.buf;
+	node->gc.iov.iov_len = (uint64_t)node->gc.count * node->bdev.blocklen;
+	rc = spdk_bdev_zone_appendv(node->base_desc, node->gc_ch, &node->gc.iov, 1,
+				    zone->slba, node->gc.count,
+				    _zr_gc_append_done, node);
+	if (rc != 0) {
+		pthread_spin_lock(&node->lock);
+		zone->pending--;
+		pthread_spin_unlock(&node->lock);
+		zr_gc_finish_step(node);
+	}
+}
+
+static void
+_zr_gc_read_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	struct vbdev_zone_remap *node = cb_arg;
+
+	spdk_bdev_free_io(bdev_io);
+
+	if (!success) {
+		node->gc.failed = true;
+	}
+	if (--node->gc.outstanding == 0) {
+		zr_gc_step_done(node);
+	}
+}
+
+static void
+zr_gc_finish_step(struct vbdev_zone_remap *node)
+{
+	node->gc.victim = NULL;
+	node->gc.append_zone = NULL;
+	node->gc.running = false;
+
+	if (node->pending_destruct) {
+		zr_destruct_finish(node);
+	}
+}
+
+static int
+zone_remap_gc_poll(void *arg)
+{
+	struct vbdev_zone_remap *node = arg;
+	struct zr_zone *victim = NULL, *zone;
+	uint32_t blocklen = node->bdev.blocklen;
+	uint32_t count = 0, i;
+	uint64_t lba, phys;
+	int rc;
+
+	if (node->gc.running || node->shutdown) {
+		return SPDK_POLLER_IDLE;
+	}
+
+	pthread_spin_lock(&node->lock);
+	if (node->empty_zones > node->reserved_zones) {
+		pthread_spin_unlock(&node->lock);
+		return SPDK_POLLER_IDLE;
+	}
+
+	for (i = 0; i < node->num_zones; i++) {
+		zone = &node->zones[i];
+		if (zone->state != ZR_ZONE_FULL || zone->pending != 0) {
+			continue;
+		}
+		if (victim == NULL || zone->valid < victim->valid) {
+			victim = zone;
+		}
+	}
+	if (victim == NULL || (victim->valid == 0 && victim->readers != 0)) {
+		pthread_spin_unlock(&node->lock);
+		return SPDK_POLLER_IDLE;
+	}
+
+	if (victim->valid > 0) {
+		for (lba = 0; lba < node->bdev.blockcnt && count < ZR_GC_BATCH_BLOCKS; lba++) {
+			phys = node->l2p[lba];
+			if (phys != ZR_LBA_UNMAPPED && zr_zone_of(node, phys) == victim) {
+				node->gc.lbas[count] = lba;
+				node->gc.plbas[count] = phys;
+				count++;
+			}
+		}
+	}
+	node->gc.victim = victim;
+	node->gc.count = count;
+	node->gc.failed = false;
+	node->gc.running = true;
+	pthread_spin_unlock(&node->lock);
+
+	if (count == 0) {
+		zr_gc_reset_victim(node);
+		return SPDK_POLLER_BUSY;
+	}
+
+	node->gc.outstanding = count;
+	for (i = 0; i < count; i++) {
+		rc = spdk_bdev_read_blocks(node->base_desc, node->gc_ch,
+					   (char *)node->gc.buf + (uint64_t)i * blocklen,
+					   node->gc.plbas[i], 1,
+					   _zr_gc_read_done, node);
+		if (rc != 0) {
+			node->gc.failed = true;
+			node->gc.outstanding -= count - i;
+			break;
+		}
+	}
+	if (node->gc.outstanding == 0) {
+		zr_gc_step_done(node);
+	}
+
+	return SPDK_POLLER_BUSY;
+}
+
+static void
+zone_remap_base_bdev_hotremove_cb(struct spdk_bdev *bdev_find)
+{
+	struct vbdev_zone_remap *node, *tmp;
+
+	TAILQ_FOREACH_SAFE(node, &g_zr_nodes, link, tmp) {
+		if (bdev_find == spdk_bdev_desc_get_bdev(node->base_desc)) {
+			spdk_bdev_unregister(&node->bdev, NULL, NULL);
+		}
+	}
+}
+
+static void
+zone_remap_base_bdev_event_cb(enum spdk_bdev_event_type type, struct spdk_bdev *bdev,
+			      void *event_ctx)
+{
+	switch (type) {
+	case SPDK_BDEV_EVENT_REMOVE:
+		zone_remap_base_bdev_hotremove_cb(bdev);
+		break;
+	default:
+		SPDK_NOTICELOG("Unsupported bdev event: type %d\n", type);
+		break;
+	}
+}
+
+static int
+_zone_remap_ch_create_cb(void *io_device, void *ctx_buf)
+{
+	struct zone_remap_io_channel *bdev_ch = ctx_buf;
+	struct vbdev_zone_remap *node = io_device;
+
+	bdev_ch->base_ch = spdk_bdev_get_io_channel(node->base_desc);
+	if (!bdev_ch->base_ch) {
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static void
+_zone_remap_ch_destroy_cb(void *io_device, void *ctx_buf)
+{
+	struct zone_remap_io_channel *bdev_ch = ctx_buf;
+
+	spdk_put_io_channel(bdev_ch->base_ch);
+}
+
+static int
+zone_remap_insert_name(const char *bdev_name, const char *vbdev_name, uint64_t zone_capacity,
+		       uint32_t reserved_zones)
+{
+	struct bdev_zone_remap_config *name;
+
+	TAILQ_FOREACH(name, &g_zr_configs, link) {
+		if (strcmp(vbdev_name, name->vbdev_name) == 0) {
+			SPDK_ERRLOG("zone remap bdev %s already exists\n", vbdev_name);
+			return -EEXIST;
+		}
+		if (strcmp(bdev_name, name->bdev_name) == 0) {
+			SPDK_ERRLOG("base bdev %s already claimed\n", bdev_name);
+			return -EEXIST;
+		}
+	}
+
+	name = calloc(1, sizeof(*name));
+	if (!name) {
+		SPDK_ERRLOG("could not allocate bdev_names\n");
+		return -ENOMEM;
+	}
+
+	name->bdev_name = strdup(bdev_name);
+	if (!name->bdev_name) {
+		SPDK_ERRLOG("could not allocate name->bdev_name\n");
+		free(name);
+		return -ENOMEM;
+	}
+
+	name->vbdev_name = strdup(vbdev_name);
+	if (!name->vbdev_name) {
+		SPDK_ERRLOG("could not allocate name->vbdev_name\n");
+		free(name->bdev_name);
+		free(name);
+		return -ENOMEM;
+	}
+
+	name->zone_capacity = zone_capacity;
+	name->reserved_zones = reserved_zones;
+
+	TAILQ_INSERT_TAIL(&g_zr_configs, name, link);
+
+	return 0;
+}
+
+static int
+zone_remap_register(const char *base_bdev_name)
+{
+	struct spdk_bdev_desc *base_desc;
+	struct spdk_bdev *base_bdev;
+	struct bdev_zone_remap_config *name, *tmp;
+	struct vbdev_zone_remap *node;
+	struct spdk_uuid ns_uuid;
+	uint64_t zone_size, zone_capacity, num_zones, i;
+	uint32_t reserved_zones;
+	int rc = 0;
+
+	spdk_uuid_parse(&ns_uuid, BDEV_ZONE_REMAP_NAMESPACE_UUID);
+
+	/* Check our list of names from config versus this bdev and if
+	 * there's a match, create the node & bdev accordingly.
+	 */
+	TAILQ_FOREACH_SAFE(name, &g_zr_configs, link, tmp) {
+		if (strcmp(name->bdev_name, base_bdev_name) != 0) {
+			continue;
+		}
+
+		rc = spdk_bdev_open_ext(base_bdev_name, true, zone_remap_base_bdev_event_cb,
+					NULL, &base_desc);
+		if (rc == -ENODEV) {
+			return -ENODEV;
+		} else if (rc) {
+			SPDK_ERRLOG("could not open bdev %s\n", base_bdev_name);
+			goto free_config;
+		}
+
+		base_bdev = spdk_bdev_desc_get_bdev(base_desc);
+
+		if (!spdk_bdev_is_zoned(base_bdev)) {
+			SPDK_ERRLOG("Base bdev %s is not a zoned bdev\n", base_bdev_name);
+			rc = -EINVAL;
+			goto not_zoned;
+		}
+
+		zone_size = spdk_bdev_get_zone_size(base_bdev);
+		num_zones = spdk_bdev_get_num_zones(base_bdev);
+		zone_capacity = name->zone_capacity ? name->zone_capacity : zone_size;
+		reserved_zones = name->reserved_zones ? name->reserved_zones :
+				 ZR_DEFAULT_RESERVED_ZONES;
+
+		if (zone_capacity > zone_size || num_zones <= reserved_zones + 1) {
+			SPDK_ERRLOG("invalid zone capacity or too few zones on %s\n",
+				    base_bdev_name);
+			rc = -EINVAL;
+			goto not_zoned;
+		}
+
+		node = calloc(1, sizeof(struct vbdev_zone_remap));
+		if (!node) {
+			rc = -ENOMEM;
+			SPDK_ERRLOG("could not allocate zone remap node\n");
+			goto not_zoned;
+		}
+
+		node->base_desc = base_desc;
+
+		node->bdev.name = strdup(name->vbdev_name);
+		if (!node->bdev.name) {
+			rc = -ENOMEM;
+			SPDK_ERRLOG("could not allocate node name\n");
+			goto strdup_failed;
+		}
+
+		node->zone_size = zone_size;
+		node->zone_capacity = zone_capacity;
+		node->num_zones = num_zones;
+		node->reserved_zones = reserved_zones;
+		node->empty_zones = num_zones;
+
+		node->bdev.product_name = "zone_remap";
+		node->bdev.write_cache = base_bdev->write_cache;
+		node->bdev.required_alignment = base_bdev->required_alignment;
+		node->bdev.blocklen = base_bdev->blocklen;
+		node->bdev.blockcnt = (num_zones - reserved_zones) * zone_capacity;
+
+		/* Keep every write within a single zone so it maps to one append. */
+		node->bdev.optimal_io_boundary = zone_capacity;
+		node->bdev.split_on_optimal_io_boundary = true;
+
+		node->bdev.ctxt = node;
+		node->bdev.fn_table = &zone_remap_fn_table;
+		node->bdev.module = &bdev_zone_remap_if;
+
+		/* Generate UUID based on namespace UUID + base bdev UUID. */
+		rc = spdk_uuid_generate_sha1(&node->bdev.uuid, &ns_uuid,
+					     (const char *)&base_bdev->uuid, sizeof(struct spdk_uuid));
+		if (rc) {
+			SPDK_ERRLOG("Unable to generate new UUID for zone remap bdev\n");
+			goto uuid_generation_failed;
+		}
+
+		node->l2p = malloc(node->bdev.blockcnt * sizeof(*node->l2p));
+		if (!node->l2p) {
+			rc = -ENOMEM;
+			SPDK_ERRLOG("could not allocate remap table\n");
+			goto uuid_generation_failed;
+		}
+		memset(node->l2p, 0xff, node->bdev.blockcnt * sizeof(*node->l2p));
+
+		node->zones = calloc(num_zones, sizeof(*node->zones));
+		if (!node->zones) {
+			rc = -ENOMEM;
+			SPDK_ERRLOG("could not allocate zones\n");
+			goto zones_failed;
+		}
+		for (i = 0; i < num_zones; i++) {
+			node->zones[i].slba = i * zone_size;
+			node->zones[i].next = node->zones[i].slba;
+			node->zones[i].state = ZR_ZONE_EMPTY;
+		}
+
+		node->gc.buf = spdk_zmalloc((uint64_t)ZR_GC_BATCH_BLOCKS * node->bdev.blocklen,
+					    0x1000, NULL, SPDK_ENV_SOCKET_ID_ANY, SPDK_MALLOC_DMA);
+		if (!node->gc.buf) {
+			rc = -ENOMEM;
+			SPDK_ERRLOG("could not allocate gc buffer\n");
+			goto gc_buf_failed;
+		}
+
+		if (pthread_spin_init(&node->lock, PTHREAD_PROCESS_PRIVATE)) {
+			rc = -ENOMEM;
+			SPDK_ERRLOG("pthread_spin_init() failed\n");
+			goto spin_init_failed;
+		}
+
+		TAILQ_INSERT_TAIL(&g_zr_nodes, node, link);
+
+		spdk_io_device_register(node, _zone_remap_ch_create_cb, _zone_remap_ch_destroy_cb,
+					sizeof(struct zone_remap_io_channel),
+					name->vbdev_name);
+
+		/* Save the thread where the base device is opened */
+		node->thread = spdk_get_thread();
+
+		node->gc_ch = spdk_bdev_get_io_channel(base_desc);
+		if (!node->gc_ch) {
+			rc = -ENOMEM;
+			SPDK_ERRLOG("could not get gc io channel\n");
+			goto gc_ch_failed;
+		}
+
+		node->gc_poller = SPDK_POLLER_REGISTER(zone_remap_gc_poll, node,
+						       ZR_GC_POLL_PERIOD_US);
+
+		rc = spdk_bdev_module_claim_bdev(base_bdev, base_desc, node->bdev.module);
+		if (rc) {
+			SPDK_ERRLOG("could not claim bdev %s\n", base_bdev_name);
+			goto claim_failed;
+		}
+
+		rc = spdk_bdev_register(&node->bdev);
+		if (rc) {
+			SPDK_ERRLOG("could not register zone remap bdev\n");
+			goto register_failed;
+		}
+	}
+
+	return rc;
+
+register_failed:
+	spdk_bdev_module_release_bdev(spdk_bdev_desc_get_bdev(node->base_desc));
+claim_failed:
+	spdk_poller_unregister(&node->gc_poller);
+	spdk_put_io_channel(node->gc_ch);
+gc_ch_failed:
+	TAILQ_REMOVE(&g_zr_nodes, node, link);
+	spdk_io_device_unregister(node, NULL);
+	pthread_spin_destroy(&node->lock);
+spin_init_failed:
+	spdk_free(node->gc.buf);
+gc_buf_failed:
+	free(node->zones);
+zones_failed:
+	free(node->l2p);
+uuid_generation_failed:
+	free(node->bdev.name);
+strdup_failed:
+	free(node);
+not_zoned:
+	spdk_bdev_close(base_desc);
+free_config:
+	zone_remap_remove_config(name);
+	return rc;
+}
+
+int
+vbdev_zone_remap_create(const char *bdev_name, const char *vbdev_name, uint64_t zone_capacity,
+			uint32_t reserved_zones)
+{
+	int rc;
+
+	/* Insert the bdev into our global name list even if it doesn't exist yet,
+	 * it may show up soon...
+	 */
+	rc = zone_remap_insert_name(bdev_name, vbdev_name, zone_capacity, reserved_zones);
+	if (rc) {
+		return rc;
+	}
+
+	rc = zone_remap_register(bdev_name);
+	if (rc == -ENODEV) {
+		/* This is not an error, even though the bdev is not present at this time it may
+		 * still show up later.
+		 */
+		rc = 0;
+	}
+	return rc;
+}
+
+void
+vbdev_zone_remap_delete(const char *name, spdk_bdev_unregister_cb cb_fn, void *cb_arg)
+{
+	struct bdev_zone_remap_config *name_node;
+	int rc;
+
+	rc = spdk_bdev_unregister_by_name(name, &bdev_zone_remap_if, cb_fn, cb_arg);
+	if (rc == 0) {
+		TAILQ_FOREACH(name_node, &g_zr_configs, link) {
+			if (strcmp(name_node->vbdev_name, name) == 0) {
+				zone_remap_remove_config(name_node);
+				break;
+			}
+		}
+	} else {
+		cb_fn(cb_arg, rc);
+	}
+}
+
+static void
+zone_remap_examine(struct spdk_bdev *bdev)
+{
+	zone_remap_register(bdev->name);
+
+	spdk_bdev_module_examine_done(&bdev_zone_remap_if);
+}
+
+SPDK_LOG_REGISTER_COMPONENT(vbdev_zone_remap)
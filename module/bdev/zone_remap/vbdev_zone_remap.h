@@ -0,0 +1,19 @@
+/*   SPDX-License-Identifier: BSD-3-Clause
+ *   Copyright (C) 2024 Intel Corporation.
+ *   All rights reserved.
+ */
+
+#ifndef SPDK_VBDEV_ZONE_REMAP_H
+#define SPDK_VBDEV_ZONE_REMAP_H
+
+#include "spdk/stdinc.h"
+
+#include "spdk/bdev.h"
+#include "spdk/bdev_module.h"
+
+int vbdev_zone_remap_create(const char *bdev_name, const char *vbdev_name,
+			    uint64_t zone_capacity, uint32_t reserved_zones);
+
+void vbdev_zone_remap_delete(const char *name, spdk_bdev_unregister_cb cb_fn, void *cb_arg);
+
+#endif /* SPDK_VBDEV_ZONE_REMAP_H */
@@ -10,7 +10,7 @@
 #include "spdk_internal/init.h"
 
 static void
-iobuf_subsystem_initialize(void)
+iobuf_subsystem_initialize(struct spdk_subsystem *subsystem)
 {
 	int rc;
 
@@ -19,7 +19,7 @@ iobuf_subsystem_initialize(void)
 		SPDK_ERRLOG("Failed to initialize iobuf\n");
 	}
 
-	spdk_subsystem_init_next(rc);
+	spdk_subsystem_init_done(subsystem, rc);
 }
 
 static void
@@ -51,6 +51,10 @@ iobuf_write_config_json(struct spdk_json_write_ctx *w)
 	spdk_json_write_named_uint64(w, "large_pool_count", opts.large_pool_count);
 	spdk_json_write_named_uint32(w, "small_bufsize", opts.small_bufsize);
 	spdk_json_write_named_uint32(w, "large_bufsize", opts.large_bufsize);
+	spdk_json_write_named_bool(w, "enable_numa", opts.enable_numa);
+	spdk_json_write_named_uint32(w, "cache_rebalance_period_us", opts.cache_rebalance_period_us);
+	spdk_json_write_named_uint64(w, "small_pool_max_count", opts.small_pool_max_count);
+	spdk_json_write_named_uint64(w, "large_pool_max_count", opts.large_pool_max_count);
 	spdk_json_write_object_end(w);
 	spdk_json_write_object_end(w);
 
@@ -59,7 +63,7 @@ iobuf_write_config_json(struct spdk_json_write_ctx *w)
 
 static struct spdk_subsystem g_subsystem_iobuf = {
 	.name = "iobuf",
-	.init = iobuf_subsystem_initialize,
+	.init_async = iobuf_subsystem_initialize,
 	.fini = iobuf_subsystem_finish,
 	.write_config_json = iobuf_write_config_json,
 };
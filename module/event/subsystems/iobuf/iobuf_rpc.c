@@ -4,6 +4,7 @@
  */
 
 #include "spdk/stdinc.h"
+#include "spdk/env.h"
 #include "spdk/thread.h"
 #include "spdk/rpc.h"
 #include "spdk/string.h"
@@ -14,6 +15,11 @@ static const struct spdk_json_object_decoder rpc_iobuf_set_options_decoders[] =
 	{"large_pool_count", offsetof(struct spdk_iobuf_opts, large_pool_count), spdk_json_decode_uint64, true},
 	{"small_bufsize", offsetof(struct spdk_iobuf_opts, small_bufsize), spdk_json_decode_uint32, true},
 	{"large_bufsize", offsetof(struct spdk_iobuf_opts, large_bufsize), spdk_json_decode_uint32, true},
+	{"enable_numa", offsetof(struct spdk_iobuf_opts, enable_numa), spdk_json_decode_bool, true},
+	{"cache_rebalance_period_us", offsetof(struct spdk_iobuf_opts, cache_rebalance_period_us), spdk_json_decode_uint32, true},
+	{"small_pool_max_count", offsetof(struct spdk_iobuf_opts, small_pool_max_count), spdk_json_decode_uint64, true},
+	{"large_pool_max_count", offsetof(struct spdk_iobuf_opts, large_pool_max_count), spdk_json_decode_uint64, true},
+	{"cache_idle_reclaim_us", offsetof(struct spdk_iobuf_opts, cache_idle_reclaim_us), spdk_json_decode_uint32, true},
 };
 
 static void
@@ -41,6 +47,70 @@ rpc_iobuf_set_options(struct spdk_jsonrpc_request *request, const struct spdk_js
 }
 SPDK_RPC_REGISTER("iobuf_set_options", rpc_iobuf_set_options, SPDK_RPC_STARTUP)
 
+struct rpc_iobuf_pool_grow {
+	uint64_t small_pool_count;
+	uint64_t large_pool_count;
+	int32_t numa_node;
+};
+
+static const struct spdk_json_object_decoder rpc_iobuf_pool_grow_decoders[] = {
+	{"small_pool_count", offsetof(struct rpc_iobuf_pool_grow, small_pool_count), spdk_json_decode_uint64, true},
+	{"large_pool_count", offsetof(struct rpc_iobuf_pool_grow, large_pool_count), spdk_json_decode_uint64, true},
+	{"numa_node", offsetof(struct rpc_iobuf_pool_grow, numa_node), spdk_json_decode_int32, true},
+};
+
+static void
+rpc_iobuf_pool_grow(struct spdk_jsonrpc_request *request, const struct spdk_json_val *params)
+{
+	struct rpc_iobuf_pool_grow req = {
+		.numa_node = SPDK_ENV_SOCKET_ID_ANY,
+	};
+	int rc;
+
+	if (params != NULL &&
+	    spdk_json_decode_object(params, rpc_iobuf_pool_grow_decoders,
+				    SPDK_COUNTOF(rpc_iobuf_pool_grow_decoders), &req)) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+						 "spdk_json_decode_object failed");
+		return;
+	}
+
+	rc = spdk_iobuf_pool_grow(req.small_pool_count, req.large_pool_count, req.numa_node);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+		return;
+	}
+
+	spdk_jsonrpc_send_bool_response(request, true);
+}
+SPDK_RPC_REGISTER("iobuf_pool_grow", rpc_iobuf_pool_grow, SPDK_RPC_RUNTIME)
+
+static void
+rpc_iobuf_pool_shrink(struct spdk_jsonrpc_request *request, const struct spdk_json_val *params)
+{
+	struct rpc_iobuf_pool_grow req = {
+		.numa_node = SPDK_ENV_SOCKET_ID_ANY,
+	};
+	int rc;
+
+	if (params != NULL &&
+	    spdk_json_decode_object(params, rpc_iobuf_pool_grow_decoders,
+				    SPDK_COUNTOF(rpc_iobuf_pool_grow_decoders), &req)) {
+		spdk_jsonrpc_send_error_response(request, SPDK_JSONRPC_ERROR_INVALID_PARAMS,
+						 "spdk_json_decode_object failed");
+		return;
+	}
+
+	rc = spdk_iobuf_pool_shrink(req.small_pool_count, req.large_pool_count, req.numa_node);
+	if (rc != 0) {
+		spdk_jsonrpc_send_error_response(request, rc, spdk_strerror(-rc));
+		return;
+	}
+
+	spdk_jsonrpc_send_bool_response(request, true);
+}
+SPDK_RPC_REGISTER("iobuf_pool_shrink", rpc_iobuf_pool_shrink, SPDK_RPC_RUNTIME)
+
 static void
 rpc_iobuf_get_stats_done(struct spdk_iobuf_module_stats *modules, uint32_t num_modules,
 			 void *cb_arg)
@@ -63,12 +133,16 @@ rpc_iobuf_get_stats_done(struct spdk_iobuf_module_stats *modules, uint32_t num_m
 		spdk_json_write_named_uint64(w, "cache", it->small_pool.cache);
 		spdk_json_write_named_uint64(w, "main", it->small_pool.main);
 		spdk_json_write_named_uint64(w, "retry", it->small_pool.retry);
+		spdk_json_write_named_uint64(w, "cache_count", it->small_pool.cache_count);
+		spdk_json_write_named_uint64(w, "cache_size", it->small_pool.cache_size);
 		spdk_json_write_object_end(w);
 
 		spdk_json_write_named_object_begin(w, "large_pool");
 		spdk_json_write_named_uint64(w, "cache", it->large_pool.cache);
 		spdk_json_write_named_uint64(w, "main", it->large_pool.main);
 		spdk_json_write_named_uint64(w, "retry", it->large_pool.retry);
+		spdk_json_write_named_uint64(w, "cache_count", it->large_pool.cache_count);
+		spdk_json_write_named_uint64(w, "cache_size", it->large_pool.cache_size);
 		spdk_json_write_object_end(w);
 
 		spdk_json_write_object_end(w);
@@ -7,11 +7,11 @@
 #include "spdk_internal/init.h"
 
 static void
-keyring_subsystem_init(void)
+keyring_subsystem_init(struct spdk_subsystem *subsystem)
 {
 	int rc = spdk_keyring_init();
 
-	spdk_subsystem_init_next(rc);
+	spdk_subsystem_init_done(subsystem, rc);
 }
 
 static void
@@ -31,7 +31,7 @@ keyring_subsystem_write_config_json(struct spdk_json_write_ctx *w)
 
 static struct spdk_subsystem g_subsystem_keyring = {
 	.name = "keyring",
-	.init = keyring_subsystem_init,
+	.init_async = keyring_subsystem_init,
 	.fini = keyring_subsystem_fini,
 	.write_config_json = keyring_subsystem_write_config_json,
 };
@@ -10,7 +10,7 @@
 #include "spdk/log.h"
 
 static void
-sock_subsystem_init(void)
+sock_subsystem_init(struct spdk_subsystem *subsystem)
 {
 	const char *sock_impl_override = getenv("SPDK_SOCK_IMPL_DEFAULT");
 	int rc = 0;
@@ -27,7 +27,7 @@ sock_subsystem_init(void)
 		}
 	}
 
-	spdk_subsystem_init_next(rc);
+	spdk_subsystem_init_done(subsystem, rc);
 }
 
 static void
@@ -44,7 +44,7 @@ sock_subsystem_write_config_json(struct spdk_json_write_ctx *w)
 
 static struct spdk_subsystem g_spdk_subsystem_sock = {
 	.name = "sock",
-	.init = sock_subsystem_init,
+	.init_async = sock_subsystem_init,
 	.fini = sock_subsystem_fini,
 	.write_config_json = sock_subsystem_write_config_json,
 };
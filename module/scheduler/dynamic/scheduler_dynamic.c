@@ -11,6 +11,7 @@
 
 #include "spdk/thread.h"
 #include "spdk_internal/event.h"
+#include "spdk_internal/thread.h"
 #include "spdk/scheduler.h"
 #include "spdk_internal/usdt.h"
 
@@ -19,7 +20,13 @@ static uint32_t g_main_lcore;
 struct core_stats {
 	uint64_t busy;
 	uint64_t idle;
+	/* Poller runs on this core that reported work done. */
+	uint64_t busy_runs;
 	uint32_t thread_count;
+	/* Number of active latency-sensitive threads on this core. */
+	uint32_t latency_threads;
+	/* Number of active threads without the latency-sensitive hint. */
+	uint32_t background_threads;
 };
 
 static struct core_stats *g_cores;
@@ -27,6 +34,12 @@ static struct core_stats *g_cores;
 uint8_t g_scheduler_load_limit = 20;
 uint8_t g_scheduler_core_limit = 80;
 uint8_t g_scheduler_core_busy = 95;
+/* Minimum number of poller runs reporting work per scheduling period for the
+ * main core to be considered doing useful work. Pollers that always report
+ * themselves busy can make a core polling empty queues look fully loaded in
+ * busy_tsc terms, so with a non-zero limit frequency is only raised when
+ * actual work gets done. Zero keeps the busy_tsc-only behavior. */
+uint32_t g_scheduler_busy_runs_limit = 0;
 
 static uint8_t
 _busy_pct(uint64_t busy, uint64_t idle)
@@ -50,6 +63,31 @@ _get_thread_load(struct spdk_scheduler_thread_info *thread_info)
 	return _busy_pct(busy, idle);
 }
 
+static bool
+_is_thread_active(struct spdk_scheduler_thread_info *thread_info)
+{
+	return _get_thread_load(thread_info) >= g_scheduler_load_limit;
+}
+
+/* Keep active latency-sensitive threads and active threads without the hint
+ * apart: neither kind is moved onto a core already running the other.
+ */
+static bool
+_cores_colocation_conflict(struct spdk_scheduler_thread_info *thread_info, uint32_t lcore)
+{
+	struct core_stats *core = &g_cores[lcore];
+
+	if (!_is_thread_active(thread_info)) {
+		return false;
+	}
+
+	if (thread_info->latency_sensitive) {
+		return core->background_threads > 0;
+	}
+
+	return core->latency_threads > 0;
+}
+
 typedef void (*_foreach_fn)(struct spdk_scheduler_thread_info *thread_info);
 
 static void
@@ -84,12 +122,14 @@ _move_thread(struct spdk_scheduler_thread_info *thread_info, uint32_t dst_core)
 
 	dst->busy += spdk_min(UINT64_MAX - dst->busy, busy_tsc);
 	dst->idle -= spdk_min(dst->idle, busy_tsc);
+	dst->busy_runs += thread_info->current_stats.busy_poller_runs;
 	dst->thread_count++;
 
 	/* Adjust busy/idle from core as if thread was not present on it.
 	 * Core load will reflect the sum of all remaining threads on it. */
 	src->busy -= spdk_min(src->busy, busy_tsc);
 	src->idle += spdk_min(UINT64_MAX - src->idle, busy_tsc);
+	src->busy_runs -= spdk_min(src->busy_runs, thread_info->current_stats.busy_poller_runs);
 
 	if (busy_pct >= g_scheduler_core_busy &&
 	    _busy_pct(src->busy, src->idle) < g_scheduler_core_limit) {
@@ -110,6 +150,18 @@ _move_thread(struct spdk_scheduler_thread_info *thread_info, uint32_t dst_core)
 	assert(src->thread_count > 0);
 	src->thread_count--;
 
+	if (_is_thread_active(thread_info)) {
+		if (thread_info->latency_sensitive) {
+			assert(src->latency_threads > 0);
+			src->latency_threads--;
+			dst->latency_threads++;
+		} else {
+			assert(src->background_threads > 0);
+			src->background_threads--;
+			dst->background_threads++;
+		}
+	}
+
 	thread_info->lcore = dst_core;
 }
 
@@ -198,6 +250,11 @@ _find_optimal_core(struct spdk_scheduler_thread_info *thread_info)
 			continue;
 		}
 
+		/* Do not colocate latency-sensitive and background threads. */
+		if (i != current_lcore && _cores_colocation_conflict(thread_info, i)) {
+			continue;
+		}
+
 		/* Search for least busy core. */
 		if (g_cores[i].busy < g_cores[least_busy_lcore].busy) {
 			least_busy_lcore = i;
@@ -244,17 +301,41 @@ init(void)
 		return -ENOMEM;
 	}
 
+	/* Attribute core load to individual pollers (visible through the
+	 * thread_get_pollers RPC) while the dynamic scheduler is active.
+	 */
+	spdk_thread_enable_poller_cycle_tracking(true);
+
 	return 0;
 }
 
 static void
 deinit(void)
 {
+	spdk_thread_enable_poller_cycle_tracking(false);
 	free(g_cores);
 	g_cores = NULL;
 	spdk_governor_set(NULL);
 }
 
+static void
+_count_active_threads(struct spdk_scheduler_thread_info *thread_info)
+{
+	struct core_stats *core = &g_cores[thread_info->lcore];
+
+	core->busy_runs += thread_info->current_stats.busy_poller_runs;
+
+	if (!_is_thread_active(thread_info)) {
+		return;
+	}
+
+	if (thread_info->latency_sensitive) {
+		core->latency_threads++;
+	} else {
+		core->background_threads++;
+	}
+}
+
 static void
 _balance_idle(struct spdk_scheduler_thread_info *thread_info)
 {
@@ -296,10 +377,15 @@ balance(struct spdk_scheduler_core_info *cores_info, uint32_t cores_count)
 		g_cores[i].thread_count = cores_info[i].threads_count;
 		g_cores[i].busy = cores_info[i].current_busy_tsc;
 		g_cores[i].idle = cores_info[i].current_idle_tsc;
+		g_cores[i].busy_runs = 0;
+		g_cores[i].latency_threads = 0;
+		g_cores[i].background_threads = 0;
 		SPDK_DTRACE_PROBE2(dynsched_core_info, i, &cores_info[i]);
 	}
 	main_core = &g_cores[g_main_lcore];
 
+	_foreach_thread(cores_info, _count_active_threads);
+
 	/* Distribute threads in two passes, to make sure updated core stats are considered on each pass.
 	 * 1) Move all idle threads to main core. */
 	_foreach_thread(cores_info, _balance_idle);
@@ -337,7 +423,9 @@ balance(struct spdk_scheduler_core_info *cores_info, uint32_t cores_count)
 		if (rc < 0) {
 			SPDK_ERRLOG("setting default frequency for core %u failed\n", g_main_lcore);
 		}
-	} else if (main_core->busy > main_core->idle) {
+	} else if (main_core->busy > main_core->idle &&
+		   (g_scheduler_busy_runs_limit == 0 ||
+		    main_core->busy_runs >= g_scheduler_busy_runs_limit)) {
 		rc = governor->core_freq_up(g_main_lcore);
 		if (rc < 0) {
 			SPDK_ERRLOG("increasing frequency for core %u failed\n", g_main_lcore);
@@ -354,12 +442,14 @@ struct json_scheduler_opts {
 	uint8_t load_limit;
 	uint8_t core_limit;
 	uint8_t core_busy;
+	uint32_t busy_runs_limit;
 };
 
 static const struct spdk_json_object_decoder sched_decoders[] = {
 	{"load_limit", offsetof(struct json_scheduler_opts, load_limit), spdk_json_decode_uint8, true},
 	{"core_limit", offsetof(struct json_scheduler_opts, core_limit), spdk_json_decode_uint8, true},
 	{"core_busy", offsetof(struct json_scheduler_opts, core_busy), spdk_json_decode_uint8, true},
+	{"busy_runs_limit", offsetof(struct json_scheduler_opts, busy_runs_limit), spdk_json_decode_uint32, true},
 };
 
 static int
@@ -370,6 +460,7 @@ set_opts(const struct spdk_json_val *opts)
 	scheduler_opts.load_limit = g_scheduler_load_limit;
 	scheduler_opts.core_limit = g_scheduler_core_limit;
 	scheduler_opts.core_busy = g_scheduler_core_busy;
+	scheduler_opts.busy_runs_limit = g_scheduler_busy_runs_limit;
 
 	if (opts != NULL) {
 		if (spdk_json_decode_object_relaxed(opts, sched_decoders,
@@ -385,6 +476,8 @@ set_opts(const struct spdk_json_val *opts)
 	g_scheduler_core_limit = scheduler_opts.core_limit;
 	SPDK_NOTICELOG("Setting scheduler core busy to %d\n", scheduler_opts.core_busy);
 	g_scheduler_core_busy = scheduler_opts.core_busy;
+	SPDK_NOTICELOG("Setting scheduler busy runs limit to %u\n", scheduler_opts.busy_runs_limit);
+	g_scheduler_busy_runs_limit = scheduler_opts.busy_runs_limit;
 
 	return 0;
 }
@@ -395,6 +488,7 @@ get_opts(struct spdk_json_write_ctx *ctx)
 	spdk_json_write_named_uint8(ctx, "load_limit", g_scheduler_load_limit);
 	spdk_json_write_named_uint8(ctx, "core_limit", g_scheduler_core_limit);
 	spdk_json_write_named_uint8(ctx, "core_busy", g_scheduler_core_busy);
+	spdk_json_write_named_uint32(ctx, "busy_runs_limit", g_scheduler_busy_runs_limit);
 }
 
 static struct spdk_scheduler scheduler_dynamic = {
@@ -38,6 +38,28 @@
 #define SPDK_ZEROCOPY
 #endif
 
+/* Dynamic zerocopy threshold tuning (enable_dynamic_zerocopy) */
+#define ZCOPY_INFLIGHT_RING_SIZE	32
+#define ZCOPY_ADAPT_INTERVAL		64
+#define ZCOPY_ADAPT_EWMA_SHIFT		3
+/* Completion notification latency includes time on the wire that copied sends pay
+ * asynchronously too, so only 1/ZCOPY_ADAPT_COPY_WEIGHT of it is attributed to
+ * zerocopy overhead when comparing against the cost of the avoided copy. */
+#define ZCOPY_ADAPT_COPY_WEIGHT		8
+#define ZCOPY_DYNAMIC_THRESHOLD_MIN	4096
+#define ZCOPY_DYNAMIC_THRESHOLD_MAX	(512 * 1024)
+
+/* Sockets skipped this many consecutive polls by the flush budget
+ * (max_flushes_per_poll) are flushed ahead of larger sockets. */
+#define MAX_FLUSH_DEFERRALS		4
+
+/* In-flight zerocopy send, tracked to measure completion notification latency */
+struct posix_zcopy_inflight {
+	uint32_t	idx;
+	uint32_t	bytes;
+	uint64_t	tsc;
+};
+
 struct spdk_posix_sock {
 	struct spdk_sock	base;
 	int			fd;
@@ -50,10 +72,30 @@ struct spdk_posix_sock {
 	bool			socket_has_data;
 	bool			zcopy;
 
+	/* Dynamic zerocopy threshold state, only used when enable_dynamic_zerocopy is set.
+	 * The adapted threshold itself lives in base.impl_opts.zerocopy_threshold. */
+	bool			dynamic_zcopy;
+	uint32_t		zcopy_threshold_floor;
+	uint32_t		zcopy_completions;
+	uint64_t		zcopy_lat_ewma;
+	uint64_t		zcopy_bytes_ewma;
+	uint64_t		copy_ticks_ewma;
+	uint64_t		copy_bytes_ewma;
+	struct posix_zcopy_inflight	zcopy_inflight[ZCOPY_INFLIGHT_RING_SIZE];
+
 	int			placement_id;
 
+	/* Number of consecutive group polls this socket was not flushed on
+	 * because the flush budget was spent on larger sockets. */
+	uint32_t		flush_deferrals;
+
 	SSL_CTX			*ctx;
 	SSL			*ssl;
+	/* Set once the TLS handshake is done and the kernel has the session keys
+	 * installed for the send direction - the transmit path then bypasses
+	 * OpenSSL and uses plain sendmsg. */
+	bool			ktls_send;
+	bool			ktls_checked;
 
 	TAILQ_ENTRY(spdk_posix_sock)	link;
 };
@@ -66,6 +108,10 @@ struct spdk_posix_sock_group_impl {
 	struct spdk_has_data_list	socks_with_data;
 	int				placement_id;
 	struct spdk_pipe_group		*pipe_group;
+	/* Flush budget (max_flushes_per_poll impl opt, snapshotted at group
+	 * creation) and the scratch array used to select the fattest sockets. */
+	uint32_t			max_flushes_per_poll;
+	uint64_t			*flush_top;
 };
 
 static struct spdk_sock_impl_opts g_posix_impl_opts = {
@@ -84,7 +130,9 @@ static struct spdk_sock_impl_opts g_posix_impl_opts = {
 	.psk_identity = NULL,
 	.get_key = NULL,
 	.get_key_ctx = NULL,
-	.tls_cipher_suites = NULL
+	.tls_cipher_suites = NULL,
+	.enable_dynamic_zerocopy = false,
+	.max_flushes_per_poll = 0
 };
 
 static struct spdk_sock_impl_opts g_ssl_impl_opts = {
@@ -99,7 +147,9 @@ static struct spdk_sock_impl_opts g_ssl_impl_opts = {
 	.tls_version = 0,
 	.enable_ktls = false,
 	.psk_key = NULL,
-	.psk_identity = NULL
+	.psk_identity = NULL,
+	.enable_dynamic_zerocopy = false,
+	.max_flushes_per_poll = 0
 };
 
 static struct spdk_sock_map g_map = {
@@ -145,6 +195,10 @@ posix_sock_copy_impl_opts(struct spdk_sock_impl_opts *dest, const struct spdk_so
 	SET_FIELD(get_key);
 	SET_FIELD(get_key_ctx);
 	SET_FIELD(tls_cipher_suites);
+	SET_FIELD(enable_dynamic_zerocopy);
+	SET_FIELD(max_pacing_rate);
+	SET_FIELD(notsent_lowat);
+	SET_FIELD(max_flushes_per_poll);
 
 #undef SET_FIELD
 #undef FIELD_OK
@@ -449,6 +503,14 @@ posix_sock_init(struct spdk_posix_sock *sock, bool enable_zero_copy)
 			sock->zcopy = true;
 		}
 	}
+
+	if (sock->zcopy && sock->base.impl_opts.enable_dynamic_zerocopy) {
+		sock->dynamic_zcopy = true;
+		/* The configured threshold becomes the starting point and lower bound */
+		sock->zcopy_threshold_floor = spdk_max(sock->base.impl_opts.zerocopy_threshold,
+						       ZCOPY_DYNAMIC_THRESHOLD_MIN);
+		sock->base.impl_opts.zerocopy_threshold = sock->zcopy_threshold_floor;
+	}
 #endif
 
 #if defined(__linux__)
@@ -461,6 +523,27 @@ posix_sock_init(struct spdk_posix_sock *sock, bool enable_zero_copy)
 		}
 	}
 
+	if (sock->base.impl_opts.max_pacing_rate != 0) {
+		unsigned int rate = sock->base.impl_opts.max_pacing_rate;
+
+		rc = setsockopt(sock->fd, SOL_SOCKET, SO_MAX_PACING_RATE, &rate, sizeof(rate));
+		if (rc != 0) {
+			SPDK_ERRLOG("max_pacing_rate was failed to set\n");
+		}
+	}
+
+	if (sock->base.impl_opts.notsent_lowat != 0) {
+		flag = sock->base.impl_opts.notsent_lowat;
+
+		/* Once more than notsent_lowat not-yet-sent bytes are queued in the
+		 * kernel, sends return EAGAIN and further requests stay queued in the
+		 * sock layer until the poll group reports the socket writable again. */
+		rc = setsockopt(sock->fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &flag, sizeof(flag));
+		if (rc != 0) {
+			SPDK_ERRLOG("notsent_lowat was failed to set\n");
+		}
+	}
+
 	spdk_sock_get_placement_id(sock->fd, sock->base.impl_opts.enable_placement_id,
 				   &sock->placement_id);
 
@@ -524,6 +607,16 @@ posix_fd_create(struct addrinfo *res, struct spdk_sock_opts *opts,
 		/* error */
 		return -1;
 	}
+#if defined(SO_REUSEPORT)
+	if (opts->reuse_port) {
+		rc = setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &val, sizeof val);
+		if (rc != 0) {
+			close(fd);
+			/* error */
+			return -1;
+		}
+	}
+#endif
 	rc = setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &val, sizeof val);
 	if (rc != 0) {
 		close(fd);
@@ -941,6 +1034,60 @@ SSL_writev(SSL *ssl, struct iovec *iov, int iovcnt)
 	}
 }
 
+#ifdef SSL_OP_ENABLE_KTLS
+static void
+posix_sock_ktls_handshake_done(struct spdk_posix_sock *sock)
+{
+	sock->ktls_checked = true;
+
+	/* With SSL_OP_ENABLE_KTLS, OpenSSL installs the session keys into the kernel
+	 * via setsockopt(SOL_TLS) when the handshake completes.  Records are then
+	 * sealed and unsealed by the kernel (or by the NIC when the driver supports
+	 * TLS offload), so the transmit path can bypass OpenSSL and use the same
+	 * plain sendmsg path as cleartext sockets.
+	 *
+	 * Receives must stay on SSL_read() even with kTLS active.  A plain readv()
+	 * has no way to handle non-data records - alerts (close_notify), TLS 1.3
+	 * KeyUpdate and NewSessionTicket arrive as EIO without the TLS_GET_RECORD_TYPE
+	 * cmsg handling that OpenSSL's kTLS BIO performs - and OpenSSL servers send
+	 * session tickets right after the handshake.  The kernel still does the
+	 * record decryption; SSL_read() just pulls the plaintext through the BIO. */
+	sock->ktls_send = BIO_get_ktls_send(SSL_get_wbio(sock->ssl)) == 1;
+
+	SPDK_DEBUGLOG(sock_posix, "kTLS on sock %d: send %d recv %d\n", sock->fd,
+		      sock->ktls_send, BIO_get_ktls_recv(SSL_get_rbio(sock->ssl)) == 1);
+
+#ifdef SPDK_ZEROCOPY
+	/* Zerocopy sends are disabled at creation for ssl sockets, but with the
+	 * kernel doing the record encryption they work like on cleartext sockets.
+	 * The flush path drops back to copied sends if the kernel refuses the flag. */
+	if (sock->ktls_send && !sock->zcopy && !sock_is_loopback(sock->fd)) {
+		bool enable_zcopy;
+		int flag = 1;
+
+		enable_zcopy = SSL_is_server(sock->ssl) ?
+			       sock->base.impl_opts.enable_zerocopy_send_server :
+			       sock->base.impl_opts.enable_zerocopy_send_client;
+		if (enable_zcopy &&
+		    setsockopt(sock->fd, SOL_SOCKET, SO_ZEROCOPY, &flag, sizeof(flag)) == 0) {
+			sock->zcopy = true;
+		}
+	}
+#endif
+}
+#endif
+
+static inline void
+posix_sock_check_ktls(struct spdk_posix_sock *sock)
+{
+#ifdef SSL_OP_ENABLE_KTLS
+	if (spdk_unlikely(sock->ssl != NULL && !sock->ktls_checked &&
+			  SSL_is_init_finished(sock->ssl))) {
+		posix_sock_ktls_handshake_done(sock);
+	}
+#endif
+}
+
 static struct spdk_sock *
 posix_sock_create(const char *ip, int port,
 		  enum posix_sock_create_type type,
@@ -1228,6 +1375,70 @@ posix_sock_close(struct spdk_sock *_sock)
 }
 
 #ifdef SPDK_ZEROCOPY
+static inline void
+posix_sock_ewma_update(uint64_t *ewma, uint64_t sample)
+{
+	if (*ewma == 0) {
+		*ewma = sample;
+	} else {
+		*ewma += ((int64_t)sample - (int64_t)*ewma) >> ZCOPY_ADAPT_EWMA_SHIFT;
+	}
+}
+
+static void
+posix_sock_adjust_zcopy_threshold(struct spdk_posix_sock *sock)
+{
+	uint64_t copy_ticks;
+	uint32_t threshold = sock->base.impl_opts.zerocopy_threshold;
+
+	if (sock->copy_bytes_ewma == 0 || sock->zcopy_bytes_ewma == 0) {
+		/* No copied sends observed yet to compare against */
+		return;
+	}
+
+	/* Estimated cost of copying the average zerocopy-sized send */
+	copy_ticks = sock->copy_ticks_ewma * sock->zcopy_bytes_ewma / sock->copy_bytes_ewma;
+
+	if (sock->zcopy_lat_ewma > copy_ticks * ZCOPY_ADAPT_COPY_WEIGHT) {
+		/* Waiting for completion notifications costs more than the copies we are
+		 * avoiding - require larger sends before using zerocopy. */
+		threshold += threshold / 4;
+	} else {
+		threshold -= threshold / 4;
+	}
+
+	sock->base.impl_opts.zerocopy_threshold =
+		spdk_min(spdk_max(threshold, sock->zcopy_threshold_floor),
+			 (uint32_t)ZCOPY_DYNAMIC_THRESHOLD_MAX);
+}
+
+static void
+posix_sock_sample_zcopy_latency(struct spdk_posix_sock *sock, uint32_t first, uint32_t last)
+{
+	struct posix_zcopy_inflight *entry;
+	uint64_t now = spdk_get_ticks();
+	uint32_t idx = first;
+
+	while (true) {
+		entry = &sock->zcopy_inflight[idx % ZCOPY_INFLIGHT_RING_SIZE];
+		if (entry->bytes != 0 && entry->idx == idx) {
+			posix_sock_ewma_update(&sock->zcopy_lat_ewma, now - entry->tsc);
+			posix_sock_ewma_update(&sock->zcopy_bytes_ewma, entry->bytes);
+			entry->bytes = 0;
+
+			if (++sock->zcopy_completions >= ZCOPY_ADAPT_INTERVAL) {
+				sock->zcopy_completions = 0;
+				posix_sock_adjust_zcopy_threshold(sock);
+			}
+		}
+
+		if (idx == last) {
+			break;
+		}
+		idx++;
+	}
+}
+
 static int
 _sock_check_zcopy(struct spdk_sock *sock)
 {
@@ -1274,6 +1485,10 @@ _sock_check_zcopy(struct spdk_sock *sock)
 			return 0;
 		}
 
+		if (psock->dynamic_zcopy) {
+			posix_sock_sample_zcopy_latency(psock, serr->ee_info, serr->ee_data);
+		}
+
 		/* Most of the time, the pending_reqs array is in the exact
 		 * order we need such that all of the requests to complete are
 		 * in order, in the front. It is guaranteed that all requests
@@ -1333,6 +1548,9 @@ _sock_flush(struct spdk_sock *sock)
 	unsigned int offset;
 	size_t len;
 	bool is_zcopy = false;
+#ifdef SPDK_ZEROCOPY
+	uint64_t start_tsc = 0;
+#endif
 
 	/* Can't flush from within a callback or we end up with recursive calls */
 	if (sock->cb_cnt > 0) {
@@ -1340,6 +1558,8 @@ _sock_flush(struct spdk_sock *sock)
 		return -1;
 	}
 
+	posix_sock_check_ktls(psock);
+
 #ifdef SPDK_ZEROCOPY
 	if (psock->zcopy) {
 		flags = MSG_ZEROCOPY | MSG_NOSIGNAL;
@@ -1362,10 +1582,26 @@ _sock_flush(struct spdk_sock *sock)
 	msg.msg_iov = iovs;
 	msg.msg_iovlen = iovcnt;
 
-	if (psock->ssl) {
+#ifdef SPDK_ZEROCOPY
+	if (psock->dynamic_zcopy) {
+		start_tsc = spdk_get_ticks();
+	}
+#endif
+
+	if (psock->ssl && !psock->ktls_send) {
 		rc = SSL_writev(psock->ssl, iovs, iovcnt);
 	} else {
 		rc = sendmsg(psock->fd, &msg, flags);
+#ifdef SPDK_ZEROCOPY
+		if (spdk_unlikely(rc < 0 && errno == EOPNOTSUPP && is_zcopy && psock->ktls_send)) {
+			/* Kernel TLS without NIC offload rejects MSG_ZEROCOPY - fall back
+			 * to copied sends for the rest of this connection. */
+			psock->zcopy = false;
+			is_zcopy = false;
+			flags &= ~MSG_ZEROCOPY;
+			rc = sendmsg(psock->fd, &msg, flags);
+		}
+#endif
 	}
 	if (rc <= 0) {
 		if (rc == 0 || errno == EAGAIN || errno == EWOULDBLOCK || (errno == ENOBUFS && psock->zcopy)) {
@@ -1386,6 +1622,26 @@ _sock_flush(struct spdk_sock *sock)
 		}
 	}
 
+#ifdef SPDK_ZEROCOPY
+	if (psock->dynamic_zcopy) {
+		if (is_zcopy) {
+			/* Remember when this sendmsg was issued, so the completion
+			 * notification read from the ERRQUEUE can be timed. */
+			struct posix_zcopy_inflight *entry;
+			uint32_t idx = psock->sendmsg_idx - 1;
+
+			entry = &psock->zcopy_inflight[idx % ZCOPY_INFLIGHT_RING_SIZE];
+			entry->idx = idx;
+			entry->bytes = sent;
+			entry->tsc = start_tsc;
+		} else {
+			posix_sock_ewma_update(&psock->copy_ticks_ewma,
+					       spdk_get_ticks() - start_tsc);
+			posix_sock_ewma_update(&psock->copy_bytes_ewma, sent);
+		}
+	}
+#endif
+
 	/* Consume the requests that were actually written */
 	req = TAILQ_FIRST(&sock->queued_reqs);
 	while (req) {
@@ -1556,6 +1812,8 @@ posix_sock_readv(struct spdk_sock *_sock, struct iovec *iov, int iovcnt)
 	int rc, i;
 	size_t len;
 
+	posix_sock_check_ktls(sock);
+
 	if (sock->recv_pipe == NULL) {
 		assert(sock->pipe_has_data == false);
 		if (group && sock->socket_has_data) {
@@ -1628,7 +1886,7 @@ posix_sock_writev(struct spdk_sock *_sock, struct iovec *iov, int iovcnt)
 		return -1;
 	}
 
-	if (sock->ssl) {
+	if (sock->ssl && !sock->ktls_send) {
 		return SSL_writev(sock->ssl, iov, iovcnt);
 	} else {
 		return writev(sock->fd, iov, iovcnt);
@@ -1671,12 +1929,20 @@ posix_sock_writev_async(struct spdk_sock *sock, struct spdk_sock_request *req)
 
 	spdk_sock_request_queue(sock, req);
 
-	/* If there are a sufficient number queued, just flush them out immediately. */
-	if (sock->queued_iovcnt >= IOV_BATCH_SIZE) {
-		rc = _sock_flush(sock);
-		if (rc < 0 && errno != EAGAIN) {
-			spdk_sock_abort_requests(sock);
+	if (spdk_sock_group_is_corked(sock)) {
+		if (sock->queued_bytes < sock->group_impl->group->cork_max_bytes) {
+			/* Hold the data until spdk_sock_group_uncork() */
+			return;
 		}
+		/* Byte cap reached - send what has accumulated */
+	} else if (sock->queued_iovcnt < IOV_BATCH_SIZE) {
+		/* Not corked and not enough queued to be worth flushing immediately */
+		return;
+	}
+
+	rc = _sock_flush(sock);
+	if (rc < 0 && errno != EAGAIN) {
+		spdk_sock_abort_requests(sock);
 	}
 }
 
@@ -1762,6 +2028,44 @@ posix_sock_is_connected(struct spdk_sock *_sock)
 	return true;
 }
 
+static int
+posix_sock_refresh_placement_id(struct spdk_sock *_sock)
+{
+	struct spdk_posix_sock *sock = __posix_sock(_sock);
+	int placement_id;
+	int rc;
+
+	/* PLACEMENT_MARK ids are assigned by the group rather than read from the
+	 * kernel, and PLACEMENT_NONE has nothing to refresh. */
+	if (_sock->impl_opts.enable_placement_id != PLACEMENT_NAPI &&
+	    _sock->impl_opts.enable_placement_id != PLACEMENT_CPU) {
+		return 0;
+	}
+
+	spdk_sock_get_placement_id(sock->fd, _sock->impl_opts.enable_placement_id, &placement_id);
+	if (placement_id == sock->placement_id) {
+		return 0;
+	}
+
+	if (_sock->group_impl != NULL) {
+		if (sock->placement_id != -1) {
+			spdk_sock_map_release(&g_map, sock->placement_id);
+		}
+		if (placement_id != -1) {
+			rc = spdk_sock_map_insert(&g_map, placement_id, _sock->group_impl);
+			if (rc != 0) {
+				/* Not fatal - the id is already owned by another group and
+				 * the rebalance callback may move the sock there. */
+				SPDK_ERRLOG("Failed to insert sock group into map: %d\n", rc);
+			}
+		}
+	}
+
+	sock->placement_id = placement_id;
+
+	return 1;
+}
+
 static struct spdk_sock_group_impl *
 posix_sock_group_impl_get_optimal(struct spdk_sock *_sock, struct spdk_sock_group_impl *hint)
 {
@@ -1777,7 +2081,7 @@ posix_sock_group_impl_get_optimal(struct spdk_sock *_sock, struct spdk_sock_grou
 }
 
 static struct spdk_sock_group_impl *
-_sock_group_impl_create(uint32_t enable_placement_id)
+_sock_group_impl_create(const struct spdk_sock_impl_opts *impl_opts)
 {
 	struct spdk_posix_sock_group_impl *group_impl;
 	int fd;
@@ -1806,11 +2110,24 @@ _sock_group_impl_create(uint32_t enable_placement_id)
 		return NULL;
 	}
 
+	group_impl->max_flushes_per_poll = impl_opts->max_flushes_per_poll;
+	if (group_impl->max_flushes_per_poll > 0) {
+		group_impl->flush_top = calloc(group_impl->max_flushes_per_poll,
+					       sizeof(*group_impl->flush_top));
+		if (group_impl->flush_top == NULL) {
+			SPDK_ERRLOG("flush_top allocation failed\n");
+			spdk_pipe_group_destroy(group_impl->pipe_group);
+			free(group_impl);
+			close(fd);
+			return NULL;
+		}
+	}
+
 	group_impl->fd = fd;
 	TAILQ_INIT(&group_impl->socks_with_data);
 	group_impl->placement_id = -1;
 
-	if (enable_placement_id == PLACEMENT_CPU) {
+	if (impl_opts->enable_placement_id == PLACEMENT_CPU) {
 		spdk_sock_map_insert(&g_map, spdk_env_get_current_core(), &group_impl->base);
 		group_impl->placement_id = spdk_env_get_current_core();
 	}
@@ -1821,13 +2138,13 @@ _sock_group_impl_create(uint32_t enable_placement_id)
 static struct spdk_sock_group_impl *
 posix_sock_group_impl_create(void)
 {
-	return _sock_group_impl_create(g_posix_impl_opts.enable_placement_id);
+	return _sock_group_impl_create(&g_posix_impl_opts);
 }
 
 static struct spdk_sock_group_impl *
 ssl_sock_group_impl_create(void)
 {
-	return _sock_group_impl_create(g_ssl_impl_opts.enable_placement_id);
+	return _sock_group_impl_create(&g_ssl_impl_opts);
 }
 
 static void
@@ -1979,6 +2296,84 @@ posix_sock_group_impl_remove_sock(struct spdk_sock_group_impl *_group, struct sp
 	return rc;
 }
 
+/*
+ * Flush sockets with queued data under a per-poll sendmsg budget. The budget
+ * goes to the sockets with the most pending bytes first, which drains incast
+ * bursts with the fewest syscalls; sockets passed over for MAX_FLUSH_DEFERRALS
+ * consecutive polls are flushed ahead of everything else so a tight budget
+ * cannot starve thin connections.
+ */
+static void
+posix_sock_group_flush_budgeted(struct spdk_posix_sock_group_impl *group)
+{
+	struct spdk_sock_group_impl *_group = &group->base;
+	struct spdk_sock *sock, *tmp;
+	struct spdk_posix_sock *psock;
+	uint64_t *top = group->flush_top;
+	uint64_t bytes, threshold;
+	uint32_t budget = group->max_flushes_per_poll;
+	uint32_t ntop = 0, i;
+	int rc;
+
+	/* First pass: find the budget-th largest pending-byte count among the
+	 * flush candidates. Overdue sockets count as infinitely large. */
+	TAILQ_FOREACH(sock, &_group->socks, link) {
+		psock = __posix_sock(sock);
+
+		if (sock->queued_bytes == 0 || spdk_sock_group_is_corked(sock)) {
+			continue;
+		}
+
+		bytes = psock->flush_deferrals >= MAX_FLUSH_DEFERRALS ? UINT64_MAX : sock->queued_bytes;
+
+		/* Insertion into a descending top array; cheap because the
+		 * budget is small compared to the socket count. */
+		if (ntop < budget) {
+			i = ntop++;
+		} else if (bytes > top[budget - 1]) {
+			i = budget - 1;
+		} else {
+			continue;
+		}
+		while (i > 0 && top[i - 1] < bytes) {
+			top[i] = top[i - 1];
+			i--;
+		}
+		top[i] = bytes;
+	}
+
+	if (ntop == 0) {
+		return;
+	}
+
+	threshold = ntop < budget ? 0 : top[ntop - 1];
+
+	/* Second pass: flush candidates at or above the threshold until the
+	 * budget runs out and age the rest. This must be a TAILQ_FOREACH_SAFE
+	 * because while flushing, a completion callback could remove the sock
+	 * from the group. */
+	TAILQ_FOREACH_SAFE(sock, &_group->socks, link, tmp) {
+		psock = __posix_sock(sock);
+
+		if (sock->queued_bytes == 0 || spdk_sock_group_is_corked(sock)) {
+			continue;
+		}
+
+		bytes = psock->flush_deferrals >= MAX_FLUSH_DEFERRALS ? UINT64_MAX : sock->queued_bytes;
+		if (budget == 0 || bytes < threshold) {
+			psock->flush_deferrals++;
+			continue;
+		}
+
+		budget--;
+		psock->flush_deferrals = 0;
+		rc = _sock_flush(sock);
+		if (rc < 0 && errno != EAGAIN) {
+			spdk_sock_abort_requests(sock);
+		}
+	}
+}
+
 static int
 posix_sock_group_impl_poll(struct spdk_sock_group_impl *_group, int max_events,
 			   struct spdk_sock **socks)
@@ -2039,13 +2434,22 @@ posix_sock_group_impl_poll(struct spdk_sock_group_impl *_group, int max_events,
 	}
 #endif
 
-	/* This must be a TAILQ_FOREACH_SAFE because while flushing,
-	 * a completion callback could remove the sock from the
-	 * group. */
-	TAILQ_FOREACH_SAFE(sock, &_group->socks, link, tmp) {
-		rc = _sock_flush(sock);
-		if (rc < 0 && errno != EAGAIN) {
-			spdk_sock_abort_requests(sock);
+	if (group->max_flushes_per_poll > 0) {
+		posix_sock_group_flush_budgeted(group);
+	} else {
+		/* This must be a TAILQ_FOREACH_SAFE because while flushing,
+		 * a completion callback could remove the sock from the
+		 * group. */
+		TAILQ_FOREACH_SAFE(sock, &_group->socks, link, tmp) {
+			if (spdk_sock_group_is_corked(sock)) {
+				/* Queued writes are held until spdk_sock_group_uncork() */
+				continue;
+			}
+
+			rc = _sock_flush(sock);
+			if (rc < 0 && errno != EAGAIN) {
+				spdk_sock_abort_requests(sock);
+			}
 		}
 	}
 
@@ -2174,6 +2578,7 @@ _sock_group_impl_close(struct spdk_sock_group_impl *_group, uint32_t enable_plac
 
 	spdk_pipe_group_destroy(group->pipe_group);
 	rc = close(group->fd);
+	free(group->flush_top);
 	free(group);
 	return rc;
 }
@@ -2210,6 +2615,7 @@ static struct spdk_net_impl g_posix_net_impl = {
 	.is_ipv4	= posix_sock_is_ipv4,
 	.is_connected	= posix_sock_is_connected,
 	.group_impl_get_optimal	= posix_sock_group_impl_get_optimal,
+	.refresh_placement_id	= posix_sock_refresh_placement_id,
 	.group_impl_create	= posix_sock_group_impl_create,
 	.group_impl_add_sock	= posix_sock_group_impl_add_sock,
 	.group_impl_remove_sock = posix_sock_group_impl_remove_sock,
@@ -2259,6 +2665,7 @@ static struct spdk_net_impl g_ssl_net_impl = {
 	.is_ipv4	= posix_sock_is_ipv4,
 	.is_connected	= posix_sock_is_connected,
 	.group_impl_get_optimal	= posix_sock_group_impl_get_optimal,
+	.refresh_placement_id	= posix_sock_refresh_placement_id,
 	.group_impl_create	= ssl_sock_group_impl_create,
 	.group_impl_add_sock	= posix_sock_group_impl_add_sock,
 	.group_impl_remove_sock = posix_sock_group_impl_remove_sock,
@@ -121,6 +121,10 @@ struct spdk_uring_sock_group_impl {
 	uint32_t				buf_ring_count;
 	struct spdk_uring_buf_tracker		*trackers;
 	STAILQ_HEAD(, spdk_uring_buf_tracker)	free_trackers;
+
+	/* Arm recvs as multishot, so a single submission keeps producing completions.
+	 * Cleared at runtime if the kernel rejects the flag. */
+	bool					multishot_recv;
 };
 
 static struct spdk_sock_impl_opts g_spdk_uring_sock_impl_opts = {
@@ -556,6 +560,17 @@ retry:
 			/* error */
 			continue;
 		}
+#if defined(SO_REUSEPORT)
+		if (opts->reuse_port) {
+			rc = setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &val, sizeof val);
+			if (rc != 0) {
+				close(fd);
+				fd = -1;
+				/* error */
+				continue;
+			}
+		}
+#endif
 		rc = setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &val, sizeof val);
 		if (rc != 0) {
 			close(fd);
@@ -1269,6 +1284,14 @@ _sock_prep_read(struct spdk_sock *_sock)
 	io_uring_prep_recv(sqe, sock->fd, NULL, URING_MAX_RECV_SIZE, 0);
 	sqe->buf_group = URING_BUF_GROUP_ID;
 	sqe->flags |= IOSQE_BUFFER_SELECT;
+#ifdef IORING_RECV_MULTISHOT
+	if (sock->group->multishot_recv) {
+		/* The recv stays armed and keeps producing completions (each consuming a
+		 * provided buffer) until the socket errors out or the kernel runs out of
+		 * buffers, so it doesn't need to be resubmitted every poll cycle. */
+		sqe->ioprio |= IORING_RECV_MULTISHOT;
+	}
+#endif
 	io_uring_sqe_set_data(sqe, task);
 	task->status = SPDK_URING_SOCK_TASK_IN_PROCESS;
 }
@@ -1319,7 +1342,7 @@ sock_uring_group_reap(struct spdk_uring_sock_group_impl *group, int max, int max
 	struct spdk_uring_sock *sock, *tmp;
 	struct spdk_uring_task *task;
 	int status, bid, flags;
-	bool is_zcopy;
+	bool is_zcopy, more;
 
 	for (i = 0; i < max; i++) {
 		ret = io_uring_peek_cqe(&group->uring, &cqe);
@@ -1337,13 +1360,21 @@ sock_uring_group_reap(struct spdk_uring_sock_group_impl *group, int max, int max
 		assert(sock != NULL);
 		assert(sock->group != NULL);
 		assert(sock->group == group);
-		sock->group->io_inflight--;
-		sock->group->io_avail++;
 		status = cqe->res;
 		flags = cqe->flags;
 		io_uring_cqe_seen(&group->uring, cqe);
 
-		task->status = SPDK_URING_SOCK_TASK_NOT_IN_USE;
+		more = false;
+#ifdef IORING_RECV_MULTISHOT
+		/* Multishot requests produce multiple completions per submission. Only
+		 * retire the task (and its queue slot) on the final one. */
+		more = (flags & IORING_CQE_F_MORE) != 0;
+#endif
+		if (!more) {
+			sock->group->io_inflight--;
+			sock->group->io_avail++;
+			task->status = SPDK_URING_SOCK_TASK_NOT_IN_USE;
+		}
 
 		switch (task->type) {
 		case URING_TASK_READ:
@@ -1353,6 +1384,11 @@ sock_uring_group_reap(struct spdk_uring_sock_group_impl *group, int max, int max
 				_sock_prep_read(&sock->base);
 			} else if (status == -ECANCELED) {
 				continue;
+			} else if (spdk_unlikely(status == -EINVAL && sock->group->multishot_recv)) {
+				/* The kernel supports provided buffers but not multishot recv
+				 * (added in 6.0) - drop back to single-shot recvs for this group. */
+				sock->group->multishot_recv = false;
+				_sock_prep_read(&sock->base);
 			} else if (status == -ENOBUFS) {
 				/* There's data in the socket but the user hasn't provided any buffers.
 				 * We need to notify the user that the socket has data pending. */
@@ -1607,6 +1643,42 @@ uring_sock_is_connected(struct spdk_sock *_sock)
 	return true;
 }
 
+static int
+uring_sock_refresh_placement_id(struct spdk_sock *_sock)
+{
+	struct spdk_uring_sock *sock = __uring_sock(_sock);
+	int placement_id;
+	int rc;
+
+	if (_sock->impl_opts.enable_placement_id != PLACEMENT_NAPI &&
+	    _sock->impl_opts.enable_placement_id != PLACEMENT_CPU) {
+		return 0;
+	}
+
+	spdk_sock_get_placement_id(sock->fd, _sock->impl_opts.enable_placement_id, &placement_id);
+	if (placement_id == sock->placement_id) {
+		return 0;
+	}
+
+	if (_sock->group_impl != NULL) {
+		if (sock->placement_id != -1) {
+			spdk_sock_map_release(&g_map, sock->placement_id);
+		}
+		if (placement_id != -1) {
+			rc = spdk_sock_map_insert(&g_map, placement_id, _sock->group_impl);
+			if (rc != 0) {
+				/* Not fatal - the id is already owned by another group and
+				 * the rebalance callback may move the sock there. */
+				SPDK_ERRLOG("Failed to insert sock group into map: %d\n", rc);
+			}
+		}
+	}
+
+	sock->placement_id = placement_id;
+
+	return 1;
+}
+
 static struct spdk_sock_group_impl *
 uring_sock_group_impl_get_optimal(struct spdk_sock *_sock, struct spdk_sock_group_impl *hint)
 {
@@ -1712,6 +1784,10 @@ uring_sock_group_impl_create(void)
 		return NULL;
 	}
 
+#ifdef IORING_RECV_MULTISHOT
+	group_impl->multishot_recv = true;
+#endif
+
 	if (g_spdk_uring_sock_impl_opts.enable_placement_id == PLACEMENT_CPU) {
 		spdk_sock_map_insert(&g_map, spdk_env_get_current_core(), &group_impl->base);
 	}
@@ -1821,6 +1897,10 @@ uring_sock_group_impl_poll(struct spdk_sock_group_impl *_group, int max_events,
 			if (spdk_unlikely(sock->connection_status)) {
 				continue;
 			}
+			if (spdk_sock_group_is_corked(_sock)) {
+				/* Queued writes are held until spdk_sock_group_uncork() */
+				continue;
+			}
 			_sock_flush(_sock);
 		}
 	}
@@ -1845,6 +1925,11 @@ uring_sock_group_impl_poll(struct spdk_sock_group_impl *_group, int max_events,
 
 	count = 0;
 	to_complete = group->io_inflight;
+	if (to_complete > 0 && group->multishot_recv) {
+		/* Each multishot recv can produce several completions per poll, so the
+		 * inflight count no longer bounds the number of pending cqes. */
+		to_complete = SPDK_SOCK_GROUP_QUEUE_DEPTH;
+	}
 	if (to_complete > 0 || !TAILQ_EMPTY(&group->pending_recv)) {
 		count = sock_uring_group_reap(group, to_complete, max_events, socks);
 	}
@@ -2029,6 +2114,7 @@ static struct spdk_net_impl g_uring_net_impl = {
 	.is_ipv4	= uring_sock_is_ipv4,
 	.is_connected   = uring_sock_is_connected,
 	.group_impl_get_optimal	= uring_sock_group_impl_get_optimal,
+	.refresh_placement_id	= uring_sock_refresh_placement_id,
 	.group_impl_create	= uring_sock_group_impl_create,
 	.group_impl_add_sock	= uring_sock_group_impl_add_sock,
 	.group_impl_remove_sock	= uring_sock_group_impl_remove_sock,
@@ -28,6 +28,22 @@ def framework_monitor_context_switch(client, enabled=None):
     return client.call('framework_monitor_context_switch', params)
 
 
+def framework_set_hybrid_interrupt(client, enabled, lcore=None):
+    """Enable or disable automatic interrupt/poll hybrid switching of reactors.
+
+    Args:
+        enabled: True to enable hybrid switching; False to disable
+        lcore: override the framework-wide setting for this reactor only (optional)
+
+    Returns:
+        Current framework-wide hybrid switching state.
+    """
+    params = {'enabled': enabled}
+    if lcore is not None:
+        params['lcore'] = lcore
+    return client.call('framework_set_hybrid_interrupt', params)
+
+
 def framework_get_reactors(client):
     """Query list of all reactors.
 
@@ -38,7 +54,7 @@ def framework_get_reactors(client):
 
 
 def framework_set_scheduler(client, name, period=None, load_limit=None, core_limit=None,
-                            core_busy=None):
+                            core_busy=None, busy_runs_limit=None):
     """Select threads scheduler that will be activated and its period.
 
     Args:
@@ -56,6 +72,8 @@ def framework_set_scheduler(client, name, period=None, load_limit=None, core_lim
         params['core_limit'] = core_limit
     if core_busy is not None:
         params['core_busy'] = core_busy
+    if busy_runs_limit is not None:
+        params['busy_runs_limit'] = busy_runs_limit
     return client.call('framework_set_scheduler', params)
 
 
@@ -77,6 +95,25 @@ def thread_get_stats(client):
     return client.call('thread_get_stats')
 
 
+def thread_stats_shm_enable(client, shm_name=None, max_threads=None):
+    """Start publishing thread and poller statistics into a shared-memory segment.
+
+    Args:
+        shm_name: name of the shared-memory segment to create (optional)
+        max_threads: number of thread slots to allocate in the segment (optional)
+
+    Returns:
+        Name of the created shared-memory segment.
+    """
+    params = {}
+
+    if shm_name is not None:
+        params['shm_name'] = shm_name
+    if max_threads is not None:
+        params['max_threads'] = max_threads
+    return client.call('thread_stats_shm_enable', params)
+
+
 def thread_set_cpumask(client, id, cpumask):
     """Set the cpumask of the thread whose ID matches to the specified value.
 
@@ -285,7 +285,7 @@ def bdev_ocf_flush_status(client, name):
 
 
 def bdev_malloc_create(client, num_blocks, block_size, physical_block_size=None, name=None, uuid=None, optimal_io_boundary=None,
-                       md_size=None, md_interleave=None, dif_type=None, dif_is_head_of_md=None):
+                       md_size=None, md_interleave=None, dif_type=None, dif_is_head_of_md=None, socket_id=None):
     """Construct a malloc block device.
 
     Args:
@@ -299,6 +299,7 @@ def bdev_malloc_create(client, num_blocks, block_size, physical_block_size=None,
         md_interleave: metadata location, interleaved if set, and separated if omitted (optional)
         dif_type: protection information type (optional)
         dif_is_head_of_md: protection information is in the first 8 bytes of metadata (optional)
+        socket_id: NUMA socket to allocate the backing buffer on (optional)
 
     Returns:
         Name of created block device.
@@ -320,6 +321,8 @@ def bdev_malloc_create(client, num_blocks, block_size, physical_block_size=None,
         params['dif_type'] = dif_type
     if dif_is_head_of_md:
         params['dif_is_head_of_md'] = dif_is_head_of_md
+    if socket_id is not None:
+        params['socket_id'] = socket_id
 
     return client.call('bdev_malloc_create', params)
 
@@ -390,16 +393,19 @@ def bdev_null_resize(client, name, new_size):
     return client.call('bdev_null_resize', params)
 
 
-def bdev_raid_set_options(client, process_window_size_kb=None):
+def bdev_raid_set_options(client, process_window_size_kb=None, process_max_bandwidth_mb_sec=None):
     """Set options for bdev raid.
 
     Args:
         process_window_size_kb: Background process (e.g. rebuild) window size in KiB
+        process_max_bandwidth_mb_sec: Background process (e.g. rebuild) maximum bandwidth in MiB/s, 0 for unlimited
     """
     params = {}
 
     if process_window_size_kb is not None:
         params['process_window_size_kb'] = process_window_size_kb
+    if process_max_bandwidth_mb_sec is not None:
+        params['process_max_bandwidth_mb_sec'] = process_max_bandwidth_mb_sec
 
     return client.call('bdev_raid_set_options', params)
 
@@ -474,6 +480,20 @@ def bdev_raid_add_base_bdev(client, base_bdev, raid_bdev):
     return client.call('bdev_raid_add_base_bdev', params)
 
 
+def bdev_raid_grow_base_bdev(client, base_bdev, raid_bdev):
+    """Add a new base bdev to an existing raid bdev, growing the raid's capacity
+
+    Args:
+        raid_bdev: raid bdev name
+        base_bdev: base bdev name
+
+    Returns:
+        None
+    """
+    params = {'raid_bdev': raid_bdev, 'base_bdev': base_bdev}
+    return client.call('bdev_raid_grow_base_bdev', params)
+
+
 def bdev_raid_remove_base_bdev(client, name):
     """Remove base bdev from existing raid bdev
 
@@ -487,6 +507,20 @@ def bdev_raid_remove_base_bdev(client, name):
     return client.call('bdev_raid_remove_base_bdev', params)
 
 
+def bdev_raid_set_read_policy(client, name, policy):
+    """Set read selection policy of raid bdev
+
+    Args:
+        name: raid bdev name
+        policy: read selection policy (outstanding, latency or affinity)
+
+    Returns:
+        None
+    """
+    params = {'name': name, 'policy': policy}
+    return client.call('bdev_raid_set_read_policy', params)
+
+
 def bdev_aio_create(client, filename, name, block_size=None, readonly=False, fallocate=False):
     """Construct a Linux AIO block device.
 
@@ -579,7 +613,7 @@ def bdev_uring_delete(client, name):
     return client.call('bdev_uring_delete', params)
 
 
-def bdev_xnvme_create(client, filename, name, io_mechanism, conserve_cpu=None):
+def bdev_xnvme_create(client, filename, name, io_mechanism, conserve_cpu=None, poll_sq=None):
     """Create a bdev with xNVMe backend.
 
     Args:
@@ -587,6 +621,8 @@ def bdev_xnvme_create(client, filename, name, io_mechanism, conserve_cpu=None):
         name: name of xNVMe bdev to create
         io_mechanism: I/O mechanism to use (ex: io_uring, io_uring_cmd, etc.)
         conserve_cpu: Whether or not to conserve CPU when polling (default: False)
+        poll_sq: use a kernel SQPOLL thread and registered files/buffers,
+                 only valid with the io_uring and io_uring_cmd mechanisms (default: False)
 
     Returns:
         Name of created bdev.
@@ -598,6 +634,8 @@ def bdev_xnvme_create(client, filename, name, io_mechanism, conserve_cpu=None):
     }
     if conserve_cpu:
         params['conserve_cpu'] = conserve_cpu
+    if poll_sq:
+        params['poll_sq'] = poll_sq
 
     return client.call('bdev_xnvme_create', params)
 
@@ -791,7 +829,7 @@ def bdev_nvme_attach_controller(client, name, trtype, traddr, adrfam=None, trsvc
                                 hdgst=None, ddgst=None, fabrics_timeout=None, multipath=None, num_io_queues=None,
                                 ctrlr_loss_timeout_sec=None, reconnect_delay_sec=None,
                                 fast_io_fail_timeout_sec=None, psk=None, max_bdevs=None,
-                                dhchap_key=None, dhchap_ctrlr_key=None):
+                                dhchap_key=None, dhchap_ctrlr_key=None, priority_class=None):
     """Construct block device for each NVMe namespace in the attached controller.
 
     Args:
@@ -830,6 +868,8 @@ def bdev_nvme_attach_controller(client, name, trtype, traddr, adrfam=None, trsvc
         max_bdevs: Size of the name array for newly created bdevs. Default is 128. (optional)
         dhchap_key: DH-HMAC-CHAP key name.
         dhchap_ctrlr_key: DH-HMAC-CHAP controller key name.
+        priority_class: WRR priority class for the controller's IO queues ("urgent", "high", "medium", or "low";
+        requires a controller supporting weighted round robin arbitration; optional)
 
     Returns:
         Names of created block devices.
@@ -901,9 +941,33 @@ def bdev_nvme_attach_controller(client, name, trtype, traddr, adrfam=None, trsvc
     if dhchap_ctrlr_key is not None:
         params['dhchap_ctrlr_key'] = dhchap_ctrlr_key
 
+    if priority_class is not None:
+        params['priority_class'] = priority_class
+
     return client.call('bdev_nvme_attach_controller', params)
 
 
+def bdev_nvme_attach_all_controllers(client, name_prefix=None):
+    """Scan the PCIe bus and attach all NVMe controllers that are not attached yet.
+
+    All discovered controllers are initialized in parallel, so the total attach
+    time is bounded by the slowest device. Block devices are created
+    asynchronously for each namespace after the controllers attach.
+
+    Args:
+        name_prefix: controller name prefix; an index is appended to create unique names (optional)
+
+    Returns:
+        Names of attached NVMe controllers.
+    """
+    params = {}
+
+    if name_prefix is not None:
+        params['name_prefix'] = name_prefix
+
+    return client.call('bdev_nvme_attach_all_controllers', params)
+
+
 def bdev_nvme_detach_controller(client, name, trtype=None, traddr=None,
                                 adrfam=None, trsvcid=None, subnqn=None,
                                 hostaddr=None, hostsvcid=None):
@@ -1111,7 +1175,7 @@ def bdev_nvme_set_multipath_policy(client, name, policy, selector, rr_min_io):
     Args:
         name: NVMe bdev name
         policy: Multipath policy (active_passive or active_active)
-        selector: Multipath selector (round_robin, queue_depth)
+        selector: Multipath selector (round_robin, queue_depth, latency)
         rr_min_io: Number of IO to route to a path before switching to another one (optional)
     """
 
@@ -1191,6 +1255,38 @@ def bdev_zone_block_delete(client, name):
     return client.call('bdev_zone_block_delete', params)
 
 
+def bdev_zone_remap_create(client, name, base_bdev, zone_capacity=None, reserved_zones=None):
+    """Creates a conventional (random-write) vbdev on top of an existing zoned bdev.
+
+    Args:
+        name: Remap device name
+        base_bdev: Base zoned bdev name
+        zone_capacity: Writable capacity of the base zones in blocks (optional, default: zone size)
+        reserved_zones: Number of zones held back for garbage collection (optional, default: 2)
+
+    Returns:
+        Name of created block device.
+    """
+    params = {'name': name,
+              'base_bdev': base_bdev}
+    if zone_capacity:
+        params['zone_capacity'] = zone_capacity
+    if reserved_zones:
+        params['reserved_zones'] = reserved_zones
+
+    return client.call('bdev_zone_remap_create', params)
+
+
+def bdev_zone_remap_delete(client, name):
+    """Remove zone remap bdev from the system.
+
+    Args:
+        name: name of zone remap bdev to delete
+    """
+    params = {'name': name}
+    return client.call('bdev_zone_remap_delete', params)
+
+
 def bdev_rbd_register_cluster(client, name, user_id=None, config_param=None, config_file=None, key_file=None, core_mask=None):
     """Create a Rados Cluster object of the Ceph RBD backend.
 
@@ -1359,6 +1455,36 @@ def bdev_delay_delete(client, name):
     return client.call('bdev_delay_delete', params)
 
 
+def bdev_rcache_create(client, base_bdev_name, name, uuid=None):
+    """Construct a read cache block device.
+
+    Args:
+        base_bdev_name: name of the existing bdev
+        name: name of block device
+        uuid: UUID of block device (optional)
+
+    Returns:
+        Name of created block device.
+    """
+    params = {
+        'base_bdev_name': base_bdev_name,
+        'name': name,
+    }
+    if uuid:
+        params['uuid'] = uuid
+    return client.call('bdev_rcache_create', params)
+
+
+def bdev_rcache_delete(client, name):
+    """Remove read cache bdev from the system.
+
+    Args:
+        name: name of rcache bdev to delete
+    """
+    params = {'name': name}
+    return client.call('bdev_rcache_delete', params)
+
+
 def bdev_delay_update_latency(client, delay_bdev_name, latency_type, latency_us):
     """Update the latency value for a delay block device
 
@@ -1772,6 +1898,16 @@ def bdev_get_histogram(client, name):
     return client.call('bdev_get_histogram', params)
 
 
+def bdev_get_latency_percentiles(client, name):
+    """Get latency percentiles for specified bdev.
+
+    Args:
+        bdev_name: name of bdev
+    """
+    params = {'name': name}
+    return client.call('bdev_get_latency_percentiles', params)
+
+
 def bdev_error_inject_error(client, name, io_type, error_type, num,
                             queue_depth, corrupt_offset, corrupt_value):
     """Inject an error via an error bdev.
@@ -1817,6 +1953,20 @@ def bdev_set_qd_sampling_period(client, name, period):
     return client.call('bdev_set_qd_sampling_period', params)
 
 
+def bdev_set_stat_subscription_period(client, name, period):
+    """Enable periodic stat publishing on a specified bdev.
+
+    Args:
+        name: name of a bdev on which to enable stat subscription.
+        period: period (in microseconds) at which each channel publishes its stats. If set to 0, publishing will be disabled.
+    """
+
+    params = {}
+    params['name'] = name
+    params['period'] = period
+    return client.call('bdev_set_stat_subscription_period', params)
+
+
 def bdev_set_qos_limit(
         client,
         name,
@@ -3,7 +3,10 @@
 #  All rights reserved.
 
 
-def iobuf_set_options(client, small_pool_count, large_pool_count, small_bufsize, large_bufsize):
+def iobuf_set_options(client, small_pool_count, large_pool_count, small_bufsize, large_bufsize,
+                      enable_numa=None, cache_rebalance_period_us=None,
+                      small_pool_max_count=None, large_pool_max_count=None,
+                      cache_idle_reclaim_us=None):
     """Set iobuf pool options.
 
     Args:
@@ -11,6 +14,16 @@ def iobuf_set_options(client, small_pool_count, large_pool_count, small_bufsize,
         large_pool_count: number of large buffers in the global pool
         small_bufsize: size of a small buffer
         large_bufsize: size of a large buffer
+        enable_numa: allocate backing pools per NUMA node (optional)
+        cache_rebalance_period_us: period of the per-thread cache rebalancer in microseconds,
+                                   0 to disable (optional)
+        small_pool_max_count: maximum number of small buffers the pool can be grown to at
+                              runtime, 0 to disable growth (optional)
+        large_pool_max_count: maximum number of large buffers the pool can be grown to at
+                              runtime, 0 to disable growth (optional)
+        cache_idle_reclaim_us: idle period after which a channel's cached buffers are
+                               returned to the shared pool, in microseconds, 0 to
+                               disable (optional)
     """
     params = {}
 
@@ -22,10 +35,64 @@ def iobuf_set_options(client, small_pool_count, large_pool_count, small_bufsize,
         params['small_bufsize'] = small_bufsize
     if large_bufsize is not None:
         params['large_bufsize'] = large_bufsize
+    if enable_numa is not None:
+        params['enable_numa'] = enable_numa
+    if cache_rebalance_period_us is not None:
+        params['cache_rebalance_period_us'] = cache_rebalance_period_us
+    if small_pool_max_count is not None:
+        params['small_pool_max_count'] = small_pool_max_count
+    if large_pool_max_count is not None:
+        params['large_pool_max_count'] = large_pool_max_count
+    if cache_idle_reclaim_us is not None:
+        params['cache_idle_reclaim_us'] = cache_idle_reclaim_us
 
     return client.call('iobuf_set_options', params)
 
 
+def iobuf_pool_grow(client, small_pool_count=None, large_pool_count=None, numa_node=None):
+    """Grow the iobuf pools at runtime.
+
+    Args:
+        small_pool_count: number of small buffers to add to the global pool (optional)
+        large_pool_count: number of large buffers to add to the global pool (optional)
+        numa_node: NUMA node to allocate the new buffers on; spread across all
+                   nodes if not specified (optional)
+    """
+    params = {}
+
+    if small_pool_count is not None:
+        params['small_pool_count'] = small_pool_count
+    if large_pool_count is not None:
+        params['large_pool_count'] = large_pool_count
+    if numa_node is not None:
+        params['numa_node'] = numa_node
+
+    return client.call('iobuf_pool_grow', params)
+
+
+def iobuf_pool_shrink(client, small_pool_count=None, large_pool_count=None, numa_node=None):
+    """Shrink the iobuf pools at runtime by freeing idle buffers added by iobuf_pool_grow.
+
+    Args:
+        small_pool_count: maximum number of small buffers to remove from the global
+                          pool (optional)
+        large_pool_count: maximum number of large buffers to remove from the global
+                          pool (optional)
+        numa_node: NUMA node to free buffers on; consider all nodes if not
+                   specified (optional)
+    """
+    params = {}
+
+    if small_pool_count is not None:
+        params['small_pool_count'] = small_pool_count
+    if large_pool_count is not None:
+        params['large_pool_count'] = large_pool_count
+    if numa_node is not None:
+        params['numa_node'] = numa_node
+
+    return client.call('iobuf_pool_shrink', params)
+
+
 def iobuf_get_stats(client):
     """Get iobuf statistics"""
 
@@ -24,6 +24,7 @@ def iscsi_set_options(
         allow_duplicated_isid=None,
         max_large_datain_per_connection=None,
         max_r2t_per_connection=None,
+        max_logins_per_poll_group=None,
         pdu_pool_size=None,
         immediate_data_pool_size=None,
         data_out_pool_size=None):
@@ -49,6 +50,7 @@ def iscsi_set_options(
         allow_duplicated_isid: Allow duplicated initiator session ID
         max_large_datain_per_connection: Max number of outstanding split read I/Os per connection (optional)
         max_r2t_per_connection: Max number of outstanding R2Ts per connection (optional)
+        max_logins_per_poll_group: Max number of concurrent logins per poll group (optional)
         pdu_pool_size: Number of PDUs in the pool (optional)
         immediate_data_pool_size: Number of immediate data buffers in the pool (optional)
         data_out_pool_size: Number of data out buffers in the pool (optional)
@@ -96,6 +98,8 @@ def iscsi_set_options(
         params['max_large_datain_per_connection'] = max_large_datain_per_connection
     if max_r2t_per_connection:
         params['max_r2t_per_connection'] = max_r2t_per_connection
+    if max_logins_per_poll_group:
+        params['max_logins_per_poll_group'] = max_logins_per_poll_group
     if pdu_pool_size:
         params['pdu_pool_size'] = pdu_pool_size
     if immediate_data_pool_size:
@@ -199,27 +199,33 @@ def bdev_lvol_delete(client, name):
     return client.call('bdev_lvol_delete', params)
 
 
-def bdev_lvol_inflate(client, name):
+def bdev_lvol_inflate(client, name, max_in_flight=None):
     """Inflate a logical volume.
 
     Args:
         name: name of logical volume to inflate
+        max_in_flight: maximum number of cluster copies kept in flight (optional)
     """
     params = {
         'name': name,
     }
+    if max_in_flight is not None:
+        params['max_in_flight'] = max_in_flight
     return client.call('bdev_lvol_inflate', params)
 
 
-def bdev_lvol_decouple_parent(client, name):
+def bdev_lvol_decouple_parent(client, name, max_in_flight=None):
     """Decouple parent of a logical volume.
 
     Args:
         name: name of logical volume to decouple parent
+        max_in_flight: maximum number of cluster copies kept in flight (optional)
     """
     params = {
         'name': name,
     }
+    if max_in_flight is not None:
+        params['max_in_flight'] = max_in_flight
     return client.call('bdev_lvol_decouple_parent', params)
 
 
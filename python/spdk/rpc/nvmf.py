@@ -119,12 +119,17 @@ def nvmf_create_transport(client, **params):
         num_cqe: The number of CQ entries to configure CQ size. Only used when no_srq=true - RDMA specific (optional)
         max_srq_depth: Max number of outstanding I/O per shared receive queue - RDMA specific (optional)
         no_srq: Boolean flag to disable SRQ even for devices that support it - RDMA specific (optional)
+        srq_autoscale: Boolean flag to grow/shrink SRQ receive buffers with the observed load - RDMA specific (optional)
         c2h_success: Boolean flag to disable the C2H success optimization - TCP specific (optional)
         dif_insert_or_strip: Boolean flag to enable DIF insert/strip for I/O - TCP specific (optional)
         acceptor_backlog: Pending connections allowed at one time - RDMA specific (optional)
         abort_timeout_sec: Abort execution timeout value, in seconds (optional)
         no_wr_batching: Boolean flag to disable work requests batching - RDMA specific (optional)
         control_msg_num: The number of control messages per poll group - TCP specific (optional)
+        enable_recv_pipe: Set to False to receive data PDU payloads directly into request buffers,
+        bypassing the socket receive pipe - TCP specific (optional)
+        listener_shards: The number of SO_REUSEPORT-sharded listen sockets created per listen
+        address - TCP specific (optional)
         disable_mappable_bar0: disable client mmap() of BAR0 - VFIO-USER specific (optional)
         disable_adaptive_irq: Disable adaptive interrupt feature - VFIO-USER specific (optional)
         disable_shadow_doorbells: disable shadow doorbell support - VFIO-USER specific (optional)
@@ -527,7 +532,7 @@ def nvmf_ns_visible(visible, client, nqn, nsid, host, tgt_name=None):
 
 
 def nvmf_subsystem_add_host(client, nqn, host, tgt_name=None, psk=None, dhchap_key=None,
-                            dhchap_ctrlr_key=None):
+                            dhchap_ctrlr_key=None, max_ios_per_sec=None, max_mbytes_per_sec=None):
     """Add a host NQN to the list of allowed hosts.
 
     Args:
@@ -537,6 +542,8 @@ def nvmf_subsystem_add_host(client, nqn, host, tgt_name=None, psk=None, dhchap_k
         psk: PSK file path for TLS (optional)
         dhchap_key: DH-HMAC-CHAP key name (optional)
         dhchap_ctrlr_key: DH-HMAC-CHAP controller key name (optional)
+        max_ios_per_sec: Max I/O per second from this host, 0 for unlimited (optional)
+        max_mbytes_per_sec: Max read/write throughput from this host in MiB/s, 0 for unlimited (optional)
 
     Returns:
         True or False
@@ -552,10 +559,41 @@ def nvmf_subsystem_add_host(client, nqn, host, tgt_name=None, psk=None, dhchap_k
         params['dhchap_key'] = dhchap_key
     if dhchap_ctrlr_key is not None:
         params['dhchap_ctrlr_key'] = dhchap_ctrlr_key
+    if max_ios_per_sec is not None:
+        params['max_ios_per_sec'] = max_ios_per_sec
+    if max_mbytes_per_sec is not None:
+        params['max_mbytes_per_sec'] = max_mbytes_per_sec
 
     return client.call('nvmf_subsystem_add_host', params)
 
 
+def nvmf_subsystem_set_host_qos(client, nqn, host, tgt_name=None, max_ios_per_sec=None,
+                                max_mbytes_per_sec=None):
+    """Set QoS rate limits for I/O submitted by a host.
+
+    Args:
+        nqn: Subsystem NQN.
+        host: Host NQN to set the QoS limits for
+        tgt_name: name of the parent NVMe-oF target (optional)
+        max_ios_per_sec: Max I/O per second from this host, 0 for unlimited (optional)
+        max_mbytes_per_sec: Max read/write throughput from this host in MiB/s, 0 for unlimited (optional)
+
+    Returns:
+        True or False
+    """
+    params = {'nqn': nqn,
+              'host': host}
+
+    if tgt_name:
+        params['tgt_name'] = tgt_name
+    if max_ios_per_sec is not None:
+        params['max_ios_per_sec'] = max_ios_per_sec
+    if max_mbytes_per_sec is not None:
+        params['max_mbytes_per_sec'] = max_mbytes_per_sec
+
+    return client.call('nvmf_subsystem_set_host_qos', params)
+
+
 def nvmf_subsystem_remove_host(client, nqn, host, tgt_name=None):
     """Remove a host NQN from the list of allowed hosts.
 
@@ -687,6 +725,25 @@ def nvmf_get_stats(client, tgt_name=None):
     return client.call('nvmf_get_stats', params)
 
 
+def nvmf_subsystem_get_ns_stats(client, nqn, tgt_name=None):
+    """Query per-namespace I/O statistics of an NVMe-oF subsystem.
+
+    Args:
+        nqn: Subsystem NQN.
+        tgt_name: name of the parent NVMe-oF target (optional).
+
+    Returns:
+        Per-namespace I/O statistics merged across all poll groups.
+    """
+
+    params = {'nqn': nqn}
+
+    if tgt_name:
+        params['tgt_name'] = tgt_name
+
+    return client.call('nvmf_subsystem_get_ns_stats', params)
+
+
 def nvmf_set_crdt(client, crdt1=None, crdt2=None, crdt3=None):
     """Set the 3 crdt (Command Retry Delay Time) values
 
@@ -27,7 +27,11 @@ def sock_impl_set_options(client,
                           enable_zerocopy_send_client=None,
                           zerocopy_threshold=None,
                           tls_version=None,
-                          enable_ktls=None):
+                          enable_ktls=None,
+                          enable_dynamic_zerocopy=None,
+                          max_pacing_rate=None,
+                          notsent_lowat=None,
+                          max_flushes_per_poll=None):
     """Set parameters for the socket layer implementation.
 
     Args:
@@ -42,6 +46,10 @@ def sock_impl_set_options(client,
         zerocopy_threshold: set zerocopy_threshold in bytes(optional)
         tls_version: set TLS protocol version (optional)
         enable_ktls: enable or disable Kernel TLS (optional)
+        enable_dynamic_zerocopy: enable or disable per-connection adaptive zerocopy threshold (optional)
+        max_pacing_rate: set maximum socket pacing rate in bytes per second, 0 to disable (optional)
+        notsent_lowat: set limit on not-yet-sent bytes queued in the kernel, 0 for kernel default (optional)
+        max_flushes_per_poll: set limit on sockets flushed per poll group iteration, 0 to flush all (optional)
     """
     params = {}
 
@@ -66,6 +74,14 @@ def sock_impl_set_options(client,
         params['tls_version'] = tls_version
     if enable_ktls is not None:
         params['enable_ktls'] = enable_ktls
+    if enable_dynamic_zerocopy is not None:
+        params['enable_dynamic_zerocopy'] = enable_dynamic_zerocopy
+    if max_pacing_rate is not None:
+        params['max_pacing_rate'] = max_pacing_rate
+    if notsent_lowat is not None:
+        params['notsent_lowat'] = notsent_lowat
+    if max_flushes_per_poll is not None:
+        params['max_flushes_per_poll'] = max_flushes_per_poll
 
     return client.call('sock_impl_set_options', params)
 
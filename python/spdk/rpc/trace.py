@@ -47,6 +47,18 @@ def trace_clear_tpoint_mask(client, name, tpoint_mask):
     return client.call('trace_clear_tpoint_mask', params)
 
 
+def trace_set_tpoint_sample_rate(client, name, rate):
+    """Set sampling rate on a specific tpoint group.
+
+    Args:
+        name: trace group name we want to set the sampling rate for. (for example "bdev").
+        rate: record one in every "rate" occurrences of an enabled tracepoint
+                        (for example 100; 0 or 1 to record every occurrence).
+    """
+    params = {'name': name, 'rate': rate}
+    return client.call('trace_set_tpoint_sample_rate', params)
+
+
 def trace_get_tpoint_group_mask(client):
     """Get trace point group mask
 
@@ -3,12 +3,14 @@
 #  All rights reserved.
 
 
-def ublk_create_target(client, cpumask=None, disable_user_copy=None):
+def ublk_create_target(client, cpumask=None, disable_user_copy=None, enable_sqpoll=None):
     params = {}
     if cpumask:
         params['cpumask'] = cpumask
     if disable_user_copy:
         params['disable_user_copy'] = True
+    if enable_sqpoll:
+        params['enable_sqpoll'] = True
     return client.call('ublk_create_target', params)
 
 
@@ -156,6 +156,20 @@ if __name__ == "__main__":
     p.add_argument('-d', '--disable', action='store_true', help='Disable context switch monitoring')
     p.set_defaults(func=framework_monitor_context_switch)
 
+    def framework_set_hybrid_interrupt(args):
+        print_dict(rpc.app.framework_set_hybrid_interrupt(args.client,
+                                                          enabled=args.enable,
+                                                          lcore=args.lcore))
+
+    p = subparsers.add_parser('framework_set_hybrid_interrupt',
+                              help='Control automatic interrupt/poll hybrid switching of reactors')
+    group = p.add_mutually_exclusive_group(required=True)
+    group.add_argument('-e', '--enable', action='store_true', help='Enable hybrid switching')
+    group.add_argument('-d', '--disable', dest='enable', action='store_false',
+                       help='Disable hybrid switching')
+    p.add_argument('-l', '--lcore', help='Apply to this reactor only', type=int)
+    p.set_defaults(func=framework_set_hybrid_interrupt)
+
     def framework_get_reactors(args):
         print_dict(rpc.app.framework_get_reactors(args.client))
 
@@ -169,7 +183,8 @@ if __name__ == "__main__":
                                         period=args.period,
                                         load_limit=args.load_limit,
                                         core_limit=args.core_limit,
-                                        core_busy=args.core_busy)
+                                        core_busy=args.core_busy,
+                                        busy_runs_limit=args.busy_runs_limit)
 
     p = subparsers.add_parser(
         'framework_set_scheduler', help='Select thread scheduler that will be activated and its period (experimental)')
@@ -178,6 +193,8 @@ if __name__ == "__main__":
     p.add_argument('--load-limit', help="Scheduler load limit. Reserved for dynamic scheduler", type=int)
     p.add_argument('--core-limit', help="Scheduler core limit. Reserved for dynamic scheduler", type=int)
     p.add_argument('--core-busy', help="Scheduler core busy limit. Reserved for dynamic schedler", type=int)
+    p.add_argument('--busy-runs-limit', help="Minimum busy poller runs per period to raise core frequency. "
+                   "Reserved for dynamic scheduler", type=int)
     p.set_defaults(func=framework_set_scheduler)
 
     def framework_get_scheduler(args):
@@ -395,7 +412,8 @@ if __name__ == "__main__":
                                                md_size=args.md_size,
                                                md_interleave=args.md_interleave,
                                                dif_type=args.dif_type,
-                                               dif_is_head_of_md=args.dif_is_head_of_md))
+                                               dif_is_head_of_md=args.dif_is_head_of_md,
+                                               socket_id=args.socket_id))
     p = subparsers.add_parser('bdev_malloc_create', help='Create a bdev with malloc backend')
     p.add_argument('-b', '--name', help="Name of the bdev")
     p.add_argument('-u', '--uuid', help="UUID of the bdev")
@@ -414,6 +432,8 @@ if __name__ == "__main__":
                         'to be set along --dif-type. Default=0 - no protection.')
     p.add_argument('-d', '--dif-is-head-of-md', action='store_true',
                    help='Protection information is in the first 8 bytes of metadata. Default=false.')
+    p.add_argument('-s', '--socket-id', type=int,
+                   help='NUMA socket to allocate the backing buffer on. Default is any socket.')
     p.set_defaults(func=bdev_malloc_create)
 
     def bdev_malloc_delete(args):
@@ -539,13 +559,18 @@ if __name__ == "__main__":
         print_json(rpc.bdev.bdev_xnvme_create(args.client,
                                               filename=args.filename,
                                               name=args.name,
-                                              io_mechanism=args.io_mechanism))
+                                              io_mechanism=args.io_mechanism,
+                                              conserve_cpu=args.conserve_cpu,
+                                              poll_sq=args.poll_sq))
 
     p = subparsers.add_parser('bdev_xnvme_create', help='Create a bdev with xNVMe backend')
     p.add_argument('filename', help='Path to device or file (ex: /dev/nvme0n1)')
     p.add_argument('name', help='name of xNVMe bdev to create')
     p.add_argument('io_mechanism', help='IO mechanism to use (ex: libaio, io_uring, io_uring_cmd, etc.)')
     p.add_argument('conserve_cpu', action='store_true', help='Whether or not to conserve CPU when polling')
+    p.add_argument('--poll-sq', dest='poll_sq', action='store_true',
+                   help='Use a kernel SQPOLL thread and registered files/buffers '
+                        '(io_uring and io_uring_cmd mechanisms only)')
     p.set_defaults(func=bdev_xnvme_create)
 
     def bdev_xnvme_delete(args):
@@ -714,7 +739,8 @@ if __name__ == "__main__":
                                                          psk=args.psk,
                                                          max_bdevs=args.max_bdevs,
                                                          dhchap_key=args.dhchap_key,
-                                                         dhchap_ctrlr_key=args.dhchap_ctrlr_key))
+                                                         dhchap_ctrlr_key=args.dhchap_ctrlr_key,
+                                                         priority_class=args.priority_class))
 
     p = subparsers.add_parser('bdev_nvme_attach_controller', help='Add bdevs with nvme backend')
     p.add_argument('-b', '--name', help="Name of the NVMe controller, prefix for each bdev name", required=True)
@@ -773,9 +799,22 @@ if __name__ == "__main__":
                    help='The size of the name array for newly created bdevs. Default is 128',)
     p.add_argument('--dhchap-key', help='DH-HMAC-CHAP key name')
     p.add_argument('--dhchap-ctrlr-key', help='DH-HMAC-CHAP controller key name')
+    p.add_argument('--priority-class',
+                   help='WRR priority class for the controller IO queues (urgent, high, medium or low). '
+                        'Requires a controller supporting weighted round robin arbitration.')
 
     p.set_defaults(func=bdev_nvme_attach_controller)
 
+    def bdev_nvme_attach_all_controllers(args):
+        print_array(rpc.bdev.bdev_nvme_attach_all_controllers(args.client,
+                                                              name_prefix=args.name_prefix))
+
+    p = subparsers.add_parser('bdev_nvme_attach_all_controllers',
+                              help='Attach all unattached PCIe NVMe controllers in parallel')
+    p.add_argument('-b', '--name-prefix',
+                   help='Controller name prefix, an index is appended to create unique names. Default is Nvme')
+    p.set_defaults(func=bdev_nvme_attach_all_controllers)
+
     def bdev_nvme_get_controllers(args):
         print_dict(rpc.nvme.bdev_nvme_get_controllers(args.client,
                                                       name=args.name))
@@ -942,7 +981,7 @@ if __name__ == "__main__":
                               help="""Set multipath policy of the NVMe bdev""")
     p.add_argument('-b', '--name', help='Name of the NVMe bdev', required=True)
     p.add_argument('-p', '--policy', help='Multipath policy (active_passive or active_active)', required=True)
-    p.add_argument('-s', '--selector', help='Multipath selector (round_robin, queue_depth)')
+    p.add_argument('-s', '--selector', help='Multipath selector (round_robin, queue_depth, latency)')
     p.add_argument('-r', '--rr-min-io',
                    help='Number of IO to route to a path before switching to another for round-robin',
                    type=int)
@@ -1001,6 +1040,29 @@ if __name__ == "__main__":
     p.add_argument('name', help='Virtual zone bdev name')
     p.set_defaults(func=bdev_zone_block_delete)
 
+    def bdev_zone_remap_create(args):
+        print_json(rpc.bdev.bdev_zone_remap_create(args.client,
+                                                   name=args.name,
+                                                   base_bdev=args.base_bdev,
+                                                   zone_capacity=args.zone_capacity,
+                                                   reserved_zones=args.reserved_zones))
+
+    p = subparsers.add_parser('bdev_zone_remap_create',
+                              help='Create conventional (random-write) device with zoned device backend')
+    p.add_argument('-b', '--name', help="Name of the remap device", required=True)
+    p.add_argument('-n', '--base-bdev', help='Name of underlying zoned bdev', required=True)
+    p.add_argument('-z', '--zone-capacity', help='Writable capacity of the base zones in blocks', type=int)
+    p.add_argument('-r', '--reserved-zones', help='Number of zones held back for garbage collection', type=int)
+    p.set_defaults(func=bdev_zone_remap_create)
+
+    def bdev_zone_remap_delete(args):
+        rpc.bdev.bdev_zone_remap_delete(args.client,
+                                        name=args.name)
+
+    p = subparsers.add_parser('bdev_zone_remap_delete', help='Delete a zone remap device')
+    p.add_argument('name', help='Zone remap bdev name')
+    p.set_defaults(func=bdev_zone_remap_delete)
+
     def bdev_rbd_register_cluster(args):
         config_param = None
         if args.config_param:
@@ -1128,6 +1190,27 @@ if __name__ == "__main__":
     p.add_argument('name', help='delay bdev name')
     p.set_defaults(func=bdev_delay_delete)
 
+    def bdev_rcache_create(args):
+        print_json(rpc.bdev.bdev_rcache_create(args.client,
+                                               base_bdev_name=args.base_bdev_name,
+                                               name=args.name,
+                                               uuid=args.uuid))
+
+    p = subparsers.add_parser('bdev_rcache_create',
+                              help='Add a read cache bdev on existing bdev')
+    p.add_argument('-b', '--base-bdev-name', help="Name of the existing bdev", required=True)
+    p.add_argument('-c', '--name', help="Name of the rcache bdev", required=True)
+    p.add_argument('-u', '--uuid', help='UUID of the bdev (optional)')
+    p.set_defaults(func=bdev_rcache_create)
+
+    def bdev_rcache_delete(args):
+        rpc.bdev.bdev_rcache_delete(args.client,
+                                    name=args.name)
+
+    p = subparsers.add_parser('bdev_rcache_delete', help='Delete a read cache bdev')
+    p.add_argument('name', help='rcache bdev name')
+    p.set_defaults(func=bdev_rcache_delete)
+
     def bdev_delay_update_latency(args):
         print_json(rpc.bdev.bdev_delay_update_latency(args.client,
                                                       delay_bdev_name=args.delay_bdev_name,
@@ -1259,6 +1342,14 @@ if __name__ == "__main__":
     p.add_argument('name', help='bdev name')
     p.set_defaults(func=bdev_get_histogram)
 
+    def bdev_get_latency_percentiles(args):
+        print_dict(rpc.bdev.bdev_get_latency_percentiles(args.client, name=args.name))
+
+    p = subparsers.add_parser('bdev_get_latency_percentiles',
+                              help='Get latency percentiles for specified bdev')
+    p.add_argument('name', help='bdev name')
+    p.set_defaults(func=bdev_get_latency_percentiles)
+
     def bdev_set_qd_sampling_period(args):
         rpc.bdev.bdev_set_qd_sampling_period(args.client,
                                              name=args.name,
@@ -1272,6 +1363,19 @@ if __name__ == "__main__":
                    type=int)
     p.set_defaults(func=bdev_set_qd_sampling_period)
 
+    def bdev_set_stat_subscription_period(args):
+        rpc.bdev.bdev_set_stat_subscription_period(args.client,
+                                                   name=args.name,
+                                                   period=args.period)
+
+    p = subparsers.add_parser('bdev_set_stat_subscription_period',
+                              help="Enable or disable periodic stat publishing for a bdev.")
+    p.add_argument('name', help='Blockdev name. Example: Malloc0')
+    p.add_argument('period', help='Period with which each channel publishes its I/O stats in microseconds.'
+                   ' If set to 0, publishing will be disabled.',
+                   type=int)
+    p.set_defaults(func=bdev_set_stat_subscription_period)
+
     def bdev_set_qos_limit(args):
         rpc.bdev.bdev_set_qos_limit(args.client,
                                     name=args.name,
@@ -1370,6 +1474,7 @@ if __name__ == "__main__":
             allow_duplicated_isid=args.allow_duplicated_isid,
             max_large_datain_per_connection=args.max_large_datain_per_connection,
             max_r2t_per_connection=args.max_r2t_per_connection,
+            max_logins_per_poll_group=args.max_logins_per_poll_group,
             pdu_pool_size=args.pdu_pool_size,
             immediate_data_pool_size=args.immediate_data_pool_size,
             data_out_pool_size=args.data_out_pool_size)
@@ -1398,6 +1503,7 @@ if __name__ == "__main__":
     p.add_argument('-p', '--allow-duplicated-isid', help='Allow duplicated initiator session ID.', action='store_true')
     p.add_argument('-x', '--max-large-datain-per-connection', help='Max number of outstanding split read I/Os per connection', type=int)
     p.add_argument('-k', '--max-r2t-per-connection', help='Max number of outstanding R2Ts per connection', type=int)
+    p.add_argument('--max-logins-per-poll-group', help='Max number of concurrent logins per poll group', type=int)
     p.add_argument('-u', '--pdu-pool-size', help='Number of PDUs in the pool', type=int)
     p.add_argument('-j', '--immediate-data-pool-size', help='Number of immediate data buffers in the pool', type=int)
     p.add_argument('-z', '--data-out-pool-size', help='Number of data out buffers in the pool', type=int)
@@ -1925,6 +2031,20 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
         type=lambda m: int(m, 16))
     p.set_defaults(func=trace_clear_tpoint_mask)
 
+    def trace_set_tpoint_sample_rate(args):
+        rpc.trace.trace_set_tpoint_sample_rate(args.client, name=args.name, rate=args.rate)
+
+    p = subparsers.add_parser('trace_set_tpoint_sample_rate',
+                              help='set sampling rate on a specific tpoint group')
+    p.add_argument(
+        'name', help="""trace group name we want to set the sampling rate for.
+        (for example "bdev" for bdev trace group)""")
+    p.add_argument(
+        'rate', help="""record one in every "rate" occurrences of an enabled tracepoint in this group.
+        (for example value of 100 will record every 100th occurrence, 0 or 1 will record all of them)""",
+        type=int)
+    p.set_defaults(func=trace_set_tpoint_sample_rate)
+
     def trace_get_tpoint_group_mask(args):
         print_dict(rpc.trace.trace_get_tpoint_group_mask(args.client))
 
@@ -2093,18 +2213,22 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
 
     def bdev_lvol_inflate(args):
         rpc.lvol.bdev_lvol_inflate(args.client,
-                                   name=args.name)
+                                   name=args.name,
+                                   max_in_flight=args.max_in_flight)
 
     p = subparsers.add_parser('bdev_lvol_inflate', help='Make thin provisioned lvol a thick provisioned lvol')
     p.add_argument('name', help='lvol bdev name')
+    p.add_argument('--max-in-flight', help='maximum number of cluster copies kept in flight', type=int)
     p.set_defaults(func=bdev_lvol_inflate)
 
     def bdev_lvol_decouple_parent(args):
         rpc.lvol.bdev_lvol_decouple_parent(args.client,
-                                           name=args.name)
+                                           name=args.name,
+                                           max_in_flight=args.max_in_flight)
 
     p = subparsers.add_parser('bdev_lvol_decouple_parent', help='Decouple parent of lvol')
     p.add_argument('name', help='lvol bdev name')
+    p.add_argument('--max-in-flight', help='maximum number of cluster copies kept in flight', type=int)
     p.set_defaults(func=bdev_lvol_decouple_parent)
 
     def bdev_lvol_resize(args):
@@ -2205,12 +2329,15 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
 
     def bdev_raid_set_options(args):
         rpc.bdev.bdev_raid_set_options(args.client,
-                                       process_window_size_kb=args.process_window_size_kb)
+                                       process_window_size_kb=args.process_window_size_kb,
+                                       process_max_bandwidth_mb_sec=args.process_max_bandwidth_mb_sec)
 
     p = subparsers.add_parser('bdev_raid_set_options',
                               help='Set options for bdev raid.')
     p.add_argument('-w', '--process-window-size-kb', type=int,
                    help="Background process (e.g. rebuild) window size in KiB")
+    p.add_argument('-b', '--process-max-bandwidth-mb-sec', type=int,
+                   help="Background process (e.g. rebuild) maximum bandwidth in MiB/s, 0 for unlimited")
 
     p.set_defaults(func=bdev_raid_set_options)
 
@@ -2265,6 +2392,16 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('base_bdev', help='base bdev name')
     p.set_defaults(func=bdev_raid_add_base_bdev)
 
+    def bdev_raid_grow_base_bdev(args):
+        rpc.bdev.bdev_raid_grow_base_bdev(args.client,
+                                          raid_bdev=args.raid_bdev,
+                                          base_bdev=args.base_bdev)
+    p = subparsers.add_parser('bdev_raid_grow_base_bdev',
+                              help='Add a new base bdev to an existing raid bdev, growing the raid\'s capacity')
+    p.add_argument('raid_bdev', help='raid bdev name')
+    p.add_argument('base_bdev', help='base bdev name')
+    p.set_defaults(func=bdev_raid_grow_base_bdev)
+
     def bdev_raid_remove_base_bdev(args):
         rpc.bdev.bdev_raid_remove_base_bdev(args.client,
                                             name=args.name)
@@ -2272,6 +2409,15 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('name', help='base bdev name')
     p.set_defaults(func=bdev_raid_remove_base_bdev)
 
+    def bdev_raid_set_read_policy(args):
+        rpc.bdev.bdev_raid_set_read_policy(args.client,
+                                           name=args.name,
+                                           policy=args.policy)
+    p = subparsers.add_parser('bdev_raid_set_read_policy', help='Set read selection policy of raid bdev')
+    p.add_argument('name', help='raid bdev name')
+    p.add_argument('policy', help="read selection policy, 'outstanding', 'latency' or 'affinity'")
+    p.set_defaults(func=bdev_raid_set_read_policy)
+
     # split
     def bdev_split_create(args):
         print_array(rpc.bdev.bdev_split_create(args.client,
@@ -2307,7 +2453,9 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                                             overprovisioning=args.overprovisioning,
                                             l2p_dram_limit=args.l2p_dram_limit,
                                             core_mask=args.core_mask,
-                                            fast_shutdown=args.fast_shutdown))
+                                            fast_shutdown=args.fast_shutdown,
+                                            nv_cache_compaction_concurrency=args.nv_cache_compaction_concurrency,
+                                            cache_dax_path=args.cache_dax_path))
 
     p = subparsers.add_parser('bdev_ftl_create', help='Add FTL bdev')
     p.add_argument('-b', '--name', help="Name of the bdev", required=True)
@@ -2324,6 +2472,10 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('--core-mask', help='CPU core mask - which cores will be used for ftl core thread, '
                    'by default core thread will be set to the main application core (optional)')
     p.add_argument('-f', '--fast-shutdown', help="Enable fast shutdown", action='store_true')
+    p.add_argument('--nv-cache-compaction-concurrency', help='Number of parallel compaction processes '
+                   'draining the cache device (optional); default 8', type=int)
+    p.add_argument('--cache-dax-path', help='Path to a DAX device or file mapping the cache device '
+                   'storage - cache IO bypasses the bdev stack through the mapping (optional)')
     p.set_defaults(func=bdev_ftl_create)
 
     def bdev_ftl_load(args):
@@ -2335,7 +2487,9 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                                           overprovisioning=args.overprovisioning,
                                           l2p_dram_limit=args.l2p_dram_limit,
                                           core_mask=args.core_mask,
-                                          fast_shutdown=args.fast_shutdown))
+                                          fast_shutdown=args.fast_shutdown,
+                                          nv_cache_compaction_concurrency=args.nv_cache_compaction_concurrency,
+                                          cache_dax_path=args.cache_dax_path))
 
     p = subparsers.add_parser('bdev_ftl_load', help='Load FTL bdev')
     p.add_argument('-b', '--name', help="Name of the bdev", required=True)
@@ -2351,6 +2505,10 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('--core-mask', help='CPU core mask - which cores will be used for ftl core thread, '
                    'by default core thread will be set to the main application core (optional)')
     p.add_argument('-f', '--fast-shutdown', help="Enable fast shutdown", action='store_true')
+    p.add_argument('--nv-cache-compaction-concurrency', help='Number of parallel compaction processes '
+                   'draining the cache device (optional); default 8', type=int)
+    p.add_argument('--cache-dax-path', help='Path to a DAX device or file mapping the cache device '
+                   'storage - cache IO bypasses the bdev stack through the mapping (optional)')
     p.set_defaults(func=bdev_ftl_load)
 
     def bdev_ftl_unload(args):
@@ -2429,11 +2587,14 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     def ublk_create_target(args):
         rpc.ublk.ublk_create_target(args.client,
                                     cpumask=args.cpumask,
-                                    disable_user_copy=args.disable_user_copy)
+                                    disable_user_copy=args.disable_user_copy,
+                                    enable_sqpoll=args.enable_sqpoll)
     p = subparsers.add_parser('ublk_create_target',
                               help='Create spdk ublk target for ublk dev')
     p.add_argument('-m', '--cpumask', help='cpu mask for ublk dev')
     p.add_argument('--disable-user-copy', help='Disable user copy feature', action='store_true')
+    p.add_argument('--enable-sqpoll', help='Use SQPOLL for IO rings (requires user copy)',
+                   action='store_true')
     p.set_defaults(func=ublk_create_target)
 
     def ublk_destroy_target(args):
@@ -2566,6 +2727,8 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     Relevant only for RDMA transport""", type=int)
     p.add_argument('-s', '--max-srq-depth', help='Max number of outstanding I/O per SRQ. Relevant only for RDMA transport', type=int)
     p.add_argument('-r', '--no-srq', action='store_true', help='Disable per-thread shared receive queue. Relevant only for RDMA transport')
+    p.add_argument('--srq-autoscale', action='store_true', help="""Allocate SRQ receive buffers in chunks and grow/shrink them with the
+    observed load instead of allocating max_srq_depth up front. Relevant only for RDMA transport""")
     p.add_argument('-o', '--c2h-success', action='store_false', help='Disable C2H success optimization. Relevant only for TCP transport')
     p.add_argument('-f', '--dif-insert-or-strip', action='store_true', help='Enable DIF insert/strip. Relevant only for TCP transport')
     p.add_argument('-y', '--sock-priority', help='The sock priority of the tcp connection. Relevant only for TCP transport', type=int)
@@ -2574,6 +2737,11 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('-w', '--no-wr-batching', action='store_true', help='Disable work requests batching. Relevant only for RDMA transport')
     p.add_argument('-e', '--control-msg-num', help="""The number of control messages per poll group.
     Relevant only for TCP transport""", type=int)
+    p.add_argument('--disable-recv-pipe', dest='enable_recv_pipe', action='store_false',
+                   help="""Receive data PDU payloads directly into request buffers, bypassing the
+    socket receive pipe. Relevant only for TCP transport""")
+    p.add_argument('--listener-shards', help="""The number of SO_REUSEPORT-sharded listen sockets
+    created per listen address. Relevant only for TCP transport""", type=int)
     p.add_argument('-M', '--disable-mappable-bar0', action='store_true', help="""Disable mmap() of BAR0.
     Relevant only for VFIO-USER transport""")
     p.add_argument('-I', '--disable-adaptive-irq', action='store_true', help="""Disable adaptive interrupt feature.
@@ -2806,7 +2974,9 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                                          tgt_name=args.tgt_name,
                                          psk=args.psk,
                                          dhchap_key=args.dhchap_key,
-                                         dhchap_ctrlr_key=args.dhchap_ctrlr_key)
+                                         dhchap_ctrlr_key=args.dhchap_ctrlr_key,
+                                         max_ios_per_sec=args.max_ios_per_sec,
+                                         max_mbytes_per_sec=args.max_mbytes_per_sec)
 
     p = subparsers.add_parser('nvmf_subsystem_add_host', help='Add a host to an NVMe-oF subsystem')
     p.add_argument('nqn', help='NVMe-oF subsystem NQN')
@@ -2815,8 +2985,27 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('--psk', help='Path to PSK file for TLS authentication (optional). Only applicable for TCP transport.', type=str)
     p.add_argument('--dhchap-key', help='DH-HMAC-CHAP key name (optional)')
     p.add_argument('--dhchap-ctrlr-key', help='DH-HMAC-CHAP controller key name (optional)')
+    p.add_argument('--max-ios-per-sec', help='Max I/O per second from this host, 0 for unlimited (optional)', type=int)
+    p.add_argument('--max-mbytes-per-sec', help='Max read/write throughput from this host in MiB/s, 0 for unlimited (optional)', type=int)
     p.set_defaults(func=nvmf_subsystem_add_host)
 
+    def nvmf_subsystem_set_host_qos(args):
+        rpc.nvmf.nvmf_subsystem_set_host_qos(args.client,
+                                             nqn=args.nqn,
+                                             host=args.host,
+                                             tgt_name=args.tgt_name,
+                                             max_ios_per_sec=args.max_ios_per_sec,
+                                             max_mbytes_per_sec=args.max_mbytes_per_sec)
+
+    p = subparsers.add_parser('nvmf_subsystem_set_host_qos',
+                              help='Set QoS rate limits for a host of an NVMe-oF subsystem')
+    p.add_argument('nqn', help='NVMe-oF subsystem NQN')
+    p.add_argument('host', help='Host NQN to set the QoS limits for')
+    p.add_argument('-t', '--tgt-name', help='The name of the parent NVMe-oF target (optional)', type=str)
+    p.add_argument('--max-ios-per-sec', help='Max I/O per second from this host, 0 for unlimited (optional)', type=int)
+    p.add_argument('--max-mbytes-per-sec', help='Max read/write throughput from this host in MiB/s, 0 for unlimited (optional)', type=int)
+    p.set_defaults(func=nvmf_subsystem_set_host_qos)
+
     def nvmf_subsystem_remove_host(args):
         rpc.nvmf.nvmf_subsystem_remove_host(args.client,
                                             nqn=args.nqn,
@@ -2883,6 +3072,15 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
     p.add_argument('-t', '--tgt-name', help='The name of the parent NVMe-oF target (optional)', type=str)
     p.set_defaults(func=nvmf_get_stats)
 
+    def nvmf_subsystem_get_ns_stats(args):
+        print_dict(rpc.nvmf.nvmf_subsystem_get_ns_stats(args.client, nqn=args.nqn, tgt_name=args.tgt_name))
+
+    p = subparsers.add_parser(
+        'nvmf_subsystem_get_ns_stats', help='Display per-namespace I/O statistics of an NVMe-oF subsystem')
+    p.add_argument('nqn', help='NVMe-oF subsystem NQN')
+    p.add_argument('-t', '--tgt-name', help='The name of the parent NVMe-oF target (optional)', type=str)
+    p.set_defaults(func=nvmf_subsystem_get_ns_stats)
+
     def nvmf_set_crdt(args):
         print_dict(rpc.nvmf.nvmf_set_crdt(args.client, args.crdt1, args.crdt2, args.crdt3))
 
@@ -3448,6 +3646,18 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
         'thread_get_stats', help='Display current statistics of all the threads')
     p.set_defaults(func=thread_get_stats)
 
+    def thread_stats_shm_enable(args):
+        print_dict(rpc.app.thread_stats_shm_enable(args.client,
+                                                   shm_name=args.shm_name,
+                                                   max_threads=args.max_threads))
+
+    p = subparsers.add_parser(
+        'thread_stats_shm_enable',
+        help='Start publishing thread and poller statistics into a shared-memory segment')
+    p.add_argument('-s', '--shm-name', help='Name of the shared-memory segment to create')
+    p.add_argument('-m', '--max-threads', help='Number of thread slots to allocate in the segment', type=int)
+    p.set_defaults(func=thread_stats_shm_enable)
+
     def thread_set_cpumask(args):
         ret = rpc.app.thread_set_cpumask(args.client,
                                          id=args.id,
@@ -3548,7 +3758,11 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                                        enable_zerocopy_send_client=args.enable_zerocopy_send_client,
                                        zerocopy_threshold=args.zerocopy_threshold,
                                        tls_version=args.tls_version,
-                                       enable_ktls=args.enable_ktls)
+                                       enable_ktls=args.enable_ktls,
+                                       enable_dynamic_zerocopy=args.enable_dynamic_zerocopy,
+                                       max_pacing_rate=args.max_pacing_rate,
+                                       notsent_lowat=args.notsent_lowat,
+                                       max_flushes_per_poll=args.max_flushes_per_poll)
 
     p = subparsers.add_parser('sock_impl_set_options', help="""Set options of socket layer implementation""")
     p.add_argument('-i', '--impl', help='Socket implementation name, e.g. posix', required=True)
@@ -3577,9 +3791,17 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                    action='store_true', dest='enable_ktls')
     p.add_argument('--disable-ktls', help='Disable Kernel TLS',
                    action='store_false', dest='enable_ktls')
+    p.add_argument('--enable-dynamic-zerocopy', help='Enable per-connection adaptive zerocopy threshold',
+                   action='store_true', dest='enable_dynamic_zerocopy')
+    p.add_argument('--disable-dynamic-zerocopy', help='Disable per-connection adaptive zerocopy threshold',
+                   action='store_false', dest='enable_dynamic_zerocopy')
+    p.add_argument('--max-pacing-rate', help='Set maximum socket pacing rate in bytes per second, 0 to disable', type=int)
+    p.add_argument('--notsent-lowat', help='Set limit on not-yet-sent bytes queued in the kernel, 0 for kernel default', type=int)
+    p.add_argument('--max-flushes-per-poll', help='Set limit on sockets flushed per poll group iteration, 0 to flush all', type=int)
     p.set_defaults(func=sock_impl_set_options, enable_recv_pipe=None, enable_quickack=None,
                    enable_placement_id=None, enable_zerocopy_send_server=None, enable_zerocopy_send_client=None,
-                   zerocopy_threshold=None, tls_version=None, enable_ktls=None)
+                   zerocopy_threshold=None, tls_version=None, enable_ktls=None, enable_dynamic_zerocopy=None,
+                   max_pacing_rate=None, notsent_lowat=None, max_flushes_per_poll=None)
 
     def sock_set_default_impl(args):
         print_json(rpc.sock.sock_set_default_impl(args.client,
@@ -3699,14 +3921,55 @@ Format: 'user:u1 secret:s1 muser:mu1 msecret:ms1,user:u2 secret:s2 muser:mu2 mse
                                     small_pool_count=args.small_pool_count,
                                     large_pool_count=args.large_pool_count,
                                     small_bufsize=args.small_bufsize,
-                                    large_bufsize=args.large_bufsize)
+                                    large_bufsize=args.large_bufsize,
+                                    enable_numa=args.enable_numa,
+                                    cache_rebalance_period_us=args.cache_rebalance_period_us,
+                                    small_pool_max_count=args.small_pool_max_count,
+                                    large_pool_max_count=args.large_pool_max_count,
+                                    cache_idle_reclaim_us=args.cache_idle_reclaim_us)
     p = subparsers.add_parser('iobuf_set_options', help='Set iobuf pool options')
     p.add_argument('--small-pool-count', help='number of small buffers in the global pool', type=int)
     p.add_argument('--large-pool-count', help='number of large buffers in the global pool', type=int)
     p.add_argument('--small-bufsize', help='size of a small buffer', type=int)
     p.add_argument('--large-bufsize', help='size of a large buffer', type=int)
+    p.add_argument('--enable-numa', help='allocate backing pools per NUMA node', action='store_true',
+                   default=None)
+    p.add_argument('--cache-rebalance-period-us', help='period of the per-thread cache rebalancer '
+                   'in microseconds, 0 to disable', type=int)
+    p.add_argument('--small-pool-max-count', help='maximum number of small buffers the pool can be '
+                   'grown to at runtime, 0 to disable growth', type=int)
+    p.add_argument('--large-pool-max-count', help='maximum number of large buffers the pool can be '
+                   'grown to at runtime, 0 to disable growth', type=int)
+    p.add_argument('--cache-idle-reclaim-us', help='idle period after which cached buffers are '
+                   'returned to the shared pool, in microseconds, 0 to disable', type=int)
     p.set_defaults(func=iobuf_set_options)
 
+    def iobuf_pool_grow(args):
+        rpc.iobuf.iobuf_pool_grow(args.client,
+                                  small_pool_count=args.small_pool_count,
+                                  large_pool_count=args.large_pool_count,
+                                  numa_node=args.numa_node)
+
+    p = subparsers.add_parser('iobuf_pool_grow', help='Grow the iobuf pools at runtime')
+    p.add_argument('--small-pool-count', help='number of small buffers to add to the global pool', type=int)
+    p.add_argument('--large-pool-count', help='number of large buffers to add to the global pool', type=int)
+    p.add_argument('--numa-node', help='NUMA node to allocate the new buffers on, '
+                   'spread across all nodes if not specified', type=int)
+    p.set_defaults(func=iobuf_pool_grow)
+
+    def iobuf_pool_shrink(args):
+        rpc.iobuf.iobuf_pool_shrink(args.client,
+                                    small_pool_count=args.small_pool_count,
+                                    large_pool_count=args.large_pool_count,
+                                    numa_node=args.numa_node)
+
+    p = subparsers.add_parser('iobuf_pool_shrink', help='Shrink the iobuf pools at runtime')
+    p.add_argument('--small-pool-count', help='maximum number of small buffers to remove from the global pool', type=int)
+    p.add_argument('--large-pool-count', help='maximum number of large buffers to remove from the global pool', type=int)
+    p.add_argument('--numa-node', help='NUMA node to free buffers on, '
+                   'consider all nodes if not specified', type=int)
+    p.set_defaults(func=iobuf_pool_shrink)
+
     def iobuf_get_stats(args):
         print_dict(rpc.iobuf.iobuf_get_stats(args.client))
 
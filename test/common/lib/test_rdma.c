@@ -11,9 +11,23 @@
 #define RDMA_UT_LKEY 123
 #define RDMA_UT_RKEY 312
 
+struct spdk_rdma_cq {
+	struct ibv_cq *cq;
+};
+
 struct spdk_nvme_transport_opts g_spdk_nvme_transport_opts = {};
 struct spdk_rdma_qp g_spdk_rdma_qp = {};
 struct spdk_rdma_srq g_spdk_rdma_srq = {};
+struct spdk_rdma_cq g_spdk_rdma_cq = {};
+struct ibv_cq g_spdk_rdma_ibv_cq = {};
+DEFINE_STUB(spdk_rdma_cq_create, struct spdk_rdma_cq *,
+	    (struct spdk_rdma_cq_init_attr *cq_attr), &g_spdk_rdma_cq);
+DEFINE_STUB_V(spdk_rdma_cq_destroy, (struct spdk_rdma_cq *rdma_cq));
+DEFINE_STUB(spdk_rdma_cq_resize, int, (struct spdk_rdma_cq *rdma_cq, int cqe), 0);
+DEFINE_STUB(spdk_rdma_cq_poll, int, (struct spdk_rdma_cq *rdma_cq, int num_entries,
+				     struct ibv_wc *wc), 0);
+DEFINE_STUB(spdk_rdma_cq_get_ibv_cq, struct ibv_cq *, (struct spdk_rdma_cq *rdma_cq),
+	    &g_spdk_rdma_ibv_cq);
 DEFINE_STUB(spdk_rdma_qp_create, struct spdk_rdma_qp *, (struct rdma_cm_id *cm_id,
 		struct spdk_rdma_qp_init_attr *qp_attr), &g_spdk_rdma_qp);
 DEFINE_STUB(spdk_rdma_qp_accept, int, (struct spdk_rdma_qp *spdk_rdma_qp,
@@ -465,6 +465,44 @@ test_mem_map_registration_adjacent(void)
 	CU_ASSERT(map == NULL);
 }
 
+static void
+test_mem_map_registration_batch(void)
+{
+	struct spdk_mem_map *map;
+	uint64_t default_translation = 0xDEADBEEF0BADF00D;
+	size_t notify_len[PAGE_ARRAY_SIZE] = {0};
+	struct iovec iov[] = {
+		{ .iov_base = (void *)0, .iov_len = VALUE_2MB },
+		{ .iov_base = (void *)VALUE_2MB, .iov_len = VALUE_2MB },
+		{ .iov_base = (void *)(4 * VALUE_2MB), .iov_len = VALUE_2MB },
+		{ .iov_base = (void *)(5 * VALUE_2MB), .iov_len = 2 * VALUE_2MB },
+	};
+	int rc;
+
+	map = spdk_mem_map_alloc(default_translation,
+				 &test_map_ops_notify_checklen, notify_len);
+	SPDK_CU_ASSERT_FATAL(map != NULL);
+
+	/* The first two and the last two entries are virtually contiguous, so
+	 * the batch is expected to be coalesced into two notifications.
+	 */
+	notify_len[0] = 2 * VALUE_2MB;
+	notify_len[4] = 3 * VALUE_2MB;
+	rc = spdk_mem_register_batch(iov, SPDK_COUNTOF(iov));
+	CU_ASSERT(rc == 0);
+
+	/* Registering any entry of the batch again must fail */
+	rc = spdk_mem_register_batch(iov, 1);
+	CU_ASSERT(rc == -EBUSY);
+
+	/* Unregistering coalesces the same way, matching the registered regions */
+	rc = spdk_mem_unregister_batch(iov, SPDK_COUNTOF(iov));
+	CU_ASSERT(rc == 0);
+
+	spdk_mem_map_free(&map);
+	CU_ASSERT(map == NULL);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -497,7 +535,8 @@ main(int argc, char **argv)
 		CU_add_test(suite, "alloc and free memory map", test_mem_map_alloc_free) == NULL ||
 		CU_add_test(suite, "mem map translation", test_mem_map_translation) == NULL ||
 		CU_add_test(suite, "mem map registration", test_mem_map_registration) == NULL ||
-		CU_add_test(suite, "mem map adjacent registrations", test_mem_map_registration_adjacent) == NULL
+		CU_add_test(suite, "mem map adjacent registrations", test_mem_map_registration_adjacent) == NULL ||
+		CU_add_test(suite, "mem map batch registrations", test_mem_map_registration_batch) == NULL
 	) {
 		CU_cleanup_registry();
 		return CU_get_error();
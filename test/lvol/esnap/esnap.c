@@ -232,7 +232,7 @@ esnap_clone_io(void)
 	struct spdk_bdev_desc *lvol_desc = NULL;
 	const char bs_malloc_uuid[SPDK_UUID_STRING_LEN] = "11110049-cf29-4681-ab4b-5dd16de6cd81";
 	const char esnap_uuid[SPDK_UUID_STRING_LEN] = "222251be-1ece-434d-8513-6944d5c93a53";
-	struct malloc_bdev_opts malloc_opts = { 0 };
+	struct malloc_bdev_opts malloc_opts = { .socket_id = SPDK_ENV_SOCKET_ID_ANY };
 	const uint32_t bs_size_bytes = 10 * 1024 * 1024;
 	const uint32_t bs_block_size = 4096;
 	const uint32_t cluster_size = 32 * 1024;
@@ -358,7 +358,7 @@ static void
 esnap_hotplug(void)
 {
 	const char *uuid_esnap = "22218fb6-6743-483d-88b1-de643dc7c0bc";
-	struct malloc_bdev_opts malloc_opts = { 0 };
+	struct malloc_bdev_opts malloc_opts = { .socket_id = SPDK_ENV_SOCKET_ID_ANY };
 	const uint32_t bs_size_bytes = 10 * 1024 * 1024;
 	const uint32_t bs_block_size = 4096;
 	const uint32_t cluster_size = 32 * 1024;
@@ -458,7 +458,7 @@ static void
 esnap_remove_degraded(void)
 {
 	const char *uuid_esnap = "33358eb9-3dcf-4275-b089-0becc126fc3d";
-	struct malloc_bdev_opts malloc_opts = { 0 };
+	struct malloc_bdev_opts malloc_opts = { .socket_id = SPDK_ENV_SOCKET_ID_ANY };
 	const uint32_t bs_size_bytes = 10 * 1024 * 1024;
 	const uint32_t bs_block_size = 4096;
 	const uint32_t cluster_size = 32 * 1024;
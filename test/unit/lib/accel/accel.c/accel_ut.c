@@ -254,6 +254,166 @@ test_spdk_accel_submit_copy(void)
 	CU_ASSERT(expected_accel_task == &task);
 }
 
+static void
+test_spdk_accel_submit_copy_numa_fallback(void)
+{
+	struct spdk_io_channel *fallback_ch;
+	struct sw_accel_io_channel *fallback_sw_ch;
+	uint8_t small_dst[TEST_SUBMIT_SIZE] = {0};
+	uint8_t small_src[TEST_SUBMIT_SIZE] = {0};
+	uint8_t *large_dst, *large_src;
+	uint64_t large_nbytes = g_opts.cross_socket_size_threshold + 1;
+	struct spdk_accel_task task;
+	struct spdk_accel_task_aux_data task_aux;
+	struct spdk_accel_task *expected_accel_task = NULL;
+	int rc;
+
+	STAILQ_INIT(&g_accel_ch->task_pool);
+	SLIST_INIT(&g_accel_ch->task_aux_data_pool);
+
+	fallback_ch = calloc(1, sizeof(struct spdk_io_channel) + sizeof(struct sw_accel_io_channel));
+	SPDK_CU_ASSERT_FATAL(fallback_ch != NULL);
+	fallback_sw_ch = (struct sw_accel_io_channel *)((char *)fallback_ch + sizeof(
+				struct spdk_io_channel));
+	fallback_sw_ch->completion_poller = (void *)0xdeadbeef;
+	STAILQ_INIT(&fallback_sw_ch->tasks_to_complete);
+
+	g_accel_ch->numa_fallback_ch[SPDK_ACCEL_OPC_COPY] = fallback_ch;
+	g_numa_fallback_module = &g_module_if;
+
+	/* An operation at or below the threshold goes to the fallback channel. */
+	task.accel_ch = g_accel_ch;
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux, link);
+	memset(small_src, 0x5a, TEST_SUBMIT_SIZE);
+
+	rc = spdk_accel_submit_copy(g_ch, small_dst, small_src, TEST_SUBMIT_SIZE, NULL, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(memcmp(small_dst, small_src, TEST_SUBMIT_SIZE) == 0);
+	CU_ASSERT(STAILQ_EMPTY(&g_sw_ch->tasks_to_complete));
+	expected_accel_task = STAILQ_FIRST(&fallback_sw_ch->tasks_to_complete);
+	STAILQ_REMOVE_HEAD(&fallback_sw_ch->tasks_to_complete, link);
+	CU_ASSERT(expected_accel_task == &task);
+
+	/* An operation above the threshold stays on the assigned module channel. */
+	large_dst = calloc(1, large_nbytes);
+	large_src = calloc(1, large_nbytes);
+	SPDK_CU_ASSERT_FATAL(large_dst != NULL && large_src != NULL);
+	memset(large_src, 0xa5, large_nbytes);
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux, link);
+
+	rc = spdk_accel_submit_copy(g_ch, large_dst, large_src, large_nbytes, NULL, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(memcmp(large_dst, large_src, large_nbytes) == 0);
+	CU_ASSERT(STAILQ_EMPTY(&fallback_sw_ch->tasks_to_complete));
+	expected_accel_task = STAILQ_FIRST(&g_sw_ch->tasks_to_complete);
+	STAILQ_REMOVE_HEAD(&g_sw_ch->tasks_to_complete, link);
+	CU_ASSERT(expected_accel_task == &task);
+
+	g_accel_ch->numa_fallback_ch[SPDK_ACCEL_OPC_COPY] = NULL;
+	g_numa_fallback_module = NULL;
+	free(large_dst);
+	free(large_src);
+	free(fallback_ch);
+}
+
+static void
+test_spdk_accel_submit_compress_adaptive(void)
+{
+	struct spdk_io_channel *sw_alt_ch;
+	struct sw_accel_io_channel *sw_alt_sw_ch;
+	struct accel_dispatch_class *class;
+	uint8_t dst[TEST_SUBMIT_SIZE] = {0};
+	uint8_t src[TEST_SUBMIT_SIZE] = {0};
+	struct iovec src_iovs = { .iov_base = src, .iov_len = TEST_SUBMIT_SIZE };
+	struct spdk_accel_task task;
+	struct spdk_accel_task_aux_data task_aux;
+	struct spdk_accel_task *expected_accel_task = NULL;
+	uint32_t output_size;
+	uint32_t cb_arg = DUMMY_ARG;
+	int rc;
+
+	STAILQ_INIT(&g_accel_ch->task_pool);
+	SLIST_INIT(&g_accel_ch->task_aux_data_pool);
+
+	sw_alt_ch = calloc(1, sizeof(struct spdk_io_channel) + sizeof(struct sw_accel_io_channel));
+	SPDK_CU_ASSERT_FATAL(sw_alt_ch != NULL);
+	sw_alt_sw_ch = (struct sw_accel_io_channel *)((char *)sw_alt_ch + sizeof(
+				struct spdk_io_channel));
+	sw_alt_sw_ch->completion_poller = (void *)0xdeadbeef;
+	STAILQ_INIT(&sw_alt_sw_ch->tasks_to_complete);
+
+	g_accel_ch->compress_sw_ch = sw_alt_ch;
+	g_compress_sw_module = &g_module_if;
+
+	/* TEST_SUBMIT_SIZE is below the base size, so everything lands in class 0 */
+	class = &g_accel_ch->compress_classes[0][0];
+	memset(class, 0, sizeof(*class));
+
+	/* The software engine is unmeasured, so the first task probes it. */
+	task.accel_ch = g_accel_ch;
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux, link);
+	MOCK_SET(spdk_get_ticks, 1000);
+
+	rc = spdk_accel_submit_compress(g_ch, dst, sizeof(dst), &src_iovs, 1, &output_size,
+					dummy_cb_fn, &cb_arg);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(task.dispatch_engine == 1);
+	CU_ASSERT(task.submit_tsc == 1000);
+	CU_ASSERT(STAILQ_EMPTY(&g_sw_ch->tasks_to_complete));
+	expected_accel_task = STAILQ_FIRST(&sw_alt_sw_ch->tasks_to_complete);
+	STAILQ_REMOVE_HEAD(&sw_alt_sw_ch->tasks_to_complete, link);
+	CU_ASSERT(expected_accel_task == &task);
+
+	/* Completing it records the software engine latency and makes it preferred. */
+	MOCK_SET(spdk_get_ticks, 1100);
+	spdk_accel_task_complete(&task, 0);
+	CU_ASSERT(class->ewma_ticks[1] == 100);
+	CU_ASSERT(class->preferred == 1);
+	STAILQ_REMOVE_HEAD(&g_accel_ch->task_pool, link);
+
+	/* The assigned engine is still unmeasured, so the next task probes it instead. */
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux, link);
+	MOCK_SET(spdk_get_ticks, 2000);
+
+	rc = spdk_accel_submit_compress(g_ch, dst, sizeof(dst), &src_iovs, 1, &output_size,
+					dummy_cb_fn, &cb_arg);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(task.dispatch_engine == 0);
+	CU_ASSERT(STAILQ_EMPTY(&sw_alt_sw_ch->tasks_to_complete));
+	expected_accel_task = STAILQ_FIRST(&g_sw_ch->tasks_to_complete);
+	STAILQ_REMOVE_HEAD(&g_sw_ch->tasks_to_complete, link);
+	CU_ASSERT(expected_accel_task == &task);
+
+	/* The assigned engine measures faster and takes over as preferred. */
+	MOCK_SET(spdk_get_ticks, 2010);
+	spdk_accel_task_complete(&task, 0);
+	CU_ASSERT(class->ewma_ticks[0] == 10);
+	CU_ASSERT(class->preferred == 0);
+	STAILQ_REMOVE_HEAD(&g_accel_ch->task_pool, link);
+
+	/* With both engines measured, tasks follow the preferred (assigned) engine. */
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task, link);
+	SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux, link);
+
+	rc = spdk_accel_submit_compress(g_ch, dst, sizeof(dst), &src_iovs, 1, &output_size,
+					dummy_cb_fn, &cb_arg);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(task.dispatch_engine == 0);
+	CU_ASSERT(STAILQ_EMPTY(&sw_alt_sw_ch->tasks_to_complete));
+	expected_accel_task = STAILQ_FIRST(&g_sw_ch->tasks_to_complete);
+	STAILQ_REMOVE_HEAD(&g_sw_ch->tasks_to_complete, link);
+	CU_ASSERT(expected_accel_task == &task);
+
+	g_accel_ch->compress_sw_ch = NULL;
+	g_compress_sw_module = NULL;
+	MOCK_CLEAR(spdk_get_ticks);
+	free(sw_alt_ch);
+}
+
 static void
 test_spdk_accel_submit_dualcast(void)
 {
@@ -520,6 +680,80 @@ test_spdk_accel_submit_copy_crc32c(void)
 	CU_ASSERT(expected_accel_task == &task);
 }
 
+static void
+test_spdk_accel_submit_batch(void)
+{
+	const uint64_t nbytes = TEST_SUBMIT_SIZE;
+	uint8_t dst[TEST_SUBMIT_SIZE] = {0};
+	uint8_t dst2[TEST_SUBMIT_SIZE] = {0};
+	uint8_t src[TEST_SUBMIT_SIZE];
+	uint32_t crc_dst = 0;
+	struct spdk_accel_submit_entry entries[3] = {};
+	struct spdk_accel_task task[3];
+	struct spdk_accel_task_aux_data task_aux[3];
+	struct spdk_accel_task *expected_accel_task = NULL;
+	int i, rc;
+
+	STAILQ_INIT(&g_accel_ch->task_pool);
+	SLIST_INIT(&g_accel_ch->task_aux_data_pool);
+
+	memset(src, 0x5a, sizeof(src));
+
+	entries[0].opcode = SPDK_ACCEL_OPC_COPY;
+	entries[0].dst = dst;
+	entries[0].src = src;
+	entries[0].nbytes = nbytes;
+	entries[1].opcode = SPDK_ACCEL_OPC_FILL;
+	entries[1].dst = dst2;
+	entries[1].fill = 0xa5;
+	entries[1].nbytes = nbytes;
+	entries[2].opcode = SPDK_ACCEL_OPC_CRC32C;
+	entries[2].crc_dst = &crc_dst;
+	entries[2].src = src;
+	entries[2].seed = 0;
+	entries[2].nbytes = nbytes;
+
+	/* Fail with an unsupported opcode in the batch */
+	entries[1].opcode = SPDK_ACCEL_OPC_COMPRESS;
+	rc = spdk_accel_submit_batch(g_ch, entries, SPDK_COUNTOF(entries));
+	CU_ASSERT(rc == -EINVAL);
+	entries[1].opcode = SPDK_ACCEL_OPC_FILL;
+
+	/* Fail with fewer tasks in the pool than entries, nothing is consumed */
+	for (i = 0; i < 2; ++i) {
+		task[i].accel_ch = g_accel_ch;
+		STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task[i], link);
+		SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux[i], link);
+	}
+	rc = spdk_accel_submit_batch(g_ch, entries, SPDK_COUNTOF(entries));
+	CU_ASSERT(rc == -ENOMEM);
+	CU_ASSERT(STAILQ_FIRST(&g_accel_ch->task_pool) != NULL);
+	CU_ASSERT(STAILQ_EMPTY(&g_sw_ch->tasks_to_complete));
+
+	/* Submission OK - the whole batch is handed to the module as one chain */
+	task[2].accel_ch = g_accel_ch;
+	STAILQ_INSERT_TAIL(&g_accel_ch->task_pool, &task[2], link);
+	SLIST_INSERT_HEAD(&g_accel_ch->task_aux_data_pool, &task_aux[2], link);
+
+	rc = spdk_accel_submit_batch(g_ch, entries, SPDK_COUNTOF(entries));
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(STAILQ_EMPTY(&g_accel_ch->task_pool));
+	CU_ASSERT(memcmp(dst, src, TEST_SUBMIT_SIZE) == 0);
+	for (i = 0; i < TEST_SUBMIT_SIZE; ++i) {
+		CU_ASSERT(dst2[i] == 0xa5);
+	}
+	CU_ASSERT(crc_dst == spdk_crc32c_update(src, TEST_SUBMIT_SIZE, ~0u));
+
+	for (i = 0; i < (int)SPDK_COUNTOF(entries); ++i) {
+		CU_ASSERT(task[i].op_code == entries[i].opcode);
+		expected_accel_task = STAILQ_FIRST(&g_sw_ch->tasks_to_complete);
+		SPDK_CU_ASSERT_FATAL(expected_accel_task != NULL);
+		STAILQ_REMOVE_HEAD(&g_sw_ch->tasks_to_complete, link);
+		CU_ASSERT(expected_accel_task == &task[i]);
+	}
+	CU_ASSERT(STAILQ_EMPTY(&g_sw_ch->tasks_to_complete));
+}
+
 static void
 test_spdk_accel_submit_xor(void)
 {
@@ -4101,6 +4335,313 @@ test_sequence_crc32(void)
 	poll_threads();
 }
 
+static bool
+ut_supports_fused_opcode(enum spdk_accel_opcode fused_opc)
+{
+	return fused_opc == SPDK_ACCEL_OPC_COPY_CRC32C;
+}
+
+static void
+test_sequence_crc32c_fusion(void)
+{
+	struct spdk_accel_sequence *seq = NULL;
+	struct spdk_io_channel *ioch;
+	struct ut_sequence ut_seq;
+	struct accel_module modules[SPDK_ACCEL_OPC_LAST];
+	char buf[4096], tmp[4096];
+	struct iovec src_iovs[2], dst_iovs[2];
+	uint32_t crc;
+	int i, rc, completed;
+
+	ioch = spdk_accel_get_io_channel();
+	SPDK_CU_ASSERT_FATAL(ioch != NULL);
+
+	/* Override the submit_tasks function and advertise fused copy+crc32c support */
+	g_module_if.submit_tasks = ut_sequnce_submit_tasks;
+	g_module_if.supports_fused_opcode = ut_supports_fused_opcode;
+	for (i = 0; i < SPDK_ACCEL_OPC_LAST; ++i) {
+		g_seq_operations[i].submit = sw_accel_submit_tasks;
+		modules[i] = g_modules_opc[i];
+		g_modules_opc[i] = g_module;
+	}
+
+	/* Check that copy+crc32c of the copy's dst is fused into a single task */
+	seq = NULL;
+	completed = 0;
+	crc = 0;
+	memset(buf, 0xa5, sizeof(buf));
+	memset(tmp, 0, sizeof(tmp));
+
+	dst_iovs[0].iov_base = tmp;
+	dst_iovs[0].iov_len = sizeof(tmp);
+	src_iovs[0].iov_base = buf;
+	src_iovs[0].iov_len = sizeof(buf);
+	rc = spdk_accel_append_copy(&seq, ioch, &dst_iovs[0], 1, NULL, NULL,
+				    &src_iovs[0], 1, NULL, NULL,
+				    ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	src_iovs[1].iov_base = tmp;
+	src_iovs[1].iov_len = sizeof(tmp);
+	rc = spdk_accel_append_crc32c(&seq, ioch, &crc, &src_iovs[1], 1, NULL, NULL, 0,
+				      ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	ut_seq.complete = false;
+	spdk_accel_sequence_finish(seq, ut_sequence_complete_cb, &ut_seq);
+
+	poll_threads();
+	CU_ASSERT_EQUAL(completed, 2);
+	CU_ASSERT(ut_seq.complete);
+	CU_ASSERT_EQUAL(ut_seq.status, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY].count, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY_CRC32C].count, 1);
+	CU_ASSERT_EQUAL(memcmp(buf, tmp, sizeof(buf)), 0);
+	CU_ASSERT_EQUAL(crc, spdk_crc32c_update(buf, sizeof(buf), ~0u));
+	g_seq_operations[SPDK_ACCEL_OPC_COPY_CRC32C].count = 0;
+
+	/* Check that crc32c+copy of the crc's src is fused too, even though the copy cannot be
+	 * elided when crc32c is the first operation in a sequence */
+	seq = NULL;
+	completed = 0;
+	crc = 0;
+	memset(buf, 0, sizeof(buf));
+	memset(tmp, 0x5a, sizeof(tmp));
+
+	src_iovs[0].iov_base = tmp;
+	src_iovs[0].iov_len = sizeof(tmp);
+	rc = spdk_accel_append_crc32c(&seq, ioch, &crc, &src_iovs[0], 1, NULL, NULL, 0,
+				      ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	dst_iovs[1].iov_base = buf;
+	dst_iovs[1].iov_len = sizeof(buf);
+	src_iovs[1].iov_base = tmp;
+	src_iovs[1].iov_len = sizeof(tmp);
+	rc = spdk_accel_append_copy(&seq, ioch, &dst_iovs[1], 1, NULL, NULL,
+				    &src_iovs[1], 1, NULL, NULL,
+				    ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	ut_seq.complete = false;
+	spdk_accel_sequence_finish(seq, ut_sequence_complete_cb, &ut_seq);
+
+	poll_threads();
+	CU_ASSERT_EQUAL(completed, 2);
+	CU_ASSERT(ut_seq.complete);
+	CU_ASSERT_EQUAL(ut_seq.status, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY].count, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY_CRC32C].count, 1);
+	CU_ASSERT_EQUAL(memcmp(buf, tmp, sizeof(buf)), 0);
+	CU_ASSERT_EQUAL(crc, spdk_crc32c_update(tmp, sizeof(tmp), ~0u));
+	g_seq_operations[SPDK_ACCEL_OPC_COPY_CRC32C].count = 0;
+
+	/* Check that nothing is fused when the buffers don't match */
+	seq = NULL;
+	completed = 0;
+	crc = 0;
+	memset(buf, 0xa5, sizeof(buf));
+	memset(tmp, 0, sizeof(tmp));
+
+	dst_iovs[0].iov_base = tmp;
+	dst_iovs[0].iov_len = sizeof(tmp);
+	src_iovs[0].iov_base = buf;
+	src_iovs[0].iov_len = sizeof(buf);
+	rc = spdk_accel_append_copy(&seq, ioch, &dst_iovs[0], 1, NULL, NULL,
+				    &src_iovs[0], 1, NULL, NULL,
+				    ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	src_iovs[1].iov_base = tmp;
+	src_iovs[1].iov_len = 2048;
+	rc = spdk_accel_append_crc32c(&seq, ioch, &crc, &src_iovs[1], 1, NULL, NULL, 0,
+				      ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	ut_seq.complete = false;
+	spdk_accel_sequence_finish(seq, ut_sequence_complete_cb, &ut_seq);
+
+	poll_threads();
+	CU_ASSERT_EQUAL(completed, 2);
+	CU_ASSERT(ut_seq.complete);
+	CU_ASSERT_EQUAL(ut_seq.status, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY].count, 1);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count, 1);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY_CRC32C].count, 0);
+	CU_ASSERT_EQUAL(memcmp(buf, tmp, sizeof(buf)), 0);
+	CU_ASSERT_EQUAL(crc, spdk_crc32c_update(buf, 2048, ~0u));
+	g_seq_operations[SPDK_ACCEL_OPC_COPY].count = 0;
+	g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count = 0;
+
+	/* Check that nothing is fused when the module doesn't advertise fused opcodes */
+	g_module_if.supports_fused_opcode = NULL;
+	seq = NULL;
+	completed = 0;
+	crc = 0;
+	memset(buf, 0x5a, sizeof(buf));
+	memset(tmp, 0, sizeof(tmp));
+
+	dst_iovs[0].iov_base = tmp;
+	dst_iovs[0].iov_len = sizeof(tmp);
+	src_iovs[0].iov_base = buf;
+	src_iovs[0].iov_len = sizeof(buf);
+	rc = spdk_accel_append_copy(&seq, ioch, &dst_iovs[0], 1, NULL, NULL,
+				    &src_iovs[0], 1, NULL, NULL,
+				    ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	src_iovs[1].iov_base = tmp;
+	src_iovs[1].iov_len = sizeof(tmp);
+	rc = spdk_accel_append_crc32c(&seq, ioch, &crc, &src_iovs[1], 1, NULL, NULL, 0,
+				      ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	ut_seq.complete = false;
+	spdk_accel_sequence_finish(seq, ut_sequence_complete_cb, &ut_seq);
+
+	poll_threads();
+	CU_ASSERT_EQUAL(completed, 2);
+	CU_ASSERT(ut_seq.complete);
+	CU_ASSERT_EQUAL(ut_seq.status, 0);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY].count, 1);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_CRC32C].count, 1);
+	CU_ASSERT_EQUAL(g_seq_operations[SPDK_ACCEL_OPC_COPY_CRC32C].count, 0);
+	CU_ASSERT_EQUAL(memcmp(buf, tmp, sizeof(buf)), 0);
+	CU_ASSERT_EQUAL(crc, spdk_crc32c_update(buf, sizeof(buf), ~0u));
+
+	for (i = 0; i < SPDK_ACCEL_OPC_LAST; ++i) {
+		g_modules_opc[i] = modules[i];
+	}
+
+	ut_clear_operations();
+	spdk_put_io_channel(ioch);
+	poll_threads();
+}
+
+static void
+test_sequence_dif_generate_verify(void)
+{
+	struct spdk_accel_sequence *seq = NULL;
+	struct spdk_io_channel *ioch;
+	struct ut_sequence ut_seq;
+	struct spdk_dif_ctx dif_ctx = {};
+	struct spdk_dif_error dif_err = {};
+	struct spdk_dif_ctx_init_ext_opts dif_opts;
+	char data[4 * 512], extended[4 * 520];
+	struct iovec src_iov, dst_iov, verify_iov;
+	uint32_t dif_flags = SPDK_DIF_FLAGS_GUARD_CHECK | SPDK_DIF_FLAGS_REFTAG_CHECK |
+			     SPDK_DIF_FLAGS_APPTAG_CHECK;
+	int rc, completed;
+
+	ioch = spdk_accel_get_io_channel();
+	SPDK_CU_ASSERT_FATAL(ioch != NULL);
+
+	dif_opts.size = SPDK_SIZEOF(&dif_opts, dif_pi_format);
+	dif_opts.dif_pi_format = SPDK_DIF_PI_FORMAT_16;
+	rc = spdk_dif_ctx_init(&dif_ctx, 520, 8, true, true, SPDK_DIF_TYPE1, dif_flags,
+			       16, 0xFFFF, 10, 0, 0, &dif_opts);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	/* Insert DIF while copying and verify the result within the same sequence */
+	seq = NULL;
+	completed = 0;
+	memset(data, 0xa5, sizeof(data));
+	memset(extended, 0, sizeof(extended));
+
+	src_iov.iov_base = data;
+	src_iov.iov_len = sizeof(data);
+	dst_iov.iov_base = extended;
+	dst_iov.iov_len = sizeof(extended);
+	rc = spdk_accel_append_dif_generate_copy(&seq, ioch, &dst_iov, 1, NULL, NULL,
+			&src_iov, 1, NULL, NULL, 4, &dif_ctx,
+			ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	verify_iov.iov_base = extended;
+	verify_iov.iov_len = sizeof(extended);
+	rc = spdk_accel_append_dif_verify(&seq, ioch, &verify_iov, 1, NULL, NULL, 4,
+					  &dif_ctx, &dif_err, ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	ut_seq.complete = false;
+	spdk_accel_sequence_finish(seq, ut_sequence_complete_cb, &ut_seq);
+
+	poll_threads();
+	CU_ASSERT_EQUAL(completed, 2);
+	CU_ASSERT(ut_seq.complete);
+	CU_ASSERT_EQUAL(ut_seq.status, 0);
+	CU_ASSERT_EQUAL(memcmp(extended, data, 512), 0);
+
+	/* Strip the DIF back out while verifying it */
+	seq = NULL;
+	completed = 0;
+	memset(data, 0, sizeof(data));
+
+	src_iov.iov_base = extended;
+	src_iov.iov_len = sizeof(extended);
+	dst_iov.iov_base = data;
+	dst_iov.iov_len = sizeof(data);
+	rc = spdk_accel_append_dif_verify_copy(&seq, ioch, &dst_iov, 1, NULL, NULL,
+					       &src_iov, 1, NULL, NULL, 4, &dif_ctx, &dif_err,
+					       ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	ut_seq.complete = false;
+	spdk_accel_sequence_finish(seq, ut_sequence_complete_cb, &ut_seq);
+
+	poll_threads();
+	CU_ASSERT_EQUAL(completed, 1);
+	CU_ASSERT(ut_seq.complete);
+	CU_ASSERT_EQUAL(ut_seq.status, 0);
+	CU_ASSERT_EQUAL((unsigned char)data[0], 0xa5);
+
+	/* Corrupt the protected data - the verify step should fail the sequence */
+	seq = NULL;
+	completed = 0;
+	extended[100] ^= 0xff;
+
+	verify_iov.iov_base = extended;
+	verify_iov.iov_len = sizeof(extended);
+	rc = spdk_accel_append_dif_verify(&seq, ioch, &verify_iov, 1, NULL, NULL, 4,
+					  &dif_ctx, &dif_err, ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	ut_seq.complete = false;
+	spdk_accel_sequence_finish(seq, ut_sequence_complete_cb, &ut_seq);
+
+	poll_threads();
+	CU_ASSERT(ut_seq.complete);
+	CU_ASSERT_NOT_EQUAL(ut_seq.status, 0);
+
+	/* Generate DIF in place and verify it */
+	seq = NULL;
+	completed = 0;
+	memset(extended, 0x5a, sizeof(extended));
+
+	verify_iov.iov_base = extended;
+	verify_iov.iov_len = sizeof(extended);
+	rc = spdk_accel_append_dif_generate(&seq, ioch, &verify_iov, 1, NULL, NULL, 4,
+					    &dif_ctx, ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	rc = spdk_accel_append_dif_verify(&seq, ioch, &verify_iov, 1, NULL, NULL, 4,
+					  &dif_ctx, &dif_err, ut_sequence_step_cb, &completed);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	ut_seq.complete = false;
+	spdk_accel_sequence_finish(seq, ut_sequence_complete_cb, &ut_seq);
+
+	poll_threads();
+	CU_ASSERT_EQUAL(completed, 2);
+	CU_ASSERT(ut_seq.complete);
+	CU_ASSERT_EQUAL(ut_seq.status, 0);
+
+	spdk_put_io_channel(ioch);
+	poll_threads();
+}
+
 static int
 test_sequence_setup(void)
 {
@@ -4187,17 +4728,22 @@ main(int argc, char **argv)
 	CU_ADD_TEST(seq_suite, test_sequence_driver);
 	CU_ADD_TEST(seq_suite, test_sequence_same_iovs);
 	CU_ADD_TEST(seq_suite, test_sequence_crc32);
+	CU_ADD_TEST(seq_suite, test_sequence_crc32c_fusion);
+	CU_ADD_TEST(seq_suite, test_sequence_dif_generate_verify);
 
 	suite = CU_add_suite("accel", test_setup, test_cleanup);
 	CU_ADD_TEST(suite, test_spdk_accel_task_complete);
 	CU_ADD_TEST(suite, test_get_task);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_copy);
+	CU_ADD_TEST(suite, test_spdk_accel_submit_copy_numa_fallback);
+	CU_ADD_TEST(suite, test_spdk_accel_submit_compress_adaptive);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_dualcast);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_compare);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_fill);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_crc32c);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_crc32cv);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_copy_crc32c);
+	CU_ADD_TEST(suite, test_spdk_accel_submit_batch);
 	CU_ADD_TEST(suite, test_spdk_accel_submit_xor);
 	CU_ADD_TEST(suite, test_spdk_accel_module_find_by_name);
 	CU_ADD_TEST(suite, test_spdk_accel_module_register);
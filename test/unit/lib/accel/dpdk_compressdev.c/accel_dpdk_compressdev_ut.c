@@ -166,6 +166,32 @@ mock_rte_pktmbuf_free_bulk(struct rte_mbuf **m, unsigned int cnt)
 {
 }
 
+void mock_rte_pktmbuf_free_seg(struct rte_mbuf *m);
+#define rte_pktmbuf_free_seg mock_rte_pktmbuf_free_seg
+void
+mock_rte_pktmbuf_free_seg(struct rte_mbuf *m)
+{
+}
+
+static void mock_rte_pktmbuf_detach(struct rte_mbuf *m);
+#define rte_pktmbuf_detach mock_rte_pktmbuf_detach
+static void
+mock_rte_pktmbuf_detach(struct rte_mbuf *m)
+{
+}
+
+/* The UT mbufs are not refcounted, control what the module sees so the tests
+ * can choose between the recycle and free paths.
+ */
+static uint16_t ut_mbuf_refcnt = 0;
+static uint16_t mock_rte_mbuf_refcnt_read(const struct rte_mbuf *m);
+#define rte_mbuf_refcnt_read mock_rte_mbuf_refcnt_read
+static uint16_t
+mock_rte_mbuf_refcnt_read(const struct rte_mbuf *m)
+{
+	return ut_mbuf_refcnt;
+}
+
 static bool ut_boundary_alloc = false;
 static int ut_rte_pktmbuf_alloc_bulk = 0;
 int mock_rte_pktmbuf_alloc_bulk(struct rte_mempool *pool, struct rte_mbuf **mbufs,
@@ -339,7 +365,10 @@ rte_compressdev_enqueue_burst(uint8_t dev_id, uint16_t qp_id, struct rte_comp_op
 		break;
 	}
 
-	/* by design the compress module will never send more than 1 op at a time */
+	/* The module aggregates ops into bursts but these tests flush one at a
+	 * time, so only the first op needs to be validated.
+	 */
+	CU_ASSERT(nb_ops == 1);
 	CU_ASSERT(op->private_xform == ut_expected_op.private_xform);
 
 	/* setup our local pointers to the chained mbufs, those pointed to in the
@@ -546,24 +575,34 @@ test_compress_operation(void)
 	CU_ASSERT(rc == 0);
 	ut_rte_pktmbuf_alloc_bulk = 0;
 
-	/* test enqueue failure busy */
+	/* test enqueue failure busy, the op is only aggregated by the operation
+	 * and the task gets queued when the flush is rejected by the device
+	 */
 	ut_enqueue_value = FAKE_ENQUEUE_BUSY;
 	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == true);
 	rc = _compress_operation(g_comp_ch, &task);
+	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == true);
+	CU_ASSERT(g_comp_ch->num_enq_ops == 1);
+	CU_ASSERT(rc == 0);
+	_compress_flush_batch(g_comp_ch);
+	CU_ASSERT(g_comp_ch->num_enq_ops == 0);
 	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == false);
 	while (!STAILQ_EMPTY(&g_comp_ch->queued_tasks)) {
 		STAILQ_REMOVE_HEAD(&g_comp_ch->queued_tasks, link);
 	}
 	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == true);
-	CU_ASSERT(rc == 0);
 	ut_enqueue_value = 1;
 
-	/* test enqueue failure error */
+	/* test enqueue failure error, the task is completed by the flush */
 	ut_enqueue_value = FAKE_ENQUEUE_ERROR;
+	ut_expected_task_status = -EINVAL;
 	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == true);
 	rc = _compress_operation(g_comp_ch, &task);
+	CU_ASSERT(rc == 0);
+	_compress_flush_batch(g_comp_ch);
+	CU_ASSERT(g_comp_ch->num_enq_ops == 0);
 	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == true);
-	CU_ASSERT(rc == -EINVAL);
+	ut_expected_task_status = 0;
 	ut_enqueue_value = FAKE_ENQUEUE_SUCCESS;
 
 	/* test success with 3 vector iovec */
@@ -596,8 +635,10 @@ test_compress_operation(void)
 	}
 
 	rc = _compress_operation(g_comp_ch, &task);
-	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == true);
 	CU_ASSERT(rc == 0);
+	_compress_flush_batch(g_comp_ch);
+	CU_ASSERT(g_comp_ch->num_enq_ops == 0);
+	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == true);
 
 	/* test sgl out failure */
 	g_device.sgl_out = false;
@@ -703,8 +744,9 @@ test_compress_operation_cross_boundary(void)
 	task.s.iovcnt = src_iovcnt;
 
 	rc = _compress_operation(g_comp_ch, &task);
-	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == true);
 	CU_ASSERT(rc == 0);
+	_compress_flush_batch(g_comp_ch);
+	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == true);
 
 	/* Now force the 2nd IOV to get partial length from spdk_vtophys */
 	g_small_size_counter = 0;
@@ -733,8 +775,9 @@ test_compress_operation_cross_boundary(void)
 	exp_src_mbuf[3]->pkt_len = exp_src_mbuf[3]->buf_len = 0x1000;
 
 	rc = _compress_operation(g_comp_ch, &task);
-	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == true);
 	CU_ASSERT(rc == 0);
+	_compress_flush_batch(g_comp_ch);
+	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == true);
 
 	/* Finally force the 3rd IOV to get partial length from spdk_vtophys */
 	g_small_size_counter = 0;
@@ -762,8 +805,9 @@ test_compress_operation_cross_boundary(void)
 	exp_src_mbuf[3]->pkt_len = exp_src_mbuf[3]->buf_len = 0x800;
 
 	rc = _compress_operation(g_comp_ch, &task);
-	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == true);
 	CU_ASSERT(rc == 0);
+	_compress_flush_batch(g_comp_ch);
+	CU_ASSERT(STAILQ_EMPTY(&g_comp_ch->queued_tasks) == true);
 
 	/* Single input iov is split on page boundary, sgl_in is not supported */
 	g_device.sgl_in = false;
@@ -851,12 +895,43 @@ test_setup_compress_mbuf(void)
 	}
 }
 
+static void
+test_mbuf_recycle(void)
+{
+	struct rte_mbuf mbufs[3] = {};
+	struct rte_mbuf *alloced[3];
+	int rc;
+
+	/* Chain segments we exclusively own land in the channel cache */
+	mbufs[0].next = &mbufs[1];
+	mbufs[1].next = &mbufs[2];
+	ut_mbuf_refcnt = 1;
+	CU_ASSERT(g_comp_ch->mbuf_cache_cnt == 0);
+	_compress_put_mbuf_chain(g_comp_ch, &mbufs[0]);
+	CU_ASSERT(g_comp_ch->mbuf_cache_cnt == 3);
+	CU_ASSERT(mbufs[0].next == NULL);
+	CU_ASSERT(mbufs[0].nb_segs == 1);
+
+	/* Cached mbufs are handed back out before the mempool is used */
+	rc = _compress_get_mbufs(g_comp_ch, alloced, 3);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_comp_ch->mbuf_cache_cnt == 0);
+	CU_ASSERT(alloced[0] == &mbufs[2]);
+	CU_ASSERT(alloced[1] == &mbufs[1]);
+	CU_ASSERT(alloced[2] == &mbufs[0]);
+
+	/* mbufs that are still referenced elsewhere bypass the cache */
+	ut_mbuf_refcnt = 0;
+	_compress_put_mbuf_chain(g_comp_ch, &mbufs[0]);
+	CU_ASSERT(g_comp_ch->mbuf_cache_cnt == 0);
+}
+
 static void
 test_poller(void)
 {
 	int rc;
 	struct compress_io_channel *args;
-	struct rte_mbuf mbuf[4]; /* one src, one dst, 2 ops */
+	struct rte_mbuf mbuf[4] = {}; /* one src, one dst, 2 ops */
 	struct iovec src_iovs[3] = {};
 	struct iovec dst_iovs[3] = {};
 	uint32_t output_size[2];
@@ -1041,6 +1116,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_compress_operation);
 	CU_ADD_TEST(suite, test_compress_operation_cross_boundary);
 	CU_ADD_TEST(suite, test_setup_compress_mbuf);
+	CU_ADD_TEST(suite, test_mbuf_recycle);
 	CU_ADD_TEST(suite, test_initdrivers);
 	CU_ADD_TEST(suite, test_poller);
 
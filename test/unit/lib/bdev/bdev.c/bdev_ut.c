@@ -153,6 +153,7 @@ static struct spdk_bdev_io *g_zcopy_bdev_io;
 static uint64_t g_seek_data_offset;
 static uint64_t g_seek_hole_offset;
 static uint64_t g_seek_offset;
+static bool g_stub_sync_complete;
 
 static struct ut_expected_io *
 ut_alloc_expected_io(uint8_t type, uint64_t offset, uint64_t length, int iovcnt)
@@ -300,6 +301,16 @@ stub_submit_request(struct spdk_io_channel *_ch, struct spdk_bdev_io *bdev_io)
 	TAILQ_INSERT_TAIL(&ch->outstanding_io, bdev_io, module_link);
 	ch->outstanding_io_count++;
 
+	if (g_stub_sync_complete) {
+		/* Complete the I/O from within submit_request, like a cache-hit
+		 * vbdev would.  The callback is deferred until the submit path
+		 * unwinds, so the bdev_io stays valid for the checks below.
+		 */
+		TAILQ_REMOVE(&ch->outstanding_io, bdev_io, module_link);
+		ch->outstanding_io_count--;
+		spdk_bdev_io_complete(bdev_io, g_io_exp_status);
+	}
+
 	expected_io = TAILQ_FIRST(&ch->expected_io);
 	if (expected_io == NULL) {
 		return;
@@ -730,6 +741,95 @@ get_device_stat_test(void)
 	free_bdev(bdev);
 }
 
+static void
+stat_subscription_io_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	spdk_bdev_free_io(bdev_io);
+}
+
+static void
+stat_subscription_cb(struct spdk_bdev *bdev, struct spdk_bdev_io_stat *stat, void *cb_arg, int rc)
+{
+	CU_ASSERT(rc == 0);
+
+	*(bool *)cb_arg = true;
+}
+
+static void
+stat_subscription_test(void)
+{
+	struct spdk_bdev *bdev;
+	struct spdk_bdev_desc *desc = NULL;
+	struct spdk_io_channel *io_ch;
+	struct spdk_bdev_io_stat stat = { .io_error = NULL };
+	bool done;
+	int rc;
+
+	ut_init_bdev(NULL);
+
+	bdev = allocate_bdev("bdev0");
+
+	rc = spdk_bdev_open_ext("bdev0", true, bdev_ut_event_cb, NULL, &desc);
+	CU_ASSERT(rc == 0);
+	poll_threads();
+	SPDK_CU_ASSERT_FATAL(desc != NULL);
+	io_ch = spdk_bdev_get_io_channel(desc);
+	CU_ASSERT(io_ch != NULL);
+
+	spdk_bdev_set_stat_subscription_period(bdev, 10);
+	poll_threads();
+
+	rc = spdk_bdev_write_blocks(desc, io_ch, NULL, 0, 1, stat_subscription_io_done, NULL);
+	CU_ASSERT(rc == 0);
+	stub_complete_io(1);
+	poll_threads();
+
+	/* Let the publish pollers fire so the channel snapshot is current. */
+	spdk_delay_us(100);
+	poll_threads();
+
+	/* The callback runs without any channel iteration, so no polling is
+	 * needed for it to be delivered.
+	 */
+	done = false;
+	spdk_bdev_get_device_stat(bdev, &stat, stat_subscription_cb, &done);
+	CU_ASSERT(done == true);
+	CU_ASSERT(stat.num_write_ops == 1);
+
+	/* Further I/O is not visible until published again. */
+	rc = spdk_bdev_write_blocks(desc, io_ch, NULL, 0, 1, stat_subscription_io_done, NULL);
+	CU_ASSERT(rc == 0);
+	stub_complete_io(1);
+
+	done = false;
+	spdk_bdev_get_device_stat(bdev, &stat, stat_subscription_cb, &done);
+	CU_ASSERT(done == true);
+	CU_ASSERT(stat.num_write_ops == 1);
+
+	spdk_delay_us(100);
+	poll_threads();
+
+	done = false;
+	spdk_bdev_get_device_stat(bdev, &stat, stat_subscription_cb, &done);
+	CU_ASSERT(done == true);
+	CU_ASSERT(stat.num_write_ops == 2);
+
+	/* Disabling falls back to the channel-iterating path. */
+	spdk_bdev_set_stat_subscription_period(bdev, 0);
+	poll_threads();
+
+	done = false;
+	spdk_bdev_get_device_stat(bdev, &stat, stat_subscription_cb, &done);
+	CU_ASSERT(done == false);
+	while (!done) { poll_threads(); }
+	CU_ASSERT(stat.num_write_ops == 2);
+
+	spdk_put_io_channel(io_ch);
+	spdk_bdev_close(desc);
+	free_bdev(bdev);
+	ut_fini_bdev();
+}
+
 static void
 open_write_test(void)
 {
@@ -2986,6 +3086,8 @@ bdev_io_split_with_io_wait(void)
 	struct spdk_bdev_opts bdev_opts = {};
 	struct iovec iov[3];
 	struct ut_expected_io *expected_io;
+	bdev_io_stailq_t child_io_cache;
+	uint16_t child_io_cache_count;
 	int rc;
 
 	spdk_bdev_get_opts(&bdev_opts, sizeof(bdev_opts));
@@ -3004,6 +3106,14 @@ bdev_io_split_with_io_wait(void)
 	channel = spdk_io_channel_get_ctx(io_ch);
 	mgmt_ch = channel->shared_resource->mgmt_ch;
 
+	/* Drain the pre-allocated child-IO cache so this test exercises the
+	 * io_wait path taken when no spdk_bdev_io is available while splitting.
+	 */
+	STAILQ_INIT(&child_io_cache);
+	STAILQ_SWAP(&channel->child_io_cache, &child_io_cache, spdk_bdev_io);
+	child_io_cache_count = channel->child_io_cache_count;
+	channel->child_io_cache_count = 0;
+
 	bdev->optimal_io_boundary = 16;
 	bdev->split_on_optimal_io_boundary = true;
 
@@ -3102,6 +3212,88 @@ bdev_io_split_with_io_wait(void)
 
 	CU_ASSERT(TAILQ_EMPTY(&g_bdev_ut_channel->expected_io));
 
+	/* Put the child-IO cache back so the channel can be torn down. */
+	STAILQ_SWAP(&channel->child_io_cache, &child_io_cache, spdk_bdev_io);
+	channel->child_io_cache_count = child_io_cache_count;
+
+	spdk_put_io_channel(io_ch);
+	spdk_bdev_close(desc);
+	free_bdev(bdev);
+	ut_fini_bdev();
+}
+
+static void
+bdev_io_split_with_inline_completions(void)
+{
+	struct spdk_bdev *bdev;
+	struct spdk_bdev_desc *desc = NULL;
+	struct spdk_io_channel *io_ch;
+	struct spdk_bdev_opts bdev_opts = {};
+	struct ut_expected_io *expected_io;
+	uint64_t i;
+	int rc;
+
+	spdk_bdev_get_opts(&bdev_opts, sizeof(bdev_opts));
+	bdev_opts.bdev_io_pool_size = 512;
+	bdev_opts.bdev_io_cache_size = 64;
+	ut_init_bdev(&bdev_opts);
+
+	bdev = allocate_bdev("bdev0");
+
+	rc = spdk_bdev_open_ext("bdev0", true, bdev_ut_event_cb, NULL, &desc);
+	CU_ASSERT(rc == 0);
+	SPDK_CU_ASSERT_FATAL(desc != NULL);
+	io_ch = spdk_bdev_get_io_channel(desc);
+	CU_ASSERT(io_ch != NULL);
+
+	bdev->optimal_io_boundary = 16;
+	bdev->split_on_optimal_io_boundary = true;
+
+	/* The stub completes every child from within its own submit_request.
+	 * Each child must still be submitted exactly once and at the right
+	 * offset - the inline completion of a child must not re-enter the
+	 * splitting logic before the parent's bookkeeping has been advanced
+	 * past the range that child covered.
+	 */
+	g_stub_sync_complete = true;
+	g_io_done = false;
+
+	for (i = 0; i < 4; i++) {
+		expected_io = ut_alloc_expected_io(SPDK_BDEV_IO_TYPE_WRITE, i * 16, 16, 1);
+		ut_expected_io_set_iov(expected_io, 0, (void *)(0xF000 + i * 16 * 512), 16 * 512);
+		TAILQ_INSERT_TAIL(&g_bdev_ut_channel->expected_io, expected_io, link);
+	}
+
+	rc = spdk_bdev_write_blocks(desc, io_ch, (void *)0xF000, 0, 64, io_done, NULL);
+	CU_ASSERT(rc == 0);
+
+	/* All children completed in submit context, so the parent's callback
+	 * ran before the submission call returned. */
+	CU_ASSERT(g_io_done == true);
+	CU_ASSERT(g_io_status == SPDK_BDEV_IO_STATUS_SUCCESS);
+	CU_ASSERT(TAILQ_EMPTY(&g_bdev_ut_channel->expected_io));
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 0);
+
+	/* Same for an unmap, which resubmits through its own split resume path. */
+	bdev->max_unmap = 8;
+	bdev->max_unmap_segments = 2;
+	g_io_done = false;
+
+	for (i = 0; i < 4; i++) {
+		expected_io = ut_alloc_expected_io(SPDK_BDEV_IO_TYPE_UNMAP, i * 16, 16, 0);
+		TAILQ_INSERT_TAIL(&g_bdev_ut_channel->expected_io, expected_io, link);
+	}
+
+	rc = spdk_bdev_unmap_blocks(desc, io_ch, 0, 64, io_done, NULL);
+	CU_ASSERT(rc == 0);
+
+	CU_ASSERT(g_io_done == true);
+	CU_ASSERT(g_io_status == SPDK_BDEV_IO_STATUS_SUCCESS);
+	CU_ASSERT(TAILQ_EMPTY(&g_bdev_ut_channel->expected_io));
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 0);
+
+	g_stub_sync_complete = false;
+
 	spdk_put_io_channel(io_ch);
 	spdk_bdev_close(desc);
 	free_bdev(bdev);
@@ -3172,12 +3364,15 @@ bdev_io_write_unit_split_test(void)
 	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 0);
 	CU_ASSERT(g_io_status == SPDK_BDEV_IO_STATUS_SUCCESS);
 
-	/* Write I/O should fail if it is smaller than write_unit_size */
+	/* Write I/O should fail if it is smaller than write_unit_size. The failure is
+	 * detected during submission, so the completion callback runs inline once the
+	 * submit path unwinds.
+	 */
 	g_io_done = false;
 
 	rc = spdk_bdev_write_blocks(desc, io_ch, (void *)0xF000, 0, 31, io_done, NULL);
 	CU_ASSERT(rc == 0);
-	CU_ASSERT(g_io_done == false);
+	CU_ASSERT(g_io_done == true);
 
 	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 0);
 	poll_threads();
@@ -3190,7 +3385,7 @@ bdev_io_write_unit_split_test(void)
 
 	rc = spdk_bdev_write_blocks(desc, io_ch, (void *)0xF000, 1, 32, io_done, NULL);
 	CU_ASSERT(rc == 0);
-	CU_ASSERT(g_io_done == false);
+	CU_ASSERT(g_io_done == true);
 
 	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 0);
 	poll_threads();
@@ -3211,7 +3406,7 @@ bdev_io_write_unit_split_test(void)
 	rc = spdk_bdev_writev_blocks(desc, io_ch, iov, SPDK_COUNTOF(iov), 0, SPDK_COUNTOF(iov),
 				     io_done, NULL);
 	CU_ASSERT(rc == 0);
-	CU_ASSERT(g_io_done == false);
+	CU_ASSERT(g_io_done == true);
 
 	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 0);
 	poll_threads();
@@ -5356,6 +5551,8 @@ bdev_io_abort(void)
 	struct spdk_bdev_opts bdev_opts = {};
 	struct iovec iov[SPDK_BDEV_IO_NUM_CHILD_IOV * 2];
 	uint64_t io_ctx1 = 0, io_ctx2 = 0, i;
+	bdev_io_stailq_t child_io_cache;
+	uint16_t child_io_cache_count;
 	int rc;
 
 	spdk_bdev_get_opts(&bdev_opts, sizeof(bdev_opts));
@@ -5374,6 +5571,14 @@ bdev_io_abort(void)
 	channel = spdk_io_channel_get_ctx(io_ch);
 	mgmt_ch = channel->shared_resource->mgmt_ch;
 
+	/* Drain the pre-allocated child-IO cache so the bdev_io exhaustion cases
+	 * below behave deterministically against bdev_io_pool_size.
+	 */
+	STAILQ_INIT(&child_io_cache);
+	STAILQ_SWAP(&channel->child_io_cache, &child_io_cache, spdk_bdev_io);
+	child_io_cache_count = channel->child_io_cache_count;
+	channel->child_io_cache_count = 0;
+
 	g_abort_done = false;
 
 	ut_enable_io_type(SPDK_BDEV_IO_TYPE_ABORT, false);
@@ -5525,6 +5730,10 @@ bdev_io_abort(void)
 
 	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 0);
 
+	/* Put the child-IO cache back so the channel can be torn down. */
+	STAILQ_SWAP(&channel->child_io_cache, &child_io_cache, spdk_bdev_io);
+	channel->child_io_cache_count = child_io_cache_count;
+
 	spdk_put_io_channel(io_ch);
 	spdk_bdev_close(desc);
 	free_bdev(bdev);
@@ -5920,6 +6129,78 @@ bdev_io_ext_invalid_opts(void)
 	ut_fini_bdev();
 }
 
+static void
+bdev_io_ext_fua(void)
+{
+	struct spdk_bdev *bdev;
+	struct spdk_bdev_desc *desc = NULL;
+	struct spdk_io_channel *io_ch;
+	char io_buf[512];
+	struct iovec iov = { .iov_base = io_buf, .iov_len = 512 };
+	struct ut_expected_io *expected_io;
+	struct spdk_bdev_ext_io_opts ext_io_opts = {
+		.size = sizeof(ext_io_opts),
+		.fua = true,
+	};
+	int rc;
+
+	ut_init_bdev(NULL);
+
+	bdev = allocate_bdev("bdev0");
+
+	rc = spdk_bdev_open_ext("bdev0", true, bdev_ut_event_cb, NULL, &desc);
+	CU_ASSERT(rc == 0);
+	SPDK_CU_ASSERT_FATAL(desc != NULL);
+	io_ch = spdk_bdev_get_io_channel(desc);
+	CU_ASSERT(io_ch != NULL);
+
+	/* FUA is passed through to bdevs which support it natively */
+	bdev->fua_supported = true;
+	g_io_done = false;
+	expected_io = ut_alloc_expected_io(SPDK_BDEV_IO_TYPE_WRITE, 32, 14, 1);
+	ut_expected_io_set_iov(expected_io, 0, iov.iov_base, iov.iov_len);
+	TAILQ_INSERT_TAIL(&g_bdev_ut_channel->expected_io, expected_io, link);
+
+	rc = spdk_bdev_writev_blocks_ext(desc, io_ch, &iov, 1, 32, 14, io_done, NULL, &ext_io_opts);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 1);
+	CU_ASSERT(g_bdev_io->u.bdev.fua == true);
+	CU_ASSERT(g_bdev_io->u.bdev.nvme_cdw12.write.fua == 1);
+	stub_complete_io(1);
+	CU_ASSERT(g_io_done == true);
+
+	/* Without native support and with a write cache, the write is emulated
+	 * with a flush of the device write cache following the write.
+	 */
+	bdev->fua_supported = false;
+	bdev->write_cache = 1;
+	g_io_done = false;
+	rc = spdk_bdev_writev_blocks_ext(desc, io_ch, &iov, 1, 32, 14, io_done, NULL, &ext_io_opts);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 1);
+	CU_ASSERT(g_bdev_io->u.bdev.fua == false);
+	stub_complete_io(1);
+	CU_ASSERT(g_io_done == false);
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 1);
+	CU_ASSERT(g_bdev_io->type == SPDK_BDEV_IO_TYPE_FLUSH);
+	stub_complete_io(1);
+	CU_ASSERT(g_io_done == true);
+
+	/* Without a write cache FUA is a no-op */
+	bdev->write_cache = 0;
+	g_io_done = false;
+	rc = spdk_bdev_writev_blocks_ext(desc, io_ch, &iov, 1, 32, 14, io_done, NULL, &ext_io_opts);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 1);
+	stub_complete_io(1);
+	CU_ASSERT(g_io_done == true);
+
+	spdk_put_io_channel(io_ch);
+	spdk_bdev_close(desc);
+	free_bdev(bdev);
+	ut_fini_bdev();
+}
+
 static void
 bdev_io_ext_split(void)
 {
@@ -7401,6 +7682,170 @@ examine_claimed(void)
 	ut_testing_examine_claimed = false;
 }
 
+static void
+bdev_submit_batch_test(void)
+{
+	struct spdk_bdev *bdev;
+	struct spdk_bdev_desc *desc = NULL;
+	struct spdk_io_channel *io_ch;
+	struct spdk_bdev_io_submit_entry entries[2] = {};
+	struct iovec iov[2];
+	int rc;
+
+	ut_init_bdev(NULL);
+	bdev = allocate_bdev("bdev0");
+
+	rc = spdk_bdev_open_ext("bdev0", true, bdev_ut_event_cb, NULL, &desc);
+	CU_ASSERT(rc == 0);
+	SPDK_CU_ASSERT_FATAL(desc != NULL);
+	io_ch = spdk_bdev_get_io_channel(desc);
+	CU_ASSERT(io_ch != NULL);
+
+	iov[0].iov_base = (void *)0x1000;
+	iov[0].iov_len = 512;
+	iov[1].iov_base = (void *)0x2000;
+	iov[1].iov_len = 512;
+
+	entries[0].type = SPDK_BDEV_IO_TYPE_READ;
+	entries[0].iovs = &iov[0];
+	entries[0].iovcnt = 1;
+	entries[0].offset_blocks = 0;
+	entries[0].num_blocks = 1;
+	entries[0].cb = io_done;
+
+	entries[1].type = SPDK_BDEV_IO_TYPE_WRITE;
+	entries[1].iovs = &iov[1];
+	entries[1].iovcnt = 1;
+	entries[1].offset_blocks = 8;
+	entries[1].num_blocks = 1;
+	entries[1].cb = io_done;
+
+	/* Empty and oversized batches are rejected. */
+	rc = spdk_bdev_submit_batch(desc, io_ch, entries, 0);
+	CU_ASSERT(rc == -EINVAL);
+	rc = spdk_bdev_submit_batch(desc, io_ch, entries, SPDK_BDEV_MAX_SUBMIT_BATCH + 1);
+	CU_ASSERT(rc == -EINVAL);
+
+	/* An out-of-range entry fails the whole batch before anything is submitted. */
+	entries[1].num_blocks = bdev->blockcnt + 1;
+	rc = spdk_bdev_submit_batch(desc, io_ch, entries, 2);
+	CU_ASSERT(rc == -EINVAL);
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 0);
+	entries[1].num_blocks = 1;
+
+	/* The stub module has no submit_request_batch, so both requests take the
+	 * regular per-I/O path.
+	 */
+	g_io_done = false;
+	rc = spdk_bdev_submit_batch(desc, io_ch, entries, 2);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 2);
+
+	stub_complete_io(2);
+	CU_ASSERT(g_io_done == true);
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 0);
+
+	spdk_put_io_channel(io_ch);
+	spdk_bdev_close(desc);
+	free_bdev(bdev);
+	ut_fini_bdev();
+}
+
+static uint32_t g_batch_done_count;
+
+static void
+io_done_batch(struct spdk_bdev_io **bdev_ios, uint32_t count, void *cb_arg)
+{
+	uint32_t i;
+
+	g_batch_done_count += count;
+	for (i = 0; i < count; i++) {
+		CU_ASSERT(spdk_bdev_io_get_success(bdev_ios[i]) == true);
+		spdk_bdev_free_io(bdev_ios[i]);
+	}
+}
+
+static void
+bdev_batched_completions(void)
+{
+	struct spdk_bdev *bdev;
+	struct spdk_bdev_desc *desc = NULL;
+	struct spdk_io_channel *io_ch;
+	int rc;
+
+	ut_init_bdev(NULL);
+	bdev = allocate_bdev("bdev0");
+
+	rc = spdk_bdev_open_ext("bdev0", true, bdev_ut_event_cb, NULL, &desc);
+	CU_ASSERT(rc == 0);
+	SPDK_CU_ASSERT_FATAL(desc != NULL);
+	io_ch = spdk_bdev_get_io_channel(desc);
+	CU_ASSERT(io_ch != NULL);
+
+	rc = spdk_bdev_channel_enable_batched_completions(io_ch, NULL, NULL);
+	CU_ASSERT(rc == -EINVAL);
+
+	rc = spdk_bdev_channel_enable_batched_completions(io_ch, io_done_batch, NULL);
+	CU_ASSERT(rc == 0);
+
+	/* Enabling twice is rejected. */
+	rc = spdk_bdev_channel_enable_batched_completions(io_ch, io_done_batch, NULL);
+	CU_ASSERT(rc == -EINVAL);
+
+	g_io_done = false;
+	g_batch_done_count = 0;
+
+	rc = spdk_bdev_read_blocks(desc, io_ch, (void *)0x1000, 0, 1, io_done, NULL);
+	CU_ASSERT(rc == 0);
+	rc = spdk_bdev_read_blocks(desc, io_ch, (void *)0x2000, 8, 1, io_done, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 2);
+
+	stub_complete_io(2);
+
+	/* Completions are held until the flush poller runs, and the per-I/O
+	 * callbacks are not invoked while batching is enabled.
+	 */
+	CU_ASSERT(g_batch_done_count == 0);
+	CU_ASSERT(g_io_done == false);
+
+	poll_threads();
+	CU_ASSERT(g_batch_done_count == 2);
+	CU_ASSERT(g_io_done == false);
+
+	/* A split I/O delivers only the user-facing parent to the batch - the
+	 * split children must complete through their internal callback so the
+	 * parent's split bookkeeping advances.
+	 */
+	bdev->optimal_io_boundary = 8;
+	bdev->split_on_optimal_io_boundary = true;
+
+	rc = spdk_bdev_write_blocks(desc, io_ch, (void *)0x1000, 4, 8, io_done, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_bdev_ut_channel->outstanding_io_count == 2);
+
+	stub_complete_io(2);
+	poll_threads();
+	CU_ASSERT(g_batch_done_count == 3);
+	CU_ASSERT(g_io_done == false);
+
+	bdev->split_on_optimal_io_boundary = false;
+
+	/* After disabling, completions revert to per-I/O delivery. */
+	spdk_bdev_channel_disable_batched_completions(io_ch);
+
+	rc = spdk_bdev_read_blocks(desc, io_ch, (void *)0x1000, 0, 1, io_done, NULL);
+	CU_ASSERT(rc == 0);
+	stub_complete_io(1);
+	CU_ASSERT(g_io_done == true);
+	CU_ASSERT(g_batch_done_count == 3);
+
+	spdk_put_io_channel(io_ch);
+	spdk_bdev_close(desc);
+	free_bdev(bdev);
+	ut_fini_bdev();
+}
+
 int
 main(int argc, char **argv)
 {
@@ -7418,6 +7863,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, claim_test);
 	CU_ADD_TEST(suite, alias_add_del_test);
 	CU_ADD_TEST(suite, get_device_stat_test);
+	CU_ADD_TEST(suite, stat_subscription_test);
 	CU_ADD_TEST(suite, bdev_io_types_test);
 	CU_ADD_TEST(suite, bdev_io_wait_test);
 	CU_ADD_TEST(suite, bdev_io_spans_split_test);
@@ -7425,6 +7871,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, bdev_io_max_size_and_segment_split_test);
 	CU_ADD_TEST(suite, bdev_io_mix_split_test);
 	CU_ADD_TEST(suite, bdev_io_split_with_io_wait);
+	CU_ADD_TEST(suite, bdev_io_split_with_inline_completions);
 	CU_ADD_TEST(suite, bdev_io_write_unit_split_test);
 	CU_ADD_TEST(suite, bdev_io_alignment_with_boundary);
 	CU_ADD_TEST(suite, bdev_io_alignment);
@@ -7454,6 +7901,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, bdev_io_ext);
 	CU_ADD_TEST(suite, bdev_io_ext_no_opts);
 	CU_ADD_TEST(suite, bdev_io_ext_invalid_opts);
+	CU_ADD_TEST(suite, bdev_io_ext_fua);
 	CU_ADD_TEST(suite, bdev_io_ext_split);
 	CU_ADD_TEST(suite, bdev_io_ext_bounce_buffer);
 	CU_ADD_TEST(suite, bdev_register_uuid_alias);
@@ -7470,6 +7918,8 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, claim_v2_existing_v1);
 	CU_ADD_TEST(suite, claim_v1_existing_v2);
 	CU_ADD_TEST(suite, examine_claimed);
+	CU_ADD_TEST(suite, bdev_batched_completions);
+	CU_ADD_TEST(suite, bdev_submit_batch_test);
 
 	allocate_cores(1);
 	allocate_threads(1);
@@ -240,6 +240,11 @@ DEFINE_STUB_V(spdk_opal_dev_destruct, (struct spdk_opal_dev *dev));
 DEFINE_STUB(spdk_accel_submit_crc32cv, int, (struct spdk_io_channel *ch, uint32_t *dst,
 		struct iovec *iov,
 		uint32_t iov_cnt, uint32_t seed, spdk_accel_completion_cb cb_fn, void *cb_arg), 0);
+DEFINE_STUB(spdk_accel_submit_crc32c, int, (struct spdk_io_channel *ch, uint32_t *crc_dst,
+		void *src, uint32_t seed, uint64_t nbytes, spdk_accel_completion_cb cb_fn,
+		void *cb_arg), 0);
+DEFINE_STUB(spdk_accel_submit_batch, int, (struct spdk_io_channel *ch,
+		struct spdk_accel_submit_entry *entries, uint32_t count), 0);
 DEFINE_STUB(spdk_accel_append_crc32c, int,
 	    (struct spdk_accel_sequence **seq, struct spdk_io_channel *ch, uint32_t *dst,
 	     struct iovec *iovs, uint32_t iovcnt, struct spdk_memory_domain *domain, void *domain_ctx,
@@ -707,6 +712,17 @@ union spdk_nvme_vs_register
 	return vs;
 }
 
+union spdk_nvme_cap_register
+	spdk_nvme_ctrlr_get_regs_cap(struct spdk_nvme_ctrlr *ctrlr)
+{
+	union spdk_nvme_cap_register cap;
+
+	cap.raw = 0;
+	cap.bits.ams = SPDK_NVME_CAP_AMS_WRR;
+
+	return cap;
+}
+
 struct spdk_nvme_qpair *
 spdk_nvme_ctrlr_alloc_io_qpair(struct spdk_nvme_ctrlr *ctrlr,
 			       const struct spdk_nvme_io_qpair_opts *user_opts,
@@ -6095,6 +6111,74 @@ test_find_io_path_min_qd(void)
 	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path1);
 }
 
+static void
+test_find_io_path_min_latency(void)
+{
+	struct nvme_bdev_channel nbdev_ch = {
+		.io_path_list = STAILQ_HEAD_INITIALIZER(nbdev_ch.io_path_list),
+		.mp_policy = BDEV_NVME_MP_POLICY_ACTIVE_ACTIVE,
+		.mp_selector = BDEV_NVME_MP_SELECTOR_LATENCY,
+	};
+	struct spdk_nvme_qpair qpair1 = {}, qpair2 = {}, qpair3 = {};
+	struct spdk_nvme_ctrlr ctrlr1 = {}, ctrlr2 = {}, ctrlr3 = {};
+	struct spdk_nvme_ns ns1 = {}, ns2 = {}, ns3 = {};
+	struct nvme_ctrlr nvme_ctrlr1 = { .ctrlr = &ctrlr1, };
+	struct nvme_ctrlr nvme_ctrlr2 = { .ctrlr = &ctrlr2, };
+	struct nvme_ctrlr nvme_ctrlr3 = { .ctrlr = &ctrlr3, };
+	struct nvme_ctrlr_channel ctrlr_ch1 = {};
+	struct nvme_ctrlr_channel ctrlr_ch2 = {};
+	struct nvme_ctrlr_channel ctrlr_ch3 = {};
+	struct nvme_qpair nvme_qpair1 = { .ctrlr_ch = &ctrlr_ch1, .ctrlr = &nvme_ctrlr1, .qpair = &qpair1, };
+	struct nvme_qpair nvme_qpair2 = { .ctrlr_ch = &ctrlr_ch2, .ctrlr = &nvme_ctrlr2, .qpair = &qpair2, };
+	struct nvme_qpair nvme_qpair3 = { .ctrlr_ch = &ctrlr_ch3, .ctrlr = &nvme_ctrlr3, .qpair = &qpair3, };
+	struct nvme_ns nvme_ns1 = { .ns = &ns1, }, nvme_ns2 = { .ns = &ns2, }, nvme_ns3 = { .ns = &ns3, };
+	struct nvme_io_path io_path1 = { .qpair = &nvme_qpair1, .nvme_ns = &nvme_ns1, };
+	struct nvme_io_path io_path2 = { .qpair = &nvme_qpair2, .nvme_ns = &nvme_ns2, };
+	struct nvme_io_path io_path3 = { .qpair = &nvme_qpair3, .nvme_ns = &nvme_ns3, };
+
+	STAILQ_INSERT_TAIL(&nbdev_ch.io_path_list, &io_path1, stailq);
+	STAILQ_INSERT_TAIL(&nbdev_ch.io_path_list, &io_path2, stailq);
+	STAILQ_INSERT_TAIL(&nbdev_ch.io_path_list, &io_path3, stailq);
+
+	/* Test if the minimum EWMA latency or the ANA optimized state is
+	 * prioritized when using latency selector
+	 */
+	io_path1.ewma_latency_ticks = 200;
+	io_path2.ewma_latency_ticks = 100;
+	io_path3.ewma_latency_ticks = 50;
+	nvme_ns1.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	nvme_ns2.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	nvme_ns3.ana_state = SPDK_NVME_ANA_NON_OPTIMIZED_STATE;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path2);
+
+	nvme_ns1.ana_state = SPDK_NVME_ANA_NON_OPTIMIZED_STATE;
+	nvme_ns2.ana_state = SPDK_NVME_ANA_NON_OPTIMIZED_STATE;
+	nvme_ns3.ana_state = SPDK_NVME_ANA_INACCESSIBLE_STATE;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path2);
+
+	/* A path without any latency sample yet is preferred so that it gets primed. */
+	nvme_ns1.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	nvme_ns2.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	io_path1.ewma_latency_ticks = 0;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path1);
+
+	io_path1.ewma_latency_ticks = 200;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path2);
+
+	/* Every BDEV_NVME_LATENCY_PROBE_RATIO-th selection falls back to round-robin
+	 * to probe an alternate path.
+	 */
+	nvme_ns3.ana_state = SPDK_NVME_ANA_OPTIMIZED_STATE;
+	nbdev_ch.latency_probe_counter = BDEV_NVME_LATENCY_PROBE_RATIO - 1;
+	nbdev_ch.current_io_path = &io_path2;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path3);
+	CU_ASSERT(nbdev_ch.latency_probe_counter == 0);
+
+	nvme_ns3.ana_state = SPDK_NVME_ANA_INACCESSIBLE_STATE;
+	nbdev_ch.current_io_path = NULL;
+	CU_ASSERT(bdev_nvme_find_io_path(&nbdev_ch) == &io_path2);
+}
+
 static void
 test_disable_auto_failback(void)
 {
@@ -7408,6 +7492,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_set_preferred_path);
 	CU_ADD_TEST(suite, test_find_next_io_path);
 	CU_ADD_TEST(suite, test_find_io_path_min_qd);
+	CU_ADD_TEST(suite, test_find_io_path_min_latency);
 	CU_ADD_TEST(suite, test_disable_auto_failback);
 	CU_ADD_TEST(suite, test_set_multipath_policy);
 	CU_ADD_TEST(suite, test_uuid_generation);
@@ -211,13 +211,34 @@ __io_type_supported(void *ctx, enum spdk_bdev_io_type type)
 	return true;
 }
 
+static struct spdk_bdev_io *g_base_submitted_io;
+static uint64_t g_base_submitted_offset;
+
+static void
+base_ut_submit_request(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io)
+{
+	g_base_submitted_io = bdev_io;
+	g_base_submitted_offset = bdev_io->u.bdev.offset_blocks;
+	spdk_bdev_io_complete(bdev_io, SPDK_BDEV_IO_STATUS_SUCCESS);
+}
+
+static void
+part_ut_submit_request(struct spdk_io_channel *ch, struct spdk_bdev_io *bdev_io)
+{
+	struct spdk_bdev_part_channel *part_ch = spdk_io_channel_get_ctx(ch);
+
+	spdk_bdev_part_submit_request(part_ch, bdev_io);
+}
+
 static struct spdk_bdev_fn_table base_fn_table = {
 	.destruct		= __destruct,
+	.submit_request	= base_ut_submit_request,
 	.get_io_channel = part_ut_get_io_channel,
 	.io_type_supported	= __io_type_supported,
 };
 static struct spdk_bdev_fn_table part_fn_table = {
 	.destruct		= __destruct,
+	.submit_request	= part_ut_submit_request,
 	.io_type_supported	= __io_type_supported,
 };
 
@@ -444,6 +465,88 @@ part_construct_ext(void)
 	poll_threads();
 }
 
+static struct spdk_bdev_io *g_completed_io;
+
+static void
+part_ut_io_done(struct spdk_bdev_io *bdev_io, bool success, void *cb_arg)
+{
+	CU_ASSERT(success == true);
+	/* The caller's bdev_io is completed exactly as it was submitted - the
+	 * offset remap happens on the child I/O issued to the base bdev.
+	 */
+	CU_ASSERT(bdev_io->u.bdev.offset_blocks == 10);
+	g_completed_io = bdev_io;
+	spdk_bdev_free_io(bdev_io);
+}
+
+static void
+part_io_remap_test(void)
+{
+	struct spdk_bdev_part_base	*base = NULL;
+	struct spdk_bdev_desc   *desc = NULL;
+	struct spdk_io_channel  *io_ch;
+	struct spdk_bdev_part		*part;
+	struct spdk_bdev		bdev_base = {};
+	SPDK_BDEV_PART_TAILQ		tailq = TAILQ_HEAD_INITIALIZER(tailq);
+	char				buf[512];
+	int rc;
+
+	ut_init_bdev();
+	bdev_base.name = "base";
+	bdev_base.blocklen = 512;
+	bdev_base.blockcnt = 1024;
+	bdev_base.fn_table = &base_fn_table;
+	bdev_base.module = &bdev_ut_if;
+	rc = spdk_bdev_register(&bdev_base);
+	CU_ASSERT(rc == 0);
+
+	rc = spdk_bdev_part_base_construct_ext("base", NULL, &vbdev_ut_if,
+					       &part_fn_table, &tailq, NULL,
+					       NULL, sizeof(struct spdk_bdev_part_channel),
+					       NULL, NULL, &base);
+	CU_ASSERT(rc == 0);
+	SPDK_CU_ASSERT_FATAL(base != NULL);
+
+	part = calloc(1, sizeof(*part));
+	SPDK_CU_ASSERT_FATAL(part != NULL);
+	rc = spdk_bdev_part_construct(part, base, "test", 100, 100, "test");
+	SPDK_CU_ASSERT_FATAL(rc == 0);
+
+	rc = spdk_bdev_open_ext("test", true, bdev_ut_event_cb, NULL, &desc);
+	CU_ASSERT(rc == 0);
+	SPDK_CU_ASSERT_FATAL(desc != NULL);
+
+	io_ch = spdk_bdev_get_io_channel(desc);
+	SPDK_CU_ASSERT_FATAL(io_ch != NULL);
+
+	/* A read on the partition is re-issued to the base bdev as a child I/O
+	 * with its offset remapped by the partition's start.
+	 */
+	g_base_submitted_io = NULL;
+	g_completed_io = NULL;
+	rc = spdk_bdev_read_blocks(desc, io_ch, buf, 10, 1, part_ut_io_done, NULL);
+	CU_ASSERT(rc == 0);
+	poll_threads();
+
+	SPDK_CU_ASSERT_FATAL(g_base_submitted_io != NULL);
+	CU_ASSERT(g_base_submitted_offset == 110);
+	SPDK_CU_ASSERT_FATAL(g_completed_io != NULL);
+	CU_ASSERT(g_completed_io != g_base_submitted_io);
+
+	spdk_put_io_channel(io_ch);
+	spdk_bdev_close(desc);
+	spdk_bdev_unregister(&part->internal.bdev, NULL, NULL);
+	poll_threads();
+
+	rc = spdk_bdev_part_free(part);
+	CU_ASSERT(rc == 1);
+	poll_threads();
+	CU_ASSERT(TAILQ_EMPTY(&tailq));
+
+	spdk_bdev_unregister(&bdev_base, NULL, NULL);
+	ut_fini_bdev();
+}
+
 int
 main(int argc, char **argv)
 {
@@ -458,6 +561,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, part_free_test);
 	CU_ADD_TEST(suite, part_get_io_channel_test);
 	CU_ADD_TEST(suite, part_construct_ext);
+	CU_ADD_TEST(suite, part_io_remap_test);
 
 	allocate_cores(1);
 	allocate_threads(1);
@@ -1415,6 +1415,158 @@ test_raid_process(void)
 	reset_globals();
 }
 
+static void
+ut_raid_process_budget_refill(void *ctx)
+{
+	raid_bdev_process_budget_poller(ctx);
+}
+
+static void
+test_raid_process_max_bandwidth(void)
+{
+	struct rpc_bdev_raid_create req;
+	struct rpc_bdev_raid_delete destroy_req;
+	struct raid_bdev *pbdev;
+	struct spdk_bdev *base_bdev;
+	struct spdk_thread *process_thread;
+	uint64_t num_blocks_processed = 0;
+	bool budget_waited = false;
+
+	set_globals();
+	CU_ASSERT(raid_bdev_init() == 0);
+
+	g_opts.process_max_bandwidth_mb_sec = 1;
+
+	create_raid_bdev_create_req(&req, "raid1", 0, true, 0, false);
+	verify_raid_bdev_present("raid1", false);
+	TAILQ_FOREACH(base_bdev, &g_bdev_list, internal.link) {
+		base_bdev->blockcnt = 1024;
+	}
+	rpc_bdev_raid_create(NULL, NULL);
+	CU_ASSERT(g_rpc_err == 0);
+	free_test_req(&req);
+
+	TAILQ_FOREACH(pbdev, &g_raid_bdev_list, global_link) {
+		if (strcmp(pbdev->bdev.name, "raid1") == 0) {
+			break;
+		}
+	}
+	CU_ASSERT(pbdev != NULL);
+
+	pbdev->module_private = &num_blocks_processed;
+	pbdev->min_base_bdevs_operational = 0;
+
+	CU_ASSERT(raid_bdev_start_rebuild(&pbdev->base_bdev_info[0]) == 0);
+	poll_app_thread();
+
+	SPDK_CU_ASSERT_FATAL(pbdev->process != NULL);
+	CU_ASSERT(pbdev->process->max_bandwidth_blocks ==
+		  1024 * 1024 / pbdev->bdev.blocklen);
+
+	process_thread = g_latest_thread;
+
+	while (spdk_thread_poll(process_thread, 0, 0) > 0 ||
+	       (pbdev->process != NULL && pbdev->process->waiting_for_budget)) {
+		if (pbdev->process != NULL && pbdev->process->waiting_for_budget) {
+			budget_waited = true;
+			spdk_thread_send_msg(process_thread, ut_raid_process_budget_refill,
+					     pbdev->process);
+		}
+		poll_app_thread();
+	}
+
+	CU_ASSERT(pbdev->process == NULL);
+	CU_ASSERT(budget_waited == true);
+	CU_ASSERT(num_blocks_processed == pbdev->bdev.blockcnt);
+
+	poll_app_thread();
+
+	g_opts.process_max_bandwidth_mb_sec = 0;
+
+	create_raid_bdev_delete_req(&destroy_req, "raid1", 0);
+	rpc_bdev_raid_delete(NULL, NULL);
+	CU_ASSERT(g_rpc_err == 0);
+	verify_raid_bdev_present("raid1", false);
+
+	raid_bdev_exit();
+	base_bdevs_cleanup();
+	reset_globals();
+}
+
+static void
+test_raid_process_resume_checkpoint(void)
+{
+	struct rpc_bdev_raid_create req;
+	struct rpc_bdev_raid_delete destroy_req;
+	struct raid_bdev *pbdev;
+	struct spdk_bdev *base_bdev;
+	struct spdk_thread *process_thread;
+	struct raid_bdev_sb_base_bdev *sb_base_bdev;
+	uint64_t num_blocks_processed = 0;
+	const uint64_t checkpoint_offset = 64;
+
+	set_globals();
+	CU_ASSERT(raid_bdev_init() == 0);
+
+	create_raid_bdev_create_req(&req, "raid1", 0, true, 0, false);
+	verify_raid_bdev_present("raid1", false);
+	TAILQ_FOREACH(base_bdev, &g_bdev_list, internal.link) {
+		base_bdev->blockcnt = 128;
+	}
+	rpc_bdev_raid_create(NULL, NULL);
+	CU_ASSERT(g_rpc_err == 0);
+	free_test_req(&req);
+
+	TAILQ_FOREACH(pbdev, &g_raid_bdev_list, global_link) {
+		if (strcmp(pbdev->bdev.name, "raid1") == 0) {
+			break;
+		}
+	}
+	CU_ASSERT(pbdev != NULL);
+
+	pbdev->module_private = &num_blocks_processed;
+	pbdev->min_base_bdevs_operational = 0;
+
+	/* Set up a superblock with a rebuild checkpoint for the target base bdev */
+	pbdev->sb = calloc(1, RAID_BDEV_SB_MAX_LENGTH);
+	SPDK_CU_ASSERT_FATAL(pbdev->sb != NULL);
+	pbdev->sb->base_bdevs_size = 1;
+	sb_base_bdev = &pbdev->sb->base_bdevs[0];
+	sb_base_bdev->slot = 0;
+	sb_base_bdev->state = RAID_SB_BASE_BDEV_MISSING;
+	sb_base_bdev->rebuild_offset = checkpoint_offset;
+	spdk_uuid_copy(&sb_base_bdev->uuid, &pbdev->base_bdev_info[0].uuid);
+
+	CU_ASSERT(raid_bdev_start_rebuild(&pbdev->base_bdev_info[0]) == 0);
+	poll_app_thread();
+
+	SPDK_CU_ASSERT_FATAL(pbdev->process != NULL);
+	CU_ASSERT(pbdev->process->window_offset == checkpoint_offset);
+
+	process_thread = g_latest_thread;
+
+	while (spdk_thread_poll(process_thread, 0, 0) > 0) {
+		poll_app_thread();
+	}
+
+	CU_ASSERT(pbdev->process == NULL);
+	CU_ASSERT(num_blocks_processed == pbdev->bdev.blockcnt - checkpoint_offset);
+
+	poll_app_thread();
+
+	free(pbdev->sb);
+	pbdev->sb = NULL;
+
+	create_raid_bdev_delete_req(&destroy_req, "raid1", 0);
+	rpc_bdev_raid_delete(NULL, NULL);
+	CU_ASSERT(g_rpc_err == 0);
+	verify_raid_bdev_present("raid1", false);
+
+	raid_bdev_exit();
+	base_bdevs_cleanup();
+	reset_globals();
+}
+
 static void
 test_raid_io_split(void)
 {
@@ -1722,6 +1874,8 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_raid_level_conversions);
 	CU_ADD_TEST(suite, test_raid_io_split);
 	CU_ADD_TEST(suite, test_raid_process);
+	CU_ADD_TEST(suite, test_raid_process_max_bandwidth);
+	CU_ADD_TEST(suite, test_raid_process_resume_checkpoint);
 
 	spdk_thread_lib_init(test_new_thread_fn, 0);
 	g_app_thread = spdk_thread_create("app_thread", NULL);
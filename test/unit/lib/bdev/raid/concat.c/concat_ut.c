@@ -25,6 +25,13 @@ DEFINE_STUB(spdk_bdev_writev_blocks_with_md, int, (struct spdk_bdev_desc *desc,
 DEFINE_STUB(raid_bdev_remap_dix_reftag, int, (void *md_buf, uint64_t num_blocks,
 		struct spdk_bdev *bdev, uint32_t remapped_offset), -1);
 
+int
+spdk_bdev_notify_blockcnt_change(struct spdk_bdev *bdev, uint64_t size)
+{
+	bdev->blockcnt = size;
+	return 0;
+}
+
 #define BLOCK_LEN (4096)
 
 enum CONCAT_IO_TYPE {
@@ -261,6 +268,66 @@ test_concat_start(void)
 	}
 }
 
+static void
+test_concat_grow(void)
+{
+	struct raid_bdev *raid_bdev;
+	struct raid_params *params;
+	struct concat_block_range *block_range;
+	struct raid_base_bdev_info *base_info;
+	struct spdk_bdev *bdev;
+	struct spdk_bdev_desc *desc;
+	uint64_t total_blockcnt;
+	int i;
+
+	RAID_PARAMS_FOR_EACH(params) {
+		raid_bdev = create_concat(params);
+		total_blockcnt = 0;
+		RAID_FOR_EACH_BASE_BDEV(raid_bdev, base_info) {
+			total_blockcnt += base_info->data_size;
+		}
+		raid_bdev->bdev.blockcnt = total_blockcnt;
+
+		/* Append a new base bdev the way the raid framework does on grow */
+		base_info = realloc(raid_bdev->base_bdev_info,
+				    (raid_bdev->num_base_bdevs + 1) * sizeof(*base_info));
+		SPDK_CU_ASSERT_FATAL(base_info != NULL);
+		raid_bdev->base_bdev_info = base_info;
+
+		base_info = &raid_bdev->base_bdev_info[raid_bdev->num_base_bdevs];
+		memset(base_info, 0, sizeof(*base_info));
+
+		bdev = calloc(1, sizeof(*bdev));
+		SPDK_CU_ASSERT_FATAL(bdev != NULL);
+		bdev->ctxt = base_info;
+		bdev->blockcnt = params->base_bdev_blockcnt;
+		bdev->blocklen = raid_bdev->bdev.blocklen;
+		bdev->md_len = raid_bdev->bdev.md_len;
+		bdev->md_interleave = raid_bdev->bdev.md_interleave;
+
+		desc = calloc(1, sizeof(*desc));
+		SPDK_CU_ASSERT_FATAL(desc != NULL);
+		desc->bdev = bdev;
+
+		base_info->raid_bdev = raid_bdev;
+		base_info->desc = desc;
+		base_info->data_offset = 0;
+		base_info->data_size = bdev->blockcnt;
+		raid_bdev->num_base_bdevs++;
+
+		CU_ASSERT(concat_grow_base_bdev(raid_bdev, base_info) == 0);
+
+		CU_ASSERT(raid_bdev->bdev.blockcnt == total_blockcnt + params->base_bdev_blockcnt);
+		block_range = raid_bdev->module_private;
+		for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
+			CU_ASSERT(block_range[i].start == (uint64_t)i * params->base_bdev_blockcnt);
+			CU_ASSERT(block_range[i].length == params->base_bdev_blockcnt);
+		}
+
+		delete_concat(raid_bdev);
+	}
+}
+
 static void
 raid_io_cleanup(struct raid_bdev_io *raid_io)
 {
@@ -464,6 +531,7 @@ main(int argc, char **argv)
 
 	suite = CU_add_suite("concat", test_setup, test_cleanup);
 	CU_ADD_TEST(suite, test_concat_start);
+	CU_ADD_TEST(suite, test_concat_grow);
 	CU_ADD_TEST(suite, test_concat_rw);
 	CU_ADD_TEST(suite, test_concat_null_payload);
 
@@ -615,6 +615,95 @@ verify_io_without_payload(struct raid_bdev_io *raid_io, uint32_t io_status)
 	CU_ASSERT(g_io_comp_status == io_status);
 }
 
+static void
+verify_batch_mapping(struct raid_bdev_io *raid_io, struct raid0_batch_request *batch)
+{
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	struct raid_bdev_io_range io_range;
+	uint8_t i;
+
+	SPDK_CU_ASSERT_FATAL(raid_bdev != NULL);
+	SPDK_CU_ASSERT_FATAL(raid_io->iovcnt == 1);
+
+	_raid0_get_io_range(&io_range, raid_bdev->num_base_bdevs, raid_bdev->strip_size,
+			    raid_bdev->strip_size_shift, raid_io->offset_blocks, raid_io->num_blocks);
+
+	CU_ASSERT(batch->start_disk == io_range.start_disk);
+	CU_ASSERT(batch->n_disks == io_range.n_disks_involved);
+
+	for (i = 0; i < batch->n_disks; i++) {
+		uint8_t disk_idx = (io_range.start_disk + i) % raid_bdev->num_base_bdevs;
+		struct raid0_batch_disk *disk = &batch->disks[i];
+		uint64_t offset_in_disk;
+		uint64_t nblocks_in_disk;
+		uint64_t pd_lba;
+		size_t iov_off = 0;
+		int v = 0;
+
+		_raid0_split_io_range(&io_range, disk_idx, &offset_in_disk, &nblocks_in_disk);
+
+		CU_ASSERT(disk->offset_in_disk == offset_in_disk);
+		CU_ASSERT(disk->nblocks_in_disk == nblocks_in_disk);
+
+		/* Each block of the child I/O must map to the correct location in the
+		 * parent I/O buffer */
+		for (pd_lba = offset_in_disk; pd_lba < offset_in_disk + nblocks_in_disk; pd_lba++) {
+			uint64_t strip_in_disk = pd_lba >> raid_bdev->strip_size_shift;
+			uint64_t strip = strip_in_disk * raid_bdev->num_base_bdevs + disk_idx;
+			uint64_t raid_lba = (strip << raid_bdev->strip_size_shift) +
+					    (pd_lba & (raid_bdev->strip_size - 1));
+			uint64_t parent_off = (raid_lba - raid_io->offset_blocks) * g_block_len;
+			size_t remaining = g_block_len;
+
+			while (remaining > 0) {
+				size_t len = spdk_min(remaining, disk->iovs[v].iov_len - iov_off);
+
+				CU_ASSERT(disk->iovs[v].iov_base + iov_off ==
+					  raid_io->iovs[0].iov_base + parent_off +
+					  (g_block_len - remaining));
+				iov_off += len;
+				remaining -= len;
+				if (iov_off == disk->iovs[v].iov_len) {
+					v++;
+					iov_off = 0;
+				}
+			}
+		}
+		CU_ASSERT(v == disk->iovcnt);
+	}
+}
+
+static void
+verify_batched_io(struct raid_bdev_io *raid_io, uint32_t io_status)
+{
+	struct raid_bdev *raid_bdev = raid_io->raid_bdev;
+	struct raid_bdev_io_range io_range;
+	uint32_t i;
+
+	SPDK_CU_ASSERT_FATAL(raid_bdev != NULL);
+
+	_raid0_get_io_range(&io_range, raid_bdev->num_base_bdevs, raid_bdev->strip_size,
+			    raid_bdev->strip_size_shift, raid_io->offset_blocks, raid_io->num_blocks);
+
+	CU_ASSERT(io_range.n_disks_involved == g_io_output_index);
+
+	for (i = 0; i < g_io_output_index; i++) {
+		uint8_t disk_idx = (io_range.start_disk + i) % raid_bdev->num_base_bdevs;
+		struct io_output *output = &g_io_output[i];
+		uint64_t offset_in_disk;
+		uint64_t nblocks_in_disk;
+
+		_raid0_split_io_range(&io_range, disk_idx, &offset_in_disk, &nblocks_in_disk);
+
+		CU_ASSERT(output->offset_blocks == offset_in_disk);
+		CU_ASSERT(output->num_blocks == nblocks_in_disk);
+		CU_ASSERT(output->desc == raid_bdev->base_bdev_info[disk_idx].desc);
+		CU_ASSERT(output->ch == raid_bdev_channel_get_base_channel(raid_io->raid_ch, disk_idx));
+		CU_ASSERT(output->iotype == raid_io->type);
+	}
+	CU_ASSERT(g_io_comp_status == io_status);
+}
+
 static struct raid_bdev *
 create_raid0(void)
 {
@@ -877,6 +966,57 @@ test_io_failure(void)
 	reset_globals();
 }
 
+static void
+test_batched_io(void)
+{
+	struct raid_bdev *raid_bdev;
+	uint32_t count;
+	uint64_t io_len;
+	uint64_t lba;
+	struct raid_bdev_io *raid_io;
+	struct raid_bdev_io_channel *raid_ch;
+
+	if (g_enable_dif) {
+		/* With DIF/DIX the bdev layer splits I/Os at strip boundaries instead */
+		return;
+	}
+
+	set_globals();
+
+	raid_bdev = create_raid0();
+	raid_ch = raid_test_create_io_channel(raid_bdev);
+
+	CU_ASSERT(raid_bdev->bdev.split_on_optimal_io_boundary == false);
+
+	/* test multi-strip IOs with unaligned start and end offsets */
+	lba = 3 * g_strip_size + g_strip_size / 4;
+	io_len = 4 * g_strip_size + g_strip_size / 2;
+	for (count = 0; count < 2; count++) {
+		struct raid0_batch_request *batch;
+
+		raid_io = calloc(1, sizeof(*raid_io));
+		SPDK_CU_ASSERT_FATAL(raid_io != NULL);
+		raid_io_initialize(raid_io, raid_ch, raid_bdev, lba, io_len,
+				   count ? SPDK_BDEV_IO_TYPE_READ : SPDK_BDEV_IO_TYPE_WRITE);
+
+		batch = raid0_batch_request_create(raid_io);
+		SPDK_CU_ASSERT_FATAL(batch != NULL);
+		verify_batch_mapping(raid_io, batch);
+		free(batch);
+
+		memset(g_io_output, 0, ((g_max_io_size / g_strip_size) + 1) * sizeof(struct io_output));
+		g_io_output_index = 0;
+		raid0_submit_rw_request(raid_io);
+		verify_batched_io(raid_io, g_child_io_status_flag);
+		raid_io_cleanup(raid_io);
+	}
+
+	raid_test_destroy_io_channel(raid_ch);
+	delete_raid0(raid_bdev);
+
+	reset_globals();
+}
+
 int
 main(int argc, char **argv)
 {
@@ -887,6 +1027,7 @@ main(int argc, char **argv)
 		{ "test_read_io", test_read_io },
 		{ "test_unmap_io", test_unmap_io },
 		{ "test_io_failure", test_io_failure },
+		{ "test_batched_io", test_batched_io },
 		CU_TEST_INFO_NULL,
 	};
 	CU_SuiteInfo suites[] = {
@@ -216,8 +216,8 @@ _test_raid1_read_balancing(struct raid_bdev *raid_bdev, struct raid_bdev_io_chan
 	}
 
 	for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
-		CU_ASSERT(raid1_ch->read_blocks_outstanding[i] == n * small_io_blocks);
-		raid1_ch->read_blocks_outstanding[i] = 0;
+		CU_ASSERT(raid1_ch->base_stats[i].read_blocks_outstanding == n * small_io_blocks);
+		raid1_ch->base_stats[i].read_blocks_outstanding = 0;
 	}
 
 	/*
@@ -239,7 +239,7 @@ _test_raid1_read_balancing(struct raid_bdev *raid_bdev, struct raid_bdev_io_chan
 	}
 
 	for (i = 0; i < raid_bdev->num_base_bdevs; i++) {
-		CU_ASSERT(raid1_ch->read_blocks_outstanding[i] == big_io_blocks);
+		CU_ASSERT(raid1_ch->base_stats[i].read_blocks_outstanding == big_io_blocks);
 	}
 
 	raid_io = get_raid_io(r1_info, raid_ch, SPDK_BDEV_IO_TYPE_READ, small_io_blocks);
@@ -254,6 +254,99 @@ test_raid1_read_balancing(void)
 	run_for_each_raid1_config(_test_raid1_read_balancing);
 }
 
+static void
+_test_raid1_read_policy_latency(struct raid_bdev *raid_bdev, struct raid_bdev_io_channel *raid_ch)
+{
+	struct raid1_info *r1_info = raid_bdev->module_private;
+	struct raid1_io_channel *raid1_ch = raid_bdev_channel_get_module_ctx(raid_ch);
+	struct raid_bdev_io *raid_io;
+	struct spdk_bdev_io bdev_io = {};
+	uint64_t read_counts[UINT8_MAX + 1] = {};
+	const int num_ios = 500;
+	uint8_t i;
+	int n;
+
+	raid_bdev->read_policy = RAID_BDEV_READ_POLICY_LATENCY;
+
+	/* without latency samples the selection should fall back to the outstanding counters */
+	MOCK_SET(spdk_get_ticks, 1000);
+	g_io_status = SPDK_BDEV_IO_STATUS_PENDING;
+	raid_io = get_raid_io(r1_info, raid_ch, SPDK_BDEV_IO_TYPE_READ, 64);
+	raid1_submit_read_request(raid_io);
+	CU_ASSERT(raid_io->base_bdev_io_submitted == 0);
+
+	/* a successful completion should record the first latency sample directly */
+	MOCK_SET(spdk_get_ticks, 1512);
+	raid1_read_bdev_io_completion(&bdev_io, true, raid_io);
+	CU_ASSERT(g_io_status == SPDK_BDEV_IO_STATUS_SUCCESS);
+	CU_ASSERT(raid1_ch->base_stats[0].latency_ticks_ewma == 512);
+
+	/* subsequent samples should be smoothed into the EWMA */
+	raid1_channel_update_read_latency(raid_ch, 0, 1024);
+	CU_ASSERT(raid1_ch->base_stats[0].latency_ticks_ewma == 512 + (512 >> RAID1_LATENCY_EWMA_SHIFT));
+
+	/* a base bdev with a much higher latency should get proportionally fewer reads */
+	raid1_ch->base_stats[0].latency_ticks_ewma = 8000;
+	for (i = 1; i < raid_bdev->num_base_bdevs; i++) {
+		raid1_ch->base_stats[i].latency_ticks_ewma = 1000;
+	}
+
+	for (n = 0; n < num_ios; n++) {
+		raid_io = get_raid_io(r1_info, raid_ch, SPDK_BDEV_IO_TYPE_READ, 4);
+		raid1_submit_read_request(raid_io);
+		SPDK_CU_ASSERT_FATAL(raid_io->base_bdev_io_submitted < raid_bdev->num_base_bdevs);
+		read_counts[raid_io->base_bdev_io_submitted]++;
+		put_raid_io(raid_io);
+	}
+
+	for (i = 1; i < raid_bdev->num_base_bdevs; i++) {
+		CU_ASSERT(read_counts[0] < read_counts[i]);
+	}
+
+	MOCK_CLEAR(spdk_get_ticks);
+}
+
+static void
+test_raid1_read_policy_latency(void)
+{
+	run_for_each_raid1_config(_test_raid1_read_policy_latency);
+}
+
+static void
+_test_raid1_read_policy_affinity(struct raid_bdev *raid_bdev, struct raid_bdev_io_channel *raid_ch)
+{
+	struct raid1_info *r1_info = raid_bdev->module_private;
+	struct raid1_io_channel *raid1_ch = raid_bdev_channel_get_module_ctx(raid_ch);
+	struct raid_bdev_io *raid_io;
+	int n;
+
+	raid_bdev->read_policy = RAID_BDEV_READ_POLICY_AFFINITY;
+
+	SPDK_CU_ASSERT_FATAL(raid1_ch->affinity_base_bdev < raid_bdev->num_base_bdevs);
+	CU_ASSERT(raid1_ch->affinity_base_bdev == 0);
+
+	/* all reads on this channel should go to the affinity base bdev */
+	for (n = 0; n < 3; n++) {
+		raid_io = get_raid_io(r1_info, raid_ch, SPDK_BDEV_IO_TYPE_READ, 64);
+		raid1_submit_read_request(raid_io);
+		CU_ASSERT(raid_io->base_bdev_io_submitted == raid1_ch->affinity_base_bdev);
+		put_raid_io(raid_io);
+	}
+
+	/* if the affinity base bdev is missing, fall back to the outstanding counters */
+	raid_ch->_base_channels[raid1_ch->affinity_base_bdev] = NULL;
+	raid_io = get_raid_io(r1_info, raid_ch, SPDK_BDEV_IO_TYPE_READ, 64);
+	raid1_submit_read_request(raid_io);
+	CU_ASSERT(raid_io->base_bdev_io_submitted == 1);
+	put_raid_io(raid_io);
+}
+
+static void
+test_raid1_read_policy_affinity(void)
+{
+	run_for_each_raid1_config(_test_raid1_read_policy_affinity);
+}
+
 static void
 _test_raid1_write_error(struct raid_bdev *raid_bdev, struct raid_bdev_io_channel *raid_ch)
 {
@@ -439,7 +532,7 @@ _test_raid1_read_error(struct raid_bdev *raid_bdev, struct raid_bdev_io_channel
 	/* read from base bdev #1 fails, read from #0 succeeds */
 	base_info->is_failed = false;
 	base_info = &raid_bdev->base_bdev_info[1];
-	raid1_ch->read_blocks_outstanding[0] = 123;
+	raid1_ch->base_stats[0].read_blocks_outstanding = 123;
 	g_io_status = SPDK_BDEV_IO_STATUS_PENDING;
 	raid_io = get_raid_io(r1_info, raid_ch, SPDK_BDEV_IO_TYPE_READ, 64);
 	raid1_submit_read_request(raid_io);
@@ -512,6 +605,8 @@ main(int argc, char **argv)
 	suite = CU_add_suite("raid1", test_setup, test_cleanup);
 	CU_ADD_TEST(suite, test_raid1_start);
 	CU_ADD_TEST(suite, test_raid1_read_balancing);
+	CU_ADD_TEST(suite, test_raid1_read_policy_latency);
+	CU_ADD_TEST(suite, test_raid1_read_policy_affinity);
 	CU_ADD_TEST(suite, test_raid1_write_error);
 	CU_ADD_TEST(suite, test_raid1_read_error);
 
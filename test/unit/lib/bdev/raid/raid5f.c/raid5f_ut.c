@@ -16,6 +16,10 @@
 static void *g_accel_p = (void *)0xdeadbeaf;
 static bool g_test_degraded;
 
+/* The I/O info of the current partial write test - the internal I/O of rmw stripe
+ * requests is not contained in a test_raid_bdev_io */
+static struct raid_io_info *g_rmw_io_info;
+
 DEFINE_STUB_V(raid_bdev_module_list_add, (struct raid_bdev_module *raid_module));
 DEFINE_STUB(spdk_bdev_get_buf_align, size_t, (const struct spdk_bdev *bdev), 0);
 DEFINE_STUB_V(raid_bdev_module_stop_done, (struct raid_bdev *raid_bdev));
@@ -148,6 +152,7 @@ static void
 test_setup(void)
 {
 	g_test_degraded = false;
+	g_rmw_io_info = NULL;
 }
 
 static struct raid5f_info *
@@ -190,6 +195,7 @@ test_raid5f_start(void)
 		CU_ASSERT_EQUAL(r5f_info->raid_bdev->bdev.optimal_io_boundary, params->strip_size);
 		CU_ASSERT_TRUE(r5f_info->raid_bdev->bdev.split_on_optimal_io_boundary);
 		CU_ASSERT_EQUAL(r5f_info->raid_bdev->bdev.write_unit_size, r5f_info->stripe_blocks);
+		CU_ASSERT_FALSE(r5f_info->raid_bdev->bdev.split_on_write_unit);
 
 		delete_raid5f(r5f_info);
 	}
@@ -225,6 +231,7 @@ struct raid_io_info {
 	void *degraded_buf;
 	void *degraded_md_buf;
 	enum spdk_bdev_io_status status;
+	unsigned int num_completed;
 	TAILQ_HEAD(, spdk_bdev_io) bdev_io_queue;
 	TAILQ_HEAD(, spdk_bdev_io_wait_entry) bdev_io_wait_queue;
 	struct {
@@ -263,6 +270,7 @@ raid_test_bdev_io_complete(struct raid_bdev_io *raid_io, enum spdk_bdev_io_statu
 			raid_io);
 
 	test_raid_bdev_io->io_info->status = status;
+	test_raid_bdev_io->io_info->num_completed++;
 
 	free(raid_io->iovs);
 	free(test_raid_bdev_io);
@@ -417,8 +425,13 @@ spdk_bdev_writev_blocks_with_md(struct spdk_bdev_desc *desc, struct spdk_io_chan
 	SPDK_CU_ASSERT_FATAL(cb == raid5f_chunk_complete_bdev_io);
 
 	stripe_req = raid5f_chunk_stripe_req(chunk);
-	test_raid_bdev_io = SPDK_CONTAINEROF(stripe_req->raid_io, struct test_raid_bdev_io, raid_io);
-	io_info = test_raid_bdev_io->io_info;
+	if (stripe_req->type == STRIPE_REQ_RMW) {
+		SPDK_CU_ASSERT_FATAL(g_rmw_io_info != NULL);
+		io_info = g_rmw_io_info;
+	} else {
+		test_raid_bdev_io = SPDK_CONTAINEROF(stripe_req->raid_io, struct test_raid_bdev_io, raid_io);
+		io_info = test_raid_bdev_io->io_info;
+	}
 	r5f_info = io_info->r5f_info;
 	raid_bdev = r5f_info->raid_bdev;
 
@@ -433,10 +446,10 @@ spdk_bdev_writev_blocks_with_md(struct spdk_bdev_desc *desc, struct spdk_io_chan
 	} else {
 		data_chunk_idx = chunk < stripe_req->parity_chunk ? chunk->index : chunk->index - 1;
 		data_offset = data_chunk_idx * raid_bdev->strip_size * raid_bdev->bdev.blocklen;
-		dest.iov_base = test_raid_bdev_io->buf + data_offset;
+		dest.iov_base = io_info->dest_buf + data_offset;
 		if (md_buf != NULL) {
 			data_offset = (data_offset >> r5f_info->blocklen_shift) * raid_bdev->bdev.md_len;
-			dest_md_buf = test_raid_bdev_io->buf_md + data_offset;
+			dest_md_buf = io_info->dest_md_buf + data_offset;
 		}
 	}
 	dest.iov_len = num_blocks * raid_bdev->bdev.blocklen;
@@ -468,8 +481,13 @@ spdk_bdev_readv_blocks_degraded(struct spdk_bdev_desc *desc, struct spdk_io_chan
 	SPDK_CU_ASSERT_FATAL(cb == raid5f_chunk_complete_bdev_io);
 
 	stripe_req = raid5f_chunk_stripe_req(chunk);
-	test_raid_bdev_io = SPDK_CONTAINEROF(stripe_req->raid_io, struct test_raid_bdev_io, raid_io);
-	io_info = test_raid_bdev_io->io_info;
+	if (stripe_req->type == STRIPE_REQ_RMW) {
+		SPDK_CU_ASSERT_FATAL(g_rmw_io_info != NULL);
+		io_info = g_rmw_io_info;
+	} else {
+		test_raid_bdev_io = SPDK_CONTAINEROF(stripe_req->raid_io, struct test_raid_bdev_io, raid_io);
+		io_info = test_raid_bdev_io->io_info;
+	}
 	raid_bdev = io_info->r5f_info->raid_bdev;
 
 	if (chunk == stripe_req->parity_chunk) {
@@ -1004,6 +1022,149 @@ test_raid5f_submit_full_stripe_write_request(void)
 	run_for_each_raid5f_config(__test_raid5f_submit_full_stripe_write_request);
 }
 
+static void
+submit_partial_write(struct raid_io_info *io_info, uint64_t stripe_offset, uint64_t num_blocks)
+{
+	struct raid_bdev *raid_bdev = io_info->r5f_info->raid_bdev;
+	uint32_t blocklen = raid_bdev->bdev.blocklen;
+	uint32_t md_len = raid_bdev->bdev.md_interleave ? 0 : raid_bdev->bdev.md_len;
+	struct test_raid_bdev_io *test_raid_bdev_io;
+	struct raid_bdev_io *raid_io;
+	void *buf = io_info->src_buf + stripe_offset * blocklen;
+	void *md_buf = io_info->src_md_buf ? io_info->src_md_buf + stripe_offset * md_len : NULL;
+	struct iovec *iovs;
+	int iovcnt;
+
+	test_raid_bdev_io = calloc(1, sizeof(*test_raid_bdev_io));
+	SPDK_CU_ASSERT_FATAL(test_raid_bdev_io != NULL);
+
+	test_raid_bdev_io->io_info = io_info;
+
+	iovcnt = num_blocks > 1 ? 2 : 1;
+	iovs = calloc(iovcnt, sizeof(*iovs));
+	SPDK_CU_ASSERT_FATAL(iovs != NULL);
+
+	iovs[0].iov_base = buf;
+	iovs[0].iov_len = (num_blocks / iovcnt) * blocklen;
+	if (iovcnt == 2) {
+		iovs[1].iov_base = buf + iovs[0].iov_len;
+		iovs[1].iov_len = num_blocks * blocklen - iovs[0].iov_len;
+	}
+
+	raid_io = &test_raid_bdev_io->raid_io;
+
+	raid_test_bdev_io_init(raid_io, raid_bdev, io_info->raid_ch, SPDK_BDEV_IO_TYPE_WRITE,
+			       io_info->offset_blocks + stripe_offset, num_blocks, iovs, iovcnt, md_buf);
+
+	raid5f_submit_rw_request(raid_io);
+}
+
+static void
+test_raid5f_partial_write_request(struct raid_io_info *io_info, unsigned int num_writes)
+{
+	unsigned int i;
+
+	for (i = 0; i < 20 && io_info->num_completed < num_writes; i++) {
+		process_io_completions(io_info);
+		poll_threads();
+		spdk_delay_us(RAID5F_RMW_FLUSH_PERIOD_US);
+	}
+	process_io_completions(io_info);
+
+	CU_ASSERT_EQUAL(io_info->num_completed, num_writes);
+}
+
+static void
+__test_raid5f_submit_partial_write_request(struct raid_bdev *raid_bdev,
+		struct raid_bdev_io_channel *raid_ch)
+{
+	struct raid5f_info *r5f_info = raid_bdev->module_private;
+	uint32_t strip_size = raid_bdev->strip_size;
+	uint32_t blocklen = raid_bdev->bdev.blocklen;
+	uint32_t md_len = raid_bdev->bdev.md_interleave ? 0 : raid_bdev->bdev.md_len;
+	uint32_t h = strip_size - strip_size / 2;
+	size_t stripe_len = r5f_info->stripe_blocks * blocklen;
+	size_t stripe_md_len = r5f_info->stripe_blocks * md_len;
+	uint64_t stripe_index;
+
+	RAID5F_TEST_FOR_EACH_STRIPE(raid_bdev, stripe_index) {
+		struct raid_io_info io_info;
+		void *expected_buf;
+		void *expected_md_buf = NULL;
+		unsigned int num_writes = 0;
+		uint64_t off, nb;
+		uint8_t i;
+
+		init_io_info(&io_info, r5f_info, raid_ch, SPDK_BDEV_IO_TYPE_WRITE,
+			     stripe_index, 0, r5f_info->stripe_blocks);
+		g_rmw_io_info = &io_info;
+
+		/* old contents of the stripe, served by the chunk reads */
+		io_info.degraded_buf = malloc(stripe_len);
+		SPDK_CU_ASSERT_FATAL(io_info.degraded_buf != NULL);
+		memset(io_info.degraded_buf, 0xab, stripe_len);
+
+		expected_buf = malloc(stripe_len);
+		SPDK_CU_ASSERT_FATAL(expected_buf != NULL);
+		memset(expected_buf, 0xab, stripe_len);
+
+		if (stripe_md_len != 0) {
+			io_info.degraded_md_buf = malloc(stripe_md_len);
+			SPDK_CU_ASSERT_FATAL(io_info.degraded_md_buf != NULL);
+			memset(io_info.degraded_md_buf, 0xab, stripe_md_len);
+
+			expected_md_buf = malloc(stripe_md_len);
+			SPDK_CU_ASSERT_FATAL(expected_md_buf != NULL);
+			memset(expected_md_buf, 0xab, stripe_md_len);
+		}
+
+		/* The first chunk is fully covered by two merged writes, the other chunks
+		 * only in the first half, forcing a read of their old data */
+		for (i = 0; i < raid5f_stripe_data_chunks_num(raid_bdev); i++) {
+			off = i * strip_size;
+			nb = h;
+			do {
+				submit_partial_write(&io_info, off, nb);
+				memcpy(expected_buf + off * blocklen,
+				       io_info.src_buf + off * blocklen, nb * blocklen);
+				if (expected_md_buf != NULL) {
+					memcpy(expected_md_buf + off * md_len,
+					       io_info.src_md_buf + off * md_len, nb * md_len);
+				}
+				num_writes++;
+				off += nb;
+				nb = strip_size - h;
+			} while (i == 0 && nb > 0 && off < strip_size);
+		}
+
+		io_info_setup_parity(&io_info, expected_buf, expected_md_buf);
+
+		test_raid5f_partial_write_request(&io_info, num_writes);
+
+		CU_ASSERT(io_info.status == SPDK_BDEV_IO_STATUS_SUCCESS);
+		CU_ASSERT(memcmp(io_info.dest_buf, expected_buf, stripe_len) == 0);
+		if (expected_md_buf != NULL) {
+			CU_ASSERT(memcmp(io_info.dest_md_buf, expected_md_buf, stripe_md_len) == 0);
+		}
+		CU_ASSERT(memcmp(io_info.parity_buf, io_info.reference_parity,
+				 io_info.parity_buf_size) == 0);
+		if (io_info.parity_md_buf) {
+			CU_ASSERT(memcmp(io_info.parity_md_buf, io_info.reference_md_parity,
+					 io_info.parity_md_buf_size) == 0);
+		}
+
+		g_rmw_io_info = NULL;
+		free(expected_buf);
+		free(expected_md_buf);
+		deinit_io_info(&io_info);
+	}
+}
+static void
+test_raid5f_submit_partial_write_request(void)
+{
+	run_for_each_raid5f_config(__test_raid5f_submit_partial_write_request);
+}
+
 static void
 __test_raid5f_chunk_write_error(struct raid_bdev *raid_bdev, struct raid_bdev_io_channel *raid_ch)
 {
@@ -1115,6 +1276,104 @@ test_raid5f_submit_read_request_degraded(void)
 	run_for_each_raid5f_config(__test_raid5f_submit_read_request);
 }
 
+static void
+__test_raid5f_submit_partial_write_request_degraded(struct raid_bdev *raid_bdev,
+		struct raid_bdev_io_channel *raid_ch)
+{
+	struct raid5f_info *r5f_info = raid_bdev->module_private;
+	uint32_t strip_size = raid_bdev->strip_size;
+	uint32_t blocklen = raid_bdev->bdev.blocklen;
+	uint32_t md_len = raid_bdev->bdev.md_interleave ? 0 : raid_bdev->bdev.md_len;
+	uint32_t h = strip_size - strip_size / 2;
+	size_t stripe_len = r5f_info->stripe_blocks * blocklen;
+	size_t stripe_md_len = r5f_info->stripe_blocks * md_len;
+	uint64_t stripe_index;
+
+	RAID5F_TEST_FOR_EACH_STRIPE(raid_bdev, stripe_index) {
+		uint8_t p_idx = raid5f_stripe_parity_chunk_index(raid_bdev, stripe_index);
+		struct raid_io_info io_info;
+		unsigned int num_writes = 0;
+		uint8_t i;
+
+		/* Writes fully covering each chunk - no reads are needed for the flush */
+		init_io_info(&io_info, r5f_info, raid_ch, SPDK_BDEV_IO_TYPE_WRITE,
+			     stripe_index, 0, r5f_info->stripe_blocks);
+		g_rmw_io_info = &io_info;
+
+		if (p_idx != 0) {
+			io_info_setup_parity(&io_info, io_info.src_buf, io_info.src_md_buf);
+		}
+
+		for (i = 0; i < raid5f_stripe_data_chunks_num(raid_bdev); i++) {
+			submit_partial_write(&io_info, i * strip_size, h);
+			num_writes++;
+			if (h < strip_size) {
+				submit_partial_write(&io_info, i * strip_size + h, strip_size - h);
+				num_writes++;
+			}
+		}
+
+		test_raid5f_partial_write_request(&io_info, num_writes);
+
+		CU_ASSERT(io_info.status == SPDK_BDEV_IO_STATUS_SUCCESS);
+
+		if (p_idx != 0) {
+			/* the chunk on the missing base bdev was not written */
+			memcpy(io_info.dest_buf, io_info.src_buf, strip_size * blocklen);
+			if (stripe_md_len != 0) {
+				memcpy(io_info.dest_md_buf, io_info.src_md_buf, strip_size * md_len);
+			}
+			CU_ASSERT(memcmp(io_info.parity_buf, io_info.reference_parity,
+					 io_info.parity_buf_size) == 0);
+			if (io_info.parity_md_buf) {
+				CU_ASSERT(memcmp(io_info.parity_md_buf, io_info.reference_md_parity,
+						 io_info.parity_md_buf_size) == 0);
+			}
+		}
+
+		CU_ASSERT(memcmp(io_info.dest_buf, io_info.src_buf, stripe_len) == 0);
+		if (stripe_md_len != 0) {
+			CU_ASSERT(memcmp(io_info.dest_md_buf, io_info.src_md_buf, stripe_md_len) == 0);
+		}
+
+		g_rmw_io_info = NULL;
+		deinit_io_info(&io_info);
+
+		if (p_idx == 0 || strip_size == 1) {
+			continue;
+		}
+
+		/* A write that requires reading old data from the missing base bdev must fail */
+		init_io_info(&io_info, r5f_info, raid_ch, SPDK_BDEV_IO_TYPE_WRITE,
+			     stripe_index, 0, r5f_info->stripe_blocks);
+		g_rmw_io_info = &io_info;
+
+		io_info.degraded_buf = malloc(stripe_len);
+		SPDK_CU_ASSERT_FATAL(io_info.degraded_buf != NULL);
+		memset(io_info.degraded_buf, 0xab, stripe_len);
+		if (stripe_md_len != 0) {
+			io_info.degraded_md_buf = malloc(stripe_md_len);
+			SPDK_CU_ASSERT_FATAL(io_info.degraded_md_buf != NULL);
+			memset(io_info.degraded_md_buf, 0xab, stripe_md_len);
+		}
+
+		submit_partial_write(&io_info, 0, 1);
+
+		test_raid5f_partial_write_request(&io_info, 1);
+
+		CU_ASSERT(io_info.status == SPDK_BDEV_IO_STATUS_FAILED);
+
+		g_rmw_io_info = NULL;
+		deinit_io_info(&io_info);
+	}
+}
+static void
+test_raid5f_submit_partial_write_request_degraded(void)
+{
+	g_test_degraded = true;
+	run_for_each_raid5f_config(__test_raid5f_submit_partial_write_request_degraded);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -1129,10 +1388,12 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_raid5f_submit_read_request);
 	CU_ADD_TEST(suite, test_raid5f_stripe_request_map_iovecs);
 	CU_ADD_TEST(suite, test_raid5f_submit_full_stripe_write_request);
+	CU_ADD_TEST(suite, test_raid5f_submit_partial_write_request);
 	CU_ADD_TEST(suite, test_raid5f_chunk_write_error);
 	CU_ADD_TEST(suite, test_raid5f_chunk_write_error_with_enomem);
 	CU_ADD_TEST(suite, test_raid5f_submit_full_stripe_write_request_degraded);
 	CU_ADD_TEST(suite, test_raid5f_submit_read_request_degraded);
+	CU_ADD_TEST(suite, test_raid5f_submit_partial_write_request_degraded);
 
 	allocate_threads(1);
 	set_thread(0);
@@ -892,6 +892,14 @@ blob_snapshot_freeze_io(void)
 	struct spdk_blob *blob;
 	struct spdk_blob_opts opts;
 	spdk_blob_id blobid;
+	spdk_bs_user_op_t *op;
+	struct iovec iov;
+	struct spdk_blob_ext_io_opts ext_opts = {
+		.memory_domain = (struct spdk_memory_domain *)0xfeedbeef,
+		.memory_domain_ctx = (void *)0xf00df00d,
+		.size = sizeof(struct spdk_blob_ext_io_opts),
+		.user_ctx = (void *)123,
+	};
 	uint32_t num_of_pages = 10;
 	uint8_t payload_read[num_of_pages * SPDK_BS_PAGE_SIZE];
 	uint8_t payload_write[num_of_pages * SPDK_BS_PAGE_SIZE];
@@ -934,9 +942,28 @@ blob_snapshot_freeze_io(void)
 	/* Verify that payload is not written to disk, at this point the blobs already switched */
 	CU_ASSERT(blob->active.clusters[0] == 0);
 
+	/* Write to the blob with ext opts while it is still frozen */
+	iov.iov_base = payload_write;
+	iov.iov_len = sizeof(payload_write);
+	g_dev_writev_ext_called = false;
+	memset(&g_blob_ext_io_opts, 0, sizeof(g_blob_ext_io_opts));
+	spdk_blob_io_writev_ext(blob, channel, &iov, 1, 0, num_of_pages, blob_op_complete, NULL,
+				&ext_opts);
+
+	/* Verify that the queued operation keeps the ext opts for replay */
+	op = TAILQ_FIRST(&bs_channel->queued_io);
+	SPDK_CU_ASSERT_FATAL(op != NULL);
+	op = TAILQ_NEXT(op, link);
+	SPDK_CU_ASSERT_FATAL(op != NULL);
+	CU_ASSERT(op->ext_io_opts == &ext_opts);
+
 	/* Finish all operations including spdk_bs_create_snapshot */
 	poll_threads();
 
+	/* Verify that the replayed I/O was submitted with the original ext opts */
+	CU_ASSERT(g_dev_writev_ext_called);
+	CU_ASSERT(memcmp(&ext_opts, &g_blob_ext_io_opts, sizeof(g_blob_ext_io_opts)) == 0);
+
 	/* Verify snapshot */
 	CU_ASSERT(g_bserrno == 0);
 	CU_ASSERT(g_blobid != SPDK_BLOBID_INVALID);
@@ -1074,6 +1101,87 @@ blob_clone(void)
 	ut_blob_close_and_delete(bs, blob);
 }
 
+static void
+blob_create_clones(void)
+{
+	struct spdk_blob_store *bs = g_bs;
+	struct spdk_blob_opts opts;
+	struct spdk_blob *blob, *clone;
+	spdk_blob_id blobid, snapshotid;
+	spdk_blob_id cloneids[4];
+	spdk_blob_id ids[4];
+	size_t count, i, j;
+	int rc;
+
+	/* Create blob with 10 clusters */
+	ut_spdk_blob_opts_init(&opts);
+	opts.num_clusters = 10;
+
+	blob = ut_blob_create_and_open(bs, &opts);
+	blobid = spdk_blob_get_id(blob);
+
+	/* Creating clones of a blob that is not read only should fail */
+	spdk_bs_create_clones(bs, blobid, NULL, SPDK_COUNTOF(cloneids), cloneids,
+			      blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == -EINVAL);
+	for (i = 0; i < SPDK_COUNTOF(cloneids); i++) {
+		CU_ASSERT(cloneids[i] == SPDK_BLOBID_INVALID);
+	}
+
+	/* Create snapshot */
+	spdk_bs_create_snapshot(bs, blobid, NULL, blob_op_with_id_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(g_blobid != SPDK_BLOBID_INVALID);
+	snapshotid = g_blobid;
+
+	/* Create a batch of clones from the snapshot */
+	spdk_bs_create_clones(bs, snapshotid, NULL, SPDK_COUNTOF(cloneids), cloneids,
+			      blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+
+	for (i = 0; i < SPDK_COUNTOF(cloneids); i++) {
+		CU_ASSERT(cloneids[i] != SPDK_BLOBID_INVALID);
+		for (j = 0; j < i; j++) {
+			CU_ASSERT(cloneids[i] != cloneids[j]);
+		}
+
+		spdk_bs_open_blob(bs, cloneids[i], blob_op_with_handle_complete, NULL);
+		poll_threads();
+		CU_ASSERT(g_bserrno == 0);
+		SPDK_CU_ASSERT_FATAL(g_blob != NULL);
+		clone = g_blob;
+		CU_ASSERT(spdk_blob_is_clone(clone));
+		CU_ASSERT(spdk_blob_get_parent_snapshot(bs, cloneids[i]) == snapshotid);
+		CU_ASSERT(spdk_blob_get_num_clusters(clone) == 10);
+		CU_ASSERT(spdk_blob_get_num_allocated_clusters(clone) == 0);
+
+		spdk_blob_close(clone, blob_op_complete, NULL);
+		poll_threads();
+		CU_ASSERT(g_bserrno == 0);
+	}
+
+	/* All clones are registered on the snapshot's clone list */
+	count = SPDK_COUNTOF(ids);
+	rc = spdk_blob_get_clones(bs, snapshotid, ids, &count);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(count == SPDK_COUNTOF(cloneids));
+
+	for (i = 0; i < SPDK_COUNTOF(cloneids); i++) {
+		spdk_bs_delete_blob(bs, cloneids[i], blob_op_complete, NULL);
+		poll_threads();
+		CU_ASSERT(g_bserrno == 0);
+	}
+
+	spdk_bs_delete_blob(bs, snapshotid, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+
+	ut_blob_close_and_delete(bs, blob);
+}
+
 static void
 _blob_inflate(bool decouple_parent)
 {
@@ -1203,6 +1311,71 @@ blob_delete(void)
 	CU_ASSERT(g_bserrno == -ENOENT);
 }
 
+static void
+blob_delete_blobs(void)
+{
+	struct spdk_blob_store *bs = g_bs;
+	struct spdk_blob *blob;
+	struct spdk_io_channel *channel;
+	struct spdk_blob_opts opts;
+	spdk_blob_id ids[4];
+	uint64_t free_clusters;
+	uint8_t payload_write[4096];
+	size_t i;
+
+	free_clusters = spdk_bs_free_cluster_count(bs);
+
+	channel = spdk_bs_alloc_io_channel(bs);
+	CU_ASSERT(channel != NULL);
+
+	ut_spdk_blob_opts_init(&opts);
+	opts.thin_provision = true;
+	opts.num_clusters = 5;
+
+	blob = ut_blob_create_and_open(bs, &opts);
+	ids[1] = spdk_blob_get_id(blob);
+
+	memset(payload_write, 0xE5, sizeof(payload_write));
+	spdk_blob_io_write(blob, channel, payload_write, 0, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+
+	/* The snapshot is deliberately listed before its clone - the batch must
+	 * retry it after deleting the clone released it. */
+	spdk_bs_create_snapshot(bs, ids[1], NULL, blob_op_with_id_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(g_blobid != SPDK_BLOBID_INVALID);
+	ids[0] = g_blobid;
+
+	spdk_blob_close(blob, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+
+	for (i = 2; i < SPDK_COUNTOF(ids); i++) {
+		blob = ut_blob_create_and_open(bs, &opts);
+		ids[i] = spdk_blob_get_id(blob);
+		spdk_blob_close(blob, blob_op_complete, NULL);
+		poll_threads();
+		CU_ASSERT(g_bserrno == 0);
+	}
+
+	spdk_bs_delete_blobs(bs, ids, SPDK_COUNTOF(ids), blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+
+	for (i = 0; i < SPDK_COUNTOF(ids); i++) {
+		spdk_bs_open_blob(bs, ids[i], blob_op_with_handle_complete, NULL);
+		poll_threads();
+		CU_ASSERT(g_bserrno == -ENOENT);
+	}
+
+	CU_ASSERT(free_clusters == spdk_bs_free_cluster_count(bs));
+
+	spdk_bs_free_io_channel(channel);
+	poll_threads();
+}
+
 static void
 blob_resize_test(void)
 {
@@ -4513,6 +4686,126 @@ blob_thin_prov_rw(void)
 	g_blobid = 0;
 }
 
+static void
+blob_thin_prov_cluster_cache(void)
+{
+	struct spdk_blob_store *bs = g_bs;
+	struct spdk_blob *blob;
+	struct spdk_io_channel *channel;
+	struct spdk_bs_channel *bs_channel;
+	struct spdk_blob_opts opts;
+	uint64_t free_clusters;
+	uint64_t pages_per_cluster;
+	uint32_t reserved;
+	uint8_t payload_write[4096];
+
+	free_clusters = spdk_bs_free_cluster_count(bs);
+	pages_per_cluster = bs->cluster_sz / spdk_bs_get_page_size(bs);
+
+	channel = spdk_bs_alloc_io_channel(bs);
+	CU_ASSERT(channel != NULL);
+	bs_channel = spdk_io_channel_get_ctx(channel);
+	CU_ASSERT(bs_channel->cluster_cache_count == 0);
+
+	ut_spdk_blob_opts_init(&opts);
+	opts.thin_provision = true;
+	opts.num_clusters = 5;
+
+	blob = ut_blob_create_and_open(bs, &opts);
+
+	/* The first allocation refills the channel's reservation cache.  The
+	 * reservations are claimed in the bit pool but are still counted as
+	 * free clusters. */
+	memset(payload_write, 0xE5, sizeof(payload_write));
+	spdk_blob_io_write(blob, channel, payload_write, 0, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(free_clusters - 1 == spdk_bs_free_cluster_count(bs));
+	reserved = bs_channel->cluster_cache_count;
+	CU_ASSERT(reserved > 0);
+	CU_ASSERT(spdk_bit_pool_count_free(bs->used_clusters) ==
+		  spdk_bs_free_cluster_count(bs) - reserved);
+
+	/* The next allocation is served from the cache without a refill. */
+	spdk_blob_io_write(blob, channel, payload_write, pages_per_cluster, 1,
+			   blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(free_clusters - 2 == spdk_bs_free_cluster_count(bs));
+	CU_ASSERT(bs_channel->cluster_cache_count == reserved - 1);
+
+	ut_blob_close_and_delete(bs, blob);
+	CU_ASSERT(free_clusters == spdk_bs_free_cluster_count(bs));
+
+	/* Destroying the channel returns the unused reservations to the pool. */
+	spdk_bs_free_io_channel(channel);
+	poll_threads();
+	CU_ASSERT(spdk_bit_pool_count_free(bs->used_clusters) == spdk_bs_free_cluster_count(bs));
+	g_blob = NULL;
+	g_blobid = 0;
+}
+
+static void
+blob_persist_md_prefix_reuse(void)
+{
+	struct spdk_blob_store *bs = g_bs;
+	struct spdk_blob *blob;
+	struct spdk_blob_opts opts;
+	uint64_t page_size;
+	uint64_t write_bytes;
+	char xattr_name[16];
+	char xattr_value[1024];
+	int rc, i;
+
+	page_size = spdk_bs_get_page_size(bs);
+
+	ut_spdk_blob_opts_init(&opts);
+	blob = ut_blob_create_and_open(bs, &opts);
+
+	/* Grow the metadata to at least three pages, with the extents
+	 * serialized after the xattrs. */
+	memset(xattr_value, 'x', sizeof(xattr_value));
+	for (i = 0; i < 10; i++) {
+		snprintf(xattr_name, sizeof(xattr_name), "xattr_%d", i);
+		rc = spdk_blob_set_xattr(blob, xattr_name, xattr_value, sizeof(xattr_value));
+		CU_ASSERT(rc == 0);
+	}
+
+	spdk_blob_sync_md(blob, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	SPDK_CU_ASSERT_FATAL(blob->active.num_pages >= 3);
+	CU_ASSERT(blob->last_md != NULL);
+	CU_ASSERT(blob->last_md_count == blob->active.num_pages);
+
+	/* Rewriting an xattr with the same value dirties the blob without
+	 * changing the serialization - the sync must not write anything. */
+	rc = spdk_blob_set_xattr(blob, "xattr_0", xattr_value, sizeof(xattr_value));
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(blob->state == SPDK_BLOB_STATE_DIRTY);
+	write_bytes = g_dev_write_bytes;
+	spdk_blob_sync_md(blob, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(g_dev_write_bytes == write_bytes);
+
+	/* A change at the end of the chain only rewrites the tail pages and the
+	 * boundary page, not the whole chain.  A full rewrite of a three page
+	 * chain costs five page writes (two chain pages, the root and two
+	 * zeroed old pages) plus any extent pages. */
+	write_bytes = g_dev_write_bytes;
+	spdk_blob_resize(blob, 3, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	spdk_blob_sync_md(blob, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(g_dev_write_bytes - write_bytes > 0);
+	CU_ASSERT(g_dev_write_bytes - write_bytes <= 4 * page_size);
+
+	ut_blob_close_and_delete(bs, blob);
+}
+
 static void
 blob_thin_prov_write_count_io(void)
 {
@@ -4662,6 +4955,84 @@ blob_thin_prov_write_count_io(void)
 	g_bs = NULL;
 }
 
+static void
+blob_thin_prov_seq_prealloc(void)
+{
+	struct spdk_blob_store *bs;
+	struct spdk_blob *blob;
+	struct spdk_io_channel *ch;
+	struct spdk_bs_dev *dev;
+	struct spdk_bs_opts bs_opts;
+	struct spdk_blob_opts opts;
+	uint64_t free_clusters;
+	uint64_t pages_per_cluster;
+	uint32_t expected_cluster;
+	uint8_t payload_write[4096];
+	uint32_t i;
+
+	dev = init_dev();
+	spdk_bs_opts_init(&bs_opts, sizeof(bs_opts));
+	bs_opts.cluster_prealloc_count = 8;
+
+	spdk_bs_init(dev, &bs_opts, bs_op_with_handle_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	SPDK_CU_ASSERT_FATAL(g_bs != NULL);
+	bs = g_bs;
+
+	free_clusters = spdk_bs_free_cluster_count(bs);
+	pages_per_cluster = bs->cluster_sz / spdk_bs_get_page_size(bs);
+
+	ch = spdk_bs_alloc_io_channel(bs);
+	SPDK_CU_ASSERT_FATAL(ch != NULL);
+
+	ut_spdk_blob_opts_init(&opts);
+	opts.thin_provision = true;
+	opts.num_clusters = 16;
+
+	blob = ut_blob_create_and_open(bs, &opts);
+
+	/* Writes to consecutive clusters arm the detector.  Once the streak
+	 * reaches the threshold a run of clusters is reserved for the blob. */
+	memset(payload_write, 0xE5, sizeof(payload_write));
+	for (i = 0; i < SPDK_BLOB_SEQ_PREALLOC_THRESHOLD; i++) {
+		g_bserrno = -1;
+		spdk_blob_io_write(blob, ch, payload_write, i * pages_per_cluster, 1,
+				   blob_op_complete, NULL);
+		poll_threads();
+		CU_ASSERT(g_bserrno == 0);
+	}
+	SPDK_CU_ASSERT_FATAL(blob->prealloc_next < blob->prealloc_count);
+	/* The reservations are not visible in the free cluster count */
+	CU_ASSERT(free_clusters - SPDK_BLOB_SEQ_PREALLOC_THRESHOLD ==
+		  spdk_bs_free_cluster_count(bs));
+
+	/* The next sequential write consumes the first reserved cluster */
+	expected_cluster = blob->prealloc_clusters[blob->prealloc_next];
+	g_bserrno = -1;
+	spdk_blob_io_write(blob, ch, payload_write, i * pages_per_cluster, 1,
+			   blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(blob->active.clusters[i] == bs_cluster_to_lba(bs, expected_cluster));
+	CU_ASSERT(free_clusters - (SPDK_BLOB_SEQ_PREALLOC_THRESHOLD + 1) ==
+		  spdk_bs_free_cluster_count(bs));
+
+	/* Closing the blob returns the unused reservations to the pool */
+	ut_blob_close_and_delete(bs, blob);
+	CU_ASSERT(free_clusters == spdk_bs_free_cluster_count(bs));
+
+	spdk_bs_free_io_channel(ch);
+	poll_threads();
+	g_blob = NULL;
+	g_blobid = 0;
+
+	spdk_bs_unload(bs, bs_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	g_bs = NULL;
+}
+
 static void
 blob_thin_prov_unmap_cluster(void)
 {
@@ -5332,6 +5703,132 @@ blob_snapshot_rw_iov(void)
 	ut_blob_close_and_delete(bs, snapshot);
 }
 
+static void
+blob_snapshot_chain_read_cache(void)
+{
+	struct spdk_blob_store *bs = g_bs;
+	struct spdk_blob *blob, *snapshot, *snapshot2;
+	struct spdk_io_channel *channel;
+	struct spdk_bs_channel *bs_channel;
+	struct spdk_bs_back_dev_cache_entry *entry;
+	struct spdk_blob_opts opts;
+	spdk_blob_id blobid, snapshotid, snapshotid2;
+	uint64_t io_units_per_cluster;
+	uint8_t payload_read[4096];
+	uint8_t payload_write[4096];
+	static const uint8_t zero[4096] = { 0 };
+
+	io_units_per_cluster = spdk_bs_get_cluster_size(bs) / spdk_bs_get_io_unit_size(bs);
+
+	channel = spdk_bs_alloc_io_channel(bs);
+	CU_ASSERT(channel != NULL);
+	bs_channel = spdk_io_channel_get_ctx(channel);
+
+	ut_spdk_blob_opts_init(&opts);
+	opts.thin_provision = true;
+	opts.num_clusters = 5;
+
+	blob = ut_blob_create_and_open(bs, &opts);
+	blobid = spdk_blob_get_id(blob);
+
+	/* Write the first cluster, then freeze it in a snapshot */
+	memset(payload_write, 0xE5, sizeof(payload_write));
+	spdk_blob_io_write(blob, channel, payload_write, 0, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+
+	spdk_bs_create_snapshot(bs, blobid, NULL, blob_op_with_id_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(g_blobid != SPDK_BLOBID_INVALID);
+	snapshotid = g_blobid;
+
+	/* A second snapshot puts an empty level between the blob and the data */
+	spdk_bs_create_snapshot(bs, blobid, NULL, blob_op_with_id_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(g_blobid != SPDK_BLOBID_INVALID);
+	snapshotid2 = g_blobid;
+
+	spdk_bs_open_blob(bs, snapshotid, blob_op_with_handle_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	SPDK_CU_ASSERT_FATAL(g_blob != NULL);
+	snapshot = g_blob;
+
+	spdk_bs_open_blob(bs, snapshotid2, blob_op_with_handle_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	SPDK_CU_ASSERT_FATAL(g_blob != NULL);
+	snapshot2 = g_blob;
+
+	/* Reading cluster 0 through the two level chain short-circuits to the
+	 * device wrapping the oldest snapshot and memoizes it in the channel. */
+	memset(payload_read, 0xFF, sizeof(payload_read));
+	spdk_blob_io_read(blob, channel, payload_read, 0, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(memcmp(payload_write, payload_read, sizeof(payload_read)) == 0);
+
+	CU_ASSERT(bs_channel->back_dev_cache_gen == bs->back_bs_dev_gen);
+	entry = &bs_channel->back_dev_cache[0];
+	CU_ASSERT(entry->blob_id == blobid);
+	CU_ASSERT(entry->cluster == 0);
+	CU_ASSERT(entry->dev == snapshot2->back_bs_dev);
+
+	/* A cluster no level ever wrote resolves to the terminal zeroes device */
+	memset(payload_read, 0xFF, sizeof(payload_read));
+	spdk_blob_io_read(blob, channel, payload_read, io_units_per_cluster, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(memcmp(zero, payload_read, sizeof(payload_read)) == 0);
+
+	entry = &bs_channel->back_dev_cache[1];
+	CU_ASSERT(entry->blob_id == blobid);
+	CU_ASSERT(entry->cluster == 1);
+	CU_ASSERT(entry->dev == snapshot->back_bs_dev);
+
+	/* Deleting the middle snapshot rewires the chain and must drop the
+	 * memoized lookups through the generation counter. */
+	spdk_blob_close(snapshot2, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	spdk_bs_delete_blob(bs, snapshotid2, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+
+	CU_ASSERT(bs_channel->back_dev_cache_gen != bs->back_bs_dev_gen);
+
+	memset(payload_read, 0xFF, sizeof(payload_read));
+	spdk_blob_io_read(blob, channel, payload_read, 0, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(memcmp(payload_write, payload_read, sizeof(payload_read)) == 0);
+
+	entry = &bs_channel->back_dev_cache[0];
+	CU_ASSERT(entry->blob_id == blobid);
+	CU_ASSERT(entry->dev == blob->back_bs_dev);
+
+	/* After a local write the cluster is allocated and the stale entry is
+	 * simply never consulted again. */
+	memset(payload_write, 0xAA, sizeof(payload_write));
+	spdk_blob_io_write(blob, channel, payload_write, 0, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+
+	memset(payload_read, 0xFF, sizeof(payload_read));
+	spdk_blob_io_read(blob, channel, payload_read, 0, 1, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+	CU_ASSERT(memcmp(payload_write, payload_read, sizeof(payload_read)) == 0);
+
+	spdk_bs_free_io_channel(channel);
+	poll_threads();
+
+	ut_blob_close_and_delete(bs, blob);
+	ut_blob_close_and_delete(bs, snapshot);
+}
+
 /**
  * Inflate / decouple parent rw unit tests.
  *
@@ -9902,6 +10399,82 @@ ut_blob_close_and_delete(struct spdk_blob_store *bs, struct spdk_blob *blob)
 	g_bserrno = -1;
 }
 
+static void
+blob_io_copy_offload(void)
+{
+	struct spdk_blob_store *bs = g_bs;
+	struct spdk_blob *blob, *thin_blob;
+	struct spdk_io_channel *channel;
+	struct spdk_blob_opts opts;
+	uint8_t payload_write[10 * 4096];
+	uint8_t payload_read[10 * 4096];
+	uint64_t copy_bytes_start;
+	uint64_t io_units_per_cluster;
+
+	io_units_per_cluster = spdk_bs_get_cluster_size(bs) / spdk_bs_get_page_size(bs);
+	SPDK_CU_ASSERT_FATAL(io_units_per_cluster >= 30);
+
+	channel = spdk_bs_alloc_io_channel(bs);
+	CU_ASSERT(channel != NULL);
+
+	ut_spdk_blob_opts_init(&opts);
+	opts.num_clusters = 4;
+
+	blob = ut_blob_create_and_open(bs, &opts);
+
+	memset(payload_write, 0xE5, sizeof(payload_write));
+	spdk_blob_io_write(blob, channel, payload_write, 0, 10, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+
+	copy_bytes_start = g_dev_copy_bytes;
+
+	spdk_blob_io_copy(blob, channel, 20, 0, 10, blob_op_complete, NULL);
+	poll_threads();
+	if (g_dev_copy_enabled) {
+		CU_ASSERT(g_bserrno == 0);
+		CU_ASSERT(g_dev_copy_bytes - copy_bytes_start == 10 * 4096);
+
+		memset(payload_read, 0xFF, sizeof(payload_read));
+		spdk_blob_io_read(blob, channel, payload_read, 20, 10, blob_op_complete, NULL);
+		poll_threads();
+		CU_ASSERT(g_bserrno == 0);
+		CU_ASSERT(memcmp(payload_write, payload_read, sizeof(payload_read)) == 0);
+	} else {
+		/* Without copy offload the caller is told to fall back. */
+		CU_ASSERT(g_bserrno == -ENOTSUP);
+		CU_ASSERT(g_dev_copy_bytes == copy_bytes_start);
+	}
+
+	/* Zero-length copies complete immediately. */
+	spdk_blob_io_copy(blob, channel, 0, 20, 0, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == 0);
+
+	/* Ranges past the end of the blob are rejected. */
+	spdk_blob_io_copy(blob, channel, 4 * io_units_per_cluster, 0, 10, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == -EINVAL);
+
+	/* Unallocated clusters cannot be copied on the device, even when copy
+	 * offload is available. */
+	ut_spdk_blob_opts_init(&opts);
+	opts.thin_provision = true;
+	opts.num_clusters = 4;
+
+	thin_blob = ut_blob_create_and_open(bs, &opts);
+
+	spdk_blob_io_copy(thin_blob, channel, 20, 0, 10, blob_op_complete, NULL);
+	poll_threads();
+	CU_ASSERT(g_bserrno == -ENOTSUP);
+
+	ut_blob_close_and_delete(bs, thin_blob);
+	ut_blob_close_and_delete(bs, blob);
+
+	spdk_bs_free_io_channel(channel);
+	poll_threads();
+}
+
 static void
 suite_blob_setup(void)
 {
@@ -10008,8 +10581,10 @@ main(int argc, char **argv)
 		CU_ADD_TEST(suite, blob_thin_provision);
 		CU_ADD_TEST(suite_bs, blob_snapshot);
 		CU_ADD_TEST(suite_bs, blob_clone);
+		CU_ADD_TEST(suite_bs, blob_create_clones);
 		CU_ADD_TEST(suite_bs, blob_inflate);
 		CU_ADD_TEST(suite_bs, blob_delete);
+		CU_ADD_TEST(suite_bs, blob_delete_blobs);
 		CU_ADD_TEST(suite_bs, blob_resize_test);
 		CU_ADD_TEST(suite_bs, blob_resize_thin_test);
 		CU_ADD_TEST(suite, blob_read_only);
@@ -10050,13 +10625,17 @@ main(int argc, char **argv)
 		CU_ADD_TEST(suite_bs, blob_thin_prov_alloc);
 		CU_ADD_TEST(suite_bs, blob_insert_cluster_msg_test);
 		CU_ADD_TEST(suite_bs, blob_thin_prov_rw);
+		CU_ADD_TEST(suite_bs, blob_thin_prov_cluster_cache);
+		CU_ADD_TEST(suite_bs, blob_persist_md_prefix_reuse);
 		CU_ADD_TEST(suite, blob_thin_prov_write_count_io);
+		CU_ADD_TEST(suite, blob_thin_prov_seq_prealloc);
 		CU_ADD_TEST(suite, blob_thin_prov_unmap_cluster);
 		CU_ADD_TEST(suite_bs, blob_thin_prov_rle);
 		CU_ADD_TEST(suite_bs, blob_thin_prov_rw_iov);
 		CU_ADD_TEST(suite, bs_load_iter_test);
 		CU_ADD_TEST(suite_bs, blob_snapshot_rw);
 		CU_ADD_TEST(suite_bs, blob_snapshot_rw_iov);
+		CU_ADD_TEST(suite_bs, blob_snapshot_chain_read_cache);
 		CU_ADD_TEST(suite, blob_relations);
 		CU_ADD_TEST(suite, blob_relations2);
 		CU_ADD_TEST(suite, blob_relations3);
@@ -10069,6 +10648,7 @@ main(int argc, char **argv)
 		CU_ADD_TEST(suite_bs, blob_operation_split_rw_iov);
 		CU_ADD_TEST(suite, blob_io_unit);
 		CU_ADD_TEST(suite, blob_io_unit_compatibility);
+		CU_ADD_TEST(suite_bs, blob_io_copy_offload);
 		CU_ADD_TEST(suite_bs, blob_simultaneous_operations);
 		CU_ADD_TEST(suite_bs, blob_persist_test);
 		CU_ADD_TEST(suite_bs, blob_decouple_snapshot);
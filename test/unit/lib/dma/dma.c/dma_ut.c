@@ -59,6 +59,23 @@ test_memory_domain_memzero_cb(struct spdk_memory_domain *src_domain, void *src_d
 	return g_memory_domain_cb_rc;
 }
 
+static int g_memory_domain_translate_count;
+
+static int
+test_translation_cache_translate_cb(struct spdk_memory_domain *src_device, void *src_device_ctx,
+				    struct spdk_memory_domain *dst_device, struct spdk_memory_domain_translation_ctx *dst_device_ctx,
+				    void *addr, size_t len, struct spdk_memory_domain_translation_result *result)
+{
+	g_memory_domain_translate_count++;
+
+	result->iov_count = 1;
+	result->iov.iov_base = addr;
+	result->iov.iov_len = len;
+	result->dst_domain = dst_device;
+
+	return 0;
+}
+
 static void
 test_dma(void)
 {
@@ -234,6 +251,77 @@ test_dma(void)
 	CU_ASSERT(spdk_memory_domain_get_first(NULL) == system_domain);
 }
 
+static void
+test_dma_translation_cache(void)
+{
+	struct spdk_memory_domain *domain = NULL;
+	struct spdk_memory_domain_translation_result result;
+	struct iovec iov;
+	void *addr = (void *)0x100000;
+	int rc;
+
+	/* The system domain cannot cache translations. Expect fail */
+	rc = spdk_memory_domain_set_translation_cache(spdk_memory_domain_get_system_domain(), 16);
+	CU_ASSERT(rc == -EINVAL);
+
+	rc = spdk_memory_domain_create(&domain, SPDK_DMA_DEVICE_TYPE_RDMA, NULL, "test_cache");
+	CU_ASSERT(rc == 0);
+	SPDK_CU_ASSERT_FATAL(domain != NULL);
+
+	spdk_memory_domain_set_translation(domain, test_translation_cache_translate_cb);
+
+	rc = spdk_memory_domain_set_translation_cache(domain, 16);
+	CU_ASSERT(rc == 0);
+
+	/* First translation invokes the callback and populates the cache */
+	g_memory_domain_translate_count = 0;
+	rc = spdk_memory_domain_translate_data(domain, NULL, domain, NULL, addr, 0x1000, &result);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_memory_domain_translate_count == 1);
+	CU_ASSERT(result.iov.iov_base == addr);
+
+	/* Repeating the same translation is served from the cache */
+	memset(&result, 0, sizeof(result));
+	rc = spdk_memory_domain_translate_data(domain, NULL, domain, NULL, addr, 0x1000, &result);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_memory_domain_translate_count == 1);
+	CU_ASSERT(result.iov.iov_base == addr);
+	CU_ASSERT(result.iov.iov_len == 0x1000);
+	CU_ASSERT(result.dst_domain == domain);
+
+	/* A different length of the same buffer misses */
+	rc = spdk_memory_domain_translate_data(domain, NULL, domain, NULL, addr, 0x2000, &result);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_memory_domain_translate_count == 2);
+
+	/* Range invalidation drops overlapping entries */
+	spdk_memory_domain_invalidate_translation_cache(domain, addr, 0x1000);
+	rc = spdk_memory_domain_translate_data(domain, NULL, domain, NULL, addr, 0x2000, &result);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_memory_domain_translate_count == 3);
+
+	/* spdk_memory_domain_invalidate_data() drops entries as well, even without
+	 * an invalidate callback */
+	iov.iov_base = addr;
+	iov.iov_len = 0x2000;
+	spdk_memory_domain_invalidate_data(domain, NULL, &iov, 1);
+	rc = spdk_memory_domain_translate_data(domain, NULL, domain, NULL, addr, 0x2000, &result);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_memory_domain_translate_count == 4);
+
+	/* Disabling the cache frees it and every translation hits the callback again */
+	rc = spdk_memory_domain_set_translation_cache(domain, 0);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(domain->tcache == NULL);
+	rc = spdk_memory_domain_translate_data(domain, NULL, domain, NULL, addr, 0x1000, &result);
+	CU_ASSERT(rc == 0);
+	rc = spdk_memory_domain_translate_data(domain, NULL, domain, NULL, addr, 0x1000, &result);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_memory_domain_translate_count == 6);
+
+	spdk_memory_domain_destroy(domain);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -244,6 +332,7 @@ main(int argc, char **argv)
 
 	suite = CU_add_suite("dma_suite", NULL, NULL);
 	CU_ADD_TEST(suite, test_dma);
+	CU_ADD_TEST(suite, test_dma_translation_cache);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
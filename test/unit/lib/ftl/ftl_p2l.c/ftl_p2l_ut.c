@@ -20,6 +20,9 @@ DEFINE_STUB_V(ftl_bitmap_destroy, (struct ftl_bitmap *bitmap));
 DEFINE_STUB_V(ftl_bitmap_set, (struct ftl_bitmap *bitmap, uint64_t bit));
 DEFINE_STUB(ftl_bitmap_get, bool, (const struct ftl_bitmap *bitmap, uint64_t bit), false);
 DEFINE_STUB_V(ftl_bitmap_clear, (struct ftl_bitmap *bitmap, uint64_t bit));
+DEFINE_STUB(ftl_bitmap_find_first_set, uint64_t, (struct ftl_bitmap *bitmap, uint64_t start_bit,
+		uint64_t end_bit), UINT64_MAX);
+DEFINE_STUB(ftl_bitmap_bits_to_size, uint64_t, (uint64_t bits), 8);
 DEFINE_STUB(ftl_md_vss_buf_alloc, union ftl_md_vss *, (struct ftl_layout_region *region,
 		uint32_t count), NULL);
 DEFINE_STUB_V(ftl_band_set_p2l, (struct ftl_band *band, uint64_t lba, ftl_addr addr,
@@ -53,6 +56,8 @@ DEFINE_STUB(ftl_md_get_vss_buffer, union ftl_md_vss *, (struct ftl_md *md), NULL
 DEFINE_STUB_V(ftl_writer_run, (struct ftl_writer *writer));
 DEFINE_STUB_V(ftl_reloc, (struct ftl_reloc *reloc));
 DEFINE_STUB_V(ftl_l2p_process, (struct spdk_ftl_dev *dev));
+DEFINE_STUB_V(ftl_hotness_sketch_decay, (struct ftl_hotness_sketch *sketch));
+DEFINE_STUB_V(ftl_io_channel_flush_completions, (struct ftl_io_channel *ioch));
 DEFINE_STUB_V(ftl_nv_cache_process, (struct spdk_ftl_dev *dev));
 DEFINE_STUB(ftl_reloc_is_halted, bool, (const struct ftl_reloc *reloc), false);
 DEFINE_STUB(ftl_writer_is_halted, bool, (struct ftl_writer *writer), true);
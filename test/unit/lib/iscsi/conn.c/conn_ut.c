@@ -22,6 +22,10 @@ DEFINE_STUB(iscsi_get_pdu, struct spdk_iscsi_pdu *,
 DEFINE_STUB(iscsi_param_eq_val, int,
 	    (struct iscsi_param *params, const char *key, const char *val), 0);
 DEFINE_STUB(iscsi_pdu_calc_data_digest, uint32_t, (struct spdk_iscsi_pdu *pdu), 0);
+DEFINE_STUB(iscsi_pdu_finalize_data_digest, uint32_t, (struct spdk_iscsi_pdu *pdu), 0);
+DEFINE_STUB(spdk_accel_submit_crc32c, int,
+	    (struct spdk_io_channel *ch, uint32_t *crc_dst, void *src, uint32_t seed,
+	     uint64_t nbytes, spdk_accel_completion_cb cb_fn, void *cb_arg), -ENOTSUP);
 DEFINE_STUB_V(spdk_sock_writev_async,
 	      (struct spdk_sock *sock, struct spdk_sock_request *req));
 
@@ -170,6 +170,26 @@ test_parse_string_simple(void)
 	VAL_STRING("hello world");
 }
 
+static void
+test_parse_string_long(void)
+{
+	/* Strings longer than one 16-byte vector chunk */
+	STR_PASS("abcdefghijklmnopqrstuvwxyz0123456789", "abcdefghijklmnopqrstuvwxyz0123456789");
+
+	/* A long plain run followed by an escape */
+	STR_PASS("abcdefghijklmnopqrstuvwxyz\\n0123456789", "abcdefghijklmnopqrstuvwxyz\n0123456789");
+
+	/* An escape followed by a long plain run */
+	STR_PASS("\\tabcdefghijklmnopqrstuvwxyz0123456789", "\tabcdefghijklmnopqrstuvwxyz0123456789");
+
+	/* Terminating quote more than one chunk in */
+	PARSE_FAIL("\"abcdefghijklmnopqrstuvwxyz0123456789", SPDK_JSON_PARSE_INCOMPLETE);
+
+	/* Whitespace runs longer than one vector chunk */
+	PARSE_PASS("                    \"hello\"                    ", 1, "");
+	VAL_STRING("hello");
+}
+
 static void
 test_parse_string_control_chars(void)
 {
@@ -884,6 +904,7 @@ main(int argc, char **argv)
 
 	CU_ADD_TEST(suite, test_parse_literal);
 	CU_ADD_TEST(suite, test_parse_string_simple);
+	CU_ADD_TEST(suite, test_parse_string_long);
 	CU_ADD_TEST(suite, test_parse_string_control_chars);
 	CU_ADD_TEST(suite, test_parse_string_utf8);
 	CU_ADD_TEST(suite, test_parse_string_escapes_twochar);
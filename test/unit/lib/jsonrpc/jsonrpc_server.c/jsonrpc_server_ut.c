@@ -360,6 +360,81 @@ test_parse_request_streaming(void)
 	free(server);
 }
 
+static void
+test_flush_result(void)
+{
+	struct spdk_jsonrpc_server *server;
+	struct spdk_jsonrpc_server_conn *conn;
+	struct jsonrpc_send_chunk *chunk;
+	struct spdk_json_write_ctx *w;
+	ssize_t queued;
+
+	server = calloc(1, sizeof(*server));
+	SPDK_CU_ASSERT_FATAL(server != NULL);
+
+	conn = calloc(1, sizeof(*conn));
+	SPDK_CU_ASSERT_FATAL(conn != NULL);
+	pthread_spin_init(&conn->queue_lock, PTHREAD_PROCESS_PRIVATE);
+	STAILQ_INIT(&conn->outstanding_queue);
+
+	conn->server = server;
+
+	PARSE_PASS("{\"jsonrpc\":\"2.0\",\"method\":\"a\",\"params\":[1],\"id\":1}", "");
+	REQ_BEGIN_VALID();
+	REQ_METHOD("a");
+
+	w = spdk_jsonrpc_begin_result(g_request);
+	SPDK_CU_ASSERT_FATAL(w != NULL);
+	spdk_json_write_array_begin(w);
+	spdk_json_write_string(w, "first element");
+
+	/* Flushing hands the serialized data off to the connection as a chunk */
+	queued = spdk_jsonrpc_flush_result(g_request, w);
+	CU_ASSERT(queued > 0);
+	CU_ASSERT(g_request->send_len == 0);
+	CU_ASSERT(g_request->streaming == true);
+	CU_ASSERT(g_request->chunks_len == (size_t)queued);
+	chunk = STAILQ_FIRST(&g_request->send_chunks);
+	SPDK_CU_ASSERT_FATAL(chunk != NULL);
+	CU_ASSERT(chunk->len == (size_t)queued);
+	CU_ASSERT(memcmp(chunk->buf, "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":[\"first element\"",
+			 chunk->len) == 0);
+
+	/* A flush with no new data just reports the backlog */
+	CU_ASSERT(spdk_jsonrpc_flush_result(g_request, w) == queued);
+
+	/* The rest of the response lands in send_buf as usual */
+	spdk_json_write_string(w, "second element");
+	spdk_json_write_array_end(w);
+	spdk_jsonrpc_end_result(g_request, w);
+	CU_ASSERT(g_request->send_len > 0);
+
+	jsonrpc_free_request(g_request);
+	g_request = NULL;
+
+	/* Responses to requests without an ID are skipped, so flushed data is discarded */
+	PARSE_PASS("{\"jsonrpc\":\"2.0\",\"method\":\"a\",\"params\":[1]}", "");
+	REQ_BEGIN_VALID();
+
+	w = spdk_jsonrpc_begin_result(g_request);
+	SPDK_CU_ASSERT_FATAL(w != NULL);
+	spdk_json_write_string(w, "ignored");
+	CU_ASSERT(spdk_jsonrpc_flush_result(g_request, w) == 0);
+	CU_ASSERT(g_request->send_len == 0);
+	CU_ASSERT(g_request->streaming == false);
+	CU_ASSERT(STAILQ_EMPTY(&g_request->send_chunks));
+	spdk_jsonrpc_end_result(g_request, w);
+
+	jsonrpc_free_request(g_request);
+	g_request = NULL;
+	g_method = NULL;
+	g_cur_param = g_params = NULL;
+
+	CU_ASSERT(conn->outstanding_requests == 0);
+	free(conn);
+	free(server);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -372,6 +447,7 @@ main(int argc, char **argv)
 
 	CU_ADD_TEST(suite, test_parse_request);
 	CU_ADD_TEST(suite, test_parse_request_streaming);
+	CU_ADD_TEST(suite, test_flush_result);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 
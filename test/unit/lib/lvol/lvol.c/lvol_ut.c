@@ -98,6 +98,14 @@ spdk_bs_inflate_blob(struct spdk_blob_store *bs, struct spdk_io_channel *channel
 	cb_fn(cb_arg, g_inflate_rc);
 }
 
+void
+spdk_bs_inflate_blob_ext(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
+			 spdk_blob_id blobid, uint32_t max_in_flight,
+			 spdk_blob_op_complete cb_fn, void *cb_arg)
+{
+	cb_fn(cb_arg, g_inflate_rc);
+}
+
 void
 spdk_bs_blob_decouple_parent(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
 			     spdk_blob_id blobid, spdk_blob_op_complete cb_fn, void *cb_arg)
@@ -105,6 +113,14 @@ spdk_bs_blob_decouple_parent(struct spdk_blob_store *bs, struct spdk_io_channel
 	cb_fn(cb_arg, g_inflate_rc);
 }
 
+void
+spdk_bs_blob_decouple_parent_ext(struct spdk_blob_store *bs, struct spdk_io_channel *channel,
+				 spdk_blob_id blobid, uint32_t max_in_flight,
+				 spdk_blob_op_complete cb_fn, void *cb_arg)
+{
+	cb_fn(cb_arg, g_inflate_rc);
+}
+
 void
 spdk_bs_iter_next(struct spdk_blob_store *bs, struct spdk_blob *b,
 		  spdk_blob_op_with_handle_complete cb_fn, void *cb_arg)
@@ -170,12 +186,27 @@ spdk_bs_load(struct spdk_bs_dev *dev, struct spdk_bs_opts *opts,
 {
 	struct lvol_ut_bs_dev *ut_dev = SPDK_CONTAINEROF(dev, struct lvol_ut_bs_dev, bs_dev);
 	struct spdk_blob_store *bs = NULL;
+	struct spdk_blob *blob;
+	int _errno = ut_dev->load_status;
 
-	if (ut_dev->load_status == 0) {
+	if (_errno == 0) {
 		bs = ut_dev->bs;
+
+		/* Emulate the iteration over all blobs that the blobstore
+		 * performs as part of its load. */
+		TAILQ_FOREACH(blob, &bs->blobs, link) {
+			if (blob->load_status != 0) {
+				_errno = blob->load_status;
+				bs = NULL;
+				break;
+			}
+			if (opts->iter_cb_fn) {
+				opts->iter_cb_fn(opts->iter_cb_arg, blob, 0);
+			}
+		}
 	}
 
-	cb_fn(cb_arg, bs, ut_dev->load_status);
+	cb_fn(cb_arg, bs, _errno);
 }
 
 void
@@ -401,6 +432,26 @@ spdk_bs_delete_blob(struct spdk_blob_store *bs, spdk_blob_id blobid,
 	cb_fn(cb_arg, g_remove_rc);
 }
 
+void
+spdk_bs_delete_blobs(struct spdk_blob_store *bs, spdk_blob_id *blobids, size_t count,
+		     spdk_blob_op_complete cb_fn, void *cb_arg)
+{
+	struct spdk_blob *blob, *tmp;
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		TAILQ_FOREACH_SAFE(blob, &bs->blobs, link, tmp) {
+			if (blob->id == blobids[i]) {
+				TAILQ_REMOVE(&bs->blobs, blob, link);
+				free(blob);
+				break;
+			}
+		}
+	}
+
+	cb_fn(cb_arg, g_remove_rc);
+}
+
 spdk_blob_id
 spdk_blob_get_id(struct spdk_blob *blob)
 {
@@ -553,6 +604,29 @@ spdk_bs_create_clone(struct spdk_blob_store *bs, spdk_blob_id blobid,
 	spdk_bs_create_blob_ext(bs, NULL, cb_fn, cb_arg);
 }
 
+void
+spdk_bs_create_clones(struct spdk_blob_store *bs, spdk_blob_id blobid,
+		      const struct spdk_blob_xattr_opts *clone_xattrs, size_t count,
+		      spdk_blob_id *blobids, spdk_blob_op_complete cb_fn, void *cb_arg)
+{
+	struct spdk_blob *b;
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		b = calloc(1, sizeof(*b));
+		SPDK_CU_ASSERT_FATAL(b != NULL);
+
+		b->id = g_blobid++;
+		b->bs = bs;
+		b->thin_provisioned = true;
+		b->num_clusters = 1;
+		TAILQ_INSERT_TAIL(&bs->blobs, b, link);
+		blobids[i] = b->id;
+	}
+
+	cb_fn(cb_arg, 0);
+}
+
 static int g_spdk_blob_get_esnap_id_errno;
 static bool g_spdk_blob_get_esnap_id_called;
 static void *g_spdk_blob_get_esnap_id;
@@ -1027,6 +1101,61 @@ lvol_destroy_fail(void)
 	free_dev(&dev);
 }
 
+static void
+lvol_destroy_bulk(void)
+{
+	struct lvol_ut_bs_dev dev;
+	struct spdk_lvs_opts opts;
+	struct spdk_lvol *lvols[3];
+	char name[16];
+	size_t i;
+	int rc = 0;
+
+	init_dev(&dev);
+
+	spdk_lvs_opts_init(&opts);
+	snprintf(opts.name, sizeof(opts.name), "lvs");
+
+	g_lvserrno = -1;
+	rc = spdk_lvs_init(&dev.bs_dev, &opts, lvol_store_op_with_handle_complete, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_lvserrno == 0);
+	SPDK_CU_ASSERT_FATAL(g_lvol_store != NULL);
+
+	for (i = 0; i < SPDK_COUNTOF(lvols); i++) {
+		snprintf(name, sizeof(name), "lvol%zu", i);
+		spdk_lvol_create(g_lvol_store, name, 10, false, LVOL_CLEAR_WITH_DEFAULT,
+				 lvol_op_with_handle_complete, NULL);
+		CU_ASSERT(g_lvserrno == 0);
+		SPDK_CU_ASSERT_FATAL(g_lvol != NULL);
+		lvols[i] = g_lvol;
+
+		spdk_lvol_close(g_lvol, op_complete, NULL);
+		CU_ASSERT(g_lvserrno == 0);
+	}
+
+	/* Destroying an open lvol fails the whole batch up front */
+	lvols[0]->ref_count = 1;
+	g_lvserrno = 0;
+	spdk_lvol_destroy_bulk(lvols, SPDK_COUNTOF(lvols), op_complete, NULL);
+	CU_ASSERT(g_lvserrno == -EBUSY);
+	CU_ASSERT(!TAILQ_EMPTY(&g_lvol_store->lvols));
+	lvols[0]->ref_count = 0;
+
+	g_lvserrno = -1;
+	spdk_lvol_destroy_bulk(lvols, SPDK_COUNTOF(lvols), op_complete, NULL);
+	CU_ASSERT(g_lvserrno == 0);
+	CU_ASSERT(TAILQ_EMPTY(&g_lvol_store->lvols));
+
+	g_lvserrno = -1;
+	rc = spdk_lvs_unload(g_lvol_store, op_complete, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_lvserrno == 0);
+	g_lvol_store = NULL;
+
+	free_dev(&dev);
+}
+
 static void
 lvol_close(void)
 {
@@ -1760,6 +1889,81 @@ lvol_clone_fail(void)
 	free_dev(&dev);
 }
 
+static void
+lvol_clone_bulk(void)
+{
+	struct lvol_ut_bs_dev dev;
+	struct spdk_lvol *lvol;
+	struct spdk_lvol *snap;
+	struct spdk_lvol *clones[3];
+	struct spdk_lvol *bad_clones[2];
+	const char *clone_names[3] = { "clone0", "clone1", "clone2" };
+	const char *bad_names[2] = { "clone3", "clone0" };
+	struct spdk_lvs_opts opts;
+	size_t i;
+	int rc = 0;
+
+	init_dev(&dev);
+
+	spdk_lvs_opts_init(&opts);
+	snprintf(opts.name, sizeof(opts.name), "lvs");
+
+	g_lvserrno = -1;
+	rc = spdk_lvs_init(&dev.bs_dev, &opts, lvol_store_op_with_handle_complete, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_lvserrno == 0);
+	SPDK_CU_ASSERT_FATAL(g_lvol_store != NULL);
+
+	spdk_lvol_create(g_lvol_store, "lvol", 10, true, LVOL_CLEAR_WITH_DEFAULT,
+			 lvol_op_with_handle_complete, NULL);
+	CU_ASSERT(g_lvserrno == 0);
+	SPDK_CU_ASSERT_FATAL(g_lvol != NULL);
+
+	lvol = g_lvol;
+
+	spdk_lvol_create_snapshot(lvol, "snap", lvol_op_with_handle_complete, NULL);
+	CU_ASSERT(g_lvserrno == 0);
+	SPDK_CU_ASSERT_FATAL(g_lvol != NULL);
+
+	snap = g_lvol;
+
+	g_lvserrno = -1;
+	spdk_lvol_create_clone_bulk(snap, clone_names, 3, clones, op_complete, NULL);
+	CU_ASSERT(g_lvserrno == 0);
+	for (i = 0; i < 3; i++) {
+		SPDK_CU_ASSERT_FATAL(clones[i] != NULL);
+		CU_ASSERT_STRING_EQUAL(clones[i]->name, clone_names[i]);
+		CU_ASSERT(clones[i]->blob != NULL);
+	}
+
+	/* A name clashing with an existing clone fails the whole batch. */
+	g_lvserrno = 0;
+	spdk_lvol_create_clone_bulk(snap, bad_names, 2, bad_clones, op_complete, NULL);
+	CU_ASSERT(g_lvserrno == -EEXIST);
+	CU_ASSERT(bad_clones[0] == NULL);
+
+	for (i = 0; i < 3; i++) {
+		spdk_lvol_close(clones[i], op_complete, NULL);
+		CU_ASSERT(g_lvserrno == 0);
+		g_lvserrno = -1;
+	}
+
+	spdk_lvol_close(snap, op_complete, NULL);
+	CU_ASSERT(g_lvserrno == 0);
+	g_lvserrno = -1;
+
+	spdk_lvol_close(lvol, op_complete, NULL);
+	CU_ASSERT(g_lvserrno == 0);
+	g_lvserrno = -1;
+
+	rc = spdk_lvs_unload(g_lvol_store, op_complete, NULL);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_lvserrno == 0);
+	g_lvol_store = NULL;
+
+	free_dev(&dev);
+}
+
 static void
 lvol_iter_clones(void)
 {
@@ -3574,6 +3778,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, lvol_create_destroy_success);
 	CU_ADD_TEST(suite, lvol_create_fail);
 	CU_ADD_TEST(suite, lvol_destroy_fail);
+	CU_ADD_TEST(suite, lvol_destroy_bulk);
 	CU_ADD_TEST(suite, lvol_close);
 	CU_ADD_TEST(suite, lvol_resize);
 	CU_ADD_TEST(suite, lvol_set_read_only);
@@ -3584,6 +3789,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, lvol_snapshot_fail);
 	CU_ADD_TEST(suite, lvol_clone);
 	CU_ADD_TEST(suite, lvol_clone_fail);
+	CU_ADD_TEST(suite, lvol_clone_bulk);
 	CU_ADD_TEST(suite, lvol_iter_clones);
 	CU_ADD_TEST(suite, lvol_refcnt);
 	CU_ADD_TEST(suite, lvol_names);
@@ -503,6 +503,160 @@ test_nvme_pcie_ctrlr_connect_qpair(void)
 	CU_ASSERT(rc == -ENOMEM);
 }
 
+static void
+test_nvme_pcie_qpair_flush(void)
+{
+	struct nvme_pcie_ctrlr pctrlr = {};
+	struct nvme_pcie_qpair pqpair = {};
+	struct spdk_nvme_pcie_stat stat = {};
+	volatile uint32_t sq_tdbl = 0;
+	int rc;
+
+	pqpair.qpair.ctrlr = &pctrlr.ctrlr;
+	pqpair.stat = &stat;
+	pqpair.sq_tdbl = &sq_tdbl;
+	pqpair.flags.delay_cmd_submit = 1;
+	pqpair.sq_tail = 2;
+	pqpair.last_sq_tail = 0;
+
+	/* Deferred submissions are made visible with a single doorbell write */
+	rc = nvme_pcie_qpair_flush(&pqpair.qpair);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(pqpair.last_sq_tail == 2);
+	CU_ASSERT(sq_tdbl == 2);
+	CU_ASSERT(stat.sq_mmio_doorbell_updates == 1);
+
+	/* Nothing pending - no doorbell write */
+	sq_tdbl = 0;
+	rc = nvme_pcie_qpair_flush(&pqpair.qpair);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(sq_tdbl == 0);
+	CU_ASSERT(stat.sq_mmio_doorbell_updates == 1);
+
+	/* Without delay_cmd_submit the doorbell is always up to date */
+	pqpair.flags.delay_cmd_submit = 0;
+	pqpair.sq_tail = 3;
+	rc = nvme_pcie_qpair_flush(&pqpair.qpair);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(sq_tdbl == 0);
+	CU_ASSERT(stat.sq_mmio_doorbell_updates == 1);
+}
+
+static void
+test_nvme_pcie_qpair_register_payload(void)
+{
+	struct nvme_pcie_ctrlr pctrlr = {};
+	struct nvme_pcie_qpair pqpair = {};
+	struct nvme_tracker tr = {};
+	struct nvme_request req = {};
+	void *buffer = (void *)0x10000000;
+	uint64_t token = 0, token2 = 0;
+	bool applied;
+	int rc;
+
+	pctrlr.ctrlr.page_size = 4096;
+	pqpair.qpair.ctrlr = &pctrlr.ctrlr;
+	tr.prp_sgl_bus_addr = 0xDBADBEEF;
+
+	/* Register a three page buffer - identity mapped by the vtophys stub */
+	rc = nvme_pcie_qpair_register_payload(&pqpair.qpair, buffer, 3 * 4096, &token);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(token == 1);
+	SPDK_CU_ASSERT_FATAL(pqpair.registered_payloads != NULL);
+	CU_ASSERT(pqpair.registered_payloads[0].num_prps == 3);
+	CU_ASSERT(pqpair.registered_payloads[0].prp1 == 0x10000000);
+	CU_ASSERT(pqpair.registered_payloads[0].prp[0] == 0x10001000);
+	CU_ASSERT(pqpair.registered_payloads[0].prp[1] == 0x10002000);
+
+	/* A matching request reuses the cached PRP entries */
+	req.payload = NVME_PAYLOAD_CONTIG(buffer, NULL);
+	req.payload_size = 3 * 4096;
+	applied = nvme_pcie_qpair_apply_registered_payload(&pqpair.qpair, &req, &tr, token, buffer);
+	CU_ASSERT(applied == true);
+	CU_ASSERT(req.cmd.psdt == SPDK_NVME_PSDT_PRP);
+	CU_ASSERT(req.cmd.dptr.prp.prp1 == 0x10000000);
+	CU_ASSERT(req.cmd.dptr.prp.prp2 == tr.prp_sgl_bus_addr);
+	CU_ASSERT(tr.u.prp[0] == 0x10001000);
+	CU_ASSERT(tr.u.prp[1] == 0x10002000);
+
+	/* A size mismatch (e.g. a split child request) falls back to the build path */
+	req.payload_size = 4096;
+	applied = nvme_pcie_qpair_apply_registered_payload(&pqpair.qpair, &req, &tr, token, buffer);
+	CU_ASSERT(applied == false);
+	req.payload_size = 3 * 4096;
+
+	/* A second registration takes the next slot */
+	rc = nvme_pcie_qpair_register_payload(&pqpair.qpair, (void *)0x20000000, 4096, &token2);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(token2 == 2);
+	CU_ASSERT(pqpair.registered_payloads[1].num_prps == 1);
+	CU_ASSERT(pqpair.registered_payloads[1].prp1 == 0x20000000);
+
+	/* Unregistration frees the slot and invalidates the token */
+	rc = nvme_pcie_qpair_unregister_payload(&pqpair.qpair, token);
+	CU_ASSERT(rc == 0);
+	applied = nvme_pcie_qpair_apply_registered_payload(&pqpair.qpair, &req, &tr, token, buffer);
+	CU_ASSERT(applied == false);
+	rc = nvme_pcie_qpair_unregister_payload(&pqpair.qpair, token);
+	CU_ASSERT(rc == -EINVAL);
+
+	free(pqpair.registered_payloads);
+}
+
+static void
+test_nvme_pcie_qpair_stage_cmb_wds(void)
+{
+	struct nvme_pcie_ctrlr pctrlr = {};
+	struct nvme_pcie_qpair pqpair = {};
+	struct nvme_tracker tr = {};
+	struct nvme_request req = {};
+	uint8_t payload[4096] = {};
+	static uint8_t cmb[2 * 4096];
+	bool staged;
+
+	pctrlr.ctrlr.page_size = 4096;
+	pqpair.qpair.ctrlr = &pctrlr.ctrlr;
+	pqpair.cmb_wds.vaddr = cmb;
+	pqpair.cmb_wds.bus_addr = 0xF8000000;
+	tr.cid = 1;
+
+	memset(payload, 0xA5, sizeof(payload));
+	req.payload = NVME_PAYLOAD_CONTIG(payload, NULL);
+	req.payload_size = 512;
+	req.cmd.opc = SPDK_NVME_OPC_WRITE;
+
+	/* Small contiguous write is staged into the tracker's CMB slot */
+	staged = nvme_pcie_qpair_stage_cmb_wds(&pqpair.qpair, &req, &tr);
+	CU_ASSERT(staged == true);
+	CU_ASSERT(req.cmd.dptr.prp.prp1 == 0xF8000000 + 4096);
+	CU_ASSERT(req.cmd.dptr.prp.prp2 == 0);
+	CU_ASSERT(memcmp(&cmb[4096], payload, 512) == 0);
+
+	/* Reads are not staged */
+	req.cmd.opc = SPDK_NVME_OPC_READ;
+	staged = nvme_pcie_qpair_stage_cmb_wds(&pqpair.qpair, &req, &tr);
+	CU_ASSERT(staged == false);
+	req.cmd.opc = SPDK_NVME_OPC_WRITE;
+
+	/* Payloads larger than one page are not staged */
+	req.payload_size = 4097;
+	staged = nvme_pcie_qpair_stage_cmb_wds(&pqpair.qpair, &req, &tr);
+	CU_ASSERT(staged == false);
+	req.payload_size = 512;
+
+	/* Payloads with metadata are not staged */
+	req.payload.md = (void *)0xDEADBEEF;
+	staged = nvme_pcie_qpair_stage_cmb_wds(&pqpair.qpair, &req, &tr);
+	CU_ASSERT(staged == false);
+	req.payload.md = NULL;
+
+	/* SGL payloads are not staged */
+	req.payload = NVME_PAYLOAD_CONTIG(payload, NULL);
+	req.payload.reset_sgl_fn = (spdk_nvme_req_reset_sgl_cb)0xDEADBEEF;
+	staged = nvme_pcie_qpair_stage_cmb_wds(&pqpair.qpair, &req, &tr);
+	CU_ASSERT(staged == false);
+}
+
 static void
 test_nvme_pcie_ctrlr_construct_admin_qpair(void)
 {
@@ -589,6 +743,9 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_nvme_pcie_qpair_construct_destroy);
 	CU_ADD_TEST(suite, test_nvme_pcie_ctrlr_cmd_create_delete_io_queue);
 	CU_ADD_TEST(suite, test_nvme_pcie_ctrlr_connect_qpair);
+	CU_ADD_TEST(suite, test_nvme_pcie_qpair_flush);
+	CU_ADD_TEST(suite, test_nvme_pcie_qpair_stage_cmb_wds);
+	CU_ADD_TEST(suite, test_nvme_pcie_qpair_register_payload);
 	CU_ADD_TEST(suite, test_nvme_pcie_ctrlr_construct_admin_qpair);
 	CU_ADD_TEST(suite, test_nvme_pcie_poll_group_get_stats);
 
@@ -47,6 +47,7 @@ DEFINE_STUB(nvme_transport_get_trtype,
 	    enum spdk_nvme_transport_type,
 	    (const struct spdk_nvme_transport *transport),
 	    SPDK_NVME_TRANSPORT_PCIE);
+DEFINE_STUB_V(nvme_qpair_unpark, (struct spdk_nvme_qpair *qpair));
 
 int
 nvme_transport_poll_group_get_stats(struct spdk_nvme_transport_poll_group *tgroup,
@@ -451,6 +452,43 @@ test_spdk_nvme_poll_group_destroy(void)
 	free(tgroup_1);
 }
 
+static void
+test_spdk_nvme_poll_group_hybrid_polling(void)
+{
+#ifdef __linux__
+	struct spdk_nvme_poll_group *group;
+	int fd, rc;
+
+	group = spdk_nvme_poll_group_create(NULL, NULL);
+	SPDK_CU_ASSERT_FATAL(group != NULL);
+
+	/* Hybrid polling is disabled by default */
+	CU_ASSERT(spdk_nvme_poll_group_get_fd(group) == -ENOTSUP);
+	CU_ASSERT(spdk_nvme_poll_group_enable_hybrid_polling(group, 0) == -EINVAL);
+
+	rc = spdk_nvme_poll_group_enable_hybrid_polling(group, 4);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(group->park_threshold == 4);
+	fd = spdk_nvme_poll_group_get_fd(group);
+	CU_ASSERT(fd >= 0);
+
+	/* Updating the threshold keeps the existing fd group */
+	rc = spdk_nvme_poll_group_enable_hybrid_polling(group, 8);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(group->park_threshold == 8);
+	CU_ASSERT(spdk_nvme_poll_group_get_fd(group) == fd);
+
+	spdk_nvme_poll_group_disable_hybrid_polling(group);
+	CU_ASSERT(group->park_threshold == 0);
+	CU_ASSERT(spdk_nvme_poll_group_get_fd(group) == -ENOTSUP);
+
+	/* Destroying a group with hybrid polling enabled releases its resources */
+	rc = spdk_nvme_poll_group_enable_hybrid_polling(group, 4);
+	CU_ASSERT(rc == 0);
+	SPDK_CU_ASSERT_FATAL(spdk_nvme_poll_group_destroy(group) == 0);
+#endif
+}
+
 static void
 test_spdk_nvme_poll_group_get_free_stats(void)
 {
@@ -503,6 +541,8 @@ main(int argc, char **argv)
 		CU_add_test(suite, "nvme_poll_group_process_completions",
 			    test_spdk_nvme_poll_group_process_completions) == NULL ||
 		CU_add_test(suite, "nvme_poll_group_destroy_test", test_spdk_nvme_poll_group_destroy) == NULL ||
+		CU_add_test(suite, "nvme_poll_group_hybrid_polling_test",
+			    test_spdk_nvme_poll_group_hybrid_polling) == NULL ||
 		CU_add_test(suite, "nvme_poll_group_get_free_stats",
 			    test_spdk_nvme_poll_group_get_free_stats) == NULL
 	) {
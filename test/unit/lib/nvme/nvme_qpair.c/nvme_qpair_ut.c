@@ -26,6 +26,7 @@ struct nvme_driver _g_nvme_driver = {
 DEFINE_STUB_V(nvme_transport_qpair_abort_reqs, (struct spdk_nvme_qpair *qpair));
 DEFINE_STUB(nvme_transport_qpair_submit_request, int,
 	    (struct spdk_nvme_qpair *qpair, struct nvme_request *req), 0);
+DEFINE_STUB(nvme_transport_qpair_flush, int, (struct spdk_nvme_qpair *qpair), 0);
 DEFINE_STUB(spdk_nvme_ctrlr_free_io_qpair, int, (struct spdk_nvme_qpair *qpair), 0);
 DEFINE_STUB_V(nvme_transport_ctrlr_disconnect_qpair, (struct spdk_nvme_ctrlr *ctrlr,
 		struct spdk_nvme_qpair *qpair));
@@ -280,6 +281,79 @@ test_nvme_qpair_process_completions(void)
 	free(admin_qp.req_buf);
 }
 
+static void
+test_nvme_qpair_hybrid_polling(void)
+{
+	struct spdk_nvme_qpair			qpair = {0};
+	struct spdk_nvme_ctrlr			ctrlr = {{0}};
+	struct spdk_nvme_poll_group		group = {};
+	struct spdk_nvme_transport_poll_group	tgroup = {};
+	struct nvme_request			*req;
+	int					rc;
+
+	TAILQ_INIT(&ctrlr.active_io_qpairs);
+	TAILQ_INIT(&ctrlr.active_procs);
+	CU_ASSERT(pthread_mutex_init(&ctrlr.ctrlr_lock, NULL) == 0);
+	nvme_qpair_init(&qpair, 1, &ctrlr, 0, 32, false);
+
+	group.park_efd = -1;
+	group.park_threshold = 2;
+	tgroup.group = &group;
+	qpair.poll_group = &tgroup;
+	qpair.state = NVME_QPAIR_ENABLED;
+
+	/* A single idle poll doesn't park the qpair yet */
+	g_transport_process_completions_rc = 0;
+	rc = spdk_nvme_qpair_process_completions(&qpair, 0);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(qpair.is_parked == 0);
+	CU_ASSERT(qpair.idle_polls == 1);
+
+	/* A poll that reaps completions resets the idle counter */
+	g_transport_process_completions_rc = 1;
+	rc = spdk_nvme_qpair_process_completions(&qpair, 0);
+	CU_ASSERT(rc == 1);
+	CU_ASSERT(qpair.idle_polls == 0);
+
+	/* Two consecutive idle polls park the qpair */
+	g_transport_process_completions_rc = 0;
+	rc = spdk_nvme_qpair_process_completions(&qpair, 0);
+	CU_ASSERT(rc == 0);
+	rc = spdk_nvme_qpair_process_completions(&qpair, 0);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(qpair.is_parked == 1);
+	CU_ASSERT(group.num_parked == 1);
+
+	/* Parked qpairs are not polled at the transport level */
+	g_called_transport_process_completions = false;
+	rc = spdk_nvme_qpair_process_completions(&qpair, 0);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(g_called_transport_process_completions == false);
+
+	/* Submitting a request unparks the qpair */
+	req = nvme_allocate_request_null(&qpair, NULL, NULL);
+	SPDK_CU_ASSERT_FATAL(req != NULL);
+	rc = nvme_qpair_submit_request(&qpair, req);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(qpair.is_parked == 0);
+	CU_ASSERT(group.num_parked == 0);
+	qpair.num_outstanding_reqs = 0;
+
+	/* A parked qpair that leaves the ENABLED state resumes polling */
+	rc = spdk_nvme_qpair_process_completions(&qpair, 0);
+	rc = spdk_nvme_qpair_process_completions(&qpair, 0);
+	CU_ASSERT(qpair.is_parked == 1);
+	qpair.state = NVME_QPAIR_DISCONNECTING;
+	g_called_transport_process_completions = false;
+	rc = spdk_nvme_qpair_process_completions(&qpair, 0);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(qpair.is_parked == 0);
+	CU_ASSERT(group.num_parked == 0);
+	CU_ASSERT(g_called_transport_process_completions == true);
+
+	free(qpair.req_buf);
+}
+
 static void
 test_nvme_completion_is_retry(void)
 {
@@ -759,6 +833,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_ctrlr_failed);
 	CU_ADD_TEST(suite, struct_packing);
 	CU_ADD_TEST(suite, test_nvme_qpair_process_completions);
+	CU_ADD_TEST(suite, test_nvme_qpair_hybrid_polling);
 	CU_ADD_TEST(suite, test_nvme_completion_is_retry);
 #ifdef DEBUG
 	CU_ADD_TEST(suite, test_get_status_string);
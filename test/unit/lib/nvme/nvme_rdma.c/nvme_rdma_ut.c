@@ -1175,35 +1175,22 @@ test_get_rdma_qpair_from_wc(void)
 	const uint32_t test_qp_num = 123;
 	struct nvme_rdma_poll_group	group = {};
 	struct nvme_rdma_qpair rqpair = {};
-	struct spdk_rdma_qp rdma_qp = {};
-	struct ibv_qp qp = { .qp_num = test_qp_num };
 	struct ibv_wc wc = { .qp_num = test_qp_num };
 
-	STAILQ_INIT(&group.group.disconnected_qpairs);
-	STAILQ_INIT(&group.group.connected_qpairs);
+	RB_INIT(&group.qpairs);
 	rqpair.qpair.trtype = SPDK_NVME_TRANSPORT_RDMA;
 
-	/* Test 1 - Simulate case when nvme_rdma_qpair is disconnected but still in one of lists.
-	 * get_rdma_qpair_from_wc must return NULL */
-	STAILQ_INSERT_HEAD(&group.group.disconnected_qpairs, &rqpair.qpair, poll_group_stailq);
+	/* Test 1 - Empty tree. get_rdma_qpair_from_wc must return NULL */
 	CU_ASSERT(get_rdma_qpair_from_wc(&group, &wc) == NULL);
-	STAILQ_REMOVE_HEAD(&group.group.disconnected_qpairs, poll_group_stailq);
 
-	STAILQ_INSERT_HEAD(&group.group.connected_qpairs, &rqpair.qpair, poll_group_stailq);
-	CU_ASSERT(get_rdma_qpair_from_wc(&group, &wc) == NULL);
-	STAILQ_REMOVE_HEAD(&group.group.connected_qpairs, poll_group_stailq);
-
-	/* Test 2 - nvme_rdma_qpair with valid rdma_qp/ibv_qp and qp_num */
-	rdma_qp.qp = &qp;
-	rqpair.rdma_qp = &rdma_qp;
-
-	STAILQ_INSERT_HEAD(&group.group.disconnected_qpairs, &rqpair.qpair, poll_group_stailq);
+	/* Test 2 - qpair with a matching qp_num is indexed in the tree */
+	rqpair.qp_num = test_qp_num;
+	RB_INSERT(nvme_rdma_qpairs_tree, &group.qpairs, &rqpair);
 	CU_ASSERT(get_rdma_qpair_from_wc(&group, &wc) == &rqpair);
-	STAILQ_REMOVE_HEAD(&group.group.disconnected_qpairs, poll_group_stailq);
 
-	STAILQ_INSERT_HEAD(&group.group.connected_qpairs, &rqpair.qpair, poll_group_stailq);
-	CU_ASSERT(get_rdma_qpair_from_wc(&group, &wc) == &rqpair);
-	STAILQ_REMOVE_HEAD(&group.group.connected_qpairs, poll_group_stailq);
+	/* Test 3 - WC for a QP whose qpair was already removed from the tree */
+	RB_REMOVE(nvme_rdma_qpairs_tree, &group.qpairs, &rqpair);
+	CU_ASSERT(get_rdma_qpair_from_wc(&group, &wc) == NULL);
 }
 
 static void
@@ -1918,6 +1918,39 @@ test_nvme_tcp_qpair_submit_request(void)
 	free(tctrlr);
 }
 
+static void
+test_nvme_tcp_qpair_flush(void)
+{
+	struct nvme_tcp_qpair tqpair = {};
+	struct spdk_nvme_qpair *qpair = &tqpair.qpair;
+	struct nvme_tcp_poll_group tgroup = {};
+	int rc;
+
+	/* Qpairs in a poll group rely on the sock group for flushing */
+	qpair->poll_group = &tgroup.group;
+	MOCK_SET(spdk_sock_flush, -1);
+	rc = nvme_tcp_qpair_flush(qpair);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	/* Standalone qpairs flush their socket directly */
+	qpair->poll_group = NULL;
+	MOCK_SET(spdk_sock_flush, 0);
+	rc = nvme_tcp_qpair_flush(qpair);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	/* EAGAIN isn't an error - the data will go out on a later flush */
+	MOCK_SET(spdk_sock_flush, -1);
+	errno = EAGAIN;
+	rc = nvme_tcp_qpair_flush(qpair);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	/* Other errors are reported back to the caller */
+	errno = ENOTCONN;
+	rc = nvme_tcp_qpair_flush(qpair);
+	CU_ASSERT_EQUAL(rc, -ENOTCONN);
+	MOCK_CLEAR(spdk_sock_flush);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -1954,6 +1987,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_nvme_tcp_poll_group_get_stats);
 	CU_ADD_TEST(suite, test_nvme_tcp_ctrlr_construct);
 	CU_ADD_TEST(suite, test_nvme_tcp_qpair_submit_request);
+	CU_ADD_TEST(suite, test_nvme_tcp_qpair_flush);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
@@ -90,7 +90,7 @@ DEFINE_STUB(nvmf_ctrlr_copy_supported,
 	    false);
 
 DEFINE_STUB_V(nvmf_get_discovery_log_page,
-	      (struct spdk_nvmf_tgt *tgt, const char *hostnqn, struct iovec *iov,
+	      (struct spdk_nvmf_ctrlr *ctrlr, struct iovec *iov,
 	       uint32_t iovcnt, uint64_t offset, uint32_t length, struct spdk_nvme_transport_id *cmd_src_trid));
 
 DEFINE_STUB(spdk_nvmf_qpair_get_listen_trid,
@@ -216,6 +216,8 @@ DEFINE_STUB(spdk_nvme_ns_get_format_index, uint32_t,
 DEFINE_STUB(spdk_nvmf_subsystem_is_discovery, bool, (struct spdk_nvmf_subsystem *subsystem), false);
 DEFINE_STUB(nvmf_subsystem_host_auth_required, bool, (struct spdk_nvmf_subsystem *s, const char *n),
 	    false);
+DEFINE_STUB_V(nvmf_subsystem_get_host_qos, (struct spdk_nvmf_subsystem *subsystem,
+		const char *hostnqn, uint64_t *ios_per_sec, uint64_t *bytes_per_sec));
 DEFINE_STUB(nvmf_qpair_auth_init, int, (struct spdk_nvmf_qpair *q), 0);
 DEFINE_STUB(nvmf_auth_request_exec, int, (struct spdk_nvmf_request *r),
 	    SPDK_NVMF_REQUEST_EXEC_STATUS_ASYNCHRONOUS);
@@ -1953,9 +1955,12 @@ static void
 test_fused_compare_and_write(void)
 {
 	struct spdk_nvmf_request req = {};
+	struct spdk_nvmf_request cmp_req = {};
 	struct spdk_nvmf_qpair qpair = {};
 	struct spdk_nvme_cmd cmd = {};
+	struct spdk_nvme_cmd cmp_cmd = {};
 	union nvmf_c2h_msg rsp = {};
+	union nvmf_c2h_msg cmp_rsp = {};
 	struct spdk_nvmf_ctrlr ctrlr = {};
 	struct spdk_nvmf_subsystem subsystem = {};
 	struct spdk_nvmf_ns ns = {};
@@ -2053,6 +2058,30 @@ test_fused_compare_and_write(void)
 	CU_ASSERT(rsp.nvme_cpl.status.sc == SPDK_NVME_SC_INVALID_OPCODE);
 	CU_ASSERT(qpair.first_fused_req == NULL);
 
+	/* Second of fused commands fails before the pair is matched - the parked
+	 * first command is aborted along with it. */
+	cmp_req.qpair = &qpair;
+	cmp_req.cmd = (union nvmf_h2c_msg *)&cmp_cmd;
+	cmp_req.rsp = &cmp_rsp;
+
+	cmp_cmd.nsid = 1;
+	cmp_cmd.fuse = SPDK_NVME_CMD_FUSE_FIRST;
+	cmp_cmd.opc = SPDK_NVME_OPC_COMPARE;
+
+	spdk_nvmf_request_exec(&cmp_req);
+	CU_ASSERT(qpair.first_fused_req == &cmp_req);
+	CU_ASSERT(nvme_status_success(&cmp_rsp.nvme_cpl.status));
+
+	cmd.nsid = 2;
+	cmd.fuse = SPDK_NVME_CMD_FUSE_SECOND;
+	cmd.opc = SPDK_NVME_OPC_WRITE;
+
+	spdk_nvmf_request_exec(&req);
+	CU_ASSERT(rsp.nvme_cpl.status.sc == SPDK_NVME_SC_INVALID_NAMESPACE_OR_FORMAT);
+	CU_ASSERT(qpair.first_fused_req == NULL);
+	CU_ASSERT(cmp_rsp.nvme_cpl.status.sc == SPDK_NVME_SC_ABORTED_MISSING_FUSED);
+	cmd.nsid = 1;
+
 	spdk_bit_array_free(&ctrlr.visible_ns);
 }
 
@@ -2213,6 +2242,16 @@ test_get_ana_log_page_one_ns_per_anagrp(void)
 
 	CU_ASSERT(memcmp(expected_page, actual_page, UT_ANA_LOG_PAGE_SIZE) == 0);
 
+	/* The serialized page is cached and only rebuilt after it is marked dirty. */
+	CU_ASSERT(ctrlr.ana_log_page != NULL);
+	CU_ASSERT(ctrlr.ana_log_page_size == UT_ANA_LOG_PAGE_SIZE);
+	CU_ASSERT(ctrlr.ana_log_page_dirty == false);
+
+	nvmf_ctrlr_ns_changed(&ctrlr, 1);
+	CU_ASSERT(ctrlr.ana_log_page_dirty == true);
+
+	free(ctrlr.ana_log_page);
+
 #undef UT_ANA_DESC_SIZE
 #undef UT_ANA_LOG_PAGE_SIZE
 }
@@ -2310,6 +2349,8 @@ test_get_ana_log_page_multi_ns_per_anagrp(void)
 
 	CU_ASSERT(memcmp(expected_page, actual_page, UT_ANA_LOG_PAGE_SIZE) == 0);
 
+	free(ctrlr.ana_log_page);
+
 #undef UT_ANA_LOG_PAGE_SIZE
 }
 static void
@@ -3363,6 +3404,75 @@ test_nvmf_check_qpair_active(void)
 	}
 }
 
+static void
+test_nvmf_qos_try_charge(void)
+{
+	union nvmf_c2h_msg rsp = {};
+	union nvmf_h2c_msg cmd = {};
+	struct spdk_nvmf_ctrlr ctrlr = {};
+	struct spdk_nvmf_qpair qpair = { .ctrlr = &ctrlr, .qid = 1 };
+	struct spdk_nvmf_request req = { .qpair = &qpair, .cmd = &cmd, .rsp = &rsp };
+	uint64_t residual = 0;
+	int64_t pool = 0;
+
+	cmd.nvme_cmd.opc = SPDK_NVME_OPC_READ;
+	req.length = 4096;
+
+	/* No limits set - always allowed */
+	CU_ASSERT(nvmf_qpair_qos_try_charge(&req) == true);
+
+	/* IOPS limit - a single token in the pool allows a single command */
+	ctrlr.qos_ios_per_sec = 1000;
+	ctrlr.qos_io_pool = 1;
+	CU_ASSERT(nvmf_qpair_qos_try_charge(&req) == true);
+	CU_ASSERT(qpair.qos_io_credits == 0);
+	CU_ASSERT(ctrlr.qos_io_pool == 0);
+	CU_ASSERT(nvmf_qpair_qos_try_charge(&req) == false);
+
+	/* Tokens are pulled into the local cache in batches */
+	ctrlr.qos_io_pool = 100;
+	CU_ASSERT(nvmf_qpair_qos_try_charge(&req) == true);
+	CU_ASSERT(ctrlr.qos_io_pool == 100 - NVMF_QOS_IO_BATCH);
+	CU_ASSERT(qpair.qos_io_credits == NVMF_QOS_IO_BATCH - 1);
+
+	/* Bandwidth limit - a command larger than the available credits runs
+	 * the bucket into debt, which must be repaid before later commands
+	 * may pass.
+	 */
+	ctrlr.qos_ios_per_sec = 0;
+	ctrlr.qos_bytes_per_sec = 1024 * 1024;
+	ctrlr.qos_byte_pool = 512;
+	req.length = 128 * 1024;
+	CU_ASSERT(nvmf_qpair_qos_try_charge(&req) == true);
+	CU_ASSERT(qpair.qos_byte_credits < 0);
+	CU_ASSERT(nvmf_qpair_qos_try_charge(&req) == false);
+	ctrlr.qos_byte_pool = NVMF_QOS_BYTE_BATCH;
+	CU_ASSERT(nvmf_qpair_qos_try_charge(&req) == false);
+	CU_ASSERT(ctrlr.qos_byte_pool == 0);
+
+	/* Admin and fabrics commands are never throttled */
+	ctrlr.qos_byte_pool = 0;
+	qpair.qos_byte_credits = 0;
+	qpair.qid = 0;
+	CU_ASSERT(nvmf_qpair_qos_try_charge(&req) == true);
+	qpair.qid = 1;
+	cmd.nvmf_cmd.opcode = SPDK_NVME_OPC_FABRIC;
+	CU_ASSERT(nvmf_qpair_qos_try_charge(&req) == true);
+
+	/* Refill converts the rate and elapsed ticks into tokens, capping the
+	 * pool at the burst allowance (10ms worth here).
+	 */
+	nvmf_qos_pool_refill(&pool, 1000, 100, 1000, &residual, 8);
+	CU_ASSERT(pool == 10);
+
+	/* Fractional tokens are carried over in the residual */
+	pool = 0;
+	nvmf_qos_pool_refill(&pool, 3, 100, 1000, &residual, 8);
+	CU_ASSERT(pool == 0 && residual == 300);
+	nvmf_qos_pool_refill(&pool, 3, 300, 1000, &residual, 8);
+	CU_ASSERT(pool == 1 && residual == 200);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -3404,6 +3514,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_nvmf_ctrlr_set_features_host_behavior_support);
 	CU_ADD_TEST(suite, test_nvmf_ctrlr_ns_attachment);
 	CU_ADD_TEST(suite, test_nvmf_check_qpair_active);
+	CU_ADD_TEST(suite, test_nvmf_qos_try_charge);
 
 	allocate_threads(1);
 	set_thread(0);
@@ -314,6 +314,12 @@ test_get_rw_ext_params(void)
 	nvmf_bdev_ctrlr_get_rw_ext_params(&cmd, &opts);
 	CU_ASSERT(opts.nvme_cdw12.raw == 0x209875);
 	CU_ASSERT(opts.nvme_cdw13.raw == 0x20000);
+	CU_ASSERT(opts.fua == false);
+
+	to_le32(&cmd.cdw12, 0x9875 | SPDK_NVME_IO_FLAGS_FORCE_UNIT_ACCESS);
+	nvmf_bdev_ctrlr_get_rw_ext_params(&cmd, &opts);
+	CU_ASSERT(opts.nvme_cdw12.raw == (0x9875 | SPDK_NVME_IO_FLAGS_FORCE_UNIT_ACCESS));
+	CU_ASSERT(opts.fua == true);
 }
 
 static void
@@ -488,6 +494,26 @@ test_spdk_nvmf_bdev_ctrlr_compare_and_write_cmd(void)
 	CU_ASSERT(cmp_rsp.nvme_cpl.status.sc == 0);
 	CU_ASSERT(write_rsp.nvme_cpl.status.sct == SPDK_NVME_SCT_GENERIC);
 	CU_ASSERT(write_rsp.nvme_cpl.status.sc == SPDK_NVME_SC_DATA_SGL_LENGTH_INVALID);
+
+	/* 5. Fused command namespace mismatch */
+	cmp_cmd.nsid = 2;
+
+	cmp_cmd.cdw10 = 1;	/* SLBA: CDW10 and CDW11 */
+	cmp_cmd.cdw12 = 1;	/* NLB: CDW12 bits 15:00, 0's based */
+
+	write_cmd.cdw10 = 1;	/* SLBA: CDW10 and CDW11 */
+	write_cmd.cdw12 = 1;	/* NLB: CDW12 bits 15:00, 0's based */
+	write_req.length = (write_cmd.cdw12 + 1) * bdev.blocklen;
+
+	rc = nvmf_bdev_ctrlr_compare_and_write_cmd(&bdev, desc, &ch, &cmp_req, &write_req);
+
+	CU_ASSERT(rc == SPDK_NVMF_REQUEST_EXEC_STATUS_COMPLETE);
+	CU_ASSERT(cmp_rsp.nvme_cpl.status.sct == 0);
+	CU_ASSERT(cmp_rsp.nvme_cpl.status.sc == 0);
+	CU_ASSERT(write_rsp.nvme_cpl.status.sct == SPDK_NVME_SCT_GENERIC);
+	CU_ASSERT(write_rsp.nvme_cpl.status.sc == SPDK_NVME_SC_INVALID_FIELD);
+
+	cmp_cmd.nsid = 1;
 }
 
 static void
@@ -279,12 +279,15 @@ test_discovery_log(void)
 {
 	struct spdk_nvmf_tgt tgt = {};
 	struct spdk_nvmf_subsystem *subsystem;
+	struct spdk_nvmf_subsystem disc_subsystem = {};
+	struct spdk_nvmf_ctrlr ctrlr = {};
 	uint8_t buffer[8192];
 	struct iovec iov;
 	struct spdk_nvmf_discovery_log_page *disc_log;
 	struct spdk_nvmf_discovery_log_page_entry *entry;
 	struct spdk_nvme_transport_id trid = {};
 	const char *hostnqn = "nqn.2016-06.io.spdk:host1";
+	const void *cached_log;
 	int rc;
 
 	iov.iov_base = buffer;
@@ -294,6 +297,10 @@ test_discovery_log(void)
 	tgt.subsystem_ids = spdk_bit_array_create(tgt.max_subsystems);
 	RB_INIT(&tgt.subsystems);
 
+	disc_subsystem.tgt = &tgt;
+	ctrlr.subsys = &disc_subsystem;
+	snprintf(ctrlr.hostnqn, sizeof(ctrlr.hostnqn), "%s", hostnqn);
+
 	/* Add one subsystem and verify that the discovery log contains it */
 	subsystem = spdk_nvmf_subsystem_create(&tgt, "nqn.2016-06.io.spdk:subsystem1",
 					       SPDK_NVMF_SUBTYPE_NVME, 0);
@@ -305,7 +312,7 @@ test_discovery_log(void)
 	/* Get only genctr (first field in the header) */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, sizeof(disc_log->genctr),
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, sizeof(disc_log->genctr),
 				    &trid);
 	/* No listeners yet on new subsystem, so genctr should still be 0. */
 	CU_ASSERT(disc_log->genctr == 0);
@@ -317,14 +324,14 @@ test_discovery_log(void)
 	/* Get only genctr (first field in the header) */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, sizeof(disc_log->genctr),
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, sizeof(disc_log->genctr),
 				    &trid);
 	CU_ASSERT(disc_log->genctr == 1); /* one added subsystem and listener */
 
 	/* Get only the header, no entries */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, sizeof(*disc_log),
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, sizeof(*disc_log),
 				    &trid);
 	CU_ASSERT(disc_log->genctr == 1);
 	CU_ASSERT(disc_log->numrec == 1);
@@ -332,7 +339,7 @@ test_discovery_log(void)
 	/* Offset 0, exact size match */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0,
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0,
 				    sizeof(*disc_log) + sizeof(disc_log->entries[0]), &trid);
 	CU_ASSERT(disc_log->genctr != 0);
 	CU_ASSERT(disc_log->numrec == 1);
@@ -341,19 +348,23 @@ test_discovery_log(void)
 	/* Offset 0, oversize buffer */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, sizeof(buffer), &trid);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, sizeof(buffer), &trid);
 	CU_ASSERT(disc_log->genctr != 0);
 	CU_ASSERT(disc_log->numrec == 1);
 	CU_ASSERT(disc_log->entries[0].trtype == 42);
 	CU_ASSERT(spdk_mem_all_zero(buffer + sizeof(*disc_log) + sizeof(disc_log->entries[0]),
 				    sizeof(buffer) - (sizeof(*disc_log) + sizeof(disc_log->entries[0]))));
+	cached_log = ctrlr.disc_log_page;
+	CU_ASSERT(cached_log != NULL);
 
-	/* Get just the first entry, no header */
+	/* Get just the first entry, no header.  Nothing changed, so the poll is
+	 * served from the cached serialization. */
 	memset(buffer, 0xCC, sizeof(buffer));
 	entry = (struct spdk_nvmf_discovery_log_page_entry *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1,
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1,
 				    offsetof(struct spdk_nvmf_discovery_log_page, entries[0]), sizeof(*entry), &trid);
 	CU_ASSERT(entry->trtype == 42);
+	CU_ASSERT(ctrlr.disc_log_page == cached_log);
 
 	/* remove the host and verify that the discovery log contains nothing */
 	rc = spdk_nvmf_subsystem_remove_host(subsystem, hostnqn);
@@ -362,7 +373,7 @@ test_discovery_log(void)
 	/* Get only the header, no entries */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, sizeof(*disc_log),
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, sizeof(*disc_log),
 				    &trid);
 	CU_ASSERT(disc_log->genctr != 0);
 	CU_ASSERT(disc_log->numrec == 0);
@@ -375,11 +386,12 @@ test_discovery_log(void)
 	/* Get only the header, no entries */
 	memset(buffer, 0xCC, sizeof(buffer));
 	disc_log = (struct spdk_nvmf_discovery_log_page *)buffer;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, sizeof(*disc_log),
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, sizeof(*disc_log),
 				    &trid);
 	CU_ASSERT(disc_log->genctr != 0);
 	CU_ASSERT(disc_log->numrec == 0);
 
+	free(ctrlr.disc_log_page);
 	spdk_bit_array_free(&tgt.subsystem_ids);
 }
 
@@ -411,6 +423,8 @@ test_discovery_log_with_filters(void)
 		= { .listener_discover = test_tcp_discover };
 	struct spdk_nvmf_transport rdma_tr = {.ops = &rdma_tr_ops }, tcp_tr = { .ops = &tcp_tr_ops };
 	struct spdk_nvmf_subsystem *subsystem;
+	struct spdk_nvmf_subsystem disc_subsystem = {};
+	struct spdk_nvmf_ctrlr ctrlr = {};
 	const char *hostnqn = "nqn.2016-06.io.spdk:host1";
 	uint8_t buffer[8192];
 	struct iovec iov;
@@ -428,6 +442,10 @@ test_discovery_log_with_filters(void)
 	tgt.subsystem_ids = spdk_bit_array_create(tgt.max_subsystems);
 	RB_INIT(&tgt.subsystems);
 
+	disc_subsystem.tgt = &tgt;
+	ctrlr.subsys = &disc_subsystem;
+	snprintf(ctrlr.hostnqn, sizeof(ctrlr.hostnqn), "%s", hostnqn);
+
 	subsystem = spdk_nvmf_subsystem_create(&tgt, "nqn.2016-06.io.spdk:subsystem1",
 					       SPDK_NVMF_SUBTYPE_NVME, 0);
 	subsystem->allow_any_host = true;
@@ -504,12 +522,12 @@ test_discovery_log_with_filters(void)
 
 	/* Test case 1 - check that all trids are reported */
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_ANY;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 8);
 
 	/* Test case 2 - check that only entries of the same transport type are returned */
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_TYPE;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 5);
 	CU_ASSERT(disc_log->entries[0].trtype == rdma_trid_1.trtype);
 	CU_ASSERT(disc_log->entries[1].trtype == rdma_trid_1.trtype);
@@ -517,7 +535,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[3].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[4].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_1);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &tcp_trid_1);
 	CU_ASSERT(disc_log->numrec == 5);
 	CU_ASSERT(disc_log->entries[0].trtype == tcp_trid_1.trtype);
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_1.trtype);
@@ -527,7 +545,7 @@ test_discovery_log_with_filters(void)
 
 	/* Test case 3 - check that only entries of the same transport address are returned */
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_ADDRESS;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 5);
 	/* 1 tcp and 3 rdma  */
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_1.traddr) == 0);
@@ -536,7 +554,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(strcasecmp(disc_log->entries[3].traddr, tcp_trid_4.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[4].traddr, rdma_trid_4.traddr) == 0);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_1);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &tcp_trid_1);
 	CU_ASSERT(disc_log->numrec == 5);
 	/* 1 rdma and 3 tcp */
 	CU_ASSERT((disc_log->entries[0].trtype ^ disc_log->entries[1].trtype ^ disc_log->entries[2].trtype)
@@ -550,7 +568,7 @@ test_discovery_log_with_filters(void)
 	/* Test case 4 - check that only entries of the same transport address and type returned */
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_TYPE |
 			       SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_ADDRESS;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 4);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_1.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, rdma_trid_1.traddr) == 0);
@@ -561,7 +579,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[2].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[3].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_2);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_2);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_2.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -570,7 +588,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_1);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &tcp_trid_1);
 	CU_ASSERT(disc_log->numrec == 4);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_1.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_1.traddr) == 0);
@@ -581,7 +599,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[2].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[3].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_2);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_2);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_2.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -593,7 +611,7 @@ test_discovery_log_with_filters(void)
 	/* Test case 5 - check that only entries of the same transport address and type returned */
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_TYPE |
 			       SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_SVCID;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 4);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].trsvcid, rdma_trid_1.trsvcid) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].trsvcid, rdma_trid_2.trsvcid) == 0);
@@ -604,7 +622,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[2].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[3].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_3);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_3);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].trsvcid, rdma_trid_3.trsvcid) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].trsvcid, tcp_trid_4.trsvcid) == 0);
@@ -613,7 +631,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_1);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &tcp_trid_1);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].trsvcid, tcp_trid_1.trsvcid) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].trsvcid, tcp_trid_4.trsvcid) == 0);
@@ -622,7 +640,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_2);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &tcp_trid_2);
 	CU_ASSERT(disc_log->numrec == 4);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].trsvcid, tcp_trid_2.trsvcid) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].trsvcid, tcp_trid_2.trsvcid) == 0);
@@ -637,7 +655,7 @@ test_discovery_log_with_filters(void)
 	 * That also implies trtype since RDMA and TCP listeners can't occupy the same socket */
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_ADDRESS |
 			       SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_SVCID;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_1.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -649,7 +667,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_2);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_2);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_2.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -661,7 +679,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_3);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_3);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_3.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -673,7 +691,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_1);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &tcp_trid_1);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_1.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -685,7 +703,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_2);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &tcp_trid_2);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_2.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -697,7 +715,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_3);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &tcp_trid_3);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_3.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -713,7 +731,7 @@ test_discovery_log_with_filters(void)
 	tgt.discovery_filter = SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_TYPE |
 			       SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_ADDRESS |
 			       SPDK_NVMF_TGT_DISCOVERY_MATCH_TRANSPORT_SVCID;
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_1);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_1);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_1.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -725,7 +743,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_2);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_2);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_2.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -737,7 +755,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &rdma_trid_3);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &rdma_trid_3);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, rdma_trid_3.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -749,7 +767,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_1);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &tcp_trid_1);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_1.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -761,7 +779,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_2);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &tcp_trid_2);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_2.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -773,7 +791,7 @@ test_discovery_log_with_filters(void)
 	CU_ASSERT(disc_log->entries[1].trtype == tcp_trid_4.trtype);
 	CU_ASSERT(disc_log->entries[2].trtype == rdma_trid_4.trtype);
 
-	nvmf_get_discovery_log_page(&tgt, hostnqn, &iov, 1, 0, 8192, &tcp_trid_3);
+	nvmf_get_discovery_log_page(&ctrlr, &iov, 1, 0, 8192, &tcp_trid_3);
 	CU_ASSERT(disc_log->numrec == 3);
 	CU_ASSERT(strcasecmp(disc_log->entries[0].traddr, tcp_trid_3.traddr) == 0);
 	CU_ASSERT(strcasecmp(disc_log->entries[1].traddr, tcp_trid_4.traddr) == 0);
@@ -787,6 +805,7 @@ test_discovery_log_with_filters(void)
 
 	subsystem->state = SPDK_NVMF_SUBSYSTEM_INACTIVE;
 	spdk_nvmf_subsystem_destroy(subsystem, NULL, NULL);
+	free(ctrlr.disc_log_page);
 	spdk_bit_array_free(&tgt.subsystem_ids);
 }
 
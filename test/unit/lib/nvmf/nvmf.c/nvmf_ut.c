@@ -26,8 +26,13 @@ DEFINE_STUB(nvmf_ctrlr_async_event_ana_change_notice, int,
 	    (struct spdk_nvmf_ctrlr *ctrlr), 0);
 DEFINE_STUB(nvmf_transport_poll_group_remove, int, (struct spdk_nvmf_transport_poll_group *group,
 		struct spdk_nvmf_qpair *qpair), 0);
+DEFINE_STUB(nvmf_transport_qpair_migrate_detach, int,
+	    (struct spdk_nvmf_transport_poll_group *group, struct spdk_nvmf_qpair *qpair), 0);
+DEFINE_STUB(nvmf_transport_qpair_migrate_attach, int,
+	    (struct spdk_nvmf_transport_poll_group *group, struct spdk_nvmf_qpair *qpair), 0);
 DEFINE_STUB(nvmf_transport_req_free, int, (struct spdk_nvmf_request *req), 0);
 DEFINE_STUB(nvmf_transport_poll_group_poll, int, (struct spdk_nvmf_transport_poll_group *group), 0);
+DEFINE_STUB_V(nvmf_poll_group_qos_drain, (struct spdk_nvmf_poll_group *group));
 DEFINE_STUB_V(nvmf_subsystem_remove_all_listeners, (struct spdk_nvmf_subsystem *subsystem,
 		bool stop));
 DEFINE_STUB(spdk_nvmf_subsystem_destroy, int, (struct spdk_nvmf_subsystem *subsystem,
@@ -49,6 +49,8 @@ DEFINE_STUB(nvmf_ctrlr_async_event_ana_change_notice,
 	    int,
 	    (struct spdk_nvmf_ctrlr *ctrlr), 0);
 
+DEFINE_STUB_V(nvmf_ctrlr_start_qos_poller, (struct spdk_nvmf_ctrlr *ctrlr));
+
 DEFINE_STUB(spdk_nvme_transport_id_trtype_str,
 	    const char *,
 	    (enum spdk_nvme_transport_type trtype), NULL);
@@ -98,6 +100,13 @@ nvmf_poll_group_update_subsystem(struct spdk_nvmf_poll_group *group,
 	return 0;
 }
 
+int
+nvmf_poll_group_add_ns(struct spdk_nvmf_poll_group *group,
+		       struct spdk_nvmf_subsystem *subsystem, uint32_t nsid)
+{
+	return 0;
+}
+
 int
 nvmf_poll_group_add_subsystem(struct spdk_nvmf_poll_group *group,
 			      struct spdk_nvmf_subsystem *subsystem,
@@ -254,6 +263,17 @@ union spdk_bdev_nvme_ctratt spdk_bdev_get_nvme_ctratt(struct spdk_bdev *bdev)
 	return bdev->ctratt;
 }
 
+static int
+nvmf_tgt_create_poll_group(void *io_device, void *ctx_buf)
+{
+	return 0;
+}
+
+static void
+nvmf_tgt_destroy_poll_group(void *io_device, void *ctx_buf)
+{
+}
+
 static void
 test_spdk_nvmf_subsystem_add_ns(void)
 {
@@ -262,6 +282,10 @@ test_spdk_nvmf_subsystem_add_ns(void)
 		.max_nsid = 1024,
 		.ns = NULL,
 		.tgt = &tgt,
+		.ctrlrs = TAILQ_HEAD_INITIALIZER(subsystem.ctrlrs),
+	};
+	struct spdk_nvmf_ctrlr ctrlr = {
+		.subsys = &subsystem
 	};
 	struct spdk_nvmf_ns_opts ns_opts;
 	uint32_t nsid;
@@ -298,8 +322,43 @@ test_spdk_nvmf_subsystem_add_ns(void)
 	CU_ASSERT(nsid == 0);
 	CU_ASSERT(subsystem.max_nsid == 1024);
 
+	/* Add a namespace to an active subsystem.  The namespace is published to the
+	 * poll groups asynchronously and hosts are only notified once that completes.
+	 */
+	spdk_io_device_register(&tgt,
+				nvmf_tgt_create_poll_group,
+				nvmf_tgt_destroy_poll_group,
+				sizeof(struct spdk_nvmf_poll_group),
+				NULL);
+	ctrlr.visible_ns = spdk_bit_array_create(subsystem.max_nsid);
+	SPDK_CU_ASSERT_FATAL(ctrlr.visible_ns != NULL);
+	TAILQ_INSERT_TAIL(&subsystem.ctrlrs, &ctrlr, link);
+
+	subsystem.state = SPDK_NVMF_SUBSYSTEM_ACTIVE;
+	g_ns_changed_ctrlr = NULL;
+	g_ns_changed_nsid = 0;
+	spdk_nvmf_ns_opts_get_defaults(&ns_opts, sizeof(ns_opts));
+	ns_opts.nsid = 7;
+	nsid = spdk_nvmf_subsystem_add_ns_ext(&subsystem, "bdev2", &ns_opts, sizeof(ns_opts), NULL);
+	CU_ASSERT(nsid == 7);
+	SPDK_CU_ASSERT_FATAL(subsystem.ns[nsid - 1] != NULL);
+	CU_ASSERT(g_ns_changed_nsid == 0);
+
+	poll_threads();
+	CU_ASSERT(g_ns_changed_ctrlr == &ctrlr);
+	CU_ASSERT(g_ns_changed_nsid == nsid);
+
+	TAILQ_REMOVE(&subsystem.ctrlrs, &ctrlr, link);
+	spdk_bit_array_free(&ctrlr.visible_ns);
+	subsystem.state = SPDK_NVMF_SUBSYSTEM_INACTIVE;
+
 	rc = spdk_nvmf_subsystem_remove_ns(&subsystem, 5);
 	CU_ASSERT(rc == 0);
+	rc = spdk_nvmf_subsystem_remove_ns(&subsystem, 7);
+	CU_ASSERT(rc == 0);
+
+	spdk_io_device_unregister(&tgt, NULL);
+	poll_threads();
 
 	free(subsystem.ns);
 	free(subsystem.ana_group);
@@ -1563,17 +1622,6 @@ test_reservation_preempt_notification(void)
 	ut_reservation_deinit();
 }
 
-static int
-nvmf_tgt_create_poll_group(void *io_device, void *ctx_buf)
-{
-	return 0;
-}
-
-static void
-nvmf_tgt_destroy_poll_group(void *io_device, void *ctx_buf)
-{
-}
-
 static void
 test_spdk_nvmf_ns_event(void)
 {
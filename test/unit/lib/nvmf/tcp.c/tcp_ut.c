@@ -71,7 +71,7 @@ DEFINE_STUB(spdk_nvmf_ns_find_host,
 	    NULL);
 
 DEFINE_STUB_V(nvmf_get_discovery_log_page,
-	      (struct spdk_nvmf_tgt *tgt, const char *hostnqn, struct iovec *iov,
+	      (struct spdk_nvmf_ctrlr *ctrlr, struct iovec *iov,
 	       uint32_t iovcnt, uint64_t offset, uint32_t length, struct spdk_nvme_transport_id *cmd_src_trid));
 
 DEFINE_STUB_V(nvmf_subsystem_remove_ctrlr,
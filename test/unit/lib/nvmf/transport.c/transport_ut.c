@@ -227,6 +227,8 @@ test_nvmf_transport_poll_group_create(void)
 	poll_group = nvmf_transport_poll_group_create(&transport, NULL);
 	SPDK_CU_ASSERT_FATAL(poll_group != NULL);
 	CU_ASSERT(poll_group->transport == &transport);
+	CU_ASSERT(poll_group->buf_arena_size == SPDK_NVMF_DEFAULT_BUFFER_CACHE_SIZE);
+	CU_ASSERT(poll_group->buf_arena_count == 0);
 
 	nvmf_transport_poll_group_destroy(poll_group);
 
@@ -237,6 +239,45 @@ test_nvmf_transport_poll_group_create(void)
 	nvmf_transport_poll_group_destroy(poll_group);
 }
 
+static void
+test_nvmf_request_buffer_arena(void)
+{
+	struct spdk_nvmf_transport transport = {};
+	struct spdk_nvmf_transport_poll_group group = {};
+	struct spdk_nvmf_request req = {};
+	void *arena[2] = {};
+	char buf0[8], buf1[8];
+	int rc;
+
+	transport.opts.io_unit_size = 0x1000;
+	transport.opts.num_shared_buffers = 4;
+	group.transport = &transport;
+	group.buf_arena = arena;
+	group.buf_arena_size = SPDK_COUNTOF(arena);
+	group.buf_arena[0] = buf0;
+	group.buf_arena[1] = buf1;
+	group.buf_arena_count = 2;
+
+	/* A request covering two full io units is served from the arena without
+	 * touching the iobuf channel. */
+	rc = spdk_nvmf_request_get_buffers(&req, &group, &transport,
+					   2 * transport.opts.io_unit_size);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(req.data_from_pool == true);
+	CU_ASSERT(req.iovcnt == 2);
+	CU_ASSERT(req.iov[0].iov_base == buf1);
+	CU_ASSERT(req.iov[1].iov_base == buf0);
+	CU_ASSERT(group.buf_arena_count == 0);
+
+	/* Releasing the request recycles the buffers back into the arena. */
+	spdk_nvmf_request_free_buffers(&req, &group, &transport);
+	CU_ASSERT(req.iovcnt == 0);
+	CU_ASSERT(req.data_from_pool == false);
+	CU_ASSERT(group.buf_arena_count == 2);
+	CU_ASSERT(group.buf_arena[0] == buf1);
+	CU_ASSERT(group.buf_arena[1] == buf0);
+}
+
 static void
 test_spdk_nvmf_transport_opts_init(void)
 {
@@ -391,6 +432,7 @@ main(int argc, char **argv)
 
 	CU_ADD_TEST(suite, test_spdk_nvmf_transport_create);
 	CU_ADD_TEST(suite, test_nvmf_transport_poll_group_create);
+	CU_ADD_TEST(suite, test_nvmf_request_buffer_arena);
 	CU_ADD_TEST(suite, test_spdk_nvmf_transport_opts_init);
 	CU_ADD_TEST(suite, test_spdk_nvmf_transport_listen_ext);
 
@@ -87,6 +87,17 @@ pmem_persist(const void *addr, size_t len)
 	sync_pm_buf(addr, len);
 }
 
+void
+pmem_flush(const void *addr, size_t len)
+{
+	sync_pm_buf(addr, len);
+}
+
+void
+pmem_drain(void)
+{
+}
+
 static void
 get_pm_file_size(void)
 {
@@ -457,10 +468,10 @@ ut_build_data_buffer(uint8_t *data, uint32_t data_len, uint8_t init_val, uint32_
 }
 
 static void
-backing_dev_compress(struct spdk_reduce_backing_dev *backing_dev,
-		     struct iovec *src_iov, int src_iovcnt,
-		     struct iovec *dst_iov, int dst_iovcnt,
-		     struct spdk_reduce_vol_cb_args *args)
+backing_dev_compress_execute(struct spdk_reduce_backing_dev *backing_dev,
+			     struct iovec *src_iov, int src_iovcnt,
+			     struct iovec *dst_iov, int dst_iovcnt,
+			     struct spdk_reduce_vol_cb_args *args)
 {
 	uint32_t compressed_len;
 	uint64_t total_length = 0;
@@ -484,6 +495,66 @@ backing_dev_compress(struct spdk_reduce_backing_dev *backing_dev,
 	args->cb_fn(args->cb_arg, rc);
 }
 
+struct ut_reduce_compress_op {
+	struct spdk_reduce_backing_dev		*backing_dev;
+	struct iovec				*src_iov;
+	int					src_iovcnt;
+	struct iovec				*dst_iov;
+	int					dst_iovcnt;
+	struct spdk_reduce_vol_cb_args		*args;
+	TAILQ_ENTRY(ut_reduce_compress_op)	link;
+};
+
+static bool g_defer_compress = false;
+static TAILQ_HEAD(, ut_reduce_compress_op) g_pending_compress_ops =
+	TAILQ_HEAD_INITIALIZER(g_pending_compress_ops);
+static uint32_t g_pending_compress_op_count = 0;
+
+static void
+backing_dev_compress(struct spdk_reduce_backing_dev *backing_dev,
+		     struct iovec *src_iov, int src_iovcnt,
+		     struct iovec *dst_iov, int dst_iovcnt,
+		     struct spdk_reduce_vol_cb_args *args)
+{
+	struct ut_reduce_compress_op *op;
+
+	if (g_defer_compress == false) {
+		backing_dev_compress_execute(backing_dev, src_iov, src_iovcnt,
+					     dst_iov, dst_iovcnt, args);
+		return;
+	}
+
+	op = calloc(1, sizeof(*op));
+	SPDK_CU_ASSERT_FATAL(op != NULL);
+
+	op->backing_dev = backing_dev;
+	op->src_iov = src_iov;
+	op->src_iovcnt = src_iovcnt;
+	op->dst_iov = dst_iov;
+	op->dst_iovcnt = dst_iovcnt;
+	op->args = args;
+	TAILQ_INSERT_TAIL(&g_pending_compress_ops, op, link);
+	g_pending_compress_op_count++;
+}
+
+static void
+compress_op_execute(uint32_t count)
+{
+	struct ut_reduce_compress_op *op;
+	uint32_t done = 0;
+
+	CU_ASSERT(g_defer_compress == true);
+	while (!TAILQ_EMPTY(&g_pending_compress_ops) && (count == 0 || done < count)) {
+		op = TAILQ_FIRST(&g_pending_compress_ops);
+		TAILQ_REMOVE(&g_pending_compress_ops, op, link);
+		g_pending_compress_op_count--;
+		backing_dev_compress_execute(op->backing_dev, op->src_iov, op->src_iovcnt,
+					     op->dst_iov, op->dst_iovcnt, op->args);
+		free(op);
+		done++;
+	}
+}
+
 static void
 backing_dev_decompress(struct spdk_reduce_backing_dev *backing_dev,
 		       struct iovec *src_iov, int src_iovcnt,
@@ -1202,6 +1273,318 @@ overlapped(void)
 	backing_dev_destroy(&backing_dev);
 }
 
+static void
+batched_persist(void)
+{
+	struct spdk_reduce_vol_params params = {};
+	struct spdk_reduce_backing_dev backing_dev = {};
+	const uint32_t logical_block_size = 512;
+	struct iovec iov;
+	char buf[logical_block_size];
+	char compare_buf[logical_block_size];
+	uint64_t chunk1_offset;
+
+	params.chunk_size = 16 * 1024;
+	params.backing_io_unit_size = 4096;
+	params.logical_block_size = logical_block_size;
+	spdk_uuid_generate(&params.uuid);
+
+	backing_dev_init(&backing_dev, &params, 512);
+
+	g_vol = NULL;
+	g_reduce_errno = -1;
+	spdk_reduce_vol_init(&params, &backing_dev, TEST_MD_PATH, init_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	SPDK_CU_ASSERT_FATAL(g_vol != NULL);
+
+	chunk1_offset = g_vol->logical_blocks_per_chunk;
+
+	/* Write 0xAA to one logical block in each of two different chunks.  These
+	 * writes do not overlap, so both will be executing at the same time.
+	 */
+	memset(buf, 0xAA, logical_block_size);
+	iov.iov_base = buf;
+	iov.iov_len = logical_block_size;
+	g_reduce_errno = -100;
+	g_defer_bdev_io = true;
+	spdk_reduce_vol_writev(g_vol, &iov, 1, 0, 1, write_cb, NULL);
+	spdk_reduce_vol_writev(g_vol, &iov, 1, chunk1_offset, 1, write_cb, NULL);
+	CU_ASSERT(g_reduce_errno == -100);
+	CU_ASSERT(g_pending_bdev_io_count == 2);
+	CU_ASSERT(g_vol->num_inflight_writes == 2);
+
+	/* Complete the first write's backing I/O.  Its metadata updates should get
+	 * staged on the pending persists list instead of being persisted, since the
+	 * second write is still in flight and can join the persist batch.
+	 */
+	backing_dev_io_execute(1);
+	CU_ASSERT(g_reduce_errno == -100);
+	CU_ASSERT(g_vol->num_inflight_writes == 1);
+	CU_ASSERT(g_vol->num_pending_persists == 1);
+
+	/* Complete the second write.  This is the last in-flight write, so it
+	 * flushes the persist batch and completes both writes.
+	 */
+	backing_dev_io_execute(0);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(g_vol->num_inflight_writes == 0);
+	CU_ASSERT(g_vol->num_pending_persists == 0);
+	CU_ASSERT(TAILQ_EMPTY(&g_vol->pending_persists));
+
+	g_defer_bdev_io = false;
+	memset(compare_buf, 0xAA, sizeof(compare_buf));
+	memset(buf, 0xFF, sizeof(buf));
+	g_reduce_errno = -100;
+	spdk_reduce_vol_readv(g_vol, &iov, 1, 0, 1, read_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(memcmp(buf, compare_buf, sizeof(buf)) == 0);
+
+	memset(buf, 0xFF, sizeof(buf));
+	g_reduce_errno = -100;
+	spdk_reduce_vol_readv(g_vol, &iov, 1, chunk1_offset, 1, read_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(memcmp(buf, compare_buf, sizeof(buf)) == 0);
+
+	g_reduce_errno = -1;
+	spdk_reduce_vol_unload(g_vol, unload_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+
+	persistent_pm_buf_destroy();
+	backing_dev_destroy(&backing_dev);
+}
+
+static void
+inline_packing(void)
+{
+	struct spdk_reduce_vol_params params = {};
+	struct spdk_reduce_backing_dev backing_dev = {};
+	const uint32_t logical_block_size = 512;
+	struct iovec iova, iovb;
+	char bufa[logical_block_size];
+	char bufb[logical_block_size];
+	char compare_buf[logical_block_size];
+	struct spdk_reduce_chunk_map *chunk0, *chunk1;
+	uint64_t chunk1_offset, shared_io_unit;
+
+	params.chunk_size = 16 * 1024;
+	params.backing_io_unit_size = 4096;
+	params.logical_block_size = logical_block_size;
+	spdk_uuid_generate(&params.uuid);
+
+	backing_dev_init(&backing_dev, &params, 512);
+
+	g_vol = NULL;
+	g_reduce_errno = -1;
+	spdk_reduce_vol_init(&params, &backing_dev, TEST_MD_PATH, init_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	SPDK_CU_ASSERT_FATAL(g_vol != NULL);
+
+	chunk1_offset = g_vol->logical_blocks_per_chunk;
+
+	/* Start two highly compressible writes to two different chunks, with their
+	 * compression operations deferred so that both writes are in the compression
+	 * stage at the same time.
+	 */
+	memset(bufa, 0xAA, sizeof(bufa));
+	iova.iov_base = bufa;
+	iova.iov_len = logical_block_size;
+	memset(bufb, 0xBB, sizeof(bufb));
+	iovb.iov_base = bufb;
+	iovb.iov_len = logical_block_size;
+	g_reduce_errno = -100;
+	g_defer_bdev_io = true;
+	g_defer_compress = true;
+	spdk_reduce_vol_writev(g_vol, &iova, 1, 0, 1, write_cb, NULL);
+	spdk_reduce_vol_writev(g_vol, &iovb, 1, chunk1_offset, 1, write_cb, NULL);
+	CU_ASSERT(g_pending_compress_op_count == 2);
+	CU_ASSERT(g_vol->num_compressing_writes == 2);
+
+	/* Complete the first compression.  The compressed chunk is small, so it
+	 * opens a pack and gets staged there - no backing I/O is issued yet, since
+	 * the second write is still compressing and may join the pack.
+	 */
+	compress_op_execute(1);
+	CU_ASSERT(g_vol->open_pack != NULL);
+	CU_ASSERT(g_pending_bdev_io_count == 0);
+
+	/* Complete the second compression.  Its chunk joins the pack, and since no
+	 * other write is in the compression stage anymore the pack is written out
+	 * as a single backing I/O.
+	 */
+	compress_op_execute(0);
+	CU_ASSERT(g_vol->open_pack == NULL);
+	CU_ASSERT(g_pending_bdev_io_count == 1);
+
+	backing_dev_io_execute(0);
+	CU_ASSERT(g_reduce_errno == 0);
+	g_defer_bdev_io = false;
+	g_defer_compress = false;
+
+	/* Both chunks should share one backing io unit, at different offsets. */
+	chunk0 = _reduce_vol_get_chunk_map(g_vol, g_vol->pm_logical_map[0]);
+	chunk1 = _reduce_vol_get_chunk_map(g_vol, g_vol->pm_logical_map[1]);
+	CU_ASSERT(chunk0->io_unit_index[0] == chunk1->io_unit_index[0]);
+	CU_ASSERT(chunk0->packed_offset == 0);
+	CU_ASSERT(chunk1->packed_offset > 0);
+	shared_io_unit = chunk0->io_unit_index[0];
+	CU_ASSERT(g_vol->io_unit_refs[shared_io_unit] == 2);
+
+	/* Read both logical blocks back through the packed chunks. */
+	memset(compare_buf, 0xAA, sizeof(compare_buf));
+	memset(bufa, 0xFF, sizeof(bufa));
+	g_reduce_errno = -100;
+	spdk_reduce_vol_readv(g_vol, &iova, 1, 0, 1, read_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(memcmp(bufa, compare_buf, sizeof(bufa)) == 0);
+
+	memset(compare_buf, 0xBB, sizeof(compare_buf));
+	memset(bufb, 0xFF, sizeof(bufb));
+	g_reduce_errno = -100;
+	spdk_reduce_vol_readv(g_vol, &iovb, 1, chunk1_offset, 1, read_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(memcmp(bufb, compare_buf, sizeof(bufb)) == 0);
+
+	/* Overwrite the first chunk.  The shared io unit must stay allocated, since
+	 * the second chunk still references it.
+	 */
+	memset(bufa, 0xCC, sizeof(bufa));
+	g_reduce_errno = -100;
+	spdk_reduce_vol_writev(g_vol, &iova, 1, 0, 1, write_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(g_vol->io_unit_refs[shared_io_unit] == 1);
+	CU_ASSERT(spdk_bit_array_get(g_vol->allocated_backing_io_units, shared_io_unit) == true);
+
+	memset(compare_buf, 0xBB, sizeof(compare_buf));
+	memset(bufb, 0xFF, sizeof(bufb));
+	g_reduce_errno = -100;
+	spdk_reduce_vol_readv(g_vol, &iovb, 1, chunk1_offset, 1, read_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(memcmp(bufb, compare_buf, sizeof(bufb)) == 0);
+
+	g_reduce_errno = -1;
+	spdk_reduce_vol_unload(g_vol, unload_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+
+	persistent_pm_buf_destroy();
+	backing_dev_destroy(&backing_dev);
+}
+
+static void
+zero_chunk(void)
+{
+	struct spdk_reduce_vol_params params = {};
+	struct spdk_reduce_backing_dev backing_dev = {};
+	const uint32_t logical_block_size = 512;
+	struct iovec iov, read_iov;
+	char buf[16 * 1024]; /* chunk size */
+	char read_buf[logical_block_size];
+	uint32_t num_lbas;
+
+	params.chunk_size = 16 * 1024;
+	params.backing_io_unit_size = 4096;
+	params.logical_block_size = logical_block_size;
+	num_lbas = params.chunk_size / logical_block_size;
+	spdk_uuid_generate(&params.uuid);
+
+	backing_dev_init(&backing_dev, &params, 512);
+
+	g_vol = NULL;
+	g_reduce_errno = -1;
+	spdk_reduce_vol_init(&params, &backing_dev, TEST_MD_PATH, init_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	SPDK_CU_ASSERT_FATAL(g_vol != NULL);
+
+	/* Write a full chunk of zeroes to an unallocated chunk.  It should map to
+	 *  the reserved zero entry without allocating a chunk map or any backing
+	 *  io units, and without issuing any compression or backing I/O.
+	 */
+	memset(buf, 0, params.chunk_size);
+	iov.iov_base = buf;
+	iov.iov_len = params.chunk_size;
+	g_reduce_errno = -1;
+	spdk_reduce_vol_writev(g_vol, &iov, 1, 0, num_lbas, write_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(_vol_get_chunk_map_index(g_vol, 0) == REDUCE_ZERO_MAP_ENTRY);
+	CU_ASSERT(spdk_bit_array_count_set(g_vol->allocated_chunk_maps) == 0);
+	CU_ASSERT(spdk_bit_array_count_set(g_vol->allocated_backing_io_units) == 0);
+
+	/* The zero chunk reads back as zeroes. */
+	memset(read_buf, 0xFF, sizeof(read_buf));
+	read_iov.iov_base = read_buf;
+	read_iov.iov_len = logical_block_size;
+	g_reduce_errno = -1;
+	spdk_reduce_vol_readv(g_vol, &read_iov, 1, 0, 1, read_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(spdk_mem_all_zero(read_buf, sizeof(read_buf)));
+
+	/* Overwrite part of the zero chunk with data.  This behaves like writing
+	 *  to an unallocated chunk - no read-modify-write is needed, and the chunk
+	 *  gets a regular chunk map.
+	 */
+	memset(buf, 0xAA, logical_block_size);
+	iov.iov_base = buf;
+	iov.iov_len = logical_block_size;
+	g_reduce_errno = -1;
+	spdk_reduce_vol_writev(g_vol, &iov, 1, 0, 1, write_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(_vol_get_chunk_map_index(g_vol, 0) != REDUCE_ZERO_MAP_ENTRY);
+	CU_ASSERT(_vol_get_chunk_map_index(g_vol, 0) != REDUCE_EMPTY_MAP_ENTRY);
+	CU_ASSERT(spdk_bit_array_count_set(g_vol->allocated_chunk_maps) == 1);
+
+	/* Overwrite the data with zeroes via a partial write.  The read-modify-write
+	 *  merge produces an all-zero chunk, so the chunk map and backing io units
+	 *  are released and the logical map entry becomes the zero entry again.
+	 *  Defer the backing I/O so a read can be queued behind the write, checking
+	 *  that a queued read started against a zero entry completes with zeroes.
+	 */
+	memset(buf, 0, logical_block_size);
+	g_reduce_errno = -1;
+	g_defer_bdev_io = true;
+	spdk_reduce_vol_writev(g_vol, &iov, 1, 0, 1, write_cb, NULL);
+	CU_ASSERT(g_reduce_errno == -1);
+	CU_ASSERT(g_pending_bdev_io_count == 1);
+
+	memset(read_buf, 0xFF, sizeof(read_buf));
+	g_reduce_errno = -100;
+	spdk_reduce_vol_readv(g_vol, &read_iov, 1, 0, 1, read_cb, NULL);
+	CU_ASSERT(g_reduce_errno == -100);
+
+	backing_dev_io_execute(0);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(_vol_get_chunk_map_index(g_vol, 0) == REDUCE_ZERO_MAP_ENTRY);
+	CU_ASSERT(spdk_bit_array_count_set(g_vol->allocated_chunk_maps) == 0);
+	CU_ASSERT(spdk_bit_array_count_set(g_vol->allocated_backing_io_units) == 0);
+	CU_ASSERT(spdk_mem_all_zero(read_buf, sizeof(read_buf)));
+	g_defer_bdev_io = false;
+
+	/* The zero entry survives an unload and reload. */
+	g_reduce_errno = -1;
+	spdk_reduce_vol_unload(g_vol, unload_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+
+	g_vol = NULL;
+	g_reduce_errno = -1;
+	spdk_reduce_vol_load(&backing_dev, load_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	SPDK_CU_ASSERT_FATAL(g_vol != NULL);
+	CU_ASSERT(_vol_get_chunk_map_index(g_vol, 0) == REDUCE_ZERO_MAP_ENTRY);
+	CU_ASSERT(spdk_bit_array_count_set(g_vol->allocated_chunk_maps) == 0);
+	CU_ASSERT(spdk_bit_array_count_set(g_vol->allocated_backing_io_units) == 0);
+
+	memset(read_buf, 0xFF, sizeof(read_buf));
+	g_reduce_errno = -1;
+	spdk_reduce_vol_readv(g_vol, &read_iov, 1, 0, 1, read_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+	CU_ASSERT(spdk_mem_all_zero(read_buf, sizeof(read_buf)));
+
+	g_reduce_errno = -1;
+	spdk_reduce_vol_unload(g_vol, unload_cb, NULL);
+	CU_ASSERT(g_reduce_errno == 0);
+
+	persistent_pm_buf_destroy();
+	backing_dev_destroy(&backing_dev);
+}
+
 #define BUFSIZE 4096
 
 static void
@@ -1840,6 +2223,9 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, destroy);
 	CU_ADD_TEST(suite, defer_bdev_io);
 	CU_ADD_TEST(suite, overlapped);
+	CU_ADD_TEST(suite, batched_persist);
+	CU_ADD_TEST(suite, inline_packing);
+	CU_ADD_TEST(suite, zero_chunk);
 	CU_ADD_TEST(suite, compress_algorithm);
 	CU_ADD_TEST(suite, test_prepare_compress_chunk);
 	CU_ADD_TEST(suite, test_reduce_decompress_chunk);
@@ -85,6 +85,15 @@ fn_rpc_method_handler(struct spdk_jsonrpc_request *request,
 	g_rpc_err = 0;
 }
 
+static int g_executor_calls;
+
+static void
+ut_rpc_executor(void (*fn)(void *ctx), void *ctx)
+{
+	g_executor_calls++;
+	fn(ctx);
+}
+
 static void
 test_jsonrpc_handler(void)
 {
@@ -139,6 +148,26 @@ test_jsonrpc_handler(void)
 	jsonrpc_handler(request, &method, &params);
 	CU_ASSERT(g_rpc_err == SPDK_JSONRPC_ERROR_INVALID_STATE);
 
+	/* Concurrent method runs through the installed executor */
+	is_alias_of.state_mask = SPDK_RPC_RUNTIME;
+	is_alias_of.flags = SPDK_RPC_METHOD_FLAG_CONCURRENT;
+	spdk_rpc_set_executor(ut_rpc_executor);
+	g_rpc_err = -1;
+	g_executor_calls = 0;
+	jsonrpc_handler(request, &method, &params);
+	CU_ASSERT(g_rpc_err == 0);
+	CU_ASSERT(g_executor_calls == 1);
+
+	/* Without an executor the concurrent method runs inline */
+	spdk_rpc_set_executor(NULL);
+	g_rpc_err = -1;
+	jsonrpc_handler(request, &method, &params);
+	CU_ASSERT(g_rpc_err == 0);
+	CU_ASSERT(g_executor_calls == 1);
+
+	is_alias_of.flags = 0;
+	g_rpc_state = SPDK_RPC_STARTUP;
+
 	SLIST_REMOVE_HEAD(&g_rpc_methods, slist);
 }
 
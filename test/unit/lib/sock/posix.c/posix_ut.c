@@ -136,6 +136,70 @@ flush(void)
 	free(req2);
 }
 
+#ifdef SPDK_ZEROCOPY
+static void
+dynamic_zerocopy_threshold(void)
+{
+	struct spdk_posix_sock psock = {};
+	uint32_t i;
+
+	psock.dynamic_zcopy = true;
+	psock.zcopy_threshold_floor = ZCOPY_DYNAMIC_THRESHOLD_MIN;
+	psock.base.impl_opts.zerocopy_threshold = ZCOPY_DYNAMIC_THRESHOLD_MIN;
+
+	/* No copied sends observed yet - threshold must not move */
+	psock.zcopy_lat_ewma = 1000;
+	psock.zcopy_bytes_ewma = 8192;
+	posix_sock_adjust_zcopy_threshold(&psock);
+	CU_ASSERT(psock.base.impl_opts.zerocopy_threshold == ZCOPY_DYNAMIC_THRESHOLD_MIN);
+
+	/* Copies are cheap relative to completion latency - threshold goes up and
+	 * saturates at the maximum */
+	psock.copy_ticks_ewma = 1;
+	psock.copy_bytes_ewma = 8192;
+	psock.zcopy_lat_ewma = 1000000;
+	for (i = 0; i < 64; i++) {
+		posix_sock_adjust_zcopy_threshold(&psock);
+	}
+	CU_ASSERT(psock.base.impl_opts.zerocopy_threshold == ZCOPY_DYNAMIC_THRESHOLD_MAX);
+
+	/* Copies are expensive and notifications come back quickly - threshold comes
+	 * back down, but never below the floor */
+	psock.copy_ticks_ewma = 1000000;
+	psock.zcopy_lat_ewma = 1;
+	for (i = 0; i < 64; i++) {
+		posix_sock_adjust_zcopy_threshold(&psock);
+	}
+	CU_ASSERT(psock.base.impl_opts.zerocopy_threshold == psock.zcopy_threshold_floor);
+
+	/* Completion notifications are matched against in-flight sends by sendmsg index
+	 * and feed the latency/size averages */
+	memset(&psock, 0, sizeof(psock));
+	psock.dynamic_zcopy = true;
+	psock.zcopy_inflight[5].idx = 5;
+	psock.zcopy_inflight[5].bytes = 4096;
+	psock.zcopy_inflight[5].tsc = 100;
+	psock.zcopy_inflight[6].idx = 6;
+	psock.zcopy_inflight[6].bytes = 8192;
+	psock.zcopy_inflight[6].tsc = 200;
+	MOCK_SET(spdk_get_ticks, 1100);
+
+	posix_sock_sample_zcopy_latency(&psock, 5, 6);
+	CU_ASSERT(psock.zcopy_inflight[5].bytes == 0);
+	CU_ASSERT(psock.zcopy_inflight[6].bytes == 0);
+	CU_ASSERT(psock.zcopy_completions == 2);
+	/* First sample (1000 ticks, 4096 bytes) seeds the EWMAs, second one nudges them */
+	CU_ASSERT(psock.zcopy_lat_ewma < 1000 && psock.zcopy_lat_ewma > 900);
+	CU_ASSERT(psock.zcopy_bytes_ewma > 4096 && psock.zcopy_bytes_ewma < 8192);
+
+	/* A notification for an index we never recorded is ignored */
+	posix_sock_sample_zcopy_latency(&psock, 7, 7);
+	CU_ASSERT(psock.zcopy_completions == 2);
+
+	MOCK_CLEAR(spdk_get_ticks);
+}
+#endif
+
 int
 main(int argc, char **argv)
 {
@@ -147,6 +211,9 @@ main(int argc, char **argv)
 	suite = CU_add_suite("posix", NULL, NULL);
 
 	CU_ADD_TEST(suite, flush);
+#ifdef SPDK_ZEROCOPY
+	CU_ADD_TEST(suite, dynamic_zerocopy_threshold);
+#endif
 
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
@@ -846,6 +846,190 @@ _posix_sock_close(void)
 	_sock_close("127.0.0.1", UT_PORT, "posix");
 }
 
+static void
+_cork_req_cb(void *cb_arg, int err)
+{
+	*(bool *)cb_arg = true;
+	CU_ASSERT(err == 0);
+}
+
+static void
+_sock_group_cork(const char *ip, int port, char *impl_name)
+{
+	struct spdk_sock_group *group;
+	struct spdk_sock *listen_sock;
+	struct spdk_sock *server_sock;
+	struct spdk_sock *client_sock;
+	uint8_t data_buf[64] = {};
+	uint8_t recv_buf[256];
+	struct spdk_sock_request *req1, *req2;
+	bool cb_arg1 = false, cb_arg2 = false;
+	ssize_t bytes;
+	int rc;
+
+	listen_sock = spdk_sock_listen(ip, port, impl_name);
+	SPDK_CU_ASSERT_FATAL(listen_sock != NULL);
+
+	client_sock = spdk_sock_connect(ip, port, impl_name);
+	SPDK_CU_ASSERT_FATAL(client_sock != NULL);
+
+	usleep(1000);
+
+	server_sock = spdk_sock_accept(listen_sock);
+	SPDK_CU_ASSERT_FATAL(server_sock != NULL);
+
+	group = spdk_sock_group_create(NULL);
+	SPDK_CU_ASSERT_FATAL(group != NULL);
+
+	rc = spdk_sock_group_add_sock(group, server_sock, read_data, server_sock);
+	CU_ASSERT(rc == 0);
+
+	/* Use a latency cap large enough that the test never hits it */
+	spdk_sock_group_cork(group, 0, 10 * 1000 * 1000);
+
+	req1 = calloc(1, sizeof(struct spdk_sock_request) + sizeof(struct iovec));
+	SPDK_CU_ASSERT_FATAL(req1 != NULL);
+	SPDK_SOCK_REQUEST_IOV(req1, 0)->iov_base = data_buf;
+	SPDK_SOCK_REQUEST_IOV(req1, 0)->iov_len = 64;
+	req1->iovcnt = 1;
+	req1->cb_fn = _cork_req_cb;
+	req1->cb_arg = &cb_arg1;
+	spdk_sock_writev_async(server_sock, req1);
+
+	req2 = calloc(1, sizeof(struct spdk_sock_request) + sizeof(struct iovec));
+	SPDK_CU_ASSERT_FATAL(req2 != NULL);
+	SPDK_SOCK_REQUEST_IOV(req2, 0)->iov_base = data_buf;
+	SPDK_SOCK_REQUEST_IOV(req2, 0)->iov_len = 64;
+	req2->iovcnt = 1;
+	req2->cb_fn = _cork_req_cb;
+	req2->cb_arg = &cb_arg2;
+	spdk_sock_writev_async(server_sock, req2);
+
+	CU_ASSERT(server_sock->queued_bytes == 128);
+
+	/* While corked, the writes are held - even across a group poll */
+	spdk_sock_group_poll(group);
+	CU_ASSERT(cb_arg1 == false);
+	CU_ASSERT(cb_arg2 == false);
+	CU_ASSERT(!TAILQ_EMPTY(&server_sock->queued_reqs));
+
+	/* Uncorking sends both requests in a single flush */
+	spdk_sock_group_uncork(group);
+	CU_ASSERT(cb_arg1 == true);
+	CU_ASSERT(cb_arg2 == true);
+	CU_ASSERT(TAILQ_EMPTY(&server_sock->queued_reqs));
+	CU_ASSERT(server_sock->queued_bytes == 0);
+
+	usleep(1000);
+	bytes = spdk_sock_recv(client_sock, recv_buf, sizeof(recv_buf));
+	CU_ASSERT(bytes == 128);
+
+	/* With an expired latency cap, a group poll uncorks automatically */
+	spdk_sock_group_cork(group, 0, 1);
+	cb_arg1 = false;
+	spdk_sock_writev_async(server_sock, req1);
+	usleep(1000);
+	spdk_sock_group_poll(group);
+	CU_ASSERT(cb_arg1 == true);
+	CU_ASSERT(group->corked == false);
+
+	rc = spdk_sock_group_remove_sock(group, server_sock);
+	CU_ASSERT(rc == 0);
+
+	rc = spdk_sock_group_close(&group);
+	CU_ASSERT(group == NULL);
+	CU_ASSERT(rc == 0);
+
+	rc = spdk_sock_close(&client_sock);
+	CU_ASSERT(client_sock == NULL);
+	CU_ASSERT(rc == 0);
+
+	rc = spdk_sock_close(&server_sock);
+	CU_ASSERT(server_sock == NULL);
+	CU_ASSERT(rc == 0);
+
+	rc = spdk_sock_close(&listen_sock);
+	CU_ASSERT(listen_sock == NULL);
+	CU_ASSERT(rc == 0);
+
+	free(req1);
+	free(req2);
+}
+
+static void
+posix_sock_group_cork(void)
+{
+	_sock_group_cork("127.0.0.1", UT_PORT, "posix");
+}
+
+static void
+_rebalance_cb(void *ctx, struct spdk_sock *sock, struct spdk_sock_group *optimal_group)
+{
+	(*(int *)ctx)++;
+}
+
+static void
+posix_sock_group_rebalance(void)
+{
+	struct spdk_sock_group *group;
+	struct spdk_sock *listen_sock;
+	struct spdk_sock *server_sock;
+	struct spdk_sock *client_sock;
+	int rebalance_count = 0;
+	uint64_t next_tsc;
+	int rc;
+
+	listen_sock = spdk_sock_listen("127.0.0.1", UT_PORT, "posix");
+	SPDK_CU_ASSERT_FATAL(listen_sock != NULL);
+
+	client_sock = spdk_sock_connect("127.0.0.1", UT_PORT, "posix");
+	SPDK_CU_ASSERT_FATAL(client_sock != NULL);
+
+	usleep(1000);
+
+	server_sock = spdk_sock_accept(listen_sock);
+	SPDK_CU_ASSERT_FATAL(server_sock != NULL);
+
+	group = spdk_sock_group_create(NULL);
+	SPDK_CU_ASSERT_FATAL(group != NULL);
+
+	rc = spdk_sock_group_add_sock(group, server_sock, read_data, server_sock);
+	CU_ASSERT(rc == 0);
+
+	spdk_sock_group_set_rebalance_cb(group, _rebalance_cb, &rebalance_count, 1);
+	next_tsc = group->rebalance_next_tsc;
+
+	/* With placement disabled the socket's placement never drifts, so an
+	 * elapsed period must re-arm the timer without invoking the callback. */
+	usleep(1000);
+	spdk_sock_group_poll(group);
+	CU_ASSERT(rebalance_count == 0);
+	CU_ASSERT(group->rebalance_next_tsc > next_tsc);
+
+	/* A NULL callback disables re-evaluation */
+	spdk_sock_group_set_rebalance_cb(group, NULL, NULL, 0);
+	CU_ASSERT(group->rebalance_cb == NULL);
+
+	rc = spdk_sock_group_remove_sock(group, server_sock);
+	CU_ASSERT(rc == 0);
+
+	rc = spdk_sock_group_close(&group);
+	CU_ASSERT(group == NULL);
+	CU_ASSERT(rc == 0);
+
+	rc = spdk_sock_close(&client_sock);
+	CU_ASSERT(client_sock == NULL);
+	CU_ASSERT(rc == 0);
+
+	rc = spdk_sock_close(&server_sock);
+	CU_ASSERT(server_sock == NULL);
+	CU_ASSERT(rc == 0);
+
+	rc = spdk_sock_close(&listen_sock);
+	CU_ASSERT(listen_sock == NULL);
+	CU_ASSERT(rc == 0);
+}
+
 static void
 sock_get_default_opts(void)
 {
@@ -1252,6 +1436,8 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, ut_sock_group);
 	CU_ADD_TEST(suite, posix_sock_group_fairness);
 	CU_ADD_TEST(suite, _posix_sock_close);
+	CU_ADD_TEST(suite, posix_sock_group_cork);
+	CU_ADD_TEST(suite, posix_sock_group_rebalance);
 	CU_ADD_TEST(suite, sock_get_default_opts);
 	CU_ADD_TEST(suite, ut_sock_impl_get_set_opts);
 	CU_ADD_TEST(suite, posix_sock_impl_get_set_opts);
@@ -615,6 +615,350 @@ iobuf_cache(void)
 	free_cores();
 }
 
+static void
+iobuf_cache_rebalance(void)
+{
+	struct spdk_iobuf_opts opts = {
+		.small_pool_count = 8,
+		.large_pool_count = 8,
+		.small_bufsize = SMALL_BUFSIZE,
+		.large_bufsize = LARGE_BUFSIZE,
+		.cache_rebalance_period_us = 1000,
+	};
+	struct spdk_iobuf_channel iobuf_ch[2];
+	void *bufs[4];
+	int rc, finish = 0;
+	uint32_t i;
+
+	allocate_cores(1);
+	allocate_threads(1);
+
+	set_thread(0);
+
+	/* We cannot use spdk_iobuf_set_opts(), as it won't allow us to use such small pools */
+	g_iobuf.opts = opts;
+	rc = spdk_iobuf_initialize();
+	CU_ASSERT_EQUAL(rc, 0);
+
+	rc = spdk_iobuf_register_module("ut_module0");
+	CU_ASSERT_EQUAL(rc, 0);
+
+	rc = spdk_iobuf_register_module("ut_module1");
+	CU_ASSERT_EQUAL(rc, 0);
+
+	rc = spdk_iobuf_channel_init(&iobuf_ch[0], "ut_module0", 2, 0);
+	CU_ASSERT_EQUAL(rc, 0);
+	rc = spdk_iobuf_channel_init(&iobuf_ch[1], "ut_module1", 2, 0);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	/* Starve module0's small cache by requesting more buffers than it holds, while
+	 * module1 stays idle */
+	for (i = 0; i < SPDK_COUNTOF(bufs); ++i) {
+		bufs[i] = spdk_iobuf_get(&iobuf_ch[0], SMALL_BUFSIZE, NULL, NULL);
+		CU_ASSERT_PTR_NOT_NULL(bufs[i]);
+	}
+	for (i = 0; i < SPDK_COUNTOF(bufs); ++i) {
+		spdk_iobuf_put(&iobuf_ch[0], bufs[i], SMALL_BUFSIZE);
+	}
+
+	CU_ASSERT(iobuf_ch[0].small.stats.main > 0);
+
+	/* After one rebalance tick, module1's small cache credits should have migrated to
+	 * module0 and its cached buffers should be back in the pool */
+	spdk_delay_us(1000);
+	poll_threads();
+
+	CU_ASSERT_EQUAL(iobuf_ch[0].small.cache_size, 4);
+	CU_ASSERT_EQUAL(iobuf_ch[1].small.cache_size, 0);
+	CU_ASSERT_EQUAL(iobuf_ch[1].small.cache_count, 0);
+
+	/* With no activity anywhere, another tick moves nothing */
+	spdk_delay_us(1000);
+	poll_threads();
+
+	CU_ASSERT_EQUAL(iobuf_ch[0].small.cache_size, 4);
+	CU_ASSERT_EQUAL(iobuf_ch[1].small.cache_size, 0);
+
+	spdk_iobuf_channel_fini(&iobuf_ch[0]);
+	spdk_iobuf_channel_fini(&iobuf_ch[1]);
+	poll_threads();
+
+	spdk_iobuf_finish(ut_iobuf_finish_cb, &finish);
+	poll_threads();
+
+	CU_ASSERT_EQUAL(finish, 1);
+
+	free_threads();
+	free_cores();
+}
+
+static void
+iobuf_pool_grow(void)
+{
+	struct spdk_iobuf_opts opts = {
+		.small_pool_count = 2,
+		.large_pool_count = 2,
+		.small_bufsize = SMALL_BUFSIZE,
+		.large_bufsize = LARGE_BUFSIZE,
+		.small_pool_max_count = 4,
+		.large_pool_max_count = 4,
+	};
+	struct spdk_iobuf_channel iobuf_ch;
+	struct ut_iobuf_entry *entry;
+	struct ut_iobuf_entry entries[] = {
+		{ .thread_id = 0, .module = "ut_module0", },
+		{ .thread_id = 0, .module = "ut_module0", },
+		{ .thread_id = 0, .module = "ut_module0", },
+		{ .thread_id = 0, .module = "ut_module0", },
+	};
+	int rc, finish = 0;
+	uint32_t i;
+
+	allocate_cores(1);
+	allocate_threads(1);
+
+	set_thread(0);
+
+	/* Growing is only possible once the pools are initialized */
+	rc = spdk_iobuf_pool_grow(1, 1, SPDK_ENV_SOCKET_ID_ANY);
+	CU_ASSERT_EQUAL(rc, -ENODEV);
+
+	/* We cannot use spdk_iobuf_set_opts(), as it won't allow us to use such small pools */
+	g_iobuf.opts = opts;
+	rc = spdk_iobuf_initialize();
+	CU_ASSERT_EQUAL(rc, 0);
+
+	rc = spdk_iobuf_register_module("ut_module0");
+	CU_ASSERT_EQUAL(rc, 0);
+
+	rc = spdk_iobuf_channel_init(&iobuf_ch, "ut_module0", 0, 0);
+	CU_ASSERT_EQUAL(rc, 0);
+	for (i = 0; i < SPDK_COUNTOF(entries); ++i) {
+		entries[i].ioch = &iobuf_ch;
+	}
+
+	/* Drain the large pool and queue one more request */
+	entry = &entries[0];
+	entry->buf = spdk_iobuf_get(entry->ioch, LARGE_BUFSIZE, &entry->iobuf, ut_iobuf_get_buf_cb);
+	CU_ASSERT_PTR_NOT_NULL(entry->buf);
+	entry = &entries[1];
+	entry->buf = spdk_iobuf_get(entry->ioch, LARGE_BUFSIZE, &entry->iobuf, ut_iobuf_get_buf_cb);
+	CU_ASSERT_PTR_NOT_NULL(entry->buf);
+	entry = &entries[2];
+	entry->buf = spdk_iobuf_get(entry->ioch, LARGE_BUFSIZE, &entry->iobuf, ut_iobuf_get_buf_cb);
+	CU_ASSERT_PTR_NULL(entry->buf);
+
+	/* Growing beyond the configured maximum counts must fail */
+	rc = spdk_iobuf_pool_grow(8, 8, SPDK_ENV_SOCKET_ID_ANY);
+	CU_ASSERT_EQUAL(rc, -ENOSPC);
+
+	/* As must growing on a NUMA node without pools */
+	rc = spdk_iobuf_pool_grow(1, 1, 12);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+
+	/* Grow both pools to their maximum size */
+	rc = spdk_iobuf_pool_grow(2, 2, SPDK_ENV_SOCKET_ID_ANY);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	/* The new buffers are immediately available ... */
+	entry = &entries[3];
+	entry->buf = spdk_iobuf_get(entry->ioch, LARGE_BUFSIZE, &entry->iobuf, ut_iobuf_get_buf_cb);
+	CU_ASSERT_PTR_NOT_NULL(entry->buf);
+
+	/* ... but queued requests are still only retried on a put */
+	CU_ASSERT_PTR_NULL(entries[2].buf);
+	entry = &entries[0];
+	spdk_iobuf_put(entry->ioch, entry->buf, LARGE_BUFSIZE);
+	CU_ASSERT_PTR_NOT_NULL(entries[2].buf);
+
+	/* There is no headroom left in the pools now */
+	rc = spdk_iobuf_pool_grow(1, 0, SPDK_ENV_SOCKET_ID_ANY);
+	CU_ASSERT_EQUAL(rc, -ENOSPC);
+	rc = spdk_iobuf_pool_grow(0, 1, SPDK_ENV_SOCKET_ID_ANY);
+	CU_ASSERT_EQUAL(rc, -ENOSPC);
+
+	/* Clean everything up */
+	for (i = 1; i < SPDK_COUNTOF(entries); ++i) {
+		entry = &entries[i];
+		spdk_iobuf_put(entry->ioch, entry->buf, LARGE_BUFSIZE);
+	}
+
+	spdk_iobuf_channel_fini(&iobuf_ch);
+	poll_threads();
+
+	spdk_iobuf_finish(ut_iobuf_finish_cb, &finish);
+	poll_threads();
+
+	CU_ASSERT_EQUAL(finish, 1);
+
+	free_threads();
+	free_cores();
+}
+
+static void
+iobuf_cache_reclaim(void)
+{
+	struct spdk_iobuf_opts opts = {
+		.small_pool_count = 8,
+		.large_pool_count = 8,
+		.small_bufsize = SMALL_BUFSIZE,
+		.large_bufsize = LARGE_BUFSIZE,
+		.cache_idle_reclaim_us = 1000,
+	};
+	struct spdk_iobuf_channel iobuf_ch;
+	void *buf;
+	int rc, finish = 0;
+
+	allocate_cores(1);
+	allocate_threads(1);
+
+	set_thread(0);
+
+	/* We cannot use spdk_iobuf_set_opts(), as it won't allow us to use such small pools */
+	g_iobuf.opts = opts;
+	rc = spdk_iobuf_initialize();
+	CU_ASSERT_EQUAL(rc, 0);
+
+	rc = spdk_iobuf_register_module("ut_module0");
+	CU_ASSERT_EQUAL(rc, 0);
+
+	rc = spdk_iobuf_channel_init(&iobuf_ch, "ut_module0", 2, 0);
+	CU_ASSERT_EQUAL(rc, 0);
+	CU_ASSERT_EQUAL(iobuf_ch.small.cache_count, 2);
+
+	/* The first tick only records the channel as seen; nothing is reclaimed yet */
+	spdk_delay_us(1000);
+	poll_threads();
+
+	CU_ASSERT_EQUAL(iobuf_ch.small.cache_count, 2);
+
+	/* After a full idle period the cached buffers go back to the pool, but the
+	 * cache credits are retained */
+	spdk_delay_us(1000);
+	poll_threads();
+
+	CU_ASSERT_EQUAL(iobuf_ch.small.cache_count, 0);
+	CU_ASSERT_EQUAL(iobuf_ch.small.cache_size, 2);
+
+	/* Once the channel becomes active again, the cache starts refilling from the
+	 * pool and an active channel is never reclaimed */
+	buf = spdk_iobuf_get(&iobuf_ch, SMALL_BUFSIZE, NULL, NULL);
+	CU_ASSERT_PTR_NOT_NULL(buf);
+	spdk_iobuf_put(&iobuf_ch, buf, SMALL_BUFSIZE);
+	CU_ASSERT_EQUAL(iobuf_ch.small.cache_count, 1);
+
+	spdk_delay_us(1000);
+	poll_threads();
+
+	CU_ASSERT_EQUAL(iobuf_ch.small.cache_count, 1);
+
+	/* Going idle again empties the cache once more */
+	spdk_delay_us(1000);
+	poll_threads();
+
+	CU_ASSERT_EQUAL(iobuf_ch.small.cache_count, 0);
+	CU_ASSERT_EQUAL(iobuf_ch.small.cache_size, 2);
+
+	spdk_iobuf_channel_fini(&iobuf_ch);
+	poll_threads();
+
+	spdk_iobuf_finish(ut_iobuf_finish_cb, &finish);
+	poll_threads();
+
+	CU_ASSERT_EQUAL(finish, 1);
+
+	free_threads();
+	free_cores();
+}
+
+static void
+iobuf_pool_shrink(void)
+{
+	struct spdk_iobuf_opts opts = {
+		.small_pool_count = 2,
+		.large_pool_count = 2,
+		.small_bufsize = SMALL_BUFSIZE,
+		.large_bufsize = LARGE_BUFSIZE,
+		.small_pool_max_count = 4,
+		.large_pool_max_count = 4,
+	};
+	struct spdk_iobuf_channel iobuf_ch;
+	void *bufs[3];
+	int rc, finish = 0;
+	uint32_t i;
+
+	allocate_cores(1);
+	allocate_threads(1);
+
+	set_thread(0);
+
+	/* Shrinking is only possible once the pools are initialized */
+	rc = spdk_iobuf_pool_shrink(1, 1, SPDK_ENV_SOCKET_ID_ANY);
+	CU_ASSERT_EQUAL(rc, -ENODEV);
+
+	/* We cannot use spdk_iobuf_set_opts(), as it won't allow us to use such small pools */
+	g_iobuf.opts = opts;
+	rc = spdk_iobuf_initialize();
+	CU_ASSERT_EQUAL(rc, 0);
+
+	rc = spdk_iobuf_register_module("ut_module0");
+	CU_ASSERT_EQUAL(rc, 0);
+
+	rc = spdk_iobuf_channel_init(&iobuf_ch, "ut_module0", 0, 0);
+	CU_ASSERT_EQUAL(rc, 0);
+
+	/* The initial pools can never be freed */
+	rc = spdk_iobuf_pool_shrink(2, 2, SPDK_ENV_SOCKET_ID_ANY);
+	CU_ASSERT_EQUAL(rc, -EBUSY);
+
+	/* Neither can pools on a NUMA node that doesn't exist */
+	rc = spdk_iobuf_pool_shrink(1, 1, 12);
+	CU_ASSERT_EQUAL(rc, -EINVAL);
+
+	/* Grow both pools to their maximum size */
+	rc = spdk_iobuf_pool_grow(2, 2, SPDK_ENV_SOCKET_ID_ANY);
+	CU_ASSERT_EQUAL(rc, 0);
+	CU_ASSERT_EQUAL(g_iobuf.opts.small_pool_count, 4);
+	CU_ASSERT_EQUAL(g_iobuf.opts.large_pool_count, 4);
+
+	/* While some of the grown large buffers are in use, the chunk they belong to
+	 * cannot be freed */
+	for (i = 0; i < SPDK_COUNTOF(bufs); ++i) {
+		bufs[i] = spdk_iobuf_get(&iobuf_ch, LARGE_BUFSIZE, NULL, NULL);
+		CU_ASSERT_PTR_NOT_NULL(bufs[i]);
+	}
+
+	rc = spdk_iobuf_pool_shrink(0, 2, SPDK_ENV_SOCKET_ID_ANY);
+	CU_ASSERT_EQUAL(rc, -EBUSY);
+	CU_ASSERT_EQUAL(g_iobuf.opts.large_pool_count, 4);
+
+	/* Once they're returned, the grown chunk can be freed again */
+	for (i = 0; i < SPDK_COUNTOF(bufs); ++i) {
+		spdk_iobuf_put(&iobuf_ch, bufs[i], LARGE_BUFSIZE);
+	}
+
+	rc = spdk_iobuf_pool_shrink(2, 2, SPDK_ENV_SOCKET_ID_ANY);
+	CU_ASSERT_EQUAL(rc, 0);
+	CU_ASSERT_EQUAL(g_iobuf.opts.small_pool_count, 2);
+	CU_ASSERT_EQUAL(g_iobuf.opts.large_pool_count, 2);
+
+	/* The remaining buffers all come from the initial allocation, so there's
+	 * nothing left to free */
+	rc = spdk_iobuf_pool_shrink(2, 2, SPDK_ENV_SOCKET_ID_ANY);
+	CU_ASSERT_EQUAL(rc, -EBUSY);
+
+	spdk_iobuf_channel_fini(&iobuf_ch);
+	poll_threads();
+
+	spdk_iobuf_finish(ut_iobuf_finish_cb, &finish);
+	poll_threads();
+
+	CU_ASSERT_EQUAL(finish, 1);
+
+	free_threads();
+	free_cores();
+}
+
 int
 main(int argc, char **argv)
 {
@@ -626,6 +970,10 @@ main(int argc, char **argv)
 	suite = CU_add_suite("io_channel", NULL, NULL);
 	CU_ADD_TEST(suite, iobuf);
 	CU_ADD_TEST(suite, iobuf_cache);
+	CU_ADD_TEST(suite, iobuf_cache_rebalance);
+	CU_ADD_TEST(suite, iobuf_pool_grow);
+	CU_ADD_TEST(suite, iobuf_cache_reclaim);
+	CU_ADD_TEST(suite, iobuf_pool_shrink);
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
 	CU_cleanup_registry();
@@ -146,6 +146,63 @@ thread_send_msg(void)
 	free_threads();
 }
 
+#define BATCH_SEND_COUNT 5
+
+static struct spdk_thread *g_batch_target_thread;
+static int g_batch_recv_count;
+
+static void
+batch_recv_msg_cb(void *ctx)
+{
+	g_batch_recv_count++;
+}
+
+static void
+batch_send_msgs_cb(void *ctx)
+{
+	int i;
+
+	for (i = 0; i < BATCH_SEND_COUNT; i++) {
+		spdk_thread_send_msg(g_batch_target_thread, batch_recv_msg_cb, NULL);
+	}
+}
+
+static void
+thread_send_msg_batching(void)
+{
+	struct spdk_thread *thread0;
+	struct spdk_thread_stats stats;
+
+	allocate_threads(2);
+	set_thread(0);
+	thread0 = spdk_get_thread();
+
+	set_thread(1);
+	g_batch_target_thread = thread0;
+	g_batch_recv_count = 0;
+
+	/* Run the sender inside thread 1's poll loop, so that its messages are
+	 * batched into a single ring enqueue when the iteration ends. */
+	spdk_thread_send_msg(spdk_get_thread(), batch_send_msgs_cb, NULL);
+	poll_thread(1);
+
+	/* The batch was flushed when thread 1's poll iteration ended, but
+	 * thread 0 has not run yet. */
+	CU_ASSERT(g_batch_recv_count == 0);
+
+	poll_thread(0);
+	CU_ASSERT(g_batch_recv_count == BATCH_SEND_COUNT);
+
+	/* The self-send above was issued outside a poll iteration, so it counts
+	 * as a single send; the five sends from the callback were batched. */
+	set_thread(1);
+	CU_ASSERT(spdk_thread_get_stats(&stats) == 0);
+	CU_ASSERT(stats.batched_msg_sends == BATCH_SEND_COUNT);
+	CU_ASSERT(stats.single_msg_sends == 1);
+
+	free_threads();
+}
+
 static int
 poller_run_done(void *ctx)
 {
@@ -446,6 +503,179 @@ poller_pause(void)
 	free_threads();
 }
 
+static int g_backoff_rc;
+static int g_backoff_run_count;
+
+static int
+poller_run_backoff_cb(void *ctx)
+{
+	g_backoff_run_count++;
+	return g_backoff_rc;
+}
+
+static void
+poller_idle_backoff(void)
+{
+	struct spdk_poller *poller;
+
+	allocate_threads(1);
+	set_thread(0);
+	MOCK_SET(spdk_get_ticks, 0);
+
+	poller = spdk_poller_register(poller_run_backoff_cb, NULL, 0);
+	CU_ASSERT(poller != NULL);
+	spdk_poller_set_idle_backoff(poller, 3, 1000);
+
+	/* Three consecutive idle returns demote the poller. */
+	g_backoff_rc = 0;
+	g_backoff_run_count = 0;
+	poll_thread_times(0, 3);
+	CU_ASSERT(g_backoff_run_count == 3);
+
+	/* The poller now sits on the timer tree, so further iterations before
+	 * the backoff period elapses do not run it.
+	 */
+	poll_thread_times(0, 5);
+	CU_ASSERT(g_backoff_run_count == 3);
+
+	/* Once the backoff period elapses it runs again, and a busy return
+	 * promotes it back to running on every iteration.
+	 */
+	g_backoff_rc = 1;
+	spdk_delay_us(1000);
+	poll_thread_times(0, 1);
+	CU_ASSERT(g_backoff_run_count == 4);
+
+	poll_thread_times(0, 2);
+	CU_ASSERT(g_backoff_run_count == 6);
+
+	/* Let it back off again and verify spdk_poller_resume() promotes it.
+	 * The promotion is processed at the end of the first iteration, so the
+	 * poller runs on the second one.
+	 */
+	g_backoff_rc = 0;
+	poll_thread_times(0, 3);
+	CU_ASSERT(g_backoff_run_count == 9);
+	poll_thread_times(0, 2);
+	CU_ASSERT(g_backoff_run_count == 9);
+
+	spdk_poller_resume(poller);
+	poll_thread_times(0, 2);
+	CU_ASSERT(g_backoff_run_count == 10);
+
+	spdk_poller_unregister(&poller);
+	CU_ASSERT(poller == NULL);
+	poll_threads();
+
+	free_threads();
+}
+
+static int g_budget_rc;
+static int g_budget_run_count;
+
+static int
+poller_run_budget_cb(void *ctx)
+{
+	g_budget_run_count++;
+	return g_budget_rc;
+}
+
+static void
+poller_budget(void)
+{
+	struct spdk_thread_stats stats;
+	struct spdk_poller *poller;
+
+	allocate_threads(1);
+	set_thread(0);
+
+	poller = spdk_poller_register(poller_run_budget_cb, NULL, 0);
+	CU_ASSERT(poller != NULL);
+	spdk_poller_set_budget(poller, 4);
+
+	/* Two busy runs of 2 work units exhaust the budget, so the third
+	 * iteration skips the poller and the fourth runs it again.
+	 */
+	g_budget_rc = 2;
+	g_budget_run_count = 0;
+	poll_thread_times(0, 2);
+	CU_ASSERT(g_budget_run_count == 2);
+	poll_thread_times(0, 1);
+	CU_ASSERT(g_budget_run_count == 2);
+	poll_thread_times(0, 1);
+	CU_ASSERT(g_budget_run_count == 3);
+
+	/* Idle returns do not consume budget. */
+	g_budget_rc = 0;
+	poll_thread_times(0, 5);
+	CU_ASSERT(g_budget_run_count == 8);
+
+	CU_ASSERT(spdk_thread_get_stats(&stats) == 0);
+	CU_ASSERT(stats.poller_deferrals == 1);
+
+	/* Disabling the policy clears a pending deferral. */
+	g_budget_rc = 4;
+	poll_thread_times(0, 1);
+	CU_ASSERT(g_budget_run_count == 9);
+	spdk_poller_set_budget(poller, 0);
+	poll_thread_times(0, 1);
+	CU_ASSERT(g_budget_run_count == 10);
+
+	spdk_poller_unregister(&poller);
+	CU_ASSERT(poller == NULL);
+	poll_threads();
+
+	free_threads();
+}
+
+static int
+poller_run_overrun_cb(void *ctx)
+{
+	int *run_count = ctx;
+
+	(*run_count)++;
+	return 0;
+}
+
+static void
+timed_poller_overrun(void)
+{
+	struct spdk_poller_stats pstats;
+	struct spdk_thread_stats stats;
+	struct spdk_poller *poller;
+	int run_count = 0;
+
+	allocate_threads(1);
+	set_thread(0);
+	MOCK_SET(spdk_get_ticks, 0);
+
+	poller = spdk_poller_register(poller_run_overrun_cb, &run_count, 1000);
+	CU_ASSERT(poller != NULL);
+
+	/* Serviced exactly at its deadline: no overrun. */
+	spdk_delay_us(1000);
+	poll_thread_times(0, 1);
+	CU_ASSERT(run_count == 1);
+	CU_ASSERT(spdk_thread_get_stats(&stats) == 0);
+	CU_ASSERT(stats.poller_overruns == 0);
+
+	/* Not serviced until more than a full period past the deadline. */
+	spdk_delay_us(2500);
+	poll_thread_times(0, 1);
+	CU_ASSERT(run_count == 2);
+	CU_ASSERT(spdk_thread_get_stats(&stats) == 0);
+	CU_ASSERT(stats.poller_overruns == 1);
+
+	spdk_poller_get_stats(poller, &pstats);
+	CU_ASSERT(pstats.overrun_count == 1);
+
+	spdk_poller_unregister(&poller);
+	CU_ASSERT(poller == NULL);
+	poll_threads();
+
+	free_threads();
+}
+
 static void
 for_each_cb(void *ctx)
 {
@@ -584,6 +814,80 @@ for_each_channel_remove(void)
 	free_threads();
 }
 
+static int g_parallel_cpl_status;
+
+static void
+parallel_channel_msg_fail(struct spdk_io_channel_iter *i)
+{
+	int *msg_count = spdk_io_channel_iter_get_ctx(i);
+
+	(*msg_count)++;
+	spdk_for_each_channel_continue(i, -EIO);
+}
+
+static void
+parallel_channel_cpl(struct spdk_io_channel_iter *i, int status)
+{
+	int *msg_count = spdk_io_channel_iter_get_ctx(i);
+
+	(*msg_count)++;
+	g_parallel_cpl_status = status;
+}
+
+static void
+for_each_channel_parallel(void)
+{
+	struct spdk_io_channel *ch0, *ch1, *ch2;
+	int ch_count = 0;
+	int msg_count = 0;
+
+	allocate_threads(3);
+	set_thread(0);
+	spdk_io_device_register(&ch_count, channel_create, channel_destroy, sizeof(int), NULL);
+	ch0 = spdk_get_io_channel(&ch_count);
+	set_thread(1);
+	ch1 = spdk_get_io_channel(&ch_count);
+	set_thread(2);
+	ch2 = spdk_get_io_channel(&ch_count);
+	CU_ASSERT(ch_count == 3);
+
+	/* All channels are visited and the completion runs on the original thread
+	 * once every channel has reported in.
+	 */
+	set_thread(0);
+	g_parallel_cpl_status = -1;
+	spdk_for_each_channel_parallel(&ch_count, channel_msg, &msg_count, parallel_channel_cpl);
+	CU_ASSERT(msg_count == 0);
+	poll_threads();
+	CU_ASSERT(msg_count == 4);
+	CU_ASSERT(g_parallel_cpl_status == 0);
+
+	/* A failing channel does not stop the broadcast - every channel is still
+	 * visited and the completion sees the error status.
+	 */
+	msg_count = 0;
+	g_parallel_cpl_status = 0;
+	spdk_for_each_channel_parallel(&ch_count, parallel_channel_msg_fail, &msg_count,
+				       parallel_channel_cpl);
+	poll_threads();
+	CU_ASSERT(msg_count == 4);
+	CU_ASSERT(g_parallel_cpl_status == -EIO);
+
+	set_thread(0);
+	spdk_put_io_channel(ch0);
+	set_thread(1);
+	spdk_put_io_channel(ch1);
+	set_thread(2);
+	spdk_put_io_channel(ch2);
+	poll_threads();
+	CU_ASSERT(ch_count == 0);
+
+	spdk_io_device_unregister(&ch_count, NULL);
+	poll_threads();
+
+	free_threads();
+}
+
 struct unreg_ctx {
 	bool	ch_done;
 	bool	foreach_done;
@@ -2027,10 +2331,15 @@ main(int argc, char **argv)
 
 	CU_ADD_TEST(suite, thread_alloc);
 	CU_ADD_TEST(suite, thread_send_msg);
+	CU_ADD_TEST(suite, thread_send_msg_batching);
 	CU_ADD_TEST(suite, thread_poller);
 	CU_ADD_TEST(suite, poller_pause);
+	CU_ADD_TEST(suite, poller_idle_backoff);
+	CU_ADD_TEST(suite, poller_budget);
+	CU_ADD_TEST(suite, timed_poller_overrun);
 	CU_ADD_TEST(suite, thread_for_each);
 	CU_ADD_TEST(suite, for_each_channel_remove);
+	CU_ADD_TEST(suite, for_each_channel_parallel);
 	CU_ADD_TEST(suite, for_each_channel_unreg);
 	CU_ADD_TEST(suite, thread_name);
 	CU_ADD_TEST(suite, channel);
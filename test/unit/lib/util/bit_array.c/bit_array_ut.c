@@ -132,6 +132,42 @@ test_find(void)
 	spdk_bit_array_free(&ba);
 }
 
+static void
+test_find_summary(void)
+{
+	struct spdk_bit_array *ba;
+	uint32_t i;
+
+	/* Large enough to span multiple summary words (one summary word covers
+	 * 4096 bits), so that the clear-bit scan exercises the summary skips.
+	 */
+	ba = spdk_bit_array_create(3 * 4096 + 100);
+	SPDK_CU_ASSERT_FATAL(ba != NULL);
+
+	for (i = 0; i < 3 * 4096 + 100; i++) {
+		CU_ASSERT(spdk_bit_array_set(ba, i) == 0);
+	}
+
+	CU_ASSERT(spdk_bit_array_find_first_clear(ba, 0) == UINT32_MAX);
+
+	/* Clear one bit in the middle of the second summary word */
+	spdk_bit_array_clear(ba, 2 * 4096 + 67);
+	CU_ASSERT(spdk_bit_array_find_first_clear(ba, 0) == 2 * 4096 + 67);
+	CU_ASSERT(spdk_bit_array_find_first_clear(ba, 4096) == 2 * 4096 + 67);
+	CU_ASSERT(spdk_bit_array_find_first_clear(ba, 2 * 4096 + 67) == 2 * 4096 + 67);
+	CU_ASSERT(spdk_bit_array_find_first_clear(ba, 2 * 4096 + 68) == UINT32_MAX);
+
+	/* Setting it again makes the whole array full */
+	CU_ASSERT(spdk_bit_array_set(ba, 2 * 4096 + 67) == 0);
+	CU_ASSERT(spdk_bit_array_find_first_clear(ba, 0) == UINT32_MAX);
+
+	/* A clear bit in the partial last word is still found */
+	spdk_bit_array_clear(ba, 3 * 4096 + 99);
+	CU_ASSERT(spdk_bit_array_find_first_clear(ba, 0) == 3 * 4096 + 99);
+
+	spdk_bit_array_free(&ba);
+}
+
 static void
 test_resize(void)
 {
@@ -317,6 +353,66 @@ test_mask_clear(void)
 	spdk_bit_array_free(&ba);
 }
 
+static void
+test_clear_range(void)
+{
+	struct spdk_bit_array *ba;
+	struct spdk_bit_pool *pool;
+	uint32_t i;
+
+	ba = spdk_bit_array_create(256);
+
+	for (i = 0; i < 256; i++) {
+		spdk_bit_array_set(ba, i);
+	}
+
+	/* Clear a range within a single word */
+	spdk_bit_array_clear_range(ba, 3, 10);
+	for (i = 0; i < 256; i++) {
+		CU_ASSERT(spdk_bit_array_get(ba, i) == (i < 3 || i >= 13));
+	}
+
+	/* Clear a range spanning whole words plus partial words on both ends */
+	spdk_bit_array_clear_range(ba, 60, 150);
+	for (i = 0; i < 256; i++) {
+		CU_ASSERT(spdk_bit_array_get(ba, i) == ((i < 3 || i >= 13) && (i < 60 || i >= 210)));
+	}
+
+	/* A zero-length range is a no-op */
+	spdk_bit_array_clear_range(ba, 0, 0);
+	CU_ASSERT(spdk_bit_array_get(ba, 0) == true);
+
+	/* Ranges past the end of the array are trimmed */
+	spdk_bit_array_clear_range(ba, 210, UINT32_MAX);
+	for (i = 210; i < 256; i++) {
+		CU_ASSERT(!spdk_bit_array_get(ba, i));
+	}
+
+	/* The cleared bits must be visible to the summary-accelerated scans */
+	CU_ASSERT(spdk_bit_array_find_first_clear(ba, 0) == 3);
+	CU_ASSERT(spdk_bit_array_find_first_set(ba, 3) == 13);
+
+	spdk_bit_array_free(&ba);
+
+	/* Freeing a range returns the bits to the pool and moves the
+	 * allocation hint back to the start of the range */
+	pool = spdk_bit_pool_create(128);
+	SPDK_CU_ASSERT_FATAL(pool != NULL);
+	for (i = 0; i < 128; i++) {
+		CU_ASSERT(spdk_bit_pool_allocate_bit(pool) == i);
+	}
+	CU_ASSERT(spdk_bit_pool_count_free(pool) == 0);
+
+	spdk_bit_pool_free_range(pool, 32, 64);
+	CU_ASSERT(spdk_bit_pool_count_free(pool) == 64);
+	for (i = 0; i < 64; i++) {
+		CU_ASSERT(spdk_bit_pool_allocate_bit(pool) == 32 + i);
+	}
+	CU_ASSERT(spdk_bit_pool_allocate_bit(pool) == UINT32_MAX);
+
+	spdk_bit_pool_free(&pool);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -330,11 +426,13 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_1bit);
 	CU_ADD_TEST(suite, test_64bit);
 	CU_ADD_TEST(suite, test_find);
+	CU_ADD_TEST(suite, test_find_summary);
 	CU_ADD_TEST(suite, test_resize);
 	CU_ADD_TEST(suite, test_errors);
 	CU_ADD_TEST(suite, test_count);
 	CU_ADD_TEST(suite, test_mask_store_load);
 	CU_ADD_TEST(suite, test_mask_clear);
+	CU_ADD_TEST(suite, test_clear_range);
 
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
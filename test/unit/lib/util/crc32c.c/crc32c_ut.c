@@ -164,6 +164,35 @@ test_crc32c_nvme(void)
 	CU_ASSERT(crc == 0x214941A8);
 }
 
+static void
+test_crc32c_large(void)
+{
+	unsigned int buf_size = 16384;
+	char buf[buf_size];
+	uint32_t crc, crc_chained;
+	unsigned int i, chunk;
+
+	/* Exercise the multi-stream code path with buffers spanning several
+	 * of its blocks and verify it against the same data fed through
+	 * chained sub-block updates, which take the single-stream path.
+	 */
+	for (i = 0; i < buf_size; i++) {
+		buf[i] = (char)(i * 31 + 7);
+	}
+
+	for (chunk = 512; chunk <= 2048; chunk *= 2) {
+		crc = 0xFFFFFFFFu;
+		crc = spdk_crc32c_update(buf, buf_size, crc);
+
+		crc_chained = 0xFFFFFFFFu;
+		for (i = 0; i < buf_size; i += chunk) {
+			crc_chained = spdk_crc32c_update(buf + i, chunk, crc_chained);
+		}
+
+		CU_ASSERT(crc == crc_chained);
+	}
+}
+
 int
 main(int argc, char **argv)
 {
@@ -176,6 +205,7 @@ main(int argc, char **argv)
 
 	CU_ADD_TEST(suite, test_crc32c);
 	CU_ADD_TEST(suite, test_crc32c_nvme);
+	CU_ADD_TEST(suite, test_crc32c_large);
 
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
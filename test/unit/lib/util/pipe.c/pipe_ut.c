@@ -601,6 +601,112 @@ test_data(void)
 	spdk_pipe_destroy(pipe);
 }
 
+static void
+test_spsc_pipe(void)
+{
+	struct spdk_spsc_pipe *pipe;
+	uint8_t mem[10];
+	struct iovec iovs[2];
+	uint8_t *data;
+	int rc;
+	size_t i;
+
+	memset(mem, 0, sizeof(mem));
+	memset(iovs, 0, sizeof(iovs));
+
+	/* The backing buffer must hold at least one byte of data */
+	pipe = spdk_spsc_pipe_create(mem, 1);
+	CU_ASSERT(pipe == NULL);
+
+	pipe = spdk_spsc_pipe_create(mem, sizeof(mem));
+	SPDK_CU_ASSERT_FATAL(pipe != NULL);
+
+	/* One byte is sacrificed, so at most 9 of the 10 bytes are usable */
+	rc = spdk_spsc_pipe_writer_get_buffer(pipe, 10, iovs);
+	CU_ASSERT(rc == 9);
+	CU_ASSERT(iovs[0].iov_base == mem);
+	CU_ASSERT(iovs[0].iov_len == 9);
+	CU_ASSERT(iovs[1].iov_base == NULL);
+	CU_ASSERT(iovs[1].iov_len == 0);
+
+	/* Cannot advance past the available space */
+	rc = spdk_spsc_pipe_writer_advance(pipe, 10);
+	CU_ASSERT(rc == -EINVAL);
+
+	memset(iovs[0].iov_base, 'A', 9);
+	rc = spdk_spsc_pipe_writer_advance(pipe, 9);
+	CU_ASSERT(rc == 0);
+
+	/* The pipe is now full */
+	rc = spdk_spsc_pipe_writer_get_buffer(pipe, 1, iovs);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(iovs[0].iov_base == NULL);
+	CU_ASSERT(iovs[0].iov_len == 0);
+
+	CU_ASSERT(spdk_spsc_pipe_reader_bytes_available(pipe) == 9);
+
+	/* Cannot read back more than was written */
+	rc = spdk_spsc_pipe_reader_advance(pipe, 10);
+	CU_ASSERT(rc == -EINVAL);
+
+	memset(iovs, 0, sizeof(iovs));
+	rc = spdk_spsc_pipe_reader_get_buffer(pipe, 10, iovs);
+	CU_ASSERT(rc == 9);
+	CU_ASSERT(iovs[0].iov_base == mem);
+	CU_ASSERT(iovs[0].iov_len == 9);
+	CU_ASSERT(iovs[1].iov_base == NULL);
+	CU_ASSERT(iovs[1].iov_len == 0);
+
+	data = iovs[0].iov_base;
+	for (i = 0; i < iovs[0].iov_len; i++) {
+		CU_ASSERT(data[i] == 'A');
+	}
+
+	rc = spdk_spsc_pipe_reader_advance(pipe, 9);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(spdk_spsc_pipe_reader_bytes_available(pipe) == 0);
+
+	/* Both indices now sit at 9, so a 4 byte write wraps across the end
+	 * of the buffer and comes back in two iovecs. */
+	memset(iovs, 0, sizeof(iovs));
+	rc = spdk_spsc_pipe_writer_get_buffer(pipe, 4, iovs);
+	CU_ASSERT(rc == 4);
+	CU_ASSERT(iovs[0].iov_base == mem + 9);
+	CU_ASSERT(iovs[0].iov_len == 1);
+	CU_ASSERT(iovs[1].iov_base == mem);
+	CU_ASSERT(iovs[1].iov_len == 3);
+
+	memset(iovs[0].iov_base, 'B', iovs[0].iov_len);
+	memset(iovs[1].iov_base, 'B', iovs[1].iov_len);
+	rc = spdk_spsc_pipe_writer_advance(pipe, 4);
+	CU_ASSERT(rc == 0);
+
+	CU_ASSERT(spdk_spsc_pipe_reader_bytes_available(pipe) == 4);
+
+	/* The read wraps the same way */
+	memset(iovs, 0, sizeof(iovs));
+	rc = spdk_spsc_pipe_reader_get_buffer(pipe, 4, iovs);
+	CU_ASSERT(rc == 4);
+	CU_ASSERT(iovs[0].iov_base == mem + 9);
+	CU_ASSERT(iovs[0].iov_len == 1);
+	CU_ASSERT(iovs[1].iov_base == mem);
+	CU_ASSERT(iovs[1].iov_len == 3);
+
+	data = iovs[0].iov_base;
+	CU_ASSERT(data[0] == 'B');
+	data = iovs[1].iov_base;
+	CU_ASSERT(data[0] == 'B');
+	CU_ASSERT(data[1] == 'B');
+	CU_ASSERT(data[2] == 'B');
+
+	rc = spdk_spsc_pipe_reader_advance(pipe, 4);
+	CU_ASSERT(rc == 0);
+	CU_ASSERT(spdk_spsc_pipe_reader_bytes_available(pipe) == 0);
+
+	data = spdk_spsc_pipe_destroy(pipe);
+	CU_ASSERT(data == mem);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -617,6 +723,7 @@ main(int argc, char **argv)
 	CU_ADD_TEST(suite, test_read_get_buffer);
 	CU_ADD_TEST(suite, test_read_advance);
 	CU_ADD_TEST(suite, test_data);
+	CU_ADD_TEST(suite, test_spsc_pipe);
 
 
 	num_failures = spdk_ut_run_tests(argc, argv, NULL);
@@ -243,6 +243,7 @@ start_vdev(struct spdk_vhost_dev *vdev)
 	rc = posix_memalign((void **)&vsession, 64, sizeof(*vsession));
 	CU_ASSERT(rc == 0);
 	SPDK_CU_ASSERT_FATAL(vsession != NULL);
+	memset(vsession, 0, sizeof(*vsession));
 	vsession->started = true;
 	vsession->vid = 0;
 	vsession->mem = mem;
@@ -353,6 +354,16 @@ desc_to_iov_test(void)
 	CU_ASSERT(iov[1].iov_len == 0x10000);
 	memset(iov, 0, sizeof(iov));
 
+	/* Both regions are cached now - repeat a translation to exercise the
+	 * cache hit path, then invalidate and verify it still resolves from
+	 * the memory table.
+	 */
+	CU_ASSERT(vhost_gpa_to_vva(vsession, 0x110000, 0x1000) == (void *)0x1110000);
+	vhost_gpa_cache_invalidate(vsession);
+	CU_ASSERT(vhost_gpa_to_vva(vsession, 0x110000, 0x1000) == (void *)0x1110000);
+	/* A translation crossing a region boundary must fail. */
+	CU_ASSERT(vhost_gpa_to_vva(vsession, 0x3F0000, 0x20000) == NULL);
+
 	cleanup_vdev(vdev);
 
 	CU_ASSERT(true);